@@ -28,6 +28,15 @@ include $(dir)/Rules.mk
 dir := $(d)/painter_cells
 include $(dir)/Rules.mk
 
+dir := $(d)/painter_benchmark
+include $(dir)/Rules.mk
+
+dir := $(d)/painter_trace_replay
+include $(dir)/Rules.mk
+
+dir := $(d)/path_benchmark
+include $(dir)/Rules.mk
+
 
 
 # Begin standard footer
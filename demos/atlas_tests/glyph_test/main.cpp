@@ -12,6 +12,7 @@
 #include <fastuidraw/gl_backend/gl_context_properties.hpp>
 #include <fastuidraw/gl_backend/gl_program.hpp>
 #include "sdl_demo.hpp"
+#include "simple_time.hpp"
 #include "ImageLoader.hpp"
 #include "PanZoomTracker.hpp"
 #include "text_helper.hpp"
@@ -56,6 +57,14 @@ private:
   void
   ready_attributes_indices(void);
 
+  void
+  run_benchmark(gl::GlyphAtlasGL::params glyph_atlas_options);
+
+  void
+  benchmark_glyph_render(const reference_counted_ptr<GlyphAtlas> &atlas,
+                         const reference_counted_ptr<GlyphCache> &cache,
+                         GlyphRender render, const char *label);
+
 
   void
   compute_glyphs_and_positions(GlyphRender renderer, float pixel_size_formatting,
@@ -172,6 +181,8 @@ private:
   command_line_argument_value<float> m_render_pixel_size;
   command_line_argument_value<float> m_bg_red, m_bg_green, m_bg_blue;
   command_line_argument_value<float> m_fg_red, m_fg_green, m_fg_blue;
+  command_line_argument_value<int> m_benchmark_rounds;
+  command_line_argument_value<int> m_benchmark_max_glyphs;
 
   reference_counted_ptr<gl::GlyphAtlasGL> m_glyph_atlas;
   reference_counted_ptr<GlyphCache> m_glyph_cache;
@@ -497,6 +508,19 @@ glyph_test(void):
   m_fg_red(0.0f, "fg_red", "Foreground Red", *this),
   m_fg_green(0.0f, "fg_green", "Foreground Green", *this),
   m_fg_blue(0.0f, "fg_blue", "Foreground Blue", *this),
+  m_benchmark_rounds(0, "benchmark_rounds",
+                     "If positive, instead of showing the glyphs, time for each glyph "
+                     "type this many rounds of generating the first benchmark_max_glyphs "
+                     "glyphs of the font into a GlyphCache of a delayed GlyphAtlasGL and "
+                     "flushing it, then print the glyphs per second with the generation "
+                     "and copy to the atlas (GlyphCache::fetch_glyph()), the copy to the "
+                     "atlas alone (Glyph::upload_to_atlas() after GlyphCache::clear_atlas()) "
+                     "and the GL upload (the flush of the atlas followed by glFinish) timed "
+                     "separately",
+                     *this),
+  m_benchmark_max_glyphs(256, "benchmark_max_glyphs",
+                         "Maximum number of glyphs of the font used by benchmark_rounds",
+                         *this),
   m_library(NULL),
   m_face(NULL),
   m_current_drawer(draw_glyph_curvepair),
@@ -638,6 +662,13 @@ init_gl(int w, int h)
       return;
     }
 
+  if(m_benchmark_rounds.m_value > 0)
+    {
+      run_benchmark(glyph_atlas_options);
+      end_demo(0);
+      return;
+    }
+
   ready_program();
   ready_attributes_indices();
 }
@@ -939,6 +970,120 @@ compute_glyphs_and_positions(fastuidraw::GlyphRender renderer, float pixel_size_
 
 
 
+/* the atlas of the benchmark is its own and delayed so
+   that the data of the glyphs is only sent to GL on flush();
+   a first round that is not timed makes the atlas allocate
+   its GL objects.
+ */
+void
+glyph_test::
+run_benchmark(gl::GlyphAtlasGL::params glyph_atlas_options)
+{
+  reference_counted_ptr<gl::GlyphAtlasGL> atlas;
+  reference_counted_ptr<GlyphCache> cache;
+
+  atlas = FASTUIDRAWnew gl::GlyphAtlasGL(glyph_atlas_options.delayed(true));
+  cache = FASTUIDRAWnew GlyphCache(atlas);
+
+  benchmark_glyph_render(atlas, cache, GlyphRender(m_coverage_pixel_size.m_value), "coverage");
+  benchmark_glyph_render(atlas, cache, GlyphRender(distance_field_glyph), "distance_field");
+  benchmark_glyph_render(atlas, cache, GlyphRender(curve_pair_glyph), "curve_pair");
+  benchmark_glyph_render(atlas, cache, GlyphRender(banded_curves_glyph), "banded_curves");
+  benchmark_glyph_render(atlas, cache, GlyphRender(msdf_glyph), "msdf");
+}
+
+void
+glyph_test::
+benchmark_glyph_render(const reference_counted_ptr<GlyphAtlas> &atlas,
+                       const reference_counted_ptr<GlyphCache> &cache,
+                       GlyphRender render, const char *label)
+{
+  std::vector<Glyph> glyphs;
+  int64_t generate_us(0), copy_us(0), gl_us(0);
+  uint64_t texels(0);
+  unsigned int count(0), number_glyphs;
+
+  if(!m_font->can_create_rendering_data(render.m_type))
+    {
+      std::cout << "\n" << label << " glyphs: not supported by the font\n";
+      return;
+    }
+
+  number_glyphs = std::min(static_cast<unsigned int>(m_face->num_glyphs),
+                           static_cast<unsigned int>(std::max(1, m_benchmark_max_glyphs.m_value)));
+  for(int round = -1; round < m_benchmark_rounds.m_value; ++round)
+    {
+      simple_time timer;
+      int64_t round_generate_us, round_copy_us, round_gl_us;
+      bool atlas_full(false);
+
+      cache->clear_cache();
+      atlas->flush();
+      glFinish();
+      glyphs.clear();
+
+      timer.restart_us();
+      for(unsigned int g = 0; g < number_glyphs; ++g)
+        {
+          glyphs.push_back(cache->fetch_glyph(render, m_font, g));
+        }
+      round_generate_us = timer.restart_us();
+
+      atlas->flush();
+      glFinish();
+      round_gl_us = timer.restart_us();
+
+      if(round == 0)
+        {
+          for(int layer = 0, end_layer = atlas->texel_store()->dimensions().z(); layer < end_layer; ++layer)
+            {
+              texels += atlas->number_texels_allocated(layer);
+            }
+        }
+
+      cache->clear_atlas();
+      timer.restart_us();
+      for(unsigned int g = 0; g < glyphs.size() && !atlas_full; ++g)
+        {
+          atlas_full = glyphs[g].valid() && glyphs[g].upload_to_atlas() == routine_fail;
+        }
+      round_copy_us = timer.restart_us();
+
+      if(atlas_full)
+        {
+          std::cout << "\n" << label << " glyphs: the atlas is too small for "
+                    << number_glyphs << " glyphs\n";
+          return;
+        }
+
+      if(round >= 0)
+        {
+          generate_us += round_generate_us;
+          copy_us += round_copy_us;
+          gl_us += round_gl_us;
+          count += glyphs.size();
+        }
+    }
+  cache->clear_cache();
+
+  double generate_s(static_cast<double>(std::max(generate_us, int64_t(1))) * 1e-6);
+  double copy_s(static_cast<double>(std::max(copy_us, int64_t(1))) * 1e-6);
+  double gl_s(static_cast<double>(std::max(gl_us, int64_t(1))) * 1e-6);
+
+  std::cout << "\n" << label << " glyphs: " << count << " glyphs over "
+            << m_benchmark_rounds.m_value << " rounds, "
+            << static_cast<double>(texels) / static_cast<double>(number_glyphs)
+            << " texels per glyph\n"
+            << "\tgenerate and copy to atlas: " << generate_us << " us, "
+            << static_cast<double>(count) / generate_s << " glyphs/sec\n"
+            << "\tcopy to atlas only: " << copy_us << " us, "
+            << static_cast<double>(count) / copy_s << " glyphs/sec\n"
+            << "\tgl upload: " << gl_us << " us, "
+            << static_cast<double>(count) / gl_s << " glyphs/sec\n"
+            << "\tgenerate, copy and gl upload: "
+            << static_cast<double>(count) / (generate_s + gl_s) << " glyphs/sec\n";
+}
+
 void
 glyph_test::
 ready_attributes_indices(void)
@@ -2,6 +2,7 @@
 #include <fastuidraw/gl_backend/opengl_trait.hpp>
 #include <cstdlib>
 #include "sdl_demo.hpp"
+#include "simple_time.hpp"
 #include "colorstop_command_line.hpp"
 
 using namespace fastuidraw;
@@ -22,6 +23,17 @@ public:
     m_stress(false, "stress_color_stop_atlas",
              "If true create and delete multiple color stops "
              "to test ColorStopAtlas allocation and deletion", *this),
+    m_benchmark_rounds(0, "benchmark_rounds",
+                       "If positive, instead of showing the gradients, time this many rounds "
+                       "of creating benchmark_copies copies of each color stop sequence "
+                       "on a delayed ColorStopAtlasGL and flushing it, then print the "
+                       "gradients per second with the CPU preparation (discretizing the "
+                       "color stops and allocating from the atlas) and the GL upload (the "
+                       "flush of the atlas followed by glFinish) timed separately",
+                       *this),
+    m_benchmark_copies(64, "benchmark_copies",
+                       "Number of copies of each color stop sequence made "
+                       "in each round of benchmark_rounds", *this),
     m_active_color_stop(0),
     m_ibo(0),
     m_bo(0),
@@ -78,6 +90,12 @@ protected:
     (void)h;
 
     create_colorstops_and_atlas();
+    if(m_benchmark_rounds.m_value > 0)
+      {
+        run_benchmark();
+        end_demo(0);
+        return;
+      }
     set_attributes_indices();
     build_programs();
   }
@@ -293,6 +311,78 @@ private:
       }
   }
 
+  /* the atlas of the benchmark is its own and delayed
+     so that the texels are only sent to GL on flush();
+     a first round that is not timed makes the atlas
+     allocate its texture at its full size.
+   */
+  void
+  run_benchmark(void)
+  {
+    gl::ColorStopAtlasGL::params params;
+    reference_counted_ptr<gl::ColorStopAtlasGL> atlas;
+    std::vector<reference_counted_ptr<ColorStopSequenceOnAtlas> > sequences;
+    int64_t cpu_us(0), gl_us(0);
+    uint64_t texels(0);
+    unsigned int count(0);
+    int copies(std::max(1, m_benchmark_copies.m_value));
+
+    params
+      .width(m_color_stop_atlas_width.m_value)
+      .num_layers(m_color_stop_atlas_layers.m_value)
+      .delayed(true);
+    atlas = FASTUIDRAWnew gl::ColorStopAtlasGL(params);
+
+    for(int round = -1; round < m_benchmark_rounds.m_value; ++round)
+      {
+        simple_time timer;
+        int64_t round_cpu_us, round_gl_us;
+
+        for(int c = 0; c < copies; ++c)
+          {
+            for(colorstop_data_hoard::iterator
+                  iter = m_color_stop_args.m_values.begin(),
+                  end = m_color_stop_args.m_values.end();
+                iter != end; ++iter)
+              {
+                int width(std::min(iter->second->m_discretization, m_color_stop_atlas_width.m_value));
+                sequences.push_back(FASTUIDRAWnew ColorStopSequenceOnAtlas(iter->second->m_stops, atlas, width));
+                if(round >= 0)
+                  {
+                    texels += sequences.back()->width();
+                  }
+              }
+          }
+        round_cpu_us = timer.restart_us();
+
+        atlas->flush();
+        glFinish();
+        round_gl_us = timer.restart_us();
+
+        if(round >= 0)
+          {
+            cpu_us += round_cpu_us;
+            gl_us += round_gl_us;
+            count += sequences.size();
+          }
+        sequences.clear();
+      }
+
+    double cpu_s(static_cast<double>(std::max(cpu_us, int64_t(1))) * 1e-6);
+    double gl_s(static_cast<double>(std::max(gl_us, int64_t(1))) * 1e-6);
+    double mb(static_cast<double>(texels) * static_cast<double>(sizeof(u8vec4)) / (1024.0 * 1024.0));
+
+    std::cout << "\nColorStopAtlasGL upload of " << count << " gradients ("
+              << mb << " MB) over " << m_benchmark_rounds.m_value << " rounds:\n"
+              << "\tcpu preparation: " << cpu_us << " us, "
+              << static_cast<double>(count) / cpu_s << " gradients/sec\n"
+              << "\tgl upload: " << gl_us << " us, "
+              << static_cast<double>(count) / gl_s << " gradients/sec, "
+              << mb / gl_s << " MB/s\n"
+              << "\ttotal: " << static_cast<double>(count) / (cpu_s + gl_s)
+              << " gradients/sec\n";
+  }
+
   void
   set_attributes_indices(void)
   {
@@ -411,6 +501,8 @@ private:
   command_line_argument_value<int> m_color_stop_atlas_layers;
   color_stop_arguments m_color_stop_args;
   command_line_argument_value<bool> m_stress;
+  command_line_argument_value<int> m_benchmark_rounds;
+  command_line_argument_value<int> m_benchmark_copies;
   reference_counted_ptr<gl::ColorStopAtlasGL> m_atlas;
   std::vector<named_color_stop> m_color_stops;
 
@@ -6,6 +6,7 @@
 #include <fastuidraw/gl_backend/opengl_trait.hpp>
 #include <fastuidraw/gl_backend/gl_program.hpp>
 #include "sdl_demo.hpp"
+#include "simple_time.hpp"
 #include "ImageLoader.hpp"
 #include "PanZoomTracker.hpp"
 #include "cycle_value.hpp"
@@ -100,6 +101,14 @@ public:
                        "then the total number of index tiles available "
                        "is given as num_index_layers*pow(2, 2*log2_num_index_tiles_per_row_per_col)",
                        *this),
+    m_benchmark_rounds(0, "benchmark_rounds",
+                       "If positive, instead of showing the images, time this many rounds "
+                       "of creating all the images on a delayed ImageAtlasGL made with the "
+                       "tile sizes and slack above and flushing it, then print the images "
+                       "per second and MB per second with the CPU preparation (allocating "
+                       "the tiles and copying the texels to them) and the GL upload (the "
+                       "flush of the atlas followed by glFinish) timed separately",
+                       *this),
     m_color_boundary_mix_value(0.0f),
     m_filtered_lookup(0.0f),
     m_current_program(draw_image_on_atlas),
@@ -140,6 +149,14 @@ protected:
     image_size = load_image_to_array(filename, image_data);
     if(image_size.x() != 0 && image_size.y() != 0)
       {
+        if(m_benchmark_rounds.m_value > 0)
+          {
+            m_benchmark_images.push_back(benchmark_image());
+            m_benchmark_images.back().first = image_size;
+            m_benchmark_images.back().second.swap(image_data);
+            return;
+          }
+
         m_image_handles.push_back(Image::create(m_atlas, image_size.x(), image_size.y(),
                                                 cast_c_array(image_data), m_slack.m_value));
         m_image_names.push_back(filename);
@@ -184,6 +201,13 @@ protected:
   void
   init_gl(int w, int h)
   {
+    if(m_benchmark_rounds.m_value > 0)
+      {
+        run_benchmark();
+        end_demo(0);
+        return;
+      }
+
     build_images();
     build_programs();
     on_resize(w, h);
@@ -421,17 +445,7 @@ private:
     glSamplerParameteri(m_sampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glSamplerParameteri(m_sampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    gl::ImageAtlasGL::params params;
-    params
-      .log2_color_tile_size(m_log2_color_tile_size.m_value)
-      .log2_num_color_tiles_per_row_per_col(m_log2_num_color_tiles_per_row_per_col.m_value)
-      .num_color_layers(m_num_color_layers.m_value)
-      .log2_index_tile_size(m_log2_index_tile_size.m_value)
-      .log2_num_index_tiles_per_row_per_col(m_log2_num_index_tiles_per_row_per_col.m_value)
-      .num_index_layers(m_num_index_layers.m_value)
-      .delayed(false);
-
-    m_atlas = FASTUIDRAWnew gl::ImageAtlasGL(params);
+    m_atlas = FASTUIDRAWnew gl::ImageAtlasGL(atlas_params().delayed(false));
     m_slack.m_value = std::max(0, m_slack.m_value);
 
     for(command_line_list::iterator iter = m_images.begin(); iter != m_images.end(); ++iter)
@@ -462,6 +476,96 @@ private:
 
   }
 
+  gl::ImageAtlasGL::params
+  atlas_params(void)
+  {
+    gl::ImageAtlasGL::params params;
+    params
+      .log2_color_tile_size(m_log2_color_tile_size.m_value)
+      .log2_num_color_tiles_per_row_per_col(m_log2_num_color_tiles_per_row_per_col.m_value)
+      .num_color_layers(m_num_color_layers.m_value)
+      .log2_index_tile_size(m_log2_index_tile_size.m_value)
+      .log2_num_index_tiles_per_row_per_col(m_log2_num_index_tiles_per_row_per_col.m_value)
+      .num_index_layers(m_num_index_layers.m_value);
+    return params;
+  }
+
+  /* the atlas of the benchmark is delayed so that the
+     texels are only sent to GL on flush(); a first round
+     that is not timed makes the atlas allocate its textures
+     at the size the images need.
+   */
+  void
+  run_benchmark(void)
+  {
+    reference_counted_ptr<gl::ImageAtlasGL> atlas;
+    std::vector<reference_counted_ptr<Image> > images;
+    int64_t cpu_us(0), gl_us(0);
+    uint64_t texels(0);
+    unsigned int count(0);
+
+    m_slack.m_value = std::max(0, m_slack.m_value);
+    for(command_line_list::iterator iter = m_images.begin(); iter != m_images.end(); ++iter)
+      {
+        add_images(*iter);
+      }
+
+    if(m_benchmark_images.empty())
+      {
+        std::cout << "\nNo images to benchmark, add images with add_image\n";
+        return;
+      }
+
+    atlas = FASTUIDRAWnew gl::ImageAtlasGL(atlas_params().delayed(true));
+    for(int round = -1; round < m_benchmark_rounds.m_value; ++round)
+      {
+        simple_time timer;
+        int64_t round_cpu_us, round_gl_us;
+
+        for(unsigned int i = 0; i < m_benchmark_images.size(); ++i)
+          {
+            const benchmark_image &im(m_benchmark_images[i]);
+            images.push_back(Image::create(atlas, im.first.x(), im.first.y(),
+                                           cast_c_array(im.second), m_slack.m_value));
+          }
+        round_cpu_us = timer.restart_us();
+
+        atlas->flush();
+        glFinish();
+        round_gl_us = timer.restart_us();
+
+        if(round >= 0)
+          {
+            cpu_us += round_cpu_us;
+            gl_us += round_gl_us;
+            count += images.size();
+            for(unsigned int i = 0; i < m_benchmark_images.size(); ++i)
+              {
+                texels += m_benchmark_images[i].second.size();
+              }
+          }
+        images.clear();
+      }
+
+    double cpu_s(static_cast<double>(std::max(cpu_us, int64_t(1))) * 1e-6);
+    double gl_s(static_cast<double>(std::max(gl_us, int64_t(1))) * 1e-6);
+    double mb(static_cast<double>(texels) * static_cast<double>(sizeof(u8vec4)) / (1024.0 * 1024.0));
+
+    std::cout << "\nImageAtlasGL upload of " << count << " images ("
+              << mb << " MB) over " << m_benchmark_rounds.m_value << " rounds with "
+              << "color tile size " << (1 << m_log2_color_tile_size.m_value)
+              << ", index tile size " << (1 << m_log2_index_tile_size.m_value)
+              << " and slack " << m_slack.m_value << ":\n"
+              << "\tcpu preparation: " << cpu_us << " us, "
+              << static_cast<double>(count) / cpu_s << " images/sec, "
+              << mb / cpu_s << " MB/s\n"
+              << "\tgl upload: " << gl_us << " us, "
+              << static_cast<double>(count) / gl_s << " images/sec, "
+              << mb / gl_s << " MB/s\n"
+              << "\ttotal: " << static_cast<double>(count) / (cpu_s + gl_s) << " images/sec, "
+              << mb / (cpu_s + gl_s) << " MB/s\n";
+  }
+
   void
   build_programs(void)
   {
@@ -691,6 +795,11 @@ private:
   command_line_argument_value<int> m_num_color_layers;
   command_line_argument_value<int> m_log2_index_tile_size, m_log2_num_index_tiles_per_row_per_col;
   command_line_argument_value<int> m_num_index_layers;
+  command_line_argument_value<int> m_benchmark_rounds;
+
+  /* the images loaded in benchmark mode, see run_benchmark() */
+  typedef std::pair<ivec2, std::vector<u8vec4> > benchmark_image;
+  std::vector<benchmark_image> m_benchmark_images;
 
   float m_color_boundary_mix_value;
   std::vector<float> m_index_boundary_mix_values;
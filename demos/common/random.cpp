@@ -1,18 +1,26 @@
 #include <stdlib.h>
 #include "random.hpp"
 
+static bool srand_inited(false);
+
 static
 void
 init_srand(void)
 {
-  static bool inited(false);
-  if(!inited)
+  if(!srand_inited)
     {
-      inited = true;
+      srand_inited = true;
       srand(0);
     }
 }
 
+void
+random_seed(unsigned int seed)
+{
+  srand_inited = true;
+  srand(seed);
+}
+
 
 float
 random_value(float pmin, float pmax)
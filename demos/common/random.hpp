@@ -2,6 +2,12 @@
 
 #include <fastuidraw/util/vecN.hpp>
 
+/* Set the seed of the values returned by random_value(). If
+   never called, the seed is 0 so that runs are repeatable.
+ */
+void
+random_seed(unsigned int seed);
+
 float
 random_value(float pmin, float pmax);
 
@@ -4,6 +4,7 @@
 #include <list>
 
 #include "ostream_utility.hpp"
+#include "cast_c_array.hpp"
 #include "read_path.hpp"
 
 namespace
@@ -130,8 +131,13 @@ read_path(fastuidraw::Path &path, const std::string &source)
         }
     }
 
-  /* now walk the list of outlines.
+  /* now walk the list of outlines, packing them as verbs
+     to add all of them to the path at once.
    */
+  std::vector<enum fastuidraw::Path::verb_t> verbs;
+  std::vector<fastuidraw::vec2> pts;
+  std::vector<float> angles;
+
   for(std::list<outline>::const_iterator iter = data.begin(), end = data.end();
       iter != end; ++iter)
     {
@@ -139,40 +145,48 @@ read_path(fastuidraw::Path &path, const std::string &source)
 
       if(!current_outline.empty())
         {
-          path << current_outline[0].m_pt;
-          for(unsigned int i = 0; i + 1 < current_outline.size(); ++i)
+          verbs.push_back(fastuidraw::Path::verb_move);
+          pts.push_back(current_outline[0].m_pt);
+          for(unsigned int i = 0; i < current_outline.size(); ++i)
             {
               const edge &current_edge(current_outline[i]);
-              const edge &next_edge(current_outline[i+1]);
+              bool last(i + 1 == current_outline.size());
 
               if(current_edge.m_arc_mode == not_arc)
                 {
                   for(unsigned int c = 0; c < current_edge.m_control_pts.size(); ++c)
                     {
-                      path << fastuidraw::Path::control_point(current_edge.m_control_pts[c]);
+                      verbs.push_back(fastuidraw::Path::verb_control_point);
+                      pts.push_back(current_edge.m_control_pts[c]);
+                    }
+                  if(last)
+                    {
+                      verbs.push_back(fastuidraw::Path::verb_close);
+                    }
+                  else
+                    {
+                      verbs.push_back(fastuidraw::Path::verb_line);
+                      pts.push_back(current_outline[i+1].m_pt);
                     }
-                  path << next_edge.m_pt;
                 }
               else
                 {
-                  path << fastuidraw::Path::arc_degrees(current_edge.m_angle, next_edge.m_pt);
-                }
-            }
-
-          const edge &current_edge(current_outline.back());
-          if(current_edge.m_arc_mode == not_arc)
-            {
-              for(unsigned int c = 0; c < current_edge.m_control_pts.size(); ++c)
-                {
-                  path << fastuidraw::Path::control_point(current_edge.m_control_pts[c]);
+                  angles.push_back(current_edge.m_angle * float(M_PI) / 180.0f);
+                  if(last)
+                    {
+                      verbs.push_back(fastuidraw::Path::verb_close_arc);
+                    }
+                  else
+                    {
+                      verbs.push_back(fastuidraw::Path::verb_arc);
+                      pts.push_back(current_outline[i+1].m_pt);
+                    }
                 }
-              path << fastuidraw::Path::contour_end();
-            }
-          else
-            {
-              path << fastuidraw::Path::contour_end_arc_degrees(current_edge.m_angle);
             }
         }
     }
 
+  path.add_contours(cast_c_array(verbs),
+                    cast_c_array(pts),
+                    cast_c_array(angles));
 }
@@ -150,6 +150,9 @@ sdl_demo(const std::string &about_text, bool dimensions_must_match_default_value
                  "Bpp of stencil buffer, non-positive values mean use SDL defaults",
                  *this),
   m_fullscreen(false, "fullscreen", "fullscreen mode", *this),
+  m_hide_window(false, "hide_window",
+                "If true, create the window hidden; useful for benchmarks "
+                "that render only to an offscreen FBO", *this),
   m_hide_cursor(false, "hide_cursor", "If true, hide the mouse cursor with a SDL call", *this),
   m_use_msaa(false, "enable_msaa", "If true enables MSAA", *this),
   m_msaa(4, "msaa_samples",
@@ -185,6 +188,12 @@ sdl_demo(const std::string &about_text, bool dimensions_must_match_default_value
   m_gl_debug_context(false, "debug_context", "if true request a context with debug", *this),
   m_gl_core_profile(true, "core_context", "if true request a context which is core profile", *this),
   #endif
+  m_gl_no_error_context(false, "no_error_context",
+                        "if true request a context without error checking "
+                        "(GL_KHR_no_error) to remove the CPU cost of the validation "
+                        "done by the GL implementation; GL errors then have undefined "
+                        "behavior. Ignored if the context is created with EGL "
+                        "or if SDL is older than 2.0.6", *this),
 
   m_show_framerate(false, "show_framerate", "if true show the cumulative framerate at end", *this),
   m_gl_logger(NULL),
@@ -246,6 +255,11 @@ init_sdl(void)
       video_flags = video_flags | SDL_WINDOW_FULLSCREEN;
     }
 
+  if(m_hide_window.m_value)
+    {
+      video_flags = video_flags | SDL_WINDOW_HIDDEN;
+    }
+
 
 
   video_flags |= SDL_WINDOW_OPENGL;
@@ -309,7 +323,14 @@ init_sdl(void)
   }
   #endif
 
-
+  #if SDL_VERSION_ATLEAST(2, 0, 6)
+  {
+    if(m_gl_no_error_context.m_value)
+      {
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_NO_ERROR, 1);
+      }
+  }
+  #endif
 
   // Create the SDL window
   m_window = SDL_CreateWindow("",
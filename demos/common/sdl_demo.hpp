@@ -121,6 +121,7 @@ private:
   command_line_argument_value<int> m_depth_bits;
   command_line_argument_value<int> m_stencil_bits;
   command_line_argument_value<bool> m_fullscreen;
+  command_line_argument_value<bool> m_hide_window;
   command_line_argument_value<bool> m_hide_cursor;
   command_line_argument_value<bool> m_use_msaa;
   command_line_argument_value<int> m_msaa;
@@ -132,6 +133,7 @@ private:
   command_line_argument_value<bool> m_print_gl_info;
   command_line_argument_value<int> m_swap_interval;
   command_line_argument_value<int> m_gl_major, m_gl_minor;
+  command_line_argument_value<bool> m_gl_no_error_context;
 #ifndef FASTUIDRAW_GL_USE_GLES
   command_line_argument_value<bool> m_gl_forward_compatible_context;
   command_line_argument_value<bool> m_gl_debug_context;
@@ -1,4 +1,6 @@
 #include "sdl_painter_demo.hpp"
+#include <cstring>
+#include <fstream>
 #include "text_helper.hpp"
 
 namespace
@@ -13,6 +15,51 @@ namespace
 
       case fastuidraw::gl::PainterBackendGL::data_store_ubo:
         return "ubo";
+
+      case fastuidraw::gl::PainterBackendGL::data_store_ssbo:
+        return "ssbo";
+      }
+
+    return "invalid value";
+  }
+
+  const char*
+  string_from_blend_shader_type(enum fastuidraw::PainterBlendShader::shader_type v)
+  {
+    switch(v)
+      {
+      case fastuidraw::PainterBlendShader::single_src:
+        return "single_src";
+
+      case fastuidraw::PainterBlendShader::dual_src:
+        return "dual_src";
+
+      case fastuidraw::PainterBlendShader::framebuffer_fetch:
+        return "framebuffer_fetch";
+
+      default:
+        break;
+      }
+
+    return "invalid value";
+  }
+
+  const char*
+  string_from_program_type(enum fastuidraw::gl::PainterBackendGL::program_type_t v)
+  {
+    switch(v)
+      {
+      case fastuidraw::gl::PainterBackendGL::program_all:
+        return "program_all";
+
+      case fastuidraw::gl::PainterBackendGL::program_without_discard:
+        return "program_without_discard";
+
+      case fastuidraw::gl::PainterBackendGL::program_with_discard:
+        return "program_with_discard";
+
+      default:
+        break;
       }
 
     return "invalid value";
@@ -99,6 +146,21 @@ sdl_painter_demo(const std::string &about_text,
                                "image_atlas_delayed_upload",
                                "if true delay uploading of data to GL from image atlas until atlas flush",
                                *this),
+  m_image_atlas_compressed_color_tiles(m_image_atlas_params.compressed_color_tiles(),
+                                       "image_atlas_compressed_color_tiles",
+                                       "if true store the color tiles of the image atlas "
+                                       "compressed as ETC2 (requires GL 4.3 or GLES 3.0)",
+                                       *this),
+  m_image_atlas_direct_index_lookup(m_image_atlas_params.direct_index_lookup(),
+                                    "image_atlas_direct_index_lookup",
+                                    "if true place the index tiles of each large image as a "
+                                    "single block so that sampling it needs only one index lookup",
+                                    *this),
+  m_image_atlas_cpu_mirror(m_image_atlas_params.cpu_mirror(),
+                           "image_atlas_cpu_mirror",
+                           "if true keep a copy of the image atlas in CPU memory "
+                           "to restore it after a GL context loss",
+                           *this),
 
   m_glyph_atlas_options("Glyph Atlas options", *this),
   m_texel_store_width(m_glyph_atlas_params.texel_store_dimensions().x(),
@@ -116,6 +178,20 @@ sdl_painter_demo(const std::string &about_text,
                                "glyph_atlas_delayed_upload",
                                "if true delay uploading of data to GL from glyph atlas until atlas flush",
                                *this),
+  m_glyph_atlas_cpu_mirror(m_glyph_atlas_params.cpu_mirror(),
+                           "glyph_atlas_cpu_mirror",
+                           "if true keep a copy of the glyph atlas in CPU memory "
+                           "to restore it after a GL context loss",
+                           *this),
+  m_glyph_atlas_shelf_max_height(0, "glyph_atlas_shelf_max_height",
+                                 "if positive, glyph regions (including padding) no taller than "
+                                 "this are allocated on shelves of uniform height",
+                                 *this),
+  m_glyph_atlas_sixteen_bit(m_glyph_atlas_params.sixteen_bit_texel_store(),
+                            "glyph_atlas_sixteen_bit",
+                            "if true the glyph atlas texels are 16-bit so that curve-pair "
+                            "glyphs are fetched with a single texel fetch",
+                            *this),
   m_glyph_geometry_backing_store_type(glyph_geometry_backing_store_auto,
                                       enumerated_string_type<enum glyph_geometry_backing_store_t>()
                                       .add_entry("buffer",
@@ -156,6 +232,11 @@ sdl_painter_demo(const std::string &about_text,
                                     "color_stop_atlas_delayed_upload",
                                     "if true delay uploading of data to GL from color stop atlas until atlas flush",
                                     *this),
+  m_color_stop_atlas_cpu_mirror(m_colorstop_atlas_params.cpu_mirror(),
+                                "color_stop_atlas_cpu_mirror",
+                                "if true keep a copy of the color stop atlas in CPU memory "
+                                "to restore it after a GL context loss",
+                                *this),
 
   m_painter_options("PainterBackendGL Options", *this),
   m_painter_attributes_per_buffer(m_painter_params.attributes_per_buffer(),
@@ -189,6 +270,11 @@ sdl_painter_demo(const std::string &about_text,
                                            "if true, unpack the brush and frag-shader specific data from "
                                            "the header in the fragment shader instead of the vertex shader",
                                            *this),
+  m_pack_varyings(m_painter_params.pack_varyings(),
+                  "painter_pack_varyings",
+                  "if true, pack the uint, int and flat float varyings of each item "
+                  "shader into shared flat uvec4 varyings",
+                  *this),
   m_separate_program_for_discard(m_painter_params.separate_program_for_discard(),
                                  "separate_program_for_discard",
                                  "if true, there are two GLSL programs active when drawing: "
@@ -200,6 +286,13 @@ sdl_painter_demo(const std::string &about_text,
                                           "Use discard in instead of thinner widths when stroking "
                                           "opaque pass for anti-aliased stroking of paths",
                                           *this),
+  m_dashed_stroke_shader_uses_discard(m_painter_params.dashed_stroke_shader_uses_discard(),
+                                      "dashed_stroke_shader_uses_discard",
+                                      "If false, dashed stroking emits the coverage of the dash pattern "
+                                      "as alpha instead of using discard, so that it keeps early depth "
+                                      "testing; only correct for blend modes where zero alpha leaves the "
+                                      "destination unchanged",
+                                      *this),
 
   m_painter_options_affected_by_context("PainterBackendGL Options that can be overridden "
                                         "by version and extension supported by GL/GLES context",
@@ -224,7 +317,11 @@ sdl_painter_demo(const std::string &about_text,
                                   fastuidraw::gl::PainterBackendGL::data_store_ubo,
                                   "use a uniform buffer object to back the data store. "
                                   "A uniform buffer object's maximum size is much smaller than that "
-                                  "of a texture buffer object usually"),
+                                  "of a texture buffer object usually")
+                       .add_entry("ssbo",
+                                  fastuidraw::gl::PainterBackendGL::data_store_ssbo,
+                                  "use a shader storage buffer object to back the data store "
+                                  "(requires GL 4.3 or GLES 3.1 with SSBO's in vertex shaders)"),
                        "painter_data_store_backing_type",
                        "specifies how the data store buffer is backed",
                        *this),
@@ -242,13 +339,191 @@ sdl_painter_demo(const std::string &about_text,
                          "painter_use_ubo_for_uniforms",
                          "If true, use a UBO instead of uniforms to hold uniform values common to all items",
                          *this),
+  m_persistent_mapped_buffers(m_painter_params.persistent_mapped_buffers(),
+                               "painter_persistent_mapped_buffers",
+                               "If true, use persistently mapped buffers fenced with glFenceSync "
+                               "for the data sent to GL each frame (requires GL_ARB_buffer_storage "
+                               "or GL_EXT_buffer_storage)",
+                               *this),
+  m_program_binary_cache_dir("", "painter_program_binary_cache_dir",
+                             "If non-empty, directory (which must already exist) in which "
+                             "to cache the program binaries of the uber-shaders",
+                             *this),
+  m_calibrate_data_store_backing(false, "painter_calibrate_data_store_backing",
+                                 "If true, ignore painter_data_store_backing_type and use the "
+                                 "data store backing that is fastest in a short synthetic workload; "
+                                 "the choice is cached in painter_program_binary_cache_dir if set",
+                                 *this),
+  m_async_program_rebuild(m_painter_params.async_program_rebuild(),
+                          "painter_async_program_rebuild",
+                          "If true, rebuild the uber-shaders without blocking when shaders are "
+                          "registered after the first frame (requires GL_KHR_parallel_shader_compile "
+                          "or GL_ARB_parallel_shader_compile)",
+                          *this),
+  m_static_attributes_per_heap(m_painter_params.static_attributes_per_heap(),
+                               "painter_static_attributes_per_heap",
+                               "Number of attributes of the buffer backing static attribute data, "
+                               "a value of 0 disables static attribute data",
+                               *this),
+  m_static_indices_per_heap(m_painter_params.static_indices_per_heap(),
+                            "painter_static_indices_per_heap",
+                            "Number of indices of the buffer backing static attribute data, "
+                            "a value of 0 disables static attribute data",
+                            *this),
+  m_use_indirect_draw(m_painter_params.use_indirect_draw(),
+                      "painter_use_indirect_draw",
+                      "If true, submit the draws of each PainterDraw with glMultiDrawElementsIndirect "
+                      "(requires GL 4.3 or GL_ARB_multi_draw_indirect or GL_EXT_multi_draw_indirect)",
+                      *this),
+  m_timer_query_frames(m_painter_params.timer_query_frames(),
+                       "painter_timer_query_frames",
+                       "If non-zero, measure the GPU time of each frame and of each set of shaders "
+                       "with a ring of GL timer queries for that many frames (requires GL 3.3 or "
+                       "GL_ARB_timer_query, not supported for GLES)",
+                       *this),
+  m_stencil_coverage(m_painter_params.stencil_coverage(),
+                     "painter_stencil_coverage",
+                     "If true, the framebuffer has a stencil buffer that the painter may use "
+                     "to compute the coverage of fills on the GPU",
+                     *this),
+  m_stencil_clipping(m_painter_params.stencil_clipping(),
+                     "painter_stencil_clipping",
+                     "If true, the framebuffer has a stencil buffer that the painter uses "
+                     "to clip by paths instead of drawing occluders to the depth buffer, "
+                     "takes precedence over painter_stencil_coverage",
+                     *this),
+  m_rounded_rect_clipping(m_painter_params.rounded_rect_clipping(),
+                          "painter_rounded_rect_clipping",
+                          "If true, the corners of rounded rect clippings are clipped "
+                          "analytically in the fragment shader instead of by a path",
+                          *this),
+  m_glyph_instancing(m_painter_params.glyph_instancing(),
+                     "painter_glyph_instancing",
+                     "If true, draw glyph instances with one attribute per glyph by "
+                     "instanced draws (requires GL 4.2 or GL_ARB_base_instance or "
+                     "GL_EXT_base_instance)",
+                     *this),
+  m_bindless_images(m_painter_params.bindless_images(),
+                    "painter_bindless_images",
+                    "If true, brushes whose image is a bindless texture sample the texture "
+                    "from its handle (requires GL_ARB_bindless_texture, not supported for GLES)",
+                    *this),
+  m_external_texture_images(m_painter_params.external_texture_images(),
+                            "painter_external_texture_images",
+                            "If true and if painter_bindless_images is true, brushes whose image is "
+                            "a bindless GL_TEXTURE_EXTERNAL_OES texture sample it as samplerExternalOES "
+                            "(requires GL_OES_EGL_image_external_essl3 or GL_OES_EGL_image_external)",
+                            *this),
+  m_specialized_programs(m_painter_params.specialized_programs(),
+                         "painter_specialized_programs",
+                         "Maximum number of GLSL programs each specialized to one of the item "
+                         "shaders that draw the most during the first frames, 0 means none",
+                         *this),
+  m_solid_brush_programs(m_painter_params.solid_brush_programs(),
+                         "painter_solid_brush_programs",
+                         "If true, build GLSL programs in which the brush shader bits are constant "
+                         "zero and draw with them the draws without gradient, image or repeat window",
+                         *this),
+  m_w3c_blend_modes(m_painter_params.w3c_blend_modes(),
+                    "painter_w3c_blend_modes",
+                    "If true, support the W3C blend modes with framebuffer fetch or with "
+                    "the coherent advanced blend equations when the GL implementation "
+                    "supports either of them",
+                    *this),
+  m_retain_gl_state_between_passes(m_painter_params.retain_gl_state_between_passes(),
+                                   "painter_retain_gl_state_between_passes",
+                                   "If true, leave the program, textures, samplers and blend "
+                                   "state of a pass bound for the next pass to reuse, i.e. "
+                                   "declare that no other GL code runs between passes",
+                                   *this),
+  m_short_indices(m_painter_params.short_indices(),
+                  "painter_short_indices",
+                  "If true, upload the streamed indices as 16-bit indices "
+                  "relative to a base vertex for each draw",
+                  *this),
+  m_opaque_front_to_back(m_painter_params.opaque_front_to_back(),
+                         "painter_opaque_front_to_back",
+                         "If true, draw the draws with blend mode porter_duff_src "
+                         "of each draw call batch first and front to back so that "
+                         "the depth test rejects the fragments they hide",
+                         *this),
+  m_precision_policy(m_painter_params.precision_policy(),
+                     enumerated_string_type<precision_policy_t>()
+                     .add_entry("highp",
+                                fastuidraw::glsl::PainterBackendGLSL::precision_highp,
+                                "all shader computations are highp")
+                     .add_entry("mediump_color",
+                                fastuidraw::glsl::PainterBackendGLSL::precision_mediump_color,
+                                "color, coverage and brush color computations in the fragment "
+                                "shader are mediump, positions and atlas coordinates are highp "
+                                "(only has an effect on GLES)"),
+                     "painter_precision_policy",
+                     "specifies the precision of the color computations of the uber-shader",
+                     *this),
+  m_tile_based_rendering(m_painter_params.tile_based_rendering(),
+                         "painter_tile_based_rendering",
+                         "If true, the backend clears depth and stencil at the start of "
+                         "a frame and invalidates them at its end so that a tiled GPU "
+                         "does not load or store them",
+                         *this),
+  m_debug_markers(m_painter_params.debug_markers(),
+                  "painter_debug_markers",
+                  "If true, the backend wraps its draws in GL_KHR_debug debug groups "
+                  "and labels its GL objects so that a GPU debugger names them",
+                  *this),
+  m_adaptive_buffer_sizes(m_painter_params.adaptive_buffer_sizes(),
+                          "painter_adaptive_buffer_sizes",
+                          "If true, the buffers to which the draws are streamed grow "
+                          "and shrink with the largest usage of the recent frames",
+                          *this),
+  m_adaptive_buffer_max_scale(m_painter_params.adaptive_buffer_max_scale(),
+                              "painter_adaptive_buffer_max_scale",
+                              "Only has effect if painter_adaptive_buffer_sizes is true, "
+                              "largest multiple of the configured buffer sizes to which "
+                              "the buffers may grow",
+                              *this),
   m_demo_options("Demo Options", *this),
-  m_print_painter_config(default_value_for_print_painter_config, "print_painter_config", "Print PainterBackendGL config", *this)
+  m_print_painter_config(default_value_for_print_painter_config, "print_painter_config", "Print PainterBackendGL config", *this),
+  m_glyph_generation_threads(1, "glyph_generation_threads",
+                             "maximum number of threads with which to generate the rendering data "
+                             "of glyphs of a sequence of characters, 0 means to use the number of "
+                             "threads of the default task executor",
+                             *this),
+  m_early_flush_attributes(0, "early_flush_attributes",
+                           "if non-zero, the draws of a frame are sent to the GPU as soon as "
+                           "they have this many attributes instead of waiting for the end of "
+                           "the frame or for the buffers to be full",
+                           *this),
+  m_early_flush_indices(0, "early_flush_indices",
+                        "if non-zero, the draws of a frame are sent to the GPU as soon as "
+                        "they have this many indices",
+                        *this),
+  m_trace_file("", "trace_file",
+               "If non-empty, record the Painter calls of the demo to this file "
+               "on exit, the trace can be replayed by painter-trace-replay",
+               *this),
+  m_trace_frames(0, "trace_frames",
+                 "maximum number of frames to record to trace_file, 0 means no limit",
+                 *this)
 {}
 
 sdl_painter_demo::
 ~sdl_painter_demo()
-{}
+{
+  if(m_trace)
+    {
+      std::vector<uint8_t> bytes;
+      std::ofstream ostr(m_trace_file.m_value.c_str(), std::ios::binary);
+
+      m_trace->write(bytes);
+      if(!bytes.empty())
+        {
+          ostr.write(reinterpret_cast<const char*>(&bytes[0]), bytes.size());
+        }
+      std::cout << "Wrote " << m_trace->number_frames() << " frames to \""
+                << m_trace_file.m_value << "\"\n";
+    }
+}
 
 void
 sdl_painter_demo::
@@ -261,7 +536,10 @@ init_gl(int w, int h)
     .log2_index_tile_size(m_log2_index_tile_size.m_value)
     .log2_num_index_tiles_per_row_per_col(m_log2_num_index_tiles_per_row_per_col.m_value)
     .num_index_layers(m_num_index_layers.m_value)
-    .delayed(m_image_atlas_delayed_upload.m_value);
+    .delayed(m_image_atlas_delayed_upload.m_value)
+    .compressed_color_tiles(m_image_atlas_compressed_color_tiles.m_value)
+    .direct_index_lookup(m_image_atlas_direct_index_lookup.m_value)
+    .cpu_mirror(m_image_atlas_cpu_mirror.m_value);
   m_image_atlas = FASTUIDRAWnew fastuidraw::gl::ImageAtlasGL(m_image_atlas_params);
 
   fastuidraw::ivec3 texel_dims(m_texel_store_width.m_value, m_texel_store_height.m_value, m_texel_store_num_layers.m_value);
@@ -269,7 +547,9 @@ init_gl(int w, int h)
     .texel_store_dimensions(texel_dims)
     .number_floats(m_geometry_store_size.m_value)
     .alignment(m_geometry_store_alignment.m_value)
-    .delayed(m_glyph_atlas_delayed_upload.m_value);
+    .delayed(m_glyph_atlas_delayed_upload.m_value)
+    .cpu_mirror(m_glyph_atlas_cpu_mirror.m_value)
+    .sixteen_bit_texel_store(m_glyph_atlas_sixteen_bit.m_value);
 
   switch(m_glyph_geometry_backing_store_type.m_value.m_value)
     {
@@ -304,11 +584,13 @@ init_gl(int w, int h)
         }
     }
   m_glyph_atlas = FASTUIDRAWnew fastuidraw::gl::GlyphAtlasGL(m_glyph_atlas_params);
+  m_glyph_atlas->shelf_max_height(m_glyph_atlas_shelf_max_height.m_value);
 
   m_colorstop_atlas_params
     .width(m_color_stop_atlas_width.m_value)
     .num_layers(m_color_stop_atlas_layers.m_value)
-    .delayed(m_color_stop_atlas_delayed_upload.m_value);
+    .delayed(m_color_stop_atlas_delayed_upload.m_value)
+    .cpu_mirror(m_color_stop_atlas_cpu_mirror.m_value);
 
   if(m_color_stop_atlas_use_optimal_width.m_value)
     {
@@ -335,20 +617,64 @@ init_gl(int w, int h)
     .frag_shader_use_switch(m_uber_frag_use_switch.m_value)
     .blend_shader_use_switch(m_uber_blend_use_switch.m_value)
     .unpack_header_and_brush_in_frag_shader(m_unpack_header_and_brush_in_frag_shader.m_value)
+    .pack_varyings(m_pack_varyings.m_value)
     .data_store_backing(m_data_store_backing.m_value.m_value)
     .assign_layout_to_vertex_shader_inputs(m_assign_layout_to_vertex_shader_inputs.m_value)
     .assign_layout_to_varyings(m_assign_layout_to_varyings.m_value)
     .assign_binding_points(m_assign_binding_points.m_value)
     .use_ubo_for_uniforms(m_use_ubo_for_uniforms.m_value)
+    .persistent_mapped_buffers(m_persistent_mapped_buffers.m_value)
+    .async_program_rebuild(m_async_program_rebuild.m_value)
+    .static_attributes_per_heap(m_static_attributes_per_heap.m_value)
+    .static_indices_per_heap(m_static_indices_per_heap.m_value)
+    .use_indirect_draw(m_use_indirect_draw.m_value)
+    .timer_query_frames(m_timer_query_frames.m_value)
+    .stencil_coverage(m_stencil_coverage.m_value)
+    .stencil_clipping(m_stencil_clipping.m_value)
+    .rounded_rect_clipping(m_rounded_rect_clipping.m_value)
+    .glyph_instancing(m_glyph_instancing.m_value)
+    .bindless_images(m_bindless_images.m_value)
+    .external_texture_images(m_external_texture_images.m_value)
+    .specialized_programs(m_specialized_programs.m_value)
+    .solid_brush_programs(m_solid_brush_programs.m_value)
+    .w3c_blend_modes(m_w3c_blend_modes.m_value)
+    .retain_gl_state_between_passes(m_retain_gl_state_between_passes.m_value)
+    .short_indices(m_short_indices.m_value)
+    .opaque_front_to_back(m_opaque_front_to_back.m_value)
+    .precision_policy(m_precision_policy.m_value.m_value)
+    .tile_based_rendering(m_tile_based_rendering.m_value)
+    .debug_markers(m_debug_markers.m_value)
+    .adaptive_buffer_sizes(m_adaptive_buffer_sizes.m_value)
+    .adaptive_buffer_max_scale(m_adaptive_buffer_max_scale.m_value)
     .separate_program_for_discard(m_separate_program_for_discard.m_value)
-    .non_dashed_stroke_shader_uses_discard(m_non_dashed_stroke_shader_uses_discard.m_value);
+    .non_dashed_stroke_shader_uses_discard(m_non_dashed_stroke_shader_uses_discard.m_value)
+    .dashed_stroke_shader_uses_discard(m_dashed_stroke_shader_uses_discard.m_value);
+
+  if(!m_program_binary_cache_dir.m_value.empty())
+    {
+      m_painter_params.program_binary_cache(FASTUIDRAWnew fastuidraw::gl::ProgramBinaryCacheDirectory(m_program_binary_cache_dir.m_value.c_str()));
+    }
+
+  if(m_calibrate_data_store_backing.m_value)
+    {
+      fastuidraw::gl::PainterBackendGL::calibrate_data_store_backing(m_painter_params);
+    }
 
   m_backend = FASTUIDRAWnew fastuidraw::gl::PainterBackendGL(m_painter_params, m_painter_base_params);
   m_painter = FASTUIDRAWnew fastuidraw::Painter(m_backend);
+  m_painter->early_flush_attributes(m_early_flush_attributes.m_value);
+  m_painter->early_flush_indices(m_early_flush_indices.m_value);
   m_glyph_cache = FASTUIDRAWnew fastuidraw::GlyphCache(m_painter->glyph_atlas());
   m_glyph_selector = FASTUIDRAWnew fastuidraw::GlyphSelector(m_glyph_cache);
+  m_glyph_selector->glyph_generation_threads(m_glyph_generation_threads.m_value);
   m_ft_lib = FASTUIDRAWnew fastuidraw::FreetypeLib();
 
+  if(!m_trace_file.m_value.empty())
+    {
+      m_trace = FASTUIDRAWnew fastuidraw::PainterTraceRecorder(m_trace_frames.m_value);
+      m_painter->trace(m_trace);
+    }
+
   if(m_print_painter_config.m_value)
     {
       std::cout << "\nPainterBackendGL configuration:\n";
@@ -365,21 +691,64 @@ init_gl(int w, int h)
       LAZY(frag_shader_use_switch);
       LAZY(blend_shader_use_switch);
       LAZY(unpack_header_and_brush_in_frag_shader);
+      LAZY(pack_varyings);
       LAZY(separate_program_for_discard);
+      LAZY(stencil_coverage);
+      LAZY(stencil_clipping);
+      LAZY(rounded_rect_clipping);
+      LAZY(specialized_programs);
+      LAZY(solid_brush_programs);
+      LAZY(w3c_blend_modes);
+      LAZY(retain_gl_state_between_passes);
       std::cout << "\n\nOptions affected by GL context\n";
       LAZY(use_hw_clip_planes);
       LAZY(data_blocks_per_store_buffer);
       LAZY(assign_layout_to_vertex_shader_inputs);
       LAZY(assign_layout_to_varyings);
       LAZY(use_ubo_for_uniforms);
+      LAZY(persistent_mapped_buffers);
+      LAZY(async_program_rebuild);
+      LAZY(static_attributes_per_heap);
+      LAZY(static_indices_per_heap);
+      LAZY(use_indirect_draw);
+      LAZY(timer_query_frames);
+      LAZY(glyph_instancing);
+      LAZY(bindless_images);
+      LAZY(external_texture_images);
+      LAZY(short_indices);
+      LAZY(opaque_front_to_back);
+      LAZY(precision_policy);
+      LAZY(tile_based_rendering);
+      LAZY(debug_markers);
+      LAZY(adaptive_buffer_sizes);
+      LAZY(adaptive_buffer_max_scale);
       std::cout << std::setw(40) << "alignment:" << std::setw(8) << m_backend->configuration_base().alignment()
                 << "  (requested " << m_painter_base_params.alignment()
                 << ")\n" << std::setw(40) << "data_store_backing:"
                 << std::setw(8) << string_from_data_store_type(m_backend->configuration_gl().data_store_backing())
                 << "  (requested " << string_from_data_store_type(m_painter_params.data_store_backing())
-                << ")\n\n\n";
+                << ")\n" << std::setw(40) << "blend_shader_type:"
+                << std::setw(8) << string_from_blend_shader_type(m_backend->configuration_glsl().default_blend_shader_type())
+                << "\n" << std::setw(40) << "blend_equation_advanced:"
+                << std::setw(8) << m_backend->configuration_glsl().blend_equation_advanced()
+                << "\n\n\n";
 
       #undef LAZY
+      std::cout << "Assembled GLSL source size in bytes of the programs (vertex, fragment) and varying slots:\n";
+      for(unsigned int i = 0; i < fastuidraw::gl::PainterBackendGL::number_program_types; ++i)
+        {
+          enum fastuidraw::gl::PainterBackendGL::program_type_t tp;
+          fastuidraw::reference_counted_ptr<fastuidraw::gl::Program> pr;
+
+          tp = static_cast<enum fastuidraw::gl::PainterBackendGL::program_type_t>(i);
+          pr = m_backend->program(tp);
+          std::cout << std::setw(40) << string_from_program_type(tp) << ": "
+                    << std::strlen(pr->shader_src_code(GL_VERTEX_SHADER, 0)) << ", "
+                    << std::strlen(pr->shader_src_code(GL_FRAGMENT_SHADER, 0)) << ", "
+                    << m_backend->varying_slot_count(tp) << " varyings\n";
+        }
+      std::cout << "\n";
+
       const fastuidraw::PainterShaderSet &sh(m_painter->default_shaders());
       std::cout << "Default shader IDs:\n";
 
@@ -46,6 +46,7 @@ protected:
 
 private:
   typedef enum fastuidraw::gl::PainterBackendGL::data_store_backing_t data_store_backing_t;
+  typedef enum fastuidraw::glsl::PainterBackendGLSL::precision_policy_t precision_policy_t;
   enum glyph_geometry_backing_store_t
     {
       glyph_geometry_backing_store_texture_buffer,
@@ -67,6 +68,9 @@ private:
   command_line_argument_value<int> m_log2_index_tile_size, m_log2_num_index_tiles_per_row_per_col;
   command_line_argument_value<int> m_num_index_layers;
   command_line_argument_value<bool> m_image_atlas_delayed_upload;
+  command_line_argument_value<bool> m_image_atlas_compressed_color_tiles;
+  command_line_argument_value<bool> m_image_atlas_direct_index_lookup;
+  command_line_argument_value<bool> m_image_atlas_cpu_mirror;
 
   /* Glyph atlas parameters
    */
@@ -75,6 +79,9 @@ private:
   command_line_argument_value<int> m_texel_store_num_layers, m_geometry_store_size;
   command_line_argument_value<int> m_geometry_store_alignment;
   command_line_argument_value<bool> m_glyph_atlas_delayed_upload;
+  command_line_argument_value<bool> m_glyph_atlas_cpu_mirror;
+  command_line_argument_value<int> m_glyph_atlas_shelf_max_height;
+  command_line_argument_value<bool> m_glyph_atlas_sixteen_bit;
   enumerated_command_line_argument_value<enum glyph_geometry_backing_store_t> m_glyph_geometry_backing_store_type;
   command_line_argument_value<int> m_glyph_geometry_backing_texture_log2_w, m_glyph_geometry_backing_texture_log2_h;
 
@@ -85,6 +92,7 @@ private:
   command_line_argument_value<bool> m_color_stop_atlas_use_optimal_width;
   command_line_argument_value<int> m_color_stop_atlas_layers;
   command_line_argument_value<bool> m_color_stop_atlas_delayed_upload;
+  command_line_argument_value<bool> m_color_stop_atlas_cpu_mirror;
 
   /* Painter params
    */
@@ -97,8 +105,10 @@ private:
   command_line_argument_value<bool> m_uber_frag_use_switch;
   command_line_argument_value<bool> m_uber_blend_use_switch;
   command_line_argument_value<bool> m_unpack_header_and_brush_in_frag_shader;
+  command_line_argument_value<bool> m_pack_varyings;
   command_line_argument_value<bool> m_separate_program_for_discard;
   command_line_argument_value<bool> m_non_dashed_stroke_shader_uses_discard;
+  command_line_argument_value<bool> m_dashed_stroke_shader_uses_discard;
 
   /* Painter params that can be overridden by properties of GL context
    */
@@ -111,7 +121,38 @@ private:
   command_line_argument_value<bool> m_assign_layout_to_varyings;
   command_line_argument_value<bool> m_assign_binding_points;
   command_line_argument_value<bool> m_use_ubo_for_uniforms;
+  command_line_argument_value<bool> m_persistent_mapped_buffers;
+  command_line_argument_value<std::string> m_program_binary_cache_dir;
+  command_line_argument_value<bool> m_calibrate_data_store_backing;
+  command_line_argument_value<bool> m_async_program_rebuild;
+  command_line_argument_value<unsigned int> m_static_attributes_per_heap;
+  command_line_argument_value<unsigned int> m_static_indices_per_heap;
+  command_line_argument_value<bool> m_use_indirect_draw;
+  command_line_argument_value<unsigned int> m_timer_query_frames;
+  command_line_argument_value<bool> m_stencil_coverage;
+  command_line_argument_value<bool> m_stencil_clipping;
+  command_line_argument_value<bool> m_rounded_rect_clipping;
+  command_line_argument_value<bool> m_glyph_instancing;
+  command_line_argument_value<bool> m_bindless_images;
+  command_line_argument_value<bool> m_external_texture_images;
+  command_line_argument_value<unsigned int> m_specialized_programs;
+  command_line_argument_value<bool> m_solid_brush_programs;
+  command_line_argument_value<bool> m_w3c_blend_modes;
+  command_line_argument_value<bool> m_retain_gl_state_between_passes;
+  command_line_argument_value<bool> m_short_indices;
+  command_line_argument_value<bool> m_opaque_front_to_back;
+  enumerated_command_line_argument_value<precision_policy_t> m_precision_policy;
+  command_line_argument_value<bool> m_tile_based_rendering;
+  command_line_argument_value<bool> m_debug_markers;
+  command_line_argument_value<bool> m_adaptive_buffer_sizes;
+  command_line_argument_value<unsigned int> m_adaptive_buffer_max_scale;
 
   command_separator m_demo_options;
   command_line_argument_value<bool> m_print_painter_config;
+  command_line_argument_value<unsigned int> m_glyph_generation_threads;
+  command_line_argument_value<unsigned int> m_early_flush_attributes;
+  command_line_argument_value<unsigned int> m_early_flush_indices;
+  command_line_argument_value<std::string> m_trace_file;
+  command_line_argument_value<unsigned int> m_trace_frames;
+  fastuidraw::reference_counted_ptr<fastuidraw::PainterTraceRecorder> m_trace;
 };
@@ -0,0 +1,909 @@
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <fstream>
+#include <sstream>
+#include <fastuidraw/painter/painter.hpp>
+#include <fastuidraw/painter/glyph_run_cache.hpp>
+#include <fastuidraw/text/glyph_cache.hpp>
+#include <fastuidraw/text/freetype_font.hpp>
+
+#include "sdl_painter_demo.hpp"
+#include "simple_time.hpp"
+#include "random.hpp"
+
+using namespace fastuidraw;
+
+/*
+  painter-benchmark renders a fixed catalogue of scenes to an
+  offscreen FBO for a fixed number of frames each and writes
+  the CPU time, GPU time and the stats counters of each scene
+  as JSON. The GPU time is only available if the backend is
+  created with a non-zero painter_timer_query_frames; since
+  that value is read back a few frames late, the warm-up frames
+  should be at least painter_timer_query_frames.
+
+  The heap allocations of each frame between Painter::begin()
+  and Painter::end() are counted by replacing the global operator
+  new and operator delete, as path-benchmark does; this counts
+  the allocations of all code, including the backend and the
+  threads of FastUIDraw. In debug builds FASTUIDRAWnew goes
+  through the tracked allocator of FastUIDraw and is not counted.
+ */
+
+namespace
+{
+  uint64_t allocation_count = 0;
+
+  void*
+  counted_allocate(std::size_t sz)
+  {
+    void *p;
+
+    ++allocation_count;
+    p = std::malloc(sz != 0 ? sz : 1);
+    if(p == NULL)
+      {
+        throw std::bad_alloc();
+      }
+    return p;
+  }
+}
+
+void*
+operator new(std::size_t sz)
+{
+  return counted_allocate(sz);
+}
+
+void*
+operator new[](std::size_t sz)
+{
+  return counted_allocate(sz);
+}
+
+void
+operator delete(void *p) throw()
+{
+  std::free(p);
+}
+
+void
+operator delete[](void *p) throw()
+{
+  std::free(p);
+}
+
+class painter_benchmark:public sdl_painter_demo
+{
+public:
+  painter_benchmark(void);
+  ~painter_benchmark();
+
+protected:
+  void
+  derived_init(int w, int h);
+
+  void
+  draw_frame(void);
+
+  void
+  handle_event(const SDL_Event &ev);
+
+private:
+  enum scene_t
+    {
+      fill_heavy_scene,
+      stroke_heavy_scene,
+      dashed_stroke_scene,
+      long_dashed_stroke_scene,
+      glyph_heavy_scene,
+      image_brush_scene,
+      clip_heavy_scene,
+      many_small_items_scene,
+      large_text_curve_pair_scene,
+      large_text_banded_curves_scene,
+      large_text_distance_field_scene,
+      large_text_msdf_scene,
+      rounded_rect_scene,
+      labels_scene,
+      labels_cached_scene,
+
+      number_scenes
+    };
+
+  class scene_result
+  {
+  public:
+    scene_result(void):
+      m_frames(0),
+      m_cpu_us_total(0),
+      m_cpu_us_min(0),
+      m_cpu_us_max(0),
+      m_gpu_us_total(0),
+      m_allocations_total(0),
+      m_allocations_max(0),
+      m_packer_stats(PainterPacker::num_stats, 0),
+      m_glyph_cache_stats(GlyphCache::num_stats, 0)
+    {}
+
+    int m_frames;
+    uint64_t m_cpu_us_total, m_cpu_us_min, m_cpu_us_max;
+    uint64_t m_gpu_us_total;
+    uint64_t m_allocations_total, m_allocations_max;
+    std::vector<uint64_t> m_packer_stats;
+    std::vector<uint64_t> m_glyph_cache_stats;
+  };
+
+  static
+  const char*
+  scene_name(enum scene_t s);
+
+  static
+  const char*
+  packer_stat_name(enum PainterPacker::stats_t s);
+
+  static
+  const char*
+  glyph_cache_stat_name(enum GlyphCache::stats_t s);
+
+  void
+  parse_scene_list(void);
+
+  void
+  create_and_bind_fbo(void);
+
+  void
+  make_scene_data(void);
+
+  void
+  draw_scene(enum scene_t s);
+
+  void
+  record_frame(uint64_t cpu_us, uint64_t allocations);
+
+  void
+  write_results(std::ostream &ostr);
+
+  command_line_argument_value<int> m_num_frames;
+  command_line_argument_value<int> m_num_warmup_frames;
+  command_line_argument_value<std::string> m_scene_list;
+  command_line_argument_value<std::string> m_output_file;
+  command_line_argument_value<std::string> m_font_file;
+  command_line_argument_value<int> m_num_items;
+  command_line_argument_value<int> m_long_dash_pattern_length;
+  command_line_argument_value<bool> m_split_dashed_edges;
+  command_line_argument_value<float> m_stroke_lod_pixel_width;
+  command_line_argument_value<bool> m_reserve;
+  command_line_argument_value<int> m_fbo_width, m_fbo_height;
+
+  std::vector<enum scene_t> m_scenes;
+  std::vector<scene_result> m_results;
+  unsigned int m_current_scene;
+  int m_frame;
+
+  ivec2 m_fbo_size;
+  GLuint m_fbo, m_color, m_depth_stencil;
+
+  std::vector<Path> m_paths;
+  std::vector<vec2> m_positions;
+  std::vector<vec4> m_colors;
+  Path m_clip_path;
+  reference_counted_ptr<const FontBase> m_font;
+  reference_counted_ptr<const Image> m_image;
+  std::string m_text;
+  std::vector<std::string> m_labels;
+  std::vector<std::vector<uint32_t> > m_label_codes;
+  GlyphSelector::FontGroup m_label_group;
+  reference_counted_ptr<GlyphRunCache> m_run_cache;
+  std::vector<PainterDashedStrokeParams::DashPatternElement> m_dash_pattern;
+  std::vector<PainterDashedStrokeParams::DashPatternElement> m_long_dash_pattern;
+};
+
+painter_benchmark::
+painter_benchmark(void):
+  sdl_painter_demo("painter-benchmark: render a fixed catalogue of scenes offscreen and report timings and stats as JSON"),
+  m_num_frames(100, "num_frames", "Number of frames to time per scene", *this),
+  m_num_warmup_frames(10, "num_warmup_frames",
+                      "Number of frames to render per scene before timing; "
+                      "should be at least painter_timer_query_frames for the GPU times "
+                      "to not include the previous scene",
+                      *this),
+  m_scene_list("all", "scenes",
+               "Comma separated list of scenes to run, or \"all\"; the scenes are "
+               "fill_heavy, stroke_heavy, dashed_stroke, long_dashed_stroke, glyph_heavy, image_brush, "
+               "clip_heavy, many_small_items, large_text_curve_pair, large_text_banded_curves, "
+               "large_text_distance_field, large_text_msdf, rounded_rect, labels and labels_cached",
+               *this),
+  m_output_file("", "output", "File to which to write the JSON results, empty means stdout", *this),
+  m_font_file("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", "font", "File from which to take font", *this),
+  m_num_items(256, "num_items",
+              "Number of items drawn by each scene; many_small_items draws 16 times as many",
+              *this),
+  m_long_dash_pattern_length(32, "long_dash_pattern_length",
+                             "Number of elements of the dash pattern of long_dashed_stroke; "
+                             "compare against dashed_stroke, whose dash pattern has 2 elements, "
+                             "to see the cost of the dash pattern lookup",
+                             *this),
+  m_split_dashed_edges(false, "split_dashed_edges",
+                       "If true, split the edges of dashed strokes at the boundaries of "
+                       "the dash pattern on the CPU, see Painter::splitDashedEdges()",
+                       *this),
+  m_stroke_lod_pixel_width(0.0f, "stroke_lod_pixel_width",
+                           "Width in pixels below which strokes of paths are drawn "
+                           "without caps, with simpler joins and a coarser tessellation, "
+                           "see Painter::strokeLODPixelWidth()",
+                           *this),
+  m_reserve(false, "reserve",
+            "If true, reserve the capacities of the default Painter::Budget "
+            "before the first frame, see Painter::reserve()",
+            *this),
+  m_fbo_width(0, "fbo_width", "width of FBO to which to render (value of 0 means match window)", *this),
+  m_fbo_height(0, "fbo_height", "height of FBO to which to render (value of 0 means match window)", *this),
+  m_current_scene(0),
+  m_frame(0),
+  m_fbo(0),
+  m_color(0),
+  m_depth_stencil(0)
+{
+  // the benchmark does not react to input
+  m_handle_events = false;
+}
+
+painter_benchmark::
+~painter_benchmark()
+{
+  if(m_fbo != 0)
+    {
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      glDeleteFramebuffers(1, &m_fbo);
+      glDeleteTextures(1, &m_color);
+      glDeleteTextures(1, &m_depth_stencil);
+    }
+}
+
+const char*
+painter_benchmark::
+scene_name(enum scene_t s)
+{
+  switch(s)
+    {
+    case fill_heavy_scene: return "fill_heavy";
+    case stroke_heavy_scene: return "stroke_heavy";
+    case dashed_stroke_scene: return "dashed_stroke";
+    case long_dashed_stroke_scene: return "long_dashed_stroke";
+    case glyph_heavy_scene: return "glyph_heavy";
+    case image_brush_scene: return "image_brush";
+    case clip_heavy_scene: return "clip_heavy";
+    case many_small_items_scene: return "many_small_items";
+    case large_text_curve_pair_scene: return "large_text_curve_pair";
+    case large_text_banded_curves_scene: return "large_text_banded_curves";
+    case large_text_distance_field_scene: return "large_text_distance_field";
+    case large_text_msdf_scene: return "large_text_msdf";
+    case rounded_rect_scene: return "rounded_rect";
+    case labels_scene: return "labels";
+    case labels_cached_scene: return "labels_cached";
+    default: return "unknown";
+    }
+}
+
+const char*
+painter_benchmark::
+packer_stat_name(enum PainterPacker::stats_t s)
+{
+  switch(s)
+    {
+    case PainterPacker::num_attributes: return "num_attributes";
+    case PainterPacker::num_indices: return "num_indices";
+    case PainterPacker::num_generic_datas: return "num_generic_datas";
+    case PainterPacker::num_draws: return "num_draws";
+    case PainterPacker::num_headers: return "num_headers";
+    case PainterPacker::num_headers_shared: return "num_headers_shared";
+    case PainterPacker::num_bytes_saved: return "num_bytes_saved";
+    case PainterPacker::num_draw_breaks_shader_change: return "num_draw_breaks_shader_change";
+    case PainterPacker::num_draw_breaks_blend_mode_change: return "num_draw_breaks_blend_mode_change";
+    case PainterPacker::num_draw_breaks_buffer_full: return "num_draw_breaks_buffer_full";
+    case PainterPacker::num_filled_path_subsets_selected: return "num_filled_path_subsets_selected";
+    case PainterPacker::num_filled_path_subsets_culled: return "num_filled_path_subsets_culled";
+    case PainterPacker::num_filled_path_clusters_culled: return "num_filled_path_clusters_culled";
+    case PainterPacker::num_stencil_filled_paths: return "num_stencil_filled_paths";
+    case PainterPacker::num_stroked_path_chunks_selected: return "num_stroked_path_chunks_selected";
+    case PainterPacker::num_stroked_path_join_chunks_selected: return "num_stroked_path_join_chunks_selected";
+    case PainterPacker::num_stroked_path_cap_chunks_selected: return "num_stroked_path_cap_chunks_selected";
+    case PainterPacker::num_clip_cache_hits: return "num_clip_cache_hits";
+    case PainterPacker::num_clip_cache_misses: return "num_clip_cache_misses";
+    case PainterPacker::num_clip_free_draws: return "num_clip_free_draws";
+    case PainterPacker::num_draws_culled: return "num_draws_culled";
+    case PainterPacker::num_stencil_clips: return "num_stencil_clips";
+    case PainterPacker::num_stream_draws_reordered: return "num_stream_draws_reordered";
+    case PainterPacker::num_stream_draws_occluded: return "num_stream_draws_occluded";
+    case PainterPacker::num_early_flushes: return "num_early_flushes";
+    case PainterPacker::num_unbudgeted_allocations: return "num_unbudgeted_allocations";
+    case PainterPacker::num_atlas_upload_bytes: return "num_atlas_upload_bytes";
+    case PainterPacker::num_backend_draw_calls: return "num_backend_draw_calls";
+    case PainterPacker::backend_gpu_time_micro_seconds: return "backend_gpu_time_micro_seconds";
+    case PainterPacker::backend_num_atlas_resizes: return "backend_num_atlas_resizes";
+    case PainterPacker::backend_num_mid_pass_atlas_flushes: return "backend_num_mid_pass_atlas_flushes";
+    case PainterPacker::backend_num_buffer_grows: return "backend_num_buffer_grows";
+    case PainterPacker::backend_num_buffer_shrinks: return "backend_num_buffer_shrinks";
+    default: return "unknown";
+    }
+}
+
+const char*
+painter_benchmark::
+glyph_cache_stat_name(enum GlyphCache::stats_t s)
+{
+  switch(s)
+    {
+    case GlyphCache::num_hits: return "num_hits";
+    case GlyphCache::num_misses: return "num_misses";
+    case GlyphCache::num_uploads: return "num_uploads";
+    case GlyphCache::num_evictions: return "num_evictions";
+    case GlyphCache::num_relocations: return "num_relocations";
+    case GlyphCache::num_layout_misses: return "num_layout_misses";
+    default: return "unknown";
+    }
+}
+
+void
+painter_benchmark::
+parse_scene_list(void)
+{
+  std::istringstream istr(m_scene_list.m_value);
+  std::string token;
+
+  while(std::getline(istr, token, ','))
+    {
+      bool found(false);
+
+      if(token == "all")
+        {
+          for(int s = 0; s < number_scenes; ++s)
+            {
+              m_scenes.push_back(static_cast<enum scene_t>(s));
+            }
+          continue;
+        }
+
+      for(int s = 0; s < number_scenes && !found; ++s)
+        {
+          if(token == scene_name(static_cast<enum scene_t>(s)))
+            {
+              m_scenes.push_back(static_cast<enum scene_t>(s));
+              found = true;
+            }
+        }
+
+      if(!found)
+        {
+          std::cerr << "Unknown scene \"" << token << "\" ignored\n";
+        }
+    }
+  m_results.resize(m_scenes.size());
+}
+
+void
+painter_benchmark::
+create_and_bind_fbo(void)
+{
+  glGenFramebuffers(1, &m_fbo);
+  assert(m_fbo != 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+
+  glGenTextures(1, &m_color);
+  assert(m_color != 0);
+  glBindTexture(GL_TEXTURE_2D, m_color);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
+               m_fbo_size.x(), m_fbo_size.y(), 0,
+               GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+  glGenTextures(1, &m_depth_stencil);
+  assert(m_depth_stencil != 0);
+  glBindTexture(GL_TEXTURE_2D, m_depth_stencil);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8,
+               m_fbo_size.x(), m_fbo_size.y(), 0,
+               GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                         GL_TEXTURE_2D, m_color, 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                         GL_TEXTURE_2D, m_depth_stencil, 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
+                         GL_TEXTURE_2D, m_depth_stencil, 0);
+}
+
+void
+painter_benchmark::
+make_scene_data(void)
+{
+  int count(m_num_items.m_value);
+  vec2 wh(m_fbo_size);
+
+  /* a mix of curved and polygonal paths so that filling
+     and stroking exercise both arcs and beziers.
+   */
+  m_paths.resize(4);
+  m_paths[0] << vec2(0.0f, 0.0f)
+             << vec2(60.0f, 0.0f)
+             << vec2(60.0f, 60.0f)
+             << vec2(0.0f, 60.0f)
+             << Path::contour_end();
+
+  m_paths[1] << vec2(30.0f, 0.0f)
+             << Path::arc(static_cast<float>(M_PI), vec2(30.0f, 60.0f))
+             << Path::contour_end_arc(static_cast<float>(M_PI));
+
+  m_paths[2] << vec2(0.0f, 60.0f)
+             << Path::control_point(30.0f, -40.0f)
+             << vec2(60.0f, 60.0f)
+             << Path::control_point(30.0f, 20.0f)
+             << Path::contour_end();
+
+  for(int i = 0; i < 5; ++i)
+    {
+      float a, r;
+      a = static_cast<float>(M_PI) * (0.5f + 0.8f * static_cast<float>(i));
+      r = 30.0f;
+      m_paths[3] << vec2(30.0f + r * std::cos(a), 30.0f - r * std::sin(a));
+    }
+  m_paths[3] << Path::contour_end();
+
+  m_clip_path << vec2(20.0f, 20.0f)
+              << Path::arc(static_cast<float>(M_PI), vec2(40.0f, 40.0f))
+              << Path::contour_end_arc(static_cast<float>(M_PI));
+
+  m_positions.resize(16 * count);
+  m_colors.resize(16 * count);
+  for(unsigned int i = 0, endi = m_positions.size(); i < endi; ++i)
+    {
+      m_positions[i] = random_value(vec2(0.0f, 0.0f), wh - vec2(60.0f, 60.0f));
+      m_colors[i] = random_value(vec4(0.0f, 0.0f, 0.0f, 0.2f),
+                                 vec4(1.0f, 1.0f, 1.0f, 0.8f));
+    }
+
+  m_font = FontFreeType::create(m_font_file.m_value.c_str(), m_ft_lib, FontFreeType::RenderParams());
+  m_text = "The quick brown fox jumps over the lazy dog 0123456789\n"
+    "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG !@#$%^&*()\n";
+
+  /* the labels of a list view, the same labels are
+     drawn each frame.
+   */
+  m_labels.resize(count);
+  m_label_codes.resize(count);
+  for(int i = 0; i < count; ++i)
+    {
+      std::ostringstream str;
+      str << "List item " << i;
+      m_labels[i] = str.str();
+      m_label_codes[i].assign(m_labels[i].begin(), m_labels[i].end());
+    }
+  m_glyph_selector->add_font(m_font);
+  m_label_group = m_glyph_selector->fetch_group(m_font->properties());
+  m_run_cache = FASTUIDRAWnew GlyphRunCache(m_glyph_selector, count);
+
+  /* generated checkerboard so that the benchmark does not
+     depend on image files.
+   */
+  const int image_size(256);
+  std::vector<u8vec4> image_data(image_size * image_size);
+  for(int y = 0; y < image_size; ++y)
+    {
+      for(int x = 0; x < image_size; ++x)
+        {
+          bool on(((x / 16) + (y / 16)) % 2 == 0);
+          image_data[x + y * image_size] = (on) ?
+            u8vec4(255, 128, 0, 255) :
+            u8vec4(0, 64, 255, 255);
+        }
+    }
+  m_image = Image::create(m_painter->image_atlas(), image_size, image_size,
+                          cast_c_array(image_data), 0);
+
+  m_dash_pattern.resize(2);
+  m_dash_pattern[0].m_draw_length = 10.0f;
+  m_dash_pattern[0].m_space_length = 5.0f;
+  m_dash_pattern[1].m_draw_length = 2.0f;
+  m_dash_pattern[1].m_space_length = 5.0f;
+
+  /* short dashes so that each stroke covers many
+     intervals of the pattern.
+   */
+  m_long_dash_pattern.resize(std::max(1, m_long_dash_pattern_length.m_value));
+  for(unsigned int i = 0, endi = m_long_dash_pattern.size(); i < endi; ++i)
+    {
+      m_long_dash_pattern[i].m_draw_length = 1.0f + static_cast<float>(i % 3);
+      m_long_dash_pattern[i].m_space_length = 1.0f + static_cast<float>(i % 2);
+    }
+}
+
+void
+painter_benchmark::
+derived_init(int w, int h)
+{
+  m_fbo_size = ivec2(w, h);
+  if(m_fbo_width.m_value > 0 && m_fbo_height.m_value > 0)
+    {
+      m_fbo_size = ivec2(m_fbo_width.m_value, m_fbo_height.m_value);
+    }
+
+  create_and_bind_fbo();
+  m_painter->target_resolution(m_fbo_size.x(), m_fbo_size.y());
+  m_painter->splitDashedEdges(m_split_dashed_edges.m_value);
+  m_painter->strokeLODPixelWidth(m_stroke_lod_pixel_width.m_value);
+  if(m_reserve.m_value)
+    {
+      m_painter->reserve(Painter::Budget());
+    }
+
+  parse_scene_list();
+  make_scene_data();
+
+  m_current_scene = 0;
+  m_frame = -m_num_warmup_frames.m_value;
+}
+
+void
+painter_benchmark::
+draw_scene(enum scene_t s)
+{
+  unsigned int count(m_num_items.m_value);
+  PainterBrush brush;
+
+  switch(s)
+    {
+    case fill_heavy_scene:
+      for(unsigned int i = 0; i < count; ++i)
+        {
+          brush.pen(m_colors[i]);
+          m_painter->save();
+          m_painter->translate(m_positions[i]);
+          m_painter->fill_path(PainterData(&brush), m_paths[i % m_paths.size()],
+                               PainterEnums::nonzero_fill_rule);
+          m_painter->restore();
+        }
+      break;
+
+    case stroke_heavy_scene:
+      {
+        PainterStrokeParams st;
+        st.miter_limit(5.0f);
+        st.width(8.0f);
+        for(unsigned int i = 0; i < count; ++i)
+          {
+            brush.pen(m_colors[i]);
+            m_painter->save();
+            m_painter->translate(m_positions[i]);
+            m_painter->stroke_path(PainterData(&brush, &st), m_paths[i % m_paths.size()],
+                                   true, PainterEnums::rounded_caps, PainterEnums::rounded_joins,
+                                   true);
+            m_painter->restore();
+          }
+      }
+      break;
+
+    case dashed_stroke_scene:
+      {
+        PainterDashedStrokeParams st;
+        st.miter_limit(5.0f);
+        st.width(4.0f);
+        st.dash_pattern(cast_c_array(m_dash_pattern));
+        for(unsigned int i = 0; i < count; ++i)
+          {
+            brush.pen(m_colors[i]);
+            m_painter->save();
+            m_painter->translate(m_positions[i]);
+            m_painter->stroke_dashed_path(PainterData(&brush, &st), m_paths[i % m_paths.size()],
+                                          true, PainterEnums::square_caps, PainterEnums::miter_joins,
+                                          true);
+            m_painter->restore();
+          }
+      }
+      break;
+
+    case long_dashed_stroke_scene:
+      {
+        /* wide strokes so that the scene is bound by
+           the dash pattern lookup of the fragment shader.
+         */
+        PainterDashedStrokeParams st;
+        st.miter_limit(5.0f);
+        st.width(16.0f);
+        st.dash_pattern(cast_c_array(m_long_dash_pattern));
+        for(unsigned int i = 0; i < count; ++i)
+          {
+            brush.pen(m_colors[i]);
+            m_painter->save();
+            m_painter->translate(m_positions[i]);
+            m_painter->stroke_dashed_path(PainterData(&brush, &st), m_paths[i % m_paths.size()],
+                                          true, PainterEnums::flat_caps, PainterEnums::bevel_joins,
+                                          true);
+            m_painter->restore();
+          }
+      }
+      break;
+
+    case glyph_heavy_scene:
+      for(unsigned int i = 0; i < count; ++i)
+        {
+          brush.pen(m_colors[i]);
+          m_painter->save();
+          m_painter->translate(m_positions[i]);
+          m_painter->rotate(static_cast<float>(i) * 0.1f);
+          draw_text(m_text, 16.0f, m_font, GlyphRender(curve_pair_glyph), PainterData(&brush));
+          m_painter->restore();
+        }
+      break;
+
+    case large_text_curve_pair_scene:
+    case large_text_banded_curves_scene:
+    case large_text_distance_field_scene:
+    case large_text_msdf_scene:
+      {
+        /* few glyphs drawn large so that the scene is bound by
+           the fragment shader of the glyphs; compare the
+           scenes to compare the glyph formats.
+         */
+        enum glyph_type tp;
+        switch(s)
+          {
+          case large_text_curve_pair_scene: tp = curve_pair_glyph; break;
+          case large_text_banded_curves_scene: tp = banded_curves_glyph; break;
+          case large_text_distance_field_scene: tp = distance_field_glyph; break;
+          default: tp = msdf_glyph;
+          }
+
+        GlyphRender render(tp);
+        for(unsigned int i = 0, endi = std::max(1u, count / 16u); i < endi; ++i)
+          {
+            brush.pen(m_colors[i]);
+            m_painter->save();
+            m_painter->translate(m_positions[i]);
+            m_painter->rotate(static_cast<float>(i) * 0.1f);
+            draw_text(m_text, 192.0f, m_font, render, PainterData(&brush));
+            m_painter->restore();
+          }
+      }
+      break;
+
+    case image_brush_scene:
+      brush.image(m_image);
+      brush.pen(1.0f, 1.0f, 1.0f, 1.0f);
+      for(unsigned int i = 0; i < count; ++i)
+        {
+          m_painter->save();
+          m_painter->translate(m_positions[i]);
+          m_painter->rotate(static_cast<float>(i) * 0.1f);
+          m_painter->draw_rect(PainterData(&brush), vec2(0.0f, 0.0f), vec2(m_image->dimensions()) * 0.25f);
+          m_painter->restore();
+        }
+      break;
+
+    case clip_heavy_scene:
+      for(unsigned int i = 0; i < count; ++i)
+        {
+          brush.pen(m_colors[i]);
+          m_painter->save();
+          m_painter->translate(m_positions[i]);
+          m_painter->clipInRect(vec2(5.0f, 5.0f), vec2(50.0f, 50.0f));
+          m_painter->clipOutPath(m_clip_path, PainterEnums::nonzero_fill_rule);
+          m_painter->fill_path(PainterData(&brush), m_paths[i % m_paths.size()],
+                               PainterEnums::nonzero_fill_rule);
+          m_painter->restore();
+        }
+      break;
+
+    case many_small_items_scene:
+      for(unsigned int i = 0, endi = 16 * count; i < endi; ++i)
+        {
+          brush.pen(m_colors[i]);
+          m_painter->draw_rect(PainterData(&brush), m_positions[i], vec2(4.0f, 4.0f));
+        }
+      break;
+
+    case rounded_rect_scene:
+      {
+        /* UI panels: a blurred drop shadow under each
+           rounded rect, both drawn as a single quad.
+         */
+        PainterBrush shadow_brush;
+
+        shadow_brush.pen(0.0f, 0.0f, 0.0f, 0.5f);
+        for(unsigned int i = 0; i < count; ++i)
+          {
+            brush.pen(m_colors[i]);
+            m_painter->draw_box_shadow(PainterData(&shadow_brush), m_positions[i] + vec2(4.0f, 6.0f),
+                                       vec2(120.0f, 80.0f), 12.0f, 6.0f);
+            m_painter->draw_rounded_rect(PainterData(&brush), m_positions[i],
+                                         vec2(120.0f, 80.0f), 12.0f);
+          }
+      }
+      break;
+
+    case labels_scene:
+    case labels_cached_scene:
+      {
+        /* labels_scene selects the glyphs of each label and
+           packs them every frame, labels_cached_scene fetches
+           the GlyphRun of each label from a GlyphRunCache.
+         */
+        GlyphRender render(16);
+        for(unsigned int i = 0; i < count; ++i)
+          {
+            brush.pen(m_colors[i]);
+            m_painter->save();
+            m_painter->translate(vec2(10.0f, 20.0f * static_cast<float>(i % 32) + 20.0f)
+                                 + vec2(200.0f * static_cast<float>(i / 32), 0.0f));
+            if(s == labels_scene)
+              {
+                draw_text(m_labels[i], 16.0f, m_font, render, PainterData(&brush));
+              }
+            else
+              {
+                const GlyphRun &run(m_run_cache->fetch_run(cast_c_array(m_label_codes[i]),
+                                                           m_label_group, render, 16.0f));
+                m_painter->draw_glyphs(PainterData(&brush), run.data());
+              }
+            m_painter->restore();
+          }
+      }
+      break;
+
+    default:
+      break;
+    }
+}
+
+void
+painter_benchmark::
+record_frame(uint64_t cpu_us, uint64_t allocations)
+{
+  scene_result &R(m_results[m_current_scene]);
+
+  if(R.m_frames == 0)
+    {
+      R.m_cpu_us_min = R.m_cpu_us_max = cpu_us;
+    }
+  else
+    {
+      R.m_cpu_us_min = std::min(R.m_cpu_us_min, cpu_us);
+      R.m_cpu_us_max = std::max(R.m_cpu_us_max, cpu_us);
+    }
+  ++R.m_frames;
+  R.m_cpu_us_total += cpu_us;
+  R.m_allocations_total += allocations;
+  R.m_allocations_max = std::max(R.m_allocations_max, allocations);
+  R.m_gpu_us_total += m_painter->query_stat(PainterPacker::backend_gpu_time_micro_seconds);
+
+  for(int i = 0; i < PainterPacker::num_stats; ++i)
+    {
+      R.m_packer_stats[i] += m_painter->query_stat(static_cast<enum PainterPacker::stats_t>(i));
+    }
+
+  for(int i = 0; i < GlyphCache::num_stats; ++i)
+    {
+      R.m_glyph_cache_stats[i] += m_glyph_cache->query_stat(static_cast<enum GlyphCache::stats_t>(i));
+    }
+}
+
+void
+painter_benchmark::
+write_results(std::ostream &ostr)
+{
+  ostr << "{\n"
+       << "  \"fbo_width\": " << m_fbo_size.x() << ",\n"
+       << "  \"fbo_height\": " << m_fbo_size.y() << ",\n"
+       << "  \"num_items\": " << m_num_items.m_value << ",\n"
+       << "  \"scenes\": [\n";
+
+  for(unsigned int s = 0, ends = m_scenes.size(); s < ends; ++s)
+    {
+      const scene_result &R(m_results[s]);
+      double denom(std::max(R.m_frames, 1));
+
+      ostr << "    {\n"
+           << "      \"name\": \"" << scene_name(m_scenes[s]) << "\",\n"
+           << "      \"frames\": " << R.m_frames << ",\n"
+           << "      \"cpu_us_avg\": " << static_cast<double>(R.m_cpu_us_total) / denom << ",\n"
+           << "      \"cpu_us_min\": " << R.m_cpu_us_min << ",\n"
+           << "      \"cpu_us_max\": " << R.m_cpu_us_max << ",\n"
+           << "      \"gpu_us_avg\": " << static_cast<double>(R.m_gpu_us_total) / denom << ",\n"
+           << "      \"heap_allocations_avg\": " << static_cast<double>(R.m_allocations_total) / denom << ",\n"
+           << "      \"heap_allocations_max\": " << R.m_allocations_max << ",\n"
+           << "      \"painter_stats_avg\": {\n";
+      for(int i = 0; i < PainterPacker::num_stats; ++i)
+        {
+          ostr << "        \"" << packer_stat_name(static_cast<enum PainterPacker::stats_t>(i))
+               << "\": " << static_cast<double>(R.m_packer_stats[i]) / denom
+               << ((i + 1 < PainterPacker::num_stats) ? ",\n" : "\n");
+        }
+      ostr << "      },\n"
+           << "      \"glyph_cache_stats_avg\": {\n";
+      for(int i = 0; i < GlyphCache::num_stats; ++i)
+        {
+          ostr << "        \"" << glyph_cache_stat_name(static_cast<enum GlyphCache::stats_t>(i))
+               << "\": " << static_cast<double>(R.m_glyph_cache_stats[i]) / denom
+               << ((i + 1 < GlyphCache::num_stats) ? ",\n" : "\n");
+        }
+      ostr << "      }\n"
+           << "    }" << ((s + 1 < ends) ? ",\n" : "\n");
+    }
+  ostr << "  ]\n"
+       << "}\n";
+}
+
+void
+painter_benchmark::
+draw_frame(void)
+{
+  if(m_current_scene >= m_scenes.size())
+    {
+      if(m_output_file.m_value.empty())
+        {
+          write_results(std::cout);
+        }
+      else
+        {
+          std::ofstream ostr(m_output_file.m_value.c_str());
+          write_results(ostr);
+        }
+      end_demo(0);
+      return;
+    }
+
+  simple_time timer;
+
+  glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+  glViewport(0, 0, m_fbo_size.x(), m_fbo_size.y());
+  glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+  m_glyph_cache->reset_stats();
+  m_glyph_cache->begin_frame();
+  timer.restart();
+
+  uint64_t allocations_start(allocation_count);
+  m_painter->begin();
+  float3x3 proj(float_orthogonal_projection_params(0, m_fbo_size.x(), m_fbo_size.y(), 0));
+  m_painter->transformation(proj);
+  draw_scene(m_scenes[m_current_scene]);
+  m_painter->end();
+
+  uint64_t cpu_us(timer.elapsed_us());
+  uint64_t allocations(allocation_count - allocations_start);
+
+  if(m_frame >= 0)
+    {
+      record_frame(cpu_us, allocations);
+    }
+
+  ++m_frame;
+  if(m_frame == m_num_frames.m_value)
+    {
+      ++m_current_scene;
+      m_frame = -m_num_warmup_frames.m_value;
+    }
+}
+
+void
+painter_benchmark::
+handle_event(const SDL_Event &ev)
+{
+  if(ev.type == SDL_QUIT)
+    {
+      end_demo(0);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+  painter_benchmark P;
+  return P.main(argc, argv);
+}
@@ -1,4 +1,5 @@
 #include <sstream>
+#include <cmath>
 #include <fastuidraw/painter/painter_attribute_data_filler_glyphs.hpp>
 #include "cell.hpp"
 #include "text_helper.hpp"
@@ -45,7 +46,8 @@ Cell(PainterWidget *p, const CellParams &params):
   m_line_brush(params.m_line_brush),
   m_item_location(params.m_size * 0.5f),
   m_shared_state(params.m_state),
-  m_timer_based_animation(params.m_timer_based_animation)
+  m_timer_based_animation(params.m_timer_based_animation),
+  m_work_value(0.0f)
 {
   std::ostringstream ostr;
   ostr << "Cell" << params.m_table_pos
@@ -65,12 +67,28 @@ Cell(PainterWidget *p, const CellParams &params):
                                                    params.m_pixel_size));
   m_dimensions = params.m_size;
   m_table_pos = m_dimensions * vec2(params.m_table_pos);
+  m_shared_state->m_cells.push_back(this);
 }
 
 void
 Cell::
 pre_paint(void)
 {
+  if(!m_shared_state->m_update_in_workers)
+    {
+      update();
+    }
+}
+
+void
+Cell::
+update(void)
+{
+  for(int i = 0; i < m_shared_state->m_cell_work_iterations; ++i)
+    {
+      m_work_value = std::sin(m_work_value + m_item_location.x()) * std::cos(m_work_value + m_item_location.y());
+    }
+
   if(!m_first_frame)
     {
       uint32_t ms;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include <fastuidraw/text/glyph_selector.hpp>
 #include <fastuidraw/text/glyph_cache.hpp>
 #include <fastuidraw/text/font.hpp>
@@ -11,6 +12,8 @@
 
 using namespace fastuidraw;
 
+class Cell;
+
 class CellSharedState:boost::noncopyable
 {
 public:
@@ -21,7 +24,9 @@ public:
     m_stroke_width(10.0f),
     m_pause(false),
     m_anti_alias_stroking(true),
-    m_cells_drawn(0)
+    m_cells_drawn(0),
+    m_update_in_workers(false),
+    m_cell_work_iterations(0)
   {}
 
   bool m_draw_text;
@@ -33,6 +38,21 @@ public:
   bool m_anti_alias_stroking;
 
   int m_cells_drawn;
+
+  /* All cells made; each Cell adds itself on construction.
+   */
+  std::vector<Cell*> m_cells;
+
+  /* If true, Cell::pre_paint() does not update the cell
+     because Cell::update() was already called for each
+     of m_cells (from worker threads) before painting.
+   */
+  bool m_update_in_workers;
+
+  /* number of iterations of synthetic work done by each
+     Cell::update() to stand in for per-cell layout
+   */
+  int m_cell_work_iterations;
 };
 
 class CellParams
@@ -62,6 +82,14 @@ public:
   Cell(PainterWidget *p, const CellParams &params);
   ~Cell() {}
 
+  /* Advance the animation of the cell by a frame and
+     do the per-cell work; only touches the state of the
+     Cell so that different cells can be updated
+     from different threads.
+   */
+  void
+  update(void);
+
 protected:
 
   virtual
@@ -94,4 +122,5 @@ private:
   PainterAttributeData m_text;
   CellSharedState *m_shared_state;
   bool m_timer_based_animation;
+  float m_work_value;
 };
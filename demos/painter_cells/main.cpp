@@ -1,5 +1,7 @@
 #include <fstream>
 #include <dirent.h>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 
 #include <fastuidraw/painter/painter.hpp>
 #include <fastuidraw/text/glyph_cache.hpp>
@@ -108,6 +110,13 @@ private:
   void
   update_cts_params(void);
 
+  void
+  update_cells(void);
+
+  static
+  void
+  update_cells_worker(std::vector<Cell*> *cells, unsigned int start, unsigned int stride);
+
   command_line_argument_value<float> m_table_width, m_table_height;
   command_line_argument_value<int> m_num_cells_x, m_num_cells_y;
   command_line_argument_value<int> m_cell_group_size;
@@ -133,6 +142,9 @@ private:
 
   command_line_argument_value<int> m_num_frames;
   command_line_argument_value<int> m_skip_frames;
+  command_line_argument_value<unsigned int> m_random_seed;
+  command_line_argument_value<int> m_num_worker_threads;
+  command_line_argument_value<int> m_cell_work_iterations;
   command_line_argument_value<bool> m_init_show_all_table;
   command_line_argument_value<bool> m_init_table_rotating;
   command_line_argument_value<bool> m_init_table_clipped;
@@ -153,6 +165,17 @@ private:
   uint64_t m_benchmark_time_us;
   simple_time m_benchmark_timer;
   std::vector<uint64_t> m_frame_times;
+
+  /* benchmark breakdown of the frame times into the time
+     updating the cells, the time recording with the Painter,
+     the time of Painter::end() (sending to the backend) and
+     the GPU time reported by the backend.
+   */
+  simple_time m_breakdown_timer;
+  uint64_t m_cell_update_time_us;
+  uint64_t m_painter_time_us;
+  uint64_t m_backend_time_us;
+  uint64_t m_gpu_time_us;
 };
 
 painter_cells::
@@ -167,7 +190,9 @@ painter_cells(void):
                   enumerated_string_type<enum fastuidraw::glyph_type>()
                   .add_entry("coverage", fastuidraw::coverage_glyph, "coverage glyphs (i.e. alpha masks)")
                   .add_entry("distance_field", fastuidraw::distance_field_glyph, "distance field glyphs")
-                  .add_entry("curve_pair", fastuidraw::curve_pair_glyph, "curve-pair glyphs"),
+                  .add_entry("curve_pair", fastuidraw::curve_pair_glyph, "curve-pair glyphs")
+                  .add_entry("banded_curves", fastuidraw::banded_curves_glyph, "banded curves glyphs")
+                  .add_entry("msdf", fastuidraw::msdf_glyph, "multi-channel signed distance field glyphs"),
                   "text_renderer",
                   "Specifies how to render text", *this),
   m_text_renderer_realized_pixel_size(24,
@@ -207,6 +232,19 @@ painter_cells(void):
   m_skip_frames(1, "num_skip_frames",
                 "If num_frames > 0, then gives the number of frames to ignore in benchmarking",
                 *this),
+  m_random_seed(0, "random_seed",
+                "Seed for the random colors and velocities of the cells; the same seed "
+                "with the same num_frames gives the same frames",
+                *this),
+  m_num_worker_threads(0, "num_worker_threads",
+                       "If positive, the per-frame update of the cells is done by this number "
+                       "of threads before painting; recording with the Painter remains on the "
+                       "main thread",
+                       *this),
+  m_cell_work_iterations(0, "cell_work_iterations",
+                         "Number of iterations of synthetic work done by each cell per frame "
+                         "to simulate per-cell layout",
+                         *this),
   m_init_show_all_table(true, "init_show_all_table",
                         "If true, initialize scroll and zoom to show entire table",
                         *this),
@@ -231,7 +269,11 @@ painter_cells(void):
   m_init_anti_alias_stroking(true, "init_antialias_stroking",
                              "Initial value for anti-aliasing for stroking",
                              *this),
-  m_table(NULL)
+  m_table(NULL),
+  m_cell_update_time_us(0),
+  m_painter_time_us(0),
+  m_backend_time_us(0),
+  m_gpu_time_us(0)
 {
   std::cout << "Controls:\n"
             << "\t[: decrease stroke width(hold left-shift for slower rate and right shift for faster)\n"
@@ -337,6 +379,9 @@ void
 painter_cells::
 derived_init(int w, int h)
 {
+  random_seed(m_random_seed.m_value);
+  m_cell_shared_state.m_cell_work_iterations = m_cell_work_iterations.m_value;
+
   m_table_params.m_wh = vec2(m_table_width.m_value, m_table_height.m_value);
   m_table_params.m_cell_count = ivec2(m_num_cells_x.m_value, m_num_cells_y.m_value);
   m_table_params.m_line_color = vec4(1.0f, 1.0f, 1.0f, 1.0f);
@@ -472,6 +517,39 @@ update_cts_params(void)
     }
 }
 
+void
+painter_cells::
+update_cells_worker(std::vector<Cell*> *cells, unsigned int start, unsigned int stride)
+{
+  for(unsigned int i = start, endi = cells->size(); i < endi; i += stride)
+    {
+      (*cells)[i]->update();
+    }
+}
+
+void
+painter_cells::
+update_cells(void)
+{
+  /* the cells are made by the Table on its first paint, so
+     until then the cells update themselves in pre_paint().
+   */
+  m_cell_shared_state.m_update_in_workers = (m_num_worker_threads.m_value > 0
+                                             && !m_cell_shared_state.m_cells.empty());
+  if(!m_cell_shared_state.m_update_in_workers)
+    {
+      return;
+    }
+
+  boost::thread_group workers;
+  unsigned int stride(m_num_worker_threads.m_value);
+  for(unsigned int i = 0; i < stride; ++i)
+    {
+      workers.create_thread(boost::bind(&update_cells_worker, &m_cell_shared_state.m_cells, i, stride));
+    }
+  workers.join_all();
+}
+
 void
 painter_cells::
 draw_frame(void)
@@ -502,6 +580,14 @@ draw_frame(void)
                 << static_cast<float>(m_benchmark_time_us) / static_cast<float>(m_frame)
                 << "us\n " << 1000.0f * 1000.0f * static_cast<float>(m_frame) / static_cast<float>(m_benchmark_time_us)
                 << " FPS\n";
+
+      float f(static_cast<float>(m_frame));
+      std::cout << "Average breakdown per frame(in us):\n"
+                << "\tcell update: " << static_cast<float>(m_cell_update_time_us) / f
+                << " (" << m_num_worker_threads.m_value << " worker threads)\n"
+                << "\tPainter recording: " << static_cast<float>(m_painter_time_us) / f << "\n"
+                << "\tbackend (Painter::end()): " << static_cast<float>(m_backend_time_us) / f << "\n"
+                << "\tGPU: " << static_cast<float>(m_gpu_time_us) / f << "\n";
       end_demo(0);
       return;
     }
@@ -514,6 +600,17 @@ draw_frame(void)
 
   m_cell_shared_state.m_cells_drawn = 0;
 
+  m_breakdown_timer.restart_us();
+  update_cells();
+  if(m_frame > 0)
+    {
+      m_cell_update_time_us += m_breakdown_timer.restart_us();
+    }
+  else
+    {
+      m_breakdown_timer.restart_us();
+    }
+
   m_painter->begin();
 
   ivec2 wh(dimensions());
@@ -557,6 +654,16 @@ draw_frame(void)
            << m_painter->query_stat(PainterPacker::num_generic_datas)
            << "\nHeaders: "
            << m_painter->query_stat(PainterPacker::num_headers)
+           << "\nHeaders shared: "
+           << m_painter->query_stat(PainterPacker::num_headers_shared)
+           << "\nBytes saved: "
+           << m_painter->query_stat(PainterPacker::num_bytes_saved)
+           << "\nDraw breaks(shader, blend, full): "
+           << m_painter->query_stat(PainterPacker::num_draw_breaks_shader_change)
+           << ", " << m_painter->query_stat(PainterPacker::num_draw_breaks_blend_mode_change)
+           << ", " << m_painter->query_stat(PainterPacker::num_draw_breaks_buffer_full)
+           << "\nGPU us: "
+           << m_painter->query_stat(PainterPacker::backend_gpu_time_micro_seconds)
            << "\n";
       if(!m_text_brush)
         {
@@ -569,8 +676,23 @@ draw_frame(void)
                 PainterData(m_text_brush));
     }
 
+  if(m_frame > 0)
+    {
+      m_painter_time_us += m_breakdown_timer.restart_us();
+    }
+  else
+    {
+      m_breakdown_timer.restart_us();
+    }
+
   m_painter->end();
 
+  if(m_frame > 0)
+    {
+      m_backend_time_us += m_breakdown_timer.restart_us();
+      m_gpu_time_us += m_painter->query_stat(PainterPacker::backend_gpu_time_micro_seconds);
+    }
+
   ++m_frame;
 }
 
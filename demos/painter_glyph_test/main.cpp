@@ -1,6 +1,8 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <iomanip>
+#include <set>
 #include <fastuidraw/text/glyph_cache.hpp>
 #include <fastuidraw/text/freetype_font.hpp>
 #include <fastuidraw/text/glyph_selector.hpp>
@@ -9,9 +11,25 @@
 #include "PanZoomTracker.hpp"
 #include "text_helper.hpp"
 #include "cycle_value.hpp"
+#include "simple_time.hpp"
 
 using namespace fastuidraw;
 
+/*
+  If benchmark_frames is positive, painter-glyph-test does not
+  show anything interactive; instead, for each glyph type the
+  font supports, drawn with isotropic and anisotropic anti-aliasing,
+  it covers the window with the glyphs of the text at
+  render_pixel_size and draws that many frames of it. The GPU time
+  of each frame, from Painter::begin() to Painter::end(), is taken
+  with a GL_TIME_ELAPSED query (for GLES, where that query is not
+  core, with glFinish() and the wall clock instead). The times are
+  reported per pixel of the window and per pixel of the glyph quads
+  drawn, together with the atlas bytes per glyph; a first frame is
+  not timed. Other sizes are measured by running again with another
+  render_pixel_size.
+ */
+
 class painter_glyph_test:public sdl_painter_demo
 {
 public:
@@ -55,11 +73,22 @@ private:
   void
   update_cts_params(void);
 
+  void
+  run_benchmark(void);
+
+  void
+  benchmark_draw_mode(unsigned int mode, bool anisotropic);
+
+  uint64_t
+  benchmark_frame(const PainterAttributeData &data, bool anisotropic);
+
   enum
     {
       draw_glyph_coverage,
       draw_glyph_curvepair,
       draw_glyph_distance,
+      draw_glyph_banded_curves,
+      draw_glyph_msdf,
 
       number_draw_modes
     };
@@ -68,14 +97,24 @@ private:
   command_line_argument_value<std::string> m_font_style, m_font_family;
   command_line_argument_value<bool> m_font_bold, m_font_italic;
   command_line_argument_value<int> m_coverage_pixel_size;
+  command_line_argument_value<bool> m_coverage_subpixel_positioning;
   command_line_argument_value<int> m_distance_pixel_size;
   command_line_argument_value<float> m_max_distance;
+  enumerated_command_line_argument_value<enum FontFreeType::RenderParams::distance_field_generator_t> m_distance_generator;
+  command_line_argument_value<int> m_distance_supersample;
   command_line_argument_value<int> m_curve_pair_pixel_size;
+  command_line_argument_value<int> m_banded_curves_pixel_size;
+  command_line_argument_value<int> m_banded_curves_max_bands;
+  command_line_argument_value<int> m_msdf_pixel_size;
+  command_line_argument_value<float> m_msdf_max_distance;
   command_line_argument_value<std::string> m_text;
   command_line_argument_value<bool> m_use_file;
   command_line_argument_value<bool> m_draw_glyph_set;
+  command_line_argument_value<bool> m_glyph_instances;
+  command_line_argument_value<unsigned int> m_glyphs_per_chunk;
   command_line_argument_value<float> m_render_pixel_size;
   command_line_argument_value<float> m_change_stroke_width_rate;
+  command_line_argument_value<int> m_benchmark_frames;
 
   reference_counted_ptr<const FontFreeType> m_font;
 
@@ -83,6 +122,7 @@ private:
   vecN<std::string, number_draw_modes> m_draw_labels;
   vecN<std::vector<Glyph>, number_draw_modes> m_glyphs;
   std::vector<vec2> m_glyph_positions;
+  std::vector<vec2> m_coverage_glyph_positions;
 
   bool m_use_anisotropic_anti_alias;
   bool m_stroke_glyphs;
@@ -104,19 +144,53 @@ painter_glyph_test(void):
   m_font_bold(false, "font_bold", "if true select a bold font", *this),
   m_font_italic(false, "font_italic", "if true select an italic font", *this),
   m_coverage_pixel_size(24, "coverage_pixel_size", "Pixel size at which to create coverage glyphs", *this),
+  m_coverage_subpixel_positioning(false, "coverage_subpixel_positioning",
+                                  "if true, coverage glyphs are created at the quantized "
+                                  "subpixel offset of their position instead of being "
+                                  "drawn at the position as is", *this),
   m_distance_pixel_size(48, "distance_pixel_size", "Pixel size at which to create distance field glyphs", *this),
   m_max_distance(96.0f, "max_distance",
                  "value to use for max distance in 64'ths of a pixel "
                  "when generating distance field glyphs", *this),
+  m_distance_generator(FontFreeType::RenderParams::outline_distance_field_generator,
+                       enumerated_string_type<enum FontFreeType::RenderParams::distance_field_generator_t>()
+                       .add_entry("outline", FontFreeType::RenderParams::outline_distance_field_generator,
+                                  "compute distances from the curves of the glyph outline")
+                       .add_entry("distance_transform", FontFreeType::RenderParams::distance_transform_distance_field_generator,
+                                  "compute Euclidean distances from a supersampled coverage bitmap"),
+                       "distance_generator",
+                       "Specifies how to compute the values of distance field glyphs", *this),
+  m_distance_supersample(5, "distance_supersample",
+                         "supersampling factor of the coverage bitmap when "
+                         "distance_generator is distance_transform", *this),
   m_curve_pair_pixel_size(48, "curvepair_pixel_size", "Pixel size at which to create distance curve pair glyphs", *this),
+  m_banded_curves_pixel_size(64, "banded_curves_pixel_size", "Pixel size at which to create banded curves glyphs", *this),
+  m_banded_curves_max_bands(8, "banded_curves_max_bands",
+                            "Maximum number of horizontal and of vertical bands of banded curves glyphs", *this),
+  m_msdf_pixel_size(24, "msdf_pixel_size",
+                    "Pixel size at which to create multi-channel signed distance field glyphs", *this),
+  m_msdf_max_distance(128.0f, "msdf_max_distance",
+                      "value to use for max distance in 64'ths of a pixel "
+                      "when generating multi-channel signed distance field glyphs", *this),
   m_text("Hello World!", "text", "text to draw to the screen", *this),
   m_use_file(false, "use_file", "if true the value for text gives a filename to display", *this),
   m_draw_glyph_set(false, "draw_glyph_set", "if true, display all glyphs of font instead of text", *this),
+  m_glyph_instances(false, "glyph_instances",
+                    "if true, pack each glyph as a single instance and draw with "
+                    "Painter::draw_glyph_instances()", *this),
+  m_glyphs_per_chunk(0, "glyphs_per_chunk",
+                     "if non-zero, split the glyphs into blocks of that many glyphs "
+                     "so that the blocks outside of the clipping are culled", *this),
   m_render_pixel_size(24.0f, "render_pixel_size", "pixel size at which to display glyphs", *this),
   m_change_stroke_width_rate(10.0f, "change_stroke_width_rate",
                              "rate of change in pixels/sec for changing stroke width "
                              "when changing stroke when key is down",
                              *this),
+  m_benchmark_frames(0, "benchmark_frames",
+                     "if positive, instead of being interactive, cover the window with "
+                     "text at render_pixel_size and, for each glyph type, time drawing "
+                     "that many frames with GPU timer queries, then report the GPU time "
+                     "per pixel and the atlas bytes per glyph and exit", *this),
   m_use_anisotropic_anti_alias(false),
   m_stroke_glyphs(false),
   m_stroke_width(1.0f),
@@ -155,7 +229,13 @@ create_and_add_font(void)
                       FontFreeType::RenderParams()
                       .distance_field_max_distance(m_max_distance.m_value)
                       .distance_field_pixel_size(m_distance_pixel_size.m_value)
-                      .curve_pair_pixel_size(m_curve_pair_pixel_size.m_value));
+                      .distance_field_generator(m_distance_generator.m_value.m_value)
+                      .distance_field_supersample(m_distance_supersample.m_value)
+                      .curve_pair_pixel_size(m_curve_pair_pixel_size.m_value)
+                      .banded_curves_pixel_size(m_banded_curves_pixel_size.m_value)
+                      .banded_curves_max_number_bands(m_banded_curves_max_bands.m_value)
+                      .msdf_pixel_size(m_msdf_pixel_size.m_value)
+                      .msdf_max_distance(m_msdf_max_distance.m_value));
 
   reference_counted_ptr<const FontBase> font;
 
@@ -232,6 +312,12 @@ compute_glyphs_and_positions(fastuidraw::GlyphRender renderer,
         case curve_pair_glyph:
           div_scale_factor = m_font->render_params().curve_pair_pixel_size();
           break;
+        case banded_curves_glyph:
+          div_scale_factor = m_font->render_params().banded_curves_pixel_size();
+          break;
+        case msdf_glyph:
+          div_scale_factor = m_font->render_params().msdf_pixel_size();
+          break;
 
         default:
           div_scale_factor = renderer.m_pixel_size;
@@ -341,9 +427,40 @@ ready_glyph_attribute_data(void)
     GlyphRender renderer(m_coverage_pixel_size.m_value);
     compute_glyphs_and_positions(renderer, m_render_pixel_size.m_value,
                                  m_glyphs[draw_glyph_coverage], character_codes);
-    m_draws[draw_glyph_coverage].set_data(PainterAttributeDataFillerGlyphs(cast_c_array(m_glyph_positions),
+
+    m_coverage_glyph_positions = m_glyph_positions;
+    if(m_coverage_subpixel_positioning.m_value)
+      {
+        float scale;
+
+        /* the subpixel offset is in pixels of the glyph, i.e.
+           before the glyph is scaled to render_pixel_size
+         */
+        scale = m_render_pixel_size.m_value / static_cast<float>(m_coverage_pixel_size.m_value);
+        for(unsigned int i = 0; i < m_glyphs[draw_glyph_coverage].size(); ++i)
+          {
+            Glyph &g(m_glyphs[draw_glyph_coverage][i]);
+            vec2 &p(m_coverage_glyph_positions[i]);
+            float snapped_x;
+            int k;
+
+            if(!g.valid())
+              {
+                continue;
+              }
+
+            k = GlyphRender::quantize_subpixel_offset(p.x() / scale, snapped_x);
+            p.x() = snapped_x * scale;
+            g = m_glyph_selector->fetch_glyph_no_merging(GlyphRender(m_coverage_pixel_size.m_value, k),
+                                                         g.layout().m_font, character_codes[i]);
+          }
+      }
+
+    m_draws[draw_glyph_coverage].set_data(PainterAttributeDataFillerGlyphs(cast_c_array(m_coverage_glyph_positions),
                                                                            cast_c_array(m_glyphs[draw_glyph_coverage]),
-                                                                           m_render_pixel_size.m_value));
+                                                                           m_render_pixel_size.m_value)
+                                           .instanced(m_glyph_instances.m_value)
+                                           .glyphs_per_chunk(m_glyphs_per_chunk.m_value));
     m_draw_labels[draw_glyph_coverage] = "draw_glyph_coverage";
   }
 
@@ -355,7 +472,9 @@ ready_glyph_attribute_data(void)
                           cast_c_array(character_codes));
     m_draws[draw_glyph_distance].set_data(PainterAttributeDataFillerGlyphs(cast_c_array(m_glyph_positions),
                                                                            cast_c_array(m_glyphs[draw_glyph_distance]),
-                                                                           m_render_pixel_size.m_value));
+                                                                           m_render_pixel_size.m_value)
+                                           .instanced(m_glyph_instances.m_value)
+                                           .glyphs_per_chunk(m_glyphs_per_chunk.m_value));
     m_draw_labels[draw_glyph_distance] = "draw_glyph_distance";
   }
 
@@ -367,15 +486,51 @@ ready_glyph_attribute_data(void)
                           cast_c_array(character_codes));
     m_draws[draw_glyph_curvepair].set_data(PainterAttributeDataFillerGlyphs(cast_c_array(m_glyph_positions),
                                                                             cast_c_array(m_glyphs[draw_glyph_curvepair]),
-                                                                            m_render_pixel_size.m_value));
+                                                                            m_render_pixel_size.m_value)
+                                           .instanced(m_glyph_instances.m_value)
+                                           .glyphs_per_chunk(m_glyphs_per_chunk.m_value));
     m_draw_labels[draw_glyph_curvepair] = "draw_glyph_curvepair";
   }
+
+  {
+    GlyphRender renderer(banded_curves_glyph);
+    change_glyph_renderer(renderer,
+                          cast_c_array(m_glyphs[draw_glyph_coverage]),
+                          m_glyphs[draw_glyph_banded_curves],
+                          cast_c_array(character_codes));
+    m_draws[draw_glyph_banded_curves].set_data(PainterAttributeDataFillerGlyphs(cast_c_array(m_glyph_positions),
+                                                                                cast_c_array(m_glyphs[draw_glyph_banded_curves]),
+                                                                                m_render_pixel_size.m_value)
+                                               .instanced(m_glyph_instances.m_value)
+                                               .glyphs_per_chunk(m_glyphs_per_chunk.m_value));
+    m_draw_labels[draw_glyph_banded_curves] = "draw_glyph_banded_curves";
+  }
+
+  {
+    GlyphRender renderer(msdf_glyph);
+    change_glyph_renderer(renderer,
+                          cast_c_array(m_glyphs[draw_glyph_coverage]),
+                          m_glyphs[draw_glyph_msdf],
+                          cast_c_array(character_codes));
+    m_draws[draw_glyph_msdf].set_data(PainterAttributeDataFillerGlyphs(cast_c_array(m_glyph_positions),
+                                                                       cast_c_array(m_glyphs[draw_glyph_msdf]),
+                                                                       m_render_pixel_size.m_value)
+                                      .instanced(m_glyph_instances.m_value));
+    m_draw_labels[draw_glyph_msdf] = "draw_glyph_msdf";
+  }
 }
 
 void
 painter_glyph_test::
 draw_frame(void)
 {
+  if(m_benchmark_frames.m_value > 0)
+    {
+      run_benchmark();
+      end_demo(0);
+      return;
+    }
+
   update_cts_params();
 
   glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
@@ -387,9 +542,18 @@ draw_frame(void)
 
   PainterBrush brush;
   brush.pen(1.0, 1.0, 1.0, 1.0);
-  m_painter->draw_glyphs(PainterData(&brush),
-                         m_draws[m_current_drawer],
-                         m_use_anisotropic_anti_alias);
+  if(m_glyph_instances.m_value)
+    {
+      m_painter->draw_glyph_instances(PainterData(&brush),
+                                      m_draws[m_current_drawer],
+                                      m_use_anisotropic_anti_alias);
+    }
+  else
+    {
+      m_painter->draw_glyphs(PainterData(&brush),
+                             m_draws[m_current_drawer],
+                             m_use_anisotropic_anti_alias);
+    }
 
   if(m_stroke_glyphs)
     {
@@ -430,6 +594,192 @@ draw_frame(void)
   m_painter->end();
 }
 
+void
+painter_glyph_test::
+run_benchmark(void)
+{
+  vecN<enum glyph_type, number_draw_modes> types;
+
+  types[draw_glyph_coverage] = coverage_glyph;
+  types[draw_glyph_curvepair] = curve_pair_glyph;
+  types[draw_glyph_distance] = distance_field_glyph;
+  types[draw_glyph_banded_curves] = banded_curves_glyph;
+  types[draw_glyph_msdf] = msdf_glyph;
+
+  std::cout << "Window " << dimensions().x() << "x" << dimensions().y()
+            << ", render_pixel_size "
+            << m_render_pixel_size.m_value << ", "
+            << m_benchmark_frames.m_value << " frames\n";
+  for(unsigned int mode = 0; mode < number_draw_modes; ++mode)
+    {
+      if(!m_font->can_create_rendering_data(types[mode]))
+        {
+          std::cout << "\n" << m_draw_labels[mode] << ": not supported by the font\n";
+          continue;
+        }
+      benchmark_draw_mode(mode, false);
+      benchmark_draw_mode(mode, true);
+    }
+}
+
+/* the glyphs of the text are repeated line after line,
+   a line being render_pixel_size high, until the window
+   is covered.
+ */
+void
+painter_glyph_test::
+benchmark_draw_mode(unsigned int mode, bool anisotropic)
+{
+  const std::vector<Glyph> &glyphs(m_glyphs[mode]);
+  std::vector<Glyph> draw_glyphs;
+  std::vector<vec2> positions;
+  std::set<unsigned int> atlas_glyphs;
+  uint64_t atlas_bytes(0), total_ns(0);
+  double quad_pixels(0.0), window_pixels;
+  float line_height(m_render_pixel_size.m_value);
+  vec2 pen(0.0f, line_height), wh(dimensions());
+
+  while(!glyphs.empty() && pen.y() < wh.y() + line_height)
+    {
+      bool advanced(false);
+
+      for(unsigned int i = 0; i < glyphs.size() && pen.y() < wh.y() + line_height; ++i)
+        {
+          const Glyph &g(glyphs[i]);
+          float scale, advance;
+
+          if(!g.valid())
+            {
+              continue;
+            }
+
+          scale = m_render_pixel_size.m_value / static_cast<float>(g.layout().m_pixel_size);
+          advance = scale * std::max(g.layout().m_advance.x(), g.layout().m_size.x());
+          if(pen.x() + advance > wh.x() && pen.x() > 0.0f)
+            {
+              pen.x() = 0.0f;
+              pen.y() += line_height;
+            }
+
+          draw_glyphs.push_back(g);
+          positions.push_back(pen);
+          quad_pixels += scale * scale * g.layout().m_size.x() * g.layout().m_size.y();
+          pen.x() += advance;
+          advanced = advanced || advance > 0.0f;
+
+          if(atlas_glyphs.insert(g.cache_location()).second)
+            {
+              GlyphLocation primary(g.atlas_location());
+              GlyphLocation secondary(g.secondary_atlas_location());
+
+              /* the texel store of GlyphAtlasGL is one byte per texel */
+              if(primary.valid())
+                {
+                  atlas_bytes += primary.size().x() * primary.size().y();
+                }
+              if(secondary.valid())
+                {
+                  atlas_bytes += secondary.size().x() * secondary.size().y();
+                }
+            }
+        }
+
+      if(!advanced)
+        {
+          /* no glyph of the text has any extent */
+          break;
+        }
+    }
+
+  if(draw_glyphs.empty())
+    {
+      std::cout << "\n" << m_draw_labels[mode] << ": no glyphs to draw\n";
+      return;
+    }
+
+  PainterAttributeData data;
+  data.set_data(PainterAttributeDataFillerGlyphs(cast_c_array(positions),
+                                                 cast_c_array(draw_glyphs),
+                                                 m_render_pixel_size.m_value)
+                .instanced(m_glyph_instances.m_value));
+
+  for(int frame = -1; frame < m_benchmark_frames.m_value; ++frame)
+    {
+      uint64_t ns;
+
+      ns = benchmark_frame(data, anisotropic);
+      if(frame >= 0)
+        {
+          total_ns += ns;
+        }
+    }
+
+  double frame_ns, frames;
+
+  frames = static_cast<double>(m_benchmark_frames.m_value);
+  frame_ns = static_cast<double>(total_ns) / frames;
+  window_pixels = static_cast<double>(wh.x()) * static_cast<double>(wh.y());
+  quad_pixels = std::max(quad_pixels, 1.0);
+
+  std::cout << "\n" << m_draw_labels[mode]
+            << (anisotropic ? " (anisotropic)" : " (isotropic)")
+            << ": " << draw_glyphs.size() << " glyphs per frame\n"
+            << "\tGPU time: " << frame_ns / 1000.0 << " us/frame\n"
+            << "\tper window pixel: " << frame_ns / window_pixels << " ns\n"
+            << "\tper glyph quad pixel: " << frame_ns / quad_pixels << " ns ("
+            << quad_pixels / window_pixels << " quad pixels per window pixel)\n"
+            << "\tatlas: " << static_cast<double>(atlas_bytes) / static_cast<double>(atlas_glyphs.size())
+            << " bytes per glyph over " << atlas_glyphs.size() << " glyphs\n";
+}
+
+uint64_t
+painter_glyph_test::
+benchmark_frame(const PainterAttributeData &data, bool anisotropic)
+{
+  ivec2 wh(dimensions());
+  float3x3 proj(float_orthogonal_projection_params(0, wh.x(), wh.y(), 0));
+  PainterBrush brush;
+  uint64_t return_value;
+
+  brush.pen(1.0, 1.0, 1.0, 1.0);
+  glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+
+  #ifndef FASTUIDRAW_GL_USE_GLES
+    GLuint query(0);
+    glGenQueries(1, &query);
+    glBeginQuery(GL_TIME_ELAPSED, query);
+  #else
+    simple_time timer;
+    glFinish();
+    timer.restart_us();
+  #endif
+
+  m_painter->begin();
+  m_painter->transformation(proj);
+  if(m_glyph_instances.m_value)
+    {
+      m_painter->draw_glyph_instances(PainterData(&brush), data, anisotropic);
+    }
+  else
+    {
+      m_painter->draw_glyphs(PainterData(&brush), data, anisotropic);
+    }
+  m_painter->end();
+
+  #ifndef FASTUIDRAW_GL_USE_GLES
+    GLuint64 ns(0);
+    glEndQuery(GL_TIME_ELAPSED);
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+    glDeleteQueries(1, &query);
+    return_value = ns;
+  #else
+    glFinish();
+    return_value = 1000u * static_cast<uint64_t>(timer.elapsed_us());
+  #endif
+
+  return return_value;
+}
+
 void
 painter_glyph_test::
 update_cts_params(void)
@@ -164,6 +164,12 @@ private:
   void
   create_stroked_path_attributes(void);
 
+  void
+  construct_hairline(void);
+
+  void
+  append_hairline_points(unsigned int count);
+
   void
   construct_color_stops(void);
 
@@ -186,14 +192,22 @@ private:
   command_line_argument_value<std::string> m_path_file;
   DashPatternList m_dash_pattern_files;
   command_line_argument_value<bool> m_print_path;
+  command_line_argument_value<bool> m_compact_edges;
+  command_line_argument_value<bool> m_multisampled_target;
+  command_line_argument_value<unsigned int> m_rounded_cache_max_bytes;
   color_stop_arguments m_color_stop_args;
   command_line_argument_value<std::string> m_image_file;
   command_line_argument_value<unsigned int> m_image_slack;
   command_line_argument_value<int> m_sub_image_x, m_sub_image_y;
   command_line_argument_value<int> m_sub_image_w, m_sub_image_h;
   command_line_argument_value<std::string> m_font_file;
+  command_line_argument_value<unsigned int> m_hairline_points;
+  command_line_argument_value<unsigned int> m_hairline_append_per_frame;
 
   Path m_path;
+  HairlinePath m_hairline;
+  unsigned int m_hairline_count;
+  uint32_t m_hairline_random;
   float m_max_miter;
   reference_counted_ptr<Image> m_image;
   uvec2 m_image_offset, m_image_size;
@@ -262,6 +276,8 @@ private:
   bool m_force_square_viewport;
 
   bool m_fill_by_clipping;
+  bool m_fill_by_stencil;
+  bool m_aa_fill;
   vec2 m_shear, m_shear2;
   bool m_draw_grid;
 
@@ -302,6 +318,18 @@ painter_stroke_test(void):
   m_print_path(false, "print_path",
                "If true, print the geometry data of the path drawn to stdout",
                *this),
+  m_compact_edges(false, "compact_edges",
+                  "If true, stroke with StrokedPath::compact_edge_format edges",
+                  *this),
+  m_multisampled_target(false, "multisampled_target",
+                        "If true, pass to Painter::begin() that the target is multisampled "
+                        "so that strokes and fills skip their shader anti-aliasing; "
+                        "use together with enable_msaa",
+                        *this),
+  m_rounded_cache_max_bytes(0, "rounded_cache_max_bytes",
+                            "Maximum number of bytes of rounded joins and caps each "
+                            "StrokedPath keeps, 0 means no limit",
+                            *this),
   m_color_stop_args(*this),
   m_image_file("", "image", "if a valid file name, apply an image to drawing the fill", *this),
   m_image_slack(0, "image_slack", "amount of slack on tiles when loading image", *this),
@@ -319,6 +347,18 @@ painter_stroke_test(void):
                 *this),
   m_font_file("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", "font",
               "File from which to take font", *this),
+  m_hairline_points(0, "hairline_points",
+                    "if non-zero, instead of stroking the path, stroke with "
+                    "Painter::draw_hairline() a time-series polyline of that "
+                    "many points spanning the bounding box of the path; the stroke "
+                    "width is then in pixels",
+                    *this),
+  m_hairline_append_per_frame(0, "hairline_append_per_frame",
+                              "number of points streamed to the end of the hairline "
+                              "polyline each frame when hairline_points is non-zero",
+                              *this),
+  m_hairline_count(0),
+  m_hairline_random(1u),
   m_join_style(PainterEnums::rounded_joins),
   m_cap_style(PainterEnums::flat_caps),
   m_close_contour(true),
@@ -343,6 +383,8 @@ painter_stroke_test(void):
   m_stroke_width_in_pixels(false),
   m_force_square_viewport(false),
   m_fill_by_clipping(false),
+  m_fill_by_stencil(false),
+  m_aa_fill(false),
   m_shear(1.0f, 1.0f),
   m_shear2(1.0f, 1.0f),
   m_draw_grid(false),
@@ -372,6 +414,8 @@ painter_stroke_test(void):
             << "\tf: toggle drawing path fill\n"
             << "\tr: cycle through fill rules\n"
             << "\te: toggle fill by drawing clip rect\n"
+            << "\tk: toggle computing fill coverage with the stencil buffer instead of triangulating\n"
+            << "\tu: toggle anti-aliased filling\n"
             << "\ti: cycle through image filter to apply to fill (no image, nearest, linear, cubic)\n"
             << "\ts: cycle through defined color stops for gradient\n"
             << "\tg: cycle through gradient types (linear or radial)\n"
@@ -955,6 +999,40 @@ handle_event(const SDL_Event &ev)
             }
           break;
 
+        case SDLK_k:
+          if(m_draw_fill)
+            {
+              m_fill_by_stencil = !m_fill_by_stencil;
+              std::cout << "Set to compute fill coverage by ";
+              if(m_fill_by_stencil)
+                {
+                  std::cout << "stencil buffer";
+                  if(!m_backend->hints().stencil_coverage())
+                    {
+                      std::cout << " (not supported, pass painter_stencil_coverage true)";
+                    }
+                  std::cout << "\n";
+                }
+              else
+                {
+                  std::cout << "triangulation\n";
+                }
+            }
+          break;
+
+        case SDLK_u:
+          if(m_draw_fill)
+            {
+              m_aa_fill = !m_aa_fill;
+              std::cout << "Set to ";
+              if(!m_aa_fill)
+                {
+                  std::cout << "NOT ";
+                }
+              std::cout << "anti-alias fill\n";
+            }
+          break;
+
         case SDLK_f:
           m_draw_fill = !m_draw_fill;
           std::cout << "Set to ";
@@ -1031,6 +1109,52 @@ construct_path(void)
          << Path::contour_end();
 }
 
+void
+painter_stroke_test::
+append_hairline_points(unsigned int count)
+{
+  vec2 p0, p1;
+  float w, h, dx;
+
+  p0 = m_path.tessellation()->bounding_box_min();
+  p1 = m_path.tessellation()->bounding_box_max();
+  w = p1.x() - p0.x();
+  h = p1.y() - p0.y();
+  dx = w / static_cast<float>(t_max(1u, m_hairline_points.m_value));
+
+  /* a sine wave with deterministic noise, wrapping
+     around the width of the box as points are streamed.
+   */
+  for(unsigned int i = 0; i < count; ++i, ++m_hairline_count)
+    {
+      float x, y, noise;
+      unsigned int column;
+
+      column = m_hairline_count % t_max(1u, m_hairline_points.m_value);
+      m_hairline_random = 1664525u * m_hairline_random + 1013904223u;
+      noise = static_cast<float>(m_hairline_random >> 8u) / static_cast<float>(1u << 24u) - 0.5f;
+      x = p0.x() + dx * static_cast<float>(column);
+      y = p0.y() + h * (0.5f + 0.35f * sinf(0.002f * static_cast<float>(m_hairline_count)) + 0.1f * noise);
+      if(column == 0)
+        {
+          m_hairline.move_to(vec2(x, y));
+        }
+      else
+        {
+          m_hairline.line_to(vec2(x, y));
+        }
+    }
+}
+
+void
+painter_stroke_test::
+construct_hairline(void)
+{
+  m_hairline.clear();
+  m_hairline_count = 0;
+  append_hairline_points(m_hairline_points.m_value);
+}
+
 void
 painter_stroke_test::
 create_stroked_path_attributes(void)
@@ -1071,21 +1195,21 @@ create_stroked_path_attributes(void)
           std::cout << "\tContour #" << c << "\n";
           for(unsigned int e = 0; e < tess->number_edges(c); ++e)
             {
-              fastuidraw::const_c_array<fastuidraw::TessellatedPath::point> pts;
+              fastuidraw::range_type<unsigned int> R(tess->edge_range(c, e));
 
               std::cout << "\t\tEdge #" << e << " has "
-                        << tess->edge_point_data(c, e).size() << " pts\n";
-              pts = tess->edge_point_data(c, e);
-              for(unsigned int i = 0; i < pts.size(); ++i)
+                        << R.m_end - R.m_begin << " pts\n";
+              for(unsigned int i = R.m_begin; i < R.m_end; ++i)
                 {
-                  std::cout << "\t\t\tPoint #" << i << ":\n"
-                            << "\t\t\t\tp          = " << pts[i].m_p << "\n"
-                            << "\t\t\t\tp_t        = " << pts[i].m_p_t << "\n"
-                            << "\t\t\t\tedge_d     = " << pts[i].m_distance_from_edge_start << "\n"
-                            << "\t\t\t\tcontour_d  = " << pts[i].m_distance_from_contour_start << "\n"
-                            << "\t\t\t\tedge_l     = " << pts[i].m_edge_length << "\n"
-                            << "\t\t\t\tcontour_l  = " << pts[i].m_open_contour_length << "\n"
-                            << "\t\t\t\tcontour_cl = " << pts[i].m_closed_contour_length << "\n";
+                  fastuidraw::TessellatedPath::point pt(tess->edge_point(c, e, i));
+                  std::cout << "\t\t\tPoint #" << i - R.m_begin << ":\n"
+                            << "\t\t\t\tp          = " << pt.m_p << "\n"
+                            << "\t\t\t\tp_t        = " << pt.m_p_t << "\n"
+                            << "\t\t\t\tedge_d     = " << pt.m_distance_from_edge_start << "\n"
+                            << "\t\t\t\tcontour_d  = " << pt.m_distance_from_contour_start << "\n"
+                            << "\t\t\t\tedge_l     = " << pt.m_edge_length << "\n"
+                            << "\t\t\t\tcontour_l  = " << pt.m_open_contour_length << "\n"
+                            << "\t\t\t\tcontour_cl = " << pt.m_closed_contour_length << "\n";
                 }
             }
         }
@@ -1160,12 +1284,12 @@ draw_frame(void)
   update_cts_params();
 
   glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
   enable_wire_frame(m_wire_frame);
 
   m_painter->curveFlatness(m_curve_flatness);
-  m_painter->begin();
+  m_painter->begin(Painter::BeginParams().multisampled_target(m_multisampled_target.m_value));
 
   if(m_force_square_viewport)
     {
@@ -1347,6 +1471,13 @@ draw_frame(void)
           fill_brush.sub_image(m_image, m_image_offset, m_image_size, f);
         }
 
+      PainterFillShader fill_shader(m_painter->default_shaders().fill_shader());
+      if(m_fill_by_stencil)
+        {
+          fill_shader.coverage(PainterFillShader::stencil_coverage);
+        }
+      fill_shader.anti_alias(m_aa_fill);
+
       if(m_fill_rule < PainterEnums::fill_rule_data_count)
         {
           enum PainterEnums::fill_rule_t v;
@@ -1361,7 +1492,7 @@ draw_frame(void)
             }
           else
             {
-              m_painter->fill_path(PainterData(&fill_brush), m_path, v);
+              m_painter->fill_path(fill_shader, PainterData(&fill_brush), m_path, v);
             }
         }
       else if(m_fill_rule == m_end_fill_rule)
@@ -1376,7 +1507,7 @@ draw_frame(void)
             }
           else
             {
-              m_painter->fill_path(PainterData(&fill_brush), m_path, EverythingWindingValueFillRule());
+              m_painter->fill_path(fill_shader, PainterData(&fill_brush), m_path, EverythingWindingValueFillRule());
             }
         }
       else
@@ -1397,7 +1528,7 @@ draw_frame(void)
             }
           else
             {
-              m_painter->fill_path(PainterData(&fill_brush), m_path, WindingValueFillRule(value));
+              m_painter->fill_path(fill_shader, PainterData(&fill_brush), m_path, WindingValueFillRule(value));
             }
         }
       submit_fill_time = measure.elapsed_us();
@@ -1411,7 +1542,15 @@ draw_frame(void)
   if(m_stroke_width > 0.0f)
     {
       simple_time measure;
-      if(is_dashed_stroking())
+      if(m_hairline_points.m_value > 0)
+        {
+          PainterStrokeParams st;
+          st.width(m_stroke_width);
+
+          append_hairline_points(m_hairline_append_per_frame.m_value);
+          m_painter->draw_hairline(PainterData(m_transparent_blue_pen, &st), m_hairline);
+        }
+      else if(is_dashed_stroking())
         {
           PainterDashedStrokeParams st;
           if(m_have_miter_limit)
@@ -1542,6 +1681,16 @@ draw_frame(void)
            << m_painter->query_stat(PainterPacker::num_indices)
            << "\nGenericData: "
            << m_painter->query_stat(PainterPacker::num_generic_datas)
+           << "\nFill subsets(drawn, culled): "
+           << m_painter->query_stat(PainterPacker::num_filled_path_subsets_selected)
+           << ", " << m_painter->query_stat(PainterPacker::num_filled_path_subsets_culled)
+           << "\nFill clusters culled: "
+           << m_painter->query_stat(PainterPacker::num_filled_path_clusters_culled)
+           << "\nStroke chunks: "
+           << m_painter->query_stat(PainterPacker::num_stroked_path_chunks_selected)
+           << "\nJoin, cap chunks: "
+           << m_painter->query_stat(PainterPacker::num_stroked_path_join_chunks_selected)
+           << ", " << m_painter->query_stat(PainterPacker::num_stroked_path_cap_chunks_selected)
            << "\nMouse position:"
            << item_coordinates(mouse_position)
            << "\n";
@@ -1554,7 +1703,8 @@ draw_frame(void)
   if(m_print_submit_stroke_time && m_stroke_width > 0.0f)
     {
       m_print_submit_stroke_time = false;
-      std::cout << "stroke_path took " << submit_stroke_time
+      std::cout << ((m_hairline_points.m_value > 0) ? "draw_hairline" : "stroke_path")
+                << " took " << submit_stroke_time
                 << " us (= " << submit_stroke_time / 1000
                 << "ms)\n";
     }
@@ -1581,8 +1731,19 @@ derived_init(int w, int h)
   m_change_miter_limit_rate.m_value /= 1000.0f;
   m_font = FontFreeType::create(m_font_file.m_value.c_str(), m_ft_lib, FontFreeType::RenderParams());
 
+  if(m_compact_edges.m_value)
+    {
+      StrokedPath::default_edge_format(StrokedPath::compact_edge_format);
+    }
+  StrokedPath::default_rounded_cache_max_bytes(m_rounded_cache_max_bytes.m_value);
   construct_path();
   create_stroked_path_attributes();
+  if(m_hairline_points.m_value > 0)
+    {
+      construct_hairline();
+      std::cout << "Hairline with " << m_hairline.segments().size()
+                << " segments\n";
+    }
   construct_color_stops();
   construct_dash_patterns();
   m_end_fill_rule = m_path.tessellation()->filled()->subset(0).winding_numbers().size() + PainterEnums::fill_rule_data_count;
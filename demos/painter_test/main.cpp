@@ -124,6 +124,7 @@ main(int argc, char **argv)
             << std::setw(40) << "image_data_size = " << PainterBrush::image_data_size << "\n"
             << std::setw(40) << "linear_gradient_data_size = " << PainterBrush::linear_gradient_data_size << "\n"
             << std::setw(40) << "radial_gradient_data_size = " << PainterBrush::radial_gradient_data_size << "\n"
+            << std::setw(40) << "gradient_inline_color_stops_data_size = " << PainterBrush::gradient_inline_color_stops_data_size << "\n"
             << std::setw(40) << "repeat_window_data_size = " << PainterBrush::repeat_window_data_size << "\n"
             << std::setw(40) << "transformation_matrix_data_size = " << PainterBrush::transformation_matrix_data_size << "\n"
             << std::setw(40) << "transformation_translation_data_size = " << PainterBrush::transformation_translation_data_size << "\n"
@@ -139,6 +140,7 @@ main(int argc, char **argv)
             << std::setw(40) << "gradient_mask = " << bitset(PainterBrush::gradient_mask) << "\n"
             << std::setw(40) << "radial_gradient_mask = " << bitset(PainterBrush::radial_gradient_mask) << "\n"
             << std::setw(40) << "gradient_repeat_mask = " << bitset(PainterBrush::gradient_repeat_mask) << "\n"
+            << std::setw(40) << "gradient_inline_color_stops_mask = " << bitset(PainterBrush::gradient_inline_color_stops_mask) << "\n"
             << std::setw(40) << "repeat_window_mask = " << bitset(PainterBrush::repeat_window_mask) << "\n"
             << std::setw(40) << "transformation_translation_mask = " << bitset(PainterBrush::transformation_translation_mask) << "\n"
             << std::setw(40) << "transformation_matrix_mask = " << bitset(PainterBrush::transformation_matrix_mask) << "\n"
@@ -0,0 +1,298 @@
+#include <fstream>
+#include <iterator>
+#include <fastuidraw/painter/painter.hpp>
+#include <fastuidraw/painter/painter_trace.hpp>
+#include <fastuidraw/text/glyph_cache.hpp>
+#include <fastuidraw/text/freetype_font.hpp>
+
+#include "sdl_painter_demo.hpp"
+#include "simple_time.hpp"
+
+using namespace fastuidraw;
+
+/*
+  painter-trace-replay replays the frames of a trace recorded
+  by a demo run with trace_file (see PainterTraceRecorder) to an
+  offscreen FBO, each frame a number of times, and prints the
+  average CPU and GPU time of each frame. The images of the
+  trace are replaced by generated checkerboards of the same
+  size and all the fonts of the trace by the font of the font
+  option.
+ */
+
+class painter_trace_replay:public sdl_painter_demo
+{
+public:
+  painter_trace_replay(void);
+  ~painter_trace_replay();
+
+protected:
+  void
+  derived_init(int w, int h);
+
+  void
+  draw_frame(void);
+
+  void
+  handle_event(const SDL_Event &ev);
+
+private:
+  class resource_provider:public PainterTracePlayer::ResourceProvider
+  {
+  public:
+    explicit
+    resource_provider(painter_trace_replay *p):
+      m_p(p)
+    {}
+
+    virtual
+    reference_counted_ptr<const Image>
+    image(const reference_counted_ptr<ImageAtlas> &atlas, ivec2 dims,
+          unsigned int slack, unsigned int number_mipmap_levels);
+
+    virtual
+    reference_counted_ptr<const FontBase>
+    font(const FontProperties &props);
+
+    virtual
+    reference_counted_ptr<GlyphCache>
+    glyph_cache(void);
+
+  private:
+    painter_trace_replay *m_p;
+  };
+
+  void
+  create_and_bind_fbo(void);
+
+  command_line_argument_value<std::string> m_trace_to_replay;
+  command_line_argument_value<std::string> m_font_file;
+  command_line_argument_value<int> m_num_repeats;
+  command_line_argument_value<int> m_num_warmup_repeats;
+  command_line_argument_value<int> m_fbo_width, m_fbo_height;
+
+  reference_counted_ptr<PainterTracePlayer> m_player;
+  reference_counted_ptr<const FontBase> m_font;
+  unsigned int m_current_frame;
+  int m_repeat;
+  uint64_t m_cpu_us_total, m_gpu_us_total;
+
+  ivec2 m_fbo_size;
+  GLuint m_fbo, m_color, m_depth_stencil;
+};
+
+//////////////////////////////////////////////
+// painter_trace_replay::resource_provider methods
+reference_counted_ptr<const Image>
+painter_trace_replay::resource_provider::
+image(const reference_counted_ptr<ImageAtlas> &atlas, ivec2 dims,
+      unsigned int slack, unsigned int number_mipmap_levels)
+{
+  std::vector<u8vec4> image_data(dims.x() * dims.y());
+  for(int y = 0; y < dims.y(); ++y)
+    {
+      for(int x = 0; x < dims.x(); ++x)
+        {
+          bool on(((x / 16) + (y / 16)) % 2 == 0);
+          image_data[x + y * dims.x()] = (on) ?
+            u8vec4(255, 128, 0, 255) :
+            u8vec4(0, 64, 255, 255);
+        }
+    }
+  return Image::create(atlas, dims.x(), dims.y(), cast_c_array(image_data),
+                       slack, number_mipmap_levels);
+}
+
+reference_counted_ptr<const FontBase>
+painter_trace_replay::resource_provider::
+font(const FontProperties &)
+{
+  return m_p->m_font;
+}
+
+reference_counted_ptr<GlyphCache>
+painter_trace_replay::resource_provider::
+glyph_cache(void)
+{
+  return m_p->m_glyph_cache;
+}
+
+//////////////////////////////////////////////
+// painter_trace_replay methods
+painter_trace_replay::
+painter_trace_replay(void):
+  sdl_painter_demo("painter-trace-replay: replay the frames of a Painter trace offscreen and report their timings"),
+  m_trace_to_replay("", "replay", "File of the trace to replay, as written by a demo run with trace_file", *this),
+  m_font_file("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", "font",
+              "File of the font to use in place of the fonts of the trace", *this),
+  m_num_repeats(100, "num_repeats", "Number of times to time each frame", *this),
+  m_num_warmup_repeats(10, "num_warmup_repeats",
+                       "Number of times to replay each frame before timing it; "
+                       "should be at least painter_timer_query_frames for the GPU times "
+                       "to not include the previous frame",
+                       *this),
+  m_fbo_width(0, "fbo_width", "width of FBO to which to render (value of 0 means the resolution of the trace)", *this),
+  m_fbo_height(0, "fbo_height", "height of FBO to which to render (value of 0 means the resolution of the trace)", *this),
+  m_current_frame(0),
+  m_repeat(0),
+  m_cpu_us_total(0),
+  m_gpu_us_total(0),
+  m_fbo(0),
+  m_color(0),
+  m_depth_stencil(0)
+{
+  // the replay does not react to input
+  m_handle_events = false;
+}
+
+painter_trace_replay::
+~painter_trace_replay()
+{
+  if(m_fbo != 0)
+    {
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      glDeleteFramebuffers(1, &m_fbo);
+      glDeleteTextures(1, &m_color);
+      glDeleteTextures(1, &m_depth_stencil);
+    }
+}
+
+void
+painter_trace_replay::
+create_and_bind_fbo(void)
+{
+  glGenFramebuffers(1, &m_fbo);
+  assert(m_fbo != 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+
+  glGenTextures(1, &m_color);
+  assert(m_color != 0);
+  glBindTexture(GL_TEXTURE_2D, m_color);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
+               m_fbo_size.x(), m_fbo_size.y(), 0,
+               GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+  glGenTextures(1, &m_depth_stencil);
+  assert(m_depth_stencil != 0);
+  glBindTexture(GL_TEXTURE_2D, m_depth_stencil);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8,
+               m_fbo_size.x(), m_fbo_size.y(), 0,
+               GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                         GL_TEXTURE_2D, m_color, 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                         GL_TEXTURE_2D, m_depth_stencil, 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
+                         GL_TEXTURE_2D, m_depth_stencil, 0);
+}
+
+void
+painter_trace_replay::
+derived_init(int w, int h)
+{
+  std::ifstream istr(m_trace_to_replay.m_value.c_str(), std::ios::binary);
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(istr)),
+                             std::istreambuf_iterator<char>());
+
+  m_font = FontFreeType::create(m_font_file.m_value.c_str(), m_ft_lib, FontFreeType::RenderParams());
+  m_player = FASTUIDRAWnew PainterTracePlayer(make_c_array(bytes),
+                                              FASTUIDRAWnew resource_provider(this));
+  if(!m_player->valid())
+    {
+      std::cerr << "Unable to read trace from \"" << m_trace_to_replay.m_value << "\"\n";
+      end_demo(-1);
+      return;
+    }
+
+  /* the FBO has the resolution of the first frame, the
+     following frames are drawn to the same resolution.
+   */
+  m_fbo_size = ivec2(w, h);
+  if(m_fbo_width.m_value > 0 && m_fbo_height.m_value > 0)
+    {
+      m_fbo_size = ivec2(m_fbo_width.m_value, m_fbo_height.m_value);
+    }
+  else if(m_player->number_frames() > 0)
+    {
+      m_fbo_size = m_player->frame_resolution(0);
+    }
+
+  create_and_bind_fbo();
+  m_painter->target_resolution(m_fbo_size.x(), m_fbo_size.y());
+
+  std::cout << "Replaying " << m_player->number_frames() << " frames at "
+            << m_fbo_size.x() << "x" << m_fbo_size.y() << "\n";
+  m_current_frame = 0;
+  m_repeat = -m_num_warmup_repeats.m_value;
+}
+
+void
+painter_trace_replay::
+draw_frame(void)
+{
+  if(!m_player || m_current_frame >= m_player->number_frames())
+    {
+      end_demo(0);
+      return;
+    }
+
+  simple_time timer;
+
+  glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+  glViewport(0, 0, m_fbo_size.x(), m_fbo_size.y());
+  glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+  m_glyph_cache->begin_frame();
+  timer.restart();
+  m_player->replay_frame(m_current_frame, *m_painter);
+
+  uint64_t cpu_us(timer.elapsed_us());
+
+  if(m_repeat >= 0)
+    {
+      m_cpu_us_total += cpu_us;
+      m_gpu_us_total += m_painter->query_stat(PainterPacker::backend_gpu_time_micro_seconds);
+    }
+
+  ++m_repeat;
+  if(m_repeat == m_num_repeats.m_value)
+    {
+      double denom(std::max(m_num_repeats.m_value, 1));
+
+      std::cout << "frame " << m_current_frame
+                << ": cpu_us_avg = " << static_cast<double>(m_cpu_us_total) / denom
+                << ", gpu_us_avg = " << static_cast<double>(m_gpu_us_total) / denom
+                << ", num_draws = " << m_painter->query_stat(PainterPacker::num_draws)
+                << "\n";
+
+      ++m_current_frame;
+      m_repeat = -m_num_warmup_repeats.m_value;
+      m_cpu_us_total = 0;
+      m_gpu_us_total = 0;
+    }
+}
+
+void
+painter_trace_replay::
+handle_event(const SDL_Event &ev)
+{
+  if(ev.type == SDL_QUIT)
+    {
+      end_demo(0);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+  painter_trace_replay P;
+  return P.main(argc, argv);
+}
@@ -0,0 +1,488 @@
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <fastuidraw/path.hpp>
+#include <fastuidraw/tessellated_path.hpp>
+#include <fastuidraw/painter/filled_path.hpp>
+#include <fastuidraw/painter/stroked_path.hpp>
+#include <fastuidraw/painter/painter_attribute_data.hpp>
+
+#include "generic_command_line.hpp"
+#include "simple_time.hpp"
+#include "read_path.hpp"
+#include "random.hpp"
+
+using namespace fastuidraw;
+
+/*
+  path-benchmark times the CPU preprocessing of paths; it does
+  not create a window or GL context. Each path of the corpus is
+  read through read_path() and then, separately timed, has its
+  TessellatedPath, FilledPath and StrokedPath constructed and
+  all Subset objects of the FilledPath triangulated (with the
+  triangulator selected by the triangulator option). The
+  StrokedPath is made with the edge format selected by the
+  edge_format option. The corpus is the files passed with add_path_file together with
+  generated paths whose point counts go from min_points to
+  max_points in steps of a factor of 10.
+
+  Allocations are counted by replacing the global operator new
+  and operator delete; this counts the allocations of all code,
+  including std::vector growth inside FastUIDraw. In debug builds,
+  FASTUIDRAWnew goes through the tracked allocator of FastUIDraw
+  and is not counted.
+ */
+
+namespace
+{
+  uint64_t allocation_count = 0;
+  uint64_t allocation_bytes = 0;
+
+  class allocation_counter
+  {
+  public:
+    allocation_counter(void):
+      m_count(allocation_count),
+      m_bytes(allocation_bytes)
+    {}
+
+    uint64_t
+    count(void) const
+    {
+      return allocation_count - m_count;
+    }
+
+    uint64_t
+    bytes(void) const
+    {
+      return allocation_bytes - m_bytes;
+    }
+
+  private:
+    uint64_t m_count, m_bytes;
+  };
+
+  void*
+  counted_allocate(std::size_t sz)
+  {
+    void *p;
+
+    ++allocation_count;
+    allocation_bytes += sz;
+    p = std::malloc(sz != 0 ? sz : 1);
+    if(p == NULL)
+      {
+        throw std::bad_alloc();
+      }
+    return p;
+  }
+}
+
+void*
+operator new(std::size_t sz)
+{
+  return counted_allocate(sz);
+}
+
+void*
+operator new[](std::size_t sz)
+{
+  return counted_allocate(sz);
+}
+
+void
+operator delete(void *p) throw()
+{
+  std::free(p);
+}
+
+void
+operator delete[](void *p) throw()
+{
+  std::free(p);
+}
+
+class command_line_list:
+  public command_line_argument,
+  public std::vector<std::string>
+{
+public:
+  command_line_list(const std::string &nm,
+                    const std::string &desc,
+                    command_line_register &p):
+    command_line_argument(p),
+    m_name(nm)
+  {
+    std::ostringstream ostr;
+    ostr << "\n\t" << m_name << " value"
+         << format_description_string(m_name, desc);
+    m_description = tabs_to_spaces(ostr.str());
+  }
+
+  virtual
+  int
+  check_arg(const std::vector<std::string> &argv, int location)
+  {
+    int argc(argv.size());
+    if(location + 1 < argc && argv[location] == m_name)
+      {
+        push_back(argv[location+1]);
+        std::cout << "\n\t" << m_name << " \""
+                  << argv[location+1] << "\" ";
+        return 2;
+      }
+    return 0;
+  }
+
+  virtual
+  void
+  print_command_line_description(std::ostream &ostr) const
+  {
+    ostr << "[" << m_name << " value] ";
+  }
+
+  virtual
+  void
+  print_detailed_description(std::ostream &ostr) const
+  {
+    ostr << m_description;
+  }
+
+private:
+  std::string m_name, m_description;
+};
+
+class stage_timing
+{
+public:
+  stage_timing(void):
+    m_us_min(0),
+    m_us_total(0),
+    m_allocs(0),
+    m_bytes(0),
+    m_runs(0)
+  {}
+
+  void
+  add(uint64_t us, const allocation_counter &allocs)
+  {
+    m_us_min = (m_runs == 0) ? us : std::min(m_us_min, us);
+    m_us_total += us;
+    m_allocs = allocs.count();
+    m_bytes = allocs.bytes();
+    ++m_runs;
+  }
+
+  uint64_t m_us_min, m_us_total;
+  uint64_t m_allocs, m_bytes;
+  unsigned int m_runs;
+};
+
+class path_benchmark:public command_line_register
+{
+public:
+  path_benchmark(void);
+
+  int
+  main(int argc, char **argv);
+
+private:
+  enum stage_t
+    {
+      read_stage,
+      tessellate_stage,
+      fill_stage,
+      triangulate_stage,
+      stroke_stage,
+
+      number_stages
+    };
+
+  static
+  std::string
+  generate_path_source(unsigned int num_points, unsigned int points_per_contour);
+
+  static
+  const char*
+  stage_name(enum stage_t s);
+
+  void
+  run_path(const std::string &label, const std::string &source);
+
+  command_line_argument_value<bool> m_print_help;
+  command_line_list m_path_files;
+  command_line_argument_value<unsigned int> m_min_points;
+  command_line_argument_value<unsigned int> m_max_points;
+  command_line_argument_value<unsigned int> m_points_per_contour;
+  command_line_argument_value<unsigned int> m_num_runs;
+  command_line_argument_value<bool> m_curvature_tessellation;
+  command_line_argument_value<bool> m_uniform_tessellation;
+  command_line_argument_value<float> m_tessellation_threshhold;
+  command_line_argument_value<unsigned int> m_max_segments;
+  command_line_argument_value<unsigned int> m_max_threads;
+  enumerated_command_line_argument_value<enum FilledPath::triangulator_t> m_triangulator;
+  enumerated_command_line_argument_value<enum StrokedPath::edge_format_t> m_edge_format;
+
+  TessellatedPath::TessellationParams m_tess_params;
+};
+
+path_benchmark::
+path_benchmark(void):
+  m_print_help(false, "help", "print help and exit", *this),
+  m_path_files("add_path_file", "add a path file, in the format of read_path(), to the corpus", *this),
+  m_min_points(10, "min_points", "smallest number of points of the generated paths", *this),
+  m_max_points(1000000, "max_points",
+               "largest number of points of the generated paths, a value of 0 "
+               "means to not generate paths",
+               *this),
+  m_points_per_contour(1000, "points_per_contour",
+                       "maximum number of points in each contour of the generated paths",
+                       *this),
+  m_num_runs(5, "num_runs", "number of times to run each stage on each path", *this),
+  m_curvature_tessellation(true, "curvature_tessellation",
+                           "if true, tessellate by curvature, otherwise by distance",
+                           *this),
+  m_uniform_tessellation(false, "uniform_tessellation",
+                         "if true and tessellating by distance, tessellate quadratic and "
+                         "cubic curves uniformly with the segment count from Wang's formula",
+                         *this),
+  m_tessellation_threshhold(float(M_PI) / 30.0f, "tessellation_threshhold",
+                            "threshhold value for tessellation, see TessellationParams",
+                            *this),
+  m_max_segments(32, "max_segments", "maximum number of segments per curve", *this),
+  m_max_threads(1, "max_threads",
+                "maximum number of threads with which to tessellate and triangulate, 0 means "
+                "to use the number of threads of the default task executor",
+                *this),
+  m_triangulator(FilledPath::glu_tess_triangulator,
+                 enumerated_string_type<enum FilledPath::triangulator_t>()
+                 .add_entry("glu", FilledPath::glu_tess_triangulator, "triangulate with GLU-tess")
+                 .add_entry("sweep", FilledPath::sweep_triangulator, "triangulate with the trapezoid sweep"),
+                 "triangulator",
+                 "Specifies how to triangulate the subsets of the filled paths", *this),
+  m_edge_format(StrokedPath::full_edge_format,
+                enumerated_string_type<enum StrokedPath::edge_format_t>()
+                .add_entry("full", StrokedPath::full_edge_format, "6 points and 4 triangles per sub-edge")
+                .add_entry("compact", StrokedPath::compact_edge_format, "4 points and 2 triangles per sub-edge"),
+                "edge_format",
+                "Specifies how to make the edges of the stroked paths", *this)
+{}
+
+const char*
+path_benchmark::
+stage_name(enum stage_t s)
+{
+  switch(s)
+    {
+    case read_stage: return "read_path";
+    case tessellate_stage: return "TessellatedPath";
+    case fill_stage: return "FilledPath";
+    case triangulate_stage: return "triangulate";
+    case stroke_stage: return "StrokedPath";
+    default: return "unknown";
+    }
+}
+
+std::string
+path_benchmark::
+generate_path_source(unsigned int num_points, unsigned int points_per_contour)
+{
+  /* generates contours that are random walks with a mix of
+     line segments, quadratic and cubic curves and arcs so
+     that all interpolator types are present and the filled
+     path has self-intersections for GLU-tess to resolve.
+   */
+  std::ostringstream str;
+  unsigned int emitted(0);
+
+  points_per_contour = std::max(3u, points_per_contour);
+  while(emitted < num_points)
+    {
+      unsigned int n;
+      vec2 center, pt;
+      float r;
+
+      n = std::min(points_per_contour, num_points - emitted);
+      n = std::max(3u, n);
+      center = random_value(vec2(0.0f, 0.0f), vec2(1000.0f, 1000.0f));
+      r = random_value(20.0f, 200.0f);
+
+      str << "[ ";
+      for(unsigned int i = 0; i < n; ++i)
+        {
+          float theta, rr;
+
+          theta = 2.0f * static_cast<float>(M_PI) * static_cast<float>(i) / static_cast<float>(n);
+          rr = r * random_value(0.5f, 1.5f);
+          pt = center + rr * vec2(std::cos(theta), std::sin(theta));
+          str << "(" << pt.x() << ", " << pt.y() << ") ";
+
+          switch(i % 4)
+            {
+            case 1:
+              pt = center + random_value(vec2(-r, -r), vec2(r, r));
+              str << "[[ (" << pt.x() << ", " << pt.y() << ") ]] ";
+              break;
+            case 2:
+              pt = center + random_value(vec2(-r, -r), vec2(r, r));
+              str << "[[ (" << pt.x() << ", " << pt.y() << ") ";
+              pt = center + random_value(vec2(-r, -r), vec2(r, r));
+              str << "(" << pt.x() << ", " << pt.y() << ") ]] ";
+              break;
+            case 3:
+              str << "arc " << random_value(-90.0f, 90.0f) << " ";
+              break;
+            default:
+              break;
+            }
+        }
+      str << "]\n";
+      emitted += n;
+    }
+  return str.str();
+}
+
+void
+path_benchmark::
+run_path(const std::string &label, const std::string &source)
+{
+  vecN<stage_timing, number_stages> timings;
+  unsigned int num_points(0), num_contours(0), num_tess_points(0), num_fill_attributes(0);
+  unsigned int num_stroke_attributes(0), num_stroke_indices(0);
+
+  for(unsigned int run = 0; run < m_num_runs.m_value; ++run)
+    {
+      simple_time timer;
+      Path path;
+
+      {
+        allocation_counter allocs;
+        timer.restart();
+        read_path(path, source);
+        timings[read_stage].add(timer.elapsed_us(), allocs);
+      }
+
+      reference_counted_ptr<TessellatedPath> tess;
+      {
+        allocation_counter allocs;
+        timer.restart();
+        tess = FASTUIDRAWnew TessellatedPath(path, m_tess_params);
+        timings[tessellate_stage].add(timer.elapsed_us(), allocs);
+      }
+
+      reference_counted_ptr<FilledPath> filled;
+      {
+        allocation_counter allocs;
+        timer.restart();
+        filled = FASTUIDRAWnew FilledPath(*tess, m_triangulator.m_value.m_value);
+        timings[fill_stage].add(timer.elapsed_us(), allocs);
+      }
+
+      {
+        allocation_counter allocs;
+        timer.restart();
+        /* the root Subset is made from all the others, so
+           fetching it triangulates every Subset.
+         */
+        filled->subset(0);
+        timings[triangulate_stage].add(timer.elapsed_us(), allocs);
+      }
+
+      {
+        allocation_counter allocs;
+        timer.restart();
+        reference_counted_ptr<StrokedPath> stroked;
+        stroked = FASTUIDRAWnew StrokedPath(*tess, m_edge_format.m_value.m_value);
+        timings[stroke_stage].add(timer.elapsed_us(), allocs);
+
+        /* the last chunk of the edges is the root of
+           the hierarchy and holds all the edges.
+         */
+        const PainterAttributeData &edges(stroked->edges(true));
+        num_stroke_attributes = edges.attribute_data_chunks().back().size();
+        num_stroke_indices = edges.index_data_chunks().back().size();
+      }
+
+      num_contours = path.number_contours();
+      num_tess_points = tess->number_points();
+      num_fill_attributes = filled->subset(0).painter_data().attribute_data_chunk(0).size();
+      num_points = 0;
+      for(unsigned int c = 0; c < num_contours; ++c)
+        {
+          num_points += path.contour(c)->number_points();
+        }
+    }
+
+  std::cout << label << ": " << num_contours << " contours, "
+            << num_points << " points, "
+            << num_tess_points << " tessellated points, "
+            << num_fill_attributes << " fill attributes, "
+            << num_stroke_attributes << " stroke edge attributes, "
+            << num_stroke_indices << " stroke edge indices\n";
+  for(int s = 0; s < number_stages; ++s)
+    {
+      const stage_timing &T(timings[s]);
+      std::cout << "\t" << std::setw(16) << std::left << stage_name(static_cast<enum stage_t>(s))
+                << " min = " << std::setw(10) << T.m_us_min << " us"
+                << " avg = " << std::setw(10) << T.m_us_total / std::max(1u, T.m_runs) << " us"
+                << " allocs = " << std::setw(10) << T.m_allocs
+                << " bytes = " << T.m_bytes << "\n";
+    }
+}
+
+int
+path_benchmark::
+main(int argc, char **argv)
+{
+  parse_command_line(argc, argv);
+  std::cout << "\n";
+  if(m_print_help.m_value)
+    {
+      print_help(std::cout);
+      print_detailed_help(std::cout);
+      return 0;
+    }
+
+  m_tess_params.m_curvature_tessellation = m_curvature_tessellation.m_value;
+  m_tess_params.m_uniform_tessellation = m_uniform_tessellation.m_value;
+  m_tess_params.m_threshhold = m_tessellation_threshhold.m_value;
+  m_tess_params.m_max_segments = m_max_segments.m_value;
+  m_tess_params.m_max_threads = m_max_threads.m_value;
+
+  for(unsigned int i = 0, endi = m_path_files.size(); i < endi; ++i)
+    {
+      std::ifstream path_file(m_path_files[i].c_str());
+      if(path_file)
+        {
+          std::stringstream buffer;
+          buffer << path_file.rdbuf();
+          run_path(m_path_files[i], buffer.str());
+        }
+      else
+        {
+          std::cerr << "Unable to open \"" << m_path_files[i] << "\"\n";
+        }
+    }
+
+  if(m_max_points.m_value > 0)
+    {
+      for(unsigned int N = std::max(3u, m_min_points.m_value); N <= m_max_points.m_value; N *= 10)
+        {
+          std::ostringstream label;
+          label << "generated_" << N;
+          run_path(label.str(), generate_path_source(N, m_points_per_contour.m_value));
+        }
+    }
+
+  return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+  path_benchmark P;
+  return P.main(argc, argv);
+}
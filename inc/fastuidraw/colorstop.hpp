@@ -104,8 +104,33 @@ namespace fastuidraw
     explicit
     ColorStopSequence(int reserve);
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+    /*!
+      Move ctor, takes the color stops of obj without
+      copying them; obj is then empty.
+      \param obj value from which to take the color stops
+     */
+    ColorStopSequence(ColorStopSequence &&obj) noexcept;
+
+    /*!
+      Move assignment operator, swaps the color stops
+      of this ColorStopSequence with those of obj.
+      \param obj value from which to take the color stops
+     */
+    ColorStopSequence&
+    operator=(ColorStopSequence &&obj) noexcept;
+#endif
+
     ~ColorStopSequence();
 
+    /*!
+      Swap the color stops of this ColorStopSequence
+      with those of another ColorStopSequence.
+      \param obj ColorStopSequence with which to swap
+     */
+    void
+    swap(ColorStopSequence &obj);
+
     /*!
       Add a ColorStop to this ColorStopSequence
       \param c value to add
@@ -106,7 +106,9 @@ namespace fastuidraw
     resizeable(void) const;
 
     /*!
-      Resize the object by increasing the number of layers.
+      Resize the object by changing the number of layers.
+      Decreasing the number of layers discards the texels of
+      the removed layers (see ColorStopAtlas::trim()).
       The routine resizeable() must return true, if not
       the function asserts.
      */
@@ -117,7 +119,8 @@ namespace fastuidraw
     /*!
       To be implemented by a derived class to resize the
       object. The resize changes ONLY the number of layers
-      of the object and only increases the value as well.
+      of the object; when the number of layers decreases
+      the texels of the remaining layers must be kept.
       When called, the return value of dimensions() is
       the size before the resize completes.
       \param new_num_layers new number of layers to which
@@ -155,14 +158,21 @@ namespace fastuidraw
       Allocate and set on the atlas a sequence of color values
       to be stored continuously in a common layer. Returns
       the offset into the layer in ivec2::x() and the which
-      layer in ivec2::y().
+      layer in ivec2::y(). If a sequence of identical color
+      values is already on the atlas, that location is returned
+      and shared (so that many ColorStopSequenceOnAtlas objects
+      made from the same color stops and width occupy the atlas
+      only once); each allocate() is to be matched by one
+      deallocate(), the region is freed by the last one.
       \param data data to place on atlas
      */
     ivec2
     allocate(const_c_array<u8vec4> data);
 
     /*!
-      Mark a region to be free on the atlas
+      Mark a region to be free on the atlas; if the region
+      is shared by several calls to allocate() (see allocate()),
+      the region is only freed once each has been deallocated.
       \param location .x() gives the offset into the layer to
                       mark as free and .y() gives the layer
       \param width number of elements to mark as free
@@ -201,6 +211,23 @@ namespace fastuidraw
     reference_counted_ptr<const ColorStopBackingStore>
     backing_store(void) const;
 
+    /*!
+      Shrink the backing store to give memory back after a
+      peak of use, for example from a callback of the
+      application on memory pressure (see
+      memory::budget_callback). The trailing layers that
+      have no color stops are removed, keeping at least one
+      layer. The color stops on the atlas are held by their
+      ColorStopSequenceOnAtlas objects, so only the layers
+      freed by the objects the application has released are
+      given back; the intervals whose freeing is delayed (see
+      delay_interval_freeing()) still count as used. Does
+      nothing if the backing store is not resizeable. Returns
+      the number of bytes of the backing store after the call.
+     */
+    uint64_t
+    trim(void);
+
     /*!
       Increments an internal counter. If this internal
       counter is greater than zero, then the reurning
@@ -290,6 +317,13 @@ namespace fastuidraw
     reference_counted_ptr<const ColorStopAtlas>
     atlas(void) const;
 
+    /*!
+      Returns the color stops, sorted by ColorStop::m_place,
+      from which the ColorStopSequenceOnAtlas was created.
+     */
+    const_c_array<ColorStop>
+    color_stops(void) const;
+
   private:
     void *m_d;
   };
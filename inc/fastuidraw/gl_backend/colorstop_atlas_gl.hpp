@@ -119,6 +119,22 @@ namespace gl
       params&
       delayed(bool v);
 
+      /*!
+        if true, the ColorStopAtlasGL keeps a copy of the
+        contents of its texture in CPU memory so that
+        ColorStopAtlasGL::restore_after_context_loss() can
+        re-create the texture on a new GL context; initial
+        value is false.
+       */
+      bool
+      cpu_mirror(void) const;
+
+      /*!
+        Set the value for cpu_mirror(void) const
+       */
+      params&
+      cpu_mirror(bool v);
+
     private:
       void *m_d;
     };
@@ -146,6 +162,19 @@ namespace gl
     const params&
     param_values(void);
 
+    /*!
+      To be called after the GL context of the ColorStopAtlasGL
+      is lost, with the GL context that replaces it current, to
+      re-create the texture of the atlas and upload to it the
+      color stops from the CPU mirror (see params::cpu_mirror()).
+      The GL objects of the lost context are not deleted. The
+      ColorStopSequenceOnAtlas objects of the atlas remain valid.
+      Returns false, doing nothing, if the atlas was constructed
+      without a CPU mirror.
+     */
+    bool
+    restore_after_context_loss(void);
+
     /*!
       Returns the texture bind target of the underlying texture;
       for GLES this is GL_TEXTURE_2D_ARRAY, for GL this is
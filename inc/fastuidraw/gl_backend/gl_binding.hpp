@@ -70,7 +70,12 @@ namespace fastuidraw {
 
   This is implemented by creating a macro for each
   GL call. If GL_DEBUG is not defined, none of these
-  logging and error calls backs are executed.
+  logging and error calls backs are executed; the macro
+  of a GL function that is linked directly calls the
+  GL function directly and the macro of a GL function
+  fetched with get_proc_function() calls through its
+  function pointer, so that a GL call costs the same as
+  a GL call made without the macro system.
   The mechanism is implemented by defining a macro
   for each GL function, hence using a GL function
   name as a function pointer will fail to compile
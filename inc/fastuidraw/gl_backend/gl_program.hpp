@@ -80,6 +80,10 @@ public:
     are called. This way, one can construct Shader
     objects from outside the GL thread. The functions
     return true if and only if the shader has been built.
+    Note that name() only issues the GL commands to
+    compile, it does not query GL for the result of the
+    compile, thus after calling only name(), shader_ready()
+    still returns false.
    */
   bool
   shader_ready(void);
@@ -182,6 +186,23 @@ public:
   virtual
   void
   action(GLuint glsl_program) const = 0;
+
+  /*!
+    To be optionally implemented by a derived class to return
+    a string that uniquely identifies the effect of action().
+    The string is hashed into the key with which a Program
+    stores and fetches its binary in a ProgramBinaryCache.
+    Default implementation returns NULL which indicates that
+    the action cannot be identified, a Program whose
+    PreLinkActionArray has such an action does not use the
+    ProgramBinaryCache.
+   */
+  virtual
+  const char*
+  binary_cache_key(void) const
+  {
+    return NULL;
+  }
 };
 
 
@@ -206,6 +227,10 @@ public:
   void
   action(GLuint glsl_program) const;
 
+  virtual
+  const char*
+  binary_cache_key(void) const;
+
 private:
   void *m_d;
 };
@@ -224,6 +249,10 @@ public:
   virtual
   void
   action(GLuint glsl_program) const;
+
+  virtual
+  const char*
+  binary_cache_key(void) const;
 };
 
 /*!
@@ -282,6 +311,12 @@ public:
   void
   execute_actions(GLuint glsl_program) const;
 
+  /*!
+    Returns the actions added via add().
+   */
+  const_c_array<reference_counted_ptr<PreLinkAction> >
+  actions(void) const;
+
 private:
   void *m_d;
 };
@@ -544,6 +579,90 @@ private:
   void *m_d;
 };
 
+/*!
+  A ProgramBinaryCache provides an interface for a Program
+  to fetch and store program binaries (as returned by
+  glGetProgramBinary) so that a Program can skip compiling
+  and linking its shaders. A binary is identified by a key
+  string computed by Program from the source code of its
+  shaders, the PreLinkAction::binary_cache_key() of its
+  pre-link actions together with the GL vendor, renderer and
+  version strings and, if GL_EXT_memory_object is supported,
+  the driver UUID. A Program having a pre-link action whose
+  binary_cache_key() returns NULL does not use its
+  ProgramBinaryCache. Program binaries require GL version 4.1 or the
+  extension GL_ARB_get_program_binary for GL and version 3.0
+  for GLES; when not supported, a Program ignores its
+  ProgramBinaryCache.
+ */
+class ProgramBinaryCache:
+  public reference_counted<ProgramBinaryCache>::default_base
+{
+public:
+  virtual
+  ~ProgramBinaryCache()
+  {}
+
+  /*!
+    To be implemented by a derived class to fetch the program
+    binary associated to a key. Returns true if a binary was
+    found. The returned data must stay valid until the next
+    call to fetch() or store() on the ProgramBinaryCache.
+    \param key key of the program binary
+    \param[out] binary_format location to which to write the
+                              binary format of the program binary
+    \param[out] binary location to which to write the program
+                       binary data
+   */
+  virtual
+  bool
+  fetch(const char *key, GLenum *binary_format,
+        const_c_array<uint8_t> *binary) = 0;
+
+  /*!
+    To be implemented by a derived class to store a program
+    binary associated to a key.
+    \param key key of the program binary
+    \param binary_format binary format of the program binary
+    \param binary program binary data
+   */
+  virtual
+  void
+  store(const char *key, GLenum binary_format,
+        const_c_array<uint8_t> binary) = 0;
+};
+
+/*!
+  A ProgramBinaryCacheDirectory implements ProgramBinaryCache
+  by storing each program binary as a file within a directory.
+  The directory must already exist.
+ */
+class ProgramBinaryCacheDirectory:public ProgramBinaryCache
+{
+public:
+  /*!
+    Ctor.
+    \param path directory in which to store the program binaries
+   */
+  explicit
+  ProgramBinaryCacheDirectory(const char *path);
+
+  ~ProgramBinaryCacheDirectory();
+
+  virtual
+  bool
+  fetch(const char *key, GLenum *binary_format,
+        const_c_array<uint8_t> *binary);
+
+  virtual
+  void
+  store(const char *key, GLenum binary_format,
+        const_c_array<uint8_t> binary);
+
+private:
+  void *m_d;
+};
+
 /*!
   Class for creating and using GLSL programs.
   A Program delays the GL commands to
@@ -1020,10 +1139,14 @@ public:
     \param action specifies actions to perform before linking of the Program
     \param initers one-time initialization actions to perform at GLSL
                    program creation
+    \param binary_cache if non-NULL, ProgramBinaryCache from which to
+                        fetch (and to which to store) the program binary
    */
   Program(const_c_array<reference_counted_ptr<Shader> > pshaders,
           const PreLinkActionArray &action = PreLinkActionArray(),
-          const ProgramInitializerArray &initers = ProgramInitializerArray());
+          const ProgramInitializerArray &initers = ProgramInitializerArray(),
+          const reference_counted_ptr<ProgramBinaryCache> &binary_cache =
+          reference_counted_ptr<ProgramBinaryCache>());
 
   /*!
     Ctor.
@@ -1033,11 +1156,15 @@ public:
                   after linking of the Program.
     \param initers one-time initialization actions to perform at GLSL
                    program creation
+    \param binary_cache if non-NULL, ProgramBinaryCache from which to
+                        fetch (and to which to store) the program binary
    */
   Program(reference_counted_ptr<Shader> vert_shader,
           reference_counted_ptr<Shader> frag_shader,
           const PreLinkActionArray &action = PreLinkActionArray(),
-          const ProgramInitializerArray &initers = ProgramInitializerArray());
+          const ProgramInitializerArray &initers = ProgramInitializerArray(),
+          const reference_counted_ptr<ProgramBinaryCache> &binary_cache =
+          reference_counted_ptr<ProgramBinaryCache>());
 
   /*!
     Ctor.
@@ -1047,11 +1174,15 @@ public:
                   after linking of the Program.
     \param initers one-time initialization actions to perform at GLSL
                    program creation
+    \param binary_cache if non-NULL, ProgramBinaryCache from which to
+                        fetch (and to which to store) the program binary
    */
   Program(const glsl::ShaderSource &vert_shader,
           const glsl::ShaderSource &frag_shader,
           const PreLinkActionArray &action = PreLinkActionArray(),
-          const ProgramInitializerArray &initers = ProgramInitializerArray());
+          const ProgramInitializerArray &initers = ProgramInitializerArray(),
+          const reference_counted_ptr<ProgramBinaryCache> &binary_cache =
+          reference_counted_ptr<ProgramBinaryCache>());
 
 
   ~Program(void);
@@ -1093,6 +1224,42 @@ public:
   float
   program_build_time(void);
 
+  /*!
+    Issue the GL commands to compile and link the Program
+    without querying GL for the results of the compile
+    and link. If the GL implementation supports the
+    extension GL_KHR_parallel_shader_compile (or
+    GL_ARB_parallel_shader_compile), it may perform the
+    compile and link in a background thread and
+    build_ready() can be used to poll for completion
+    without blocking. Calling start_build() before
+    use_program() is optional; the GL context must be
+    current.
+   */
+  void
+  start_build(void);
+
+  /*!
+    Returns true if querying any of the properties of
+    the Program will not have to wait on GL to finish
+    compiling and linking. If start_build() has not been
+    called, returns false. If the GL implementation does
+    not support parallel shader compile, returns true
+    once start_build() has been called. The GL context
+    must be current.
+   */
+  bool
+  build_ready(void);
+
+  /*!
+    Returns true if the Program was realized from a
+    program binary fetched from the ProgramBinaryCache
+    passed at ctor, i.e. the shaders of the Program
+    were not compiled and linked.
+   */
+  bool
+  from_binary_cache(void);
+
   /*!
     Returns true if and only if this Program
     successfully linked. This function should
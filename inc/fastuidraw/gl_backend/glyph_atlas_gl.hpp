@@ -184,6 +184,42 @@ namespace gl
       params&
       alignment(unsigned int v);
 
+      /*!
+        if true, the GlyphAtlasGL keeps a copy of the contents
+        of its texel and geometry stores in CPU memory so that
+        GlyphAtlasGL::restore_after_context_loss() can re-create
+        them on a new GL context; initial value is false.
+       */
+      bool
+      cpu_mirror(void) const;
+
+      /*!
+        Set the value for cpu_mirror(void) const
+       */
+      params&
+      cpu_mirror(bool v);
+
+      /*!
+        if true, the texels of the texel store are 16-bit
+        (see GlyphAtlasTexelBackingStoreBase::sixteen_bit()),
+        backed by a GL_RG8UI texture with the low byte in
+        the red channel and the high byte in the green channel.
+        Glyphs whose texels are more than 8-bits (such as
+        GlyphRenderDataCurvePair glyphs of many curves) are
+        then fetched with a single texel fetch from a single
+        region of the atlas instead of two fetches from two
+        regions; the cost is that the texel store takes twice
+        the memory for all glyphs. Initial value is false.
+       */
+      bool
+      sixteen_bit_texel_store(void) const;
+
+      /*!
+        Set the value for sixteen_bit_texel_store(void) const
+       */
+      params&
+      sixteen_bit_texel_store(bool v);
+
     private:
       void *m_d;
     };
@@ -204,7 +240,10 @@ namespace gl
       GL context is the context to which the texture will belong).
       \param as_integer if true, returns a view to the texture whose internal
                         format is GL_R8UI. If false returns a view to the
-                        texture whose internal format is GL_R8. NOTE:
+                        texture whose internal format is GL_R8. If the
+                        texel store is 16-bit (see
+                        params::sixteen_bit_texel_store()), the formats
+                        are GL_RG8UI and GL_RG8 instead. NOTE:
                         if the GL implementation does not support the
                         glTextureView API (in ES via GL_OES_texture_view),
                         will return 0 if as_integer is false.
@@ -245,6 +284,19 @@ namespace gl
     const params&
     param_values(void) const;
 
+    /*!
+      To be called after the GL context of the GlyphAtlasGL is
+      lost, with the GL context that replaces it current, to
+      re-create the GL objects of the atlas and upload to them
+      the glyph data from the CPU mirror (see params::cpu_mirror()).
+      The glyphs of a GlyphCache on the atlas then remain valid
+      and are not generated again. The GL objects of the lost
+      context are not deleted. Returns false, doing nothing, if
+      the atlas was constructed without a CPU mirror.
+     */
+    bool
+    restore_after_context_loss(void);
+
   private:
     void *m_d;
   };
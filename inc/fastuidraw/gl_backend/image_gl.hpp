@@ -41,7 +41,10 @@ namespace gl
     If the ImageAtlasGL was constructed as delayed,
     then the loading of data to the GL textures is delayed until
     flush(), otherwise it is done immediately and then must be done
-    with a GL context current.
+    with a GL context current. When delayed, the texels of the tiles
+    added since the last flush() are sent to the GL in flush() through
+    a ring of pixel unpack buffer objects, and Image objects may be
+    created on any thread (see Image::uploaded()).
    */
   class ImageAtlasGL:public ImageAtlas
   {
@@ -174,6 +177,62 @@ namespace gl
       params&
       delayed(bool v);
 
+      /*!
+        If true, the color tiles are stored in the block
+        compressed format GL_COMPRESSED_RGBA8_ETC2_EAC, using
+        a quarter of the memory and sampling bandwidth of
+        GL_RGBA8. The texels of each color tile are compressed
+        on the CPU when the tile is added to the ImageAtlasGL.
+        Requires OpenGL ES 3.0, OpenGL 4.3 or GL_ARB_ES3_compatibility.
+        Because the compression is lossy, images whose tiles
+        are compressed are not an exact reproduction of the
+        texel data given. When true, the effective value of
+        log2_color_tile_size() is atleast 2 so that the color
+        tiles are made of whole 4x4 blocks and resizing the
+        color store (see ImageAtlas::resizeable()) requires
+        glCopyImageSubData (OpenGL ES 3.2, OpenGL 4.3,
+        GL_ARB_copy_image, GL_OES_copy_image or GL_EXT_copy_image).
+        Initial value is false.
+       */
+      bool
+      compressed_color_tiles(void) const;
+
+      /*!
+        Set the value for compressed_color_tiles(void) const
+       */
+      params&
+      compressed_color_tiles(bool v);
+
+      /*!
+        The value for ImageAtlas::direct_index_lookup()
+        of the ImageAtlasGL, initial value is false.
+       */
+      bool
+      direct_index_lookup(void) const;
+
+      /*!
+        Set the value for direct_index_lookup(void) const
+       */
+      params&
+      direct_index_lookup(bool v);
+
+      /*!
+        if true, the ImageAtlasGL keeps a copy of the contents
+        of its color and index textures in CPU memory so that
+        ImageAtlasGL::restore_after_context_loss() can re-create
+        the textures on a new GL context; the copy of compressed
+        color tiles (see compressed_color_tiles()) holds the
+        compressed blocks. Initial value is false.
+       */
+      bool
+      cpu_mirror(void) const;
+
+      /*!
+        Set the value for cpu_mirror(void) const
+       */
+      params&
+      cpu_mirror(bool v);
+
     private:
       void *m_d;
     };
@@ -214,6 +273,21 @@ namespace gl
     const params&
     param_values(void) const;
 
+    /*!
+      To be called after the GL context of the ImageAtlasGL is
+      lost, with the GL context that replaces it current, to
+      re-create the color and index textures of the atlas and
+      upload to them the tiles from the CPU mirror (see
+      params::cpu_mirror()), so that the Image objects on the
+      atlas remain valid without decoding them again. The GL
+      objects of the lost context are not deleted. Images that
+      are not on the atlas (for example bindless images) are
+      not restored. Returns false, doing nothing, if the atlas
+      was constructed without a CPU mirror.
+     */
+    bool
+    restore_after_context_loss(void);
+
     /*!
       Returns the coordinates to use for the corners
       of drawing an image that are fed as the 1st
@@ -228,6 +302,151 @@ namespace gl
   private:
     void *m_d;
   };
+
+  /*!
+    Create an Image (see Image::create_bindless()) whose texels
+    are the texels of GL texture of type GL_TEXTURE_2D, for example
+    a texture owned by the application into which video frames are
+    decoded. The bindless handle of the texture (from glGetTextureHandleARB())
+    is made resident; the application is to keep the texture alive
+    while the returned Image is drawn and to make the handle non-resident
+    with glMakeTextureHandleNonResidentARB(Image::bindless_handle()) once
+    it no longer draws the Image. Requires GL_ARB_bindless_texture and
+    a GL context current; returns a NULL handle if the extension is not
+    supported or if the handle could not be made. The Image is drawn
+    directly only if PainterBackendGL::ConfigurationGL::bindless_images()
+    is true. Once a handle for a texture is made, the GL does not allow
+    the texture's parameters or storage to change.
+    \param texture GL name of the texture
+    \param w width of the texture
+    \param h height of the texture
+    \param premultiplied_alpha if true, the texels of the texture are
+                               pre-multiplied by alpha, see
+                               Image::premultiplied_alpha()
+   */
+  reference_counted_ptr<Image>
+  create_bindless_image(GLuint texture, int w, int h,
+                        bool premultiplied_alpha = false);
+
+  /*!
+    An ExternalTextureGL represents a texture whose texels are
+    produced outside of FastUIDraw, for example the frames of a
+    video decoder that outputs GL textures or EGLImages (of
+    dmabufs), as an Image (see image()) that a PainterBrush
+    draws directly without any copy of the texels. The Image is
+    a bindless image (see Image::create_bindless()) and is drawn
+    only if PainterBackendGL::ConfigurationGL::bindless_images()
+    is true; if the texture is of type GL_TEXTURE_EXTERNAL_OES,
+    additionally PainterBackendGL::ConfigurationGL::external_texture_images()
+    must be true. On deletion, the bindless handle of the texture
+    is made non-resident and if the texture was created by the
+    ExternalTextureGL, the texture is deleted; hence an
+    ExternalTextureGL must outlive the last Painter::end() that
+    draws its image() and no two ExternalTextureGL may wrap the
+    same texture.
+
+    Synchronization with the producer of the texels is explicit:
+    each frame acquire() is called with the fence the producer
+    signals once it has written the texels and release() is called
+    after the Painter::end() of the frame to return a fence that is
+    signaled once the GL has finished reading the texels, which is
+    handed back to the producer before it writes to the texture again.
+    All methods must be called with a GL context current. Only
+    supported for GL (not GLES) with GL_ARB_bindless_texture.
+   */
+  class ExternalTextureGL:
+    public reference_counted<ExternalTextureGL>::default_base
+  {
+  public:
+    /*!
+      Create an ExternalTextureGL wrapping a texture owned
+      by the application; the application is to keep the
+      texture alive for the lifetime of the returned object.
+      Returns a NULL handle if GL_ARB_bindless_texture is
+      not supported, if target is not one of GL_TEXTURE_2D
+      or GL_TEXTURE_EXTERNAL_OES, or if the bindless handle
+      of the texture could not be made. Once a handle for a
+      texture is made, the GL does not allow the texture's
+      parameters or storage to change.
+      \param texture GL name of the texture
+      \param target texture type of the texture, one of
+                    GL_TEXTURE_2D or GL_TEXTURE_EXTERNAL_OES
+      \param w width of the texture
+      \param h height of the texture
+     */
+    static
+    reference_counted_ptr<ExternalTextureGL>
+    create(GLuint texture, GLenum target, int w, int h);
+
+    /*!
+      Create an ExternalTextureGL whose texture is created from
+      an EGLImage with glEGLImageTargetTexStorageEXT(). The
+      texture is sampled with bilinear filtering and clamped
+      to its edges. Returns a NULL handle if either of the
+      extensions GL_ARB_bindless_texture or GL_EXT_EGL_image_storage
+      is not supported or if the texture could not be created.
+      \param egl_image the EGLImage, the caller is to keep it alive
+                       for the lifetime of the returned object
+      \param external if true the texture is created as type
+                      GL_TEXTURE_EXTERNAL_OES, which is necessary
+                      for EGLImages whose texels are not RGBA (for
+                      example YUV video frames), otherwise the texture
+                      is created as type GL_TEXTURE_2D
+      \param w width of the EGLImage
+      \param h height of the EGLImage
+     */
+    static
+    reference_counted_ptr<ExternalTextureGL>
+    create_from_egl_image(void *egl_image, bool external, int w, int h);
+
+    ~ExternalTextureGL();
+
+    /*!
+      Returns the Image through which to draw the texture.
+     */
+    const reference_counted_ptr<Image>&
+    image(void) const;
+
+    /*!
+      Returns the GL name of the texture.
+     */
+    GLuint
+    texture(void) const;
+
+    /*!
+      Returns the texture type of the texture, one of
+      GL_TEXTURE_2D or GL_TEXTURE_EXTERNAL_OES.
+     */
+    GLenum
+    target(void) const;
+
+    /*!
+      Makes the GL wait (without blocking the CPU) for the GPU to
+      signal the fence before executing any GL command issued after,
+      in particular the draws of the Painter that sample the texture.
+      To be called before the Painter::end() of the frame the new
+      texels are to be drawn. The fence is deleted by the call.
+      \param fence fence the producer of the texels signals when it
+                   has written them; if NULL, nothing is done
+     */
+    void
+    acquire(GLsync fence);
+
+    /*!
+      Returns a new fence that is signaled once the GPU has executed
+      all GL commands issued before the call; to be called after the
+      Painter::end() of the last frame drawing the texels. The
+      caller owns the returned fence.
+     */
+    GLsync
+    release(void);
+
+  private:
+    ExternalTextureGL(GLuint texture, GLenum target, bool owns_texture,
+                      const reference_counted_ptr<Image> &image);
+
+    void *m_d;
+  };
 /*! @} */
 
 } //namespace gl
@@ -25,6 +25,7 @@
 #include <fastuidraw/gl_backend/image_gl.hpp>
 #include <fastuidraw/gl_backend/glyph_atlas_gl.hpp>
 #include <fastuidraw/gl_backend/colorstop_atlas_gl.hpp>
+#include <fastuidraw/gl_backend/gl_program.hpp>
 
 namespace fastuidraw
 {
@@ -68,6 +69,36 @@ namespace fastuidraw
           number_program_types
         };
 
+      /*!
+        A TimerQueryResult holds the GPU time taken by the
+        draws of a frame that used the same shaders, see
+        ConfigurationGL::timer_query_frames().
+       */
+      class TimerQueryResult
+      {
+      public:
+        /*!
+          The PainterShaderGroup::item_group() of the draws.
+         */
+        uint32_t m_item_group;
+
+        /*!
+          The PainterShaderGroup::blend_group() of the draws.
+         */
+        uint32_t m_blend_group;
+
+        /*!
+          The PainterShaderGroup::brush() of the draws.
+         */
+        uint32_t m_brush;
+
+        /*!
+          The sum of the GPU time in nanoseconds
+          of the draws.
+         */
+        uint64_t m_time_ns;
+      };
+
       /*!
         A ConfigurationGL gives parameters how to contruct
         a PainterBackendGL.
@@ -186,8 +217,13 @@ namespace fastuidraw
           Returns how the data store is realized. The GL implementation
           may impose size limits that will force that the size of the
           data store might be smaller than that specified by
-          data_blocks_per_store_buffer(). The initial value
-          is data_store_tbo.
+          data_blocks_per_store_buffer(). If the GL context does not
+          support the backing, data_store_ssbo falls back to
+          data_store_tbo and data_store_tbo falls back to
+          data_store_ubo. Which backing is the fastest depends
+          on the GL implementation, see
+          PainterBackendGL::calibrate_data_store_backing().
+          The initial value is data_store_tbo.
          */
         enum data_store_backing_t
         data_store_backing(void) const;
@@ -303,6 +339,27 @@ namespace fastuidraw
         ConfigurationGL&
         unpack_header_and_brush_in_frag_shader(bool v);
 
+        /*!
+          If true, the flat varyings (uint, int and flat float)
+          of each item shader are packed together into shared
+          flat uvec4 varyings, see glsl::PainterBackendGLSL::UberShaderParams::pack_varyings().
+          Reduces the varyings of the uber-shaders when item
+          shaders differ in what kinds of flat values they use,
+          which benefits GPUs where the number of varyings limits
+          occupancy or where varyings are written to memory
+          between the vertex and fragment stages (tilers). Use
+          PainterBackendGL::varying_slot_count() to see the
+          effect. Default value is false.
+         */
+        bool
+        pack_varyings(void) const;
+
+        /*!
+          Set the value for pack_varyings(void) const
+        */
+        ConfigurationGL&
+        pack_varyings(bool v);
+
         /*!
           If true, the vertex shader inputs should be qualified
           with a layout(location=) specifier. Default value is
@@ -399,6 +456,550 @@ namespace fastuidraw
         ConfigurationGL&
         non_dashed_stroke_shader_uses_discard(bool);
 
+        /*!
+          If false, the dashed stroke shader emits the coverage
+          of the dash pattern as alpha instead of discarding the
+          fragments in the gaps of the dash pattern, so that
+          with separate_program_for_discard() dashed stroking is
+          drawn by the program without discard; see
+          glsl::PainterBackendGLSL::ConfigurationGLSL::dashed_stroke_shader_uses_discard()
+          for the caveats.
+         */
+        bool
+        dashed_stroke_shader_uses_discard(void) const;
+
+        /*!
+          Set the value returned by dashed_stroke_shader_uses_discard(void) const.
+          Default value is true.
+         */
+        ConfigurationGL&
+        dashed_stroke_shader_uses_discard(bool);
+
+        /*!
+          If true, the buffers backing the attributes, headers,
+          indices and data store are created with immutable storage
+          (glBufferStorage) and are mapped once, persistently and
+          coherently, for the lifetime of the PainterBackendGL. Instead
+          of mapping and unmapping buffers on each map_draw(), a fence
+          (glFenceSync) is placed after the draws of each pool (see
+          number_pools()) and the CPU only waits on that fence when it
+          wraps around to write to the pool again. When uniforms are
+          sourced from a UBO (see use_ubo_for_uniforms()), each pool
+          has its own block of a single persistently mapped buffer
+          that is bound with glBindBufferRange. Requires GL version
+          4.4 or the extension GL_ARB_buffer_storage for GL and the
+          extension GL_EXT_buffer_storage for GLES; if not supported
+          the value is set to false. Default value is false.
+         */
+        bool
+        persistent_mapped_buffers(void) const;
+
+        /*!
+          Set the value for persistent_mapped_buffers(void) const
+        */
+        ConfigurationGL&
+        persistent_mapped_buffers(bool v);
+
+        /*!
+          If non-NULL, the ProgramBinaryCache passed to each of the
+          Program objects (see program()) built by the PainterBackendGL.
+          Using a ProgramBinaryCache allows for the GLSL programs to be
+          realized from program binaries obtained on previous runs
+          instead of compiling and linking the uber-shaders. Default
+          value is NULL.
+         */
+        const reference_counted_ptr<ProgramBinaryCache>&
+        program_binary_cache(void) const;
+
+        /*!
+          Set the value returned by program_binary_cache(void) const.
+         */
+        ConfigurationGL&
+        program_binary_cache(const reference_counted_ptr<ProgramBinaryCache> &v);
+
+        /*!
+          If true, when shaders are registered after the uber-shaders
+          have been built, the rebuilt uber-shaders are compiled and
+          linked asynchronously (see Program::start_build()) and the
+          previous uber-shaders continue to be used until the new
+          ones are ready. While the new uber-shaders are not ready,
+          the draws that use the newly registered shaders are
+          skipped. Requires the extension GL_KHR_parallel_shader_compile
+          or GL_ARB_parallel_shader_compile; if not supported the value
+          is set to false. Default value is false.
+         */
+        bool
+        async_program_rebuild(void) const;
+
+        /*!
+          Set the value for async_program_rebuild(void) const
+        */
+        ConfigurationGL&
+        async_program_rebuild(bool v);
+
+        /*!
+          The number of attributes of the buffer object backing
+          the static attribute data created by
+          PainterBackendGL::create_static_attribute_data(). A value
+          of 0 indicates to not support static attribute data. Static
+          attribute data requires GL version 4.2, the extension
+          GL_ARB_base_instance or for GLES the extension
+          GL_EXT_base_instance; if not supported the value is set
+          to 0. Default value is 0.
+         */
+        unsigned int
+        static_attributes_per_heap(void) const;
+
+        /*!
+          Set the value for static_attributes_per_heap(void) const
+        */
+        ConfigurationGL&
+        static_attributes_per_heap(unsigned int v);
+
+        /*!
+          The number of indices of the buffer object backing
+          the static attribute data created by
+          PainterBackendGL::create_static_attribute_data().
+          If zero, static attribute data is not supported. Default
+          value is 0.
+         */
+        unsigned int
+        static_indices_per_heap(void) const;
+
+        /*!
+          Set the value for static_indices_per_heap(void) const
+        */
+        ConfigurationGL&
+        static_indices_per_heap(unsigned int v);
+
+        /*!
+          If true, the draw ranges of each PainterDraw are written
+          to a buffer object bound to GL_DRAW_INDIRECT_BUFFER and
+          are drawn with glMultiDrawElementsIndirect, so that the
+          number of GL calls of a PainterDraw depends only on the
+          number of state changes. Requires GL version 4.3, the
+          extension GL_ARB_multi_draw_indirect or for GLES the
+          extension GL_EXT_multi_draw_indirect; if not supported
+          the value is set to false. Default value is false.
+         */
+        bool
+        use_indirect_draw(void) const;
+
+        /*!
+          Set the value for use_indirect_draw(void) const
+        */
+        ConfigurationGL&
+        use_indirect_draw(bool v);
+
+        /*!
+          If non-zero, the GPU time of each frame, i.e. from
+          on_pre_draw() to on_post_draw(), and of each sequence
+          of draws that use the same shaders is measured with
+          GL timer queries from a ring of query objects for
+          timer_query_frames() frames. The results of a frame
+          are read back only once GL reports them as available,
+          which is typically timer_query_frames() - 1 frames later,
+          so reading them never stalls; a frame for which the
+          query objects of its slot are still pending is not
+          timed. When on, draws that use different shaders are
+          placed in separate GL draw calls so that each can be
+          timed. Requires GL version 3.3 or the extension
+          GL_ARB_timer_query and is not supported for GLES;
+          if not supported the value is set to 0. Default
+          value is 0.
+         */
+        unsigned int
+        timer_query_frames(void) const;
+
+        /*!
+          Set the value for timer_query_frames(void) const
+        */
+        ConfigurationGL&
+        timer_query_frames(unsigned int v);
+
+        /*!
+          If true, the framebuffer to which the PainterBackendGL
+          draws is guaranteed to have a stencil buffer of at least
+          8 bits whose values are zero at on_pre_draw(); the
+          PainterBackendGL then supports filling paths with
+          PainterFillShader::stencil_coverage (see
+          PainterBackend::PerformanceHints::stencil_coverage())
+          and leaves the stencil buffer as zero at on_post_draw().
+          Default value is false.
+         */
+        bool
+        stencil_coverage(void) const;
+
+        /*!
+          Set the value for stencil_coverage(void) const
+        */
+        ConfigurationGL&
+        stencil_coverage(bool v);
+
+        /*!
+          If true, the framebuffer to which the PainterBackendGL
+          draws is guaranteed to have a stencil buffer of at least
+          8 bits whose values are zero at on_pre_draw(); the
+          PainterBackendGL then supports clipping by the stencil
+          buffer (see PainterBackend::PerformanceHints::stencil_clipping())
+          and leaves the stencil buffer as zero at on_post_draw()
+          provided that each Painter::begin() is matched by a
+          Painter::end(). Since both use the stencil buffer, if
+          true then PainterBackend::PerformanceHints::stencil_coverage()
+          is false regardless of stencil_coverage(void) const.
+          Default value is false.
+         */
+        bool
+        stencil_clipping(void) const;
+
+        /*!
+          Set the value for stencil_clipping(void) const
+        */
+        ConfigurationGL&
+        stencil_clipping(bool v);
+
+        /*!
+          If true, the uber-shaders clip the corners of
+          Painter::clipInRoundedRect() analytically per fragment
+          (see glsl::PainterBackendGLSL::ConfigurationGLSL::rounded_rect_clipping()),
+          instead of the Painter clipping by a Path with occluders.
+          Since the corners are clipped by discard, if true then
+          separate_program_for_discard(void) const is false.
+          Default value is false.
+         */
+        bool
+        rounded_rect_clipping(void) const;
+
+        /*!
+          Set the value for rounded_rect_clipping(void) const
+        */
+        ConfigurationGL&
+        rounded_rect_clipping(bool v);
+
+        /*!
+          If true, glyph instances (see
+          PainterPacker::draw_instanced_quads()) are drawn
+          with instanced draw calls in which each glyph is a
+          single attribute and the vertex shader computes the
+          corners of the quad of the glyph; the PainterBackendGL
+          then reports true for
+          PainterBackend::PerformanceHints::instanced_quads().
+          Requires GL version 4.2 or the extension
+          GL_ARB_base_instance, for GLES requires
+          GL_EXT_base_instance; if not supported the value is
+          set to false. Default value is true.
+         */
+        bool
+        glyph_instancing(void) const;
+
+        /*!
+          Set the value for glyph_instancing(void) const
+        */
+        ConfigurationGL&
+        glyph_instancing(bool v);
+
+        /*!
+          If true, brushes whose image is a bindless texture
+          (see Image::create_bindless() and create_bindless_image())
+          sample the texture directly from its handle, so that
+          textures owned by the application are drawn in the same
+          draw calls as the images of the ImageAtlasGL. Requires
+          the extension GL_ARB_bindless_texture; if not supported
+          (which is always the case for GLES), the value is set
+          to false and bindless images are drawn as transparent
+          black. Default value is false.
+         */
+        bool
+        bindless_images(void) const;
+
+        /*!
+          Set the value for bindless_images(void) const
+        */
+        ConfigurationGL&
+        bindless_images(bool v);
+
+        /*!
+          If true and if bindless_images() is true, brushes whose
+          image is a bindless external texture (see
+          Image::bindless_external_texture() and ExternalTextureGL)
+          sample the texture as a samplerExternalOES. Requires
+          the extension GL_OES_EGL_image_external_essl3 or
+          GL_OES_EGL_image_external; if neither is supported or
+          if bindless_images() is false, the value is set to false
+          and bindless external textures are drawn as transparent
+          black. Default value is false.
+         */
+        bool
+        external_texture_images(void) const;
+
+        /*!
+          Set the value for external_texture_images(void) const
+        */
+        ConfigurationGL&
+        external_texture_images(bool v);
+
+        /*!
+          The uber-shader of the programs of program() has every
+          registered item shader which costs registers and occupancy
+          even when drawing only with simple shaders such as those
+          of solid fills. If non-zero, the PainterBackendGL counts
+          the indices drawn by each item shader during its first
+          draws (on_pre_draw() calls) and then builds, for each of up
+          to specialized_programs() item shaders that drew the most
+          (and at least a tenth of all the indices), a program whose
+          uber-shader only has that item shader (including its sub-
+          shaders). The draws with those item shaders are then drawn
+          with their specialized program, changing programs where
+          the item shader changes between those shaders and any
+          other shader. A non-zero value makes each change of item
+          shader break the draw (as break_on_shader_change() does).
+          If async_program_rebuild() is true, the specialized
+          programs are used once they are built without blocking.
+          Default value is 0.
+         */
+        unsigned int
+        specialized_programs(void) const;
+
+        /*!
+          Set the value for specialized_programs(void) const
+        */
+        ConfigurationGL&
+        specialized_programs(unsigned int v);
+
+        /*!
+          The uber-shader tests the brush shader bits (see
+          PainterBrush::shader()) of each fragment to decide if
+          to apply a gradient, an image or a repeat window, even
+          for a solid fill. If true, the PainterBackendGL builds
+          for each program of program() a program in which the
+          brush shader bits are the compile-time constant zero,
+          so that the brush code paths are removed by the GLSL
+          compiler, and uses it for the draws whose brush has no
+          shader bits, i.e. whose PainterShaderGroup::brush() is
+          zero. A true value makes each change of the brush shader
+          bits break the draw (i.e. PainterBackend::ConfigurationBase::brush_shader_mask()
+          is all bits up) and doubles the number of programs to
+          build. The programs of item shaders of specialized_programs()
+          are not given solid brush programs. Default value is false.
+         */
+        bool
+        solid_brush_programs(void) const;
+
+        /*!
+          Set the value for solid_brush_programs(void) const
+        */
+        ConfigurationGL&
+        solid_brush_programs(bool v);
+
+        /*!
+          If true, the default blend shaders support the W3C
+          blend modes (PainterEnums::blend_w3c_mulitply through
+          PainterEnums::blend_w3c_luminosity) when the GL implementation
+          allows to do so without copying the framebuffer, i.e. the blend
+          shader type (see glsl::PainterBackendGLSL::ConfigurationGLSL::default_blend_shader_type())
+          is PainterBlendShader::framebuffer_fetch if GL_EXT_shader_framebuffer_fetch
+          is supported and otherwise it is PainterBlendShader::single_src with
+          the advanced blend equations if GL_KHR_blend_equation_advanced_coherent
+          is supported. The coherent variants are required so that no
+          blend barriers are needed between overlapping draws. If false,
+          or if neither is supported, the blend shaders use dual source
+          blending when available and do not support the W3C blend
+          modes. Default value is true.
+         */
+        bool
+        w3c_blend_modes(void) const;
+
+        /*!
+          Set the value for w3c_blend_modes(void) const
+        */
+        ConfigurationGL&
+        w3c_blend_modes(bool v);
+
+        /*!
+          Within a pass, i.e. from PainterBackend::on_pre_draw()
+          to PainterBackend::on_post_draw(), the PainterBackendGL
+          shadows the GL state it sets so that it does not bind
+          again the program, vertex array object, textures,
+          samplers or blend state that are already bound. By
+          default, PainterBackend::on_post_draw() unbinds that
+          state and the shadow is discarded at the start of each
+          pass. If true, the application declares that no GL
+          code other than that of FastUIDraw runs between passes
+          (or that such code restores the GL state it changes),
+          so that on_post_draw() leaves the program, textures,
+          samplers and blend state bound for the next pass, which
+          then only binds the textures, samplers and blend state
+          that changed. The vertex array object is still unbound
+          at the end of each pass and the program is still bound
+          at the start of each pass. Default value is false.
+         */
+        bool
+        retain_gl_state_between_passes(void) const;
+
+        /*!
+          Set the value for retain_gl_state_between_passes(void) const
+        */
+        ConfigurationGL&
+        retain_gl_state_between_passes(bool v);
+
+        /*!
+          If true, the streamed indices are uploaded to GL as
+          16-bit indices, halving the size of the index buffers
+          sent each frame. PainterPacker continues to write
+          PainterIndex values; on unmap, each range of indices
+          drawn with one GL call is split into runs whose vertices
+          lie within 65536 of each other and the indices of each
+          run are written relative to the smallest vertex of the
+          run, which is given to GL as the base vertex of the
+          draw. The indices of static attribute data (see
+          PainterBackendGL::create_static_attribute_data())
+          remain 32-bit. Requires GL version 3.2 or the extension
+          GL_ARB_draw_elements_base_vertex, for GLES requires
+          version 3.2 or the extension GL_OES_draw_elements_base_vertex
+          or GL_EXT_draw_elements_base_vertex; if not supported the
+          value is set to false. Default value is false.
+         */
+        bool
+        short_indices(void) const;
+
+        /*!
+          Set the value for short_indices(void) const
+        */
+        ConfigurationGL&
+        short_indices(bool v);
+
+        /*!
+          If true, within each PainterDraw the draws whose blend
+          mode replaces the color they cover (i.e. drawn with
+          PainterEnums::blend_porter_duff_src) are drawn first and
+          front to back, followed by the other draws in their
+          original order. Because each item is drawn with a larger
+          z-value than the items before it and the depth test keeps
+          the larger z-value, the result is unchanged while the
+          fragments hidden by the later opaque draws are rejected
+          by the depth test before they are shaded. Draws that
+          write to the stencil buffer and the occluders of clipping
+          are never moved across. The blend mode of a draw only
+          tells if it replaces the color it covers with the blend
+          shaders of type PainterBlendShader::single_src, for the
+          other blend shader types the value is set to false.
+          Default value is false.
+         */
+        bool
+        opaque_front_to_back(void) const;
+
+        /*!
+          Set the value for opaque_front_to_back(void) const
+        */
+        ConfigurationGL&
+        opaque_front_to_back(bool v);
+
+        /*!
+          Specifies the precision policy of the uber-shader,
+          see glsl::PainterBackendGLSL::UberShaderParams::precision_policy().
+          The value only changes the generated code on GLES.
+          Default value is glsl::PainterBackendGLSL::precision_highp.
+         */
+        enum glsl::PainterBackendGLSL::precision_policy_t
+        precision_policy(void) const;
+
+        /*!
+          Set the value for precision_policy(void) const
+        */
+        ConfigurationGL&
+        precision_policy(enum glsl::PainterBackendGLSL::precision_policy_t v);
+
+        /*!
+          If true, frames are drawn so that a tiled GPU does not
+          load or store the depth and stencil buffers from memory:
+          PainterBackend::on_begin() clears the depth and stencil
+          buffers of the bound framebuffer (so the application does
+          not need to); PainterBackend::on_end() and end_render_target()
+          invalidate them with glInvalidateFramebuffer(), since their
+          contents are no longer needed. The color buffer is neither
+          cleared nor invalidated. For the clear to let the GPU skip
+          loading the buffers, the scissor test must be disabled at
+          PainterPacker::begin(). The invalidation requires GLES 3.0,
+          GL version 4.3 or the extension GL_ARB_invalidate_subdata
+          and is skipped otherwise. Default value is false.
+         */
+        bool
+        tile_based_rendering(void) const;
+
+        /*!
+          Set the value for tile_based_rendering(void) const
+        */
+        ConfigurationGL&
+        tile_based_rendering(bool v);
+
+        /*!
+          If true, the GL work of PainterBackendGL is annotated for
+          GPU profilers and debuggers (for example RenderDoc or Nsight)
+          with the functionality of GL_KHR_debug: each PainterDraw is
+          drawn within a debug group (see glPushDebugGroup()) and so is
+          each of its draws, labelled with the item shader group, blend
+          shader group, brush and blend mode of the draw, and so is the
+          flush of the atlases before the first draw of a pass. The
+          textures of the atlases, the GLSL programs and the buffer
+          objects and VAO's of the pools of PainterBackendGL are given
+          names with glObjectLabel(). Requires GL version 4.3, GLES
+          version 3.2 or the extension GL_KHR_debug, otherwise the
+          value is set to false at the ctor of PainterBackendGL.
+          Default value is false.
+         */
+        bool
+        debug_markers(void) const;
+
+        /*!
+          Set the value for debug_markers(void) const
+        */
+        ConfigurationGL&
+        debug_markers(bool v);
+
+        /*!
+          If true, the size of the buffers of the pools (see
+          number_pools()) to which the draws are streamed adapts
+          to the draws: the largest number of attributes, indices
+          and data store blocks written in a pass over the recent
+          passes is tracked and, when a pool is rotated, the size
+          of the buffers is grown, with a quarter more room, to
+          hold that many or shrunk once it is more than twice
+          that many. A buffer of a pool is created again with the
+          new size the next time the pool is used, after its fence.
+          The sizes never go below attributes_per_buffer(),
+          indices_per_buffer() and data_blocks_per_store_buffer(),
+          nor above those values times adaptive_buffer_max_scale();
+          the size of the data store does not adapt if it is backed
+          by a UBO (see data_store_backing()) because it is then an
+          array size of the GLSL programs. The decisions are
+          reported by PainterBackend::num_buffer_grows and
+          PainterBackend::num_buffer_shrinks. Default value is false.
+         */
+        bool
+        adaptive_buffer_sizes(void) const;
+
+        /*!
+          Set the value for adaptive_buffer_sizes(void) const
+        */
+        ConfigurationGL&
+        adaptive_buffer_sizes(bool v);
+
+        /*!
+          If adaptive_buffer_sizes() is true, the largest multiple
+          of attributes_per_buffer(), indices_per_buffer() and
+          data_blocks_per_store_buffer() to which the buffers of
+          the pools may grow. Values less than 1 are taken as 1.
+          Default value is 8.
+         */
+        unsigned int
+        adaptive_buffer_max_scale(void) const;
+
+        /*!
+          Set the value for adaptive_buffer_max_scale(void) const
+        */
+        ConfigurationGL&
+        adaptive_buffer_max_scale(unsigned int v);
+
       private:
         void *m_d;
       };
@@ -421,6 +1022,24 @@ namespace fastuidraw
 
       ~PainterBackendGL();
 
+      /*!
+        Runs a small synthetic workload that reads a data store
+        from the vertex and fragment shaders with each of the
+        data store backings supported by the current GL context
+        and sets ConfigurationGL::data_store_backing() of config_gl
+        to the fastest. The choice is stored in and, if present,
+        fetched from the ConfigurationGL::program_binary_cache()
+        of config_gl (under a key computed from the GL vendor,
+        renderer and version strings) so that the workload is only
+        run once per GL implementation. A GL context must be current;
+        the GL state of the program, vertex array, buffer and texture
+        bindings is reset to default values. Returns the chosen backing.
+        \param config_gl ConfigurationGL to modify
+       */
+      static
+      enum data_store_backing_t
+      calibrate_data_store_backing(ConfigurationGL &config_gl);
+
       virtual
       unsigned int
       attribs_per_mapping(void) const;
@@ -441,6 +1060,179 @@ namespace fastuidraw
       reference_counted_ptr<const PainterDraw>
       map_draw(void);
 
+      /*!
+        Returns the number of GL draw calls issued and the
+        number of bytes uploaded to the GL objects of the
+        atlases since the last call to reset_stats(). The
+        bytes uploaded are counted for all atlases of the
+        GL backend, not only those of this PainterBackendGL.
+        The value for \ref gpu_time_micro_seconds is the
+        GPU time of the frame of timer_query_results(); it
+        is not affected by reset_stats().
+       */
+      virtual
+      unsigned int
+      query_stat(enum stats_t st) const;
+
+      virtual
+      void
+      reset_stats(void);
+
+      /*!
+        Overrides PainterBackend::no_depth_buffer(). If
+        true, on_pre_draw() disables GL_DEPTH_TEST (which
+        also disables depth writes) and on_begin() clears
+        only the stencil buffer.
+       */
+      virtual
+      void
+      no_depth_buffer(bool v);
+
+      /*!
+        Overrides PainterBackend::on_begin(). If
+        ConfigurationGL::tile_based_rendering() is true,
+        clears the depth and stencil buffers of the bound
+        framebuffer.
+       */
+      virtual
+      void
+      on_begin(void);
+
+      /*!
+        Overrides PainterBackend::on_end(). If
+        ConfigurationGL::tile_based_rendering() is true,
+        invalidates the depth and stencil buffers of the
+        bound framebuffer.
+       */
+      virtual
+      void
+      on_end(void);
+
+      /*!
+        Copies the attribute and index data to a buffer object
+        sub-allocated from a heap of size given by
+        ConfigurationGL::static_attributes_per_heap() and
+        ConfigurationGL::static_indices_per_heap(). Returns NULL
+        if static attribute data is not supported or if there is
+        not enough room left in the heap. The data of each layout
+        is drawn through its own VAO whose stride is the size of
+        the layout, all layouts share the same buffer object, and
+        a PainterAttribute::layout_attrib0 attribute takes a third
+        of the room of a PainterAttribute::layout_full attribute.
+       */
+      virtual
+      reference_counted_ptr<const PainterStaticAttributeData>
+      create_static_attribute_data(const PainterAttributeData &data,
+                                   const_c_array<unsigned int> attrib_chunk_selector,
+                                   enum PainterAttribute::layout_t layout);
+
+      /*!
+        Select the surface for which the PainterBackendGL draws,
+        for example one surface for each window of an application
+        that draws its windows with one PainterBackendGL. Each
+        surface has its own buffers to which the draws are
+        streamed (their count and sizes are those of the
+        ConfigurationGL, see ConfigurationGL::attributes_per_buffer()
+        and ConfigurationGL::number_pools()) and its own uniforms; the atlases, the
+        GLSL programs and the static attribute data (see
+        create_static_attribute_data()) are shared by all surfaces.
+        Switching between surfaces thus neither reallocates buffers
+        nor rebuilds programs, and the draws of one surface do not
+        wait on the fences of the buffers used by the others. The
+        buffers of a surface are created the first time it is
+        selected, with the GL context of the surface current;
+        if the surfaces are drawn with different GL contexts,
+        the contexts must share their GL objects and each surface
+        must be drawn with the same context, as vertex array
+        objects are not shared. Each surface keeps its own shadow
+        of the GL state (see ConfigurationGL::retain_gl_state_between_passes())
+        as well, but the timer queries (see ConfigurationGL::timer_query_frames())
+        are shared and require that all surfaces are drawn with
+        the same GL context. The resolution is not per surface, a Painter sets
+        its resolution to the backend at each Painter::begin().
+        Must not be called between PainterPacker::begin() and
+        PainterPacker::end(). Initially the surface is 0.
+        \param surface index of the surface to select
+       */
+      void
+      current_surface(unsigned int surface);
+
+      /*!
+        Returns the value set by current_surface(unsigned int).
+       */
+      unsigned int
+      current_surface(void) const;
+
+      /*!
+        Release the buffers of a surface, for example when the
+        window of the surface is closed; the surface gets new
+        buffers the next time it is selected by current_surface().
+        The GL context of the surface must be current. Must not
+        be called with the current surface.
+        \param surface index of surface to release
+       */
+      void
+      release_surface(unsigned int surface);
+
+      /*!
+        Overrides PainterBackend::create_render_target(). The
+        render target is a framebuffer object with a GL_RGBA8
+        texture as color buffer and a GL_DEPTH24_STENCIL8
+        renderbuffer. The texture is drawn as an image only
+        as a bindless image (see create_bindless_image()),
+        hence returns NULL if ConfigurationGL::bindless_images()
+        is false. A GL context must be current when the returned
+        object is destroyed.
+       */
+      virtual
+      reference_counted_ptr<RenderTarget>
+      create_render_target(ivec2 dims);
+
+      /*!
+        Overrides PainterBackend::begin_render_target(). Binds
+        the framebuffer object of the render target to
+        GL_DRAW_FRAMEBUFFER and sets the viewport to it (with
+        the scissor test disabled); the previous binding, viewport
+        and scissor test are restored by end_render_target().
+       */
+      virtual
+      void
+      begin_render_target(const reference_counted_ptr<RenderTarget> &target);
+
+      /*!
+        Overrides PainterBackend::end_render_target().
+       */
+      virtual
+      void
+      end_render_target(void);
+
+      /*!
+        Overrides PainterBackend::blur_render_target(). The
+        blur is a dual-Kawase pyramid: the region is halved
+        about log2(radius) times and then doubled back, each
+        pass a single quad whose taps fall between texels so
+        that each tap averages four texels; a large radius
+        thus costs a few passes at low resolution. The levels
+        of the pyramid are textures kept by the PainterBackendGL
+        and reused by later blurs. Returns routine_fail if the
+        shaders of the blur fail to build.
+       */
+      virtual
+      enum return_code
+      blur_render_target(const reference_counted_ptr<RenderTarget> &src,
+                         const reference_counted_ptr<RenderTarget> &dst,
+                         ivec2 size, float radius, bool alpha_only);
+
+      /*!
+        Returns the GPU times, grouped by the shaders used,
+        of the most recent frame whose timer queries have
+        completed, see ConfigurationGL::timer_query_frames().
+        The values are replaced within on_pre_draw() when
+        the results of a later frame become available.
+       */
+      const_c_array<TimerQueryResult>
+      timer_query_results(void) const;
+
       /*!
         Return the specified Program use to draw
         with this PainterBackendGL.
@@ -448,6 +1240,17 @@ namespace fastuidraw
       reference_counted_ptr<Program>
       program(enum program_type_t tp);
 
+      /*!
+        Returns the number of vec4 varying slots used by the
+        Program returned by program(enum program_type_t). The
+        item shader varyings of each program are sized by the
+        item shaders of that program only, so the programs
+        without and with discard can use fewer varyings than
+        the program of all item shaders.
+       */
+      unsigned int
+      varying_slot_count(enum program_type_t tp);
+
       /*!
         Returns the ConfigurationGL adapted from that passed
         by ctor (for the properties of the GL context) of
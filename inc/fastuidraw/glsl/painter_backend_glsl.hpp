@@ -55,7 +55,16 @@ namespace fastuidraw
             PainterBackend::ConfigurationBase::alignment()
             must then be 4.
            */
-          data_store_ubo
+          data_store_ubo,
+
+          /*!
+            Data store is backed by a shader storage buffer
+            object that is an array of uvec4; requires GLSL
+            version 430 or 310 es. The value for
+            PainterBackend::ConfigurationBase::alignment()
+            must then be 4.
+           */
+          data_store_ssbo
         };
 
       /*!
@@ -94,6 +103,32 @@ namespace fastuidraw
           colorstop_texture_2d_array
         };
 
+      /*!
+        Enumeration to specify the precision the uber-shader
+        uses for color and coverage computations in the fragment
+        shader. The precision qualifiers only have an effect on
+        GLES; GL accepts them and computes in full precision.
+       */
+      enum precision_policy_t
+        {
+          /*!
+            All computations are highp.
+           */
+          precision_highp,
+
+          /*!
+            Color math, coverage values and brush colors of
+            the fragment shader are mediump; positions, brush
+            coordinates and atlas coordinates remain highp.
+            On many GLES GPUs, mediump arithmetic has twice
+            the throughput of highp and uses fewer registers.
+            The colors and coverage values are within [0, 1]
+            and so the loss of precision is typically below
+            what an 8-bit framebuffer can represent.
+           */
+          precision_mediump_color,
+        };
+
       /*!
         Enumeration to specify the convention for a 3D API
         for its normalized device coordinate in z.
@@ -186,6 +221,26 @@ namespace fastuidraw
         ConfigurationGLSL&
         use_hw_clip_planes(bool);
 
+        /*!
+          If true, the uber-shaders test the rounded rect of
+          PainterClipEquations per fragment, making
+          Painter::clipInRoundedRect() analytic (see
+          PainterBackend::PerformanceHints::rounded_rect_clipping()).
+          The cost is six more varyings and, for each vertex,
+          reading the rounded rect data of the clipping; each
+          fragment does the test only when a rounded rect
+          clipping is active.
+         */
+        bool
+        rounded_rect_clipping(void) const;
+
+        /*!
+          Set the value returned by rounded_rect_clipping(void) const.
+          Default value is false.
+         */
+        ConfigurationGLSL&
+        rounded_rect_clipping(bool);
+
         /*!
           Set the blend shader type used by the blend
           shaders of the default shaders, as returned by
@@ -202,6 +257,27 @@ namespace fastuidraw
         ConfigurationGLSL&
         default_blend_shader_type(enum PainterBlendShader::shader_type);
 
+        /*!
+          If true and default_blend_shader_type() is
+          PainterBlendShader::single_src, the default blend shaders
+          implement the W3C blend modes with the advanced blend
+          equations of BlendMode (BlendMode::MULTIPLY through
+          BlendMode::HSL_LUMINOSITY), i.e. via GL_KHR_blend_equation_advanced.
+          If default_blend_shader_type() is PainterBlendShader::framebuffer_fetch,
+          the W3C blend modes are implemented in GLSL regardless of this
+          value. For the other cases, the default blend shaders do
+          not support the W3C blend modes.
+         */
+        bool
+        blend_equation_advanced(void) const;
+
+        /*!
+          Set the value returned by blend_equation_advanced(void) const.
+          Default value is false.
+         */
+        ConfigurationGLSL&
+        blend_equation_advanced(bool);
+
         /*!
           Sets the non-dashed stroke shader to use discard
           instead of on opaque pass stroking a small amount
@@ -221,6 +297,32 @@ namespace fastuidraw
         ConfigurationGLSL&
         non_dashed_stroke_shader_uses_discard(bool);
 
+        /*!
+          Sets the dashed stroke shader to use discard for the
+          fragments in the gaps of the dash pattern. If false,
+          the dashed stroke shader emits the coverage of the dash
+          pattern as alpha instead, so that a backend that puts
+          the shaders with discard in a separate program (see
+          gl::PainterBackendGL::ConfigurationGL::separate_program_for_discard())
+          draws it with the program without discard and keeps
+          early depth testing. The caveat is that
+          fragments in the gaps still write depth, so where a
+          path crosses itself, a dash underneath a gap of the
+          other portion of the path may not be drawn. Only set
+          to false if the blend modes used for dashed stroking
+          leave the destination unchanged for a fragment with
+          alpha zero, for example PainterEnums::blend_porter_duff_src_over.
+         */
+        bool
+        dashed_stroke_shader_uses_discard(void) const;
+
+        /*!
+          Set the value returned by dashed_stroke_shader_uses_discard(void) const.
+          Default value is true.
+         */
+        ConfigurationGLSL&
+        dashed_stroke_shader_uses_discard(bool);
+
       private:
         void *m_d;
       };
@@ -406,6 +508,24 @@ namespace fastuidraw
         BindingPoints&
         data_store_buffer_ubo(unsigned int);
 
+        /*!
+          Specifies the buffer binding point of the data store
+          buffer (PainterDraw::m_store) as an SSBO. Only active
+          if UberShaderParams::data_store_backing() is
+          \ref data_store_ssbo. The binding point is always set
+          with a layout qualifier in the GLSL code, regardless
+          of UberShaderParams::assign_binding_points().
+         */
+        unsigned int
+        data_store_buffer_ssbo(void) const;
+
+        /*!
+          Set the value returned by data_store_buffer_ssbo(void) const.
+          Default value is 0.
+         */
+        BindingPoints&
+        data_store_buffer_ssbo(unsigned int);
+
       private:
         void *m_d;
       };
@@ -589,6 +709,28 @@ namespace fastuidraw
         UberShaderParams&
         unpack_header_and_brush_in_frag_shader(bool);
 
+        /*!
+          If true, the uint, int and flat float varyings of each
+          PainterItemShaderGLSL are packed together into shared
+          flat uvec4 varyings, with the int and float values
+          bit-cast to uint. The uber-shader then needs as many
+          flat varyings as the item shader with the most flat
+          values instead of the sum over the kinds of flat values
+          of the most any item shader has of that kind. The cost
+          is the bit-casting in both shaders and the copy of the
+          flat values into the packed varyings at the end of each
+          item vertex shader.
+         */
+        bool
+        pack_varyings(void) const;
+
+        /*!
+          Set the value returned by pack_varyings(void) const.
+          Default value is false.
+         */
+        UberShaderParams&
+        pack_varyings(bool);
+
         /*!
           Specify how to access the data in PainterDraw::m_store
           from the GLSL shader.
@@ -605,7 +747,7 @@ namespace fastuidraw
 
         /*!
           Only needed if data_store_backing(void) const
-          has value data_store_ubo. Gives the size in
+          has value data_store_ubo or data_store_ssbo. Gives the size in
           blocks of PainterDraw::m_store which
           is PainterDraw::m_store.size() divided
           by PainterBackend::configuration_base().alignment().
@@ -702,6 +844,51 @@ namespace fastuidraw
         UberShaderParams&
         use_ubo_for_uniforms(bool);
 
+        /*!
+          If true, the uber-shader samples the images of brushes
+          that are bindless textures (see Image::create_bindless())
+          through sampler2D values made from the handles packed by
+          the PainterBrush, defining the macro
+          FASTUIDRAW_PAINTER_IMAGE_BINDLESS. The fragment shader
+          then requires the GLSL extension GL_ARB_bindless_texture,
+          which the caller is to enable in the source passed to
+          construct_shader(). If false, bindless images are drawn
+          as transparent black.
+         */
+        bool
+        bindless_images(void) const;
+
+        /*!
+          Set the value returned by bindless_images(void) const.
+          Default value is false.
+         */
+        UberShaderParams&
+        bindless_images(bool);
+
+        /*!
+          If true and if bindless_images() is true, the uber-shader
+          samples the images of brushes that are bindless external
+          textures (see Image::bindless_external_texture()) through
+          samplerExternalOES values made from the handles packed by
+          the PainterBrush, defining the macro
+          FASTUIDRAW_PAINTER_IMAGE_EXTERNAL_TEXTURE. The fragment
+          shader then additionally requires a GLSL extension
+          providing samplerExternalOES (for example
+          GL_OES_EGL_image_external_essl3), which the caller is
+          to enable in the source passed to construct_shader().
+          If false, bindless external textures are drawn as
+          transparent black.
+         */
+        bool
+        external_texture_images(void) const;
+
+        /*!
+          Set the value returned by external_texture_images(void) const.
+          Default value is false.
+         */
+        UberShaderParams&
+        external_texture_images(bool);
+
         /*!
           Build the uber-shader with those blend shaders registered to
           the PainterBackendGLSL of this type only.
@@ -716,6 +903,23 @@ namespace fastuidraw
         UberShaderParams&
         blend_type(enum PainterBlendShader::shader_type);
 
+        /*!
+          Specifies the precision policy of the uber-shader. The
+          uber-shader defines the macro fastuidraw_color_precision
+          as mediump or highp from the value, which item, brush
+          and blend shaders may use to qualify their color and
+          coverage values.
+         */
+        enum precision_policy_t
+        precision_policy(void) const;
+
+        /*!
+          Set the value returned by precision_policy(void) const.
+          Default value is \ref precision_highp.
+         */
+        UberShaderParams&
+        precision_policy(enum precision_policy_t);
+
       private:
         void *m_d;
       };
@@ -770,6 +974,20 @@ namespace fastuidraw
       void
       add_vertex_shader_util(const ShaderSource &src);
 
+      /*!
+        Add GLSL code that is to be visible to those vertex
+        shaders that use it. The code is only added to an
+        uber-shader whose code, or the code of another utility
+        added to it, contains the string symbol, typically
+        the name of the function the code defines; this keeps
+        the code that is never called out of the programs.
+        \param src shader source to add
+        \param symbol string whose presence in the code of an
+                      uber-shader makes the code added to it
+       */
+      void
+      add_vertex_shader_util(const ShaderSource &src, const char *symbol);
+
       /*!
         Add GLSL code that is to be visible to all vertex
         shaders. The code can define functions or macros.
@@ -778,6 +996,16 @@ namespace fastuidraw
       void
       add_fragment_shader_util(const ShaderSource &src);
 
+      /*!
+        Add GLSL code that is to be visible to those fragment
+        shaders that use it, see add_vertex_shader_util(const ShaderSource&, const char*).
+        \param src shader source to add
+        \param symbol string whose presence in the code of an
+                      uber-shader makes the code added to it
+       */
+      void
+      add_fragment_shader_util(const ShaderSource &src, const char *symbol);
+
       /*!
         Add the uber-vertex and fragment shaders to given
         ShaderSource values.
@@ -800,6 +1028,23 @@ namespace fastuidraw
                        const ItemShaderFilter *item_shader_filter = NULL,
                        const char *discard_macro_value = "discard");
 
+      /*!
+        Returns the number of vec4 varying slots (i.e. locations)
+        the uber-shader constructed by construct_shader() with the
+        same arguments uses. The varyings of the item shaders are
+        sized by those item shaders that pass item_shader_filter
+        only, so a program of a subset of the item shaders can
+        have fewer varyings than one of all of them.
+        \param contruct_params specifies how to construct the uber-shaders.
+        \param item_shader_filter pointer to ItemShaderFilter to use to filter
+                                  which shader to place into the uber-shader.
+                                  A value of NULL indicates to add all item
+                                  shaders to the uber-shader.
+       */
+      unsigned int
+      varying_slot_count(const UberShaderParams &contruct_params,
+                         const ItemShaderFilter *item_shader_filter = NULL);
+
       /*!
         Fill a buffer to hold the values for the uniforms
         of the uber-shader. It must be that p.size() is atleast
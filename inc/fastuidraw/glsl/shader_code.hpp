@@ -69,6 +69,44 @@ namespace fastuidraw
                                         const char *function_name,
                                         const char *geometry_store_fetch,
                                         bool derivative_function = false);
+
+      /*!
+        Construct/returns a ShaderSource value that
+        implements the function:
+        \code
+        float
+        function_name(in vec2 texture_coordinate,
+                      in uint layer,
+                      in uint geometry_offset)
+        \endcode
+
+        which returns the coverage of a pixel by a glyph of type
+        \ref banded_curves_glyph (these glyphs are backed by data
+        produced from a \ref GlyphRenderDataBandedCurves). The value
+        texture_coordinate is the position in the texel store (the
+        bottom left for the glyph being at Glyph::atlas_location().location()
+        and the top right being at that value plus
+        GlyphRenderDataBandedCurves::number_bands()), the value layer
+        is Glyph::atlas_location().layer() and the value geometry_offset
+        is from Glyph::geometry_offset(). Only the curves of the
+        horizontal and vertical band of texture_coordinate are read.
+        The function uses the derivatives of texture_coordinate, so it
+        must be called from uniform control flow.
+
+        \param alignment alignment of the backing geometry store,
+                         GlyphAtlasGeometryBackingStoreBase::alignment().
+        \param function_name name for the function
+        \param texel_store name of the usampler2DArray of the texel
+                           backing store of the glyph atlas
+        \param geometry_store_fetch the macro function (that returns a vec4)
+                                    to use in the produced GLSL code to fetch
+                                    the geometry store data.
+       */
+      ShaderSource
+      banded_curves_compute_coverage(unsigned int alignment,
+                                     const char *function_name,
+                                     const char *texel_store,
+                                     const char *geometry_store_fetch);
       /*!
         Gives the shader source code for a function with
         the signature:
@@ -113,7 +151,10 @@ namespace fastuidraw
         that compute the interval a distance value lies upon from
         a repeated interval pattern. The parameter meanins are:
         - intervals_location gives the location into the data store buffer where the
-          interval data is packed as (TODO: document format).
+          interval data is packed as a search tree, see PainterDashedStrokeParams.
+          The search makes one fetch for each level of the tree followed by one
+          fetch for a leaf, i.e. roughly the logarithm base (data_alignment + 1)
+          of the number of blocks of the intervals.
         - total_distance the period of the repeat interval pattern
         - first_interval_start
         - in_distance distance value to evaluate
@@ -132,6 +132,15 @@ public:
    */
   ShaderSource(const ShaderSource &obj);
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+  /*!
+    Move ctor, takes the source of obj without copying
+    it; obj is then as if default constructed.
+    \param obj value from which to take the source
+   */
+  ShaderSource(ShaderSource &&obj) noexcept;
+#endif
+
   ~ShaderSource();
 
   /*!
@@ -141,6 +150,24 @@ public:
   ShaderSource&
   operator=(const ShaderSource &obj);
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+  /*!
+    Move assignment operator, swaps the source of
+    this ShaderSource with that of obj.
+    \param obj value from which to take the source
+   */
+  ShaderSource&
+  operator=(ShaderSource &&obj) noexcept;
+#endif
+
+  /*!
+    Swap the source of this ShaderSource with
+    that of another ShaderSource.
+    \param obj ShaderSource with which to swap
+   */
+  void
+  swap(ShaderSource &obj);
+
   /*!
     Specifies the version of GLSL to which to
     declare the shader. An empty string indicates
@@ -105,7 +105,9 @@ class Image;
     resizeable(void) const;
 
     /*!
-      Resize the object by increasing the number of layers.
+      Resize the object by changing the number of layers.
+      Decreasing the number of layers discards the texels of
+      the removed layers (see ImageAtlas::trim()).
       The routine resizeable() must return true, if not
       the function asserts.
      */
@@ -116,7 +118,8 @@ class Image;
     /*!
       To be implemented by a derived class to resize the
       object. The resize changes ONLY the number of layers
-      of the object and only increases the value as well.
+      of the object; when the number of layers decreases
+      the texels of the remaining layers must be kept.
       When called, the return value of dimensions() is
       the size before the resize completes.
       \param new_num_layers new number of layers to which
@@ -230,7 +233,9 @@ class Image;
     resizeable(void) const;
 
     /*!
-      Resize the object by increasing the number of layers.
+      Resize the object by changing the number of layers.
+      Decreasing the number of layers discards the texels of
+      the removed layers (see ImageAtlas::trim()).
       The routine resizeable() must return true, if not
       the function asserts.
      */
@@ -241,7 +246,8 @@ class Image;
     /*!
       To be implemented by a derived class to resize the
       object. The resize changes ONLY the number of layers
-      of the object and only increases the value as well.
+      of the object; when the number of layers decreases
+      the texels of the remaining layers must be kept.
       When called, the return value of dimensions() is
       the size before the resize completes.
       \param new_num_layers new number of layers to which
@@ -260,7 +266,13 @@ class Image;
     An ImageAtlas is a common location to place images of an application.
     Ideally, all images are placed into a single ImageAtlas (changes of
     ImageAtlas force draw-call breaks). Methods of ImageAtlas are
-    thread safe, locked behind a mutex of the ImageAtlas.
+    thread safe, locked behind a mutex of the ImageAtlas. If the
+    set_data() methods of the backing stores of an ImageAtlas do not
+    issue GL commands (for example an ImageAtlasGL constructed with
+    ImageAtlasGL::params::delayed() true), then Image objects can be
+    created on any thread, doing their tile slicing and index building
+    off of the GL thread, with only flush() called on the GL thread;
+    an Image is then drawable once Image::uploaded() is true.
    */
   class ImageAtlas:
     public reference_counted<ImageAtlas>::default_base
@@ -305,6 +317,13 @@ class Image;
     void
     flush(void) const;
 
+    /*!
+      Returns the number of times flush() has been
+      called on the ImageAtlas, see Image::uploaded().
+     */
+    uint64_t
+    number_flushes(void) const;
+
     /*!
       Returns a handle to the backing store for the image data.
      */
@@ -324,6 +343,28 @@ class Image;
     bool
     resizeable(void) const;
 
+    /*!
+      If true, an Image whose color tiles need more than one
+      index tile places its index tiles of the first level as
+      a single rectangle of adjacent index tiles (see
+      add_index_tile_block()) so that Image::number_index_lookups()
+      is one regardless of the size of the Image, i.e. the
+      index data acts as a direct page table. This saves the
+      dependent texture fetches of the additional index levels
+      at the cost of needing a free rectangle of index tiles;
+      if there is none, the Image falls back to multiple levels
+      of index tiles. Initial value is false.
+     */
+    bool
+    direct_index_lookup(void) const;
+
+    /*!
+      Set the value returned by direct_index_lookup(void) const.
+      The value only affects the Image objects created afterwards.
+     */
+    void
+    direct_index_lookup(bool v);
+
     /*!
       Increments an internal counter. If this internal
       counter is greater than zero, then the reurning
@@ -380,6 +421,36 @@ class Image;
     ivec3
     add_index_tile_index_data(const_c_array<ivec3> data);
 
+    /*!
+      Set the data of an index tile previously added with
+      add_index_tile(), i.e. an index tile that indexes into
+      color data.
+      \param tile tile as returned by add_index_tile()
+      \param data array of tiles as returned by add_color_tile()
+      \param slack amount of pixels duplicated on each boundary,
+                   see add_index_tile().
+     */
+    void
+    set_index_tile(ivec3 tile, const_c_array<ivec3> data, int slack);
+
+    /*!
+      Allocates a rectangle of count.x() by count.y() index
+      tiles that are adjacent in a single layer of the index
+      backing store. The data of each tile is set with
+      set_index_tile() and each tile is freed with
+      delete_index_tile(). If the atlas is resizeable()
+      and has no such rectangle free, the index backing
+      store is grown by a layer. Returns false if the
+      rectangle could not be allocated.
+      \param count number of index tiles across and down
+      \param[out] first_tile location of the tile at the
+                             minimum corner of the rectangle,
+                             the tile (x, y) of the rectangle
+                             is at first_tile + ivec3(x, y, 0)
+     */
+    bool
+    add_index_tile_block(ivec2 count, ivec3 &first_tile);
+
     /*!
       Mark a tile as free in the atlas
       \param tile tile to free as returned by add_index_tile().
@@ -390,14 +461,21 @@ class Image;
     /*!
       Adds a tile to the atlas returning the location
       (in pixels) of the tile in the backing store
-      of the atlas.
+      of the atlas. If a tile of the same content is
+      already on the atlas, that tile is returned and
+      no new tile is used, i.e. identical color tiles are
+      stored once across all the Image objects of the
+      ImageAtlas. Tiles of identical content are found
+      by a 128-bit hash of the content.
       \param data color/image data to which to set the tile
      */
     ivec3
     add_color_tile(const_c_array<u8vec4> data);
 
     /*!
-      Mark a tile as free in the atlas
+      Release a tile returned by add_color_tile(); the tile
+      is marked as free once it is released as many times
+      as it was returned by add_color_tile().
       \param tile tile to free as returned by add_color_tile().
      */
     void
@@ -422,10 +500,71 @@ class Image;
     void
     resize_to_fit(int num_color_tiles, int num_index_tiles);
 
+    /*!
+      Shrink the color and index backing stores to give memory
+      back after a peak of use, for example from a callback of
+      the application on memory pressure (see
+      memory::budget_callback). The trailing layers of each
+      backing store all of whose tiles are free are removed,
+      keeping at least one layer. The tiles of an Image are
+      held by the Image, so only the layers freed by the
+      Image objects the application has released are given
+      back; the tiles of the living Image objects are not
+      moved. Does nothing if the atlas is not resizeable().
+      Returns the number of bytes of the color and index
+      backing stores after the call.
+     */
+    uint64_t
+    trim(void);
+
   private:
+    friend class Image;
+
+    /* reserve room for the tiles of an Image before it is
+       constructed so that Image objects created concurrently
+       cannot together exhaust the atlas; if resizeable() the
+       atlas is grown as needed. Returns false if there is not
+       enough room.
+     */
+    bool
+    reserve_tiles(int num_color_tiles, int num_index_tiles);
+
+    /* release a reservation made by reserve_tiles() once the
+       Image is constructed and holds its tiles.
+     */
+    void
+    release_tiles(int num_color_tiles, int num_index_tiles);
+
     void *m_d;
   };
 
+  /*!
+    An ImageTileProvider provides on demand the texels of
+    an Image created with Image::create_streaming().
+   */
+  class ImageTileProvider:
+    public reference_counted<ImageTileProvider>::default_base
+  {
+  public:
+    virtual
+    ~ImageTileProvider()
+    {}
+
+    /*!
+      To be implemented by a derived class to write the
+      texels of a region of the image. The region is
+      always within the dimensions of the image.
+      \param location location of the minimum corner of the region
+      \param size width and height of the region
+      \param dst location to which to write the texels, the texel
+                 (x, y) of the region is dst[x + y * size.x()]
+     */
+    virtual
+    void
+    fetch_texels(ivec2 location, ivec2 size,
+                 c_array<u8vec4> dst) = 0;
+  };
+
   /*!
     An Image represents an image comprising of RGBA8 values.
     The texel values themselves are stored in a ImageAtlas.
@@ -436,7 +575,15 @@ class Image;
   public:
     /*!
       Construct an image. If there is insufficient room on the atlas,
-      returns a NULL handle.
+      returns a NULL handle. The image may be created on any thread
+      if the backing stores of the atlas do not issue GL commands
+      in their set_data() methods, see ImageAtlas and uploaded().
+      The room for the image is reserved on the atlas before the
+      image is constructed, so images created concurrently on an
+      atlas that is not resizeable cannot together exhaust it;
+      while another image is being created the room it reserved
+      is not available, so creation may then fail on an atlas that
+      is close to full.
       \param atlas ImageAtlas atlas onto which to place the image
       \param w width of the image
       \param h height of the image
@@ -444,14 +591,203 @@ class Image;
       \param pslack number of pixels allowed to sample outside of color tile
                     for the image. A value of one allows for bilinear
                     filtering and a value of two allows for cubic filtering.
+      \param pnumber_mipmap_levels number of mipmap levels of the image,
+                                   including the image itself, see
+                                   number_mipmap_levels(). The value is
+                                   clamped to [1, max_number_mipmap_levels(w, h)]
      */
     static
     reference_counted_ptr<Image>
     create(reference_counted_ptr<ImageAtlas> atlas, int w, int h,
-           const_c_array<u8vec4> image_data, unsigned int pslack);
+           const_c_array<u8vec4> image_data, unsigned int pslack,
+           unsigned int pnumber_mipmap_levels = 1);
+
+    /*!
+      Returns the number of mipmap levels of an image
+      of the given size, i.e. the number of times one can
+      halve (rounding down) the larger of the two dimensions
+      until it is 1, plus one.
+      \param w width of the image
+      \param h height of the image
+     */
+    static
+    unsigned int
+    max_number_mipmap_levels(int w, int h);
+
+    /*!
+      Returns the size of the mipmap level L of an image whose
+      dimensions() is dims, i.e. max(1, dims.x() >> L) by
+      max(1, dims.y() >> L).
+      \param dims dimensions of the image
+      \param L mipmap level
+     */
+    static
+    ivec2
+    mipmap_level_dimensions(ivec2 dims, unsigned int L);
+
+    /*!
+      Returns the location of the minimum corner of the
+      mipmap level L, L >= 1, within the texels of an image
+      whose dimensions() is dims. The levels past the first
+      are stacked vertically to the right of the image, i.e.
+      at x = dims.x() and y is the sum of the heights of the
+      levels 1, 2, .., L - 1.
+      \param dims dimensions of the image
+      \param L mipmap level, must be atleast 1
+     */
+    static
+    ivec2
+    mipmap_level_location(ivec2 dims, unsigned int L);
+
+    /*!
+      Construct a streaming image. The texels of a streaming image
+      are not given at creation; instead the color tiles of the image
+      are made resident on demand from an ImageTileProvider by
+      update_residency() for the regions requested by request_region().
+      The index tiles of a color tile that is not resident point to a
+      single tile of the fallback color. At most max_resident_tiles
+      color tiles are resident at any time, the least recently requested
+      resident tiles are made non-resident to make room for others. If
+      there is insufficient room on the atlas, returns a NULL handle.
+      \param atlas ImageAtlas atlas onto which to place the image
+      \param w width of the image
+      \param h height of the image
+      \param provider ImageTileProvider from which to fetch the texels
+      \param pslack number of pixels allowed to sample outside of color tile
+                    for the image, see create()
+      \param max_resident_tiles maximum number of color tiles of the image
+                                that are resident, must be positive
+      \param fallback_color color of the image where its color tiles are
+                            not resident
+     */
+    static
+    reference_counted_ptr<Image>
+    create_streaming(reference_counted_ptr<ImageAtlas> atlas, int w, int h,
+                     reference_counted_ptr<ImageTileProvider> provider,
+                     unsigned int pslack, unsigned int max_resident_tiles,
+                     u8vec4 fallback_color = u8vec4(0, 0, 0, 0));
+
+    /*!
+      Construct an image whose texels are not on an ImageAtlas
+      but are a texture referenced by a 64-bit bindless handle
+      of the backend (for the GL backend, a handle returned by
+      glGetTextureHandleARB() which must be resident while it is
+      drawn, see gl::create_bindless_image()). Drawing with such an
+      Image does not force a draw-call break, but requires that the
+      backend supports bindless textures (for the GL backend, see
+      gl::PainterBackendGL::ConfigurationGL::bindless_images());
+      if it does not, brushes with the image draw the image as
+      transparent black. The image has no atlas, one mipmap level,
+      no slack and no index tiles; the caller keeps the texture
+      alive for the lifetime of the Image. Returns a NULL handle
+      if handle is 0 or if w or h is not positive.
+      \param w width of the texture
+      \param h height of the texture
+      \param handle bindless handle of the texture, see bindless_handle()
+      \param external_texture if true, the texture is an external texture
+                              (for the GL backend a texture of type
+                              GL_TEXTURE_EXTERNAL_OES, for example one
+                              that sources an EGLImage of a video decoder),
+                              see bindless_external_texture()
+      \param premultiplied_alpha if true, the texels of the texture are
+                                 pre-multiplied by alpha, see
+                                 premultiplied_alpha()
+     */
+    static
+    reference_counted_ptr<Image>
+    create_bindless(int w, int h, uint64_t handle, bool external_texture = false,
+                    bool premultiplied_alpha = false);
 
     ~Image();
 
+    /*!
+      Returns the bindless handle of the texture of the Image if
+      it was created with create_bindless(), otherwise returns 0.
+     */
+    uint64_t
+    bindless_handle(void) const;
+
+    /*!
+      Returns true if the Image was created with create_bindless()
+      with the texture an external texture. An external texture
+      is sampled only at level 0 with the filtering of its sampler
+      state, the backend must additionally support external textures
+      (for the GL backend, see
+      gl::PainterBackendGL::ConfigurationGL::external_texture_images());
+      if it does not, brushes with the image draw the image as
+      transparent black.
+     */
+    bool
+    bindless_external_texture(void) const;
+
+    /*!
+      Returns true if the texels of the Image are pre-multiplied
+      by alpha, as for example the texels of a layer drawn by
+      Painter::begin_layer(). A PainterBrush divides the color
+      of such an image by its alpha before modulating it, so that
+      the image is drawn as one whose texels are not pre-multiplied.
+      Only an Image created with create_bindless() can have
+      pre-multiplied texels.
+     */
+    bool
+    premultiplied_alpha(void) const;
+
+    /*!
+      Returns true if and only if the Image was created with
+      create_streaming().
+     */
+    bool
+    streaming(void) const;
+
+    /*!
+      Only has effect if streaming() is true. Request that the color
+      tiles of a region of the image are to be resident. The request
+      holds until the next call to update_residency(). The region is
+      typically the part of the image that is visible when drawing
+      the next frame.
+      \param min_corner minimum corner of the region in texels
+      \param max_corner maximum corner of the region in texels
+     */
+    void
+    request_region(ivec2 min_corner, ivec2 max_corner);
+
+    /*!
+      Only has effect if streaming() is true. Make resident the color
+      tiles requested by request_region() since the last call to
+      update_residency(), fetching their texels from the
+      ImageTileProvider of the Image. Because the index tiles of the
+      image change, the function should be called before drawing the
+      image in a frame. Returns the number of color tiles made resident.
+      \param max_uploads maximum number of color tiles to make resident,
+                         the requested tiles beyond this number are
+                         not made resident until they are requested
+                         again
+     */
+    unsigned int
+    update_residency(unsigned int max_uploads);
+
+    /*!
+      Returns true if ImageAtlas::flush() has been called on the
+      ImageAtlas of the Image since the tiles of the Image were last
+      written (an Image created with create_bindless() is always
+      uploaded), i.e. since the Image was created or, for a streaming
+      Image, since the last call to update_residency() that made tiles
+      resident. An Image created on a thread other than the thread
+      that flushes the ImageAtlas should not be drawn until uploaded()
+      is true, since until then draws of the Image may read tiles whose
+      data has not yet been sent to the backing stores.
+     */
+    bool
+    uploaded(void) const;
+
+    /*!
+      Returns the number of color tiles of the Image that
+      are resident. If streaming() is false, this is the
+      number of color tiles of the Image.
+     */
+    unsigned int
+    number_resident_tiles(void) const;
+
     /*!
       Returns the number of index look-ups
       to get to the image data.
@@ -465,6 +801,29 @@ class Image;
     ivec2
     dimensions(void) const;
 
+    /*!
+      Returns the number of mipmap levels of the image,
+      including the image itself. The mipmap level L
+      is made by averaging 2x2 blocks of the texels of
+      the level L - 1; the levels past the first are
+      stored on the color tiles of the image to the right
+      of the image (see mipmap_level_location()) so that
+      all levels share the index tiles of the image.
+      A streaming image always has one level.
+     */
+    unsigned int
+    number_mipmap_levels(void) const;
+
+    /*!
+      Returns the dimensions of the texels of the image stored
+      on the color tiles of the ImageAtlas, i.e. dimensions()
+      together with the area of the mipmap levels past the
+      first. If number_mipmap_levels() is 1, the returns the
+      same value as dimensions().
+     */
+    ivec2
+    stored_dimensions(void) const;
+
     /*!
       Returns the slack of the image, i.e. how many texels ouside
       of the image's sub-tiles from which one may sample.
@@ -484,27 +843,38 @@ class Image;
       If number_index_lookups() > 0, returns the number of texels in
       each dimension of the master index tile this Image lies.
       If number_index_lookups() is 0, the returns the same value
-      as dimensions().
+      as stored_dimensions().
      */
     vec2
     master_index_tile_dims(void) const;
 
     /*!
-      Returns the quotient of dimensions() divided
+      Returns the quotient of stored_dimensions() divided
       by master_index_tile_dims().
      */
     float
     dimensions_index_divisor(void) const;
 
     /*!
-      Returns the ImageAtlas on which this Image resides.
+      Returns the ImageAtlas on which this Image resides,
+      a NULL handle if the image was created with
+      create_bindless().
      */
     const reference_counted_ptr<ImageAtlas>&
     atlas(void) const;
 
   private:
     Image(reference_counted_ptr<ImageAtlas> atlas, int w, int h,
-          const_c_array<u8vec4> image_data, unsigned int pslack);
+          const_c_array<u8vec4> image_data, unsigned int pslack,
+          unsigned int pnumber_mipmap_levels);
+
+    Image(reference_counted_ptr<ImageAtlas> atlas, int w, int h,
+          reference_counted_ptr<ImageTileProvider> provider,
+          unsigned int pslack, unsigned int max_resident_tiles,
+          u8vec4 fallback_color);
+
+    Image(int w, int h, uint64_t handle, bool external_texture,
+          bool premultiplied_alpha);
 
     void *m_d;
   };
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <vector>
+#include <stdint.h>
 #include <fastuidraw/util/fastuidraw_memory.hpp>
 #include <fastuidraw/util/vecN.hpp>
 #include <fastuidraw/util/c_array.hpp>
@@ -55,9 +57,54 @@ public:
   class Subset
   {
   public:
+    /*!
+      A Cluster is a range of spatially coherent triangles
+      of an index chunk of painter_data() together with the
+      bounding box of those triangles. The triangles of an
+      index chunk outside of the clusters that intersect
+      the clipping region do not need to be drawn.
+     */
+    class Cluster
+    {
+    public:
+      /*!
+        Range of the index chunk that holds the indices
+        of the triangles of the Cluster.
+       */
+      range_type<unsigned int> m_index_range;
+
+      /*!
+        Minimum corner of the bounding box of the triangles
+        of the Cluster.
+       */
+      vec2 m_min_bb;
+
+      /*!
+        Maximum corner of the bounding box of the triangles
+        of the Cluster.
+       */
+      vec2 m_max_bb;
+    };
+
     const PainterAttributeData&
     painter_data(void) const;
 
+    /*!
+      Returns the clusters of an index chunk of painter_data();
+      the clusters are in order of their ranges and together
+      cover the entire index chunk. Returns an empty array if
+      the index chunk is not divided into clusters, which is
+      the case for a Subset that is made by merging smaller
+      Subset objects; such a Subset is only returned by
+      FilledPath::select_subsets() when it is entirely within
+      the clipping region or small on the screen.
+      \param chunk index chunk of painter_data(), for example
+                   as returned by chunk_from_winding_number()
+                   or chunk_from_fill_rule()
+     */
+    const_c_array<Cluster>
+    clusters(unsigned int chunk) const;
+
     /*!
       Returns an array listing what winding number values
       there are triangle in this Subset. To get the indices
@@ -88,6 +135,53 @@ public:
     unsigned int
     chunk_from_fill_rule(enum PainterEnums::fill_rule_t fill_rule);
 
+    /*!
+      Returns the anti-alias fuzz of the boundary between
+      the regions of different winding numbers of this
+      Subset. The fuzz of an edge of the boundary is a
+      quad for each side of the edge that is drawn when
+      the region on the other side of the edge is filled
+      and the region on its side is not. The attribute
+      data of a quad is packed as follows:
+       - PainterAttribute::m_attrib0 .xy -> position of the vertex on the edge (float)
+       - PainterAttribute::m_attrib0 .zw -> unit normal to the edge pointing away from the filled side (float)
+       - PainterAttribute::m_attrib1 .x  -> 0 for the vertices on the edge and 1 for the vertices
+                                            to be moved along the normal (float)
+       - PainterAttribute::m_attrib1 .yzw -> 0 (free)
+       - PainterAttribute::m_attrib2 -> 0 (free)
+
+      The attributes of painter_data() are packed the same
+      way with a zero normal, so a single shader can draw the
+      triangles of painter_data() and the quads of
+      aa_painter_data() together. The same attribute chunk, 0,
+      is used regardless of which index chunk.
+     */
+    const PainterAttributeData&
+    aa_painter_data(void) const;
+
+    /*!
+      Returns what chunk to pass PainterAttributeData::index_chunks()
+      called on the PainterAttributeData returned by aa_painter_data()
+      to get the anti-alias fuzz of the boundary of a specified fill
+      rule.
+     */
+    static
+    unsigned int
+    aa_chunk_from_fill_rule(enum PainterEnums::fill_rule_t fill_rule);
+
+    /*!
+      Returns what chunk to pass PainterAttributeData::index_chunks()
+      called on the PainterAttributeData returned by aa_painter_data()
+      to get the anti-alias fuzz of the edges between a filled region
+      and an unfilled region of the specified winding numbers.
+      \param filled_winding winding number of the filled side of the edges
+      \param unfilled_winding winding number of the unfilled side of the edges,
+                              must be different from filled_winding
+     */
+    static
+    unsigned int
+    aa_chunk_from_winding_numbers(int filled_winding, int unfilled_winding);
+
   private:
     friend class FilledPath;
 
@@ -111,16 +205,114 @@ public:
     void *m_d;
   };
 
+  /*!
+    Enumeration to specify how the Subset objects
+    of a FilledPath are triangulated.
+   */
+  enum triangulator_t
+    {
+      /*!
+        Triangulate with GLU-tess.
+       */
+      glu_tess_triangulator,
+
+      /*!
+        Triangulate by cutting the Subset into horizontal
+        slabs at each vertex and each intersection of edges;
+        each slab is then a sequence of trapezoids, one per
+        winding number region. Avoids the allocation per vertex
+        of GLU-tess and computes the intersections of edges
+        exactly, but typically makes more vertices and triangles.
+       */
+      sweep_triangulator,
+    };
+
   /*!
     Ctor. Construct a FilledPath from the data
     of a TessellatedPath.
     \param P source TessellatedPath
+    \param triangulator how to triangulate the Subset objects
+    \param simplify_tolerance if positive, the contours of P are
+                              simplified (by Douglas-Peucker) before
+                              triangulating, dropping the points whose
+                              removal moves the boundary by no more
+                              than simplify_tolerance; the connectivity
+                              of the fill can only change at features
+                              smaller than simplify_tolerance. Used to
+                              make the levels of detail of
+                              TessellatedPath::filled(float) const.
    */
   explicit
-  FilledPath(const TessellatedPath &P);
+  FilledPath(const TessellatedPath &P,
+             enum triangulator_t triangulator = default_triangulator(),
+             float simplify_tolerance = 0.0f);
 
   ~FilledPath();
 
+  /*!
+    Returns the version of the blob format written by
+    serialize() and read by create_from_blob(). A blob
+    written with a different version is rejected
+    by create_from_blob().
+   */
+  static
+  uint32_t
+  blob_version(void);
+
+  /*!
+    Write the triangulation of all Subset objects of this
+    FilledPath to a blob so that an application can compute
+    triangulations offline and load them with create_from_blob()
+    without triangulating again. Triangulates all Subset objects
+    that are not yet triangulated. The blob is a sequence of
+    32-bit little-endian words.
+    \param dst location to which to write the blob
+   */
+  void
+  serialize(std::vector<uint8_t> &dst) const;
+
+  /*!
+    Create a FilledPath from a blob written by serialize().
+    If the host is little-endian and the blob is 4-byte aligned
+    (for example a memory mapped file) the attribute and index
+    data of the returned FilledPath point into the blob
+    directly, otherwise the blob is copied. In either case,
+    the memory of the blob must stay valid for as long as
+    the returned FilledPath is alive. Returns a NULL handle
+    if the blob is malformed or of a different version
+    than blob_version().
+    \param blob bytes written by serialize()
+   */
+  static
+  reference_counted_ptr<FilledPath>
+  create_from_blob(const_c_array<uint8_t> blob);
+
+  /*!
+    Returns the value of triangulator passed in the ctor.
+   */
+  enum triangulator_t
+  triangulator(void) const;
+
+  /*!
+    Returns the triangulator used when one is not specified
+    at construction of a FilledPath, in particular those
+    made by TessellatedPath::filled(). Default value is
+    \ref glu_tess_triangulator.
+   */
+  static
+  enum triangulator_t
+  default_triangulator(void);
+
+  /*!
+    Set the value returned by default_triangulator(void).
+    Not thread safe; set it before FilledPath objects
+    are created.
+    \param v value to use
+   */
+  static
+  void
+  default_triangulator(enum triangulator_t v);
+
   /*!
     Returns the number of Subset objects of the FilledPath.
    */
@@ -147,6 +339,16 @@ public:
                          Subset::painter_data() have no more than
                          max_index_cnt attributes.
     \param dst[output] location to which to write the what SubSets
+    \param coarse_size if both coordinates are positive, a Subset whose
+                       bounding box transformed by clip_matrix_local has
+                       a width and height, in normalized device coordinates,
+                       no larger than coarse_size is selected whole even
+                       if it is only partially within the clipping region,
+                       instead of its smaller Subset objects that intersect
+                       the clipping region. This bounds the number of selected
+                       Subset objects by the area of the screen the path
+                       covers; such a Subset may be made by merging smaller
+                       Subset objects and then has no Subset::clusters().
     \returns the number of chunks that intersect the clipping region,
              that number is guarnanteed to be no more than number_subsets().
 
@@ -157,8 +359,35 @@ public:
                  const float3x3 &clip_matrix_local,
                  unsigned int max_attribute_cnt,
                  unsigned int max_index_cnt,
-                 c_array<unsigned int> dst) const;
+                 c_array<unsigned int> dst,
+                 const vec2 &coarse_size = vec2(0.0f, 0.0f)) const;
+
+  /*!
+    Returns true if a point is within the fill of this FilledPath
+    for a fill rule. Only the triangles of the single leaf Subset
+    of the hierarchy whose bounds contain the point are tested, and
+    of those only the clusters (see Subset::clusters()) whose
+    bounding box contains the point; that leaf Subset is triangulated
+    if it is not yet triangulated. A point outside of the bounds of
+    the path has the winding number 0.
+    \param pt point, in the coordinates of the path
+    \param fill_rule fill rule to apply
+   */
+  bool
+  hit_test(const vec2 &pt, enum PainterEnums::fill_rule_t fill_rule) const;
+
+  /*!
+    Returns the winding number of a point for this FilledPath,
+    computed as in hit_test().
+    \param pt point, in the coordinates of the path
+   */
+  int
+  winding_number(const vec2 &pt) const;
+
 private:
+  explicit
+  FilledPath(void *d);
+
   void *m_d;
 };
 
@@ -0,0 +1,243 @@
+/*!
+ * \file glyph_run.hpp
+ * \brief file glyph_run.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/painter/painter_attribute_data.hpp>
+#include <fastuidraw/painter/painter_enums.hpp>
+#include <fastuidraw/text/glyph.hpp>
+#include <fastuidraw/text/glyph_cache.hpp>
+#include <fastuidraw/text/font.hpp>
+
+
+namespace fastuidraw
+{
+/*!\addtogroup Painter
+  @{
+ */
+
+  /*!
+    A GlyphRun holds a sequence of glyphs together with
+    their positions and keeps a PainterAttributeData,
+    see data(), from which to draw them with
+    Painter::draw_glyphs() (or Painter::draw_glyph_instances()
+    if the GlyphRun is instanced). The data is packed exactly
+    as by PainterAttributeDataFillerGlyphs, with the
+    glyph types giving the chunks, but is maintained
+    incrementally: changing a span of the glyphs with
+    replace(), append() or erase() only packs the
+    attributes of the glyphs of the span. The glyphs are
+    uploaded to their GlyphCache when they are added; a
+    glyph that fails to upload is kept in the GlyphRun but
+    is not drawn until a call to refresh_atlas_locations()
+    succeeds in uploading it. The order of the glyphs within
+    the chunks of data() is NOT the order of the glyphs
+    in the GlyphRun.
+   */
+  class GlyphRun:noncopyable
+  {
+  public:
+    /*!
+      Ctor.
+      \param orientation orientation of drawing
+      \param instanced if true, data() holds one attribute per glyph
+                       packed as by PainterAttributeDataFillerGlyphs
+                       with PainterAttributeDataFillerGlyphs::instanced()
+                       true, to be drawn with Painter::draw_glyph_instances()
+     */
+    explicit
+    GlyphRun(enum PainterEnums::glyph_orientation orientation
+             = PainterEnums::y_increases_downwards,
+             bool instanced = false);
+
+    ~GlyphRun();
+
+    /*!
+      Returns the orientation of drawing of the GlyphRun.
+     */
+    enum PainterEnums::glyph_orientation
+    orientation(void) const;
+
+    /*!
+      Returns the value of instanced passed in the ctor.
+     */
+    bool
+    instanced(void) const;
+
+    /*!
+      Returns the number of glyphs of the GlyphRun.
+     */
+    unsigned int
+    number_glyphs(void) const;
+
+    /*!
+      Returns the number of glyphs of the GlyphRun that
+      are not drawn because they failed to upload to
+      their GlyphCache.
+     */
+    unsigned int
+    number_glyphs_not_uploaded(void) const;
+
+    /*!
+      Returns the named glyph.
+      \param I index of glyph with 0 <= I < number_glyphs()
+     */
+    Glyph
+    glyph(unsigned int I) const;
+
+    /*!
+      Returns the position of the bottom left corner
+      of the named glyph.
+      \param I index of glyph with 0 <= I < number_glyphs()
+     */
+    vec2
+    glyph_position(unsigned int I) const;
+
+    /*!
+      Returns the pixel size at which the named glyph is
+      drawn, i.e. the value of render_pixel_size passed
+      to replace() or append() when the glyph was added.
+      \param I index of glyph with 0 <= I < number_glyphs()
+     */
+    float
+    render_pixel_size(unsigned int I) const;
+
+    /*!
+      Replace a span of glyphs of the GlyphRun.
+      \param begin index of first glyph to replace
+      \param count number of glyphs to replace, begin + count
+                   must be no more than number_glyphs()
+      \param glyph_positions position of the bottom left corner of
+                             each glyph replacing the span
+      \param glyphs glyphs replacing the span, array must be same
+                    size as glyph_positions
+      \param render_pixel_size pixel size to which to scale the glyphs
+     */
+    void
+    replace(unsigned int begin, unsigned int count,
+            const_c_array<vec2> glyph_positions,
+            const_c_array<Glyph> glyphs,
+            float render_pixel_size);
+
+    /*!
+      Replace a span of glyphs of the GlyphRun with glyphs
+      given by glyph codes, for example the output of a text
+      shaper. The glyphs are fetched with GlyphCache::fetch_glyph().
+      \param begin index of first glyph to replace
+      \param count number of glyphs to replace, begin + count
+                   must be no more than number_glyphs()
+      \param cache GlyphCache from which to fetch the glyphs
+      \param render how to render the glyphs
+      \param font font of the glyphs
+      \param glyph_positions position of the bottom left corner of
+                             each glyph replacing the span
+      \param glyph_codes glyph codes of the glyphs replacing the span,
+                         array must be same size as glyph_positions
+      \param render_pixel_size pixel size to which to scale the glyphs
+     */
+    void
+    replace(unsigned int begin, unsigned int count,
+            GlyphCache &cache, GlyphRender render,
+            const reference_counted_ptr<const FontBase> &font,
+            const_c_array<vec2> glyph_positions,
+            const_c_array<uint32_t> glyph_codes,
+            float render_pixel_size);
+
+    /*!
+      Equivalent to
+      \code
+      replace(number_glyphs(), 0, glyph_positions, glyphs, render_pixel_size);
+      \endcode
+      \param glyph_positions position of the bottom left corner of each glyph
+      \param glyphs glyphs to add, array must be same size as glyph_positions
+      \param render_pixel_size pixel size to which to scale the glyphs
+     */
+    void
+    append(const_c_array<vec2> glyph_positions,
+           const_c_array<Glyph> glyphs,
+           float render_pixel_size);
+
+    /*!
+      Equivalent to
+      \code
+      replace(number_glyphs(), 0, cache, render, font,
+              glyph_positions, glyph_codes, render_pixel_size);
+      \endcode
+      \param cache GlyphCache from which to fetch the glyphs
+      \param render how to render the glyphs
+      \param font font of the glyphs
+      \param glyph_positions position of the bottom left corner of each glyph
+      \param glyph_codes glyph codes of the glyphs to add, array must be
+                         same size as glyph_positions
+      \param render_pixel_size pixel size to which to scale the glyphs
+     */
+    void
+    append(GlyphCache &cache, GlyphRender render,
+           const reference_counted_ptr<const FontBase> &font,
+           const_c_array<vec2> glyph_positions,
+           const_c_array<uint32_t> glyph_codes,
+           float render_pixel_size);
+
+    /*!
+      Remove a span of glyphs from the GlyphRun.
+      \param begin index of first glyph to remove
+      \param count number of glyphs to remove, begin + count
+                   must be no more than number_glyphs()
+     */
+    void
+    erase(unsigned int begin, unsigned int count);
+
+    /*!
+      Remove all glyphs from the GlyphRun.
+     */
+    void
+    clear(void);
+
+    /*!
+      Upload each glyph of the GlyphRun to its GlyphCache (see
+      Glyph::upload_to_atlas()) and repack those glyphs whose
+      location in the GlyphAtlas changed, for example after
+      GlyphCache::clear_atlas() or after the glyphs were removed
+      from the GlyphAtlas to make room for others (see
+      GlyphCache::begin_frame()) or moved within the GlyphAtlas
+      (see GlyphCache::compact_atlas()). Glyphs that previously failed
+      to upload are tried again. Uploading marks the glyphs as
+      used in the current frame of their GlyphCache.
+     */
+    void
+    refresh_atlas_locations(void);
+
+    /*!
+      Returns the PainterAttributeData from which to draw
+      the glyphs of the GlyphRun. The returned object is
+      the same object for the lifetime of the GlyphRun, but
+      its contents are only valid until the GlyphRun is
+      next modified.
+     */
+    const PainterAttributeData&
+    data(void) const;
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+}
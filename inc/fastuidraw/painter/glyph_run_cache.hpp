@@ -0,0 +1,210 @@
+/*!
+ * \file glyph_run_cache.hpp
+ * \brief file glyph_run_cache.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/painter/painter_enums.hpp>
+#include <fastuidraw/painter/glyph_run.hpp>
+#include <fastuidraw/text/glyph_selector.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Painter
+  @{
+ */
+
+  /*!
+    A GlyphRunCache keeps the GlyphRun of recently drawn
+    strings so that drawing the same label again does not
+    select its glyphs again: a string of character codes
+    is laid out on a single line, from left to right, with
+    the glyphs selected by GlyphSelector::create_glyph_sequence()
+    from a FontGroup, and the GlyphRun (whose data is drawn
+    with Painter::draw_glyphs()) is kept together with the
+    metrics of the line. fetch_run() returns the kept GlyphRun
+    if a string was laid out before with the same FontGroup,
+    GlyphRender and layout parameters and none of its glyphs
+    has since been removed from the GlyphCache (see
+    Glyph::generation()); otherwise the string is laid out
+    again. The GlyphRunCache keeps at most max_number_runs()
+    GlyphRun objects, discarding the least recently fetched.
+    As with GlyphCache, the methods are NOT thread safe.
+   */
+  class GlyphRunCache:
+    public reference_counted<GlyphRunCache>::non_concurrent
+  {
+  public:
+    /*!
+      Enumeration to query the statistics of
+      the GlyphRunCache, see query_stat().
+     */
+    enum stats_t
+      {
+        /*!
+          Offset to how many calls to fetch_run()
+          returned a kept GlyphRun.
+         */
+        num_hits,
+
+        /*!
+          Offset to how many calls to fetch_run()
+          laid out a string not kept.
+         */
+        num_misses,
+
+        /*!
+          Offset to how many calls to fetch_run() laid
+          out again a kept string because a glyph of
+          its GlyphRun was removed from the GlyphCache.
+         */
+        num_invalidations,
+
+        /*!
+          Number of stats.
+         */
+        num_stats,
+      };
+
+    /*!
+      The metrics of a string laid out by fetch_run(),
+      in the units of the pixel size passed to fetch_run()
+      with the baseline of the line at y = 0 and the pen
+      starting at x = 0.
+     */
+    class Metrics
+    {
+    public:
+      Metrics(void):
+        m_advance(0.0f),
+        m_ascent(0.0f),
+        m_descent(0.0f)
+      {}
+
+      /*!
+        Position along x of the pen after the
+        last glyph, i.e. the width of the line.
+       */
+      float m_advance;
+
+      /*!
+        Largest distance from the baseline to the
+        top of a glyph, 0 if no glyph is above the
+        baseline.
+       */
+      float m_ascent;
+
+      /*!
+        Largest distance from the baseline to the
+        bottom of a glyph, as a value no more than 0.
+       */
+      float m_descent;
+    };
+
+    /*!
+      Ctor.
+      \param selector GlyphSelector from which to select glyphs,
+                      the FontGroup values passed to fetch_run()
+                      are to come from selector
+      \param max_number_runs initial value for max_number_runs()
+     */
+    GlyphRunCache(const reference_counted_ptr<GlyphSelector> &selector,
+                  unsigned int max_number_runs = 256);
+
+    ~GlyphRunCache();
+
+    /*!
+      Maximum number of GlyphRun objects kept,
+      always at least 1.
+     */
+    unsigned int
+    max_number_runs(void) const;
+
+    /*!
+      Set the value returned by max_number_runs(void) const,
+      discarding the least recently fetched GlyphRun objects
+      as needed. Values less than 1 are taken as 1.
+      \param v value
+     */
+    void
+    max_number_runs(unsigned int v);
+
+    /*!
+      Returns the number of GlyphRun objects kept.
+     */
+    unsigned int
+    number_runs(void) const;
+
+    /*!
+      Returns the GlyphRun of a string laid out on a single
+      line; the position of a glyph is the position of the
+      pen at the glyph and the pen advances by the advance of
+      each glyph scaled to pixel_size. The glyphs of the
+      returned GlyphRun are uploaded to the GlyphAtlas (see
+      GlyphRun::refresh_atlas_locations()), so the data of the
+      GlyphRun can be drawn right away. The returned reference
+      is valid until the next call to fetch_run(), clear() or
+      max_number_runs(unsigned int).
+      \param text character codes of the string
+      \param group FontGroup from which to select the glyphs
+      \param render how to render the glyphs
+      \param pixel_size pixel size at which to draw the glyphs
+      \param orientation orientation of drawing of the GlyphRun
+      \param instanced if true the GlyphRun is instanced, see
+                       GlyphRun::GlyphRun()
+      \param out_metrics if non-NULL, location to which to write
+                         the metrics of the line
+     */
+    const GlyphRun&
+    fetch_run(const_c_array<uint32_t> text,
+              GlyphSelector::FontGroup group,
+              GlyphRender render, float pixel_size,
+              enum PainterEnums::glyph_orientation orientation
+              = PainterEnums::y_increases_downwards,
+              bool instanced = false,
+              Metrics *out_metrics = NULL);
+
+    /*!
+      Discard all the kept GlyphRun objects.
+     */
+    void
+    clear(void);
+
+    /*!
+      Returns a stat of the GlyphRunCache since the last
+      call to reset_stats(). The stats are not collected
+      (and thus are 0) if FastUIDraw is built with
+      FASTUIDRAW_NO_STATS defined.
+      \param st stat to query
+     */
+    unsigned int
+    query_stat(enum stats_t st) const;
+
+    /*!
+      Resets all the stats of the GlyphRunCache to 0.
+     */
+    void
+    reset_stats(void);
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+}
@@ -0,0 +1,152 @@
+/*!
+ * \file hairline_path.hpp
+ * \brief file hairline_path.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/painter/painter_attribute.hpp>
+
+
+namespace fastuidraw
+{
+/*!\addtogroup Painter
+  @{
+ */
+
+  /*!
+    A HairlinePath holds polylines to be stroked thin with
+    Painter::draw_hairline(). Unlike a Path, a HairlinePath
+    is never tessellated nor made into a StrokedPath: each
+    line segment is packed directly as a single PainterAttribute
+    holding its two end points, from which the vertex shader
+    makes a quad expanded in screen space by the stroking
+    width (given in pixels). Segments are butt ended and
+    there are no joins or caps, which is not visible at
+    the widths of a few pixels a HairlinePath is made for.
+    Points are appended with move_to() and line_to(); appending
+    only packs the new segments, so a HairlinePath can be
+    streamed to without repacking what it already holds.
+
+    The segments are packed as follows:
+     - PainterAttribute::m_attrib0 .xy -> start point of the segment (float)
+     - PainterAttribute::m_attrib0 .zw -> end point of the segment (float)
+     - PainterAttribute::m_attrib1 -> 0
+     - PainterAttribute::m_attrib2 -> 0; when expanded to a quad by
+       expand_segment(), .w holds the corner of the vertex
+   */
+  class HairlinePath:noncopyable
+  {
+  public:
+    /*!
+      Ctor, the HairlinePath is initially empty.
+     */
+    HairlinePath(void);
+
+    ~HairlinePath();
+
+    /*!
+      Start a new polyline at a point; no segment
+      is added.
+      \param pt starting point of the new polyline
+     */
+    HairlinePath&
+    move_to(const vec2 &pt);
+
+    /*!
+      Add a segment from the last point of the current
+      polyline to a point. If there is no current polyline,
+      acts as move_to().
+      \param pt point to which to add a segment
+     */
+    HairlinePath&
+    line_to(const vec2 &pt);
+
+    /*!
+      Equivalent to calling line_to(const vec2&)
+      on each element of pts.
+      \param pts points to which to add segments
+     */
+    HairlinePath&
+    line_to(const_c_array<vec2> pts);
+
+    /*!
+      Remove all polylines and segments.
+     */
+    void
+    clear(void);
+
+    /*!
+      Returns the packed segments, one attribute
+      per segment, in the order they were added.
+     */
+    const_c_array<PainterAttribute>
+    segments(void) const;
+
+    /*!
+      Returns true if the HairlinePath has no segments.
+     */
+    bool
+    empty(void) const;
+
+    /*!
+      Returns the min-corner of the bounding box of
+      the points of the segments; only meaningful if
+      empty() returns false.
+     */
+    const vec2&
+    bounding_box_min(void) const;
+
+    /*!
+      Returns the max-corner of the bounding box of
+      the points of the segments; only meaningful if
+      empty() returns false.
+     */
+    const vec2&
+    bounding_box_max(void) const;
+
+    /*!
+      Expand a packed segment to the four vertices of its
+      quad, for drawing it with indices instead of as an
+      instance (see Painter::draw_hairline()).
+      \param segment packed segment, an element of segments()
+      \param dst location to which to write the four vertices
+     */
+    static
+    void
+    expand_segment(const PainterAttribute &segment,
+                   c_array<PainterAttribute> dst);
+
+    /*!
+      Write the six indices of the two triangles of
+      the quad of an expanded segment.
+      \param dst location to which to write the indices
+      \param first index of the first vertex of the quad
+     */
+    static
+    void
+    pack_segment_indices(c_array<PainterIndex> dst,
+                         PainterIndex first);
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+}
@@ -24,6 +24,8 @@
 #include <fastuidraw/image.hpp>
 #include <fastuidraw/colorstop_atlas.hpp>
 #include <fastuidraw/painter/packing/painter_draw.hpp>
+#include <fastuidraw/painter/packing/painter_static_attribute_data.hpp>
+#include <fastuidraw/painter/painter_attribute_data.hpp>
 #include <fastuidraw/painter/painter_shader.hpp>
 #include <fastuidraw/painter/painter_shader_set.hpp>
 
@@ -41,6 +43,99 @@ namespace fastuidraw
   class PainterBackend:public reference_counted<PainterBackend>::default_base
   {
   public:
+    /*!
+      Enumeration to query the statistics of
+      a PainterBackend, see query_stat().
+     */
+    enum stats_t
+      {
+        /*!
+          Offset to how many bytes were uploaded
+          to the atlases of the PainterBackend.
+         */
+        num_atlas_upload_bytes,
+
+        /*!
+          Offset to how many 3D API draw calls
+          were issued by the PainterBackend.
+         */
+        num_draw_calls,
+
+        /*!
+          Offset to the GPU time in micro-seconds taken
+          by a frame of the PainterBackend. Because GPU
+          timings are read back asynchronously, the value
+          is typically for a frame several frames old.
+         */
+        gpu_time_micro_seconds,
+
+        /*!
+          Offset to how many times the storage of an atlas
+          of the PainterBackend was re-allocated to grow;
+          the contents are copied to the new storage without
+          a round trip through the CPU.
+         */
+        num_atlas_resizes,
+
+        /*!
+          Offset to how many passes, i.e. on_pre_draw()/on_post_draw()
+          pairs, uploaded data to an atlas after the first draw of
+          the pass. Such an upload may force a tiled GPU to resolve
+          and reload the surface in the middle of the pass.
+         */
+        num_mid_pass_atlas_flushes,
+
+        /*!
+          Offset to how many times the PainterBackend decided
+          to enlarge the buffers to which the draws are streamed
+          because the recent passes wrote more than they hold.
+         */
+        num_buffer_grows,
+
+        /*!
+          Offset to how many times the PainterBackend decided
+          to reduce the buffers to which the draws are streamed
+          because the recent passes wrote much less than they hold.
+         */
+        num_buffer_shrinks,
+
+        /*!
+          Number of stats.
+         */
+        num_stats,
+      };
+
+    /*!
+      A RenderTarget is an offscreen surface of a PainterBackend
+      into which a Painter draws the content of a layer, see
+      Painter::begin_layer(). The texels of the surface are
+      pre-multiplied by alpha and are given by image(), which
+      can be drawn by a PainterBrush once the draws to the
+      RenderTarget are flushed.
+     */
+    class RenderTarget:public reference_counted<RenderTarget>::default_base
+    {
+    public:
+      virtual
+      ~RenderTarget();
+
+      /*!
+        To be implemented by a derived class to return
+        the width and height of the RenderTarget in pixels.
+       */
+      virtual
+      ivec2
+      dimensions(void) const = 0;
+
+      /*!
+        To be implemented by a derived class to return an
+        Image whose texels are the pixels of the RenderTarget,
+        with Image::premultiplied_alpha() true.
+       */
+      virtual
+      const reference_counted_ptr<Image>&
+      image(void) const = 0;
+    };
 
     /*!
       A ConfigurationBase holds how data should be set to a
@@ -134,6 +229,82 @@ namespace fastuidraw
       PerformanceHints&
       clipping_via_hw_clip_planes(bool v);
 
+      /*!
+        Returns true if an implementation of PainterBackend
+        supports the values of BlendMode::stencil_op_t other
+        than BlendMode::STENCIL_OFF, i.e. if it can compute
+        the coverage of a fill on the GPU with a stencil
+        buffer (see PainterFillShader::coverage()).
+       */
+      bool
+      stencil_coverage(void) const;
+
+      /*!
+        Set the value returned by
+        stencil_coverage(void) const,
+        default value is false.
+       */
+      PerformanceHints&
+      stencil_coverage(bool v);
+
+      /*!
+        Returns true if an implementation of PainterBackend
+        supports BlendMode::STENCIL_CLIP_TEST,
+        BlendMode::STENCIL_CLIP_INCREMENT and
+        BlendMode::STENCIL_CLIP_DECREMENT, in which case
+        Painter clips by paths and by rectangles under
+        transformations that do not keep rectangles
+        axis aligned with the stencil buffer instead
+        of with occluders in the depth buffer.
+       */
+      bool
+      stencil_clipping(void) const;
+
+      /*!
+        Set the value returned by
+        stencil_clipping(void) const,
+        default value is false.
+       */
+      PerformanceHints&
+      stencil_clipping(bool v);
+
+      /*!
+        Returns true if an implementation of PainterBackend
+        supports PainterDraw::draw_instanced_quads(), i.e.
+        if it can draw a glyph from a single attribute
+        (see PainterPacker::draw_instanced_quads()) instead
+        of from four vertices and six indices.
+       */
+      bool
+      instanced_quads(void) const;
+
+      /*!
+        Set the value returned by
+        instanced_quads(void) const,
+        default value is false.
+       */
+      PerformanceHints&
+      instanced_quads(bool v);
+
+      /*!
+        Returns true if an implementation of PainterBackend
+        tests the rounded rect of PainterClipEquations
+        (see PainterClipEquations::m_rounded_rect_radius)
+        per fragment, in which case Painter::clipInRoundedRect()
+        clips the corners of the rounded rect analytically
+        instead of by clipping against a Path.
+       */
+      bool
+      rounded_rect_clipping(void) const;
+
+      /*!
+        Set the value returned by
+        rounded_rect_clipping(void) const,
+        default value is false.
+       */
+      PerformanceHints&
+      rounded_rect_clipping(bool v);
+
     private:
       void *m_d;
     };
@@ -185,6 +356,19 @@ namespace fastuidraw
     void
     target_resolution(int w, int h) = 0;
 
+    /*!
+      To be optionally implemented by a derived class to draw
+      the passes of the frames that follow without the depth
+      test and without depth writes, so that the target surface
+      does not need a depth buffer. Called by PainterPacker::begin()
+      before on_begin(). Default implementation does nothing,
+      i.e. the depth buffer is still tested and written.
+      \param v if true, the depth buffer is not used
+     */
+    virtual
+    void
+    no_depth_buffer(bool v);
+
     /*!
       Returns a handle to the GlyphAtlas of this
       PainterBackend. All glyphs used by this
@@ -239,6 +423,141 @@ namespace fastuidraw
     reference_counted_ptr<const PainterDraw>
     map_draw(void) = 0;
 
+    /*!
+      To be optionally implemented by a derived class to
+      return a stat since the last call to reset_stats().
+      Default implementation returns 0.
+      \param st stat to query
+     */
+    virtual
+    unsigned int
+    query_stat(enum stats_t st) const;
+
+    /*!
+      To be optionally implemented by a derived class to
+      reset the values returned by query_stat() to 0.
+      Called by PainterPacker::begin(). Default
+      implementation does nothing.
+     */
+    virtual
+    void
+    reset_stats(void);
+
+    /*!
+      To be optionally implemented by a derived class to
+      prepare for the passes of a frame. Called by
+      PainterPacker::begin() before any on_pre_draw().
+      Default implementation does nothing.
+     */
+    virtual
+    void
+    on_begin(void);
+
+    /*!
+      To be optionally implemented by a derived class to
+      finish the passes of a frame. Called by PainterPacker::end()
+      after the last on_post_draw(). Default implementation
+      does nothing.
+     */
+    virtual
+    void
+    on_end(void);
+
+    /*!
+      Copy the attribute and index data of a PainterAttributeData
+      to memory owned by the backend so that it can be drawn with
+      PainterPacker::draw_static() without copying the attribute
+      and index data to each PainterDraw. The i'th chunk of the
+      returned object is the index chunk i of data together with
+      the attribute chunk K of data, with the index adjust of chunk
+      i applied, where K = i if attrib_chunk_selector is empty and
+      K = attrib_chunk_selector[i] otherwise. Default implementation
+      returns NULL, indicating that
+      static attribute data is not supported; a caller must then draw
+      the PainterAttributeData with PainterPacker::draw_generic().
+      A NULL value is also returned if the backend memory for static
+      attribute data is exhausted. Must not be called within a
+      on_pre_draw()/on_post_draw() pair.
+      \param data PainterAttributeData to copy
+      \param attrib_chunk_selector selects which attribute chunk to use
+                                   for each index chunk; if empty the
+                                   index chunk i uses the attribute chunk i
+      \param layout which fields of the attributes to copy; the shaders
+                    drawing the returned object must only read those
+                    fields
+     */
+    virtual
+    reference_counted_ptr<const PainterStaticAttributeData>
+    create_static_attribute_data(const PainterAttributeData &data,
+                                 const_c_array<unsigned int> attrib_chunk_selector,
+                                 enum PainterAttribute::layout_t layout);
+
+    /*!
+      To be optionally implemented by a derived class to create
+      a RenderTarget. Default implementation returns NULL,
+      indicating that render targets are not supported; a
+      Painter then draws the content of a layer directly, see
+      Painter::begin_layer(). Must not be called within a
+      on_pre_draw()/on_post_draw() pair.
+      \param dims width and height in pixels of the RenderTarget
+     */
+    virtual
+    reference_counted_ptr<RenderTarget>
+    create_render_target(ivec2 dims);
+
+    /*!
+      To be optionally implemented by a derived class to make the
+      draws of the following on_pre_draw()/on_post_draw() pairs
+      go to a RenderTarget until the matching end_render_target().
+      The RenderTarget is cleared to transparent black, with the
+      depth and stencil cleared as the application does for its
+      surface. Calls may nest. Must not be called within a
+      on_pre_draw()/on_post_draw() pair. Default implementation
+      does nothing.
+      \param target RenderTarget created by create_render_target()
+     */
+    virtual
+    void
+    begin_render_target(const reference_counted_ptr<RenderTarget> &target);
+
+    /*!
+      To be optionally implemented by a derived class to make
+      the draws go to where they went before the matching call
+      to begin_render_target(). Must not be called within a
+      on_pre_draw()/on_post_draw() pair. Default implementation
+      does nothing.
+     */
+    virtual
+    void
+    end_render_target(void);
+
+    /*!
+      To be optionally implemented by a derived class to blur
+      the region of a RenderTarget into the same region of a
+      RenderTarget, see Painter::end_layer_blurred() and
+      Painter::end_layer_drop_shadow(). The draws to src must
+      have been sent to the backend (i.e. end_render_target()
+      was called for it). Must not be called within a
+      on_pre_draw()/on_post_draw() pair nor between
+      begin_render_target() and end_render_target(). Default
+      implementation does nothing and returns routine_fail,
+      indicating that blurring is not supported.
+      \param src RenderTarget to blur
+      \param dst RenderTarget to which to write the blurred
+                 texels, may be the same as src
+      \param size the region blurred is the region of size
+                  pixels at the origin of src and of dst
+      \param radius radius of the blur in pixels
+      \param alpha_only if true, the texels written are the
+                        blurred alpha of src, i.e. the blurred
+                        coverage as a white image
+     */
+    virtual
+    enum return_code
+    blur_render_target(const reference_counted_ptr<RenderTarget> &src,
+                       const reference_counted_ptr<RenderTarget> &dst,
+                       ivec2 size, float radius, bool alpha_only);
+
     /*!
       Registers a vertex shader for use. Must not be called within a
       on_pre_draw()/on_post_draw() pair.
@@ -268,7 +587,8 @@ namespace fastuidraw
     /*!
       Provided as a conveniance, equivalent to
       \code
-      register_shader(p.fill_shader());
+      register_shader(p.item_shader());
+      register_shader(p.aa_item_shader());
       \endcode
       \param p PainterFillShader hold shaders to register
      */
@@ -26,6 +26,7 @@
 #include <fastuidraw/painter/painter_attribute.hpp>
 #include <fastuidraw/painter/painter_shader.hpp>
 #include <fastuidraw/painter/packing/painter_shader_group.hpp>
+#include <fastuidraw/painter/packing/painter_static_attribute_data.hpp>
 
 namespace fastuidraw
 {
@@ -38,9 +39,12 @@ namespace fastuidraw
     items for items to draw. Indices (stored in \ref m_indices)
     are -ALWAYS- in groups of three where each group is a single
     triangle and each index is an index into \ref m_attributes.
+    A PainterDraw is only used by the PainterPacker and PainterBackend
+    that make it and so its reference count, as that of its
+    DelayedAction objects, is not thread safe.
    */
   class PainterDraw:
-    public reference_counted<PainterDraw>::default_base
+    public reference_counted<PainterDraw>::non_concurrent
   {
   public:
     /*!
@@ -50,7 +54,7 @@ namespace fastuidraw
       of values. A DelayedAction object may only be added
       to one PainterDraw object.
      */
-    class DelayedAction:public reference_counted<DelayedAction>::default_base
+    class DelayedAction:public reference_counted<DelayedAction>::non_concurrent
     {
     public:
       /*!
@@ -141,6 +145,50 @@ namespace fastuidraw
                unsigned int attributes_written,
                unsigned int indices_written) const = 0;
 
+    /*!
+      Called to add a draw of number_instances instances of a chunk
+      of a PainterStaticAttributeData. The draw is to be ordered after
+      the indices written before the call and before the indices written
+      after the call. The header location of the instance i, 0 <= i <
+      number_instances, is stored at m_header_attributes[header_attribute + i].
+      Default implementation asserts, only a PainterDraw whose PainterBackend
+      returns non-NULL objects from PainterBackend::create_static_attribute_data()
+      need implement it.
+      \param data PainterStaticAttributeData to draw
+      \param chunk which chunk of data to draw
+      \param header_attribute index into m_header_attributes holding the
+                              header location of the first instance
+      \param number_instances number of instances to draw
+      \param indices_written total number of indices written to m_indices -before- the call
+     */
+    virtual
+    void
+    draw_static(const reference_counted_ptr<const PainterStaticAttributeData> &data,
+                unsigned int chunk, unsigned int header_attribute,
+                unsigned int number_instances,
+                unsigned int indices_written) const;
+
+    /*!
+      Called to add a draw of instanced quads: each of the
+      attributes m_attributes[first_attribute + i], 0 <= i <
+      number_instances, is a single instance from which the vertex
+      shader computes all four corners of a quad (see
+      PainterPacker::draw_instanced_quads()). The draw is to be
+      ordered after the indices written before the call and before
+      the indices written after the call. Default implementation
+      asserts, only a PainterDraw whose PainterBackend returns
+      true for PainterBackend::PerformanceHints::instanced_quads()
+      need implement it.
+      \param first_attribute index into m_attributes of first instance
+      \param number_instances number of instances to draw
+      \param indices_written total number of indices written to m_indices -before- the call
+     */
+    virtual
+    void
+    draw_instanced_quads(unsigned int first_attribute,
+                         unsigned int number_instances,
+                         unsigned int indices_written) const;
+
     /*!
       Adds a delayed action to the action list.
       \param h handle to action to add.
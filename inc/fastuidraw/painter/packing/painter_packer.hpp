@@ -36,6 +36,7 @@
 #include <fastuidraw/painter/packing/painter_draw.hpp>
 #include <fastuidraw/painter/packing/painter_backend.hpp>
 #include <fastuidraw/painter/packing/painter_packer_data.hpp>
+#include <fastuidraw/painter/packing/painter_packer_stream.hpp>
 
 namespace fastuidraw
 {
@@ -45,9 +46,13 @@ namespace fastuidraw
 
   /*!
     A PainterPacker packs data created by a Painter
-    to be fed to a PainterBackend to draw.
+    to be fed to a PainterBackend to draw. Like
+    the Painter, a PainterPacker is used from only
+    one thread at a time and its reference count
+    (and that of its DataCallBack objects) is not
+    thread safe.
    */
-  class PainterPacker:public reference_counted<PainterPacker>::default_base
+  class PainterPacker:public reference_counted<PainterPacker>::non_concurrent
   {
   public:
     /*!
@@ -56,7 +61,7 @@ namespace fastuidraw
       added or when a new PainterDraw is
       taken into use.
      */
-    class DataCallBack:public reference_counted<DataCallBack>::default_base
+    class DataCallBack:public reference_counted<DataCallBack>::non_concurrent
     {
     public:
       /*!
@@ -77,6 +82,81 @@ namespace fastuidraw
       virtual
       void
       header_added(const PainterHeader &original_value, c_array<generic_data> mapped_location) = 0;
+
+      /*!
+        To be optionally implemented by a derived class to
+        indicate that the z-value of the draws made with it
+        is to be set later, once per PainterDraw instead of
+        once per header. If true, the first header added with
+        the DataCallBack to a PainterDraw is preceded by a
+        single value in PainterDraw::m_store holding the z-value
+        of the draw, which is passed to z_value_added(), and the
+        headers added with the DataCallBack to the PainterDraw
+        hold the location of that value (see
+        PainterHeader::z_indirect_bit) instead of a z-value;
+        such headers are also shared between consecutive draws
+        like the headers of draws without a DataCallBack.
+        Default implementation returns false.
+       */
+      virtual
+      bool
+      indirect_z(void) const
+      {
+        return false;
+      }
+
+      /*!
+        To be optionally implemented by a derived class whose
+        indirect_z() returns true to note the location of the
+        z-value of the headers added with it to the current
+        PainterDraw (see current_draw()). Default implementation
+        does nothing.
+        \param mapped_location sub-array into PainterDraw::m_store
+                               whose first element holds the z-value
+       */
+      virtual
+      void
+      z_value_added(c_array<generic_data> mapped_location)
+      {
+        FASTUIDRAWunused(mapped_location);
+      }
+    };
+
+    /*!
+      A DataWriter writes the attribute and index data of a
+      draw directly into the mapped buffers of a PainterDraw,
+      see draw_generic(const reference_counted_ptr<PainterItemShader>&,
+      const PainterPackerData&, unsigned int, unsigned int,
+      const DataWriter&, unsigned int, const reference_counted_ptr<DataCallBack>&).
+      This avoids building the data in a PainterAttributeData
+      or an array that the PainterPacker then copies, which is
+      useful for content generated each frame.
+     */
+    class DataWriter
+    {
+    public:
+      virtual
+      ~DataWriter()
+      {}
+
+      /*!
+        To be implemented by a derived class to write the
+        attributes and indices of the draw. The index values
+        written are relative to the start of attributes, i.e.
+        an index value of 0 refers to attributes[0]; the
+        PainterPacker adds the location of attributes within
+        PainterDraw::m_attributes after write_data() returns.
+        \param attributes destination of the attributes, the
+                          size of the array is the number of
+                          attributes passed to draw_generic()
+        \param indices destination of the indices, the size
+                       of the array is the number of indices passed
+                       to draw_generic()
+       */
+      virtual
+      void
+      write_data(c_array<PainterAttribute> attributes,
+                 c_array<PainterIndex> indices) const = 0;
     };
 
     /*!
@@ -111,6 +191,253 @@ namespace fastuidraw
         */
         num_headers,
 
+        /*!
+          Offset to how many painter headers were not packed
+          because the draw used the same header as the draw
+          before it. These are included in \ref num_headers.
+         */
+        num_headers_shared,
+
+        /*!
+          Offset to how many bytes were not written to the
+          store buffer(s) because of headers shared by
+          consecutive draws and state values (that are not
+          from PainterPackedValue objects) equal to the value
+          of the previous draw. This includes brushes given by
+          value that are equal to a brush already packed to the
+          same PainterDraw, which reuse its location.
+         */
+        num_bytes_saved,
+
+        /*!
+          Offset to how many times the draws were broken
+          because the item shader group, blend shader group
+          or brush shader (as masked by
+          PainterBackend::ConfigurationBase::brush_shader_mask())
+          changed, i.e. the number of calls to PainterDraw::draw_break()
+          caused by a shader change.
+         */
+        num_draw_breaks_shader_change,
+
+        /*!
+          Offset to how many times the draws were broken
+          because the 3D API blend mode changed without
+          a shader change.
+         */
+        num_draw_breaks_blend_mode_change,
+
+        /*!
+          Offset to how many times a new PainterDraw was
+          mapped because the attribute, index or store
+          buffer of the current PainterDraw was full.
+         */
+        num_draw_breaks_buffer_full,
+
+        /*!
+          Offset to how many FilledPath::Subset objects were
+          selected for drawing by FilledPath::select_subsets().
+          Only tracked by Painter, i.e. PainterPacker::query_stat()
+          returns 0 for it.
+         */
+        num_filled_path_subsets_selected,
+
+        /*!
+          Offset to how many FilledPath::Subset objects were
+          culled by FilledPath::select_subsets(). Only tracked
+          by Painter, i.e. PainterPacker::query_stat() returns
+          0 for it.
+         */
+        num_filled_path_subsets_culled,
+
+        /*!
+          Offset to how many FilledPath::Subset::Cluster objects
+          of the FilledPath::Subset objects selected for drawing
+          were culled against the clipping region. Only tracked
+          by Painter, i.e. PainterPacker::query_stat() returns
+          0 for it.
+         */
+        num_filled_path_clusters_culled,
+
+        /*!
+          Offset to how many paths were filled with
+          PainterFillShader::stencil_coverage, i.e. without
+          using a FilledPath. Only tracked by Painter, i.e.
+          PainterPacker::query_stat() returns 0 for it.
+         */
+        num_stencil_filled_paths,
+
+        /*!
+          Offset to how many chunks of StrokedPath edge data
+          were selected for drawing by StrokedPath::compute_chunks().
+          Only tracked by Painter, i.e. PainterPacker::query_stat()
+          returns 0 for it.
+         */
+        num_stroked_path_chunks_selected,
+
+        /*!
+          Offset to how many chunks of StrokedPath join data
+          were selected for drawing by StrokedPath::join_chunks().
+          Only tracked by Painter, i.e. PainterPacker::query_stat()
+          returns 0 for it.
+         */
+        num_stroked_path_join_chunks_selected,
+
+        /*!
+          Offset to how many chunks of StrokedPath cap data
+          were selected for drawing by StrokedPath::cap_chunks().
+          Only tracked by Painter, i.e. PainterPacker::query_stat()
+          returns 0 for it.
+         */
+        num_stroked_path_cap_chunks_selected,
+
+        /*!
+          Offset to how many times clipping by a path with
+          a PainterClipCache reused the occluder retained by
+          the PainterClipCache. Only tracked by Painter, i.e.
+          PainterPacker::query_stat() returns 0 for it.
+         */
+        num_clip_cache_hits,
+
+        /*!
+          Offset to how many times clipping by a path with
+          a PainterClipCache packed the occluder again. Only
+          tracked by Painter, i.e. PainterPacker::query_stat()
+          returns 0 for it.
+         */
+        num_clip_cache_misses,
+
+        /*!
+          Offset to how many draws were packed without the
+          clip equations of the current clipping, because the
+          geometry was clipped on CPU (Painter::draw_convex_polygon()
+          and the methods using it) or was found to be within
+          the clipping region (Painter::draw_glyphs() with the
+          default glyph shaders and Painter::draw_glyph_instances()).
+          Such draws use clip equations that never clip, so they
+          are never discarded by the clip test of the fragment
+          shader. Only tracked by Painter, i.e.
+          PainterPacker::query_stat() returns 0 for it.
+         */
+        num_clip_free_draws,
+
+        /*!
+          Offset to how many draws were not packed at all
+          because their bounding box was outside of the
+          clipping region, see \ref num_clip_free_draws for
+          which draws are tested. Also counts the fills of a
+          Path (Painter::fill_path() taking a Path) skipped
+          because Path::tight_bounding_box() is outside of the
+          clipping region. Only tracked by Painter, i.e.
+          PainterPacker::query_stat() returns 0 for it.
+         */
+        num_draws_culled,
+
+        /*!
+          Offset to how many clippings by a path, or by a
+          rectangle under a transformation that does not keep
+          rectangles axis aligned, were done with the stencil
+          buffer instead of with occluders in the depth buffer
+          (see PainterBackend::PerformanceHints::stencil_clipping()).
+          Only tracked by Painter, i.e. PainterPacker::query_stat()
+          returns 0 for it.
+         */
+        num_stencil_clips,
+
+        /*!
+          Offset to how many draws of PainterPackerStream objects
+          were drawn ahead of a draw recorded before them, see
+          stream_reorder_window().
+         */
+        num_stream_draws_reordered,
+
+        /*!
+          Offset to how many draws of PainterPackerStream objects
+          were skipped because an opaque draw recorded after them
+          hides them, see stream_occlusion_culling().
+         */
+        num_stream_draws_occluded,
+
+        /*!
+          Offset to how many times the accumulated draws were
+          sent to the backend before a draw because they reached
+          early_flush_attributes() or early_flush_indices().
+         */
+        num_early_flushes,
+
+        /*!
+          Offset to how many times a container of the
+          PainterPacker or of the Painter that is reserved
+          ahead of time (see reserve_draws() and
+          Painter::reserve()) had to allocate because the
+          frame needed more than was reserved. Once the
+          reserved capacities cover a frame, the value is 0
+          and, other than by caches on a miss, the frame
+          allocates no memory in its packing.
+         */
+        num_unbudgeted_allocations,
+
+        /*!
+          Offset to how many bytes the backend uploaded to
+          its atlases, as reported by PainterBackend::query_stat()
+          with PainterBackend::num_atlas_upload_bytes. Uploads
+          are typically issued in PainterBackend::on_pre_draw(),
+          so the value is complete only after end().
+         */
+        num_atlas_upload_bytes,
+
+        /*!
+          Offset to how many 3D API draw calls the backend
+          issued, as reported by PainterBackend::query_stat()
+          with PainterBackend::num_draw_calls; the value is
+          complete only after end().
+         */
+        num_backend_draw_calls,
+
+        /*!
+          Offset to the GPU time in micro-seconds of a frame
+          as reported by PainterBackend::query_stat() with
+          PainterBackend::gpu_time_micro_seconds; the value is
+          read back asynchronously and is thus typically
+          for a frame several frames old.
+         */
+        backend_gpu_time_micro_seconds,
+
+        /*!
+          Offset to how many times the backend re-allocated the
+          storage of an atlas to grow it, as reported by
+          PainterBackend::query_stat() with
+          PainterBackend::num_atlas_resizes; the value is
+          complete only after end().
+         */
+        backend_num_atlas_resizes,
+
+        /*!
+          Offset to how many passes of the backend uploaded data
+          to an atlas after their first draw, as reported by
+          PainterBackend::query_stat() with
+          PainterBackend::num_mid_pass_atlas_flushes; the value
+          is complete only after end().
+         */
+        backend_num_mid_pass_atlas_flushes,
+
+        /*!
+          Offset to how many times the backend decided to enlarge
+          the buffers to which the draws are streamed, as reported
+          by PainterBackend::query_stat() with
+          PainterBackend::num_buffer_grows; the value is complete
+          only after end().
+         */
+        backend_num_buffer_grows,
+
+        /*!
+          Offset to how many times the backend decided to reduce
+          the buffers to which the draws are streamed, as reported
+          by PainterBackend::query_stat() with
+          PainterBackend::num_buffer_shrinks; the value is complete
+          only after end().
+         */
+        backend_num_buffer_shrinks,
+
         /*!
           Number of stats.
          */
@@ -174,13 +501,128 @@ namespace fastuidraw
     blend_shader(const reference_counted_ptr<PainterBlendShader> &h,
                  BlendMode::packed_value packed_blend_mode);
 
+    /*!
+      Set the stencil value of the clipping region when
+      clipping is by the stencil buffer (see
+      PainterBackend::PerformanceHints::stencil_clipping()).
+      If non-zero, each draw whose blend mode has
+      BlendMode::stencil_op() as BlendMode::STENCIL_OFF
+      is drawn with BlendMode::STENCIL_CLIP_TEST against the
+      value instead, i.e. only where the stencil buffer is the
+      value. Only the low 8 bits are used. Default value is 0.
+      \param v stencil value of the clipping region
+     */
+    void
+    stencil_clip_value(uint32_t v);
+
+    /*!
+      Returns the value set by stencil_clip_value(uint32_t).
+     */
+    uint32_t
+    stencil_clip_value(void) const;
+
+    /*!
+      Set the size of the window of draws of a PainterPackerStream
+      within which draw_stream() may change the order of the draws
+      to reduce the number of changes of PainterShaderGroup, i.e.
+      the state changes of the backend. Within a window, a draw
+      is drawn ahead of the draws recorded before it only if it
+      uses the shader group of the draw drawn just before and if
+      its box (see PainterPackerStream::add_to_bounding_box())
+      does not intersect the boxes of those draws, so the result
+      is unchanged. Draws without a box are never moved nor
+      moved past. A value less than 2 indicates to draw in the
+      recorded order. Default value is 0.
+      \param v number of draws of the window
+     */
+    void
+    stream_reorder_window(unsigned int v);
+
+    /*!
+      Returns the value set by stream_reorder_window(unsigned int).
+     */
+    unsigned int
+    stream_reorder_window(void) const;
+
+    /*!
+      If non-zero, before packing a draw the PainterPacker sends
+      the draws accumulated since the last flush to the backend,
+      as flush() does, if they have at least this many attributes;
+      this lets the GPU start on the draws of a frame while the
+      rest of the frame is packed, instead of waiting until the
+      buffers of the backend are full or end(). Each such flush
+      is a pass of the backend, i.e. a PainterBackend::on_pre_draw()
+      and PainterBackend::on_post_draw() pair, so a value that is too small adds the cost of the
+      passes and (for PainterBackendGL) makes the backend cycle
+      through its pools of buffers faster. Default value is 0.
+      \param v number of attributes, 0 to not flush early on attributes
+     */
+    void
+    early_flush_attributes(unsigned int v);
+
+    /*!
+      Returns the value set by early_flush_attributes(unsigned int).
+     */
+    unsigned int
+    early_flush_attributes(void) const;
+
+    /*!
+      As early_flush_attributes(unsigned int) for the number
+      of indices of the accumulated draws. Default value is 0.
+      \param v number of indices, 0 to not flush early on indices
+     */
+    void
+    early_flush_indices(unsigned int v);
+
+    /*!
+      Returns the value set by early_flush_indices(unsigned int).
+     */
+    unsigned int
+    early_flush_indices(void) const;
+
+    /*!
+      Reserve room for the PainterPacker to accumulate
+      count PainterDraw objects between two flushes without
+      allocating memory; the room is kept and the state of
+      each PainterDraw so reserved (including its work rooms)
+      is reused by the later flushes. A frame that needs more
+      grows the room by itself, counting as \ref
+      num_unbudgeted_allocations.
+      \param count number of PainterDraw objects
+     */
+    void
+    reserve_draws(unsigned int count);
+
+    /*!
+      If true, draw_stream() skips each draw of a PainterPackerStream
+      whose box (see PainterPackerStream::add_to_bounding_box()) is
+      contained in the opaque box (see PainterPackerStream::opaque_box())
+      of a draw recorded after it, i.e. the draws that end up completely
+      covered. Draws without a box and draws that change the stencil
+      buffer are never skipped. Only the last opaque draws of a stream
+      are tested against (to keep the cost linear), so a hidden draw
+      may still be drawn. Default value is false.
+      \param v value to use
+     */
+    void
+    stream_occlusion_culling(bool v);
+
+    /*!
+      Returns the value set by stream_occlusion_culling(bool).
+     */
+    bool
+    stream_occlusion_culling(void) const;
+
     /*!
       Indicate to start drawing. Commands are buffered and not
       set to the backend until end() or flush() is called.
       All draw commands must be between a begin() / end() pair.
+      \param no_depth_buffer passed to PainterBackend::no_depth_buffer(),
+                             if true the draws until end() must not
+                             rely on the depth buffer
      */
     void
-    begin(void);
+    begin(bool no_depth_buffer = false);
 
     /*!
       Indicate to end drawing. Commands are buffered and not
@@ -191,7 +633,13 @@ namespace fastuidraw
     end(void);
 
     /*!
-      Flush all buffered rendering commands.
+      Flush all buffered rendering commands to the backend,
+      i.e. call PainterBackend::on_pre_draw(), draw the
+      buffered commands and call PainterBackend::on_post_draw().
+      Drawing can continue after flush() until end(); a flush
+      is needed for example to change the render target of the
+      backend (see PainterBackend::begin_render_target()) between
+      draws of a frame. Must be called between begin() and end().
      */
     void
     flush(void);
@@ -245,9 +693,176 @@ namespace fastuidraw
                  const_c_array<unsigned int> attrib_chunk_selector,
                  unsigned int z,
                  const reference_counted_ptr<DataCallBack> &call_back = reference_counted_ptr<DataCallBack>());
+
+    /*!
+      Draw generic attribute data that is written by a DataWriter
+      directly into the buffers of the current PainterDraw instead
+      of being copied from arrays. The attributes and indices of
+      the draw are always placed in a single PainterDraw, so
+      number_attributes and number_indices must not exceed the
+      number of attributes and indices of a PainterDraw of the
+      PainterBackend; if they do, nothing is drawn.
+      \param shader shader with which to draw data
+      \param data data for how to draw
+      \param number_attributes number of attributes of the draw
+      \param number_indices number of indices of the draw
+      \param writer DataWriter that writes the attributes and indices,
+                    DataWriter::write_data() is called exactly once if
+                    the draw is not empty
+      \param z z-value z value placed into the header
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_generic(const reference_counted_ptr<PainterItemShader> &shader,
+                 const PainterPackerData &data,
+                 unsigned int number_attributes,
+                 unsigned int number_indices,
+                 const DataWriter &writer,
+                 unsigned int z,
+                 const reference_counted_ptr<DataCallBack> &call_back = reference_counted_ptr<DataCallBack>());
+
+    /*!
+      Draw the commands recorded in a PainterPackerStream, in the
+      order they were recorded. The attribute, index and state data
+      of the stream are copied into the PainterDraw buffers with the
+      indices, header locations and data store locations rebased.
+      Since the packing of the data was done when recording the
+      stream, the cost of draw_stream() is essentially that of
+      copying the data. Several streams recorded on different
+      threads can be drawn one after the other to split the cost of
+      packing across threads while keeping a single submission to
+      the PainterBackend.
+      \param stream stream of commands to draw, stream.alignment()
+                    must be the same as the alignment of the
+                    PainterBackend of this PainterPacker
+      \param z_offset value added to each z-value recorded in stream
+      \param call_back if non-NULL handle, call back called when attribute data
+                       of the stream is added.
+     */
+    void
+    draw_stream(const PainterPackerStream &stream, unsigned int z_offset = 0,
+                const reference_counted_ptr<DataCallBack> &call_back = reference_counted_ptr<DataCallBack>());
+
+    /*!
+      Draw the commands recorded in a PainterPackerStream replacing
+      the clipping and transformation recorded. The clipping of each
+      draw is given by clip and the transformation of each draw is
+      given by transformation * inverse(stream.base_transformation()) * R
+      where R is the transformation recorded for the draw. Only the
+      clipping and transformation data is packed, all other data of the
+      stream is copied.
+      \param stream stream of commands to draw
+      \param z_offset value added to each z-value recorded in stream
+      \param clip clipping to use for each draw of the stream
+      \param transformation transformation to apply to the stream
+      \param call_back if non-NULL handle, call back called when attribute data
+                       of the stream is added.
+     */
+    void
+    draw_stream(const PainterPackerStream &stream, unsigned int z_offset,
+                const PainterData::value<PainterClipEquations> &clip,
+                const float3x3 &transformation,
+                const reference_counted_ptr<DataCallBack> &call_back = reference_counted_ptr<DataCallBack>());
+
+    /*!
+      Copy the attribute and index data of a PainterAttributeData
+      to memory of the PainterBackend of this PainterPacker, see
+      PainterBackend::create_static_attribute_data(). Returns NULL
+      if the PainterBackend does not support static attribute data
+      or if its memory for static attribute data is exhausted.
+      \param data PainterAttributeData to copy
+      \param attrib_chunk_selector selects which attribute chunk to use
+                                   for each index chunk
+      \param layout which fields of the attributes to copy, the shaders
+                    passed to draw_static() for the returned object must
+                    only read those fields
+     */
+    reference_counted_ptr<const PainterStaticAttributeData>
+    create_static_attribute_data(const PainterAttributeData &data,
+                                 const_c_array<unsigned int> attrib_chunk_selector = const_c_array<unsigned int>(),
+                                 enum PainterAttribute::layout_t layout = PainterAttribute::layout_full);
+
+    /*!
+      Draw chunks of a PainterStaticAttributeData. The attribute
+      and index data is -not- copied to the PainterDraw buffers,
+      only the header and a single attribute that holds the header
+      location are written, i.e. the cost of drawing is independent
+      of the number of attributes and indices of the chunks.
+      \param shader shader with which to draw data
+      \param data data for how to draw
+      \param static_data PainterStaticAttributeData to draw, must
+                         have been created by create_static_attribute_data()
+                         of this PainterPacker
+      \param chunks which chunks of static_data to draw
+      \param z z-value z value placed into the header
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_static(const reference_counted_ptr<PainterItemShader> &shader,
+                const PainterPackerData &data,
+                const reference_counted_ptr<const PainterStaticAttributeData> &static_data,
+                const_c_array<unsigned int> chunks,
+                unsigned int z,
+                const reference_counted_ptr<DataCallBack> &call_back = reference_counted_ptr<DataCallBack>());
+
+    /*!
+      Draw chunks of a PainterStaticAttributeData several times,
+      each time with the state (typically the transformation and
+      the brush) of an element of instances. As with draw_static(),
+      only the headers and one attribute per instance are written;
+      in addition each chunk is drawn once as an instanced draw for
+      all the instances that land in the same PainterDraw.
+      \param shader shader with which to draw data
+      \param instances data for how to draw each instance
+      \param static_data PainterStaticAttributeData to draw, must
+                         have been created by create_static_attribute_data()
+                         of this PainterPacker
+      \param chunks which chunks of static_data to draw
+      \param z z-value z value placed into the headers
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_static_instances(const reference_counted_ptr<PainterItemShader> &shader,
+                          const_c_array<PainterPackerData> instances,
+                          const reference_counted_ptr<const PainterStaticAttributeData> &static_data,
+                          const_c_array<unsigned int> chunks,
+                          unsigned int z,
+                          const reference_counted_ptr<DataCallBack> &call_back = reference_counted_ptr<DataCallBack>());
+
+    /*!
+      Draw instanced quads: each attribute is a single instance from
+      which the vertex shader of the shader computes the four corners
+      of a quad, for example the glyph instances packed by
+      PainterAttributeDataFillerGlyphs when its instanced() is true.
+      No indices are written, i.e. the attribute traffic is a quarter
+      and the index traffic is none of drawing the same quads with
+      draw_generic(). May only be called if the
+      PainterBackend::PerformanceHints::instanced_quads() of the
+      PainterBackend is true.
+      \param shader shader with which to draw the instances; its vertex
+                    shader must expand the quad from the instance
+      \param data data for how to draw
+      \param instances the instances to draw, one attribute per quad
+      \param z z-value z value placed into the header
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_instanced_quads(const reference_counted_ptr<PainterItemShader> &shader,
+                         const PainterPackerData &data,
+                         const_c_array<PainterAttribute> instances,
+                         unsigned int z,
+                         const reference_counted_ptr<DataCallBack> &call_back = reference_counted_ptr<DataCallBack>());
+
     /*!
       Returns a stat on how much data the PainterPacker has
-      handled since the last call to begin().
+      handled since the last call to begin(). The stats
+      that are not needed for packing are not collected
+      (and thus are 0) if FastUIDraw is built with
+      FASTUIDRAW_NO_STATS defined.
       \param st stat to query
      */
     unsigned int
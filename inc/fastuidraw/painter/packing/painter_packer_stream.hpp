@@ -0,0 +1,258 @@
+/*!
+ * \file painter_packer_stream.hpp
+ * \brief file painter_packer_stream.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/matrix.hpp>
+#include <fastuidraw/util/blend_mode.hpp>
+#include <fastuidraw/painter/painter_attribute.hpp>
+#include <fastuidraw/painter/painter_item_shader.hpp>
+#include <fastuidraw/painter/painter_blend_shader.hpp>
+#include <fastuidraw/painter/packing/painter_packer_data.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup PainterPacking
+  @{
+ */
+
+  /*!
+    A PainterPackerStream records draw_generic() calls into
+    CPU-side buffers so that the work of packing the attribute,
+    index and state data can be done on a thread different from
+    the thread of the PainterPacker (or Painter) that draws the
+    recorded commands. The recorded commands are added to a
+    PainterPacker with PainterPacker::draw_stream(), where the
+    indices, attribute header locations and data store locations
+    are rebased to where the data lands in the PainterDraw buffers.
+
+    A PainterPackerStream is NOT thread safe, i.e. a fixed
+    PainterPackerStream can only be recorded to or drawn from one
+    thread at a time; different PainterPackerStream objects can be
+    recorded in different threads at the same time. If the
+    PainterPackerData values passed to draw_generic() use
+    PainterPackedValue objects, those objects must be from a
+    PainterPackedValuePool whose PainterPackedValuePool::thread_safe()
+    returns true if the stream is recorded from a thread different than
+    the thread of the PainterPacker. The shaders used must already be
+    registered to the PainterBackend of the PainterPacker when
+    PainterPacker::draw_stream() is called.
+
+    A PainterPackerStream can be drawn any number of times, making it
+    a retained draw list; the overload of PainterPacker::draw_stream()
+    taking a transformation and clipping replaces the recorded clipping
+    and transformation, so that a static portion of a UI can be recorded
+    once and drawn each frame at a different location.
+   */
+  class PainterPackerStream:
+    public reference_counted<PainterPackerStream>::default_base
+  {
+  public:
+    /*!
+      Ctor.
+      \param painter_alignment the alignment to create packed data, see
+                               PainterPacker::Configuration::alignment();
+                               must match the alignment of the PainterPacker
+                               to which the stream is drawn.
+     */
+    explicit
+    PainterPackerStream(int painter_alignment);
+
+    ~PainterPackerStream();
+
+    /*!
+      Returns the value of painter_alignment passed in the ctor.
+     */
+    int
+    alignment(void) const;
+
+    /*!
+      Clear all recorded commands. The blend shader and
+      blend mode are not affected.
+     */
+    void
+    clear(void);
+
+    /*!
+      Returns the number of draw_generic() calls recorded.
+     */
+    unsigned int
+    number_draws(void) const;
+
+    /*!
+      Returns one plus the largest z-value recorded; returns 0
+      if no commands are recorded.
+     */
+    unsigned int
+    z_range(void) const;
+
+    /*!
+      Returns the transformation that is considered the base
+      of the transformations of the recorded draws. When drawn
+      by the overload of PainterPacker::draw_stream() taking a
+      transformation T, the transformation of each draw is given
+      by T * inverse(base_transformation()) * R where R is the
+      transformation of the draw when recorded. Default value
+      is the identity.
+     */
+    const float3x3&
+    base_transformation(void) const;
+
+    /*!
+      Set the value returned by base_transformation(void) const.
+      \param v value to use
+     */
+    void
+    base_transformation(const float3x3 &v);
+
+    /*!
+      Returns true if the region covered by the recorded draws
+      is known, in which case the min and max corners of a box
+      containing the recorded draws are written to pmin and pmax.
+      The box is in the coordinates that base_transformation()
+      maps to clip coordinates. Returns false if no draws
+      are recorded or if bounding_box_unknown() was called
+      since the last call to clear(). The box is set by the
+      Painter while recording, see Painter::begin_recording().
+      \param pmin location to which to write the min corner
+      \param pmax location to which to write the max corner
+     */
+    bool
+    bounding_box(vec2 *pmin, vec2 *pmax) const;
+
+    /*!
+      Enlarge the box of bounding_box() to contain the box
+      with min and max corners pmin and pmax, given in the
+      coordinates of bounding_box(). Has no effect after
+      bounding_box_unknown() until clear(). In addition, the
+      union of the boxes passed since the last draw_generic()
+      is the box of the next draw recorded, which is used by
+      PainterPacker::stream_reorder_window(); a recorded draw
+      with no box passed before it is treated as unbounded.
+      \param pmin min corner of box to add
+      \param pmax max corner of box to add
+     */
+    void
+    add_to_bounding_box(const vec2 &pmin, const vec2 &pmax);
+
+    /*!
+      Mark the region covered by the recorded draws as not
+      known, i.e. some draw is not bounded by the box of
+      bounding_box(); bounding_box() returns false until
+      clear() is called. The next draw recorded is also
+      treated as unbounded.
+     */
+    void
+    bounding_box_unknown(void);
+
+    /*!
+      Mark the next recorded draw as opaque over the box with
+      min and max corners pmin and pmax, given in the coordinates
+      of bounding_box(): every pixel of the box is drawn by the
+      draw with a color that does not depend on what is behind it.
+      The draws recorded before it whose box is contained in the
+      opaque box are then skipped by PainterPacker::draw_stream()
+      if PainterPacker::stream_occlusion_culling() is true.
+      \param pmin min corner of the opaque box
+      \param pmax max corner of the opaque box
+     */
+    void
+    opaque_box(const vec2 &pmin, const vec2 &pmax);
+
+    /*!
+      Returns the blend shader used for the draws recorded
+      after the last call to blend_shader(); initial value
+      is NULL which indicates to use the blend shader of the
+      PainterPacker when drawn.
+     */
+    const reference_counted_ptr<PainterBlendShader>&
+    blend_shader(void) const;
+
+    /*!
+      Returns the 3D API blend mode packed as in BlendMode::packed()
+      used for the draws recorded after the last call to blend_shader().
+     */
+    BlendMode::packed_value
+    blend_mode(void) const;
+
+    /*!
+      Sets the blend shader used for the draws recorded after
+      this call.
+      \param h blend shader to use for blending, a NULL value
+               indicates to use the blend shader of the
+               PainterPacker when drawn.
+      \param packed_blend_mode 3D API blend mode packed via BlendMode::packed().
+     */
+    void
+    blend_shader(const reference_counted_ptr<PainterBlendShader> &h,
+                 BlendMode::packed_value packed_blend_mode);
+
+    /*!
+      Record a draw of generic attribute data, see
+      PainterPacker::draw_generic(). The attribute and index data
+      and the state data of draw that is not from PainterPackedValue
+      objects is copied; PainterPackedValue values are retained.
+      \param shader shader with which to draw data
+      \param draw data for how to draw
+      \param attrib_chunks attribute data to draw
+      \param index_chunks the i'th element is index data into attrib_chunks[i]
+      \param index_adjusts the i'th element is the value by which to adjust all of index_chunks[i]
+      \param z z-value placed into the header, relative to the z-offset
+               passed to PainterPacker::draw_stream()
+     */
+    void
+    draw_generic(const reference_counted_ptr<PainterItemShader> &shader,
+                 const PainterPackerData &draw,
+                 const_c_array<const_c_array<PainterAttribute> > attrib_chunks,
+                 const_c_array<const_c_array<PainterIndex> > index_chunks,
+                 const_c_array<int> index_adjusts,
+                 unsigned int z);
+
+    /*!
+      Record a draw of generic attribute data, see
+      PainterPacker::draw_generic().
+      \param shader shader with which to draw data
+      \param draw data for how to draw
+      \param attrib_chunks attribute data to draw
+      \param index_chunks the i'th element is index data into attrib_chunks[K]
+                          where K = attrib_chunk_selector[i]
+      \param index_adjusts the i'th element is the value by which to adjust all of index_chunks[i]
+      \param attrib_chunk_selector selects which attribute chunk to use for
+             each index chunk
+      \param z z-value placed into the header, relative to the z-offset
+               passed to PainterPacker::draw_stream()
+     */
+    void
+    draw_generic(const reference_counted_ptr<PainterItemShader> &shader,
+                 const PainterPackerData &draw,
+                 const_c_array<const_c_array<PainterAttribute> > attrib_chunks,
+                 const_c_array<const_c_array<PainterIndex> > index_chunks,
+                 const_c_array<int> index_adjusts,
+                 const_c_array<unsigned int> attrib_chunk_selector,
+                 unsigned int z);
+
+  private:
+    friend class PainterPacker;
+    void *m_d;
+  };
+/*! @} */
+
+}
@@ -0,0 +1,81 @@
+/*!
+ * \file painter_static_attribute_data.hpp
+ * \brief file painter_static_attribute_data.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/painter/painter_attribute.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup PainterPacking
+  @{
+ */
+
+  /*!
+    A PainterStaticAttributeData represents the attribute and index
+    data of a PainterAttributeData copied to memory owned by a
+    PainterBackend (for example GPU buffer objects). Drawing from a
+    PainterStaticAttributeData only writes the per-draw header to the
+    streaming buffers of a PainterDraw; the attribute and index data
+    is sourced directly from the backend memory. Objects are created
+    by PainterBackend::create_static_attribute_data() and may only be
+    drawn by a PainterPacker whose PainterBackend created them. The
+    backend memory is released when the object is destroyed.
+   */
+  class PainterStaticAttributeData:
+    public reference_counted<PainterStaticAttributeData>::default_base
+  {
+  public:
+    virtual
+    ~PainterStaticAttributeData()
+    {}
+
+    /*!
+      To be implemented by a derived class to return the
+      number of chunks, the value is the same as the number
+      of index chunks of the PainterAttributeData from which
+      this object was created.
+     */
+    virtual
+    unsigned int
+    number_chunks(void) const = 0;
+
+    /*!
+      To be implemented by a derived class to return the
+      number of indices of the named chunk.
+      \param chunk which chunk
+     */
+    virtual
+    unsigned int
+    number_indices(unsigned int chunk) const = 0;
+
+    /*!
+      To be implemented by a derived class to return
+      the PainterAttribute::layout_t with which the
+      attribute data was copied, i.e. which fields of
+      the attributes are read by the shader.
+     */
+    virtual
+    enum PainterAttribute::layout_t
+    attribute_layout(void) const = 0;
+  };
+/*! @} */
+
+}
@@ -23,10 +23,15 @@
 #include <fastuidraw/tessellated_path.hpp>
 #include <fastuidraw/painter/stroked_path.hpp>
 #include <fastuidraw/painter/filled_path.hpp>
+#include <fastuidraw/painter/glyph_run.hpp>
+#include <fastuidraw/painter/hairline_path.hpp>
 #include <fastuidraw/painter/painter_brush.hpp>
 #include <fastuidraw/painter/painter_stroke_params.hpp>
 #include <fastuidraw/painter/painter_dashed_stroke_params.hpp>
 #include <fastuidraw/painter/painter_data.hpp>
+#include <fastuidraw/painter/painter_clip_cache.hpp>
+#include <fastuidraw/painter/painter_layer_cache.hpp>
+#include <fastuidraw/painter/painter_trace.hpp>
 #include <fastuidraw/painter/packing/painter_packer.hpp>
 
 namespace fastuidraw
@@ -56,8 +61,11 @@ namespace fastuidraw
     to consume, see \ref draw_generic(). In addition, the class
     PainterAttributeData can be used to generate and save attribute and
     index data to be used repeatedly.
+
+    A Painter is to be used from only one thread at a time, as such
+    its reference count is not thread safe.
    */
-  class Painter:public reference_counted<Painter>::default_base
+  class Painter:public reference_counted<Painter>::non_concurrent
   {
   public:
     /*!
@@ -77,6 +85,92 @@ namespace fastuidraw
       operator()(int winding_number) const = 0;
     };
 
+    /*!
+      Class to specify how a frame is begun by
+      begin(const BeginParams&).
+     */
+    class BeginParams
+    {
+    public:
+      /*!
+        Ctor, initializes values to those of begin(void).
+       */
+      BeginParams(void):
+        m_reset_z(true),
+        m_multisampled_target(false),
+        m_no_depth_buffer(false)
+      {}
+
+      /*!
+        Set the value of \ref m_reset_z.
+        \param v value to use
+       */
+      BeginParams&
+      reset_z(bool v)
+      {
+        m_reset_z = v;
+        return *this;
+      }
+
+      /*!
+        Set the value of \ref m_multisampled_target.
+        \param v value to use
+       */
+      BeginParams&
+      multisampled_target(bool v)
+      {
+        m_multisampled_target = v;
+        return *this;
+      }
+
+      /*!
+        Set the value of \ref m_no_depth_buffer.
+        \param v value to use
+       */
+      BeginParams&
+      no_depth_buffer(bool v)
+      {
+        m_no_depth_buffer = v;
+        return *this;
+      }
+
+      /*!
+        If true, reset the z-value of draws.
+        Default value is true.
+       */
+      bool m_reset_z;
+
+      /*!
+        If true, the surface drawn to is multisampled and so
+        the anti-aliasing of geometry is provided by the
+        hardware. Until the next begin(), strokes are drawn
+        without the anti-alias pass(es) and fills are drawn
+        without their anti-alias fuzz regardless of the
+        requested anti-aliasing. This saves the second pass
+        (with discard) of the strokes and the fuzz geometry
+        of the fills. Default value is false.
+       */
+      bool m_multisampled_target;
+
+      /*!
+        If true, the frame is drawn without the depth test and
+        without depth writes (see PainterBackend::no_depth_buffer()),
+        so the surface drawn to does not need a depth buffer.
+        Clipping with clipInPath() or clipOutPath(), or with
+        clipInRect() under a rotation or shear, needs either the
+        depth buffer or the stencil buffer (see
+        PainterBackend::PerformanceHints::stencil_clipping()). If
+        such a clipping cannot be done with the stencil buffer, it
+        is rejected with a warning and all content is clipped out
+        until the clipping is removed by restore(). Clipping by
+        rects that stay screen aligned is done by the clip
+        equations alone. Without the depth test, the pieces of a
+        stroke that overlap are blended more than once. Default
+        value is false.
+       */
+      bool m_no_depth_buffer;
+    };
+
     /*!
       Class to specify a custom fill rule from
       a function.
@@ -104,6 +198,79 @@ namespace fastuidraw
       bool (*m_fill_rule)(int);
     };
 
+    /*!
+      A Budget gives the capacities that reserve() reserves
+      for a frame, i.e. between begin() and end(). A frame
+      that stays within the capacities reserved does not
+      allocate memory in the Painter and its PainterPacker,
+      other than by the caches (for example GlyphCache or
+      PainterClipCache) on a miss; a frame that needs more
+      grows the containers by itself, and each such growth
+      counts as PainterPacker::num_unbudgeted_allocations
+      in query_stat().
+     */
+    class Budget
+    {
+    public:
+      Budget(void):
+        m_draws(4),
+        m_clip_depth(16),
+        m_clippings(64),
+        m_clip_equations(256),
+        m_save_depth(32),
+        m_layer_depth(4),
+        m_occluder_draws(64)
+      {}
+
+      /*!
+        Number of PainterDraw objects accumulated
+        between two flushes, see
+        PainterPacker::reserve_draws().
+       */
+      unsigned int m_draws;
+
+      /*!
+        Number of clippings by paths (clipInPath(),
+        clipOutPath() and clipInRect() when not axis
+        aligned) in effect at the same time.
+       */
+      unsigned int m_clip_depth;
+
+      /*!
+        Number of clippings by paths over a frame,
+        i.e. the count of m_clip_depth summed over
+        the frame.
+       */
+      unsigned int m_clippings;
+
+      /*!
+        Number of clip equations, summed over the
+        save() calls in effect, kept for restore().
+       */
+      unsigned int m_clip_equations;
+
+      /*!
+        Number of save() calls in effect
+        at the same time.
+       */
+      unsigned int m_save_depth;
+
+      /*!
+        Number of begin_layer() calls in
+        effect at the same time.
+       */
+      unsigned int m_layer_depth;
+
+      /*!
+        Number of (clipping, PainterDraw) pairs over
+        a frame, i.e. the number of PainterDraw objects
+        to which the occluders of each clipping by a
+        path are packed, summed over the clippings of
+        a frame.
+       */
+      unsigned int m_occluder_draws;
+    };
+
     /*!
       Ctor.
      */
@@ -215,21 +382,95 @@ namespace fastuidraw
 
     /*!
       Informs the Painter what the resolution of
-      the target surface is.
+      the target surface is. The resolution is also
+      set to the PainterBackend at each begin(), so
+      that Painters of surfaces of different sizes
+      can share a PainterBackend.
       \param w width of target resolution
       \param h height of target resolution
      */
     void
     target_resolution(int w, int h);
 
+    /*!
+      Set the damage region, i.e. the region of the target
+      surface that is to be redrawn. A draw whose bounding box
+      misses all the rectangles of the damage region is skipped
+      before any of its data is packed; the test is only made
+      for the draws whose bounding box the Painter computes,
+      i.e. the fills, glyphs, polygons and streams (see
+      draw_stream()). The damage region is not a clipping, the
+      content of a draw that is not skipped is drawn also outside
+      of the damage region. The damage region remains until it
+      is set again; an empty array, the initial value, indicates
+      that all of the target surface is damaged.
+      \param rects rectangles of the damage region, each given as
+                   (x, y, width, height) in pixels of the target
+                   surface (see target_resolution()) with the
+                   origin at the corner of normalized device
+                   coordinates (-1, -1), i.e. as for glScissor()
+                   and EGL_KHR_partial_update
+     */
+    void
+    damage_region(const_c_array<vec4> rects);
+
+    /*!
+      Returns the value set by damage_region(const_c_array<vec4>).
+     */
+    const_c_array<vec4>
+    damage_region(void) const;
+
+    /*!
+      Returns the damage of the streams drawn with draw_stream()
+      since begin(), as one rectangle per stream drawn, given as
+      for damage_region(const_c_array<vec4>) and clamped to the
+      target surface. The rectangle of a stream is the bounding
+      box of the stream (see PainterPackerStream::bounding_box())
+      in pixels; a stream whose bounding box is not known damages
+      all of the target surface. Together with the draws made
+      outside of streams, the rectangles can be given to the
+      compositor as the damage of a frame, e.g. with
+      EGL_KHR_partial_update or EGL_EXT_buffer_age.
+     */
+    const_c_array<vec4>
+    stream_damage(void) const;
+
     /*!
       Indicate to start drawing with methods of this Painter.
       Drawing commands sent to 3D hardware are buffered and not
       sent to hardware until end() is called.
       All draw commands must be between a begin()/end() pair.
+      \param params how to begin the frame
+     */
+    void
+    begin(const BeginParams &params);
+
+    /*!
+      Provided as a conveniance, equivalent to
+      \code
+      begin(BeginParams().reset_z(reset_z));
+      \endcode
+      \param reset_z if true, reset the z-value of draws
      */
     void
-    begin(bool reset_z = true);
+    begin(bool reset_z = true)
+    {
+      begin(BeginParams().reset_z(reset_z));
+    }
+
+    /*!
+      Returns the value of BeginParams::m_multisampled_target
+      passed to the last call to begin().
+     */
+    bool
+    multisampled_target(void) const;
+
+    /*!
+      Returns the value of BeginParams::m_no_depth_buffer
+      passed to the last call to begin().
+     */
+    bool
+    no_depth_buffer(void) const;
 
     /*!
       Indicate to end drawing with methods of this Painter.
@@ -328,6 +569,22 @@ namespace fastuidraw
     void
     clipInRect(const vec2 &xy, const vec2 &wh);
 
+    /*!
+      Set clipping to the intersection of the current
+      clipping with a rectangle whose corners are rounded.
+      If the backend supports it (see PainterBackend::PerformanceHints::rounded_rect_clipping()),
+      the corners are clipped analytically in the fragment
+      shader, otherwise (or if the current clipping already
+      has a rounded rectangle) the clipping falls back to
+      clipInPath() against the rounded rectangle.
+      \param xy location of rectangle
+      \param wh width and height of rectange
+      \param corner_radius radius of each corner, clamped to half
+                           of the smaller of the width and height
+     */
+    void
+    clipInRoundedRect(const vec2 &xy, const vec2 &wh, float corner_radius);
+
     /*!
       Clip-out by a path, i.e. set the clipping to be
       the intersection of the current clipping against
@@ -368,6 +625,36 @@ namespace fastuidraw
     void
     clipInPath(const Path &path, const CustomFillRuleBase &fill_rule);
 
+    /*!
+      Clip-out by a path retaining the packed occluder in a
+      PainterClipCache, see PainterClipCache for when the
+      retained occluder is reused. If cache is NULL, if
+      recording() or if the Painter clips with the stencil
+      buffer (see PainterBackend::PerformanceHints::stencil_clipping()),
+      equivalent to clipOutPath(path, fill_rule).
+      \param path path by which to clip out
+      \param fill_rule fill rule to apply to path
+      \param cache PainterClipCache in which to retain the occluder
+     */
+    void
+    clipOutPath(const Path &path, enum PainterEnums::fill_rule_t fill_rule,
+                const reference_counted_ptr<PainterClipCache> &cache);
+
+    /*!
+      Clip-in by a path retaining the packed occluder in a
+      PainterClipCache, see PainterClipCache for when the
+      retained occluder is reused. If cache is NULL, if
+      recording() or if the Painter clips with the stencil
+      buffer (see PainterBackend::PerformanceHints::stencil_clipping()),
+      equivalent to clipInPath(path, fill_rule).
+      \param path path by which to clip in
+      \param fill_rule fill rule to apply to path
+      \param cache PainterClipCache in which to retain the occluder
+     */
+    void
+    clipInPath(const Path &path, enum PainterEnums::fill_rule_t fill_rule,
+               const reference_counted_ptr<PainterClipCache> &cache);
+
     /*!
       Set the curve flatness requirement for TessellatedPath
       and StrokedPath selection when stroking or filling paths
@@ -377,7 +664,9 @@ namespace fastuidraw
       the true curve (realized in Path). This value is combined
       with a value derived from the current transformation matrix
       to pass to Path::tessellation(float) to fetch a
-      TessellatedPath.
+      TessellatedPath. When filling, the same value is passed
+      to TessellatedPath::filled(float) const to fetch the
+      level of detail of the fill.
      */
     void
     curveFlatness(float thresh);
@@ -388,6 +677,54 @@ namespace fastuidraw
     float
     curveFlatness(void);
 
+    /*!
+      Set if dashed stroking of a StrokedPath with a
+      PainterDashedStrokeShaderSet draws the edges from
+      StrokedPath::dashed_edges() instead of
+      StrokedPath::edges(), i.e. if the edges are split on
+      the CPU at the boundaries of the dash pattern so that
+      no fragments are made in the gaps of the dash pattern.
+      This is a gain for long and sparse dash patterns that
+      are zoomed in, but the split data is made again each
+      time the dash pattern, the dash offset or the scale
+      of the transformation changes by more than a factor of
+      two. Splitting is only done if the
+      PainterDashedStrokeShaderSet::dash_evaluator() implements
+      DashEvaluatorBase::draw_intervals() and the transformation
+      has no perspective. Default value is false.
+     */
+    void
+    splitDashedEdges(bool v);
+
+    /*!
+      Returns the value set by splitDashedEdges(bool).
+     */
+    bool
+    splitDashedEdges(void);
+
+    /*!
+      Set the width in pixels below which stroking a Path
+      (i.e. stroke_path() and stroke_dashed_path() taking a
+      Path) simplifies the stroke: the caps are dropped,
+      rounded and miter joins are drawn as bevel joins, or
+      not at all when the stroke is thinner than half the
+      value, and the StrokedPath comes from the TessellatedPath
+      one level of detail coarser than the one a fill would
+      use. The width of the stroke in pixels is computed from
+      StrokingDataSelectorBase::stroking_distances() and the
+      scale of the current transformation. A value of 0 or
+      less disables the simplification. Default value is 0.
+      \param v width in pixels
+     */
+    void
+    strokeLODPixelWidth(float v);
+
+    /*!
+      Returns the value set by strokeLODPixelWidth(float).
+     */
+    float
+    strokeLODPixelWidth(void);
+
     /*!
       Save the current state of this Painter onto the save state stack.
       The state is restored (and the stack popped) by called restore().
@@ -397,6 +734,12 @@ namespace fastuidraw
       - clip state (see clipInRect(), clipOutPath(), clipInPath())
       - curve flatness requirement (see curveFlatness(float))
       - blend shader (see blend_shader()).
+      The state is saved lazily: save() itself only records the
+      clip state of clipOutPath() and clipInPath() and each of
+      the other parts of the state is copied only when it is
+      first modified after the save(), so that a save() and
+      restore() pair around drawing that modifies little of the
+      state is cheap.
      */
     void
     save(void);
@@ -408,6 +751,99 @@ namespace fastuidraw
     void
     restore(void);
 
+    /*!
+      Begin a layer: the content drawn until the matching
+      end_layer() is drawn to an offscreen surface, see
+      PainterBackend::create_render_target(), which end_layer()
+      then composites to the rect of the layer with the blend
+      shader current at begin_layer() and the opacity of the
+      layer modulating its alpha. The content is thus blended
+      as a group, as needed to draw a widget with opacity.
+      The offscreen surfaces are pooled by the Painter and are
+      reused in later frames. Drawing to the offscreen surface
+      breaks the batching of draws of the frame, since the
+      draws so far are sent to the backend at begin_layer()
+      and those of the layer at end_layer().
+
+      The surface of the layer covers the rect [xy, xy + wh]
+      in the coordinates of the transformation at begin_layer(),
+      with a size in pixels of the bounding box of the rect in
+      pixels (at most 4096 by 4096). Between begin_layer() and
+      end_layer(), the transformation maps the rect to the
+      surface of the layer and the clipping is the rect; the
+      state of begin_layer() is restored by end_layer() as by
+      save() and restore(), and save() and restore() calls
+      must be balanced within the layer. The damage region (see
+      damage_region()) does not apply to the content of the
+      layer and the streams drawn to the layer do not add to
+      stream_damage().
+
+      If cache is non-NULL and is valid for the layer (see
+      PainterLayerCache), the retained surface is composited by
+      end_layer() and begin_layer() returns false, indicating
+      that the caller is to skip drawing the content; otherwise
+      returns true and the cache retains the surface drawn.
+
+      If the PainterBackend does not support render targets, if
+      recording() or if the transformation maps a corner of the
+      rect behind the viewer, the content is drawn directly,
+      i.e. without the opacity of the layer or group blending,
+      and begin_layer() returns true.
+      \param xy min-corner of the rect of the layer
+      \param wh width and height of the rect of the layer
+      \param opacity opacity with which to composite the layer
+      \param cache if non-NULL, PainterLayerCache in which to
+                   retain the surface of the layer
+     */
+    bool
+    begin_layer(const vec2 &xy, const vec2 &wh, float opacity = 1.0f,
+                const reference_counted_ptr<PainterLayerCache> &cache = reference_counted_ptr<PainterLayerCache>());
+
+    /*!
+      End the layer of the matching call to begin_layer()
+      and composite it, see begin_layer().
+     */
+    void
+    end_layer(void);
+
+    /*!
+      End the layer of the matching call to begin_layer()
+      and composite it blurred, as for a blur-behind effect.
+      The blur is performed by the PainterBackend on the
+      surface of the layer (see
+      PainterBackend::blur_render_target()); if the layer is
+      retained by a PainterLayerCache, the blur is to a pooled
+      surface so that the cache keeps the layer unblurred. The
+      blur does not reach beyond the rect of the layer, so the
+      rect should have a margin of the blur radius around the
+      content. If the content of the layer is drawn directly
+      (see begin_layer()) or the PainterBackend does not support
+      blurring, the layer is composited unblurred.
+      \param radius radius of the blur in pixels of the
+                    surface of the layer
+     */
+    void
+    end_layer_blurred(float radius);
+
+    /*!
+      End the layer of the matching call to begin_layer()
+      and composite it over a drop shadow: the coverage of
+      the layer blurred (see end_layer_blurred()), offset and
+      colored, is composited first and then the layer. If the
+      content of the layer is drawn directly (see begin_layer())
+      or the PainterBackend does not support blurring, the
+      layer is composited without a shadow.
+      \param radius radius of the blur of the shadow in pixels
+                    of the surface of the layer
+      \param offset offset of the shadow in the coordinates of
+                    the rect of the layer
+      \param color color of the shadow, the alpha of the
+                   shadow is the blurred alpha of the layer
+                   times color.w() and the opacity of the layer
+     */
+    void
+    end_layer_drop_shadow(float radius, const vec2 &offset, const vec4 &color);
+
     /*!
       Return the default shaders for common drawing types.
      */
@@ -415,7 +851,13 @@ namespace fastuidraw
     default_shaders(void) const;
 
     /*!
-      Draw glyphs.
+      Draw glyphs. The shader of each chunk of data is that
+      of the glyph type PainterAttributeDataFillerGlyphs::chunk_glyph_type()
+      of the chunk. If shader is one of the default glyph shaders,
+      each chunk whose glyphs are outside of the clipping is
+      skipped; filling with PainterAttributeDataFillerGlyphs::glyphs_per_chunk()
+      non-zero makes a chunk per block of glyphs, so that only
+      the visible blocks of a long glyph run are drawn.
       \param draw data for how to draw
       \param data attribute and index data with which to draw the glyphs.
       \param shader with which to draw the glyphs
@@ -441,6 +883,82 @@ namespace fastuidraw
                 const PainterAttributeData &data, bool use_anistopic_antialias = false,
                 const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
 
+    /*!
+      Draw glyphs from glyph instances, i.e. from data filled by a
+      PainterAttributeDataFillerGlyphs whose instanced() is true.
+      If the PainterBackend supports instanced quads (see
+      PainterBackend::PerformanceHints::instanced_quads()), the
+      instances are drawn directly with instance_shader, one attribute
+      per glyph. Otherwise, and when recording to a PainterPackerStream,
+      the instances are expanded to four attributes and six indices
+      per glyph and drawn with quad_shader.
+      \param instance_shader shader with which to draw the instances,
+                             for example default_shaders().glyph_instance_shader()
+      \param quad_shader shader with which to draw the expanded glyphs,
+                         for example default_shaders().glyph_shader()
+      \param draw data for how to draw
+      \param data attribute data of the glyph instances
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_glyph_instances(const PainterGlyphShader &instance_shader,
+                         const PainterGlyphShader &quad_shader,
+                         const PainterData &draw,
+                         const PainterAttributeData &data,
+                         const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw glyphs from glyph instances with the default shaders.
+      \param draw data for how to draw
+      \param data attribute data of the glyph instances
+      \param use_anistopic_antialias if true, use default_shaders().glyph_instance_shader_anisotropic()
+                                     and default_shaders().glyph_shader_anisotropic(), otherwise use
+                                     default_shaders().glyph_instance_shader() and
+                                     default_shaders().glyph_shader()
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_glyph_instances(const PainterData &draw,
+                         const PainterAttributeData &data, bool use_anistopic_antialias = false,
+                         const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw the glyphs of several GlyphRun objects with the same
+      PainterData. The chunks of the same glyph type of all the
+      runs are drawn with a single draw_generic() call, i.e. a
+      single header and state upload for each glyph type instead
+      of one for each run and glyph type. The GlyphRun objects
+      must not be instanced.
+      \param shader shader with which to draw the glyphs
+      \param draw data for how to draw
+      \param runs GlyphRun objects to draw, NULL values are ignored
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_glyph_runs(const PainterGlyphShader &shader, const PainterData &draw,
+                    const_c_array<const GlyphRun*> runs,
+                    const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw the glyphs of several GlyphRun objects with the same
+      PainterData and the default shaders. The runs that are not
+      instanced are drawn as by draw_glyph_runs(const PainterGlyphShader&,
+      const PainterData&, const_c_array<const GlyphRun*>, const reference_counted_ptr<PainterPacker::DataCallBack>&),
+      the instanced runs are drawn with draw_glyph_instances().
+      \param draw data for how to draw
+      \param runs GlyphRun objects to draw, NULL values are ignored
+      \param use_anistopic_antialias if true, use the anisotropic glyph shaders
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_glyph_runs(const PainterData &draw,
+                    const_c_array<const GlyphRun*> runs, bool use_anistopic_antialias = false,
+                    const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
     /*!
       Stroke a path.
       \param shader shader with which to stroke the attribute data
@@ -451,7 +969,8 @@ namespace fastuidraw
       \param inc_edge amount by which to increment current_z() for the edge drawing
       \param cap_data attribute and index data for drawing the caps,
                       NULL value indicates to not draw caps.
-      \param cap_chunk which chunk to take from cap_data
+      \param cap_chunks which chunks to take from cap_data
+      \param inc_cap amount by which to increment current_z() for the cap drawing
       \param join_data attribute and index data for drawing the joins,
                        NULL value indicates to not draw joins.
       \param join_chunks which chunks to take from join_data to draw the joins
@@ -464,7 +983,8 @@ namespace fastuidraw
     stroke_path(const PainterStrokeShader &shader, const PainterData &draw,
                 const PainterAttributeData *edge_data, const_c_array<unsigned int> edge_chunks,
                 unsigned int inc_edge,
-                const PainterAttributeData *cap_data, unsigned int cap_chunk,
+                const PainterAttributeData *cap_data, const_c_array<unsigned int> cap_chunks,
+                unsigned int inc_cap,
                 const PainterAttributeData *join_data, const_c_array<unsigned int> join_chunks,
                 unsigned int inc_join, bool with_anti_aliasing,
                 const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
@@ -546,6 +1066,44 @@ namespace fastuidraw
                             bool with_anti_aliasing,
                             const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
 
+    /*!
+      Stroke a HairlinePath with anti-aliasing. If the PainterBackend
+      supports instanced quads (see
+      PainterBackend::PerformanceHints::instanced_quads()), the
+      segments are drawn directly with instance_shader, one attribute
+      per segment; otherwise (or while recording()) each segment is
+      expanded to four attributes and six indices and drawn with
+      quad_shader.
+      \param instance_shader shader with which to draw the segments as
+                             instances, for example default_shaders().hairline_instance_shader()
+      \param quad_shader shader with which to draw the expanded segments,
+                         for example default_shaders().hairline_shader()
+      \param draw data for how to draw, the item shader data must be
+                  a PainterStrokeParams whose width is in pixels
+      \param path HairlinePath to stroke
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_hairline(const reference_counted_ptr<PainterItemShader> &instance_shader,
+                  const reference_counted_ptr<PainterItemShader> &quad_shader,
+                  const PainterData &draw, const HairlinePath &path,
+                  const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Stroke a HairlinePath with the default hairline shaders,
+      default_shaders().hairline_instance_shader() and
+      default_shaders().hairline_shader().
+      \param draw data for how to draw, the item shader data must be
+                  a PainterStrokeParams whose width is in pixels
+      \param path HairlinePath to stroke
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_hairline(const PainterData &draw, const HairlinePath &path,
+                  const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
     /*!
       Stroke a path dashed.
       \param shader shader with which to draw
@@ -556,7 +1114,8 @@ namespace fastuidraw
       \param inc_edge amount by which to increment current_z() for the edge drawing
       \param cap_data attribute and index data for drawing the caps,
                       NULL value indicates to not draw caps.
-      \param cap_chunk which chunk to take from cap_data
+      \param cap_chunks which chunks to take from cap_data
+      \param inc_cap amount by which to increment current_z() for the cap drawing
       \param include_joins_from_closing_edge if false, disclude the joins formed
                                              from the closing edges of each contour
       \param dash_evaluator DashEvaluatorBase object to determine which joins
@@ -571,7 +1130,8 @@ namespace fastuidraw
     stroke_dashed_path(const PainterStrokeShader &shader, const PainterData &draw,
                        const PainterAttributeData *edge_data, const_c_array<unsigned int> edge_chunks,
                        unsigned int inc_edge,
-                       const PainterAttributeData *cap_data, unsigned int cap_chunk,
+                       const PainterAttributeData *cap_data, const_c_array<unsigned int> cap_chunks,
+                       unsigned int inc_cap,
                        bool include_joins_from_closing_edge,
                        const DashEvaluatorBase *dash_evaluator, const PainterAttributeData *join_data,
                        bool with_anti_aliasing,
@@ -823,6 +1383,157 @@ namespace fastuidraw
     draw_rect(const PainterData &draw, const vec2 &p, const vec2 &wh,
               const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
 
+    /*!
+      Draw many quads using a custom shader with the same PainterData.
+      The quads are clipped and culled individually as by draw_quad(),
+      but their attributes and indices are written in one pass and
+      drawn with a single draw_generic() call, i.e. with a single
+      header and state upload.
+      \param shader shader with which to draw the quads. The shader must
+                    accept the exact same format as packed by
+                    PainterAttributeDataFillerPathFill
+      \param draw data for how to draw
+      \param pts points of the quads, the points of the quad I are
+                 pts[4 * I], pts[4 * I + 1], pts[4 * I + 2], pts[4 * I + 3]
+                 as the points p0, p1, p2, p3 of draw_quad()
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_quads(const reference_counted_ptr<PainterItemShader> &shader, const PainterData &draw,
+               const_c_array<vec2> pts,
+               const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw many quads using the default fill shader, see
+      draw_quads(const reference_counted_ptr<PainterItemShader>&, const PainterData&,
+                 const_c_array<vec2>, const reference_counted_ptr<PainterPacker::DataCallBack>&).
+      \param draw data for how to draw
+      \param pts points of the quads, 4 for each quad
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_quads(const PainterData &draw, const_c_array<vec2> pts,
+               const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw many rects using a custom shader with the same PainterData,
+      see draw_quads().
+      \param shader shader with which to draw the rects. The shader must
+                    accept the exact same format as packed by
+                    PainterAttributeDataFillerPathFill
+      \param draw data for how to draw
+      \param p min-corners of the rects
+      \param wh width and height of the rects, must be the same size as p
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_rects(const reference_counted_ptr<PainterItemShader> &shader, const PainterData &draw,
+               const_c_array<vec2> p, const_c_array<vec2> wh,
+               const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw many rects using the default fill shader with the same
+      PainterData, see draw_quads().
+      \param draw data for how to draw
+      \param p min-corners of the rects
+      \param wh width and height of the rects, must be the same size as p
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_rects(const PainterData &draw, const_c_array<vec2> p, const_c_array<vec2> wh,
+               const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw an anti-aliased rounded rect as a single quad whose
+      coverage is computed in closed form by the shader, i.e. without
+      building, tessellating and filling a Path. The quad is drawn
+      with four attributes and six indices, the values of the rect
+      are in the attributes so that rounded rects drawn with the
+      same PainterData are packed into the same PainterDraw.
+      \param shader shader with which to draw the rounded rect,
+                    for example default_shaders().rounded_rect_shader()
+      \param draw data for how to draw
+      \param p min-corner of rect
+      \param wh width and height of rect
+      \param corner_radius radius of the corners of the rect, clamped
+                           to [0, min(wh.x(), wh.y()) / 2]
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_rounded_rect(const reference_counted_ptr<PainterItemShader> &shader,
+                      const PainterData &draw, const vec2 &p, const vec2 &wh,
+                      float corner_radius,
+                      const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw an anti-aliased rounded rect with the default rounded rect
+      shader, default_shaders().rounded_rect_shader().
+      \param draw data for how to draw
+      \param p min-corner of rect
+      \param wh width and height of rect
+      \param corner_radius radius of the corners of the rect, clamped
+                           to [0, min(wh.x(), wh.y()) / 2]
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_rounded_rect(const PainterData &draw, const vec2 &p, const vec2 &wh,
+                      float corner_radius,
+                      const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw the shadow of a rounded rect blurred by a Gaussian, as a
+      single quad which extends three standard deviations beyond the
+      rect. The shader computes the blurred coverage in closed form
+      along one axis and with a fixed number of samples along the
+      other, so the cost per pixel does not depend on the blur and
+      no offscreen rendering is needed. The shadow is colored by the
+      brush of draw; to offset or spread a shadow, offset or enlarge
+      the rect. If blur_sigma is not positive, draws the same as
+      draw_rounded_rect().
+      \param shader shader with which to draw the shadow,
+                    for example default_shaders().box_shadow_shader()
+      \param draw data for how to draw
+      \param p min-corner of rect
+      \param wh width and height of rect
+      \param corner_radius radius of the corners of the rect, clamped
+                           to [0, min(wh.x(), wh.y()) / 2]
+      \param blur_sigma standard deviation of the blur in local
+                        coordinates, i.e. half the blur radius
+                        of a CSS box-shadow
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_box_shadow(const reference_counted_ptr<PainterItemShader> &shader,
+                    const PainterData &draw, const vec2 &p, const vec2 &wh,
+                    float corner_radius, float blur_sigma,
+                    const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw the shadow of a rounded rect with the default box shadow
+      shader, default_shaders().box_shadow_shader(), see
+      draw_box_shadow(const reference_counted_ptr<PainterItemShader>&,
+                      const PainterData&, const vec2&, const vec2&, float, float,
+                      const reference_counted_ptr<PainterPacker::DataCallBack>&).
+      \param draw data for how to draw
+      \param p min-corner of rect
+      \param wh width and height of rect
+      \param corner_radius radius of the corners of the rect
+      \param blur_sigma standard deviation of the blur in local coordinates
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_box_shadow(const PainterData &draw, const vec2 &p, const vec2 &wh,
+                    float corner_radius, float blur_sigma,
+                    const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
     /*!
       Draw generic attribute data.
       \param draw data for how to draw
@@ -882,9 +1593,301 @@ namespace fastuidraw
                  const_c_array<unsigned int> attrib_chunk_selector,
                  const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
 
+    /*!
+      Draw generic attribute data written by a PainterPacker::DataWriter
+      directly into the buffers of the PainterBackend, see
+      PainterPacker::draw_generic(const reference_counted_ptr<PainterItemShader>&,
+      const PainterPackerData&, unsigned int, unsigned int,
+      const PainterPacker::DataWriter&, unsigned int, const reference_counted_ptr<PainterPacker::DataCallBack>&).
+      When recording to a PainterPackerStream, the data is written
+      to a temporary array that is then recorded.
+      \param shader shader with which to draw data
+      \param draw data for how to draw
+      \param number_attributes number of attributes of the draw
+      \param number_indices number of indices of the draw
+      \param writer writes the attributes and indices of the draw
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_generic(const reference_counted_ptr<PainterItemShader> &shader,
+                 const PainterData &draw,
+                 unsigned int number_attributes,
+                 unsigned int number_indices,
+                 const PainterPacker::DataWriter &writer,
+                 const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Copy a PainterAttributeData to memory of the PainterBackend
+      for drawing with draw_static(), see
+      PainterPacker::create_static_attribute_data(). Returns NULL
+      if static attribute data is not supported by the backend or
+      if the backend memory for it is exhausted, in which case the
+      PainterAttributeData should be drawn with draw_generic().
+      \param data PainterAttributeData to copy
+      \param attrib_chunk_selector selects which attribute chunk to use
+                                   for each index chunk
+      \param layout which fields of the attributes to copy, see
+                    PainterAttribute::layout_t
+     */
+    reference_counted_ptr<const PainterStaticAttributeData>
+    create_static_attribute_data(const PainterAttributeData &data,
+                                 const_c_array<unsigned int> attrib_chunk_selector = const_c_array<unsigned int>(),
+                                 enum PainterAttribute::layout_t layout = PainterAttribute::layout_full);
+
+    /*!
+      Draw chunks of a PainterStaticAttributeData, see
+      PainterPacker::draw_static(). Static attribute data cannot be
+      recorded to a PainterPackerStream, and so must not be called
+      while recording().
+      \param shader shader with which to draw data
+      \param draw data for how to draw
+      \param static_data PainterStaticAttributeData created with
+                         create_static_attribute_data() of this Painter
+      \param chunks which chunks of static_data to draw
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_static(const reference_counted_ptr<PainterItemShader> &shader,
+                const PainterData &draw,
+                const reference_counted_ptr<const PainterStaticAttributeData> &static_data,
+                const_c_array<unsigned int> chunks,
+                const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw chunks of a PainterStaticAttributeData once for each
+      element of matrices, see PainterPacker::draw_static_instances().
+      The instance i is drawn with the transformation
+      transformation() * matrices[i] and, if colors is non-empty,
+      with the brush of draw whose pen color is colors[i]. The
+      attribute data is referenced once for all the instances.
+      All instances share the same z-value. As with draw_static(),
+      must not be called while recording().
+      \param shader shader with which to draw data
+      \param draw data for how to draw
+      \param static_data PainterStaticAttributeData created with
+                         create_static_attribute_data() of this Painter
+      \param chunks which chunks of static_data to draw
+      \param matrices transformation of each instance, relative to transformation()
+      \param colors if non-empty, pen color of each instance, must then be
+                    the same size as matrices and draw must have a brush
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_static_instances(const reference_counted_ptr<PainterItemShader> &shader,
+                          const PainterData &draw,
+                          const reference_counted_ptr<const PainterStaticAttributeData> &static_data,
+                          const_c_array<unsigned int> chunks,
+                          const_c_array<float3x3> matrices,
+                          const_c_array<vec4> colors = const_c_array<vec4>(),
+                          const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw chunks of a PainterAttributeData once for each element
+      of matrices with the same transformations and colors as
+      draw_static_instances(). Unlike draw_static_instances(),
+      the attribute data is streamed for each instance; this
+      is the fallback for when create_static_attribute_data()
+      returns NULL or when recording().
+      \param shader shader with which to draw data
+      \param draw data for how to draw
+      \param data attribute data to draw
+      \param chunks which chunks of data to draw
+      \param matrices transformation of each instance, relative to transformation()
+      \param colors if non-empty, pen color of each instance, must then be
+                    the same size as matrices and draw must have a brush
+      \param call_back if non-NULL handle, call back called when attribute data
+                       is added.
+     */
+    void
+    draw_generic_instances(const reference_counted_ptr<PainterItemShader> &shader,
+                           const PainterData &draw,
+                           const PainterAttributeData &data,
+                           const_c_array<unsigned int> chunks,
+                           const_c_array<float3x3> matrices,
+                           const_c_array<vec4> colors = const_c_array<vec4>(),
+                           const reference_counted_ptr<PainterPacker::DataCallBack> &call_back = reference_counted_ptr<PainterPacker::DataCallBack>());
+
+    /*!
+      Draw the commands recorded in a PainterPackerStream (see
+      PainterPacker::draw_stream()). The z-values of the stream
+      are offset by current_z() and current_z() is incremented by
+      PainterPackerStream::z_range(). If the current clipping state
+      culls all content or if the bounding box of the stream
+      misses the damage region (see damage_region()), the stream
+      is not drawn, but current_z() is still incremented. The
+      damage of the stream is added to stream_damage(). Must not
+      be called while recording().
+      \param stream stream of commands to draw
+      \param use_current_state if false, the commands use the clipping
+                               and transformation recorded in the stream.
+                               If true, the commands use the current
+                               clipping of the Painter and the current
+                               transformation is applied to the stream,
+                               see PainterPackerStream::base_transformation().
+     */
+    void
+    draw_stream(const PainterPackerStream &stream, bool use_current_state = false);
+
+    /*!
+      Set the window within which draw_stream() may reorder the
+      draws of a stream to reduce state changes, see
+      PainterPacker::stream_reorder_window(). The Painter records
+      the bounding box of each fill, glyph run and polygon drawn
+      while recording(), so those draws can be reordered; other
+      draws keep their place.
+      \param v number of draws of the window
+     */
+    void
+    stream_reorder_window(unsigned int v);
+
+    /*!
+      Returns the value set by stream_reorder_window(unsigned int).
+     */
+    unsigned int
+    stream_reorder_window(void) const;
+
+    /*!
+      Set the number of attributes after which the draws
+      accumulated so far are sent to the backend before the
+      next draw, see PainterPacker::early_flush_attributes().
+      \param v number of attributes, 0 to not flush early on attributes
+     */
+    void
+    early_flush_attributes(unsigned int v);
+
+    /*!
+      Returns the value set by early_flush_attributes(unsigned int).
+     */
+    unsigned int
+    early_flush_attributes(void) const;
+
+    /*!
+      Set the number of indices after which the draws
+      accumulated so far are sent to the backend before the
+      next draw, see PainterPacker::early_flush_indices().
+      \param v number of indices, 0 to not flush early on indices
+     */
+    void
+    early_flush_indices(unsigned int v);
+
+    /*!
+      Returns the value set by early_flush_indices(unsigned int).
+     */
+    unsigned int
+    early_flush_indices(void) const;
+
+    /*!
+      Reserve the capacities of a Budget so that
+      the frames that stay within them do not allocate
+      memory in the Painter and its PainterPacker; the
+      count of the frame allocations that went beyond
+      what is reserved is given by query_stat() with
+      PainterPacker::num_unbudgeted_allocations. The
+      capacities reserved are kept; the containers
+      also keep the capacity of the largest frame, so
+      once warm the frames like those already drawn do
+      not allocate.
+      \param budget capacities to reserve
+     */
+    void
+    reserve(const Budget &budget);
+
+    /*!
+      Set if draw_stream() skips the draws of a stream that are
+      completely covered by an opaque draw recorded after them,
+      see PainterPacker::stream_occlusion_culling(). The Painter
+      marks as opaque the rects and quads drawn while recording()
+      with the default fill shader, an opaque pen color without
+      image or gradient, blend mode blend_porter_duff_src or
+      blend_porter_duff_src_over, no clipping by a path and which
+      stay axis aligned in the coordinates of
+      PainterPackerStream::base_transformation() and inside of
+      the clipping rect.
+      \param v value to use
+     */
+    void
+    stream_occlusion_culling(bool v);
+
+    /*!
+      Returns the value set by stream_occlusion_culling(bool).
+     */
+    bool
+    stream_occlusion_culling(void) const;
+
+    /*!
+      Start recording the draws of this Painter into a
+      PainterPackerStream instead of sending them to the
+      PainterPacker. The stream is cleared and its
+      PainterPackerStream::base_transformation() is set to the
+      current transformation. The recorded stream can then be
+      drawn any number of times with draw_stream(), for example
+      to retain the draws of a part of a UI that does not change
+      from frame to frame. The PainterPacker::DataCallBack objects
+      passed to draw calls are ignored while recording. Clipping
+      operations made while recording only affect the recorded
+      draws when the stream is drawn with use_current_state as
+      false. While recording, the Painter sets the bounding box
+      of the stream (see PainterPackerStream::bounding_box()) from
+      the bounding boxes of the fills, glyphs and polygons drawn;
+      recording any other draw makes the bounding box unknown.
+      Must be called within a begin()/end() pair and the
+      recording must end before end() is called.
+      \param stream stream to which to record
+     */
+    void
+    begin_recording(const reference_counted_ptr<PainterPackerStream> &stream);
+
+    /*!
+      End recording started by begin_recording() and return the
+      stream to which the draws were recorded. The value of
+      current_z() is restored to its value at begin_recording(),
+      as nothing was drawn.
+     */
+    reference_counted_ptr<PainterPackerStream>
+    end_recording(void);
+
+    /*!
+      Returns true if within a begin_recording()/end_recording() pair.
+     */
+    bool
+    recording(void) const;
+
+    /*!
+      Returns the alignment, in units of generic_data (i.e. 32-bit
+      words), of the data of the PainterBackend of this Painter, i.e.
+      the alignment to pass to the ctor of a PainterPackerStream to
+      be passed to begin_recording().
+     */
+    int
+    alignment(void) const;
+
+    /*!
+      Set the PainterTraceRecorder to which to record the calls to
+      this Painter, see PainterTraceRecorder for what is recorded. A
+      frame is recorded from begin() to end(), so the recorder should
+      be set outside of a begin()/end() pair.
+      \param recorder PainterTraceRecorder to record to, a NULL value
+                      indicates to stop recording
+     */
+    void
+    trace(const reference_counted_ptr<PainterTraceRecorder> &recorder);
+
+    /*!
+      Returns the value set by trace(const reference_counted_ptr<PainterTraceRecorder>&).
+     */
+    const reference_counted_ptr<PainterTraceRecorder>&
+    trace(void) const;
+
     /*!
       Returns a stat on how much data the Packer has
-      handled since the last call to begin().
+      handled since the last call to begin(), including
+      the stats that only the Painter tracks, such as
+      PainterPacker::num_filled_path_subsets_selected. The
+      stats fed by the PainterBackend are complete only after
+      end().
       \param st stat to query
      */
     unsigned int
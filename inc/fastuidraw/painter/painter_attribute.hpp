@@ -36,6 +36,53 @@ namespace fastuidraw
   class PainterAttribute
   {
   public:
+    /*!
+      Enumeration to specify which fields of a PainterAttribute
+      are stored when the attribute data is held by a
+      PainterStaticAttributeData. A shader that reads only
+      m_attrib0 (for example the shader of non-anti-aliased
+      fills, which reads only the position from m_attrib0)
+      or only m_attrib0 and m_attrib1 can be drawn from static
+      data with a compact layout, which takes a third or two
+      thirds of the memory and bandwidth of the full layout.
+      The fields that are not stored are read as zero by the
+      shader.
+     */
+    enum layout_t
+      {
+        /*!
+          all of m_attrib0, m_attrib1 and m_attrib2
+          are stored, 48 bytes per attribute
+         */
+        layout_full,
+
+        /*!
+          m_attrib0 and m_attrib1 are stored, 32
+          bytes per attribute
+         */
+        layout_attrib0_attrib1,
+
+        /*!
+          only m_attrib0 is stored, 16 bytes per
+          attribute
+         */
+        layout_attrib0,
+
+        number_layouts
+      };
+
+    /*!
+      Returns the number of uvec4 values stored for
+      each attribute for a layout.
+      \param v layout to query
+     */
+    static
+    unsigned int
+    number_uvec4s(enum layout_t v)
+    {
+      return 3u - static_cast<unsigned int>(v);
+    }
+
     /*!
       Generic attribute data
      */
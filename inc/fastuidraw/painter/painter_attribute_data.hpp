@@ -25,6 +25,29 @@
 
 namespace fastuidraw
 {
+  class PainterAttributeData;
+
+///@cond
+  namespace detail
+  {
+    class BlobWriter;
+    class BlobReader;
+
+    void
+    write_painter_attribute_data(BlobWriter &dst, const PainterAttributeData &data);
+
+    bool
+    read_painter_attribute_data(BlobReader &src, PainterAttributeData &dst);
+
+    void
+    set_painter_attribute_data_chunks(PainterAttributeData &dst,
+                                      const_c_array<PainterAttribute> attribute_store,
+                                      const_c_array<PainterIndex> index_store,
+                                      const_c_array<const_c_array<PainterAttribute> > attribute_chunks,
+                                      const_c_array<const_c_array<PainterIndex> > index_chunks);
+  }
+///@endcond
+
 /*!\addtogroup Painter
   @{
  */
@@ -42,8 +65,33 @@ namespace fastuidraw
      */
     PainterAttributeData(void);
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+    /*!
+      Move ctor, takes the data of obj without copying
+      it; obj is then empty.
+      \param obj value from which to take data
+     */
+    PainterAttributeData(PainterAttributeData &&obj) noexcept;
+
+    /*!
+      Move assignment operator, swaps the data of
+      this PainterAttributeData with that of obj.
+      \param obj value from which to take data
+     */
+    PainterAttributeData&
+    operator=(PainterAttributeData &&obj) noexcept;
+#endif
+
     ~PainterAttributeData();
 
+    /*!
+      Swap the data of this PainterAttributeData
+      with that of another PainterAttributeData.
+      \param obj PainterAttributeData with which to swap
+     */
+    void
+    swap(PainterAttributeData &obj);
+
     /*!
       Set the index, attribute, z-increment and chunk
       data of this PainterAttributeData using a
@@ -53,6 +101,22 @@ namespace fastuidraw
     void
     set_data(const PainterAttributeDataFiller &filler);
 
+    /*!
+      Set the index, attribute, z-increment and chunk
+      data of this PainterAttributeData using a
+      PainterAttributeDataFiller, running the jobs
+      of PainterAttributeDataFiller::number_fill_jobs()
+      on up to max_threads threads.
+      \param filler object that fills the data.
+      \param max_threads maximum number of threads with
+                         which to fill, a value of 0
+                         indicates to use the number of
+                         threads of default_task_executor()
+     */
+    void
+    set_data(const PainterAttributeDataFiller &filler,
+             unsigned int max_threads);
+
     /*!
       Returns the attribute data chunks. Usually, for each
       attribute data chunk, there is a matching index data
@@ -132,7 +196,25 @@ namespace fastuidraw
     unsigned int
     increment_z_value(unsigned int i) const;
 
+    /*!
+      Returns the number of bytes of the attribute and
+      index data owned by this PainterAttributeData; data
+      used in place from a blob is not counted.
+     */
+    unsigned int
+    number_bytes(void) const;
+
   private:
+    friend void detail::write_painter_attribute_data(detail::BlobWriter&,
+                                                     const PainterAttributeData&);
+    friend bool detail::read_painter_attribute_data(detail::BlobReader&,
+                                                    PainterAttributeData&);
+    friend void detail::set_painter_attribute_data_chunks(PainterAttributeData&,
+                                                          const_c_array<PainterAttribute>,
+                                                          const_c_array<PainterIndex>,
+                                                          const_c_array<const_c_array<PainterAttribute> >,
+                                                          const_c_array<const_c_array<PainterIndex> >);
+
     void *m_d;
   };
 /*! @} */
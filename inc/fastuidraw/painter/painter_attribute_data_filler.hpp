@@ -31,7 +31,15 @@ namespace fastuidraw
 
   /*!
     A PainterAttributeDataFiller is the interfaceto fill the
-    data held by a \ref PainterAttributeData
+    data held by a \ref PainterAttributeData. The sizes given
+    by compute_sizes() are used to allocate the arrays once
+    before filling, so a PainterAttributeDataFiller should
+    compute them from data it already holds (for example
+    from counts made when it was constructed) instead of
+    walking its input an additional time. In addition, a
+    PainterAttributeDataFiller can split the filling into
+    independent jobs (see number_fill_jobs()) which
+    PainterAttributeData::set_data() can run concurrently.
    */
   class PainterAttributeDataFiller:noncopyable
   {
@@ -66,6 +74,9 @@ namespace fastuidraw
 
     /*!
       To be implemented by a derived class to fill data.
+      If number_fill_jobs() is non-zero, fill_data() is
+      called after all of the jobs have been run and is
+      to only fill the data that the jobs do not fill.
       \param attributes location to which to place attributes
       \param indices location to which to place indices
       \param attrib_chunks location to which to fill attribute chunks;
@@ -89,6 +100,50 @@ namespace fastuidraw
               c_array<const_c_array<PainterIndex> > index_chunks,
               c_array<unsigned int> zincrements,
               c_array<int> index_adjusts) const = 0;
+
+    /*!
+      To be optionally implemented by a derived class to
+      return the number of independent jobs of filling.
+      Each job must write to parts of the arrays that no
+      other job reads or writes to so that the jobs can
+      run concurrently and in any order. Default
+      implementation returns 0, i.e. all data is filled
+      by fill_data().
+     */
+    virtual
+    unsigned int
+    number_fill_jobs(void) const
+    {
+      return 0;
+    }
+
+    /*!
+      To be implemented by a derived class whose
+      number_fill_jobs() returns non-zero to run a job
+      of filling. The arrays passed are the same as
+      those passed to fill_data(). Default implementation
+      does nothing.
+      \param job which job to run, in the range
+                 [0, number_fill_jobs())
+     */
+    virtual
+    void
+    fill_job(unsigned int job,
+             c_array<PainterAttribute> attributes,
+             c_array<PainterIndex> indices,
+             c_array<const_c_array<PainterAttribute> > attrib_chunks,
+             c_array<const_c_array<PainterIndex> > index_chunks,
+             c_array<unsigned int> zincrements,
+             c_array<int> index_adjusts) const
+    {
+      FASTUIDRAWunused(job);
+      FASTUIDRAWunused(attributes);
+      FASTUIDRAWunused(indices);
+      FASTUIDRAWunused(attrib_chunks);
+      FASTUIDRAWunused(index_chunks);
+      FASTUIDRAWunused(zincrements);
+      FASTUIDRAWunused(index_adjusts);
+    }
   };
 /*! @} */
 }
@@ -36,7 +36,13 @@ namespace fastuidraw
     The enumeration glyph_type provide the indices into
     PainterAttributeData::attribute_data_chunks() and
     PainterAttributeData::index_data_chunks() for the different
-    glyph types. If a glyph is not uploaded to its GlyphCache and
+    glyph types. If glyphs_per_chunk() is non-zero, the glyphs
+    are also split into blocks of that many consecutive glyphs
+    and the chunk of a glyph is given by chunk_index() from the
+    glyph type and the block of the glyph; Painter::draw_glyphs()
+    culls each chunk against the clipping, so that drawing a long
+    glyph run of which only a small part is visible only draws
+    the blocks of that part. If a glyph is not uploaded to its GlyphCache and
     failed to be uploaded to its GlyphCache, then filling will
     only fill the PainterAttrributeData to the last glyph that
     successfully uploaded to its GlyphCache. That value can be
@@ -52,6 +58,18 @@ namespace fastuidraw
       - PainterAttribute::m_attrib2 .y -> glyph offset (uint)
       - PainterAttribute::m_attrib2 .z -> layer in primary atlas (uint)
       - PainterAttribute::m_attrib2 .w -> layer in secondary atlas (uint)
+
+    If instanced() is true, each glyph is instead a single attribute,
+    to be drawn with Painter::draw_glyph_instances(), and the index
+    chunks are empty. Such an instance is packed as follows:
+      - PainterAttribute::m_attrib0 .xy   -> xy-texel location of bottom left in primary atlas (float)
+      - PainterAttribute::m_attrib0 .zw   -> xy-texel location of bottom left in secondary atlas (float)
+      - PainterAttribute::m_attrib1 .xy -> bottom left position in item coordinates (float)
+      - PainterAttribute::m_attrib1 .zw -> top right position in item coordinates (float)
+      - PainterAttribute::m_attrib2 .x -> texel size, x in low 16 bits, y in high 16 bits (uint)
+      - PainterAttribute::m_attrib2 .y -> glyph offset (uint)
+      - PainterAttribute::m_attrib2 .z -> layer in primary atlas (uint)
+      - PainterAttribute::m_attrib2 .w -> layer in secondary atlas (uint)
    */
   class PainterAttributeDataFillerGlyphs:public PainterAttributeDataFiller
   {
@@ -118,6 +136,78 @@ namespace fastuidraw
     unsigned int
     number_glyphs(void) const;
 
+    /*!
+      If true, fill one attribute per glyph (an instance)
+      and no indices, see Painter::draw_glyph_instances();
+      otherwise fill four attributes and six indices per glyph,
+      see Painter::draw_glyphs().
+     */
+    bool
+    instanced(void) const;
+
+    /*!
+      Set the value returned by instanced(void) const,
+      default value is false.
+      \param v value
+     */
+    PainterAttributeDataFillerGlyphs&
+    instanced(bool v);
+
+    /*!
+      If non-zero, the glyphs are split into blocks of
+      glyphs_per_chunk() consecutive glyphs (for example
+      a block per line of text) and each block has its own
+      chunks, see chunk_index(). If zero, there is one chunk
+      per glyph type, i.e. the chunk of a glyph is its type.
+     */
+    unsigned int
+    glyphs_per_chunk(void) const;
+
+    /*!
+      Set the value returned by glyphs_per_chunk(void) const,
+      default value is 0.
+      \param v value
+     */
+    PainterAttributeDataFillerGlyphs&
+    glyphs_per_chunk(unsigned int v);
+
+    enum
+      {
+        /*!
+          Number of chunks of each block of glyphs, see
+          chunk_index(); this is one more than the
+          largest glyph type.
+         */
+        chunks_per_block = msdf_glyph + 1
+      };
+
+    /*!
+      Returns the index of the chunk holding the glyphs
+      of a glyph type of a block of glyphs; for
+      glyphs_per_chunk() zero, the only block is 0.
+      \param tp glyph type
+      \param block block of glyphs
+     */
+    static
+    unsigned int
+    chunk_index(enum glyph_type tp, unsigned int block)
+    {
+      assert(tp < chunks_per_block);
+      return block * chunks_per_block + tp;
+    }
+
+    /*!
+      Returns the glyph type of the glyphs of a chunk,
+      i.e. the inverse of chunk_index().
+      \param chunk chunk index
+     */
+    static
+    enum glyph_type
+    chunk_glyph_type(unsigned int chunk)
+    {
+      return static_cast<enum glyph_type>(chunk % chunks_per_block);
+    }
+
     virtual
     void
     compute_sizes(unsigned int &number_attributes,
@@ -127,6 +127,41 @@ namespace fastuidraw
           Bit up is translation is present
          */
         transformation_matrix_bit,
+
+        /*!
+          Bit up if an image is present and the image
+          has more than one mipmap level, see
+          Image::number_mipmap_levels()
+         */
+        image_mipmap_bit,
+
+        /*!
+          Bit up if an image is present and the image
+          is a bindless texture, see Image::bindless_handle()
+         */
+        image_bindless_bit,
+
+        /*!
+          Bit up if an image is present and the image is
+          a bindless texture that is an external texture,
+          see Image::bindless_external_texture()
+         */
+        image_external_texture_bit,
+
+        /*!
+          Bit up if an image is present and the texels
+          of the image are pre-multiplied by alpha, see
+          Image::premultiplied_alpha()
+         */
+        image_premultiplied_alpha_bit,
+
+        /*!
+          Bit up if a gradient is present and its color
+          stops are packed directly into the brush data
+          (see \ref gradient_inline_color_stops_offset_t)
+          instead of read from a ColorStopAtlas
+         */
+        gradient_inline_color_stops_bit,
       };
 
     /*!
@@ -177,6 +212,39 @@ namespace fastuidraw
           bit mask for if matrix is used in brush
          */
         transformation_matrix_mask = FASTUIDRAW_MASK(transformation_matrix_bit, 1),
+
+        /*!
+          bit mask for if the image of the brush is mipmapped
+          (only up if image_mask is also non-zero)
+         */
+        image_mipmap_mask = FASTUIDRAW_MASK(image_mipmap_bit, 1),
+
+        /*!
+          bit mask for if the image of the brush is a bindless
+          texture (only up if image_mask is also non-zero)
+         */
+        image_bindless_mask = FASTUIDRAW_MASK(image_bindless_bit, 1),
+
+        /*!
+          bit mask for if the image of the brush is a bindless
+          external texture (only up if image_bindless_mask is
+          also up)
+         */
+        image_external_texture_mask = FASTUIDRAW_MASK(image_external_texture_bit, 1),
+
+        /*!
+          bit mask for if the texels of the image of the brush
+          are pre-multiplied by alpha (only up if image_mask is
+          also non-zero)
+         */
+        image_premultiplied_alpha_mask = FASTUIDRAW_MASK(image_premultiplied_alpha_bit, 1),
+
+        /*!
+          bit mask for if the color stops of the gradient
+          are packed directly into the brush data (only up
+          if gradient_mask is also up)
+         */
+        gradient_inline_color_stops_mask = FASTUIDRAW_MASK(gradient_inline_color_stops_bit, 1),
       };
 
     /*!
@@ -200,6 +268,21 @@ namespace fastuidraw
          */
         image_packing,
 
+        /*!
+          image mipmap packing, only present if the
+          image is mipmapped, see \ref image_mipmap_offset_t
+          for the offsets for the individual fields
+         */
+        image_mipmap_packing,
+
+        /*!
+          image bindless packing, only present if the
+          image is a bindless texture, see \ref
+          image_bindless_offset_t for the offsets for the
+          individual fields
+         */
+        image_bindless_packing,
+
         /*!
           gradient packing, see \ref gradient_offset_t
           for the offsets from the start of gradient packing
@@ -207,6 +290,15 @@ namespace fastuidraw
          */
         gradient_packing,
 
+        /*!
+          inline color stop packing, only present if
+          the color stops of the gradient are packed
+          directly into the brush, see \ref
+          gradient_inline_color_stops_offset_t for the
+          offsets for the individual fields
+         */
+        gradient_inline_color_stops_packing,
+
         /*!
           repeat window packing, see \ref
           repeat_window_offset_t for the offsets
@@ -355,6 +447,66 @@ namespace fastuidraw
         image_data_size
       };
 
+    /*!
+      Offsets for the mipmap data of an image, packed
+      only if shader() & \ref image_mipmap_mask is non-zero.
+      The shader derives the location of each mipmap level
+      from Image::dimensions() as according to
+      Image::mipmap_level_location().
+     */
+    enum image_mipmap_offset_t
+      {
+        /*!
+          Width and height of the entire image (Image::dimensions())
+          encoded in a single uint32. The bits are packed as according
+          to image_size_encoding
+         */
+        image_mipmap_dimensions_xy_offset,
+
+        /*!
+          Number of mipmap levels of the image
+          (Image::number_mipmap_levels()) packed as a uint32
+         */
+        image_mipmap_number_levels_offset,
+
+        /*!
+          Number of elements packed for image mipmap
+          support for a brush.
+         */
+        image_mipmap_data_size
+      };
+
+    /*!
+      Offsets for the bindless handle of an image, packed
+      only if shader() & \ref image_bindless_mask is non-zero.
+     */
+    enum image_bindless_offset_t
+      {
+        /*!
+          Low 32 bits of Image::bindless_handle() packed as a uint32
+         */
+        image_bindless_handle_low_offset,
+
+        /*!
+          High 32 bits of Image::bindless_handle() packed as a uint32
+         */
+        image_bindless_handle_high_offset,
+
+        /*!
+          Image::dimensions() of the image packed as
+          according to \ref image_size_x_bit0, \ref
+          image_size_x_num_bits, \ref image_size_y_bit0
+          and \ref image_size_y_num_bits
+         */
+        image_bindless_texture_size_xy_offset,
+
+        /*!
+          Number of elements packed for image bindless
+          support for a brush.
+         */
+        image_bindless_data_size
+      };
+
     /*!
       Bit encoding for packing ColorStopSequenceOnAtlas::texel_location()
      */
@@ -433,6 +585,50 @@ namespace fastuidraw
         radial_gradient_data_size
       };
 
+    enum
+      {
+        /*!
+          Maximum number of color stops that can be
+          packed directly into the brush data, see
+          \ref gradient_inline_color_stops_offset_t
+         */
+        max_inline_color_stops = 4
+      };
+
+    /*!
+      Enumeration that provides offset from the start of
+      inline color stop packing to the color stops of a gradient
+      whose color stops are packed directly into the brush.
+      The color stops are sorted by ColorStop::m_place. Each
+      color is packed as a uint32_t with red in bits [0, 8),
+      green in bits [8, 16), blue in bits [16, 24) and alpha
+      in bits [24, 32).
+     */
+    enum gradient_inline_color_stops_offset_t
+      {
+        /*!
+          Offset to the number of color stops (packed as uint)
+         */
+        gradient_inline_color_stops_count_offset,
+
+        /*!
+          Offset to the first of the \ref max_inline_color_stops
+          ColorStop::m_place values (packed as float)
+         */
+        gradient_inline_color_stops_place_offset,
+
+        /*!
+          Offset to the first of the \ref max_inline_color_stops
+          ColorStop::m_color values (packed as uint)
+         */
+        gradient_inline_color_stops_color_offset = gradient_inline_color_stops_place_offset + max_inline_color_stops,
+
+        /*!
+          Size of the data for inline color stops.
+         */
+        gradient_inline_color_stops_data_size = gradient_inline_color_stops_color_offset + max_inline_color_stops
+      };
+
     /*!
       Enumeration that provides offset from the start of
       repeat window packing to data for repeat window data
@@ -517,7 +713,21 @@ namespace fastuidraw
     }
 
     /*!
-      Sets the brush to have an image.
+      Returns the color of the pen, see pen(const vec4&).
+     */
+    const vec4&
+    pen(void) const
+    {
+      return m_data.m_pen;
+    }
+
+    /*!
+      Sets the brush to have an image. If the image has more than
+      one mipmap level (see Image::number_mipmap_levels()), the
+      level from which to sample is chosen per pixel; levels past
+      the first are sampled with \ref image_filter_nearest if f is
+      \ref image_filter_nearest and with \ref image_filter_linear
+      otherwise, blending between the two closest levels.
       \param im handle to image to use. If handle is invalid,
                 then sets brush to not have an image.
       \param f filter to apply to image, only has effect if im
@@ -547,6 +757,26 @@ namespace fastuidraw
       return image(reference_counted_ptr<const Image>());
     }
 
+    /*!
+      Returns the top-left corner of the sub-rectangle of
+      the image that the brush sources from, see sub_image().
+     */
+    const uvec2&
+    sub_image_start(void) const
+    {
+      return m_data.m_image_start;
+    }
+
+    /*!
+      Returns the size of the sub-rectangle of the image
+      that the brush sources from, see sub_image().
+     */
+    const uvec2&
+    sub_image_size(void) const
+    {
+      return m_data.m_image_size;
+    }
+
     /*!
       Sets the brush to have a linear gradient.
       \param cs color stops for gradient. If handle is invalid,
@@ -561,11 +791,12 @@ namespace fastuidraw
                     const vec2 &start_p, const vec2 &end_p, bool repeat)
     {
       m_data.m_cs = cs;
+      m_data.m_number_inline_stops = 0;
       m_data.m_grad_start = start_p;
       m_data.m_grad_end = end_p;
       m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, cs, gradient_mask);
       m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, cs && repeat, gradient_repeat_mask);
-      m_data.m_shader_raw &= ~radial_gradient_mask;
+      m_data.m_shader_raw &= ~(radial_gradient_mask | gradient_inline_color_stops_mask);
       return *this;
     }
 
@@ -586,6 +817,7 @@ namespace fastuidraw
                     const vec2 &end_p, float end_r, bool repeat)
     {
       m_data.m_cs = cs;
+      m_data.m_number_inline_stops = 0;
       m_data.m_grad_start = start_p;
       m_data.m_grad_start_r = start_r;
       m_data.m_grad_end = end_p;
@@ -593,9 +825,86 @@ namespace fastuidraw
       m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, cs, gradient_mask);
       m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, cs && repeat, gradient_repeat_mask);
       m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, cs, radial_gradient_mask);
+      m_data.m_shader_raw &= ~gradient_inline_color_stops_mask;
       return *this;
     }
 
+    /*!
+      Sets the brush to have a linear gradient whose color stops
+      are packed directly into the brush data instead of being
+      read from a ColorStopAtlas. This avoids the allocation and
+      upload of a ColorStopSequenceOnAtlas and a texture fetch per
+      pixel and is intended for gradients with only a few color
+      stops. Only the first \ref max_inline_color_stops color stops
+      (after sorting) of cs are used.
+      \param cs color stops for gradient. If empty, then sets
+                brush to not have a gradient.
+      \param start_p start position of gradient
+      \param end_p end position of gradient.
+      \param repeat if true, repeats the gradient, if false then
+                    clamps the gradient
+     */
+    PainterBrush&
+    linear_gradient(const ColorStopSequence &cs,
+                    const vec2 &start_p, const vec2 &end_p, bool repeat);
+
+    /*!
+      Sets the brush to have a radial gradient whose color stops
+      are packed directly into the brush data instead of being
+      read from a ColorStopAtlas, see linear_gradient(const ColorStopSequence&,
+      const vec2&, const vec2&, bool).
+      \param cs color stops for gradient. If empty, then sets
+                brush to not have a gradient.
+      \param start_p start position of gradient
+      \param start_r starting radius of radial gradient
+      \param end_p end position of gradient.
+      \param end_r ending radius of radial gradient
+      \param repeat if true, repeats the gradient, if false then
+                    clamps the gradient
+     */
+    PainterBrush&
+    radial_gradient(const ColorStopSequence &cs,
+                    const vec2 &start_p, float start_r,
+                    const vec2 &end_p, float end_r, bool repeat);
+
+    /*!
+      Returns the start position of the gradient.
+     */
+    const vec2&
+    gradient_start(void) const
+    {
+      return m_data.m_grad_start;
+    }
+
+    /*!
+      Returns the end position of the gradient.
+     */
+    const vec2&
+    gradient_end(void) const
+    {
+      return m_data.m_grad_end;
+    }
+
+    /*!
+      Returns the start radius of the gradient, only
+      has effect if the gradient is radial.
+     */
+    float
+    gradient_start_radius(void) const
+    {
+      return m_data.m_grad_start_r;
+    }
+
+    /*!
+      Returns the end radius of the gradient, only
+      has effect if the gradient is radial.
+     */
+    float
+    gradient_end_radius(void) const
+    {
+      return m_data.m_grad_end_r;
+    }
+
     /*!
       Sets the brush to not have a gradient.
      */
@@ -603,7 +912,9 @@ namespace fastuidraw
     no_gradient(void)
     {
       m_data.m_cs = reference_counted_ptr<const ColorStopSequenceOnAtlas>();
-      m_data.m_shader_raw &= ~(gradient_mask | gradient_repeat_mask | radial_gradient_mask);
+      m_data.m_number_inline_stops = 0;
+      m_data.m_shader_raw &= ~(gradient_mask | gradient_repeat_mask
+                               | radial_gradient_mask | gradient_inline_color_stops_mask);
       return *this;
     }
 
@@ -631,6 +942,28 @@ namespace fastuidraw
       return *this;
     }
 
+    /*!
+      Returns the translation of the brush transformation,
+      only has effect if shader() & \ref transformation_translation_mask
+      is non-zero.
+     */
+    const vec2&
+    transformation_translate(void) const
+    {
+      return m_data.m_transformation_p;
+    }
+
+    /*!
+      Returns the matrix of the brush transformation, only
+      has effect if shader() & \ref transformation_matrix_mask
+      is non-zero.
+     */
+    const float2x2&
+    transformation_matrix(void) const
+    {
+      return m_data.m_transformation_matrix;
+    }
+
     /*!
       Sets the brush to have a matrix and translation in its
       transformation
@@ -690,6 +1023,26 @@ namespace fastuidraw
       return *this;
     }
 
+    /*!
+      Returns the position of the repeat window, only has
+      effect if shader() & \ref repeat_window_mask is non-zero.
+     */
+    const vec2&
+    repeat_window_position(void) const
+    {
+      return m_data.m_window_position;
+    }
+
+    /*!
+      Returns the size of the repeat window, only has effect
+      if shader() & \ref repeat_window_mask is non-zero.
+     */
+    const vec2&
+    repeat_window_size(void) const
+    {
+      return m_data.m_window_size;
+    }
+
     /*!
       Sets the brush to not have a repeat window
      */
@@ -744,12 +1097,21 @@ namespace fastuidraw
       - If shader() & \ref gradient_repeat_mask then the gradient is repeated
         instead of clamped. Note that if shader() & \ref gradient_repeat_mask
         is non-zero, then shader() & \ref gradient_mask is also non-zero.
+      - If shader() & \ref gradient_inline_color_stops_mask then the color
+        stops of the gradient are packed in the brush data instead of
+        read from a ColorStopAtlas. Note that if shader()
+        & \ref gradient_inline_color_stops_mask is non-zero, then
+        shader() & \ref gradient_mask is also non-zero.
       - If shader() & \ref repeat_window_mask is non-zero, then a repeat
         window is applied to the brush.
       - If shader() & \ref transformation_translation_mask is non-zero, then a
         translation is applied to the brush.
       - If shader() & \ref transformation_matrix_mask is non-zero, then a
         2x2 matrix is applied to the brush.
+      - If shader() & \ref image_mipmap_mask is non-zero, then the
+        image has more than one mipmap level and the level from
+        which to sample is chosen from the screen space derivatives
+        of the brush coordinates.
      */
     uint32_t
     shader(void) const;
@@ -781,6 +1143,21 @@ namespace fastuidraw
       return m_data.m_cs;
     }
 
+    /*!
+      Returns the color stops packed directly into the
+      brush data as set by linear_gradient(const ColorStopSequence&,
+      const vec2&, const vec2&, bool) or radial_gradient(const
+      ColorStopSequence&, const vec2&, float, const vec2&, float, bool).
+      The array is empty if the brush is not set to use such a
+      gradient.
+     */
+    const_c_array<ColorStop>
+    inline_color_stops(void) const
+    {
+      return const_c_array<ColorStop>(m_data.m_inline_stops.c_ptr(),
+                                      m_data.m_number_inline_stops);
+    }
+
     /*!
       Returns true if and only if passed image can
       be rendered correctly with the specified filter.
@@ -812,6 +1189,8 @@ namespace fastuidraw
     slack_requirement(enum image_filter f);
 
   private:
+    void
+    set_inline_color_stops(const ColorStopSequence &cs);
 
     class brush_data
     {
@@ -825,6 +1204,7 @@ namespace fastuidraw
         m_grad_end(1.0f, 1.0f),
         m_grad_start_r(0.0f),
         m_grad_end_r(1.0f),
+        m_number_inline_stops(0),
         m_window_position(0.0f, 0.0f),
         m_window_size(1.0f, 1.0f),
         m_transformation_matrix(),
@@ -838,6 +1218,8 @@ namespace fastuidraw
       reference_counted_ptr<const ColorStopSequenceOnAtlas> m_cs;
       vec2 m_grad_start, m_grad_end;
       float m_grad_start_r, m_grad_end_r;
+      vecN<ColorStop, max_inline_color_stops> m_inline_stops;
+      unsigned int m_number_inline_stops;
       vec2 m_window_position, m_window_size;
       float2x2 m_transformation_matrix;
       vec2 m_transformation_p;
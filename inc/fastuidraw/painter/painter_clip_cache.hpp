@@ -0,0 +1,87 @@
+/*!
+ * \file painter_clip_cache.hpp
+ * \brief file painter_clip_cache.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/reference_counted.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Painter
+  @{
+ */
+
+  /*!
+    A PainterClipCache retains the packed occluder that
+    Painter::clipOutPath() and Painter::clipInPath() draw
+    to clip by a path. When a PainterClipCache is passed to
+    those methods and the TessellatedPath selected from the
+    Path, the fill rule, the transformation, the clipping
+    and the resolution of the Painter are unchanged from the
+    last time the PainterClipCache was used, the occluder is
+    drawn from the retained PainterPackerStream instead of
+    selecting and packing the fill of the path again. The
+    occluder itself is still drawn each time, since the depth
+    buffer holding it is cleared every frame, but at the cost
+    essentially of copying its data. The hit and miss counts
+    are given by PainterPacker::num_clip_cache_hits and
+    PainterPacker::num_clip_cache_misses. When the Painter
+    clips with the stencil buffer (see
+    PainterBackend::PerformanceHints::stencil_clipping()),
+    the draws of a clipping carry the stencil value of the
+    clipping in which it is nested, so the PainterClipCache
+    is not used.
+
+    A PainterClipCache holds data packed for a specific Painter
+    and can only be used with that Painter. As with a
+    PainterPackerStream, a PainterClipCache is not thread safe,
+    neither is its reference count.
+   */
+  class PainterClipCache:
+    public reference_counted<PainterClipCache>::non_concurrent
+  {
+  public:
+    /*!
+      Ctor. The PainterClipCache is initially empty
+      so that its first use is a miss.
+     */
+    PainterClipCache(void);
+
+    ~PainterClipCache();
+
+    /*!
+      Discard the retained occluder, forcing the
+      next use to pack the occluder again.
+     */
+    void
+    clear(void);
+
+    /*!
+      Returns true if the PainterClipCache holds a
+      retained occluder.
+     */
+    bool
+    valid(void) const;
+
+  private:
+    friend class Painter;
+    void *m_d;
+  };
+/*! @} */
+}
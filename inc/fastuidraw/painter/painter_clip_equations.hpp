@@ -34,6 +34,10 @@ namespace fastuidraw
     PainterPacker. Each vec3 gives a clip equation in
     3D API clip coordinats (i.e. after PainterItemMatrix
     transformation is applied) as dot(clip_vector, p) >= 0.
+    In addition, it can hold the corners of a rounded rect
+    (see Painter::clipInRoundedRect()) that a backend which
+    supports PainterBackend::PerformanceHints::rounded_rect_clipping()
+    tests analytically per fragment.
   */
   class PainterClipEquations
   {
@@ -64,11 +68,41 @@ namespace fastuidraw
         clip_data_size /*!< number of elements for clip equations */
       };
 
+    /*!
+      Enumeration that provides offsets for the elements
+      of the rounded rect data, relative to the start of
+      the rounded rect data, which is packed after the clip
+      equations at round_up_to_multiple(clip_data_size, alignment).
+     */
+    enum rounded_rect_data_offset_t
+      {
+        rounded_rect_x_coeff_x, /*!< offset to x-coefficient of m_rounded_rect_transformation[0] */
+        rounded_rect_x_coeff_y, /*!< offset to y-coefficient of m_rounded_rect_transformation[0] */
+        rounded_rect_x_coeff_w, /*!< offset to w-coefficient of m_rounded_rect_transformation[0] */
+
+        rounded_rect_y_coeff_x, /*!< offset to x-coefficient of m_rounded_rect_transformation[1] */
+        rounded_rect_y_coeff_y, /*!< offset to y-coefficient of m_rounded_rect_transformation[1] */
+        rounded_rect_y_coeff_w, /*!< offset to w-coefficient of m_rounded_rect_transformation[1] */
+
+        rounded_rect_q_coeff_x, /*!< offset to x-coefficient of m_rounded_rect_transformation[2] */
+        rounded_rect_q_coeff_y, /*!< offset to y-coefficient of m_rounded_rect_transformation[2] */
+        rounded_rect_q_coeff_w, /*!< offset to w-coefficient of m_rounded_rect_transformation[2] */
+
+        rounded_rect_half_width_offset, /*!< offset to m_rounded_rect_half_size.x() */
+        rounded_rect_half_height_offset, /*!< offset to m_rounded_rect_half_size.y() */
+        rounded_rect_radius_offset, /*!< offset to m_rounded_rect_radius */
+
+        rounded_rect_data_size /*!< number of elements for the rounded rect data */
+      };
+
     /*!
       Ctor, initializes all clip equations as \f$ z \geq 0\f$
     */
     PainterClipEquations(void):
-      m_clip_equations(vec3(0.0f, 0.0f, 1.0f))
+      m_clip_equations(vec3(0.0f, 0.0f, 1.0f)),
+      m_rounded_rect_transformation(vec3(0.0f, 0.0f, 0.0f)),
+      m_rounded_rect_half_size(0.0f, 0.0f),
+      m_rounded_rect_radius(0.0f)
     {}
 
     /*!
@@ -91,7 +125,23 @@ namespace fastuidraw
     unsigned int
     data_size(unsigned int alignment) const
     {
-      return round_up_to_multiple(clip_data_size, alignment);
+      return round_up_to_multiple(clip_data_size, alignment)
+        + round_up_to_multiple(rounded_rect_data_size, alignment);
+    }
+
+    /*!
+      Returns true if the clip equations and the rounded
+      rect of this are the same as those of another.
+      \param rhs value to which to compare
+     */
+    bool
+    same_clipping(const PainterClipEquations &rhs) const
+    {
+      return m_clip_equations == rhs.m_clip_equations
+        && m_rounded_rect_radius == rhs.m_rounded_rect_radius
+        && (m_rounded_rect_radius <= 0.0f
+            || (m_rounded_rect_transformation == rhs.m_rounded_rect_transformation
+                && m_rounded_rect_half_size == rhs.m_rounded_rect_half_size));
     }
 
     /*!
@@ -102,6 +152,31 @@ namespace fastuidraw
       \endcode
     */
     vecN<vec3, 4> m_clip_equations;
+
+    /*!
+      Maps 3D API clip-coordinates p to the coordinates of
+      a rounded rect centered at the origin, i.e. the point
+      in rounded rect coordinates is
+      \code
+      vec2(dot(m_rounded_rect_transformation[0], p),
+           dot(m_rounded_rect_transformation[1], p))
+        / dot(m_rounded_rect_transformation[2], p)
+      \endcode
+      Only used if m_rounded_rect_radius is positive.
+     */
+    vecN<vec3, 3> m_rounded_rect_transformation;
+
+    /*!
+      Half of the width and height of the rounded rect.
+     */
+    vec2 m_rounded_rect_half_size;
+
+    /*!
+      Radius of the corners of the rounded rect, in rounded
+      rect coordinates; a value that is not positive indicates
+      that there is no rounded rect clipping.
+     */
+    float m_rounded_rect_radius;
   };
 
 /*! @} */
@@ -30,7 +30,18 @@ namespace fastuidraw
   /*!
     Class to specify dashed stroking parameters, data is packed
     as according to PainterDashedStrokeParams::stroke_data_offset_t.
-    Data for dashing is packed [TODO describe].
+    The dash pattern is packed in the blocks that follow as the
+    ends of its draw and skip intervals, i.e. the running sums
+    of the lengths, arranged as a static search tree read by the
+    function made by glsl::code::compute_interval(). For an alignment
+    of N, a node of the tree is one block of N values and has N + 1
+    children. The internal nodes come first, level by level from
+    the root, with level k having (N + 1)^k nodes; the i'th value
+    of a node is the largest end under its i'th child. They are
+    followed by the leaves, which are the ends in order, N per
+    block. Values past the last end, and the values of the nodes
+    for the subtree holding the last leaf, are padded by a value
+    larger than the total length of the dash pattern.
    */
   class PainterDashedStrokeParams:public PainterItemShaderData
   {
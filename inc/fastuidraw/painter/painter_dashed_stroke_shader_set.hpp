@@ -78,6 +78,28 @@ namespace fastuidraw
     bool
     covered_by_dash_pattern(const PainterShaderData::DataBase *data,
                             const PainterAttribute &attrib) const = 0;
+
+    /*!
+      To be optionally implemented by a derived class to return
+      the intervals drawn by the dash pattern, so that a
+      Painter can split the edges of a StrokedPath at the
+      boundaries of the dash pattern (see
+      StrokedPath::dashed_edges()). The intervals are in units
+      of the distance from the start of a contour, i.e. with
+      any dash offset already applied, and are sorted with
+      the begin of the first interval in [0, period). The pattern
+      repeats every period. Default implementation returns an
+      empty array which indicates that the dash pattern cannot
+      be given as intervals.
+      \param data PainterItemShaderData::DataBase object holding the data to
+                  be sent to the shader
+      \param[out] out_period location to which to write the length of
+                             one period of the dash pattern
+     */
+    virtual
+    const_c_array<range_type<float> >
+    draw_intervals(const PainterShaderData::DataBase *data,
+                   float *out_period) const;
   };
 
   /*!
@@ -36,6 +36,34 @@ namespace fastuidraw
   class PainterFillShader
   {
   public:
+    /*!
+      Enumeration to specify how Painter::fill_path()
+      computes what regions of a Path to draw.
+     */
+    enum coverage_t
+      {
+        /*!
+          Draw the triangles of the FilledPath of the
+          TessellatedPath of the Path that the fill
+          rule accepts.
+         */
+        triangulated_coverage,
+
+        /*!
+          Do not triangulate; instead compute the winding
+          number at each pixel into the stencil buffer by
+          drawing a triangle fan for each contour of the
+          TessellatedPath of the Path and then draw the
+          bounding box of the path where the stencil test
+          accepts the winding number. Only supported if
+          PainterBackend::PerformanceHints::stencil_coverage()
+          is true, otherwise behaves as triangulated_coverage.
+          Only applies to those overloads of Painter::fill_path()
+          that take a Path.
+         */
+        stencil_coverage
+      };
+
     /*!
       Ctor
      */
@@ -67,6 +95,58 @@ namespace fastuidraw
     PainterFillShader&
     item_shader(const reference_counted_ptr<PainterItemShader> &sh);
 
+    /*!
+      Returns the PainterItemShader with which to draw the
+      triangles of a fill together with the anti-alias fuzz
+      of its boundary when anti_alias() is true. The shader
+      draws the attributes of both FilledPath::Subset::painter_data()
+      and FilledPath::Subset::aa_painter_data().
+     */
+    const reference_counted_ptr<PainterItemShader>&
+    aa_item_shader(void) const;
+
+    /*!
+      Set the value returned by aa_item_shader(void) const.
+      \param sh value to use
+     */
+    PainterFillShader&
+    aa_item_shader(const reference_counted_ptr<PainterItemShader> &sh);
+
+    /*!
+      Returns how the regions to fill are computed,
+      the item_shader() is used to draw for both.
+     */
+    enum coverage_t
+    coverage(void) const;
+
+    /*!
+      Set the value returned by coverage(void) const.
+      Default value is \ref triangulated_coverage.
+      \param v value to use
+     */
+    PainterFillShader&
+    coverage(enum coverage_t v);
+
+    /*!
+      If true, Painter::fill_path() draws the fill with
+      aa_item_shader() and draws the anti-alias fuzz of
+      its boundary, FilledPath::Subset::aa_painter_data(),
+      in the same draw call as the triangles of the fill;
+      the fuzz extends one pixel outside of the filled
+      region. Only applies to \ref triangulated_coverage
+      and only if aa_item_shader() is non-NULL.
+     */
+    bool
+    anti_alias(void) const;
+
+    /*!
+      Set the value returned by anti_alias(void) const.
+      Default value is false.
+      \param v value to use
+     */
+    PainterFillShader&
+    anti_alias(bool v);
+
   private:
     void *m_d;
   };
@@ -63,26 +63,63 @@ namespace fastuidraw
         blend_shader_bit0 = item_shader_num_bits,
       };
 
+    /*!
+      Bit packing for \ref m_z
+     */
+    enum z_encoding
+      {
+        /*!
+          If this bit of \ref m_z is up, then \ref m_z does
+          not hold the z-value but, with the bit down, the
+          location, in units of PainterBackend::Configuration::alignment()
+          generic_data tuples, in the data store buffer
+          (PainterDraw::m_store) of the z-value. I.e. the
+          z-value is then
+          \code
+          PainterDraw::m_store[(m_z & ~(1u << z_indirect_bit)) * PainterBackend::Configuration::alignment()].u
+          \endcode
+          This allows for the z-value of many headers to be
+          set after they are written by writing a single value,
+          see PainterPacker::DataCallBack::indirect_z().
+         */
+        z_indirect_bit = 31,
+      };
+
     /*!
       Enumerations specifying how the contents of a PainterHeader
       are packed into a data store buffer (PainterDraw::m_store).
+      The header is made of two parts:
+       - the hot part, [0, hot_header_size), holds the values the
+         vertex shader needs before it can fetch the clipping, the
+         transformation and the z-value of an item,
+       - the cold part, [hot_header_size, header_size), holds the
+         values that select and locate the data of the item, brush
+         and blend shaders; a fragment shader that unpacks the header
+         (see glsl::PainterBackendGLSL::UberShaderParams::unpack_header_and_brush_in_frag_shader())
+         only reads the cold part.
+
+      The cold part is packed starting at the first multiple of
+      the alignment at or after hot_header_size, see cold_header_location().
      */
     enum offset_t
       {
         clip_equations_location_offset, /*!< offset to \ref m_clip_equations_location */
         item_matrix_location_offset, /*!< offset to \ref m_item_matrix_location */
-        brush_shader_data_location_offset, /*!< offset to \ref m_brush_shader_data_location */
-        item_shader_data_location_offset, /*!< offset to \ref m_item_shader_data_location */
-        blend_shader_data_location_offset, /*!< offset to \ref m_blend_shader_data_location */
+        z_offset, /*!< offset to \ref m_z */
         /*!
           offset to \ref m_item_shader and m_blend_shader packed as
           according to item_blend_shader_encoding
          */
         item_blend_shader_offset,
+
+        hot_header_size, /*!< size of the hot part of the header */
+
+        item_shader_data_location_offset = hot_header_size, /*!< offset to \ref m_item_shader_data_location */
+        blend_shader_data_location_offset, /*!< offset to \ref m_blend_shader_data_location */
         brush_shader_offset, /*!< offset to \ref m_brush_shader */
-        z_offset, /*!< offset to \ref m_z */
+        brush_shader_data_location_offset, /*!< offset to \ref m_brush_shader_data_location */
 
-        header_size /*!< size of header */
+        header_size /*!< size of header, without the padding between its parts */
       };
 
     /*!
@@ -156,8 +193,9 @@ namespace fastuidraw
     uint32_t m_blend_shader;
 
     /*!
-      The z-value to use for the item. The z-value is used
-      by Painter to implement clipping.
+      The z-value to use for the item, or its location in the
+      data store if the bit \ref z_indirect_bit is up. The
+      z-value is used by Painter to implement clipping.
      */
     uint32_t m_z;
 
@@ -182,7 +220,23 @@ namespace fastuidraw
     unsigned int
     data_size(unsigned int alignment)
     {
-      return round_up_to_multiple(header_size, alignment);
+      return cold_header_location(alignment)
+        + round_up_to_multiple(header_size - hot_header_size, alignment);
+    }
+
+    /*!
+      Returns the location, in units of generic_data, relative to
+      the start of a packed header, at which the cold part of
+      the header (see \ref offset_t) is packed.
+      \param alignment alignment of the data store
+                       in units of generic_data, see
+                       PainterBackend::ConfigurationBase::alignment()
+     */
+    static
+    unsigned int
+    cold_header_location(unsigned int alignment)
+    {
+      return round_up_to_multiple(hot_header_size, alignment);
     }
   };
 
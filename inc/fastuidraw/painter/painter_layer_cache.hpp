@@ -0,0 +1,81 @@
+/*!
+ * \file painter_layer_cache.hpp
+ * \brief file painter_layer_cache.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/reference_counted.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Painter
+  @{
+ */
+
+  /*!
+    A PainterLayerCache retains the offscreen surface into
+    which Painter::begin_layer() draws the content of a layer
+    so that the content is drawn once and composited in later
+    frames as a single textured rect. When a PainterLayerCache
+    is passed to Painter::begin_layer() and the rect of the
+    layer and the size in pixels of the layer are unchanged
+    from the layer the PainterLayerCache retains,
+    Painter::begin_layer() returns false and the caller skips
+    drawing the content. The caller is to call clear() when
+    the content of the layer changes. Moving the layer with
+    translations of the transformation keeps the retained
+    layer valid; scaling it changes its size in pixels and
+    the content of the layer is drawn again.
+
+    A PainterLayerCache holds an offscreen surface of a specific
+    PainterBackend and can only be used with a Painter of that
+    PainterBackend. As with a PainterClipCache, a PainterLayerCache
+    is not thread safe, neither is its reference count.
+   */
+  class PainterLayerCache:
+    public reference_counted<PainterLayerCache>::non_concurrent
+  {
+  public:
+    /*!
+      Ctor. The PainterLayerCache is initially empty
+      so that its first use draws the layer.
+     */
+    PainterLayerCache(void);
+
+    ~PainterLayerCache();
+
+    /*!
+      Discard the retained layer, forcing the
+      next use to draw the layer again.
+     */
+    void
+    clear(void);
+
+    /*!
+      Returns true if the PainterLayerCache holds a
+      retained layer.
+     */
+    bool
+    valid(void) const;
+
+  private:
+    friend class Painter;
+    void *m_d;
+  };
+/*! @} */
+}
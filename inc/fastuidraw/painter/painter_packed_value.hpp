@@ -73,9 +73,12 @@ namespace fastuidraw
     already copied to PainterDraw::m_store. If already
     on a store, then rather than copying the data again, the data is
     reused. The object behind the handle is NOT thread safe. In addition
-    the underlying reference count is not either. Hence any access
-    (even dtor, copy ctor and equality operator) on a fixed object cannot
-    be done from multiple threads simutaneously. A fixed
+    the underlying reference count is not either unless the
+    PainterPackedValue was created by a PainterPackedValuePool whose
+    PainterPackedValuePool::thread_safe() returns true. Hence, unless
+    created from such a pool, any access (even dtor, copy ctor and
+    equality operator) on a fixed object cannot be done from multiple
+    threads simutaneously. A fixed
     PainterPackedValue can be used by different Painter (and PainterPacker)
     objects subject to the condition that the data store alignment (see
     PainterPacker::Configuration::alignment()) is the same for each of these
@@ -118,7 +121,7 @@ namespace fastuidraw
     unsigned int
     alignment_packing(void) const
     {
-      return this->m_d->alignment_packing();
+      return PainterPackedValueBase::alignment_packing();
     }
 
     /*!
@@ -187,14 +190,22 @@ namespace fastuidraw
 
   /*!
     A PainterPackedValuePool can be used to create PainterPackedValue
-    objects. Just like PainterPackedValue, PainterPackedValuePool is
-    NOT thread safe, as such it is not a safe operation to use the
-    same PainterPackedValuePool object from multiple threads at the
-    same time. A fixed PainterPackedValuePool can create PainterPackedValue
-    objects used by different Painter (and PainterPacker) objects subject
-    to the condition that the data store alignment (see
-    PainterPacker::Configuration::alignment()) is the same for each of
-    these objects.
+    objects. Unless constructed with thread_safe as true, just like
+    PainterPackedValue, PainterPackedValuePool is NOT thread safe, as
+    such it is not a safe operation to use the same PainterPackedValuePool
+    object from multiple threads at the same time. If constructed with
+    thread_safe as true, then create_packed_value() may be called from
+    multiple threads simutaneously and the reference count of the created
+    PainterPackedValue objects is thread safe, so that the handles can be
+    copied and released from any thread; aquiring and releasing a slot
+    of the pool is lock free with a lock only taken once every 1024
+    allocations when the pool must grow. Note that using the same
+    PainterPackedValue within PainterPacker objects on different threads
+    at the same time is still not safe. A fixed PainterPackedValuePool
+    can create PainterPackedValue objects used by different Painter (and
+    PainterPacker) objects subject to the condition that the data store
+    alignment (see PainterPacker::Configuration::alignment()) is the same
+    for each of these objects.
    */
   class PainterPackedValuePool:noncopyable
   {
@@ -203,12 +214,21 @@ namespace fastuidraw
       Ctor.
       \param painter_alignment the alignment to create packed data, see
                                 PainterPacker::Configuration::alignment()
+      \param thread_safe if true, the PainterPackedValuePool and the
+                         reference counts of the created PainterPackedValue
+                         objects are thread safe
      */
     explicit
-    PainterPackedValuePool(int painter_alignment);
+    PainterPackedValuePool(int painter_alignment, bool thread_safe = false);
 
     ~PainterPackedValuePool();
 
+    /*!
+      Returns the value of thread_safe passed in the ctor.
+     */
+    bool
+    thread_safe(void) const;
+
     /*!
       Create and return a PainterPackedValue<PainterBrush>
       object for the value of a PainterBrush object.
@@ -91,6 +91,38 @@ namespace fastuidraw
     PainterShaderSet&
     glyph_shader_anisotropic(const PainterGlyphShader &sh);
 
+    /*!
+      Shader set for rendering glyph instances, i.e. one
+      attribute per glyph (see PainterPacker::draw_instanced_quads()
+      and PainterAttributeDataFillerGlyphs::instanced()), with
+      isotropic anti-aliasing. The shaders draw the same as
+      those of glyph_shader().
+     */
+    const PainterGlyphShader&
+    glyph_instance_shader(void) const;
+
+    /*!
+      Set the value returned by glyph_instance_shader(void) const.
+      \param sh value to use
+     */
+    PainterShaderSet&
+    glyph_instance_shader(const PainterGlyphShader &sh);
+
+    /*!
+      Shader set for rendering glyph instances with anisotropic
+      anti-aliasing. The shaders draw the same as those of
+      glyph_shader_anisotropic().
+     */
+    const PainterGlyphShader&
+    glyph_instance_shader_anisotropic(void) const;
+
+    /*!
+      Set the value returned by glyph_instance_shader_anisotropic(void) const.
+      \param sh value to use
+     */
+    PainterShaderSet&
+    glyph_instance_shader_anisotropic(const PainterGlyphShader &sh);
+
     /*!
       Shader set for stroking of paths where the stroking
       width is given in same units as the original path.
@@ -166,6 +198,66 @@ namespace fastuidraw
     PainterShaderSet&
     fill_shader(const PainterFillShader &sh);
 
+    /*!
+      Shader for stroking a HairlinePath when each segment
+      is expanded to the four vertices of its quad (see
+      HairlinePath::expand_segment()). The stroking width
+      is in pixels and is given by PainterStrokeParams.
+     */
+    const reference_counted_ptr<PainterItemShader>&
+    hairline_shader(void) const;
+
+    /*!
+      Set the value returned by hairline_shader(void) const.
+      \param sh value to use
+     */
+    PainterShaderSet&
+    hairline_shader(const reference_counted_ptr<PainterItemShader> &sh);
+
+    /*!
+      Shader for stroking a HairlinePath with each segment
+      drawn as an instanced quad (see PainterPacker::draw_instanced_quads()).
+      The shader draws the same as hairline_shader().
+     */
+    const reference_counted_ptr<PainterItemShader>&
+    hairline_instance_shader(void) const;
+
+    /*!
+      Set the value returned by hairline_instance_shader(void) const.
+      \param sh value to use
+     */
+    PainterShaderSet&
+    hairline_instance_shader(const reference_counted_ptr<PainterItemShader> &sh);
+
+    /*!
+      Shader for drawing an anti-aliased rounded rect as a
+      single quad, see Painter::draw_rounded_rect().
+     */
+    const reference_counted_ptr<PainterItemShader>&
+    rounded_rect_shader(void) const;
+
+    /*!
+      Set the value returned by rounded_rect_shader(void) const.
+      \param sh value to use
+     */
+    PainterShaderSet&
+    rounded_rect_shader(const reference_counted_ptr<PainterItemShader> &sh);
+
+    /*!
+      Shader for drawing the Gaussian blurred shadow of a
+      rounded rect as a single quad, see Painter::draw_box_shadow().
+      It takes the same attributes as rounded_rect_shader().
+     */
+    const reference_counted_ptr<PainterItemShader>&
+    box_shadow_shader(void) const;
+
+    /*!
+      Set the value returned by box_shadow_shader(void) const.
+      \param sh value to use
+     */
+    PainterShaderSet&
+    box_shadow_shader(const reference_counted_ptr<PainterItemShader> &sh);
+
     /*!
       Blend shaders. If an element is a NULL shader, then that
       blend mode is not supported.
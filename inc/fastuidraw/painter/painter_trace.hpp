@@ -0,0 +1,317 @@
+/*!
+ * \file painter_trace.hpp
+ * \brief file painter_trace.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/matrix.hpp>
+#include <fastuidraw/util/blend_mode.hpp>
+#include <fastuidraw/image.hpp>
+#include <fastuidraw/text/font.hpp>
+#include <fastuidraw/text/glyph_cache.hpp>
+#include <fastuidraw/painter/painter_enums.hpp>
+#include <fastuidraw/painter/painter_blend_shader.hpp>
+
+namespace fastuidraw
+{
+  class Path;
+  class GlyphRun;
+  class Painter;
+  class PainterData;
+  class PainterShaderSet;
+  class PainterPackerStream;
+
+/*!\addtogroup Painter
+  @{
+ */
+
+  /*!
+    A PainterTraceRecorder records the calls made to a Painter
+    (see Painter::trace()) into a compact binary trace that can
+    be replayed by a PainterTracePlayer, for example to turn
+    the frames of an application into a benchmark. The trace
+    holds each frame as the sequence of the Painter calls made
+    between Painter::begin() and Painter::end() together with
+    the definitions of the paths, images, fonts, glyph runs,
+    brushes and stroking parameters those calls use; a
+    definition is written only once, before its first use,
+    however many times it is used. The following are recorded:
+     - save(), restore() and the transformation
+     - the blend mode when it is one of the blend modes of
+       Painter::default_shaders()
+     - clipInRect(), clipInRoundedRect() and clipInPath() / clipOutPath() with a
+       PainterEnums::fill_rule_t
+     - fill_path() and stroke_path() / stroke_dashed_path() of a
+       Path with the default shaders, with a PainterEnums::fill_rule_t
+       for fills
+     - the convex polygons, quads and rects drawn with the
+       default fill shader
+     - draw_glyph_runs() with the default glyph shaders
+     - begin_layer() / end_layer(), end_layer_blurred() and
+       end_layer_drop_shadow()
+     - begin_recording() / end_recording() and draw_stream()
+     - curveFlatness()
+
+    Draws with other shaders or a custom fill rule, draws of
+    pre-built FilledPath, StrokedPath or PainterAttributeData
+    values and the data of custom shaders are not recorded.
+    Images are recorded by their size, slack and number of
+    mipmap levels only and fonts by their FontProperties; the
+    PainterTracePlayer::ResourceProvider of the replay provides
+    the images and fonts to use in their place. A recorder
+    holds a reference to the images, fonts and streams of the
+    trace so that their addresses identify them.
+   */
+  class PainterTraceRecorder:
+    public reference_counted<PainterTraceRecorder>::non_concurrent
+  {
+  public:
+    /*!
+      Ctor.
+      \param max_frames maximum number of frames to record,
+                        frames after are not recorded. A
+                        value of 0 indicates no limit.
+     */
+    explicit
+    PainterTraceRecorder(unsigned int max_frames = 0);
+
+    ~PainterTraceRecorder();
+
+    /*!
+      Returns the number of frames recorded, a frame is
+      counted when its Painter::end() is called.
+     */
+    unsigned int
+    number_frames(void) const;
+
+    /*!
+      Returns true if the recorder has recorded max_frames
+      frames, as passed to the ctor.
+     */
+    bool
+    done(void) const;
+
+    /*!
+      Write the trace to a blob of bytes, which can be saved
+      to a file and then passed to a PainterTracePlayer.
+      \param dst location to which to write the trace
+     */
+    void
+    write(std::vector<uint8_t> &dst) const;
+
+    /*!
+      Clear the recorded frames and definitions and
+      release the references to images, fonts and streams.
+     */
+    void
+    clear(void);
+
+  private:
+    friend class Painter;
+
+    void
+    begin_frame(const ivec2 &resolution, bool reset_z, bool multisampled_target,
+                bool no_depth_buffer);
+
+    void
+    end_frame(void);
+
+    void
+    save(void);
+
+    void
+    restore(void);
+
+    void
+    transformation(const float3x3 &m);
+
+    void
+    blend_shader(const PainterShaderSet &default_shaders,
+                 const reference_counted_ptr<PainterBlendShader> &h,
+                 BlendMode::packed_value mode);
+
+    void
+    curve_flatness(float v);
+
+    void
+    clip_in_rect(const vec2 &xy, const vec2 &wh);
+
+    void
+    clip_in_rounded_rect(const vec2 &xy, const vec2 &wh, float corner_radius);
+
+    void
+    clip_path(bool clip_in, const Path &path, enum PainterEnums::fill_rule_t fill_rule);
+
+    void
+    fill_path(const PainterData &draw, const Path &path,
+              enum PainterEnums::fill_rule_t fill_rule);
+
+    void
+    stroke_path(const PainterData &draw, const Path &path, bool dashed, bool pixel_width,
+                bool close_contours, enum PainterEnums::cap_style cp,
+                enum PainterEnums::join_style js, bool with_anti_aliasing);
+
+    void
+    draw_convex_polygon(const PainterData &draw, const_c_array<vec2> pts);
+
+    void
+    draw_quads(const PainterData &draw, const_c_array<vec2> pts);
+
+    void
+    draw_glyph_runs(const PainterData &draw, const_c_array<const GlyphRun*> runs,
+                    bool use_anistopic_antialias);
+
+    void
+    begin_layer(const vec2 &xy, const vec2 &wh, float opacity);
+
+    void
+    end_layer(void);
+
+    void
+    end_layer_blurred(float radius);
+
+    void
+    end_layer_drop_shadow(float radius, const vec2 &offset, const vec4 &color);
+
+    void
+    begin_recording(const reference_counted_ptr<PainterPackerStream> &stream);
+
+    void
+    end_recording(void);
+
+    void
+    draw_stream(const PainterPackerStream &stream, bool use_current_state);
+
+    void *m_d;
+  };
+
+  /*!
+    A PainterTracePlayer replays the frames of a trace written
+    by PainterTraceRecorder::write() to a Painter. The images,
+    fonts, glyph runs, paths and color stops of the trace are
+    created on their first use by a replay and then kept by the
+    PainterTracePlayer, so that the replays of a frame after the
+    first time it is replayed measure only the drawing. Streams
+    recorded by a frame (see Painter::begin_recording()) are kept
+    as well, so frames should be replayed in order.
+   */
+  class PainterTracePlayer:
+    public reference_counted<PainterTracePlayer>::non_concurrent
+  {
+  public:
+    /*!
+      A ResourceProvider provides to a PainterTracePlayer the
+      resources that a trace does not hold.
+     */
+    class ResourceProvider:
+      public reference_counted<ResourceProvider>::default_base
+    {
+    public:
+      virtual
+      ~ResourceProvider()
+      {}
+
+      /*!
+        To be implemented by a derived class to return an image
+        to use in place of the image of the trace with the
+        passed size, slack and number of mipmap levels.
+        \param atlas ImageAtlas of the Painter of the replay
+        \param dims dimensions of the image of the trace
+        \param slack Image::slack() of the image of the trace
+        \param number_mipmap_levels number of mipmap levels of
+                                    the image of the trace
+       */
+      virtual
+      reference_counted_ptr<const Image>
+      image(const reference_counted_ptr<ImageAtlas> &atlas, ivec2 dims,
+            unsigned int slack, unsigned int number_mipmap_levels) = 0;
+
+      /*!
+        To be implemented by a derived class to return the font
+        to use in place of the font of the trace with the passed
+        properties.
+        \param props FontProperties of the font of the trace
+       */
+      virtual
+      reference_counted_ptr<const FontBase>
+      font(const FontProperties &props) = 0;
+
+      /*!
+        To be implemented by a derived class to return the
+        GlyphCache, on the GlyphAtlas of the Painter of the
+        replay, to which to upload the glyphs of the trace.
+       */
+      virtual
+      reference_counted_ptr<GlyphCache>
+      glyph_cache(void) = 0;
+    };
+
+    /*!
+      Ctor. The trace is parsed, but no resource is created.
+      \param blob bytes of the trace, as written by PainterTraceRecorder::write();
+                  the bytes are copied
+      \param provider ResourceProvider of the images, fonts and
+                      GlyphCache of the replays
+     */
+    PainterTracePlayer(const_c_array<uint8_t> blob,
+                       const reference_counted_ptr<ResourceProvider> &provider);
+
+    ~PainterTracePlayer();
+
+    /*!
+      Returns true if the trace was parsed successfully.
+     */
+    bool
+    valid(void) const;
+
+    /*!
+      Returns the number of frames of the trace.
+     */
+    unsigned int
+    number_frames(void) const;
+
+    /*!
+      Returns the resolution of the target of a frame
+      as given by Painter::target_resolution() when the
+      frame began.
+      \param frame frame to query, 0 <= frame < number_frames()
+     */
+    ivec2
+    frame_resolution(unsigned int frame) const;
+
+    /*!
+      Replays a frame to a Painter, i.e. calls Painter::begin()
+      and Painter::end() and all the recorded calls between them.
+      The target resolution of the Painter is not changed,
+      see frame_resolution().
+      \param frame frame to replay, 0 <= frame < number_frames()
+      \param painter Painter to which to replay
+     */
+    void
+    replay_frame(unsigned int frame, Painter &painter);
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+}
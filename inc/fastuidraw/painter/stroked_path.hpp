@@ -19,12 +19,15 @@
 
 #pragma once
 
+#include <vector>
+#include <stdint.h>
 #include <fastuidraw/util/fastuidraw_memory.hpp>
 #include <fastuidraw/util/vecN.hpp>
 #include <fastuidraw/util/matrix.hpp>
 #include <fastuidraw/util/c_array.hpp>
 #include <fastuidraw/util/reference_counted.hpp>
 #include <fastuidraw/painter/painter_attribute_data.hpp>
+#include <fastuidraw/painter/painter_enums.hpp>
 
 namespace fastuidraw  {
 
@@ -278,6 +281,16 @@ public:
         geometry of a bevel between two sub-edges.
        */
       bevel_edge_bit = number_common_bits,
+
+      /*!
+        The bit is up if the point is on the side of
+        the sub-edge opposite to its normal; only points
+        of edges() of a StrokedPath whose edge_format()
+        is \ref compact_edge_format have the bit up.
+        For such points, point::on_boundary() is -1
+        instead of +1.
+       */
+      negative_boundary_bit,
     };
 
   /*!
@@ -330,6 +343,11 @@ public:
        */
       bevel_edge_mask = FASTUIDRAW_MASK(bevel_edge_bit, 1),
 
+      /*!
+        Mask generated for \ref negative_boundary_bit
+       */
+      negative_boundary_mask = FASTUIDRAW_MASK(negative_boundary_bit, 1),
+
       /*!
         Mask generated for \ref depth_bit0 and \ref depth_num_bits
        */
@@ -445,7 +463,7 @@ public:
     }
 
     /*!
-      Has value 0 or +1. If the value is 0, then
+      Has value 0, +1 or -1. If the value is 0, then
       the point is on the path. If the value has
       absolute value 1, then indicates a point that
       is on the boundary of the stroked path. The triangles
@@ -453,11 +471,23 @@ public:
       m_on_boundary is interpolated across the triangle
       the center of stroking the value is 0 and the
       value has absolute value +1 on the boundary.
+      The value is -1 only for points with the bit
+      \ref negative_boundary_bit up.
      */
     int
     on_boundary(void) const
     {
-      return unpack_bits(boundary_bit, 1u, m_packed_data);
+      int v;
+      enum offset_type_t tp;
+
+      v = unpack_bits(boundary_bit, 1u, m_packed_data);
+      tp = offset_type();
+      if((tp == offset_start_sub_edge || tp == offset_end_sub_edge)
+         && (m_packed_data & negative_boundary_mask) != 0u)
+        {
+          v = -v;
+        }
+      return v;
     }
 
     /*!
@@ -623,16 +653,111 @@ public:
   unsigned int
   chunk_for_named_join(unsigned int J);
 
+  /*!
+    Enumeration to specify how the points of
+    edges() are made.
+   */
+  enum edge_format_t
+    {
+      /*!
+        Each sub-edge of edges() is a quad made of
+        6 points and 4 triangles: the two points on
+        the path at its start and end together with
+        the two points for each side of the path on
+        the boundary of the stroke.
+       */
+      full_edge_format,
+
+      /*!
+        Each sub-edge of edges() is a quad made of
+        only the 4 points on the boundary of the
+        stroke and 2 triangles; the points on the
+        side opposite to the normal of the sub-edge
+        have point::on_boundary() as -1 so that its
+        interpolation still gives the distance to the
+        path. Uses two thirds of the attributes and half
+        of the indices of \ref full_edge_format for the
+        same edges; the joins and caps are the same.
+       */
+      compact_edge_format,
+    };
+
   /*!
     Ctor. Construct a StrokedPath from the data
     of a TessellatedPath.
     \param P source TessellatedPath
+    \param edge_format how to make the points of edges()
    */
   explicit
-  StrokedPath(const TessellatedPath &P);
+  StrokedPath(const TessellatedPath &P,
+              enum edge_format_t edge_format = default_edge_format());
 
   ~StrokedPath();
 
+  /*!
+    Returns the version of the blob format written by
+    serialize() and read by create_from_blob(). A blob
+    written with a different version is rejected
+    by create_from_blob().
+   */
+  static
+  uint32_t
+  blob_version(void);
+
+  /*!
+    Write the data of this StrokedPath to a blob so that an
+    application can compute it offline and load it with
+    create_from_blob(). The rounded joins and caps are not
+    written; a StrokedPath made by create_from_blob() makes
+    them on demand as usual. The blob is a sequence of
+    32-bit little-endian words.
+    \param dst location to which to write the blob
+   */
+  void
+  serialize(std::vector<uint8_t> &dst) const;
+
+  /*!
+    Create a StrokedPath from a blob written by serialize().
+    If the host is little-endian and the blob is 4-byte aligned
+    (for example a memory mapped file) the attribute and index
+    data of the returned StrokedPath point into the blob
+    directly, otherwise the blob is copied. In either case,
+    the memory of the blob must stay valid for as long as
+    the returned StrokedPath is alive. Returns a NULL handle
+    if the blob is malformed or of a different version
+    than blob_version().
+    \param blob bytes written by serialize()
+   */
+  static
+  reference_counted_ptr<StrokedPath>
+  create_from_blob(const_c_array<uint8_t> blob);
+
+  /*!
+    Returns the value of edge_format passed in the ctor.
+   */
+  enum edge_format_t
+  edge_format(void) const;
+
+  /*!
+    Returns the edge format used when one is not specified
+    at construction of a StrokedPath, in particular those
+    made by TessellatedPath::stroked(). Default value is
+    \ref full_edge_format.
+   */
+  static
+  enum edge_format_t
+  default_edge_format(void);
+
+  /*!
+    Set the value returned by default_edge_format(void).
+    Not thread safe; set it before StrokedPath objects
+    are created.
+    \param v value to use
+   */
+  static
+  void
+  default_edge_format(enum edge_format_t v);
+
   /*!
     Returns TessellatedPath::effective_curve_distance_threshhold()
     of the TessellatedPath that generated this StrokedPath.
@@ -646,6 +771,44 @@ public:
   const PainterAttributeData&
   edges(bool include_closing_edges) const;
 
+  /*!
+    Returns the data to draw the edges of a stroked path
+    with a dash pattern where the edges are split at the
+    boundaries of the dash pattern and the portions of the
+    edges in the gaps of the dash pattern are dropped, so
+    that no fragments are made there. The bevels of the
+    edges in the gaps are also dropped. A portion of an edge
+    in the interior of an interval of the dash pattern is
+    entirely covered, so a shader does not need to compute
+    the dash pattern per fragment for it. The chunks of the
+    returned PainterAttributeData are the same as those of
+    edges(include_closing_edges), so the chunks returned
+    by edge_chunks() and the value of z_increment_edge() are
+    valid for it. The data of the last few dash patterns is
+    kept; the returned reference is only valid until the
+    next call to dashed_edges(). Returns
+    edges(include_closing_edges) if the dash pattern has no
+    gap longer than twice margin.
+    \param draw_intervals intervals drawn by the dash pattern, in units
+                          of the distance from the start of a contour,
+                          sorted and with each interval beginning within
+                          one period of the begin of the first interval,
+                          as returned by DashEvaluatorBase::draw_intervals()
+    \param period length of one period of the dash pattern, the
+                  intervals are repeated every period
+    \param margin distance in local coordinates about each boundary
+                  of the dash pattern that is drawn with the dash
+                  pattern computed per fragment; this should be
+                  so that the anti-aliasing of the boundary, about
+                  one pixel, is within it
+    \param include_closing_edges if true, include the closing edges
+                                 of each contour
+   */
+  const PainterAttributeData&
+  dashed_edges(const_c_array<range_type<float> > draw_intervals,
+               float period, float margin,
+               bool include_closing_edges) const;
+
   /*!
     Given a set of clip equations in clip coordinates
     and a tranformation from local coordiante to clip
@@ -682,6 +845,47 @@ public:
               unsigned int max_index_cnt,
               c_array<unsigned int> dst) const;
 
+  /*!
+    Given a set of clip equations in clip coordinates
+    and a tranformation from local coordiante to clip
+    coordinates, compute what chunks are not completely
+    culled by the clip equations. The sizes of the chunks
+    are checked against edge_data, which is to be either
+    edges(include_closing_edges) or the return value of
+    dashed_edges() with the same value of include_closing_edges.
+    \param scratch_space scratch space for computations.
+    \param edge_data PainterAttributeData holding the edge data
+    \param clip_equations array of clip equations
+    \param clip_matrix_local 3x3 transformation from local (x, y, 1)
+                             coordinates to clip coordinates.
+    \param recip_dimensions holds the reciprocal of the dimensions of the viewport
+    \param pixels_additional_room amount in -pixels- to push clip equations by
+                                  to grab additional edges
+    \param item_space_additional_room amount in local coordinates to push clip
+                                      equations by to grab additional edges
+    \param include_closing_edges if true include the chunks needed to
+                                 draw the closing edges of each contour
+    \param max_attribute_cnt only allow those chunks for which have no more
+                             than max_attribute_cnt attributes
+    \param max_index_cnt only allow those chunks for which have no more
+                         than max_index_cnt indices
+    \param dst[output] location to which to write the what chunks
+    \returns the number of chunks that intersect the clipping region,
+             that number is guarnanteed to be no more than maximum_edge_chunks().
+   */
+  unsigned int
+  edge_chunks(ScratchSpace &scratch_space,
+              const PainterAttributeData &edge_data,
+              const_c_array<vec3> clip_equations,
+              const float3x3 &clip_matrix_local,
+              const vec2 &recip_dimensions,
+              float pixels_additional_room,
+              float item_space_additional_room,
+              bool include_closing_edges,
+              unsigned int max_attribute_cnt,
+              unsigned int max_index_cnt,
+              c_array<unsigned int> dst) const;
+
   /*!
     Gives the maximum return value to edge_chunks(), i.e. the
     maximum number of chunks that edge_chunks() will return.
@@ -689,6 +893,137 @@ public:
   unsigned int
   maximum_edge_chunks(void) const;
 
+  /*!
+    Given a set of clip equations in clip coordinates
+    and a tranformation from local coordiante to clip
+    coordinates, compute what chunks of the data for the
+    joins are not completely culled by the clip equations.
+    The same chunks are used by bevel_joins(), miter_joins()
+    and rounded_joins() for any threshhold. A join is tested
+    as its point inflated by the additional room, so the
+    additional room needs to be large enough to contain
+    the join; for example the miter of a miter join extends
+    farther than the stroking radius.
+    \param scratch_space scratch space for computations.
+    \param join_data data of the joins from which the chunks are taken,
+                     must be bevel_joins(), miter_joins() or rounded_joins()
+                     of this StrokedPath
+    \param clip_equations array of clip equations
+    \param clip_matrix_local 3x3 transformation from local (x, y, 1)
+                             coordinates to clip coordinates.
+    \param recip_dimensions holds the reciprocal of the dimensions of the viewport
+    \param pixels_additional_room amount in -pixels- to push clip equations by
+                                  to grab additional joins
+    \param item_space_additional_room amount in local coordinates to push clip
+                                      equations by to grab additional joins
+    \param include_joins_from_closing_edge if true include the chunks needed to
+                                           draw the joins of the closing edges of
+                                           each contour
+    \param max_attribute_cnt only allow those chunks for which have no more
+                             than max_attribute_cnt attributes
+    \param max_index_cnt only allow those chunks for which have no more
+                         than max_index_cnt indices
+    \param dst[output] location to which to write the what chunks
+    \returns the number of chunks that intersect the clipping region,
+             that number is guarnanteed to be no more than maximum_join_chunks().
+   */
+  unsigned int
+  join_chunks(ScratchSpace &scratch_space,
+              const PainterAttributeData &join_data,
+              const_c_array<vec3> clip_equations,
+              const float3x3 &clip_matrix_local,
+              const vec2 &recip_dimensions,
+              float pixels_additional_room,
+              float item_space_additional_room,
+              bool include_joins_from_closing_edge,
+              unsigned int max_attribute_cnt,
+              unsigned int max_index_cnt,
+              c_array<unsigned int> dst) const;
+
+  /*!
+    Gives the maximum return value to join_chunks(), i.e. the
+    maximum number of chunks that join_chunks() will return.
+   */
+  unsigned int
+  maximum_join_chunks(void) const;
+
+  /*!
+    Given a set of clip equations in clip coordinates
+    and a tranformation from local coordiante to clip
+    coordinates, compute what chunks of the data for the
+    caps are not completely culled by the clip equations.
+    The same chunks are used by square_caps(), adjustable_caps()
+    and rounded_caps() for any threshhold. A cap is tested as
+    its point inflated by the additional room, so the additional
+    room needs to be large enough to contain the cap; for example
+    the corners of a square cap are sqrt(2) times the stroking
+    radius from the point of the cap.
+    \param scratch_space scratch space for computations.
+    \param cap_data data of the caps from which the chunks are taken,
+                    must be square_caps(), adjustable_caps() or rounded_caps()
+                    of this StrokedPath
+    \param clip_equations array of clip equations
+    \param clip_matrix_local 3x3 transformation from local (x, y, 1)
+                             coordinates to clip coordinates.
+    \param recip_dimensions holds the reciprocal of the dimensions of the viewport
+    \param pixels_additional_room amount in -pixels- to push clip equations by
+                                  to grab additional caps
+    \param item_space_additional_room amount in local coordinates to push clip
+                                      equations by to grab additional caps
+    \param max_attribute_cnt only allow those chunks for which have no more
+                             than max_attribute_cnt attributes
+    \param max_index_cnt only allow those chunks for which have no more
+                         than max_index_cnt indices
+    \param dst[output] location to which to write the what chunks
+    \returns the number of chunks that intersect the clipping region,
+             that number is guarnanteed to be no more than maximum_cap_chunks().
+   */
+  unsigned int
+  cap_chunks(ScratchSpace &scratch_space,
+             const PainterAttributeData &cap_data,
+             const_c_array<vec3> clip_equations,
+             const float3x3 &clip_matrix_local,
+             const vec2 &recip_dimensions,
+             float pixels_additional_room,
+             float item_space_additional_room,
+             unsigned int max_attribute_cnt,
+             unsigned int max_index_cnt,
+             c_array<unsigned int> dst) const;
+
+  /*!
+    Gives the maximum return value to cap_chunks(), i.e. the
+    maximum number of chunks that cap_chunks() will return.
+   */
+  unsigned int
+  maximum_cap_chunks(void) const;
+
+  /*!
+    Returns true if a point is covered by the stroking of this
+    StrokedPath, as drawn by Painter::stroke_path() without
+    dashing. Only the chunks of the edges, joins and caps whose
+    bounding box inflated by the stroking radius (and the miter
+    or cap extent) contains the point are visited, and their
+    triangles are tested with the offsets of their points
+    computed as the stroke shader does. Rounded joins and caps
+    are tested as the disc of the stroking radius about the
+    join or cap point, so they do not depend on a threshhold.
+    \param scratch_space scratch space for computations
+    \param pt point, in the coordinates of the path
+    \param stroke_width width of the stroking, in the coordinates
+                        of the path
+    \param js join style
+    \param cp cap style, caps are only tested if close_contours is false
+    \param close_contours if true, the closing edges of each contour
+                          and their joins are tested
+    \param miter_limit miter limit of the miter joins, see
+                       PainterStrokeParams::miter_limit(); a value
+                       less than zero indicates no miter limit
+   */
+  bool
+  hit_test(ScratchSpace &scratch_space, const vec2 &pt, float stroke_width,
+           enum PainterEnums::join_style js, enum PainterEnums::cap_style cp,
+           bool close_contours, float miter_limit = 15.0f) const;
+
   /*!
     Gives the maximum value for point::depth() for all
     edges of a stroked path.
@@ -725,6 +1060,13 @@ public:
 
   /*!
     Returns the data to draw rounded joins of a stroked path.
+    The rounded joins are made for threshholds that are powers
+    of 2; the data returned is that of the largest power of 2
+    that is no more than thresh, made on the first call that
+    needs it. If rounded_cache_max_bytes() is non-zero, the
+    returned reference may be invalidated by later calls to
+    rounded_joins(float) const, rounded_caps(float) const
+    and warm_rounded(float) const for a different threshhold.
     \param thresh will return rounded joins so that the distance
                   between the approximation of the round and the
                   actual round is no more than thresh.
@@ -734,6 +1076,8 @@ public:
 
   /*!
     Returns the data to draw rounded caps of a stroked path.
+    The data is made and released in the same way as that
+    of rounded_joins(float) const.
     \param thresh will return rounded caps so that the distance
                   between the approximation of the round and the
                   actual round is no more than thresh.
@@ -741,7 +1085,73 @@ public:
   const PainterAttributeData&
   rounded_caps(float thresh) const;
 
+  /*!
+    Make ahead of time the data that rounded_joins(float) const
+    and rounded_caps(float) const return for thresh and all
+    coarser threshholds, so that later calls with a threshhold
+    of at least thresh do not make any data (unless it was
+    released since, see rounded_cache_max_bytes()). The joins
+    and caps of the different threshholds are made in parallel
+    on up to TessellatedPath::TessellationParams::m_max_threads
+    threads of the TessellatedPath from which the StrokedPath
+    was made (the value is kept in the blob made by serialize()).
+    The bevel, miter, square and adjustable join and cap data
+    are made in the same way when a StrokedPath is constructed.
+    Like the other methods of StrokedPath, it is not safe to
+    call at the same time as other methods of the same
+    StrokedPath.
+    \param thresh threshhold as passed to rounded_joins(float) const
+                  and rounded_caps(float) const
+   */
+  void
+  warm_rounded(float thresh) const;
+
+  /*!
+    Returns the sum of PainterAttributeData::number_bytes()
+    of the rounded join and cap data that this StrokedPath
+    keeps.
+   */
+  unsigned int
+  rounded_cache_bytes(void) const;
+
+  /*!
+    Returns the maximum number of bytes, as measured by
+    rounded_cache_bytes(), of the rounded join and cap data
+    that this StrokedPath keeps. When exceeded, the least
+    recently returned data is released; the data used by
+    the most recent call to rounded_joins(float) const,
+    rounded_caps(float) const or warm_rounded(float) const,
+    and both the joins and caps of the threshhold of that
+    call, are never released. A value of 0 indicates no limit. The
+    value is default_rounded_cache_max_bytes() at the time
+    the StrokedPath is constructed.
+   */
+  unsigned int
+  rounded_cache_max_bytes(void) const;
+
+  /*!
+    Returns the value of rounded_cache_max_bytes() for
+    StrokedPath objects when they are constructed. Default
+    value is 0.
+   */
+  static
+  unsigned int
+  default_rounded_cache_max_bytes(void);
+
+  /*!
+    Set the value returned by default_rounded_cache_max_bytes(void).
+    Not thread safe; set it before StrokedPath objects
+    are created.
+    \param v value to use
+   */
+  static
+  void
+  default_rounded_cache_max_bytes(unsigned int v);
+
 private:
+  explicit
+  StrokedPath(void *d);
+
   void *m_d;
 };
 
@@ -122,6 +122,24 @@ public:
     void
     approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const = 0;
 
+    /*!
+      To be optionally implemented by a derived class to return
+      the tight bounding box of the interpolator, i.e. the smallest
+      axis aligned box containing the curve. The value is used
+      to cull before tessellating. Default implementation returns
+      the value of approximate_bounding_box().
+      \param out_min_bb (output) location to which to write the min-x and min-y
+                                 coordinates of the tight bounding box.
+      \param out_max_bb (output) location to which to write the max-x and max-y
+                                 coordinates of the tight bounding box.
+     */
+    virtual
+    void
+    tight_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const
+    {
+      approximate_bounding_box(out_min_bb, out_max_bb);
+    }
+
     /*!
       To be implemented by a derived class to create and
       return a deep copy of the interpolator object.
@@ -284,6 +302,26 @@ public:
     virtual
     ~bezier();
 
+    /*!
+      Returns the points that define the curve: the start
+      point, then the control points and then the end point.
+     */
+    const_c_array<vec2>
+    pts(void) const;
+
+    /*!
+      Overrides interpolator_generic::produce_tessellation()
+      so that quadratic and cubic curves tessellated by
+      distance are subdivided on the stack instead of via
+      tessellate().
+     */
+    virtual
+    unsigned int
+    produce_tessellation(const TessellatedPath::TessellationParams &tess_params,
+                         c_array<TessellatedPath::point> out_data,
+                         float *out_effective_curve_distance,
+                         float *out_effective_curvature) const;
+
     virtual
     void
     compute(float in_t, vec2 *outp, vec2 *outp_t, vec2 *outp_tt) const;
@@ -299,6 +337,17 @@ public:
     void
     approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const;
 
+    /*!
+      Returns the tight bounding box of the curve computed from the
+      roots of the derivative for quadratic and cubic curves. For
+      curves of higher degree, returns the bounding box of the
+      control points, i.e. the same as approximate_bounding_box().
+      The value is computed once, on construction.
+     */
+    virtual
+    void
+    tight_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const;
+
     virtual
     interpolator_base*
     deep_copy(const reference_counted_ptr<const interpolator_base> &prev) const;
@@ -332,6 +381,14 @@ public:
 
     ~arc();
 
+    /*!
+      Returns the signed angle of the arc in radians,
+      a positive value indicates that the arc goes
+      counter-clockwise.
+     */
+    float
+    angle(void) const;
+
     virtual
     void
     approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const;
@@ -429,7 +486,9 @@ public:
     Returns the last interpolator added to this PathContour.
     You MUST use this interpolator in the ctor of
     interpolator_base for interpolator passed to
-    to_generic() and end_generic().
+    to_generic() and end_generic(). Creates the \ref flat
+    objects of the line segments of this PathContour, see
+    interpolator().
    */
   const reference_counted_ptr<const interpolator_base>&
   prev_interpolator(void);
@@ -440,6 +499,16 @@ public:
   bool
   ended(void) const;
 
+  /*!
+    Returns true if the PathContour has ended and all of
+    its \ref interpolator_base objects are \ref flat, i.e.
+    the PathContour is a polygon. The tessellation of such
+    a PathContour does not depend on the
+    TessellatedPath::TessellationParams.
+   */
+  bool
+  is_flat(void) const;
+
   /*!
     Return the I'th point of this PathContour.
     For I = 0, returns the value passed to start().
@@ -459,11 +528,32 @@ public:
     that interpolates from the I'th point to the
     (I+1)'th point. If I == number_points() - 1,
     then returns the interpolator from the last
-    point to the first point.
+    point to the first point. The line segments added
+    by to_point() and end() are stored only as their
+    points; the first call to interpolator() creates
+    the \ref flat objects for all of them. Hence, the
+    first call modifies the PathContour and must not
+    be made at the same time from several threads.
+    Prefer curve_interpolator() when the \ref flat
+    objects are not needed.
    */
   const reference_counted_ptr<const interpolator_base>&
   interpolator(unsigned int I) const;
 
+  /*!
+    Returns the interpolator of the edge from the I'th point
+    to the (I+1)'th point (or for I == number_points() - 1,
+    from the last point to the first point) if that edge is not
+    a line segment and NULL if it is, i.e. the edge is then the
+    line segment from point(I) to the next point. Unlike
+    interpolator(), does not create the \ref flat objects of
+    the line segments; interpolator_base::prev_interpolator()
+    of the returned object is only valid once interpolator()
+    or prev_interpolator() has been called.
+   */
+  const interpolator_base*
+  curve_interpolator(unsigned int I) const;
+
   /*!
     Returns an approximation of the bounding box for
     this PathContour WITHOUT relying on tessellating
@@ -480,6 +570,22 @@ public:
   bool
   approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const;
 
+  /*!
+    Returns the union of the interpolator_base::tight_bounding_box()
+    of the \ref interpolator_base objects of this PathContour IF
+    this PathContour is ended(), i.e. a bounding box that is exact
+    for lines, arcs, quadratic and cubic curves. The value is
+    computed once, when the PathContour is ended. Returns true if
+    this is ended() and writes the values, otherwise returns false
+    and does not write any value.
+    \param out_min_bb (output) location to which to write the min-x and min-y
+                               coordinates of the tight bounding box.
+    \param out_max_bb (output) location to which to write the max-x and max-y
+                               coordinates of the tight bounding box.
+   */
+  bool
+  tight_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const;
+
   /*!
     Create a deep copy of this PathContour.
    */
@@ -487,6 +593,71 @@ public:
   deep_copy(void);
 
 private:
+  friend class Path;
+
+  void
+  end_contour(reference_counted_ptr<const interpolator_base> p);
+
+  void
+  create_interpolators(void) const;
+
+  void *m_d;
+};
+
+/*!
+  A PathGeometryCache allows Path objects whose geometry is
+  identical to share their TessellatedPath objects, and hence
+  also the StrokedPath and FilledPath objects of those. Each
+  Path that is given the PathGeometryCache (see
+  Path::geometry_cache(const reference_counted_ptr<PathGeometryCache>&))
+  looks up its geometry in the PathGeometryCache when it needs
+  a tessellation; if a Path of the same geometry already made
+  the tessellations, they are used instead of tessellating again,
+  otherwise the tessellations it makes are added for the Paths
+  that come after it. Geometry is identical if the contours have
+  the same points and interpolators of the same type (one of
+  PathContour::flat, PathContour::bezier or PathContour::arc)
+  with the same control points and angles, compared bit for bit;
+  a Path with an interpolator of another type is not shared.
+  The PathGeometryCache keeps the tessellations until clear() is
+  called or it is destroyed. As the reference counts of Path
+  data are not thread safe, all Path objects using the same
+  PathGeometryCache must be used from only one thread at a time.
+ */
+class PathGeometryCache:
+  public reference_counted<PathGeometryCache>::non_concurrent
+{
+public:
+  /*!
+    Ctor.
+   */
+  PathGeometryCache(void);
+
+  ~PathGeometryCache();
+
+  /*!
+    Release all the tessellations the PathGeometryCache keeps;
+    a Path keeps the tessellations that it already uses.
+   */
+  void
+  clear(void);
+
+  /*!
+    Returns the number of distinct geometries of
+    which the PathGeometryCache keeps tessellations.
+   */
+  unsigned int
+  number_entries(void) const;
+
+  /*!
+    Returns the number of times a Path used the
+    tessellations made by a Path of the same geometry.
+   */
+  unsigned int
+  number_hits(void) const;
+
+private:
+  friend class Path;
   void *m_d;
 };
 
@@ -560,6 +731,67 @@ public:
     vec2 m_pt;
   };
 
+  /*!
+    Enumeration of the verbs of the bulk construction
+    of contours by add_contours(const_c_array<enum verb_t>, const_c_array<vec2>, const_c_array<float>).
+    Each verb consumes a fixed number of points and
+    angles, listed with each verb.
+   */
+  enum verb_t
+    {
+      /*!
+        Begin a new contour, ending the current one with
+        a line segment if it is not yet closed; consumes
+        one point.
+       */
+      verb_move,
+
+      /*!
+        Add a control point to the next edge; consumes
+        one point. Used for Bezier curves of degree
+        higher than three.
+       */
+      verb_control_point,
+
+      /*!
+        Line segment to a point; consumes one point.
+       */
+      verb_line,
+
+      /*!
+        Quadratic Bezier curve; consumes two points,
+        the control point and the end point.
+       */
+      verb_quadratic,
+
+      /*!
+        Cubic Bezier curve; consumes three points,
+        the two control points and the end point.
+       */
+      verb_cubic,
+
+      /*!
+        Arc to a point; consumes one point and one angle
+        (in radians, with the same convention as arc).
+       */
+      verb_arc,
+
+      /*!
+        Close the current contour by the edge to its
+        first point. If the last point added is the first
+        point of the contour, the edge added last closes
+        the contour instead of adding a line segment of
+        length zero. Consumes nothing.
+       */
+      verb_close,
+
+      /*!
+        Close the current contour with an arc to its
+        first point; consumes one angle.
+       */
+      verb_close_arc
+    };
+
   /*!
     Tag class to mark the end of an contour
    */
@@ -599,6 +831,15 @@ public:
    */
   Path(const Path &obj);
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+  /*!
+    Move ctor, takes the path data of obj without
+    copying it; obj is then an empty Path.
+    \param obj Path from which to take path data
+   */
+  Path(Path &&obj) noexcept;
+#endif
+
   ~Path();
 
   /*!
@@ -608,6 +849,16 @@ public:
   const Path&
   operator=(const Path &rhs);
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+  /*!
+    Move assignment operator, swaps the path data
+    of this Path with that of rhs.
+    \param rhs value from which to assign.
+   */
+  const Path&
+  operator=(Path &&rhs) noexcept;
+#endif
+
   /*!
     Clear the path, i.e. remove all PathContour's from the
     path
@@ -831,6 +1082,35 @@ public:
   Path&
   add_contours(const Path &path);
 
+  /*!
+    Add contours from packed arrays of verbs, points and
+    arc angles, the format of streamed or memory mapped
+    path data. Each contour is built directly, with the
+    storage of its edges allocated once, and the
+    tessellations of this Path are invalidated only once,
+    making this the preferred way to add large amounts
+    of path data. The verbs must begin with \ref
+    verb_move; a contour that is not closed by \ref
+    verb_close or \ref verb_close_arc when the next
+    contour begins or the verbs end is closed as if by
+    \ref verb_close; verbs after \ref verb_close or \ref
+    verb_close_arc and before the next \ref verb_move are
+    ignored. The contours are added before the
+    current contour of this Path if it is not ended.
+    Returns the number of verbs that were consumed, which
+    is less than verbs.size() only if pts or arc_angles
+    have fewer elements than the verbs require.
+    \param verbs the verbs, see \ref verb_t
+    \param pts the points consumed by the verbs, in order
+    \param arc_angles the angles in radians consumed by the
+                      verbs \ref verb_arc and \ref verb_close_arc,
+                      in order
+   */
+  unsigned int
+  add_contours(const_c_array<enum verb_t> verbs,
+               const_c_array<vec2> pts,
+               const_c_array<float> arc_angles = const_c_array<float>());
+
   /*!
     Returns the number of contours of the Path.
    */
@@ -861,6 +1141,23 @@ public:
   bool
   approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const;
 
+  /*!
+    Returns the union of the PathContour::tight_bounding_box()
+    of the PathContour objects of this Path that are
+    PathContour::ended(). As with approximate_bounding_box(),
+    no TessellatedPath is created. Painter uses the value to
+    skip filling a Path that is outside of the clipping region
+    without tessellating it. Returns true if atleast one PathContour
+    of this Path is PathContour::ended() and writes the values,
+    otherwise returns false and does not write any value.
+    \param out_min_bb (output) location to which to write the min-x and min-y
+                               coordinates of the tight bounding box.
+    \param out_max_bb (output) location to which to write the max-x and max-y
+                               coordinates of the tight bounding box.
+   */
+  bool
+  tight_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const;
+
   /*!
     Return the tessellation of this Path at a specific
     level of detail. The TessellatedPath is constructed
@@ -887,6 +1184,89 @@ public:
   const reference_counted_ptr<const TessellatedPath>&
   tessellation(void) const;
 
+  /*!
+    Set the value returned by tessellation_cache_max_bytes(void) const.
+    \param v value to use
+   */
+  Path&
+  tessellation_cache_max_bytes(unsigned int v);
+
+  /*!
+    Returns the maximum number of bytes, as measured by
+    tessellation_cache_bytes(), of the TessellatedPath
+    objects that this Path keeps. When exceeded, the least
+    recently returned levels of detail of tessellation()
+    are released; the coarsest level and the level being
+    returned are never released. A value of 0 indicates
+    no limit. Default value is 0.
+   */
+  unsigned int
+  tessellation_cache_max_bytes(void) const;
+
+  /*!
+    Returns the sum of TessellatedPath::number_bytes() of
+    the TessellatedPath objects that this Path keeps.
+   */
+  unsigned int
+  tessellation_cache_bytes(void) const;
+
+  /*!
+    Set the value returned by async_tessellation(void) const.
+    \param v value to use
+   */
+  Path&
+  async_tessellation(bool v);
+
+  /*!
+    If true, when tessellation(float) const needs a finer
+    level of detail than what is available, the finer levels
+    (and the StrokedPath and FilledPath of the finest of them)
+    are created in the background, as a task given to
+    TaskExecutor::run_task_async() of default_task_executor(),
+    and the finest level already available is returned instead;
+    the new levels are returned by the calls to
+    tessellation(float) const made after the task is done, see
+    tessellation_pending(). The coarsest level is always created
+    on the calling thread. Changing the geometry discards the
+    work of the task. The task works on a copy of the contours,
+    made when the task is started, so that the Path can be
+    modified while it runs; nevertheless, all methods of a
+    fixed Path must still be called from one thread at a time.
+    If the last contour is not PathContour::ended(), levels are
+    created on the calling thread. Neither the dtor of Path nor
+    a change of geometry waits for the task; a task whose work
+    is discarded frees it when done. Default value is false.
+   */
+  bool
+  async_tessellation(void) const;
+
+  /*!
+    Returns true if a background task started because of
+    async_tessellation(void) const is still creating finer
+    levels of detail.
+   */
+  bool
+  tessellation_pending(void) const;
+
+  /*!
+    Set the value returned by geometry_cache(void) const.
+    \param v value to use, a NULL value indicates to not share
+             tessellations
+   */
+  Path&
+  geometry_cache(const reference_counted_ptr<PathGeometryCache> &v);
+
+  /*!
+    Returns the PathGeometryCache through which this Path shares
+    its tessellations with other Path objects of identical geometry,
+    see PathGeometryCache. A copy of a Path uses the same
+    PathGeometryCache as the Path from which it is copied; note
+    that a copy of a Path already shares the tessellations that
+    the Path has made when it is copied. Default value is NULL.
+   */
+  const reference_counted_ptr<PathGeometryCache>&
+  geometry_cache(void) const;
+
 private:
   void *m_d;
 };
@@ -56,18 +56,23 @@ public:
      */
     TessellationParams(void):
       m_curvature_tessellation(true),
+      m_uniform_tessellation(false),
       m_threshhold(float(M_PI)/30.0f),
-      m_max_segments(32)
+      m_max_segments(32),
+      m_max_threads(1)
     {}
 
     /*!
-      Non-equal comparison operator.
+      Non-equal comparison operator; \ref m_max_threads
+      is not compared since it does not affect the
+      tessellation produced.
       \param rhs value to which to compare against
      */
     bool
     operator!=(const TessellationParams &rhs) const
     {
       return m_curvature_tessellation != rhs.m_curvature_tessellation
+        || m_uniform_tessellation != rhs.m_uniform_tessellation
         || m_threshhold != rhs.m_threshhold
         || m_max_segments != rhs.m_max_segments;
     }
@@ -76,6 +81,7 @@ public:
       Provided as a conveniance. Equivalent to
       \code
       m_curvature_tessellation = true;
+      m_uniform_tessellation = false;
       m_threshhold = p;
       \endcode
       \param p value to which to assign to \ref m_threshhold
@@ -84,6 +90,7 @@ public:
     curvature_tessellate(float p)
     {
       m_curvature_tessellation = true;
+      m_uniform_tessellation = false;
       m_threshhold = p;
       return *this;
     }
@@ -92,6 +99,7 @@ public:
       Provided as a conveniance. Equivalent to
       \code
       m_curvature_tessellation = true;
+      m_uniform_tessellation = false;
       m_threshhold = 2.0f * static_cast<float>(M_PI) / static_cast<float>(N);
       \endcode
       \param N number of points for goal to tessellate a circle to.
@@ -100,6 +108,7 @@ public:
     curvature_tessellate_num_points_in_circle(unsigned int N)
     {
       m_curvature_tessellation = true;
+      m_uniform_tessellation = false;
       m_threshhold = 2.0f * static_cast<float>(M_PI) / static_cast<float>(N);
       return *this;
     }
@@ -108,6 +117,7 @@ public:
       Provided as a conveniance. Equivalent to
       \code
       m_curvature_tessellation = false;
+      m_uniform_tessellation = false;
       m_threshhold = p;
       \endcode
       \param p value to which to assign to \ref m_threshhold
@@ -116,6 +126,25 @@ public:
     curve_distance_tessellate(float p)
     {
       m_curvature_tessellation = false;
+      m_uniform_tessellation = false;
+      m_threshhold = p;
+      return *this;
+    }
+
+    /*!
+      Provided as a conveniance. Equivalent to
+      \code
+      m_curvature_tessellation = false;
+      m_uniform_tessellation = true;
+      m_threshhold = p;
+      \endcode
+      \param p value to which to assign to \ref m_threshhold
+     */
+    TessellationParams&
+    curve_distance_tessellate_uniform(float p)
+    {
+      m_curvature_tessellation = false;
+      m_uniform_tessellation = true;
       m_threshhold = p;
       return *this;
     }
@@ -131,11 +160,42 @@ public:
       return *this;
     }
 
+    /*!
+      Set the value of \ref m_max_threads.
+      \param v value to which to assign to \ref m_max_threads
+     */
+    TessellationParams&
+    max_threads(unsigned int v)
+    {
+      m_max_threads = v;
+      return *this;
+    }
+
     /*!
       Specifies the meaning of \ref m_threshhold.
      */
     bool m_curvature_tessellation;
 
+    /*!
+      Only has effect if \ref m_curvature_tessellation is false.
+      If true, quadratic and cubic Bezier curves are not
+      tessellated by recursive subdivision; instead the number
+      of segments needed for \ref m_threshhold is computed up
+      front with Wang's formula, i.e. the smallest N with
+      \code
+      degree * (degree - 1) * M / (8 * N * N) <= m_threshhold
+      \endcode
+      where M is the largest magnitude of the second differences
+      of the control points, and the curve is evaluated at N + 1
+      uniformly spaced times by forward differencing. The bound
+      is conservative for the whole curve, so the tessellation
+      typically has more points than the recursive tessellation,
+      but it is computed without any branching on the curve data.
+      Other curves are tessellated as if the value were false.
+      Default value is false.
+     */
+    bool m_uniform_tessellation;
+
     /*!
       Meaning depends on \ref m_curvature_tessellation.
        - If m_curvature_tessellation is true, then represents the
@@ -157,10 +217,31 @@ public:
       PathContour of a Path.
      */
     unsigned int m_max_segments;
+
+    /*!
+      Maximum number of threads with which to tessellate
+      the edges of a Path; a value of 0 indicates to use
+      the number of threads of default_task_executor(). The
+      edges are split into contiguous ranges, each a task of
+      default_task_executor(), and the output
+      is identical to tessellating on a single thread. Paths
+      with few edges are always tessellated on the calling
+      thread. The value is also the maximum number of threads
+      with which the FilledPath made from the TessellatedPath
+      triangulates its FilledPath::Subset objects in
+      FilledPath::select_subsets() and FilledPath::subset().
+      Default value is 1.
+     */
+    unsigned int m_max_threads;
   };
 
   /*!
-    Represents point of a tessellated path.
+    Represents point of a tessellated path. A TessellatedPath
+    does not store its points as point values: the values that
+    vary along an edge are stored as separate arrays (see
+    point_positions(), point_derivatives() and
+    point_distances_from_edge_start()) and the lengths once per
+    edge and contour, and edge_point() reconstructs a point.
    */
   class point
   {
@@ -216,6 +297,28 @@ public:
    */
   TessellatedPath(const Path &input, TessellationParams P);
 
+  /*!
+    Ctor. Construct a TessellatedPath from a Path, reusing
+    the tessellation of the leading contours of input that
+    are the same ended PathContour objects, in the same order,
+    as the leading contours from which prev was constructed.
+    The leading contours are not reused if the tessellation
+    parameters of prev differ from P. This is the fast path used
+    by Path::tessellation() when contours are appended to a Path.
+    Independently of P, the tessellation of any contour of prev
+    that is the same PathContour object, at the same index, as
+    a contour of input and is PathContour::is_flat() is copied
+    instead of computed, since the tessellation of a polygon does
+    not depend on the TessellationParams; Path::tessellation()
+    creates each finer level of detail from the previous level
+    for this reason.
+    \param input source path to tessellate
+    \param P parameters on how to tessellate the source Path
+    \param prev TessellatedPath from which to reuse tessellation
+   */
+  TessellatedPath(const Path &input, TessellationParams P,
+                  const TessellatedPath &prev);
+
   ~TessellatedPath();
 
   /*!
@@ -247,10 +350,78 @@ public:
   max_segments(void) const;
 
   /*!
-    Returns all the point data
+    Returns the number of points of the tessellation,
+    i.e. the size of each of point_positions(),
+    point_derivatives() and point_distances_from_edge_start().
+   */
+  unsigned int
+  number_points(void) const;
+
+  /*!
+    Returns the position, point::m_p, of all the points
+    of the tessellation; the ranges of contour_range(),
+    unclosed_contour_range() and edge_range() index into
+    the returned array.
    */
-  const_c_array<point>
-  point_data(void) const;
+  const_c_array<vec2>
+  point_positions(void) const;
+
+  /*!
+    Returns the derivative, point::m_p_t, of all the
+    points of the tessellation, indexed as point_positions().
+   */
+  const_c_array<vec2>
+  point_derivatives(void) const;
+
+  /*!
+    Returns the distance from the start of the edge of each
+    point, point::m_distance_from_edge_start, of all the points
+    of the tessellation, indexed as point_positions().
+   */
+  const_c_array<float>
+  point_distances_from_edge_start(void) const;
+
+  /*!
+    Returns all the values of a point of the tessellation.
+    \param contour contour of the point
+    \param edge edge of the contour of the point
+    \param I index of the point into point_positions(), must
+             be within edge_range(contour, edge)
+   */
+  point
+  edge_point(unsigned int contour, unsigned int edge, unsigned int I) const;
+
+  /*!
+    Returns the length of the named edge of the named
+    contour, i.e. point::m_edge_length of its points.
+   */
+  float
+  edge_length(unsigned int contour, unsigned int edge) const;
+
+  /*!
+    Returns the distance from the start of the named
+    contour to the start of the named edge, i.e. the value
+    to add to the distance from the start of the edge of a
+    point of the edge to get point::m_distance_from_contour_start.
+   */
+  float
+  edge_distance_from_contour_start(unsigned int contour, unsigned int edge) const;
+
+  /*!
+    Returns the length of the named contour without its
+    closing edge, i.e. point::m_open_contour_length of its
+    points.
+   */
+  float
+  open_contour_length(unsigned int contour) const;
+
+  /*!
+    Returns the length of the named contour with its
+    closing edge, i.e. point::m_closed_contour_length of
+    its points.
+   */
+  float
+  closed_contour_length(unsigned int contour) const;
 
   /*!
     Returns the number of contours
@@ -259,7 +430,7 @@ public:
   number_contours(void) const;
 
   /*!
-    Returns the range into point_data()
+    Returns the range into point_positions()
     for the named contour. The contour data is a
     sequence of lines. Points that are shared
     between edges are replicated (because the
@@ -269,7 +440,7 @@ public:
   contour_range(unsigned int contour) const;
 
   /*!
-    Returns the range into point_data()
+    Returns the range into point_positions()
     for the named contour lacking the closing
     edge. The contour data is a sequence of
     lines. Points that are shared between
@@ -279,21 +450,6 @@ public:
   range_type<unsigned int>
   unclosed_contour_range(unsigned int contour) const;
 
-  /*!
-    Returns the point data of the named contour.
-    The contour data is a sequence of lines.
-   */
-  const_c_array<point>
-  contour_point_data(unsigned int contour) const;
-
-  /*!
-    Returns the point data of the named contour
-    lacking the point data of the closing edge.
-    The contour data is a sequence of lines.
-   */
-  const_c_array<point>
-  unclosed_contour_point_data(unsigned int contour) const;
-
   /*!
     Returns the number of edges for the named contour
    */
@@ -301,7 +457,7 @@ public:
   number_edges(unsigned int contour) const;
 
   /*!
-    Returns the range into point_data(void)
+    Returns the range into point_positions()
     for the named edge of the named contour.
     The returned range does include the end
     point of the edge.
@@ -309,13 +465,6 @@ public:
   range_type<unsigned int>
   edge_range(unsigned int contour, unsigned int edge) const;
 
-  /*!
-    Returns the point data of the named edge of the
-    named contour.
-   */
-  const_c_array<point>
-  edge_point_data(unsigned int contour, unsigned int edge) const;
-
   /*!
     Returns the minimum point of the bounding box of
     the tessellation.
@@ -337,6 +486,15 @@ public:
   vec2
   bounding_box_size(void) const;
 
+  /*!
+    Returns the number of bytes used to store the point
+    data and edge ranges of this TessellatedPath; does not
+    include the bytes of the objects returned by stroked()
+    and filled().
+   */
+  unsigned int
+  number_bytes(void) const;
+
   /*!
     Returns this TessellatedPath stroked. The StrokedPath object
     is constructed lazily.
@@ -351,6 +509,22 @@ public:
   const reference_counted_ptr<const FilledPath>&
   filled(void) const;
 
+  /*!
+    Returns a level of detail of filled(), i.e. a FilledPath
+    whose contours are simplified (see the ctor of FilledPath)
+    with the largest tolerance among S/2048, S/1024, ..., S/8
+    that does not exceed the passed tolerance, where S is the
+    larger of the dimensions of bounding_box_size(). If the
+    tolerance is smaller than S/2048, returns filled(). The
+    number of triangles of the returned FilledPath is then
+    bounded by the number of pixels it covers when tolerance
+    is the size of a pixel in the coordinates of the path.
+    Each level is constructed lazily.
+    \param tolerance how far the boundary of the fill may be moved
+   */
+  const reference_counted_ptr<const FilledPath>&
+  filled(float tolerance) const;
+
 private:
   void *m_d;
 };
@@ -87,7 +87,9 @@ namespace fastuidraw
 
     /*!
       To be implemented by a derived class to generate glyph
-      rendering data given a glyph code and GlyphRender.
+      rendering data given a glyph code and GlyphRender. The
+      method may be called from several threads at the same
+      time (see GlyphCache::end_deferred_generation()).
       \param render specifies object to return via GlyphRender::type(),
                     it is guaranteed by the caller that can_create_rendering_data()
                     returns true on render.type()
@@ -100,6 +102,25 @@ namespace fastuidraw
     compute_rendering_data(GlyphRender render, uint32_t glyph_code,
                            GlyphLayoutData &layout, Path &path) const = 0;
 
+    /*!
+      To be optionally implemented by a derived class to compute
+      only the GlyphLayoutData of a glyph, i.e. the same value
+      compute_rendering_data() gives with the same arguments,
+      without generating the rendering data. The default
+      implementation calls compute_rendering_data() and
+      discards the rendering data. The method may be called
+      from several threads at the same time.
+      \param render specifies the glyph rendering type, it is guaranteed
+                    by the caller that can_create_rendering_data()
+                    returns true on render.type()
+      \param glyph_code glyph code of glyph
+      \param[out] layout location to which to place the GlyphLayoutData for the glyph
+     */
+    virtual
+    void
+    compute_layout_data(GlyphRender render, uint32_t glyph_code,
+                        GlyphLayoutData &layout) const;
+
   private:
     FontProperties m_props;
   };
@@ -0,0 +1,87 @@
+/*!
+ * \file font_file_data.hpp
+ * \brief file font_file_data.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/util/c_array.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Text
+  @{
+*/
+
+  /*!
+    A FontFileData holds the contents of a font file in
+    memory so that fonts (for example the faces of a
+    FontFreeType) created from it can share it without
+    reading or copying the file again. Where supported,
+    the file is memory mapped read-only, so that only the
+    pages of the file that are used are read and they are
+    shared with other processes mapping the same file;
+    otherwise the file is read into memory. The data is
+    never modified after construction, so a FontFileData
+    can be used from several threads at the same time.
+   */
+  class FontFileData:public reference_counted<FontFileData>::default_base
+  {
+  public:
+    /*!
+      Ctor. Map (or read) the contents of a file. If the
+      file cannot be opened, valid() returns false.
+      \param filename name of the file
+     */
+    explicit
+    FontFileData(const char *filename);
+
+    ~FontFileData();
+
+    /*!
+      Returns true if the file was mapped (or read)
+      successfully.
+     */
+    bool
+    valid(void) const;
+
+    /*!
+      Returns the contents of the file.
+     */
+    const_c_array<uint8_t>
+    data(void) const;
+
+    /*!
+      Returns the name of the file passed to the ctor.
+     */
+    const char*
+    filename(void) const;
+
+    /*!
+      Returns true if data() is a memory mapping of
+      the file rather than a copy of its contents.
+     */
+    bool
+    memory_mapped(void) const;
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+}
@@ -26,6 +26,7 @@
 
 #include <fastuidraw/text/font.hpp>
 #include <fastuidraw/text/freetype_lib.hpp>
+#include <fastuidraw/text/font_file_data.hpp>
 
 namespace fastuidraw
 {
@@ -103,6 +104,70 @@ namespace fastuidraw
       RenderParams&
       distance_field_max_distance(float v);
 
+      /*!
+        Enumeration to specify how the values of
+        distance field glyphs are computed.
+       */
+      enum distance_field_generator_t
+        {
+          /*!
+            Compute the distance from each texel to the
+            curves of the glyph outline directly. Distances
+            are computed along the rows and columns of
+            the texels and to the end points of the curves,
+            so they can be larger than the Euclidean distance
+            where the boundary is not horizontal or vertical.
+           */
+          outline_distance_field_generator,
+
+          /*!
+            Render the glyph to a coverage bitmap that is
+            distance_field_supersample() times the resolution
+            of the distance field and compute the exact
+            Euclidean distance transform of it. The distances
+            are Euclidean, but the boundary of the glyph is only
+            accurate to a pixel of the supersampled bitmap and
+            generation is slower than with
+            \ref outline_distance_field_generator.
+           */
+          distance_transform_distance_field_generator,
+        };
+
+      /*!
+        Specifies how the values of distance field
+        glyphs are computed.
+       */
+      enum distance_field_generator_t
+      distance_field_generator(void) const;
+
+      /*!
+        Set the value returned by distance_field_generator(void) const,
+        initial value is \ref outline_distance_field_generator.
+        \param v value
+       */
+      RenderParams&
+      distance_field_generator(enum distance_field_generator_t v);
+
+      /*!
+        Only has effect when distance_field_generator() is
+        \ref distance_transform_distance_field_generator;
+        gives the factor by which to supersample the coverage
+        bitmap from which the distance field is computed.
+       */
+      unsigned int
+      distance_field_supersample(void) const;
+
+      /*!
+        Set the value returned by distance_field_supersample(void) const,
+        initial value is 5. Odd values are best because then the
+        center of each texel of the distance field is the center
+        of a pixel of the supersampled bitmap. A value of 0 is
+        treated as 1.
+        \param v value
+       */
+      RenderParams&
+      distance_field_supersample(unsigned int v);
+
       /*!
         Pixel size at which to render curve pair scalable glyphs.
        */
@@ -117,6 +182,96 @@ namespace fastuidraw
       RenderParams&
       curve_pair_pixel_size(unsigned int v);
 
+      /*!
+        Pixel size at which to load the outlines of banded
+        curves scalable glyphs; it determines the pixel size
+        of the GlyphLayoutData of those glyphs.
+       */
+      unsigned int
+      banded_curves_pixel_size(void) const;
+
+      /*!
+        Set the value returned by banded_curves_pixel_size(void) const,
+        initial value is 64
+        \param v value
+       */
+      RenderParams&
+      banded_curves_pixel_size(unsigned int v);
+
+      /*!
+        Maximum number of horizontal bands and of vertical
+        bands into which a banded curves glyph is divided.
+        A glyph with N curves is divided into about sqrt(N)
+        bands in each direction, up to this value; more bands
+        mean fewer curves per fragment, but more curves
+        duplicated across bands.
+       */
+      unsigned int
+      banded_curves_max_number_bands(void) const;
+
+      /*!
+        Set the value returned by banded_curves_max_number_bands(void) const,
+        initial value is 8. A value of 0 is treated as 1.
+        \param v value
+       */
+      RenderParams&
+      banded_curves_max_number_bands(unsigned int v);
+
+      /*!
+        Pixel size at which to create multi-channel signed
+        distance field glyphs. Because the corners of those
+        glyphs stay sharp when magnified, this can be much
+        smaller than distance_field_pixel_size().
+       */
+      unsigned int
+      msdf_pixel_size(void) const;
+
+      /*!
+        Set the value returned by msdf_pixel_size(void) const,
+        initial value is 24
+        \param v value
+       */
+      RenderParams&
+      msdf_pixel_size(unsigned int v);
+
+      /*!
+        The maximum distance, in units of 1/64 of a pixel,
+        stored in the channels of multi-channel signed distance
+        field glyphs, see distance_field_max_distance().
+       */
+      float
+      msdf_max_distance(void) const;
+
+      /*!
+        Set the value returned by msdf_max_distance(void) const,
+        initial value is 128.0, i.e. 2 pixels
+        \param v value
+       */
+      RenderParams&
+      msdf_max_distance(float v);
+
+      /*!
+        Maximum number of FT_Face objects a FontFreeType
+        created from a file (see FontFreeType::create())
+        opens so that the rendering data of different glyphs
+        can be generated from different threads at the same
+        time (see GlyphSelector::glyph_generation_threads()).
+        The faces beyond the first are only opened when
+        glyph data is requested while all open faces are in
+        use. A value of 0 indicates to use the number of
+        threads of default_task_executor().
+       */
+      unsigned int
+      max_number_faces(void) const;
+
+      /*!
+        Set the value returned by max_number_faces(void) const,
+        initial value is 0.
+        \param v value
+       */
+      RenderParams&
+      max_number_faces(unsigned int v);
+
     private:
       void *m_d;
     };
@@ -162,8 +317,61 @@ namespace fastuidraw
     FontFreeType(FT_Face pface, reference_counted_ptr<FreetypeLib> lib,
                  const RenderParams &render_params = RenderParams());
 
+    /*!
+      Ctor. Create a font from the data of a font file and guess the
+      FontProperties from the FT_Face. The face (and the faces the font
+      opens to generate glyph data from several threads, see
+      RenderParams::max_number_faces()) are created with FT_New_Memory_Face()
+      directly from data, so fonts of several faces of the same
+      FontFileData share its memory and cost no additional reads.
+      The font retains a reference to data.
+      \param data data of the font file from which to load the font
+      \param lib FreetypeLib used to create FreeTypeFont object
+      \param render_params specifies how to generate data for scalable glyph data
+      \param face_index face index for face into font file to load
+     */
+    static
+    reference_counted_ptr<FontFreeType>
+    create(reference_counted_ptr<const FontFileData> data,
+           reference_counted_ptr<FreetypeLib> lib,
+           const RenderParams &render_params = RenderParams(),
+           int face_index = 0);
+
+    /*!
+      Ctor. Create a font from the data of a font file and guess the
+      FontProperties from the FT_Face, see
+      create(reference_counted_ptr<const FontFileData>, reference_counted_ptr<FreetypeLib>, const RenderParams&, int).
+      The font created will use its own private \ref FreetypeLib object.
+      \param data data of the font file from which to load the font
+      \param render_params specifies how to generate data for scalable glyph data
+      \param face_index face index for face into font file to load
+     */
+    static
+    reference_counted_ptr<FontFreeType>
+    create(reference_counted_ptr<const FontFileData> data,
+           const RenderParams &render_params = RenderParams(),
+           int face_index = 0);
+
+    /*!
+      Create fonts from all faces of the data of a font file,
+      all sharing data. Returns the number of faces that are
+      in the font file.
+      \param fonts location to which to place handles to new fonts
+      \param data data of the font file from which to load the fonts
+      \param lib FreetypeLib used to create FreeTypeFont objects
+      \param render_params specifies how to generate data for scalable glyph data
+     */
+    static
+    int
+    create(c_array<reference_counted_ptr<FontFreeType> > fonts,
+           reference_counted_ptr<const FontFileData> data,
+           reference_counted_ptr<FreetypeLib> lib,
+           const RenderParams &render_params = RenderParams());
+
     /*!
       Ctor. Create a font from file and guess the FontProperties from the FT_Face.
+      The file is loaded as a FontFileData, see
+      create(reference_counted_ptr<const FontFileData>, reference_counted_ptr<FreetypeLib>, const RenderParams&, int).
       \param filename from which to load the font
       \param lib FreetypeLib used to create FreeTypeFont object
       \param render_params specifies how to generate data for scalable glyph data
@@ -189,7 +397,8 @@ namespace fastuidraw
            int face_index = 0);
 
     /*!
-      Create fonts from all faces of a font file.
+      Create fonts from all faces of a font file, the file
+      is loaded once as a FontFileData shared by the fonts.
       Returns the number of faces that are in font file.
       \param fonts location to which to place handles to new fonts
       \param filename from which to load the fonts
@@ -246,6 +455,11 @@ namespace fastuidraw
     compute_rendering_data(GlyphRender render, uint32_t glyph_code,
                            GlyphLayoutData &layout, Path &path) const;
 
+    virtual
+    void
+    compute_layout_data(GlyphRender render, uint32_t glyph_code,
+                        GlyphLayoutData &layout) const;
+
   private:
     void *m_d;
   };
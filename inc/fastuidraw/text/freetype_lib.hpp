@@ -67,8 +67,25 @@ namespace fastuidraw
       return m_lib != NULL;
     }
 
+    /*!
+      Lock the mutex of this FreetypeLib. Creating and
+      destroying FT_Face objects from lib() is not thread
+      safe, so those calls are to be made with the mutex
+      locked when FT_Face objects of lib() are used from
+      different threads.
+     */
+    void
+    lock(void);
+
+    /*!
+      Unlock the mutex of this FreetypeLib, see lock().
+     */
+    void
+    unlock(void);
+
   private:
     FT_Library m_lib;
+    void *m_mutex;
   };
 /*! @} */
 };
@@ -69,6 +69,16 @@ namespace fastuidraw
     enum glyph_type
     type(void) const;
 
+    /*!
+      Returns the GlyphRender with which the glyph was
+      created, i.e. its type() together with the pixel
+      size and subpixel offset of coverage glyphs. valid()
+      must return true. If not, debug builds assert and
+      release builds crash.
+     */
+    GlyphRender
+    renderer(void) const;
+
     /*!
       Returns the glyph's layout data, valid()
       must return true. If not, debug builds assert
@@ -125,6 +135,20 @@ namespace fastuidraw
     unsigned int
     cache_location(void) const;
 
+    /*!
+      Returns a value that changes each time the glyph is
+      removed from its GlyphCache (see GlyphCache::delete_glyph()
+      and GlyphCache::clear_cache()). The GlyphCache reuses the
+      storage of a removed glyph for the glyphs it creates later,
+      so a Glyph value whose generation() differs from the value
+      it had when it was fetched no longer refers to the glyph
+      that was fetched and is to be fetched again. Unlike the
+      other methods, may be called after the glyph is removed;
+      the GlyphCache of the glyph must still exist.
+     */
+    unsigned int
+    generation(void) const;
+
     /*!
       If returns \ref routine_fail, then the GlyphCache
       on which the glyph resides needs to be cleared
@@ -140,6 +164,19 @@ namespace fastuidraw
     const Path&
     path(void) const;
 
+    /*!
+      Returns the number of texels of the rendering data of
+      the glyph at which the glyph is only approximated, see
+      GlyphRenderDataCurvePair::number_approximated_texels().
+      Only glyphs of type \ref curve_pair_glyph can have such
+      texels; for glyphs of other types, and glyphs whose
+      rendering data is not yet generated, returns 0. The
+      return value of valid() must be true. If not, debug
+      builds assert and release builds crash.
+     */
+    unsigned int
+    number_approximated_texels(void) const;
+
     /* How to use: when printing a bunch of glyphs do this:
         for(each glyph G)
           {
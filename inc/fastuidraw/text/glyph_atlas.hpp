@@ -36,9 +36,14 @@ namespace fastuidraw
     store for one-channel 8-bit data (for glyphs essentially). The values
     stored can be coverage values, distance values or index values.
     Index values are to be fetched unfiltered and other values filtered
-    (but NO mipmap filtering). An implementation of the class does NOT
-    need to be thread safe because the user of the backing store (GlyphAtlas)
-    performs calls to the backing store behind its own mutex.
+    (but NO mipmap filtering). A backing store can optionally hold 16-bit
+    texels (see sixteen_bit()), where the 8-bit data of set_data() goes to
+    the low byte and set_data16() sets both bytes; glyph data of more
+    than 8-bits per texel can then be fetched with a single fetch from a
+    single region instead of from two regions. An implementation of the
+    class does NOT need to be thread safe because the user of the backing
+    store (GlyphAtlas) performs calls to the backing store behind its own
+    mutex.
    */
   class GlyphAtlasTexelBackingStoreBase:
     public reference_counted<GlyphAtlasTexelBackingStoreBase>::default_base
@@ -48,8 +53,11 @@ namespace fastuidraw
       Ctor.
       \param whl provides the dimensions of the GlyphAtlasBackingStoreBase
       \param presizable if true the object can be resized to be larger
+      \param psixteen_bit if true the texels of the store are 16-bit
+                          (see sixteen_bit())
      */
-    GlyphAtlasTexelBackingStoreBase(ivec3 whl, bool presizable);
+    GlyphAtlasTexelBackingStoreBase(ivec3 whl, bool presizable,
+                                    bool psixteen_bit = false);
 
     /*!
       Ctor.
@@ -57,8 +65,11 @@ namespace fastuidraw
       \param h height of the backing store
       \param l number of layers of the backing store
       \param presizable if true the object can be resized to be larger
+      \param psixteen_bit if true the texels of the store are 16-bit
+                          (see sixteen_bit())
      */
-    GlyphAtlasTexelBackingStoreBase(int w, int h, int l, bool presizable);
+    GlyphAtlasTexelBackingStoreBase(int w, int h, int l, bool presizable,
+                                    bool psixteen_bit = false);
 
     virtual
     ~GlyphAtlasTexelBackingStoreBase();
@@ -77,6 +88,22 @@ namespace fastuidraw
     set_data(int x, int y, int l, int w, int h,
              const_c_array<uint8_t> data)=0;
 
+    /*!
+      To be implemented by a derived class whose sixteen_bit()
+      returns true to set 16-bit data into the backing store;
+      the default implementation asserts.
+      \param x horizontal position
+      \param y vertical position
+      \param l layer of position
+      \param w width of data
+      \param h height of data
+      \param data 16-bit values
+     */
+    virtual
+    void
+    set_data16(int x, int y, int l, int w, int h,
+               const_c_array<uint16_t> data);
+
     /*!
       To be implemented by a derived class
       to flush set_data() to the backing
@@ -86,6 +113,28 @@ namespace fastuidraw
     void
     flush(void) = 0;
 
+    /*!
+      To be implemented by a derived class to copy a region
+      of the backing store to another region of the backing
+      store; the regions do not overlap. The copy is to act
+      as if it is performed after all previous calls to
+      set_data() and before all later calls to set_data(),
+      i.e. an implementation that delays set_data() to
+      flush() must also delay the copy.
+      \param src_x horizontal position of the region to copy
+      \param src_y vertical position of the region to copy
+      \param src_l layer of the region to copy
+      \param w width of the region
+      \param h height of the region
+      \param dst_x horizontal position to which to copy the region
+      \param dst_y vertical position to which to copy the region
+      \param dst_l layer to which to copy the region
+     */
+    virtual
+    void
+    copy_data(int src_x, int src_y, int src_l, int w, int h,
+              int dst_x, int dst_y, int dst_l) = 0;
+
     /*!
       Returns the dimensions of the backing store
       (as passed in the ctor).
@@ -101,7 +150,16 @@ namespace fastuidraw
     resizeable(void) const;
 
     /*!
-      Resize the object by increasing the number of layers.
+      Returns true if and only if the texels of this object
+      are 16-bit, i.e. if set_data16() can be used.
+     */
+    bool
+    sixteen_bit(void) const;
+
+    /*!
+      Resize the object by changing the number of layers.
+      Decreasing the number of layers discards the texels of
+      the removed layers (see GlyphAtlas::shrink_texel_store()).
       The routine resizeable() must return true, if not
       the function asserts.
      */
@@ -113,7 +171,8 @@ namespace fastuidraw
     /*!
       To be implemented by a derived class to resize the
       object. The resize changes ONLY the number of layers
-      of the object and only increases the value as well.
+      of the object; when the number of layers decreases
+      the texels of the remaining layers must be kept.
       When called, the return value of dimensions() is
       the size before the resize completes.
       \param new_num_layers new number of layers to which
@@ -223,7 +282,13 @@ namespace fastuidraw
     A GlyphAtlas is a common location to place glyph data of
     an application. Ideally, all glyph data is placed into a
     single GlyphAtlas. Methods of GlyphAtlas are thread
-    safe, locked behind a mutex of the GlyphAtlas.
+    safe. The atlas is locked in parts: each layer of the
+    texel store is locked on its own while a region is
+    allocated from it, and the calls to the texel store
+    and to the geometry store are each locked behind their
+    own mutex; hence threads uploading glyphs at the same
+    time only wait on each other when they allocate from
+    the same layer or are writing data to the same store.
    */
   class GlyphAtlas:
     public reference_counted<GlyphAtlas>::default_base
@@ -287,6 +352,19 @@ namespace fastuidraw
     GlyphLocation
     allocate(ivec2 size, const_c_array<uint8_t> data, const Padding &padding);
 
+    /*!
+      Allocate a rectangular region with 16-bit data; the
+      texel store (see texel_store()) must have that
+      GlyphAtlasTexelBackingStoreBase::sixteen_bit() returns
+      true. If allocation is not possible, return a GlyphLocation
+      where GlyphLocation::valid() return false.
+      \param size size of region to allocate
+      \param data data to which to set the region allocated
+      \param padding amount of padding the passed data has
+     */
+    GlyphLocation
+    allocate(ivec2 size, const_c_array<uint16_t> data, const Padding &padding);
+
     /*!
       Free a region previously allocated by allocate().
       \param G region to free as returned by allocate().
@@ -294,6 +372,49 @@ namespace fastuidraw
     void
     deallocate(GlyphLocation G);
 
+    /*!
+      Move a region previously allocated by allocate() to
+      a layer of the texel store other than a named layer.
+      The texels of the region are copied on the texel store
+      with GlyphAtlasTexelBackingStoreBase::copy_data(), the
+      texel store is never resized. On success the region G
+      is freed and the new region is returned; on failure
+      G is unchanged and a GlyphLocation where
+      GlyphLocation::valid() returns false is returned.
+      \param G region to move as returned by allocate()
+      \param excluded_layer layer in which NOT to place the region
+      \param number_layers if non-negative, only the layers less
+                           than number_layers are considered
+     */
+    GlyphLocation
+    relocate(GlyphLocation G, int excluded_layer, int number_layers = -1);
+
+    /*!
+      Shrink the texel store to a number of layers, giving the
+      memory of the removed layers back; this is the last step
+      of trimming the atlas after a peak of use, see
+      GlyphCache::trim_atlas(). The removed layers must have no
+      texels allocated, i.e. their regions must have been freed
+      or moved (see relocate()) to the remaining layers first;
+      regions of size zero on a removed layer are not counted
+      and must not be used after the call. Returns routine_fail
+      and does nothing if a removed layer has texels allocated
+      or the texel store is not resizeable.
+      \param number_layers number of layers to keep, must be
+                           at least 1
+     */
+    enum return_code
+    shrink_texel_store(int number_layers);
+
+    /*!
+      Returns the number of texels, including padding, of
+      the regions allocated by allocate() on a layer of the
+      texel store.
+      \param layer layer of the texel store
+     */
+    int
+    number_texels_allocated(int layer) const;
+
     /*!
       Negative return value indicates failure.
       Size of pdata must be a multiple of geometry_store()->alignment().
@@ -313,6 +434,31 @@ namespace fastuidraw
     void
     clear(void);
 
+    /*!
+      Set the height up to which regions are allocated on
+      shelves instead of in the tree of free rectangles. A
+      shelf is a strip the width of the texel store holding
+      regions of (about) the same height side by side; glyphs
+      of a single pixel size rendered as coverage or distance
+      fields are nearly uniform in height and pack much more
+      tightly on shelves, and allocating or freeing one is far
+      cheaper than splitting or merging tree nodes. The height
+      of a region (including its padding) is rounded up to a
+      multiple of 4 to select its shelf. Regions already
+      allocated are not moved. Default value is 0, i.e. no
+      shelves.
+      \param v maximum height (in texels, including padding)
+                of the regions to place on shelves
+     */
+    void
+    shelf_max_height(int v);
+
+    /*!
+      Returns the value set by shelf_max_height(int).
+     */
+    int
+    shelf_max_height(void) const;
+
     /*!
       Calls GlyphAtlasTexelBackingStoreBase::flush() on
       the texel backing store (see texel_store())
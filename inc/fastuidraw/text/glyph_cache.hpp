@@ -19,7 +19,10 @@
 
 #pragma once
 
+#include <vector>
+#include <stdint.h>
 #include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/util/c_array.hpp>
 #include <fastuidraw/text/glyph_atlas.hpp>
 #include <fastuidraw/text/font.hpp>
 #include <fastuidraw/text/glyph_layout_data.hpp>
@@ -38,6 +41,61 @@ namespace fastuidraw
   class GlyphCache:public reference_counted<GlyphCache>::default_base
   {
   public:
+    /*!
+      Enumeration to query the statistics of
+      the GlyphCache, see query_stat().
+     */
+    enum stats_t
+      {
+        /*!
+          Offset to how many calls to fetch_glyph()
+          found the glyph already in the cache.
+         */
+        num_hits,
+
+        /*!
+          Offset to how many calls to fetch_glyph()
+          had to create the rendering data of the
+          glyph.
+         */
+        num_misses,
+
+        /*!
+          Offset to how many times the data of a glyph
+          was uploaded to the GlyphAtlas, see
+          Glyph::upload_to_atlas().
+         */
+        num_uploads,
+
+        /*!
+          Offset to how many glyphs had their data
+          removed from the GlyphAtlas to make room
+          for the upload of another glyph or to shrink
+          the GlyphAtlas, see begin_frame() and trim_atlas().
+         */
+        num_evictions,
+
+        /*!
+          Offset to how many times the data of a glyph
+          was moved within the GlyphAtlas, see
+          compact_atlas() and trim_atlas().
+         */
+        num_relocations,
+
+        /*!
+          Offset to how many calls to fetch_glyph_layout()
+          had to compute the layout data of the glyph,
+          i.e. found neither the glyph nor its layout
+          data in the cache.
+         */
+        num_layout_misses,
+
+        /*!
+          Number of stats.
+         */
+        num_stats,
+      };
+
     /*!
       Ctor
       \param patlas GlyphAtlas to store glyph data
@@ -57,6 +115,91 @@ namespace fastuidraw
                 const reference_counted_ptr<const FontBase> &font,
                 uint32_t glyph_code);
 
+    /*!
+      Request that the rendering data of a glyph is generated
+      in the background, by a task of default_task_executor()
+      (see TaskExecutor::run_task_async()); the requests are
+      processed in the order they are made, in batches whose
+      glyphs are generated in parallel by the threads of
+      default_task_executor(). A
+      later call to fetch_glyph() on the glyph waits for its
+      data to be generated if it is not yet done, whereas
+      fetch_glyph_if_ready() does not. Does nothing if the
+      glyph is already in the GlyphCache. Because the data is
+      generated from a different thread, FontBase::compute_rendering_data()
+      of font may be called from several threads at the same time.
+      \param render how to render the glyph
+      \param font font of the glyph
+      \param glyph_code glyph code of the glyph
+     */
+    void
+    prefetch_glyph(GlyphRender render,
+                   const reference_counted_ptr<const FontBase> &font,
+                   uint32_t glyph_code);
+
+    /*!
+      Fetch a glyph only if its rendering data is already
+      generated, i.e. the glyph was fetched with fetch_glyph()
+      or its prefetch (see prefetch_glyph()) is done. Never
+      generates rendering data nor waits for a prefetch,
+      instead returns an invalid Glyph.
+      \param render how to render the glyph
+      \param font font of the glyph
+      \param glyph_code glyph code of the glyph
+     */
+    Glyph
+    fetch_glyph_if_ready(GlyphRender render,
+                         const reference_counted_ptr<const FontBase> &font,
+                         uint32_t glyph_code);
+
+    /*!
+      Fetch only the GlyphLayoutData of a glyph, for example to
+      measure text, without generating its rendering data. If
+      the glyph was fetched with fetch_glyph() and its rendering
+      data is generated, returns its layout; otherwise the layout
+      data is computed with FontBase::compute_layout_data() and
+      kept in the GlyphCache, apart from the glyphs, so that
+      fetching it again does not compute it again. The rendering
+      data of the glyph is generated only when it is fetched with
+      fetch_glyph(), i.e. when the glyph is to be drawn. The
+      layout data kept is discarded by clear_cache(). Returns a
+      default constructed GlyphLayoutData if font cannot create
+      glyphs rendered as render.
+      \param render how the glyph is to be rendered; the layout
+                    of a glyph depends on its rendering type
+      \param font font of the glyph
+      \param glyph_code glyph code of the glyph
+     */
+    GlyphLayoutData
+    fetch_glyph_layout(GlyphRender render,
+                       const reference_counted_ptr<const FontBase> &font,
+                       uint32_t glyph_code);
+
+    /*!
+      Start deferring the generation of glyph rendering data:
+      until end_deferred_generation() is called, fetch_glyph()
+      does not generate the rendering data of a glyph that is
+      not yet in the GlyphCache, instead that data is generated
+      by end_deferred_generation(). A Glyph value returned by
+      fetch_glyph() while deferring is only to be stored until
+      end_deferred_generation() is called. Neither delete_glyph()
+      nor clear_cache() is to be called while deferring.
+     */
+    void
+    begin_deferred_generation(void);
+
+    /*!
+      Generate the rendering data of the glyphs fetched by
+      fetch_glyph() since begin_deferred_generation() with
+      up to max_threads threads, thus FontBase::compute_rendering_data()
+      may be called from several threads at the same time.
+      \param max_threads maximum number of threads, a value of 0
+                         indicates to use the number of threads
+                         of default_task_executor()
+     */
+    void
+    end_deferred_generation(unsigned int max_threads);
+
     /*!
       Removes a glyph from the -CACHE-, i.e. the GlyphCache,
       thus to use that glyph again requires calling fetch_glyph()
@@ -65,6 +208,175 @@ namespace fastuidraw
     void
     delete_glyph(Glyph);
 
+    /*!
+      Returns the version of the blob format written by
+      bake_glyphs() and read by load_baked_glyphs(). A blob
+      written with a different version is rejected by
+      load_baked_glyphs().
+     */
+    static
+    uint32_t
+    baked_glyphs_blob_version(void);
+
+    /*!
+      Write the GlyphLayoutData, Glyph::path() and rendering
+      data (the texels and geometry data of coverage, distance
+      field and curve pair glyphs) of glyphs to a blob so that
+      an application can generate glyph data offline and add
+      it to a GlyphCache with load_baked_glyphs() without
+      calling FontBase::compute_rendering_data(). The glyphs
+      are fetched with fetch_glyph(), so those not yet in this
+      GlyphCache are generated. A glyph is skipped if its
+      rendering data is not a GlyphRenderDataCoverage,
+      GlyphRenderDataDistanceField or GlyphRenderDataCurvePair
+      or if its path has interpolators other than
+      PathContour::flat and PathContour::bezier. Returns
+      the number of glyphs written. The blob is a sequence
+      of 32-bit little-endian words.
+      \param dst location to which to write the blob
+      \param render how to render the glyphs
+      \param font font of the glyphs
+      \param glyph_codes glyph codes of the glyphs
+     */
+    unsigned int
+    bake_glyphs(std::vector<uint8_t> &dst, GlyphRender render,
+                const reference_counted_ptr<const FontBase> &font,
+                const_c_array<uint32_t> glyph_codes);
+
+    /*!
+      Add the glyphs of a blob written by bake_glyphs() to
+      this GlyphCache as glyphs of a font and upload them to
+      the GlyphAtlas. The font is to be the same font (i.e.
+      the same face with the same parameters) from which
+      the blob was baked, since the glyphs are then fetched
+      with fetch_glyph() passing that font. The data is
+      copied out of the blob, so the blob (for example a
+      memory mapped file) need not stay valid after the call.
+      A glyph of the blob that is already in this GlyphCache
+      is not changed. Returns the number of glyphs added or
+      -1 if the blob is malformed or of a different version
+      than baked_glyphs_blob_version(), in which case no glyph
+      is added.
+      \param blob bytes written by bake_glyphs()
+      \param font font of the glyphs
+     */
+    int
+    load_baked_glyphs(const_c_array<uint8_t> blob,
+                      const reference_counted_ptr<const FontBase> &font);
+
+    /*!
+      Returns the version of the blob format written by
+      write_usage_profile() and read by prefetch_usage_profile().
+     */
+    static
+    uint32_t
+    usage_profile_version(void);
+
+    /*!
+      Write the keys, i.e. the font, glyph code and GlyphRender,
+      of the glyphs of this GlyphCache to a blob so that the
+      next run of an application can prefetch them at start-up
+      with prefetch_usage_profile() before they are drawn. Only
+      the keys are written, not the glyph data; the font of a key
+      is written as its index into fonts and the glyphs of fonts
+      not in fonts are skipped. The keys are written in the order
+      the glyphs were added to the GlyphCache, roughly the order
+      in which they were first needed. Returns the number of keys
+      written. The blob is a sequence of 32-bit little-endian words.
+      \param dst location to which to write the blob
+      \param fonts fonts whose glyphs to write
+     */
+    unsigned int
+    write_usage_profile(std::vector<uint8_t> &dst,
+                        const_c_array<reference_counted_ptr<const FontBase> > fonts) const;
+
+    /*!
+      Prefetch (see prefetch_glyph()) the glyphs of a blob
+      written by write_usage_profile(), so that their rendering
+      data is generated in the background before the glyphs
+      are needed. The font of a key is the element of fonts at
+      the index written, so fonts is to list the same fonts in
+      the same order as passed to write_usage_profile(); keys
+      whose index is not in fonts are skipped. Returns the number
+      of keys of the blob that were not skipped, or -1 if the blob
+      is malformed or of a different version than
+      usage_profile_version(), in which case no glyph is
+      prefetched.
+      \param blob bytes written by write_usage_profile()
+      \param fonts fonts of the glyphs
+     */
+    int
+    prefetch_usage_profile(const_c_array<uint8_t> blob,
+                           const_c_array<reference_counted_ptr<const FontBase> > fonts);
+
+    /*!
+      Call to mark the start of a frame. When the GlyphAtlas
+      is too full to upload a glyph (see Glyph::upload_to_atlas()),
+      the GlyphCache removes from the GlyphAtlas the data of the
+      glyphs that have not been used for the longest time, least
+      recently used first, until the upload succeeds. A glyph is
+      used when it is returned by fetch_glyph() or uploaded with
+      Glyph::upload_to_atlas(); the glyphs used since the last
+      call to begin_frame() are never removed. A removed glyph
+      is NOT removed from the GlyphCache, i.e. its Glyph value
+      is still valid, but it needs to be re-uploaded with
+      Glyph::upload_to_atlas(). If begin_frame() is never called,
+      all glyphs are considered used in the current frame and no
+      glyph is removed from the GlyphAtlas.
+     */
+    void
+    begin_frame(void);
+
+    /*!
+      Perform a step of compacting the GlyphAtlas. Removing glyphs
+      from the GlyphAtlas (see begin_frame()) fragments the free
+      room of the layers of the texel store so that uploads fail,
+      or grow the texel store, even though the total free room
+      is plenty. A compaction empties a sparsely used layer of the
+      texel store by moving its glyphs to the free room of the other
+      layers (see GlyphAtlas::relocate()); the emptied layer is then
+      unfragmented. A compaction is only started when no layer of the
+      texel store is empty and is spread over as many calls to
+      compact_atlas() as needed to keep each call within a budget.
+      Moving a glyph changes its Glyph::atlas_location() and
+      Glyph::secondary_atlas_location(), thus attribute data packed
+      from the glyph needs to be packed again (see
+      GlyphRun::refresh_atlas_locations()). Since the texels of the
+      old locations may be overwritten by later uploads, the function
+      should be called at the start of a frame, before any glyphs are
+      drawn. Returns the number of glyphs moved.
+      \param max_texels the number of texels, including padding, after
+                        moving which no more glyphs are moved
+     */
+    unsigned int
+    compact_atlas(unsigned int max_texels);
+
+    /*!
+      Shrink the texel store of the GlyphAtlas to give memory
+      back after a peak of use, for example from a callback
+      of the application on memory pressure (see
+      memory::budget_callback). The number of layers to keep
+      is the number of whole layers that fit in target_bytes,
+      but at least one. The glyphs on the layers to remove
+      that were not used since the last call to begin_frame()
+      are removed from the GlyphAtlas and the other glyphs
+      on them are moved to the layers to keep (see
+      GlyphAtlas::relocate()); to make room for these, glyphs
+      on the layers to keep that were not used since the last
+      call to begin_frame() are removed, least recently used
+      first. The texel store is then shrunk to the last layer
+      that still has glyphs, see GlyphAtlas::shrink_texel_store().
+      As with compact_atlas(), moving a glyph changes its atlas
+      locations and the function should be called at the start
+      of a frame. The geometry store of the GlyphAtlas is not
+      shrunk. Returns the number of bytes of the texel store
+      after the call.
+      \param target_bytes number of bytes of texel store to
+                          which to shrink
+     */
+    uint64_t
+    trim_atlas(uint64_t target_bytes);
+
     /*!
       Call to clear the backing GlyphAtlas. In doing so, the glyphs
       will no longer be uploaded to the GlyphAtlas and will need
@@ -79,10 +391,31 @@ namespace fastuidraw
 
     /*!
       Clear this GlyphCache and the GlyphAtlas. Essentially NUKE.
+      The prefetches (see prefetch_glyph()) that are not done
+      are discarded, as is the layout data kept by
+      fetch_glyph_layout().
      */
     void
     clear_cache(void);
 
+    /*!
+      Returns a stat of the GlyphCache since the last
+      call to reset_stats(). The stats are not collected
+      (and thus are 0) if FastUIDraw is built with
+      FASTUIDRAW_NO_STATS defined.
+      \param st stat to query
+     */
+    unsigned int
+    query_stat(enum stats_t st) const;
+
+    /*!
+      Resets all the stats of the GlyphCache to 0;
+      typically called once per frame so that
+      query_stat() reports the values of a frame.
+     */
+    void
+    reset_stats(void);
+
   private:
     void *m_d;
   };
@@ -60,6 +60,20 @@ namespace fastuidraw
        */
       curve_pair_glyph,
 
+      /*!
+        Glyph is a banded curves glyph, generated
+        from a GlyphRenderDataBandedCurves. Glyph
+        is scalable.
+       */
+      banded_curves_glyph,
+
+      /*!
+        Glyph is a multi-channel signed distance field
+        glyph, generated from a GlyphRenderDataMSDF.
+        Glyph is scalable.
+       */
+      msdf_glyph,
+
       /*!
         Tag to indicate invalid glyph type; the value is much
         larger than the last glyph type to allow for later ABI
@@ -74,12 +88,23 @@ namespace fastuidraw
   class GlyphRender
   {
   public:
+    enum
+      {
+        /*!
+          Number of quantized subpixel offsets along x
+          at which coverage glyphs can be rendered, see
+          m_subpixel_offset.
+         */
+        number_subpixel_offsets = 4
+      };
+
     /*!
       Ctor. Initializes m_type as coverage_glyph
       \param pixel_size value to which to initialize m_pixel_size
+      \param subpixel_offset value to which to initialize m_subpixel_offset
      */
     explicit
-    GlyphRender(int pixel_size);
+    GlyphRender(int pixel_size, int subpixel_offset = 0);
 
     /*!
       Ctor.
@@ -102,15 +127,47 @@ namespace fastuidraw
      */
     int m_pixel_size;
 
+    /*!
+      Subpixel offset observed only if scalable() when
+      passed m_type returns false. A coverage glyph with
+      subpixel offset k is rasterized with its origin
+      k / number_subpixel_offsets pixels to the right of
+      a pixel boundary, so that drawing it at the position
+      p gives the glyph as positioned at
+      p + k / number_subpixel_offsets; the GlyphLayoutData
+      of such a glyph includes the offset. Must be in the
+      range [0, number_subpixel_offsets). The glyphs of
+      each offset are separate entries of a GlyphCache,
+      each created when first fetched.
+     */
+    int m_subpixel_offset;
+
     /*!
       Returns true if and only if the data for a glyph type
-      is scalable, for example distance_field_glyph and
-      curve_pair_glyph are scalable
+      is scalable, for example distance_field_glyph,
+      curve_pair_glyph, banded_curves_glyph and msdf_glyph
+      are scalable
      */
     static
     bool
     scalable(enum glyph_type tp);
 
+    /*!
+      Quantizes a position along x, in pixels, to a subpixel
+      offset: returns the value k for m_subpixel_offset and
+      writes to snapped_x the position at which to draw the
+      glyph, so that snapped_x + k / number_subpixel_offsets
+      is within half a subpixel step of x. The value written
+      to snapped_x is an integer.
+      \param x position in pixels
+      \param snapped_x (output) position at which to draw
+                       the glyph rendered with the returned
+                       subpixel offset
+     */
+    static
+    int
+    quantize_subpixel_offset(float x, float &snapped_x);
+
     /*!
       Comparison operator.
       \param rhs value to which to compare against
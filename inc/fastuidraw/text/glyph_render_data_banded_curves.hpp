@@ -0,0 +1,268 @@
+/*!
+ * \file glyph_render_data_banded_curves.hpp
+ * \brief file glyph_render_data_banded_curves.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/text/glyph_render_data.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Text
+  @{
+*/
+
+  /*!
+    A GlyphRenderDataBandedCurves represents the data needed
+    to build a scalable glyph whose coverage is computed
+    directly from the quadratic curves of its outline. The
+    glyph is divided into horizontal bands and vertical bands;
+    each band holds the list of curves that pass through it,
+    sorted so that the curves furthest along the band come
+    first. To compute the coverage of a point, a ray is cast
+    along its horizontal band and along its vertical band,
+    touching only the curves of those two bands, and the
+    coverage is computed from the distances in pixels to the
+    crossings of the rays with the curves. As such, unlike a
+    GlyphRenderDataCurvePair, the outline is never approximated
+    regardless of how many curves meet at a point, and the cost
+    of a fragment is proportional to the number of curves of its
+    bands rather than fixed.
+
+    The coordinates of the curves are in units of bands: the
+    glyph occupies [0, number_bands().x()]x[0, number_bands().y()]
+    with the bottom left of the glyph at (0, 0), i.e. each vertical
+    band is one unit wide and each horizontal band is one unit tall.
+
+    Data is uploaded to atlas as follows:
+     - a rectangle of resolution number_bands() is allocated in the
+       texel backing store, the texel of (x, y) holds the value of
+       cell_values() of the cell which is the intersection of the
+       vertical band x and the horizontal band y. The cell value
+       allows the shader to skip the curves entirely for cells through
+       which no curve passes.
+     - the geometry data is packed into the geometry backing store of the
+       atlas as entries of entry_size floats, with each entry padded to a
+       multiple of GlyphAtlasGeometryBackingStoreBase::alignment(). The
+       entries are:
+        - entry 0: the header with (Glyph::atlas_location().location(),
+                   number_bands())
+        - entries [1, 1 + number_bands().y()): the horizontal bands
+        - entries [1 + number_bands().y(), 1 + number_bands().y() + number_bands().x()):
+          the vertical bands
+        - the curves of the bands listed band after band, each curve taking
+          two entries (see curve_packing)
+       where each band entry holds (first entry of its curves, number of curves, 0, 0).
+       In addition, the curve coordinates are incremented by
+       Glyph::atlas_location().location() so that the coverage is computed
+       directly from the texel coordinate.
+   */
+  class GlyphRenderDataBandedCurves:public GlyphRenderData
+  {
+  public:
+    /*!
+      A curve represents a single quadratic curve of the
+      outline of the glyph; line segments are represented
+      with the control point at the middle of the segment.
+     */
+    class curve
+    {
+    public:
+      /*!
+        Ctor for a quadratic curve.
+        \param p0 start point
+        \param p1 control point
+        \param p2 end point
+       */
+      curve(vec2 p0, vec2 p1, vec2 p2):
+        m_p0(p0),
+        m_p1(p1),
+        m_p2(p2)
+      {}
+
+      /*!
+        Ctor for a line segment.
+        \param p0 start point
+        \param p2 end point
+       */
+      curve(vec2 p0, vec2 p2):
+        m_p0(p0),
+        m_p1((p0 + p2) * 0.5f),
+        m_p2(p2)
+      {}
+
+      curve(void)
+      {}
+
+      /*!
+        Start point of the curve
+       */
+      vec2 m_p0;
+
+      /*!
+        Control point of the curve
+       */
+      vec2 m_p1;
+
+      /*!
+        End point of the curve
+       */
+      vec2 m_p2;
+    };
+
+    /*!
+      Enumeration of values of cell_values()
+     */
+    enum cell_value_t
+      {
+        /*!
+          No curve passes through the cell and
+          the cell is outside of the glyph.
+         */
+        cell_empty = 0,
+
+        /*!
+          No curve passes through the cell and
+          the cell is inside of the glyph.
+         */
+        cell_full = 1,
+
+        /*!
+          At least one curve passes through (or
+          near) the cell.
+         */
+        cell_has_curves = 2,
+      };
+
+    /*!
+      Sequence of enumerations describing how each
+      curve of a band is packed into geometry data
+      of Glyph.
+     */
+    enum curve_packing
+      {
+        pack_offset_p0_x, /*!< offset for curve::m_p0.x() */
+        pack_offset_p0_y, /*!< offset for curve::m_p0.y() */
+        pack_offset_p1_x, /*!< offset for curve::m_p1.x() */
+        pack_offset_p1_y, /*!< offset for curve::m_p1.y() */
+        pack_offset_p2_x, /*!< offset for curve::m_p2.x() */
+        pack_offset_p2_y, /*!< offset for curve::m_p2.y() */
+
+        number_elements_to_pack_per_curve
+      };
+
+    enum
+      {
+        /*!
+          Number of floats of an entry of the packed
+          geometry data, each entry is padded to a
+          multiple of the alignment of the geometry
+          store.
+         */
+        entry_size = 4,
+
+        /*!
+          Number of entries a curve takes
+         */
+        entries_per_curve = 2,
+      };
+
+    /*!
+      Ctor, initializes as having no bands and no curves.
+     */
+    GlyphRenderDataBandedCurves(void);
+
+    ~GlyphRenderDataBandedCurves();
+
+    /*!
+      Set the curves of the glyph and compute the band lists
+      and the cell values from them. The curves are to form
+      closed contours and are filled with the non-zero
+      fill rule.
+      \param number_bands number of vertical bands (x-coordinate)
+                          and of horizontal bands (y-coordinate),
+                          each must be at least 1 if curves is
+                          non-empty
+      \param curves curves of the glyph, in units of bands
+     */
+    void
+    set_curves(ivec2 number_bands, const_c_array<curve> curves);
+
+    /*!
+      Returns the number of vertical bands (x-coordinate)
+      and horizontal bands (y-coordinate) as set by
+      set_curves(); this is also the resolution of the
+      data placed in the texel store.
+     */
+    ivec2
+    number_bands(void) const;
+
+    /*!
+      Returns the curves as passed to set_curves().
+     */
+    const_c_array<curve>
+    curves(void) const;
+
+    /*!
+      Returns the indices into curves() of the curves
+      of a horizontal band, sorted by decreasing maximum
+      x-coordinate.
+      \param band which band, must be in [0, number_bands().y())
+     */
+    const_c_array<unsigned int>
+    horizontal_band(int band) const;
+
+    /*!
+      Returns the indices into curves() of the curves
+      of a vertical band, sorted by decreasing maximum
+      y-coordinate.
+      \param band which band, must be in [0, number_bands().x())
+     */
+    const_c_array<unsigned int>
+    vertical_band(int band) const;
+
+    /*!
+      Returns the cell values, an enumeration of type
+      cell_value_t. The cell (x,y) is located at I where
+      I = x + y * number_bands().x().
+     */
+    const_c_array<uint8_t>
+    cell_values(void) const;
+
+    /*!
+      Returns the total number of curves over all bands,
+      i.e. the number of curves packed into the geometry
+      data.
+     */
+    unsigned int
+    number_band_curves(void) const;
+
+    virtual
+    enum fastuidraw::return_code
+    upload_to_atlas(const reference_counted_ptr<GlyphAtlas> &atlas,
+                    GlyphLocation &atlas_location,
+                    GlyphLocation &secondary_atlas_location,
+                    int &geometry_offset,
+                    int &geometry_length) const;
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+}
@@ -50,6 +50,10 @@ namespace fastuidraw
           * if atleast one coverted value is atleast 256, then the lower 8-bits
             of each value are in the texel backing store at Glyph::atlas_location()
             and the high 8-bits are stored at Glyph::secondary_atlas_location()
+          * if the texel store of the atlas is 16-bit (see
+            GlyphAtlasTexelBackingStoreBase::sixteen_bit()), the values are
+            stored whole at Glyph::atlas_location() and
+            Glyph::secondary_atlas_location() is not used
        * The curve pair data is packed into the geometry backing store of the atlas
          with the location a multiple of GlyphAtlasTexelBackingStoreBase::blocks_per_curvepair_entry().
          Each entry is takes up GlyphAtlasTexelBackingStoreBase::blocks_per_curvepair_entry()
@@ -306,6 +310,24 @@ namespace fastuidraw
     void
     resize_geometry_data(int sz);
 
+    /*!
+      Returns the number of texels through which pass more
+      than two curves of the glyph, each of which is rendered
+      with only the pair of curves judged most important, i.e.
+      the glyph can be drawn incorrectly at those texels. See
+      also Glyph::number_approximated_texels().
+     */
+    unsigned int
+    number_approximated_texels(void) const;
+
+    /*!
+      Set the value returned by number_approximated_texels(void) const,
+      initial value is 0.
+      \param v value
+     */
+    void
+    number_approximated_texels(unsigned int v);
+
     virtual
     enum fastuidraw::return_code
     upload_to_atlas(const reference_counted_ptr<GlyphAtlas> &atlas,
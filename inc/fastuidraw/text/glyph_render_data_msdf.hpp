@@ -0,0 +1,125 @@
+/*!
+ * \file glyph_render_data_msdf.hpp
+ * \brief file glyph_render_data_msdf.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/text/glyph_render_data.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Text
+  @{
+*/
+
+  /*!
+    Represents a multi-channel signed distance field of
+    a glyph. Each of the three channels holds the signed
+    distance to a subset of the edges of the outline of
+    the glyph and the edges are assigned to the channels
+    so that at a corner the two edges meeting there do
+    not share all channels. The glyph is rendered from
+    the median of the three channels, which keeps the
+    corners of the glyph sharp when the glyph is drawn
+    much larger than its stored resolution.
+
+    The channels are uploaded as three planes of 8-bit
+    texels: the first is the region of
+    Glyph::atlas_location() and the second and third are
+    side by side in the region of Glyph::secondary_atlas_location(),
+    the third starting resolution().x() texels after the
+    second. That offset is stored as the first value of
+    the data of the glyph in the geometry store at
+    Glyph::geometry_offset().
+   */
+  class GlyphRenderDataMSDF:public GlyphRenderData
+  {
+  public:
+    /*!
+      Enumeration to name the channels.
+     */
+    enum channel_t
+      {
+        red_channel, /*!< first channel, in the primary atlas */
+        green_channel, /*!< second channel, in the secondary atlas */
+        blue_channel, /*!< third channel, in the secondary atlas */
+
+        number_channels /*!< number of channels */
+      };
+
+    /*!
+      Ctor, initialized the resolution as (0,0).
+     */
+    GlyphRenderDataMSDF(void);
+    ~GlyphRenderDataMSDF(void);
+
+    /*!
+      Returns the resolution of each channel of the
+      glyph with padding. The padding is to be 1 pixel
+      wide on the bottom and on the right as for
+      GlyphRenderDataDistanceField::resolution().
+     */
+    ivec2
+    resolution(void) const;
+
+    /*!
+      Returns the distance values of a channel. The texel
+      (x,y) is located at I where I is given by
+      I = x + y * resolution().x(). The value is an 8-bit
+      value where 0 is max_distance outside of the edges
+      of the channel, 255 is max_distance inside and 127
+      is on the edges.
+      \param c channel to query
+     */
+    const_c_array<uint8_t>
+    distance_values(enum channel_t c) const;
+
+    /*!
+      Returns the distance values of a channel. The texel
+      (x,y) is located at I where I is given by
+      I = x + y * resolution().x(). The value is an 8-bit
+      value where 0 is max_distance outside of the edges
+      of the channel, 255 is max_distance inside and 127
+      is on the edges.
+      \param c channel to query
+     */
+    c_array<uint8_t>
+    distance_values(enum channel_t c);
+
+    /*!
+      Change the resolution, the resolution of
+      each channel is changed.
+      \param sz new resolution
+     */
+    void
+    resize(ivec2 sz);
+
+    virtual
+    enum fastuidraw::return_code
+    upload_to_atlas(const reference_counted_ptr<GlyphAtlas> &atlas,
+                    GlyphLocation &atlas_location,
+                    GlyphLocation &secondary_atlas_location,
+                    int &geometry_offset,
+                    int &geometry_length) const;
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+
+} //namespace fastuidraw
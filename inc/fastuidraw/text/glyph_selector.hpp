@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <vector>
+#include <algorithm>
 #include <fastuidraw/text/font.hpp>
 #include <fastuidraw/text/glyph.hpp>
 #include <fastuidraw/text/glyph_cache.hpp>
@@ -52,11 +54,147 @@ namespace fastuidraw
         m_d(NULL)
       {}
 
+      /*!
+        Comparison operator, two FontGroup values are
+        equal exactly when they refer to the same group
+        of fonts of the same GlyphSelector.
+        \param rhs value to which to compare
+       */
+      bool
+      operator==(const FontGroup &rhs) const
+      {
+        return m_d == rhs.m_d;
+      }
+
+      /*!
+        Comparison operator, an arbitrary strict order
+        so that FontGroup values can be used as keys
+        of a std::map.
+        \param rhs value to which to compare
+       */
+      bool
+      operator<(const FontGroup &rhs) const
+      {
+        return m_d < rhs.m_d;
+      }
+
     private:
       friend class GlyphSelector;
       void *m_d;
     };
 
+    /*!
+      A RenderPolicy selects the GlyphRender with which to
+      draw text from the pixel size at which the text is
+      drawn, so that the atlas bytes and the fragment cost per
+      drawn glyph stay low without noticeable loss of quality:
+       - below coverage_max_pixel_size(), \ref coverage_glyph
+         glyphs realized at the pixel size (rounded up), which
+         are the cheapest to draw and small at small sizes
+       - below distance_field_max_pixel_size(),
+         \ref distance_field_glyph glyphs, whose data is of
+         fixed size and shared by all pixel sizes
+       - otherwise \ref curve_pair_glyph glyphs, which need
+         no size-specific data and stay sharp at large
+         sizes but are the costliest per fragment.
+      Curve-pair rendering of some glyphs is only approximated
+      (see Glyph::number_approximated_texels()); when a glyph
+      selected as a curve-pair glyph has more such texels than
+      curve_pair_max_approximated_texels(), the glyph is instead
+      selected as a distance field glyph.
+     */
+    class RenderPolicy
+    {
+    public:
+      /*!
+        Ctor, initializes values to defaults.
+       */
+      RenderPolicy(void);
+
+      /*!
+        Copy ctor.
+        \param obj value from which to copy
+       */
+      RenderPolicy(const RenderPolicy &obj);
+
+      ~RenderPolicy();
+
+      /*!
+        Assignment operator.
+        \param rhs value from which to copy
+       */
+      RenderPolicy&
+      operator=(const RenderPolicy &rhs);
+
+      /*!
+        Pixel size below which text is drawn with
+        coverage glyphs.
+       */
+      float
+      coverage_max_pixel_size(void) const;
+
+      /*!
+        Set the value returned by coverage_max_pixel_size(void) const,
+        initial value is 16.0.
+        \param v value
+       */
+      RenderPolicy&
+      coverage_max_pixel_size(float v);
+
+      /*!
+        Pixel size below which (and at or above
+        coverage_max_pixel_size()) text is drawn
+        with distance field glyphs.
+       */
+      float
+      distance_field_max_pixel_size(void) const;
+
+      /*!
+        Set the value returned by distance_field_max_pixel_size(void) const,
+        initial value is 48.0.
+        \param v value
+       */
+      RenderPolicy&
+      distance_field_max_pixel_size(float v);
+
+      /*!
+        Maximum number of approximated texels (see
+        Glyph::number_approximated_texels()) for a
+        curve-pair glyph to be used; a negative value
+        indicates to always use the curve-pair glyph.
+       */
+      int
+      curve_pair_max_approximated_texels(void) const;
+
+      /*!
+        Set the value returned by curve_pair_max_approximated_texels(void) const,
+        initial value is 0.
+        \param v value
+       */
+      RenderPolicy&
+      curve_pair_max_approximated_texels(int v);
+
+      /*!
+        Returns the GlyphRender the policy selects
+        for text drawn at a pixel size.
+        \param pixel_size pixel size at which text is drawn
+       */
+      GlyphRender
+      select(float pixel_size) const;
+
+      /*!
+        Returns true if a Glyph is a curve-pair glyph with
+        more approximated texels than curve_pair_max_approximated_texels(),
+        i.e. is to be replaced by a distance field glyph.
+        \param G Glyph to check
+       */
+      bool
+      too_approximated(const Glyph &G) const;
+
+    private:
+      void *m_d;
+    };
+
     /*!
       Ctor
       \param cache GlyphCache to store/fetch glyphs.
@@ -134,6 +272,133 @@ namespace fastuidraw
     fetch_glyph_no_merging(GlyphRender tp, reference_counted_ptr<const FontBase> h,
                            uint32_t character_code);
 
+    /*!
+      Fetch a Glyph (and if necessary generate it and place into GlyphCache)
+      with font merging, with the glyph rendering type selected by a
+      RenderPolicy, including the fallback to distance field rendering for
+      curve-pair glyphs that are too approximated. Use with
+      PainterAttributeDataFillerGlyphs constructed with a render pixel size,
+      since glyphs of different rendering types can be selected.
+      \param policy RenderPolicy to select the glyph rendering type
+      \param pixel_size pixel size at which the glyph is to be drawn
+      \param group FontGroup used to fetch font
+      \param character_code character code of glyph to fetch
+     */
+    Glyph
+    fetch_glyph(const RenderPolicy &policy, float pixel_size,
+                FontGroup group, uint32_t character_code);
+
+    /*!
+      Fetch a Glyph (and if necessary generate it and place into GlyphCache)
+      with font merging, with the glyph rendering type selected by a
+      RenderPolicy, see fetch_glyph(const RenderPolicy&, float, FontGroup, uint32_t).
+      \param policy RenderPolicy to select the glyph rendering type
+      \param pixel_size pixel size at which the glyph is to be drawn
+      \param h handle to font from which to fetch the glyph, if the glyph
+               is not present in the font attempt to get the glyph from
+               a font of similiar properties
+      \param character_code character code of glyph to fetch
+     */
+    Glyph
+    fetch_glyph(const RenderPolicy &policy, float pixel_size,
+                reference_counted_ptr<const FontBase> h,
+                uint32_t character_code);
+
+    /*!
+      Fetch only the GlyphLayoutData of a glyph, with font merging,
+      without generating its rendering data, see
+      GlyphCache::fetch_glyph_layout(). Use to measure text (for
+      example to break lines) before drawing it; the glyphs drawn
+      are then fetched with the same GlyphRender by create_glyph_sequence()
+      or fetch_glyph(), which generate their rendering data. Returns a
+      default constructed GlyphLayoutData (whose GlyphLayoutData::m_font
+      is NULL) if no font has the glyph.
+      \param tp glyph rendering type with which the glyph is to be drawn
+      \param group FontGroup used to fetch font
+      \param character_code character code of glyph to fetch
+     */
+    GlyphLayoutData
+    fetch_glyph_layout(GlyphRender tp, FontGroup group, uint32_t character_code);
+
+    /*!
+      Fetch only the GlyphLayoutData of a glyph, with font merging,
+      without generating its rendering data, see
+      fetch_glyph_layout(GlyphRender, FontGroup, uint32_t).
+      \param tp glyph rendering type with which the glyph is to be drawn
+      \param h handle to font from which to fetch the glyph, if the glyph
+               is not present in the font attempt to get the glyph from
+               a font of similiar properties
+      \param character_code character code of glyph to fetch
+     */
+    GlyphLayoutData
+    fetch_glyph_layout(GlyphRender tp,
+                       reference_counted_ptr<const FontBase> h,
+                       uint32_t character_code);
+
+    /*!
+      Fill GlyphLayoutData values from an iterator range of character
+      code values, see fetch_glyph_layout(GlyphRender, FontGroup, uint32_t).
+      \tparam input_iterator read iterator to type that is castable to uint32_t
+      \tparam output_iterator write iterator to GlyphLayoutData
+      \param tp glyph rendering type with which the glyphs are to be drawn
+      \param group FontGroup to choose what font
+      \param character_codes_begin iterator to 1st character code
+      \param character_codes_end iterator to one past last character code
+      \param output_begin begin iterator to output
+     */
+    template<typename input_iterator,
+             typename output_iterator>
+    void
+    create_glyph_layout_sequence(GlyphRender tp, FontGroup group,
+                                 input_iterator character_codes_begin,
+                                 input_iterator character_codes_end,
+                                 output_iterator output_begin);
+
+    /*!
+      Fill GlyphLayoutData values from an iterator range of character
+      code values, see fetch_glyph_layout(GlyphRender, FontGroup, uint32_t).
+      \tparam input_iterator read iterator to type that is castable to uint32_t
+      \tparam output_iterator write iterator to GlyphLayoutData
+      \param tp glyph rendering type with which the glyphs are to be drawn
+      \param h handle to font from which to fetch the glyph, if the glyph
+               is not present in the font attempt to get the glyph from
+               a font of similiar properties
+      \param character_codes_begin iterator to 1st character code
+      \param character_codes_end iterator to one past last character code
+      \param output_begin begin iterator to output
+     */
+    template<typename input_iterator,
+             typename output_iterator>
+    void
+    create_glyph_layout_sequence(GlyphRender tp,
+                                 reference_counted_ptr<const FontBase> h,
+                                 input_iterator character_codes_begin,
+                                 input_iterator character_codes_end,
+                                 output_iterator output_begin);
+
+    /*!
+      Returns the maximum number of threads with which
+      create_glyph_sequence() and create_glyph_sequence_no_merging()
+      generate the rendering data of the glyphs that are not
+      yet in the GlyphCache, see GlyphCache::end_deferred_generation().
+      A value of 0 indicates to use the number of hardware
+      threads. Generating glyphs with more than one thread
+      requires that FontBase::compute_rendering_data() of
+      the fonts can be called from several threads at the
+      same time efficiently, for example FontFreeType
+      created by FontFreeType::create().
+     */
+    unsigned int
+    glyph_generation_threads(void) const;
+
+    /*!
+      Set the value returned by glyph_generation_threads(void) const.
+      Default value is 1.
+      \param v value
+     */
+    void
+    glyph_generation_threads(unsigned int v);
+
     /*!
       Fill Glyph values from an iterator range of character code values.
       \tparam input_iterator read iterator to type that is castable to uint32_t
@@ -194,6 +459,148 @@ namespace fastuidraw
                                      input_iterator character_codes_end,
                                      output_iterator output_begin);
 
+    /*!
+      Request that the glyphs of an iterator range of character
+      code values are generated in the background, see
+      GlyphCache::prefetch_glyph(); the glyphs are selected
+      with font merging as in create_glyph_sequence().
+      \tparam input_iterator read iterator to type that is castable to uint32_t
+      \param tp glyph rendering type
+      \param group FontGroup to choose what font
+      \param character_codes_begin iterator to 1st character code
+      \param character_codes_end iterator to one past last character code
+     */
+    /*!
+      Fill Glyph values from an iterator range of character code values,
+      with the glyph rendering type selected by a RenderPolicy, see
+      fetch_glyph(const RenderPolicy&, float, FontGroup, uint32_t). The
+      rendering data of the glyphs is generated as in create_glyph_sequence().
+      \tparam input_iterator read iterator to type that is castable to uint32_t
+      \tparam output_iterator write iterator to Glyph
+      \param policy RenderPolicy to select the glyph rendering type
+      \param pixel_size pixel size at which the glyphs are to be drawn
+      \param group FontGroup to choose what font
+      \param character_codes_begin iterator to 1st character code
+      \param character_codes_end iterator to one past last character code
+      \param output_begin begin iterator to output
+     */
+    template<typename input_iterator,
+             typename output_iterator>
+    void
+    create_glyph_sequence(const RenderPolicy &policy, float pixel_size,
+                          FontGroup group,
+                          input_iterator character_codes_begin,
+                          input_iterator character_codes_end,
+                          output_iterator output_begin);
+
+    /*!
+      Fill Glyph values from an iterator range of character code values,
+      with the glyph rendering type selected by a RenderPolicy, see
+      fetch_glyph(const RenderPolicy&, float, FontGroup, uint32_t).
+      \tparam input_iterator read iterator to type that is castable to uint32_t
+      \tparam output_iterator write iterator to Glyph
+      \param policy RenderPolicy to select the glyph rendering type
+      \param pixel_size pixel size at which the glyphs are to be drawn
+      \param h handle to font from which to fetch the glyph, if the glyph
+               is not present in the font attempt to get the glyph from
+               a font of similiar properties
+      \param character_codes_begin iterator to 1st character code
+      \param character_codes_end iterator to one past last character code
+      \param output_begin begin iterator to output
+     */
+    template<typename input_iterator,
+             typename output_iterator>
+    void
+    create_glyph_sequence(const RenderPolicy &policy, float pixel_size,
+                          reference_counted_ptr<const FontBase> h,
+                          input_iterator character_codes_begin,
+                          input_iterator character_codes_end,
+                          output_iterator output_begin);
+
+    template<typename input_iterator>
+    void
+    prefetch_glyph_sequence(GlyphRender tp, FontGroup group,
+                            input_iterator character_codes_begin,
+                            input_iterator character_codes_end);
+
+    /*!
+      Request that the glyphs of an iterator range of character
+      code values are generated in the background, see
+      GlyphCache::prefetch_glyph(); the glyphs are selected
+      with font merging as in create_glyph_sequence().
+      \tparam input_iterator read iterator to type that is castable to uint32_t
+      \param tp glyph rendering type
+      \param h handle to font from which to fetch the glyph, if the glyph
+               is not present in the font attempt to get the glyph from
+               a font of similiar properties
+      \param character_codes_begin iterator to 1st character code
+      \param character_codes_end iterator to one past last character code
+     */
+    template<typename input_iterator>
+    void
+    prefetch_glyph_sequence(GlyphRender tp,
+                            reference_counted_ptr<const FontBase> h,
+                            input_iterator character_codes_begin,
+                            input_iterator character_codes_end);
+
+    /*!
+      Fill Glyph values from an iterator range of character code
+      values without ever waiting for the generation of glyph
+      rendering data. For each character, if the glyph rendered
+      as tp is ready (see GlyphCache::fetch_glyph_if_ready()) it
+      is used; otherwise its generation is requested in the
+      background (see prefetch_glyph_sequence()) and the glyph
+      rendered as fallback is used if that one is ready, and
+      if it is not, the output Glyph is invalid, i.e. is not
+      drawn. Use with PainterAttributeDataFillerGlyphs constructed
+      with a render pixel size so that glyphs of different
+      rendering types are drawn at the same size.
+      \tparam input_iterator read iterator to type that is castable to uint32_t
+      \tparam output_iterator write iterator to Glyph
+      \param tp glyph rendering type
+      \param fallback glyph rendering type to use while the glyph
+                       rendered as tp is not ready, for example a
+                       scalable type such as distance_field_glyph;
+                       an invalid value indicates to not use a fallback
+      \param group FontGroup to choose what font
+      \param character_codes_begin iterator to 1st character code
+      \param character_codes_end iterator to one past last character code
+      \param output_begin begin iterator to output
+     */
+    template<typename input_iterator,
+             typename output_iterator>
+    void
+    create_glyph_sequence_if_ready(GlyphRender tp, GlyphRender fallback,
+                                   FontGroup group,
+                                   input_iterator character_codes_begin,
+                                   input_iterator character_codes_end,
+                                   output_iterator output_begin);
+
+    /*!
+      Fill Glyph values from an iterator range of character code
+      values without ever waiting for the generation of glyph
+      rendering data, see create_glyph_sequence_if_ready(GlyphRender, GlyphRender, FontGroup, input_iterator, input_iterator, output_iterator).
+      \tparam input_iterator read iterator to type that is castable to uint32_t
+      \tparam output_iterator write iterator to Glyph
+      \param tp glyph rendering type
+      \param fallback glyph rendering type to use while the glyph
+                       rendered as tp is not ready
+      \param h handle to font from which to fetch the glyph, if the glyph
+               is not present in the font attempt to get the glyph from
+               a font of similiar properties
+      \param character_codes_begin iterator to 1st character code
+      \param character_codes_end iterator to one past last character code
+      \param output_begin begin iterator to output
+     */
+    template<typename input_iterator,
+             typename output_iterator>
+    void
+    create_glyph_sequence_if_ready(GlyphRender tp, GlyphRender fallback,
+                                   reference_counted_ptr<const FontBase> h,
+                                   input_iterator character_codes_begin,
+                                   input_iterator character_codes_end,
+                                   output_iterator output_begin);
+
   private:
     void
     lock_mutex(void);
@@ -201,6 +608,18 @@ namespace fastuidraw
     void
     unlock_mutex(void);
 
+    /* locks the mutex and defers the generation
+       of glyph rendering data of the GlyphCache
+     */
+    void
+    begin_glyph_sequence(void);
+
+    /* generates the deferred glyph rendering
+       data and unlocks the mutex
+     */
+    void
+    end_glyph_sequence(void);
+
     Glyph
     fetch_glyph_no_lock(GlyphRender tp, FontGroup group, uint32_t character_code);
 
@@ -214,6 +633,47 @@ namespace fastuidraw
                                    reference_counted_ptr<const FontBase> h,
                                    uint32_t character_code);
 
+    void
+    prefetch_glyph_no_lock(GlyphRender tp, FontGroup group, uint32_t character_code);
+
+    GlyphLayoutData
+    fetch_glyph_layout_no_lock(GlyphRender tp, FontGroup group, uint32_t character_code);
+
+    GlyphLayoutData
+    fetch_glyph_layout_no_lock(GlyphRender tp,
+                               reference_counted_ptr<const FontBase> h,
+                               uint32_t character_code);
+
+    void
+    prefetch_glyph_no_lock(GlyphRender tp,
+                           reference_counted_ptr<const FontBase> h,
+                           uint32_t character_code);
+
+    Glyph
+    fetch_glyph_if_ready_no_lock(GlyphRender tp, GlyphRender fallback,
+                                 FontGroup group, uint32_t character_code);
+
+    Glyph
+    fetch_glyph_if_ready_no_lock(GlyphRender tp, GlyphRender fallback,
+                                 reference_counted_ptr<const FontBase> h,
+                                 uint32_t character_code);
+
+    /* replaces each glyph of glyphs selected as a curve-pair glyph
+       that is too approximated for policy by a glyph selected with the
+       rendering type of the policy fallback; the glyphs are selected
+       at the indices of glyphs from character_codes.
+     */
+    void
+    apply_render_policy_fallback(const RenderPolicy &policy, FontGroup group,
+                                 const_c_array<uint32_t> character_codes,
+                                 c_array<Glyph> glyphs);
+
+    void
+    apply_render_policy_fallback(const RenderPolicy &policy,
+                                 reference_counted_ptr<const FontBase> h,
+                                 const_c_array<uint32_t> character_codes,
+                                 c_array<Glyph> glyphs);
+
     void *m_d;
   };
 
@@ -226,14 +686,14 @@ namespace fastuidraw
                         input_iterator character_codes_end,
                         output_iterator output_begin)
   {
-    lock_mutex();
+    begin_glyph_sequence();
     for(;character_codes_begin != character_codes_end; ++character_codes_begin, ++output_begin)
       {
         uint32_t v;
         v = static_cast<uint32_t>(*character_codes_begin);
         *output_begin = fetch_glyph_no_lock(tp, group, v);
       }
-    unlock_mutex();
+    end_glyph_sequence();
   }
 
   template<typename input_iterator,
@@ -246,14 +706,14 @@ namespace fastuidraw
                         input_iterator character_codes_end,
                         output_iterator output_begin)
   {
-    lock_mutex();
+    begin_glyph_sequence();
     for(;character_codes_begin != character_codes_end; ++character_codes_begin, ++output_begin)
       {
         uint32_t v;
         v = static_cast<uint32_t>(*character_codes_begin);
         *output_begin = fetch_glyph_no_lock(tp, h, v);
       }
-    unlock_mutex();
+    end_glyph_sequence();
   }
 
   template<typename input_iterator,
@@ -266,13 +726,185 @@ namespace fastuidraw
                                    input_iterator character_codes_end,
                                    output_iterator output_begin)
   {
-    lock_mutex();
+    begin_glyph_sequence();
     for(;character_codes_begin != character_codes_end; ++character_codes_begin, ++output_begin)
       {
         uint32_t v;
         v = static_cast<uint32_t>(*character_codes_begin);
         *output_begin = fetch_glyph_no_merging_no_lock(tp, h, v);
       }
+    end_glyph_sequence();
+  }
+
+  template<typename input_iterator,
+           typename output_iterator>
+  void
+  GlyphSelector::
+  create_glyph_sequence(const RenderPolicy &policy, float pixel_size,
+                        FontGroup group,
+                        input_iterator character_codes_begin,
+                        input_iterator character_codes_end,
+                        output_iterator output_begin)
+  {
+    std::vector<uint32_t> character_codes;
+    std::vector<Glyph> glyphs;
+    GlyphRender tp(policy.select(pixel_size));
+
+    for(;character_codes_begin != character_codes_end; ++character_codes_begin)
+      {
+        character_codes.push_back(static_cast<uint32_t>(*character_codes_begin));
+      }
+    glyphs.resize(character_codes.size());
+    create_glyph_sequence(tp, group, character_codes.begin(), character_codes.end(), glyphs.begin());
+    if(tp.m_type == curve_pair_glyph && !glyphs.empty())
+      {
+        apply_render_policy_fallback(policy, group,
+                                     const_c_array<uint32_t>(&character_codes[0], character_codes.size()),
+                                     c_array<Glyph>(&glyphs[0], glyphs.size()));
+      }
+    std::copy(glyphs.begin(), glyphs.end(), output_begin);
+  }
+
+  template<typename input_iterator,
+           typename output_iterator>
+  void
+  GlyphSelector::
+  create_glyph_sequence(const RenderPolicy &policy, float pixel_size,
+                        reference_counted_ptr<const FontBase> h,
+                        input_iterator character_codes_begin,
+                        input_iterator character_codes_end,
+                        output_iterator output_begin)
+  {
+    std::vector<uint32_t> character_codes;
+    std::vector<Glyph> glyphs;
+    GlyphRender tp(policy.select(pixel_size));
+
+    for(;character_codes_begin != character_codes_end; ++character_codes_begin)
+      {
+        character_codes.push_back(static_cast<uint32_t>(*character_codes_begin));
+      }
+    glyphs.resize(character_codes.size());
+    create_glyph_sequence(tp, h, character_codes.begin(), character_codes.end(), glyphs.begin());
+    if(tp.m_type == curve_pair_glyph && !glyphs.empty())
+      {
+        apply_render_policy_fallback(policy, h,
+                                     const_c_array<uint32_t>(&character_codes[0], character_codes.size()),
+                                     c_array<Glyph>(&glyphs[0], glyphs.size()));
+      }
+    std::copy(glyphs.begin(), glyphs.end(), output_begin);
+  }
+
+  template<typename input_iterator,
+           typename output_iterator>
+  void
+  GlyphSelector::
+  create_glyph_layout_sequence(GlyphRender tp, FontGroup group,
+                               input_iterator character_codes_begin,
+                               input_iterator character_codes_end,
+                               output_iterator output_begin)
+  {
+    lock_mutex();
+    for(;character_codes_begin != character_codes_end; ++character_codes_begin, ++output_begin)
+      {
+        uint32_t v;
+        v = static_cast<uint32_t>(*character_codes_begin);
+        *output_begin = fetch_glyph_layout_no_lock(tp, group, v);
+      }
+    unlock_mutex();
+  }
+
+  template<typename input_iterator,
+           typename output_iterator>
+  void
+  GlyphSelector::
+  create_glyph_layout_sequence(GlyphRender tp,
+                               reference_counted_ptr<const FontBase> h,
+                               input_iterator character_codes_begin,
+                               input_iterator character_codes_end,
+                               output_iterator output_begin)
+  {
+    lock_mutex();
+    for(;character_codes_begin != character_codes_end; ++character_codes_begin, ++output_begin)
+      {
+        uint32_t v;
+        v = static_cast<uint32_t>(*character_codes_begin);
+        *output_begin = fetch_glyph_layout_no_lock(tp, h, v);
+      }
+    unlock_mutex();
+  }
+
+  template<typename input_iterator>
+  void
+  GlyphSelector::
+  prefetch_glyph_sequence(GlyphRender tp, FontGroup group,
+                          input_iterator character_codes_begin,
+                          input_iterator character_codes_end)
+  {
+    lock_mutex();
+    for(;character_codes_begin != character_codes_end; ++character_codes_begin)
+      {
+        uint32_t v;
+        v = static_cast<uint32_t>(*character_codes_begin);
+        prefetch_glyph_no_lock(tp, group, v);
+      }
+    unlock_mutex();
+  }
+
+  template<typename input_iterator>
+  void
+  GlyphSelector::
+  prefetch_glyph_sequence(GlyphRender tp,
+                          reference_counted_ptr<const FontBase> h,
+                          input_iterator character_codes_begin,
+                          input_iterator character_codes_end)
+  {
+    lock_mutex();
+    for(;character_codes_begin != character_codes_end; ++character_codes_begin)
+      {
+        uint32_t v;
+        v = static_cast<uint32_t>(*character_codes_begin);
+        prefetch_glyph_no_lock(tp, h, v);
+      }
+    unlock_mutex();
+  }
+
+  template<typename input_iterator,
+           typename output_iterator>
+  void
+  GlyphSelector::
+  create_glyph_sequence_if_ready(GlyphRender tp, GlyphRender fallback,
+                                 FontGroup group,
+                                 input_iterator character_codes_begin,
+                                 input_iterator character_codes_end,
+                                 output_iterator output_begin)
+  {
+    lock_mutex();
+    for(;character_codes_begin != character_codes_end; ++character_codes_begin, ++output_begin)
+      {
+        uint32_t v;
+        v = static_cast<uint32_t>(*character_codes_begin);
+        *output_begin = fetch_glyph_if_ready_no_lock(tp, fallback, group, v);
+      }
+    unlock_mutex();
+  }
+
+  template<typename input_iterator,
+           typename output_iterator>
+  void
+  GlyphSelector::
+  create_glyph_sequence_if_ready(GlyphRender tp, GlyphRender fallback,
+                                 reference_counted_ptr<const FontBase> h,
+                                 input_iterator character_codes_begin,
+                                 input_iterator character_codes_end,
+                                 output_iterator output_begin)
+  {
+    lock_mutex();
+    for(;character_codes_begin != character_codes_end; ++character_codes_begin, ++output_begin)
+      {
+        uint32_t v;
+        v = static_cast<uint32_t>(*character_codes_begin);
+        *output_begin = fetch_glyph_if_ready_no_lock(tp, fallback, h, v);
+      }
     unlock_mutex();
   }
 
@@ -29,13 +29,19 @@ namespace fastuidraw
  */
   /*!
     Class to hold the blend mode as exposed by typical
-    3D APIs
+    3D APIs together with how a draw uses the stencil
+    buffer.
   */
   class BlendMode
   {
   public:
     /*!
       Enumeration to specify blend equation, i.e. glBlendEquation.
+      The values MULTIPLY through HSL_LUMINOSITY are the advanced
+      blend equations of GL_KHR_blend_equation_advanced; for these
+      the blend coefficients are ignored, the source and destination
+      are taken as pre-multiplied by alpha and the equation must be
+      the same for the RGB and Alpha channels, see is_advanced().
      */
     enum op_t
       {
@@ -45,6 +51,22 @@ namespace fastuidraw
         MIN,
         MAX,
 
+        MULTIPLY,
+        SCREEN,
+        OVERLAY,
+        DARKEN,
+        LIGHTEN,
+        COLORDODGE,
+        COLORBURN,
+        HARDLIGHT,
+        SOFTLIGHT,
+        DIFFERENCE,
+        EXCLUSION,
+        HSL_HUE,
+        HSL_SATURATION,
+        HSL_COLOR,
+        HSL_LUMINOSITY,
+
         NUMBER_OPS
       };
 
@@ -77,11 +99,95 @@ namespace fastuidraw
         NUMBER_FUNCS,
       };
 
+    /*!
+      Enumeration to specify how a draw uses and affects the
+      stencil buffer. The stencil values are 8-bit and wrap,
+      so a winding number is stored modulo 256. The values
+      STENCIL_ADD_WINDING through STENCIL_CLEAR are only supported
+      by a PainterBackend whose
+      PainterBackend::PerformanceHints::stencil_coverage() is true
+      and the values STENCIL_CLIP_TEST through STENCIL_CLIP_DECREMENT
+      are only supported by a PainterBackend whose
+      PainterBackend::PerformanceHints::stencil_clipping() is true.
+     */
+    enum stencil_op_t
+      {
+        /*!
+          The stencil test is off and the stencil
+          buffer is not affected.
+         */
+        STENCIL_OFF,
+
+        /*!
+          Color and depth writes are off and the stencil test
+          always passes; front facing triangles increment the
+          stencil value and back facing triangles decrement it.
+         */
+        STENCIL_ADD_WINDING,
+
+        /*!
+          As STENCIL_ADD_WINDING, except that front facing
+          triangles decrement the stencil value and back
+          facing triangles increment it.
+         */
+        STENCIL_SUBTRACT_WINDING,
+
+        /*!
+          Only draw where the stencil value is non-zero, the
+          stencil value of those pixels drawn is set to zero.
+         */
+        STENCIL_COVER_NON_ZERO,
+
+        /*!
+          Only draw where the stencil value is odd, the
+          stencil value of those pixels drawn is set to zero.
+         */
+        STENCIL_COVER_ODD,
+
+        /*!
+          Only draw where the stencil value is even, the
+          stencil value of those pixels drawn is set to zero.
+         */
+        STENCIL_COVER_EVEN,
+
+        /*!
+          Only draw where the stencil value is stencil_value(),
+          the stencil value of those pixels drawn is set to zero.
+         */
+        STENCIL_COVER_EQUAL,
+
+        /*!
+          Color and depth writes are off, the stencil
+          value is set to zero.
+         */
+        STENCIL_CLEAR,
+
+        /*!
+          Only draw where the stencil value is stencil_value(),
+          the stencil buffer is not affected.
+         */
+        STENCIL_CLIP_TEST,
+
+        /*!
+          Color and depth writes are off, the stencil value
+          is incremented where it is stencil_value().
+         */
+        STENCIL_CLIP_INCREMENT,
+
+        /*!
+          Color and depth writes are off, the stencil value
+          is decremented where it is stencil_value().
+         */
+        STENCIL_CLIP_DECREMENT,
+
+        NUMBER_STENCIL_OPS
+      };
+
     /*!
       Represents a BlendMode packed as a single
       32-bit integer value, see also packed().
      */
-    typedef uint32_t packed_value;
+    typedef uint64_t packed_value;
 
     /*!
       Ctor.
@@ -92,6 +198,8 @@ namespace fastuidraw
       m_blend_equation[Kequation_rgb] = m_blend_equation[Kequation_alpha] = ADD;
       m_blend_func[Kfunc_src_rgb] = m_blend_func[Kfunc_src_alpha] = ONE;
       m_blend_func[Kfunc_dst_rgb] = m_blend_func[Kfunc_dst_alpha] = ZERO;
+      m_stencil_op = STENCIL_OFF;
+      m_stencil_value = 0u;
     }
 
     /*!
@@ -162,6 +270,17 @@ namespace fastuidraw
       return *this;
     }
 
+    /*!
+      Returns true if the blend equation of the RGB
+      channels is an advanced blend equation, i.e.
+      one of MULTIPLY through HSL_LUMINOSITY.
+     */
+    bool
+    is_advanced(void) const
+    {
+      return m_blend_equation[Kequation_rgb] >= MULTIPLY;
+    }
+
     /*!
       Set the source coefficient for the RGB channels.
       Default value is ONE.
@@ -257,6 +376,34 @@ namespace fastuidraw
       return *this;
     }
 
+    /*!
+      Set how the stencil buffer is used and affected.
+      Default value is STENCIL_OFF.
+     */
+    BlendMode&
+    stencil_op(enum stencil_op_t v) { m_stencil_op = v; return *this; }
+
+    /*!
+      Return the value as set by stencil_op(enum stencil_op_t).
+     */
+    enum stencil_op_t
+    stencil_op(void) const { return m_stencil_op; }
+
+    /*!
+      Set the stencil value against which STENCIL_COVER_EQUAL
+      and STENCIL_CLIP_TEST, STENCIL_CLIP_INCREMENT and
+      STENCIL_CLIP_DECREMENT test, only the low 8 bits are
+      used. Default value is 0.
+     */
+    BlendMode&
+    stencil_value(uint32_t v) { m_stencil_value = v & 0xFFu; return *this; }
+
+    /*!
+      Return the value as set by stencil_value(uint32_t).
+     */
+    uint32_t
+    stencil_value(void) const { return m_stencil_value; }
+
     /*!
       Return the blend mode as a single packed 64-bit
       unsigned integer.
@@ -284,6 +431,8 @@ namespace fastuidraw
     bool m_blending_on;
     vecN<enum op_t, Knumber_blend_equation_args> m_blend_equation;
     vecN<enum func_t, Knumber_blend_args> m_blend_func;
+    enum stencil_op_t m_stencil_op;
+    uint32_t m_stencil_value;
   };
 /*! @} */
 }
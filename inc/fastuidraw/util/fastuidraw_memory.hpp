@@ -27,18 +27,100 @@
 #include <fastuidraw/util/checked_delete.hpp>
 #include <fastuidraw/util/fastuidraw_memory_private.hpp>
 
+namespace fastuidraw
+{
+
+namespace memory
+{
+  /*!
+    An allocator provides the storage for FASTUIDRAWnew,
+    FASTUIDRAWmalloc, FASTUIDRAWcalloc, FASTUIDRAWrealloc and
+    their tag variants; storage is released by FASTUIDRAWdelete,
+    FASTUIDRAWfree and FASTUIDRAWfree_tag.
+    The methods may be called from any thread concurrently.
+   */
+  class allocator
+  {
+  public:
+    virtual
+    ~allocator()
+    {}
+
+    /*!
+      To be implemented by a derived class to allocate
+      storage; the returned address must be aligned as
+      std::malloc() would align it.
+      \param size number of bytes, never zero
+      \param tag subsystem making the allocation
+     */
+    virtual
+    void*
+    allocate(size_t size, enum tag_t tag) = 0;
+
+    /*!
+      To be implemented by a derived class to resize
+      storage as std::realloc() does.
+      \param ptr storage to resize, never NULL
+      \param size new size in bytes, never zero
+      \param tag subsystem that made the allocation
+     */
+    virtual
+    void*
+    reallocate(void *ptr, size_t size, enum tag_t tag) = 0;
+
+    /*!
+      To be implemented by a derived class to release
+      storage returned by allocate() or reallocate().
+      \param ptr storage to release, never NULL
+      \param tag subsystem that made the allocation
+     */
+    virtual
+    void
+    deallocate(void *ptr, enum tag_t tag) = 0;
+  };
+
+  /*!
+    Set the \ref allocator used by the allocation macros of
+    FastUIDraw. Must be called before any allocation by FastUIDraw
+    is made, typically at program start. The allocator is not
+    owned, i.e. it must remain alive until all allocations made
+    from it are freed. Passing NULL restores the default of
+    std::malloc, std::realloc and std::free.
+   */
+  void
+  set_allocator(allocator *p);
+
+  /*!
+    Returns the \ref allocator set by set_allocator(),
+    returns NULL if none is set.
+   */
+  allocator*
+  get_allocator(void);
+
+} //namespace memory
+
+} //namespace fastuidraw
+
 /*!\def FASTUIDRAWnew
   When FASTUIDRAW_DEBUG is defined, allocations with FASTUIDRAWnew are tracked and
   at program exit a list of those objects not deleted by FASTUIDRAWdelete
-  are printed with the file and line number of the allocation. When FASTUIDRAW_DEBUG
-  is not defined, FASTUIDRAWnew maps to new.
+  are printed with the file and line number of the allocation. FASTUIDRAWnew
+  is a placement new whose storage comes from the allocator set by
+  fastuidraw::memory::set_allocator() with the tag fastuidraw::memory::tag_general
+  (or from std::malloc if none is set). Arrays allocated with FASTUIDRAWnew
+  are an exception: their storage comes from the global operator new[],
+  because the number of elements an array delete destroys cannot be
+  recovered portably.
  */
 
 /*!\def FASTUIDRAWdelete
   Use FASTUIDRAWdelete for objects allocated with FASTUIDRAWnew.
-  When FASTUIDRAW_DEBUG is not defined, maps to fastuidraw::checked_delete(p).
+  Destroys the object and releases its storage to the allocator
+  set by fastuidraw::memory::set_allocator(). The type of the
+  object must be complete.
   \param ptr address of object to delete, value must be a return
-             value of FASTUIDRAWnew
+             value of FASTUIDRAWnew or a pointer to a base class
+             of it whose destructor is virtual
  */
 
 /*!\def FASTUIDRAWdelete_array
@@ -52,14 +134,16 @@
   When FASTUIDRAW_DEBUG is defined, allocations with FASTUIDRAWmalloc are tracked and
   at program exit a list of those objects not deleted by FASTUIDRAWfree
   are printed with the file and line number of the allocation. When FASTUIDRAW_DEBUG
-  is not defined, maps to std::malloc.
+  is not defined, maps to std::malloc or to the allocator set by
+  fastuidraw::memory::set_allocator().
  */
 
 /*!\def FASTUIDRAWcalloc
   When FASTUIDRAW_DEBUG is defined, allocations with FASTUIDRAWcalloc are tracked and
   at program exit a list of those objects not deleted by FASTUIDRAWfree
   are printed with the file and line number of the allocation. When FASTUIDRAW_DEBUG
-  is not defined, maps to std::calloc.
+  is not defined, maps to std::calloc or to the allocator set by
+  fastuidraw::memory::set_allocator().
   \param nmemb number of elements to allocate
   \param size size of each element in bytes
  */
@@ -68,7 +152,8 @@
   When FASTUIDRAW_DEBUG is defined, allocations with FASTUIDRAWrealloc are tracked and
   at program exit a list of those objects not deleted by FASTUIDRAWfree
   are printed with the file and line number of the allocation. When FASTUIDRAW_DEBUG
-  is not defined, maps to std::realloc.
+  is not defined, maps to std::realloc or to the allocator set by
+  fastuidraw::memory::set_allocator().
   \param ptr pointer at whcih to rellocate
   \param size new size
  */
@@ -76,45 +161,89 @@
 /*!\def FASTUIDRAWfree
   Use FASTUIDRAWfree for objects allocated with FASTUIDRAWmalloc,
   FASTUIDRAWrealloc and FASTUIDRAWcalloc. When FASTUIDRAW_DEBUG is not defined,
-  maps to std::free.
+  maps to std::free or to the allocator set by fastuidraw::memory::set_allocator().
+  \param ptr address of object to free
+ */
+
+/*!\def FASTUIDRAWmalloc_tag
+  Same as FASTUIDRAWmalloc, but the allocation is made with the
+  given fastuidraw::memory::tag_t. If an allocator is set with
+  fastuidraw::memory::set_allocator(), both FASTUIDRAWmalloc and
+  FASTUIDRAWmalloc_tag allocate from it (FASTUIDRAWmalloc
+  with the tag fastuidraw::memory::tag_general).
+  \param size number of bytes to allocate
+  \param tag fastuidraw::memory::tag_t of the allocation
+ */
+
+/*!\def FASTUIDRAWcalloc_tag
+  Same as FASTUIDRAWcalloc, but the allocation is made with
+  the given fastuidraw::memory::tag_t.
+  \param nmemb number of elements to allocate
+  \param size size of each element in bytes
+  \param tag fastuidraw::memory::tag_t of the allocation
+ */
+
+/*!\def FASTUIDRAWrealloc_tag
+  Same as FASTUIDRAWrealloc, but the allocation is made with
+  the given fastuidraw::memory::tag_t, which must be the same
+  tag as the original allocation.
+  \param ptr pointer at which to reallocate
+  \param size new size
+  \param tag fastuidraw::memory::tag_t of the allocation
+ */
+
+/*!\def FASTUIDRAWfree_tag
+  Same as FASTUIDRAWfree, but for allocations made with
+  the tag versions of the allocation macros.
   \param ptr address of object to free
+  \param tag fastuidraw::memory::tag_t of the allocation
  */
+
+#define FASTUIDRAWmalloc(size) \
+  FASTUIDRAWmalloc_tag(size, fastuidraw::memory::tag_general)
+#define FASTUIDRAWcalloc(nmemb, size) \
+  FASTUIDRAWcalloc_tag(nmemb, size, fastuidraw::memory::tag_general)
+#define FASTUIDRAWrealloc(ptr, size) \
+  FASTUIDRAWrealloc_tag(ptr, size, fastuidraw::memory::tag_general)
+#define FASTUIDRAWfree(ptr) \
+  FASTUIDRAWfree_tag(ptr, fastuidraw::memory::tag_general)
+
 #ifdef FASTUIDRAW_DEBUG
 #define FASTUIDRAWnew \
-  ::new(__FILE__, __LINE__)
+  ::new(fastuidraw::memory::tag_general, __FILE__, __LINE__)
 #define FASTUIDRAWdelete(ptr) \
   do {                                                                  \
-    fastuidraw::memory::object_deletion_message(ptr, __FILE__, __LINE__); \
-    fastuidraw::checked_delete(ptr); } while(0)
+    fastuidraw::memory::delete_implement(ptr, fastuidraw::memory::tag_general, \
+                                         __FILE__, __LINE__); } while(0)
 #define FASTUIDRAWdelete_array(ptr) \
   do {                                                                  \
     fastuidraw::memory::object_deletion_message(ptr, __FILE__, __LINE__); \
     fastuidraw::checked_array_delete(ptr); } while(0)
-#define FASTUIDRAWmalloc(size) \
-  fastuidraw::memory::malloc_implement(size, __FILE__, __LINE__)
-#define FASTUIDRAWcalloc(nmemb, size) \
-  fastuidraw::memory::calloc_implement(nmemb, size, __FILE__, __LINE__)
-#define FASTUIDRAWrealloc(ptr, size) \
-  fastuidraw::memory::realloc_implement(ptr, size, __FILE__, __LINE__)
-#define FASTUIDRAWfree(ptr) \
-  fastuidraw::memory::free_implement(ptr, __FILE__, __LINE__)
+#define FASTUIDRAWmalloc_tag(size, tag) \
+  fastuidraw::memory::malloc_implement(size, tag, __FILE__, __LINE__)
+#define FASTUIDRAWcalloc_tag(nmemb, size, tag) \
+  fastuidraw::memory::calloc_implement(nmemb, size, tag, __FILE__, __LINE__)
+#define FASTUIDRAWrealloc_tag(ptr, size, tag) \
+  fastuidraw::memory::realloc_implement(ptr, size, tag, __FILE__, __LINE__)
+#define FASTUIDRAWfree_tag(ptr, tag) \
+  fastuidraw::memory::free_implement(ptr, tag, __FILE__, __LINE__)
 
 #else
 
 #define FASTUIDRAWnew \
-  new
+  ::new(fastuidraw::memory::tag_general)
 #define FASTUIDRAWdelete(ptr) \
-  do { fastuidraw::checked_delete(ptr); } while(0)
+  do { fastuidraw::memory::delete_dispatch(ptr, fastuidraw::memory::tag_general); } while(0)
 #define FASTUIDRAWdelete_array(ptr) \
   do { fastuidraw::checked_array_delete(ptr); } while(0)
-#define FASTUIDRAWmalloc(size) \
-  std::malloc(size)
-#define FASTUIDRAWcalloc(nmemb, size) \
-  std::calloc(nmemb, size);
-#define FASTUIDRAWrealloc(ptr, size) \
-  std::realloc(ptr, size);
-#define FASTUIDRAWfree(ptr) \
-  std::free(ptr)
+#define FASTUIDRAWmalloc_tag(size, tag) \
+  fastuidraw::memory::malloc_dispatch(size, tag)
+#define FASTUIDRAWcalloc_tag(nmemb, size, tag) \
+  fastuidraw::memory::calloc_dispatch(nmemb, size, tag)
+#define FASTUIDRAWrealloc_tag(ptr, size, tag) \
+  fastuidraw::memory::realloc_dispatch(ptr, size, tag)
+#define FASTUIDRAWfree_tag(ptr, tag) \
+  fastuidraw::memory::free_dispatch(ptr, tag)
 
 #endif
 
@@ -24,35 +24,54 @@
 
 #include <cstddef>
 
-/*!
-  Internal routine used by FASTUIDRAWnew, do not use directly.
- */
-void*
-operator new(std::size_t n, const char *file, int line) throw ();
-
-/*!
-  Internal routine used by FASTUIDRAWnew, do not use directly.
- */
-void*
-operator new[](std::size_t n, const char *file, int line) throw ();
-
-/*!
-  Internal routine used by FASTUIDRAWnew, do not use directly.
- */
-void
-operator delete(void *ptr, const char *file, int line) throw();
-
-/*!
-  Internal routine used by FASTUIDRAWnew, do not use directly.
- */
-void
-operator delete[](void *ptr, const char *file, int line) throw();
-
 namespace fastuidraw
 {
 
 namespace memory
 {
+  /*!
+    Enumeration to tag the allocations made with
+    FASTUIDRAWmalloc_tag, FASTUIDRAWcalloc_tag and
+    FASTUIDRAWrealloc_tag by subsystem, so that an
+    \ref allocator can route allocations to arenas.
+   */
+  enum tag_t
+    {
+      /*!
+        Allocation not of a specific subsystem, the
+        tag of FASTUIDRAWmalloc, FASTUIDRAWcalloc and
+        FASTUIDRAWrealloc.
+       */
+      tag_general,
+
+      /*!
+        Allocation made for creating, tessellating
+        and filling paths.
+       */
+      tag_path,
+
+      /*!
+        Allocation made for glyphs and fonts.
+       */
+      tag_glyph,
+
+      /*!
+        Allocation made for images and their atlas.
+       */
+      tag_image,
+
+      /*!
+        Allocation made by Painter and the packing
+        of its data.
+       */
+      tag_painter,
+
+      /*!
+        Number of tags.
+       */
+      number_tags
+    };
+
   /*!
     Private function used by macro FASTUIDRAWdelete, do NOT call.
    */
@@ -63,26 +82,191 @@ namespace memory
     Private function used by macro FASTUIDRAWmalloc, do NOT call.
    */
   void*
-  malloc_implement(size_t size, const char *file, int line);
+  malloc_implement(size_t size, enum tag_t tag, const char *file, int line);
+
+  /*!
+    Private function used by macro FASTUIDRAWmalloc, do NOT call.
+   */
+  void*
+  malloc_dispatch(size_t size, enum tag_t tag);
+
+  /*!
+    Private function used by macro FASTUIDRAWcalloc, do NOT call.
+   */
+  void*
+  calloc_implement(size_t nmemb, size_t size, enum tag_t tag, const char *file, int line);
 
   /*!
     Private function used by macro FASTUIDRAWcalloc, do NOT call.
    */
   void*
-  calloc_implement(size_t nmemb, size_t size, const char *file, int line);
+  calloc_dispatch(size_t nmemb, size_t size, enum tag_t tag);
 
   /*!
     Private function used by macro FASTUIDRAWrealloc, do NOT call.
    */
   void*
-  realloc_implement(void *ptr, size_t size, const char *file, int line);
+  realloc_implement(void *ptr, size_t size, enum tag_t tag, const char *file, int line);
+
+  /*!
+    Private function used by macro FASTUIDRAWrealloc, do NOT call.
+   */
+  void*
+  realloc_dispatch(void *ptr, size_t size, enum tag_t tag);
+
+  /*!
+    Private function used by macro FASTUIDRAWfree, do NOT call.
+   */
+  void
+  free_implement(void *ptr, enum tag_t tag, const char *file, int line);
 
   /*!
     Private function used by macro FASTUIDRAWfree, do NOT call.
    */
   void
-  free_implement(void *ptr, const char *file, int line);
+  free_dispatch(void *ptr, enum tag_t tag);
+
+  /*!
+    Private class used by macro FASTUIDRAWdelete, do NOT use.
+    Gives the address of the storage of an object from a pointer
+    to it, which for a polymorphic type may be a pointer to a base
+    class sub-object at an offset within the storage.
+   */
+  template<bool is_polymorphic>
+  class object_storage
+  {
+  public:
+    template<typename T>
+    static
+    void*
+    get(T *p)
+    {
+      return const_cast<void*>(dynamic_cast<const volatile void*>(p));
+    }
+  };
+
+  /*!
+    Private class used by macro FASTUIDRAWdelete, do NOT use.
+   */
+  template<>
+  class object_storage<false>
+  {
+  public:
+    template<typename T>
+    static
+    void*
+    get(T *p)
+    {
+      return const_cast<void*>(static_cast<const volatile void*>(p));
+    }
+  };
+
+  /*!
+    Private function used by macro FASTUIDRAWdelete, do NOT call.
+    Destroys the object and returns the address of its storage.
+    If the type T is not complete, triggers a compiler error.
+   */
+  template<typename T>
+  void*
+  destroy_object(T *p)
+  {
+    typedef char type[sizeof(T) ? 1 : -1];
+    unsigned int N;
+    void *storage;
+
+    N = sizeof(type);
+    (void)N;
+    storage = object_storage<__is_polymorphic(T)>::get(p);
+    p->~T();
+    return storage;
+  }
+
+  /*!
+    Private function used by macro FASTUIDRAWdelete, do NOT call.
+   */
+  template<typename T>
+  void
+  delete_implement(T *p, enum tag_t tag, const char *file, int line)
+  {
+    if(p)
+      {
+        void *storage;
+
+        storage = destroy_object(p);
+        object_deletion_message(storage, file, line);
+        free_dispatch(storage, tag);
+      }
+  }
+
+  /*!
+    Private function used by macro FASTUIDRAWdelete, do NOT call.
+   */
+  template<typename T>
+  void
+  delete_dispatch(T *p, enum tag_t tag)
+  {
+    if(p)
+      {
+        free_dispatch(destroy_object(p), tag);
+      }
+  }
 
 } //namespace memory
 
 } //namespace fastuidraw
+
+/*!
+  Internal routine used by FASTUIDRAWnew, do not use directly.
+ */
+void*
+operator new(std::size_t n, enum fastuidraw::memory::tag_t tag) throw ();
+
+/*!
+  Internal routine used by FASTUIDRAWnew, do not use directly.
+ */
+void*
+operator new(std::size_t n, enum fastuidraw::memory::tag_t tag,
+             const char *file, int line) throw ();
+
+/*!
+  Internal routine used by FASTUIDRAWnew, do not use directly.
+ */
+void*
+operator new[](std::size_t n, enum fastuidraw::memory::tag_t tag) throw ();
+
+/*!
+  Internal routine used by FASTUIDRAWnew, do not use directly.
+ */
+void*
+operator new[](std::size_t n, enum fastuidraw::memory::tag_t tag,
+               const char *file, int line) throw ();
+
+/*!
+  Internal routine used by FASTUIDRAWnew if a constructor
+  throws, do not use directly.
+ */
+void
+operator delete(void *ptr, enum fastuidraw::memory::tag_t tag) throw();
+
+/*!
+  Internal routine used by FASTUIDRAWnew if a constructor
+  throws, do not use directly.
+ */
+void
+operator delete(void *ptr, enum fastuidraw::memory::tag_t tag,
+                const char *file, int line) throw();
+
+/*!
+  Internal routine used by FASTUIDRAWnew if a constructor
+  throws, do not use directly.
+ */
+void
+operator delete[](void *ptr, enum fastuidraw::memory::tag_t tag) throw();
+
+/*!
+  Internal routine used by FASTUIDRAWnew if a constructor
+  throws, do not use directly.
+ */
+void
+operator delete[](void *ptr, enum fastuidraw::memory::tag_t tag,
+                  const char *file, int line) throw();
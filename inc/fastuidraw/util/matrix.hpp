@@ -22,6 +22,7 @@
 
 #include <fastuidraw/util/math.hpp>
 #include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
 
 namespace fastuidraw {
 
@@ -731,6 +732,101 @@ public:
  */
 typedef matrix3x3<float> float3x3;
 
+/*!
+  Apply a matrix3x3 to an array of points, where each point p
+  is taken as (p.x(), p.y(), 1), i.e. dst[i] = m * vecN<T,3>(src[i].x(), src[i].y(), 1).
+  The entries of the matrix are read once and the body of the loop
+  is a fixed sequence of multiply-adds without branching so that a
+  compiler can vectorize it across the points.
+  \param m matrix to apply
+  \param src points to which to apply m
+  \param dst location to which to write the results, must be
+             atleast the size of src
+ */
+template<typename T>
+void
+transform_points(const matrix3x3<T> &m,
+                 const_c_array<vecN<T, 2> > src,
+                 c_array<vecN<T, 3> > dst)
+{
+  const T *q(m.c_ptr());
+  const T m00(q[0]), m10(q[1]), m20(q[2]);
+  const T m01(q[3]), m11(q[4]), m21(q[5]);
+  const T m02(q[6]), m12(q[7]), m22(q[8]);
+
+  assert(dst.size() >= src.size());
+  for(unsigned int i = 0, endi = src.size(); i < endi; ++i)
+    {
+      T x(src[i].x()), y(src[i].y());
+
+      dst[i].x() = m00 * x + m01 * y + m02;
+      dst[i].y() = m10 * x + m11 * y + m12;
+      dst[i].z() = m20 * x + m21 * y + m22;
+    }
+}
+
+/*!
+  Apply a matrix3x3 to an array of vectors, i.e. dst[i] = m * src[i].
+  As transform_points(const matrix3x3<T>&, const_c_array<vecN<T, 2> >, c_array<vecN<T, 3> >),
+  the loop is written so that a compiler can vectorize it.
+  \param m matrix to apply
+  \param src vectors to which to apply m
+  \param dst location to which to write the results, must be
+             atleast the size of src; may be the same array as src
+ */
+template<typename T>
+void
+transform_points(const matrix3x3<T> &m,
+                 const_c_array<vecN<T, 3> > src,
+                 c_array<vecN<T, 3> > dst)
+{
+  const T *q(m.c_ptr());
+  const T m00(q[0]), m10(q[1]), m20(q[2]);
+  const T m01(q[3]), m11(q[4]), m21(q[5]);
+  const T m02(q[6]), m12(q[7]), m22(q[8]);
+
+  assert(dst.size() >= src.size());
+  for(unsigned int i = 0, endi = src.size(); i < endi; ++i)
+    {
+      T x(src[i].x()), y(src[i].y()), z(src[i].z());
+
+      dst[i].x() = m00 * x + m01 * y + m02 * z;
+      dst[i].y() = m10 * x + m11 * y + m12 * z;
+      dst[i].z() = m20 * x + m21 * y + m22 * z;
+    }
+}
+
+/*!
+  Apply a matrix3x3 to an array of points, each point p taken
+  as (p.x(), p.y(), 1), followed by the perspective divide, i.e.
+  dst[i] = (r.x(), r.y()) / r.z() where r = m * vecN<T,3>(src[i].x(), src[i].y(), 1).
+  \param m matrix to apply
+  \param src points to which to apply m
+  \param dst location to which to write the results, must be
+             atleast the size of src; may be the same array as src
+ */
+template<typename T>
+void
+transform_points_projected(const matrix3x3<T> &m,
+                           const_c_array<vecN<T, 2> > src,
+                           c_array<vecN<T, 2> > dst)
+{
+  const T *q(m.c_ptr());
+  const T m00(q[0]), m10(q[1]), m20(q[2]);
+  const T m01(q[3]), m11(q[4]), m21(q[5]);
+  const T m02(q[6]), m12(q[7]), m22(q[8]);
+
+  assert(dst.size() >= src.size());
+  for(unsigned int i = 0, endi = src.size(); i < endi; ++i)
+    {
+      T x(src[i].x()), y(src[i].y()), recip_z;
+
+      recip_z = T(1) / (m20 * x + m21 * y + m22);
+      dst[i].x() = (m00 * x + m01 * y + m02) * recip_z;
+      dst[i].y() = (m10 * x + m11 * y + m12) * recip_z;
+    }
+}
+
 /*!
   Convenience typedef for projection_params\<float\>
  */
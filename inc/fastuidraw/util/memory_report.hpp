@@ -0,0 +1,226 @@
+/*!
+ * \file memory_report.hpp
+ * \brief file memory_report.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+namespace fastuidraw
+{
+
+namespace memory
+{
+/*!\addtogroup Utility
+  @{
+ */
+
+  /*!
+    Enumeration of the subsystems of FastUIDraw whose
+    memory is reported by subsystem_usage().
+   */
+  enum subsystem_t
+    {
+      /*!
+        CPU memory of the point data and edge ranges
+        of TessellatedPath objects, as reported by
+        TessellatedPath::number_bytes().
+       */
+      subsystem_tessellated_paths,
+
+      /*!
+        CPU memory of the attribute and index data held
+        by PainterAttributeData objects, i.e. the data
+        of StrokedPath and FilledPath objects.
+       */
+      subsystem_attribute_data,
+
+      /*!
+        CPU memory of the glyph entries held by
+        GlyphCache objects.
+       */
+      subsystem_glyph_cache,
+
+      /*!
+        GPU memory of the backing stores of the
+        GlyphAtlas objects.
+       */
+      subsystem_glyph_atlas,
+
+      /*!
+        GPU memory of the backing stores of the
+        ImageAtlas objects.
+       */
+      subsystem_image_atlas,
+
+      /*!
+        GPU memory of the backing stores of the
+        ColorStopAtlas objects.
+       */
+      subsystem_colorstop_atlas,
+
+      /*!
+        GPU memory of the buffers with which a
+        PainterBackend streams the data of its draws.
+       */
+      subsystem_painter_backend,
+
+      /*!
+        Number of subsystems.
+       */
+      number_subsystems
+    };
+
+  /*!
+    A usage holds the number of bytes of CPU and
+    GPU memory of a subsystem.
+   */
+  class usage
+  {
+  public:
+    /*!
+      Ctor.
+      \param cpu_bytes value with which to initialize m_cpu_bytes
+      \param gpu_bytes value with which to initialize m_gpu_bytes
+     */
+    explicit
+    usage(uint64_t cpu_bytes = 0, uint64_t gpu_bytes = 0):
+      m_cpu_bytes(cpu_bytes),
+      m_gpu_bytes(gpu_bytes),
+      m_free_bytes(0),
+      m_largest_free_bytes(0)
+    {}
+
+    /*!
+      Returns the fragmentation of the free space of the
+      backing stores of the subsystem, i.e.
+      1 - m_largest_free_bytes / m_free_bytes. A value of 0
+      indicates that the free space of each backing store is
+      in one piece, a value close to 1 that the free space
+      is split into many small pieces.
+     */
+    float
+    fragmentation(void) const
+    {
+      return (m_free_bytes != 0) ?
+        1.0f - static_cast<float>(m_largest_free_bytes) / static_cast<float>(m_free_bytes) :
+        0.0f;
+    }
+
+    /*!
+      Number of bytes of CPU memory.
+     */
+    uint64_t m_cpu_bytes;
+
+    /*!
+      Number of bytes of GPU memory. The GPU memory of
+      a backing store is computed from its dimensions
+      and the size of its texels before any compression,
+      it does not include padding added by the driver.
+     */
+    uint64_t m_gpu_bytes;
+
+    /*!
+      Number of bytes of the backing stores of the subsystem
+      that are free for allocation, only reported for the
+      backing stores from which ranges are allocated: the
+      geometry store of GlyphAtlas, the layers of ColorStopAtlas
+      and the static attribute and index heap of the GL backend.
+      Budgets do not apply to this value.
+     */
+    uint64_t m_free_bytes;
+
+    /*!
+      Sum over the backing stores counted in m_free_bytes
+      of the size in bytes of the largest free range of
+      each backing store.
+     */
+    uint64_t m_largest_free_bytes;
+  };
+
+  /*!
+    A budget_callback is notified when the memory
+    of a subsystem grows.
+   */
+  class budget_callback
+  {
+  public:
+    virtual
+    ~budget_callback()
+    {}
+
+    /*!
+      Called when the GPU memory of a subsystem grows,
+      for example when an atlas resizes its backing store.
+      Default implementation does nothing.
+      \param subsystem subsystem whose memory grew
+      \param current memory of the subsystem after the growth
+     */
+    virtual
+    void
+    grew(enum subsystem_t subsystem, const usage &current)
+    {
+      (void)subsystem;
+      (void)current;
+    }
+
+    /*!
+      To be implemented by a derived class to handle when
+      the memory of a subsystem grows to more than the
+      limit passed to set_budget().
+      \param subsystem subsystem whose memory grew
+      \param current memory of the subsystem after the growth
+      \param limit limit passed to set_budget()
+     */
+    virtual
+    void
+    over_budget(enum subsystem_t subsystem, const usage &current,
+                const usage &limit) = 0;
+  };
+
+  /*!
+    Returns the memory of a subsystem summed over all objects
+    of the subsystem. The values are maintained as objects are
+    created, resized and destroyed, so the call is only the cost
+    of a lock and a copy and can be made each frame. The call is
+    thread safe.
+    \param subsystem subsystem to query
+   */
+  usage
+  subsystem_usage(enum subsystem_t subsystem);
+
+  /*!
+    Set the budget of a subsystem. Each time the memory of the
+    subsystem grows, budget_callback::grew() is called if the GPU
+    memory grew, and budget_callback::over_budget() is called if
+    the CPU or GPU memory is then more than limit. A limit value of
+    0 indicates no limit. The callbacks are called from the thread
+    performing the allocation without any lock of this API held,
+    the callback must remain alive until it is replaced by another
+    call to set_budget(). The call is thread safe.
+    \param subsystem subsystem whose budget to set
+    \param limit limit of the subsystem
+    \param callback callback of the subsystem, NULL indicates no callback
+   */
+  void
+  set_budget(enum subsystem_t subsystem, const usage &limit,
+             budget_callback *callback);
+/*! @} */
+} //namespace memory
+
+} //namespace fastuidraw
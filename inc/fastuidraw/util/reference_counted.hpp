@@ -23,6 +23,9 @@
 #include <assert.h>
 
 #include <fastuidraw/util/util.hpp>
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+#include <utility>
+#endif
 #include <fastuidraw/util/fastuidraw_memory.hpp>
 
 #include <fastuidraw/util/reference_count_mutex.hpp>
@@ -113,6 +116,32 @@ namespace fastuidraw
         }
     }
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+    /*!
+      Move ctor, takes the reference of obj without
+      changing the reference count; obj is then NULL.
+      \param obj value from which to initialize
+     */
+    reference_counted_ptr(reference_counted_ptr &&obj) noexcept:
+      m_p(obj.m_p)
+    {
+      obj.m_p = NULL;
+    }
+
+    /*!
+      Move ctor from a reference_counted_ptr<U> where U* is
+      implicitely convertible to a T*; obj is then NULL.
+      \tparam U type where U* is implicitely convertible to a T*.
+      \param obj value from which to initialize
+     */
+    template<typename U>
+    reference_counted_ptr(reference_counted_ptr<U> &&obj) noexcept:
+      m_p(obj.m_p)
+    {
+      obj.m_p = NULL;
+    }
+#endif
+
     /*!
       Dtor, if pointer is non-NULL, then reference is decremented
       (via T::remove_reference()).
@@ -164,6 +193,37 @@ namespace fastuidraw
       return *this;
     }
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+    /*!
+      Move assignment operator, takes the reference of rhs
+      without changing its reference count; rhs is then NULL.
+      \param rhs value from which to assign
+     */
+    reference_counted_ptr&
+    operator=(reference_counted_ptr &&rhs) noexcept
+    {
+      reference_counted_ptr temp(std::move(rhs));
+      temp.swap(*this);
+      return *this;
+    }
+
+    /*!
+      Move assignment operator from a reference_counted_ptr<U>
+      where U* is implicitely convertible to a T*; rhs is
+      then NULL.
+      \tparam U type where U* is implicitely convertible to a T*.
+      \param rhs value from which to assign
+     */
+    template<typename U>
+    reference_counted_ptr&
+    operator=(reference_counted_ptr<U> &&rhs) noexcept
+    {
+      reference_counted_ptr temp(std::move(rhs));
+      temp.swap(*this);
+      return *this;
+    }
+#endif
+
     /*!
       Returns the underlying pointer
      */
@@ -337,6 +397,9 @@ namespace fastuidraw
     }
 
   private:
+    template<typename U>
+    friend class reference_counted_ptr;
+
     T *m_p;
   };
 
@@ -0,0 +1,180 @@
+/*!
+ * \file task_executor.hpp
+ * \brief file task_executor.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/util/c_array.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Utility
+  @{
+ */
+
+  /*!
+    A TaskExecutor runs the work that FastUIDraw splits across
+    threads: the tessellation of the edges of a TessellatedPath,
+    the triangulation of the subsets of a FilledPath, the joins
+    and caps of a StrokedPath, the filling of PainterAttributeData,
+    the deferred glyph generation of GlyphCache and the mipmap
+    generation of Image, and it runs the background work of the
+    asynchronous tessellation of Path (see Path::async_tessellation())
+    and of the glyph prefetching of GlyphCache. All of them use the
+    TaskExecutor returned
+    by default_task_executor(), so an application can size or
+    replace that single executor, for example with one that
+    forwards to the thread pool of the application.
+   */
+  class TaskExecutor:
+    public reference_counted<TaskExecutor>::default_base
+  {
+  public:
+    /*!
+      A Task is a unit of work run by a TaskExecutor.
+     */
+    class Task
+    {
+    public:
+      virtual
+      ~Task()
+      {}
+
+      /*!
+        To be implemented by a derived class to perform
+        the work of the Task. May be called from any thread.
+       */
+      virtual
+      void
+      run(void) = 0;
+    };
+
+    virtual
+    ~TaskExecutor()
+    {}
+
+    /*!
+      To be implemented by a derived class to return the number
+      of threads that may run tasks at the same time, including
+      the thread calling run_tasks(). FastUIDraw splits its work
+      into at most this many tasks when a caller asks for the
+      number of threads to be chosen automatically. Must return
+      at least 1.
+     */
+    virtual
+    unsigned int
+    number_threads(void) const = 0;
+
+    /*!
+      To be implemented by a derived class to run each of the
+      passed tasks exactly once and to return only when all of
+      them are done. The tasks may run in any order and on any
+      threads, including the calling thread. A Task may itself
+      call run_tasks(), an implementation must not dead-lock
+      when it does. May be called from several threads at the
+      same time.
+      \param tasks tasks to run, the Task objects are owned
+                   by the caller
+     */
+    virtual
+    void
+    run_tasks(const_c_array<Task*> tasks) = 0;
+
+    /*!
+      To be implemented by a derived class to run a Task later
+      on a thread of the executor and to return without waiting
+      for it. The caller must keep the Task alive until its
+      Task::run() returns. An implementation that has no thread
+      other than the calling one may run the Task before
+      returning. May be called from several threads at the
+      same time.
+      \param task task to run, owned by the caller
+     */
+    virtual
+    void
+    run_task_async(Task *task) = 0;
+  };
+
+  /*!
+    A WorkStealingTaskExecutor is the TaskExecutor that
+    FastUIDraw uses by default. It runs tasks with a fixed
+    set of worker threads, each with its own queue of tasks.
+    The tasks of run_tasks() are placed on the queue of the
+    calling thread (or on a shared queue if the caller is
+    not a worker) and the calling thread runs tasks until
+    those it passed are done; an idle thread takes tasks
+    from the queues of the other threads. The tasks of
+    run_task_async() are kept on a separate queue that only
+    the worker threads take from, so that they never delay
+    the return of run_tasks(); they are taken when the worker
+    finds no task of run_tasks() to run.
+   */
+  class WorkStealingTaskExecutor:public TaskExecutor
+  {
+  public:
+    /*!
+      Ctor.
+      \param number_threads number of threads that run tasks
+                            including the calling thread of
+                            run_tasks(), i.e. the number of
+                            worker threads created is one less.
+                            A value of 0 indicates to use the
+                            number of hardware threads.
+     */
+    explicit
+    WorkStealingTaskExecutor(unsigned int number_threads = 0);
+
+    ~WorkStealingTaskExecutor();
+
+    virtual
+    unsigned int
+    number_threads(void) const;
+
+    virtual
+    void
+    run_tasks(const_c_array<Task*> tasks);
+
+    virtual
+    void
+    run_task_async(Task *task);
+
+  private:
+    void *m_d;
+  };
+
+  /*!
+    Returns the TaskExecutor used by FastUIDraw. If none was set
+    with default_task_executor(const reference_counted_ptr<TaskExecutor>&),
+    a WorkStealingTaskExecutor with one thread per hardware thread
+    is created on the first call. Thread safe.
+   */
+  reference_counted_ptr<TaskExecutor>
+  default_task_executor(void);
+
+  /*!
+    Set the TaskExecutor used by FastUIDraw. Work already running
+    on the previous TaskExecutor completes on it. Thread safe.
+    \param executor TaskExecutor to use, a NULL value indicates
+                    to create a WorkStealingTaskExecutor on the
+                    next call to default_task_executor(void)
+   */
+  void
+  default_task_executor(const reference_counted_ptr<TaskExecutor> &executor);
+/*! @} */
+}
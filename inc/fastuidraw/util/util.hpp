@@ -23,6 +23,23 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/*!\addtogroup Utility
+  @{
+ */
+
+/*!\def FASTUIDRAW_HAS_MOVE_SEMANTICS
+  Defined when the compiler supports rvalue references (C++11
+  or later); the move ctors and move assignment operators of
+  reference_counted_ptr, Path, PainterAttributeData,
+  ColorStopSequence and glsl::ShaderSource are only declared
+  when it is defined.
+ */
+#if __cplusplus >= 201103L
+#define FASTUIDRAW_HAS_MOVE_SEMANTICS
+#endif
+
+/*! @} */
+
 namespace fastuidraw
 {
 /*!\addtogroup Utility
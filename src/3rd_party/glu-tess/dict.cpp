@@ -38,7 +38,8 @@
 
 /* really glu_fastuidraw_gl_dictListNewDict */
 Dict *dictNewDict( void *frame,
-                   int (*leq)(void *frame, DictKey key1, DictKey key2) )
+                   int (*leq)(void *frame, DictKey key1, DictKey key2),
+                   GLUpool *pool )
 {
   Dict *dict = (Dict *) memAlloc( sizeof( Dict ));
   DictNode *head;
@@ -53,6 +54,7 @@ Dict *dictNewDict( void *frame,
 
   dict->frame = frame;
   dict->leq = leq;
+  dict->pool = pool;
 
   return dict;
 }
@@ -64,7 +66,7 @@ void dictDeleteDict( Dict *dict )
 
   for( node = dict->head.next; node != &dict->head; node = next ) {
     next = node->next;
-    memFree( node );
+    poolFree( node );
   }
   memFree( dict );
 }
@@ -78,7 +80,7 @@ DictNode *dictInsertBefore( Dict *dict, DictNode *node, DictKey key )
     node = node->prev;
   } while( node->key != NULL && ! (*dict->leq)(dict->frame, node->key, key));
 
-  newNode = (DictNode *) memAlloc( sizeof( DictNode ));
+  newNode = (DictNode *) poolAlloc( dict->pool, sizeof( DictNode ));
   if (newNode == NULL) return NULL;
 
   newNode->key = key;
@@ -96,7 +98,7 @@ void dictDelete( Dict *dict, DictNode *node ) /*ARGSUSED*/
   (void)dict;
   node->next->prev = node->prev;
   node->prev->next = node->next;
-  memFree( node );
+  poolFree( node );
 }
 
 /* really glu_fastuidraw_gl_dictListSearch */
@@ -41,7 +41,7 @@
 #define Dict            DictList
 #define DictNode        DictListNode
 
-#define dictNewDict(frame,leq)          glu_fastuidraw_gl_dictListNewDict(frame,leq)
+#define dictNewDict(frame,leq,pool)     glu_fastuidraw_gl_dictListNewDict(frame,leq,pool)
 #define dictDeleteDict(dict)            glu_fastuidraw_gl_dictListDeleteDict(dict)
 
 #define dictSearch(dict,key)            glu_fastuidraw_gl_dictListSearch(dict,key)
@@ -63,7 +63,8 @@ typedef struct DictNode DictNode;
 
 Dict            *dictNewDict(
                         void *frame,
-                        int (*leq)(void *frame, DictKey key1, DictKey key2) );
+                        int (*leq)(void *frame, DictKey key1, DictKey key2),
+                        struct GLUpool *pool );
 
 void            dictDeleteDict( Dict *dict );
 
@@ -95,6 +96,7 @@ struct Dict {
   DictNode      head;
   void          *frame;
   int           (*leq)(void *frame, DictKey key1, DictKey key2);
+  struct GLUpool *pool;         /* from which the nodes are allocated */
 };
 
 #endif
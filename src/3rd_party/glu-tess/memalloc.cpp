@@ -33,6 +33,7 @@
 */
 
 #include "memalloc.hpp"
+#include <stddef.h>
 #include <string.h>
 
 int glu_fastuidraw_gl_memInit( size_t maxFast )
@@ -53,3 +54,139 @@ void *glu_fastuidraw_gl_memAlloc( size_t n )
   return memset( FASTUIDRAWmalloc( n ), 0xa5, n );
 }
 #endif
+
+#define POOL_CLASS_SIZE    16
+#define POOL_NUM_CLASSES   16
+#define POOL_CHUNK_SIZE    (64 * 1024)
+
+typedef union {
+  struct {
+    GLUpool     *pool;          /* NULL if allocated by memAlloc() */
+    unsigned int sizeClass;
+  } h;
+  double        align;
+} PoolHeader;
+
+typedef struct PoolBlock { struct PoolBlock *next; } PoolBlock;
+
+typedef struct PoolChunk {
+  struct PoolChunk *next;
+  size_t        used;
+  double        align;          /* the blocks start after this */
+} PoolChunk;
+
+struct GLUpool {
+  PoolChunk     *chunks;        /* list of all chunks */
+  PoolChunk     *current;       /* chunk from which new blocks are cut */
+  PoolBlock     *freeList[POOL_NUM_CLASSES];
+};
+
+static char *chunkData( PoolChunk *c )
+{
+  return (char *)&c->align;
+}
+
+GLUpool *glu_fastuidraw_gl_poolNew( void )
+{
+  GLUpool *pool = (GLUpool *)memAlloc( sizeof( GLUpool ));
+  if (pool == NULL) return NULL;
+
+  pool->chunks = NULL;
+  pool->current = NULL;
+  memset( pool->freeList, 0, sizeof( pool->freeList ));
+  return pool;
+}
+
+void glu_fastuidraw_gl_poolDelete( GLUpool *pool )
+{
+  PoolChunk *c, *cNext;
+
+  for( c = pool->chunks; c != NULL; c = cNext ) {
+    cNext = c->next;
+    memFree( c );
+  }
+  memFree( pool );
+}
+
+void glu_fastuidraw_gl_poolReset( GLUpool *pool )
+{
+  PoolChunk *c;
+
+  for( c = pool->chunks; c != NULL; c = c->next ) {
+    c->used = 0;
+  }
+  pool->current = pool->chunks;
+  memset( pool->freeList, 0, sizeof( pool->freeList ));
+}
+
+void *glu_fastuidraw_gl_poolAlloc( GLUpool *pool, size_t size )
+{
+  unsigned int sizeClass;
+  size_t blockSize;
+  PoolHeader *header;
+
+  sizeClass = (unsigned int)((size + sizeof( PoolHeader ) + POOL_CLASS_SIZE - 1) / POOL_CLASS_SIZE) - 1;
+  if( sizeClass >= POOL_NUM_CLASSES ) {
+    header = (PoolHeader *)memAlloc( size + sizeof( PoolHeader ));
+    if (header == NULL) return NULL;
+    header->h.pool = NULL;
+    header->h.sizeClass = sizeClass;
+    return header + 1;
+  }
+
+  if( pool->freeList[sizeClass] != NULL ) {
+    PoolBlock *b = pool->freeList[sizeClass];
+    pool->freeList[sizeClass] = b->next;
+    header = (PoolHeader *)b;
+    header->h.pool = pool;
+    header->h.sizeClass = sizeClass;
+    return header + 1;
+  }
+
+  /* cut a new block from the current chunk, moving to the
+   * next chunk (kept by poolReset()) or to a new one when
+   * the current chunk is full.
+   */
+  blockSize = (sizeClass + 1) * POOL_CLASS_SIZE;
+  while( pool->current != NULL && pool->current->used + blockSize > POOL_CHUNK_SIZE ) {
+    pool->current = pool->current->next;
+  }
+  if( pool->current == NULL ) {
+    PoolChunk *c = (PoolChunk *)memAlloc( offsetof( PoolChunk, align ) + POOL_CHUNK_SIZE );
+    if (c == NULL) return NULL;
+    c->next = pool->chunks;
+    c->used = 0;
+    pool->chunks = c;
+    pool->current = c;
+  }
+
+  header = (PoolHeader *)(chunkData( pool->current ) + pool->current->used);
+  pool->current->used += blockSize;
+  header->h.pool = pool;
+  header->h.sizeClass = sizeClass;
+  return header + 1;
+}
+
+void glu_fastuidraw_gl_poolFree( void *ptr )
+{
+  PoolHeader *header = (PoolHeader *)ptr - 1;
+  GLUpool *pool = header->h.pool;
+  unsigned int sizeClass = header->h.sizeClass;
+  PoolBlock *b;
+
+  if( pool == NULL ) {
+    memFree( header );
+    return;
+  }
+
+  /* the header is written again when the block is reused */
+  b = (PoolBlock *)header;
+  b->next = pool->freeList[sizeClass];
+  pool->freeList[sizeClass] = b;
+}
+
+GLUpool *glu_fastuidraw_gl_poolOf( void *ptr )
+{
+  PoolHeader *header = (PoolHeader *)ptr - 1;
+  return header->h.pool;
+}
@@ -38,18 +38,48 @@
 #include <stdlib.h>
 #include <fastuidraw/util/fastuidraw_memory.hpp>
 
-#define memRealloc      FASTUIDRAWrealloc
-#define memFree         FASTUIDRAWfree
+#define memRealloc(ptr, size) FASTUIDRAWrealloc_tag(ptr, size, fastuidraw::memory::tag_path)
+#define memFree(ptr)    FASTUIDRAWfree_tag(ptr, fastuidraw::memory::tag_path)
 
 #define memInit         glu_fastuidraw_gl_memInit
 /*extern void           glu_fastuidraw_gl_memInit( size_t );*/
 extern int              glu_fastuidraw_gl_memInit( size_t );
 
 #ifndef MEMORY_DEBUG
-#define memAlloc        FASTUIDRAWmalloc
+#define memAlloc(size)  FASTUIDRAWmalloc_tag(size, fastuidraw::memory::tag_path)
 #else
 #define memAlloc        glu_fastuidraw_gl_memAlloc
 extern void *           glu_fastuidraw_gl_memAlloc( size_t );
 #endif
 
+/* A GLUpool hands out the small objects of the tessellator
+ * (vertices, faces, half-edge pairs, active regions and the
+ * nodes of the sweep line dictionary) from large chunks owned
+ * by a tessellator. Each block starts with a header naming its
+ * pool and size class, so poolFree() needs no pool argument; a
+ * freed block is put on the free list of its size class and
+ * reused by the next allocation of that class. poolReset()
+ * makes all the blocks free at once while keeping the chunks,
+ * so that the next polygon of the tessellator allocates no
+ * memory until it needs more than the largest polygon before.
+ * Blocks too large for a size class are passed to memAlloc().
+ */
+typedef struct GLUpool GLUpool;
+
+#define poolNew         glu_fastuidraw_gl_poolNew
+#define poolDelete      glu_fastuidraw_gl_poolDelete
+#define poolReset       glu_fastuidraw_gl_poolReset
+#define poolAlloc       glu_fastuidraw_gl_poolAlloc
+#define poolFree        glu_fastuidraw_gl_poolFree
+#define poolOf          glu_fastuidraw_gl_poolOf
+
+extern GLUpool *        glu_fastuidraw_gl_poolNew( void );
+extern void             glu_fastuidraw_gl_poolDelete( GLUpool *pool );
+extern void             glu_fastuidraw_gl_poolReset( GLUpool *pool );
+extern void *           glu_fastuidraw_gl_poolAlloc( GLUpool *pool, size_t size );
+extern void             glu_fastuidraw_gl_poolFree( void *ptr );
+
+/* returns the pool from which a block of poolAlloc() came */
+extern GLUpool *        glu_fastuidraw_gl_poolOf( void *ptr );
+
 #endif
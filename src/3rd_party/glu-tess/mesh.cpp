@@ -45,14 +45,14 @@
 #define FALSE 0
 #endif
 
-static GLUvertex *allocVertex()
+static GLUvertex *allocVertex( GLUpool *pool )
 {
-   return (GLUvertex *)memAlloc( sizeof( GLUvertex ));
+   return (GLUvertex *)poolAlloc( pool, sizeof( GLUvertex ));
 }
 
-static GLUface *allocFace()
+static GLUface *allocFace( GLUpool *pool )
 {
-   return (GLUface *)memAlloc( sizeof( GLUface ));
+   return (GLUface *)poolAlloc( pool, sizeof( GLUface ));
 }
 
 /************************ Utility Routines ************************/
@@ -62,16 +62,25 @@ static GLUface *allocFace()
  */
 typedef struct { GLUhalfEdge e, eSym; } EdgePair;
 
+/* The vertices, faces and edges of a mesh come from the pool of the
+ * mesh; edgePool( e ) is that pool for an edge e of the mesh (but not
+ * for the dummy header edges embedded in the GLUmesh).
+ */
+static GLUpool *edgePool( GLUhalfEdge *e )
+{
+  return poolOf( (e->Sym < e) ? e->Sym : e );
+}
+
 /* MakeEdge creates a new pair of half-edges which form their own loop.
  * No vertex or face structures are allocated, but these must be assigned
  * before the current edge operation is completed.
  */
-static GLUhalfEdge *MakeEdge( GLUhalfEdge *eNext )
+static GLUhalfEdge *MakeEdge( GLUpool *pool, GLUhalfEdge *eNext )
 {
   GLUhalfEdge *e;
   GLUhalfEdge *eSym;
   GLUhalfEdge *ePrev;
-  EdgePair *pair = (EdgePair *)memAlloc( sizeof( EdgePair ));
+  EdgePair *pair = (EdgePair *)poolAlloc( pool, sizeof( EdgePair ));
   if (pair == NULL) return NULL;
 
   e = &pair->e;
@@ -215,7 +224,7 @@ static void KillEdge( GLUhalfEdge *eDel )
   eNext->Sym->next = ePrev;
   ePrev->Sym->next = eNext;
 
-  memFree( eDel );
+  poolFree( eDel );
 }
 
 
@@ -240,7 +249,7 @@ static void KillVertex( GLUvertex *vDel, GLUvertex *newOrg )
   vNext->prev = vPrev;
   vPrev->next = vNext;
 
-  memFree( vDel );
+  poolFree( vDel );
 }
 
 /* KillFace( fDel ) destroys a face and removes it from the global face
@@ -264,7 +273,7 @@ static void KillFace( GLUface *fDel, GLUface *newLface )
   fNext->prev = fPrev;
   fPrev->next = fNext;
 
-  memFree( fDel );
+  poolFree( fDel );
 }
 
 
@@ -275,24 +284,24 @@ static void KillFace( GLUface *fDel, GLUface *newLface )
  */
 GLUhalfEdge *glu_fastuidraw_gl_meshMakeEdge( GLUmesh *mesh )
 {
-  GLUvertex *newVertex1= allocVertex();
-  GLUvertex *newVertex2= allocVertex();
-  GLUface *newFace= allocFace();
+  GLUvertex *newVertex1= allocVertex( mesh->pool );
+  GLUvertex *newVertex2= allocVertex( mesh->pool );
+  GLUface *newFace= allocFace( mesh->pool );
   GLUhalfEdge *e;
 
   /* if any one is null then all get freed */
   if (newVertex1 == NULL || newVertex2 == NULL || newFace == NULL) {
-     if (newVertex1 != NULL) memFree(newVertex1);
-     if (newVertex2 != NULL) memFree(newVertex2);
-     if (newFace != NULL) memFree(newFace);
+     if (newVertex1 != NULL) poolFree(newVertex1);
+     if (newVertex2 != NULL) poolFree(newVertex2);
+     if (newFace != NULL) poolFree(newFace);
      return NULL;
   }
 
-  e = MakeEdge( &mesh->eHead );
+  e = MakeEdge( mesh->pool, &mesh->eHead );
   if (e == NULL) {
-     memFree(newVertex1);
-     memFree(newVertex2);
-     memFree(newFace);
+     poolFree(newVertex1);
+     poolFree(newVertex2);
+     poolFree(newFace);
      return NULL;
   }
 
@@ -330,8 +339,10 @@ int glu_fastuidraw_gl_meshSplice( GLUhalfEdge *eOrg, GLUhalfEdge *eDst )
 {
   int joiningLoops = FALSE;
   int joiningVertices = FALSE;
+  GLUpool *pool;
 
   if( eOrg == eDst ) return 1;
+  pool = edgePool( eOrg );
 
   if( eDst->Org != eOrg->Org ) {
     /* We are merging two disjoint vertices -- destroy eDst->Org */
@@ -348,7 +359,7 @@ int glu_fastuidraw_gl_meshSplice( GLUhalfEdge *eOrg, GLUhalfEdge *eDst )
   Splice( eDst, eOrg );
 
   if( ! joiningVertices ) {
-    GLUvertex *newVertex= allocVertex();
+    GLUvertex *newVertex= allocVertex( pool );
     if (newVertex == NULL) return 0;
 
     /* We split one vertex into two -- the new vertex is eDst->Org.
@@ -358,7 +369,7 @@ int glu_fastuidraw_gl_meshSplice( GLUhalfEdge *eOrg, GLUhalfEdge *eDst )
     eOrg->Org->anEdge = eOrg;
   }
   if( ! joiningLoops ) {
-    GLUface *newFace= allocFace();
+    GLUface *newFace= allocFace( pool );
     if (newFace == NULL) return 0;
 
     /* We split one loop into two -- the new loop is eDst->Lface.
@@ -405,7 +416,7 @@ int glu_fastuidraw_gl_meshDelete( GLUhalfEdge *eDel )
 
     Splice( eDel, eDel->Oprev );
     if( ! joiningLoops ) {
-      GLUface *newFace= allocFace();
+      GLUface *newFace= allocFace( edgePool( eDel ) );
       if (newFace == NULL) return 0;
 
       /* We are splitting one loop into two -- create a new loop for eDel. */
@@ -447,7 +458,8 @@ int glu_fastuidraw_gl_meshDelete( GLUhalfEdge *eDel )
 GLUhalfEdge *glu_fastuidraw_gl_meshAddEdgeVertex( GLUhalfEdge *eOrg )
 {
   GLUhalfEdge *eNewSym;
-  GLUhalfEdge *eNew = MakeEdge( eOrg );
+  GLUpool *pool = edgePool( eOrg );
+  GLUhalfEdge *eNew = MakeEdge( pool, eOrg );
   if (eNew == NULL) return NULL;
 
   eNewSym = eNew->Sym;
@@ -458,7 +470,7 @@ GLUhalfEdge *glu_fastuidraw_gl_meshAddEdgeVertex( GLUhalfEdge *eOrg )
   /* Set the vertex and face information */
   eNew->Org = eOrg->Dst;
   {
-    GLUvertex *newVertex= allocVertex();
+    GLUvertex *newVertex= allocVertex( pool );
     if (newVertex == NULL) return NULL;
 
     MakeVertex( newVertex, eNewSym, eNew->Org );
@@ -510,7 +522,8 @@ GLUhalfEdge *glu_fastuidraw_gl_meshConnect( GLUhalfEdge *eOrg, GLUhalfEdge *eDst
 {
   GLUhalfEdge *eNewSym;
   int joiningLoops = FALSE;
-  GLUhalfEdge *eNew = MakeEdge( eOrg );
+  GLUpool *pool = edgePool( eOrg );
+  GLUhalfEdge *eNew = MakeEdge( pool, eOrg );
   if (eNew == NULL) return NULL;
 
   eNewSym = eNew->Sym;
@@ -534,7 +547,7 @@ GLUhalfEdge *glu_fastuidraw_gl_meshConnect( GLUhalfEdge *eOrg, GLUhalfEdge *eDst
   eOrg->Lface->anEdge = eNewSym;
 
   if( ! joiningLoops ) {
-    GLUface *newFace= allocFace();
+    GLUface *newFace= allocFace( pool );
     if (newFace == NULL) return NULL;
 
     /* We split one loop into two -- the new loop is eNew->Lface */
@@ -594,14 +607,15 @@ void glu_fastuidraw_gl_meshZapFace( GLUface *fZap )
   fNext->prev = fPrev;
   fPrev->next = fNext;
 
-  memFree( fZap );
+  poolFree( fZap );
 }
 
 
-/* glu_fastuidraw_gl_meshNewMesh() creates a new mesh with no edges, no vertices,
- * and no loops (what we usually call a "face").
+/* glu_fastuidraw_gl_meshNewMesh( pool ) creates a new mesh with no edges, no vertices,
+ * and no loops (what we usually call a "face"), whose vertices, faces and
+ * edges are allocated from pool.
  */
-GLUmesh *glu_fastuidraw_gl_meshNewMesh( void )
+GLUmesh *glu_fastuidraw_gl_meshNewMesh( GLUpool *pool )
 {
   GLUvertex *v;
   GLUface *f;
@@ -616,6 +630,7 @@ GLUmesh *glu_fastuidraw_gl_meshNewMesh( void )
   f = &mesh->fHead;
   e = &mesh->eHead;
   eSym = &mesh->eHeadSym;
+  mesh->pool = pool;
 
   v->next = v->prev = v;
   v->anEdge = NULL;
@@ -717,18 +732,18 @@ void glu_fastuidraw_gl_meshDeleteMesh( GLUmesh *mesh )
 
   for( f = mesh->fHead.next; f != &mesh->fHead; f = fNext ) {
     fNext = f->next;
-    memFree( f );
+    poolFree( f );
   }
 
   for( v = mesh->vHead.next; v != &mesh->vHead; v = vNext ) {
     vNext = v->next;
-    memFree( v );
+    poolFree( v );
   }
 
   for( e = mesh->eHead.next; e != &mesh->eHead; e = eNext ) {
     /* One call frees both e and e->Sym (see EdgePair above) */
     eNext = e->next;
-    memFree( e );
+    poolFree( e );
   }
 
   memFree( mesh );
@@ -166,6 +166,7 @@ struct GLUmesh {
   GLUface       fHead;          /* dummy header for face list */
   GLUhalfEdge   eHead;          /* dummy header for edge list */
   GLUhalfEdge   eHeadSym;       /* and its symmetric counterpart */
+  struct GLUpool *pool;         /* pool of the vertices, faces and edges */
 };
 
 /* The mesh operations below have three motivations: completeness,
@@ -227,7 +228,7 @@ struct GLUmesh {
  *
  * ************************ Other Operations *****************************
  *
- * glu_fastuidraw_gl_meshNewMesh() creates a new mesh with no edges, no vertices,
+ * glu_fastuidraw_gl_meshNewMesh( pool ) creates a new mesh with no edges, no vertices,
  * and no loops (what we usually call a "face").
  *
  * glu_fastuidraw_gl_meshUnion( mesh1, mesh2 ) forms the union of all structures in
@@ -253,7 +254,7 @@ GLUhalfEdge     *glu_fastuidraw_gl_meshAddEdgeVertex( GLUhalfEdge *eOrg );
 GLUhalfEdge     *glu_fastuidraw_gl_meshSplitEdge( GLUhalfEdge *eOrg );
 GLUhalfEdge     *glu_fastuidraw_gl_meshConnect( GLUhalfEdge *eOrg, GLUhalfEdge *eDst );
 
-GLUmesh         *glu_fastuidraw_gl_meshNewMesh( void );
+GLUmesh         *glu_fastuidraw_gl_meshNewMesh( struct GLUpool *pool );
 GLUmesh         *glu_fastuidraw_gl_meshUnion( GLUmesh *mesh1, GLUmesh *mesh2 );
 void            glu_fastuidraw_gl_meshDeleteMesh( GLUmesh *mesh );
 void            glu_fastuidraw_gl_meshZapFace( GLUface *fZap );
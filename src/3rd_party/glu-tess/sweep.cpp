@@ -159,7 +159,7 @@ static void DeleteRegion( fastuidraw_GLUtesselator *tess, ActiveRegion *reg )
   }
   reg->eUp->activeRegion = NULL;
   dictDelete( tess->dict, reg->nodeUp ); /* glu_fastuidraw_gl_dictListDelete */
-  memFree( reg );
+  poolFree( reg );
 }
 
 
@@ -220,7 +220,7 @@ static ActiveRegion *AddRegionBelow( fastuidraw_GLUtesselator *tess,
  * Winding number and "inside" flag are not updated.
  */
 {
-  ActiveRegion *regNew = (ActiveRegion *)memAlloc( sizeof( ActiveRegion ));
+  ActiveRegion *regNew = (ActiveRegion *)poolAlloc( tess->pool, sizeof( ActiveRegion ));
   if (regNew == NULL) longjmp(tess->env,1);
 
   regNew->eUp = eNewUp;
@@ -1126,7 +1126,7 @@ static void AddSentinel( fastuidraw_GLUtesselator *tess, double t )
  */
 {
   GLUhalfEdge *e;
-  ActiveRegion *reg = (ActiveRegion *)memAlloc( sizeof( ActiveRegion ));
+  ActiveRegion *reg = (ActiveRegion *)poolAlloc( tess->pool, sizeof( ActiveRegion ));
   if (reg == NULL) longjmp(tess->env,1);
 
   e = glu_fastuidraw_gl_meshMakeEdge( tess->mesh );
@@ -1156,7 +1156,7 @@ static void InitEdgeDict( fastuidraw_GLUtesselator *tess )
  */
 {
   /* glu_fastuidraw_gl_dictListNewDict */
-  tess->dict = dictNewDict( tess, (int (*)(void *, DictKey, DictKey)) EdgeLeq );
+  tess->dict = dictNewDict( tess, (int (*)(void *, DictKey, DictKey)) EdgeLeq, tess->pool );
   if (tess->dict == NULL) longjmp(tess->env,1);
 
   AddSentinel( tess, -SENTINEL_COORD );
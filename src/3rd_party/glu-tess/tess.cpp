@@ -163,7 +163,7 @@ fastuidraw_gluNewTess_debug(const char *file, int line)
 {
   fastuidraw_GLUtesselator *R;
   R = fastuidraw_gluNewTess_release();
-  R->fastuidraw_alloc_tracker = fastuidraw::memory::malloc_implement(4, file, line);
+  R->fastuidraw_alloc_tracker = fastuidraw::memory::malloc_implement(4, fastuidraw::memory::tag_general, file, line);
   return R;
 }
 
@@ -184,6 +184,12 @@ fastuidraw_gluNewTess_release( void )
      return 0;                  /* out of memory */
   }
 
+  tess->pool = poolNew();
+  if (tess->pool == NULL) {
+     memFree( tess );
+     return 0;                  /* out of memory */
+  }
+
 
   tess->state = T_DORMANT;
 
@@ -269,7 +275,7 @@ static void GotoState( fastuidraw_GLUtesselator *tess, enum TessState newState )
 void REGALFASTUIDRAW_GLU_CALL
 fastuidraw_gluDeleteTess_debug(fastuidraw_GLUtesselator* tess, const char *file, int line)
 {
-  fastuidraw::memory::free_implement(tess->fastuidraw_alloc_tracker, file, line);
+  fastuidraw::memory::free_implement(tess->fastuidraw_alloc_tracker, fastuidraw::memory::tag_general, file, line);
   fastuidraw_gluDeleteTess_release(tess);
 }
 
@@ -278,6 +284,7 @@ void REGALFASTUIDRAW_GLU_CALL
 fastuidraw_gluDeleteTess_release( fastuidraw_GLUtesselator *tess )
 {
   RequireState( tess, T_DORMANT );
+  poolDelete( tess->pool );
   memFree( tess );
 }
 
@@ -456,7 +463,7 @@ static int EmptyCache( fastuidraw_GLUtesselator *tess )
   CachedVertex *vLast;
   int add_return_value, edges_real;
 
-  tess->mesh = glu_fastuidraw_gl_meshNewMesh();
+  tess->mesh = glu_fastuidraw_gl_meshNewMesh( tess->pool );
   if (tess->mesh == NULL) return 0;
 
   edges_real = tess->edges_real;
@@ -531,6 +538,11 @@ fastuidraw_gluTessBeginPolygon( fastuidraw_GLUtesselator *tess, void *data )
 {
   RequireState( tess, T_DORMANT );
 
+  /* nothing of the previous polygon is still alive, so
+   * its blocks are handed out again without a free list.
+   */
+  poolReset( tess->pool );
+
   tess->state = T_IN_POLYGON;
   tess->cacheCount = 0;
   tess->emptyCache = FALSE;
@@ -69,6 +69,8 @@ public:
   GLUhalfEdge   *lastEdge;      /* lastEdge->Org is the most recent vertex */
   GLUmesh       *mesh;          /* stores the input contours, and eventually
                                    the tessellation itself */
+  struct GLUpool *pool;         /* from which the mesh, dictionary and sweep
+                                   objects are allocated; reset for each polygon */
 
   void          (REGALFASTUIDRAW_GLU_CALL *callError)( FASTUIDRAW_GLUenum errnum );
 
@@ -57,6 +57,23 @@ ColorStopSequence(int reserve):
   m_d(FASTUIDRAWnew ColorStopSequencePrivate(reserve))
 {}
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+fastuidraw::ColorStopSequence::
+ColorStopSequence(ColorStopSequence &&obj) noexcept:
+  m_d(obj.m_d)
+{
+  obj.m_d = FASTUIDRAWnew ColorStopSequencePrivate();
+}
+
+fastuidraw::ColorStopSequence&
+fastuidraw::ColorStopSequence::
+operator=(ColorStopSequence &&obj) noexcept
+{
+  swap(obj);
+  return *this;
+}
+#endif
+
 fastuidraw::ColorStopSequence::
 ~ColorStopSequence()
 {
@@ -65,6 +82,13 @@ fastuidraw::ColorStopSequence::
   FASTUIDRAWdelete(d);
 }
 
+void
+fastuidraw::ColorStopSequence::
+swap(ColorStopSequence &obj)
+{
+  std::swap(m_d, obj.m_d);
+}
+
 void
 fastuidraw::ColorStopSequence::
 add(const ColorStop &c)
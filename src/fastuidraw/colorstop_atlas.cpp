@@ -18,9 +18,11 @@
 
 
 #include <vector>
+#include <cstring>
 #include <fastuidraw/colorstop_atlas.hpp>
 #include "private/interval_allocator.hpp"
 #include "private/util_private.hpp"
+#include "private/memory_report_private.hpp"
 
 namespace
 {
@@ -55,6 +57,27 @@ namespace
 
   typedef std::pair<fastuidraw::ivec2, int> delayed_free_entry;
 
+  class shared_interval
+  {
+  public:
+    shared_interval(void):
+      m_location(-1, -1),
+      m_count(0)
+    {}
+
+    bool
+    same_texels(fastuidraw::const_c_array<fastuidraw::u8vec4> data) const
+    {
+      return data.size() == m_texels.size()
+        && std::memcmp(data.c_ptr(), &m_texels[0],
+                       sizeof(fastuidraw::u8vec4) * data.size()) == 0;
+    }
+
+    fastuidraw::ivec2 m_location;
+    unsigned int m_count;
+    std::vector<fastuidraw::u8vec4> m_texels;
+  };
+
   class ColorStopAtlasPrivate
   {
   public:
@@ -87,6 +110,20 @@ namespace
        key.
      */
     std::map<int, std::set<int> > m_available_layers;
+
+    /* intervals with identical texels (for example from
+       ColorStopSequenceOnAtlas objects made from the same
+       color stops and width) share their location on the
+       atlas; m_shared_intervals is keyed by the hash of
+       the texels and gives the location, the number of
+       allocations sharing it and a copy of the texels to
+       compare against, m_hash_of_interval gives the hash
+       for each shared location. An interval whose hash
+       matches a shared interval of different texels is
+       not shared and is not in m_hash_of_interval.
+     */
+    std::map<fastuidraw::texel_hash, shared_interval> m_shared_intervals;
+    std::map<fastuidraw::ivec2, fastuidraw::texel_hash> m_hash_of_interval;
   };
 
   class ColorStopBackingStorePrivate
@@ -110,6 +147,7 @@ namespace
     fastuidraw::ivec2 m_texel_location;
     int m_width;
     int m_start_slack, m_end_slack;
+    std::vector<fastuidraw::ColorStop> m_color_stops;
   };
 }
 
@@ -151,6 +189,8 @@ add_bookkeeping(int new_size)
   for(int y = old_size; y < new_size; ++y)
     {
       m_layer_allocator[y] = FASTUIDRAWnew fastuidraw::interval_allocator(width);
+      m_layer_allocator[y]->report_free_space(fastuidraw::memory::subsystem_colorstop_atlas,
+                                              sizeof(fastuidraw::u8vec4));
       S.insert(y);
     }
 }
@@ -185,13 +225,21 @@ deallocate_implement(fastuidraw::ivec2 location, int width)
 fastuidraw::ColorStopBackingStore::
 ColorStopBackingStore(int w, int num_layers, bool presizable)
 {
-  m_d = FASTUIDRAWnew ColorStopBackingStorePrivate(w, num_layers, presizable);
+  ColorStopBackingStorePrivate *d;
+  d = FASTUIDRAWnew ColorStopBackingStorePrivate(w, num_layers, presizable);
+  m_d = d;
+  detail::memory_report_grow(memory::subsystem_colorstop_atlas, 0,
+                             sizeof(u8vec4) * d->m_width_times_height);
 }
 
 fastuidraw::ColorStopBackingStore::
 ColorStopBackingStore(ivec2 wl, bool presizable)
 {
-  m_d = FASTUIDRAWnew ColorStopBackingStorePrivate(wl.x(), wl.y(), presizable);
+  ColorStopBackingStorePrivate *d;
+  d = FASTUIDRAWnew ColorStopBackingStorePrivate(wl.x(), wl.y(), presizable);
+  m_d = d;
+  detail::memory_report_grow(memory::subsystem_colorstop_atlas, 0,
+                             sizeof(u8vec4) * d->m_width_times_height);
 }
 
 fastuidraw::ColorStopBackingStore::
@@ -199,6 +247,8 @@ fastuidraw::ColorStopBackingStore::
 {
   ColorStopBackingStorePrivate *d;
   d = static_cast<ColorStopBackingStorePrivate*>(m_d);
+  detail::memory_report_shrink(memory::subsystem_colorstop_atlas, 0,
+                               sizeof(u8vec4) * d->m_width_times_height);
   FASTUIDRAWdelete(d);
   m_d = NULL;
 }
@@ -237,10 +287,23 @@ resize(int new_num_layers)
   ColorStopBackingStorePrivate *d;
   d = static_cast<ColorStopBackingStorePrivate*>(m_d);
   assert(d->m_resizeable);
-  assert(new_num_layers > d->m_dimensions.y());
+  assert(new_num_layers > 0);
+  assert(new_num_layers != d->m_dimensions.y());
   resize_implement(new_num_layers);
+
+  int old_width_times_height(d->m_width_times_height);
   d->m_dimensions.y() = new_num_layers;
   d->m_width_times_height = d->m_dimensions.x() * d->m_dimensions.y();
+  if(d->m_width_times_height > old_width_times_height)
+    {
+      detail::memory_report_grow(memory::subsystem_colorstop_atlas, 0,
+                                 sizeof(u8vec4) * (d->m_width_times_height - old_width_times_height));
+    }
+  else
+    {
+      detail::memory_report_shrink(memory::subsystem_colorstop_atlas, 0,
+                                   sizeof(u8vec4) * (old_width_times_height - d->m_width_times_height));
+    }
 }
 
 ///////////////////////////////////////
@@ -310,6 +373,31 @@ deallocate(ivec2 location, int width)
   d = static_cast<ColorStopAtlasPrivate*>(m_d);
 
   autolock_mutex m(d->m_mutex);
+
+  std::map<ivec2, texel_hash>::iterator hash_iter;
+  std::map<texel_hash, shared_interval>::iterator iter;
+
+  hash_iter = d->m_hash_of_interval.find(location);
+  if(hash_iter != d->m_hash_of_interval.end())
+    {
+      iter = d->m_shared_intervals.find(hash_iter->second);
+      assert(iter != d->m_shared_intervals.end());
+      assert(iter->second.m_count > 0);
+
+      --iter->second.m_count;
+      if(iter->second.m_count > 0)
+        {
+          return;
+        }
+
+      /* remove the interval from sharing now, even if its
+         freeing is delayed, so that a later allocation does
+         not share an interval that is about to be freed.
+       */
+      d->m_shared_intervals.erase(iter);
+      d->m_hash_of_interval.erase(hash_iter);
+    }
+
   if(d->m_delayed_interval_freeing_counter == 0)
     {
       d->deallocate_implement(location, width);
@@ -368,12 +456,22 @@ allocate(const_c_array<u8vec4> data)
   autolock_mutex m(d->m_mutex);
 
   std::map<int, std::set<int> >::iterator iter;
+  std::map<texel_hash, shared_interval>::iterator shared_iter;
   ivec2 return_value;
   int width(data.size());
+  texel_hash hash;
 
   assert(width > 0);
   assert(width <= max_width());
 
+  hash = compute_texel_hash(data);
+  shared_iter = d->m_shared_intervals.find(hash);
+  if(shared_iter != d->m_shared_intervals.end() && shared_iter->second.same_texels(data))
+    {
+      ++shared_iter->second.m_count;
+      return shared_iter->second.m_location;
+    }
+
   iter = d->m_available_layers.lower_bound(width);
   if(iter == d->m_available_layers.end())
     {
@@ -419,6 +517,16 @@ allocate(const_c_array<u8vec4> data)
   d->m_backing_store->set_data(return_value.x(), return_value.y(),
                                width, data);
   d->m_allocated += width;
+
+  if(shared_iter == d->m_shared_intervals.end())
+    {
+      shared_interval &entry(d->m_shared_intervals[hash]);
+
+      entry.m_location = return_value;
+      entry.m_count = 1;
+      entry.m_texels.assign(data.begin(), data.end());
+      d->m_hash_of_interval[return_value] = hash;
+    }
   return return_value;
 }
 
@@ -432,6 +540,46 @@ max_width(void) const
   return d->m_backing_store->dimensions().x();
 }
 
+uint64_t
+fastuidraw::ColorStopAtlas::
+trim(void)
+{
+  ColorStopAtlasPrivate *d;
+  d = static_cast<ColorStopAtlasPrivate*>(m_d);
+
+  autolock_mutex m(d->m_mutex);
+  int width(d->m_backing_store->dimensions().x());
+  int old_size(d->m_layer_allocator.size()), new_size(old_size);
+
+  /* the intervals whose freeing is delayed are not yet
+     free in their layer allocator, so their layers are
+     not removed.
+   */
+  if(d->m_backing_store->resizeable())
+    {
+      while(new_size > 1 && d->m_layer_allocator[new_size - 1]->largest_free_interval() == width)
+        {
+          --new_size;
+        }
+    }
+
+  if(new_size < old_size)
+    {
+      for(int y = new_size; y < old_size; ++y)
+        {
+          std::map<int, std::set<int> >::iterator iter;
+
+          iter = d->m_available_layers.find(width);
+          d->remove_entry_from_available_layers(iter, y);
+          FASTUIDRAWdelete(d->m_layer_allocator[y]);
+        }
+      d->m_layer_allocator.resize(new_size);
+      d->m_backing_store->resize(new_size);
+    }
+
+  return uint64_t(d->m_backing_store->width_times_height()) * sizeof(u8vec4);
+}
+
 fastuidraw::reference_counted_ptr<const fastuidraw::ColorStopBackingStore>
 fastuidraw::ColorStopAtlas::
 backing_store(void) const
@@ -456,6 +604,7 @@ ColorStopSequenceOnAtlas(const ColorStopSequence &pcolor_stops,
   d->m_width = pwidth;
 
   const_c_array<ColorStop> color_stops(pcolor_stops.values());
+  d->m_color_stops.assign(color_stops.begin(), color_stops.end());
   assert(d->m_atlas);
   assert(pwidth>0);
 
@@ -587,3 +736,12 @@ atlas(void) const
   d = static_cast<ColorStopSequenceOnAtlasPrivate*>(m_d);
   return d->m_atlas;
 }
+
+fastuidraw::const_c_array<fastuidraw::ColorStop>
+fastuidraw::ColorStopSequenceOnAtlas::
+color_stops(void) const
+{
+  ColorStopSequenceOnAtlasPrivate *d;
+  d = static_cast<ColorStopSequenceOnAtlasPrivate*>(m_d);
+  return make_c_array(d->m_color_stops);
+}
@@ -29,7 +29,7 @@ namespace
   class BackingStore:public fastuidraw::ColorStopBackingStore
   {
   public:
-    BackingStore(int w, int l, bool delayed);
+    BackingStore(int w, int l, bool delayed, bool cpu_mirror);
     ~BackingStore();
 
     virtual
@@ -50,16 +50,27 @@ namespace
       return m_backing_store.texture();
     }
 
+    bool
+    restore_after_context_loss(void)
+    {
+      if(!m_backing_store.has_cpu_mirror())
+        {
+          return false;
+        }
+      m_backing_store.recreate_from_cpu_mirror();
+      return true;
+    }
+
     virtual
     void
     resize_implement(int new_num_layers);
 
     static
     fastuidraw::reference_counted_ptr<fastuidraw::ColorStopBackingStore>
-    create(int w, int l, bool delayed)
+    create(int w, int l, bool delayed, bool cpu_mirror)
     {
       BackingStore *p;
-      p = FASTUIDRAWnew BackingStore(w, l, delayed);
+      p = FASTUIDRAWnew BackingStore(w, l, delayed, cpu_mirror);
       return fastuidraw::reference_counted_ptr<fastuidraw::ColorStopBackingStore>(p);
     }
 
@@ -117,12 +128,14 @@ namespace
     ColorStopAtlasGLParamsPrivate(void):
       m_width(1024),
       m_num_layers(32),
-      m_delayed(false)
+      m_delayed(false),
+      m_cpu_mirror(false)
     {}
 
     int m_width;
     int m_num_layers;
     bool m_delayed;
+    bool m_cpu_mirror;
   };
 
   class ColorStopAtlasGLPrivate
@@ -140,10 +153,14 @@ namespace
 //////////////////////////
 // BackingStore methods
 BackingStore::
-BackingStore(int w, int l, bool delayed):
+BackingStore(int w, int l, bool delayed, bool cpu_mirror):
   fastuidraw::ColorStopBackingStore(w, l, true),
   m_backing_store(dimensions_for_store(w, l), delayed)
 {
+  if(cpu_mirror)
+    {
+      m_backing_store.keep_cpu_mirror();
+    }
 }
 
 BackingStore::
@@ -237,6 +254,7 @@ operator=(const params &rhs)
 paramsSetGet(int, width)
 paramsSetGet(int, num_layers)
 paramsSetGet(bool, delayed)
+paramsSetGet(bool, cpu_mirror)
 
 #undef paramsSetGet
 
@@ -252,7 +270,7 @@ optimal_width(void)
 // fastuidraw::gl::ColorStopAtlasGL methods
 fastuidraw::gl::ColorStopAtlasGL::
 ColorStopAtlasGL(const params &P):
-  fastuidraw::ColorStopAtlas(BackingStore::create(P.width(), P.num_layers(), P.delayed()))
+  fastuidraw::ColorStopAtlas(BackingStore::create(P.width(), P.num_layers(), P.delayed(), P.cpu_mirror()))
 {
   m_d = FASTUIDRAWnew ColorStopAtlasGLPrivate(P);
 }
@@ -286,6 +304,20 @@ texture(void) const
   return p->texture();
 }
 
+bool
+fastuidraw::gl::ColorStopAtlasGL::
+restore_after_context_loss(void)
+{
+  BackingStore *p;
+
+  /* the backing store is only reachable as const from
+     ColorStopAtlas, but it is owned by this atlas
+   */
+  assert(dynamic_cast<const BackingStore*>(backing_store().get()));
+  p = const_cast<BackingStore*>(static_cast<const BackingStore*>(backing_store().get()));
+  return p->restore_after_context_loss();
+}
+
 GLenum
 fastuidraw::gl::ColorStopAtlasGL::
 texture_bind_target(void)
@@ -28,6 +28,7 @@
 #include <vector>
 #include <list>
 #include <algorithm>
+#include <iterator>
 #include <sstream>
 #include <stdint.h>
 #include <sys/time.h>
@@ -38,6 +39,10 @@
 #include <fastuidraw/gl_backend/gl_context_properties.hpp>
 #include <fastuidraw/gl_backend/gl_program.hpp>
 
+#ifndef GL_COMPLETION_STATUS_ARB
+#define GL_COMPLETION_STATUS_ARB 0x91B1
+#endif
+
 namespace
 {
   class ShaderPrivate
@@ -46,9 +51,13 @@ namespace
     ShaderPrivate(const fastuidraw::glsl::ShaderSource &src,
                   GLenum pshader_type);
 
+    void
+    issue_compile(void);
+
     void
     compile(void);
 
+    bool m_compile_issued;
     bool m_shader_ready;
     GLuint m_name;
     GLenum m_shader_type;
@@ -64,10 +73,15 @@ namespace
     BindAttributePrivate(const char *pname, int plocation):
       m_label(pname),
       m_location(plocation)
-    {}
+    {
+      std::ostringstream str;
+      str << "BindAttribute:" << m_label << ":" << m_location;
+      m_binary_cache_key = str.str();
+    }
 
     std::string m_label;
     int m_location;
+    std::string m_binary_cache_key;
   };
 
   class PreLinkActionArrayPrivate
@@ -579,12 +593,16 @@ namespace
     ProgramPrivate(const fastuidraw::const_c_array<ShaderRef> pshaders,
                    const fastuidraw::gl::PreLinkActionArray &action,
                    const fastuidraw::gl::ProgramInitializerArray &initers,
+                   const fastuidraw::reference_counted_ptr<fastuidraw::gl::ProgramBinaryCache> &binary_cache,
                    fastuidraw::gl::Program *p):
       m_shaders(pshaders.begin(), pshaders.end()),
       m_name(0),
+      m_build_started(false),
       m_assembled(false),
       m_initializers(initers),
       m_pre_link_actions(action),
+      m_binary_cache(binary_cache),
+      m_from_binary_cache(false),
       m_p(p)
     {
     }
@@ -593,11 +611,15 @@ namespace
                    fastuidraw::reference_counted_ptr<fastuidraw::gl::Shader> frag_shader,
                    const fastuidraw::gl::PreLinkActionArray &action,
                    const fastuidraw::gl::ProgramInitializerArray &initers,
+                   const fastuidraw::reference_counted_ptr<fastuidraw::gl::ProgramBinaryCache> &binary_cache,
                    fastuidraw::gl::Program *p):
       m_name(0),
+      m_build_started(false),
       m_assembled(false),
       m_initializers(initers),
       m_pre_link_actions(action),
+      m_binary_cache(binary_cache),
+      m_from_binary_cache(false),
       m_p(p)
     {
       m_shaders.push_back(vert_shader);
@@ -608,11 +630,15 @@ namespace
                    const fastuidraw::glsl::ShaderSource &frag_shader,
                    const fastuidraw::gl::PreLinkActionArray &action,
                    const fastuidraw::gl::ProgramInitializerArray &initers,
+                   const fastuidraw::reference_counted_ptr<fastuidraw::gl::ProgramBinaryCache> &binary_cache,
                    fastuidraw::gl::Program *p):
       m_name(0),
+      m_build_started(false),
       m_assembled(false),
       m_initializers(initers),
       m_pre_link_actions(action),
+      m_binary_cache(binary_cache),
+      m_from_binary_cache(false),
       m_p(p)
     {
       m_shaders.push_back(FASTUIDRAWnew fastuidraw::gl::Shader(vert_shader, GL_VERTEX_SHADER));
@@ -622,9 +648,33 @@ namespace
     void
     assemble(fastuidraw::gl::Program *program);
 
+    void
+    start_build(void);
+
+    bool
+    build_ready(void);
+
+    bool
+    assemble_from_binary(const std::string &key);
+
+    void
+    issue_link(void);
+
+    void
+    finish_link(void);
+
+    void
+    store_binary(const std::string &key);
+
+    std::string
+    compute_binary_key(const fastuidraw::gl::ContextProperties &ctx_props);
+
     void
     clear_shaders_and_save_shader_data(void);
 
+    void
+    clear_shaders_and_save_shader_source(void);
+
     void
     generate_log(void);
 
@@ -633,6 +683,10 @@ namespace
     std::map<GLenum, std::vector<int> > m_shader_data_sorted_by_type;
 
     GLuint m_name;
+    bool m_build_started;
+    bool m_parallel_compile_supported;
+    struct timeval m_start_time;
+    std::string m_binary_key;
     bool m_link_success, m_assembled;
     std::string m_link_log;
     std::string m_log;
@@ -645,8 +699,108 @@ namespace
     std::vector<AtomicBufferInfo> m_abo_list;
     fastuidraw::gl::ProgramInitializerArray m_initializers;
     fastuidraw::gl::PreLinkActionArray m_pre_link_actions;
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::ProgramBinaryCache> m_binary_cache;
+    bool m_from_binary_cache;
     fastuidraw::gl::Program *m_p;
   };
+
+  class ProgramBinaryCacheDirectoryPrivate
+  {
+  public:
+    explicit
+    ProgramBinaryCacheDirectoryPrivate(const char *path):
+      m_path(path)
+    {}
+
+    std::string
+    filename(const char *key) const
+    {
+      return m_path + "/" + key + ".glbin";
+    }
+
+    std::string m_path;
+    std::vector<uint8_t> m_data;
+  };
+
+  bool
+  program_binary_supported(const fastuidraw::gl::ContextProperties &ctx_props)
+  {
+    bool return_value;
+
+    if(ctx_props.is_es())
+      {
+        return_value = ctx_props.version() >= fastuidraw::ivec2(3, 0);
+      }
+    else
+      {
+        return_value = ctx_props.version() >= fastuidraw::ivec2(4, 1)
+          || ctx_props.has_extension("GL_ARB_get_program_binary");
+      }
+
+    /* an implementation may support the API but not
+       support any binary formats.
+     */
+    return return_value
+      && fastuidraw::gl::context_get<GLint>(GL_NUM_PROGRAM_BINARY_FORMATS) > 0;
+  }
+
+  /* 64-bit FNV-1a hash */
+  class binary_key_hasher
+  {
+  public:
+    binary_key_hasher(void):
+      m_value(14695981039346656037ull)
+    {}
+
+    void
+    add(const char *str)
+    {
+      /* add the terminator too so that the concatenation
+         of a sequence of strings is unambiguous.
+       */
+      for(; *str; ++str)
+        {
+          add_byte(*str);
+        }
+      add_byte(0);
+    }
+
+    void
+    add(fastuidraw::const_c_array<GLubyte> v)
+    {
+      for(unsigned int i = 0; i < v.size(); ++i)
+        {
+          add_byte(v[i]);
+        }
+    }
+
+    void
+    add(GLenum v)
+    {
+      for(unsigned int i = 0; i < sizeof(GLenum); ++i, v >>= 8u)
+        {
+          add_byte(v & 0xFF);
+        }
+    }
+
+    std::string
+    value(void) const
+    {
+      std::ostringstream str;
+      str << std::hex << std::setfill('0') << std::setw(16) << m_value;
+      return str.str();
+    }
+
+  private:
+    void
+    add_byte(uint8_t b)
+    {
+      m_value ^= b;
+      m_value *= 1099511628211ull;
+    }
+
+    uint64_t m_value;
+  };
 }
 
 /////////////////////////////////////////
@@ -654,6 +808,7 @@ namespace
 ShaderPrivate::
 ShaderPrivate(const fastuidraw::glsl::ShaderSource &src,
               GLenum pshader_type):
+  m_compile_issued(false),
   m_shader_ready(false),
   m_name(0),
   m_shader_type(pshader_type),
@@ -664,9 +819,9 @@ ShaderPrivate(const fastuidraw::glsl::ShaderSource &src,
 
 void
 ShaderPrivate::
-compile(void)
+issue_compile(void)
 {
-  if(m_shader_ready)
+  if(m_compile_issued)
     {
       return;
     }
@@ -674,7 +829,7 @@ compile(void)
   //now do the GL work, create a name and compile the source code:
   assert(m_name == 0);
 
-  m_shader_ready = true;
+  m_compile_issued = true;
   m_name = glCreateShader(m_shader_type);
 
   const char *sourceString[1];
@@ -686,6 +841,23 @@ compile(void)
                  NULL); //lengths of each string or NULL implies each is 0-terminated
 
   glCompileShader(m_name);
+}
+
+void
+ShaderPrivate::
+compile(void)
+{
+  if(m_shader_ready)
+    {
+      return;
+    }
+
+  /* issue the compile (if not yet issued) and then
+     query GL for the results; the queries wait for
+     the GL implementation to finish compiling.
+   */
+  issue_compile();
+  m_shader_ready = true;
 
   GLint logSize(0), shaderOK;
   std::vector<char> raw_log;
@@ -1536,7 +1708,7 @@ name(void)
 {
   ShaderPrivate *d;
   d = static_cast<ShaderPrivate*>(m_d);
-  d->compile();
+  d->issue_compile();
   return d->m_name;
 }
 
@@ -1639,6 +1811,15 @@ action(GLuint glsl_program) const
   glBindAttribLocation(glsl_program, d->m_location, d->m_label.c_str());
 }
 
+const char*
+fastuidraw::gl::BindAttribute::
+binary_cache_key(void) const
+{
+  BindAttributePrivate *d;
+  d = static_cast<BindAttributePrivate*>(m_d);
+  return d->m_binary_cache_key.c_str();
+}
+
 ////////////////////////////////////
 // ProgramSeparable methods
 void
@@ -1648,6 +1829,13 @@ action(GLuint glsl_program) const
   glProgramParameteri(glsl_program, GL_PROGRAM_SEPARABLE, GL_TRUE);
 }
 
+const char*
+fastuidraw::gl::ProgramSeparable::
+binary_cache_key(void) const
+{
+  return "ProgramSeparable";
+}
+
 
 ////////////////////////////////////////////
 // fastuidraw::gl::PreLinkActionArray methods
@@ -1717,6 +1905,17 @@ execute_actions(GLuint pr) const
     }
 }
 
+fastuidraw::const_c_array<fastuidraw::reference_counted_ptr<fastuidraw::gl::PreLinkAction> >
+fastuidraw::gl::PreLinkActionArray::
+actions(void) const
+{
+  PreLinkActionArrayPrivate *d;
+  d = static_cast<PreLinkActionArrayPrivate*>(m_d);
+  return (d->m_values.empty()) ?
+    const_c_array<reference_counted_ptr<PreLinkAction> >() :
+    const_c_array<reference_counted_ptr<PreLinkAction> >(&d->m_values[0], d->m_values.size());
+}
+
 
 ///////////////////////////////////////////////////
 // fastuidraw::gl::Program::shader_variable_info methods
@@ -2040,71 +2239,99 @@ atomic_variable(const char *name,
 //ProgramPrivate methods
 void
 ProgramPrivate::
-assemble(fastuidraw::gl::Program *program)
+start_build(void)
 {
-  if(m_assembled)
+  if(m_build_started)
     {
       return;
     }
 
-  struct timeval start_time, end_time;
-  gettimeofday(&start_time, NULL);
+  fastuidraw::gl::ContextProperties ctx_props;
 
-  std::ostringstream error_ostr;
-
-  m_assembled = true;
+  gettimeofday(&m_start_time, NULL);
+  m_build_started = true;
   assert(m_name == 0);
-  m_name = glCreateProgram();
-  m_link_success = true;
 
-  //attatch the shaders, attaching a bad shader makes
-  //m_link_success become false
-  for(std::vector<fastuidraw::reference_counted_ptr<fastuidraw::gl::Shader> >::iterator iter = m_shaders.begin(),
-        end = m_shaders.end(); iter != end; ++iter)
+  m_parallel_compile_supported = ctx_props.has_extension("GL_KHR_parallel_shader_compile")
+    || ctx_props.has_extension("GL_ARB_parallel_shader_compile");
+
+  if(m_binary_cache && !program_binary_supported(ctx_props))
     {
-      if((*iter)->compile_success())
-        {
-          glAttachShader(m_name, (*iter)->name());
-        }
-      else
+      m_binary_cache = fastuidraw::reference_counted_ptr<fastuidraw::gl::ProgramBinaryCache>();
+    }
+
+  if(m_binary_cache)
+    {
+      m_binary_key = compute_binary_key(ctx_props);
+      if(m_binary_key.empty())
         {
-          m_link_success = false;
+          m_binary_cache = fastuidraw::reference_counted_ptr<fastuidraw::gl::ProgramBinaryCache>();
         }
     }
 
-  //we no longer need the GL shaders.
-  clear_shaders_and_save_shader_data();
+  if(m_binary_cache)
+    {
+      m_from_binary_cache = assemble_from_binary(m_binary_key);
+    }
 
-  //perform any pre-link actions and then clear them
-  m_pre_link_actions.execute_actions(m_name);
-  m_pre_link_actions = fastuidraw::gl::PreLinkActionArray();
+  if(!m_from_binary_cache)
+    {
+      issue_link();
+    }
+}
 
-  //now finally link!
-  glLinkProgram(m_name);
+bool
+ProgramPrivate::
+build_ready(void)
+{
+  if(m_assembled)
+    {
+      return true;
+    }
 
-  gettimeofday(&end_time, NULL);
-  m_assemble_time = float(end_time.tv_sec - start_time.tv_sec)
-    + float(end_time.tv_usec - start_time.tv_usec) / 1e6f;
+  if(!m_build_started)
+    {
+      return false;
+    }
 
-  //retrieve the log fun
-  std::vector<char> raw_log;
-  GLint logSize, linkOK;
+  if(m_from_binary_cache || !m_parallel_compile_supported)
+    {
+      /* without parallel shader compile, there is no way to
+         query GL without blocking.
+       */
+      return true;
+    }
 
-  glGetProgramiv(m_name, GL_LINK_STATUS, &linkOK);
-  glGetProgramiv(m_name, GL_INFO_LOG_LENGTH, &logSize);
+  GLint status(GL_FALSE);
+  glGetProgramiv(m_name, GL_COMPLETION_STATUS_ARB, &status);
+  return status == GL_TRUE;
+}
 
-  raw_log.resize(logSize+2);
-  glGetProgramInfoLog(m_name, logSize+1, NULL , &raw_log[0]);
+void
+ProgramPrivate::
+assemble(fastuidraw::gl::Program *program)
+{
+  if(m_assembled)
+    {
+      return;
+    }
 
-  error_ostr << "\n-----------------------\n" << &raw_log[0];
+  start_build();
+  m_assembled = true;
 
-  m_link_log = error_ostr.str();
-  m_link_success = m_link_success and (linkOK == GL_TRUE);
+  if(!m_from_binary_cache)
+    {
+      finish_link();
+    }
+
+  struct timeval end_time;
+  gettimeofday(&end_time, NULL);
+  m_assemble_time = float(end_time.tv_sec - m_start_time.tv_sec)
+    + float(end_time.tv_usec - m_start_time.tv_usec) / 1e6f;
 
+  fastuidraw::gl::ContextProperties ctx_props;
   if(m_link_success)
     {
-      fastuidraw::gl::ContextProperties ctx_props;
-
       m_uniform_list.populate(m_name, ctx_props);
       m_attribute_list.populate(m_name, ctx_props);
       m_storage_buffer_list.populate(m_name, ctx_props);
@@ -2157,6 +2384,204 @@ assemble(fastuidraw::gl::Program *program)
   m_initializers.clear();
 }
 
+std::string
+ProgramPrivate::
+compute_binary_key(const fastuidraw::gl::ContextProperties &ctx_props)
+{
+  binary_key_hasher hasher;
+
+  /* a program binary is only valid for the exact same
+     driver, so the key includes the identification strings
+     of the GL implementation.
+   */
+  hasher.add(reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+  hasher.add(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+  hasher.add(reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+  /* the version string of some implementations does not
+     change between driver builds, the driver UUID of
+     GL_EXT_memory_object does. The extension is only
+     queried if the GL headers against which we build
+     declare it (the GL core profile header does not).
+   */
+  #ifdef GL_DRIVER_UUID_EXT
+  {
+    if(ctx_props.has_extension("GL_EXT_memory_object"))
+      {
+        fastuidraw::vecN<GLubyte, GL_UUID_SIZE_EXT> uuid(0);
+        glGetUnsignedBytevEXT(GL_DRIVER_UUID_EXT, uuid.c_ptr());
+        hasher.add(fastuidraw::const_c_array<GLubyte>(uuid.c_ptr(), uuid.size()));
+      }
+  }
+  #else
+  {
+    FASTUIDRAWunused(ctx_props);
+  }
+  #endif
+
+  for(std::vector<fastuidraw::reference_counted_ptr<fastuidraw::gl::Shader> >::iterator iter = m_shaders.begin(),
+        end = m_shaders.end(); iter != end; ++iter)
+    {
+      hasher.add((*iter)->shader_type());
+      hasher.add((*iter)->source_code());
+    }
+
+  /* the pre-link actions (for example the attribute
+     bindings) change the program that is linked from
+     the same shaders. If an action cannot be identified,
+     return an empty key to indicate that the program
+     cannot use the binary cache.
+   */
+  fastuidraw::const_c_array<fastuidraw::reference_counted_ptr<fastuidraw::gl::PreLinkAction> > actions;
+  actions = m_pre_link_actions.actions();
+  for(unsigned int i = 0; i < actions.size(); ++i)
+    {
+      const char *action_key;
+
+      if(!actions[i])
+        {
+          continue;
+        }
+
+      action_key = actions[i]->binary_cache_key();
+      if(action_key == NULL)
+        {
+          return std::string();
+        }
+      hasher.add(action_key);
+    }
+  return hasher.value();
+}
+
+bool
+ProgramPrivate::
+assemble_from_binary(const std::string &key)
+{
+  GLenum binary_format;
+  fastuidraw::const_c_array<uint8_t> binary;
+  GLint linkOK;
+
+  if(!m_binary_cache->fetch(key.c_str(), &binary_format, &binary) || binary.empty())
+    {
+      return false;
+    }
+
+  m_name = glCreateProgram();
+  glProgramBinary(m_name, binary_format, binary.c_ptr(), binary.size());
+  glGetProgramiv(m_name, GL_LINK_STATUS, &linkOK);
+
+  if(linkOK != GL_TRUE)
+    {
+      /* the GL implementation rejected the binary (for example
+         a driver update), fall back to compiling the shaders.
+       */
+      glDeleteProgram(m_name);
+      m_name = 0;
+      return false;
+    }
+
+  /* the GL shaders are never compiled and the pre-link
+     actions are already part of the binary.
+   */
+  clear_shaders_and_save_shader_source();
+  m_pre_link_actions = fastuidraw::gl::PreLinkActionArray();
+  m_link_success = true;
+  m_link_log = "\n-----------------------\nProgram from ProgramBinaryCache";
+
+  return true;
+}
+
+void
+ProgramPrivate::
+issue_link(void)
+{
+  m_name = glCreateProgram();
+
+  /* Shader::name() only issues the compile, it does not
+     wait for GL to complete it. If a shader fails to
+     compile, then the link will fail.
+   */
+  for(std::vector<fastuidraw::reference_counted_ptr<fastuidraw::gl::Shader> >::iterator iter = m_shaders.begin(),
+        end = m_shaders.end(); iter != end; ++iter)
+    {
+      glAttachShader(m_name, (*iter)->name());
+    }
+
+  //perform any pre-link actions and then clear them
+  m_pre_link_actions.execute_actions(m_name);
+  m_pre_link_actions = fastuidraw::gl::PreLinkActionArray();
+
+  if(m_binary_cache)
+    {
+      glProgramParameteri(m_name, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+  //now finally link!
+  glLinkProgram(m_name);
+}
+
+void
+ProgramPrivate::
+finish_link(void)
+{
+  std::ostringstream error_ostr;
+
+  m_link_success = true;
+  for(std::vector<fastuidraw::reference_counted_ptr<fastuidraw::gl::Shader> >::iterator iter = m_shaders.begin(),
+        end = m_shaders.end(); iter != end; ++iter)
+    {
+      m_link_success = m_link_success && (*iter)->compile_success();
+    }
+
+  //we no longer need the GL shaders.
+  clear_shaders_and_save_shader_data();
+
+  //retrieve the log fun
+  std::vector<char> raw_log;
+  GLint logSize, linkOK;
+
+  glGetProgramiv(m_name, GL_LINK_STATUS, &linkOK);
+  glGetProgramiv(m_name, GL_INFO_LOG_LENGTH, &logSize);
+
+  raw_log.resize(logSize+2);
+  glGetProgramInfoLog(m_name, logSize+1, NULL , &raw_log[0]);
+
+  error_ostr << "\n-----------------------\n" << &raw_log[0];
+
+  m_link_log = error_ostr.str();
+  m_link_success = m_link_success and (linkOK == GL_TRUE);
+
+  if(m_link_success && m_binary_cache)
+    {
+      store_binary(m_binary_key);
+    }
+}
+
+void
+ProgramPrivate::
+store_binary(const std::string &key)
+{
+  GLint length(0);
+  GLenum binary_format(GL_INVALID_ENUM);
+  std::vector<uint8_t> binary;
+
+  glGetProgramiv(m_name, GL_PROGRAM_BINARY_LENGTH, &length);
+  if(length <= 0)
+    {
+      return;
+    }
+
+  binary.resize(length);
+  glGetProgramBinary(m_name, length, &length, &binary_format, &binary[0]);
+  if(length <= 0)
+    {
+      return;
+    }
+
+  m_binary_cache->store(key.c_str(), binary_format,
+                        fastuidraw::const_c_array<uint8_t>(&binary[0], length));
+}
+
 void
 ProgramPrivate::
 clear_shaders_and_save_shader_data(void)
@@ -2173,6 +2598,25 @@ clear_shaders_and_save_shader_data(void)
   m_shaders.clear();
 }
 
+void
+ProgramPrivate::
+clear_shaders_and_save_shader_source(void)
+{
+  /* same as clear_shaders_and_save_shader_data() except that
+     does not trigger the compiling of the shaders.
+   */
+  m_shader_data.resize(m_shaders.size());
+  for(unsigned int i = 0, endi = m_shaders.size(); i<endi; ++i)
+    {
+      m_shader_data[i].m_source_code = m_shaders[i]->source_code();
+      m_shader_data[i].m_name = 0;
+      m_shader_data[i].m_shader_type = m_shaders[i]->shader_type();
+      m_shader_data[i].m_compile_log = "Not compiled: Program from ProgramBinaryCache";
+      m_shader_data_sorted_by_type[m_shader_data[i].m_shader_type].push_back(i);
+    }
+  m_shaders.clear();
+}
+
 void
 ProgramPrivate::
 generate_log(void)
@@ -2299,27 +2743,30 @@ generate_log(void)
 fastuidraw::gl::Program::
 Program(const_c_array<reference_counted_ptr<Shader> > pshaders,
         const PreLinkActionArray &action,
-        const ProgramInitializerArray &initers)
+        const ProgramInitializerArray &initers,
+        const reference_counted_ptr<ProgramBinaryCache> &binary_cache)
 {
-  m_d = FASTUIDRAWnew ProgramPrivate(pshaders, action, initers, this);
+  m_d = FASTUIDRAWnew ProgramPrivate(pshaders, action, initers, binary_cache, this);
 }
 
 fastuidraw::gl::Program::
 Program(reference_counted_ptr<Shader> vert_shader,
         reference_counted_ptr<Shader> frag_shader,
         const PreLinkActionArray &action,
-        const ProgramInitializerArray &initers)
+        const ProgramInitializerArray &initers,
+        const reference_counted_ptr<ProgramBinaryCache> &binary_cache)
 {
-  m_d = FASTUIDRAWnew ProgramPrivate(vert_shader, frag_shader, action, initers, this);
+  m_d = FASTUIDRAWnew ProgramPrivate(vert_shader, frag_shader, action, initers, binary_cache, this);
 }
 
 fastuidraw::gl::Program::
 Program(const glsl::ShaderSource &vert_shader,
         const glsl::ShaderSource &frag_shader,
         const PreLinkActionArray &action,
-        const ProgramInitializerArray &initers)
+        const ProgramInitializerArray &initers,
+        const reference_counted_ptr<ProgramBinaryCache> &binary_cache)
 {
-  m_d = FASTUIDRAWnew ProgramPrivate(vert_shader, frag_shader, action, initers, this);
+  m_d = FASTUIDRAWnew ProgramPrivate(vert_shader, frag_shader, action, initers, binary_cache, this);
 }
 
 fastuidraw::gl::Program::
@@ -2379,6 +2826,34 @@ program_build_time(void)
   return d->m_assemble_time;
 }
 
+void
+fastuidraw::gl::Program::
+start_build(void)
+{
+  ProgramPrivate *d;
+  d = static_cast<ProgramPrivate*>(m_d);
+  d->start_build();
+}
+
+bool
+fastuidraw::gl::Program::
+build_ready(void)
+{
+  ProgramPrivate *d;
+  d = static_cast<ProgramPrivate*>(m_d);
+  return d->build_ready();
+}
+
+bool
+fastuidraw::gl::Program::
+from_binary_cache(void)
+{
+  ProgramPrivate *d;
+  d = static_cast<ProgramPrivate*>(m_d);
+  d->assemble(this);
+  return d->m_from_binary_cache;
+}
+
 bool
 fastuidraw::gl::Program::
 link_success(void)
@@ -2841,3 +3316,62 @@ perform_initialization(Program *pr, bool program_bound) const
                 << " for initialization\n";
     }
 }
+
+////////////////////////////////////////////
+// fastuidraw::gl::ProgramBinaryCacheDirectory methods
+fastuidraw::gl::ProgramBinaryCacheDirectory::
+ProgramBinaryCacheDirectory(const char *path)
+{
+  m_d = FASTUIDRAWnew ProgramBinaryCacheDirectoryPrivate(path);
+}
+
+fastuidraw::gl::ProgramBinaryCacheDirectory::
+~ProgramBinaryCacheDirectory()
+{
+  ProgramBinaryCacheDirectoryPrivate *d;
+  d = static_cast<ProgramBinaryCacheDirectoryPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+bool
+fastuidraw::gl::ProgramBinaryCacheDirectory::
+fetch(const char *key, GLenum *binary_format,
+      const_c_array<uint8_t> *binary)
+{
+  ProgramBinaryCacheDirectoryPrivate *d;
+  d = static_cast<ProgramBinaryCacheDirectoryPrivate*>(m_d);
+
+  std::ifstream file(d->filename(key).c_str(), std::ios::binary);
+  uint32_t fmt;
+
+  if(!file || !file.read(reinterpret_cast<char*>(&fmt), sizeof(fmt)))
+    {
+      return false;
+    }
+
+  d->m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  if(d->m_data.empty())
+    {
+      return false;
+    }
+
+  *binary_format = fmt;
+  *binary = const_c_array<uint8_t>(&d->m_data[0], d->m_data.size());
+  return true;
+}
+
+void
+fastuidraw::gl::ProgramBinaryCacheDirectory::
+store(const char *key, GLenum binary_format,
+      const_c_array<uint8_t> binary)
+{
+  ProgramBinaryCacheDirectoryPrivate *d;
+  d = static_cast<ProgramBinaryCacheDirectoryPrivate*>(m_d);
+
+  std::ofstream file(d->filename(key).c_str(), std::ios::binary | std::ios::trunc);
+  uint32_t fmt(binary_format);
+
+  file.write(reinterpret_cast<const char*>(&fmt), sizeof(fmt));
+  file.write(reinterpret_cast<const char*>(binary.c_ptr()), binary.size());
+}
@@ -32,7 +32,8 @@ namespace
   class TexelStoreGL:public fastuidraw::GlyphAtlasTexelBackingStoreBase
   {
   public:
-    TexelStoreGL(fastuidraw::ivec3 dims, bool delayed);
+    TexelStoreGL(fastuidraw::ivec3 dims, bool delayed, bool cpu_mirror,
+                 bool sixteen_bit);
 
     ~TexelStoreGL(void);
 
@@ -40,18 +41,29 @@ namespace
     set_data(int x, int y, int l, int w, int h,
              fastuidraw::const_c_array<uint8_t> data);
 
+    void
+    set_data16(int x, int y, int l, int w, int h,
+               fastuidraw::const_c_array<uint16_t> data);
+
     void
     flush(void)
     {
       m_backing_store.flush();
     }
 
+    void
+    copy_data(int src_x, int src_y, int src_l, int w, int h,
+              int dst_x, int dst_y, int dst_l);
+
     GLuint
     texture(bool as_integer) const;
 
+    bool
+    restore_after_context_loss(void);
+
     static
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasTexelBackingStoreBase>
-    create(fastuidraw::ivec3 dims, bool delayed);
+    create(const fastuidraw::gl::GlyphAtlasGL::params &P);
 
   protected:
 
@@ -61,10 +73,17 @@ namespace
 
 
   private:
-    typedef fastuidraw::gl::detail::TextureGL<GL_TEXTURE_2D_ARRAY,
-                                              GL_R8UI, GL_RED_INTEGER,
-                                              GL_UNSIGNED_BYTE,
-                                              GL_NEAREST> TextureGL;
+    void
+    set_bytes(int x, int y, int l, int w, int h,
+              fastuidraw::const_c_array<uint8_t> data);
+
+    /* a 16-bit texel store is GL_RG8UI with the low
+       byte in the red channel and the high byte in
+       the green channel, so that the filtered view
+       (as GL_RG8) still samples 8-bit values from
+       the red channel.
+     */
+    typedef fastuidraw::gl::detail::TextureGLGeneric<GL_TEXTURE_2D_ARRAY> TextureGL;
     TextureGL m_backing_store;
     mutable GLuint m_texture_as_r8;
   };
@@ -85,6 +104,10 @@ namespace
     GLuint
     texture(void) const = 0;
 
+    virtual
+    bool
+    restore_after_context_loss(void) = 0;
+
     static
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasGeometryBackingStoreBase>
     create(const fastuidraw::gl::GlyphAtlasGL::params &P);
@@ -97,7 +120,7 @@ namespace
   {
   public:
     explicit
-    GeometryStoreGL_Buffer(unsigned int number_vecNs, bool delayed, unsigned int N);
+    GeometryStoreGL_Buffer(unsigned int number_vecNs, bool delayed, unsigned int N, bool cpu_mirror);
 
     virtual
     void
@@ -112,6 +135,10 @@ namespace
     GLuint
     texture(void) const;
 
+    virtual
+    bool
+    restore_after_context_loss(void);
+
   protected:
 
     virtual
@@ -130,7 +157,8 @@ namespace
   {
   public:
     explicit
-    GeometryStoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number_vecNs, bool delayed, unsigned int N);
+    GeometryStoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number_vecNs, bool delayed, unsigned int N,
+                            bool cpu_mirror);
 
     virtual
     void
@@ -145,6 +173,10 @@ namespace
     GLuint
     texture(void) const;
 
+    virtual
+    bool
+    restore_after_context_loss(void);
+
   protected:
 
     virtual
@@ -180,7 +212,9 @@ namespace
       m_delayed(false),
       m_alignment(4),
       m_type(fastuidraw::glsl::PainterBackendGLSL::glyph_geometry_tbo),
-      m_log2_dims_geometry_store(-1, -1)
+      m_log2_dims_geometry_store(-1, -1),
+      m_cpu_mirror(false),
+      m_sixteen_bit_texel_store(false)
     {}
 
     fastuidraw::ivec3 m_texel_store_dimensions;
@@ -189,6 +223,8 @@ namespace
     unsigned int m_alignment;
     enum fastuidraw::glsl::PainterBackendGLSL::glyph_geometry_backing_t m_type;
     fastuidraw::ivec2 m_log2_dims_geometry_store;
+    bool m_cpu_mirror;
+    bool m_sixteen_bit_texel_store;
   };
 
   class GlyphAtlasGLPrivate
@@ -208,11 +244,19 @@ namespace
 /////////////////////////////////////////
 // TexelStoreGL methods
 TexelStoreGL::
-TexelStoreGL(fastuidraw::ivec3 dims, bool delayed):
-  fastuidraw::GlyphAtlasTexelBackingStoreBase(dims, true),
-  m_backing_store(dims, delayed),
+TexelStoreGL(fastuidraw::ivec3 dims, bool delayed, bool cpu_mirror,
+             bool sixteen_bit):
+  fastuidraw::GlyphAtlasTexelBackingStoreBase(dims, true, sixteen_bit),
+  m_backing_store(sixteen_bit ? GL_RG8UI : GL_R8UI,
+                  sixteen_bit ? GL_RG_INTEGER : GL_RED_INTEGER,
+                  GL_UNSIGNED_BYTE, GL_NEAREST, dims, delayed),
   m_texture_as_r8(0)
 {
+  if(cpu_mirror)
+    {
+      m_backing_store.keep_cpu_mirror();
+    }
+
   /* clear the right and bottom border
      of the texture
    */
@@ -277,6 +321,42 @@ void
 TexelStoreGL::
 set_data(int x, int y, int l, int w, int h,
          fastuidraw::const_c_array<uint8_t> data)
+{
+  if(!sixteen_bit())
+    {
+      set_bytes(x, y, l, w, h, data);
+    }
+  else
+    {
+      std::vector<uint8_t> bytes(2 * data.size(), 0);
+      for(unsigned int i = 0, endi = data.size(); i < endi; ++i)
+        {
+          bytes[2 * i] = data[i];
+        }
+      set_bytes(x, y, l, w, h, fastuidraw::make_c_array(bytes));
+    }
+}
+
+void
+TexelStoreGL::
+set_data16(int x, int y, int l, int w, int h,
+           fastuidraw::const_c_array<uint16_t> data)
+{
+  assert(sixteen_bit());
+
+  std::vector<uint8_t> bytes(2 * data.size());
+  for(unsigned int i = 0, endi = data.size(); i < endi; ++i)
+    {
+      bytes[2 * i] = data[i] & 0xFF;
+      bytes[2 * i + 1] = data[i] >> 8;
+    }
+  set_bytes(x, y, l, w, h, fastuidraw::make_c_array(bytes));
+}
+
+void
+TexelStoreGL::
+set_bytes(int x, int y, int l, int w, int h,
+          fastuidraw::const_c_array<uint8_t> data)
 {
   TextureGL::EntryLocation V;
 
@@ -289,6 +369,22 @@ set_data(int x, int y, int l, int w, int h,
   m_backing_store.set_data_c_array(V, data);
 }
 
+void
+TexelStoreGL::
+copy_data(int src_x, int src_y, int src_l, int w, int h,
+          int dst_x, int dst_y, int dst_l)
+{
+  TextureGL::EntryLocation V;
+
+  V.m_location.x() = src_x;
+  V.m_location.y() = src_y;
+  V.m_location.z() = src_l;
+  V.m_size.x() = w;
+  V.m_size.y() = h;
+  V.m_size.z() = 1;
+  m_backing_store.copy_data(V, fastuidraw::vecN<int, 3>(dst_x, dst_y, dst_l));
+}
+
 GLuint
 TexelStoreGL::
 texture(bool as_integer) const
@@ -317,7 +413,7 @@ texture(bool as_integer) const
                                               m_texture_as_r8, //texture to become view
                                               GL_TEXTURE_2D_ARRAY, //texture target for m_texture_as_r8
                                               tex_as_r8ui, //source of backing store for m_texture_as_r8
-                                              GL_R8, //internal format for m_texture_as_r8
+                                              sixteen_bit() ? GL_RG8 : GL_R8, //internal format for m_texture_as_r8
                                               0, //mipmap level start
                                               1, //number of mips to take
                                               0, //min layer
@@ -338,19 +434,36 @@ texture(bool as_integer) const
   return m_texture_as_r8;
 }
 
+bool
+TexelStoreGL::
+restore_after_context_loss(void)
+{
+  if(!m_backing_store.has_cpu_mirror())
+    {
+      return false;
+    }
+
+  /* the texture view is recreated on demand by texture() */
+  m_texture_as_r8 = 0;
+  m_backing_store.recreate_from_cpu_mirror();
+  return true;
+}
+
 fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasTexelBackingStoreBase>
 TexelStoreGL::
-create(fastuidraw::ivec3 dims, bool delayed)
+create(const fastuidraw::gl::GlyphAtlasGL::params &P)
 {
   TexelStoreGL *p;
-  p = FASTUIDRAWnew TexelStoreGL(dims, delayed);
+  p = FASTUIDRAWnew TexelStoreGL(P.texel_store_dimensions(), P.delayed(),
+                                 P.cpu_mirror(), P.sixteen_bit_texel_store());
   return fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasTexelBackingStoreBase>(p);
 }
 
 ///////////////////////////////////////////////
 // GeometryStoreGL_Texture methods
 GeometryStoreGL_Texture::
-GeometryStoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number_texels, bool delayed, unsigned int N):
+GeometryStoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number_texels, bool delayed, unsigned int N,
+                        bool cpu_mirror):
   GeometryStoreGL(number_texels, N, GL_TEXTURE_2D_ARRAY, log2_wh),
   m_layer_dims(1 << log2_wh.x(), 1 << log2_wh.y()),
   m_texels_per_layer(m_layer_dims.x() * m_layer_dims.y()),
@@ -358,6 +471,10 @@ GeometryStoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number_texels, b
                   texture_size(m_layer_dims, number_texels), delayed)
 {
   assert(N <= 4 && N > 0);
+  if(cpu_mirror)
+    {
+      m_backing_store.keep_cpu_mirror();
+    }
 }
 
 fastuidraw::ivec3
@@ -426,6 +543,18 @@ texture(void) const
   return m_backing_store.texture();
 }
 
+bool
+GeometryStoreGL_Texture::
+restore_after_context_loss(void)
+{
+  if(!m_backing_store.has_cpu_mirror())
+    {
+      return false;
+    }
+  m_backing_store.recreate_from_cpu_mirror();
+  return true;
+}
+
 void
 GeometryStoreGL_Texture::
 set_values(unsigned int location,
@@ -483,7 +612,7 @@ set_values(unsigned int location,
 ///////////////////////////////////////////////
 // GeometryStoreGL_Buffer methods
 GeometryStoreGL_Buffer::
-GeometryStoreGL_Buffer(unsigned int number_vecNs, bool delayed, unsigned int N):
+GeometryStoreGL_Buffer(unsigned int number_vecNs, bool delayed, unsigned int N, bool cpu_mirror):
   GeometryStoreGL(number_vecNs, N, GL_TEXTURE_BUFFER,
                   fastuidraw::ivec2(-1, -1)),
   m_backing_store(number_vecNs * N * sizeof(float), delayed),
@@ -491,6 +620,26 @@ GeometryStoreGL_Buffer(unsigned int number_vecNs, bool delayed, unsigned int N):
   m_tbo_dirty(true)
 {
   assert(N <= 4 && N > 0);
+  if(cpu_mirror)
+    {
+      m_backing_store.keep_cpu_mirror();
+    }
+}
+
+bool
+GeometryStoreGL_Buffer::
+restore_after_context_loss(void)
+{
+  if(!m_backing_store.has_cpu_mirror())
+    {
+      return false;
+    }
+
+  /* the texture buffer object is recreated on demand by texture() */
+  m_texture = 0;
+  m_tbo_dirty = true;
+  m_backing_store.recreate_from_cpu_mirror();
+  return true;
 }
 
 void
@@ -573,12 +722,12 @@ create(const fastuidraw::gl::GlyphAtlasGL::params &P)
   switch(P.glyph_geometry_backing_store_type())
     {
     case fastuidraw::glsl::PainterBackendGLSL::glyph_geometry_tbo:
-      p = FASTUIDRAWnew GeometryStoreGL_Buffer(number_vecNs, delayed, N);
+      p = FASTUIDRAWnew GeometryStoreGL_Buffer(number_vecNs, delayed, N, P.cpu_mirror());
       break;
 
     case fastuidraw::glsl::PainterBackendGLSL::glyph_geometry_texture_array:
       p = FASTUIDRAWnew GeometryStoreGL_Texture(P.texture_2d_array_geometry_store_log2_dims(),
-                                                number_vecNs, delayed, N);
+                                                number_vecNs, delayed, N, P.cpu_mirror());
       break;
 
     default:
@@ -740,6 +889,8 @@ paramsSetGet(fastuidraw::ivec3, texel_store_dimensions)
 paramsSetGet(unsigned int, number_floats)
 paramsSetGet(bool, delayed)
 paramsSetGet(unsigned int, alignment)
+paramsSetGet(bool, cpu_mirror)
+paramsSetGet(bool, sixteen_bit_texel_store)
 
 
 #undef paramsSetGet
@@ -748,7 +899,7 @@ paramsSetGet(unsigned int, alignment)
 // fastuidraw::gl::GlyphAtlasGL methods
 fastuidraw::gl::GlyphAtlasGL::
 GlyphAtlasGL(const params &P):
-  GlyphAtlas(TexelStoreGL::create(P.texel_store_dimensions(), P.delayed()),
+  GlyphAtlas(TexelStoreGL::create(P),
              GeometryStoreGL::create(P))
 {
   m_d = FASTUIDRAWnew GlyphAtlasGLPrivate(P);
@@ -813,3 +964,20 @@ geometry_texture_as_2d_array_log2_dims(void) const
   p = static_cast<const GeometryStoreGL*>(geometry_store().get());
   return p->m_log2_dims;
 }
+
+bool
+fastuidraw::gl::GlyphAtlasGL::
+restore_after_context_loss(void)
+{
+  TexelStoreGL *t;
+  GeometryStoreGL *g;
+
+  /* the backing stores are only reachable as const from
+     GlyphAtlas, but they are owned by this atlas
+   */
+  assert(dynamic_cast<const TexelStoreGL*>(texel_store().get()));
+  assert(dynamic_cast<const GeometryStoreGL*>(geometry_store().get()));
+  t = const_cast<TexelStoreGL*>(static_cast<const TexelStoreGL*>(texel_store().get()));
+  g = const_cast<GeometryStoreGL*>(static_cast<const GeometryStoreGL*>(geometry_store().get()));
+  return t->restore_after_context_loss() && g->restore_after_context_loss();
+}
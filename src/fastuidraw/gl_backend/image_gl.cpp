@@ -20,10 +20,15 @@
 #include <vector>
 #include <fastuidraw/gl_backend/ngl_header.hpp>
 #include <fastuidraw/gl_backend/gl_get.hpp>
+#include <fastuidraw/gl_backend/gl_context_properties.hpp>
 #include <fastuidraw/gl_backend/image_gl.hpp>
 #include "private/texture_gl.hpp"
+#include "private/etc2_compress.hpp"
 #include "../private/util_private.hpp"
 
+#ifndef GL_TEXTURE_EXTERNAL_OES
+#define GL_TEXTURE_EXTERNAL_OES 0x8D65
+#endif
 
 
 namespace
@@ -42,7 +47,8 @@ namespace
   class ColorBackingStoreGL:public fastuidraw::AtlasColorBackingStoreBase
   {
   public:
-    ColorBackingStoreGL(int log2_tile_size, int log2_num_tiles_per_row_per_col, int number_layers, bool delayed);
+    ColorBackingStoreGL(int log2_tile_size, int log2_num_tiles_per_row_per_col, int number_layers,
+                        bool delayed, bool compressed, bool cpu_mirror);
     ~ColorBackingStoreGL() {}
 
     virtual
@@ -64,16 +70,29 @@ namespace
       return m_backing_store.texture();
     }
 
+    bool
+    restore_after_context_loss(void)
+    {
+      if(!m_backing_store.has_cpu_mirror())
+        {
+          return false;
+        }
+      m_backing_store.recreate_from_cpu_mirror();
+      return true;
+    }
+
     static
     fastuidraw::ivec3
     store_size(int log2_tile_size, int log2_num_tiles_per_row_per_col, int num_layers);
 
     static
     fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase>
-    create(int log2_tile_size, int log2_num_tiles_per_row_per_col, int num_layers, bool delayed)
+    create(int log2_tile_size, int log2_num_tiles_per_row_per_col, int num_layers,
+           bool delayed, bool compressed, bool cpu_mirror)
     {
       ColorBackingStoreGL *p;
-      p = FASTUIDRAWnew ColorBackingStoreGL(log2_tile_size, log2_num_tiles_per_row_per_col, num_layers, delayed);
+      p = FASTUIDRAWnew ColorBackingStoreGL(log2_tile_size, log2_num_tiles_per_row_per_col, num_layers,
+                                           delayed, compressed, cpu_mirror);
       return fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase>(p);
     }
 
@@ -88,8 +107,14 @@ namespace
     }
 
   private:
-    typedef Texture<GL_RGBA8, GL_RGBA, GL_NEAREST>::type TextureGL;
+    /* the internal format is GL_RGBA8 or, if compressed,
+       GL_COMPRESSED_RGBA8_ETC2_EAC in which case the texels
+       are compressed by set_data() before they are uploaded.
+     */
+    typedef fastuidraw::gl::detail::TextureGLGeneric<GL_TEXTURE_2D_ARRAY> TextureGL;
+    bool m_compressed;
     TextureGL m_backing_store;
+    std::vector<uint8_t> m_compressed_data;
   };
 
 
@@ -99,7 +124,7 @@ namespace
     IndexBackingStoreGL(int log2_tile_size,
                         int log2_num_index_tiles_per_row_per_col,
                         int num_layers,
-                        bool delayed);
+                        bool delayed, bool cpu_mirror);
 
     ~IndexBackingStoreGL()
     {}
@@ -132,6 +157,17 @@ namespace
       return m_backing_store.texture();
     }
 
+    bool
+    restore_after_context_loss(void)
+    {
+      if(!m_backing_store.has_cpu_mirror())
+        {
+          return false;
+        }
+      m_backing_store.recreate_from_cpu_mirror();
+      return true;
+    }
+
     static
     fastuidraw::ivec3
     store_size(int log2_tile_size,
@@ -142,12 +178,12 @@ namespace
     fastuidraw::reference_counted_ptr<fastuidraw::AtlasIndexBackingStoreBase>
     create(int log2_tile_size,
            int log2_num_index_tiles_per_row_per_col,
-           int num_layers, bool delayed)
+           int num_layers, bool delayed, bool cpu_mirror)
     {
       IndexBackingStoreGL *p;
       p = FASTUIDRAWnew IndexBackingStoreGL(log2_tile_size,
                                            log2_num_index_tiles_per_row_per_col,
-                                           num_layers, delayed);
+                                           num_layers, delayed, cpu_mirror);
       return fastuidraw::reference_counted_ptr<fastuidraw::AtlasIndexBackingStoreBase>(p);
     }
 
@@ -185,7 +221,10 @@ namespace
       m_log2_index_tile_size(2),
       m_log2_num_index_tiles_per_row_per_col(6),
       m_num_index_layers(4),
-      m_delayed(false)
+      m_delayed(false),
+      m_compressed_color_tiles(false),
+      m_direct_index_lookup(false),
+      m_cpu_mirror(false)
     {}
 
     int m_log2_color_tile_size;
@@ -195,6 +234,9 @@ namespace
     int m_log2_num_index_tiles_per_row_per_col;
     int m_num_index_layers;
     bool m_delayed;
+    bool m_compressed_color_tiles;
+    bool m_direct_index_lookup;
+    bool m_cpu_mirror;
   };
 
   class ImageAtlasGLPrivate
@@ -207,6 +249,52 @@ namespace
     fastuidraw::gl::ImageAtlasGL::params m_params;
   };
 
+  /* a compressed color tile is made of whole blocks */
+  int
+  effective_log2_color_tile_size(const fastuidraw::gl::ImageAtlasGL::params &P)
+  {
+    return P.compressed_color_tiles() ?
+      std::max(2, P.log2_color_tile_size()) :
+      P.log2_color_tile_size();
+  }
+
+  class ExternalTextureGLPrivate
+  {
+  public:
+    ExternalTextureGLPrivate(GLuint texture, GLenum target, bool owns_texture,
+                             const fastuidraw::reference_counted_ptr<fastuidraw::Image> &image):
+      m_texture(texture),
+      m_target(target),
+      m_owns_texture(owns_texture),
+      m_image(image)
+    {}
+
+    GLuint m_texture;
+    GLenum m_target;
+    bool m_owns_texture;
+    fastuidraw::reference_counted_ptr<fastuidraw::Image> m_image;
+  };
+
+  #ifndef FASTUIDRAW_GL_USE_GLES
+
+  /* returns the bindless handle of a texture made
+     resident, or 0 if the handle could not be made
+   */
+  GLuint64
+  make_resident_texture_handle(GLuint texture)
+  {
+    GLuint64 handle;
+
+    handle = glGetTextureHandleARB(texture);
+    if(handle != 0 && !glIsTextureHandleResidentARB(handle))
+      {
+        glMakeTextureHandleResidentARB(handle);
+      }
+    return handle;
+  }
+
+  #endif
+
 } //namespace
 
 
@@ -218,11 +306,22 @@ ColorBackingStoreGL::
 ColorBackingStoreGL(int log2_tile_size,
                     int log2_num_tiles_per_row_per_col,
                     int number_layers,
-                    bool delayed):
+                    bool delayed, bool compressed, bool cpu_mirror):
   fastuidraw::AtlasColorBackingStoreBase(store_size(log2_tile_size, log2_num_tiles_per_row_per_col, number_layers),
                                          true),
-  m_backing_store(dimensions(), delayed)
-{}
+  m_compressed(compressed),
+  m_backing_store(compressed ? GL_COMPRESSED_RGBA8_ETC2_EAC : GL_RGBA8,
+                  GL_RGBA, GL_UNSIGNED_BYTE, GL_NEAREST,
+                  dimensions(), delayed)
+{
+  /* when compressed, the mirror holds the compressed
+     blocks, i.e. a quarter of the size of the texels
+   */
+  if(cpu_mirror)
+    {
+      m_backing_store.keep_cpu_mirror();
+    }
+}
 
 void
 ColorBackingStoreGL::
@@ -239,7 +338,19 @@ set_data(int x, int y, int l,
   V.m_size.x() = w;
   V.m_size.y() = h;
   V.m_size.z() = 1;
-  data = pdata.reinterpret_pointer<uint8_t>();
+  if(m_compressed)
+    {
+      /* the color tiles are aligned to the blocks
+         because the tile size is atleast the block
+         size and both are powers of 2.
+       */
+      fastuidraw::gl::detail::compress_etc2_eac_rgba8(pdata, w, h, m_compressed_data);
+      data = fastuidraw::make_c_array(m_compressed_data);
+    }
+  else
+    {
+      data = pdata.reinterpret_pointer<uint8_t>();
+    }
   m_backing_store.set_data_c_array(V, data);
 }
 
@@ -261,11 +372,16 @@ IndexBackingStoreGL::
 IndexBackingStoreGL(int log2_tile_size,
                     int log2_num_index_tiles_per_row_per_col,
                     int num_layers,
-                    bool delayed):
+                    bool delayed, bool cpu_mirror):
   fastuidraw::AtlasIndexBackingStoreBase(store_size(log2_tile_size, log2_num_index_tiles_per_row_per_col, num_layers),
                                         true),
   m_backing_store(dimensions(), delayed)
-{}
+{
+  if(cpu_mirror)
+    {
+      m_backing_store.keep_cpu_mirror();
+    }
+}
 
 void
 IndexBackingStoreGL::
@@ -403,6 +519,9 @@ paramsSetGet(int, log2_index_tile_size)
 paramsSetGet(int, log2_num_index_tiles_per_row_per_col)
 paramsSetGet(int, num_index_layers)
 paramsSetGet(bool, delayed)
+paramsSetGet(bool, compressed_color_tiles)
+paramsSetGet(bool, direct_index_lookup)
+paramsSetGet(bool, cpu_mirror)
 
 #undef paramsSetGet
 
@@ -412,15 +531,19 @@ paramsSetGet(bool, delayed)
 // fastuidraw::gl::ImageAtlasGL methods
 fastuidraw::gl::ImageAtlasGL::
 ImageAtlasGL(const params &P):
-  fastuidraw::ImageAtlas(1 << P.log2_color_tile_size(), //color tile size
+  fastuidraw::ImageAtlas(1 << effective_log2_color_tile_size(P), //color tile size
                         1 << P.log2_index_tile_size(), //index tile size
-                        ColorBackingStoreGL::create(P.log2_color_tile_size(), P.log2_num_color_tiles_per_row_per_col(),
-                                                    P.num_color_layers(), P.delayed()),
+                        ColorBackingStoreGL::create(effective_log2_color_tile_size(P),
+                                                    P.log2_num_color_tiles_per_row_per_col(),
+                                                    P.num_color_layers(), P.delayed(),
+                                                    P.compressed_color_tiles(), P.cpu_mirror()),
                         IndexBackingStoreGL::create(P.log2_index_tile_size(),
                                                     P.log2_num_index_tiles_per_row_per_col(),
-                                                    P.num_index_layers(), P.delayed()))
+                                                    P.num_index_layers(), P.delayed(),
+                                                    P.cpu_mirror()))
 {
   m_d = FASTUIDRAWnew ImageAtlasGLPrivate(P);
+  direct_index_lookup(P.direct_index_lookup());
 }
 
 fastuidraw::gl::ImageAtlasGL::
@@ -463,6 +586,23 @@ index_texture(void) const
   return p->texture();
 }
 
+bool
+fastuidraw::gl::ImageAtlasGL::
+restore_after_context_loss(void)
+{
+  ColorBackingStoreGL *c;
+  IndexBackingStoreGL *i;
+
+  /* the backing stores are only reachable as const from
+     ImageAtlas, but they are owned by this atlas
+   */
+  assert(dynamic_cast<const ColorBackingStoreGL*>(color_store().get()));
+  assert(dynamic_cast<const IndexBackingStoreGL*>(index_store().get()));
+  c = const_cast<ColorBackingStoreGL*>(static_cast<const ColorBackingStoreGL*>(color_store().get()));
+  i = const_cast<IndexBackingStoreGL*>(static_cast<const IndexBackingStoreGL*>(index_store().get()));
+  return c->restore_after_context_loss() && i->restore_after_context_loss();
+}
+
 fastuidraw::vecN<fastuidraw::vec2, 2>
 fastuidraw::gl::ImageAtlasGL::
 shader_coords(reference_counted_ptr<Image> image)
@@ -471,9 +611,211 @@ shader_coords(reference_counted_ptr<Image> image)
 
   assert(image->number_index_lookups() > 0);
 
+  /* the mipmap levels past the first are stored to the right of
+     the image, only the coordinates of the image itself are wanted
+   */
   vec2 wh(image->master_index_tile_dims());
+  wh *= vec2(image->dimensions()) / vec2(image->stored_dimensions());
   float f(image->atlas()->index_tile_size());
   vec2 fmaster_index_tile(master_index_tile);
   vec2 c0(f * fmaster_index_tile);
   return vecN<vec2, 2>(c0, c0 + wh);
 }
+
+fastuidraw::reference_counted_ptr<fastuidraw::Image>
+fastuidraw::gl::
+create_bindless_image(GLuint texture, int w, int h,
+                      bool premultiplied_alpha)
+{
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      FASTUIDRAWunused(texture);
+      FASTUIDRAWunused(w);
+      FASTUIDRAWunused(h);
+      FASTUIDRAWunused(premultiplied_alpha);
+      return reference_counted_ptr<Image>();
+    }
+  #else
+    {
+      ContextProperties ctx;
+      GLuint64 handle;
+
+      if(!ctx.has_extension("GL_ARB_bindless_texture") || w <= 0 || h <= 0)
+        {
+          return reference_counted_ptr<Image>();
+        }
+
+      handle = make_resident_texture_handle(texture);
+      if(handle == 0)
+        {
+          return reference_counted_ptr<Image>();
+        }
+      return Image::create_bindless(w, h, handle, false, premultiplied_alpha);
+    }
+  #endif
+}
+
+///////////////////////////////////////////////
+// fastuidraw::gl::ExternalTextureGL methods
+fastuidraw::gl::ExternalTextureGL::
+ExternalTextureGL(GLuint texture, GLenum target, bool owns_texture,
+                  const reference_counted_ptr<Image> &image)
+{
+  m_d = FASTUIDRAWnew ExternalTextureGLPrivate(texture, target, owns_texture, image);
+}
+
+fastuidraw::gl::ExternalTextureGL::
+~ExternalTextureGL()
+{
+  ExternalTextureGLPrivate *d;
+  d = static_cast<ExternalTextureGLPrivate*>(m_d);
+
+  #ifndef FASTUIDRAW_GL_USE_GLES
+    {
+      GLuint64 handle(d->m_image->bindless_handle());
+      if(glIsTextureHandleResidentARB(handle))
+        {
+          glMakeTextureHandleNonResidentARB(handle);
+        }
+    }
+  #endif
+
+  if(d->m_owns_texture)
+    {
+      glDeleteTextures(1, &d->m_texture);
+    }
+
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::gl::ExternalTextureGL>
+fastuidraw::gl::ExternalTextureGL::
+create(GLuint texture, GLenum target, int w, int h)
+{
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      FASTUIDRAWunused(texture);
+      FASTUIDRAWunused(target);
+      FASTUIDRAWunused(w);
+      FASTUIDRAWunused(h);
+      return reference_counted_ptr<ExternalTextureGL>();
+    }
+  #else
+    {
+      ContextProperties ctx;
+      GLuint64 handle;
+      reference_counted_ptr<Image> image;
+
+      if(!ctx.has_extension("GL_ARB_bindless_texture") || w <= 0 || h <= 0
+         || (target != GL_TEXTURE_2D && target != GL_TEXTURE_EXTERNAL_OES))
+        {
+          return reference_counted_ptr<ExternalTextureGL>();
+        }
+
+      handle = make_resident_texture_handle(texture);
+      if(handle == 0)
+        {
+          return reference_counted_ptr<ExternalTextureGL>();
+        }
+
+      image = Image::create_bindless(w, h, handle, target == GL_TEXTURE_EXTERNAL_OES);
+      return FASTUIDRAWnew ExternalTextureGL(texture, target, false, image);
+    }
+  #endif
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::gl::ExternalTextureGL>
+fastuidraw::gl::ExternalTextureGL::
+create_from_egl_image(void *egl_image, bool external, int w, int h)
+{
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      FASTUIDRAWunused(egl_image);
+      FASTUIDRAWunused(external);
+      FASTUIDRAWunused(w);
+      FASTUIDRAWunused(h);
+      return reference_counted_ptr<ExternalTextureGL>();
+    }
+  #else
+    {
+      ContextProperties ctx;
+      GLenum target;
+      GLuint texture(0);
+      GLuint64 handle;
+      reference_counted_ptr<Image> image;
+
+      if(!ctx.has_extension("GL_ARB_bindless_texture")
+         || !ctx.has_extension("GL_EXT_EGL_image_storage")
+         || egl_image == NULL || w <= 0 || h <= 0)
+        {
+          return reference_counted_ptr<ExternalTextureGL>();
+        }
+
+      target = (external) ? GL_TEXTURE_EXTERNAL_OES : GL_TEXTURE_2D;
+      glGenTextures(1, &texture);
+      glBindTexture(target, texture);
+      glEGLImageTargetTexStorageEXT(target, egl_image, NULL);
+      glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      glBindTexture(target, 0);
+
+      handle = make_resident_texture_handle(texture);
+      if(handle == 0)
+        {
+          glDeleteTextures(1, &texture);
+          return reference_counted_ptr<ExternalTextureGL>();
+        }
+
+      image = Image::create_bindless(w, h, handle, external);
+      return FASTUIDRAWnew ExternalTextureGL(texture, target, true, image);
+    }
+  #endif
+}
+
+const fastuidraw::reference_counted_ptr<fastuidraw::Image>&
+fastuidraw::gl::ExternalTextureGL::
+image(void) const
+{
+  ExternalTextureGLPrivate *d;
+  d = static_cast<ExternalTextureGLPrivate*>(m_d);
+  return d->m_image;
+}
+
+GLuint
+fastuidraw::gl::ExternalTextureGL::
+texture(void) const
+{
+  ExternalTextureGLPrivate *d;
+  d = static_cast<ExternalTextureGLPrivate*>(m_d);
+  return d->m_texture;
+}
+
+GLenum
+fastuidraw::gl::ExternalTextureGL::
+target(void) const
+{
+  ExternalTextureGLPrivate *d;
+  d = static_cast<ExternalTextureGLPrivate*>(m_d);
+  return d->m_target;
+}
+
+void
+fastuidraw::gl::ExternalTextureGL::
+acquire(GLsync fence)
+{
+  if(fence != NULL)
+    {
+      glWaitSync(fence, 0, GL_TIMEOUT_IGNORED);
+      glDeleteSync(fence);
+    }
+}
+
+GLsync
+fastuidraw::gl::ExternalTextureGL::
+release(void)
+{
+  return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
@@ -391,9 +391,23 @@ output_to_header(ostream &headerFile)
 
   headerFile << ")\n"
              << "#else\n" << "#define " << function_name() << "(" << argument_list_names_only()
-             << ") "
-             << sm_namespace << "::" << function_pointer_name() <<  "(" << argument_list_names_only()
-             << ")\n#endif\n\n";
+             << ") ";
+
+  /* release builds have none of the debug hooks; when the
+     function is linked directly, call it directly instead of
+     through the function pointer so that the call is the same
+     as a call made without the binding. A function that is
+     loaded at run time must go through its function pointer.
+   */
+  if(m_use_function_pointer)
+    {
+      headerFile << sm_namespace << "::" << function_pointer_name();
+    }
+  else
+    {
+      headerFile << "::" << m_functionName;
+    }
+  headerFile <<  "(" << argument_list_names_only() << ")\n#endif\n\n";
 
 
 
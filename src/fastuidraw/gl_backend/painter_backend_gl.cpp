@@ -19,6 +19,7 @@
 
 #include <list>
 #include <map>
+#include <algorithm>
 #include <sstream>
 #include <vector>
 #include <iostream>
@@ -32,12 +33,31 @@
 #include <fastuidraw/gl_backend/gluniform.hpp>
 
 #include "private/tex_buffer.hpp"
+#include "private/data_store_calibration.hpp"
+#include "private/upload_stats.hpp"
+#include "private/layer_blur.hpp"
+#include "../private/interval_allocator.hpp"
+#include "../private/util_private.hpp"
+#include "../private/memory_report_private.hpp"
+#include "../private/small_vector.hpp"
 
 #ifdef FASTUIDRAW_GL_USE_GLES
 #define GL_SRC1_COLOR GL_SRC1_COLOR_EXT
 #define GL_SRC1_ALPHA GL_SRC1_ALPHA_EXT
 #define GL_ONE_MINUS_SRC1_COLOR GL_ONE_MINUS_SRC1_COLOR_EXT
 #define GL_ONE_MINUS_SRC1_ALPHA GL_ONE_MINUS_SRC1_ALPHA_EXT
+#define GL_MAP_PERSISTENT_BIT GL_MAP_PERSISTENT_BIT_EXT
+#define GL_MAP_COHERENT_BIT GL_MAP_COHERENT_BIT_EXT
+#define glBufferStorage glBufferStorageEXT
+#define glDrawElementsInstancedBaseVertexBaseInstance glDrawElementsInstancedBaseVertexBaseInstanceEXT
+#define glMultiDrawElementsIndirect glMultiDrawElementsIndirectEXT
+#define glPushDebugGroup glPushDebugGroupKHR
+#define glPopDebugGroup glPopDebugGroupKHR
+#define glObjectLabel glObjectLabelKHR
+#define GL_DEBUG_SOURCE_APPLICATION GL_DEBUG_SOURCE_APPLICATION_KHR
+#define GL_BUFFER GL_BUFFER_KHR
+#define GL_PROGRAM GL_PROGRAM_KHR
+#define GL_VERTEX_ARRAY GL_VERTEX_ARRAY_KHR
 #endif
 
 namespace
@@ -45,7 +65,37 @@ namespace
   enum
     {
       shader_group_discard_bit = 31u,
-      shader_group_discard_mask = (1u << 31u)
+      shader_group_discard_mask = (1u << 31u),
+
+      /* shaders registered after the programs are built
+         when async_program_rebuild() is true have this bit
+         up in their group and their ID in the low bits.
+       */
+      shader_group_async_bit = 30u,
+      shader_group_async_mask = (1u << 30u),
+      shader_group_async_id_mask = (1u << 30u) - 1u
+    };
+
+  enum
+    {
+      /* number of on_pre_draw() calls during which the indices
+         drawn by each item shader are counted to choose the
+         item shaders of ConfigurationGL::specialized_programs()
+       */
+      specialization_sample_draws = 16,
+
+      /* an item shader is given a specialized program only if it
+         drew at least 1 / specialization_min_share_recip of the
+         indices; for less used shaders the cost of changing
+         programs is more than the gain over the uber-shader.
+       */
+      specialization_min_share_recip = 10,
+
+      /* bit up in a program choice (see PainterBackendGLPrivate::
+         program_choice()) for the programs of
+         ConfigurationGL::solid_brush_programs()
+       */
+      choice_solid_brush_bit = 1u << 16u
     };
 
   class painter_vao
@@ -53,85 +103,367 @@ namespace
   public:
     painter_vao(void):
       m_vao(0),
+      m_static_vaos(0),
+      m_instanced_vao(0),
+      m_indirect_bo(0),
       m_attribute_bo(0),
       m_header_bo(0),
       m_index_bo(0),
       m_data_bo(0),
-      m_data_tbo(0)
+      m_data_tbo(0),
+      m_attribute_ptr(NULL),
+      m_header_ptr(NULL),
+      m_index_ptr(NULL),
+      m_data_ptr(NULL),
+      m_number_attributes(0),
+      m_number_indices(0),
+      m_number_data_blocks(0)
     {}
 
     GLuint m_vao;
+
+    /* VAOs sourcing attributes and indices from the buffers of
+       static_attribute_heap and the header attribute from
+       m_header_bo with divisor 1, so that the header location
+       is selected by the base instance of the draw; element L
+       reads the attributes with the stride of the layout L,
+       with the fields the layout does not store disabled.
+       The values are 0 if static attribute data is not
+       supported.
+     */
+    fastuidraw::vecN<GLuint, fastuidraw::PainterAttribute::number_layouts> m_static_vaos;
+
+    /* VAO sourcing the attributes and the header attribute
+       from m_attribute_bo and m_header_bo with divisor 1 and
+       the indices of a single quad, so that each instance of
+       a draw is a glyph instance selected by the base instance
+       of the draw; 0 if glyph_instancing() is false.
+     */
+    GLuint m_instanced_vao;
+
+    /* buffer for GL_DRAW_INDIRECT_BUFFER holding the draw
+       ranges of the DrawCommand that uses this painter_vao;
+       0 if use_indirect_draw() is false.
+     */
+    GLuint m_indirect_bo;
     GLuint m_attribute_bo, m_header_bo, m_index_bo, m_data_bo;
     GLuint m_data_tbo;
+
+    /* only non-NULL if the buffers are persistently mapped,
+       in which case the buffers stay mapped for the lifetime
+       of the painter_vao_pool.
+     */
+    void *m_attribute_ptr, *m_header_ptr, *m_index_ptr, *m_data_ptr;
+
     enum fastuidraw::gl::PainterBackendGL::data_store_backing_t m_data_store_backing;
     unsigned int m_data_store_binding_point;
+
+    /* the sizes of the buffers, which differ between the
+       painter_vao's of a painter_vao_pool whose buffer
+       sizes adapt, see painter_vao_pool::request_vao()
+     */
+    unsigned int m_number_attributes, m_number_indices;
+    unsigned int m_number_data_blocks;
+  };
+
+  /* layout of a draw command sourced from GL_DRAW_INDIRECT_BUFFER
+     by glMultiDrawElementsIndirect
+   */
+  class draw_elements_indirect_command
+  {
+  public:
+    GLuint m_count;
+    GLuint m_instance_count;
+    GLuint m_first_index;
+    GLint m_base_vertex;
+    GLuint m_base_instance;
+  };
+
+  /* Heap backing the PainterStaticAttributeData objects made
+     by a PainterBackendGL; the attribute and index buffers are
+     sub-allocated with an interval_allocator. The heap is
+     reference counted so that the buffers stay alive for as long
+     as any StaticAttributeDataGL is alive. The attribute buffer
+     is allocated in units of uvec4 so that the data of all the
+     PainterAttribute::layout_t values share it; the allocation
+     of a layout storing K uvec4's is aligned to K uvec4's so that
+     its attributes start at an integer base vertex.
+   */
+  class static_attribute_heap:
+    public fastuidraw::reference_counted<static_attribute_heap>::default_base
+  {
+  public:
+    static_attribute_heap(unsigned int num_attributes,
+                          unsigned int num_indices);
+
+    ~static_attribute_heap();
+
+    fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData>
+    create(const fastuidraw::PainterAttributeData &data,
+           fastuidraw::const_c_array<unsigned int> attrib_chunk_selector,
+           enum fastuidraw::PainterAttribute::layout_t layout);
+
+    void
+    release(fastuidraw::range_type<int> attributes,
+            fastuidraw::range_type<int> indices);
+
+    GLuint m_attribute_bo, m_index_bo;
+
+  private:
+    fastuidraw::interval_allocator m_attributes, m_indices;
+  };
+
+  class StaticAttributeDataGL:public fastuidraw::PainterStaticAttributeData
+  {
+  public:
+    class chunk
+    {
+    public:
+      GLsizei m_count;
+      const GLvoid *m_offset;
+      GLint m_base_vertex;
+    };
+
+    StaticAttributeDataGL(const fastuidraw::reference_counted_ptr<static_attribute_heap> &heap,
+                          enum fastuidraw::PainterAttribute::layout_t layout,
+                          fastuidraw::range_type<int> attributes,
+                          fastuidraw::range_type<int> indices):
+      m_heap(heap),
+      m_layout(layout),
+      m_attributes(attributes),
+      m_indices(indices)
+    {}
+
+    ~StaticAttributeDataGL()
+    {
+      m_heap->release(m_attributes, m_indices);
+    }
+
+    virtual
+    unsigned int
+    number_chunks(void) const
+    {
+      return m_chunks.size();
+    }
+
+    virtual
+    unsigned int
+    number_indices(unsigned int c) const
+    {
+      assert(c < m_chunks.size());
+      return m_chunks[c].m_count;
+    }
+
+    virtual
+    enum fastuidraw::PainterAttribute::layout_t
+    attribute_layout(void) const
+    {
+      return m_layout;
+    }
+
+    fastuidraw::reference_counted_ptr<static_attribute_heap> m_heap;
+    enum fastuidraw::PainterAttribute::layout_t m_layout;
+
+    /* m_attributes is in units of uvec4 */
+    fastuidraw::range_type<int> m_attributes, m_indices;
+    std::vector<chunk> m_chunks;
   };
 
   class painter_vao_pool:fastuidraw::noncopyable
   {
   public:
+    /* what next_pool() decided for the sizes of
+       the buffers, see ConfigurationGL::adaptive_buffer_sizes()
+     */
+    enum resize_t
+      {
+        no_resize,
+        grow_buffers,
+        shrink_buffers,
+      };
+
+    /* max_data_blocks is the largest number of data store
+       blocks a buffer may hold for the GL context
+     */
     explicit
     painter_vao_pool(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &params,
                      const fastuidraw::PainterBackend::ConfigurationBase &params_base,
                      enum fastuidraw::gl::detail::tex_buffer_support_t tex_buffer_support,
-                     const fastuidraw::glsl::PainterBackendGLSL::BindingPoints &binding_points);
+                     const fastuidraw::glsl::PainterBackendGLSL::BindingPoints &binding_points,
+                     const static_attribute_heap *static_heap,
+                     unsigned int max_data_blocks);
 
     ~painter_vao_pool();
 
     unsigned int
-    attribute_buffer_size(void) const
+    attribute_buffer_size(const painter_vao &vao) const
     {
-      return m_attribute_buffer_size;
+      return vao.m_number_attributes * sizeof(fastuidraw::PainterAttribute);
     }
 
     unsigned int
-    header_buffer_size(void) const
+    header_buffer_size(const painter_vao &vao) const
     {
-      return m_header_buffer_size;
+      return vao.m_number_attributes * sizeof(uint32_t);
     }
 
     unsigned int
-    index_buffer_size(void) const
+    index_buffer_size(const painter_vao &vao) const
     {
-      return m_index_buffer_size;
+      return vao.m_number_indices
+        * (m_short_indices ? sizeof(uint16_t) : sizeof(fastuidraw::PainterIndex));
     }
 
     unsigned int
-    data_buffer_size(void) const
+    data_buffer_size(const painter_vao &vao) const
+    {
+      return vao.m_number_data_blocks * m_alignment * sizeof(fastuidraw::generic_data);
+    }
+
+    bool
+    persistent_mapping(void) const
     {
-      return m_data_buffer_size;
+      return m_persistent_mapping;
     }
 
+    /* if the buffer sizes adapt and changed since the buffers of
+       the next painter_vao of the pool were made, the buffers
+       are made again; the pool was waited on by then, so GL no
+       longer reads from them.
+     */
     painter_vao
     request_vao(void);
 
+    /* add to the usage of the current pass the values
+       a DrawCommand unmapped with
+     */
     void
+    note_usage(unsigned int attributes, unsigned int indices,
+               unsigned int data_store);
+
+    enum resize_t
     next_pool(void);
 
     GLuint //objects are recycled; make sure size never increases!
     request_uniform_ubo(unsigned int ubo_size, GLenum target);
 
+    /* only for persistent_mapping(); returns the buffer object
+       holding the uniform ring, i.e. a block of ubo_size bytes
+       for each pool, and gives the offset and pointer to the
+       block of the current pool. Waits on the fence of the pool
+       so that the block can be written immediately.
+     */
+    GLuint //size must never change!
+    request_uniform_ring_block(unsigned int ubo_size, GLintptr *offset, void **ptr);
+
   private:
     void
     generate_tbos(painter_vao &vao);
 
+    static
+    void
+    setup_attribute_slots(enum fastuidraw::PainterAttribute::layout_t layout
+                          = fastuidraw::PainterAttribute::layout_full);
+
+    void
+    generate_static_vao(painter_vao &vao,
+                        enum fastuidraw::PainterAttribute::layout_t layout);
+
+    void
+    generate_instanced_vao(painter_vao &vao);
+
     GLuint
     generate_tbo(GLuint src_buffer, GLenum fmt, unsigned int unit);
 
     GLuint
     generate_bo(GLenum bind_target, GLsizei psize);
 
-    unsigned int m_attribute_buffer_size, m_header_buffer_size;
-    unsigned int m_index_buffer_size;
-    int m_alignment, m_blocks_per_data_buffer;
-    unsigned int m_data_buffer_size;
+    GLuint
+    generate_persistent_bo(GLenum bind_target, GLsizei psize, void **ptr);
+
+    void
+    wait_pool_fence(void);
+
+    /* delete the GL objects of vao */
+    void
+    release_vao(painter_vao &vao);
+
+    /* record the usage of the pass that ended and move
+       m_size towards the largest usage of the recent passes
+     */
+    enum resize_t
+    adapt_sizes(void);
+
+    /* the sizes of the buffers in number of attributes,
+       indices and data store blocks, indexed by buffer_size_t
+     */
+    enum buffer_size_t
+      {
+        attribute_size,
+        index_size,
+        data_block_size,
+
+        number_sizes
+      };
+    typedef fastuidraw::vecN<unsigned int, number_sizes> sizes;
+
+    /* number of passes over which the largest usage is taken */
+    enum
+      {
+        usage_history_length = 32
+      };
+
+    int m_alignment;
+    bool m_short_indices;
     enum fastuidraw::gl::PainterBackendGL::data_store_backing_t m_data_store_backing;
     enum fastuidraw::gl::detail::tex_buffer_support_t m_tex_buffer_support;
     fastuidraw::glsl::PainterBackendGLSL::BindingPoints m_binding_points;
+    bool m_persistent_mapping;
+    bool m_use_indirect_draw;
+    GLuint m_static_attribute_bo, m_static_index_bo;
+    bool m_glyph_instancing;
+    bool m_debug_markers;
+
+    /* the 6 indices of the two triangles of a quad, sourced
+       by each painter_vao::m_instanced_vao
+     */
+    GLuint m_quad_index_bo;
 
     unsigned int m_current, m_pool;
     std::vector<std::vector<painter_vao> > m_vaos;
     std::vector<GLuint> m_ubos;
+
+    /* persistently mapped buffer with a block of uniforms for
+       each pool, m_uniform_ring_stride is the size of the block
+       rounded up to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+     */
+    GLuint m_uniform_ring;
+    void *m_uniform_ring_ptr;
+    unsigned int m_uniform_ring_stride;
+
+    /* bytes of the buffer objects made by generate_bo()
+       and generate_persistent_bo(), as reported to
+       fastuidraw::memory::subsystem_usage()
+     */
+    uint64_t m_gpu_bytes;
+
+    /* m_fences[p] is signaled when GL is finished with
+       the buffers of the pool p; only used when buffers
+       are persistently mapped.
+     */
+    std::vector<GLsync> m_fences;
+
+    /* ConfigurationGL::adaptive_buffer_sizes() support: m_size is
+       the size of the buffers made by request_vao(), m_min_size
+       and m_max_size its range, m_pass_usage the sum of the usage
+       of the DrawCommand's of the current pass and m_usage_history
+       a ring of the usage of the last usage_history_length passes.
+     */
+    bool m_adaptive;
+    sizes m_size, m_min_size, m_max_size;
+    sizes m_pass_usage;
+    std::vector<sizes> m_usage_history;
+    unsigned int m_usage_history_pos;
   };
 
   bool
@@ -161,391 +493,2208 @@ namespace
     enum fastuidraw::gl::PainterBackendGL::program_type_t m_tp;
   };
 
-  class PainterBackendGLPrivate
+  class SpecializedItemShaderFilter:public fastuidraw::glsl::PainterBackendGLSL::ItemShaderFilter
   {
   public:
-    typedef fastuidraw::reference_counted_ptr<fastuidraw::gl::Program> program_ref;
-    enum { program_count = fastuidraw::gl::PainterBackendGL::number_program_types };
-    typedef fastuidraw::vecN<program_ref, program_count + 1> program_set;
+    explicit
+    SpecializedItemShaderFilter(const fastuidraw::PainterShader *shader):
+      m_shader(shader)
+    {}
 
-    PainterBackendGLPrivate(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &P,
-                            fastuidraw::gl::PainterBackendGL *p);
+    bool
+    use_shader(const fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> &shader) const
+    {
+      return static_cast<const fastuidraw::PainterShader*>(shader.get()) == m_shader;
+    }
 
-    ~PainterBackendGLPrivate();
+  private:
+    const fastuidraw::PainterShader *m_shader;
+  };
 
-    static
-    fastuidraw::glsl::PainterBackendGLSL::ConfigurationGLSL
-    compute_glsl_config(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &P);
+  /* the shaders in use by a DrawEntry, used to label the
+     GPU time of the DrawEntry.
+   */
+  class shader_group_label
+  {
+  public:
+    shader_group_label(void):
+      m_item_group(0),
+      m_blend_group(0),
+      m_brush(0)
+    {}
 
-    static
-    fastuidraw::PainterBackend::ConfigurationBase
-    compute_base_config(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &P,
-                        const fastuidraw::PainterBackend::ConfigurationBase &config_base);
+    explicit
+    shader_group_label(const fastuidraw::PainterShaderGroup &g):
+      m_item_group(g.item_group()),
+      m_blend_group(g.blend_group()),
+      m_brush(g.brush())
+    {}
 
-    const program_set&
-    programs(bool rebuild);
+    bool
+    operator==(const shader_group_label &rhs) const
+    {
+      return m_item_group == rhs.m_item_group
+        && m_blend_group == rhs.m_blend_group
+        && m_brush == rhs.m_brush;
+    }
 
-    void
-    configure_backend(void);
+    bool
+    operator!=(const shader_group_label &rhs) const
+    {
+      return !operator==(rhs);
+    }
+
+    uint32_t m_item_group, m_blend_group, m_brush;
+  };
+
+  /* the annotations of ConfigurationGL::debug_markers() */
+  void
+  push_debug_group(const std::string &label)
+  {
+    glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, label.c_str());
+  }
 
+  void
+  pop_debug_group(void)
+  {
+    glPopDebugGroup();
+  }
+
+  void
+  label_object(GLenum identifier, GLuint name, const std::string &label)
+  {
+    if(name != 0)
+      {
+        glObjectLabel(identifier, name, -1, label.c_str());
+      }
+  }
+
+  std::string
+  debug_group_name(const shader_group_label &label, const fastuidraw::BlendMode &mode)
+  {
+    std::ostringstream str;
+
+    str << "fastuidraw draw: item group 0x" << std::hex << label.m_item_group
+        << ", blend group 0x" << label.m_blend_group
+        << ", brush 0x" << label.m_brush
+        << ", blend mode ";
+    if(mode.blending_on())
+      {
+        str << "0x" << mode.packed();
+      }
+    else
+      {
+        str << "off";
+      }
+    return str.str();
+  }
+
+  /* Ring of GL query objects timing the GPU work of frames,
+     i.e. from on_pre_draw() to on_post_draw(), with GL_TIMESTAMP
+     queries and of each DrawEntry with GL_TIME_ELAPSED queries.
+     The results of a frame are read only once GL reports the
+     last query of the frame as available, so reading never
+     stalls; a frame whose slot in the ring is still pending
+     is not timed.
+   */
+  class timer_query_ring:fastuidraw::noncopyable
+  {
+  public:
+    explicit
+    timer_query_ring(unsigned int number_frames);
+
+    ~timer_query_ring();
+
+    /* reads the results of completed frames and starts
+       timing a frame if the next slot is free.
+     */
     void
-    configure_source_front_matter(void);
+    begin_frame(void);
 
     void
-    build_programs(void);
+    end_frame(void);
 
-    program_ref
-    build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp);
+    bool
+    timing(void) const
+    {
+      return m_current != NULL;
+    }
 
     void
-    build_vao_tbos(void);
+    begin_element(const shader_group_label &label);
 
-    fastuidraw::gl::PainterBackendGL::ConfigurationGL m_params;
-    fastuidraw::glsl::PainterBackendGLSL::UberShaderParams m_uber_shader_builder_params;
+    void
+    end_element(void);
 
-    fastuidraw::gl::ContextProperties m_ctx_properties;
-    bool m_backend_configured;
-    enum fastuidraw::gl::detail::tex_buffer_support_t m_tex_buffer_support;
-    int m_number_clip_planes;
-    GLenum m_clip_plane0;
-    std::string m_gles_clip_plane_extension;
+    const std::vector<fastuidraw::gl::PainterBackendGL::TimerQueryResult>&
+    results(void) const
+    {
+      return m_results;
+    }
 
-    GLuint m_linear_filter_sampler;
-    fastuidraw::gl::PreLinkActionArray m_attribute_binder;
-    fastuidraw::gl::ProgramInitializerArray m_initializer;
-    fastuidraw::glsl::ShaderSource m_front_matter_vert;
-    fastuidraw::glsl::ShaderSource m_front_matter_frag;
-    program_set m_programs;
-    fastuidraw::vecN<GLint, fastuidraw::gl::PainterBackendGL::number_program_types> m_shader_uniforms_loc;
-    std::vector<fastuidraw::generic_data> m_uniform_values;
-    fastuidraw::c_array<fastuidraw::generic_data> m_uniform_values_ptr;
-    painter_vao_pool *m_pool;
+    uint64_t
+    frame_time_ns(void) const
+    {
+      return m_frame_time_ns;
+    }
 
-    fastuidraw::gl::PainterBackendGL *m_p;
+  private:
+    class frame
+    {
+    public:
+      frame(void):
+        m_start(0),
+        m_end(0),
+        m_number_used(0),
+        m_pending(false)
+      {}
+
+      GLuint m_start, m_end;
+      std::vector<GLuint> m_queries;
+      std::vector<shader_group_label> m_labels;
+      unsigned int m_number_used;
+      bool m_pending;
+    };
+
+    void
+    read_results(frame &f);
+
+    std::vector<frame> m_frames;
+    unsigned int m_next;
+    frame *m_current;
+    std::vector<fastuidraw::gl::PainterBackendGL::TimerQueryResult> m_results;
+    uint64_t m_frame_time_ns;
   };
 
-  class DrawEntry
+  /* A RenderTargetGL is a framebuffer object whose color
+     buffer is a GL_TEXTURE_2D drawn as a bindless image and
+     whose depth and stencil are a renderbuffer.
+   */
+  class RenderTargetGL:public fastuidraw::PainterBackend::RenderTarget
   {
   public:
-    DrawEntry(const fastuidraw::BlendMode &mode,
-              PainterBackendGLPrivate *pr,
-              unsigned int pz);
+    /* returns NULL if bindless textures are not supported
+       or the framebuffer object is not complete
+     */
+    static
+    fastuidraw::reference_counted_ptr<RenderTargetGL>
+    create(fastuidraw::ivec2 dims);
 
+    ~RenderTargetGL();
 
-    DrawEntry(const fastuidraw::BlendMode &mode);
+    virtual
+    fastuidraw::ivec2
+    dimensions(void) const
+    {
+      return m_dimensions;
+    }
 
-    void
-    add_entry(GLsizei count, const void *offset);
+    virtual
+    const fastuidraw::reference_counted_ptr<fastuidraw::Image>&
+    image(void) const
+    {
+      return m_image;
+    }
 
-    void
-    draw(void) const;
+    GLuint
+    fbo(void) const
+    {
+      return m_fbo;
+    }
 
-  private:
+    GLuint
+    texture(void) const
+    {
+      return m_texture;
+    }
 
-    static
-    GLenum
-    convert_blend_op(enum fastuidraw::BlendMode::op_t v);
+  private:
+    RenderTargetGL(fastuidraw::ivec2 dims);
 
-    static
-    GLenum
-    convert_blend_func(enum fastuidraw::BlendMode::func_t v);
+    fastuidraw::ivec2 m_dimensions;
+    GLuint m_texture, m_depth_stencil, m_fbo;
+    fastuidraw::reference_counted_ptr<fastuidraw::Image> m_image;
+  };
 
-    fastuidraw::BlendMode m_blend_mode;
-    std::vector<GLsizei> m_counts;
-    std::vector<const GLvoid*> m_indices;
-    PainterBackendGLPrivate *m_private;
-    unsigned int m_choice;
+  /* what PainterBackendGL::end_render_target() restores */
+  class saved_render_target
+  {
+  public:
+    GLint m_fbo;
+    fastuidraw::vecN<GLint, 4> m_viewport;
+    bool m_scissor_test;
   };
 
-  class DrawCommand:public fastuidraw::PainterDraw
+  /* Shadow of the GL binding state that the draws of a
+     PainterBackendGL set, so that binding what is already
+     bound is skipped. State that is not known is marked
+     with unknown_name (or GL_NONE for a texture target)
+     and is always set.
+   */
+  class gl_state_shadow
   {
   public:
-    explicit
-    DrawCommand(painter_vao_pool *hnd,
-                const fastuidraw::gl::PainterBackendGL::ConfigurationGL &params,
-                PainterBackendGLPrivate *pr);
+    enum { unknown_name = ~0u };
 
-    virtual
-    ~DrawCommand()
-    {}
+    gl_state_shadow(void):
+      m_atlas_resizes(0)
+    {
+      invalidate();
+    }
 
-    virtual
+    /* forget all state, as after GL code foreign
+       to the PainterBackendGL ran
+     */
     void
-    draw_break(const fastuidraw::PainterShaderGroup &old_shaders,
-               const fastuidraw::PainterShaderGroup &new_shaders,
-               unsigned int attributes_written, unsigned int indices_written) const;
+    invalidate(void);
 
-    virtual
+    /* forget the texture bound to the active texture unit;
+       uploading to the texture of an atlas or of an image
+       binds the texture to the active texture unit.
+     */
     void
-    draw(void) const;
+    invalidate_active_texture(void);
 
-  protected:
+    /* forget the bound program; a program that is deleted
+       while bound stays bound but its name may be reused.
+     */
+    void
+    invalidate_program(void)
+    {
+      m_program = unknown_name;
+    }
 
-    virtual
+    /* forget the bound textures if atlases were resized
+       since the last call, i.e. if v differs from its
+       previous value; deleting a bound texture unbinds
+       it and its name may be reused.
+     */
     void
-    unmap_implement(unsigned int attributes_written,
-                    unsigned int indices_written,
-                    unsigned int data_store_written) const;
+    note_atlas_resizes(uint64_t v);
 
-  private:
+    void
+    use_program(fastuidraw::gl::Program *pr);
 
     void
-    add_entry(unsigned int indices_written) const;
+    bind_vertex_array(GLuint vao);
 
-    PainterBackendGLPrivate *m_pr;
-    painter_vao m_vao;
-    mutable unsigned int m_attributes_written, m_indices_written;
-    mutable std::list<DrawEntry> m_draws;
+    void
+    bind_texture(GLuint unit, GLenum target, GLuint texture);
+
+    void
+    bind_sampler(GLuint unit, GLuint sampler);
+
+    /* returns true if the blend state is to be set,
+       i.e. it is not known to be mode already, and
+       records that it is then mode.
+     */
+    bool
+    change_blend_mode(const fastuidraw::BlendMode &mode);
+
+  private:
+    void
+    active_texture(GLuint unit);
+
+    GLuint m_program, m_vao, m_active_unit;
+    uint64_t m_atlas_resizes;
+    std::vector<std::pair<GLenum, GLuint> > m_textures;
+    std::vector<GLuint> m_samplers;
+    bool m_blend_mode_known;
+    fastuidraw::BlendMode::packed_value m_blend_mode;
+  };
+
+  /* the state of a PainterBackendGL that is per surface,
+     see PainterBackendGL::current_surface()
+   */
+  class surface_state:fastuidraw::noncopyable
+  {
+  public:
+    explicit
+    surface_state(painter_vao_pool *pool):
+      m_pool(pool)
+    {}
+
+    ~surface_state()
+    {
+      FASTUIDRAWdelete(m_pool);
+    }
+
+    painter_vao_pool *m_pool;
+
+    /* invalidated at each on_pre_draw() unless
+       retain_gl_state_between_passes() is true
+     */
+    gl_state_shadow m_gl_state;
+  };
+
+  class PainterBackendGLPrivate
+  {
+  public:
+    typedef fastuidraw::reference_counted_ptr<fastuidraw::gl::Program> program_ref;
+    enum { program_count = fastuidraw::gl::PainterBackendGL::number_program_types };
+    typedef fastuidraw::vecN<program_ref, program_count + 1> program_set;
+
+    /* the textures of the atlases, see label_atlas_textures() */
+    enum atlas_texture_t
+      {
+        image_color_atlas_texture,
+        image_index_atlas_texture,
+        glyph_texel_uint_atlas_texture,
+        glyph_texel_float_atlas_texture,
+        glyph_geometry_atlas_texture,
+        colorstop_atlas_texture,
+
+        number_atlas_textures
+      };
+
+    PainterBackendGLPrivate(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &P,
+                            fastuidraw::gl::PainterBackendGL *p);
+
+    ~PainterBackendGLPrivate();
+
+    static
+    fastuidraw::glsl::PainterBackendGLSL::ConfigurationGLSL
+    compute_glsl_config(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &P);
+
+    static
+    fastuidraw::PainterBackend::ConfigurationBase
+    compute_base_config(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &P,
+                        const fastuidraw::PainterBackend::ConfigurationBase &config_base);
+
+    const program_set&
+    programs(bool rebuild);
+
+    void
+    configure_backend(void);
+
+    /* make the surface current, creating its pool
+       if it does not yet exist
+     */
+    void
+    select_surface(unsigned int surface);
+
+    void
+    invalidate_depth_stencil(void);
+
+    /* names with glObjectLabel() the textures of the atlases
+       that are not yet named, see ConfigurationGL::debug_markers()
+     */
+    void
+    label_atlas_textures(const fastuidraw::vecN<GLuint, number_atlas_textures> &textures);
+
+    /* names with glObjectLabel() the programs of m_programs,
+       m_solid_brush_programs and m_specialized_programs
+     */
+    void
+    label_programs(void);
+
+    void
+    configure_source_front_matter(void);
+
+    void
+    build_programs(void);
+
+    void
+    start_pending_programs(void);
+
+    void
+    promote_pending_programs(void);
+
+    void
+    set_program_uniform_locations(void);
+
+    uint32_t
+    compute_async_group(fastuidraw::PainterShader::Tag tag,
+                        unsigned int number_sub_shaders,
+                        unsigned int *id_end);
+
+    program_ref
+    build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp);
+
+    program_ref
+    build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp,
+                  bool solid_brush);
+
+    program_ref
+    build_program(const fastuidraw::glsl::PainterBackendGLSL::ItemShaderFilter *item_filter,
+                  const char *discard_macro, bool solid_brush = false);
+
+    program_ref
+    build_specialized_program(unsigned int I);
+
+    /* ConfigurationGL::specialized_programs() support */
+    void
+    note_item_shader(fastuidraw::PainterShader::Tag tag,
+                     const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader);
+
+    void
+    note_item_indices(uint32_t item_group, unsigned int count);
+
+    void
+    choose_specialized_programs(void);
+
+    void
+    check_specialized_programs_ready(void);
+
+    void
+    set_specialized_program_uniform_locations(void);
+
+    /* returns the index to feed choice_program() of the
+       program to draw the item shader group item_group
+       with the brush shader bits brush.
+     */
+    unsigned int
+    program_choice(uint32_t item_group, uint32_t brush) const;
+
+    const program_ref&
+    choice_program(unsigned int choice) const
+    {
+      if(choice & choice_solid_brush_bit)
+        {
+          return m_solid_brush_programs[choice & ~choice_solid_brush_bit];
+        }
+      return (choice < fastuidraw::gl::PainterBackendGL::number_program_types) ?
+        m_programs[choice] :
+        m_specialized_programs[choice - fastuidraw::gl::PainterBackendGL::number_program_types];
+    }
+
+    void
+    build_vao_tbos(void);
+
+    fastuidraw::gl::PainterBackendGL::ConfigurationGL m_params;
+    fastuidraw::glsl::PainterBackendGLSL::UberShaderParams m_uber_shader_builder_params;
+
+    fastuidraw::gl::ContextProperties m_ctx_properties;
+    bool m_backend_configured;
+    enum fastuidraw::gl::detail::tex_buffer_support_t m_tex_buffer_support;
+    int m_number_clip_planes;
+    GLenum m_clip_plane0;
+    std::string m_gles_clip_plane_extension;
+    std::string m_external_texture_extension;
+
+    GLuint m_linear_filter_sampler;
+
+    /* set by PainterBackendGL::no_depth_buffer() */
+    bool m_no_depth_buffer;
+
+    fastuidraw::gl::PreLinkActionArray m_attribute_binder;
+    fastuidraw::gl::ProgramInitializerArray m_initializer;
+    fastuidraw::glsl::ShaderSource m_front_matter_vert;
+    fastuidraw::glsl::ShaderSource m_front_matter_frag;
+    program_set m_programs;
+
+    /* async_program_rebuild() support; the shader ID interval
+       of the shaders supported by the programs in m_programs
+       is [0, m_ready_item_shader_id_end) and
+       [0, m_ready_blend_shader_id_end)
+     */
+    program_set m_pending_programs;
+    bool m_has_pending_programs;
+    unsigned int m_item_shader_id_end, m_blend_shader_id_end;
+    unsigned int m_pending_item_shader_id_end, m_pending_blend_shader_id_end;
+    unsigned int m_ready_item_shader_id_end, m_ready_blend_shader_id_end;
+
+    fastuidraw::vecN<GLint, fastuidraw::gl::PainterBackendGL::number_program_types> m_shader_uniforms_loc;
+
+    /* ConfigurationGL::specialized_programs() support:
+        - m_item_shader_of_id[ID] is the parent shader of the item shader ID
+        - m_item_indices_drawn[ID] is the number of indices drawn with the
+          item shader ID during the first specialization_sample_draws
+          calls to on_pre_draw(), m_specialization_samples is the
+          number of such calls so far
+        - m_specialized_shaders[I] is the item shader of the I'th
+          specialized program m_specialized_programs[I]
+        - m_specialized_program_of_id[ID] is the index of the specialized
+          program of the item shader ID or -1 if it has none
+        - the specialized programs are only used once all of them
+          are built, i.e. when m_specialized_programs_ready is true.
+     */
+    std::vector<const fastuidraw::PainterShader*> m_item_shader_of_id;
+    std::vector<uint64_t> m_item_indices_drawn;
+    unsigned int m_specialization_samples;
+    std::vector<const fastuidraw::PainterShader*> m_specialized_shaders;
+    std::vector<int> m_specialized_program_of_id;
+    std::vector<program_ref> m_specialized_programs, m_pending_specialized_programs;
+    std::vector<GLint> m_specialized_uniforms_loc;
+    bool m_specialized_programs_ready;
+
+    /* ConfigurationGL::solid_brush_programs() support: the programs
+       of each program type built for brushes whose shader bits are
+       zero; the choice of such a program has choice_solid_brush_bit up.
+     */
+    program_set m_solid_brush_programs, m_pending_solid_brush_programs;
+    fastuidraw::vecN<GLint, fastuidraw::gl::PainterBackendGL::number_program_types> m_solid_brush_uniforms_loc;
+    std::vector<fastuidraw::generic_data> m_uniform_values;
+    fastuidraw::c_array<fastuidraw::generic_data> m_uniform_values_ptr;
+
+    /* m_surfaces[i] is NULL if the surface i has not been
+       selected since its creation or release; m_pool and
+       m_gl_state are of m_surfaces[m_current_surface].
+     */
+    std::vector<surface_state*> m_surfaces;
+    unsigned int m_current_surface;
+    painter_vao_pool *m_pool;
+    gl_state_shadow *m_gl_state;
+    fastuidraw::reference_counted_ptr<static_attribute_heap> m_static_heap;
+
+    /* work room for DrawCommand::upload_indirect_commands() */
+    std::vector<draw_elements_indirect_command> m_indirect_commands;
+
+    /* if ConfigurationGL::short_indices() is true, the indices
+       of the mapped DrawCommand are written here and converted
+       to 16-bit indices into the index buffer on unmap; since
+       PainterPacker unmaps a PainterDraw before mapping the
+       next, a single staging buffer is shared by all of them.
+     */
+    std::vector<fastuidraw::PainterIndex> m_short_index_staging;
+
+    /* stats for PainterBackend::query_stat(), the bytes uploaded
+       are the difference of detail::number_bytes_uploaded()
+       against its value at the last reset_stats(), as are
+       the atlas resizes against detail::number_atlas_resizes().
+     */
+    unsigned int m_num_draw_calls;
+    uint64_t m_bytes_uploaded_at_reset;
+    uint64_t m_atlas_resizes_at_reset;
+
+    /* the upload counts once on_pre_draw() has flushed the
+       atlases; if they differ at on_post_draw(), the pass
+       uploaded to an atlas after its first draw.
+     */
+    uint64_t m_bytes_uploaded_at_pass;
+    uint64_t m_atlas_resizes_at_pass;
+    unsigned int m_num_mid_pass_atlas_flushes;
+
+    /* the decisions of painter_vao_pool::next_pool() */
+    unsigned int m_num_buffer_grows, m_num_buffer_shrinks;
+
+    /* the largest number of data store blocks a buffer
+       may hold for the GL context, see painter_vao_pool
+     */
+    unsigned int m_max_data_blocks_per_store_buffer;
+
+    /* glInvalidateFramebuffer() is available */
+    bool m_have_invalidate_framebuffer;
+
+    /* the atlas textures last named by label_atlas_textures() */
+    fastuidraw::vecN<GLuint, number_atlas_textures> m_labelled_atlas_textures;
+
+    /* NULL if timer_query_frames() is 0 */
+    timer_query_ring *m_timer_queries;
+
+    /* one entry for each begin_render_target()
+       without its end_render_target()
+     */
+    std::vector<saved_render_target> m_render_target_stack;
+
+    /* created on the first PainterBackendGL::blur_render_target() */
+    fastuidraw::gl::detail::LayerBlur *m_layer_blur;
+
+    fastuidraw::gl::PainterBackendGL *m_p;
+  };
+
+  class DrawEntry
+  {
+  public:
+    DrawEntry(const fastuidraw::BlendMode &mode,
+              PainterBackendGLPrivate *pr,
+              unsigned int pz);
+
+
+    DrawEntry(const fastuidraw::BlendMode &mode);
+
+    enum static_entry_t { static_entry };
+
+    /* an entry whose elements are drawn from the static
+       attribute data of the named layout through
+       painter_vao::m_static_vaos
+     */
+    DrawEntry(const fastuidraw::BlendMode &mode, enum static_entry_t,
+              enum fastuidraw::PainterAttribute::layout_t layout);
+
+    enum instanced_entry_t { instanced_entry };
+
+    /* an entry whose elements are instances of a quad drawn from
+       the streamed attributes through painter_vao::m_instanced_vao
+     */
+    DrawEntry(const fastuidraw::BlendMode &mode, enum instanced_entry_t);
+
+    void
+    add_entry(GLsizei count, const void *offset,
+              unsigned int item_id_end, unsigned int blend_id_end);
+
+    void
+    add_static_entry(const StaticAttributeDataGL::chunk &chunk,
+                     GLuint base_instance, GLsizei instance_count,
+                     unsigned int item_id_end, unsigned int blend_id_end);
+
+    void
+    add_instanced_entry(GLsizei instance_count, GLuint base_instance,
+                        unsigned int item_id_end, unsigned int blend_id_end);
+
+    bool
+    is_static(void) const
+    {
+      return m_static;
+    }
+
+    enum fastuidraw::PainterAttribute::layout_t
+    static_layout(void) const
+    {
+      return m_static_layout;
+    }
+
+    bool
+    is_instanced(void) const
+    {
+      return m_instanced;
+    }
+
+    const fastuidraw::BlendMode&
+    blend_mode(void) const
+    {
+      return m_blend_mode;
+    }
+
+    /* shaders used by the elements of the entry; when
+       timer queries are on each DrawEntry uses only
+       one set of shaders.
+     */
+    const shader_group_label&
+    label(void) const
+    {
+      return m_label;
+    }
+
+    void
+    label(const shader_group_label &v)
+    {
+      m_label = v;
+    }
+
+    /* returns the number of GL draw calls issued
+     */
+    unsigned int
+    draw(gl_state_shadow &state, const painter_vao &vao,
+         unsigned int ready_item_id_end,
+         unsigned int ready_blend_id_end) const;
+
+    /* append the elements of this entry to cmds and record
+       where they are so that draw() sources them from the
+       GL_DRAW_INDIRECT_BUFFER
+     */
+    void
+    add_indirect_commands(std::vector<draw_elements_indirect_command> &cmds);
+
+    /* for an entry drawn from the streamed buffers, write the
+       indices of its elements from src to dst as 16-bit indices
+       relative to a base vertex for each element, splitting the
+       elements whose vertices do not lie within 65536 of each
+       other; does nothing for static and instanced entries.
+     */
+    void
+    convert_to_short_indices(const fastuidraw::PainterIndex *src, uint16_t *dst);
+
+    /* true if the entry replaces the color of the pixels it
+       draws, i.e. its blend mode is that of the single_src
+       blend shader of PainterEnums::blend_porter_duff_src, and
+       does not write to the stencil buffer. Since every draw is
+       depth tested with GL_GEQUAL and writes its depth, the
+       result of drawing such entries does not depend on the
+       order in which they are drawn.
+     */
+    bool
+    replaces_color(void) const;
+
+    /* true if no entry may be moved across the entry when
+       reordering: the entry writes to the stencil buffer or,
+       as the occluders of clipping do, writes only depth.
+     */
+    bool
+    order_barrier(void) const;
+
+    /* reverse the order of the elements of the entry, must
+       be called before add_indirect_commands()
+     */
+    void
+    reverse_elements(void);
+
+    /* if the entry continues with the program of the entry
+       before it, set the program to choice
+     */
+    void
+    program(PainterBackendGLPrivate *pr, unsigned int choice);
+
+    unsigned int
+    program_choice(unsigned int current) const
+    {
+      return m_private ? m_choice : current;
+    }
+
+  private:
+
+    bool
+    all_elements_ready(unsigned int ready_item_id_end,
+                       unsigned int ready_blend_id_end) const
+    {
+      return m_max_item_id_end <= ready_item_id_end
+        && m_max_blend_id_end <= ready_blend_id_end;
+    }
+
+    unsigned int
+    draw_indirect(void) const;
+
+    void
+    add_id_ends(unsigned int item_id_end, unsigned int blend_id_end);
+
+    bool
+    element_ready(unsigned int i,
+                  unsigned int ready_item_id_end,
+                  unsigned int ready_blend_id_end) const
+    {
+      return m_item_id_ends.empty()
+        || (m_item_id_ends[i] <= ready_item_id_end
+            && m_blend_id_ends[i] <= ready_blend_id_end);
+    }
+
+    unsigned int
+    draw_base_instance(gl_state_shadow &state, GLuint vao_name,
+                       const painter_vao &vao,
+                       unsigned int ready_item_id_end,
+                       unsigned int ready_blend_id_end) const;
+
+    static
+    unsigned int
+    draw_elements(fastuidraw::const_c_array<GLsizei> counts,
+                  fastuidraw::const_c_array<const GLvoid*> indices);
+
+    static
+    unsigned int
+    draw_short_elements(fastuidraw::const_c_array<GLsizei> counts,
+                        fastuidraw::const_c_array<const GLvoid*> indices,
+                        fastuidraw::const_c_array<GLint> base_vertices);
+
+    GLenum
+    index_type(void) const
+    {
+      return m_short_indices ?
+        GL_UNSIGNED_SHORT :
+        fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type;
+    }
+
+    static
+    GLenum
+    convert_blend_op(enum fastuidraw::BlendMode::op_t v);
+
+    static
+    GLenum
+    convert_blend_func(enum fastuidraw::BlendMode::func_t v);
+
+    static
+    void
+    apply_blend_mode(const fastuidraw::BlendMode &mode);
+
+    static
+    void
+    apply_stencil_op(const fastuidraw::BlendMode &mode);
+
+    /* nearly all DrawEntry objects have few elements, the
+       arrays of the elements keep that many inline so that
+       making a DrawEntry does not allocate.
+     */
+    enum
+      {
+        inline_elements = 8
+      };
+
+    fastuidraw::BlendMode m_blend_mode;
+    fastuidraw::small_vector<GLsizei, inline_elements> m_counts;
+    fastuidraw::small_vector<const GLvoid*, inline_elements> m_indices;
+    PainterBackendGLPrivate *m_private;
+    unsigned int m_choice;
+
+    /* if m_static or m_instanced is true, each element is drawn
+       with base vertex, base instance and instance count from
+       m_base_vertices, m_base_instances and m_instance_counts
+     */
+    bool m_static, m_instanced;
+    enum fastuidraw::PainterAttribute::layout_t m_static_layout;
+
+    /* if true, the elements are 16-bit indices drawn with the
+       base vertices of m_base_vertices, see convert_to_short_indices()
+     */
+    bool m_short_indices;
+    fastuidraw::small_vector<GLint, inline_elements> m_base_vertices;
+    fastuidraw::small_vector<GLuint, inline_elements> m_base_instances;
+    fastuidraw::small_vector<GLsizei, inline_elements> m_instance_counts;
+
+    /* location and number of the commands in the
+       GL_DRAW_INDIRECT_BUFFER, m_indirect_count is 0
+       if not drawn with glMultiDrawElementsIndirect
+     */
+    const GLvoid *m_indirect_offset;
+    GLsizei m_indirect_count;
+
+    /* for each element, one past the largest item and blend
+       shader ID that uber-shader must support to draw the
+       element, a value of 0 indicates no requirement. Only
+       non-empty if some element requires a shader
+       registered with async_program_rebuild() true.
+     */
+    fastuidraw::small_vector<unsigned int, inline_elements> m_item_id_ends, m_blend_id_ends;
+    unsigned int m_max_item_id_end, m_max_blend_id_end;
+    shader_group_label m_label;
+  };
+
+  class DrawCommand:public fastuidraw::PainterDraw
+  {
+  public:
+    explicit
+    DrawCommand(painter_vao_pool *hnd,
+                const fastuidraw::gl::PainterBackendGL::ConfigurationGL &params,
+                PainterBackendGLPrivate *pr);
+
+    virtual
+    ~DrawCommand()
+    {}
+
+    virtual
+    void
+    draw_break(const fastuidraw::PainterShaderGroup &old_shaders,
+               const fastuidraw::PainterShaderGroup &new_shaders,
+               unsigned int attributes_written, unsigned int indices_written) const;
+
+    virtual
+    void
+    draw_static(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData> &data,
+                unsigned int chunk, unsigned int header_attribute,
+                unsigned int number_instances,
+                unsigned int indices_written) const;
+
+    virtual
+    void
+    draw_instanced_quads(unsigned int first_attribute,
+                         unsigned int number_instances,
+                         unsigned int indices_written) const;
+
+    virtual
+    void
+    draw(void) const;
+
+  protected:
+
+    virtual
+    void
+    unmap_implement(unsigned int attributes_written,
+                    unsigned int indices_written,
+                    unsigned int data_store_written) const;
+
+  private:
+
+    void
+    add_entry(unsigned int indices_written) const;
+
+    /* appends a DrawEntry labeled with m_current_label */
+    void
+    push_draw_entry(const DrawEntry &entry) const;
+
+    void
+    upload_indirect_commands(void) const;
+
+    /* see ConfigurationGL::opaque_front_to_back() */
+    void
+    order_front_to_back(void) const;
+
+    static
+    unsigned int
+    async_id_end(uint32_t group);
+
+    PainterBackendGLPrivate *m_pr;
+    painter_vao m_vao;
+
+    /* mapped index buffer if ConfigurationGL::short_indices()
+       is true, NULL otherwise.
+     */
+    uint16_t *m_short_indices;
+    mutable unsigned int m_attributes_written, m_indices_written;
+    mutable unsigned int m_current_item_id_end, m_current_blend_id_end;
+    mutable uint32_t m_current_item_group;
+    mutable shader_group_label m_current_label;
+
+    /* program of the item shader group 0 with which the
+       draws start, chosen when packing since the choice
+       of programs may change in on_pre_draw().
+     */
+    unsigned int m_initial_choice;
+    mutable std::list<DrawEntry> m_draws;
+
+    /* keeps the static attribute data drawn alive until
+       this DrawCommand is done
+     */
+    mutable std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData> > m_static_data;
+  };
+
+  class ConfigurationGLPrivate
+  {
+  public:
+    ConfigurationGLPrivate(void):
+      m_attributes_per_buffer(512 * 512),
+      m_indices_per_buffer((m_attributes_per_buffer * 6) / 4),
+      m_data_blocks_per_store_buffer(1024 * 64),
+      m_data_store_backing(fastuidraw::gl::PainterBackendGL::data_store_tbo),
+      m_number_pools(3),
+      m_break_on_shader_change(false),
+      m_use_hw_clip_planes(true),
+      /* on Mesa/i965 using switch statement gives much slower
+         performance than using if/else chain.
+       */
+      m_vert_shader_use_switch(false),
+      m_frag_shader_use_switch(false),
+      m_blend_shader_use_switch(false),
+      m_unpack_header_and_brush_in_frag_shader(false),
+      m_pack_varyings(false),
+      m_assign_layout_to_vertex_shader_inputs(true),
+      m_assign_layout_to_varyings(false),
+      m_assign_binding_points(true),
+      m_use_ubo_for_uniforms(false),
+      m_separate_program_for_discard(true),
+      m_non_dashed_stroke_shader_uses_discard(false),
+      m_dashed_stroke_shader_uses_discard(true),
+      m_persistent_mapped_buffers(false),
+      m_async_program_rebuild(false),
+      m_static_attributes_per_heap(0),
+      m_static_indices_per_heap(0),
+      m_use_indirect_draw(false),
+      m_timer_query_frames(0),
+      m_stencil_coverage(false),
+      m_stencil_clipping(false),
+      m_rounded_rect_clipping(false),
+      m_glyph_instancing(true),
+      m_bindless_images(false),
+      m_external_texture_images(false),
+      m_specialized_programs(0),
+      m_solid_brush_programs(false),
+      m_w3c_blend_modes(true),
+      m_retain_gl_state_between_passes(false),
+      m_short_indices(false),
+      m_opaque_front_to_back(false),
+      m_precision_policy(fastuidraw::glsl::PainterBackendGLSL::precision_highp),
+      m_tile_based_rendering(false),
+      m_debug_markers(false),
+      m_adaptive_buffer_sizes(false),
+      m_adaptive_buffer_max_scale(8)
+    {}
+
+    unsigned int m_attributes_per_buffer;
+    unsigned int m_indices_per_buffer;
+    unsigned int m_data_blocks_per_store_buffer;
+    enum fastuidraw::gl::PainterBackendGL::data_store_backing_t m_data_store_backing;
+    unsigned int m_number_pools;
+    bool m_break_on_shader_change;
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::ImageAtlasGL> m_image_atlas;
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::ColorStopAtlasGL> m_colorstop_atlas;
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::GlyphAtlasGL> m_glyph_atlas;
+    bool m_use_hw_clip_planes;
+    bool m_vert_shader_use_switch;
+    bool m_frag_shader_use_switch;
+    bool m_blend_shader_use_switch;
+    bool m_unpack_header_and_brush_in_frag_shader;
+    bool m_pack_varyings;
+    bool m_assign_layout_to_vertex_shader_inputs;
+    bool m_assign_layout_to_varyings;
+    bool m_assign_binding_points;
+    bool m_use_ubo_for_uniforms;
+    bool m_separate_program_for_discard;
+    bool m_non_dashed_stroke_shader_uses_discard;
+    bool m_dashed_stroke_shader_uses_discard;
+    bool m_persistent_mapped_buffers;
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::ProgramBinaryCache> m_program_binary_cache;
+    bool m_async_program_rebuild;
+    unsigned int m_static_attributes_per_heap;
+    unsigned int m_static_indices_per_heap;
+    bool m_use_indirect_draw;
+    unsigned int m_timer_query_frames;
+    bool m_stencil_coverage;
+    bool m_stencil_clipping;
+    bool m_rounded_rect_clipping;
+    bool m_glyph_instancing;
+    bool m_bindless_images;
+    bool m_external_texture_images;
+    unsigned int m_specialized_programs;
+    bool m_solid_brush_programs;
+    bool m_w3c_blend_modes;
+    bool m_retain_gl_state_between_passes;
+    bool m_short_indices;
+    bool m_opaque_front_to_back;
+    enum fastuidraw::glsl::PainterBackendGLSL::precision_policy_t m_precision_policy;
+    bool m_tile_based_rendering;
+    bool m_debug_markers;
+    bool m_adaptive_buffer_sizes;
+    unsigned int m_adaptive_buffer_max_scale;
   };
 
-  class ConfigurationGLPrivate
-  {
-  public:
-    ConfigurationGLPrivate(void):
-      m_attributes_per_buffer(512 * 512),
-      m_indices_per_buffer((m_attributes_per_buffer * 6) / 4),
-      m_data_blocks_per_store_buffer(1024 * 64),
-      m_data_store_backing(fastuidraw::gl::PainterBackendGL::data_store_tbo),
-      m_number_pools(3),
-      m_break_on_shader_change(false),
-      m_use_hw_clip_planes(true),
-      /* on Mesa/i965 using switch statement gives much slower
-         performance than using if/else chain.
+}
+
+///////////////////////////////////////////
+// static_attribute_heap methods
+static_attribute_heap::
+static_attribute_heap(unsigned int num_attributes,
+                      unsigned int num_indices):
+  m_attribute_bo(0),
+  m_index_bo(0),
+  m_attributes(num_attributes * fastuidraw::PainterAttribute::number_uvec4s(fastuidraw::PainterAttribute::layout_full)),
+  m_indices(num_indices)
+{
+  glGenBuffers(1, &m_attribute_bo);
+  assert(m_attribute_bo != 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, m_attribute_bo);
+  glBufferData(GL_COPY_WRITE_BUFFER, num_attributes * sizeof(fastuidraw::PainterAttribute),
+               NULL, GL_STATIC_DRAW);
+
+  glGenBuffers(1, &m_index_bo);
+  assert(m_index_bo != 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, m_index_bo);
+  glBufferData(GL_COPY_WRITE_BUFFER, num_indices * sizeof(fastuidraw::PainterIndex),
+               NULL, GL_STATIC_DRAW);
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  m_attributes.report_free_space(fastuidraw::memory::subsystem_painter_backend,
+                                 sizeof(fastuidraw::uvec4));
+  m_indices.report_free_space(fastuidraw::memory::subsystem_painter_backend,
+                              sizeof(fastuidraw::PainterIndex));
+  fastuidraw::detail::memory_report_grow(fastuidraw::memory::subsystem_painter_backend, 0,
+                                         num_attributes * sizeof(fastuidraw::PainterAttribute)
+                                         + num_indices * sizeof(fastuidraw::PainterIndex));
+}
+
+static_attribute_heap::
+~static_attribute_heap()
+{
+  glDeleteBuffers(1, &m_attribute_bo);
+  glDeleteBuffers(1, &m_index_bo);
+  fastuidraw::detail::memory_report_shrink(fastuidraw::memory::subsystem_painter_backend, 0,
+                                           m_attributes.size() * sizeof(fastuidraw::uvec4)
+                                           + m_indices.size() * sizeof(fastuidraw::PainterIndex));
+}
+
+fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData>
+static_attribute_heap::
+create(const fastuidraw::PainterAttributeData &data,
+       fastuidraw::const_c_array<unsigned int> attrib_chunk_selector,
+       enum fastuidraw::PainterAttribute::layout_t layout)
+{
+  using namespace fastuidraw;
+
+  const_c_array<const_c_array<PainterAttribute> > attrib_chunks(data.attribute_data_chunks());
+  const_c_array<const_c_array<PainterIndex> > index_chunks(data.index_data_chunks());
+  const_c_array<int> index_adjusts(data.index_adjust_chunks());
+  std::vector<unsigned int> attrib_chunk_offsets(attrib_chunks.size());
+  unsigned int num_attributes(0), num_indices(0);
+  unsigned int num_fields, num_units;
+  int unit_loc, attrib_loc, index_loc;
+
+  assert(attrib_chunk_selector.empty() || attrib_chunk_selector.size() == index_chunks.size());
+  for(unsigned int i = 0; i < attrib_chunks.size(); ++i)
+    {
+      attrib_chunk_offsets[i] = num_attributes;
+      num_attributes += attrib_chunks[i].size();
+    }
+
+  for(unsigned int i = 0; i < index_chunks.size(); ++i)
+    {
+      num_indices += index_chunks[i].size();
+    }
+
+  if(num_attributes == 0 || num_indices == 0)
+    {
+      return reference_counted_ptr<const PainterStaticAttributeData>();
+    }
+
+  /* allocate num_fields - 1 extra units so that the start
+     can be aligned to num_fields units, attrib_loc is then
+     in units of attributes of the layout.
+   */
+  num_fields = PainterAttribute::number_uvec4s(layout);
+  num_units = num_attributes * num_fields + num_fields - 1;
+  unit_loc = m_attributes.allocate_interval(num_units);
+  if(unit_loc == -1)
+    {
+      return reference_counted_ptr<const PainterStaticAttributeData>();
+    }
+  attrib_loc = (unit_loc + num_fields - 1) / num_fields;
+
+  index_loc = m_indices.allocate_interval(num_indices);
+  if(index_loc == -1)
+    {
+      m_attributes.free_interval(unit_loc, num_units);
+      return reference_counted_ptr<const PainterStaticAttributeData>();
+    }
+
+  StaticAttributeDataGL *return_value;
+  std::vector<PainterIndex> indices;
+
+  return_value = FASTUIDRAWnew StaticAttributeDataGL(this, layout,
+                                                     range_type<int>(unit_loc, unit_loc + num_units),
+                                                     range_type<int>(index_loc, index_loc + num_indices));
+  return_value->m_chunks.resize(index_chunks.size());
+  indices.reserve(num_indices);
+
+  /* the index adjust is applied to the index values, the offset
+     of the attribute chunk is given by the base vertex of the draw
+   */
+  for(unsigned int i = 0; i < index_chunks.size(); ++i)
+    {
+      unsigned int K;
+      StaticAttributeDataGL::chunk &dst(return_value->m_chunks[i]);
+      const PainterIndex *offset(NULL);
+
+      K = attrib_chunk_selector.empty() ? i : attrib_chunk_selector[i];
+      assert(K < attrib_chunks.size());
+
+      offset += index_loc + indices.size();
+      dst.m_count = index_chunks[i].size();
+      dst.m_offset = offset;
+      dst.m_base_vertex = attrib_loc + attrib_chunk_offsets[K];
+
+      for(unsigned int j = 0; j < index_chunks[i].size(); ++j)
+        {
+          assert(int(index_chunks[i][j]) + index_adjusts[i] >= 0);
+          assert(int(index_chunks[i][j]) + index_adjusts[i] < int(attrib_chunks[K].size()));
+          indices.push_back(int(index_chunks[i][j]) + index_adjusts[i]);
+        }
+    }
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, m_attribute_bo);
+  if(layout == PainterAttribute::layout_full)
+    {
+      for(unsigned int i = 0; i < attrib_chunks.size(); ++i)
+        {
+          if(!attrib_chunks[i].empty())
+            {
+              glBufferSubData(GL_COPY_WRITE_BUFFER,
+                              (attrib_loc + attrib_chunk_offsets[i]) * sizeof(PainterAttribute),
+                              attrib_chunks[i].size() * sizeof(PainterAttribute),
+                              attrib_chunks[i].c_ptr());
+            }
+        }
+    }
+  else
+    {
+      std::vector<uvec4> packed;
+
+      /* only the fields the layout stores are uploaded */
+      packed.reserve(num_attributes * num_fields);
+      for(unsigned int i = 0; i < attrib_chunks.size(); ++i)
+        {
+          for(unsigned int j = 0; j < attrib_chunks[i].size(); ++j)
+            {
+              packed.push_back(attrib_chunks[i][j].m_attrib0);
+              if(num_fields > 1)
+                {
+                  packed.push_back(attrib_chunks[i][j].m_attrib1);
+                }
+            }
+        }
+      glBufferSubData(GL_COPY_WRITE_BUFFER,
+                      attrib_loc * num_fields * sizeof(uvec4),
+                      packed.size() * sizeof(uvec4),
+                      &packed[0]);
+    }
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, m_index_bo);
+  glBufferSubData(GL_COPY_WRITE_BUFFER,
+                  index_loc * sizeof(PainterIndex),
+                  indices.size() * sizeof(PainterIndex),
+                  &indices[0]);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  return return_value;
+}
+
+void
+static_attribute_heap::
+release(fastuidraw::range_type<int> attributes,
+        fastuidraw::range_type<int> indices)
+{
+  m_attributes.free_interval(attributes.m_begin, attributes.m_end - attributes.m_begin);
+  m_indices.free_interval(indices.m_begin, indices.m_end - indices.m_begin);
+}
+
+///////////////////////////////////////////
+// painter_vao_pool methods
+painter_vao_pool::
+painter_vao_pool(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &params,
+                 const fastuidraw::PainterBackend::ConfigurationBase &params_base,
+                 enum fastuidraw::gl::detail::tex_buffer_support_t tex_buffer_support,
+                 const fastuidraw::glsl::PainterBackendGLSL::BindingPoints &binding_points,
+                 const static_attribute_heap *static_heap,
+                 unsigned int max_data_blocks):
+  m_alignment(params_base.alignment()),
+  m_short_indices(params.short_indices()),
+  m_data_store_backing(params.data_store_backing()),
+  m_tex_buffer_support(tex_buffer_support),
+  m_binding_points(binding_points),
+  m_persistent_mapping(params.persistent_mapped_buffers()),
+  m_use_indirect_draw(params.use_indirect_draw()),
+  m_static_attribute_bo(static_heap ? static_heap->m_attribute_bo : 0),
+  m_static_index_bo(static_heap ? static_heap->m_index_bo : 0),
+  m_glyph_instancing(params.glyph_instancing()),
+  m_debug_markers(params.debug_markers()),
+  m_quad_index_bo(0),
+  m_current(0),
+  m_pool(0),
+  m_vaos(params.number_pools()),
+  m_ubos(params.number_pools(), 0),
+  m_uniform_ring(0),
+  m_uniform_ring_ptr(NULL),
+  m_uniform_ring_stride(0),
+  m_gpu_bytes(0),
+  m_fences(params.number_pools(), 0),
+  m_adaptive(params.adaptive_buffer_sizes()),
+  m_pass_usage(0),
+  m_usage_history_pos(0)
+{
+  unsigned int scale;
+
+  m_min_size[attribute_size] = params.attributes_per_buffer();
+  m_min_size[index_size] = params.indices_per_buffer();
+  m_min_size[data_block_size] = params.data_blocks_per_store_buffer();
+  m_size = m_min_size;
+
+  scale = (m_adaptive) ? fastuidraw::t_max(1u, params.adaptive_buffer_max_scale()) : 1u;
+  for(unsigned int s = 0; s < number_sizes; ++s)
+    {
+      m_max_size[s] = scale * m_min_size[s];
+    }
+
+  /* the size of a data store backed by a UBO is the
+     array size of the GLSL programs, so it is fixed
+   */
+  if(m_data_store_backing == fastuidraw::gl::PainterBackendGL::data_store_ubo)
+    {
+      m_max_size[data_block_size] = m_min_size[data_block_size];
+    }
+  else
+    {
+      m_max_size[data_block_size] = fastuidraw::t_max(m_min_size[data_block_size],
+                                                      fastuidraw::t_min(max_data_blocks,
+                                                                        m_max_size[data_block_size]));
+    }
+}
+
+painter_vao_pool::
+~painter_vao_pool()
+{
+  assert(m_ubos.size() == m_vaos.size());
+  for(unsigned int p = 0, endp = m_vaos.size(); p < endp; ++p)
+    {
+      for(unsigned int i = 0, endi = m_vaos[p].size(); i < endi; ++i)
+        {
+          release_vao(m_vaos[p][i]);
+        }
+
+      if(m_ubos[p] != 0)
+        {
+          glDeleteBuffers(1, &m_ubos[p]);
+        }
+
+      if(m_fences[p] != 0)
+        {
+          glDeleteSync(m_fences[p]);
+        }
+    }
+
+  if(m_quad_index_bo != 0)
+    {
+      glDeleteBuffers(1, &m_quad_index_bo);
+    }
+
+  if(m_uniform_ring != 0)
+    {
+      glDeleteBuffers(1, &m_uniform_ring);
+    }
+
+  fastuidraw::detail::memory_report_shrink(fastuidraw::memory::subsystem_painter_backend,
+                                           0, m_gpu_bytes);
+}
+
+GLuint
+painter_vao_pool::
+request_uniform_ubo(unsigned int sz, GLenum target)
+{
+  if(m_ubos[m_pool] == 0)
+    {
+      m_ubos[m_pool] = generate_bo(target, sz);
+    }
+  else
+    {
+      glBindBuffer(target, m_ubos[m_pool]);
+    }
+
+  #ifndef NDEBUG
+    {
+      GLint psize(0);
+      glGetBufferParameteriv(target, GL_BUFFER_SIZE, &psize);
+      assert(psize >= static_cast<int>(sz));
+    }
+  #endif
+
+  return m_ubos[m_pool];
+}
+
+GLuint
+painter_vao_pool::
+request_uniform_ring_block(unsigned int sz, GLintptr *offset, void **ptr)
+{
+  assert(m_persistent_mapping);
+  if(m_uniform_ring == 0)
+    {
+      unsigned int alignment;
+
+      alignment = fastuidraw::gl::context_get<GLint>(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT);
+      alignment = fastuidraw::t_max(alignment, 1u);
+      m_uniform_ring_stride = alignment * ((sz + alignment - 1u) / alignment);
+      m_uniform_ring = generate_persistent_bo(GL_UNIFORM_BUFFER,
+                                              m_uniform_ring_stride * m_vaos.size(),
+                                              &m_uniform_ring_ptr);
+    }
+  assert(sz <= m_uniform_ring_stride);
+
+  /* the block of the pool was last read by the draws
+     of the pool number_pools() passes ago.
+   */
+  wait_pool_fence();
+
+  *offset = m_pool * m_uniform_ring_stride;
+  *ptr = static_cast<uint8_t*>(m_uniform_ring_ptr) + *offset;
+  return m_uniform_ring;
+}
+
+painter_vao
+painter_vao_pool::
+request_vao(void)
+{
+  painter_vao return_value;
+
+  if(m_current == 0)
+    {
+      wait_pool_fence();
+    }
+
+  if(m_current == m_vaos[m_pool].size())
+    {
+      m_vaos[m_pool].resize(m_current + 1);
+    }
+  else if(m_vaos[m_pool][m_current].m_number_attributes != m_size[attribute_size]
+          || m_vaos[m_pool][m_current].m_number_indices != m_size[index_size]
+          || m_vaos[m_pool][m_current].m_number_data_blocks != m_size[data_block_size])
+    {
+      release_vao(m_vaos[m_pool][m_current]);
+      m_vaos[m_pool][m_current] = painter_vao();
+    }
+
+  if(m_vaos[m_pool][m_current].m_vao == 0)
+    {
+      fastuidraw::gl::opengl_trait_value v;
+
+      glGenVertexArrays(1, &m_vaos[m_pool][m_current].m_vao);
+
+      assert(m_vaos[m_pool][m_current].m_vao != 0);
+      glBindVertexArray(m_vaos[m_pool][m_current].m_vao);
+
+      m_vaos[m_pool][m_current].m_data_store_backing = m_data_store_backing;
+
+      painter_vao &vao(m_vaos[m_pool][m_current]);
+      vao.m_number_attributes = m_size[attribute_size];
+      vao.m_number_indices = m_size[index_size];
+      vao.m_number_data_blocks = m_size[data_block_size];
+      switch(m_data_store_backing)
+        {
+        case fastuidraw::gl::PainterBackendGL::data_store_tbo:
+          {
+            vao.m_data_bo = generate_persistent_bo(GL_TEXTURE_BUFFER, data_buffer_size(vao), &vao.m_data_ptr);
+            vao.m_data_store_binding_point = m_binding_points.data_store_buffer_tbo();
+            generate_tbos(vao);
+          }
+          break;
+
+        case fastuidraw::gl::PainterBackendGL::data_store_ubo:
+          {
+            vao.m_data_bo = generate_persistent_bo(GL_ARRAY_BUFFER, data_buffer_size(vao), &vao.m_data_ptr);
+            vao.m_data_store_binding_point = m_binding_points.data_store_buffer_ubo();
+          }
+          break;
+
+        case fastuidraw::gl::PainterBackendGL::data_store_ssbo:
+          {
+            vao.m_data_bo = generate_persistent_bo(GL_SHADER_STORAGE_BUFFER, data_buffer_size(vao), &vao.m_data_ptr);
+            vao.m_data_store_binding_point = m_binding_points.data_store_buffer_ssbo();
+          }
+          break;
+        }
+
+      /* generate_persistent_bo leaves the returned buffer object
+         bound to the passed binding target.
+      */
+      vao.m_attribute_bo = generate_persistent_bo(GL_ARRAY_BUFFER, attribute_buffer_size(vao), &vao.m_attribute_ptr);
+      vao.m_index_bo = generate_persistent_bo(GL_ELEMENT_ARRAY_BUFFER, index_buffer_size(vao), &vao.m_index_ptr);
+
+      setup_attribute_slots();
+
+      vao.m_header_bo = generate_persistent_bo(GL_ARRAY_BUFFER, header_buffer_size(vao), &vao.m_header_ptr);
+      glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot);
+      v = fastuidraw::gl::opengl_trait_values<uint32_t>();
+      fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot, v);
+
+      glBindVertexArray(0);
+
+      if(m_static_attribute_bo != 0)
+        {
+          for(unsigned int L = 0; L < fastuidraw::PainterAttribute::number_layouts; ++L)
+            {
+              generate_static_vao(vao, static_cast<enum fastuidraw::PainterAttribute::layout_t>(L));
+            }
+        }
+
+      if(m_glyph_instancing)
+        {
+          generate_instanced_vao(vao);
+        }
+
+      if(m_use_indirect_draw)
+        {
+          /* the store of the buffer is specified by
+             DrawCommand::unmap_implement() because
+             only then is the number of draws known.
+           */
+          glGenBuffers(1, &vao.m_indirect_bo);
+          assert(vao.m_indirect_bo != 0);
+        }
+
+      if(m_debug_markers)
+        {
+          std::ostringstream str;
+          std::string prefix;
+
+          str << "fastuidraw: pool " << m_pool << " buffer " << m_current << " ";
+          prefix = str.str();
+          label_object(GL_VERTEX_ARRAY, vao.m_vao, prefix + "vao");
+          label_object(GL_BUFFER, vao.m_attribute_bo, prefix + "attributes");
+          label_object(GL_BUFFER, vao.m_header_bo, prefix + "headers");
+          label_object(GL_BUFFER, vao.m_index_bo, prefix + "indices");
+          label_object(GL_BUFFER, vao.m_data_bo, prefix + "data store");
+          label_object(GL_BUFFER, vao.m_indirect_bo, prefix + "indirect draws");
+        }
+    }
+
+  return_value = m_vaos[m_pool][m_current];
+  ++m_current;
+
+  return return_value;
+}
+
+void
+painter_vao_pool::
+note_usage(unsigned int attributes, unsigned int indices,
+           unsigned int data_store)
+{
+  m_pass_usage[attribute_size] += attributes;
+  m_pass_usage[index_size] += indices;
+  m_pass_usage[data_block_size] += (data_store + m_alignment - 1) / m_alignment;
+}
+
+enum painter_vao_pool::resize_t
+painter_vao_pool::
+next_pool(void)
+{
+  enum resize_t return_value(no_resize);
+
+  if(m_persistent_mapping && m_current > 0)
+    {
+      /* the fence is signaled once GL has consumed all
+         the draws that sourced from the buffers of the pool
        */
-      m_vert_shader_use_switch(false),
-      m_frag_shader_use_switch(false),
-      m_blend_shader_use_switch(false),
-      m_unpack_header_and_brush_in_frag_shader(false),
-      m_assign_layout_to_vertex_shader_inputs(true),
-      m_assign_layout_to_varyings(false),
-      m_assign_binding_points(true),
-      m_use_ubo_for_uniforms(false),
-      m_separate_program_for_discard(true),
-      m_non_dashed_stroke_shader_uses_discard(false)
-    {}
+      assert(m_fences[m_pool] == 0);
+      m_fences[m_pool] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
 
-    unsigned int m_attributes_per_buffer;
-    unsigned int m_indices_per_buffer;
-    unsigned int m_data_blocks_per_store_buffer;
-    enum fastuidraw::gl::PainterBackendGL::data_store_backing_t m_data_store_backing;
-    unsigned int m_number_pools;
-    bool m_break_on_shader_change;
-    fastuidraw::reference_counted_ptr<fastuidraw::gl::ImageAtlasGL> m_image_atlas;
-    fastuidraw::reference_counted_ptr<fastuidraw::gl::ColorStopAtlasGL> m_colorstop_atlas;
-    fastuidraw::reference_counted_ptr<fastuidraw::gl::GlyphAtlasGL> m_glyph_atlas;
-    bool m_use_hw_clip_planes;
-    bool m_vert_shader_use_switch;
-    bool m_frag_shader_use_switch;
-    bool m_blend_shader_use_switch;
-    bool m_unpack_header_and_brush_in_frag_shader;
-    bool m_assign_layout_to_vertex_shader_inputs;
-    bool m_assign_layout_to_varyings;
-    bool m_assign_binding_points;
-    bool m_use_ubo_for_uniforms;
-    bool m_separate_program_for_discard;
-    bool m_non_dashed_stroke_shader_uses_discard;
-  };
+  if(m_adaptive)
+    {
+      return_value = adapt_sizes();
+    }
+
+  ++m_pool;
+  if(m_pool == m_vaos.size())
+    {
+      m_pool = 0;
+    }
 
+  m_current = 0;
+  return return_value;
 }
 
-///////////////////////////////////////////
-// painter_vao_pool methods
+enum painter_vao_pool::resize_t
 painter_vao_pool::
-painter_vao_pool(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &params,
-                 const fastuidraw::PainterBackend::ConfigurationBase &params_base,
-                 enum fastuidraw::gl::detail::tex_buffer_support_t tex_buffer_support,
-                 const fastuidraw::glsl::PainterBackendGLSL::BindingPoints &binding_points):
-  m_attribute_buffer_size(params.attributes_per_buffer() * sizeof(fastuidraw::PainterAttribute)),
-  m_header_buffer_size(params.attributes_per_buffer() * sizeof(uint32_t)),
-  m_index_buffer_size(params.indices_per_buffer() * sizeof(fastuidraw::PainterIndex)),
-  m_alignment(params_base.alignment()),
-  m_blocks_per_data_buffer(params.data_blocks_per_store_buffer()),
-  m_data_buffer_size(m_blocks_per_data_buffer * m_alignment * sizeof(fastuidraw::generic_data)),
-  m_data_store_backing(params.data_store_backing()),
-  m_tex_buffer_support(tex_buffer_support),
-  m_binding_points(binding_points),
-  m_current(0),
-  m_pool(0),
-  m_vaos(params.number_pools()),
-  m_ubos(params.number_pools(), 0)
-{}
+adapt_sizes(void)
+{
+  sizes peak(0);
+  bool grow(false), shrink(false);
+
+  if(m_usage_history.size() < usage_history_length)
+    {
+      m_usage_history.push_back(m_pass_usage);
+    }
+  else
+    {
+      m_usage_history[m_usage_history_pos] = m_pass_usage;
+    }
+  m_usage_history_pos = (m_usage_history_pos + 1) % usage_history_length;
+  m_pass_usage = sizes(0);
+
+  for(unsigned int p = 0, endp = m_usage_history.size(); p < endp; ++p)
+    {
+      for(unsigned int s = 0; s < number_sizes; ++s)
+        {
+          peak[s] = fastuidraw::t_max(peak[s], m_usage_history[p][s]);
+        }
+    }
+
+  /* grow as soon as a pass needs more room so that the next
+     passes fit in fewer buffers, but only shrink once a full
+     history is below half of the size so that an occasional
+     light pass does not make the buffers be made again.
+   */
+  for(unsigned int s = 0; s < number_sizes; ++s)
+    {
+      unsigned int target;
+
+      target = peak[s] + peak[s] / 4u;
+      target = fastuidraw::t_max(m_min_size[s], fastuidraw::t_min(m_max_size[s], target));
+      if(target > m_size[s])
+        {
+          m_size[s] = target;
+          grow = true;
+        }
+      else if(m_usage_history.size() == usage_history_length && 2u * target < m_size[s])
+        {
+          m_size[s] = target;
+          shrink = true;
+        }
+    }
+
+  if(grow)
+    {
+      return grow_buffers;
+    }
+  return (shrink) ? shrink_buffers : no_resize;
+}
 
+
+void
 painter_vao_pool::
-~painter_vao_pool()
+setup_attribute_slots(enum fastuidraw::PainterAttribute::layout_t layout)
 {
-  assert(m_ubos.size() == m_vaos.size());
-  for(unsigned int p = 0, endp = m_vaos.size(); p < endp; ++p)
+  fastuidraw::gl::opengl_trait_value v;
+  unsigned int num_fields, stride;
+
+  /* a layout storing K fields stores them as the first K
+     fields of PainterAttribute, packed with no padding.
+   */
+  num_fields = fastuidraw::PainterAttribute::number_uvec4s(layout);
+  stride = num_fields * sizeof(fastuidraw::uvec4);
+
+  glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::primary_attrib_slot);
+  v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(stride,
+                                                             offsetof(fastuidraw::PainterAttribute, m_attrib0));
+  fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::primary_attrib_slot, v);
+
+  if(num_fields > 1)
+    {
+      glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::secondary_attrib_slot);
+      v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(stride,
+                                                                 offsetof(fastuidraw::PainterAttribute, m_attrib1));
+      fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::secondary_attrib_slot, v);
+    }
+
+  if(num_fields > 2)
+    {
+      glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::uint_attrib_slot);
+      v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(stride,
+                                                                 offsetof(fastuidraw::PainterAttribute, m_attrib2));
+      fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::uint_attrib_slot, v);
+    }
+}
+
+void
+painter_vao_pool::
+generate_static_vao(painter_vao &vao,
+                    enum fastuidraw::PainterAttribute::layout_t layout)
+{
+  fastuidraw::gl::opengl_trait_value v;
+
+  glGenVertexArrays(1, &vao.m_static_vaos[layout]);
+  assert(vao.m_static_vaos[layout] != 0);
+  glBindVertexArray(vao.m_static_vaos[layout]);
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_static_attribute_bo);
+  setup_attribute_slots(layout);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_static_index_bo);
+
+  /* each static draw is a single instance whose base instance
+     is the index into the header buffer of the header location
+   */
+  glBindBuffer(GL_ARRAY_BUFFER, vao.m_header_bo);
+  glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot);
+  v = fastuidraw::gl::opengl_trait_values<uint32_t>();
+  fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot, v);
+  glVertexAttribDivisor(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot, 1);
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void
+painter_vao_pool::
+generate_instanced_vao(painter_vao &vao)
+{
+  fastuidraw::gl::opengl_trait_value v;
+
+  if(m_quad_index_bo == 0)
+    {
+      const fastuidraw::PainterIndex quad[6] = { 0, 1, 2, 0, 2, 3 };
+
+      glGenBuffers(1, &m_quad_index_bo);
+      assert(m_quad_index_bo != 0);
+      glBindBuffer(GL_COPY_WRITE_BUFFER, m_quad_index_bo);
+      glBufferData(GL_COPY_WRITE_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+      glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+  glGenVertexArrays(1, &vao.m_instanced_vao);
+  assert(vao.m_instanced_vao != 0);
+  glBindVertexArray(vao.m_instanced_vao);
+
+  /* the attribute and the header of each instance is read once
+     per instance; the base instance of the draw gives the index
+     of the first instance into the attribute and header buffers.
+   */
+  glBindBuffer(GL_ARRAY_BUFFER, vao.m_attribute_bo);
+  setup_attribute_slots();
+  glVertexAttribDivisor(fastuidraw::glsl::PainterBackendGLSL::primary_attrib_slot, 1);
+  glVertexAttribDivisor(fastuidraw::glsl::PainterBackendGLSL::secondary_attrib_slot, 1);
+  glVertexAttribDivisor(fastuidraw::glsl::PainterBackendGLSL::uint_attrib_slot, 1);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quad_index_bo);
+
+  glBindBuffer(GL_ARRAY_BUFFER, vao.m_header_bo);
+  glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot);
+  v = fastuidraw::gl::opengl_trait_values<uint32_t>();
+  fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot, v);
+  glVertexAttribDivisor(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot, 1);
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void
+painter_vao_pool::
+generate_tbos(painter_vao &vao)
+{
+  const GLenum uint_fmts[4] =
+    {
+      GL_R32UI,
+      GL_RG32UI,
+      GL_RGB32UI,
+      GL_RGBA32UI,
+    };
+  vao.m_data_tbo = generate_tbo(vao.m_data_bo, uint_fmts[m_alignment - 1],
+                                m_binding_points.data_store_buffer_tbo());
+}
+
+GLuint
+painter_vao_pool::
+generate_tbo(GLuint src_buffer, GLenum fmt, unsigned int unit)
+{
+  GLuint return_value(0);
+
+  glGenTextures(1, &return_value);
+  assert(return_value != 0);
+
+  glActiveTexture(GL_TEXTURE0 + unit);
+  glBindTexture(GL_TEXTURE_BUFFER, return_value);
+  fastuidraw::gl::detail::tex_buffer(m_tex_buffer_support, GL_TEXTURE_BUFFER, fmt, src_buffer);
+
+  return return_value;
+}
+
+GLuint
+painter_vao_pool::
+generate_bo(GLenum bind_target, GLsizei psize)
+{
+  GLuint return_value(0);
+  glGenBuffers(1, &return_value);
+  assert(return_value != 0);
+  glBindBuffer(bind_target, return_value);
+  glBufferData(bind_target, psize, NULL, GL_STREAM_DRAW);
+  m_gpu_bytes += psize;
+  fastuidraw::detail::memory_report_grow(fastuidraw::memory::subsystem_painter_backend,
+                                         0, psize);
+  return return_value;
+}
+
+GLuint
+painter_vao_pool::
+generate_persistent_bo(GLenum bind_target, GLsizei psize, void **ptr)
+{
+  GLuint return_value(0);
+  GLbitfield flags;
+
+  if(!m_persistent_mapping)
+    {
+      *ptr = NULL;
+      return generate_bo(bind_target, psize);
+    }
+
+  flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  glGenBuffers(1, &return_value);
+  assert(return_value != 0);
+  glBindBuffer(bind_target, return_value);
+  glBufferStorage(bind_target, psize, NULL, flags);
+  *ptr = glMapBufferRange(bind_target, 0, psize, flags);
+  assert(*ptr != NULL);
+  m_gpu_bytes += psize;
+  fastuidraw::detail::memory_report_grow(fastuidraw::memory::subsystem_painter_backend,
+                                         0, psize);
+
+  return return_value;
+}
+
+void
+painter_vao_pool::
+release_vao(painter_vao &vao)
+{
+  uint64_t bytes;
+
+  if(vao.m_vao == 0)
+    {
+      return;
+    }
+
+  if(vao.m_data_tbo != 0)
+    {
+      glDeleteTextures(1, &vao.m_data_tbo);
+    }
+
+  /* deleting a buffer object that is persistently
+     mapped implicitely unmaps it, so there is no need
+     to call glUnmapBuffer() on the buffers.
+   */
+  glDeleteBuffers(1, &vao.m_attribute_bo);
+  glDeleteBuffers(1, &vao.m_header_bo);
+  glDeleteBuffers(1, &vao.m_index_bo);
+  glDeleteBuffers(1, &vao.m_data_bo);
+  glDeleteVertexArrays(1, &vao.m_vao);
+  for(unsigned int L = 0; L < fastuidraw::PainterAttribute::number_layouts; ++L)
+    {
+      if(vao.m_static_vaos[L] != 0)
+        {
+          glDeleteVertexArrays(1, &vao.m_static_vaos[L]);
+        }
+    }
+  if(vao.m_instanced_vao != 0)
+    {
+      glDeleteVertexArrays(1, &vao.m_instanced_vao);
+    }
+  if(vao.m_indirect_bo != 0)
+    {
+      glDeleteBuffers(1, &vao.m_indirect_bo);
+    }
+
+  bytes = attribute_buffer_size(vao) + header_buffer_size(vao)
+    + index_buffer_size(vao) + data_buffer_size(vao);
+  assert(bytes <= m_gpu_bytes);
+  m_gpu_bytes -= bytes;
+  fastuidraw::detail::memory_report_shrink(fastuidraw::memory::subsystem_painter_backend,
+                                           0, bytes);
+}
+
+void
+painter_vao_pool::
+wait_pool_fence(void)
+{
+  GLsync fence(m_fences[m_pool]);
+
+  if(fence == 0)
+    {
+      return;
+    }
+
+  /* The pool is only revisited after number_pools() calls to
+     next_pool(), so typically the fence is already signaled
+     and the wait returns immediately. We only block if the GPU
+     is still reading from the buffers we are about to write.
+   */
+  GLenum status;
+  status = glClientWaitSync(fence, 0, 0);
+  while(status == GL_TIMEOUT_EXPIRED)
+    {
+      const GLuint64 one_millisecond_in_ns(1000000u);
+      status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, one_millisecond_in_ns);
+    }
+  assert(status != GL_WAIT_FAILED);
+
+  glDeleteSync(fence);
+  m_fences[m_pool] = 0;
+}
+
+///////////////////////////////////////////////
+// timer_query_ring methods
+timer_query_ring::
+timer_query_ring(unsigned int number_frames):
+  m_frames(number_frames),
+  m_next(0),
+  m_current(NULL),
+  m_frame_time_ns(0)
+{
+  assert(number_frames > 0);
+}
+
+timer_query_ring::
+~timer_query_ring()
+{
+  for(std::vector<frame>::iterator iter = m_frames.begin(),
+        end = m_frames.end(); iter != end; ++iter)
+    {
+      if(iter->m_start != 0)
+        {
+          glDeleteQueries(1, &iter->m_start);
+          glDeleteQueries(1, &iter->m_end);
+        }
+      if(!iter->m_queries.empty())
+        {
+          glDeleteQueries(iter->m_queries.size(), &iter->m_queries[0]);
+        }
+    }
+}
+
+void
+timer_query_ring::
+read_results(frame &f)
+{
+  GLint available(0);
+
+  assert(f.m_pending);
+  glGetQueryObjectiv(f.m_end, GL_QUERY_RESULT_AVAILABLE, &available);
+  if(!available)
     {
-      for(unsigned int i = 0, endi = m_vaos[p].size(); i < endi; ++i)
+      return;
+    }
+
+  GLuint64 start(0), end(0);
+  glGetQueryObjectui64v(f.m_start, GL_QUERY_RESULT, &start);
+  glGetQueryObjectui64v(f.m_end, GL_QUERY_RESULT, &end);
+  m_frame_time_ns = end - start;
+
+  /* the queries of a frame are issued in order, thus
+     if the last is available then so are the others.
+   */
+  m_results.clear();
+  for(unsigned int i = 0; i < f.m_number_used; ++i)
+    {
+      GLuint64 t(0);
+      unsigned int k, endk;
+
+      glGetQueryObjectui64v(f.m_queries[i], GL_QUERY_RESULT, &t);
+      for(k = 0, endk = m_results.size(); k < endk; ++k)
         {
-          if(m_vaos[p][i].m_data_tbo != 0)
+          if(m_results[k].m_item_group == f.m_labels[i].m_item_group
+             && m_results[k].m_blend_group == f.m_labels[i].m_blend_group
+             && m_results[k].m_brush == f.m_labels[i].m_brush)
             {
-              glDeleteTextures(1, &m_vaos[p][i].m_data_tbo);
+              break;
             }
-          glDeleteBuffers(1, &m_vaos[p][i].m_attribute_bo);
-          glDeleteBuffers(1, &m_vaos[p][i].m_header_bo);
-          glDeleteBuffers(1, &m_vaos[p][i].m_index_bo);
-          glDeleteBuffers(1, &m_vaos[p][i].m_data_bo);
-          glDeleteVertexArrays(1, &m_vaos[p][i].m_vao);
         }
 
-      if(m_ubos[p] != 0)
+      if(k == m_results.size())
         {
-          glDeleteBuffers(1, &m_ubos[p]);
+          fastuidraw::gl::PainterBackendGL::TimerQueryResult R;
+          R.m_item_group = f.m_labels[i].m_item_group;
+          R.m_blend_group = f.m_labels[i].m_blend_group;
+          R.m_brush = f.m_labels[i].m_brush;
+          R.m_time_ns = 0;
+          m_results.push_back(R);
         }
+      m_results[k].m_time_ns += t;
     }
+  f.m_pending = false;
 }
 
-GLuint
-painter_vao_pool::
-request_uniform_ubo(unsigned int sz, GLenum target)
+void
+timer_query_ring::
+begin_frame(void)
 {
-  if(m_ubos[m_pool] == 0)
+  assert(m_current == NULL);
+
+  /* read the frames from oldest to newest so that
+     m_results ends up with the newest completed frame.
+   */
+  for(unsigned int i = 0, endi = m_frames.size(); i < endi; ++i)
     {
-      m_ubos[m_pool] = generate_bo(target, sz);
+      frame &f(m_frames[(m_next + i) % endi]);
+      if(f.m_pending)
+        {
+          read_results(f);
+        }
     }
-  else
+
+  frame &f(m_frames[m_next]);
+  m_next = (m_next + 1) % m_frames.size();
+  if(f.m_pending)
     {
-      glBindBuffer(target, m_ubos[m_pool]);
+      return;
     }
 
-  #ifndef NDEBUG
+  if(f.m_start == 0)
     {
-      GLint psize(0);
-      glGetBufferParameteriv(target, GL_BUFFER_SIZE, &psize);
-      assert(psize >= static_cast<int>(sz));
+      glGenQueries(1, &f.m_start);
+      glGenQueries(1, &f.m_end);
     }
-  #endif
 
-  return m_ubos[m_pool];
+  m_current = &f;
+  m_current->m_number_used = 0;
+  m_current->m_labels.clear();
+  glQueryCounter(m_current->m_start, GL_TIMESTAMP);
 }
 
-painter_vao
-painter_vao_pool::
-request_vao(void)
+void
+timer_query_ring::
+end_frame(void)
 {
-  painter_vao return_value;
-
-  if(m_current == m_vaos[m_pool].size())
+  if(m_current != NULL)
     {
-      fastuidraw::gl::opengl_trait_value v;
+      glQueryCounter(m_current->m_end, GL_TIMESTAMP);
+      m_current->m_pending = true;
+      m_current = NULL;
+    }
+}
 
-      m_vaos[m_pool].resize(m_current + 1);
-      glGenVertexArrays(1, &m_vaos[m_pool][m_current].m_vao);
+void
+timer_query_ring::
+begin_element(const shader_group_label &label)
+{
+  assert(m_current != NULL);
+  if(m_current->m_number_used == m_current->m_queries.size())
+    {
+      GLuint q(0);
+      glGenQueries(1, &q);
+      m_current->m_queries.push_back(q);
+    }
+  m_current->m_labels.push_back(label);
+  glBeginQuery(GL_TIME_ELAPSED, m_current->m_queries[m_current->m_number_used]);
+  ++m_current->m_number_used;
+}
 
-      assert(m_vaos[m_pool][m_current].m_vao != 0);
-      glBindVertexArray(m_vaos[m_pool][m_current].m_vao);
+void
+timer_query_ring::
+end_element(void)
+{
+  assert(m_current != NULL);
+  glEndQuery(GL_TIME_ELAPSED);
+}
 
-      m_vaos[m_pool][m_current].m_data_store_backing = m_data_store_backing;
+///////////////////////////////////////////////
+// RenderTargetGL methods
+RenderTargetGL::
+RenderTargetGL(fastuidraw::ivec2 dims):
+  m_dimensions(dims),
+  m_texture(0),
+  m_depth_stencil(0),
+  m_fbo(0)
+{
+  glGenTextures(1, &m_texture);
+  assert(m_texture != 0);
+  glBindTexture(GL_TEXTURE_2D, m_texture);
+  glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, dims.x(), dims.y());
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glGenRenderbuffers(1, &m_depth_stencil);
+  assert(m_depth_stencil != 0);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_depth_stencil);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, dims.x(), dims.y());
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  GLint old_fbo(0);
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &old_fbo);
+  glGenFramebuffers(1, &m_fbo);
+  assert(m_fbo != 0);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_fbo);
+  glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                         GL_TEXTURE_2D, m_texture, 0);
+  glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                            GL_RENDERBUFFER, m_depth_stencil);
+  if(glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+    {
+      /* the texture parameters are set before the handle is
+         made, since afterwards the texture is immutable.
+       */
+      m_image = fastuidraw::gl::create_bindless_image(m_texture, dims.x(), dims.y(), true);
+    }
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, old_fbo);
+}
 
-      switch(m_data_store_backing)
+RenderTargetGL::
+~RenderTargetGL()
+{
+  #ifndef FASTUIDRAW_GL_USE_GLES
+    {
+      if(m_image)
         {
-        case fastuidraw::gl::PainterBackendGL::data_store_tbo:
-          {
-            m_vaos[m_pool][m_current].m_data_bo = generate_bo(GL_TEXTURE_BUFFER, m_data_buffer_size);
-            m_vaos[m_pool][m_current].m_data_store_binding_point = m_binding_points.data_store_buffer_tbo();
-            generate_tbos(m_vaos[m_pool][m_current]);
-          }
-          break;
-
-        case fastuidraw::gl::PainterBackendGL::data_store_ubo:
-          {
-            m_vaos[m_pool][m_current].m_data_bo = generate_bo(GL_ARRAY_BUFFER, m_data_buffer_size);
-            m_vaos[m_pool][m_current].m_data_store_binding_point = m_binding_points.data_store_buffer_ubo();
-          }
-          break;
+          glMakeTextureHandleNonResidentARB(m_image->bindless_handle());
         }
+    }
+  #endif
+  glDeleteFramebuffers(1, &m_fbo);
+  glDeleteRenderbuffers(1, &m_depth_stencil);
+  glDeleteTextures(1, &m_texture);
+}
 
-      /* generate_bo leaves the returned buffer object bound to
-         the passed binding target.
-      */
-      m_vaos[m_pool][m_current].m_attribute_bo = generate_bo(GL_ARRAY_BUFFER, m_attribute_buffer_size);
-      m_vaos[m_pool][m_current].m_index_bo = generate_bo(GL_ELEMENT_ARRAY_BUFFER, m_index_buffer_size);
-
-      glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::primary_attrib_slot);
-      v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(sizeof(fastuidraw::PainterAttribute),
-                                                                 offsetof(fastuidraw::PainterAttribute, m_attrib0));
-      fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::primary_attrib_slot, v);
+fastuidraw::reference_counted_ptr<RenderTargetGL>
+RenderTargetGL::
+create(fastuidraw::ivec2 dims)
+{
+  fastuidraw::reference_counted_ptr<RenderTargetGL> return_value;
 
-      glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::secondary_attrib_slot);
-      v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(sizeof(fastuidraw::PainterAttribute),
-                                                                 offsetof(fastuidraw::PainterAttribute, m_attrib1));
-      fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::secondary_attrib_slot, v);
+  assert(dims.x() > 0 && dims.y() > 0);
+  return_value = FASTUIDRAWnew RenderTargetGL(dims);
+  if(!return_value->m_image)
+    {
+      return_value.clear();
+    }
+  return return_value;
+}
 
-      glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::uint_attrib_slot);
-      v = fastuidraw::gl::opengl_trait_values<fastuidraw::uvec4>(sizeof(fastuidraw::PainterAttribute),
-                                                                 offsetof(fastuidraw::PainterAttribute, m_attrib2));
-      fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::uint_attrib_slot, v);
+///////////////////////////////////////////////
+// gl_state_shadow methods
+void
+gl_state_shadow::
+invalidate(void)
+{
+  m_program = unknown_name;
+  m_vao = unknown_name;
+  m_active_unit = unknown_name;
+  m_textures.clear();
+  m_samplers.clear();
+  m_blend_mode_known = false;
+}
 
-      m_vaos[m_pool][m_current].m_header_bo = generate_bo(GL_ARRAY_BUFFER, m_header_buffer_size);
-      glEnableVertexAttribArray(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot);
-      v = fastuidraw::gl::opengl_trait_values<uint32_t>();
-      fastuidraw::gl::VertexAttribIPointer(fastuidraw::glsl::PainterBackendGLSL::header_attrib_slot, v);
+void
+gl_state_shadow::
+invalidate_active_texture(void)
+{
+  if(m_active_unit < m_textures.size())
+    {
+      m_textures[m_active_unit].first = GL_NONE;
+    }
+}
 
-      glBindVertexArray(0);
+void
+gl_state_shadow::
+note_atlas_resizes(uint64_t v)
+{
+  if(v != m_atlas_resizes)
+    {
+      m_textures.clear();
+      m_atlas_resizes = v;
     }
+}
 
-  return_value = m_vaos[m_pool][m_current];
-  ++m_current;
+void
+gl_state_shadow::
+use_program(fastuidraw::gl::Program *pr)
+{
+  GLuint name;
 
-  return return_value;
+  name = (pr != NULL) ? pr->name() : 0;
+  if(name != m_program)
+    {
+      glUseProgram(name);
+      m_program = name;
+    }
 }
 
 void
-painter_vao_pool::
-next_pool(void)
+gl_state_shadow::
+bind_vertex_array(GLuint vao)
 {
-  ++m_pool;
-  if(m_pool == m_vaos.size())
+  if(vao != m_vao)
     {
-      m_pool = 0;
+      glBindVertexArray(vao);
+      m_vao = vao;
     }
-
-  m_current = 0;
 }
 
-
 void
-painter_vao_pool::
-generate_tbos(painter_vao &vao)
+gl_state_shadow::
+active_texture(GLuint unit)
 {
-  const GLenum uint_fmts[4] =
+  if(unit != m_active_unit)
     {
-      GL_R32UI,
-      GL_RG32UI,
-      GL_RGB32UI,
-      GL_RGBA32UI,
-    };
-  vao.m_data_tbo = generate_tbo(vao.m_data_bo, uint_fmts[m_alignment - 1],
-                                m_binding_points.data_store_buffer_tbo());
+      glActiveTexture(GL_TEXTURE0 + unit);
+      m_active_unit = unit;
+    }
 }
 
-GLuint
-painter_vao_pool::
-generate_tbo(GLuint src_buffer, GLenum fmt, unsigned int unit)
+void
+gl_state_shadow::
+bind_texture(GLuint unit, GLenum target, GLuint texture)
 {
-  GLuint return_value(0);
+  std::pair<GLenum, GLuint> v(target, texture);
 
-  glGenTextures(1, &return_value);
-  assert(return_value != 0);
+  if(unit >= m_textures.size())
+    {
+      m_textures.resize(unit + 1, std::pair<GLenum, GLuint>(GL_NONE, 0));
+    }
 
-  glActiveTexture(GL_TEXTURE0 + unit);
-  glBindTexture(GL_TEXTURE_BUFFER, return_value);
-  fastuidraw::gl::detail::tex_buffer(m_tex_buffer_support, GL_TEXTURE_BUFFER, fmt, src_buffer);
+  if(m_textures[unit] != v)
+    {
+      active_texture(unit);
+      glBindTexture(target, texture);
+      m_textures[unit] = v;
+    }
+}
 
-  return return_value;
+void
+gl_state_shadow::
+bind_sampler(GLuint unit, GLuint sampler)
+{
+  if(unit >= m_samplers.size())
+    {
+      m_samplers.resize(unit + 1, unknown_name);
+    }
+
+  if(m_samplers[unit] != sampler)
+    {
+      glBindSampler(unit, sampler);
+      m_samplers[unit] = sampler;
+    }
 }
 
-GLuint
-painter_vao_pool::
-generate_bo(GLenum bind_target, GLsizei psize)
+bool
+gl_state_shadow::
+change_blend_mode(const fastuidraw::BlendMode &mode)
 {
-  GLuint return_value(0);
-  glGenBuffers(1, &return_value);
-  assert(return_value != 0);
-  glBindBuffer(bind_target, return_value);
-  glBufferData(bind_target, psize, NULL, GL_STREAM_DRAW);
-  return return_value;
+  fastuidraw::BlendMode::packed_value v(mode.packed());
+
+  if(m_blend_mode_known && v == m_blend_mode)
+    {
+      return false;
+    }
+  m_blend_mode_known = true;
+  m_blend_mode = v;
+  return true;
 }
 
 ///////////////////////////////////////////////
@@ -556,89 +2705,655 @@ DrawEntry(const fastuidraw::BlendMode &mode,
           unsigned int pz):
   m_blend_mode(mode),
   m_private(pr),
-  m_choice(pz)
+  m_choice(pz),
+  m_static(false),
+  m_instanced(false),
+  m_static_layout(fastuidraw::PainterAttribute::layout_full),
+  m_short_indices(false),
+  m_indirect_offset(NULL),
+  m_indirect_count(0),
+  m_max_item_id_end(0),
+  m_max_blend_id_end(0)
+{}
+
+
+DrawEntry::
+DrawEntry(const fastuidraw::BlendMode &mode):
+  m_blend_mode(mode),
+  m_private(NULL),
+  m_choice(fastuidraw::gl::PainterBackendGL::number_program_types),
+  m_static(false),
+  m_instanced(false),
+  m_static_layout(fastuidraw::PainterAttribute::layout_full),
+  m_short_indices(false),
+  m_indirect_offset(NULL),
+  m_indirect_count(0),
+  m_max_item_id_end(0),
+  m_max_blend_id_end(0)
+{}
+
+DrawEntry::
+DrawEntry(const fastuidraw::BlendMode &mode, enum static_entry_t,
+          enum fastuidraw::PainterAttribute::layout_t layout):
+  m_blend_mode(mode),
+  m_private(NULL),
+  m_choice(fastuidraw::gl::PainterBackendGL::number_program_types),
+  m_static(true),
+  m_instanced(false),
+  m_static_layout(layout),
+  m_short_indices(false),
+  m_indirect_offset(NULL),
+  m_indirect_count(0),
+  m_max_item_id_end(0),
+  m_max_blend_id_end(0)
 {}
 
+DrawEntry::
+DrawEntry(const fastuidraw::BlendMode &mode, enum instanced_entry_t):
+  m_blend_mode(mode),
+  m_private(NULL),
+  m_choice(fastuidraw::gl::PainterBackendGL::number_program_types),
+  m_static(false),
+  m_instanced(true),
+  m_static_layout(fastuidraw::PainterAttribute::layout_full),
+  m_short_indices(false),
+  m_indirect_offset(NULL),
+  m_indirect_count(0),
+  m_max_item_id_end(0),
+  m_max_blend_id_end(0)
+{}
+
+void
+DrawEntry::
+add_id_ends(unsigned int item_id_end, unsigned int blend_id_end)
+{
+  /* called before the element is added to m_counts */
+  if((item_id_end != 0 || blend_id_end != 0) && m_item_id_ends.empty())
+    {
+      m_item_id_ends.resize(m_counts.size(), 0);
+      m_blend_id_ends.resize(m_counts.size(), 0);
+    }
+
+  if(!m_item_id_ends.empty())
+    {
+      m_item_id_ends.push_back(item_id_end);
+      m_blend_id_ends.push_back(blend_id_end);
+      m_max_item_id_end = std::max(m_max_item_id_end, item_id_end);
+      m_max_blend_id_end = std::max(m_max_blend_id_end, blend_id_end);
+    }
+}
+
+void
+DrawEntry::
+add_entry(GLsizei count, const void *offset,
+          unsigned int item_id_end, unsigned int blend_id_end)
+{
+  assert(!m_static && !m_instanced);
+  add_id_ends(item_id_end, blend_id_end);
+  m_counts.push_back(count);
+  m_indices.push_back(offset);
+}
+
+void
+DrawEntry::
+add_static_entry(const StaticAttributeDataGL::chunk &chunk,
+                 GLuint base_instance, GLsizei instance_count,
+                 unsigned int item_id_end, unsigned int blend_id_end)
+{
+  assert(m_static);
+  add_id_ends(item_id_end, blend_id_end);
+  m_counts.push_back(chunk.m_count);
+  m_indices.push_back(chunk.m_offset);
+  m_base_vertices.push_back(chunk.m_base_vertex);
+  m_base_instances.push_back(base_instance);
+  m_instance_counts.push_back(instance_count);
+}
+
+void
+DrawEntry::
+add_instanced_entry(GLsizei instance_count, GLuint base_instance,
+                    unsigned int item_id_end, unsigned int blend_id_end)
+{
+  assert(m_instanced);
+  if(!m_counts.empty()
+     && m_base_instances.back() + m_instance_counts.back() == base_instance
+     && (m_item_id_ends.empty() || (m_item_id_ends.back() == item_id_end
+                                    && m_blend_id_ends.back() == blend_id_end)))
+    {
+      /* the instances continue those of the previous element */
+      m_instance_counts.back() += instance_count;
+      return;
+    }
+
+  add_id_ends(item_id_end, blend_id_end);
+  m_counts.push_back(6);
+  m_indices.push_back(NULL);
+  m_base_vertices.push_back(0);
+  m_base_instances.push_back(base_instance);
+  m_instance_counts.push_back(instance_count);
+}
+
+void
+DrawEntry::
+add_indirect_commands(std::vector<draw_elements_indirect_command> &cmds)
+{
+  const fastuidraw::PainterIndex *offset(NULL);
+  const uint16_t *short_offset(NULL);
+  unsigned int start(cmds.size());
+
+  for(unsigned int i = 0, endi = m_counts.size(); i < endi; ++i)
+    {
+      draw_elements_indirect_command cmd;
+
+      if(m_counts[i] == 0)
+        {
+          continue;
+        }
+
+      cmd.m_count = m_counts[i];
+      cmd.m_instance_count = m_instance_counts.empty() ? 1 : m_instance_counts[i];
+      cmd.m_first_index = m_short_indices ?
+        static_cast<const uint16_t*>(m_indices[i]) - short_offset :
+        static_cast<const fastuidraw::PainterIndex*>(m_indices[i]) - offset;
+      cmd.m_base_vertex = m_base_vertices.empty() ? 0 : m_base_vertices[i];
+      cmd.m_base_instance = m_base_instances.empty() ? 0 : m_base_instances[i];
+      cmds.push_back(cmd);
+    }
+
+  m_indirect_offset = static_cast<const GLvoid*>(static_cast<const char*>(NULL)
+                                                 + start * sizeof(draw_elements_indirect_command));
+  m_indirect_count = cmds.size() - start;
+}
+
+void
+DrawEntry::
+convert_to_short_indices(const fastuidraw::PainterIndex *src, uint16_t *dst)
+{
+  const fastuidraw::PainterIndex *offset(NULL);
+  const uint16_t *short_offset(NULL);
+  fastuidraw::small_vector<GLsizei, inline_elements> counts;
+  fastuidraw::small_vector<const GLvoid*, inline_elements> indices;
+  fastuidraw::small_vector<GLint, inline_elements> base_vertices;
+  fastuidraw::small_vector<unsigned int, inline_elements> item_id_ends, blend_id_ends;
+
+  if(m_static || m_instanced || m_short_indices)
+    {
+      return;
+    }
+
+  for(unsigned int i = 0, endi = m_counts.size(); i < endi; ++i)
+    {
+      unsigned int first, end, j;
+
+      first = static_cast<const fastuidraw::PainterIndex*>(m_indices[i]) - offset;
+      end = first + m_counts[i];
+      assert(m_counts[i] % 3 == 0);
+
+      if(first == end)
+        {
+          /* keep empty elements so that the entry is never empty */
+          counts.push_back(0);
+          indices.push_back(short_offset + first);
+          base_vertices.push_back(0);
+          if(!m_item_id_ends.empty())
+            {
+              item_id_ends.push_back(m_item_id_ends[i]);
+              blend_id_ends.push_back(m_blend_id_ends[i]);
+            }
+          continue;
+        }
+
+      /* grow each run a triangle at a time for as long as
+         its vertices lie within 65536 of each other
+       */
+      for(j = first; j < end;)
+        {
+          unsigned int start(j);
+          fastuidraw::PainterIndex lo(src[j]), hi(src[j]);
+
+          while(j < end)
+            {
+              fastuidraw::PainterIndex tlo, thi;
+
+              tlo = std::min(lo, std::min(src[j], std::min(src[j + 1], src[j + 2])));
+              thi = std::max(hi, std::max(src[j], std::max(src[j + 1], src[j + 2])));
+              if(thi - tlo > 0xFFFFu && j != start)
+                {
+                  break;
+                }
+              assert(thi - tlo <= 0xFFFFu);
+              lo = tlo;
+              hi = thi;
+              j += 3;
+            }
+
+          for(unsigned int k = start; k < j; ++k)
+            {
+              dst[k] = static_cast<uint16_t>(src[k] - lo);
+            }
+
+          counts.push_back(j - start);
+          indices.push_back(short_offset + start);
+          base_vertices.push_back(lo);
+          if(!m_item_id_ends.empty())
+            {
+              item_id_ends.push_back(m_item_id_ends[i]);
+              blend_id_ends.push_back(m_blend_id_ends[i]);
+            }
+        }
+    }
+
+  m_counts = counts;
+  m_indices = indices;
+  m_base_vertices = base_vertices;
+  m_item_id_ends = item_id_ends;
+  m_blend_id_ends = blend_id_ends;
+  m_short_indices = true;
+}
+
+bool
+DrawEntry::
+replaces_color(void) const
+{
+  enum fastuidraw::BlendMode::stencil_op_t op(m_blend_mode.stencil_op());
+
+  return (op == fastuidraw::BlendMode::STENCIL_OFF || op == fastuidraw::BlendMode::STENCIL_CLIP_TEST)
+    && m_blend_mode.blending_on()
+    && !m_blend_mode.is_advanced()
+    && m_blend_mode.equation_rgb() == fastuidraw::BlendMode::ADD
+    && m_blend_mode.equation_alpha() == fastuidraw::BlendMode::ADD
+    && m_blend_mode.func_src_rgb() == fastuidraw::BlendMode::ONE
+    && m_blend_mode.func_src_alpha() == fastuidraw::BlendMode::ONE
+    && m_blend_mode.func_dst_rgb() == fastuidraw::BlendMode::ZERO
+    && m_blend_mode.func_dst_alpha() == fastuidraw::BlendMode::ZERO;
+}
 
+bool
 DrawEntry::
-DrawEntry(const fastuidraw::BlendMode &mode):
-  m_blend_mode(mode),
-  m_private(NULL),
-  m_choice(fastuidraw::gl::PainterBackendGL::number_program_types)
-{}
+order_barrier(void) const
+{
+  enum fastuidraw::BlendMode::stencil_op_t op(m_blend_mode.stencil_op());
+
+  if(op != fastuidraw::BlendMode::STENCIL_OFF && op != fastuidraw::BlendMode::STENCIL_CLIP_TEST)
+    {
+      return true;
+    }
+
+  /* the occluders of clipping are drawn with the blend mode of
+     PainterEnums::blend_porter_duff_dst and with a z-value larger
+     than the draws that follow them; an opaque draw moved before
+     an occluder would not be occluded by it.
+   */
+  return m_blend_mode.blending_on()
+    && !m_blend_mode.is_advanced()
+    && m_blend_mode.func_src_rgb() == fastuidraw::BlendMode::ZERO
+    && m_blend_mode.func_src_alpha() == fastuidraw::BlendMode::ZERO
+    && m_blend_mode.func_dst_rgb() == fastuidraw::BlendMode::ONE
+    && m_blend_mode.func_dst_alpha() == fastuidraw::BlendMode::ONE;
+}
 
 void
 DrawEntry::
-add_entry(GLsizei count, const void *offset)
+reverse_elements(void)
 {
-  m_counts.push_back(count);
-  m_indices.push_back(offset);
+  assert(m_indirect_count == 0);
+  std::reverse(m_counts.begin(), m_counts.end());
+  std::reverse(m_indices.begin(), m_indices.end());
+  std::reverse(m_base_vertices.begin(), m_base_vertices.end());
+  std::reverse(m_base_instances.begin(), m_base_instances.end());
+  std::reverse(m_instance_counts.begin(), m_instance_counts.end());
+  std::reverse(m_item_id_ends.begin(), m_item_id_ends.end());
+  std::reverse(m_blend_id_ends.begin(), m_blend_id_ends.end());
 }
 
 void
 DrawEntry::
-draw(void) const
+program(PainterBackendGLPrivate *pr, unsigned int choice)
 {
-  if(m_private)
+  if(m_private == NULL)
     {
-      m_private->m_programs[m_choice]->use_program();
+      m_private = pr;
+      m_choice = choice;
     }
+}
 
-  if(m_blend_mode.blending_on())
+unsigned int
+DrawEntry::
+draw_indirect(void) const
+{
+  if(m_indirect_count > 0)
     {
-      glEnable(GL_BLEND);
-      glBlendEquationSeparate(convert_blend_op(m_blend_mode.equation_rgb()),
-                              convert_blend_op(m_blend_mode.equation_alpha()));
-      glBlendFuncSeparate(convert_blend_func(m_blend_mode.func_src_rgb()),
-                          convert_blend_func(m_blend_mode.func_dst_rgb()),
-                          convert_blend_func(m_blend_mode.func_src_alpha()),
-                          convert_blend_func(m_blend_mode.func_dst_alpha()));
+      glMultiDrawElementsIndirect(GL_TRIANGLES, index_type(),
+                                  m_indirect_offset, m_indirect_count,
+                                  sizeof(draw_elements_indirect_command));
+      return 1;
     }
-  else
+  return 0;
+}
+
+unsigned int
+DrawEntry::
+draw_base_instance(gl_state_shadow &state, GLuint vao_name,
+                   const painter_vao &vao,
+                   unsigned int ready_item_id_end,
+                   unsigned int ready_blend_id_end) const
+{
+  unsigned int return_value(0);
+
+  assert(vao_name != 0);
+  state.bind_vertex_array(vao_name);
+  if(vao.m_indirect_bo != 0 && all_elements_ready(ready_item_id_end, ready_blend_id_end))
     {
-      glDisable(GL_BLEND);
+      return draw_indirect();
     }
+
+  for(unsigned int i = 0, endi = m_counts.size(); i < endi; ++i)
+    {
+      if(element_ready(i, ready_item_id_end, ready_blend_id_end))
+        {
+          glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, m_counts[i],
+                                                        fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type,
+                                                        m_indices[i], m_instance_counts[i],
+                                                        m_base_vertices[i],
+                                                        m_base_instances[i]);
+          ++return_value;
+        }
+    }
+  return return_value;
+}
+
+unsigned int
+DrawEntry::
+draw(gl_state_shadow &state, const painter_vao &vao,
+     unsigned int ready_item_id_end,
+     unsigned int ready_blend_id_end) const
+{
+  if(m_private)
+    {
+      state.use_program(m_private->choice_program(m_choice).get());
+    }
+
+  if(state.change_blend_mode(m_blend_mode))
+    {
+      apply_blend_mode(m_blend_mode);
+    }
+  apply_stencil_op(m_blend_mode);
   assert(!m_counts.empty());
   assert(m_counts.size() == m_indices.size());
 
-  /* TODO:
-     Get rid of this unholy mess of #ifdef's here and move
-     it to an internal private function that also has a tag
-     on what to call.
-  */
+  if(m_static)
+    {
+      /* the slots of the fields that the layout does not store
+         are disabled in the VAO and so source the current value
+         of the generic attribute, which is context state and not
+         VAO state; set it to zero before each such draw.
+       */
+      if(m_static_layout != fastuidraw::PainterAttribute::layout_full)
+        {
+          glVertexAttribI4ui(fastuidraw::glsl::PainterBackendGLSL::uint_attrib_slot, 0, 0, 0, 0);
+          if(m_static_layout == fastuidraw::PainterAttribute::layout_attrib0)
+            {
+              glVertexAttribI4ui(fastuidraw::glsl::PainterBackendGLSL::secondary_attrib_slot, 0, 0, 0, 0);
+            }
+        }
+      return draw_base_instance(state, vao.m_static_vaos[m_static_layout], vao,
+                                ready_item_id_end, ready_blend_id_end);
+    }
+
+  if(m_instanced)
+    {
+      return draw_base_instance(state, vao.m_instanced_vao, vao, ready_item_id_end, ready_blend_id_end);
+    }
+
+  state.bind_vertex_array(vao.m_vao);
+
+  if(all_elements_ready(ready_item_id_end, ready_blend_id_end))
+    {
+      if(vao.m_indirect_bo != 0)
+        {
+          return draw_indirect();
+        }
+
+      if(m_short_indices)
+        {
+          return draw_short_elements(fastuidraw::make_c_array(m_counts),
+                                     fastuidraw::make_c_array(m_indices),
+                                     fastuidraw::make_c_array(m_base_vertices));
+        }
+
+      return draw_elements(fastuidraw::make_c_array(m_counts),
+                           fastuidraw::make_c_array(m_indices));
+    }
+
+  /* some elements use shaders that the current programs
+     do not yet have, skip those elements.
+   */
+  fastuidraw::small_vector<GLsizei, inline_elements> counts;
+  fastuidraw::small_vector<const GLvoid*, inline_elements> indices;
+  fastuidraw::small_vector<GLint, inline_elements> base_vertices;
+
+  assert(m_item_id_ends.size() == m_counts.size());
+  for(unsigned int i = 0, endi = m_counts.size(); i < endi; ++i)
+    {
+      if(element_ready(i, ready_item_id_end, ready_blend_id_end))
+        {
+          counts.push_back(m_counts[i]);
+          indices.push_back(m_indices[i]);
+          if(m_short_indices)
+            {
+              base_vertices.push_back(m_base_vertices[i]);
+            }
+        }
+    }
+
+  if(counts.empty())
+    {
+      return 0;
+    }
+
+  if(m_short_indices)
+    {
+      return draw_short_elements(fastuidraw::make_c_array(counts),
+                                 fastuidraw::make_c_array(indices),
+                                 fastuidraw::make_c_array(base_vertices));
+    }
+
+  return draw_elements(fastuidraw::make_c_array(counts),
+                       fastuidraw::make_c_array(indices));
+}
+
+unsigned int
+DrawEntry::
+draw_elements(fastuidraw::const_c_array<GLsizei> counts,
+              fastuidraw::const_c_array<const GLvoid*> indices)
+{
   #ifndef FASTUIDRAW_GL_USE_GLES
     {
-      glMultiDrawElements(GL_TRIANGLES, &m_counts[0],
+      glMultiDrawElements(GL_TRIANGLES, counts.c_ptr(),
                           fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type,
-                          &m_indices[0], m_counts.size());
+                          indices.c_ptr(), counts.size());
+      return 1;
     }
   #else
     {
       if(FASTUIDRAWglfunctionExists(glMultiDrawElementsEXT))
         {
-          glMultiDrawElementsEXT(GL_TRIANGLES, &m_counts[0],
+          glMultiDrawElementsEXT(GL_TRIANGLES, counts.c_ptr(),
                                  fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type,
-                                 &m_indices[0], m_counts.size());
+                                 indices.c_ptr(), counts.size());
+          return 1;
         }
       else
         {
-          for(unsigned int i = 0, endi = m_counts.size(); i < endi; ++i)
+          for(unsigned int i = 0, endi = counts.size(); i < endi; ++i)
             {
-              glDrawElements(GL_TRIANGLES, m_counts[i],
+              glDrawElements(GL_TRIANGLES, counts[i],
                              fastuidraw::gl::opengl_trait<fastuidraw::PainterIndex>::type,
-                             m_indices[i]);
+                             indices[i]);
             }
+          return counts.size();
+        }
+    }
+  #endif
+}
+
+unsigned int
+DrawEntry::
+draw_short_elements(fastuidraw::const_c_array<GLsizei> counts,
+                    fastuidraw::const_c_array<const GLvoid*> indices,
+                    fastuidraw::const_c_array<GLint> base_vertices)
+{
+  assert(counts.size() == indices.size());
+  assert(counts.size() == base_vertices.size());
+  #ifndef FASTUIDRAW_GL_USE_GLES
+    {
+      glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts.c_ptr(), GL_UNSIGNED_SHORT,
+                                    indices.c_ptr(), counts.size(),
+                                    base_vertices.c_ptr());
+      return 1;
+    }
+  #else
+    {
+      for(unsigned int i = 0, endi = counts.size(); i < endi; ++i)
+        {
+          glDrawElementsBaseVertex(GL_TRIANGLES, counts[i], GL_UNSIGNED_SHORT,
+                                   indices[i], base_vertices[i]);
         }
+      return counts.size();
     }
   #endif
 }
 
+void
+DrawEntry::
+apply_blend_mode(const fastuidraw::BlendMode &mode)
+{
+  if(mode.blending_on() && mode.is_advanced())
+    {
+      /* the advanced blend equations cannot be given to
+         glBlendEquationSeparate and ignore the blend
+         coefficients.
+       */
+      glEnable(GL_BLEND);
+      glBlendEquation(convert_blend_op(mode.equation_rgb()));
+    }
+  else if(mode.blending_on())
+    {
+      glEnable(GL_BLEND);
+      glBlendEquationSeparate(convert_blend_op(mode.equation_rgb()),
+                              convert_blend_op(mode.equation_alpha()));
+      glBlendFuncSeparate(convert_blend_func(mode.func_src_rgb()),
+                          convert_blend_func(mode.func_dst_rgb()),
+                          convert_blend_func(mode.func_src_alpha()),
+                          convert_blend_func(mode.func_dst_alpha()));
+    }
+  else
+    {
+      glDisable(GL_BLEND);
+    }
+}
+
+void
+DrawEntry::
+apply_stencil_op(const fastuidraw::BlendMode &mode)
+{
+  bool writes_color(true);
+
+  /* the draws that accumulate the winding number, clear the
+     stencil buffer or change the clipping region cover pixels
+     the fill does not, so they must not affect the color or
+     depth buffers. The clipping ops only change the stencil
+     value where the depth test passes so that they respect
+     the depth occluders drawn before them.
+   */
+  switch(mode.stencil_op())
+    {
+    case fastuidraw::BlendMode::STENCIL_OFF:
+      glDisable(GL_STENCIL_TEST);
+      break;
+
+    case fastuidraw::BlendMode::STENCIL_ADD_WINDING:
+      glEnable(GL_STENCIL_TEST);
+      glStencilFunc(GL_ALWAYS, 0, 0xFF);
+      glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
+      glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
+      writes_color = false;
+      break;
+
+    case fastuidraw::BlendMode::STENCIL_SUBTRACT_WINDING:
+      glEnable(GL_STENCIL_TEST);
+      glStencilFunc(GL_ALWAYS, 0, 0xFF);
+      glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
+      glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_INCR_WRAP);
+      writes_color = false;
+      break;
+
+    case fastuidraw::BlendMode::STENCIL_COVER_NON_ZERO:
+      glEnable(GL_STENCIL_TEST);
+      glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+      glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+      break;
+
+    case fastuidraw::BlendMode::STENCIL_COVER_ODD:
+      glEnable(GL_STENCIL_TEST);
+      glStencilFunc(GL_EQUAL, 1, 0x01);
+      glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+      break;
+
+    case fastuidraw::BlendMode::STENCIL_COVER_EVEN:
+      glEnable(GL_STENCIL_TEST);
+      glStencilFunc(GL_EQUAL, 0, 0x01);
+      glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+      break;
+
+    case fastuidraw::BlendMode::STENCIL_COVER_EQUAL:
+      glEnable(GL_STENCIL_TEST);
+      glStencilFunc(GL_EQUAL, mode.stencil_value(), 0xFF);
+      glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+      break;
+
+    case fastuidraw::BlendMode::STENCIL_CLEAR:
+      glEnable(GL_STENCIL_TEST);
+      glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+      glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+      writes_color = false;
+      break;
+
+    case fastuidraw::BlendMode::STENCIL_CLIP_TEST:
+      glEnable(GL_STENCIL_TEST);
+      glStencilFunc(GL_EQUAL, mode.stencil_value(), 0xFF);
+      glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+      break;
+
+    case fastuidraw::BlendMode::STENCIL_CLIP_INCREMENT:
+      glEnable(GL_STENCIL_TEST);
+      glStencilFunc(GL_EQUAL, mode.stencil_value(), 0xFF);
+      glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+      writes_color = false;
+      break;
+
+    case fastuidraw::BlendMode::STENCIL_CLIP_DECREMENT:
+      glEnable(GL_STENCIL_TEST);
+      glStencilFunc(GL_EQUAL, mode.stencil_value(), 0xFF);
+      glStencilOp(GL_KEEP, GL_KEEP, GL_DECR);
+      writes_color = false;
+      break;
+
+    default:
+      assert(!"Bad fastuidraw::BlendMode::stencil_op_t value");
+    }
+
+  glColorMask(writes_color, writes_color, writes_color, writes_color);
+  glDepthMask(writes_color);
+}
+
 GLenum
 DrawEntry::
 convert_blend_op(enum fastuidraw::BlendMode::op_t v)
 {
 #define C(X) case fastuidraw::BlendMode::X: return GL_FUNC_##X
 #define D(X) case fastuidraw::BlendMode::X: return GL_##X
+#define E(X) case fastuidraw::BlendMode::X: return GL_##X##_KHR
 
   switch(v)
     {
@@ -647,6 +3362,21 @@ convert_blend_op(enum fastuidraw::BlendMode::op_t v)
       C(REVERSE_SUBTRACT);
       D(MIN);
       D(MAX);
+      E(MULTIPLY);
+      E(SCREEN);
+      E(OVERLAY);
+      E(DARKEN);
+      E(LIGHTEN);
+      E(COLORDODGE);
+      E(COLORBURN);
+      E(HARDLIGHT);
+      E(SOFTLIGHT);
+      E(DIFFERENCE);
+      E(EXCLUSION);
+      E(HSL_HUE);
+      E(HSL_SATURATION);
+      E(HSL_COLOR);
+      E(HSL_LUMINOSITY);
 
     case fastuidraw::BlendMode::NUMBER_OPS:
     default:
@@ -654,6 +3384,7 @@ convert_blend_op(enum fastuidraw::BlendMode::op_t v)
     }
 #undef C
 #undef D
+#undef E
 
   assert("Invalid blend_op_t");
   return GL_INVALID_ENUM;
@@ -704,41 +3435,76 @@ DrawCommand(painter_vao_pool *hnd,
   m_pr(pr),
   m_vao(hnd->request_vao()),
   m_attributes_written(0),
-  m_indices_written(0)
+  m_indices_written(0),
+  m_current_item_id_end(0),
+  m_current_blend_id_end(0),
+  m_current_item_group(0u),
+  m_initial_choice(pr->program_choice(0u, 0u))
 {
   /* map the buffers and set to the c_array<> fields of
      fastuidraw::PainterDraw to the mapping location.
   */
   void *attr_bo, *index_bo, *data_bo, *header_bo;
-  uint32_t flags;
 
-  flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+  if(hnd->persistent_mapping())
+    {
+      /* buffers are already mapped; painter_vao_pool::request_vao()
+         has already waited for GL to finish reading from them.
+       */
+      attr_bo = m_vao.m_attribute_ptr;
+      header_bo = m_vao.m_header_ptr;
+      index_bo = m_vao.m_index_ptr;
+      data_bo = m_vao.m_data_ptr;
+    }
+  else
+    {
+      uint32_t flags;
+      flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
 
-  glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_attribute_bo);
-  attr_bo = glMapBufferRange(GL_ARRAY_BUFFER, 0, hnd->attribute_buffer_size(), flags);
-  assert(attr_bo != NULL);
+      glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_attribute_bo);
+      attr_bo = glMapBufferRange(GL_ARRAY_BUFFER, 0, hnd->attribute_buffer_size(m_vao), flags);
 
-  glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_header_bo);
-  header_bo = glMapBufferRange(GL_ARRAY_BUFFER, 0, hnd->header_buffer_size(), flags);
-  assert(header_bo != NULL);
+      glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_header_bo);
+      header_bo = glMapBufferRange(GL_ARRAY_BUFFER, 0, hnd->header_buffer_size(m_vao), flags);
 
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_vao.m_index_bo);
-  index_bo = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, hnd->index_buffer_size(), flags);
-  assert(index_bo != NULL);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_vao.m_index_bo);
+      index_bo = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, hnd->index_buffer_size(m_vao), flags);
 
-  glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_data_bo);
-  data_bo = glMapBufferRange(GL_ARRAY_BUFFER, 0, hnd->data_buffer_size(), flags);
+      glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_data_bo);
+      data_bo = glMapBufferRange(GL_ARRAY_BUFFER, 0, hnd->data_buffer_size(m_vao), flags);
+    }
+
+  assert(attr_bo != NULL);
+  assert(header_bo != NULL);
+  assert(index_bo != NULL);
   assert(data_bo != NULL);
 
   m_attributes = fastuidraw::c_array<fastuidraw::PainterAttribute>(static_cast<fastuidraw::PainterAttribute*>(attr_bo),
-                                                                 params.attributes_per_buffer());
-  m_indices = fastuidraw::c_array<fastuidraw::PainterIndex>(static_cast<fastuidraw::PainterIndex*>(index_bo),
-                                                          params.indices_per_buffer());
+                                                                 m_vao.m_number_attributes);
+  if(params.short_indices())
+    {
+      /* the buffers of a pool whose sizes adapt may hold
+         more indices than indices_per_buffer()
+       */
+      if(pr->m_short_index_staging.size() < m_vao.m_number_indices)
+        {
+          pr->m_short_index_staging.resize(m_vao.m_number_indices);
+        }
+      m_short_indices = static_cast<uint16_t*>(index_bo);
+      m_indices = fastuidraw::c_array<fastuidraw::PainterIndex>(&pr->m_short_index_staging[0],
+                                                              m_vao.m_number_indices);
+    }
+  else
+    {
+      m_short_indices = NULL;
+      m_indices = fastuidraw::c_array<fastuidraw::PainterIndex>(static_cast<fastuidraw::PainterIndex*>(index_bo),
+                                                              m_vao.m_number_indices);
+    }
   m_store = fastuidraw::c_array<fastuidraw::generic_data>(static_cast<fastuidraw::generic_data*>(data_bo),
-                                                          hnd->data_buffer_size() / sizeof(fastuidraw::generic_data));
+                                                          hnd->data_buffer_size(m_vao) / sizeof(fastuidraw::generic_data));
 
   m_header_attributes = fastuidraw::c_array<uint32_t>(static_cast<uint32_t*>(header_bo),
-                                                     params.attributes_per_buffer());
+                                                     m_vao.m_number_attributes);
 
   glBindBuffer(GL_ARRAY_BUFFER, 0);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -753,57 +3519,220 @@ draw_break(const fastuidraw::PainterShaderGroup &old_shaders,
   /* if the blend mode changes, then we need to start a new DrawEntry
    */
   fastuidraw::BlendMode::packed_value old_mode, new_mode;
-  uint32_t new_disc, old_disc;
+  unsigned int old_choice, new_choice;
+  shader_group_label new_label(new_shaders);
 
   old_mode = old_shaders.packed_blend_mode();
   new_mode = new_shaders.packed_blend_mode();
 
-  old_disc = old_shaders.item_group() & shader_group_discard_mask;
-  new_disc = new_shaders.item_group() & shader_group_discard_mask;
+  /* a change of program happens between the programs with
+     and without discard, to and from the specialized
+     programs, see ConfigurationGL::specialized_programs(),
+     and to and from the solid brush programs, see
+     ConfigurationGL::solid_brush_programs().
+   */
+  old_choice = m_pr->program_choice(old_shaders.item_group(), old_shaders.brush());
+  new_choice = m_pr->program_choice(new_shaders.item_group(), new_shaders.brush());
+
+  if(old_choice != new_choice)
+    {
+      if(!m_draws.empty())
+        {
+          add_entry(indices_written);
+        }
+      m_current_label = new_label;
+      push_draw_entry(DrawEntry(fastuidraw::BlendMode(new_mode), m_pr, new_choice));
+    }
+  else if(old_mode != new_mode)
+    {
+      if(!m_draws.empty())
+        {
+          add_entry(indices_written);
+        }
+      m_current_label = new_label;
+      push_draw_entry(fastuidraw::BlendMode(new_mode));
+    }
+  else if((m_pr->m_timer_queries != NULL || m_pr->m_params.debug_markers())
+          && new_label != m_current_label)
+    {
+      /* give the draws of each set of shaders their own
+         DrawEntry so that each is timed and labelled separately.
+       */
+      add_entry(indices_written);
+      m_current_label = new_label;
+      push_draw_entry(m_draws.back().blend_mode());
+    }
+  else
+    {
+      /* any other state changes means that we just need to add an
+         entry to the current draw entry.
+      */
+      add_entry(indices_written);
+    }
+
+  /* add_entry() above closed the range of indices drawn with
+     old_shaders, the indices that follow use new_shaders.
+   */
+  m_current_item_id_end = async_id_end(new_shaders.item_group());
+  m_current_blend_id_end = async_id_end(new_shaders.blend_group());
+  m_current_item_group = new_shaders.item_group();
+  m_current_label = new_label;
+
+  FASTUIDRAWunused(attributes_written);
+}
+
+void
+DrawCommand::
+draw_static(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData> &data,
+            unsigned int chunk, unsigned int header_attribute,
+            unsigned int number_instances,
+            unsigned int indices_written) const
+{
+  const StaticAttributeDataGL *p;
+
+  assert(dynamic_cast<const StaticAttributeDataGL*>(data.get()));
+  p = static_cast<const StaticAttributeDataGL*>(data.get());
+  assert(p->m_heap == m_pr->m_static_heap);
+  assert(chunk < p->m_chunks.size());
+
+  /* close the range of streamed indices before the static draw */
+  add_entry(indices_written);
+  if(!m_draws.back().is_static() || m_draws.back().static_layout() != p->m_layout)
+    {
+      push_draw_entry(DrawEntry(m_draws.back().blend_mode(), DrawEntry::static_entry, p->m_layout));
+    }
+  /* the header attribute has divisor 1 in the static VAO,
+     so each instance sources its own header.
+   */
+  m_draws.back().add_static_entry(p->m_chunks[chunk], header_attribute, number_instances,
+                                  m_current_item_id_end, m_current_blend_id_end);
+
+  if(m_static_data.empty() || m_static_data.back() != data)
+    {
+      m_static_data.push_back(data);
+    }
+}
+
+void
+DrawCommand::
+draw_instanced_quads(unsigned int first_attribute,
+                     unsigned int number_instances,
+                     unsigned int indices_written) const
+{
+  assert(m_vao.m_instanced_vao != 0);
+
+  /* close the range of streamed indices before the instances */
+  add_entry(indices_written);
+  if(!m_draws.back().is_instanced())
+    {
+      push_draw_entry(DrawEntry(m_draws.back().blend_mode(), DrawEntry::instanced_entry));
+    }
+  m_draws.back().add_instanced_entry(number_instances, first_attribute,
+                                     m_current_item_id_end, m_current_blend_id_end);
+}
+
+void
+DrawCommand::
+push_draw_entry(const DrawEntry &entry) const
+{
+  m_draws.push_back(entry);
+  m_draws.back().label(m_current_label);
+}
+
+void
+DrawCommand::
+upload_indirect_commands(void) const
+{
+  std::vector<draw_elements_indirect_command> &cmds(m_pr->m_indirect_commands);
+
+  cmds.clear();
+  for(std::list<DrawEntry>::iterator iter = m_draws.begin(),
+        end = m_draws.end(); iter != end; ++iter)
+    {
+      iter->add_indirect_commands(cmds);
+    }
+
+  /* orphan the previous store of the buffer; the buffer was last
+     sourced by a draw that is number_pools() frames old.
+   */
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_vao.m_indirect_bo);
+  glBufferData(GL_DRAW_INDIRECT_BUFFER,
+               cmds.size() * sizeof(draw_elements_indirect_command),
+               cmds.empty() ? NULL : &cmds[0], GL_STREAM_DRAW);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void
+DrawCommand::
+order_front_to_back(void) const
+{
+  std::list<DrawEntry>::iterator segment_begin, iter, end;
+  unsigned int choice(m_initial_choice);
+
+  /* an entry without its own program uses the program of the
+     entry drawn before it, give each entry its program before
+     the entries are moved.
+   */
+  for(iter = m_draws.begin(), end = m_draws.end(); iter != end; ++iter)
+    {
+      choice = iter->program_choice(choice);
+      iter->program(m_pr, choice);
+    }
 
-  if(old_disc != new_disc)
+  /* Painter gives each item a larger z-value than the items
+     before it, so between two order barriers the entries that
+     replace the color they draw can be drawn first and in the
+     reverse order, i.e. front to back, so that the depth test
+     rejects the fragments they hide before shading them; the
+     other entries follow in their original order.
+   */
+  segment_begin = m_draws.begin();
+  iter = m_draws.begin();
+  while(iter != end)
     {
-      unsigned int pz;
-      pz = (new_disc != 0u) ?
-        fastuidraw::gl::PainterBackendGL::program_with_discard :
-        fastuidraw::gl::PainterBackendGL::program_without_discard;
-
-      if(!m_draws.empty())
+      if(iter->order_barrier())
         {
-          add_entry(indices_written);
+          ++iter;
+          segment_begin = iter;
         }
-      m_draws.push_back(DrawEntry(fastuidraw::BlendMode(new_mode), m_pr, pz));
-    }
-  else if(old_mode != new_mode)
-    {
-      if(!m_draws.empty())
+      else if(iter->replaces_color())
         {
-          add_entry(indices_written);
+          std::list<DrawEntry>::iterator next(iter);
+
+          ++next;
+          iter->reverse_elements();
+          m_draws.splice(segment_begin, m_draws, iter);
+          segment_begin = iter;
+          iter = next;
+        }
+      else
+        {
+          ++iter;
         }
-      m_draws.push_back(fastuidraw::BlendMode(new_mode));
-    }
-  else
-    {
-      /* any other state changes means that we just need to add an
-         entry to the current draw entry.
-      */
-      add_entry(indices_written);
     }
+}
 
-  FASTUIDRAWunused(attributes_written);
+unsigned int
+DrawCommand::
+async_id_end(uint32_t group)
+{
+  return (group & shader_group_async_mask) ?
+    (group & shader_group_async_id_mask) + 1u :
+    0u;
 }
 
 void
 DrawCommand::
 draw(void) const
 {
-  glBindVertexArray(m_vao.m_vao);
+  gl_state_shadow &state(*m_pr->m_gl_state);
+
+  state.bind_vertex_array(m_vao.m_vao);
   switch(m_vao.m_data_store_backing)
     {
     case fastuidraw::gl::PainterBackendGL::data_store_tbo:
       {
-        glActiveTexture(GL_TEXTURE0 + m_vao.m_data_store_binding_point);
-        glBindTexture(GL_TEXTURE_BUFFER, m_vao.m_data_tbo);
+        state.bind_texture(m_vao.m_data_store_binding_point, GL_TEXTURE_BUFFER, m_vao.m_data_tbo);
       }
       break;
 
@@ -813,21 +3742,82 @@ draw(void) const
       }
       break;
 
+    case fastuidraw::gl::PainterBackendGL::data_store_ssbo:
+      {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_vao.m_data_store_binding_point, m_vao.m_data_bo);
+      }
+      break;
+
     default:
       assert(!"Bad value for m_vao.m_data_store_backing");
     }
 
-  if(m_pr->m_params.separate_program_for_discard())
+  /* the previous DrawCommand may have ended with another
+     program than the one of the item shader group 0.
+   */
+  if(m_pr->m_params.separate_program_for_discard()
+     || m_pr->m_params.solid_brush_programs()
+     || !m_pr->m_specialized_programs.empty())
+    {
+      state.use_program(m_pr->choice_program(m_initial_choice).get());
+    }
+
+  if(m_vao.m_indirect_bo != 0)
     {
-      m_pr->m_programs[fastuidraw::gl::PainterBackendGL::program_without_discard]->use_program();
+      glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_vao.m_indirect_bo);
+    }
+
+  bool markers(m_pr->m_params.debug_markers());
+  if(markers)
+    {
+      push_debug_group("fastuidraw: PainterDraw");
     }
 
   for(std::list<DrawEntry>::const_iterator iter = m_draws.begin(),
         end = m_draws.end(); iter != end; ++iter)
     {
-      iter->draw();
+      unsigned int num_calls;
+      bool timed;
+
+      if(markers)
+        {
+          push_debug_group(debug_group_name(iter->label(), iter->blend_mode()));
+        }
+
+      timed = m_pr->m_timer_queries != NULL && m_pr->m_timer_queries->timing();
+      if(timed)
+        {
+          m_pr->m_timer_queries->begin_element(iter->label());
+        }
+
+      num_calls = iter->draw(state, m_vao, m_pr->m_ready_item_shader_id_end,
+                             m_pr->m_ready_blend_shader_id_end);
+      FASTUIDRAWincrement_stat(m_pr->m_num_draw_calls, num_calls);
+      FASTUIDRAWunused(num_calls);
+
+      if(timed)
+        {
+          m_pr->m_timer_queries->end_element();
+        }
+
+      if(markers)
+        {
+          pop_debug_group();
+        }
+    }
+
+  if(markers)
+    {
+      pop_debug_group();
+    }
+
+  /* the VAO of the draws is unbound by on_post_draw(); the
+     next DrawCommand binds its own VAO.
+   */
+  if(m_vao.m_indirect_bo != 0)
+    {
+      glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
     }
-  glBindVertexArray(0);
 }
 
 void
@@ -839,6 +3829,35 @@ unmap_implement(unsigned int attributes_written,
   m_attributes_written = attributes_written;
   add_entry(indices_written);
   assert(m_indices_written == indices_written);
+  m_pr->m_pool->note_usage(attributes_written, indices_written, data_store_written);
+
+  if(m_short_indices != NULL)
+    {
+      for(std::list<DrawEntry>::iterator iter = m_draws.begin(),
+            end = m_draws.end(); iter != end; ++iter)
+        {
+          iter->convert_to_short_indices(&m_pr->m_short_index_staging[0], m_short_indices);
+        }
+    }
+
+  if(m_pr->m_params.opaque_front_to_back())
+    {
+      order_front_to_back();
+    }
+
+  if(m_vao.m_indirect_bo != 0)
+    {
+      upload_indirect_commands();
+    }
+
+  if(m_vao.m_attribute_ptr != NULL)
+    {
+      /* persistently mapped buffers are mapped coherent,
+         the writes are visible to GL without flushing
+         and the buffers stay mapped.
+       */
+      return;
+    }
 
   glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_attribute_bo);
   glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, attributes_written * sizeof(fastuidraw::PainterAttribute));
@@ -849,7 +3868,8 @@ unmap_implement(unsigned int attributes_written,
   glUnmapBuffer(GL_ARRAY_BUFFER);
 
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_vao.m_index_bo);
-  glFlushMappedBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, indices_written * sizeof(fastuidraw::PainterIndex));
+  glFlushMappedBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0,
+                           indices_written * (m_short_indices ? sizeof(uint16_t) : sizeof(fastuidraw::PainterIndex)));
   glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
 
   glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_data_bo);
@@ -866,13 +3886,26 @@ add_entry(unsigned int indices_written) const
 
   if(m_draws.empty())
     {
-      m_draws.push_back(fastuidraw::BlendMode());
+      push_draw_entry(fastuidraw::BlendMode());
     }
   assert(indices_written >= m_indices_written);
   count = indices_written - m_indices_written;
+
+  if(m_draws.back().is_static() || m_draws.back().is_instanced())
+    {
+      /* indices after static or instanced draws are drawn from
+         the streaming buffers with the same state as those draws
+       */
+      if(count == 0)
+        {
+          return;
+        }
+      push_draw_entry(m_draws.back().blend_mode());
+    }
   offset += m_indices_written;
-  m_draws.back().add_entry(count, offset);
+  m_draws.back().add_entry(count, offset, m_current_item_id_end, m_current_blend_id_end);
   m_indices_written = indices_written;
+  m_pr->note_item_indices(m_current_item_group, count);
 }
 
 /////////////////////////////////////////
@@ -886,7 +3919,32 @@ PainterBackendGLPrivate(const fastuidraw::gl::PainterBackendGL::ConfigurationGL
   m_number_clip_planes(0),
   m_clip_plane0(GL_INVALID_ENUM),
   m_linear_filter_sampler(0),
+  m_no_depth_buffer(false),
+  m_has_pending_programs(false),
+  m_item_shader_id_end(0),
+  m_blend_shader_id_end(0),
+  m_pending_item_shader_id_end(0),
+  m_pending_blend_shader_id_end(0),
+  m_ready_item_shader_id_end(0),
+  m_ready_blend_shader_id_end(0),
+  m_specialization_samples(0),
+  m_specialized_programs_ready(false),
+  m_current_surface(0),
   m_pool(NULL),
+  m_gl_state(NULL),
+  m_num_draw_calls(0),
+  m_bytes_uploaded_at_reset(0),
+  m_atlas_resizes_at_reset(0),
+  m_bytes_uploaded_at_pass(0),
+  m_atlas_resizes_at_pass(0),
+  m_num_mid_pass_atlas_flushes(0),
+  m_num_buffer_grows(0),
+  m_num_buffer_shrinks(0),
+  m_max_data_blocks_per_store_buffer(0),
+  m_have_invalidate_framebuffer(false),
+  m_labelled_atlas_textures(0),
+  m_timer_queries(NULL),
+  m_layer_blur(NULL),
   m_p(p)
 {
   configure_backend();
@@ -900,9 +3958,22 @@ PainterBackendGLPrivate::
       glDeleteSamplers(1, &m_linear_filter_sampler);
     }
 
-  if(m_pool != NULL)
+  for(unsigned int i = 0, endi = m_surfaces.size(); i < endi; ++i)
     {
-      FASTUIDRAWdelete(m_pool);
+      if(m_surfaces[i] != NULL)
+        {
+          FASTUIDRAWdelete(m_surfaces[i]);
+        }
+    }
+
+  if(m_timer_queries != NULL)
+    {
+      FASTUIDRAWdelete(m_timer_queries);
+    }
+
+  if(m_layer_blur != NULL)
+    {
+      FASTUIDRAWdelete(m_layer_blur);
     }
 }
 
@@ -915,11 +3986,21 @@ compute_base_config(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &par
   PainterBackend::ConfigurationBase return_value(config_base);
 
   if(params.data_store_backing() == gl::PainterBackendGL::data_store_ubo
+     || params.data_store_backing() == gl::PainterBackendGL::data_store_ssbo
      || gl::detail::compute_tex_buffer_support() == gl::detail::tex_buffer_not_supported)
     {
-      //using UBO's requires that the data store alignment is 4.
+      //using UBO's or SSBO's requires that the data store alignment is 4.
       return_value.alignment(4);
     }
+
+  if(params.solid_brush_programs())
+    {
+      /* the programs change between brushes with and without
+         brush shader bits, so every change of the brush bits
+         must break the draw.
+       */
+      return_value.brush_shader_mask(~0u);
+    }
   return return_value;
 }
 
@@ -945,9 +4026,11 @@ compute_glsl_config(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &par
     }
   #endif
 
+  return_value.rounded_rect_clipping(params.rounded_rect_clipping());
   return_value.non_dashed_stroke_shader_uses_discard(params.non_dashed_stroke_shader_uses_discard());
+  return_value.dashed_stroke_shader_uses_discard(params.dashed_stroke_shader_uses_discard());
 
-  bool have_dual_src_blending, have_framebuffer_fetch;
+  bool have_dual_src_blending, have_framebuffer_fetch, have_blend_equation_advanced;
 
   #ifdef FASTUIDRAW_GL_USE_GLES
     {
@@ -961,11 +4044,24 @@ compute_glsl_config(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &par
     }
   #endif
 
-  if(have_framebuffer_fetch && false)
+  /* the non-coherent advanced blend equations need a
+     glBlendBarrier between overlapping primitives, but
+     the draws of the uber-shader batch primitives that
+     may overlap, so only the coherent variant is used.
+   */
+  have_blend_equation_advanced = ctx.has_extension("GL_KHR_blend_equation_advanced_coherent");
+
+  if(have_framebuffer_fetch && params.w3c_blend_modes())
     {
       return_value
         .default_blend_shader_type(PainterBlendShader::framebuffer_fetch);
     }
+  else if(have_blend_equation_advanced && params.w3c_blend_modes())
+    {
+      return_value
+        .default_blend_shader_type(PainterBlendShader::single_src)
+        .blend_equation_advanced(true);
+    }
   else if(have_dual_src_blending)
     {
       return_value
@@ -980,6 +4076,124 @@ compute_glsl_config(const fastuidraw::gl::PainterBackendGL::ConfigurationGL &par
   return return_value;
 }
 
+void
+PainterBackendGLPrivate::
+select_surface(unsigned int surface)
+{
+  if(surface >= m_surfaces.size())
+    {
+      m_surfaces.resize(surface + 1, NULL);
+    }
+
+  if(m_surfaces[surface] == NULL)
+    {
+      painter_vao_pool *pool;
+
+      /* the pools of all surfaces have the sizes of m_params
+         and source the same static attribute data
+       */
+      pool = FASTUIDRAWnew painter_vao_pool(m_params, m_p->configuration_base(),
+                                            m_tex_buffer_support,
+                                            m_uber_shader_builder_params.binding_points(),
+                                            m_static_heap.get(),
+                                            m_max_data_blocks_per_store_buffer);
+      m_surfaces[surface] = FASTUIDRAWnew surface_state(pool);
+    }
+
+  m_current_surface = surface;
+  m_pool = m_surfaces[surface]->m_pool;
+  m_gl_state = &m_surfaces[surface]->m_gl_state;
+}
+
+void
+PainterBackendGLPrivate::
+label_atlas_textures(const fastuidraw::vecN<GLuint, number_atlas_textures> &textures)
+{
+  static const char *names[number_atlas_textures] =
+    {
+      "fastuidraw: ImageAtlasGL color tiles",
+      "fastuidraw: ImageAtlasGL index tiles",
+      "fastuidraw: GlyphAtlasGL texels (uint)",
+      "fastuidraw: GlyphAtlasGL texels (float)",
+      "fastuidraw: GlyphAtlasGL geometry",
+      "fastuidraw: ColorStopAtlasGL",
+    };
+
+  for(unsigned int i = 0; i < number_atlas_textures; ++i)
+    {
+      if(textures[i] != m_labelled_atlas_textures[i])
+        {
+          label_object(GL_TEXTURE, textures[i], names[i]);
+          m_labelled_atlas_textures[i] = textures[i];
+        }
+    }
+}
+
+void
+PainterBackendGLPrivate::
+label_programs(void)
+{
+  static const char *names[program_count] =
+    {
+      "all",
+      "without discard",
+      "with discard",
+    };
+
+  if(!m_params.debug_markers())
+    {
+      return;
+    }
+
+  for(unsigned int i = 0; i < program_count; ++i)
+    {
+      std::string name(names[i]);
+
+      label_object(GL_PROGRAM, m_programs[i]->name(), "fastuidraw: program " + name);
+      if(m_solid_brush_programs[i])
+        {
+          label_object(GL_PROGRAM, m_solid_brush_programs[i]->name(),
+                       "fastuidraw: solid brush program " + name);
+        }
+    }
+
+  for(unsigned int i = 0, endi = m_specialized_programs.size(); i < endi && m_specialized_programs_ready; ++i)
+    {
+      std::ostringstream str;
+      str << "fastuidraw: specialized program " << i;
+      label_object(GL_PROGRAM, m_specialized_programs[i]->name(), str.str());
+    }
+}
+
+void
+PainterBackendGLPrivate::
+invalidate_depth_stencil(void)
+{
+  GLint fbo(0);
+  fastuidraw::vecN<GLenum, 2> attachments;
+
+  if(!m_have_invalidate_framebuffer)
+    {
+      return;
+    }
+
+  /* the default framebuffer names its buffers
+     differently than a framebuffer object
+   */
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &fbo);
+  if(fbo == 0)
+    {
+      attachments[0] = GL_DEPTH;
+      attachments[1] = GL_STENCIL;
+    }
+  else
+    {
+      attachments[0] = GL_DEPTH_ATTACHMENT;
+      attachments[1] = GL_STENCIL_ATTACHMENT;
+    }
+  glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, attachments.size(), attachments.c_ptr());
+}
+
 void
 PainterBackendGLPrivate::
 configure_backend(void)
@@ -989,6 +4203,13 @@ configure_backend(void)
   m_backend_configured = true;
   m_tex_buffer_support = fastuidraw::gl::detail::compute_tex_buffer_support();
 
+  if(m_params.data_store_backing() == fastuidraw::gl::PainterBackendGL::data_store_ssbo
+     && !fastuidraw::gl::detail::data_store_ssbo_supported(m_ctx_properties))
+    {
+      // SSBO's not supported, fall back to using TBO's.
+      m_params.data_store_backing(fastuidraw::gl::PainterBackendGL::data_store_tbo);
+    }
+
   if(m_params.data_store_backing() == fastuidraw::gl::PainterBackendGL::data_store_tbo
      && m_tex_buffer_support == fastuidraw::gl::detail::tex_buffer_not_supported)
     {
@@ -1007,6 +4228,7 @@ configure_backend(void)
         max_texture_buffer_size = fastuidraw::gl::context_get<GLint>(GL_MAX_TEXTURE_BUFFER_SIZE);
         m_params.data_blocks_per_store_buffer(fastuidraw::t_min(max_texture_buffer_size,
                                                                 m_params.data_blocks_per_store_buffer()));
+        m_max_data_blocks_per_store_buffer = max_texture_buffer_size;
       }
       break;
 
@@ -1018,7 +4240,21 @@ configure_backend(void)
         max_num_blocks = max_ubo_size_bytes / block_size_bytes;
         m_params.data_blocks_per_store_buffer(fastuidraw::t_min(max_num_blocks,
                                                                 m_params.data_blocks_per_store_buffer()));
+        m_max_data_blocks_per_store_buffer = m_params.data_blocks_per_store_buffer();
+      }
+      break;
+
+    case fastuidraw::gl::PainterBackendGL::data_store_ssbo:
+      {
+        unsigned int max_ssbo_size_bytes, max_num_blocks, block_size_bytes;
+        block_size_bytes = m_p->configuration_base().alignment() * sizeof(fastuidraw::generic_data);
+        max_ssbo_size_bytes = fastuidraw::gl::context_get<GLint>(GL_MAX_SHADER_STORAGE_BLOCK_SIZE);
+        max_num_blocks = max_ssbo_size_bytes / block_size_bytes;
+        m_params.data_blocks_per_store_buffer(fastuidraw::t_min(max_num_blocks,
+                                                                m_params.data_blocks_per_store_buffer()));
+        m_max_data_blocks_per_store_buffer = max_num_blocks;
       }
+      break;
     }
 
   if(!m_params.use_hw_clip_planes())
@@ -1059,9 +4295,12 @@ configure_backend(void)
   assert(m_params.use_hw_clip_planes() == m_p->configuration_glsl().use_hw_clip_planes());
 
   /* if have to use discard for clipping, then there is zero point to
-     separate the discarding and non-discarding item shaders.
+     separate the discarding and non-discarding item shaders; the
+     corners of a rounded rect clipping are also clipped by discard.
   */
-  m_params.separate_program_for_discard(m_params.separate_program_for_discard() && m_params.use_hw_clip_planes());
+  m_params.separate_program_for_discard(m_params.separate_program_for_discard()
+                                        && m_params.use_hw_clip_planes()
+                                        && !m_params.rounded_rect_clipping());
 
   fastuidraw::gl::ColorStopAtlasGL *color;
   assert(dynamic_cast<fastuidraw::gl::ColorStopAtlasGL*>(m_params.colorstop_atlas().get()));
@@ -1095,17 +4334,187 @@ configure_backend(void)
     }
   #else
     {
-      if(m_ctx_properties.version() < fastuidraw::ivec2(4, 2))
-        {
-          m_params.assign_layout_to_varyings(m_params.assign_layout_to_varyings()
-                                             && m_ctx_properties.has_extension("GL_ARB_separate_shader_objects"));
-          m_params.assign_binding_points(m_params.assign_binding_points()
-                                         && m_ctx_properties.has_extension("GL_ARB_shading_language_420pack"));
-        }
+      if(m_ctx_properties.version() < fastuidraw::ivec2(4, 2))
+        {
+          m_params.assign_layout_to_varyings(m_params.assign_layout_to_varyings()
+                                             && m_ctx_properties.has_extension("GL_ARB_separate_shader_objects"));
+          m_params.assign_binding_points(m_params.assign_binding_points()
+                                         && m_ctx_properties.has_extension("GL_ARB_shading_language_420pack"));
+        }
+    }
+  #endif
+
+  /* persistent mapping requires immutable buffer storage,
+     core in GL version 4.4, for GLES requires GL_EXT_buffer_storage.
+   */
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      m_params.persistent_mapped_buffers(m_params.persistent_mapped_buffers()
+                                         && m_ctx_properties.has_extension("GL_EXT_buffer_storage"));
+    }
+  #else
+    {
+      m_params.persistent_mapped_buffers(m_params.persistent_mapped_buffers()
+                                         && (m_ctx_properties.version() >= fastuidraw::ivec2(4, 4)
+                                             || m_ctx_properties.has_extension("GL_ARB_buffer_storage")));
+    }
+  #endif
+
+  /* asynchronous rebuild only makes sense if GL can compile
+     and link without blocking the calling thread.
+   */
+  m_params.async_program_rebuild(m_params.async_program_rebuild()
+                                 && (m_ctx_properties.has_extension("GL_KHR_parallel_shader_compile")
+                                     || m_ctx_properties.has_extension("GL_ARB_parallel_shader_compile")));
+
+  /* static attribute data selects the header location with
+     the base instance of the draw.
+   */
+  bool have_base_instance;
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      have_base_instance = m_ctx_properties.has_extension("GL_EXT_base_instance");
+    }
+  #else
+    {
+      have_base_instance = m_ctx_properties.version() >= fastuidraw::ivec2(4, 2)
+        || m_ctx_properties.has_extension("GL_ARB_base_instance");
+    }
+  #endif
+
+  /* glyph instances are also selected by the base instance */
+  m_params.glyph_instancing(m_params.glyph_instancing() && have_base_instance);
+
+  if(!have_base_instance
+     || m_params.static_attributes_per_heap() == 0
+     || m_params.static_indices_per_heap() == 0)
+    {
+      m_params
+        .static_attributes_per_heap(0)
+        .static_indices_per_heap(0);
+    }
+
+  /* short indices are drawn relative to a base vertex */
+  bool have_base_vertex;
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      have_base_vertex = m_ctx_properties.version() >= fastuidraw::ivec2(3, 2)
+        || m_ctx_properties.has_extension("GL_OES_draw_elements_base_vertex")
+        || m_ctx_properties.has_extension("GL_EXT_draw_elements_base_vertex");
+    }
+  #else
+    {
+      have_base_vertex = m_ctx_properties.version() >= fastuidraw::ivec2(3, 2)
+        || m_ctx_properties.has_extension("GL_ARB_draw_elements_base_vertex");
+    }
+  #endif
+  m_params.short_indices(m_params.short_indices() && have_base_vertex);
+
+  /* only with the single_src blend shaders does the BlendMode
+     of a draw tell if it replaces the color it covers: with
+     dual_src every Porter-Duff mode uses the same BlendMode
+     and with framebuffer_fetch blending is always off.
+   */
+  m_params.opaque_front_to_back(m_params.opaque_front_to_back()
+                                && m_p->configuration_glsl().default_blend_shader_type() == fastuidraw::PainterBlendShader::single_src);
+
+  /* glMultiDrawElementsIndirect is core in GL 4.3, for
+     GLES requires GL_EXT_multi_draw_indirect.
+   */
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      m_params.use_indirect_draw(m_params.use_indirect_draw()
+                                 && m_ctx_properties.has_extension("GL_EXT_multi_draw_indirect"));
+    }
+  #else
+    {
+      m_params.use_indirect_draw(m_params.use_indirect_draw()
+                                 && (m_ctx_properties.version() >= fastuidraw::ivec2(4, 3)
+                                     || m_ctx_properties.has_extension("GL_ARB_multi_draw_indirect")));
+    }
+  #endif
+
+  /* glInvalidateFramebuffer is core in GLES 3.0 and GL 4.3 */
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      m_have_invalidate_framebuffer = m_ctx_properties.version() >= fastuidraw::ivec2(3, 0);
+    }
+  #else
+    {
+      m_have_invalidate_framebuffer = m_ctx_properties.version() >= fastuidraw::ivec2(4, 3)
+        || m_ctx_properties.has_extension("GL_ARB_invalidate_subdata");
+    }
+  #endif
+
+  /* the functions of GL_KHR_debug are core in GL 4.3; for
+     GLES we use the KHR suffixed functions of the extension.
+   */
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      if(!m_ctx_properties.has_extension("GL_KHR_debug"))
+        {
+          m_params.debug_markers(false);
+        }
+    }
+  #else
+    {
+      if(m_ctx_properties.version() < fastuidraw::ivec2(4, 3)
+         && !m_ctx_properties.has_extension("GL_KHR_debug"))
+        {
+          m_params.debug_markers(false);
+        }
+    }
+  #endif
+
+  /* GL_TIMESTAMP queries are core in GL 3.3; for GLES they
+     require GL_EXT_disjoint_timer_query which we do not use.
+   */
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      m_params.timer_query_frames(0);
+    }
+  #else
+    {
+      if(m_ctx_properties.version() < fastuidraw::ivec2(3, 3)
+         && !m_ctx_properties.has_extension("GL_ARB_timer_query"))
+        {
+          m_params.timer_query_frames(0);
+        }
+    }
+  #endif
+
+  /* bindless textures are only supported for GL
+     by GL_ARB_bindless_texture.
+   */
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      m_params.bindless_images(false);
+    }
+  #else
+    {
+      m_params.bindless_images(m_params.bindless_images()
+                               && m_ctx_properties.has_extension("GL_ARB_bindless_texture"));
     }
   #endif
 
+  /* external textures are sampled through a samplerExternalOES
+     made from a bindless handle.
+   */
+  if(m_ctx_properties.has_extension("GL_OES_EGL_image_external_essl3"))
+    {
+      m_external_texture_extension = "GL_OES_EGL_image_external_essl3";
+    }
+  else if(m_ctx_properties.has_extension("GL_OES_EGL_image_external"))
+    {
+      m_external_texture_extension = "GL_OES_EGL_image_external";
+    }
+  m_params.external_texture_images(m_params.external_texture_images()
+                                   && m_params.bindless_images()
+                                   && !m_external_texture_extension.empty());
+
   m_uber_shader_builder_params
+    .bindless_images(m_params.bindless_images())
+    .external_texture_images(m_params.external_texture_images())
     .assign_layout_to_vertex_shader_inputs(m_params.assign_layout_to_vertex_shader_inputs())
     .assign_layout_to_varyings(m_params.assign_layout_to_varyings())
     .assign_binding_points(m_params.assign_binding_points())
@@ -1116,19 +4525,32 @@ configure_backend(void)
     .frag_shader_use_switch(m_params.frag_shader_use_switch())
     .blend_shader_use_switch(m_params.blend_shader_use_switch())
     .unpack_header_and_brush_in_frag_shader(m_params.unpack_header_and_brush_in_frag_shader())
+    .pack_varyings(m_params.pack_varyings())
     .data_store_backing(m_params.data_store_backing())
     .data_blocks_per_store_buffer(m_params.data_blocks_per_store_buffer())
     .glyph_geometry_backing(m_params.glyph_atlas()->param_values().glyph_geometry_backing_store_type())
     .glyph_geometry_backing_log2_dims(m_params.glyph_atlas()->param_values().texture_2d_array_geometry_store_log2_dims())
     .have_float_glyph_texture_atlas(m_params.glyph_atlas()->texel_texture(false) != 0)
     .colorstop_atlas_backing(colorstop_tp)
-    .blend_type(m_p->configuration_glsl().default_blend_shader_type());
+    .blend_type(m_p->configuration_glsl().default_blend_shader_type())
+    .precision_policy(m_params.precision_policy());
 
   /* now allocate m_pool after adjusting m_params
    */
-  m_pool = FASTUIDRAWnew painter_vao_pool(m_params, m_p->configuration_base(),
-                                          m_tex_buffer_support,
-                                          m_uber_shader_builder_params.binding_points());
+  if(m_params.static_attributes_per_heap() > 0)
+    {
+      m_static_heap = FASTUIDRAWnew static_attribute_heap(m_params.static_attributes_per_heap(),
+                                                          m_params.static_indices_per_heap());
+    }
+  if(m_params.short_indices())
+    {
+      m_short_index_staging.resize(m_params.indices_per_buffer());
+    }
+  select_surface(0);
+  if(m_params.timer_query_frames() > 0)
+    {
+      m_timer_queries = FASTUIDRAWnew timer_query_ring(m_params.timer_query_frames());
+    }
 
   configure_source_front_matter();
 }
@@ -1173,6 +4595,10 @@ configure_source_front_matter(void)
             m_initializer.add_uniform_block_binding("fastuidraw_painterStore_ubo", binding_points.data_store_buffer_ubo());
           }
           break;
+
+        case PainterBackendGLSL::data_store_ssbo:
+          /* the GLSL code always has the binding of the SSBO */
+          break;
         }
     }
 
@@ -1240,7 +4666,13 @@ configure_source_front_matter(void)
         && (m_uber_shader_builder_params.assign_layout_to_varyings()
             || m_uber_shader_builder_params.assign_binding_points());
 
-      if(using_glsl42)
+      if(m_params.data_store_backing() == fastuidraw::gl::PainterBackendGL::data_store_ssbo)
+        {
+          /* configure_backend() made sure that the GL version is atleast 4.3 */
+          m_front_matter_vert.specify_version("430");
+          m_front_matter_frag.specify_version("430");
+        }
+      else if(using_glsl42)
         {
           m_front_matter_vert.specify_version("420");
           m_front_matter_frag.specify_version("420");
@@ -1262,9 +4694,36 @@ configure_source_front_matter(void)
               m_front_matter_frag.specify_extension("GL_ARB_shading_language_420pack", ShaderSource::require_extension);
             }
         }
+
+      if(m_uber_shader_builder_params.bindless_images())
+        {
+          m_front_matter_frag.specify_extension("GL_ARB_bindless_texture", ShaderSource::require_extension);
+        }
+
+      if(m_uber_shader_builder_params.external_texture_images())
+        {
+          m_front_matter_frag.specify_extension(m_external_texture_extension.c_str(),
+                                                ShaderSource::require_extension);
+        }
     }
   #endif
 
+  if(m_p->configuration_glsl().default_blend_shader_type() == fastuidraw::PainterBlendShader::framebuffer_fetch)
+    {
+      m_front_matter_frag.specify_extension("GL_EXT_shader_framebuffer_fetch", ShaderSource::require_extension);
+    }
+  else if(m_p->configuration_glsl().blend_equation_advanced()
+          && m_p->configuration_glsl().default_blend_shader_type() == fastuidraw::PainterBlendShader::single_src)
+    {
+      /* the advanced blend equations are core in GLES 3.2, for
+         which the extension might not be listed.
+       */
+      if(m_ctx_properties.has_extension("GL_KHR_blend_equation_advanced"))
+        {
+          m_front_matter_frag.specify_extension("GL_KHR_blend_equation_advanced", ShaderSource::require_extension);
+        }
+      m_front_matter_frag.add_source("layout(blend_support_all_equations) out;\n", ShaderSource::from_string);
+    }
 }
 
 const PainterBackendGLPrivate::program_set&
@@ -1273,7 +4732,19 @@ programs(bool rebuild)
 {
   if(rebuild)
     {
-      build_programs();
+      if(m_params.async_program_rebuild() && m_programs[0])
+        {
+          start_pending_programs();
+        }
+      else
+        {
+          build_programs();
+        }
+    }
+
+  if(m_has_pending_programs)
+    {
+      promote_pending_programs();
     }
   return m_programs;
 }
@@ -1287,8 +4758,113 @@ build_programs(void)
       enum fastuidraw::gl::PainterBackendGL::program_type_t tp;
       tp = static_cast<enum fastuidraw::gl::PainterBackendGL::program_type_t>(i);
       m_programs[tp] = build_program(tp);
-      m_shader_uniforms_loc[tp] = m_programs[tp]->uniform_location("fastuidraw_shader_uniforms");
+      if(m_params.solid_brush_programs())
+        {
+          m_solid_brush_programs[tp] = build_program(tp, true);
+        }
+    }
+
+  for(unsigned int i = 0, endi = m_specialized_shaders.size(); i < endi; ++i)
+    {
+      m_specialized_programs[i] = build_specialized_program(i);
+    }
+  m_specialized_programs_ready = !m_specialized_shaders.empty();
+
+  /* a synchronous build supersedes any pending build */
+  m_has_pending_programs = false;
+  m_pending_programs = program_set();
+  m_pending_solid_brush_programs = program_set();
+  m_pending_specialized_programs.clear();
+  m_ready_item_shader_id_end = m_item_shader_id_end;
+  m_ready_blend_shader_id_end = m_blend_shader_id_end;
+  set_program_uniform_locations();
+}
+
+void
+PainterBackendGLPrivate::
+start_pending_programs(void)
+{
+  /* if a build is already pending, it is abandoned
+     since it does not have the latest shaders.
+   */
+  for(unsigned int i = 0; i < fastuidraw::gl::PainterBackendGL::number_program_types; ++i)
+    {
+      enum fastuidraw::gl::PainterBackendGL::program_type_t tp;
+      tp = static_cast<enum fastuidraw::gl::PainterBackendGL::program_type_t>(i);
+      m_pending_programs[tp] = build_program(tp);
+      m_pending_programs[tp]->start_build();
+      if(m_params.solid_brush_programs())
+        {
+          m_pending_solid_brush_programs[tp] = build_program(tp, true);
+          m_pending_solid_brush_programs[tp]->start_build();
+        }
+    }
+
+  m_pending_specialized_programs.resize(m_specialized_shaders.size());
+  for(unsigned int i = 0, endi = m_specialized_shaders.size(); i < endi; ++i)
+    {
+      m_pending_specialized_programs[i] = build_specialized_program(i);
+      m_pending_specialized_programs[i]->start_build();
+    }
+  m_has_pending_programs = true;
+  m_pending_item_shader_id_end = m_item_shader_id_end;
+  m_pending_blend_shader_id_end = m_blend_shader_id_end;
+}
+
+void
+PainterBackendGLPrivate::
+promote_pending_programs(void)
+{
+  for(unsigned int i = 0; i < fastuidraw::gl::PainterBackendGL::number_program_types; ++i)
+    {
+      if(!m_pending_programs[i]->build_ready()
+         || (m_pending_solid_brush_programs[i] && !m_pending_solid_brush_programs[i]->build_ready()))
+        {
+          return;
+        }
+    }
+
+  for(unsigned int i = 0, endi = m_pending_specialized_programs.size(); i < endi; ++i)
+    {
+      if(!m_pending_specialized_programs[i]->build_ready())
+        {
+          return;
+        }
+    }
+
+  m_programs = m_pending_programs;
+  m_pending_programs = program_set();
+  if(m_params.solid_brush_programs())
+    {
+      m_solid_brush_programs = m_pending_solid_brush_programs;
+      m_pending_solid_brush_programs = program_set();
+    }
+  if(!m_pending_specialized_programs.empty())
+    {
+      m_specialized_programs.swap(m_pending_specialized_programs);
+      m_pending_specialized_programs.clear();
+      m_specialized_programs_ready = true;
+    }
+  m_has_pending_programs = false;
+  m_ready_item_shader_id_end = m_pending_item_shader_id_end;
+  m_ready_blend_shader_id_end = m_pending_blend_shader_id_end;
+  set_program_uniform_locations();
+}
+
+void
+PainterBackendGLPrivate::
+set_program_uniform_locations(void)
+{
+  for(unsigned int i = 0; i < fastuidraw::gl::PainterBackendGL::number_program_types; ++i)
+    {
+      m_shader_uniforms_loc[i] = m_programs[i]->uniform_location("fastuidraw_shader_uniforms");
+      if(m_solid_brush_programs[i])
+        {
+          m_solid_brush_uniforms_loc[i] = m_solid_brush_programs[i]->uniform_location("fastuidraw_shader_uniforms");
+        }
     }
+  set_specialized_program_uniform_locations();
+  label_programs();
 
   if(!m_uber_shader_builder_params.use_ubo_for_uniforms())
     {
@@ -1297,12 +4873,39 @@ build_programs(void)
     }
 }
 
+uint32_t
+PainterBackendGLPrivate::
+compute_async_group(fastuidraw::PainterShader::Tag tag,
+                    unsigned int number_sub_shaders,
+                    unsigned int *id_end)
+{
+  *id_end = std::max(*id_end, tag.m_ID + std::max(1u, number_sub_shaders));
+
+  /* shaders registered before the programs are first built are
+     always in the programs; those registered after can only be
+     used once the rebuilt programs are ready, so they are given
+     their own group to place them in their own draw elements.
+   */
+  if(m_params.async_program_rebuild() && m_programs[0])
+    {
+      assert((tag.m_ID & ~shader_group_async_id_mask) == 0u);
+      return shader_group_async_mask | tag.m_ID;
+    }
+  return 0u;
+}
+
 PainterBackendGLPrivate::program_ref
 PainterBackendGLPrivate::
 build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp)
 {
-  fastuidraw::glsl::ShaderSource vert, frag;
-  program_ref return_value;
+  return build_program(tp, false);
+}
+
+PainterBackendGLPrivate::program_ref
+PainterBackendGLPrivate::
+build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp,
+              bool solid_brush)
+{
   DiscardItemShaderFilter item_filter(tp);
   const char *discard_macro;
 
@@ -1314,6 +4917,29 @@ build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp)
     {
       discard_macro = "discard";
     }
+  return build_program(&item_filter, discard_macro, solid_brush);
+}
+
+PainterBackendGLPrivate::program_ref
+PainterBackendGLPrivate::
+build_specialized_program(unsigned int I)
+{
+  const fastuidraw::glsl::PainterItemShaderGLSL *sh;
+  SpecializedItemShaderFilter item_filter(m_specialized_shaders[I]);
+
+  assert(I < m_specialized_shaders.size());
+  assert(dynamic_cast<const fastuidraw::glsl::PainterItemShaderGLSL*>(m_specialized_shaders[I]));
+  sh = static_cast<const fastuidraw::glsl::PainterItemShaderGLSL*>(m_specialized_shaders[I]);
+  return build_program(&item_filter, sh->uses_discard() ? "discard" : "fastuidraw_do_nothing()");
+}
+
+PainterBackendGLPrivate::program_ref
+PainterBackendGLPrivate::
+build_program(const fastuidraw::glsl::PainterBackendGLSL::ItemShaderFilter *item_filter,
+              const char *discard_macro, bool solid_brush)
+{
+  fastuidraw::glsl::ShaderSource vert, frag;
+  program_ref return_value;
 
   vert
     .specify_version(m_front_matter_vert.version())
@@ -1325,13 +4951,247 @@ build_program(enum fastuidraw::gl::PainterBackendGL::program_type_t tp)
     .specify_extensions(m_front_matter_frag)
     .add_source(m_front_matter_frag);
 
-  m_p->construct_shader(vert, frag, m_uber_shader_builder_params, &item_filter, discard_macro);
+  if(solid_brush)
+    {
+      vert.add_macro("FASTUIDRAW_PAINTER_BRUSH_SOLID");
+      frag.add_macro("FASTUIDRAW_PAINTER_BRUSH_SOLID");
+    }
+
+  m_p->construct_shader(vert, frag, m_uber_shader_builder_params, item_filter, discard_macro);
   return_value = FASTUIDRAWnew fastuidraw::gl::Program(vert, frag,
                                                        m_attribute_binder,
-                                                       m_initializer);
+                                                       m_initializer,
+                                                       m_params.program_binary_cache());
   return return_value;
 }
 
+void
+PainterBackendGLPrivate::
+note_item_shader(fastuidraw::PainterShader::Tag tag,
+                 const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader)
+{
+  const fastuidraw::PainterShader *parent;
+  unsigned int end;
+
+  if(m_params.specialized_programs() == 0)
+    {
+      return;
+    }
+
+  if(shader->parent())
+    {
+      parent = shader->parent().get();
+      end = tag.m_ID + 1;
+    }
+  else
+    {
+      parent = shader.get();
+      end = tag.m_ID + std::max(1u, shader->number_sub_shaders());
+    }
+
+  if(end > m_item_shader_of_id.size())
+    {
+      m_item_shader_of_id.resize(end, NULL);
+    }
+
+  for(unsigned int ID = tag.m_ID; ID < end; ++ID)
+    {
+      m_item_shader_of_id[ID] = parent;
+    }
+}
+
+void
+PainterBackendGLPrivate::
+note_item_indices(uint32_t item_group, unsigned int count)
+{
+  /* the item shader ID is in the group, see
+     PainterBackendGL::compute_item_shader_group()
+   */
+  uint32_t ID(item_group & shader_group_async_id_mask);
+
+  if(m_params.specialized_programs() == 0
+     || m_specialization_samples >= specialization_sample_draws
+     || count == 0)
+    {
+      return;
+    }
+
+  if(ID >= m_item_indices_drawn.size())
+    {
+      m_item_indices_drawn.resize(ID + 1, 0);
+    }
+  m_item_indices_drawn[ID] += count;
+}
+
+namespace
+{
+  bool
+  compare_indices_drawn(const std::pair<uint64_t, const fastuidraw::PainterShader*> &lhs,
+                        const std::pair<uint64_t, const fastuidraw::PainterShader*> &rhs)
+  {
+    return lhs.first > rhs.first;
+  }
+}
+
+void
+PainterBackendGLPrivate::
+choose_specialized_programs(void)
+{
+  if(m_params.specialized_programs() == 0
+     || m_specialization_samples >= specialization_sample_draws)
+    {
+      return;
+    }
+
+  ++m_specialization_samples;
+  if(m_specialization_samples < specialization_sample_draws)
+    {
+      return;
+    }
+
+  /* sum the indices drawn by each parent shader */
+  std::vector<std::pair<uint64_t, const fastuidraw::PainterShader*> > drawn;
+  uint64_t total(0);
+
+  for(unsigned int ID = 0, endID = std::min(m_item_indices_drawn.size(), m_item_shader_of_id.size());
+      ID < endID; ++ID)
+    {
+      const fastuidraw::PainterShader *sh(m_item_shader_of_id[ID]);
+      unsigned int k;
+
+      if(sh == NULL || m_item_indices_drawn[ID] == 0)
+        {
+          continue;
+        }
+
+      total += m_item_indices_drawn[ID];
+      for(k = 0; k < drawn.size() && drawn[k].second != sh; ++k)
+        {}
+
+      if(k == drawn.size())
+        {
+          drawn.push_back(std::make_pair(uint64_t(0), sh));
+        }
+      drawn[k].first += m_item_indices_drawn[ID];
+    }
+  std::vector<uint64_t>().swap(m_item_indices_drawn);
+
+  std::stable_sort(drawn.begin(), drawn.end(), compare_indices_drawn);
+  for(unsigned int i = 0; i < drawn.size()
+        && m_specialized_shaders.size() < m_params.specialized_programs()
+        && drawn[i].first * specialization_min_share_recip >= total; ++i)
+    {
+      m_specialized_shaders.push_back(drawn[i].second);
+    }
+
+  if(m_specialized_shaders.empty())
+    {
+      return;
+    }
+
+  m_specialized_program_of_id.resize(m_item_shader_of_id.size(), -1);
+  for(unsigned int ID = 0, endID = m_item_shader_of_id.size(); ID < endID; ++ID)
+    {
+      for(unsigned int k = 0; k < m_specialized_shaders.size(); ++k)
+        {
+          if(m_item_shader_of_id[ID] == m_specialized_shaders[k])
+            {
+              m_specialized_program_of_id[ID] = k;
+            }
+        }
+    }
+
+  m_specialized_programs.resize(m_specialized_shaders.size());
+  for(unsigned int i = 0, endi = m_specialized_shaders.size(); i < endi; ++i)
+    {
+      m_specialized_programs[i] = build_specialized_program(i);
+      if(m_params.async_program_rebuild())
+        {
+          m_specialized_programs[i]->start_build();
+        }
+    }
+
+  /* when building asynchronously, the programs are
+     used once check_specialized_programs_ready() finds
+     all of them built.
+   */
+  m_specialized_programs_ready = false;
+  check_specialized_programs_ready();
+}
+
+void
+PainterBackendGLPrivate::
+check_specialized_programs_ready(void)
+{
+  if(m_specialized_programs_ready || m_specialized_programs.empty())
+    {
+      return;
+    }
+
+  if(m_params.async_program_rebuild())
+    {
+      for(unsigned int i = 0, endi = m_specialized_programs.size(); i < endi; ++i)
+        {
+          if(!m_specialized_programs[i]->build_ready())
+            {
+              return;
+            }
+        }
+    }
+  m_specialized_programs_ready = true;
+  set_specialized_program_uniform_locations();
+  label_programs();
+}
+
+void
+PainterBackendGLPrivate::
+set_specialized_program_uniform_locations(void)
+{
+  if(!m_specialized_programs_ready)
+    {
+      return;
+    }
+
+  m_specialized_uniforms_loc.resize(m_specialized_programs.size());
+  for(unsigned int i = 0, endi = m_specialized_programs.size(); i < endi; ++i)
+    {
+      m_specialized_uniforms_loc[i] = m_specialized_programs[i]->uniform_location("fastuidraw_shader_uniforms");
+    }
+}
+
+unsigned int
+PainterBackendGLPrivate::
+program_choice(uint32_t item_group, uint32_t brush) const
+{
+  /* shaders registered while the programs are rebuilt
+     asynchronously are not in the specialized programs
+   */
+  if(m_specialized_programs_ready && (item_group & shader_group_async_mask) == 0u)
+    {
+      uint32_t ID(item_group & shader_group_async_id_mask);
+      if(ID < m_specialized_program_of_id.size() && m_specialized_program_of_id[ID] >= 0)
+        {
+          return fastuidraw::gl::PainterBackendGL::number_program_types + m_specialized_program_of_id[ID];
+        }
+    }
+
+  unsigned int return_value;
+  uint32_t solid;
+
+  solid = (brush == 0u && m_solid_brush_programs[0]) ? uint32_t(choice_solid_brush_bit) : 0u;
+  if(m_params.separate_program_for_discard())
+    {
+      return_value = (item_group & shader_group_discard_mask) ?
+        fastuidraw::gl::PainterBackendGL::program_with_discard :
+        fastuidraw::gl::PainterBackendGL::program_without_discard;
+    }
+  else
+    {
+      return_value = fastuidraw::gl::PainterBackendGL::program_all;
+    }
+  return return_value | solid;
+}
+
 ///////////////////////////////////////////////
 // fastuidraw::gl::PainterBackendGL::ConfigurationGL methods
 fastuidraw::gl::PainterBackendGL::ConfigurationGL::
@@ -1404,6 +5264,7 @@ setget_implement(bool, vert_shader_use_switch)
 setget_implement(bool, frag_shader_use_switch)
 setget_implement(bool, blend_shader_use_switch)
 setget_implement(bool, unpack_header_and_brush_in_frag_shader)
+setget_implement(bool, pack_varyings)
 setget_implement(enum fastuidraw::gl::PainterBackendGL::data_store_backing_t, data_store_backing)
 setget_implement(bool, assign_layout_to_vertex_shader_inputs)
 setget_implement(bool, assign_layout_to_varyings)
@@ -1411,6 +5272,31 @@ setget_implement(bool, assign_binding_points)
 setget_implement(bool, use_ubo_for_uniforms)
 setget_implement(bool, separate_program_for_discard)
 setget_implement(bool, non_dashed_stroke_shader_uses_discard)
+setget_implement(bool, dashed_stroke_shader_uses_discard)
+setget_implement(bool, persistent_mapped_buffers)
+setget_implement(const fastuidraw::reference_counted_ptr<fastuidraw::gl::ProgramBinaryCache>&, program_binary_cache)
+setget_implement(bool, async_program_rebuild)
+setget_implement(unsigned int, static_attributes_per_heap)
+setget_implement(unsigned int, static_indices_per_heap)
+setget_implement(bool, use_indirect_draw)
+setget_implement(unsigned int, timer_query_frames)
+setget_implement(bool, stencil_coverage)
+setget_implement(bool, stencil_clipping)
+setget_implement(bool, rounded_rect_clipping)
+setget_implement(bool, glyph_instancing)
+setget_implement(bool, bindless_images)
+setget_implement(bool, external_texture_images)
+setget_implement(unsigned int, specialized_programs)
+setget_implement(bool, solid_brush_programs)
+setget_implement(bool, w3c_blend_modes)
+setget_implement(bool, retain_gl_state_between_passes)
+setget_implement(bool, short_indices)
+setget_implement(bool, opaque_front_to_back)
+setget_implement(enum fastuidraw::glsl::PainterBackendGLSL::precision_policy_t, precision_policy)
+setget_implement(bool, tile_based_rendering)
+setget_implement(bool, debug_markers)
+setget_implement(bool, adaptive_buffer_sizes)
+setget_implement(unsigned int, adaptive_buffer_max_scale)
 
 #undef setget_implement
 
@@ -1425,7 +5311,16 @@ PainterBackendGL(const ConfigurationGL &config_gl,
                      PainterBackendGLPrivate::compute_glsl_config(config_gl),
                      PainterBackendGLPrivate::compute_base_config(config_gl, config_base))
 {
-  m_d = FASTUIDRAWnew PainterBackendGLPrivate(config_gl, this);
+  PainterBackendGLPrivate *d;
+  d = FASTUIDRAWnew PainterBackendGLPrivate(config_gl, this);
+  m_d = d;
+  /* stencil clipping and stencil coverage both use the
+     stencil buffer, stencil clipping takes precedence.
+   */
+  set_hints()
+    .stencil_coverage(d->m_params.stencil_coverage() && !d->m_params.stencil_clipping())
+    .stencil_clipping(d->m_params.stencil_clipping())
+    .instanced_quads(d->m_params.glyph_instancing());
 }
 
 fastuidraw::gl::PainterBackendGL::
@@ -1437,6 +5332,17 @@ fastuidraw::gl::PainterBackendGL::
   m_d = NULL;
 }
 
+enum fastuidraw::gl::PainterBackendGL::data_store_backing_t
+fastuidraw::gl::PainterBackendGL::
+calibrate_data_store_backing(ConfigurationGL &config_gl)
+{
+  enum data_store_backing_t v;
+
+  v = detail::calibrate_data_store_backing(config_gl.program_binary_cache());
+  config_gl.data_store_backing(v);
+  return v;
+}
+
 fastuidraw::reference_counted_ptr<fastuidraw::gl::Program>
 fastuidraw::gl::PainterBackendGL::
 program(enum program_type_t tp)
@@ -1446,6 +5352,17 @@ program(enum program_type_t tp)
   return d->programs(shader_code_added())[tp];
 }
 
+unsigned int
+fastuidraw::gl::PainterBackendGL::
+varying_slot_count(enum program_type_t tp)
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  DiscardItemShaderFilter item_filter(tp);
+  return glsl::PainterBackendGLSL::varying_slot_count(d->m_uber_shader_builder_params, &item_filter);
+}
+
 const fastuidraw::gl::PainterBackendGL::ConfigurationGL&
 fastuidraw::gl::PainterBackendGL::
 configuration_gl(void) const
@@ -1463,9 +5380,18 @@ compute_item_shader_group(PainterShader::Tag tag,
   bool b;
   uint32_t return_value;
 
-  b = configuration_gl().break_on_shader_change();
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  /* the specialized programs are chosen by the item shader
+     ID, so the ID is also in the group if there can be any.
+   */
+  b = configuration_gl().break_on_shader_change()
+    || configuration_gl().specialized_programs() > 0;
   return_value = (b) ? tag.m_ID : 0u;
+  return_value |= d->compute_async_group(tag, shader->number_sub_shaders(), &d->m_item_shader_id_end);
   return_value |= (shader_group_discard_mask & tag.m_group);
+  d->note_item_shader(tag, shader);
 
   if(configuration_gl().separate_program_for_discard())
     {
@@ -1487,9 +5413,12 @@ compute_blend_shader_group(PainterShader::Tag tag,
   bool b;
   uint32_t return_value;
 
-  FASTUIDRAWunused(shader);
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
   b = configuration_gl().break_on_shader_change();
   return_value = (b) ? tag.m_ID : 0u;
+  return_value |= d->compute_async_group(tag, shader->number_sub_shaders(), &d->m_blend_shader_id_end);
   return return_value;
 }
 
@@ -1531,8 +5460,23 @@ on_pre_draw(void)
       glSamplerParameteri(d->m_linear_filter_sampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     }
 
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_GEQUAL);
+  if(d->m_timer_queries != NULL)
+    {
+      d->m_timer_queries->begin_frame();
+    }
+
+  if(d->m_no_depth_buffer)
+    {
+      /* disabling the depth test also disables
+         writing to the depth buffer
+       */
+      glDisable(GL_DEPTH_TEST);
+    }
+  else
+    {
+      glEnable(GL_DEPTH_TEST);
+      glDepthFunc(GL_GEQUAL);
+    }
   glDisable(GL_STENCIL_TEST);
 
   if(d->m_number_clip_planes > 0)
@@ -1564,45 +5508,110 @@ on_pre_draw(void)
   const glsl::PainterBackendGLSL::UberShaderParams &uber_params(d->m_uber_shader_builder_params);
   const glsl::PainterBackendGLSL::BindingPoints &binding_points(uber_params.binding_points());
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.image_atlas_color_tiles_unfiltered());
-  glBindSampler(binding_points.image_atlas_color_tiles_unfiltered(), 0);
-  glBindTexture(GL_TEXTURE_2D_ARRAY, image->color_texture());
+  /* fetch the textures first, fetching a texture of an atlas
+     may upload to it, binding it to the active texture unit.
+   */
+  if(d->m_params.debug_markers())
+    {
+      push_debug_group("fastuidraw: atlas flush");
+    }
+
+  GLuint image_color(image->color_texture());
+  GLuint image_index(image->index_texture());
+  GLuint glyph_texel_uint(glyphs->texel_texture(true));
+  GLuint glyph_texel_float(glyphs->texel_texture(false));
+  GLuint glyph_geometry(glyphs->geometry_texture());
+  GLuint colorstop(color->texture());
+
+  if(d->m_params.debug_markers())
+    {
+      pop_debug_group();
+
+      /* an atlas creates a new texture when it is resized */
+      vecN<GLuint, PainterBackendGLPrivate::number_atlas_textures> textures;
+      textures[PainterBackendGLPrivate::image_color_atlas_texture] = image_color;
+      textures[PainterBackendGLPrivate::image_index_atlas_texture] = image_index;
+      textures[PainterBackendGLPrivate::glyph_texel_uint_atlas_texture] = glyph_texel_uint;
+      textures[PainterBackendGLPrivate::glyph_texel_float_atlas_texture] = glyph_texel_float;
+      textures[PainterBackendGLPrivate::glyph_geometry_atlas_texture] = glyph_geometry;
+      textures[PainterBackendGLPrivate::colorstop_atlas_texture] = colorstop;
+      d->label_atlas_textures(textures);
+    }
+
+  d->m_bytes_uploaded_at_pass = detail::number_bytes_uploaded();
+  d->m_atlas_resizes_at_pass = detail::number_atlas_resizes();
+
+  gl_state_shadow &state(*d->m_gl_state);
+  if(d->m_params.retain_gl_state_between_passes())
+    {
+      state.invalidate_program();
+      state.note_atlas_resizes(detail::number_atlas_resizes());
+    }
+  else
+    {
+      state.invalidate();
+    }
+  state.invalidate_active_texture();
+
+  state.bind_sampler(binding_points.image_atlas_color_tiles_unfiltered(), 0);
+  state.bind_texture(binding_points.image_atlas_color_tiles_unfiltered(),
+                     GL_TEXTURE_2D_ARRAY, image_color);
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.image_atlas_color_tiles_filtered());
-  glBindSampler(binding_points.image_atlas_color_tiles_filtered(), d->m_linear_filter_sampler);
-  glBindTexture(GL_TEXTURE_2D_ARRAY, image->color_texture());
+  state.bind_sampler(binding_points.image_atlas_color_tiles_filtered(), d->m_linear_filter_sampler);
+  state.bind_texture(binding_points.image_atlas_color_tiles_filtered(),
+                     GL_TEXTURE_2D_ARRAY, image_color);
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.image_atlas_index_tiles());
-  glBindSampler(binding_points.image_atlas_index_tiles(), 0);
-  glBindTexture(GL_TEXTURE_2D_ARRAY, image->index_texture());
+  state.bind_sampler(binding_points.image_atlas_index_tiles(), 0);
+  state.bind_texture(binding_points.image_atlas_index_tiles(),
+                     GL_TEXTURE_2D_ARRAY, image_index);
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.glyph_atlas_texel_store_uint());
-  glBindSampler(binding_points.glyph_atlas_texel_store_uint(), 0);
-  glBindTexture(GL_TEXTURE_2D_ARRAY, glyphs->texel_texture(true));
+  state.bind_sampler(binding_points.glyph_atlas_texel_store_uint(), 0);
+  state.bind_texture(binding_points.glyph_atlas_texel_store_uint(),
+                     GL_TEXTURE_2D_ARRAY, glyph_texel_uint);
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.glyph_atlas_texel_store_float());
-  glBindSampler(binding_points.glyph_atlas_texel_store_float(), 0);
-  glBindTexture(GL_TEXTURE_2D_ARRAY, glyphs->texel_texture(false));
+  state.bind_sampler(binding_points.glyph_atlas_texel_store_float(), 0);
+  state.bind_texture(binding_points.glyph_atlas_texel_store_float(),
+                     GL_TEXTURE_2D_ARRAY, glyph_texel_float);
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.glyph_atlas_geometry_store());
-  glBindSampler(binding_points.glyph_atlas_geometry_store(), 0);
-  glBindTexture(glyphs->geometry_texture_binding_point(), glyphs->geometry_texture());
+  state.bind_sampler(binding_points.glyph_atlas_geometry_store(), 0);
+  state.bind_texture(binding_points.glyph_atlas_geometry_store(),
+                     glyphs->geometry_texture_binding_point(), glyph_geometry);
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.colorstop_atlas());
-  glBindSampler(binding_points.colorstop_atlas(), 0);
-  glBindTexture(ColorStopAtlasGL::texture_bind_target(), color->texture());
+  state.bind_sampler(binding_points.colorstop_atlas(), 0);
+  state.bind_texture(binding_points.colorstop_atlas(),
+                     ColorStopAtlasGL::texture_bind_target(), colorstop);
 
   //grabbing the programs via programs() makes sure they
   //are built.
   const PainterBackendGLPrivate::program_set &prs(d->programs(shader_code_added()));
   assert(!shader_code_added());
+  d->choose_specialized_programs();
+  d->check_specialized_programs_ready();
 
   if(!d->m_params.separate_program_for_discard())
     {
-      prs[program_all]->use_program();
+      state.use_program(prs[program_all].get());
     }
 
-  if(d->m_uber_shader_builder_params.use_ubo_for_uniforms())
+  if(d->m_uber_shader_builder_params.use_ubo_for_uniforms()
+     && d->m_pool->persistent_mapping())
+    {
+      /* write the uniforms directly to the block of the pool in
+         the persistently mapped ring, so that starting a pass
+         costs a single bind instead of a map and unmap.
+       */
+      GLuint ubo;
+      GLintptr offset;
+      unsigned int size_generics(ubo_size());
+      unsigned int size_bytes(sizeof(generic_data) * size_generics);
+      void *ubo_mapped;
+
+      ubo = d->m_pool->request_uniform_ring_block(size_bytes, &offset, &ubo_mapped);
+      fill_uniform_buffer(c_array<generic_data>(static_cast<generic_data*>(ubo_mapped), size_generics));
+      glBindBufferRange(GL_UNIFORM_BUFFER, d->m_uber_shader_builder_params.binding_points().uniforms_ubo(),
+                        ubo, offset, size_bytes);
+    }
+  else if(d->m_uber_shader_builder_params.use_ubo_for_uniforms())
     {
       /* Grab the buffer, map it, fill it and leave it bound.
        */
@@ -1630,16 +5639,40 @@ on_pre_draw(void)
       fill_uniform_buffer(d->m_uniform_values_ptr);
       if(d->m_params.separate_program_for_discard())
         {
-          prs[program_without_discard]->use_program();
+          state.use_program(prs[program_without_discard].get());
           Uniform(d->m_shader_uniforms_loc[program_without_discard], ubo_size(), d->m_uniform_values_ptr.reinterpret_pointer<float>());
 
-          prs[program_with_discard]->use_program();
+          state.use_program(prs[program_with_discard].get());
           Uniform(d->m_shader_uniforms_loc[program_with_discard], ubo_size(), d->m_uniform_values_ptr.reinterpret_pointer<float>());
         }
       else
         {
           Uniform(d->m_shader_uniforms_loc[program_all], ubo_size(), d->m_uniform_values_ptr.reinterpret_pointer<float>());
         }
+
+      if(d->m_params.solid_brush_programs())
+        {
+          for(unsigned int i = 0; i < number_program_types; ++i)
+            {
+              state.use_program(d->m_solid_brush_programs[i].get());
+              Uniform(d->m_solid_brush_uniforms_loc[i], ubo_size(), d->m_uniform_values_ptr.reinterpret_pointer<float>());
+            }
+        }
+
+      if(d->m_specialized_programs_ready)
+        {
+          for(unsigned int i = 0, endi = d->m_specialized_programs.size(); i < endi; ++i)
+            {
+              state.use_program(d->m_specialized_programs[i].get());
+              Uniform(d->m_specialized_uniforms_loc[i], ubo_size(), d->m_uniform_values_ptr.reinterpret_pointer<float>());
+            }
+        }
+
+      if((d->m_specialized_programs_ready || d->m_params.solid_brush_programs())
+         && !d->m_params.separate_program_for_discard())
+        {
+          state.use_program(prs[program_all].get());
+        }
     }
 }
 
@@ -1650,11 +5683,20 @@ on_post_draw(void)
   PainterBackendGLPrivate *d;
   d = static_cast<PainterBackendGLPrivate*>(m_d);
 
-  /* this is somewhat paranoid to make sure that
-     the GL objects do not leak...
+  /* the VAO is always unbound since uploading to the index
+     buffers between passes binds GL_ELEMENT_ARRAY_BUFFER,
+     which would change the index buffer of a bound VAO.
    */
-  glUseProgram(0);
-  glBindVertexArray(0);
+  d->m_gl_state->bind_vertex_array(0);
+  glDisable(GL_STENCIL_TEST);
+
+  if(d->m_bytes_uploaded_at_pass != detail::number_bytes_uploaded()
+     || d->m_atlas_resizes_at_pass != detail::number_atlas_resizes())
+    {
+      ++d->m_num_mid_pass_atlas_flushes;
+    }
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  glDepthMask(GL_TRUE);
 
   if(d->m_tex_buffer_support != fastuidraw::gl::detail::tex_buffer_not_supported)
     {
@@ -1664,52 +5706,87 @@ on_post_draw(void)
   const glsl::PainterBackendGLSL::UberShaderParams &uber_params(d->m_uber_shader_builder_params);
   const glsl::PainterBackendGLSL::BindingPoints &binding_points(uber_params.binding_points());
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.image_atlas_color_tiles_unfiltered());
-  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+  /* with retain_gl_state_between_passes() the program,
+     textures, samplers and blend state stay bound for
+     the next pass to reuse.
+   */
+  if(!d->m_params.retain_gl_state_between_passes())
+    {
+      /* this is somewhat paranoid to make sure that
+         the GL objects do not leak...
+       */
+      glUseProgram(0);
+
+      glActiveTexture(GL_TEXTURE0 + binding_points.image_atlas_color_tiles_unfiltered());
+      glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+      glActiveTexture(GL_TEXTURE0 + binding_points.image_atlas_color_tiles_filtered());
+      glBindSampler(binding_points.image_atlas_color_tiles_filtered(), 0);
+      glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+      glActiveTexture(GL_TEXTURE0 + binding_points.image_atlas_index_tiles());
+      glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+      glActiveTexture(GL_TEXTURE0 + binding_points.glyph_atlas_texel_store_uint());
+      glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.image_atlas_color_tiles_filtered());
-  glBindSampler(binding_points.image_atlas_color_tiles_filtered(), 0);
-  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+      glActiveTexture(GL_TEXTURE0 + binding_points.glyph_atlas_texel_store_float());
+      glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.image_atlas_index_tiles());
-  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+      fastuidraw::gl::GlyphAtlasGL *glyphs;
+      assert(dynamic_cast<fastuidraw::gl::GlyphAtlasGL*>(glyph_atlas().get()));
+      glyphs = static_cast<fastuidraw::gl::GlyphAtlasGL*>(glyph_atlas().get());
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.glyph_atlas_texel_store_uint());
-  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+      glActiveTexture(GL_TEXTURE0 + binding_points.glyph_atlas_geometry_store());
+      glBindTexture(glyphs->geometry_texture_binding_point(), 0);
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.glyph_atlas_texel_store_float());
-  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+      glActiveTexture(GL_TEXTURE0 + binding_points.colorstop_atlas());
+      glBindTexture(ColorStopAtlasGL::texture_bind_target(), 0);
 
-  fastuidraw::gl::GlyphAtlasGL *glyphs;
-  assert(dynamic_cast<fastuidraw::gl::GlyphAtlasGL*>(glyph_atlas().get()));
-  glyphs = static_cast<fastuidraw::gl::GlyphAtlasGL*>(glyph_atlas().get());
+      switch(d->m_params.data_store_backing())
+        {
+        case fastuidraw::gl::PainterBackendGL::data_store_tbo:
+          {
+            glActiveTexture(GL_TEXTURE0 + binding_points.data_store_buffer_tbo());
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+          }
+          break;
+
+        case fastuidraw::gl::PainterBackendGL::data_store_ubo:
+          {
+            glBindBufferBase(GL_UNIFORM_BUFFER, binding_points.data_store_buffer_ubo(), 0);
+          }
+          break;
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.glyph_atlas_geometry_store());
-  glBindTexture(glyphs->geometry_texture_binding_point(), 0);
+        case fastuidraw::gl::PainterBackendGL::data_store_ssbo:
+          {
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding_points.data_store_buffer_ssbo(), 0);
+          }
+          break;
 
-  glActiveTexture(GL_TEXTURE0 + binding_points.colorstop_atlas());
-  glBindTexture(ColorStopAtlasGL::texture_bind_target(), 0);
+        default:
+          assert(!"Bad value for m_params.data_store_backing()");
+        }
+      glBindBufferBase(GL_UNIFORM_BUFFER, binding_points.uniforms_ubo(), 0);
+    }
 
-  switch(d->m_params.data_store_backing())
+  if(d->m_timer_queries != NULL)
     {
-    case fastuidraw::gl::PainterBackendGL::data_store_tbo:
-      {
-        glActiveTexture(GL_TEXTURE0 + binding_points.data_store_buffer_tbo());
-        glBindTexture(GL_TEXTURE_BUFFER, 0);
-      }
+      d->m_timer_queries->end_frame();
+    }
+  switch(d->m_pool->next_pool())
+    {
+    case painter_vao_pool::grow_buffers:
+      ++d->m_num_buffer_grows;
       break;
 
-    case fastuidraw::gl::PainterBackendGL::data_store_ubo:
-      {
-        glBindBufferBase(GL_UNIFORM_BUFFER, binding_points.data_store_buffer_ubo(), 0);
-      }
+    case painter_vao_pool::shrink_buffers:
+      ++d->m_num_buffer_shrinks;
       break;
 
     default:
-      assert(!"Bad value for m_params.data_store_backing()");
+      break;
     }
-  glBindBufferBase(GL_UNIFORM_BUFFER, binding_points.uniforms_ubo(), 0);
-  d->m_pool->next_pool();
 }
 
 fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw>
@@ -1721,3 +5798,276 @@ map_draw(void)
 
   return FASTUIDRAWnew DrawCommand(d->m_pool, d->m_params, d);
 }
+
+unsigned int
+fastuidraw::gl::PainterBackendGL::
+query_stat(enum stats_t st) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  switch(st)
+    {
+    case num_atlas_upload_bytes:
+      return static_cast<unsigned int>(detail::number_bytes_uploaded() - d->m_bytes_uploaded_at_reset);
+
+    case num_draw_calls:
+      return d->m_num_draw_calls;
+
+    case gpu_time_micro_seconds:
+      return (d->m_timer_queries != NULL) ?
+        static_cast<unsigned int>(d->m_timer_queries->frame_time_ns() / 1000u) :
+        0u;
+
+    case num_atlas_resizes:
+      return static_cast<unsigned int>(detail::number_atlas_resizes() - d->m_atlas_resizes_at_reset);
+
+    case num_mid_pass_atlas_flushes:
+      return d->m_num_mid_pass_atlas_flushes;
+
+    case num_buffer_grows:
+      return d->m_num_buffer_grows;
+
+    case num_buffer_shrinks:
+      return d->m_num_buffer_shrinks;
+
+    default:
+      return 0;
+    }
+}
+
+void
+fastuidraw::gl::PainterBackendGL::
+reset_stats(void)
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  d->m_num_draw_calls = 0;
+  d->m_bytes_uploaded_at_reset = detail::number_bytes_uploaded();
+  d->m_atlas_resizes_at_reset = detail::number_atlas_resizes();
+  d->m_num_mid_pass_atlas_flushes = 0;
+  d->m_num_buffer_grows = 0;
+  d->m_num_buffer_shrinks = 0;
+}
+
+void
+fastuidraw::gl::PainterBackendGL::
+no_depth_buffer(bool v)
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  d->m_no_depth_buffer = v;
+}
+
+void
+fastuidraw::gl::PainterBackendGL::
+on_begin(void)
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  if(d->m_params.tile_based_rendering())
+    {
+      GLint zero_stencil(0);
+
+      glStencilMask(~0u);
+      if(d->m_no_depth_buffer)
+        {
+          glClearBufferiv(GL_STENCIL, 0, &zero_stencil);
+        }
+      else
+        {
+          /* the Painter tests depth with GL_GEQUAL against z-values
+             that start at 1, i.e. the depth is cleared to 0.
+           */
+          glDepthMask(GL_TRUE);
+          glClearBufferfi(GL_DEPTH_STENCIL, 0, 0.0f, zero_stencil);
+        }
+    }
+}
+
+void
+fastuidraw::gl::PainterBackendGL::
+on_end(void)
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  if(d->m_params.tile_based_rendering())
+    {
+      d->invalidate_depth_stencil();
+    }
+}
+
+fastuidraw::const_c_array<fastuidraw::gl::PainterBackendGL::TimerQueryResult>
+fastuidraw::gl::PainterBackendGL::
+timer_query_results(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  if(d->m_timer_queries == NULL)
+    {
+      return const_c_array<TimerQueryResult>();
+    }
+  return make_c_array(d->m_timer_queries->results());
+}
+
+void
+fastuidraw::gl::PainterBackendGL::
+current_surface(unsigned int surface)
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  d->select_surface(surface);
+}
+
+unsigned int
+fastuidraw::gl::PainterBackendGL::
+current_surface(void) const
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  return d->m_current_surface;
+}
+
+void
+fastuidraw::gl::PainterBackendGL::
+release_surface(unsigned int surface)
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  assert(surface != d->m_current_surface);
+  if(surface < d->m_surfaces.size() && d->m_surfaces[surface] != NULL
+     && surface != d->m_current_surface)
+    {
+      FASTUIDRAWdelete(d->m_surfaces[surface]);
+      d->m_surfaces[surface] = NULL;
+    }
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend::RenderTarget>
+fastuidraw::gl::PainterBackendGL::
+create_render_target(ivec2 dims)
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  /* the color buffer of a RenderTargetGL is drawn
+     as a bindless image
+   */
+  if(!d->m_params.bindless_images())
+    {
+      return reference_counted_ptr<RenderTarget>();
+    }
+  return RenderTargetGL::create(dims);
+}
+
+void
+fastuidraw::gl::PainterBackendGL::
+begin_render_target(const reference_counted_ptr<RenderTarget> &target)
+{
+  PainterBackendGLPrivate *d;
+  RenderTargetGL *t;
+  saved_render_target S;
+  GLint zero_stencil(0);
+  vec4 transparent_black(0.0f, 0.0f, 0.0f, 0.0f);
+
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  assert(dynamic_cast<RenderTargetGL*>(target.get()));
+  t = static_cast<RenderTargetGL*>(target.get());
+
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &S.m_fbo);
+  glGetIntegerv(GL_VIEWPORT, S.m_viewport.c_ptr());
+  S.m_scissor_test = (glIsEnabled(GL_SCISSOR_TEST) == GL_TRUE);
+  d->m_render_target_stack.push_back(S);
+
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, t->fbo());
+  glViewport(0, 0, t->dimensions().x(), t->dimensions().y());
+  glDisable(GL_SCISSOR_TEST);
+
+  /* the Painter tests depth with GL_GEQUAL against z-values
+     that start at 1, i.e. the depth is cleared to 0; the
+     clear does not change the clear values of the application.
+   */
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  glDepthMask(GL_TRUE);
+  glStencilMask(~0u);
+  glClearBufferfv(GL_COLOR, 0, transparent_black.c_ptr());
+  glClearBufferfi(GL_DEPTH_STENCIL, 0, 0.0f, zero_stencil);
+}
+
+void
+fastuidraw::gl::PainterBackendGL::
+end_render_target(void)
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  assert(!d->m_render_target_stack.empty());
+  const saved_render_target &S(d->m_render_target_stack.back());
+
+  if(d->m_params.tile_based_rendering())
+    {
+      d->invalidate_depth_stencil();
+    }
+
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, S.m_fbo);
+  glViewport(S.m_viewport[0], S.m_viewport[1], S.m_viewport[2], S.m_viewport[3]);
+  if(S.m_scissor_test)
+    {
+      glEnable(GL_SCISSOR_TEST);
+    }
+  d->m_render_target_stack.pop_back();
+}
+
+enum fastuidraw::return_code
+fastuidraw::gl::PainterBackendGL::
+blur_render_target(const reference_counted_ptr<RenderTarget> &src,
+                   const reference_counted_ptr<RenderTarget> &dst,
+                   ivec2 size, float radius, bool alpha_only)
+{
+  PainterBackendGLPrivate *d;
+  const RenderTargetGL *s, *t;
+  bool success;
+
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+  assert(dynamic_cast<const RenderTargetGL*>(src.get()));
+  assert(dynamic_cast<const RenderTargetGL*>(dst.get()));
+  s = static_cast<const RenderTargetGL*>(src.get());
+  t = static_cast<const RenderTargetGL*>(dst.get());
+
+  if(d->m_layer_blur == NULL)
+    {
+      d->m_layer_blur = FASTUIDRAWnew detail::LayerBlur(d->m_ctx_properties);
+    }
+
+  success = d->m_layer_blur->blur(s->texture(), s->dimensions(), t->fbo(),
+                                  size, radius, alpha_only);
+
+  /* the blur binds its own program, VAO and texture */
+  if(d->m_gl_state != NULL)
+    {
+      d->m_gl_state->invalidate();
+    }
+
+  return success ? routine_success : routine_fail;
+}
+
+fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData>
+fastuidraw::gl::PainterBackendGL::
+create_static_attribute_data(const PainterAttributeData &data,
+                             const_c_array<unsigned int> attrib_chunk_selector,
+                             enum PainterAttribute::layout_t layout)
+{
+  PainterBackendGLPrivate *d;
+  d = static_cast<PainterBackendGLPrivate*>(m_d);
+
+  if(!d->m_static_heap)
+    {
+      return reference_counted_ptr<const PainterStaticAttributeData>();
+    }
+  return d->m_static_heap->create(data, attrib_chunk_selector, layout);
+}
@@ -4,7 +4,11 @@ dirstack_$(sp)	:= $(d)
 d		:= $(dir)
 # End standard header
 
-LIBRARY_PRIVATE_GL_SOURCES += $(call filelist, tex_buffer.cpp texture_gl.cpp texture_view.cpp)
+LIBRARY_PRIVATE_GL_SOURCES += $(call filelist, tex_buffer.cpp texture_gl.cpp texture_view.cpp upload_stats.cpp etc2_compress.cpp data_store_calibration.cpp layer_blur.cpp)
+
+# the private symbols of libFastUIDraw are hidden, so the GL backend
+# builds its own copy of the private code it uses.
+LIBRARY_PRIVATE_GL_SOURCES += $(call filelist, ../../private/interval_allocator.cpp)
 
 
 # Begin standard footer
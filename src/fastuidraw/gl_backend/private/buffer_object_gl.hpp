@@ -19,16 +19,57 @@
 
 #pragma once
 
+#include <vector>
+#include <algorithm>
+#include <cstring>
 #include <fastuidraw/gl_backend/ngl_header.hpp>
 #include <fastuidraw/gl_backend/gl_get.hpp>
+#include "upload_stats.hpp"
 
 namespace fastuidraw { namespace gl { namespace detail {
 
+/* a delayed upload to a BufferGL: the bytes
+   BufferGL::m_staging[m_begin, m_end) (or of
+   BufferGL::m_mirror if the BufferGL keeps a CPU
+   mirror) are to be written at m_location of the
+   buffer
+ */
 class BufferGLEntryLocation
 {
 public:
   int m_location;
-  std::vector<uint8_t> m_data;
+  unsigned int m_begin, m_end;
+
+  /* location in the buffer one past the last byte */
+  int
+  end_location(void) const
+  {
+    return m_location + static_cast<int>(m_end - m_begin);
+  }
+};
+
+/* orders the indices of a list of BufferGLEntryLocation
+   by the location at which they write, ties broken by
+   the order of the writes
+ */
+class BufferGLEntryLocationOrder
+{
+public:
+  explicit
+  BufferGLEntryLocationOrder(const std::vector<BufferGLEntryLocation> &v):
+    m_v(v)
+  {}
+
+  bool
+  operator()(unsigned int lhs, unsigned int rhs) const
+  {
+    return (m_v[lhs].m_location != m_v[rhs].m_location) ?
+      m_v[lhs].m_location < m_v[rhs].m_location :
+      lhs < rhs;
+  }
+
+private:
+  const std::vector<BufferGLEntryLocation> &m_v;
 };
 
 /*!\class BufferGL
@@ -44,11 +85,21 @@ template<GLenum binding_point,
 class BufferGL
 {
 public:
+  enum
+    {
+      /* largest gap between two delayed writes that flush()
+         uploads together with the writes when the buffer
+         keeps a CPU mirror, from which the gap is filled.
+       */
+      max_bridged_gap = 256
+    };
+
   BufferGL(GLsizei psize, bool delayed):
     m_size(psize),
     m_buffer_size(psize),
     m_delayed(delayed),
-    m_buffer(0)
+    m_buffer(0),
+    m_keep_cpu_mirror(false)
   {
     assert(m_size > 0);
     if(!m_delayed)
@@ -78,35 +129,61 @@ public:
   set_data(int offset, const_c_array<uint8_t> data)
   {
     assert(!data.empty());
+    if(m_keep_cpu_mirror)
+      {
+        assert(static_cast<unsigned int>(offset) + data.size() <= m_mirror.size());
+        std::memcpy(&m_mirror[offset], data.c_ptr(), data.size());
+      }
+
     if(m_delayed)
       {
-        m_unflushed_commands.push_back(BufferGLEntryLocation());
-        m_unflushed_commands.back().m_location = offset;
-        m_unflushed_commands.back().m_data.resize(data.size());
-        std::copy(data.begin(), data.end(), m_unflushed_commands.back().m_data.begin());
+        BufferGLEntryLocation C;
+
+        /* with a CPU mirror the bytes are already in
+           m_mirror and the command refers to them there
+         */
+        C.m_location = offset;
+        if(m_keep_cpu_mirror)
+          {
+            C.m_begin = offset;
+            C.m_end = offset + data.size();
+          }
+        else
+          {
+            C.m_begin = m_staging.size();
+            m_staging.insert(m_staging.end(), data.begin(), data.end());
+            C.m_end = m_staging.size();
+          }
+
+        /* if the write continues the previous write, then
+           merge them so that flush() issues a single
+           glBufferSubData() for both.
+         */
+        if(!m_unflushed_commands.empty()
+           && m_unflushed_commands.back().m_end == C.m_begin
+           && m_unflushed_commands.back().m_location
+              + static_cast<int>(m_unflushed_commands.back().m_end - m_unflushed_commands.back().m_begin) == offset)
+          {
+            m_unflushed_commands.back().m_end = C.m_end;
+          }
+        else
+          {
+            m_unflushed_commands.push_back(C);
+          }
       }
     else
       {
         flush_size_change();
         glBindBuffer(binding_point, m_buffer);
         glBufferSubData(binding_point, offset, data.size(), &data[0]);
+        note_bytes_uploaded(data.size());
       }
   }
 
   void
   set_data_vector(int offset, std::vector<uint8_t> &data)
   {
-    assert(!data.empty());
-    if(m_delayed)
-      {
-        m_unflushed_commands.push_back(BufferGLEntryLocation());
-        m_unflushed_commands.back().m_location = offset;
-        m_unflushed_commands.back().m_data.swap(data);
-      }
-    else
-      {
-        set_data(offset, data);
-      }
+    set_data(offset, data);
   }
 
   void
@@ -120,14 +197,26 @@ public:
 
     if(!m_unflushed_commands.empty())
       {
+        const uint8_t *src;
+
+        coalesce_unflushed_commands();
+
+        /* with a CPU mirror, the merged ranges are uploaded
+           straight from the mirror, which holds the latest
+           value of every byte.
+         */
+        src = (m_keep_cpu_mirror) ? &m_mirror[0] : &m_staging[0];
         glBindBuffer(binding_point, m_buffer);
-        for(typename std::list<BufferGLEntryLocation>::iterator iter = m_unflushed_commands.begin(),
+        for(std::vector<BufferGLEntryLocation>::const_iterator iter = m_unflushed_commands.begin(),
               end = m_unflushed_commands.end(); iter != end; ++iter)
           {
-            assert(!iter->m_data.empty());
-            glBufferSubData(binding_point, iter->m_location, iter->m_data.size(), &iter->m_data[0]);
+            assert(iter->m_begin < iter->m_end);
+            glBufferSubData(binding_point, iter->m_location,
+                            iter->m_end - iter->m_begin, src + iter->m_begin);
+            note_bytes_uploaded(iter->m_end - iter->m_begin);
           }
         m_unflushed_commands.clear();
+        m_staging.clear();
       }
   }
 
@@ -148,10 +237,153 @@ public:
   resize(GLsizei new_size)
   {
     m_size = new_size;
+    if(m_keep_cpu_mirror)
+      {
+        m_mirror.resize(m_size, 0);
+      }
+  }
+
+  /* keep a copy of the contents of the buffer in CPU memory
+     so that recreate_from_cpu_mirror() can re-create the
+     buffer on a new GL context; must be called before any
+     data is set.
+   */
+  void
+  keep_cpu_mirror(void)
+  {
+    assert(m_unflushed_commands.empty());
+    if(!m_keep_cpu_mirror)
+      {
+        m_keep_cpu_mirror = true;
+        m_mirror.resize(m_size, 0);
+      }
+  }
+
+  bool
+  has_cpu_mirror(void) const
+  {
+    return m_keep_cpu_mirror;
+  }
+
+  /* for after the GL context of the buffer is lost: drop the
+     old GL name without deleting it, create the buffer on the
+     current GL context and upload the CPU mirror to it.
+   */
+  void
+  recreate_from_cpu_mirror(void)
+  {
+    assert(m_keep_cpu_mirror);
+    m_buffer = 0;
+    m_unflushed_commands.clear();
+    m_staging.clear();
+    m_buffer_size = m_size;
+    create_buffer();
+    glBufferSubData(binding_point, 0, m_size, &m_mirror[0]);
+    note_bytes_uploaded(m_size);
   }
 
 private:
 
+  /* Merge the delayed writes whose ranges overlap or
+     touch, in whatever order they were made, so that
+     flush() issues one glBufferSubData() per merged range.
+     Where writes overlap, the later write wins. With a CPU
+     mirror, writes separated by at most max_bridged_gap
+     bytes are merged as well; the ranges of the commands
+     are then of m_mirror, see set_data().
+   */
+  void
+  coalesce_unflushed_commands(void)
+  {
+    std::vector<BufferGLEntryLocation> &cmds(m_unflushed_commands);
+    int gap((m_keep_cpu_mirror) ? max_bridged_gap : 0);
+    unsigned int staging_size(0);
+
+    m_work_order.resize(cmds.size());
+    for(unsigned int i = 0, endi = cmds.size(); i < endi; ++i)
+      {
+        m_work_order[i] = i;
+      }
+    std::sort(m_work_order.begin(), m_work_order.end(), BufferGLEntryLocationOrder(cmds));
+
+    /* m_work_ranges gets the merged ranges, as locations in
+       the buffer and the location of the bytes of each in
+       the new staging buffer; m_work_range_of[i] is the
+       index of the merged range of the i'th command.
+     */
+    m_work_ranges.clear();
+    m_work_range_of.resize(cmds.size());
+    for(unsigned int k = 0, endk = m_work_order.size(); k < endk; ++k)
+      {
+        const BufferGLEntryLocation &C(cmds[m_work_order[k]]);
+
+        if(!m_work_ranges.empty()
+           && C.m_location <= m_work_ranges.back().end_location() + gap)
+          {
+            BufferGLEntryLocation &R(m_work_ranges.back());
+            int e(std::max(R.end_location(), C.end_location()));
+            R.m_end = R.m_begin + static_cast<unsigned int>(e - R.m_location);
+          }
+        else
+          {
+            BufferGLEntryLocation R;
+
+            R.m_location = C.m_location;
+            R.m_begin = 0;
+            R.m_end = C.m_end - C.m_begin;
+            m_work_ranges.push_back(R);
+          }
+        m_work_range_of[m_work_order[k]] = m_work_ranges.size() - 1;
+      }
+
+    if(m_keep_cpu_mirror)
+      {
+        for(unsigned int r = 0, endr = m_work_ranges.size(); r < endr; ++r)
+          {
+            BufferGLEntryLocation &R(m_work_ranges[r]);
+            unsigned int sz(R.m_end - R.m_begin);
+
+            R.m_begin = R.m_location;
+            R.m_end = R.m_location + sz;
+          }
+        cmds.swap(m_work_ranges);
+        return;
+      }
+
+    if(m_work_ranges.size() == cmds.size())
+      {
+        /* nothing to merge */
+        return;
+      }
+
+    for(unsigned int r = 0, endr = m_work_ranges.size(); r < endr; ++r)
+      {
+        BufferGLEntryLocation &R(m_work_ranges[r]);
+        unsigned int sz(R.m_end - R.m_begin);
+
+        R.m_begin = staging_size;
+        R.m_end = staging_size + sz;
+        staging_size += sz;
+      }
+
+    /* copy the writes in the order they were made
+       so that overlapping writes resolve as they
+       would have had they been issued one by one.
+     */
+    m_work_staging.resize(staging_size);
+    for(unsigned int i = 0, endi = cmds.size(); i < endi; ++i)
+      {
+        const BufferGLEntryLocation &C(cmds[i]);
+        const BufferGLEntryLocation &R(m_work_ranges[m_work_range_of[i]]);
+
+        std::copy(m_staging.begin() + C.m_begin, m_staging.begin() + C.m_end,
+                  m_work_staging.begin() + R.m_begin + (C.m_location - R.m_location));
+      }
+
+    cmds.swap(m_work_ranges);
+    m_staging.swap(m_work_staging);
+  }
+
   void
   flush_size_change(void)
   {
@@ -185,6 +417,7 @@ private:
 
             glBindBuffer(src_binding_point, prev_buffer);
             glDeleteBuffers(1, &old_buffer);
+            note_atlas_resize();
           }
 
         m_buffer_size = m_size;
@@ -205,7 +438,16 @@ private:
   GLsizei m_buffer_size;
   bool m_delayed;
   mutable GLuint m_buffer;
-  std::list<BufferGLEntryLocation> m_unflushed_commands;
+  std::vector<BufferGLEntryLocation> m_unflushed_commands;
+  std::vector<uint8_t> m_staging;
+
+  /* work rooms for coalesce_unflushed_commands() */
+  std::vector<unsigned int> m_work_order, m_work_range_of;
+  std::vector<BufferGLEntryLocation> m_work_ranges;
+  std::vector<uint8_t> m_work_staging;
+
+  bool m_keep_cpu_mirror;
+  std::vector<uint8_t> m_mirror;
 };
 
 } //namespace detail
@@ -0,0 +1,433 @@
+/*!
+ * \file data_store_calibration.cpp
+ * \brief file data_store_calibration.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <stdint.h>
+#include <sys/time.h>
+
+#include <fastuidraw/gl_backend/ngl_header.hpp>
+#include <fastuidraw/gl_backend/gl_get.hpp>
+#include "data_store_calibration.hpp"
+#include "tex_buffer.hpp"
+
+namespace
+{
+  enum
+    {
+      /* size in texels of the width and height of the render target */
+      calibration_target_size = 256,
+
+      /* number of uvec4 blocks of the data store */
+      calibration_number_blocks = 1024,
+
+      /* number of quads of each draw, tiling the render target */
+      calibration_quads_per_side = 16,
+
+      /* number of blocks read per vertex and per fragment */
+      calibration_reads = 8,
+
+      /* number of timed draws per backing */
+      calibration_draws = 32
+    };
+
+  typedef fastuidraw::glsl::PainterBackendGLSL PainterBackendGLSL;
+
+  std::string
+  calibration_key(void)
+  {
+    /* FNV-1a hash of the identification strings of the GL
+       implementation, since the choice is only valid for
+       the exact same driver.
+     */
+    uint64_t value(14695981039346656037ull);
+    const char *strs[] =
+      {
+        "fastuidraw data store calibration",
+        reinterpret_cast<const char*>(glGetString(GL_VENDOR)),
+        reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+        reinterpret_cast<const char*>(glGetString(GL_VERSION))
+      };
+
+    for(unsigned int i = 0; i < 4; ++i)
+      {
+        for(const char *p = strs[i]; p && *p; ++p)
+          {
+            value ^= static_cast<uint8_t>(*p);
+            value *= 1099511628211ull;
+          }
+        /* the terminator, so that the concatenation is unambiguous */
+        value *= 1099511628211ull;
+      }
+
+    std::ostringstream str;
+    str << "calibrate_" << std::hex << std::setfill('0') << std::setw(16) << value;
+    return str.str();
+  }
+
+  fastuidraw::glsl::ShaderSource&
+  specify_front_matter(fastuidraw::glsl::ShaderSource &src,
+                       const fastuidraw::gl::ContextProperties &ctx,
+                       enum PainterBackendGLSL::data_store_backing_t tp)
+  {
+    using namespace fastuidraw::glsl;
+
+    if(ctx.is_es())
+      {
+        if(ctx.version() >= fastuidraw::ivec2(3, 2))
+          {
+            src.specify_version("320 es");
+          }
+        else
+          {
+            src
+              .specify_version(ctx.version() >= fastuidraw::ivec2(3, 1) ? "310 es" : "300 es")
+              .specify_extension("GL_EXT_texture_buffer", ShaderSource::enable_extension)
+              .specify_extension("GL_OES_texture_buffer", ShaderSource::enable_extension);
+          }
+        src.add_source("precision highp float;\nprecision highp int;\n", ShaderSource::from_string);
+        if(tp == PainterBackendGLSL::data_store_tbo)
+          {
+            src.add_source("precision highp usamplerBuffer;\n", ShaderSource::from_string);
+          }
+      }
+    else
+      {
+        src.specify_version(tp == PainterBackendGLSL::data_store_ssbo ? "430" : "330");
+      }
+
+    switch(tp)
+      {
+      case PainterBackendGLSL::data_store_tbo:
+        src.add_source("uniform usamplerBuffer store;\n"
+                       "#define fetch(i) texelFetch(store, int(i))\n",
+                       ShaderSource::from_string);
+        break;
+
+      case PainterBackendGLSL::data_store_ubo:
+        src
+          .add_macro("NUMBER_BLOCKS", uint32_t(calibration_number_blocks))
+          .add_source("layout(std140) uniform store_ubo { uvec4 store[NUMBER_BLOCKS]; };\n"
+                      "#define fetch(i) store[int(i)]\n",
+                      ShaderSource::from_string);
+        break;
+
+      case PainterBackendGLSL::data_store_ssbo:
+        src.add_source("layout(binding = 0, std430) restrict readonly buffer store_ssbo { uvec4 store[]; };\n"
+                       "#define fetch(i) store[int(i)]\n",
+                       ShaderSource::from_string);
+        break;
+      }
+
+    return src
+      .add_macro("NUMBER_BLOCKS_MASK", uint32_t(calibration_number_blocks - 1))
+      .add_macro("NUMBER_READS", uint32_t(calibration_reads))
+      .add_macro("QUADS_PER_SIDE", uint32_t(calibration_quads_per_side));
+  }
+
+  fastuidraw::reference_counted_ptr<fastuidraw::gl::Program>
+  build_calibration_program(const fastuidraw::gl::ContextProperties &ctx,
+                            enum PainterBackendGLSL::data_store_backing_t tp)
+  {
+    using namespace fastuidraw;
+    using namespace fastuidraw::glsl;
+
+    ShaderSource vert, frag;
+    gl::ProgramInitializerArray initers;
+
+    /* each quad is made of 6 vertices without attributes,
+       the per-vertex and per-fragment reads mimic how the
+       uber-shader reads the header and the brush and item
+       data from the data store.
+     */
+    specify_front_matter(vert, ctx, tp)
+      .add_source("flat out uvec4 v;\n"
+                  "void main(void)\n"
+                  "{\n"
+                  "  const vec2 corners[6] = vec2[6](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),\n"
+                  "                                  vec2(0.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));\n"
+                  "  uint quad = uint(gl_VertexID / 6);\n"
+                  "  vec2 p = vec2(float(quad % uint(QUADS_PER_SIDE)), float(quad / uint(QUADS_PER_SIDE)));\n"
+                  "  p = (p + corners[gl_VertexID % 6]) * (2.0 / float(QUADS_PER_SIDE)) - vec2(1.0, 1.0);\n"
+                  "  v = uvec4(0u);\n"
+                  "  for(uint i = 0u; i < uint(NUMBER_READS); ++i)\n"
+                  "    {\n"
+                  "      v += fetch((quad * uint(NUMBER_READS) + i) & uint(NUMBER_BLOCKS_MASK));\n"
+                  "    }\n"
+                  "  gl_Position = vec4(p, 0.0, 1.0);\n"
+                  "}\n", ShaderSource::from_string);
+
+    specify_front_matter(frag, ctx, tp)
+      .add_source("flat in uvec4 v;\n"
+                  "out vec4 color;\n"
+                  "void main(void)\n"
+                  "{\n"
+                  "  uvec4 s = v;\n"
+                  "  uint base = (uint(gl_FragCoord.x) + (uint(gl_FragCoord.y) << 3u)) & uint(NUMBER_BLOCKS_MASK);\n"
+                  "  for(uint i = 0u; i < uint(NUMBER_READS); ++i)\n"
+                  "    {\n"
+                  "      s ^= fetch((base + i * s.x) & uint(NUMBER_BLOCKS_MASK));\n"
+                  "    }\n"
+                  "  color = vec4(s & uvec4(255u)) / 255.0;\n"
+                  "}\n", ShaderSource::from_string);
+
+    switch(tp)
+      {
+      case PainterBackendGLSL::data_store_tbo:
+        initers.add_sampler_initializer("store", 0);
+        break;
+
+      case PainterBackendGLSL::data_store_ubo:
+        initers.add_uniform_block_binding("store_ubo", 0);
+        break;
+
+      default:
+        break;
+      }
+
+    return FASTUIDRAWnew gl::Program(vert, frag, gl::PreLinkActionArray(), initers);
+  }
+
+  uint64_t
+  time_micro_seconds(void)
+  {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return uint64_t(tv.tv_sec) * 1000000u + uint64_t(tv.tv_usec);
+  }
+
+  /* returns the time in micro-seconds to draw calibration_draws
+     times with the data store backed as tp, or 0 if the program
+     fails to build.
+   */
+  uint64_t
+  time_backing(const fastuidraw::gl::ContextProperties &ctx,
+               enum PainterBackendGLSL::data_store_backing_t tp,
+               GLuint data_bo,
+               enum fastuidraw::gl::detail::tex_buffer_support_t tex_buffer_support)
+  {
+    using namespace fastuidraw;
+
+    reference_counted_ptr<gl::Program> pr;
+    GLuint tbo(0);
+    GLsizei count(6 * calibration_quads_per_side * calibration_quads_per_side);
+    uint64_t start, end;
+
+    pr = build_calibration_program(ctx, tp);
+    if(!pr->link_success())
+      {
+        return 0u;
+      }
+
+    switch(tp)
+      {
+      case PainterBackendGLSL::data_store_tbo:
+        glGenTextures(1, &tbo);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_BUFFER, tbo);
+        gl::detail::tex_buffer(tex_buffer_support, GL_TEXTURE_BUFFER, GL_RGBA32UI, data_bo);
+        break;
+
+      case PainterBackendGLSL::data_store_ubo:
+        glBindBufferBase(GL_UNIFORM_BUFFER, 0, data_bo);
+        break;
+
+      case PainterBackendGLSL::data_store_ssbo:
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, data_bo);
+        break;
+      }
+
+    pr->use_program();
+
+    /* the first draw is not timed so that the lazy work
+       of the GL implementation is not counted.
+     */
+    glDrawArrays(GL_TRIANGLES, 0, count);
+    glFinish();
+
+    start = time_micro_seconds();
+    for(unsigned int i = 0; i < calibration_draws; ++i)
+      {
+        glDrawArrays(GL_TRIANGLES, 0, count);
+      }
+    glFinish();
+    end = time_micro_seconds();
+
+    switch(tp)
+      {
+      case PainterBackendGLSL::data_store_tbo:
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glDeleteTextures(1, &tbo);
+        break;
+
+      case PainterBackendGLSL::data_store_ubo:
+        glBindBufferBase(GL_UNIFORM_BUFFER, 0, 0);
+        break;
+
+      case PainterBackendGLSL::data_store_ssbo:
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+        break;
+      }
+
+    glUseProgram(0);
+    return std::max(uint64_t(1), end - start);
+  }
+}
+
+bool
+fastuidraw::gl::detail::
+data_store_ssbo_supported(const ContextProperties &ctx)
+{
+  bool version_ok;
+
+  version_ok = (ctx.is_es()) ?
+    ctx.version() >= ivec2(3, 1) :
+    ctx.version() >= ivec2(4, 3);
+
+  /* GLES3.1 only requires SSBO's in compute shaders */
+  return version_ok
+    && context_get<GLint>(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS) > 0
+    && context_get<GLint>(GL_MAX_FRAGMENT_SHADER_STORAGE_BLOCKS) > 0;
+}
+
+bool
+fastuidraw::gl::detail::
+data_store_backing_supported(const ContextProperties &ctx,
+                             enum glsl::PainterBackendGLSL::data_store_backing_t tp)
+{
+  switch(tp)
+    {
+    case glsl::PainterBackendGLSL::data_store_tbo:
+      return compute_tex_buffer_support(ctx) != tex_buffer_not_supported;
+
+    case glsl::PainterBackendGLSL::data_store_ubo:
+      return true;
+
+    case glsl::PainterBackendGLSL::data_store_ssbo:
+      return data_store_ssbo_supported(ctx);
+    }
+  return false;
+}
+
+enum fastuidraw::glsl::PainterBackendGLSL::data_store_backing_t
+fastuidraw::gl::detail::
+calibrate_data_store_backing(const reference_counted_ptr<ProgramBinaryCache> &cache)
+{
+  const enum glsl::PainterBackendGLSL::data_store_backing_t candidates[] =
+    {
+      glsl::PainterBackendGLSL::data_store_tbo,
+      glsl::PainterBackendGLSL::data_store_ubo,
+      glsl::PainterBackendGLSL::data_store_ssbo
+    };
+  const unsigned int number_candidates(sizeof(candidates) / sizeof(candidates[0]));
+
+  ContextProperties ctx;
+  enum glsl::PainterBackendGLSL::data_store_backing_t return_value;
+  std::string key;
+
+  return_value = compute_tex_buffer_support(ctx) != tex_buffer_not_supported ?
+    glsl::PainterBackendGLSL::data_store_tbo :
+    glsl::PainterBackendGLSL::data_store_ubo;
+
+  if(cache)
+    {
+      /* the choice is stored as a one byte "binary" of
+         format GL_NONE within the ProgramBinaryCache.
+       */
+      GLenum format;
+      const_c_array<uint8_t> value;
+
+      key = calibration_key();
+      if(cache->fetch(key.c_str(), &format, &value)
+         && format == GL_NONE && value.size() == 1 && value[0] < number_candidates
+         && data_store_backing_supported(ctx, candidates[value[0]]))
+        {
+          return candidates[value[0]];
+        }
+    }
+
+  GLint old_fbo(0);
+  GLint old_viewport[4];
+  GLuint fbo(0), color(0), vao(0), data_bo(0);
+  std::vector<uint32_t> data(4 * calibration_number_blocks);
+  uint64_t best_time(0);
+  uint8_t best_index(0);
+
+  old_fbo = context_get<GLint>(GL_DRAW_FRAMEBUFFER_BINDING);
+  glGetIntegerv(GL_VIEWPORT, old_viewport);
+
+  for(unsigned int i = 0, endi = data.size(); i < endi; ++i)
+    {
+      data[i] = i * 2654435761u;
+    }
+
+  glGenBuffers(1, &data_bo);
+  glBindBuffer(GL_ARRAY_BUFFER, data_bo);
+  glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(uint32_t), &data[0], GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  glGenTextures(1, &color);
+  glBindTexture(GL_TEXTURE_2D, color);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, calibration_target_size, calibration_target_size,
+               0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glGenFramebuffers(1, &fbo);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+  glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color, 0);
+  glViewport(0, 0, calibration_target_size, calibration_target_size);
+
+  glGenVertexArrays(1, &vao);
+  glBindVertexArray(vao);
+
+  for(unsigned int i = 0; i < number_candidates; ++i)
+    {
+      uint64_t t;
+
+      if(!data_store_backing_supported(ctx, candidates[i]))
+        {
+          continue;
+        }
+
+      t = time_backing(ctx, candidates[i], data_bo, compute_tex_buffer_support(ctx));
+      if(t != 0u && (best_time == 0u || t < best_time))
+        {
+          best_time = t;
+          best_index = i;
+          return_value = candidates[i];
+        }
+    }
+
+  glBindVertexArray(0);
+  glDeleteVertexArrays(1, &vao);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, old_fbo);
+  glDeleteFramebuffers(1, &fbo);
+  glDeleteTextures(1, &color);
+  glDeleteBuffers(1, &data_bo);
+  glViewport(old_viewport[0], old_viewport[1], old_viewport[2], old_viewport[3]);
+
+  if(cache && best_time != 0u)
+    {
+      cache->store(key.c_str(), GL_NONE, const_c_array<uint8_t>(&best_index, 1));
+    }
+
+  return return_value;
+}
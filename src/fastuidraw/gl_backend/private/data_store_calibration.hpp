@@ -0,0 +1,56 @@
+/*!
+ * \file data_store_calibration.hpp
+ * \brief file data_store_calibration.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/gl_backend/gl_context_properties.hpp>
+#include <fastuidraw/gl_backend/gl_program.hpp>
+#include <fastuidraw/glsl/painter_backend_glsl.hpp>
+
+namespace fastuidraw { namespace gl { namespace detail {
+
+/* Returns true if the GL context can back the data store
+   with an SSBO read from both the vertex and fragment shader.
+ */
+bool
+data_store_ssbo_supported(const ContextProperties &ctx);
+
+/* Returns true if the GL context can back the data store
+   with the named backing.
+ */
+bool
+data_store_backing_supported(const ContextProperties &ctx,
+                             enum glsl::PainterBackendGLSL::data_store_backing_t tp);
+
+/* Run a small synthetic workload reading the data store from
+   the vertex and fragment shaders for each supported backing
+   and return the fastest. The GL state touched (program,
+   VAO, framebuffer, viewport, buffer and texture bindings)
+   is restored to default values, except the framebuffer
+   and viewport which are restored to their previous values.
+   If cache is non-NULL, a previous choice stored in it for
+   the same GL implementation is returned without running
+   the workload, and a new choice is stored in it.
+ */
+enum glsl::PainterBackendGLSL::data_store_backing_t
+calibrate_data_store_backing(const reference_counted_ptr<ProgramBinaryCache> &cache);
+
+} //namespace detail
+} //namespace gl
+} //namespace fastuidraw
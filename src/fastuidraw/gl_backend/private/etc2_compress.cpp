@@ -0,0 +1,405 @@
+/*!
+ * \file etc2_compress.cpp
+ * \brief file etc2_compress.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <algorithm>
+#include <limits>
+#include <fastuidraw/util/util.hpp>
+#include "etc2_compress.hpp"
+#include "../../private/util_private.hpp"
+
+namespace
+{
+  /* The modifier tables of the ETC1 modes, each row is
+     the small and the large modifier of a table.
+   */
+  const int etc_modifier_table[8][2] =
+    {
+      {2, 8},
+      {5, 17},
+      {9, 29},
+      {13, 42},
+      {18, 60},
+      {24, 80},
+      {33, 106},
+      {47, 183}
+    };
+
+  /* The modifier tables of EAC alpha */
+  const int eac_modifier_table[16][8] =
+    {
+      {-3, -6, -9, -15, 2, 5, 8, 14},
+      {-3, -7, -10, -13, 2, 6, 9, 12},
+      {-2, -5, -8, -13, 1, 4, 7, 12},
+      {-2, -4, -6, -13, 1, 3, 5, 12},
+      {-3, -6, -8, -12, 2, 5, 7, 11},
+      {-3, -7, -9, -11, 2, 6, 8, 10},
+      {-4, -7, -8, -11, 3, 6, 7, 10},
+      {-3, -5, -8, -11, 2, 4, 7, 10},
+      {-2, -6, -8, -10, 1, 5, 7, 9},
+      {-2, -5, -8, -10, 1, 4, 7, 9},
+      {-2, -4, -8, -10, 1, 3, 7, 9},
+      {-2, -5, -7, -10, 1, 4, 6, 9},
+      {-3, -4, -7, -10, 2, 3, 6, 9},
+      {-1, -2, -3, -10, 0, 1, 2, 9},
+      {-4, -6, -8, -9, 3, 5, 7, 8},
+      {-3, -5, -7, -9, 2, 4, 6, 8}
+    };
+
+  inline
+  int
+  clamp_byte(int v)
+  {
+    return std::max(0, std::min(255, v));
+  }
+
+  /* The ETC1 pixel index i of a value encodes the
+     modifier as: 0 -> +small, 1 -> +large,
+     2 -> -small, 3 -> -large
+   */
+  inline
+  int
+  etc_modifier(int table, int i)
+  {
+    int v;
+    v = etc_modifier_table[table][i & 1];
+    return (i & 2) ? -v : v;
+  }
+
+  /* the texels of a block are ordered as in ETC, i.e.
+     column-major: texel (x, y) is at index 4 * x + y.
+   */
+  typedef fastuidraw::vecN<fastuidraw::u8vec4, 16> block_texels;
+
+  inline
+  unsigned int
+  sub_block_of(int flip, int i)
+  {
+    /* without flip, the sub-blocks are the left and right
+       2x4 halves, with flip the top and bottom 4x2 halves.
+     */
+    return flip ? ((i & 3) >= 2) : (i >= 8);
+  }
+
+  class etc_sub_block_choice
+  {
+  public:
+    etc_sub_block_choice(void):
+      m_error(std::numeric_limits<unsigned int>::max()),
+      m_table(0)
+    {}
+
+    unsigned int m_error;
+    int m_table;
+    fastuidraw::vecN<int, 16> m_indices;
+  };
+
+  /* choose the modifier table and indices for the texels
+     of the sub-block S given the base color
+   */
+  etc_sub_block_choice
+  choose_sub_block(const block_texels &texels, int flip, unsigned int S,
+                   fastuidraw::ivec3 base)
+  {
+    etc_sub_block_choice return_value;
+
+    for(int table = 0; table < 8; ++table)
+      {
+        etc_sub_block_choice current;
+
+        current.m_table = table;
+        current.m_error = 0;
+        for(int i = 0; i < 16; ++i)
+          {
+            unsigned int best_error(std::numeric_limits<unsigned int>::max());
+
+            if(sub_block_of(flip, i) != S)
+              {
+                continue;
+              }
+
+            for(int m = 0; m < 4; ++m)
+              {
+                unsigned int e(0);
+                for(int c = 0; c < 3; ++c)
+                  {
+                    int d;
+                    d = clamp_byte(base[c] + etc_modifier(table, m)) - texels[i][c];
+                    e += d * d;
+                  }
+                if(e < best_error)
+                  {
+                    best_error = e;
+                    current.m_indices[i] = m;
+                  }
+              }
+            current.m_error += best_error;
+          }
+
+        if(current.m_error < return_value.m_error)
+          {
+            return_value = current;
+          }
+      }
+    return return_value;
+  }
+
+  inline
+  int
+  quantize(float v, int max_value)
+  {
+    int r;
+    r = static_cast<int>(v * static_cast<float>(max_value) / 255.0f + 0.5f);
+    return std::max(0, std::min(max_value, r));
+  }
+
+  inline
+  int
+  expand4(int v)
+  {
+    return (v << 4) | v;
+  }
+
+  inline
+  int
+  expand5(int v)
+  {
+    return (v << 3) | (v >> 2);
+  }
+
+  void
+  compress_color(const block_texels &texels, uint8_t *dst)
+  {
+    unsigned int best_error(std::numeric_limits<unsigned int>::max());
+    uint32_t best_hi(0), best_lo(0);
+
+    for(int flip = 0; flip < 2; ++flip)
+      {
+        fastuidraw::vecN<fastuidraw::vec3, 2> average(fastuidraw::vec3(0.0f, 0.0f, 0.0f));
+
+        for(int i = 0; i < 16; ++i)
+          {
+            for(int c = 0; c < 3; ++c)
+              {
+                average[sub_block_of(flip, i)][c] += static_cast<float>(texels[i][c]);
+              }
+          }
+        average[0] /= 8.0f;
+        average[1] /= 8.0f;
+
+        for(int diff = 0; diff < 2; ++diff)
+          {
+            fastuidraw::vecN<fastuidraw::ivec3, 2> q, base;
+            fastuidraw::vecN<etc_sub_block_choice, 2> choice;
+            uint32_t hi, lo;
+
+            if(diff)
+              {
+                /* the second color is encoded as a 3-bit signed offset
+                   from the first, clamp the offset to [-4, 3]; since the
+                   first color is in [0, 31] and the offset is clamped
+                   so that the second color is as well, the block never
+                   triggers the T, H or planar modes of ETC2.
+                 */
+                for(int c = 0; c < 3; ++c)
+                  {
+                    int d;
+
+                    q[0][c] = quantize(average[0][c], 31);
+                    q[1][c] = quantize(average[1][c], 31);
+                    d = std::max(-4, std::min(3, q[1][c] - q[0][c]));
+                    q[1][c] = std::max(0, std::min(31, q[0][c] + d));
+                    base[0][c] = expand5(q[0][c]);
+                    base[1][c] = expand5(q[1][c]);
+                  }
+              }
+            else
+              {
+                for(int c = 0; c < 3; ++c)
+                  {
+                    q[0][c] = quantize(average[0][c], 15);
+                    q[1][c] = quantize(average[1][c], 15);
+                    base[0][c] = expand4(q[0][c]);
+                    base[1][c] = expand4(q[1][c]);
+                  }
+              }
+
+            choice[0] = choose_sub_block(texels, flip, 0, base[0]);
+            choice[1] = choose_sub_block(texels, flip, 1, base[1]);
+            if(choice[0].m_error + choice[1].m_error >= best_error)
+              {
+                continue;
+              }
+
+            if(diff)
+              {
+                hi = 0;
+                for(int c = 0; c < 3; ++c)
+                  {
+                    hi |= static_cast<uint32_t>(q[0][c]) << (27 - 8 * c);
+                    hi |= static_cast<uint32_t>((q[1][c] - q[0][c]) & 7) << (24 - 8 * c);
+                  }
+              }
+            else
+              {
+                hi = 0;
+                for(int c = 0; c < 3; ++c)
+                  {
+                    hi |= static_cast<uint32_t>(q[0][c]) << (28 - 8 * c);
+                    hi |= static_cast<uint32_t>(q[1][c]) << (24 - 8 * c);
+                  }
+              }
+            hi |= static_cast<uint32_t>((choice[0].m_table << 5) | (choice[1].m_table << 2) | (diff << 1) | flip);
+
+            lo = 0;
+            for(int i = 0; i < 16; ++i)
+              {
+                int m;
+                m = choice[sub_block_of(flip, i)].m_indices[i];
+                lo |= static_cast<uint32_t>((m >> 1) & 1) << (16 + i);
+                lo |= static_cast<uint32_t>(m & 1) << i;
+              }
+
+            best_error = choice[0].m_error + choice[1].m_error;
+            best_hi = hi;
+            best_lo = lo;
+          }
+      }
+
+    for(int b = 0; b < 4; ++b)
+      {
+        dst[b] = static_cast<uint8_t>(best_hi >> (24 - 8 * b));
+        dst[4 + b] = static_cast<uint8_t>(best_lo >> (24 - 8 * b));
+      }
+  }
+
+  void
+  compress_alpha(const block_texels &texels, uint8_t *dst)
+  {
+    int min_alpha(255), max_alpha(0);
+    unsigned int best_error(std::numeric_limits<unsigned int>::max());
+    int best_base(0), best_multiplier(1), best_table(0);
+    fastuidraw::vecN<int, 16> best_indices(0);
+
+    for(int i = 0; i < 16; ++i)
+      {
+        min_alpha = std::min(min_alpha, static_cast<int>(texels[i].w()));
+        max_alpha = std::max(max_alpha, static_cast<int>(texels[i].w()));
+      }
+
+    for(int table = 0; table < 16 && best_error > 0; ++table)
+      {
+        int lo, hi, m0;
+
+        /* the table of a row goes from lo to hi, choose the
+           multiplier so that the table spans [min_alpha, max_alpha]
+           and try its neighbours too.
+         */
+        lo = eac_modifier_table[table][3];
+        hi = eac_modifier_table[table][7];
+        m0 = (max_alpha - min_alpha + (hi - lo) / 2) / (hi - lo);
+        for(int multiplier = std::max(1, m0 - 1); multiplier <= std::min(15, m0 + 1); ++multiplier)
+          {
+            int base;
+            unsigned int error(0);
+            fastuidraw::vecN<int, 16> indices;
+
+            base = clamp_byte((min_alpha + max_alpha - multiplier * (lo + hi)) / 2);
+            for(int i = 0; i < 16; ++i)
+              {
+                unsigned int e(std::numeric_limits<unsigned int>::max());
+                for(int k = 0; k < 8; ++k)
+                  {
+                    int d;
+                    unsigned int ed;
+
+                    d = clamp_byte(base + eac_modifier_table[table][k] * multiplier) - texels[i].w();
+                    ed = d * d;
+                    if(ed < e)
+                      {
+                        e = ed;
+                        indices[i] = k;
+                      }
+                  }
+                error += e;
+              }
+
+            if(error < best_error)
+              {
+                best_error = error;
+                best_base = base;
+                best_multiplier = multiplier;
+                best_table = table;
+                best_indices = indices;
+              }
+          }
+      }
+
+    uint64_t bits(0);
+    for(int i = 0; i < 16; ++i)
+      {
+        bits |= static_cast<uint64_t>(best_indices[i]) << (45 - 3 * i);
+      }
+
+    dst[0] = static_cast<uint8_t>(best_base);
+    dst[1] = static_cast<uint8_t>((best_multiplier << 4) | best_table);
+    for(int b = 0; b < 6; ++b)
+      {
+        dst[2 + b] = static_cast<uint8_t>(bits >> (40 - 8 * b));
+      }
+  }
+}
+
+void
+fastuidraw::gl::detail::
+compress_etc2_eac_rgba8(const_c_array<u8vec4> texels, int w, int h,
+                        std::vector<uint8_t> &dst)
+{
+  int blocks_x, blocks_y;
+  c_array<uint8_t> dst_ptr;
+
+  assert(w % etc2_block_size == 0);
+  assert(h % etc2_block_size == 0);
+  assert(texels.size() == static_cast<unsigned int>(w * h));
+
+  blocks_x = w / etc2_block_size;
+  blocks_y = h / etc2_block_size;
+  dst.resize(blocks_x * blocks_y * etc2_eac_rgba8_block_bytes);
+  dst_ptr = make_c_array(dst);
+
+  for(int by = 0; by < blocks_y; ++by)
+    {
+      for(int bx = 0; bx < blocks_x; ++bx)
+        {
+          block_texels block;
+          uint8_t *block_dst;
+
+          for(int x = 0; x < 4; ++x)
+            {
+              for(int y = 0; y < 4; ++y)
+                {
+                  block[4 * x + y] = texels[(bx * 4 + x) + (by * 4 + y) * w];
+                }
+            }
+
+          /* EAC alpha comes first, then the ETC2 color */
+          block_dst = dst_ptr.c_ptr() + (bx + by * blocks_x) * etc2_eac_rgba8_block_bytes;
+          compress_alpha(block, block_dst);
+          compress_color(block, block_dst + 8);
+        }
+    }
+}
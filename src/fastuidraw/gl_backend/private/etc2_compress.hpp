@@ -0,0 +1,53 @@
+/*!
+ * \file etc2_compress.hpp
+ * \brief file etc2_compress.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/vecN.hpp>
+
+namespace fastuidraw { namespace gl { namespace detail {
+
+enum
+  {
+    /* size in texels of the width and height of a block */
+    etc2_block_size = 4,
+
+    /* number of bytes of a GL_COMPRESSED_RGBA8_ETC2_EAC block */
+    etc2_eac_rgba8_block_bytes = 16
+  };
+
+/* Compress RGBA8 texels to GL_COMPRESSED_RGBA8_ETC2_EAC. The
+   texels are row-major with w texels per row, w and h must
+   be multiples of etc2_block_size. The compressed blocks are
+   written row-major to dst, which is resized to hold them.
+   The alpha is encoded as EAC and the color with only the
+   individual and differential modes of ETC2 (i.e. the ETC1
+   modes), choosing per block the mode, flip and modifier
+   tables of least squared error.
+ */
+void
+compress_etc2_eac_rgba8(const_c_array<u8vec4> texels, int w, int h,
+                        std::vector<uint8_t> &dst);
+
+} //namespace detail
+} //namespace gl
+} //namespace fastuidraw
@@ -0,0 +1,349 @@
+/*!
+ * \file layer_blur.cpp
+ * \brief file layer_blur.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include <fastuidraw/gl_backend/ngl_header.hpp>
+#include <fastuidraw/gl_backend/gluniform.hpp>
+#include "layer_blur.hpp"
+
+namespace
+{
+  enum
+    {
+      /* the textures of the levels are sized to a multiple
+         of level_granularity so that blurs of regions of
+         slightly different sizes share them
+       */
+      level_granularity = 64,
+
+      /* maximum number of times the region is halved */
+      max_number_levels = 6
+    };
+
+  fastuidraw::glsl::ShaderSource&
+  specify_front_matter(fastuidraw::glsl::ShaderSource &src,
+                       bool is_es, fastuidraw::ivec2 version)
+  {
+    using namespace fastuidraw::glsl;
+
+    if(is_es)
+      {
+        src
+          .specify_version(version >= fastuidraw::ivec2(3, 2) ? "320 es" : "300 es")
+          .add_source("precision highp float;\nprecision highp int;\n", ShaderSource::from_string);
+      }
+    else
+      {
+        src.specify_version("330");
+      }
+    return src;
+  }
+
+  /* the quad covers the viewport, which the caller sets to the
+     region written; uv covers the region read of the source.
+   */
+  const char *vert_source =
+    "uniform vec2 uv_scale;\n"
+    "out vec2 uv;\n"
+    "void main(void)\n"
+    "{\n"
+    "  const vec2 corners[4] = vec2[4](vec2(0.0, 0.0), vec2(1.0, 0.0),\n"
+    "                                  vec2(0.0, 1.0), vec2(1.0, 1.0));\n"
+    "  vec2 p = corners[gl_VertexID];\n"
+    "  uv = p * uv_scale;\n"
+    "  gl_Position = vec4(2.0 * p - vec2(1.0, 1.0), 0.0, 1.0);\n"
+    "}\n";
+
+  /* each tap is clamped to the region read so that the texels
+     of the texture outside of the region do not bleed in;
+     tap_offset is half a texel of the source scaled by the
+     offset of the pass, so that the taps fall between texels.
+   */
+  const char *frag_common_source =
+    "uniform sampler2D src;\n"
+    "uniform vec2 uv_min, uv_max, tap_offset;\n"
+    "in vec2 uv;\n"
+    "out vec4 color;\n"
+    "vec4 tap(vec2 d)\n"
+    "{\n"
+    "  return texture(src, clamp(uv + d, uv_min, uv_max));\n"
+    "}\n";
+
+  const char *frag_down_source =
+    "void main(void)\n"
+    "{\n"
+    "  vec2 h = tap_offset;\n"
+    "  color = (4.0 * tap(vec2(0.0, 0.0))\n"
+    "           + tap(vec2(-h.x, -h.y)) + tap(vec2(h.x, h.y))\n"
+    "           + tap(vec2(h.x, -h.y)) + tap(vec2(-h.x, h.y))) / 8.0;\n"
+    "}\n";
+
+  const char *frag_up_source =
+    "void main(void)\n"
+    "{\n"
+    "  vec2 h = tap_offset;\n"
+    "  color = (tap(vec2(-2.0 * h.x, 0.0)) + tap(vec2(2.0 * h.x, 0.0))\n"
+    "           + tap(vec2(0.0, -2.0 * h.y)) + tap(vec2(0.0, 2.0 * h.y))\n"
+    "           + 2.0 * (tap(vec2(-h.x, -h.y)) + tap(vec2(h.x, h.y))\n"
+    "                    + tap(vec2(h.x, -h.y)) + tap(vec2(-h.x, h.y)))) / 12.0;\n"
+    "  #ifdef ALPHA_ONLY\n"
+    "    {\n"
+    "      color = vec4(color.a);\n"
+    "    }\n"
+    "  #endif\n"
+    "}\n";
+
+  fastuidraw::ivec2
+  half_size(fastuidraw::ivec2 sz)
+  {
+    return fastuidraw::ivec2(std::max(1, (sz.x() + 1) / 2),
+                             std::max(1, (sz.y() + 1) / 2));
+  }
+}
+
+//////////////////////////////////////////
+// fastuidraw::gl::detail::LayerBlur methods
+fastuidraw::gl::detail::LayerBlur::
+LayerBlur(const ContextProperties &ctx):
+  m_is_es(ctx.is_es()),
+  m_version(ctx.version()),
+  m_programs_built(false),
+  m_programs_ok(false),
+  m_vao(0)
+{
+}
+
+fastuidraw::gl::detail::LayerBlur::
+~LayerBlur()
+{
+  for(unsigned int i = 0; i < m_levels.size(); ++i)
+    {
+      if(m_levels[i].m_fbo != 0)
+        {
+          glDeleteFramebuffers(1, &m_levels[i].m_fbo);
+          glDeleteTextures(1, &m_levels[i].m_texture);
+        }
+    }
+
+  if(m_vao != 0)
+    {
+      glDeleteVertexArrays(1, &m_vao);
+    }
+}
+
+bool
+fastuidraw::gl::detail::LayerBlur::
+build_programs(void)
+{
+  using namespace fastuidraw::glsl;
+
+  if(m_programs_built)
+    {
+      return m_programs_ok;
+    }
+
+  m_programs_built = true;
+  m_programs_ok = true;
+  for(unsigned int i = 0; i < number_programs; ++i)
+    {
+      ShaderSource vert, frag;
+      ProgramInitializerArray initers;
+      GLuint name;
+
+      specify_front_matter(vert, m_is_es, m_version)
+        .add_source(vert_source, ShaderSource::from_string);
+
+      specify_front_matter(frag, m_is_es, m_version);
+      if(i == program_up_alpha_only)
+        {
+          frag.add_macro("ALPHA_ONLY");
+        }
+      frag
+        .add_source(frag_common_source, ShaderSource::from_string)
+        .add_source(i == program_down ? frag_down_source : frag_up_source,
+                    ShaderSource::from_string);
+
+      initers.add_sampler_initializer("src", 0);
+      m_programs[i].m_program = FASTUIDRAWnew Program(vert, frag, PreLinkActionArray(), initers);
+      m_programs_ok = m_programs_ok && m_programs[i].m_program->link_success();
+
+      name = m_programs[i].m_program->name();
+      m_programs[i].m_uv_scale = glGetUniformLocation(name, "uv_scale");
+      m_programs[i].m_uv_min = glGetUniformLocation(name, "uv_min");
+      m_programs[i].m_uv_max = glGetUniformLocation(name, "uv_max");
+      m_programs[i].m_tap_offset = glGetUniformLocation(name, "tap_offset");
+    }
+
+  glGenVertexArrays(1, &m_vao);
+  assert(m_vao != 0);
+
+  return m_programs_ok;
+}
+
+void
+fastuidraw::gl::detail::LayerBlur::
+ready_level(unsigned int i, ivec2 dims)
+{
+  if(i >= m_levels.size())
+    {
+      m_levels.resize(i + 1);
+    }
+
+  level &L(m_levels[i]);
+  if(L.m_dims.x() >= dims.x() && L.m_dims.y() >= dims.y())
+    {
+      return;
+    }
+
+  if(L.m_fbo != 0)
+    {
+      glDeleteFramebuffers(1, &L.m_fbo);
+      glDeleteTextures(1, &L.m_texture);
+    }
+
+  L.m_dims.x() = (std::max(dims.x(), L.m_dims.x()) + level_granularity - 1) & ~(level_granularity - 1);
+  L.m_dims.y() = (std::max(dims.y(), L.m_dims.y()) + level_granularity - 1) & ~(level_granularity - 1);
+
+  glGenTextures(1, &L.m_texture);
+  assert(L.m_texture != 0);
+  glBindTexture(GL_TEXTURE_2D, L.m_texture);
+  glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, L.m_dims.x(), L.m_dims.y());
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  glGenFramebuffers(1, &L.m_fbo);
+  assert(L.m_fbo != 0);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, L.m_fbo);
+  glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                         GL_TEXTURE_2D, L.m_texture, 0);
+}
+
+void
+fastuidraw::gl::detail::LayerBlur::
+pass(const program &P, float offset,
+     GLuint src, ivec2 src_dims, ivec2 src_size,
+     GLuint dst, ivec2 dst_size)
+{
+  vec2 recip_dims(1.0f / static_cast<float>(src_dims.x()),
+                  1.0f / static_cast<float>(src_dims.y()));
+
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dst);
+  glViewport(0, 0, dst_size.x(), dst_size.y());
+  glBindTexture(GL_TEXTURE_2D, src);
+
+  P.m_program->use_program();
+  Uniform(P.m_uv_scale, vec2(src_size) * recip_dims);
+  Uniform(P.m_uv_min, 0.5f * recip_dims);
+  Uniform(P.m_uv_max, (vec2(src_size) - vec2(0.5f, 0.5f)) * recip_dims);
+  Uniform(P.m_tap_offset, 0.5f * offset * recip_dims);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+bool
+fastuidraw::gl::detail::LayerBlur::
+blur(GLuint src_texture, ivec2 src_dims, GLuint dst_fbo,
+     ivec2 size, float radius, bool alpha_only)
+{
+  GLint old_fbo(0);
+  vecN<GLint, 4> old_viewport;
+  bool old_scissor_test;
+  unsigned int number_levels;
+  float offset;
+  std::vector<ivec2> sizes;
+
+  if(!build_programs())
+    {
+      return false;
+    }
+
+  /* the region is halved number_levels times, about
+     log2(radius) times, and the taps of each pass are
+     spread by offset texels of its level so that the
+     spread of the blur is about radius texels of the
+     region.
+   */
+  radius = std::max(radius, 1.0f);
+  number_levels = static_cast<unsigned int>(std::floor(std::log(radius) / std::log(2.0f)));
+  number_levels = std::max(1u, std::min(number_levels, static_cast<unsigned int>(max_number_levels)));
+  offset = radius / static_cast<float>(1u << number_levels);
+
+  sizes.push_back(size);
+  for(unsigned int i = 1; i <= number_levels; ++i)
+    {
+      sizes.push_back(half_size(sizes.back()));
+    }
+
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &old_fbo);
+  glGetIntegerv(GL_VIEWPORT, old_viewport.c_ptr());
+  old_scissor_test = (glIsEnabled(GL_SCISSOR_TEST) == GL_TRUE);
+
+  /* levels 1 to number_levels of the pyramid are the
+     textures m_levels[1] to m_levels[number_levels],
+     level 0 is the source and the destination.
+   */
+  for(unsigned int i = 1; i <= number_levels; ++i)
+    {
+      ready_level(i, sizes[i]);
+    }
+
+  glDisable(GL_SCISSOR_TEST);
+  glDisable(GL_BLEND);
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_STENCIL_TEST);
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  glActiveTexture(GL_TEXTURE0);
+  glBindSampler(0, 0);
+  glBindVertexArray(m_vao);
+
+  pass(m_programs[program_down], offset,
+       src_texture, src_dims, sizes[0],
+       m_levels[1].m_fbo, sizes[1]);
+  for(unsigned int i = 2; i <= number_levels; ++i)
+    {
+      pass(m_programs[program_down], offset,
+           m_levels[i - 1].m_texture, m_levels[i - 1].m_dims, sizes[i - 1],
+           m_levels[i].m_fbo, sizes[i]);
+    }
+
+  for(unsigned int i = number_levels; i > 1; --i)
+    {
+      pass(m_programs[program_up], offset,
+           m_levels[i].m_texture, m_levels[i].m_dims, sizes[i],
+           m_levels[i - 1].m_fbo, sizes[i - 1]);
+    }
+  pass(m_programs[alpha_only ? program_up_alpha_only : program_up], offset,
+       m_levels[1].m_texture, m_levels[1].m_dims, sizes[1],
+       dst_fbo, sizes[0]);
+
+  glBindVertexArray(0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glUseProgram(0);
+
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, old_fbo);
+  glViewport(old_viewport[0], old_viewport[1], old_viewport[2], old_viewport[3]);
+  if(old_scissor_test)
+    {
+      glEnable(GL_SCISSOR_TEST);
+    }
+
+  return true;
+}
@@ -0,0 +1,126 @@
+/*!
+ * \file layer_blur.hpp
+ * \brief file layer_blur.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <vector>
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/gl_backend/gl_header.hpp>
+#include <fastuidraw/gl_backend/gl_context_properties.hpp>
+#include <fastuidraw/gl_backend/gl_program.hpp>
+
+namespace fastuidraw { namespace gl { namespace detail {
+
+/* A LayerBlur blurs a region of a texture with a dual-Kawase
+   pyramid: the region is downsampled by halves a number of
+   times and then upsampled back, each pass drawing a single
+   quad whose taps are placed between texels so that the
+   bilinear filter averages four texels per tap. A blur of a
+   large radius thus costs a few passes over low resolution
+   levels instead of a wide kernel at full resolution. The
+   textures of the levels of the pyramid are owned by the
+   LayerBlur and reused across calls; they only grow when a
+   larger region is blurred. The programs are built on the
+   first call, a GL context must be current for all calls
+   and at destruction.
+ */
+class LayerBlur:noncopyable
+{
+public:
+  explicit
+  LayerBlur(const ContextProperties &ctx);
+
+  ~LayerBlur();
+
+  /* Blur the texels of the region [0, size) of src_texture,
+     a GL_TEXTURE_2D of dimensions src_dims with linear
+     filtering, into the region [0, size) of the color buffer
+     of the framebuffer dst_fbo; dst_fbo may be a framebuffer
+     whose color buffer is src_texture. The blur spreads each
+     texel over about radius texels. If alpha_only is true,
+     the texels written are the blurred alpha in all four
+     channels. Returns false, doing nothing, if the programs
+     failed to build. The draw framebuffer, viewport and
+     scissor test are restored; the bound program, VAO, the
+     texture and sampler of unit 0 and the blend, depth and
+     stencil tests are left to default values (disabled).
+   */
+  bool
+  blur(GLuint src_texture, ivec2 src_dims, GLuint dst_fbo,
+       ivec2 size, float radius, bool alpha_only);
+
+private:
+  enum program_t
+    {
+      program_down,
+      program_up,
+      program_up_alpha_only,
+
+      number_programs
+    };
+
+  class level
+  {
+  public:
+    level(void):
+      m_texture(0),
+      m_fbo(0),
+      m_dims(0, 0)
+    {}
+
+    GLuint m_texture, m_fbo;
+    ivec2 m_dims;
+  };
+
+  class program
+  {
+  public:
+    reference_counted_ptr<Program> m_program;
+    GLint m_uv_scale, m_uv_min, m_uv_max, m_tap_offset;
+  };
+
+  bool
+  build_programs(void);
+
+  /* make the level i at least dims texels */
+  void
+  ready_level(unsigned int i, ivec2 dims);
+
+  /* draw with P reading the region [0, src_size) of the
+     texture src of dimensions src_dims to the region
+     [0, dst_size) of the framebuffer dst
+   */
+  void
+  pass(const program &P, float offset,
+       GLuint src, ivec2 src_dims, ivec2 src_size,
+       GLuint dst, ivec2 dst_size);
+
+  bool m_is_es;
+  ivec2 m_version;
+  bool m_programs_built, m_programs_ok;
+  vecN<program, number_programs> m_programs;
+  std::vector<level> m_levels;
+  GLuint m_vao;
+};
+
+} //namespace detail
+} //namespace gl
+} //namespace fastuidraw
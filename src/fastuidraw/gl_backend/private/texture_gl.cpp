@@ -17,6 +17,7 @@
  */
 
 #include <iostream>
+#include <cstring>
 #include <fastuidraw/gl_backend/ngl_header.hpp>
 #include <fastuidraw/gl_backend/gl_context_properties.hpp>
 #include <fastuidraw/gl_backend/gl_get.hpp>
@@ -142,6 +143,81 @@ format_from_internal_format(GLenum fmt)
     }
 }
 
+bool
+fastuidraw::gl::detail::
+is_compressed_internal_format(GLenum fmt)
+{
+  switch(fmt)
+    {
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+      return true;
+
+    default:
+      return false;
+    }
+}
+
+int
+fastuidraw::gl::detail::
+compressed_block_size(GLenum fmt)
+{
+  return is_compressed_internal_format(fmt) ? 4 : 1;
+}
+
+unsigned int
+fastuidraw::gl::detail::
+element_bytes(GLenum internal_format, GLenum external_format, GLenum external_type)
+{
+  unsigned int num_components, component_bytes;
+
+  switch(internal_format)
+    {
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+      return 16;
+    }
+
+  switch(external_format)
+    {
+    case GL_RED:
+    case GL_RED_INTEGER:
+      num_components = 1;
+      break;
+
+    case GL_RG:
+    case GL_RG_INTEGER:
+      num_components = 2;
+      break;
+
+    case GL_RGB:
+    case GL_RGB_INTEGER:
+      num_components = 3;
+      break;
+
+    default:
+      num_components = 4;
+    }
+
+  switch(external_type)
+    {
+    case GL_UNSIGNED_SHORT:
+    case GL_SHORT:
+    case GL_HALF_FLOAT:
+      component_bytes = 2;
+      break;
+
+    case GL_UNSIGNED_INT:
+    case GL_INT:
+    case GL_FLOAT:
+      component_bytes = 4;
+      break;
+
+    default:
+      component_bytes = 1;
+    }
+
+  return num_components * component_bytes;
+}
+
 ////////////////////////////////
 // CopyImageSubData methods
 fastuidraw::gl::detail::CopyImageSubData::
@@ -262,3 +338,86 @@ operator()(GLuint srcName, GLenum srcTarget, GLint srcLevel,
       break;
     }
 }
+
+////////////////////////////////
+// PixelUnpackRing methods
+fastuidraw::gl::detail::PixelUnpackRing::
+PixelUnpackRing(void):
+  m_buffers(0),
+  m_sizes(0),
+  m_current(0)
+{}
+
+fastuidraw::gl::detail::PixelUnpackRing::
+~PixelUnpackRing()
+{
+  for(unsigned int i = 0; i < number_buffers; ++i)
+    {
+      assert(m_buffers[i] == 0);
+    }
+}
+
+void
+fastuidraw::gl::detail::PixelUnpackRing::
+delete_buffers(void)
+{
+  for(unsigned int i = 0; i < number_buffers; ++i)
+    {
+      if(m_buffers[i] != 0)
+        {
+          glDeleteBuffers(1, &m_buffers[i]);
+          m_buffers[i] = 0;
+          m_sizes[i] = 0;
+        }
+    }
+}
+
+void
+fastuidraw::gl::detail::PixelUnpackRing::
+forget_buffers(void)
+{
+  m_buffers = vecN<GLuint, number_buffers>(0);
+  m_sizes = vecN<unsigned int, number_buffers>(0);
+}
+
+void
+fastuidraw::gl::detail::PixelUnpackRing::
+bind_with_data(const_c_array<uint8_t> data)
+{
+  m_current = (m_current + 1) % number_buffers;
+  if(m_buffers[m_current] == 0)
+    {
+      glGenBuffers(1, &m_buffers[m_current]);
+      assert(m_buffers[m_current] != 0);
+    }
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffers[m_current]);
+  if(data.size() > m_sizes[m_current])
+    {
+      /* grow the buffer, giving it the texels as its
+         initial contents.
+       */
+      m_sizes[m_current] = data.size();
+      glBufferData(GL_PIXEL_UNPACK_BUFFER, data.size(), data.c_ptr(), GL_STREAM_DRAW);
+    }
+  else
+    {
+      void *ptr;
+
+      /* orphan the old contents so that the GL does not
+         need to wait for previous uploads to complete.
+       */
+      ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, data.size(),
+                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+      assert(ptr != NULL);
+      std::memcpy(ptr, data.c_ptr(), data.size());
+      glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+}
+
+void
+fastuidraw::gl::detail::PixelUnpackRing::
+unbind(void)
+{
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
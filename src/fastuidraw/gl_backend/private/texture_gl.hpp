@@ -22,16 +22,39 @@
 #include <list>
 #include <vector>
 #include <algorithm>
+#include <cstring>
 
 #include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/util.hpp>
 #include <fastuidraw/gl_backend/ngl_header.hpp>
 #include <fastuidraw/gl_backend/gl_context_properties.hpp>
+#include "upload_stats.hpp"
+#include "../../private/util_private.hpp"
 
 namespace fastuidraw { namespace gl { namespace detail {
 
 GLenum
 format_from_internal_format(GLenum fmt);
 
+/* returns true if fmt is a block compressed format, the
+   texels of a texture of such a format are uploaded with
+   glCompressedTexSubImage as the compressed blocks.
+ */
+bool
+is_compressed_internal_format(GLenum fmt);
+
+/* returns the width and height in texels of the blocks
+   of a compressed internal format and 1 otherwise.
+ */
+int
+compressed_block_size(GLenum fmt);
+
+/* returns the number of bytes of a texel of the given
+   external format and type, or for a compressed internal
+   format the number of bytes of a block.
+ */
+unsigned int
+element_bytes(GLenum internal_format, GLenum external_format, GLenum external_type);
 
 
 class CopyImageSubData
@@ -126,6 +149,18 @@ tex_sub_image(GLenum texture_target, vecN<GLint, 3> offset,
                   format, type, pixels);
 }
 
+inline
+void
+compressed_tex_sub_image(GLenum texture_target, vecN<GLint, 3> offset,
+                         vecN<GLsizei, 3> size, GLenum internal_format,
+                         GLsizei num_bytes, const void *data)
+{
+  glCompressedTexSubImage3D(texture_target, 0,
+                            offset.x(), offset.y(), offset.z(),
+                            size.x(), size.y(), size.z(),
+                            internal_format, num_bytes, data);
+}
+
 //////////////////////////////////////////////
 // 2D
 
@@ -188,6 +223,20 @@ tex_sub_image(GLenum texture_target,
                   format, type, pixels);
 }
 
+inline
+void
+compressed_tex_sub_image(GLenum texture_target,
+                         vecN<GLint, 2> offset,
+                         vecN<GLsizei, 2> size,
+                         GLenum internal_format,
+                         GLsizei num_bytes, const void *data)
+{
+  glCompressedTexSubImage2D(texture_target, 0,
+                            offset.x(), offset.y(),
+                            size.x(), size.y(),
+                            internal_format, num_bytes, data);
+}
+
 
 //////////////////////////////////////////
 // 1D
@@ -232,13 +281,64 @@ tex_sub_image(GLenum texture_target, vecN<GLint, 1> offset,
   glTexSubImage1D(texture_target, 0, offset.x(), size.x(), format, type, pixels);
 }
 
+inline
+void
+compressed_tex_sub_image(GLenum texture_target, vecN<GLint, 1> offset,
+                         vecN<GLsizei, 1> size, GLenum internal_format,
+                         GLsizei num_bytes, const void *data)
+{
+  glCompressedTexSubImage1D(texture_target, 0, offset.x(), size.x(),
+                            internal_format, num_bytes, data);
+}
+
 #endif
 
+/* A PixelUnpackRing is a ring of buffer objects from which
+   TextureGLGeneric::flush() issues the delayed texel uploads:
+   all the texels of a flush are sent to the GL with a single
+   buffer upload and each glTexSubImage call then reads from
+   that buffer. The buffers are used in turn so that writing
+   the texels of a flush does not need to wait for the GL to
+   finish reading the texels of the previous flush.
+ */
+class PixelUnpackRing:noncopyable
+{
+public:
+  enum { number_buffers = 3 };
+
+  PixelUnpackRing(void);
+  ~PixelUnpackRing();
+
+  /* bind the next buffer of the ring to GL_PIXEL_UNPACK_BUFFER
+     and set its contents to data; the offset to pass as the pixel
+     pointer for the byte data[k] is then k.
+   */
+  void
+  bind_with_data(const_c_array<uint8_t> data);
+
+  /* unbind the buffer bound by bind_with_data() */
+  void
+  unbind(void);
+
+  void
+  delete_buffers(void);
+
+  /* drop the names of the buffers without deleting them,
+     for when the GL context that made them is lost.
+   */
+  void
+  forget_buffers(void);
+
+private:
+  vecN<GLuint, number_buffers> m_buffers;
+  vecN<unsigned int, number_buffers> m_sizes;
+  unsigned int m_current;
+};
+
 template<size_t N>
 class EntryLocationN
 {
 public:
-  typedef std::pair<EntryLocationN, std::vector<uint8_t> > with_data;
   vecN<int, N> m_location;
   vecN<GLsizei, N> m_size;
 };
@@ -273,45 +373,206 @@ public:
   set_data_vector(const EntryLocation &loc,
                   std::vector<uint8_t> &data);
 
+  /* if the internal format is compressed (see
+     is_compressed_internal_format()), data holds the
+     compressed blocks of the region loc.
+   */
   void
   set_data_c_array(const EntryLocation &loc,
                    const_c_array<uint8_t> data);
 
+  /* copy the texels of the region src to the region of
+     the same size at dst, the regions must not overlap;
+     when delayed, the copy is performed by flush() in
+     order with the delayed uploads.
+   */
+  void
+  copy_data(const EntryLocation &src, const vecN<int, N> &dst);
+
+  /* resize the texture, the storage of the GL texture is only
+     re-created (with the old texels copied on the GPU by m_blitter)
+     if the new size does not fit the current storage; for layered
+     targets the number of layers of the new storage is then at
+     least double the old, so that atlases that grow a layer at a
+     time re-create their texture only a logarithmic number of times.
+     If the new size is smaller in some dimension, the next flush()
+     re-creates the storage at exactly the new size after issuing
+     the delayed uploads and copies, so these may still read from
+     the region that is cut away.
+   */
   void
   resize(vecN<int, N> new_num_layers)
   {
+    if(m_keep_cpu_mirror)
+      {
+        resize_mirror(new_num_layers);
+      }
+    for(unsigned int i = 0; i < N; ++i)
+      {
+        m_shrink_requested = m_shrink_requested || new_num_layers[i] < m_dims[i];
+        m_peak_dims[i] = std::max(m_peak_dims[i], new_num_layers[i]);
+      }
     m_dims = new_num_layers;
   }
 
+  /* keep a copy of the texels of the texture in CPU memory
+     so that recreate_from_cpu_mirror() can re-create the
+     texture on a new GL context; must be called before any
+     data is set.
+   */
+  void
+  keep_cpu_mirror(void);
+
+  bool
+  has_cpu_mirror(void) const
+  {
+    return m_keep_cpu_mirror;
+  }
+
+  /* for after the GL context of the texture is lost: drop
+     the old GL names without deleting them, create the texture
+     on the current GL context and upload the CPU mirror to it.
+     The delayed uploads and copies not yet flushed are already
+     in the mirror and are dropped.
+   */
+  void
+  recreate_from_cpu_mirror(void);
+
 private:
 
+  /* true if the last dimension of the texture is the layer */
+  static
+  bool
+  layered(void)
+  {
+    #ifdef GL_TEXTURE_1D_ARRAY
+      {
+        if(texture_target == GL_TEXTURE_1D_ARRAY)
+          {
+            return true;
+          }
+      }
+    #endif
+    return texture_target == GL_TEXTURE_2D_ARRAY;
+  }
+
   void
   create_texture(void) const;
 
   void
-  tex_subimage(const EntryLocation &loc,
-               const_c_array<uint8_t> data);
+  tex_sub_image_region(const EntryLocation &loc,
+                       const void *data, unsigned int num_bytes);
 
   void
   flush_size_change(void);
 
+  /* re-create the storage of the GL texture at exactly m_dims */
+  void
+  shrink_storage(void);
+
+  /* copy the region [0, dims) of old_texture to m_texture */
+  void
+  blit_from(GLuint old_texture, const vecN<int, N> &dims);
+
+  void
+  copy_region(const EntryLocation &src, const vecN<int, N> &dst);
+
+  /* dimensions in elements (texels or compressed
+     blocks) of the mirror of a texture of size dims
+   */
+  vecN<int, N>
+  mirror_dims(const vecN<int, N> &dims) const;
+
+  /* offset in bytes into m_mirror of the element p
+     of a mirror of dimensions dims
+   */
+  unsigned int
+  mirror_offset(const vecN<int, N> &p, const vecN<int, N> &dims) const;
+
+  /* the region in elements of a region in texels */
+  EntryLocation
+  mirror_region(const EntryLocation &loc) const;
+
+  void
+  resize_mirror(const vecN<int, N> &new_dims);
+
+  void
+  write_mirror(const EntryLocation &loc, const_c_array<uint8_t> data);
+
+  void
+  copy_mirror(const EntryLocation &src, const vecN<int, N> &dst);
+
+  /* the rows of a region are the runs of elements along the
+     first dimension; returns the number of rows of a region
+     of size sz and the coordinate within the region of
+     the start of the row r.
+   */
+  static
+  unsigned int
+  number_rows(const vecN<GLsizei, N> &sz);
+
+  static
+  vecN<int, N>
+  row_start(unsigned int r, const vecN<GLsizei, N> &sz);
+
+  /* a delayed upload, its texels are m_staging[m_begin, m_end),
+     or if m_copy is true, a delayed copy of the region
+     m_location to m_copy_dst.
+   */
+  class UnflushedCommand
+  {
+  public:
+    UnflushedCommand(void):
+      m_begin(0),
+      m_end(0),
+      m_copy(false)
+    {}
+
+    EntryLocation m_location;
+    unsigned int m_begin, m_end;
+    bool m_copy;
+    vecN<int, N> m_copy_dst;
+  };
+
   GLenum m_internal_format;
   GLenum m_external_format;
   GLenum m_external_type;
   GLenum m_filter;
+  bool m_compressed;
 
   bool m_delayed;
+
+  /* m_dims is the size of the texture as seen by the atlas,
+     m_texture_dimension is the size of the storage of the GL
+     texture which is atleast m_dims once flushed. m_peak_dims
+     is the largest size m_dims took since the last flush() and
+     is the size the unflushed commands need; m_shrink_requested
+     is true if m_dims became smaller since the last flush().
+   */
   vecN<int, N> m_dims;
   vecN<int, N> m_texture_dimension;
+  vecN<int, N> m_peak_dims;
+  bool m_shrink_requested;
   mutable GLuint m_texture;
   mutable bool m_use_tex_storage;
   mutable int m_number_times_create_texture_called;
   CopyImageSubData m_blitter;
 
-  typedef typename EntryLocation::with_data with_data;
-  typedef std::list<with_data> list_type;
-
-  list_type m_unflushed_commands;
+  /* the texels of all delayed uploads are packed into
+     m_staging and sent to the GL with m_unpack_ring
+   */
+  std::vector<UnflushedCommand> m_unflushed_commands;
+  std::vector<uint8_t> m_staging;
+  PixelUnpackRing m_unpack_ring;
+
+  /* if m_keep_cpu_mirror is true, m_mirror holds the texels
+     (or compressed blocks) of the texture, row-major with the
+     first dimension fastest, for a texture of size m_dims.
+   */
+  bool m_keep_cpu_mirror;
+  int m_block_size;
+  unsigned int m_element_bytes;
+  std::vector<uint8_t> m_mirror;
 };
 
 ///////////////////////////////////////
@@ -327,16 +588,22 @@ TextureGLGeneric(GLenum internal_format,
   m_external_format(external_format),
   m_external_type(external_type),
   m_filter(filter),
+  m_compressed(is_compressed_internal_format(internal_format)),
   m_delayed(delayed),
   m_dims(dims),
+  m_texture_dimension(dims),
+  m_peak_dims(dims),
+  m_shrink_requested(false),
   m_texture(0),
-  m_number_times_create_texture_called(0)
+  m_number_times_create_texture_called(0),
+  m_keep_cpu_mirror(false),
+  m_block_size(compressed_block_size(internal_format)),
+  m_element_bytes(element_bytes(internal_format, external_format, external_type))
 {
   if(!m_delayed)
     {
       create_texture();
     }
-  m_texture_dimension = m_dims;
 }
 
 template<GLenum texture_target>
@@ -347,6 +614,7 @@ TextureGLGeneric<texture_target>::
     {
       delete_texture();
     }
+  m_unpack_ring.delete_buffers();
 }
 
 template<GLenum texture_target>
@@ -354,63 +622,121 @@ void
 TextureGLGeneric<texture_target>::
 flush_size_change(void)
 {
-  if(m_texture_dimension != m_dims)
+  vecN<int, N> old_texture_dimension(m_texture_dimension);
+  bool fits(true);
+
+  for(unsigned int i = 0; i < N; ++i)
     {
-      /* only need to issue GL commands to resize
-         the underlying GL texture IF we do not have
-         a texture yet.
-       */
-      if(m_texture != 0)
+      fits = fits && m_peak_dims[i] <= m_texture_dimension[i];
+      m_texture_dimension[i] = std::max(m_peak_dims[i], m_texture_dimension[i]);
+    }
+
+  if(fits)
+    {
+      return;
+    }
+
+  /* only need to issue GL commands to resize
+     the underlying GL texture IF we do not have
+     a texture yet.
+   */
+  if(m_texture != 0)
+    {
+      GLuint old_texture;
+
+      if(layered())
         {
-          GLuint old_texture;
-
-          old_texture = m_texture;
-          /* create a new texture for the new size,
-           */
-          m_texture = 0;
-          create_texture();
-
-          /* copy the contents of old_texture to m_texture
-           */
-          vecN<GLint, 3> blit_dims;
-          for(unsigned int i = 0; i < N; ++i)
-            {
-              blit_dims[i] = std::min(m_dims[i], m_texture_dimension[i]);
-            }
-          for(unsigned int i = N; i < 3; ++i)
-            {
-              blit_dims[i] = 1;
-            }
+          m_texture_dimension[N - 1] = std::max(m_texture_dimension[N - 1],
+                                                2 * old_texture_dimension[N - 1]);
+        }
 
-          #ifdef GL_TEXTURE_1D_ARRAY
-            {
-              /* Sighs. The GL API is utterly wonky. For GL_TEXTURE_1D_ARRAY,
-                 we need to permute [2] and [1].
-                 "Slices of a TEXTURE_1D_ARRAY, TEXTURE_2D_ARRAY, TEXTURE_CUBE_MAP_ARRAY
-                 TEXTURE_3D and faces of TEXTURE_CUBE_MAP are all compatible provided
-                 they share a compatible internal format, and multiple slices or faces
-                 may be copied between these objects with a single call by specifying the
-                 starting slice with <srcZ> and <dstZ>, and the number of slices to
-                 be copied with <srcDepth>.
-              */
-              if(texture_target == GL_TEXTURE_1D_ARRAY)
-                {
-                  std::swap(blit_dims[1], blit_dims[2]);
-                }
-            }
-          #endif
+      old_texture = m_texture;
+      /* create a new texture for the new size,
+       */
+      m_texture = 0;
+      create_texture();
+
+      /* copy the contents of old_texture to m_texture
+       */
+      blit_from(old_texture, old_texture_dimension);
 
-          m_blitter(old_texture, texture_target, 0,
-                    0, 0, 0, //src
-                    m_texture, texture_target, 0,
-                    0, 0, 0, //dst
-                    blit_dims[0], blit_dims[1], blit_dims[2]);
+      /* now delete old_texture
+       */
+      glDeleteTextures(1, &old_texture);
+      note_atlas_resize();
+    }
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+blit_from(GLuint old_texture, const vecN<int, N> &dims)
+{
+  vecN<GLint, 3> blit_dims;
+  for(unsigned int i = 0; i < N; ++i)
+    {
+      blit_dims[i] = dims[i];
+    }
+  for(unsigned int i = N; i < 3; ++i)
+    {
+      blit_dims[i] = 1;
+    }
 
-          /* now delete old_texture
-           */
-          glDeleteTextures(1, &old_texture);
+  #ifdef GL_TEXTURE_1D_ARRAY
+    {
+      /* Sighs. The GL API is utterly wonky. For GL_TEXTURE_1D_ARRAY,
+         we need to permute [2] and [1].
+         "Slices of a TEXTURE_1D_ARRAY, TEXTURE_2D_ARRAY, TEXTURE_CUBE_MAP_ARRAY
+         TEXTURE_3D and faces of TEXTURE_CUBE_MAP are all compatible provided
+         they share a compatible internal format, and multiple slices or faces
+         may be copied between these objects with a single call by specifying the
+         starting slice with <srcZ> and <dstZ>, and the number of slices to
+         be copied with <srcDepth>.
+      */
+      if(texture_target == GL_TEXTURE_1D_ARRAY)
+        {
+          std::swap(blit_dims[1], blit_dims[2]);
         }
-      m_texture_dimension = m_dims;
+    }
+  #endif
+
+  m_blitter(old_texture, texture_target, 0,
+            0, 0, 0, //src
+            m_texture, texture_target, 0,
+            0, 0, 0, //dst
+            blit_dims[0], blit_dims[1], blit_dims[2]);
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+shrink_storage(void)
+{
+  vecN<int, N> common;
+  bool same(true);
+
+  m_shrink_requested = false;
+  for(unsigned int i = 0; i < N; ++i)
+    {
+      same = same && m_dims[i] == m_texture_dimension[i];
+      common[i] = std::min(m_dims[i], m_texture_dimension[i]);
+    }
+
+  if(same)
+    {
+      return;
+    }
+
+  m_texture_dimension = m_dims;
+  if(m_texture != 0)
+    {
+      GLuint old_texture(m_texture);
+
+      m_texture = 0;
+      create_texture();
+      blit_from(old_texture, common);
+      glDeleteTextures(1, &old_texture);
+      note_atlas_resize();
     }
 }
 
@@ -450,7 +776,11 @@ create_texture(void) const
       m_use_tex_storage = ctx.is_es() || ctx.version() >= ivec2(4, 2)
         || ctx.has_extension("GL_ARB_texture_storage");
     }
-  tex_storage(m_use_tex_storage, texture_target, m_internal_format, m_dims);
+  /* the compressed formats supported are only core in
+     GL versions that also have glTexStorage
+   */
+  assert(!m_compressed || m_use_tex_storage);
+  tex_storage(m_use_tex_storage, texture_target, m_internal_format, m_texture_dimension);
   glTexParameteri(texture_target, GL_TEXTURE_MIN_FILTER, m_filter);
   glTexParameteri(texture_target, GL_TEXTURE_MAG_FILTER, m_filter);
   ++m_number_times_create_texture_called;
@@ -472,18 +802,40 @@ flush(void)
     {
       glBindTexture(texture_target, m_texture);
       glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-      for(typename list_type::iterator iter = m_unflushed_commands.begin(),
+      if(!m_staging.empty())
+        {
+          m_unpack_ring.bind_with_data(make_c_array(m_staging));
+        }
+      for(typename std::vector<UnflushedCommand>::const_iterator iter = m_unflushed_commands.begin(),
             end = m_unflushed_commands.end(); iter != end; ++iter)
         {
-          assert(!iter->second.empty());
-          tex_sub_image(texture_target,
-                        iter->first.m_location,
-                        iter->first.m_size,
-                        m_external_format, m_external_type,
-                        &iter->second[0]);
+          if(iter->m_copy)
+            {
+              copy_region(iter->m_location, iter->m_copy_dst);
+            }
+          else
+            {
+              const uint8_t *offset(NULL);
+
+              assert(iter->m_begin < iter->m_end);
+              offset += iter->m_begin;
+              tex_sub_image_region(iter->m_location, offset,
+                                   iter->m_end - iter->m_begin);
+            }
+        }
+      if(!m_staging.empty())
+        {
+          m_unpack_ring.unbind();
         }
       m_unflushed_commands.clear();
+      m_staging.clear();
+    }
+
+  if(m_shrink_requested)
+    {
+      shrink_storage();
     }
+  m_peak_dims = m_dims;
 }
 
 
@@ -492,61 +844,333 @@ void
 TextureGLGeneric<texture_target>::
 set_data_vector(const EntryLocation &loc,
                 std::vector<uint8_t> &data)
+{
+  set_data_c_array(loc, make_c_array(data));
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+set_data_c_array(const EntryLocation &loc,
+                 fastuidraw::const_c_array<uint8_t> data)
 {
   if(data.empty())
     {
       return;
     }
 
+  if(m_keep_cpu_mirror)
+    {
+      write_mirror(loc, data);
+    }
+
   if(m_delayed)
     {
-      m_unflushed_commands.push_back(typename EntryLocation::with_data());
-      typename EntryLocation::with_data &R(m_unflushed_commands.back());
-      R.first = loc;
-      R.second.swap(data);
+      UnflushedCommand C;
+
+      C.m_location = loc;
+      C.m_begin = m_staging.size();
+      m_staging.insert(m_staging.end(), data.begin(), data.end());
+      C.m_end = m_staging.size();
+      m_unflushed_commands.push_back(C);
     }
   else
     {
       flush_size_change();
       glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
       glBindTexture(texture_target, m_texture);
+      tex_sub_image_region(loc, data.c_ptr(), data.size());
+    }
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+tex_sub_image_region(const EntryLocation &loc,
+                     const void *data, unsigned int num_bytes)
+{
+  if(m_compressed)
+    {
+      compressed_tex_sub_image(texture_target,
+                               loc.m_location,
+                               loc.m_size,
+                               m_internal_format,
+                               num_bytes, data);
+    }
+  else
+    {
       tex_sub_image(texture_target,
                     loc.m_location,
                     loc.m_size,
                     m_external_format, m_external_type,
-                    &data[0]);
+                    data);
     }
+  note_bytes_uploaded(num_bytes);
 }
 
 template<GLenum texture_target>
 void
 TextureGLGeneric<texture_target>::
-set_data_c_array(const EntryLocation &loc,
-                 fastuidraw::const_c_array<uint8_t> data)
+copy_data(const EntryLocation &src, const vecN<int, N> &dst)
 {
-  if(data.empty())
+  if(m_keep_cpu_mirror)
     {
-      return;
+      copy_mirror(src, dst);
     }
 
   if(m_delayed)
     {
-      std::vector<uint8_t> data_copy;
-      data_copy.resize(data.size());
-      std::copy(data.begin(), data.end(), data_copy.begin());
-      set_data_vector(loc, data_copy);
+      UnflushedCommand C;
+
+      C.m_location = src;
+      C.m_copy = true;
+      C.m_copy_dst = dst;
+      m_unflushed_commands.push_back(C);
     }
   else
     {
       flush_size_change();
-      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-      glBindTexture(texture_target, m_texture);
-      tex_sub_image(texture_target,
-                    loc.m_location,
-                    loc.m_size,
-                    m_external_format, m_external_type,
-                    data.c_ptr());
+      copy_region(src, dst);
+    }
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+copy_region(const EntryLocation &src, const vecN<int, N> &dst)
+{
+  vecN<GLint, 3> src_location(0), dst_location(0), copy_dims(1);
+
+  for(unsigned int i = 0; i < N; ++i)
+    {
+      src_location[i] = src.m_location[i];
+      dst_location[i] = dst[i];
+      copy_dims[i] = src.m_size[i];
+    }
+
+  #ifdef GL_TEXTURE_1D_ARRAY
+    {
+      /* the layer of a GL_TEXTURE_1D_ARRAY is given
+         by the z-coordinate to glCopyImageSubData,
+         see flush_size_change().
+       */
+      if(texture_target == GL_TEXTURE_1D_ARRAY)
+        {
+          std::swap(src_location[1], src_location[2]);
+          std::swap(dst_location[1], dst_location[2]);
+          std::swap(copy_dims[1], copy_dims[2]);
+        }
+    }
+  #endif
+
+  m_blitter(m_texture, texture_target, 0,
+            src_location[0], src_location[1], src_location[2],
+            m_texture, texture_target, 0,
+            dst_location[0], dst_location[1], dst_location[2],
+            copy_dims[0], copy_dims[1], copy_dims[2]);
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+keep_cpu_mirror(void)
+{
+  assert(m_unflushed_commands.empty());
+  if(!m_keep_cpu_mirror)
+    {
+      vecN<int, N> md(mirror_dims(m_dims));
+      unsigned int sz(m_element_bytes);
+
+      for(unsigned int i = 0; i < N; ++i)
+        {
+          sz *= md[i];
+        }
+      m_keep_cpu_mirror = true;
+      m_mirror.resize(sz, 0);
+    }
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+recreate_from_cpu_mirror(void)
+{
+  EntryLocation loc;
+
+  assert(m_keep_cpu_mirror);
+
+  m_texture = 0;
+  m_unpack_ring.forget_buffers();
+  m_unflushed_commands.clear();
+  m_staging.clear();
+  m_texture_dimension = m_dims;
+  m_peak_dims = m_dims;
+  m_shrink_requested = false;
+  create_texture();
+
+  loc.m_location = vecN<int, N>(0);
+  for(unsigned int i = 0; i < N; ++i)
+    {
+      loc.m_size[i] = m_dims[i];
+    }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glBindTexture(texture_target, m_texture);
+  tex_sub_image_region(loc, &m_mirror[0], m_mirror.size());
+}
+
+template<GLenum texture_target>
+typename TextureGLGeneric<texture_target>::DimensionType
+TextureGLGeneric<texture_target>::
+mirror_dims(const vecN<int, N> &dims) const
+{
+  vecN<int, N> R(dims);
+
+  /* compressed blocks are square blocks of the
+     first two dimensions
+   */
+  for(unsigned int i = 0; i < N && i < 2; ++i)
+    {
+      R[i] = (R[i] + m_block_size - 1) / m_block_size;
+    }
+  return R;
+}
+
+template<GLenum texture_target>
+unsigned int
+TextureGLGeneric<texture_target>::
+mirror_offset(const vecN<int, N> &p, const vecN<int, N> &dims) const
+{
+  unsigned int R(0);
+
+  for(unsigned int i = N; i > 0; --i)
+    {
+      R = R * dims[i - 1] + p[i - 1];
+    }
+  return R * m_element_bytes;
+}
+
+template<GLenum texture_target>
+typename TextureGLGeneric<texture_target>::EntryLocation
+TextureGLGeneric<texture_target>::
+mirror_region(const EntryLocation &loc) const
+{
+  EntryLocation R(loc);
+
+  for(unsigned int i = 0; i < N && i < 2; ++i)
+    {
+      assert(loc.m_location[i] % m_block_size == 0);
+      R.m_location[i] = loc.m_location[i] / m_block_size;
+      R.m_size[i] = (loc.m_size[i] + m_block_size - 1) / m_block_size;
+    }
+  return R;
+}
+
+template<GLenum texture_target>
+unsigned int
+TextureGLGeneric<texture_target>::
+number_rows(const vecN<GLsizei, N> &sz)
+{
+  unsigned int R(1);
+
+  for(unsigned int i = 1; i < N; ++i)
+    {
+      R *= sz[i];
+    }
+  return R;
+}
+
+template<GLenum texture_target>
+typename TextureGLGeneric<texture_target>::DimensionType
+TextureGLGeneric<texture_target>::
+row_start(unsigned int r, const vecN<GLsizei, N> &sz)
+{
+  vecN<int, N> R(0);
+
+  for(unsigned int i = 1; i < N; ++i)
+    {
+      R[i] = r % sz[i];
+      r /= sz[i];
+    }
+  return R;
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+resize_mirror(const vecN<int, N> &new_dims)
+{
+  vecN<int, N> old_md(mirror_dims(m_dims)), new_md(mirror_dims(new_dims));
+  vecN<GLsizei, N> common;
+  unsigned int sz(m_element_bytes), row_bytes;
+  bool only_last_changes(true);
+  std::vector<uint8_t> new_mirror;
+
+  for(unsigned int i = 0; i < N; ++i)
+    {
+      sz *= new_md[i];
+      common[i] = std::min(old_md[i], new_md[i]);
+      only_last_changes = only_last_changes && (i + 1 == N || old_md[i] == new_md[i]);
+    }
+
+  /* changing only the number of layers does not
+     change the location of the existing texels
+   */
+  if(only_last_changes)
+    {
+      m_mirror.resize(sz, 0);
+      return;
+    }
+
+  new_mirror.resize(sz, 0);
+  row_bytes = common[0] * m_element_bytes;
+  for(unsigned int r = 0, endr = number_rows(common); r < endr && row_bytes > 0; ++r)
+    {
+      vecN<int, N> p(row_start(r, common));
+      std::memcpy(&new_mirror[mirror_offset(p, new_md)],
+                  &m_mirror[mirror_offset(p, old_md)],
+                  row_bytes);
+    }
+  m_mirror.swap(new_mirror);
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+write_mirror(const EntryLocation &loc, const_c_array<uint8_t> data)
+{
+  EntryLocation R(mirror_region(loc));
+  vecN<int, N> md(mirror_dims(m_dims));
+  unsigned int row_bytes(R.m_size[0] * m_element_bytes);
+
+  for(unsigned int r = 0, endr = number_rows(R.m_size); r < endr; ++r)
+    {
+      vecN<int, N> p(row_start(r, R.m_size));
 
+      assert((r + 1) * row_bytes <= data.size());
+      p += R.m_location;
+      std::memcpy(&m_mirror[mirror_offset(p, md)], &data[r * row_bytes], row_bytes);
+    }
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+copy_mirror(const EntryLocation &src, const vecN<int, N> &dst)
+{
+  EntryLocation R(mirror_region(src)), D;
+  vecN<int, N> md(mirror_dims(m_dims));
+  unsigned int row_bytes(R.m_size[0] * m_element_bytes);
+
+  D.m_location = dst;
+  D.m_size = src.m_size;
+  D = mirror_region(D);
+  for(unsigned int r = 0, endr = number_rows(R.m_size); r < endr; ++r)
+    {
+      vecN<int, N> p(row_start(r, R.m_size));
+      std::memmove(&m_mirror[mirror_offset(p + D.m_location, md)],
+                   &m_mirror[mirror_offset(p + R.m_location, md)],
+                   row_bytes);
     }
 }
 
@@ -0,0 +1,77 @@
+/*!
+ * \file upload_stats.cpp
+ * \brief file upload_stats.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <fastuidraw/util/util.hpp>
+#include "upload_stats.hpp"
+
+namespace
+{
+  uint64_t&
+  bytes_uploaded(void)
+  {
+    static uint64_t R(0);
+    return R;
+  }
+
+  uint64_t&
+  atlas_resizes(void)
+  {
+    static uint64_t R(0);
+    return R;
+  }
+}
+
+void
+fastuidraw::gl::detail::
+note_bytes_uploaded(unsigned int num_bytes)
+{
+  #ifdef FASTUIDRAW_NO_STATS
+    {
+      FASTUIDRAWunused(num_bytes);
+    }
+  #else
+    {
+      bytes_uploaded() += num_bytes;
+    }
+  #endif
+}
+
+uint64_t
+fastuidraw::gl::detail::
+number_bytes_uploaded(void)
+{
+  return bytes_uploaded();
+}
+
+void
+fastuidraw::gl::detail::
+note_atlas_resize(void)
+{
+  #ifndef FASTUIDRAW_NO_STATS
+    {
+      ++atlas_resizes();
+    }
+  #endif
+}
+
+uint64_t
+fastuidraw::gl::detail::
+number_atlas_resizes(void)
+{
+  return atlas_resizes();
+}
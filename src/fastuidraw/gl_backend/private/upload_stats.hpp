@@ -0,0 +1,53 @@
+/*!
+ * \file upload_stats.hpp
+ * \brief file upload_stats.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+namespace fastuidraw { namespace gl { namespace detail {
+
+/* Running count of the bytes uploaded by TextureGLGeneric
+   and BufferGL, i.e. by the backing stores of the atlases.
+   PainterBackendGL reports the difference of the count
+   between PainterBackend::reset_stats() and the query as
+   PainterBackend::num_atlas_upload_bytes. The count is not
+   thread safe; it is only a statistic and is not updated
+   at all if FASTUIDRAW_NO_STATS is defined.
+ */
+void
+note_bytes_uploaded(unsigned int num_bytes);
+
+uint64_t
+number_bytes_uploaded(void);
+
+/* Running count of the number of times TextureGLGeneric and
+   BufferGL re-created their GL object to grow (copying the old
+   contents on the GPU), reported as PainterBackend::num_atlas_resizes
+   in the same way as number_bytes_uploaded().
+ */
+void
+note_atlas_resize(void);
+
+uint64_t
+number_atlas_resizes(void);
+
+} //namespace detail
+} //namespace gl
+} //namespace fastuidraw
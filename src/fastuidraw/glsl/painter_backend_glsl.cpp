@@ -71,13 +71,19 @@ namespace
   public:
     ConfigurationGLSLPrivate(void):
       m_use_hw_clip_planes(true),
+      m_rounded_rect_clipping(false),
       m_default_blend_shader_type(fastuidraw::PainterBlendShader::dual_src),
-      m_non_dashed_stroke_shader_uses_discard(false)
+      m_blend_equation_advanced(false),
+      m_non_dashed_stroke_shader_uses_discard(false),
+      m_dashed_stroke_shader_uses_discard(true)
     {}
 
     bool m_use_hw_clip_planes;
+    bool m_rounded_rect_clipping;
     enum fastuidraw::PainterBlendShader::shader_type m_default_blend_shader_type;
+    bool m_blend_equation_advanced;
     bool m_non_dashed_stroke_shader_uses_discard;
+    bool m_dashed_stroke_shader_uses_discard;
   };
 
   class BindingPointsPrivate
@@ -93,6 +99,7 @@ namespace
       m_glyph_atlas_geometry_store(6),
       m_data_store_buffer_tbo(7),
       m_data_store_buffer_ubo(0),
+      m_data_store_buffer_ssbo(0),
       m_uniforms_ubo(1)
     {}
 
@@ -105,6 +112,7 @@ namespace
     unsigned int m_glyph_atlas_geometry_store;
     unsigned int m_data_store_buffer_tbo;
     unsigned int m_data_store_buffer_ubo;
+    unsigned int m_data_store_buffer_ssbo;
     unsigned int m_uniforms_ubo;
   };
 
@@ -121,6 +129,7 @@ namespace
       m_frag_shader_use_switch(false),
       m_blend_shader_use_switch(false),
       m_unpack_header_and_brush_in_frag_shader(false),
+      m_pack_varyings(false),
       m_data_store_backing(fastuidraw::glsl::PainterBackendGLSL::data_store_tbo),
       m_data_blocks_per_store_buffer(-1),
       m_glyph_geometry_backing(fastuidraw::glsl::PainterBackendGLSL::glyph_geometry_tbo),
@@ -128,7 +137,10 @@ namespace
       m_have_float_glyph_texture_atlas(true),
       m_colorstop_atlas_backing(fastuidraw::glsl::PainterBackendGLSL::colorstop_texture_1d_array),
       m_use_ubo_for_uniforms(true),
-      m_blend_type(fastuidraw::PainterBlendShader::dual_src)
+      m_bindless_images(false),
+      m_external_texture_images(false),
+      m_blend_type(fastuidraw::PainterBlendShader::dual_src),
+      m_precision_policy(fastuidraw::glsl::PainterBackendGLSL::precision_highp)
     {}
 
     enum fastuidraw::glsl::PainterBackendGLSL::z_coordinate_convention_t m_z_coordinate_convention;
@@ -140,6 +152,7 @@ namespace
     bool m_frag_shader_use_switch;
     bool m_blend_shader_use_switch;
     bool m_unpack_header_and_brush_in_frag_shader;
+    bool m_pack_varyings;
     enum fastuidraw::glsl::PainterBackendGLSL::data_store_backing_t m_data_store_backing;
     int m_data_blocks_per_store_buffer;
     enum fastuidraw::glsl::PainterBackendGLSL::glyph_geometry_backing_t m_glyph_geometry_backing;
@@ -147,10 +160,50 @@ namespace
     bool m_have_float_glyph_texture_atlas;
     enum fastuidraw::glsl::PainterBackendGLSL::colorstop_backing_t m_colorstop_atlas_backing;
     bool m_use_ubo_for_uniforms;
+    bool m_bindless_images;
+    bool m_external_texture_images;
     enum fastuidraw::PainterBlendShader::shader_type m_blend_type;
+    enum fastuidraw::glsl::PainterBackendGLSL::precision_policy_t m_precision_policy;
     fastuidraw::glsl::PainterBackendGLSL::BindingPoints m_binding_points;
   };
 
+  /* A ShaderUtilities holds the GLSL utility code added to the
+     uber-shaders. An entry added with a symbol (typically the name
+     of the function it defines) is only added to an uber-shader
+     whose code, or the code of another utility added to it,
+     references that symbol; an entry without a symbol is always
+     added. The entries are added in the order they were added
+     to the ShaderUtilities.
+   */
+  class ShaderUtilities
+  {
+  public:
+    void
+    add(const fastuidraw::glsl::ShaderSource &src, const char *symbol)
+    {
+      m_entries.push_back(entry());
+      m_entries.back().m_src.add_source(src);
+      if(symbol)
+        {
+          m_entries.back().m_symbol = symbol;
+        }
+    }
+
+    /* add to dst those utilities used by code */
+    void
+    add_used(fastuidraw::glsl::ShaderSource &dst, const std::string &code) const;
+
+  private:
+    class entry
+    {
+    public:
+      std::string m_symbol;
+      fastuidraw::glsl::ShaderSource m_src;
+    };
+
+    std::vector<entry> m_entries;
+  };
+
   class PainterBackendGLSLPrivate
   {
   public:
@@ -166,8 +219,34 @@ namespace
                      const fastuidraw::glsl::PainterBackendGLSL::ItemShaderFilter *item_shader_filter,
                      const char *discard_macro_value);
 
-    void
-    update_varying_size(const fastuidraw::glsl::varying_list &plist);
+    /* returns the item shaders that pass item_shader_filter,
+       using work as backing if necessary
+     */
+    fastuidraw::const_c_array<fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> >
+    filter_item_shaders(const fastuidraw::glsl::PainterBackendGLSL::ItemShaderFilter *item_shader_filter,
+                        std::vector<fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> > &work);
+
+    /* declare the brush, main and item shader varyings of an
+       uber-shader of item_shaders, returning the number of
+       varying slots used
+     */
+    unsigned int
+    declare_varyings(const fastuidraw::glsl::PainterBackendGLSL::UberShaderParams &params,
+                     fastuidraw::const_c_array<fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> > item_shaders,
+                     std::string *declare_brush_varyings,
+                     fastuidraw::glsl::detail::DeclareVaryingsStringDatum *brush_varying_datum,
+                     std::string *declare_main_varyings,
+                     fastuidraw::glsl::detail::DeclareVaryingsStringDatum *main_varying_datum,
+                     std::string *declare_shader_varyings,
+                     fastuidraw::glsl::detail::DeclareVaryingsStringDatum *shader_varying_datum);
+
+    const fastuidraw::glsl::varying_list&
+    main_varying_list(const fastuidraw::glsl::PainterBackendGLSL::UberShaderParams &params) const
+    {
+      return params.unpack_header_and_brush_in_frag_shader() ?
+        m_main_varyings_header_only :
+        m_main_varyings_shaders_and_shader_datas;
+    }
 
     std::string
     declare_shader_uniforms(const fastuidraw::glsl::PainterBackendGLSL::UberShaderParams &params);
@@ -194,12 +273,8 @@ namespace
     fastuidraw::vecN<BlendShaderGroup, fastuidraw::PainterBlendShader::number_types> m_blend_shaders;
     unsigned int m_next_blend_shader_ID;
     fastuidraw::glsl::ShaderSource m_constant_code;
-    fastuidraw::glsl::ShaderSource m_vert_shader_utils;
-    fastuidraw::glsl::ShaderSource m_frag_shader_utils;
-
-    fastuidraw::vecN<size_t, fastuidraw::glsl::varying_list::interpolation_number_types> m_number_float_varyings;
-    size_t m_number_uint_varyings;
-    size_t m_number_int_varyings;
+    ShaderUtilities m_vert_shader_utils;
+    ShaderUtilities m_frag_shader_utils;
 
     fastuidraw::glsl::varying_list m_main_varyings_header_only;
     fastuidraw::glsl::varying_list m_main_varyings_shaders_and_shader_datas;
@@ -213,6 +288,49 @@ namespace
   };
 }
 
+/////////////////////////////////////
+// ShaderUtilities methods
+void
+ShaderUtilities::
+add_used(fastuidraw::glsl::ShaderSource &dst, const std::string &code) const
+{
+  std::vector<bool> used(m_entries.size(), false);
+  std::vector<unsigned int> to_scan;
+
+  for(unsigned int i = 0, endi = m_entries.size(); i < endi; ++i)
+    {
+      if(m_entries[i].m_symbol.empty() || code.find(m_entries[i].m_symbol) != std::string::npos)
+        {
+          used[i] = true;
+          to_scan.push_back(i);
+        }
+    }
+
+  /* a utility can use another utility */
+  while(!to_scan.empty())
+    {
+      std::string src(m_entries[to_scan.back()].m_src.assembled_code());
+
+      to_scan.pop_back();
+      for(unsigned int i = 0, endi = m_entries.size(); i < endi; ++i)
+        {
+          if(!used[i] && src.find(m_entries[i].m_symbol) != std::string::npos)
+            {
+              used[i] = true;
+              to_scan.push_back(i);
+            }
+        }
+    }
+
+  for(unsigned int i = 0, endi = m_entries.size(); i < endi; ++i)
+    {
+      if(used[i])
+        {
+          dst.add_source(m_entries[i].m_src);
+        }
+    }
+}
+
 /////////////////////////////////////
 // PainterBackendGLSLPrivate methods
 PainterBackendGLSLPrivate::
@@ -222,9 +340,6 @@ PainterBackendGLSLPrivate(fastuidraw::glsl::PainterBackendGLSL *p,
   m_shader_code_added(false),
   m_next_item_shader_ID(1),
   m_next_blend_shader_ID(1),
-  m_number_float_varyings(0),
-  m_number_uint_varyings(0),
-  m_number_int_varyings(0),
   m_p(p)
 {
   /* add varyings needed by fastuidraw_painter_main
@@ -246,31 +361,59 @@ PainterBackendGLSLPrivate(fastuidraw::glsl::PainterBackendGLSL *p,
   shader_constants.add_constants(m_constant_code);
   add_texture_size_constants(m_constant_code);
 
-  m_vert_shader_utils
-    .add_source("fastuidraw_circular_interpolate.glsl.resource_string", ShaderSource::from_resource)
-    .add_source("fastuidraw_anisotropic.frag.glsl.resource_string", ShaderSource::from_resource)
-    .add_source("fastuidraw_unpack_unit_vector.glsl.resource_string", ShaderSource::from_resource)
-    .add_source("fastuidraw_compute_local_distance_from_pixel_distance.glsl.resource_string",
-                ShaderSource::from_resource)
-    .add_source("fastuidraw_align.vert.glsl.resource_string", ShaderSource::from_resource)
-    .add_source(code::compute_interval("fastuidraw_compute_interval", m_p->configuration_base().alignment()));
-
-  m_frag_shader_utils
-    .add_source("fastuidraw_circular_interpolate.glsl.resource_string", ShaderSource::from_resource)
-    .add_source("fastuidraw_anisotropic.frag.glsl.resource_string", ShaderSource::from_resource)
-    .add_source(code::compute_interval("fastuidraw_compute_interval", m_p->configuration_base().alignment()))
-    .add_source(code::image_atlas_compute_coord("fastuidraw_compute_image_atlas_coord",
-                                                "fastuidraw_imageIndexAtlas",
-                                                m_p->image_atlas()->index_tile_size(),
-                                                m_p->image_atlas()->color_tile_size()))
-    .add_source(code::curvepair_compute_pseudo_distance(m_p->glyph_atlas()->geometry_store()->alignment(),
-                                                                          "fastuidraw_curvepair_pseudo_distance",
-                                                                          "fastuidraw_fetch_glyph_data",
-                                                                          false))
-    .add_source(code::curvepair_compute_pseudo_distance(m_p->glyph_atlas()->geometry_store()->alignment(),
-                                                                          "fastuidraw_curvepair_pseudo_distance",
-                                                                          "fastuidraw_fetch_glyph_data",
-                                                                          true));
+  /* the utilities are only added to the uber-shaders that use
+     them, so each is given the name of the function it defines.
+   */
+  m_vert_shader_utils.add(ShaderSource()
+                          .add_source("fastuidraw_circular_interpolate.glsl.resource_string", ShaderSource::from_resource),
+                          "fastuidraw_circular_interpolate");
+  m_vert_shader_utils.add(ShaderSource()
+                          .add_source("fastuidraw_anisotropic.frag.glsl.resource_string", ShaderSource::from_resource),
+                          "fastuidraw_anisotropic_coverage");
+  m_vert_shader_utils.add(ShaderSource()
+                          .add_source("fastuidraw_unpack_unit_vector.glsl.resource_string", ShaderSource::from_resource),
+                          "fastuidraw_unpack_unit_vector");
+  m_vert_shader_utils.add(ShaderSource()
+                          .add_source("fastuidraw_compute_local_distance_from_pixel_distance.glsl.resource_string",
+                                      ShaderSource::from_resource),
+                          "fastuidraw_local_distance_from_pixel_distance");
+  m_vert_shader_utils.add(ShaderSource()
+                          .add_source("fastuidraw_align.vert.glsl.resource_string", ShaderSource::from_resource),
+                          "fastuidraw_align_normal_to_screen");
+  m_vert_shader_utils.add(code::compute_interval("fastuidraw_compute_interval", m_p->configuration_base().alignment()),
+                          "fastuidraw_compute_interval");
+
+  m_frag_shader_utils.add(ShaderSource()
+                          .add_source("fastuidraw_circular_interpolate.glsl.resource_string", ShaderSource::from_resource),
+                          "fastuidraw_circular_interpolate");
+  m_frag_shader_utils.add(ShaderSource()
+                          .add_source("fastuidraw_anisotropic.frag.glsl.resource_string", ShaderSource::from_resource),
+                          "fastuidraw_anisotropic_coverage");
+  m_frag_shader_utils.add(code::compute_interval("fastuidraw_compute_interval", m_p->configuration_base().alignment()),
+                          "fastuidraw_compute_interval");
+  m_frag_shader_utils.add(code::image_atlas_compute_coord("fastuidraw_compute_image_atlas_coord",
+                                                          "fastuidraw_imageIndexAtlas",
+                                                          m_p->image_atlas()->index_tile_size(),
+                                                          m_p->image_atlas()->color_tile_size()),
+                          "fastuidraw_compute_image_atlas_coord");
+  m_frag_shader_utils.add(ShaderSource()
+                          .add_source(code::curvepair_compute_pseudo_distance(m_p->glyph_atlas()->geometry_store()->alignment(),
+                                                                              "fastuidraw_curvepair_pseudo_distance",
+                                                                              "fastuidraw_fetch_glyph_data",
+                                                                              false))
+                          .add_source(code::curvepair_compute_pseudo_distance(m_p->glyph_atlas()->geometry_store()->alignment(),
+                                                                              "fastuidraw_curvepair_pseudo_distance",
+                                                                              "fastuidraw_fetch_glyph_data",
+                                                                              true)),
+                          "fastuidraw_curvepair_pseudo_distance");
+  m_frag_shader_utils.add(code::banded_curves_compute_coverage(m_p->glyph_atlas()->geometry_store()->alignment(),
+                                                               "fastuidraw_banded_curves_coverage",
+                                                               "fastuidraw_glyphTexelStoreUINT",
+                                                               "fastuidraw_fetch_glyph_data"),
+                          "fastuidraw_banded_curves_coverage");
+  m_frag_shader_utils.add(ShaderSource()
+                          .add_source("fastuidraw_msdf_sample.frag.glsl.resource_string", ShaderSource::from_resource),
+                          "fastuidraw_msdf_sample");
 }
 
 PainterBackendGLSLPrivate::
@@ -282,8 +425,14 @@ void
 PainterBackendGLSLPrivate::
 ready_main_varyings(void)
 {
+  using namespace fastuidraw::glsl;
+
+  /* fastuidraw_header_varying is the location of the cold
+     part of the header, see PainterHeader::offset_t
+   */
   m_main_varyings_header_only
     .add_uint_varying("fastuidraw_header_varying")
+    .add_uint_varying("fastuidraw_item_blend_shader_varying")
     .add_float_varying("fastuidraw_brush_p_x")
     .add_float_varying("fastuidraw_brush_p_y");
 
@@ -309,6 +458,29 @@ ready_main_varyings(void)
         .add_float_varying("fastuidraw_clip_plane2")
         .add_float_varying("fastuidraw_clip_plane3");
     }
+
+  if(m_config.rounded_rect_clipping())
+    {
+      /* the position in the coordinates of the rounded rect
+         is (fastuidraw_rounded_clip_x, fastuidraw_rounded_clip_y)
+         / fastuidraw_rounded_clip_q, see PainterClipEquations.
+       */
+      m_main_varyings_header_only
+        .add_float_varying("fastuidraw_rounded_clip_x")
+        .add_float_varying("fastuidraw_rounded_clip_y")
+        .add_float_varying("fastuidraw_rounded_clip_q")
+        .add_float_varying("fastuidraw_rounded_clip_half_width", varying_list::interpolation_flat)
+        .add_float_varying("fastuidraw_rounded_clip_half_height", varying_list::interpolation_flat)
+        .add_float_varying("fastuidraw_rounded_clip_radius", varying_list::interpolation_flat);
+
+      m_main_varyings_shaders_and_shader_datas
+        .add_float_varying("fastuidraw_rounded_clip_x")
+        .add_float_varying("fastuidraw_rounded_clip_y")
+        .add_float_varying("fastuidraw_rounded_clip_q")
+        .add_float_varying("fastuidraw_rounded_clip_half_width", varying_list::interpolation_flat)
+        .add_float_varying("fastuidraw_rounded_clip_half_height", varying_list::interpolation_flat)
+        .add_float_varying("fastuidraw_rounded_clip_radius", varying_list::interpolation_flat);
+    }
 }
 
 void
@@ -355,6 +527,15 @@ ready_brush_varyings(void)
                                      coordinate goes beyond image size)
        - fastuidraw_brush_image_factor ratio of master index tile size to
                                        dimension of image
+       - fastuidraw_brush_image_start start of the (sub)image within the image
+       - fastuidraw_brush_image_mipmap_size size of the entire image (only
+                                            needed for mipmapped images)
+       - fastuidraw_brush_image_number_mipmap_levels number of mipmap levels
+       - fastuidraw_brush_image_bindless_handle bindless handle of the
+                                                image (only for bindless
+                                                images)
+       - fastuidraw_brush_image_bindless_texture_size size of the texture
+                                                      of a bindless image
     */
     .add_float_varying("fastuidraw_brush_image_x", varying_list::interpolation_flat)
     .add_float_varying("fastuidraw_brush_image_y", varying_list::interpolation_flat)
@@ -364,6 +545,15 @@ ready_brush_varyings(void)
     .add_float_varying("fastuidraw_brush_image_factor", varying_list::interpolation_flat)
     .add_uint_varying("fastuidraw_brush_image_slack")
     .add_uint_varying("fastuidraw_brush_image_number_index_lookups")
+    .add_float_varying("fastuidraw_brush_image_start_x", varying_list::interpolation_flat)
+    .add_float_varying("fastuidraw_brush_image_start_y", varying_list::interpolation_flat)
+    .add_uint_varying("fastuidraw_brush_image_mipmap_size_x")
+    .add_uint_varying("fastuidraw_brush_image_mipmap_size_y")
+    .add_uint_varying("fastuidraw_brush_image_number_mipmap_levels")
+    .add_uint_varying("fastuidraw_brush_image_bindless_handle_low")
+    .add_uint_varying("fastuidraw_brush_image_bindless_handle_high")
+    .add_uint_varying("fastuidraw_brush_image_bindless_texture_size_x")
+    .add_uint_varying("fastuidraw_brush_image_bindless_texture_size_y")
 
     /* ColorStop paremeters (only active if gradient active)
        - fastuidraw_brush_color_stop_xy (x,y) texture coordinates of start of color stop
@@ -375,6 +565,23 @@ ready_brush_varyings(void)
     .add_float_varying("fastuidraw_brush_color_stop_y", varying_list::interpolation_flat)
     .add_float_varying("fastuidraw_brush_color_stop_length", varying_list::interpolation_flat)
 
+    /* Inline ColorStop parameters (only active if gradient active and
+       the color stops are packed in the brush)
+       - fastuidraw_brush_inline_color_stop_count number of color stops
+       - fastuidraw_brush_inline_color_stop_placeN place of the N'th color stop
+       - fastuidraw_brush_inline_color_stop_colorN color of the N'th color stop
+                                                   packed as RGBA8
+    */
+    .add_uint_varying("fastuidraw_brush_inline_color_stop_count")
+    .add_float_varying("fastuidraw_brush_inline_color_stop_place0", varying_list::interpolation_flat)
+    .add_float_varying("fastuidraw_brush_inline_color_stop_place1", varying_list::interpolation_flat)
+    .add_float_varying("fastuidraw_brush_inline_color_stop_place2", varying_list::interpolation_flat)
+    .add_float_varying("fastuidraw_brush_inline_color_stop_place3", varying_list::interpolation_flat)
+    .add_uint_varying("fastuidraw_brush_inline_color_stop_color0")
+    .add_uint_varying("fastuidraw_brush_inline_color_stop_color1")
+    .add_uint_varying("fastuidraw_brush_inline_color_stop_color2")
+    .add_uint_varying("fastuidraw_brush_inline_color_stop_color3")
+
     /* Pen color (RGBA)
      */
     .add_float_varying("fastuidraw_brush_pen_color_x", varying_list::interpolation_flat)
@@ -451,6 +658,11 @@ add_enums(fastuidraw::glsl::ShaderSource &src)
     .add_macro("fastuidraw_shader_repeat_window_mask", PainterBrush::repeat_window_mask)
     .add_macro("fastuidraw_shader_transformation_translation_mask", PainterBrush::transformation_translation_mask)
     .add_macro("fastuidraw_shader_transformation_matrix_mask", PainterBrush::transformation_matrix_mask)
+    .add_macro("fastuidraw_shader_image_mipmap_mask", PainterBrush::image_mipmap_mask)
+    .add_macro("fastuidraw_shader_image_bindless_mask", PainterBrush::image_bindless_mask)
+    .add_macro("fastuidraw_shader_image_external_texture_mask", PainterBrush::image_external_texture_mask)
+    .add_macro("fastuidraw_shader_image_premultiplied_alpha_mask", PainterBrush::image_premultiplied_alpha_mask)
+    .add_macro("fastuidraw_shader_gradient_inline_color_stops_mask", PainterBrush::gradient_inline_color_stops_mask)
     .add_macro("fastuidraw_image_number_index_lookup_bit0", PainterBrush::image_number_index_lookups_bit0)
     .add_macro("fastuidraw_image_number_index_lookup_num_bits", PainterBrush::image_number_index_lookups_num_bits)
     .add_macro("fastuidraw_image_slack_bit0", PainterBrush::image_slack_bit0)
@@ -472,18 +684,25 @@ add_enums(fastuidraw::glsl::ShaderSource &src)
 
     .add_macro("fastuidraw_shader_pen_num_blocks", number_blocks(alignment, PainterBrush::pen_data_size))
     .add_macro("fastuidraw_shader_image_num_blocks", number_blocks(alignment, PainterBrush::image_data_size))
+    .add_macro("fastuidraw_shader_image_mipmap_num_blocks", number_blocks(alignment, PainterBrush::image_mipmap_data_size))
+    .add_macro("fastuidraw_shader_image_bindless_num_blocks", number_blocks(alignment, PainterBrush::image_bindless_data_size))
     .add_macro("fastuidraw_shader_linear_gradient_num_blocks", number_blocks(alignment, PainterBrush::linear_gradient_data_size))
     .add_macro("fastuidraw_shader_radial_gradient_num_blocks", number_blocks(alignment, PainterBrush::radial_gradient_data_size))
+    .add_macro("fastuidraw_shader_gradient_inline_color_stops_num_blocks",
+               number_blocks(alignment, PainterBrush::gradient_inline_color_stops_data_size))
     .add_macro("fastuidraw_shader_repeat_window_num_blocks", number_blocks(alignment, PainterBrush::repeat_window_data_size))
     .add_macro("fastuidraw_shader_transformation_matrix_num_blocks", number_blocks(alignment, PainterBrush::transformation_matrix_data_size))
     .add_macro("fastuidraw_shader_transformation_translation_num_blocks", number_blocks(alignment, PainterBrush::transformation_translation_data_size))
     .add_macro("fastuidraw_stroke_dashed_stroking_params_header_num_blocks",
                number_blocks(alignment, PainterDashedStrokeParams::stroke_static_data_size))
+    .add_macro("fastuidraw_clipping_num_blocks", number_blocks(alignment, PainterClipEquations::clip_data_size))
+    .add_macro("fastuidraw_header_hot_num_blocks", PainterHeader::cold_header_location(alignment) / alignment)
 
     .add_macro("fastuidraw_item_shader_bit0", PainterHeader::item_shader_bit0)
     .add_macro("fastuidraw_item_shader_num_bits", PainterHeader::item_shader_num_bits)
     .add_macro("fastuidraw_blend_shader_bit0", PainterHeader::blend_shader_bit0)
     .add_macro("fastuidraw_blend_shader_num_bits", PainterHeader::blend_shader_num_bits)
+    .add_macro("fastuidraw_z_indirect_bit", PainterHeader::z_indirect_bit)
 
     /* offset types for stroking.
      */
@@ -507,6 +726,7 @@ add_enums(fastuidraw::glsl::ShaderSource &src)
     .add_macro("fastuidraw_stroke_boundary_bit", StrokedPath::boundary_bit)
     .add_macro("fastuidraw_stroke_join_mask", StrokedPath::join_mask)
     .add_macro("fastuidraw_stroke_bevel_edge_mask", StrokedPath::bevel_edge_mask)
+    .add_macro("fastuidraw_stroke_negative_boundary_mask", StrokedPath::negative_boundary_mask)
     .add_macro("fastuidraw_stroke_adjustable_cap_ending_mask", StrokedPath::adjustable_cap_ending_mask)
     .add_macro("fastuidraw_stroke_depth_bit0", StrokedPath::depth_bit0)
     .add_macro("fastuidraw_stroke_depth_num_bits", StrokedPath::depth_num_bits)
@@ -592,6 +812,27 @@ stream_unpack_code(fastuidraw::glsl::ShaderSource &str)
                               "fastuidraw_brush_image_data_raw");
   }
 
+  {
+    shader_unpack_value_set<PainterBrush::image_mipmap_data_size> labels;
+    labels
+      .set(PainterBrush::image_mipmap_dimensions_xy_offset, ".dimensions_xy", shader_unpack_value::uint_type)
+      .set(PainterBrush::image_mipmap_number_levels_offset, ".number_levels", shader_unpack_value::uint_type)
+      .stream_unpack_function(alignment, str,
+                              "fastuidraw_read_brush_image_mipmap_raw_data",
+                              "fastuidraw_brush_image_mipmap_raw");
+  }
+
+  {
+    shader_unpack_value_set<PainterBrush::image_bindless_data_size> labels;
+    labels
+      .set(PainterBrush::image_bindless_handle_low_offset, ".handle_low", shader_unpack_value::uint_type)
+      .set(PainterBrush::image_bindless_handle_high_offset, ".handle_high", shader_unpack_value::uint_type)
+      .set(PainterBrush::image_bindless_texture_size_xy_offset, ".texture_size_xy", shader_unpack_value::uint_type)
+      .stream_unpack_function(alignment, str,
+                              "fastuidraw_read_brush_image_bindless_raw_data",
+                              "fastuidraw_brush_image_bindless_raw");
+  }
+
   {
     shader_unpack_value_set<PainterBrush::linear_gradient_data_size> labels;
     labels
@@ -623,19 +864,62 @@ stream_unpack_code(fastuidraw::glsl::ShaderSource &str)
   }
 
   {
-    shader_unpack_value_set<PainterHeader::header_size> labels;
+    /* the GLSL reads the places and colors as a vec4 and a uvec4,
+       i.e. this assumes PainterBrush::max_inline_color_stops is 4.
+     */
+    shader_unpack_value_set<PainterBrush::gradient_inline_color_stops_data_size> labels;
     labels
+      .set(PainterBrush::gradient_inline_color_stops_count_offset, ".count", shader_unpack_value::uint_type)
+      .set(PainterBrush::gradient_inline_color_stops_place_offset + 0, ".places.x")
+      .set(PainterBrush::gradient_inline_color_stops_place_offset + 1, ".places.y")
+      .set(PainterBrush::gradient_inline_color_stops_place_offset + 2, ".places.z")
+      .set(PainterBrush::gradient_inline_color_stops_place_offset + 3, ".places.w")
+      .set(PainterBrush::gradient_inline_color_stops_color_offset + 0, ".colors.x", shader_unpack_value::uint_type)
+      .set(PainterBrush::gradient_inline_color_stops_color_offset + 1, ".colors.y", shader_unpack_value::uint_type)
+      .set(PainterBrush::gradient_inline_color_stops_color_offset + 2, ".colors.z", shader_unpack_value::uint_type)
+      .set(PainterBrush::gradient_inline_color_stops_color_offset + 3, ".colors.w", shader_unpack_value::uint_type)
+      .stream_unpack_function(alignment, str,
+                              "fastuidraw_read_brush_gradient_inline_color_stops",
+                              "fastuidraw_brush_gradient_inline_color_stops_raw");
+  }
+
+  {
+    /* the hot and cold parts of the header are read by separate
+       functions that fill the fields of the same struct (hence the
+       inout), so that a shader only fetches the part it needs.
+     */
+    shader_unpack_value_set<PainterHeader::hot_header_size> hot_labels;
+    shader_unpack_value_set<PainterHeader::header_size - PainterHeader::hot_header_size> cold_labels;
+    hot_labels
       .set(PainterHeader::clip_equations_location_offset, ".clipping_location", shader_unpack_value::uint_type)
       .set(PainterHeader::item_matrix_location_offset, ".item_matrix_location", shader_unpack_value::uint_type)
-      .set(PainterHeader::brush_shader_data_location_offset, ".brush_shader_data_location", shader_unpack_value::uint_type)
-      .set(PainterHeader::item_shader_data_location_offset, ".item_shader_data_location", shader_unpack_value::uint_type)
-      .set(PainterHeader::blend_shader_data_location_offset, ".blend_shader_data_location", shader_unpack_value::uint_type)
-      .set(PainterHeader::brush_shader_offset, ".brush_shader", shader_unpack_value::uint_type)
       .set(PainterHeader::z_offset, ".z", shader_unpack_value::uint_type)
-      .set(PainterHeader::item_blend_shader_offset, ".item_blend_shader_packed", shader_unpack_value::uint_type)
-      .stream_unpack_function(alignment, str,
-                              "fastuidraw_read_header",
-                              "fastuidraw_shader_header", false);
+      .set(PainterHeader::item_blend_shader_offset, ".item_blend_shader_packed", shader_unpack_value::uint_type);
+    cold_labels
+      .set(PainterHeader::item_shader_data_location_offset - PainterHeader::hot_header_size,
+           ".item_shader_data_location", shader_unpack_value::uint_type)
+      .set(PainterHeader::blend_shader_data_location_offset - PainterHeader::hot_header_size,
+           ".blend_shader_data_location", shader_unpack_value::uint_type)
+      .set(PainterHeader::brush_shader_offset - PainterHeader::hot_header_size,
+           ".brush_shader", shader_unpack_value::uint_type)
+      .set(PainterHeader::brush_shader_data_location_offset - PainterHeader::hot_header_size,
+           ".brush_shader_data_location", shader_unpack_value::uint_type);
+
+    str.add_source("void\n"
+                   "fastuidraw_read_header_hot(in uint location, inout fastuidraw_shader_header h)\n",
+                   ShaderSource::from_string);
+    hot_labels.stream_unpack_code(alignment, str, "location", "h");
+    str.add_source("\nvoid\n"
+                   "fastuidraw_read_header_cold(in uint location, inout fastuidraw_shader_header h)\n",
+                   ShaderSource::from_string);
+    cold_labels.stream_unpack_code(alignment, str, "location", "h");
+    str.add_source("\nvoid\n"
+                   "fastuidraw_read_header(in uint location, out fastuidraw_shader_header h)\n"
+                   "{\n"
+                   "  fastuidraw_read_header_hot(location, h);\n"
+                   "  fastuidraw_read_header_cold(location + uint(fastuidraw_header_hot_num_blocks), h);\n"
+                   "}\n\n",
+                   ShaderSource::from_string);
   }
 
   {
@@ -662,6 +946,30 @@ stream_unpack_code(fastuidraw::glsl::ShaderSource &str)
                               "fastuidraw_clipping_data", false);
   }
 
+  {
+    shader_unpack_value_set<PainterClipEquations::rounded_rect_data_size> labels;
+    labels
+      .set(PainterClipEquations::rounded_rect_x_coeff_x, ".x.x")
+      .set(PainterClipEquations::rounded_rect_x_coeff_y, ".x.y")
+      .set(PainterClipEquations::rounded_rect_x_coeff_w, ".x.z")
+
+      .set(PainterClipEquations::rounded_rect_y_coeff_x, ".y.x")
+      .set(PainterClipEquations::rounded_rect_y_coeff_y, ".y.y")
+      .set(PainterClipEquations::rounded_rect_y_coeff_w, ".y.z")
+
+      .set(PainterClipEquations::rounded_rect_q_coeff_x, ".q.x")
+      .set(PainterClipEquations::rounded_rect_q_coeff_y, ".q.y")
+      .set(PainterClipEquations::rounded_rect_q_coeff_w, ".q.z")
+
+      .set(PainterClipEquations::rounded_rect_half_width_offset, ".half_size.x")
+      .set(PainterClipEquations::rounded_rect_half_height_offset, ".half_size.y")
+      .set(PainterClipEquations::rounded_rect_radius_offset, ".radius")
+
+      .stream_unpack_function(alignment, str,
+                              "fastuidraw_read_rounded_clipping",
+                              "fastuidraw_rounded_clipping_data", false);
+  }
+
   {
     /* Matrics in GLSL are [column][row], that is why
        one sees the transposing to the loads
@@ -708,18 +1016,69 @@ stream_unpack_code(fastuidraw::glsl::ShaderSource &str)
   }
 }
 
-void
+fastuidraw::const_c_array<fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> >
 PainterBackendGLSLPrivate::
-update_varying_size(const fastuidraw::glsl::varying_list &plist)
+filter_item_shaders(const fastuidraw::glsl::PainterBackendGLSL::ItemShaderFilter *item_shader_filter,
+                    std::vector<fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> > &work)
 {
-  m_number_uint_varyings = std::max(m_number_uint_varyings, plist.uints().size());
-  m_number_int_varyings = std::max(m_number_int_varyings, plist.ints().size());
-  for(unsigned int i = 0; i < fastuidraw::glsl::varying_list::interpolation_number_types; ++i)
+  if(!item_shader_filter)
     {
-      enum fastuidraw::glsl::varying_list::interpolation_qualifier_t q;
-      q = static_cast<enum fastuidraw::glsl::varying_list::interpolation_qualifier_t>(i);
-      m_number_float_varyings[q] = std::max(m_number_float_varyings[q], plist.floats(q).size());
+      return fastuidraw::make_c_array(m_item_shaders);
     }
+
+  for(unsigned int i = 0, endi = m_item_shaders.size(); i < endi; ++i)
+    {
+      if(item_shader_filter->use_shader(m_item_shaders[i]))
+        {
+          work.push_back(m_item_shaders[i]);
+        }
+    }
+  return fastuidraw::make_c_array(work);
+}
+
+unsigned int
+PainterBackendGLSLPrivate::
+declare_varyings(const fastuidraw::glsl::PainterBackendGLSL::UberShaderParams &params,
+                 fastuidraw::const_c_array<fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> > item_shaders,
+                 std::string *declare_brush_varyings,
+                 fastuidraw::glsl::detail::DeclareVaryingsStringDatum *brush_varying_datum,
+                 std::string *declare_main_varyings,
+                 fastuidraw::glsl::detail::DeclareVaryingsStringDatum *main_varying_datum,
+                 std::string *declare_shader_varyings,
+                 fastuidraw::glsl::detail::DeclareVaryingsStringDatum *shader_varying_datum)
+{
+  using namespace fastuidraw::glsl::detail;
+
+  unsigned int varying_slot(0);
+  const fastuidraw::glsl::varying_list &main_list(main_varying_list(params));
+
+  if(!params.unpack_header_and_brush_in_frag_shader())
+    {
+      *declare_brush_varyings = declare_varyings_string("_brush",
+                                                        m_brush_varyings.uints().size(),
+                                                        m_brush_varyings.ints().size(),
+                                                        m_brush_varyings.float_counts(),
+                                                        &varying_slot,
+                                                        brush_varying_datum);
+    }
+
+  *declare_main_varyings = declare_varyings_string("_main",
+                                                   main_list.uints().size(),
+                                                   main_list.ints().size(),
+                                                   main_list.float_counts(),
+                                                   &varying_slot,
+                                                   main_varying_datum);
+
+  /* the item shader varyings are sized by the item shaders
+     of this uber-shader only, so that programs of a subset
+     of the item shaders (for example the programs with and
+     without discard) get their own, smaller, layout.
+   */
+  *declare_shader_varyings = declare_varyings_string("_shader", item_shaders,
+                                                     params.pack_varyings(),
+                                                     &varying_slot,
+                                                     shader_varying_datum);
+  return varying_slot;
 }
 
 std::string
@@ -795,21 +1154,7 @@ construct_shader(fastuidraw::glsl::ShaderSource &vert,
   std::vector<reference_counted_ptr<PainterItemShaderGLSL> > work_shaders;
   const_c_array<reference_counted_ptr<PainterItemShaderGLSL> > item_shaders;
 
-  if(item_shader_filter)
-    {
-      for(unsigned int i = 0, endi = m_item_shaders.size(); i < endi; ++i)
-        {
-          if(item_shader_filter->use_shader(m_item_shaders[i]))
-            {
-              work_shaders.push_back(m_item_shaders[i]);
-            }
-        }
-      item_shaders = make_c_array(work_shaders);
-    }
-  else
-    {
-      item_shaders = make_c_array(m_item_shaders);
-    }
+  item_shaders = filter_item_shaders(item_shader_filter, work_shaders);
 
   if(params.assign_layout_to_vertex_shader_inputs())
     {
@@ -858,35 +1203,11 @@ construct_shader(fastuidraw::glsl::ShaderSource &vert,
       binding_layout_macro = ostr.str();
     }
 
-  unsigned int varying_slot(0);
-  if(params.unpack_header_and_brush_in_frag_shader())
-    {
-      main_varyings = &m_main_varyings_header_only;
-    }
-  else
-    {
-      main_varyings = &m_main_varyings_shaders_and_shader_datas;
-      declare_brush_varyings = declare_varyings_string("_brush",
-                                                       m_brush_varyings.uints().size(),
-                                                       m_brush_varyings.ints().size(),
-                                                       m_brush_varyings.float_counts(),
-                                                       &varying_slot,
-                                                       &brush_varying_datum);
-    }
-
-  declare_main_varyings = declare_varyings_string("_main",
-                                                  main_varyings->uints().size(),
-                                                  main_varyings->ints().size(),
-                                                  main_varyings->float_counts(),
-                                                  &varying_slot,
-                                                  &main_varying_datum);
-
-  declare_shader_varyings = declare_varyings_string("_shader",
-                                                    m_number_uint_varyings,
-                                                    m_number_int_varyings,
-                                                    m_number_float_varyings,
-                                                    &varying_slot,
-                                                    &shader_varying_datum);
+  main_varyings = &main_varying_list(params);
+  declare_varyings(params, item_shaders,
+                   &declare_brush_varyings, &brush_varying_datum,
+                   &declare_main_varyings, &main_varying_datum,
+                   &declare_shader_varyings, &shader_varying_datum);
 
   declare_uniforms = declare_shader_uniforms(params);
 
@@ -919,6 +1240,12 @@ construct_shader(fastuidraw::glsl::ShaderSource &vert,
       frag.add_macro("FASTUIDRAW_PAINTER_USE_HW_CLIP_PLANES");
     }
 
+  if(m_config.rounded_rect_clipping())
+    {
+      vert.add_macro("FASTUIDRAW_PAINTER_ROUNDED_RECT_CLIPPING");
+      frag.add_macro("FASTUIDRAW_PAINTER_ROUNDED_RECT_CLIPPING");
+    }
+
   switch(params.colorstop_atlas_backing())
     {
     case PainterBackendGLSL::colorstop_texture_1d_array:
@@ -964,10 +1291,44 @@ construct_shader(fastuidraw::glsl::ShaderSource &vert,
       }
       break;
 
+    case PainterBackendGLSL::data_store_ssbo:
+      {
+        unsigned int alignment(m_p->configuration_base().alignment());
+        assert(alignment == 4);
+        FASTUIDRAWunused(alignment);
+
+        vert.add_macro("FASTUIDRAW_PAINTER_USE_DATA_SSBO");
+        frag.add_macro("FASTUIDRAW_PAINTER_USE_DATA_SSBO");
+      }
+      break;
+
     default:
       assert(!"Invalid data_store_backing() value");
     }
 
+  if(params.bindless_images())
+    {
+      vert.add_macro("FASTUIDRAW_PAINTER_IMAGE_BINDLESS");
+      frag.add_macro("FASTUIDRAW_PAINTER_IMAGE_BINDLESS");
+
+      if(params.external_texture_images())
+        {
+          vert.add_macro("FASTUIDRAW_PAINTER_IMAGE_EXTERNAL_TEXTURE");
+          frag.add_macro("FASTUIDRAW_PAINTER_IMAGE_EXTERNAL_TEXTURE");
+        }
+    }
+
+  if(params.precision_policy() == PainterBackendGLSL::precision_mediump_color)
+    {
+      vert.add_macro("fastuidraw_color_precision", "mediump");
+      frag.add_macro("fastuidraw_color_precision", "mediump");
+    }
+  else
+    {
+      vert.add_macro("fastuidraw_color_precision", "highp");
+      frag.add_macro("fastuidraw_color_precision", "highp");
+    }
+
   if(!params.have_float_glyph_texture_atlas())
     {
       vert.add_macro("FASTUIDRAW_PAINTER_EMULATE_GLYPH_TEXEL_STORE_FLOAT");
@@ -1011,6 +1372,7 @@ construct_shader(fastuidraw::glsl::ShaderSource &vert,
     .add_macro("FASTUIDRAW_GLYPH_GEOMETRY_STORE_BINDING", binding_params.glyph_atlas_geometry_store())
     .add_macro("FASTUIDRAW_PAINTER_STORE_TBO_BINDING", binding_params.data_store_buffer_tbo())
     .add_macro("FASTUIDRAW_PAINTER_STORE_UBO_BINDING", binding_params.data_store_buffer_ubo())
+    .add_macro("FASTUIDRAW_PAINTER_STORE_SSBO_BINDING", binding_params.data_store_buffer_ssbo())
     .add_macro("fastuidraw_varying", "out")
     .add_source(declare_vertex_shader_ins.c_str(), ShaderSource::from_string)
     .add_source(declare_brush_varyings.c_str(), ShaderSource::from_string)
@@ -1036,16 +1398,24 @@ construct_shader(fastuidraw::glsl::ShaderSource &vert,
     .add_source("fastuidraw_painter_types.glsl.resource_string", ShaderSource::from_resource)
     .add_source("fastuidraw_painter_brush_types.glsl.resource_string", ShaderSource::from_resource)
     .add_source("fastuidraw_painter_forward_declares.vert.glsl.resource_string", ShaderSource::from_resource)
-    .add_source("fastuidraw_painter_brush_unpack_forward_declares.glsl.resource_string", ShaderSource::from_resource)
+    .add_source("fastuidraw_painter_brush_unpack_forward_declares.glsl.resource_string", ShaderSource::from_resource);
+
+  /* the code after the forward declarations is assembled first
+     to find which of the utilities it uses.
+   */
+  ShaderSource vert_main, vert_uber;
+  vert_main
     .add_source("fastuidraw_painter_brush_unpack.glsl.resource_string", ShaderSource::from_resource)
     .add_source("fastuidraw_painter_brush.vert.glsl.resource_string", ShaderSource::from_resource)
-    .add_source("fastuidraw_painter_main.vert.glsl.resource_string", ShaderSource::from_resource)
-    .add_source(m_vert_shader_utils);
-
-  stream_unpack_code(vert);
-  stream_uber_vert_shader(params.vert_shader_use_switch(), vert, item_shaders,
+    .add_source("fastuidraw_painter_main.vert.glsl.resource_string", ShaderSource::from_resource);
+  stream_unpack_code(vert_uber);
+  stream_uber_vert_shader(params.vert_shader_use_switch(), vert_uber, item_shaders,
                           shader_varying_datum);
 
+  vert.add_source(vert_main);
+  m_vert_shader_utils.add_used(vert, std::string(vert_main.assembled_code()) + vert_uber.assembled_code());
+  vert.add_source(vert_uber);
+
   const char *shader_blend_macro;
   switch(params.blend_type())
     {
@@ -1081,6 +1451,7 @@ construct_shader(fastuidraw::glsl::ShaderSource &vert,
     .add_macro("FASTUIDRAW_GLYPH_GEOMETRY_STORE_BINDING", binding_params.glyph_atlas_geometry_store())
     .add_macro("FASTUIDRAW_PAINTER_STORE_TBO_BINDING", binding_params.data_store_buffer_tbo())
     .add_macro("FASTUIDRAW_PAINTER_STORE_UBO_BINDING", binding_params.data_store_buffer_ubo())
+    .add_macro("FASTUIDRAW_PAINTER_STORE_SSBO_BINDING", binding_params.data_store_buffer_ssbo())
     .add_macro("fastuidraw_varying", "in")
     .add_source(declare_brush_varyings.c_str(), ShaderSource::from_string)
     .add_source(declare_main_varyings.c_str(), ShaderSource::from_string)
@@ -1106,24 +1477,29 @@ construct_shader(fastuidraw::glsl::ShaderSource &vert,
     .add_source("fastuidraw_painter_brush_types.glsl.resource_string", ShaderSource::from_resource)
     .add_source("fastuidraw_painter_forward_declares.frag.glsl.resource_string", ShaderSource::from_resource);
 
+  ShaderSource frag_main, frag_uber;
   if(params.unpack_header_and_brush_in_frag_shader())
     {
       frag
-        .add_source("fastuidraw_painter_brush_unpack_forward_declares.glsl.resource_string", ShaderSource::from_resource)
+        .add_source("fastuidraw_painter_brush_unpack_forward_declares.glsl.resource_string", ShaderSource::from_resource);
+      frag_main
         .add_source("fastuidraw_painter_brush_unpack.glsl.resource_string", ShaderSource::from_resource);
     }
 
-  frag
+  frag_main
     .add_source("fastuidraw_painter_brush.frag.glsl.resource_string", ShaderSource::from_resource)
-    .add_source("fastuidraw_painter_main.frag.glsl.resource_string", ShaderSource::from_resource)
-    .add_source(m_frag_shader_utils);
+    .add_source("fastuidraw_painter_main.frag.glsl.resource_string", ShaderSource::from_resource);
 
-  stream_unpack_code(frag);
-  stream_uber_frag_shader(params.frag_shader_use_switch(), frag, item_shaders,
+  stream_unpack_code(frag_uber);
+  stream_uber_frag_shader(params.frag_shader_use_switch(), frag_uber, item_shaders,
                           shader_varying_datum);
-  stream_uber_blend_shader(params.blend_shader_use_switch(), frag,
+  stream_uber_blend_shader(params.blend_shader_use_switch(), frag_uber,
                            make_c_array(m_blend_shaders[params.blend_type()].m_shaders),
                            params.blend_type());
+
+  frag.add_source(frag_main);
+  m_frag_shader_utils.add_used(frag, std::string(frag_main.assembled_code()) + frag_uber.assembled_code());
+  frag.add_source(frag_uber);
 }
 
 /////////////////////////////////////////////////////////////////
@@ -1186,8 +1562,11 @@ operator=(const ConfigurationGLSL &rhs)
   }
 
 setget_implement(bool, use_hw_clip_planes)
+setget_implement(bool, rounded_rect_clipping)
 setget_implement(enum fastuidraw::PainterBlendShader::shader_type, default_blend_shader_type)
+setget_implement(bool, blend_equation_advanced)
 setget_implement(bool, non_dashed_stroke_shader_uses_discard)
+setget_implement(bool, dashed_stroke_shader_uses_discard)
 
 #undef setget_implement
 
@@ -1259,6 +1638,7 @@ setget_implement(unsigned int, glyph_atlas_texel_store_float)
 setget_implement(unsigned int, glyph_atlas_geometry_store)
 setget_implement(unsigned int, data_store_buffer_tbo)
 setget_implement(unsigned int, data_store_buffer_ubo)
+setget_implement(unsigned int, data_store_buffer_ssbo)
 setget_implement(unsigned int, uniforms_ubo)
 
 #undef setget_implement
@@ -1331,6 +1711,7 @@ setget_implement(bool, vert_shader_use_switch)
 setget_implement(bool, frag_shader_use_switch)
 setget_implement(bool, blend_shader_use_switch)
 setget_implement(bool, unpack_header_and_brush_in_frag_shader)
+setget_implement(bool, pack_varyings)
 setget_implement(enum fastuidraw::glsl::PainterBackendGLSL::data_store_backing_t, data_store_backing)
 setget_implement(int, data_blocks_per_store_buffer)
 setget_implement(enum fastuidraw::glsl::PainterBackendGLSL::glyph_geometry_backing_t, glyph_geometry_backing)
@@ -1338,7 +1719,10 @@ setget_implement(fastuidraw::ivec2, glyph_geometry_backing_log2_dims)
 setget_implement(bool, have_float_glyph_texture_atlas)
 setget_implement(enum fastuidraw::glsl::PainterBackendGLSL::colorstop_backing_t, colorstop_atlas_backing)
 setget_implement(bool, use_ubo_for_uniforms)
+setget_implement(bool, bindless_images)
+setget_implement(bool, external_texture_images)
 setget_implement(enum fastuidraw::PainterBlendShader::shader_type, blend_type)
+setget_implement(enum fastuidraw::glsl::PainterBackendGLSL::precision_policy_t, precision_policy)
 setget_implement(const fastuidraw::glsl::PainterBackendGLSL::BindingPoints&, binding_points)
 #undef setget_implement
 
@@ -1352,11 +1736,15 @@ PainterBackendGLSL(reference_counted_ptr<GlyphAtlas> glyph_atlas,
                    const ConfigurationBase &config_base):
   PainterBackend(glyph_atlas, image_atlas, colorstop_atlas, config_base,
                  detail::ShaderSetCreator(config_glsl.default_blend_shader_type(),
-                                          config_glsl.non_dashed_stroke_shader_uses_discard())
+                                          config_glsl.blend_equation_advanced(),
+                                          config_glsl.non_dashed_stroke_shader_uses_discard(),
+                                          config_glsl.dashed_stroke_shader_uses_discard())
                  .create_shader_set())
 {
   m_d = FASTUIDRAWnew PainterBackendGLSLPrivate(this, config_glsl);
-  set_hints().clipping_via_hw_clip_planes(config_glsl.use_hw_clip_planes());
+  set_hints()
+    .clipping_via_hw_clip_planes(config_glsl.use_hw_clip_planes())
+    .rounded_rect_clipping(config_glsl.rounded_rect_clipping());
 }
 
 fastuidraw::glsl::PainterBackendGLSL::
@@ -1374,7 +1762,17 @@ add_vertex_shader_util(const ShaderSource &src)
 {
   PainterBackendGLSLPrivate *d;
   d = static_cast<PainterBackendGLSLPrivate*>(m_d);
-  d->m_vert_shader_utils.add_source(src);
+  d->m_vert_shader_utils.add(src, NULL);
+}
+
+void
+fastuidraw::glsl::PainterBackendGLSL::
+add_vertex_shader_util(const ShaderSource &src, const char *symbol)
+{
+  PainterBackendGLSLPrivate *d;
+  d = static_cast<PainterBackendGLSLPrivate*>(m_d);
+  assert(symbol && *symbol);
+  d->m_vert_shader_utils.add(src, symbol);
 }
 
 void
@@ -1383,7 +1781,17 @@ add_fragment_shader_util(const ShaderSource &src)
 {
   PainterBackendGLSLPrivate *d;
   d = static_cast<PainterBackendGLSLPrivate*>(m_d);
-  d->m_frag_shader_utils.add_source(src);
+  d->m_frag_shader_utils.add(src, NULL);
+}
+
+void
+fastuidraw::glsl::PainterBackendGLSL::
+add_fragment_shader_util(const ShaderSource &src, const char *symbol)
+{
+  PainterBackendGLSLPrivate *d;
+  d = static_cast<PainterBackendGLSLPrivate*>(m_d);
+  assert(symbol && *symbol);
+  d->m_frag_shader_utils.add(src, symbol);
 }
 
 uint32_t
@@ -1422,7 +1830,6 @@ absorb_item_shader(const reference_counted_ptr<PainterItemShader> &shader)
 
   d->m_shader_code_added = true;
   d->m_item_shaders.push_back(h);
-  d->update_varying_size(h->varyings());
 
   return_value.m_ID = d->m_next_item_shader_ID;
   return_value.m_group = 0;
@@ -1525,6 +1932,23 @@ construct_shader(ShaderSource &out_vertex,
                       item_shader_filter, discard_macro_value);
 }
 
+unsigned int
+fastuidraw::glsl::PainterBackendGLSL::
+varying_slot_count(const UberShaderParams &construct_params,
+                   const ItemShaderFilter *item_shader_filter)
+{
+  PainterBackendGLSLPrivate *d;
+  std::vector<reference_counted_ptr<PainterItemShaderGLSL> > work_shaders;
+  std::string brush, main, shader;
+  detail::DeclareVaryingsStringDatum brush_datum, main_datum, shader_datum;
+
+  d = static_cast<PainterBackendGLSLPrivate*>(m_d);
+  return d->declare_varyings(construct_params,
+                             d->filter_item_shaders(item_shader_filter, work_shaders),
+                             &brush, &brush_datum, &main, &main_datum,
+                             &shader, &shader_datum);
+}
+
 uint32_t
 fastuidraw::glsl::PainterBackendGLSL::
 ubo_size(void)
@@ -27,8 +27,10 @@ namespace fastuidraw { namespace glsl { namespace detail {
 /////////////////////////////////////
 // BlendShaderSetCreator methods
 BlendShaderSetCreator::
-BlendShaderSetCreator(enum PainterBlendShader::shader_type tp):
-  m_type(tp)
+BlendShaderSetCreator(enum PainterBlendShader::shader_type tp,
+                      bool blend_equation_advanced):
+  m_type(tp),
+  m_blend_equation_advanced(blend_equation_advanced && tp == PainterBlendShader::single_src)
 {
   if(m_type == PainterBlendShader::single_src)
     {
@@ -82,6 +84,84 @@ add_blend_shader(PainterBlendShaderSet &out,
     }
 }
 
+void
+BlendShaderSetCreator::
+add_w3c_blend_shaders(PainterBlendShaderSet &out)
+{
+  using namespace fastuidraw::PainterEnums;
+
+  /* the i'th W3C blend mode and advanced blend equation,
+     the sub-shaders of fastuidraw_fbf_w3c.glsl are in
+     the same order.
+   */
+  static const enum blend_mode_t modes[] =
+    {
+      blend_w3c_mulitply,
+      blend_w3c_screen,
+      blend_w3c_overlay,
+      blend_w3c_darken,
+      blend_w3c_lighten,
+      blend_w3c_color_dodge,
+      blend_w3c_color_burn,
+      blend_w3c_hardlight,
+      blend_w3c_soft_light,
+      blend_w3c_difference,
+      blend_w3c_exclusion,
+      blend_w3c_hue,
+      blend_w3c_saturation,
+      blend_w3c_color,
+      blend_w3c_luminosity,
+    };
+  static const enum BlendMode::op_t ops[] =
+    {
+      BlendMode::MULTIPLY,
+      BlendMode::SCREEN,
+      BlendMode::OVERLAY,
+      BlendMode::DARKEN,
+      BlendMode::LIGHTEN,
+      BlendMode::COLORDODGE,
+      BlendMode::COLORBURN,
+      BlendMode::HARDLIGHT,
+      BlendMode::SOFTLIGHT,
+      BlendMode::DIFFERENCE,
+      BlendMode::EXCLUSION,
+      BlendMode::HSL_HUE,
+      BlendMode::HSL_SATURATION,
+      BlendMode::HSL_COLOR,
+      BlendMode::HSL_LUMINOSITY,
+    };
+  const unsigned int num_modes(sizeof(modes) / sizeof(modes[0]));
+
+  assert(sizeof(ops) / sizeof(ops[0]) == num_modes);
+
+  if(m_type == PainterBlendShader::framebuffer_fetch)
+    {
+      /* all W3C modes are one shader with a sub-shader for each
+         mode, and since none uses the fixed function blending
+         changing between them does not break a draw call.
+       */
+      reference_counted_ptr<PainterBlendShader> p;
+      p = FASTUIDRAWnew PainterBlendShaderGLSL(m_type,
+                                               ShaderSource()
+                                               .add_source("fastuidraw_fbf_w3c.glsl.resource_string",
+                                                           ShaderSource::from_resource),
+                                               num_modes);
+      for(unsigned int i = 0; i < num_modes; ++i)
+        {
+          reference_counted_ptr<PainterBlendShader> sub;
+          sub = FASTUIDRAWnew PainterBlendShader(i, p);
+          out.shader(modes[i], BlendMode().blending_on(false), sub);
+        }
+    }
+  else if(m_blend_equation_advanced)
+    {
+      for(unsigned int i = 0; i < num_modes; ++i)
+        {
+          out.shader(modes[i], BlendMode().equation(ops[i]), m_single_src_blend_shader_code);
+        }
+    }
+}
+
 PainterBlendShaderSet
 BlendShaderSetCreator::
 create_blend_shaders(void)
@@ -170,7 +250,9 @@ create_blend_shaders(void)
   add_blend_shader(shaders, blend_porter_duff_xor,
                    BlendMode().func(BlendMode::ONE_MINUS_DST_ALPHA, BlendMode::ONE_MINUS_SRC_ALPHA),
                    "fastuidraw_porter_duff_xor.glsl.resource_string", one_minus_dst_alpha_src1,
-                   "fastuidraw_fbf_porter_duff_dst_atop.glsl.resource_string");
+                   "fastuidraw_fbf_porter_duff_xor.glsl.resource_string");
+
+  add_w3c_blend_shaders(shaders);
 
   return shaders;
 }
@@ -213,11 +295,13 @@ add_constants(ShaderSource &src)
 //  ShaderSetCreator methods
 ShaderSetCreator::
 ShaderSetCreator(enum PainterBlendShader::shader_type tp,
-                 bool non_dashed_stroke_shader_uses_discard):
-  BlendShaderSetCreator(tp)
+                 bool blend_equation_advanced,
+                 bool non_dashed_stroke_shader_uses_discard,
+                 bool dashed_stroke_shader_uses_discard):
+  BlendShaderSetCreator(tp, blend_equation_advanced)
 {
   unsigned int num_undashed_sub_shaders, num_dashed_sub_shaders;
-  const char *extra_macro;
+  const char *extra_macro, *dashed_extra_macro;
 
   if(non_dashed_stroke_shader_uses_discard)
     {
@@ -248,24 +332,36 @@ ShaderSetCreator(enum PainterBlendShader::shader_type tp,
                                         num_undashed_sub_shaders
                                         );
 
+  /* without discard, the dashed stroke shader emits
+     the coverage of the dash pattern as alpha.
+   */
+  if(dashed_stroke_shader_uses_discard)
+    {
+      dashed_extra_macro = "FASTUIDRAW_STROKE_USE_DISCARD";
+    }
+  else
+    {
+      dashed_extra_macro = "FASTUIDRAW_STROKE_DOES_NOT_USE_DISCARD";
+    }
+
   num_dashed_sub_shaders = 1u << (m_stroke_render_pass_num_bits + m_stroke_dash_style_num_bits + 1u);
 
   m_uber_dashed_stroke_shader =
-    FASTUIDRAWnew PainterItemShaderGLSL(true,
+    FASTUIDRAWnew PainterItemShaderGLSL(dashed_stroke_shader_uses_discard,
                                         ShaderSource()
                                         .add_macro("FASTUIDRAW_STROKE_DASHED")
-                                        .add_macro("FASTUIDRAW_STROKE_USE_DISCARD")
+                                        .add_macro(dashed_extra_macro)
                                         .add_source("fastuidraw_painter_stroke.vert.glsl.resource_string",
                                                     ShaderSource::from_resource)
-                                        .remove_macro("FASTUIDRAW_STROKE_USE_DISCARD")
+                                        .remove_macro(dashed_extra_macro)
                                         .remove_macro("FASTUIDRAW_STROKE_DASHED"),
 
                                         ShaderSource()
                                         .add_macro("FASTUIDRAW_STROKE_DASHED")
-                                        .add_macro("FASTUIDRAW_STROKE_USE_DISCARD")
+                                        .add_macro(dashed_extra_macro)
                                         .add_source("fastuidraw_painter_stroke.frag.glsl.resource_string",
                                                     ShaderSource::from_resource)
-                                        .remove_macro("FASTUIDRAW_STROKE_USE_DISCARD")
+                                        .remove_macro(dashed_extra_macro)
                                         .remove_macro("FASTUIDRAW_STROKE_DASHED"),
 
                                         varying_list()
@@ -294,12 +390,39 @@ create_glyph_item_shader(const std::string &vert_src,
   return shader;
 }
 
+reference_counted_ptr<PainterItemShader>
+ShaderSetCreator::
+create_glyph_instance_item_shader(bool normalize_texel_coordinates,
+                                  const std::string &frag_src,
+                                  const varying_list &varyings)
+{
+  reference_counted_ptr<PainterItemShader> shader;
+  ShaderSource vert;
+
+  if(normalize_texel_coordinates)
+    {
+      vert.add_macro("FASTUIDRAW_GLYPH_INSTANCE_NORMALIZE_TEXEL_COORDINATES");
+    }
+  vert.add_source("fastuidraw_painter_glyph_instance.vert.glsl.resource_string", ShaderSource::from_resource);
+  if(normalize_texel_coordinates)
+    {
+      vert.remove_macro("FASTUIDRAW_GLYPH_INSTANCE_NORMALIZE_TEXEL_COORDINATES");
+    }
+
+  shader = FASTUIDRAWnew PainterItemShaderGLSL(false, vert,
+                                               ShaderSource()
+                                               .add_source(frag_src.c_str(), ShaderSource::from_resource),
+                                               varyings);
+  return shader;
+}
+
 PainterGlyphShader
 ShaderSetCreator::
-create_glyph_shader(bool anisotropic)
+create_glyph_shader(bool anisotropic, bool instanced)
 {
   PainterGlyphShader return_value;
   varying_list varyings;
+  const char *coverage_frag, *distance_frag, *curve_pair_frag, *banded_curves_frag, *msdf_frag;
 
   varyings
     .add_float_varying("fastuidraw_glyph_tex_coord_x")
@@ -310,35 +433,64 @@ create_glyph_shader(bool anisotropic)
     .add_uint_varying("fastuidraw_glyph_secondary_tex_coord_layer")
     .add_uint_varying("fastuidraw_glyph_geometry_data_location");
 
-  return_value
-    .shader(coverage_glyph,
-            create_glyph_item_shader("fastuidraw_painter_glyph_coverage.vert.glsl.resource_string",
-                                     "fastuidraw_painter_glyph_coverage.frag.glsl.resource_string",
-                                     varyings));
+  coverage_frag = "fastuidraw_painter_glyph_coverage.frag.glsl.resource_string";
 
+  /* the banded curves shader computes the coverage from the
+     pixel distances along each axis, which already accounts
+     for anisotropic transformations.
+   */
+  banded_curves_frag = "fastuidraw_painter_glyph_banded_curves.frag.glsl.resource_string";
   if(anisotropic)
     {
+      distance_frag = "fastuidraw_painter_glyph_distance_field_anisotropic.frag.glsl.resource_string";
+      curve_pair_frag = "fastuidraw_painter_glyph_curve_pair_anisotropic.frag.glsl.resource_string";
+      msdf_frag = "fastuidraw_painter_glyph_msdf_anisotropic.frag.glsl.resource_string";
+    }
+  else
+    {
+      distance_frag = "fastuidraw_painter_glyph_distance_field.frag.glsl.resource_string";
+      curve_pair_frag = "fastuidraw_painter_glyph_curve_pair.frag.glsl.resource_string";
+      msdf_frag = "fastuidraw_painter_glyph_msdf.frag.glsl.resource_string";
+    }
+
+  if(instanced)
+    {
+      /* the instance vertex shader computes the same values
+         as the vertex shaders of the non-instanced glyph
+         shaders: coverage and distance field glyphs normalize
+         the texel coordinates, curve pair, banded curves and
+         multi-channel distance field glyphs do not.
+       */
       return_value
+        .shader(coverage_glyph,
+                create_glyph_instance_item_shader(true, coverage_frag, varyings))
         .shader(distance_field_glyph,
-                create_glyph_item_shader("fastuidraw_painter_glyph_distance_field.vert.glsl.resource_string",
-                                         "fastuidraw_painter_glyph_distance_field_anisotropic.frag.glsl.resource_string",
-                                         varyings))
+                create_glyph_instance_item_shader(true, distance_frag, varyings))
         .shader(curve_pair_glyph,
-                create_glyph_item_shader("fastuidraw_painter_glyph_curve_pair.vert.glsl.resource_string",
-                                         "fastuidraw_painter_glyph_curve_pair_anisotropic.frag.glsl.resource_string",
-                                         varyings));
+                create_glyph_instance_item_shader(false, curve_pair_frag, varyings))
+        .shader(banded_curves_glyph,
+                create_glyph_instance_item_shader(false, banded_curves_frag, varyings))
+        .shader(msdf_glyph,
+                create_glyph_instance_item_shader(false, msdf_frag, varyings));
     }
   else
     {
       return_value
+        .shader(coverage_glyph,
+                create_glyph_item_shader("fastuidraw_painter_glyph_coverage.vert.glsl.resource_string",
+                                         coverage_frag, varyings))
         .shader(distance_field_glyph,
                 create_glyph_item_shader("fastuidraw_painter_glyph_distance_field.vert.glsl.resource_string",
-                                         "fastuidraw_painter_glyph_distance_field.frag.glsl.resource_string",
-                                         varyings))
+                                         distance_frag, varyings))
         .shader(curve_pair_glyph,
                 create_glyph_item_shader("fastuidraw_painter_glyph_curve_pair.vert.glsl.resource_string",
-                                         "fastuidraw_painter_glyph_curve_pair.frag.glsl.resource_string",
-                                         varyings));
+                                         curve_pair_frag, varyings))
+        .shader(banded_curves_glyph,
+                create_glyph_item_shader("fastuidraw_painter_glyph_curve_pair.vert.glsl.resource_string",
+                                         banded_curves_frag, varyings))
+        .shader(msdf_glyph,
+                create_glyph_item_shader("fastuidraw_painter_glyph_curve_pair.vert.glsl.resource_string",
+                                         msdf_frag, varyings));
     }
 
   return return_value;
@@ -412,9 +564,10 @@ ShaderSetCreator::
 create_fill_shader(void)
 {
   PainterFillShader fill_shader;
-  varying_list varyings;
+  varying_list varyings, aa_varyings;
 
   varyings.add_float_varying("fastuidraw_stroking_on_boundary");
+  aa_varyings.add_float_varying("fastuidraw_fill_on_boundary");
   fill_shader
     .item_shader(FASTUIDRAWnew PainterItemShaderGLSL(false,
                                                      ShaderSource()
@@ -423,10 +576,83 @@ create_fill_shader(void)
                                                      ShaderSource()
                                                      .add_source("fastuidraw_painter_fill.frag.glsl.resource_string",
                                                                  ShaderSource::from_resource),
-                                                     varyings));;
+                                                     varyings))
+    .aa_item_shader(FASTUIDRAWnew PainterItemShaderGLSL(false,
+                                                        ShaderSource()
+                                                        .add_source("fastuidraw_painter_fill_aa.vert.glsl.resource_string",
+                                                                    ShaderSource::from_resource),
+                                                        ShaderSource()
+                                                        .add_source("fastuidraw_painter_fill_aa.frag.glsl.resource_string",
+                                                                    ShaderSource::from_resource),
+                                                        aa_varyings));
   return fill_shader;
 }
 
+reference_counted_ptr<PainterItemShader>
+ShaderSetCreator::
+create_hairline_shader(bool instanced)
+{
+  varying_list varyings;
+  ShaderSource vert;
+
+  varyings
+    .add_float_varying("fastuidraw_hairline_distance")
+    .add_float_varying("fastuidraw_hairline_radius");
+
+  if(instanced)
+    {
+      vert.add_macro("FASTUIDRAW_HAIRLINE_INSTANCED");
+    }
+  vert.add_source("fastuidraw_painter_hairline.vert.glsl.resource_string", ShaderSource::from_resource);
+  if(instanced)
+    {
+      vert.remove_macro("FASTUIDRAW_HAIRLINE_INSTANCED");
+    }
+
+  return FASTUIDRAWnew PainterItemShaderGLSL(false, vert,
+                                             ShaderSource()
+                                             .add_source("fastuidraw_painter_hairline.frag.glsl.resource_string",
+                                                         ShaderSource::from_resource),
+                                             varyings);
+}
+
+reference_counted_ptr<PainterItemShader>
+ShaderSetCreator::
+create_rounded_rect_shader(bool box_shadow)
+{
+  varying_list varyings;
+  ShaderSource vert;
+  const char *frag;
+
+  varyings
+    .add_float_varying("fastuidraw_rounded_rect_x")
+    .add_float_varying("fastuidraw_rounded_rect_y")
+    .add_float_varying("fastuidraw_rounded_rect_half_width", varying_list::interpolation_flat)
+    .add_float_varying("fastuidraw_rounded_rect_half_height", varying_list::interpolation_flat)
+    .add_float_varying("fastuidraw_rounded_rect_radius", varying_list::interpolation_flat);
+
+  if(box_shadow)
+    {
+      varyings.add_float_varying("fastuidraw_box_shadow_sigma", varying_list::interpolation_flat);
+      vert.add_macro("FASTUIDRAW_BOX_SHADOW");
+      frag = "fastuidraw_painter_box_shadow.frag.glsl.resource_string";
+    }
+  else
+    {
+      frag = "fastuidraw_painter_rounded_rect.frag.glsl.resource_string";
+    }
+  vert.add_source("fastuidraw_painter_rounded_rect.vert.glsl.resource_string", ShaderSource::from_resource);
+  if(box_shadow)
+    {
+      vert.remove_macro("FASTUIDRAW_BOX_SHADOW");
+    }
+
+  return FASTUIDRAWnew PainterItemShaderGLSL(false, vert,
+                                             ShaderSource()
+                                             .add_source(frag, ShaderSource::from_resource),
+                                             varyings);
+}
+
 PainterShaderSet
 ShaderSetCreator::
 create_shader_set(void)
@@ -439,13 +665,19 @@ create_shader_set(void)
   se_pixel = PainterStrokeParams::stroking_data_selector(true);
 
   return_value
-    .glyph_shader(create_glyph_shader(false))
-    .glyph_shader_anisotropic(create_glyph_shader(true))
+    .glyph_shader(create_glyph_shader(false, false))
+    .glyph_shader_anisotropic(create_glyph_shader(true, false))
+    .glyph_instance_shader(create_glyph_shader(false, true))
+    .glyph_instance_shader_anisotropic(create_glyph_shader(true, true))
     .stroke_shader(create_stroke_shader(number_cap_styles, false, se))
     .pixel_width_stroke_shader(create_stroke_shader(number_cap_styles, true, se_pixel))
     .dashed_stroke_shader(create_dashed_stroke_shader_set(false))
     .pixel_width_dashed_stroke_shader(create_dashed_stroke_shader_set(true))
     .fill_shader(create_fill_shader())
+    .hairline_shader(create_hairline_shader(false))
+    .hairline_instance_shader(create_hairline_shader(true))
+    .rounded_rect_shader(create_rounded_rect_shader(false))
+    .box_shadow_shader(create_rounded_rect_shader(true))
     .blend_shaders(create_blend_shaders());
   return return_value;
 }
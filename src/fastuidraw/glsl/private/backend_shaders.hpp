@@ -39,8 +39,8 @@ enum uber_stroke_render_pass_t
 class BlendShaderSetCreator
 {
 public:
-  explicit
-  BlendShaderSetCreator(enum PainterBlendShader::shader_type tp);
+  BlendShaderSetCreator(enum PainterBlendShader::shader_type tp,
+                        bool blend_equation_advanced);
 
   PainterBlendShaderSet
   create_blend_shaders(void);
@@ -54,7 +54,15 @@ private:
                    const BlendMode &dual_md,
                    const std::string &framebuffer_fetch_src_file);
 
+  /* adds the W3C blend modes, which are only supported
+     by framebuffer_fetch and by single_src with the
+     advanced blend equations.
+   */
+  void
+  add_w3c_blend_shaders(PainterBlendShaderSet &out);
+
   enum PainterBlendShader::shader_type m_type;
+  bool m_blend_equation_advanced;
   reference_counted_ptr<PainterBlendShaderGLSL> m_single_src_blend_shader_code;
 };
 
@@ -75,17 +83,23 @@ class ShaderSetCreator:
   public BlendShaderSetCreator
 {
 public:
-  explicit
   ShaderSetCreator(enum PainterBlendShader::shader_type tp,
-                   bool non_dashed_stroke_shader_uses_discard);
+                   bool blend_equation_advanced,
+                   bool non_dashed_stroke_shader_uses_discard,
+                   bool dashed_stroke_shader_uses_discard);
 
   reference_counted_ptr<PainterItemShader>
   create_glyph_item_shader(const std::string &vert_src,
                            const std::string &frag_src,
                            const varying_list &varyings);
 
+  reference_counted_ptr<PainterItemShader>
+  create_glyph_instance_item_shader(bool normalize_texel_coordinates,
+                                    const std::string &frag_src,
+                                    const varying_list &varyings);
+
   PainterGlyphShader
-  create_glyph_shader(bool anisotropic);
+  create_glyph_shader(bool anisotropic, bool instanced);
 
   /*
     stroke_dash_style having value number_cap_styles means
@@ -107,6 +121,12 @@ public:
   PainterFillShader
   create_fill_shader(void);
 
+  reference_counted_ptr<PainterItemShader>
+  create_hairline_shader(bool instanced);
+
+  reference_counted_ptr<PainterItemShader>
+  create_rounded_rect_shader(bool box_shadow);
+
   PainterShaderSet
   create_shader_set(void);
 
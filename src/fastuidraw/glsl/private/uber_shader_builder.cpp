@@ -52,6 +52,36 @@ namespace
     return "fastuidraw_varying_uint";
   }
 
+  const char*
+  packed_flat_varying_label(void)
+  {
+    return "fastuidraw_varying_flat_packed";
+  }
+
+  const char *uint_type_labels[]=
+    {
+      "uint",
+      "uvec2",
+      "uvec3",
+      "uvec4",
+    };
+
+  const char *int_type_labels[]=
+    {
+      "int",
+      "ivec2",
+      "ivec3",
+      "ivec4",
+    };
+
+  const char *float_type_labels[]=
+    {
+      "float",
+      "vec2",
+      "vec3",
+      "vec4",
+    };
+
   void
   stream_varyings_as_local_variables_array(fastuidraw::glsl::ShaderSource &vert,
                                            fastuidraw::const_c_array<const char*> p,
@@ -147,71 +177,244 @@ namespace
                           unsigned int start_slot)
   {
     unsigned int number_slots(0);
-    const char *uint_labels[]=
-      {
-        "uint",
-        "uvec2",
-        "uvec3",
-        "uvec4",
-      };
-    const char *int_labels[]=
-      {
-        "int",
-        "ivec2",
-        "ivec3",
-        "ivec4",
-      };
-    const char *float_labels[]=
-      {
-        "float",
-        "vec2",
-        "vec3",
-        "vec4",
-      };
 
     number_slots +=
       stream_declare_varyings_type(append_to_name, start_slot + number_slots, str,
-                                   uint_count, "flat", uint_labels, uint_varying_label());
+                                   uint_count, "flat", uint_type_labels, uint_varying_label());
 
     number_slots +=
       stream_declare_varyings_type(append_to_name, start_slot + number_slots, str,
-                                   int_count, "flat", int_labels, int_varying_label());
+                                   int_count, "flat", int_type_labels, int_varying_label());
 
     number_slots +=
       stream_declare_varyings_type(append_to_name, start_slot + number_slots, str,
                                    float_counts[fastuidraw::glsl::varying_list::interpolation_smooth],
-                                   "", float_labels,
+                                   "", float_type_labels,
                                    float_varying_label(fastuidraw::glsl::varying_list::interpolation_smooth));
 
     number_slots +=
       stream_declare_varyings_type(append_to_name, start_slot + number_slots, str,
                                    float_counts[fastuidraw::glsl::varying_list::interpolation_flat],
-                                   "flat", float_labels,
+                                   "flat", float_type_labels,
                                    float_varying_label(fastuidraw::glsl::varying_list::interpolation_flat));
 
     number_slots +=
       stream_declare_varyings_type(append_to_name, start_slot + number_slots, str,
                                    float_counts[fastuidraw::glsl::varying_list::interpolation_noperspective],
-                                   "noperspective", float_labels,
+                                   "noperspective", float_type_labels,
                                    float_varying_label(fastuidraw::glsl::varying_list::interpolation_noperspective));
     return number_slots;
   }
 
 
+  std::string
+  packed_component(const char *append_to_name, unsigned int idx,
+                   unsigned int special_index)
+  {
+    const char *ext = "xyzw";
+    std::ostringstream str;
+
+    str << packed_flat_varying_label() << append_to_name << idx / 4;
+    if(idx != special_index)
+      {
+        str << "." << ext[idx % 4];
+      }
+    return str.str();
+  }
+
+  /* alias the varyings of p to the components of the packed
+     varyings starting at offset, with the conversion from
+     uint of the component given by prefix and suffix; only
+     used in the fragment shader since the result is not
+     an l-value.
+   */
   void
-  pre_stream_varyings(fastuidraw::glsl::ShaderSource &dst,
-                      const fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> &sh,
-                      const fastuidraw::glsl::detail::DeclareVaryingsStringDatum &datum)
+  stream_alias_packed_varyings_array(const char *append_to_name,
+                                     fastuidraw::glsl::ShaderSource &shader,
+                                     fastuidraw::const_c_array<const char*> p,
+                                     unsigned int offset, bool define,
+                                     unsigned int special_index,
+                                     const char *prefix, const char *suffix)
   {
-    fastuidraw::glsl::detail::stream_alias_varyings("_shader", dst, sh->varyings(), true, datum);
+    for(unsigned int i = 0; i < p.size(); ++i)
+      {
+        if(define)
+          {
+            std::ostringstream str;
+            str << prefix << packed_component(append_to_name, i + offset, special_index) << suffix;
+            shader.add_macro(p[i], str.str().c_str());
+          }
+        else
+          {
+            shader.remove_macro(p[i]);
+          }
+      }
   }
 
+  /* alias the varyings of p to the elements of a scratch array
+     of the vertex shader
+   */
   void
-  post_stream_varyings(fastuidraw::glsl::ShaderSource &dst,
+  stream_alias_scratch_varyings_array(fastuidraw::glsl::ShaderSource &shader,
+                                      fastuidraw::const_c_array<const char*> p,
+                                      const char *scratch, bool define)
+  {
+    for(unsigned int i = 0; i < p.size(); ++i)
+      {
+        if(define)
+          {
+            std::ostringstream str;
+            str << scratch << "[" << i << "]";
+            shader.add_macro(p[i], str.str().c_str());
+          }
+        else
+          {
+            shader.remove_macro(p[i]);
+          }
+      }
+  }
+
+  void
+  stream_alias_packed_varyings(const char *append_to_name,
+                               fastuidraw::glsl::ShaderSource &shader,
+                               const fastuidraw::glsl::varying_list &p,
+                               bool define, bool vertex_shader,
+                               const fastuidraw::glsl::detail::DeclareVaryingsStringDatum &datum)
+  {
+    using namespace fastuidraw::glsl;
+
+    const unsigned int flat(varying_list::interpolation_flat);
+    if(vertex_shader)
+      {
+        stream_alias_scratch_varyings_array(shader, p.uints(), "fastuidraw_varying_scratch_uint", define);
+        stream_alias_scratch_varyings_array(shader, p.ints(), "fastuidraw_varying_scratch_int", define);
+        stream_alias_scratch_varyings_array(shader, p.floats(varying_list::interpolation_flat),
+                                            "fastuidraw_varying_scratch_float_flat", define);
+      }
+    else
+      {
+        unsigned int offset(0);
+
+        stream_alias_packed_varyings_array(append_to_name, shader, p.uints(), offset,
+                                           define, datum.m_packed_special_index, "", "");
+        offset += p.uints().size();
+
+        stream_alias_packed_varyings_array(append_to_name, shader, p.ints(), offset,
+                                           define, datum.m_packed_special_index, "int(", ")");
+        offset += p.ints().size();
+
+        stream_alias_packed_varyings_array(append_to_name, shader, p.floats(varying_list::interpolation_flat),
+                                           offset, define, datum.m_packed_special_index,
+                                           "uintBitsToFloat(", ")");
+      }
+
+    for(unsigned int i = 0; i < varying_list::interpolation_number_types; ++i)
+      {
+        enum varying_list::interpolation_qualifier_t q;
+        q = static_cast<enum varying_list::interpolation_qualifier_t>(i);
+        if(i != flat)
+          {
+            stream_alias_varyings_array(append_to_name, shader, p.floats(q), float_varying_label(q),
+                                        define, datum.m_float_special_index[q]);
+          }
+      }
+  }
+
+  /* stream the function called by the uber-vertex shader after
+     the vertex shader of sh returns which packs the scratch values
+     written by the shader into the packed varyings.
+   */
+  void
+  stream_pack_function(const char *append_to_name,
+                       fastuidraw::glsl::ShaderSource &dst,
                        const fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> &sh,
                        const fastuidraw::glsl::detail::DeclareVaryingsStringDatum &datum)
   {
-    fastuidraw::glsl::detail::stream_alias_varyings("_shader", dst, sh->varyings(), false, datum);
+    using namespace fastuidraw::glsl;
+
+    const varying_list &p(sh->varyings());
+    unsigned int offset(0);
+    std::ostringstream str;
+
+    str << "void\nfastuidraw_pack_shader_varyings" << sh->ID() << "(void)\n{\n";
+    for(unsigned int i = 0, endi = p.uints().size(); i < endi; ++i, ++offset)
+      {
+        str << "    " << packed_component(append_to_name, offset, datum.m_packed_special_index)
+            << " = fastuidraw_varying_scratch_uint[" << i << "];\n";
+      }
+    for(unsigned int i = 0, endi = p.ints().size(); i < endi; ++i, ++offset)
+      {
+        str << "    " << packed_component(append_to_name, offset, datum.m_packed_special_index)
+            << " = uint(fastuidraw_varying_scratch_int[" << i << "]);\n";
+      }
+    for(unsigned int i = 0, endi = p.floats(varying_list::interpolation_flat).size(); i < endi; ++i, ++offset)
+      {
+        str << "    " << packed_component(append_to_name, offset, datum.m_packed_special_index)
+            << " = floatBitsToUint(fastuidraw_varying_scratch_float_flat[" << i << "]);\n";
+      }
+    str << "}\n";
+    dst.add_source(str.str().c_str(), fastuidraw::glsl::ShaderSource::from_string);
+  }
+
+  void
+  pre_stream_vert_varyings(fastuidraw::glsl::ShaderSource &dst,
+                           const fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> &sh,
+                           const fastuidraw::glsl::detail::DeclareVaryingsStringDatum &datum)
+  {
+    if(datum.m_pack_flat)
+      {
+        stream_alias_packed_varyings("_shader", dst, sh->varyings(), true, true, datum);
+      }
+    else
+      {
+        fastuidraw::glsl::detail::stream_alias_varyings("_shader", dst, sh->varyings(), true, datum);
+      }
+  }
+
+  void
+  post_stream_vert_varyings(fastuidraw::glsl::ShaderSource &dst,
+                            const fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> &sh,
+                            const fastuidraw::glsl::detail::DeclareVaryingsStringDatum &datum)
+  {
+    if(datum.m_pack_flat)
+      {
+        stream_pack_function("_shader", dst, sh, datum);
+        stream_alias_packed_varyings("_shader", dst, sh->varyings(), false, true, datum);
+      }
+    else
+      {
+        fastuidraw::glsl::detail::stream_alias_varyings("_shader", dst, sh->varyings(), false, datum);
+      }
+  }
+
+  void
+  pre_stream_frag_varyings(fastuidraw::glsl::ShaderSource &dst,
+                           const fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> &sh,
+                           const fastuidraw::glsl::detail::DeclareVaryingsStringDatum &datum)
+  {
+    if(datum.m_pack_flat)
+      {
+        stream_alias_packed_varyings("_shader", dst, sh->varyings(), true, false, datum);
+      }
+    else
+      {
+        fastuidraw::glsl::detail::stream_alias_varyings("_shader", dst, sh->varyings(), true, datum);
+      }
+  }
+
+  void
+  post_stream_frag_varyings(fastuidraw::glsl::ShaderSource &dst,
+                            const fastuidraw::reference_counted_ptr<fastuidraw::glsl::PainterItemShaderGLSL> &sh,
+                            const fastuidraw::glsl::detail::DeclareVaryingsStringDatum &datum)
+  {
+    if(datum.m_pack_flat)
+      {
+        stream_alias_packed_varyings("_shader", dst, sh->varyings(), false, false, datum);
+      }
+    else
+      {
+        fastuidraw::glsl::detail::stream_alias_varyings("_shader", dst, sh->varyings(), false, datum);
+      }
   }
 
   template<typename T>
@@ -242,7 +445,8 @@ namespace
                 const std::string &uber_func_with_args,
                 const std::string &shader_main,
                 const std::string &shader_args, //of the form ", arg1, arg2,..,argN" or empty string
-                const std::string &shader_id);
+                const std::string &shader_id,
+                const std::string &shader_post_call); //if non-empty, called with no args after shader_main
 
     static
     void
@@ -258,7 +462,7 @@ namespace
                   &stream_nothing, &stream_nothing,
                   fastuidraw::glsl::detail::DeclareVaryingsStringDatum(),
                   return_type, uber_func_with_args,
-                  shader_main, shader_args, shader_id);
+                  shader_main, shader_args, shader_id, "");
     }
   };
 
@@ -275,7 +479,8 @@ stream_uber(bool use_switch, ShaderSource &dst, array_type shaders,
             const std::string &uber_func_with_args,
             const std::string &shader_main,
             const std::string &shader_args, //of the form ", arg1, arg2,..,argN" or empty string
-            const std::string &shader_id)
+            const std::string &shader_id,
+            const std::string &shader_post_call)
 {
   /* first stream all of the item_shaders with predefined macros. */
   for(unsigned int i = 0; i < shaders.size(); ++i)
@@ -330,8 +535,12 @@ stream_uber(bool use_switch, ShaderSource &dst, array_type shaders,
               str << "p = ";
             }
           str << shader_main << shaders[i]->ID()
-              << "(" << shader_id << " - uint(" << start << ")" << shader_args << ");\n"
-              << "    }\n";
+              << "(" << shader_id << " - uint(" << start << ")" << shader_args << ");\n";
+          if(!shader_post_call.empty())
+            {
+              str << "        " << shader_post_call << shaders[i]->ID() << "();\n";
+            }
+          str << "    }\n";
           has_sub_shaders = true;
         }
     }
@@ -386,6 +595,12 @@ stream_uber(bool use_switch, ShaderSource &dst, array_type shaders,
           str << shader_main << shaders[i]->ID()
               << "(uint(0)" << shader_args << ");\n";
 
+          if(!shader_post_call.empty())
+            {
+              str << tab << (use_switch ? "        " : "    ")
+                  << shader_post_call << shaders[i]->ID() << "();\n";
+            }
+
           if(use_switch)
             {
               str << tab << "    }\n"
@@ -476,20 +691,101 @@ declare_varyings_string(const char *append_to_name,
   return ostr.str();
 }
 
+std::string
+declare_varyings_string(const char *append_to_name,
+                        const_c_array<reference_counted_ptr<PainterItemShaderGLSL> > item_shaders,
+                        bool pack_flat,
+                        unsigned int *slot,
+                        DeclareVaryingsStringDatum *datum)
+{
+  const unsigned int flat(varying_list::interpolation_flat);
+  size_t uint_count(0), int_count(0), packed_count(0);
+  vecN<size_t, varying_list::interpolation_number_types> float_counts(0);
+
+  for(unsigned int i = 0; i < item_shaders.size(); ++i)
+    {
+      const varying_list &p(item_shaders[i]->varyings());
+
+      uint_count = std::max(uint_count, p.uints().size());
+      int_count = std::max(int_count, p.ints().size());
+      for(unsigned int q = 0; q < varying_list::interpolation_number_types; ++q)
+        {
+          enum varying_list::interpolation_qualifier_t qq;
+          qq = static_cast<enum varying_list::interpolation_qualifier_t>(q);
+          float_counts[q] = std::max(float_counts[q], p.floats(qq).size());
+        }
+      packed_count = std::max(packed_count,
+                              p.uints().size() + p.ints().size()
+                              + p.floats(varying_list::interpolation_flat).size());
+    }
+
+  datum->m_pack_flat = pack_flat;
+  if(!pack_flat)
+    {
+      return declare_varyings_string(append_to_name, uint_count, int_count,
+                                     float_counts, slot, datum);
+    }
+
+  /* the uints, ints and flat floats share flat uvec4 varyings
+     sized by the largest number any one item shader uses; the
+     smooth and noperspective floats are as without packing.
+   */
+  std::ostringstream ostr;
+  vecN<size_t, varying_list::interpolation_number_types> unpacked_float_counts(float_counts);
+
+  unpacked_float_counts[flat] = 0;
+  *slot += stream_declare_varyings_type(append_to_name, *slot, ostr, packed_count,
+                                        "flat", uint_type_labels, packed_flat_varying_label());
+  *slot += stream_declare_varyings(append_to_name, ostr, 0, 0, unpacked_float_counts, *slot);
+
+  datum->m_uint_special_index = compute_special_index(0);
+  datum->m_int_special_index = compute_special_index(0);
+  for(unsigned int i = 0; i < varying_list::interpolation_number_types; ++i)
+    {
+      datum->m_float_special_index[i] = compute_special_index(unpacked_float_counts[i]);
+    }
+  datum->m_packed_special_index = compute_special_index(packed_count);
+  datum->m_scratch_uint_count = uint_count;
+  datum->m_scratch_int_count = int_count;
+  datum->m_scratch_float_flat_count = float_counts[flat];
+
+  return ostr.str();
+}
+
 void
 stream_uber_vert_shader(bool use_switch,
                         ShaderSource &vert,
                         const_c_array<reference_counted_ptr<PainterItemShaderGLSL> > item_shaders,
                         const DeclareVaryingsStringDatum &datum)
 {
+  if(datum.m_pack_flat)
+    {
+      std::ostringstream str;
+
+      if(datum.m_scratch_uint_count > 0)
+        {
+          str << "uint fastuidraw_varying_scratch_uint[" << datum.m_scratch_uint_count << "];\n";
+        }
+      if(datum.m_scratch_int_count > 0)
+        {
+          str << "int fastuidraw_varying_scratch_int[" << datum.m_scratch_int_count << "];\n";
+        }
+      if(datum.m_scratch_float_flat_count > 0)
+        {
+          str << "float fastuidraw_varying_scratch_float_flat[" << datum.m_scratch_float_flat_count << "];\n";
+        }
+      vert.add_source(str.str().c_str(), ShaderSource::from_string);
+    }
+
   UberShaderStreamer<PainterItemShaderGLSL>::stream_uber(use_switch, vert, item_shaders,
                                                          &PainterItemShaderGLSL::vertex_src,
-                                                         &pre_stream_varyings, &post_stream_varyings, datum,
+                                                         &pre_stream_vert_varyings, &post_stream_vert_varyings, datum,
                                                          "vec4", "fastuidraw_run_vert_shader(in fastuidraw_shader_header h, out uint add_z)",
                                                          "fastuidraw_gl_vert_main",
                                                          ", fastuidraw_primary_attribute, fastuidraw_secondary_attribute, "
                                                          "fastuidraw_uint_attribute, h.item_shader_data_location, add_z",
-                                                         "h.item_shader");
+                                                         "h.item_shader",
+                                                         datum.m_pack_flat ? "fastuidraw_pack_shader_varyings" : "");
 }
 
 void
@@ -500,12 +796,12 @@ stream_uber_frag_shader(bool use_switch,
 {
   UberShaderStreamer<PainterItemShaderGLSL>::stream_uber(use_switch, frag, item_shaders,
                                                          &PainterItemShaderGLSL::fragment_src,
-                                                         &pre_stream_varyings, &post_stream_varyings, datum,
+                                                         &pre_stream_frag_varyings, &post_stream_frag_varyings, datum,
                                                          "vec4",
                                                          "fastuidraw_run_frag_shader(in uint frag_shader, "
                                                          "in uint frag_shader_data_location)",
                                                          "fastuidraw_gl_frag_main", ", frag_shader_data_location",
-                                                         "frag_shader");
+                                                         "frag_shader", "");
 }
 
 void
@@ -30,9 +30,29 @@ namespace fastuidraw { namespace glsl { namespace detail {
 class DeclareVaryingsStringDatum
 {
 public:
+  DeclareVaryingsStringDatum(void):
+    m_pack_flat(false),
+    m_packed_special_index(0),
+    m_scratch_uint_count(0),
+    m_scratch_int_count(0),
+    m_scratch_float_flat_count(0)
+  {}
+
   unsigned int m_uint_special_index;
   unsigned int m_int_special_index;
   vecN<unsigned int, varying_list::interpolation_number_types> m_float_special_index;
+
+  /* if true, the uint, int and flat float varyings of each
+     item shader are packed, in that order, into shared flat
+     uvec4 varyings; the ints and floats are bit-cast. The
+     vertex shader writes the values to scratch globals which
+     are packed after the item shader's main returns.
+   */
+  bool m_pack_flat;
+  unsigned int m_packed_special_index;
+  size_t m_scratch_uint_count;
+  size_t m_scratch_int_count;
+  size_t m_scratch_float_flat_count;
 };
 
 std::string
@@ -42,6 +62,18 @@ declare_varyings_string(const char *append_to_name,
                         const_c_array<size_t> float_counts,
                         unsigned int *slot,
                         DeclareVaryingsStringDatum *datum);
+/* declares the varyings of the item shaders of an uber-shader,
+   sized by the maximum over item_shaders of each kind of varying;
+   if pack_flat is true, the flat varyings are packed, see
+   DeclareVaryingsStringDatum::m_pack_flat.
+ */
+std::string
+declare_varyings_string(const char *append_to_name,
+                        const_c_array<reference_counted_ptr<PainterItemShaderGLSL> > item_shaders,
+                        bool pack_flat,
+                        unsigned int *slot,
+                        DeclareVaryingsStringDatum *datum);
+
 void
 stream_alias_varyings(const char *append_to_name,
                       ShaderSource &shader,
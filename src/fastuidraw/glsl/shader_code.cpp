@@ -17,10 +17,12 @@
  */
 
 #include <sstream>
+#include <algorithm>
 
 #include <fastuidraw/util/math.hpp>
 #include <fastuidraw/glsl/shader_code.hpp>
 #include <fastuidraw/text/glyph_render_data_curve_pair.hpp>
+#include <fastuidraw/text/glyph_render_data_banded_curves.hpp>
 
 namespace
 {
@@ -205,6 +207,70 @@ curvepair_compute_pseudo_distance(unsigned int alignment,
 
 }
 
+fastuidraw::glsl::ShaderSource
+fastuidraw::glsl::code::
+banded_curves_compute_coverage(unsigned int alignment,
+                               const char *function_name,
+                               const char *texel_store,
+                               const char *geometry_store_fetch)
+{
+  ShaderSource return_value;
+  std::ostringstream str, ray_name;
+  unsigned int blocks_per_entry;
+  const char *swizzle[4] =
+    {
+      "r",
+      "rg",
+      "rgb",
+      "rgba"
+    };
+
+  /* an entry is 4 floats padded to a multiple of alignment,
+     the macro gathers the 4 floats from as many blocks as
+     needed.
+   */
+  blocks_per_entry = round_up_to_multiple(static_cast<unsigned int>(GlyphRenderDataBandedCurves::entry_size),
+                                          alignment) / alignment;
+  str << "\n#define FASTUIDRAW_BANDED_CURVES_FETCH_ENTRY(geometry_offset, entry) ";
+  if(alignment >= GlyphRenderDataBandedCurves::entry_size)
+    {
+      str << geometry_store_fetch << "(int(geometry_offset) + int(entry))";
+    }
+  else
+    {
+      str << "vec4(";
+      for(unsigned int b = 0, c = 0; c < GlyphRenderDataBandedCurves::entry_size; ++b, c += alignment)
+        {
+          unsigned int num;
+
+          num = std::min(alignment, GlyphRenderDataBandedCurves::entry_size - c);
+          if(b != 0)
+            {
+              str << ", ";
+            }
+          str << geometry_store_fetch << "(int(geometry_offset) + "
+              << blocks_per_entry << " * int(entry) + " << b << ")."
+              << swizzle[num - 1];
+        }
+      str << ")";
+    }
+  str << "\n";
+
+  ray_name << function_name << "_ray";
+  return_value
+    .add_macro("FASTUIDRAW_BANDED_CURVES_COMPUTE_NAME", function_name)
+    .add_macro("FASTUIDRAW_BANDED_CURVES_RAY_NAME", ray_name.str().c_str())
+    .add_macro("FASTUIDRAW_BANDED_CURVES_TEXEL_STORE", texel_store)
+    .add_source(str.str().c_str(), ShaderSource::from_string)
+    .add_source("fastuidraw_banded_curves_glyph.frag.glsl.resource_string", ShaderSource::from_resource)
+    .add_source("#undef FASTUIDRAW_BANDED_CURVES_FETCH_ENTRY\n", ShaderSource::from_string)
+    .remove_macro("FASTUIDRAW_BANDED_CURVES_COMPUTE_NAME")
+    .remove_macro("FASTUIDRAW_BANDED_CURVES_RAY_NAME")
+    .remove_macro("FASTUIDRAW_BANDED_CURVES_TEXEL_STORE");
+
+  return return_value;
+}
+
 fastuidraw::glsl::ShaderSource
 fastuidraw::glsl::code::
 image_atlas_compute_coord(const char *function_name,
@@ -236,7 +302,6 @@ compute_interval(const char *function_name, unsigned int data_alignment)
   ShaderSource return_value;
   std::ostringstream ostr;
 
-  const char *xyzw = "xyzw";
   const char *itypes[] =
     {
       "uint",
@@ -261,33 +326,23 @@ compute_interval(const char *function_name, unsigned int data_alignment)
       "xyzw",
     };
 
-  const char *start_interval[] =
+  const char *components[4][4] =
     {
-      "lastd",
-      "fV.x",
-      "fV.y",
-      "fV.z",
-    };
-
-  const char *end_interval[] =
-    {
-      "fV.x",
-      "fV.y",
-      "fV.z",
-      "fV.w"
-    };
-
-  const char *return_signs[] =
-    {
-      "1.0",
-      "-1.0",
-      "1.0",
-      "-1.0"
+      {"fV", "", "", ""},
+      {"fV.x", "fV.y", "", ""},
+      {"fV.x", "fV.y", "fV.z", ""},
+      {"fV.x", "fV.y", "fV.z", "fV.w"},
     };
 
   assert(data_alignment >=1 && data_alignment <= 4);
-
-  /* This.. is awful.
+  const char **fV(components[data_alignment - 1]);
+
+  /* The intervals are packed as a static search tree
+     whose nodes are each one block of data_alignment
+     values with data_alignment + 1 children, see
+     PainterDashedStrokeParams. Each iteration of the
+     descent reads one node and the search ends by
+     reading one leaf.
    */
   ostr << "float\n" << function_name
        << "(in uint intervals_location, in float total_distance,\n"
@@ -296,65 +351,83 @@ compute_interval(const char *function_name, unsigned int data_alignment)
        << "\tout int interval_ID,\n"
        << "\tout float interval_begin, out float interval_end)\n"
        << "{\n"
-       << "\tint loc;\n"
-       << "\tfloat d, lastd, ff, fd;\n";
-
-  if(data_alignment == 1 || data_alignment == 3)
-    {
-      ostr << "\tfloat s = 1.0;\n";
-    }
-
-  ostr << "\n"
+       << "\tuint num_leaves, level_start, level_width, node, j;\n"
+       << "\tfloat d, lastd, endd, ff, fd;\n"
+       << "\t" << itypes[data_alignment - 1] << " V;\n"
+       << "\t" << ftypes[data_alignment - 1] << " fV;\n"
+       << "\n"
+       << "\tinterval_begin = 0.0;\n"
+       << "\tinterval_end = 0.0;\n"
+       << "\tinterval_ID = -1;\n"
+       << "\tif(number_intervals == 0u)\n"
+       << "\t{\n"
+       << "\t\treturn -1.0;\n"
+       << "\t}\n"
+       << "\n"
        << "\tfd = floor(in_distance / total_distance);\n"
        << "\tff = total_distance * fd;\n"
        << "\td = in_distance - ff;\n"
        << "\tlastd = first_interval_start;\n"
-       << "\tloc = 0;\n"
-       << "\tinterval_begin = 0.0;\n"
-       << "\tinterval_end = 0.0;\n"
-       << "\tinterval_ID = -1;\n"
-       << "\n\n"
-       << "\tdo\n"
+       << "\n"
+       << "\tnum_leaves = (number_intervals + " << data_alignment - 1 << "u) / " << data_alignment << "u;\n"
+       << "\tlevel_start = 0u;\n"
+       << "\tlevel_width = 1u;\n"
+       << "\tnode = 0u;\n"
+       << "\twhile(level_width < num_leaves)\n"
        << "\t{\n"
-       << "\t\t" << itypes[data_alignment - 1] << " V;\n"
-       << "\t\t" << ftypes[data_alignment - 1] << " fV;\n"
-       << "\t\tV = fastuidraw_fetch_data(loc + int(intervals_location))." << extract_swizzle[data_alignment - 1] << ";\n"
-       << "\t\tfV = uintBitsToFloat(V);\n";
+       << "\t\tuint c;\n"
+       << "\n"
+       << "\t\tV = fastuidraw_fetch_data(intervals_location + level_start + node)."
+       << extract_swizzle[data_alignment - 1] << ";\n"
+       << "\t\tfV = uintBitsToFloat(V);\n"
+       << "\t\tc = 0u;\n";
   for(unsigned int i = 0; i < data_alignment; ++i)
     {
-      ostr << "\t\t";
+      ostr << "\t\tif(d >= " << fV[i] << ")\n"
+           << "\t\t{\n"
+           << "\t\t\tlastd = " << fV[i] << ";\n"
+           << "\t\t\tc = " << i + 1 << "u;\n"
+           << "\t\t}\n";
+    }
+  ostr << "\t\tlevel_start += level_width;\n"
+       << "\t\tlevel_width *= " << data_alignment + 1 << "u;\n"
+       << "\t\tnode = node * " << data_alignment + 1 << "u + c;\n"
+       << "\t}\n"
+       << "\n"
+       << "\tV = fastuidraw_fetch_data(intervals_location + level_start + node)."
+       << extract_swizzle[data_alignment - 1] << ";\n"
+       << "\tfV = uintBitsToFloat(V);\n";
+  for(unsigned int i = 0; i < data_alignment; ++i)
+    {
+      ostr << "\t";
       if(i != 0)
         {
           ostr << "else ";
         }
-      ostr << "if(d < fV." << xyzw[i] << ")\n"
-           << "\t\t{\n"
-           << "\t\t\tinterval_begin = ff + " << start_interval[i] << ";\n"
-           << "\t\t\tinterval_end = ff + " << end_interval[i] << ";\n"
-           << "\t\t\tinterval_ID = int(" << data_alignment << ") * loc "
-           << "+ int(" << i << ") + int(fd) * int(number_intervals);\n";
-      if(data_alignment == 1 || data_alignment == 3)
-        {
-          ostr << "\t\t\treturn s * " << return_signs[i] << ";\n";
-        }
-      else
+      ostr << "if(d < " << fV[i] << ")\n"
+           << "\t{\n";
+      if(i != 0)
         {
-          ostr << "\t\t\treturn " << return_signs[i] << ";\n";
+          ostr << "\t\tlastd = " << fV[i - 1] << ";\n";
         }
-      ostr << "\t\t\tlastd = 2.0 * total_distance + 1.0;\n"
-           << "\t\t}\n";
-    }
-  ostr << "\t\tlastd = fV." << xyzw[data_alignment - 1] << ";\n"
-       << "\t\t++loc;\n";
-
-  if(data_alignment == 1 || data_alignment == 3)
-    {
-      ostr << "\t\ts *= -1.0;\n";
+      ostr << "\t\tendd = " << fV[i] << ";\n"
+           << "\t\tj = " << i << "u;\n"
+           << "\t}\n";
     }
-
-  ostr << "\t}\n"
-       << "\twhile(lastd < total_distance);\n"
-       << "\treturn -1.0;\n"
+  ostr << "\telse\n"
+       << "\t{\n"
+       << "\t\treturn -1.0;\n"
+       << "\t}\n"
+       << "\n"
+       << "\tj += " << data_alignment << "u * node;\n"
+       << "\tif(j >= number_intervals)\n"
+       << "\t{\n"
+       << "\t\treturn -1.0;\n"
+       << "\t}\n"
+       << "\tinterval_begin = ff + lastd;\n"
+       << "\tinterval_end = ff + endd;\n"
+       << "\tinterval_ID = int(j) + int(fd) * int(number_intervals);\n"
+       << "\treturn ((j & 1u) == 0u) ? 1.0 : -1.0;\n"
        << "}";
 
   return_value
@@ -279,6 +279,15 @@ ShaderSource(const ShaderSource &obj)
   m_d = FASTUIDRAWnew SourcePrivate(*d);
 }
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+fastuidraw::glsl::ShaderSource::
+ShaderSource(ShaderSource &&obj) noexcept:
+  m_d(obj.m_d)
+{
+  obj.m_d = FASTUIDRAWnew SourcePrivate();
+}
+#endif
+
 fastuidraw::glsl::ShaderSource::
 ~ShaderSource()
 {
@@ -302,6 +311,23 @@ operator=(const ShaderSource &obj)
   return *this;
 }
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+fastuidraw::glsl::ShaderSource&
+fastuidraw::glsl::ShaderSource::
+operator=(ShaderSource &&obj) noexcept
+{
+  swap(obj);
+  return *this;
+}
+#endif
+
+void
+fastuidraw::glsl::ShaderSource::
+swap(ShaderSource &obj)
+{
+  std::swap(m_d, obj.m_d);
+}
+
 fastuidraw::glsl::ShaderSource&
 fastuidraw::glsl::ShaderSource::
 specify_version(const char *v)
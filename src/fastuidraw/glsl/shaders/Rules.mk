@@ -11,6 +11,8 @@ LIBRARY_RESOURCE_STRING += $(call filelist, \
 	fastuidraw_atlas_image_fetch.glsl.resource_string \
 	fastuidraw_curvepair_glyph.frag.glsl.resource_string \
 	fastuidraw_curvepair_glyph_derivative.frag.glsl.resource_string \
+	fastuidraw_banded_curves_glyph.frag.glsl.resource_string \
+	fastuidraw_msdf_sample.frag.glsl.resource_string \
 	fastuidraw_circular_interpolate.glsl.resource_string \
 	fastuidraw_anisotropic.frag.glsl.resource_string \
 	fastuidraw_unpack_unit_vector.glsl.resource_string \
@@ -23,7 +23,14 @@ LIBRARY_RESOURCE_STRING += $(call filelist, fastuidraw_painter_main.vert.glsl.re
 	fastuidraw_painter_stroke.vert.glsl.resource_string \
 	fastuidraw_painter_stroke.frag.glsl.resource_string \
 	fastuidraw_painter_fill.vert.glsl.resource_string \
-	fastuidraw_painter_fill.frag.glsl.resource_string)
+	fastuidraw_painter_fill.frag.glsl.resource_string \
+	fastuidraw_painter_fill_aa.vert.glsl.resource_string \
+	fastuidraw_painter_fill_aa.frag.glsl.resource_string \
+	fastuidraw_painter_hairline.vert.glsl.resource_string \
+	fastuidraw_painter_hairline.frag.glsl.resource_string \
+	fastuidraw_painter_rounded_rect.vert.glsl.resource_string \
+	fastuidraw_painter_rounded_rect.frag.glsl.resource_string \
+	fastuidraw_painter_box_shadow.frag.glsl.resource_string)
 
 # Begin standard footer
 d		:= $(dirstack_$(sp))
@@ -6,12 +6,16 @@ d		:= $(dir)
 
 LIBRARY_RESOURCE_STRING += $(call filelist, fastuidraw_painter_glyph_coverage.vert.glsl.resource_string \
 	fastuidraw_painter_glyph_coverage.frag.glsl.resource_string \
+	fastuidraw_painter_glyph_instance.vert.glsl.resource_string \
 	fastuidraw_painter_glyph_distance_field.vert.glsl.resource_string \
 	fastuidraw_painter_glyph_distance_field.frag.glsl.resource_string \
 	fastuidraw_painter_glyph_distance_field_anisotropic.frag.glsl.resource_string \
 	fastuidraw_painter_glyph_curve_pair.vert.glsl.resource_string \
 	fastuidraw_painter_glyph_curve_pair.frag.glsl.resource_string \
 	fastuidraw_painter_glyph_curve_pair_anisotropic.frag.glsl.resource_string \
+	fastuidraw_painter_glyph_banded_curves.frag.glsl.resource_string \
+	fastuidraw_painter_glyph_msdf.frag.glsl.resource_string \
+	fastuidraw_painter_glyph_msdf_anisotropic.frag.glsl.resource_string \
 	)
 
 # Begin standard footer
@@ -17,9 +17,11 @@
  */
 
 
-#include <boost/multi_array.hpp>
+#include <algorithm>
+#include <cstring>
 #include <fastuidraw/image.hpp>
 #include "private/util_private.hpp"
+#include "private/memory_report_private.hpp"
 
 
 namespace
@@ -148,22 +150,91 @@ namespace
     return return_value;
   }
 
-  /* TODO: take into account for repeated tile colors. */
-  bool
-  enough_room_in_atlas(fastuidraw::ivec2 number_color_tiles,
-                       fastuidraw::ImageAtlas *C,
-                       int &total_index)
+  /* set the rows [row_begin, row_end) of dst as the 2x2 box
+     filter of src, dst_dims = Image::mipmap_level_dimensions(src_dims, 1)
+   */
+  void
+  downsample_mipmap_level(fastuidraw::const_c_array<fastuidraw::u8vec4> src,
+                          fastuidraw::ivec2 src_dims, int src_stride,
+                          fastuidraw::c_array<fastuidraw::u8vec4> dst,
+                          fastuidraw::ivec2 dst_dims, int dst_stride,
+                          int row_begin, int row_end)
+  {
+    for(int y = row_begin; y < row_end; ++y)
+      {
+        int y0, y1;
+
+        y0 = std::min(2 * y, src_dims.y() - 1);
+        y1 = std::min(2 * y + 1, src_dims.y() - 1);
+        for(int x = 0; x < dst_dims.x(); ++x)
+          {
+            int x0, x1;
+            fastuidraw::u8vec4 &v(dst[x + y * dst_stride]);
+
+            x0 = std::min(2 * x, src_dims.x() - 1);
+            x1 = std::min(2 * x + 1, src_dims.x() - 1);
+            for(unsigned int c = 0; c < 4; ++c)
+              {
+                unsigned int sum;
+                sum = src[x0 + y0 * src_stride][c] + src[x1 + y0 * src_stride][c]
+                  + src[x0 + y1 * src_stride][c] + src[x1 + y1 * src_stride][c];
+                v[c] = static_cast<uint8_t>((sum + 2u) / 4u);
+              }
+          }
+      }
+  }
+
+  /* rows of a mipmap level below which a level is
+     downsampled on the calling thread
+   */
+  const unsigned int min_downsample_rows_per_task = 128;
+
+  /* job for run_in_parallel() to downsample the rows
+     of a mipmap level, each row only reads from the
+     previous level.
+   */
+  class downsample_job
   {
-    int total_color;
+  public:
+    downsample_job(fastuidraw::const_c_array<fastuidraw::u8vec4> src,
+                   fastuidraw::ivec2 src_dims,
+                   fastuidraw::c_array<fastuidraw::u8vec4> dst,
+                   fastuidraw::ivec2 dst_dims, int stride):
+      m_src(src), m_src_dims(src_dims),
+      m_dst(dst), m_dst_dims(dst_dims),
+      m_stride(stride)
+    {}
+
+    void
+    operator()(unsigned int b, unsigned int e)
+    {
+      downsample_mipmap_level(m_src, m_src_dims, m_stride,
+                              m_dst, m_dst_dims, m_stride,
+                              b, e);
+    }
+
+  private:
+    fastuidraw::const_c_array<fastuidraw::u8vec4> m_src;
+    fastuidraw::ivec2 m_src_dims;
+    fastuidraw::c_array<fastuidraw::u8vec4> m_dst;
+    fastuidraw::ivec2 m_dst_dims;
+    int m_stride;
+  };
 
-    total_color = number_color_tiles.x() * number_color_tiles.y();
-    total_index = number_index_tiles_needed(number_color_tiles, C->index_tile_size());
+  fastuidraw::ivec2
+  compute_stored_dimensions(fastuidraw::ivec2 dims, unsigned int number_levels)
+  {
+    fastuidraw::ivec2 last_location, last_dims;
 
-    //std::cout << "Need " << total_color << " have: " << C->number_free_color_tiles() << "\n"
-    //        << "Need " << total_index << " have: " << C->number_free_index_tiles() << "\n";
+    if(number_levels <= 1)
+      {
+        return dims;
+      }
 
-    return total_color <= C->number_free_color_tiles()
-      && total_index <= C->number_free_index_tiles();
+    last_location = fastuidraw::Image::mipmap_level_location(dims, number_levels - 1);
+    last_dims = fastuidraw::Image::mipmap_level_dimensions(dims, number_levels - 1);
+    return fastuidraw::ivec2(dims.x() + fastuidraw::Image::mipmap_level_dimensions(dims, 1).x(),
+                             std::max(dims.y(), last_location.y() + last_dims.y()));
   }
 
   class BackingStorePrivate
@@ -179,17 +250,63 @@ namespace
       m_resizeable(presizable)
     {}
 
+    /* both the color and index texels are 4 bytes */
+    uint64_t
+    bytes(void) const
+    {
+      return 4u * uint64_t(m_dimensions.x()) * uint64_t(m_dimensions.y()) * uint64_t(m_dimensions.z());
+    }
+
     fastuidraw::ivec3 m_dimensions;
     bool m_resizeable;
   };
 
-  class inited_bool
+  /* bit helpers for the free-tile bitmaps of tile_allocator */
+  inline
+  unsigned int
+  lowest_set_bit(uint64_t v)
   {
-  public:
-    bool m_value;
-    inited_bool(bool b = false):m_value(b) {}
-  };
+    assert(v != 0);
+    #if defined(__GNUC__)
+      {
+        return __builtin_ctzll(v);
+      }
+    #else
+      {
+        unsigned int return_value(0);
+        for(; (v & 1u) == 0; v >>= 1u, ++return_value)
+          {}
+        return return_value;
+      }
+    #endif
+  }
+
+  inline
+  int
+  number_bits_set(uint64_t v)
+  {
+    #if defined(__GNUC__)
+      {
+        return __builtin_popcountll(v);
+      }
+    #else
+      {
+        int return_value(0);
+        for(; v != 0; v &= v - 1u, ++return_value)
+          {}
+        return return_value;
+      }
+    #endif
+  }
 
+  /* A tile_allocator tracks which tiles of a backing store are
+     free with a bitmap, one bit per tile, the tiles of a layer
+     are numbered x + y * num_tiles().x() and each layer starts
+     on a new word. Allocation is next-fit: the search for a free
+     tile starts at the word of the last allocated tile, so that
+     the tiles allocated in sequence for an image are adjacent
+     in the backing store when there is room to do so.
+   */
   class tile_allocator
   {
   public:
@@ -200,6 +317,13 @@ namespace
     fastuidraw::ivec3
     allocate_tile(void);
 
+    /* allocate count.x() by count.y() tiles that are
+       adjacent in a single layer, returns false if
+       there is no such free rectangle of tiles.
+     */
+    bool
+    allocate_block(fastuidraw::ivec2 count, fastuidraw::ivec3 &first);
+
     void
     delete_tile(fastuidraw::ivec3 v);
 
@@ -209,6 +333,13 @@ namespace
     bool
     resize_to_fit(int num_tiles);
 
+    /* remove the trailing layers all of whose tiles are
+       free, keeping at least min_layers layers; returns
+       true if a layer was removed.
+     */
+    bool
+    remove_free_layers(int min_layers);
+
     void
     delay_tile_freeing(void);
 
@@ -228,21 +359,58 @@ namespace
     }
 
   private:
+    enum { bits_per_word = 64 };
+
+    /* add the words for the layers [begin_layer, m_num_tiles.z())
+       with all their tiles free
+     */
     void
-    delete_tile_implement(fastuidraw::ivec3 v);
+    add_layers(int begin_layer);
+
+    unsigned int
+    word_of_tile(fastuidraw::ivec3 v, uint64_t &mask) const;
+
+    bool
+    block_free(fastuidraw::ivec3 first, fastuidraw::ivec2 count) const;
 
     int m_tile_size;
-    fastuidraw::ivec3 m_next_tile;
     fastuidraw::ivec3 m_num_tiles;
-    std::vector<fastuidraw::ivec3> m_free_tiles;
+    int m_words_per_layer;
     int m_tile_count;
 
+    /* bit is up if the tile is free */
+    std::vector<uint64_t> m_free_tiles;
+
+    /* word of m_free_tiles from which the next search begins */
+    unsigned int m_search_word;
+
+    /* bit is up if the tile is deleted but its
+       freeing is delayed, see delay_tile_freeing()
+     */
     int m_delay_tile_freeing_counter;
-    std::vector<fastuidraw::ivec3> m_delayed_free_tiles;
+    std::vector<uint64_t> m_delayed_free_tiles;
+    bool m_have_delayed_free_tiles;
+  };
 
-    #ifdef FASTUIDRAW_DEBUG
-    boost::multi_array<inited_bool, 3> m_tile_allocated;
-    #endif
+  class shared_color_tile
+  {
+  public:
+    shared_color_tile(void):
+      m_tile(0, 0, 0),
+      m_count(0)
+    {}
+
+    bool
+    same_texels(fastuidraw::const_c_array<fastuidraw::u8vec4> data) const
+    {
+      return data.size() == m_texels.size()
+        && (data.empty() || std::memcmp(data.c_ptr(), &m_texels[0],
+                                        sizeof(fastuidraw::u8vec4) * data.size()) == 0);
+    }
+
+    fastuidraw::ivec3 m_tile;
+    unsigned int m_count;
+    std::vector<fastuidraw::u8vec4> m_texels;
   };
 
   class ImageAtlasPrivate
@@ -255,18 +423,59 @@ namespace
       m_color_tiles(pcolor_tile_size, pcolor_store->dimensions()),
       m_index_store(pindex_store),
       m_index_tiles(pindex_tile_size, pindex_store->dimensions()),
-      m_resizeable(m_color_store->resizeable() && m_index_store->resizeable())
+      m_resizeable(m_color_store->resizeable() && m_index_store->resizeable()),
+      m_direct_index_lookup(false),
+      m_number_flushes(0),
+      m_reserved_color_tiles(0),
+      m_reserved_index_tiles(0)
     {}
 
+    /* allocate a tile from the named allocator; if the atlas
+       is resizeable and there is no free tile, the atlas is
+       first grown. Because this is done with m_mutex locked,
+       Image objects created concurrently on different threads
+       cannot together exhaust a resizeable atlas between the
+       check of Image::create() and the allocation of the tiles.
+     */
+    fastuidraw::ivec3
+    allocate_color_tile(void);
+
+    fastuidraw::ivec3
+    allocate_index_tile(void);
+
+    bool
+    allocate_index_tile_block(fastuidraw::ivec2 count, fastuidraw::ivec3 &first);
+
     fastuidraw::mutex m_mutex;
 
     fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase> m_color_store;
     tile_allocator m_color_tiles;
 
+    /* color tiles of identical content are stored once; the
+       tiles are keyed by a 128-bit hash of their texels
+       and each records how many times it was added and a
+       copy of its texels to compare against. A tile whose
+       hash matches a shared tile of different texels is not
+       shared and is not in m_hash_of_color_tile.
+     */
+    std::map<fastuidraw::texel_hash, shared_color_tile> m_shared_color_tiles;
+    std::map<fastuidraw::ivec3, fastuidraw::texel_hash> m_hash_of_color_tile;
+
     fastuidraw::reference_counted_ptr<fastuidraw::AtlasIndexBackingStoreBase> m_index_store;
     tile_allocator m_index_tiles;
 
     bool m_resizeable;
+    bool m_direct_index_lookup;
+    uint64_t m_number_flushes;
+
+    /* tiles reserved by ImageAtlas::reserve_tiles() for the
+       Image objects under construction; the reserved count is
+       released only after the construction, so it is counted
+       against the free tiles even after the Image allocated
+       them which errs on the side of refusing an Image.
+     */
+    int m_reserved_color_tiles;
+    int m_reserved_index_tiles;
   };
 
   class per_color_tile
@@ -291,55 +500,305 @@ namespace
     ImagePrivate(fastuidraw::reference_counted_ptr<fastuidraw::ImageAtlas> patlas,
                  int w, int h,
                  fastuidraw::const_c_array<fastuidraw::u8vec4> image_data,
-                 unsigned int pslack);
+                 unsigned int pslack, unsigned int pnumber_mipmap_levels);
+
+    ImagePrivate(fastuidraw::reference_counted_ptr<fastuidraw::ImageAtlas> patlas,
+                 int w, int h,
+                 fastuidraw::reference_counted_ptr<fastuidraw::ImageTileProvider> provider,
+                 unsigned int pslack, unsigned int max_resident_tiles,
+                 fastuidraw::u8vec4 fallback_color);
+
+    /* an image whose texels are a bindless texture */
+    ImagePrivate(int w, int h, uint64_t handle, bool external_texture,
+                 bool premultiplied_alpha);
 
     ~ImagePrivate();
 
     void
     create_color_tiles(fastuidraw::const_c_array<fastuidraw::u8vec4> image_data);
 
+    /* make all color tiles point to a single
+       tile of the fallback color
+     */
+    void
+    create_fallback_color_tiles(fastuidraw::u8vec4 fallback_color);
+
+    /* make resident the color tile I of m_color_tiles,
+       texels and tile_data are work room
+     */
+    void
+    make_tile_resident(unsigned int I,
+                       std::vector<fastuidraw::u8vec4> &texels,
+                       std::vector<fastuidraw::u8vec4> &tile_data);
+
+    /* make non-resident the color tile I of m_color_tiles */
+    void
+    make_tile_non_resident(unsigned int I);
+
+    /* returns the index into m_index_tiles of
+       the index tile of the color tile I
+     */
+    unsigned int
+    index_tile_of_color_tile(unsigned int I) const;
+
+    /* set the data of the index tile J of m_index_tiles
+       from m_color_tiles, tile_data is work room
+     */
+    void
+    update_index_tile(unsigned int J, std::vector<fastuidraw::ivec3> &tile_data);
+
     void
     create_index_tiles(void);
 
+    /* create the first level of index tiles as a single
+       block of adjacent index tiles so that the image
+       needs only one index lookup, returns false if the
+       atlas has no room for the block.
+     */
+    bool
+    create_direct_index_tiles(fastuidraw::ivec2 num_index_tiles);
+
     template<typename T>
     fastuidraw::ivec2
     create_index_layer(fastuidraw::const_c_array<T> src_tiles,
                        fastuidraw::ivec2 src_dims, int slack,
-                       std::list<std::vector<fastuidraw::ivec3> > &destination);
+                       std::vector<fastuidraw::ivec3> &destination);
 
     fastuidraw::reference_counted_ptr<fastuidraw::ImageAtlas> m_atlas;
     fastuidraw::ivec2 m_dimensions;
     unsigned int m_slack;
     fastuidraw::ivec2 m_num_color_tiles;
 
+    /* dimensions of all mipmap levels together, the
+       color tiles are made from this area.
+     */
+    unsigned int m_number_mipmap_levels;
+    fastuidraw::ivec2 m_stored_dimensions;
+
     std::map<fastuidraw::u8vec4, fastuidraw::ivec3> m_repeated_tiles;
     std::vector<per_color_tile> m_color_tiles;
-    std::list<std::vector<fastuidraw::ivec3> > m_index_tiles;
+
+    /* the index tiles of all the index levels, the tiles
+       of the first level (whose entries are color tiles)
+       first and the last tile is the master index tile.
+     */
+    std::vector<fastuidraw::ivec3> m_index_tiles;
 
     fastuidraw::ivec3 m_master_index_tile;
     fastuidraw::vec2 m_master_index_tile_dims;
     unsigned int m_number_index_lookups;
     float m_dimensions_index_divisor;
+
+    /* only used by streaming images, i.e. when
+       m_provider is non-NULL; the m_non_repeat_color
+       of an element of m_color_tiles is then true
+       exactly when the tile is resident.
+     */
+    fastuidraw::reference_counted_ptr<fastuidraw::ImageTileProvider> m_provider;
+    unsigned int m_max_resident_tiles;
+    unsigned int m_number_resident_tiles;
+
+    /* value of m_current_frame when each color
+       tile was last requested by request_region()
+     */
+    uint64_t m_current_frame;
+    std::vector<uint64_t> m_last_requested;
+
+    /* tiles requested since the last update_residency() */
+    std::vector<unsigned int> m_requested;
+
+    /* value of ImageAtlas::number_flushes() after the
+       tiles of the image were last written to the atlas
+     */
+    uint64_t m_written_at_flush;
+
+    /* non-zero exactly when the image is a bindless
+       texture, then m_atlas is NULL.
+     */
+    uint64_t m_bindless_handle;
+
+    /* true if the bindless texture is an external
+       texture (i.e. GL_TEXTURE_EXTERNAL_OES)
+     */
+    bool m_bindless_external_texture;
+
+    /* true if the texels of the bindless texture
+       are pre-multiplied by alpha
+     */
+    bool m_premultiplied_alpha;
   };
 }
 
+////////////////////////////////////////////
+// ImageAtlasPrivate methods
+fastuidraw::ivec3
+ImageAtlasPrivate::
+allocate_color_tile(void)
+{
+  if(m_resizeable && m_color_tiles.number_free() == 0
+     && m_color_tiles.resize_to_fit(1))
+    {
+      m_color_store->resize(m_color_tiles.num_tiles().z());
+    }
+  return m_color_tiles.allocate_tile();
+}
+
+fastuidraw::ivec3
+ImageAtlasPrivate::
+allocate_index_tile(void)
+{
+  if(m_resizeable && m_index_tiles.number_free() == 0
+     && m_index_tiles.resize_to_fit(1))
+    {
+      m_index_store->resize(m_index_tiles.num_tiles().z());
+    }
+  return m_index_tiles.allocate_tile();
+}
+
+bool
+ImageAtlasPrivate::
+allocate_index_tile_block(fastuidraw::ivec2 count, fastuidraw::ivec3 &first)
+{
+  if(count.x() > m_index_tiles.num_tiles().x()
+     || count.y() > m_index_tiles.num_tiles().y())
+    {
+      return false;
+    }
+
+  if(m_index_tiles.allocate_block(count, first))
+    {
+      return true;
+    }
+
+  /* a new layer has all of its tiles free and so is
+     certain to have room for the block.
+   */
+  if(m_resizeable
+     && m_index_tiles.resize_to_fit(m_index_tiles.number_free()
+                                    + m_index_tiles.num_tiles().x() * m_index_tiles.num_tiles().y()))
+    {
+      m_index_store->resize(m_index_tiles.num_tiles().z());
+      return m_index_tiles.allocate_block(count, first);
+    }
+  return false;
+}
+
 /////////////////////////////////////////////
 //ImagePrivate methods
 ImagePrivate::
 ImagePrivate(fastuidraw::reference_counted_ptr<fastuidraw::ImageAtlas> patlas,
              int w, int h,
              fastuidraw::const_c_array<fastuidraw::u8vec4> image_data,
-             unsigned int pslack):
+             unsigned int pslack, unsigned int pnumber_mipmap_levels):
+  m_atlas(patlas),
+  m_dimensions(w,h),
+  m_slack(pslack),
+  m_number_mipmap_levels(pnumber_mipmap_levels),
+  m_stored_dimensions(compute_stored_dimensions(m_dimensions, m_number_mipmap_levels)),
+  m_bindless_handle(0),
+  m_bindless_external_texture(false),
+  m_premultiplied_alpha(false)
+{
+  assert(m_dimensions.x() > 0);
+  assert(m_dimensions.y() > 0);
+  assert(m_atlas);
+  assert(m_number_mipmap_levels >= 1);
+
+  if(m_number_mipmap_levels > 1)
+    {
+      std::vector<fastuidraw::u8vec4> stored_data;
+      int stride(m_stored_dimensions.x());
+
+      stored_data.resize(m_stored_dimensions.x() * m_stored_dimensions.y(),
+                         fastuidraw::u8vec4(0, 0, 0, 0));
+      for(int y = 0; y < m_dimensions.y(); ++y)
+        {
+          std::copy(image_data.begin() + y * m_dimensions.x(),
+                    image_data.begin() + (y + 1) * m_dimensions.x(),
+                    stored_data.begin() + y * stride);
+        }
+
+      fastuidraw::ivec2 src_location(0, 0), src_dims(m_dimensions);
+      for(unsigned int L = 1; L < m_number_mipmap_levels; ++L)
+        {
+          fastuidraw::ivec2 dst_location, dst_dims;
+
+          dst_location = fastuidraw::Image::mipmap_level_location(m_dimensions, L);
+          dst_dims = fastuidraw::Image::mipmap_level_dimensions(m_dimensions, L);
+
+          downsample_job job(fastuidraw::make_c_array(stored_data).sub_array(src_location.x() + src_location.y() * stride),
+                             src_dims,
+                             fastuidraw::make_c_array(stored_data).sub_array(dst_location.x() + dst_location.y() * stride),
+                             dst_dims, stride);
+          fastuidraw::run_in_parallel(static_cast<unsigned int>(dst_dims.y()), 0,
+                                      min_downsample_rows_per_task, job);
+          src_location = dst_location;
+          src_dims = dst_dims;
+        }
+      create_color_tiles(fastuidraw::make_c_array(stored_data));
+    }
+  else
+    {
+      create_color_tiles(image_data);
+    }
+  create_index_tiles();
+  m_written_at_flush = m_atlas->number_flushes();
+}
+
+ImagePrivate::
+ImagePrivate(fastuidraw::reference_counted_ptr<fastuidraw::ImageAtlas> patlas,
+             int w, int h,
+             fastuidraw::reference_counted_ptr<fastuidraw::ImageTileProvider> provider,
+             unsigned int pslack, unsigned int max_resident_tiles,
+             fastuidraw::u8vec4 fallback_color):
   m_atlas(patlas),
   m_dimensions(w,h),
-  m_slack(pslack)
+  m_slack(pslack),
+  m_number_mipmap_levels(1),
+  m_stored_dimensions(m_dimensions),
+  m_provider(provider),
+  m_max_resident_tiles(max_resident_tiles),
+  m_number_resident_tiles(0),
+  m_current_frame(1),
+  m_bindless_handle(0),
+  m_bindless_external_texture(false),
+  m_premultiplied_alpha(false)
 {
   assert(m_dimensions.x() > 0);
   assert(m_dimensions.y() > 0);
   assert(m_atlas);
+  assert(m_provider);
+  assert(m_max_resident_tiles > 0);
 
-  create_color_tiles(image_data);
+  create_fallback_color_tiles(fallback_color);
   create_index_tiles();
+  m_last_requested.resize(m_color_tiles.size(), 0);
+  m_written_at_flush = m_atlas->number_flushes();
+}
+
+ImagePrivate::
+ImagePrivate(int w, int h, uint64_t handle, bool external_texture,
+             bool premultiplied_alpha):
+  m_dimensions(w, h),
+  m_slack(0),
+  m_num_color_tiles(0, 0),
+  m_number_mipmap_levels(1),
+  m_stored_dimensions(m_dimensions),
+  m_master_index_tile(0, 0, 0),
+  m_master_index_tile_dims(m_dimensions),
+  m_number_index_lookups(0),
+  m_dimensions_index_divisor(1.0f),
+  m_max_resident_tiles(0),
+  m_number_resident_tiles(0),
+  m_current_frame(1),
+  m_written_at_flush(0),
+  m_bindless_handle(handle),
+  m_bindless_external_texture(external_texture),
+  m_premultiplied_alpha(premultiplied_alpha)
+{
+  assert(m_dimensions.x() > 0);
+  assert(m_dimensions.y() > 0);
+  assert(m_bindless_handle != 0);
 }
 
 ImagePrivate::
@@ -360,14 +819,10 @@ ImagePrivate::
       m_atlas->delete_color_tile(iter->second);
     }
 
-  for(std::list<std::vector<fastuidraw::ivec3> >::const_iterator viter = m_index_tiles.begin(),
-        vend = m_index_tiles.end(); viter != vend; ++viter)
+  for(std::vector<fastuidraw::ivec3>::const_iterator iter = m_index_tiles.begin(),
+        end = m_index_tiles.end(); iter != end; ++iter)
     {
-      for(std::vector<fastuidraw::ivec3>::const_iterator iter = viter->begin(),
-            end = viter->end(); iter != end; ++iter)
-        {
-          m_atlas->delete_index_tile(*iter);
-        }
+      m_atlas->delete_index_tile(*iter);
     }
 }
 
@@ -380,8 +835,8 @@ create_color_tiles(fastuidraw::const_c_array<fastuidraw::u8vec4> image_data)
 
   color_tile_size = m_atlas->color_tile_size();
   tile_interior_size = color_tile_size - 2 * m_slack;
-  m_num_color_tiles = divide_up(m_dimensions, tile_interior_size);
-  m_master_index_tile_dims = fastuidraw::vec2(m_dimensions) / static_cast<float>(tile_interior_size);
+  m_num_color_tiles = divide_up(m_stored_dimensions, tile_interior_size);
+  m_master_index_tile_dims = fastuidraw::vec2(m_stored_dimensions) / static_cast<float>(tile_interior_size);
   m_dimensions_index_divisor = static_cast<float>(tile_interior_size);
 
   unsigned int savings(0);
@@ -399,7 +854,7 @@ create_color_tiles(fastuidraw::const_c_array<fastuidraw::u8vec4> image_data)
 
           all_same_color = copy_sub_data<fastuidraw::u8vec4>(make_c_array(tile_data), color_tile_size,
                                                             image_data, source_x, source_y,
-                                                            m_dimensions);
+                                                            m_stored_dimensions);
           if(all_same_color)
             {
               std::map<fastuidraw::u8vec4, fastuidraw::ivec3>::iterator iter;
@@ -439,6 +894,112 @@ create_color_tiles(fastuidraw::const_c_array<fastuidraw::u8vec4> image_data)
 }
 
 
+void
+ImagePrivate::
+create_fallback_color_tiles(fastuidraw::u8vec4 fallback_color)
+{
+  int tile_interior_size;
+  int color_tile_size;
+  fastuidraw::ivec3 fallback_tile;
+
+  color_tile_size = m_atlas->color_tile_size();
+  tile_interior_size = color_tile_size - 2 * m_slack;
+  m_num_color_tiles = divide_up(m_dimensions, tile_interior_size);
+  m_master_index_tile_dims = fastuidraw::vec2(m_dimensions) / static_cast<float>(tile_interior_size);
+  m_dimensions_index_divisor = static_cast<float>(tile_interior_size);
+
+  /* the fallback tile is kept in m_repeated_tiles so
+     that it is deleted with the repeated color tiles.
+   */
+  std::vector<fastuidraw::u8vec4> tile_data(color_tile_size * color_tile_size, fallback_color);
+  fallback_tile = m_atlas->add_color_tile(make_c_array(tile_data));
+  m_repeated_tiles[fallback_color] = fallback_tile;
+  m_color_tiles.resize(m_num_color_tiles.x() * m_num_color_tiles.y(),
+                       per_color_tile(fallback_tile, false));
+}
+
+void
+ImagePrivate::
+make_tile_resident(unsigned int I,
+                   std::vector<fastuidraw::u8vec4> &texels,
+                   std::vector<fastuidraw::u8vec4> &tile_data)
+{
+  int tile_interior_size;
+  int color_tile_size;
+  fastuidraw::ivec2 tile, source, min_corner, max_corner, size;
+
+  assert(!m_color_tiles[I].m_non_repeat_color);
+  color_tile_size = m_atlas->color_tile_size();
+  tile_interior_size = color_tile_size - 2 * m_slack;
+  tile = fastuidraw::ivec2(I % m_num_color_tiles.x(), I / m_num_color_tiles.x());
+
+  /* the color tile covers [source, source + color_tile_size)
+     of the image; fetch from the provider only the part within
+     the image, copy_sub_data() then replicates the boundary
+     texels for the part outside of the image.
+   */
+  for(unsigned int c = 0; c < 2; ++c)
+    {
+      source[c] = tile[c] * tile_interior_size - static_cast<int>(m_slack);
+      min_corner[c] = std::max(source[c], 0);
+      max_corner[c] = std::min(source[c] + color_tile_size, m_dimensions[c]);
+      size[c] = max_corner[c] - min_corner[c];
+    }
+
+  texels.resize(size.x() * size.y());
+  tile_data.resize(color_tile_size * color_tile_size);
+  m_provider->fetch_texels(min_corner, size, make_c_array(texels));
+  copy_sub_data<fastuidraw::u8vec4, fastuidraw::u8vec4>(make_c_array(tile_data), color_tile_size,
+                                                        make_c_array(texels),
+                                                        source.x() - min_corner.x(),
+                                                        source.y() - min_corner.y(),
+                                                        size);
+
+  m_color_tiles[I] = per_color_tile(m_atlas->add_color_tile(make_c_array(tile_data)), true);
+  ++m_number_resident_tiles;
+}
+
+void
+ImagePrivate::
+make_tile_non_resident(unsigned int I)
+{
+  assert(m_color_tiles[I].m_non_repeat_color);
+  assert(!m_repeated_tiles.empty());
+  m_atlas->delete_color_tile(m_color_tiles[I].m_tile);
+  m_color_tiles[I] = per_color_tile(m_repeated_tiles.begin()->second, false);
+  --m_number_resident_tiles;
+}
+
+unsigned int
+ImagePrivate::
+index_tile_of_color_tile(unsigned int I) const
+{
+  int index_tile_size, num_index_tiles_x;
+
+  index_tile_size = m_atlas->index_tile_size();
+  num_index_tiles_x = divide_up(m_num_color_tiles, index_tile_size).x();
+  return (I % m_num_color_tiles.x()) / index_tile_size
+    + num_index_tiles_x * ((I / m_num_color_tiles.x()) / index_tile_size);
+}
+
+void
+ImagePrivate::
+update_index_tile(unsigned int J, std::vector<fastuidraw::ivec3> &tile_data)
+{
+  int index_tile_size, num_index_tiles_x;
+
+  index_tile_size = m_atlas->index_tile_size();
+  num_index_tiles_x = divide_up(m_num_color_tiles, index_tile_size).x();
+  tile_data.resize(index_tile_size * index_tile_size);
+  copy_sub_data<fastuidraw::ivec3, per_color_tile>(make_c_array(tile_data),
+                                                   index_tile_size,
+                                                   fastuidraw::make_c_array(m_color_tiles),
+                                                   index_tile_size * (J % num_index_tiles_x),
+                                                   index_tile_size * (J / num_index_tiles_x),
+                                                   m_num_color_tiles);
+  m_atlas->set_index_tile(m_index_tiles[J], make_c_array(tile_data), m_slack);
+}
+
 /*
   returns the number of index tiles needed to
   store the created index data.
@@ -448,7 +1009,7 @@ fastuidraw::ivec2
 ImagePrivate::
 create_index_layer(fastuidraw::const_c_array<T> src_tiles,
                    fastuidraw::ivec2 src_dims, int slack,
-                   std::list<std::vector<fastuidraw::ivec3> > &destination)
+                   std::vector<fastuidraw::ivec3> &destination)
 {
   int index_tile_size;
   fastuidraw::ivec2 num_index_tiles;
@@ -456,8 +1017,6 @@ create_index_layer(fastuidraw::const_c_array<T> src_tiles,
   index_tile_size = m_atlas->index_tile_size();
   num_index_tiles = divide_up(src_dims, index_tile_size);
 
-  destination.push_back(std::vector<fastuidraw::ivec3>());
-
   std::vector<fastuidraw::ivec3> vtile_data(index_tile_size * index_tile_size);
   fastuidraw::c_array<fastuidraw::ivec3> tile_data;
   tile_data = fastuidraw::make_c_array(vtile_data);
@@ -481,7 +1040,7 @@ create_index_layer(fastuidraw::const_c_array<T> src_tiles,
               new_tile = m_atlas->add_index_tile(tile_data, slack);
             }
 
-          destination.back().push_back(new_tile);
+          destination.push_back(new_tile);
         }
     }
   return num_index_tiles;
@@ -492,28 +1051,96 @@ ImagePrivate::
 create_index_tiles(void)
 {
   fastuidraw::ivec2 num_index_tiles;
-  int level(2);
+  int level(2), index_tile_size;
   float findex_tile_size;
+  unsigned int total_index_tiles, layer_begin;
+
+  index_tile_size = m_atlas->index_tile_size();
+  findex_tile_size = static_cast<float>(index_tile_size);
+
+  num_index_tiles = divide_up(m_num_color_tiles, index_tile_size);
+  if(m_atlas->direct_index_lookup()
+     && (num_index_tiles.x() > 1 || num_index_tiles.y() > 1)
+     && create_direct_index_tiles(num_index_tiles))
+    {
+      return;
+    }
+
+  /* reserve the room for the tiles of all levels so that a
+     level can be built from the previous level in place.
+   */
+  total_index_tiles = num_index_tiles.x() * num_index_tiles.y();
+  while(num_index_tiles.x() > 1 || num_index_tiles.y() > 1)
+    {
+      num_index_tiles = divide_up(num_index_tiles, index_tile_size);
+      total_index_tiles += num_index_tiles.x() * num_index_tiles.y();
+    }
+  m_index_tiles.reserve(total_index_tiles);
 
-  findex_tile_size = static_cast<float>(m_atlas->index_tile_size());
   num_index_tiles = create_index_layer<per_color_tile>(fastuidraw::make_c_array(m_color_tiles),
                                                        m_num_color_tiles,
                                                        m_slack,
                                                        m_index_tiles);
 
-  for(level = 2; num_index_tiles.x() > 1 || num_index_tiles.y() > 1; ++level)
+  for(level = 2, layer_begin = 0; num_index_tiles.x() > 1 || num_index_tiles.y() > 1; ++level)
     {
-      num_index_tiles = create_index_layer<fastuidraw::ivec3>(fastuidraw::make_c_array(m_index_tiles.back()),
+      fastuidraw::const_c_array<fastuidraw::ivec3> src_tiles;
+      unsigned int layer_end(m_index_tiles.size());
+
+      src_tiles = fastuidraw::const_c_array<fastuidraw::ivec3>(&m_index_tiles[layer_begin],
+                                                               layer_end - layer_begin);
+      num_index_tiles = create_index_layer<fastuidraw::ivec3>(src_tiles,
                                                              num_index_tiles,
                                                              -1, //indicates from index tile
                                                              m_index_tiles);
+      layer_begin = layer_end;
       m_dimensions_index_divisor *= findex_tile_size;
       m_master_index_tile_dims /= findex_tile_size;
     }
 
-  assert(m_index_tiles.back().size() == 1);
-  m_master_index_tile = m_index_tiles.back()[0];
-  m_number_index_lookups = m_index_tiles.size();
+  assert(m_index_tiles.size() == total_index_tiles);
+  assert(m_index_tiles.size() == layer_begin + 1);
+  m_master_index_tile = m_index_tiles.back();
+  m_number_index_lookups = level - 1;
+}
+
+bool
+ImagePrivate::
+create_direct_index_tiles(fastuidraw::ivec2 num_index_tiles)
+{
+  fastuidraw::ivec3 first;
+  std::vector<fastuidraw::ivec3> tile_data;
+
+  if(!m_atlas->add_index_tile_block(num_index_tiles, first))
+    {
+      return false;
+    }
+
+  /* the tiles of the block are in the same order as the
+     tiles of the first index level made by create_index_layer(),
+     so index_tile_of_color_tile() and update_index_tile() apply
+     unchanged. The block is then a single master index tile
+     of num_index_tiles index tiles, and the index coordinate
+     of a texel, whose unit is a color tile, selects the entry
+     of its color tile directly.
+   */
+  m_index_tiles.reserve(num_index_tiles.x() * num_index_tiles.y());
+  for(int y = 0; y < num_index_tiles.y(); ++y)
+    {
+      for(int x = 0; x < num_index_tiles.x(); ++x)
+        {
+          m_index_tiles.push_back(first + fastuidraw::ivec3(x, y, 0));
+        }
+    }
+
+  for(unsigned int J = 0; J < m_index_tiles.size(); ++J)
+    {
+      update_index_tile(J, tile_data);
+    }
+
+  m_master_index_tile = first;
+  m_number_index_lookups = 1;
+  return true;
 }
 
 ///////////////////////////////////////////
@@ -521,21 +1148,18 @@ create_index_tiles(void)
 tile_allocator::
 tile_allocator(int tile_size, fastuidraw::ivec3 store_dimensions):
   m_tile_size(tile_size),
-  m_next_tile(0, 0, 0),
   m_num_tiles(store_dimensions.x() / m_tile_size,
               store_dimensions.y() / m_tile_size,
               store_dimensions.z()),
+  m_words_per_layer((m_num_tiles.x() * m_num_tiles.y() + bits_per_word - 1) / bits_per_word),
   m_tile_count(0),
-  m_delay_tile_freeing_counter(0)
+  m_search_word(0),
+  m_delay_tile_freeing_counter(0),
+  m_have_delayed_free_tiles(false)
 {
   assert(store_dimensions.x() % m_tile_size == 0);
   assert(store_dimensions.y() % m_tile_size == 0);
-
-  #ifdef FASTUIDRAW_DEBUG
-    {
-      m_tile_allocated.resize(boost::extents[m_num_tiles.x()][m_num_tiles.y()][m_num_tiles.z()]);
-    }
-  #endif
+  add_layers(0);
 }
 
 tile_allocator::
@@ -545,49 +1169,129 @@ tile_allocator::
   assert(m_tile_count == 0);
 }
 
-fastuidraw::ivec3
+void
 tile_allocator::
-allocate_tile(void)
+add_layers(int begin_layer)
 {
-  fastuidraw::ivec3 return_value;
-  if(m_free_tiles.empty())
+  int tiles_per_layer, full_words, tail_bits;
+
+  tiles_per_layer = m_num_tiles.x() * m_num_tiles.y();
+  full_words = tiles_per_layer / bits_per_word;
+  tail_bits = tiles_per_layer - full_words * bits_per_word;
+
+  m_free_tiles.resize(m_words_per_layer * m_num_tiles.z(), 0u);
+  m_delayed_free_tiles.resize(m_words_per_layer * m_num_tiles.z(), 0u);
+  for(int z = begin_layer; z < m_num_tiles.z(); ++z)
     {
-      if(m_next_tile.x() < m_num_tiles.x() || m_next_tile.y() < m_num_tiles.y() || m_next_tile.z() < m_num_tiles.z())
-        {
-          return_value = m_next_tile;
-          ++m_next_tile.x();
-          if(m_next_tile.x() == m_num_tiles.x())
-            {
-              m_next_tile.x() = 0;
-              ++m_next_tile.y();
-              if(m_next_tile.y() == m_num_tiles.y())
-                {
-                  m_next_tile.y() = 0;
-                  ++m_next_tile.z();
-                }
-            }
-        }
-      else
+      unsigned int w(z * m_words_per_layer);
+
+      std::fill(m_free_tiles.begin() + w, m_free_tiles.begin() + w + full_words,
+                ~uint64_t(0));
+      if(tail_bits > 0)
         {
-          assert(!"Color tile room exhausted");
-          return fastuidraw::ivec3(-1, -1,-1);
+          m_free_tiles[w + full_words] = (uint64_t(1) << tail_bits) - 1u;
         }
     }
-  else
-    {
-      return_value = m_free_tiles.back();
-      m_free_tiles.pop_back();
-    }
-
-  #ifdef FASTUIDRAW_DEBUG
-    {
-      assert(!m_tile_allocated[return_value.x()][return_value.y()][return_value.z()].m_value);
-      m_tile_allocated[return_value.x()][return_value.y()][return_value.z()] = true;
-    }
-  #endif
-
-  ++m_tile_count;
-  return return_value;
+}
+
+unsigned int
+tile_allocator::
+word_of_tile(fastuidraw::ivec3 v, uint64_t &mask) const
+{
+  int t;
+
+  assert(v.x() >= 0 && v.x() < m_num_tiles.x());
+  assert(v.y() >= 0 && v.y() < m_num_tiles.y());
+  assert(v.z() >= 0 && v.z() < m_num_tiles.z());
+  t = v.x() + v.y() * m_num_tiles.x();
+  mask = uint64_t(1) << (t % bits_per_word);
+  return v.z() * m_words_per_layer + t / bits_per_word;
+}
+
+fastuidraw::ivec3
+tile_allocator::
+allocate_tile(void)
+{
+  unsigned int num_words(m_free_tiles.size());
+
+  for(unsigned int i = 0; i < num_words; ++i)
+    {
+      unsigned int w;
+
+      w = (m_search_word + i) % num_words;
+      if(m_free_tiles[w] != 0u)
+        {
+          unsigned int bit;
+          int t;
+
+          bit = lowest_set_bit(m_free_tiles[w]);
+          m_free_tiles[w] &= ~(uint64_t(1) << bit);
+          m_search_word = w;
+          ++m_tile_count;
+
+          t = (w % m_words_per_layer) * bits_per_word + bit;
+          return fastuidraw::ivec3(t % m_num_tiles.x(),
+                                   t / m_num_tiles.x(),
+                                   w / m_words_per_layer);
+        }
+    }
+
+  assert(!"Color tile room exhausted");
+  return fastuidraw::ivec3(-1, -1,-1);
+}
+
+bool
+tile_allocator::
+block_free(fastuidraw::ivec3 first, fastuidraw::ivec2 count) const
+{
+  for(int y = 0; y < count.y(); ++y)
+    {
+      for(int x = 0; x < count.x(); ++x)
+        {
+          unsigned int w;
+          uint64_t mask;
+
+          w = word_of_tile(first + fastuidraw::ivec3(x, y, 0), mask);
+          if((m_free_tiles[w] & mask) == 0u)
+            {
+              return false;
+            }
+        }
+    }
+  return true;
+}
+
+bool
+tile_allocator::
+allocate_block(fastuidraw::ivec2 count, fastuidraw::ivec3 &first)
+{
+  for(int z = 0; z < m_num_tiles.z(); ++z)
+    {
+      for(int y = 0; y + count.y() <= m_num_tiles.y(); ++y)
+        {
+          for(int x = 0; x + count.x() <= m_num_tiles.x(); ++x)
+            {
+              if(block_free(fastuidraw::ivec3(x, y, z), count))
+                {
+                  first = fastuidraw::ivec3(x, y, z);
+                  for(int by = 0; by < count.y(); ++by)
+                    {
+                      for(int bx = 0; bx < count.x(); ++bx)
+                        {
+                          unsigned int w;
+                          uint64_t mask;
+
+                          w = word_of_tile(first + fastuidraw::ivec3(bx, by, 0), mask);
+                          m_free_tiles[w] &= ~mask;
+                        }
+                    }
+                  m_tile_count += count.x() * count.y();
+                  return true;
+                }
+            }
+        }
+    }
+  return false;
 }
 
 void
@@ -603,13 +1307,16 @@ undelay_tile_freeing(void)
 {
   assert(m_delay_tile_freeing_counter >= 1);
   --m_delay_tile_freeing_counter;
-  if(m_delay_tile_freeing_counter == 0)
+  if(m_delay_tile_freeing_counter == 0 && m_have_delayed_free_tiles)
     {
-      for(unsigned int i = 0, endi = m_delayed_free_tiles.size(); i < endi; ++i)
+      for(unsigned int w = 0, endw = m_delayed_free_tiles.size(); w < endw; ++w)
         {
-          delete_tile_implement(m_delayed_free_tiles[i]);
+          assert((m_free_tiles[w] & m_delayed_free_tiles[w]) == 0u);
+          m_tile_count -= number_bits_set(m_delayed_free_tiles[w]);
+          m_free_tiles[w] |= m_delayed_free_tiles[w];
+          m_delayed_free_tiles[w] = 0u;
         }
-      m_delayed_free_tiles.clear();
+      m_have_delayed_free_tiles = false;
     }
 }
 
@@ -617,30 +1324,22 @@ void
 tile_allocator::
 delete_tile(fastuidraw::ivec3 v)
 {
+  unsigned int w;
+  uint64_t mask;
+
+  w = word_of_tile(v, mask);
+  assert((m_free_tiles[w] & mask) == 0u);
+  assert((m_delayed_free_tiles[w] & mask) == 0u);
   if(m_delay_tile_freeing_counter == 0)
     {
-      delete_tile_implement(v);
+      m_free_tiles[w] |= mask;
+      --m_tile_count;
     }
   else
     {
-      m_delayed_free_tiles.push_back(v);
-    }
-}
-
-void
-tile_allocator::
-delete_tile_implement(fastuidraw::ivec3 v)
-{
-  assert(m_delay_tile_freeing_counter == 0);
-  #ifdef FASTUIDRAW_DEBUG
-    {
-      assert(m_tile_allocated[v.x()][v.y()][v.z()].m_value);
-      m_tile_allocated[v.x()][v.y()][v.z()] = false;
+      m_delayed_free_tiles[w] |= mask;
+      m_have_delayed_free_tiles = true;
     }
-  #endif
-
-  --m_tile_count;
-  m_free_tiles.push_back(v);
 }
 
 int
@@ -660,7 +1359,7 @@ resize_to_fit(int num_tiles)
          compute how many more tiles needed and from
          there compute how many more layers needed.
        */
-      int needed_tiles, tiles_per_layer, needed_layers;
+      int needed_tiles, tiles_per_layer, needed_layers, old_num_layers;
       needed_tiles = num_tiles - number_free();
       tiles_per_layer = m_num_tiles.x() * m_num_tiles.y();
       needed_layers = needed_tiles / tiles_per_layer;
@@ -673,12 +1372,9 @@ resize_to_fit(int num_tiles)
           Should we resize at powers of 2, or just to what is
           needed?
        */
+      old_num_layers = m_num_tiles.z();
       m_num_tiles.z() += needed_layers;
-      #ifdef FASTUIDRAW_DEBUG
-        {
-          m_tile_allocated.resize(boost::extents[m_num_tiles.x()][m_num_tiles.y()][m_num_tiles.z()]);
-        }
-      #endif
+      add_layers(old_num_layers);
 
       return true;
     }
@@ -688,18 +1384,66 @@ resize_to_fit(int num_tiles)
     }
 }
 
+bool
+tile_allocator::
+remove_free_layers(int min_layers)
+{
+  int tiles_per_layer, new_num_layers(m_num_tiles.z());
+
+  /* a tile whose freeing is delayed is not free,
+     so its layer is not removed.
+   */
+  tiles_per_layer = m_num_tiles.x() * m_num_tiles.y();
+  while(new_num_layers > min_layers)
+    {
+      int count(0);
+      unsigned int w((new_num_layers - 1) * m_words_per_layer);
+
+      for(int i = 0; i < m_words_per_layer; ++i)
+        {
+          count += number_bits_set(m_free_tiles[w + i]);
+        }
+
+      if(count != tiles_per_layer)
+        {
+          break;
+        }
+      --new_num_layers;
+    }
+
+  if(new_num_layers == m_num_tiles.z())
+    {
+      return false;
+    }
+
+  m_num_tiles.z() = new_num_layers;
+  m_free_tiles.resize(m_words_per_layer * m_num_tiles.z());
+  m_delayed_free_tiles.resize(m_words_per_layer * m_num_tiles.z());
+  if(m_search_word >= m_free_tiles.size())
+    {
+      m_search_word = 0;
+    }
+  return true;
+}
+
 ///////////////////////////////////////////
 // fastuidraw::AtlasColorBackingStoreBase methods
 fastuidraw::AtlasColorBackingStoreBase::
 AtlasColorBackingStoreBase(ivec3 whl, bool presizable)
 {
-  m_d = FASTUIDRAWnew BackingStorePrivate(whl, presizable);
+  BackingStorePrivate *d;
+  d = FASTUIDRAWnew BackingStorePrivate(whl, presizable);
+  m_d = d;
+  detail::memory_report_grow(memory::subsystem_image_atlas, 0, d->bytes());
 }
 
 fastuidraw::AtlasColorBackingStoreBase::
 AtlasColorBackingStoreBase(int w, int h, int num_layers, bool presizable)
 {
-  m_d = FASTUIDRAWnew BackingStorePrivate(w, h, num_layers, presizable);
+  BackingStorePrivate *d;
+  d = FASTUIDRAWnew BackingStorePrivate(w, h, num_layers, presizable);
+  m_d = d;
+  detail::memory_report_grow(memory::subsystem_image_atlas, 0, d->bytes());
 }
 
 fastuidraw::AtlasColorBackingStoreBase::
@@ -707,6 +1451,7 @@ fastuidraw::AtlasColorBackingStoreBase::
 {
   BackingStorePrivate *d;
   d = static_cast<BackingStorePrivate*>(m_d);
+  detail::memory_report_shrink(memory::subsystem_image_atlas, 0, d->bytes());
   FASTUIDRAWdelete(d);
   m_d = NULL;
 }
@@ -737,9 +1482,20 @@ resize(int new_num_layers)
 
   d = static_cast<BackingStorePrivate*>(m_d);
   assert(d->m_resizeable);
-  assert(new_num_layers > d->m_dimensions.z());
+  assert(new_num_layers > 0);
+  assert(new_num_layers != d->m_dimensions.z());
   resize_implement(new_num_layers);
+
+  uint64_t old_bytes(d->bytes());
   d->m_dimensions.z() = new_num_layers;
+  if(d->bytes() > old_bytes)
+    {
+      detail::memory_report_grow(memory::subsystem_image_atlas, 0, d->bytes() - old_bytes);
+    }
+  else
+    {
+      detail::memory_report_shrink(memory::subsystem_image_atlas, 0, old_bytes - d->bytes());
+    }
 }
 
 ///////////////////////////////////////////////
@@ -747,13 +1503,19 @@ resize(int new_num_layers)
 fastuidraw::AtlasIndexBackingStoreBase::
 AtlasIndexBackingStoreBase(ivec3 whl, bool presizable)
 {
-  m_d = FASTUIDRAWnew BackingStorePrivate(whl, presizable);
+  BackingStorePrivate *d;
+  d = FASTUIDRAWnew BackingStorePrivate(whl, presizable);
+  m_d = d;
+  detail::memory_report_grow(memory::subsystem_image_atlas, 0, d->bytes());
 }
 
 fastuidraw::AtlasIndexBackingStoreBase::
 AtlasIndexBackingStoreBase(int w, int h, int l, bool presizable)
 {
-  m_d = FASTUIDRAWnew BackingStorePrivate(w, h, l, presizable);
+  BackingStorePrivate *d;
+  d = FASTUIDRAWnew BackingStorePrivate(w, h, l, presizable);
+  m_d = d;
+  detail::memory_report_grow(memory::subsystem_image_atlas, 0, d->bytes());
 }
 
 fastuidraw::AtlasIndexBackingStoreBase::
@@ -761,6 +1523,7 @@ fastuidraw::AtlasIndexBackingStoreBase::
 {
   BackingStorePrivate *d;
   d = static_cast<BackingStorePrivate*>(m_d);
+  detail::memory_report_shrink(memory::subsystem_image_atlas, 0, d->bytes());
   FASTUIDRAWdelete(d);
   m_d = NULL;
 }
@@ -791,9 +1554,20 @@ resize(int new_num_layers)
 
   d = static_cast<BackingStorePrivate*>(m_d);
   assert(d->m_resizeable);
-  assert(new_num_layers > d->m_dimensions.z());
+  assert(new_num_layers > 0);
+  assert(new_num_layers != d->m_dimensions.z());
   resize_implement(new_num_layers);
+
+  uint64_t old_bytes(d->bytes());
   d->m_dimensions.z() = new_num_layers;
+  if(d->bytes() > old_bytes)
+    {
+      detail::memory_report_grow(memory::subsystem_image_atlas, 0, d->bytes() - old_bytes);
+    }
+  else
+    {
+      detail::memory_report_shrink(memory::subsystem_image_atlas, 0, old_bytes - d->bytes());
+    }
 }
 
 
@@ -887,7 +1661,7 @@ add_index_tile(fastuidraw::const_c_array<fastuidraw::ivec3> data, int slack)
        non-tiny images. A single index tile would hold 4 such tiles
        and we could also recurse such.
    */
-  return_value = d->m_index_tiles.allocate_tile();
+  return_value = d->allocate_index_tile();
   d->m_index_store->set_data(return_value.x() * d->m_index_tiles.tile_size(),
                              return_value.y() * d->m_index_tiles.tile_size(),
                              return_value.z(),
@@ -911,7 +1685,7 @@ add_index_tile_index_data(fastuidraw::const_c_array<fastuidraw::ivec3> data)
   ivec3 return_value;
   autolock_mutex M(d->m_mutex);
 
-  return_value = d->m_index_tiles.allocate_tile();
+  return_value = d->allocate_index_tile();
   d->m_index_store->set_data(return_value.x() * d->m_index_tiles.tile_size(),
                              return_value.y() * d->m_index_tiles.tile_size(),
                              return_value.z(),
@@ -922,6 +1696,37 @@ add_index_tile_index_data(fastuidraw::const_c_array<fastuidraw::ivec3> data)
   return return_value;
 }
 
+void
+fastuidraw::ImageAtlas::
+set_index_tile(fastuidraw::ivec3 tile,
+               fastuidraw::const_c_array<fastuidraw::ivec3> data, int slack)
+{
+  ImageAtlasPrivate *d;
+  d = static_cast<ImageAtlasPrivate*>(m_d);
+
+  autolock_mutex M(d->m_mutex);
+  d->m_index_store->set_data(tile.x() * d->m_index_tiles.tile_size(),
+                             tile.y() * d->m_index_tiles.tile_size(),
+                             tile.z(),
+                             d->m_index_tiles.tile_size(),
+                             d->m_index_tiles.tile_size(),
+                             data,
+                             slack,
+                             d->m_color_store.get(),
+                             d->m_color_tiles.tile_size());
+}
+
+bool
+fastuidraw::ImageAtlas::
+add_index_tile_block(ivec2 count, ivec3 &first_tile)
+{
+  ImageAtlasPrivate *d;
+  d = static_cast<ImageAtlasPrivate*>(m_d);
+
+  autolock_mutex M(d->m_mutex);
+  return d->allocate_index_tile_block(count, first_tile);
+}
+
 void
 fastuidraw::ImageAtlas::
 delete_index_tile(fastuidraw::ivec3 tile)
@@ -951,15 +1756,35 @@ add_color_tile(fastuidraw::const_c_array<u8vec4> data)
   ImageAtlasPrivate *d;
   d = static_cast<ImageAtlasPrivate*>(m_d);
   ivec3 return_value;
+  texel_hash hash;
+  std::map<texel_hash, shared_color_tile>::iterator iter;
   autolock_mutex M(d->m_mutex);
 
-  return_value = d->m_color_tiles.allocate_tile();
+  hash = compute_texel_hash(data);
+  iter = d->m_shared_color_tiles.find(hash);
+  if(iter != d->m_shared_color_tiles.end() && iter->second.same_texels(data))
+    {
+      ++iter->second.m_count;
+      return iter->second.m_tile;
+    }
+
+  return_value = d->allocate_color_tile();
   d->m_color_store->set_data(return_value.x() * d->m_color_tiles.tile_size(),
                              return_value.y() * d->m_color_tiles.tile_size(),
                              return_value.z(),
                              d->m_color_tiles.tile_size(),
                              d->m_color_tiles.tile_size(),
                              data);
+
+  if(iter == d->m_shared_color_tiles.end())
+    {
+      shared_color_tile &entry(d->m_shared_color_tiles[hash]);
+
+      entry.m_tile = return_value;
+      entry.m_count = 1;
+      entry.m_texels.assign(data.begin(), data.end());
+      d->m_hash_of_color_tile[return_value] = hash;
+    }
   return return_value;
 }
 
@@ -970,7 +1795,31 @@ delete_color_tile(fastuidraw::ivec3 tile)
   ImageAtlasPrivate *d;
   d = static_cast<ImageAtlasPrivate*>(m_d);
   autolock_mutex M(d->m_mutex);
-  d->m_color_tiles.delete_tile(tile);
+
+  std::map<ivec3, texel_hash>::iterator hash_iter;
+  std::map<texel_hash, shared_color_tile>::iterator iter;
+
+  hash_iter = d->m_hash_of_color_tile.find(tile);
+  if(hash_iter == d->m_hash_of_color_tile.end())
+    {
+      /* the tile was not shared because its hash collided
+         with that of a shared tile of different texels.
+       */
+      d->m_color_tiles.delete_tile(tile);
+      return;
+    }
+
+  iter = d->m_shared_color_tiles.find(hash_iter->second);
+  assert(iter != d->m_shared_color_tiles.end());
+  assert(iter->second.m_count > 0);
+
+  --iter->second.m_count;
+  if(iter->second.m_count == 0)
+    {
+      d->m_shared_color_tiles.erase(iter);
+      d->m_hash_of_color_tile.erase(hash_iter);
+      d->m_color_tiles.delete_tile(tile);
+    }
 }
 
 void
@@ -982,6 +1831,17 @@ flush(void) const
   autolock_mutex M(d->m_mutex);
   d->m_index_store->flush();
   d->m_color_store->flush();
+  ++d->m_number_flushes;
+}
+
+uint64_t
+fastuidraw::ImageAtlas::
+number_flushes(void) const
+{
+  ImageAtlasPrivate *d;
+  d = static_cast<ImageAtlasPrivate*>(m_d);
+  autolock_mutex M(d->m_mutex);
+  return d->m_number_flushes;
 }
 
 fastuidraw::reference_counted_ptr<const fastuidraw::AtlasColorBackingStoreBase>
@@ -1011,6 +1871,24 @@ resizeable(void) const
   return d->m_resizeable;
 }
 
+bool
+fastuidraw::ImageAtlas::
+direct_index_lookup(void) const
+{
+  ImageAtlasPrivate *d;
+  d = static_cast<ImageAtlasPrivate*>(m_d);
+  return d->m_direct_index_lookup;
+}
+
+void
+fastuidraw::ImageAtlas::
+direct_index_lookup(bool v)
+{
+  ImageAtlasPrivate *d;
+  d = static_cast<ImageAtlasPrivate*>(m_d);
+  d->m_direct_index_lookup = v;
+}
+
 void
 fastuidraw::ImageAtlas::
 resize_to_fit(int num_color_tiles, int num_index_tiles)
@@ -1018,6 +1896,7 @@ resize_to_fit(int num_color_tiles, int num_index_tiles)
   ImageAtlasPrivate *d;
   d = static_cast<ImageAtlasPrivate*>(m_d);
   assert(d->m_resizeable);
+  autolock_mutex M(d->m_mutex);
   if(d->m_color_tiles.resize_to_fit(num_color_tiles))
     {
       d->m_color_store->resize(d->m_color_tiles.num_tiles().z());
@@ -1028,18 +1907,94 @@ resize_to_fit(int num_color_tiles, int num_index_tiles)
     }
 }
 
+bool
+fastuidraw::ImageAtlas::
+reserve_tiles(int num_color_tiles, int num_index_tiles)
+{
+  ImageAtlasPrivate *d;
+  d = static_cast<ImageAtlasPrivate*>(m_d);
+
+  autolock_mutex M(d->m_mutex);
+  int color_needed(num_color_tiles + d->m_reserved_color_tiles);
+  int index_needed(num_index_tiles + d->m_reserved_index_tiles);
+
+  if(color_needed > d->m_color_tiles.number_free()
+     || index_needed > d->m_index_tiles.number_free())
+    {
+      if(!d->m_resizeable)
+        {
+          return false;
+        }
+
+      if(d->m_color_tiles.resize_to_fit(color_needed))
+        {
+          d->m_color_store->resize(d->m_color_tiles.num_tiles().z());
+        }
+      if(d->m_index_tiles.resize_to_fit(index_needed))
+        {
+          d->m_index_store->resize(d->m_index_tiles.num_tiles().z());
+        }
+    }
+
+  d->m_reserved_color_tiles += num_color_tiles;
+  d->m_reserved_index_tiles += num_index_tiles;
+  return true;
+}
+
+void
+fastuidraw::ImageAtlas::
+release_tiles(int num_color_tiles, int num_index_tiles)
+{
+  ImageAtlasPrivate *d;
+  d = static_cast<ImageAtlasPrivate*>(m_d);
+
+  autolock_mutex M(d->m_mutex);
+  assert(d->m_reserved_color_tiles >= num_color_tiles);
+  assert(d->m_reserved_index_tiles >= num_index_tiles);
+  d->m_reserved_color_tiles -= num_color_tiles;
+  d->m_reserved_index_tiles -= num_index_tiles;
+}
+
+uint64_t
+fastuidraw::ImageAtlas::
+trim(void)
+{
+  ImageAtlasPrivate *d;
+  d = static_cast<ImageAtlasPrivate*>(m_d);
+
+  autolock_mutex M(d->m_mutex);
+  if(d->m_resizeable)
+    {
+      if(d->m_color_tiles.remove_free_layers(1))
+        {
+          d->m_color_store->resize(d->m_color_tiles.num_tiles().z());
+        }
+      if(d->m_index_tiles.remove_free_layers(1))
+        {
+          d->m_index_store->resize(d->m_index_tiles.num_tiles().z());
+        }
+    }
+
+  /* both the color and index texels are 4 bytes */
+  ivec3 color_dims(d->m_color_store->dimensions());
+  ivec3 index_dims(d->m_index_store->dimensions());
+  return 4u * (uint64_t(color_dims.x()) * uint64_t(color_dims.y()) * uint64_t(color_dims.z())
+               + uint64_t(index_dims.x()) * uint64_t(index_dims.y()) * uint64_t(index_dims.z()));
+}
+
 
 //////////////////////////////////////
 // fastuidraw::Image methods
 fastuidraw::reference_counted_ptr<fastuidraw::Image>
 fastuidraw::Image::
 create(fastuidraw::reference_counted_ptr<ImageAtlas> atlas, int w, int h,
-       const_c_array<u8vec4> image_data, unsigned int pslack)
+       const_c_array<u8vec4> image_data, unsigned int pslack,
+       unsigned int pnumber_mipmap_levels)
 {
   int tile_interior_size;
   int color_tile_size;
   ivec2 num_color_tiles;
-  int index_tiles;
+  int color_tiles, index_tiles;
 
   if(w <= 0 || h <= 0)
     {
@@ -1054,35 +2009,172 @@ create(fastuidraw::reference_counted_ptr<ImageAtlas> atlas, int w, int h,
       return reference_counted_ptr<Image>();
     }
 
+  pnumber_mipmap_levels = std::max(1u, std::min(pnumber_mipmap_levels, max_number_mipmap_levels(w, h)));
+  num_color_tiles = divide_up(compute_stored_dimensions(ivec2(w, h), pnumber_mipmap_levels),
+                              tile_interior_size);
+  /*TODO:
+     there actually might be enough room if we take into account
+     the savings from repeated tiles. The correct thing is to
+     delay this until iamge construction, check if it succeeded
+     and if not then delete it and return an invalid handle.
+   */
+  color_tiles = num_color_tiles.x() * num_color_tiles.y();
+  index_tiles = number_index_tiles_needed(num_color_tiles, atlas->index_tile_size());
+  if(!atlas->reserve_tiles(color_tiles, index_tiles))
+    {
+      return reference_counted_ptr<Image>();
+    }
+
+  reference_counted_ptr<Image> return_value;
+  return_value = FASTUIDRAWnew Image(atlas, w, h, image_data, pslack, pnumber_mipmap_levels);
+  atlas->release_tiles(color_tiles, index_tiles);
+  return return_value;
+}
+
+unsigned int
+fastuidraw::Image::
+max_number_mipmap_levels(int w, int h)
+{
+  unsigned int return_value(1);
+  int m(std::max(w, h));
+
+  while(m > 1)
+    {
+      m >>= 1;
+      ++return_value;
+    }
+  return return_value;
+}
+
+fastuidraw::ivec2
+fastuidraw::Image::
+mipmap_level_dimensions(ivec2 dims, unsigned int L)
+{
+  return ivec2(std::max(1, dims.x() >> L), std::max(1, dims.y() >> L));
+}
+
+fastuidraw::ivec2
+fastuidraw::Image::
+mipmap_level_location(ivec2 dims, unsigned int L)
+{
+  ivec2 return_value(dims.x(), 0);
+
+  assert(L >= 1);
+  for(unsigned int k = 1; k < L; ++k)
+    {
+      return_value.y() += mipmap_level_dimensions(dims, k).y();
+    }
+  return return_value;
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::Image>
+fastuidraw::Image::
+create_streaming(fastuidraw::reference_counted_ptr<ImageAtlas> atlas, int w, int h,
+                 reference_counted_ptr<ImageTileProvider> provider,
+                 unsigned int pslack, unsigned int max_resident_tiles,
+                 u8vec4 fallback_color)
+{
+  int tile_interior_size;
+  int color_tile_size;
+  int color_tiles, index_tiles;
+  ivec2 num_color_tiles;
+
+  if(w <= 0 || h <= 0 || !provider || max_resident_tiles == 0)
+    {
+      return reference_counted_ptr<Image>();
+    }
+
+  color_tile_size = atlas->color_tile_size();
+  tile_interior_size = color_tile_size - 2 * pslack;
+
+  if(tile_interior_size <= 0)
+    {
+      return reference_counted_ptr<Image>();
+    }
+
+  /* room for the fallback tile and the resident tiles */
   num_color_tiles = divide_up(ivec2(w, h), tile_interior_size);
-  if(!enough_room_in_atlas(num_color_tiles, atlas.get(), index_tiles))
+  color_tiles = 1 + std::min(static_cast<int>(max_resident_tiles),
+                             num_color_tiles.x() * num_color_tiles.y());
+  index_tiles = number_index_tiles_needed(num_color_tiles, atlas->index_tile_size());
+  if(!atlas->reserve_tiles(color_tiles, index_tiles))
     {
-      /*TODO:
-         there actually might be enough room if we take into account
-         the savings from repeated tiles. The correct thing is to
-         delay this until iamge construction, check if it succeeded
-         and if not then delete it and return an invalid handle.
-       */
-      if(atlas->resizeable())
-        {
-          atlas->resize_to_fit(num_color_tiles.x() * num_color_tiles.y(), index_tiles);
-        }
-      else
-        {
-          return reference_counted_ptr<Image>();
-        }
+      return reference_counted_ptr<Image>();
     }
 
-  return FASTUIDRAWnew Image(atlas, w, h, image_data, pslack);
+  reference_counted_ptr<Image> return_value;
+  return_value = FASTUIDRAWnew Image(atlas, w, h, provider, pslack,
+                                     max_resident_tiles, fallback_color);
+  atlas->release_tiles(color_tiles, index_tiles);
+  return return_value;
 }
 
 fastuidraw::Image::
 Image(fastuidraw::reference_counted_ptr<fastuidraw::ImageAtlas> patlas,
       int w, int h,
       fastuidraw::const_c_array<fastuidraw::u8vec4> image_data,
-      unsigned int pslack)
+      unsigned int pslack, unsigned int pnumber_mipmap_levels)
 {
-  m_d = FASTUIDRAWnew ImagePrivate(patlas, w, h, image_data, pslack);
+  m_d = FASTUIDRAWnew ImagePrivate(patlas, w, h, image_data, pslack,
+                                   pnumber_mipmap_levels);
+}
+
+fastuidraw::Image::
+Image(fastuidraw::reference_counted_ptr<fastuidraw::ImageAtlas> patlas,
+      int w, int h,
+      fastuidraw::reference_counted_ptr<fastuidraw::ImageTileProvider> provider,
+      unsigned int pslack, unsigned int max_resident_tiles,
+      fastuidraw::u8vec4 fallback_color)
+{
+  m_d = FASTUIDRAWnew ImagePrivate(patlas, w, h, provider, pslack,
+                                   max_resident_tiles, fallback_color);
+}
+
+fastuidraw::Image::
+Image(int w, int h, uint64_t handle, bool external_texture,
+      bool premultiplied_alpha)
+{
+  m_d = FASTUIDRAWnew ImagePrivate(w, h, handle, external_texture,
+                                   premultiplied_alpha);
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::Image>
+fastuidraw::Image::
+create_bindless(int w, int h, uint64_t handle, bool external_texture,
+                bool premultiplied_alpha)
+{
+  if(w <= 0 || h <= 0 || handle == 0)
+    {
+      return reference_counted_ptr<Image>();
+    }
+  return FASTUIDRAWnew Image(w, h, handle, external_texture, premultiplied_alpha);
+}
+
+uint64_t
+fastuidraw::Image::
+bindless_handle(void) const
+{
+  ImagePrivate *d;
+  d = static_cast<ImagePrivate*>(m_d);
+  return d->m_bindless_handle;
+}
+
+bool
+fastuidraw::Image::
+bindless_external_texture(void) const
+{
+  ImagePrivate *d;
+  d = static_cast<ImagePrivate*>(m_d);
+  return d->m_bindless_external_texture;
+}
+
+bool
+fastuidraw::Image::
+premultiplied_alpha(void) const
+{
+  ImagePrivate *d;
+  d = static_cast<ImagePrivate*>(m_d);
+  return d->m_premultiplied_alpha;
 }
 
 fastuidraw::Image::
@@ -1113,6 +2205,24 @@ dimensions(void) const
   return d->m_dimensions;
 }
 
+unsigned int
+fastuidraw::Image::
+number_mipmap_levels(void) const
+{
+  ImagePrivate *d;
+  d = static_cast<ImagePrivate*>(m_d);
+  return d->m_number_mipmap_levels;
+}
+
+fastuidraw::ivec2
+fastuidraw::Image::
+stored_dimensions(void) const
+{
+  ImagePrivate *d;
+  d = static_cast<ImagePrivate*>(m_d);
+  return d->m_stored_dimensions;
+}
+
 unsigned int
 fastuidraw::Image::
 slack(void) const
@@ -1157,3 +2267,152 @@ atlas(void) const
   d = static_cast<ImagePrivate*>(m_d);
   return d->m_atlas;
 }
+
+bool
+fastuidraw::Image::
+streaming(void) const
+{
+  ImagePrivate *d;
+  d = static_cast<ImagePrivate*>(m_d);
+  return d->m_provider;
+}
+
+void
+fastuidraw::Image::
+request_region(ivec2 min_corner, ivec2 max_corner)
+{
+  ImagePrivate *d;
+  d = static_cast<ImagePrivate*>(m_d);
+
+  int tile_interior_size;
+  ivec2 min_tile, max_tile;
+
+  if(!d->m_provider)
+    {
+      return;
+    }
+
+  /* a color tile is needed if its interior intersects
+     the region; the slack of a tile only replicates texels
+     of the interiors of its neighbors.
+   */
+  tile_interior_size = d->m_atlas->color_tile_size() - 2 * d->m_slack;
+  for(unsigned int c = 0; c < 2; ++c)
+    {
+      min_tile[c] = std::max(0, std::min(min_corner[c], max_corner[c]) / tile_interior_size);
+      max_tile[c] = std::min(d->m_num_color_tiles[c] - 1,
+                             std::max(min_corner[c], max_corner[c]) / tile_interior_size);
+    }
+
+  for(int y = min_tile.y(); y <= max_tile.y(); ++y)
+    {
+      for(int x = min_tile.x(); x <= max_tile.x(); ++x)
+        {
+          unsigned int I;
+
+          I = x + y * d->m_num_color_tiles.x();
+          if(d->m_last_requested[I] != d->m_current_frame)
+            {
+              d->m_last_requested[I] = d->m_current_frame;
+              d->m_requested.push_back(I);
+            }
+        }
+    }
+}
+
+unsigned int
+fastuidraw::Image::
+update_residency(unsigned int max_uploads)
+{
+  ImagePrivate *d;
+  d = static_cast<ImagePrivate*>(m_d);
+
+  if(!d->m_provider)
+    {
+      return 0;
+    }
+
+  /* the resident tiles not requested in this frame,
+     least recently requested first, are the tiles to
+     make non-resident to make room.
+   */
+  std::vector<std::pair<uint64_t, unsigned int> > evict_candidates;
+  std::vector<unsigned int> dirty_index_tiles;
+  std::vector<u8vec4> texels, tile_data;
+  std::vector<ivec3> index_tile_data;
+  unsigned int return_value(0), next_candidate(0);
+
+  for(unsigned int i = 0, endi = d->m_color_tiles.size(); i < endi; ++i)
+    {
+      if(d->m_color_tiles[i].m_non_repeat_color
+         && d->m_last_requested[i] != d->m_current_frame)
+        {
+          evict_candidates.push_back(std::make_pair(d->m_last_requested[i], i));
+        }
+    }
+  std::sort(evict_candidates.begin(), evict_candidates.end());
+
+  for(std::vector<unsigned int>::const_iterator iter = d->m_requested.begin(),
+        end = d->m_requested.end(); iter != end && return_value < max_uploads; ++iter)
+    {
+      unsigned int I(*iter);
+
+      if(d->m_color_tiles[I].m_non_repeat_color)
+        {
+          continue;
+        }
+
+      if(d->m_number_resident_tiles >= d->m_max_resident_tiles
+         || d->m_atlas->number_free_color_tiles() == 0)
+        {
+          if(next_candidate == evict_candidates.size())
+            {
+              break;
+            }
+          d->make_tile_non_resident(evict_candidates[next_candidate].second);
+          dirty_index_tiles.push_back(d->index_tile_of_color_tile(evict_candidates[next_candidate].second));
+          ++next_candidate;
+        }
+
+      d->make_tile_resident(I, texels, tile_data);
+      dirty_index_tiles.push_back(d->index_tile_of_color_tile(I));
+      ++return_value;
+    }
+
+  std::sort(dirty_index_tiles.begin(), dirty_index_tiles.end());
+  dirty_index_tiles.erase(std::unique(dirty_index_tiles.begin(), dirty_index_tiles.end()),
+                          dirty_index_tiles.end());
+  for(std::vector<unsigned int>::const_iterator iter = dirty_index_tiles.begin(),
+        end = dirty_index_tiles.end(); iter != end; ++iter)
+    {
+      d->update_index_tile(*iter, index_tile_data);
+    }
+
+  if(return_value > 0)
+    {
+      d->m_written_at_flush = d->m_atlas->number_flushes();
+    }
+  d->m_requested.clear();
+  ++d->m_current_frame;
+  return return_value;
+}
+
+bool
+fastuidraw::Image::
+uploaded(void) const
+{
+  ImagePrivate *d;
+  d = static_cast<ImagePrivate*>(m_d);
+  return !d->m_atlas || d->m_atlas->number_flushes() > d->m_written_at_flush;
+}
+
+unsigned int
+fastuidraw::Image::
+number_resident_tiles(void) const
+{
+  ImagePrivate *d;
+  d = static_cast<ImagePrivate*>(m_d);
+  return d->m_provider ?
+    d->m_number_resident_tiles :
+    d->m_color_tiles.size();
+}
@@ -11,6 +11,7 @@ include $(dir)/Rules.mk
 LIBRARY_SOURCES += $(call filelist, \
 	painter_attribute_data.cpp \
 	painter_attribute_data_filler_glyphs.cpp \
+	glyph_run.cpp glyph_run_cache.cpp hairline_path.cpp \
 	painter_brush.cpp painter_stroke_params.cpp \
 	painter_dashed_stroke_params.cpp \
 	painter.cpp painter_enums.cpp \
@@ -20,7 +21,7 @@ LIBRARY_SOURCES += $(call filelist, \
 	painter_shader.cpp painter_shader_set.cpp \
 	painter_dashed_stroke_shader_set.cpp painter_stroke_shader.cpp \
 	painter_glyph_shader.cpp painter_blend_shader_set.cpp \
-	painter_fill_shader.cpp \
+	painter_fill_shader.cpp painter_trace.cpp \
 	stroked_path.cpp filled_path.cpp)
 
 # Begin standard footer
@@ -32,6 +32,9 @@
 #include "../private/util_private_ostream.hpp"
 #include "../private/bounding_box.hpp"
 #include "../private/clip.hpp"
+#include "../private/culling_boxes.hpp"
+#include "../private/sweep_triangulator.hpp"
+#include "../private/blob_private.hpp"
 #include "../../3rd_party/glu-tess/glu-tess.hpp"
 
 /* Actual triangulation is handled by GLU-tess.
@@ -69,6 +72,12 @@
    via the class SubPath. The class SubsetPrivate
    is the one that represents an element in the
    hierarchy that is triangulated on demand.
+
+   A Subset can instead be triangulated by
+   detail::SweepTriangulator (see sweep_builder)
+   which does not need the fudging of GLU-tess
+   since it computes the intersections of edges
+   directly.
  */
 
 /* Values to define how to create Subset objects.
@@ -78,9 +87,22 @@ namespace SubsetConstants
   enum
     {
       recursion_depth = 12,
-      points_per_subset = 64
+      points_per_subset = 64,
+
+      /* maximum number of triangles of a
+         FilledPath::Subset::Cluster
+       */
+      triangles_per_cluster = 64
     };
 
+  /* Value that starts a blob of a FilledPath and
+     the version of its format, see
+     FilledPathPrivate::write_to_blob().
+   */
+  const uint32_t blob_magic = 0x50464446u;
+  const uint32_t blob_version = 3u;
+  const uint32_t blob_no_child = 0xFFFFFFFFu;
+
   /* if negative, aspect ratio is not
      enfored.
    */
@@ -359,8 +381,7 @@ namespace
 
     typedef std::vector<SubContourPoint> SubContour;
 
-    explicit
-    SubPath(const fastuidraw::TessellatedPath &P);
+    SubPath(const fastuidraw::TessellatedPath &P, float simplify_tolerance);
 
     const std::vector<SubContour>&
     contours(void) const
@@ -374,6 +395,16 @@ namespace
       return m_bounds;
     }
 
+    /* bounds of the TessellatedPath from which the
+       root SubPath was made; nothing is outside of it
+       so the winding number there is 0.
+     */
+    const fastuidraw::BoundingBox&
+    path_bounds(void) const
+    {
+      return m_path_bounds;
+    }
+
     unsigned int
     total_points(void) const
     {
@@ -391,6 +422,7 @@ namespace
 
   private:
     SubPath(const fastuidraw::BoundingBox &bb,
+            const fastuidraw::BoundingBox &path_bb,
             std::vector<SubContour> &contours,
             int winding_start);
 
@@ -402,6 +434,10 @@ namespace
     copy_contour(SubContour &dst,
                  const fastuidraw::TessellatedPath &src, unsigned int C);
 
+    static
+    void
+    simplify_contour(SubContour &C, float tolerance);
+
     static
     void
     split_contour(const SubContour &src,
@@ -420,7 +456,7 @@ namespace
                        int splitting_coordinate, float spitting_value);
 
     unsigned int m_total_points;
-    fastuidraw::BoundingBox m_bounds;
+    fastuidraw::BoundingBox m_bounds, m_path_bounds;
     std::vector<SubContour> m_contours;
     int m_winding_start;
   };
@@ -482,9 +518,18 @@ namespace
 
   class tesser:fastuidraw::noncopyable
   {
+  public:
+    /* create a GLU tessellator with the callbacks of tesser;
+       one tessellator is used for both passes of a builder
+       so that the objects allocated from its pool by the
+       first pass are reused by the second.
+     */
+    static
+    fastuidraw_GLUtesselator*
+    create_tess(void);
+
   protected:
-    explicit
-    tesser(PointHoard &points);
+    tesser(PointHoard &points, fastuidraw_GLUtesselator *tess);
 
     virtual
     ~tesser(void);
@@ -567,18 +612,18 @@ namespace
   public:
     static
     bool
-    execute_path(PointHoard &points,
+    execute_path(PointHoard &points, fastuidraw_GLUtesselator *tess,
                  const PointHoard::Path &P,
                  const PointHoard::BoundingBoxes &boxes,
                  const SubPath &path,
                  winding_index_hoard &hoard)
     {
-      non_zero_tesser NZ(points, P, boxes, path, hoard);
+      non_zero_tesser NZ(points, tess, P, boxes, path, hoard);
       return NZ.triangulation_failed();
     }
 
   private:
-    non_zero_tesser(PointHoard &points,
+    non_zero_tesser(PointHoard &points, fastuidraw_GLUtesselator *tess,
                     const PointHoard::Path &P,
                     const PointHoard::BoundingBoxes &boxes,
                     const SubPath &path,
@@ -607,19 +652,19 @@ namespace
   public:
     static
     bool
-    execute_path(PointHoard &points,
+    execute_path(PointHoard &points, fastuidraw_GLUtesselator *tess,
                  const PointHoard::Path &P,
                  const PointHoard::BoundingBoxes &boxes,
                  const SubPath &path,
                  winding_index_hoard &hoard)
     {
-      zero_tesser Z(points, P, boxes, path, hoard);
+      zero_tesser Z(points, tess, P, boxes, path, hoard);
       return Z.triangulation_failed();
     }
 
   private:
 
-    zero_tesser(PointHoard &points,
+    zero_tesser(PointHoard &points, fastuidraw_GLUtesselator *tess,
                 const PointHoard::Path &P,
                 const PointHoard::BoundingBoxes &boxes,
                 const SubPath &path,
@@ -663,9 +708,74 @@ namespace
   private:
     winding_index_hoard m_hoard;
     PointHoard m_points;
+    fastuidraw_GLUtesselator *m_tess;
     bool m_failed;
   };
 
+  /* sweep_builder has the same interface as builder
+     but triangulates with detail::SweepTriangulator.
+   */
+  class sweep_builder:fastuidraw::noncopyable
+  {
+  public:
+    explicit
+    sweep_builder(const SubPath &P, std::vector<fastuidraw::vec2> &pts);
+
+    void
+    fill_indices(std::vector<unsigned int> &indices,
+                 std::map<int, fastuidraw::const_c_array<unsigned int> > &winding_map,
+                 unsigned int &even_non_zero_start,
+                 unsigned int &zero_start);
+
+    bool
+    triangulation_failed(void)
+    {
+      return false;
+    }
+
+  private:
+    /* orders triangles by: odd winding, even and non-zero
+       winding, zero winding and then by winding number.
+     */
+    class triangle_order
+    {
+    public:
+      explicit
+      triangle_order(const std::vector<int> &windings, int winding_start):
+        m_windings(windings),
+        m_winding_start(winding_start)
+      {}
+
+      static
+      int
+      category(int w)
+      {
+        return (w == 0) ? 2 : (is_even(w) ? 1 : 0);
+      }
+
+      int
+      winding(unsigned int t) const
+      {
+        return m_windings[t] + m_winding_start;
+      }
+
+      bool
+      operator()(unsigned int a, unsigned int b) const
+      {
+        int wa(winding(a)), wb(winding(b));
+        int ca(category(wa)), cb(category(wb));
+        return ca < cb || (ca == cb && wa < wb);
+      }
+
+    private:
+      const std::vector<int> &m_windings;
+      int m_winding_start;
+    };
+
+    fastuidraw::detail::SweepTriangulator m_triangulator;
+    int m_winding_start;
+  };
+
   class AttributeDataMerger:public fastuidraw::PainterAttributeDataFiller
   {
   public:
@@ -752,6 +862,71 @@ namespace
     }
   };
 
+  /* AAFuzzFiller holds the anti-alias fuzz of the boundary
+     edges of a SubsetPrivate, see FilledPath::Subset::aa_painter_data();
+     m_chunks[K] gives the indices of index chunk K.
+   */
+  class AAFuzzFiller:public fastuidraw::PainterAttributeDataFiller
+  {
+  public:
+    /* add the fuzz of the edge from p to q between the region
+       of winding number wa and the region of winding number wb
+       where n is the unit normal to the edge pointing into the
+       region of winding number wb.
+     */
+    void
+    add_edge(const fastuidraw::vec2 &p, const fastuidraw::vec2 &q,
+             const fastuidraw::vec2 &n, int wa, int wb);
+
+    unsigned int
+    largest_index_block(void) const;
+
+    virtual
+    void
+    compute_sizes(unsigned int &number_attributes,
+                  unsigned int &number_indices,
+                  unsigned int &number_attribute_chunks,
+                  unsigned int &number_index_chunks,
+                  unsigned int &number_z_increments) const;
+    virtual
+    void
+    fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attributes,
+              fastuidraw::c_array<fastuidraw::PainterIndex> indices,
+              fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attrib_chunks,
+              fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+              fastuidraw::c_array<unsigned int> zincrements,
+              fastuidraw::c_array<int> index_adjusts) const;
+
+    std::vector<fastuidraw::PainterAttribute> m_attribs;
+    std::vector<std::vector<fastuidraw::PainterIndex> > m_chunks;
+
+  private:
+    /* add the quad that extends from the edge p-q along n
+       into the region of winding number unfilled_winding
+     */
+    void
+    add_quad(const fastuidraw::vec2 &p, const fastuidraw::vec2 &q,
+             const fastuidraw::vec2 &n, int filled_winding, int unfilled_winding);
+
+    void
+    add_quad_indices(unsigned int chunk, unsigned int first_attrib);
+
+    static
+    fastuidraw::PainterAttribute
+    generate_attribute(const fastuidraw::vec2 &p, const fastuidraw::vec2 &n, float boundary)
+    {
+      fastuidraw::PainterAttribute dst;
+
+      dst.m_attrib0 = fastuidraw::pack_vec4(p.x(), p.y(), n.x(), n.y());
+      dst.m_attrib1 = fastuidraw::pack_vec4(boundary, 0.0f, 0.0f, 0.0f);
+      dst.m_attrib2 = fastuidraw::uvec4(0u, 0u, 0u, 0u);
+
+      return dst;
+    }
+  };
+
+  class SubsetPrivate;
+
   class ScratchSpacePrivate
   {
   public:
@@ -760,6 +935,15 @@ namespace
 
     fastuidraw::vecN<std::vector<fastuidraw::vec2>, 2> m_clip_scratch_vec2s;
     std::vector<float> m_clip_scratch_floats;
+
+    std::vector<SubsetPrivate*> m_unready_subsets;
+
+    /* transformation to clip coordinates and the size in normalized
+       device coordinates below which an element of the hierarchy
+       is selected whole, see SubsetHierarchy::walk().
+     */
+    fastuidraw::float3x3 m_clip_matrix_local;
+    fastuidraw::vec2 m_coarse_size;
   };
 
   class SubsetPrivate
@@ -768,19 +952,107 @@ namespace
     ~SubsetPrivate(void);
 
     SubsetPrivate(SubPath *P, int max_recursion,
+                  enum fastuidraw::FilledPath::triangulator_t triangulator,
                   std::vector<SubsetPrivate*> &out_values);
 
-    unsigned int
-    select_subsets(ScratchSpacePrivate &scratch,
-                   fastuidraw::const_c_array<fastuidraw::vec3> clip_equations,
-                   const fastuidraw::float3x3 &clip_matrix_local,
-                   unsigned int max_attribute_cnt,
-                   unsigned int max_index_cnt,
-                   fastuidraw::c_array<unsigned int> dst);
+    /* read the SubsetPrivate with the named ID from a blob,
+       the IDs of its children are written to child_IDs
+       and are linked by set_children().
+     */
+    SubsetPrivate(fastuidraw::detail::BlobReader &src, unsigned int ID,
+                  enum fastuidraw::FilledPath::triangulator_t triangulator,
+                  fastuidraw::vecN<uint32_t, 2> &child_IDs);
+
+    /* make ready this SubsetPrivate, the leaves below it
+       are triangulated with up to max_threads threads.
+     */
+    void
+    make_ready(unsigned int max_threads);
 
     void
     make_ready(void);
 
+    /* triangulate all leaves below this SubsetPrivate
+       and compute the sizes of all SubsetPrivate below
+       and including it; this is what write_to_blob()
+       needs.
+     */
+    void
+    make_ready_for_blob(unsigned int max_threads);
+
+    /* write this SubsetPrivate (but not its children) to
+       a blob; only leaves carry their triangulation, the
+       triangulation of other elements is merged from their
+       children as usual when needed.
+     */
+    void
+    write_to_blob(fastuidraw::detail::BlobWriter &dst) const;
+
+    void
+    set_children(SubsetPrivate *child0, SubsetPrivate *child1)
+    {
+      m_children[0] = child0;
+      m_children[1] = child1;
+    }
+
+    /* triangulate the (distinct) leaves with up to max_threads
+       threads; each leaf only modifies itself so different
+       leaves can be made ready at the same time.
+     */
+    static
+    void
+    make_ready_leaves(const std::vector<SubsetPrivate*> &leaves,
+                      unsigned int max_threads);
+
+    /* add the leaves below this that are not triangulated
+       to out
+     */
+    void
+    collect_unready_leaves(std::vector<SubsetPrivate*> &out);
+
+    /* returns the winding number of the point p (which
+       must be within m_bounds) by descending to the leaf
+       whose bounds contain p and testing the triangles of
+       only that leaf; the leaf is triangulated if it is
+       not yet.
+     */
+    int
+    winding_number_at(const fastuidraw::vec2 &p);
+
+    /* add this SubsetPrivate to dst if it is small enough,
+       otherwise recurse into its children; called on those
+       elements that SubsetHierarchy finds not culled.
+     */
+    void
+    select_subsets_all_unculled(fastuidraw::c_array<unsigned int> dst,
+                                unsigned int max_attribute_cnt,
+                                unsigned int max_index_cnt,
+                                unsigned int &current);
+
+    unsigned int
+    ID(void) const
+    {
+      return m_ID;
+    }
+
+    const fastuidraw::BoundingBox&
+    bounds(void) const
+    {
+      return m_bounds;
+    }
+
+    const SubsetPrivate*
+    child(unsigned int i) const
+    {
+      return m_children[i];
+    }
+
+    bool
+    sizes_ready(void) const
+    {
+      return m_sizes_ready;
+    }
+
     fastuidraw::const_c_array<int>
     winding_numbers(void)
     {
@@ -795,19 +1067,46 @@ namespace
       return *m_painter_data;
     }
 
+    const fastuidraw::PainterAttributeData &
+    aa_painter_data(void)
+    {
+      assert(m_aa_painter_data != NULL);
+      return *m_aa_painter_data;
+    }
+
+    fastuidraw::const_c_array<fastuidraw::FilledPath::Subset::Cluster>
+    clusters(unsigned int chunk)
+    {
+      assert(m_painter_data != NULL);
+      if(chunk >= m_cluster_chunks.size())
+        {
+          return fastuidraw::const_c_array<fastuidraw::FilledPath::Subset::Cluster>();
+        }
+      return fastuidraw::make_c_array(m_clusters).sub_array(m_cluster_chunks[chunk]);
+    }
+
   private:
-    void
-    select_subsets_implement(ScratchSpacePrivate &scratch,
-                             fastuidraw::c_array<unsigned int> dst,
-                             unsigned int max_attribute_cnt,
-                             unsigned int max_index_cnt,
-                             unsigned int &current);
+    /* job for run_in_parallel() to triangulate leaves */
+    class make_ready_leaves_job
+    {
+    public:
+      explicit
+      make_ready_leaves_job(const std::vector<SubsetPrivate*> &leaves):
+        m_leaves(leaves)
+      {}
 
-    void
-    select_subsets_all_unculled(fastuidraw::c_array<unsigned int> dst,
-                                unsigned int max_attribute_cnt,
-                                unsigned int max_index_cnt,
-                                unsigned int &current);
+      void
+      operator()(unsigned int begin, unsigned int end)
+      {
+        for(unsigned int i = begin; i < end; ++i)
+          {
+            m_leaves[i]->make_ready_from_sub_path();
+          }
+      }
+
+    private:
+      const std::vector<SubsetPrivate*> &m_leaves;
+    };
 
     void
     make_ready_from_children(void);
@@ -815,6 +1114,33 @@ namespace
     void
     make_ready_from_sub_path(void);
 
+    /* sort the triangles of each winding number of filler
+       spatially and make the clusters of each index chunk
+       made by AttributeDataFiller::fill_data()
+     */
+    void
+    make_clusters(AttributeDataFiller &filler,
+                  unsigned int even_non_zero_start,
+                  unsigned int zero_start);
+
+    void
+    add_chunk_clusters(unsigned int chunk, unsigned int begin, unsigned int end,
+                       const std::vector<fastuidraw::FilledPath::Subset::Cluster> &block_clusters);
+
+    /* find the edges of the triangles of filler that
+       separate regions of different winding numbers and
+       add their anti-alias fuzz to fuzz; path_bounds is
+       SubPath::path_bounds().
+     */
+    static
+    void
+    make_aa_fuzz(const AttributeDataFiller &filler,
+                 const fastuidraw::BoundingBox &path_bounds,
+                 AAFuzzFiller &fuzz);
+
+    void
+    make_sizes_ready(void);
+
     /* m_ID represents an index into the std::vector<>
        passed into create_hierarchy() where this element
        is found.
@@ -837,6 +1163,12 @@ namespace
     fastuidraw::PainterAttributeData *m_painter_data;
     std::vector<int> m_winding_numbers;
 
+    /* anti-alias fuzz of the boundary of the regions
+       of m_painter_data, made and merged along with
+       m_painter_data.
+     */
+    fastuidraw::PainterAttributeData *m_aa_painter_data;
+
     bool m_sizes_ready;
     unsigned int m_num_attributes;
     unsigned int m_largest_index_block;
@@ -848,34 +1180,268 @@ namespace
      */
     SubPath *m_sub_path;
     fastuidraw::vecN<SubsetPrivate*, 2> m_children;
+
+    /* only leaves have clusters; m_cluster_chunks[K]
+       is the range into m_clusters of the clusters of
+       index chunk K of m_painter_data.
+     */
+    std::vector<fastuidraw::FilledPath::Subset::Cluster> m_clusters;
+    std::vector<fastuidraw::range_type<unsigned int> > m_cluster_chunks;
+
+    enum fastuidraw::FilledPath::triangulator_t m_triangulator;
   };
 
-  class FilledPathPrivate
+  enum fastuidraw::FilledPath::triangulator_t default_triangulator_value = fastuidraw::FilledPath::glu_tess_triangulator;
+
+  bool
+  box_contains(const fastuidraw::BoundingBox &b, const fastuidraw::vec2 &p)
+  {
+    return !b.empty()
+      && p.x() >= b.min_point().x() && p.x() <= b.max_point().x()
+      && p.y() >= b.min_point().y() && p.y() <= b.max_point().y();
+  }
+
+  fastuidraw::vec2
+  attribute_position(const fastuidraw::PainterAttribute &a)
+  {
+    return fastuidraw::vec2(fastuidraw::unpack_float(a.m_attrib0.x()),
+                            fastuidraw::unpack_float(a.m_attrib0.y()));
+  }
+
+  /* inclusive of the edges and of either orientation,
+     so that a point on an edge shared by two triangles
+     is found in one of them.
+   */
+  bool
+  triangle_contains(const fastuidraw::vec2 &a, const fastuidraw::vec2 &b,
+                    const fastuidraw::vec2 &c, const fastuidraw::vec2 &p)
+  {
+    float d0, d1, d2;
+    bool has_neg, has_pos;
+
+    d0 = (b.x() - a.x()) * (p.y() - a.y()) - (b.y() - a.y()) * (p.x() - a.x());
+    d1 = (c.x() - b.x()) * (p.y() - b.y()) - (c.y() - b.y()) * (p.x() - b.x());
+    d2 = (a.x() - c.x()) * (p.y() - c.y()) - (a.y() - c.y()) * (p.x() - c.x());
+    has_neg = (d0 < 0.0f) || (d1 < 0.0f) || (d2 < 0.0f);
+    has_pos = (d0 > 0.0f) || (d1 > 0.0f) || (d2 > 0.0f);
+    return !(has_neg && has_pos);
+  }
+
+  bool
+  winding_number_is_filled(int w, enum fastuidraw::PainterEnums::fill_rule_t fill_rule)
+  {
+    switch(fill_rule)
+      {
+      case fastuidraw::PainterEnums::odd_even_fill_rule:
+        return !is_even(w);
+      case fastuidraw::PainterEnums::complement_odd_even_fill_rule:
+        return is_even(w);
+      case fastuidraw::PainterEnums::nonzero_fill_rule:
+        return w != 0;
+      case fastuidraw::PainterEnums::complement_nonzero_fill_rule:
+        return w == 0;
+      default:
+        assert(!"Invalid fill rule passed to FilledPath::hit_test()");
+        return false;
+      }
+  }
+
+  /* SubsetHierarchy holds the bounding boxes of the SubsetPrivate
+     hierarchy of a FilledPath in arrays ordered by SubsetPrivate::m_ID.
+     That order is depth-first: the first child of element i is element
+     i + 1 and the elements below i are those in [i + 1, m_skip[i]),
+     so walking the hierarchy is a forward scan over the arrays that
+     jumps ahead to m_skip[i] to skip the elements below i.
+
+     The boxes are classified against the clip equations block_size
+     elements at a time, since the elements following an element
+     that is partially clipped are the next ones visited. The
+     test of a box against a clip equation only looks at the box
+     corners nearest and farthest along the equation's normal;
+     only a box that crosses a clip equation is clipped exactly
+     with detail::clip_against_planes() to decide if it is culled.
+   */
+  class SubsetHierarchy
   {
   public:
-    explicit
-    FilledPathPrivate(const fastuidraw::TessellatedPath &P);
+    enum
+      {
+        block_size = fastuidraw::detail::CullingBoxes::block_size
+      };
 
-    ~FilledPathPrivate();
+    /* set from the SubsetPrivate objects in order of m_ID,
+       the hierarchy must be depth-first ordered.
+     */
+    void
+    set(const std::vector<SubsetPrivate*> &subsets);
+
+    /* Calls f.select(i) for those element i, in depth-first order,
+       which intersect the clipping region that are unclipped, have
+       no children or are no larger than scratch.m_coarse_size on
+       the screen. Before visiting an element i, calls f.enter(i);
+       if that returns false the element and those below are
+       skipped.
+     */
+    template<typename F>
+    void
+    walk(ScratchSpacePrivate &scratch, F &f) const;
 
-    SubsetPrivate *m_root;
-    std::vector<SubsetPrivate*> m_subsets;
+  private:
+    typedef fastuidraw::detail::CullingBoxes Boxes;
+
+    bool
+    is_coarse(const ScratchSpacePrivate &scratch, unsigned int i) const;
+
+    Boxes m_boxes;
+    std::vector<unsigned int> m_skip;
+    std::vector<bool> m_is_leaf;
   };
-}
 
-////////////////////////////////////////
-// SubPath::SubContourPoint methods
-SubPath::SubContourPoint::
-SubContourPoint(const SubContourPoint &a,
-                const SubContourPoint &b,
-                const fastuidraw::vec2 &pt,
-                int split_coordinate,
-                enum on_boundary_t tp):
-  m_pt(pt),
-  m_start_tessellated_edge(true)
-{
-  int unsplit_coordinate(1 - split_coordinate);
-  if(a.m_boundary_type[unsplit_coordinate] == b.m_boundary_type[unsplit_coordinate])
+  /* functor for SubsetHierarchy::walk() to collect
+     the leaves that select_subsets() will triangulate.
+   */
+  class collect_unready_leaves_walker
+  {
+  public:
+    collect_unready_leaves_walker(const std::vector<SubsetPrivate*> &subsets,
+                                  std::vector<SubsetPrivate*> &out):
+      m_subsets(subsets),
+      m_out(out)
+    {}
+
+    bool
+    enter(unsigned int i)
+    {
+      /* sizes are ready only once all leaves
+         below are triangulated.
+       */
+      return !m_subsets[i]->sizes_ready();
+    }
+
+    void
+    select(unsigned int i)
+    {
+      m_subsets[i]->collect_unready_leaves(m_out);
+    }
+
+  private:
+    const std::vector<SubsetPrivate*> &m_subsets;
+    std::vector<SubsetPrivate*> &m_out;
+  };
+
+  /* functor for SubsetHierarchy::walk() to select
+     the subsets for FilledPath::select_subsets().
+   */
+  class select_subsets_walker
+  {
+  public:
+    select_subsets_walker(const std::vector<SubsetPrivate*> &subsets,
+                          fastuidraw::c_array<unsigned int> dst,
+                          unsigned int max_attribute_cnt,
+                          unsigned int max_index_cnt):
+      m_subsets(subsets),
+      m_dst(dst),
+      m_max_attribute_cnt(max_attribute_cnt),
+      m_max_index_cnt(max_index_cnt),
+      m_current(0)
+    {}
+
+    bool
+    enter(unsigned int)
+    {
+      return true;
+    }
+
+    void
+    select(unsigned int i)
+    {
+      m_subsets[i]->select_subsets_all_unculled(m_dst, m_max_attribute_cnt,
+                                                m_max_index_cnt, m_current);
+    }
+
+    unsigned int
+    current(void) const
+    {
+      return m_current;
+    }
+
+  private:
+    const std::vector<SubsetPrivate*> &m_subsets;
+    fastuidraw::c_array<unsigned int> m_dst;
+    unsigned int m_max_attribute_cnt, m_max_index_cnt;
+    unsigned int m_current;
+  };
+
+  class FilledPathPrivate
+  {
+  public:
+    FilledPathPrivate(const fastuidraw::TessellatedPath &P,
+                      enum fastuidraw::FilledPath::triangulator_t triangulator,
+                      float simplify_tolerance);
+
+    ~FilledPathPrivate();
+
+    /* Blob format, all values are 32-bit words:
+        - SubsetConstants::blob_magic
+        - SubsetConstants::blob_version
+        - m_triangulator
+        - m_max_threads
+        - number of SubsetPrivate objects, followed by
+          each SubsetPrivate in order of m_ID, see
+          SubsetPrivate::write_to_blob()
+     */
+    void
+    write_to_blob(fastuidraw::detail::BlobWriter &dst) const;
+
+    /* returns NULL if the blob is malformed
+     */
+    static
+    FilledPathPrivate*
+    create_from_blob(fastuidraw::const_c_array<uint8_t> blob);
+
+    unsigned int
+    select_subsets(ScratchSpacePrivate &scratch,
+                   fastuidraw::const_c_array<fastuidraw::vec3> clip_equations,
+                   const fastuidraw::float3x3 &clip_matrix_local,
+                   unsigned int max_attribute_cnt,
+                   unsigned int max_index_cnt,
+                   fastuidraw::c_array<unsigned int> dst,
+                   const fastuidraw::vec2 &coarse_size);
+
+    enum fastuidraw::FilledPath::triangulator_t m_triangulator;
+    unsigned int m_max_threads;
+    SubsetPrivate *m_root;
+    std::vector<SubsetPrivate*> m_subsets;
+    SubsetHierarchy m_hierarchy;
+
+    /* if a FilledPath is read from a blob that cannot
+       be used in place, the words of the blob are
+       copied here.
+     */
+    std::vector<uint32_t> m_blob_words;
+
+  private:
+    FilledPathPrivate(void):
+      m_triangulator(fastuidraw::FilledPath::glu_tess_triangulator),
+      m_max_threads(1),
+      m_root(NULL)
+    {}
+  };
+}
+
+////////////////////////////////////////
+// SubPath::SubContourPoint methods
+SubPath::SubContourPoint::
+SubContourPoint(const SubContourPoint &a,
+                const SubContourPoint &b,
+                const fastuidraw::vec2 &pt,
+                int split_coordinate,
+                enum on_boundary_t tp):
+  m_pt(pt),
+  m_start_tessellated_edge(true)
+{
+  int unsplit_coordinate(1 - split_coordinate);
+  if(a.m_boundary_type[unsplit_coordinate] == b.m_boundary_type[unsplit_coordinate])
     {
       m_boundary_type[unsplit_coordinate] = a.m_boundary_type[unsplit_coordinate];
     }
@@ -910,10 +1476,12 @@ SubContourPoint(const SubContourPoint &a,
 // SubPath methods
 SubPath::
 SubPath(const fastuidraw::BoundingBox &bb,
+        const fastuidraw::BoundingBox &path_bb,
         std::vector<SubContour> &contours,
         int winding_start):
   m_total_points(0),
   m_bounds(bb),
+  m_path_bounds(path_bb),
   m_winding_start(winding_start)
 {
   m_contours.swap(contours);
@@ -925,20 +1493,109 @@ SubPath(const fastuidraw::BoundingBox &bb,
 }
 
 SubPath::
-SubPath(const fastuidraw::TessellatedPath &P):
+SubPath(const fastuidraw::TessellatedPath &P, float simplify_tolerance):
   m_total_points(0),
   m_bounds(P.bounding_box_min(),
            P.bounding_box_max()),
+  m_path_bounds(m_bounds),
   m_contours(P.number_contours()),
   m_winding_start(0)
 {
   for(unsigned int c = 0, endc = m_contours.size(); c < endc; ++c)
     {
       copy_contour(m_contours[c], P, c);
+      if(simplify_tolerance > 0.0f)
+        {
+          simplify_contour(m_contours[c], simplify_tolerance);
+        }
       m_total_points += m_contours[c].size();
     }
 }
 
+void
+SubPath::
+simplify_contour(SubContour &C, float tolerance)
+{
+  /* Douglas-Peucker on the closed contour: the contour is cut
+     into two chains at C[0] and the point farthest from it,
+     then a chain is kept as the segment between its end points
+     if no point of it is farther than tolerance from it and
+     otherwise it is cut at its farthest point. Only points of
+     C are kept, so the simplified contour is within the
+     bounding box of C.
+   */
+  unsigned int n(C.size());
+  if(n <= 3)
+    {
+      return;
+    }
+
+  unsigned int far_idx(1);
+  float far_dist(-1.0f);
+  for(unsigned int i = 1; i < n; ++i)
+    {
+      float d;
+      d = (C[i].pt() - C[0].pt()).magnitudeSq();
+      if(d > far_dist)
+        {
+          far_dist = d;
+          far_idx = i;
+        }
+    }
+
+  std::vector<bool> keep(n, false);
+  std::vector<fastuidraw::uvec2> chains;
+  unsigned int num_kept(2);
+
+  keep[0] = keep[far_idx] = true;
+  chains.push_back(fastuidraw::uvec2(0, far_idx));
+  chains.push_back(fastuidraw::uvec2(far_idx, n));
+  while(!chains.empty())
+    {
+      fastuidraw::uvec2 R(chains.back());
+      fastuidraw::vec2 a(C[R.x()].pt()), b(C[R.y() % n].pt()), ab(b - a);
+      float ab_sq(ab.magnitudeSq()), max_dist(-1.0f);
+      unsigned int max_idx(R.x());
+
+      chains.pop_back();
+      for(unsigned int i = R.x() + 1; i < R.y(); ++i)
+        {
+          fastuidraw::vec2 ap(C[i].pt() - a);
+          float t, d;
+
+          t = (ab_sq > 0.0f) ? fastuidraw::t_max(0.0f, fastuidraw::t_min(1.0f, dot(ap, ab) / ab_sq)) : 0.0f;
+          d = (ap - t * ab).magnitudeSq();
+          if(d > max_dist)
+            {
+              max_dist = d;
+              max_idx = i;
+            }
+        }
+
+      if(max_idx != R.x() && (max_dist > tolerance * tolerance || num_kept < 3))
+        {
+          /* the first point cut is kept even when it is within
+             tolerance so that the contour does not collapse to
+             a segment of zero area.
+           */
+          keep[max_idx] = true;
+          ++num_kept;
+          chains.push_back(fastuidraw::uvec2(R.x(), max_idx));
+          chains.push_back(fastuidraw::uvec2(max_idx, R.y()));
+        }
+    }
+
+  unsigned int dst(0);
+  for(unsigned int i = 0; i < n; ++i)
+    {
+      if(keep[i])
+        {
+          C[dst++] = C[i];
+        }
+    }
+  C.resize(dst);
+}
+
 void
 SubPath::
 copy_contour(SubContour &dst,
@@ -949,10 +1606,10 @@ copy_contour(SubContour &dst,
       fastuidraw::range_type<unsigned int> R;
 
       R = src.edge_range(C, e);
-      dst.push_back(SubContourPoint(src.point_data()[R.m_begin].m_p, true));
+      dst.push_back(SubContourPoint(src.point_positions()[R.m_begin], true));
       for(unsigned int v = R.m_begin + 1; v + 1 < R.m_end; ++v)
         {
-          SubContourPoint pt(src.point_data()[v].m_p);
+          SubContourPoint pt(src.point_positions()[v]);
           dst.push_back(pt);
         }
     }
@@ -1226,8 +1883,8 @@ split(void) const
         }
     }
 
-  return_value[0] = FASTUIDRAWnew SubPath(B0, C0, C0_winding_start + m_winding_start);
-  return_value[1] = FASTUIDRAWnew SubPath(B1, C1, C1_winding_start + m_winding_start);
+  return_value[0] = FASTUIDRAWnew SubPath(B0, m_path_bounds, C0, C0_winding_start + m_winding_start);
+  return_value[1] = FASTUIDRAWnew SubPath(B1, m_path_bounds, C1, C1_winding_start + m_winding_start);
 
   return return_value;
 }
@@ -1393,24 +2050,33 @@ process_bounding_boxes(const std::vector<fastuidraw::BoundingBox> &in_boxes,
 
 ////////////////////////////////////////
 // tesser methods
+fastuidraw_GLUtesselator*
+tesser::
+create_tess(void)
+{
+  fastuidraw_GLUtesselator *tess;
+
+  tess = fastuidraw_gluNewTess;
+  fastuidraw_gluTessCallbackBegin(tess, &begin_callBack);
+  fastuidraw_gluTessCallbackVertex(tess, &vertex_callBack);
+  fastuidraw_gluTessCallbackCombine(tess, &combine_callback);
+  fastuidraw_gluTessCallbackFillRule(tess, &winding_callBack);
+  fastuidraw_gluTessPropertyBoundaryOnly(tess, FASTUIDRAW_GLU_FALSE);
+  return tess;
+}
+
 tesser::
-tesser(PointHoard &points):
+tesser(PointHoard &points, fastuidraw_GLUtesselator *tess):
   m_point_count(0),
+  m_tess(tess),
   m_points(points),
   m_triangulation_failed(false)
 {
-  m_tess = fastuidraw_gluNewTess;
-  fastuidraw_gluTessCallbackBegin(m_tess, &begin_callBack);
-  fastuidraw_gluTessCallbackVertex(m_tess, &vertex_callBack);
-  fastuidraw_gluTessCallbackCombine(m_tess, &combine_callback);
-  fastuidraw_gluTessCallbackFillRule(m_tess, &winding_callBack);
-  fastuidraw_gluTessPropertyBoundaryOnly(m_tess, FASTUIDRAW_GLU_FALSE);
 }
 
 tesser::
 ~tesser(void)
 {
-  fastuidraw_gluDeleteTess(m_tess);
 }
 
 
@@ -1706,12 +2372,12 @@ winding_callBack(int winding_number, void *tess)
 ///////////////////////////////////
 // non_zero_tesser methods
 non_zero_tesser::
-non_zero_tesser(PointHoard &points,
+non_zero_tesser(PointHoard &points, fastuidraw_GLUtesselator *tess,
                 const PointHoard::Path &P,
                 const PointHoard::BoundingBoxes &boxes,
                 const SubPath &path,
                 winding_index_hoard &hoard):
-  tesser(points),
+  tesser(points, tess),
   m_winding_start(path.winding_start()),
   m_hoard(hoard),
   m_current_winding(0)
@@ -1759,12 +2425,12 @@ fill_region(int winding_number)
 ///////////////////////////////
 // zero_tesser methods
 zero_tesser::
-zero_tesser(PointHoard &points,
+zero_tesser(PointHoard &points, fastuidraw_GLUtesselator *tess,
             const PointHoard::Path &P,
             const PointHoard::BoundingBoxes &boxes,
             const SubPath &path,
             winding_index_hoard &hoard):
-  tesser(points),
+  tesser(points, tess),
   m_indices(hoard[path.winding_start()])
 {
   if(!m_indices)
@@ -1807,21 +2473,23 @@ fill_region(int winding_number)
 // builder methods
 builder::
 builder(const SubPath &P, std::vector<fastuidraw::vec2> &points):
-  m_points(P.bounds(), points)
+  m_points(P.bounds(), points),
+  m_tess(tesser::create_tess())
 {
   bool failZ, failNZ;
   PointHoard::Path path;
   PointHoard::BoundingBoxes path_bounding_boxes;
 
   m_points.generate_path(P, path, path_bounding_boxes);
-  failNZ = non_zero_tesser::execute_path(m_points, path, path_bounding_boxes, P, m_hoard);
-  failZ = zero_tesser::execute_path(m_points, path, path_bounding_boxes, P, m_hoard);
+  failNZ = non_zero_tesser::execute_path(m_points, m_tess, path, path_bounding_boxes, P, m_hoard);
+  failZ = zero_tesser::execute_path(m_points, m_tess, path, path_bounding_boxes, P, m_hoard);
   m_failed= failNZ || failZ;
 }
 
 builder::
 ~builder()
 {
+  fastuidraw_gluDeleteTess(m_tess);
 }
 
 void
@@ -1904,6 +2572,78 @@ fill_indices(std::vector<unsigned int> &indices,
 
 }
 
+/////////////////////////////////////////
+// sweep_builder methods
+sweep_builder::
+sweep_builder(const SubPath &P, std::vector<fastuidraw::vec2> &points):
+  m_winding_start(P.winding_start())
+{
+  const std::vector<SubPath::SubContour> &contours(P.contours());
+  for(std::vector<SubPath::SubContour>::const_iterator iter = contours.begin(),
+        end = contours.end(); iter != end; ++iter)
+    {
+      const SubPath::SubContour &C(*iter);
+      for(unsigned int v = 0, endv = C.size(); v < endv; ++v)
+        {
+          m_triangulator.add_point(C[v].pt());
+        }
+      m_triangulator.end_contour();
+    }
+  m_triangulator.triangulate(P.bounds().min_point(), P.bounds().max_point());
+  points.assign(m_triangulator.points().begin(), m_triangulator.points().end());
+}
+
+void
+sweep_builder::
+fill_indices(std::vector<unsigned int> &indices,
+             std::map<int, fastuidraw::const_c_array<unsigned int> > &winding_map,
+             unsigned int &even_non_zero_start,
+             unsigned int &zero_start)
+{
+  const std::vector<int> &windings(m_triangulator.winding_numbers());
+  const std::vector<unsigned int> &src(m_triangulator.indices());
+  triangle_order order(windings, m_winding_start);
+  std::vector<unsigned int> triangles(windings.size());
+
+  for(unsigned int t = 0, endt = triangles.size(); t < endt; ++t)
+    {
+      triangles[t] = t;
+    }
+  std::sort(triangles.begin(), triangles.end(), order);
+
+  even_non_zero_start = zero_start = 3 * triangles.size();
+  indices.resize(3 * triangles.size());
+  for(unsigned int t = 0, endt = triangles.size(), run_start = 0; t < endt; ++t)
+    {
+      unsigned int tri(triangles[t]);
+      int w(order.winding(tri));
+
+      indices[3 * t + 0] = src[3 * tri + 0];
+      indices[3 * t + 1] = src[3 * tri + 1];
+      indices[3 * t + 2] = src[3 * tri + 2];
+
+      if(t == 0 || order.winding(triangles[t - 1]) != w)
+        {
+          int c(triangle_order::category(w));
+
+          run_start = t;
+          if(c >= 1 && even_non_zero_start == 3 * endt)
+            {
+              even_non_zero_start = 3 * t;
+            }
+          if(c == 2)
+            {
+              zero_start = 3 * t;
+            }
+        }
+
+      if(t + 1 == endt || order.winding(triangles[t + 1]) != w)
+        {
+          winding_map[w] = fastuidraw::make_c_array(indices).sub_array(3 * run_start, 3 * (t + 1 - run_start));
+        }
+    }
+}
+
 ////////////////////////////////
 // AttributeDataMerger methods
 void
@@ -2117,17 +2857,151 @@ fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attributes,
     }
 }
 
+////////////////////////////////////
+// AAFuzzFiller methods
+void
+AAFuzzFiller::
+add_edge(const fastuidraw::vec2 &p, const fastuidraw::vec2 &q,
+         const fastuidraw::vec2 &n, int wa, int wb)
+{
+  add_quad(p, q, n, wa, wb);
+  add_quad(p, q, -n, wb, wa);
+}
+
+void
+AAFuzzFiller::
+add_quad(const fastuidraw::vec2 &p, const fastuidraw::vec2 &q,
+         const fastuidraw::vec2 &n, int filled_winding, int unfilled_winding)
+{
+  using namespace fastuidraw;
+
+  unsigned int first_attrib(m_attribs.size());
+  bool filled_odd(filled_winding % 2 != 0), unfilled_odd(unfilled_winding % 2 != 0);
+
+  m_attribs.push_back(generate_attribute(p, n, 0.0f));
+  m_attribs.push_back(generate_attribute(q, n, 0.0f));
+  m_attribs.push_back(generate_attribute(p, n, 1.0f));
+  m_attribs.push_back(generate_attribute(q, n, 1.0f));
+
+  add_quad_indices(FilledPath::Subset::aa_chunk_from_winding_numbers(filled_winding, unfilled_winding),
+                   first_attrib);
+  if(filled_odd && !unfilled_odd)
+    {
+      add_quad_indices(FilledPath::Subset::aa_chunk_from_fill_rule(PainterEnums::odd_even_fill_rule),
+                       first_attrib);
+    }
+  if(!filled_odd && unfilled_odd)
+    {
+      add_quad_indices(FilledPath::Subset::aa_chunk_from_fill_rule(PainterEnums::complement_odd_even_fill_rule),
+                       first_attrib);
+    }
+  if(filled_winding != 0 && unfilled_winding == 0)
+    {
+      add_quad_indices(FilledPath::Subset::aa_chunk_from_fill_rule(PainterEnums::nonzero_fill_rule),
+                       first_attrib);
+    }
+  if(filled_winding == 0 && unfilled_winding != 0)
+    {
+      add_quad_indices(FilledPath::Subset::aa_chunk_from_fill_rule(PainterEnums::complement_nonzero_fill_rule),
+                       first_attrib);
+    }
+}
+
+void
+AAFuzzFiller::
+add_quad_indices(unsigned int chunk, unsigned int first_attrib)
+{
+  if(chunk >= m_chunks.size())
+    {
+      m_chunks.resize(chunk + 1);
+    }
+
+  std::vector<fastuidraw::PainterIndex> &dst(m_chunks[chunk]);
+  dst.push_back(first_attrib + 0);
+  dst.push_back(first_attrib + 1);
+  dst.push_back(first_attrib + 2);
+  dst.push_back(first_attrib + 1);
+  dst.push_back(first_attrib + 3);
+  dst.push_back(first_attrib + 2);
+}
+
+unsigned int
+AAFuzzFiller::
+largest_index_block(void) const
+{
+  unsigned int return_value(0);
+  for(unsigned int i = 0, endi = m_chunks.size(); i < endi; ++i)
+    {
+      return_value = fastuidraw::t_max(return_value, static_cast<unsigned int>(m_chunks[i].size()));
+    }
+  return return_value;
+}
+
+void
+AAFuzzFiller::
+compute_sizes(unsigned int &number_attributes,
+              unsigned int &number_indices,
+              unsigned int &number_attribute_chunks,
+              unsigned int &number_index_chunks,
+              unsigned int &number_z_increments) const
+{
+  number_z_increments = 0;
+  number_attributes = m_attribs.size();
+  number_attribute_chunks = m_attribs.empty() ? 0 : 1;
+  number_index_chunks = m_chunks.size();
+  number_indices = 0;
+  for(unsigned int i = 0, endi = m_chunks.size(); i < endi; ++i)
+    {
+      number_indices += m_chunks[i].size();
+    }
+}
+
+void
+AAFuzzFiller::
+fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attributes,
+          fastuidraw::c_array<fastuidraw::PainterIndex> indices,
+          fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attrib_chunks,
+          fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+          fastuidraw::c_array<unsigned int> zincrements,
+          fastuidraw::c_array<int> index_adjusts) const
+{
+  using namespace fastuidraw;
+
+  FASTUIDRAWunused(zincrements);
+  if(m_attribs.empty())
+    {
+      return;
+    }
+
+  std::copy(m_attribs.begin(), m_attribs.end(), attributes.begin());
+  attrib_chunks[0] = attributes;
+  std::fill(index_adjusts.begin(), index_adjusts.end(), 0);
+
+  for(unsigned int chunk = 0, current = 0, end_chunk = m_chunks.size(); chunk < end_chunk; ++chunk)
+    {
+      c_array<PainterIndex> dst;
+
+      dst = indices.sub_array(current, m_chunks[chunk].size());
+      std::copy(m_chunks[chunk].begin(), m_chunks[chunk].end(), dst.begin());
+      index_chunks[chunk] = dst;
+      current += dst.size();
+    }
+}
+
 /////////////////////////////////
 // SubsetPrivate methods
 SubsetPrivate::
 SubsetPrivate(SubPath *Q, int max_recursion,
+              enum fastuidraw::FilledPath::triangulator_t triangulator,
               std::vector<SubsetPrivate*> &out_values):
   m_ID(out_values.size()),
   m_bounds(Q->bounds()),
   m_painter_data(NULL),
+  m_aa_painter_data(NULL),
   m_sizes_ready(false),
   m_sub_path(Q),
-  m_children(NULL, NULL)
+  m_children(NULL, NULL),
+  m_triangulator(triangulator)
 {
   out_values.push_back(this);
   if(max_recursion > 0 && m_sub_path->total_points() > SubsetConstants::points_per_subset)
@@ -2137,8 +3011,8 @@ SubsetPrivate(SubPath *Q, int max_recursion,
       C = Q->split();
       if(C[0]->total_points() < m_sub_path->total_points() || C[1]->total_points() < m_sub_path->total_points())
         {
-          m_children[0] = FASTUIDRAWnew SubsetPrivate(C[0], max_recursion - 1, out_values);
-          m_children[1] = FASTUIDRAWnew SubsetPrivate(C[1], max_recursion - 1, out_values);
+          m_children[0] = FASTUIDRAWnew SubsetPrivate(C[0], max_recursion - 1, triangulator, out_values);
+          m_children[1] = FASTUIDRAWnew SubsetPrivate(C[1], max_recursion - 1, triangulator, out_values);
           FASTUIDRAWdelete(m_sub_path);
           m_sub_path = NULL;
         }
@@ -2164,7 +3038,9 @@ SubsetPrivate::
   if(m_painter_data != NULL)
     {
       assert(m_sub_path == NULL);
+      assert(m_aa_painter_data != NULL);
       FASTUIDRAWdelete(m_painter_data);
+      FASTUIDRAWdelete(m_aa_painter_data);
     }
 
   if(m_children[0] != NULL)
@@ -2176,67 +3052,267 @@ SubsetPrivate::
     }
 }
 
-unsigned int
 SubsetPrivate::
-select_subsets(ScratchSpacePrivate &scratch,
-               fastuidraw::const_c_array<fastuidraw::vec3> clip_equations,
-               const fastuidraw::float3x3 &clip_matrix_local,
-               unsigned int max_attribute_cnt,
-               unsigned int max_index_cnt,
-               fastuidraw::c_array<unsigned int> dst)
+SubsetPrivate(fastuidraw::detail::BlobReader &src, unsigned int ID,
+              enum fastuidraw::FilledPath::triangulator_t triangulator,
+              fastuidraw::vecN<uint32_t, 2> &child_IDs):
+  m_ID(ID),
+  m_painter_data(NULL),
+  m_aa_painter_data(NULL),
+  m_sizes_ready(true),
+  m_sub_path(NULL),
+  m_children(NULL, NULL),
+  m_triangulator(triangulator)
 {
-  unsigned int return_value(0u);
+  m_bounds = src.read_bounding_box();
+  child_IDs[0] = src.read_u32();
+  child_IDs[1] = src.read_u32();
+  m_num_attributes = src.read_u32();
+  m_largest_index_block = src.read_u32();
 
-  scratch.m_adjusted_clip_eqs.resize(clip_equations.size());
-  for(unsigned int i = 0; i < clip_equations.size(); ++i)
+  if((child_IDs[0] == SubsetConstants::blob_no_child) != (child_IDs[1] == SubsetConstants::blob_no_child))
     {
-      /* transform clip equations from clip coordinates to
-         local coordinates.
-       */
-      scratch.m_adjusted_clip_eqs[i] = clip_equations[i] * clip_matrix_local;
+      src.fail();
     }
 
-  select_subsets_implement(scratch, dst, max_attribute_cnt, max_index_cnt, return_value);
-  return return_value;
-}
+  if(child_IDs[0] == SubsetConstants::blob_no_child && !src.failed())
+    {
+      unsigned int num_windings, num_clusters, num_chunks;
 
-void
-SubsetPrivate::
-select_subsets_implement(ScratchSpacePrivate &scratch,
-                         fastuidraw::c_array<unsigned int> dst,
-                         unsigned int max_attribute_cnt,
-                         unsigned int max_index_cnt,
-                         unsigned int &current)
-{
-  using namespace fastuidraw;
-  using namespace fastuidraw::detail;
+      num_windings = src.read_u32();
+      for(unsigned int i = 0; i < num_windings && !src.failed(); ++i)
+        {
+          m_winding_numbers.push_back(src.read_i32());
+        }
 
-  vecN<vec2, 4> bb;
-  bool unclipped;
+      m_painter_data = FASTUIDRAWnew fastuidraw::PainterAttributeData();
+      m_aa_painter_data = FASTUIDRAWnew fastuidraw::PainterAttributeData();
+      fastuidraw::detail::read_painter_attribute_data(src, *m_painter_data);
 
-  m_bounds.inflated_polygon(bb, 0.0f);
-  unclipped = clip_against_planes(make_c_array(scratch.m_adjusted_clip_eqs),
-                                  bb, scratch.m_clipped_rect,
-                                  scratch.m_clip_scratch_floats,
-                                  scratch.m_clip_scratch_vec2s);
+      num_clusters = src.read_u32();
+      for(unsigned int i = 0; i < num_clusters && !src.failed(); ++i)
+        {
+          fastuidraw::FilledPath::Subset::Cluster C;
 
-  //completely clipped
-  if(scratch.m_clipped_rect.empty())
-    {
-      return;
-    }
+          C.m_index_range.m_begin = src.read_u32();
+          C.m_index_range.m_end = src.read_u32();
+          C.m_min_bb = src.read_vec2();
+          C.m_max_bb = src.read_vec2();
+          m_clusters.push_back(C);
+        }
 
-  //completely unclipped or no children
-  assert((m_children[0] == NULL) == (m_children[1] == NULL));
-  if(unclipped || m_children[0] == NULL)
-    {
-      select_subsets_all_unculled(dst, max_attribute_cnt, max_index_cnt, current);
-      return;
-    }
+      num_chunks = src.read_u32();
+      for(unsigned int i = 0; i < num_chunks && !src.failed(); ++i)
+        {
+          fastuidraw::range_type<unsigned int> R;
+          unsigned int chunk_size;
 
-  m_children[0]->select_subsets_implement(scratch, dst, max_attribute_cnt, max_index_cnt, current);
-  m_children[1]->select_subsets_implement(scratch, dst, max_attribute_cnt, max_index_cnt, current);
-}
+          R.m_begin = src.read_u32();
+          R.m_end = src.read_u32();
+          if(R.m_begin > R.m_end || R.m_end > m_clusters.size())
+            {
+              src.fail();
+              break;
+            }
+
+          /* a cluster must be within its index chunk */
+          chunk_size = m_painter_data->index_data_chunk(i).size();
+          for(unsigned int c = R.m_begin; c < R.m_end; ++c)
+            {
+              if(m_clusters[c].m_index_range.m_begin > m_clusters[c].m_index_range.m_end
+                 || m_clusters[c].m_index_range.m_end > chunk_size)
+                {
+                  src.fail();
+                }
+            }
+          m_cluster_chunks.push_back(R);
+        }
+
+      fastuidraw::detail::read_painter_attribute_data(src, *m_aa_painter_data);
+    }
+}
+
+void
+SubsetPrivate::
+make_ready_for_blob(unsigned int max_threads)
+{
+  std::vector<SubsetPrivate*> leaves;
+
+  collect_unready_leaves(leaves);
+  make_ready_leaves(leaves, max_threads);
+  make_sizes_ready();
+}
+
+void
+SubsetPrivate::
+make_sizes_ready(void)
+{
+  if(m_sizes_ready)
+    {
+      return;
+    }
+
+  /* leaves have their sizes computed when triangulated
+     which make_ready_for_blob() did already.
+   */
+  assert(m_children[0] != NULL);
+  m_children[0]->make_sizes_ready();
+  m_children[1]->make_sizes_ready();
+  m_sizes_ready = true;
+  m_num_attributes = m_children[0]->m_num_attributes + m_children[1]->m_num_attributes;
+  m_largest_index_block = m_children[0]->m_largest_index_block + m_children[1]->m_largest_index_block;
+}
+
+void
+SubsetPrivate::
+write_to_blob(fastuidraw::detail::BlobWriter &dst) const
+{
+  assert(m_sizes_ready);
+  dst.write_bounding_box(m_bounds);
+  for(unsigned int i = 0; i < 2; ++i)
+    {
+      dst.write_u32(m_children[i] != NULL ?
+                    m_children[i]->m_ID :
+                    SubsetConstants::blob_no_child);
+    }
+  dst.write_u32(m_num_attributes);
+  dst.write_u32(m_largest_index_block);
+
+  if(m_children[0] == NULL)
+    {
+      assert(m_painter_data != NULL);
+      dst.write_u32(m_winding_numbers.size());
+      for(unsigned int i = 0, endi = m_winding_numbers.size(); i < endi; ++i)
+        {
+          dst.write_i32(m_winding_numbers[i]);
+        }
+      fastuidraw::detail::write_painter_attribute_data(dst, *m_painter_data);
+
+      dst.write_u32(m_clusters.size());
+      for(unsigned int i = 0, endi = m_clusters.size(); i < endi; ++i)
+        {
+          dst.write_u32(m_clusters[i].m_index_range.m_begin);
+          dst.write_u32(m_clusters[i].m_index_range.m_end);
+          dst.write_vec2(m_clusters[i].m_min_bb);
+          dst.write_vec2(m_clusters[i].m_max_bb);
+        }
+
+      dst.write_u32(m_cluster_chunks.size());
+      for(unsigned int i = 0, endi = m_cluster_chunks.size(); i < endi; ++i)
+        {
+          dst.write_u32(m_cluster_chunks[i].m_begin);
+          dst.write_u32(m_cluster_chunks[i].m_end);
+        }
+
+      fastuidraw::detail::write_painter_attribute_data(dst, *m_aa_painter_data);
+    }
+}
+
+void
+SubsetPrivate::
+make_ready_leaves(const std::vector<SubsetPrivate*> &leaves,
+                  unsigned int max_threads)
+{
+  /* triangulating a leaf is cheap, a thread needs
+     several to pay for its creation.
+   */
+  const unsigned int min_leaves_per_thread = 4;
+  make_ready_leaves_job job(leaves);
+
+  fastuidraw::run_in_parallel(leaves.size(), max_threads, min_leaves_per_thread, job);
+}
+
+void
+SubsetPrivate::
+collect_unready_leaves(std::vector<SubsetPrivate*> &out)
+{
+  if(m_painter_data != NULL || m_sizes_ready)
+    {
+      return;
+    }
+
+  if(m_children[0] == NULL)
+    {
+      assert(m_sub_path != NULL);
+      out.push_back(this);
+    }
+  else
+    {
+      m_children[0]->collect_unready_leaves(out);
+      m_children[1]->collect_unready_leaves(out);
+    }
+}
+
+int
+SubsetPrivate::
+winding_number_at(const fastuidraw::vec2 &p)
+{
+  if(m_children[0] != NULL)
+    {
+      /* the bounds of the children partition the bounds of
+         this, a point on their shared side is in both.
+       */
+      SubsetPrivate *c;
+      c = box_contains(m_children[0]->m_bounds, p) ? m_children[0] : m_children[1];
+      return c->winding_number_at(p);
+    }
+
+  make_ready();
+
+  fastuidraw::const_c_array<fastuidraw::PainterAttribute> attribs;
+  attribs = m_painter_data->attribute_data_chunk(0);
+
+  /* the triangles of winding number 0 are those not in the
+     triangles of any other winding number, so they need
+     not be tested.
+   */
+  for(unsigned int k = 0; k < m_winding_numbers.size(); ++k)
+    {
+      int w(m_winding_numbers[k]);
+      unsigned int chunk;
+      fastuidraw::const_c_array<fastuidraw::PainterIndex> indices;
+      fastuidraw::const_c_array<fastuidraw::FilledPath::Subset::Cluster> chunk_clusters;
+      fastuidraw::FilledPath::Subset::Cluster whole;
+
+      if(w == 0)
+        {
+          continue;
+        }
+
+      chunk = fastuidraw::FilledPath::Subset::chunk_from_winding_number(w);
+      indices = m_painter_data->index_data_chunk(chunk);
+      chunk_clusters = clusters(chunk);
+      if(chunk_clusters.empty())
+        {
+          whole.m_index_range = fastuidraw::range_type<unsigned int>(0, indices.size());
+          chunk_clusters = fastuidraw::const_c_array<fastuidraw::FilledPath::Subset::Cluster>(&whole, 1);
+        }
+
+      for(unsigned int c = 0; c < chunk_clusters.size(); ++c)
+        {
+          const fastuidraw::FilledPath::Subset::Cluster &cl(chunk_clusters[c]);
+
+          if(&cl != &whole
+             && (p.x() < cl.m_min_bb.x() || p.x() > cl.m_max_bb.x()
+                 || p.y() < cl.m_min_bb.y() || p.y() > cl.m_max_bb.y()))
+            {
+              continue;
+            }
+
+          for(unsigned int i = cl.m_index_range.m_begin; i + 2 < cl.m_index_range.m_end; i += 3)
+            {
+              if(triangle_contains(attribute_position(attribs[indices[i]]),
+                                   attribute_position(attribs[indices[i + 1]]),
+                                   attribute_position(attribs[indices[i + 2]]),
+                                   p))
+                {
+                  return w;
+                }
+            }
+        }
+    }
+  return 0;
+}
 
 void
 SubsetPrivate::
@@ -2279,6 +3355,20 @@ select_subsets_all_unculled(fastuidraw::c_array<unsigned int> dst,
     }
 }
 
+void
+SubsetPrivate::
+make_ready(unsigned int max_threads)
+{
+  if(m_painter_data == NULL && max_threads != 1)
+    {
+      std::vector<SubsetPrivate*> leaves;
+
+      collect_unready_leaves(leaves);
+      make_ready_leaves(leaves, max_threads);
+    }
+  make_ready();
+}
+
 void
 SubsetPrivate::
 make_ready(void)
@@ -2315,6 +3405,11 @@ make_ready_from_children(void)
   m_painter_data = FASTUIDRAWnew fastuidraw::PainterAttributeData();
   m_painter_data->set_data(merger);
 
+  AttributeDataMerger aa_merger(m_children[0]->aa_painter_data(),
+                                m_children[1]->aa_painter_data());
+  m_aa_painter_data = FASTUIDRAWnew fastuidraw::PainterAttributeData();
+  m_aa_painter_data->set_data(aa_merger);
+
   std::copy(m_children[0]->winding_numbers().begin(),
             m_children[0]->winding_numbers().end(),
             std::inserter(wnd, wnd.begin()));
@@ -2345,11 +3440,26 @@ make_ready_from_sub_path(void)
   assert(!m_sizes_ready);
 
   AttributeDataFiller filler;
-  builder B(*m_sub_path, filler.m_points);
+  AAFuzzFiller fuzz;
   unsigned int even_non_zero_start, zero_start;
   unsigned int m1, m2;
+  bool triangulation_failed;
 
-  B.fill_indices(filler.m_indices, filler.m_per_fill, even_non_zero_start, zero_start);
+  if(m_triangulator == fastuidraw::FilledPath::sweep_triangulator)
+    {
+      sweep_builder B(*m_sub_path, filler.m_points);
+      B.fill_indices(filler.m_indices, filler.m_per_fill, even_non_zero_start, zero_start);
+      triangulation_failed = B.triangulation_failed();
+    }
+  else
+    {
+      builder B(*m_sub_path, filler.m_points);
+      B.fill_indices(filler.m_indices, filler.m_per_fill, even_non_zero_start, zero_start);
+      triangulation_failed = B.triangulation_failed();
+    }
+
+  make_clusters(filler, even_non_zero_start, zero_start);
+  make_aa_fuzz(filler, m_sub_path->path_bounds(), fuzz);
 
   fastuidraw::const_c_array<unsigned int> indices_ptr;
   indices_ptr = fastuidraw::make_c_array(filler.m_indices);
@@ -2363,8 +3473,12 @@ make_ready_from_sub_path(void)
                          filler.m_zero_winding_indices.size());
   m2 = fastuidraw::t_max(filler.m_odd_winding_indices.size(),
                          filler.m_even_winding_indices.size());
-  m_largest_index_block = fastuidraw::t_max(m1, m2);
-  m_num_attributes = filler.m_points.size();
+  /* the fuzz is drawn from its own attribute chunk, so
+     each of the fill and the fuzz must fit in a block.
+   */
+  m_largest_index_block = fastuidraw::t_max(fastuidraw::t_max(m1, m2),
+                                            fuzz.largest_index_block());
+  m_num_attributes = fastuidraw::t_max(filler.m_points.size(), fuzz.m_attribs.size());
 
   m_winding_numbers.reserve(filler.m_per_fill.size());
   for(std::map<int, fastuidraw::const_c_array<unsigned int> >::iterator
@@ -2379,13 +3493,15 @@ make_ready_from_sub_path(void)
    */
   m_painter_data = FASTUIDRAWnew fastuidraw::PainterAttributeData();
   m_painter_data->set_data(filler);
+  m_aa_painter_data = FASTUIDRAWnew fastuidraw::PainterAttributeData();
+  m_aa_painter_data->set_data(fuzz);
 
   FASTUIDRAWdelete(m_sub_path);
   m_sub_path = NULL;
 
   #ifdef FASTUIDRAW_DEBUG
     {
-      if(B.triangulation_failed())
+      if(triangulation_failed)
         {
           /* On debug builds, print a warning.
            */
@@ -2394,24 +3510,627 @@ make_ready_from_sub_path(void)
                     << this << "\n";
         }
     }
+  #else
+    {
+      FASTUIDRAWunused(triangulation_failed);
+    }
   #endif
 
 }
 
+namespace
+{
+  bool
+  cluster_compare(const fastuidraw::FilledPath::Subset::Cluster &lhs,
+                  const fastuidraw::FilledPath::Subset::Cluster &rhs)
+  {
+    return lhs.m_index_range.m_begin < rhs.m_index_range.m_begin;
+  }
+
+  /* spread the low 16 bits of v to the even bits */
+  uint32_t
+  spread_bits(uint32_t v)
+  {
+    v &= 0xFFFFu;
+    v = (v | (v << 8u)) & 0x00FF00FFu;
+    v = (v | (v << 4u)) & 0x0F0F0F0Fu;
+    v = (v | (v << 2u)) & 0x33333333u;
+    v = (v | (v << 1u)) & 0x55555555u;
+    return v;
+  }
+
+  /* Morton code of a point within a box, so that sorting
+     by it keeps points that are near each other close
+     in the sorted order.
+   */
+  uint32_t
+  morton_code(const fastuidraw::vec2 &p,
+              const fastuidraw::vec2 &min_pt,
+              const fastuidraw::vec2 &recip_size)
+  {
+    fastuidraw::vecN<uint32_t, 2> q;
+
+    for(unsigned int c = 0; c < 2; ++c)
+      {
+        float v;
+        v = (p[c] - min_pt[c]) * recip_size[c];
+        v = fastuidraw::t_min(1.0f, fastuidraw::t_max(0.0f, v));
+        q[c] = static_cast<uint32_t>(v * 65535.0f);
+      }
+    return spread_bits(q.x()) | (spread_bits(q.y()) << 1u);
+  }
+}
+
+void
+SubsetPrivate::
+make_clusters(AttributeDataFiller &filler,
+              unsigned int even_non_zero_start,
+              unsigned int zero_start)
+{
+  using namespace fastuidraw;
+
+  std::vector<FilledPath::Subset::Cluster> block_clusters;
+  std::vector<std::pair<uint32_t, unsigned int> > sorted;
+  std::vector<unsigned int> tmp;
+  vec2 min_pt(0.0f, 0.0f), recip_size(0.0f, 0.0f);
+  unsigned int total(filler.m_indices.size());
+
+  if(!m_bounds.empty())
+    {
+      vec2 sz(m_bounds.max_point() - m_bounds.min_point());
+
+      min_pt = m_bounds.min_point();
+      recip_size.x() = (sz.x() > 0.0f) ? 1.0f / sz.x() : 0.0f;
+      recip_size.y() = (sz.y() > 0.0f) ? 1.0f / sz.y() : 0.0f;
+    }
+
+  /* sort the triangles of each winding number by the Morton
+     code of their centroid; this only reorders the triangles
+     within the range of each winding number, so the ranges
+     of filler.m_per_fill and of the fill rules stay the same.
+   */
+  for(std::map<int, const_c_array<unsigned int> >::iterator
+        iter = filler.m_per_fill.begin(), end = filler.m_per_fill.end();
+      iter != end; ++iter)
+    {
+      unsigned int begin, num_tris;
+
+      begin = iter->second.c_ptr() - &filler.m_indices[0];
+      num_tris = iter->second.size() / 3;
+      assert(iter->second.size() % 3 == 0);
+
+      sorted.resize(num_tris);
+      for(unsigned int t = 0; t < num_tris; ++t)
+        {
+          vec2 c;
+
+          c = filler.m_points[filler.m_indices[begin + 3 * t + 0]]
+            + filler.m_points[filler.m_indices[begin + 3 * t + 1]]
+            + filler.m_points[filler.m_indices[begin + 3 * t + 2]];
+          sorted[t] = std::make_pair(morton_code(c / 3.0f, min_pt, recip_size), t);
+        }
+      std::sort(sorted.begin(), sorted.end());
+
+      tmp.resize(3 * num_tris);
+      for(unsigned int t = 0; t < num_tris; ++t)
+        {
+          for(unsigned int k = 0; k < 3; ++k)
+            {
+              tmp[3 * t + k] = filler.m_indices[begin + 3 * sorted[t].second + k];
+            }
+        }
+      std::copy(tmp.begin(), tmp.end(), filler.m_indices.begin() + begin);
+
+      /* the triangles in order make the clusters */
+      for(unsigned int t = 0; t < num_tris; t += SubsetConstants::triangles_per_cluster)
+        {
+          FilledPath::Subset::Cluster C;
+          BoundingBox bb;
+          unsigned int t_end;
+
+          t_end = t_min(num_tris, t + SubsetConstants::triangles_per_cluster);
+          for(unsigned int i = begin + 3 * t; i < begin + 3 * t_end; ++i)
+            {
+              bb.union_point(filler.m_points[filler.m_indices[i]]);
+            }
+          C.m_index_range = range_type<unsigned int>(begin + 3 * t, begin + 3 * t_end);
+          C.m_min_bb = bb.min_point();
+          C.m_max_bb = bb.max_point();
+          block_clusters.push_back(C);
+        }
+    }
+
+  /* block_clusters are in order of the winding numbers, put
+     them in order of their location in filler.m_indices so
+     that the fill rule ranges are contiguous in it.
+   */
+  std::sort(block_clusters.begin(), block_clusters.end(), cluster_compare);
+
+  m_clusters.clear();
+  m_cluster_chunks.clear();
+  add_chunk_clusters(PainterEnums::odd_even_fill_rule, 0, even_non_zero_start, block_clusters);
+  add_chunk_clusters(PainterEnums::nonzero_fill_rule, 0, zero_start, block_clusters);
+  add_chunk_clusters(PainterEnums::complement_odd_even_fill_rule, even_non_zero_start, total, block_clusters);
+  add_chunk_clusters(PainterEnums::complement_nonzero_fill_rule, zero_start, total, block_clusters);
+  for(std::map<int, const_c_array<unsigned int> >::iterator
+        iter = filler.m_per_fill.begin(), end = filler.m_per_fill.end();
+      iter != end; ++iter)
+    {
+      if(iter->first != 0) //winding number 0 is by complement_nonzero_fill_rule
+        {
+          unsigned int begin;
+
+          begin = iter->second.c_ptr() - &filler.m_indices[0];
+          add_chunk_clusters(FilledPath::Subset::chunk_from_winding_number(iter->first),
+                             begin, begin + iter->second.size(), block_clusters);
+        }
+    }
+}
+
+void
+SubsetPrivate::
+add_chunk_clusters(unsigned int chunk, unsigned int begin, unsigned int end,
+                   const std::vector<fastuidraw::FilledPath::Subset::Cluster> &block_clusters)
+{
+  using namespace fastuidraw;
+
+  if(chunk >= m_cluster_chunks.size())
+    {
+      m_cluster_chunks.resize(chunk + 1, range_type<unsigned int>(0, 0));
+    }
+
+  m_cluster_chunks[chunk].m_begin = m_clusters.size();
+  for(unsigned int i = 0, endi = block_clusters.size(); i < endi; ++i)
+    {
+      const FilledPath::Subset::Cluster &C(block_clusters[i]);
+      if(C.m_index_range.m_begin >= begin && C.m_index_range.m_end <= end)
+        {
+          FilledPath::Subset::Cluster R(C);
+
+          /* the index chunk made from [begin, end) starts at 0 */
+          R.m_index_range.m_begin -= begin;
+          R.m_index_range.m_end -= begin;
+          m_clusters.push_back(R);
+        }
+    }
+  m_cluster_chunks[chunk].m_end = m_clusters.size();
+}
+
+namespace
+{
+  /* the edge between the vertices m_v of a triangle of winding
+     number m_winding whose third vertex is m_opposite; sorting
+     triangle_edge values puts the edges shared by triangles
+     next to each other.
+   */
+  class triangle_edge
+  {
+  public:
+    bool
+    operator<(const triangle_edge &rhs) const
+    {
+      return m_v < rhs.m_v;
+    }
+
+    std::pair<unsigned int, unsigned int> m_v;
+    unsigned int m_opposite;
+    int m_winding;
+  };
+
+  /* returns true if the edge from p to q is along a side of box */
+  bool
+  on_boundary(const fastuidraw::vec2 &p, const fastuidraw::vec2 &q,
+              const fastuidraw::BoundingBox &box)
+  {
+    for(unsigned int c = 0; c < 2; ++c)
+      {
+        if((p[c] == box.min_point()[c] && q[c] == box.min_point()[c])
+           || (p[c] == box.max_point()[c] && q[c] == box.max_point()[c]))
+          {
+            return true;
+          }
+      }
+    return false;
+  }
+}
+
+void
+SubsetPrivate::
+make_aa_fuzz(const AttributeDataFiller &filler,
+             const fastuidraw::BoundingBox &path_bounds,
+             AAFuzzFiller &fuzz)
+{
+  using namespace fastuidraw;
+
+  std::vector<triangle_edge> edges;
+
+  edges.reserve(filler.m_indices.size());
+  for(std::map<int, const_c_array<unsigned int> >::const_iterator
+        iter = filler.m_per_fill.begin(), end = filler.m_per_fill.end();
+      iter != end; ++iter)
+    {
+      const_c_array<unsigned int> tris(iter->second);
+      for(unsigned int t = 0; t + 2 < tris.size(); t += 3)
+        {
+          for(unsigned int k = 0; k < 3; ++k)
+            {
+              triangle_edge E;
+              unsigned int a(tris[t + k]), b(tris[t + (k + 1) % 3]);
+
+              E.m_v = std::make_pair(t_min(a, b), t_max(a, b));
+              E.m_opposite = tris[t + (k + 2) % 3];
+              E.m_winding = iter->first;
+              edges.push_back(E);
+            }
+        }
+    }
+  std::sort(edges.begin(), edges.end());
+
+  /* an edge shared by triangles of different winding numbers
+     is on the boundary of the fill. An edge of only one triangle
+     is on the boundary of the Subset; it is on the boundary of
+     the fill only if it is on the boundary of the path, outside
+     of which the winding number is 0.
+   */
+  for(unsigned int i = 0, endi = edges.size(); i < endi;)
+    {
+      const triangle_edge &A(edges[i]);
+      int other_winding;
+
+      if(i + 1 < endi && A.m_v == edges[i + 1].m_v)
+        {
+          other_winding = edges[i + 1].m_winding;
+          i += 2;
+        }
+      else
+        {
+          if(!on_boundary(filler.m_points[A.m_v.first],
+                          filler.m_points[A.m_v.second],
+                          path_bounds))
+            {
+              ++i;
+              continue;
+            }
+          other_winding = 0;
+          ++i;
+        }
+
+      if(A.m_winding != other_winding)
+        {
+          vec2 p(filler.m_points[A.m_v.first]), q(filler.m_points[A.m_v.second]);
+          vec2 t(q - p), n(-t.y(), t.x());
+          float mag(t.magnitude());
+
+          if(mag > 0.0f)
+            {
+              /* make n point away from the triangle of A */
+              n /= mag;
+              if(dot(n, filler.m_points[A.m_opposite] - p) > 0.0f)
+                {
+                  n = -n;
+                }
+              fuzz.add_edge(p, q, n, A.m_winding, other_winding);
+            }
+        }
+    }
+}
+
+/////////////////////////////////
+// SubsetHierarchy methods
+void
+SubsetHierarchy::
+set(const std::vector<SubsetPrivate*> &subsets)
+{
+  unsigned int sz;
+
+  sz = subsets.size();
+  m_boxes.pad(sz);
+  m_skip.resize(sz);
+  m_is_leaf.resize(sz);
+
+  /* children come after their parent, so walking backwards
+     visits the elements below i before i.
+   */
+  for(unsigned int i = sz; i > 0; --i)
+    {
+      const SubsetPrivate *p(subsets[i - 1]);
+
+      assert(p->ID() == i - 1);
+      m_boxes.set(i - 1, p->bounds());
+
+      m_is_leaf[i - 1] = (p->child(0) == NULL);
+      if(m_is_leaf[i - 1])
+        {
+          m_skip[i - 1] = i;
+        }
+      else
+        {
+          assert(p->child(0)->ID() == i);
+          assert(p->child(1)->ID() == m_skip[i]);
+          m_skip[i - 1] = m_skip[p->child(1)->ID()];
+        }
+    }
+}
+
+bool
+SubsetHierarchy::
+is_coarse(const ScratchSpacePrivate &scratch, unsigned int i) const
+{
+  /* an element partially within the clipping region that is
+     small on the screen is drawn whole, since its merged
+     triangulation costs little more than the triangles of its
+     descendants that are visible and it is a single Subset.
+   */
+  if(scratch.m_coarse_size.x() <= 0.0f || scratch.m_coarse_size.y() <= 0.0f)
+    {
+      return false;
+    }
+
+  fastuidraw::vec2 pmin, pmax;
+  for(unsigned int k = 0; k < 4; ++k)
+    {
+      fastuidraw::vec3 q;
+      fastuidraw::vec2 p;
+      float x, y;
+
+      x = (k & 1u) ? m_boxes.m_max_x[i] : m_boxes.m_min_x[i];
+      y = (k & 2u) ? m_boxes.m_max_y[i] : m_boxes.m_min_y[i];
+      q = scratch.m_clip_matrix_local * fastuidraw::vec3(x, y, 1.0f);
+      if(q.z() <= 0.0f)
+        {
+          return false;
+        }
+      p = fastuidraw::vec2(q.x(), q.y()) / q.z();
+      if(k == 0)
+        {
+          pmin = pmax = p;
+        }
+      else
+        {
+          pmin.x() = fastuidraw::t_min(pmin.x(), p.x());
+          pmin.y() = fastuidraw::t_min(pmin.y(), p.y());
+          pmax.x() = fastuidraw::t_max(pmax.x(), p.x());
+          pmax.y() = fastuidraw::t_max(pmax.y(), p.y());
+        }
+    }
+  return pmax.x() - pmin.x() <= scratch.m_coarse_size.x()
+    && pmax.y() - pmin.y() <= scratch.m_coarse_size.y();
+}
+
+template<typename F>
+void
+SubsetHierarchy::
+walk(ScratchSpacePrivate &scratch, F &f) const
+{
+  using namespace fastuidraw;
+  using namespace fastuidraw::detail;
+
+  const_c_array<vec3> clip_eqs(make_c_array(scratch.m_adjusted_clip_eqs));
+  vecN<enum Boxes::classification_t, block_size> block;
+  unsigned int block_start(m_boxes.m_min_x.size());
+  unsigned int i(0), sz(m_skip.size());
+
+  while(i < sz)
+    {
+      enum Boxes::classification_t c;
+
+      if(!f.enter(i))
+        {
+          i = m_skip[i];
+          continue;
+        }
+
+      if(i < block_start || i >= block_start + block_size)
+        {
+          block_start = i - (i % block_size);
+          m_boxes.classify_block(clip_eqs, 0.0f, block_start, block);
+        }
+
+      c = block[i - block_start];
+      if(c == Boxes::is_partially_clipped)
+        {
+          c = m_boxes.clip(clip_eqs, 0.0f, i,
+                           scratch.m_clipped_rect,
+                           scratch.m_clip_scratch_floats,
+                           scratch.m_clip_scratch_vec2s);
+        }
+
+      if(c == Boxes::is_culled)
+        {
+          i = m_skip[i];
+        }
+      else if(c == Boxes::is_unclipped || m_is_leaf[i] || is_coarse(scratch, i))
+        {
+          f.select(i);
+          i = m_skip[i];
+        }
+      else
+        {
+          ++i;
+        }
+    }
+}
+
 /////////////////////////////////
 // FilledPathPrivate methods
 FilledPathPrivate::
-FilledPathPrivate(const fastuidraw::TessellatedPath &P)
+FilledPathPrivate(const fastuidraw::TessellatedPath &P,
+                  enum fastuidraw::FilledPath::triangulator_t triangulator,
+                  float simplify_tolerance):
+  m_triangulator(triangulator),
+  m_max_threads(P.tessellation_parameters().m_max_threads)
 {
   SubPath *q;
-  q = FASTUIDRAWnew SubPath(P);
-  m_root = FASTUIDRAWnew SubsetPrivate(q, SubsetConstants::recursion_depth, m_subsets);
+  q = FASTUIDRAWnew SubPath(P, simplify_tolerance);
+  m_root = FASTUIDRAWnew SubsetPrivate(q, SubsetConstants::recursion_depth,
+                                       triangulator, m_subsets);
+  m_hierarchy.set(m_subsets);
 }
 
 FilledPathPrivate::
 ~FilledPathPrivate()
 {
-  FASTUIDRAWdelete(m_root);
+  if(m_root != NULL)
+    {
+      FASTUIDRAWdelete(m_root);
+    }
+}
+
+unsigned int
+FilledPathPrivate::
+select_subsets(ScratchSpacePrivate &scratch,
+               fastuidraw::const_c_array<fastuidraw::vec3> clip_equations,
+               const fastuidraw::float3x3 &clip_matrix_local,
+               unsigned int max_attribute_cnt,
+               unsigned int max_index_cnt,
+               fastuidraw::c_array<unsigned int> dst,
+               const fastuidraw::vec2 &coarse_size)
+{
+  scratch.m_clip_matrix_local = clip_matrix_local;
+  scratch.m_coarse_size = coarse_size;
+  scratch.m_adjusted_clip_eqs.resize(clip_equations.size());
+  for(unsigned int i = 0; i < clip_equations.size(); ++i)
+    {
+      /* transform clip equations from clip coordinates to
+         local coordinates.
+       */
+      scratch.m_adjusted_clip_eqs[i] = clip_equations[i] * clip_matrix_local;
+    }
+
+  /* triangulate the leaves that are about to be selected
+     in parallel before selecting; then select_subsets_walker
+     finds them ready.
+   */
+  if(m_max_threads != 1)
+    {
+      collect_unready_leaves_walker collector(m_subsets, scratch.m_unready_subsets);
+
+      scratch.m_unready_subsets.clear();
+      m_hierarchy.walk(scratch, collector);
+      SubsetPrivate::make_ready_leaves(scratch.m_unready_subsets, m_max_threads);
+    }
+
+  select_subsets_walker selector(m_subsets, dst, max_attribute_cnt, max_index_cnt);
+  m_hierarchy.walk(scratch, selector);
+  return selector.current();
+}
+
+void
+FilledPathPrivate::
+write_to_blob(fastuidraw::detail::BlobWriter &dst) const
+{
+  m_root->make_ready_for_blob(m_max_threads);
+
+  dst.write_u32(SubsetConstants::blob_magic);
+  dst.write_u32(SubsetConstants::blob_version);
+  dst.write_u32(m_triangulator);
+  dst.write_u32(m_max_threads);
+  dst.write_u32(m_subsets.size());
+  for(unsigned int i = 0, endi = m_subsets.size(); i < endi; ++i)
+    {
+      m_subsets[i]->write_to_blob(dst);
+    }
+}
+
+FilledPathPrivate*
+FilledPathPrivate::
+create_from_blob(fastuidraw::const_c_array<uint8_t> blob)
+{
+  FilledPathPrivate *d;
+  std::vector<fastuidraw::vecN<uint32_t, 2> > child_IDs;
+  std::vector<bool> has_parent;
+  std::vector<unsigned int> skip;
+  unsigned int triangulator, num_subsets;
+
+  d = FASTUIDRAWnew FilledPathPrivate();
+  fastuidraw::detail::BlobReader src(blob, d->m_blob_words);
+
+  if(src.read_u32() != SubsetConstants::blob_magic
+     || src.read_u32() != SubsetConstants::blob_version)
+    {
+      src.fail();
+    }
+
+  triangulator = src.read_u32();
+  d->m_max_threads = src.read_u32();
+  num_subsets = src.read_u32();
+  if(triangulator > fastuidraw::FilledPath::sweep_triangulator || num_subsets == 0)
+    {
+      src.fail();
+    }
+  d->m_triangulator = static_cast<enum fastuidraw::FilledPath::triangulator_t>(triangulator);
+
+  for(unsigned int i = 0; i < num_subsets && !src.failed(); ++i)
+    {
+      child_IDs.push_back(fastuidraw::vecN<uint32_t, 2>());
+      d->m_subsets.push_back(FASTUIDRAWnew SubsetPrivate(src, i, d->m_triangulator,
+                                                         child_IDs.back()));
+    }
+
+  /* the elements form a tree rooted at element 0 if each
+     child comes after its parent and each element other
+     than the root has exactly one parent. In addition,
+     SubsetHierarchy needs the elements in depth-first
+     order: the elements below i are [i + 1, skip[i]),
+     with the first child at i + 1 and the second child
+     at skip[i + 1].
+   */
+  has_parent.resize(d->m_subsets.size(), false);
+  for(unsigned int i = 0, endi = d->m_subsets.size(); i < endi && !src.failed(); ++i)
+    {
+      for(unsigned int c = 0; c < 2 && child_IDs[i][c] != SubsetConstants::blob_no_child; ++c)
+        {
+          uint32_t C(child_IDs[i][c]);
+          if(C <= i || C >= endi || has_parent[C])
+            {
+              src.fail();
+            }
+          else
+            {
+              has_parent[C] = true;
+            }
+        }
+    }
+
+  skip.resize(d->m_subsets.size());
+  for(unsigned int i = d->m_subsets.size(); i > 0 && !src.failed(); --i)
+    {
+      if(child_IDs[i - 1][0] == SubsetConstants::blob_no_child)
+        {
+          skip[i - 1] = i;
+        }
+      else if(child_IDs[i - 1][0] == i && child_IDs[i - 1][1] == skip[i])
+        {
+          skip[i - 1] = skip[child_IDs[i - 1][1]];
+        }
+      else
+        {
+          src.fail();
+        }
+    }
+
+  if(src.failed())
+    {
+      for(unsigned int i = 0, endi = d->m_subsets.size(); i < endi; ++i)
+        {
+          FASTUIDRAWdelete(d->m_subsets[i]);
+        }
+      d->m_subsets.clear();
+      FASTUIDRAWdelete(d);
+      return NULL;
+    }
+
+  for(unsigned int i = 0, endi = d->m_subsets.size(); i < endi; ++i)
+    {
+      if(child_IDs[i][0] != SubsetConstants::blob_no_child)
+        {
+          d->m_subsets[i]->set_children(d->m_subsets[child_IDs[i][0]],
+                                        d->m_subsets[child_IDs[i][1]]);
+        }
+    }
+  d->m_root = d->m_subsets[0];
+  d->m_hierarchy.set(d->m_subsets);
+  return d;
 }
 
 ///////////////////////////////
@@ -2448,6 +4167,15 @@ painter_data(void) const
   return d->painter_data();
 }
 
+fastuidraw::const_c_array<fastuidraw::FilledPath::Subset::Cluster>
+fastuidraw::FilledPath::Subset::
+clusters(unsigned int chunk) const
+{
+  SubsetPrivate *d;
+  d = static_cast<SubsetPrivate*>(m_d);
+  return d->clusters(chunk);
+}
+
 fastuidraw::const_c_array<int>
 fastuidraw::FilledPath::Subset::
 winding_numbers(void) const
@@ -2485,12 +4213,57 @@ chunk_from_fill_rule(enum PainterEnums::fill_rule_t fill_rule)
   return fill_rule;
 }
 
+const fastuidraw::PainterAttributeData&
+fastuidraw::FilledPath::Subset::
+aa_painter_data(void) const
+{
+  SubsetPrivate *d;
+  d = static_cast<SubsetPrivate*>(m_d);
+  return d->aa_painter_data();
+}
+
+unsigned int
+fastuidraw::FilledPath::Subset::
+aa_chunk_from_fill_rule(enum PainterEnums::fill_rule_t fill_rule)
+{
+  assert(fill_rule < fastuidraw::PainterEnums::fill_rule_data_count);
+  return fill_rule;
+}
+
+unsigned int
+fastuidraw::FilledPath::Subset::
+aa_chunk_from_winding_numbers(int filled_winding, int unfilled_winding)
+{
+  /* basic idea:
+     - start counting at fill_rule_data_count
+     - map each winding number w to z(w) with the ordering
+       0, 1, -1, 2, -2, ... as 0, 1, 2, 3, 4, ...
+     - the pairs (a, b) with max(z(a), z(b)) = m are the
+       2m pairs after the m(m - 1) pairs with max < m.
+   */
+  unsigned int za, zb, m, r;
+
+  assert(filled_winding != unfilled_winding);
+  za = (filled_winding > 0) ? 2 * filled_winding - 1 : -2 * filled_winding;
+  zb = (unfilled_winding > 0) ? 2 * unfilled_winding - 1 : -2 * unfilled_winding;
+  m = t_max(za, zb);
+  r = (za == m) ? zb : m + za;
+  return fastuidraw::PainterEnums::fill_rule_data_count + m * (m - 1) + r;
+}
+
 ///////////////////////////////////////
 // fastuidraw::FilledPath methods
 fastuidraw::FilledPath::
-FilledPath(const TessellatedPath &P)
+FilledPath(const TessellatedPath &P, enum triangulator_t triangulator,
+           float simplify_tolerance)
+{
+  m_d = FASTUIDRAWnew FilledPathPrivate(P, triangulator, simplify_tolerance);
+}
+
+fastuidraw::FilledPath::
+FilledPath(void *d):
+  m_d(d)
 {
-  m_d = FASTUIDRAWnew FilledPathPrivate(P);
 }
 
 fastuidraw::FilledPath::
@@ -2502,6 +4275,62 @@ fastuidraw::FilledPath::
   m_d = NULL;
 }
 
+uint32_t
+fastuidraw::FilledPath::
+blob_version(void)
+{
+  return SubsetConstants::blob_version;
+}
+
+void
+fastuidraw::FilledPath::
+serialize(std::vector<uint8_t> &dst) const
+{
+  FilledPathPrivate *d;
+  detail::BlobWriter writer;
+
+  d = static_cast<FilledPathPrivate*>(m_d);
+  d->write_to_blob(writer);
+  writer.finish(dst);
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::FilledPath>
+fastuidraw::FilledPath::
+create_from_blob(const_c_array<uint8_t> blob)
+{
+  FilledPathPrivate *d;
+
+  d = FilledPathPrivate::create_from_blob(blob);
+  if(d == NULL)
+    {
+      return reference_counted_ptr<FilledPath>();
+    }
+  return FASTUIDRAWnew FilledPath(d);
+}
+
+enum fastuidraw::FilledPath::triangulator_t
+fastuidraw::FilledPath::
+triangulator(void) const
+{
+  FilledPathPrivate *d;
+  d = static_cast<FilledPathPrivate*>(m_d);
+  return d->m_triangulator;
+}
+
+enum fastuidraw::FilledPath::triangulator_t
+fastuidraw::FilledPath::
+default_triangulator(void)
+{
+  return default_triangulator_value;
+}
+
+void
+fastuidraw::FilledPath::
+default_triangulator(enum triangulator_t v)
+{
+  default_triangulator_value = v;
+}
+
 unsigned int
 fastuidraw::FilledPath::
 number_subsets(void) const
@@ -2522,7 +4351,7 @@ subset(unsigned int I) const
   d = static_cast<FilledPathPrivate*>(m_d);
   assert(I < d->m_subsets.size());
   p = d->m_subsets[I];
-  p->make_ready();
+  p->make_ready(d->m_max_threads);
 
   return Subset(p);
 }
@@ -2534,14 +4363,19 @@ select_subsets(ScratchSpace &work_room,
                const float3x3 &clip_matrix_local,
                unsigned int max_attribute_cnt,
                unsigned int max_index_cnt,
-               c_array<unsigned int> dst) const
+               c_array<unsigned int> dst,
+               const vec2 &coarse_size) const
 {
   FilledPathPrivate *d;
   unsigned int return_value;
 
   d = static_cast<FilledPathPrivate*>(m_d);
   assert(dst.size() >= d->m_subsets.size());
-  /* TODO:
+  /* The leaves that need triangulation are triangulated in
+     parallel, with up to TessellationParams::m_max_threads
+     threads, and the call waits for them.
+
+     TODO:
        - have another method in SubsetPrivate called
          "fast_select_subsets" which ignores the requirements
          coming from max_attribute_cnt and max_index_cnt.
@@ -2561,9 +4395,31 @@ select_subsets(ScratchSpace &work_room,
          thread safe (with regards to the SubsetPrivate
          being made ready via make_ready()).
    */
-  return_value= d->m_root->select_subsets(*static_cast<ScratchSpacePrivate*>(work_room.m_d),
-                                          clip_equations, clip_matrix_local,
-                                          max_attribute_cnt, max_index_cnt, dst);
+  return_value = d->select_subsets(*static_cast<ScratchSpacePrivate*>(work_room.m_d),
+                                   clip_equations, clip_matrix_local,
+                                   max_attribute_cnt, max_index_cnt, dst,
+                                   coarse_size);
 
   return return_value;
 }
+
+int
+fastuidraw::FilledPath::
+winding_number(const vec2 &pt) const
+{
+  FilledPathPrivate *d;
+  d = static_cast<FilledPathPrivate*>(m_d);
+
+  if(!box_contains(d->m_root->bounds(), pt))
+    {
+      return 0;
+    }
+  return d->m_root->winding_number_at(pt);
+}
+
+bool
+fastuidraw::FilledPath::
+hit_test(const vec2 &pt, enum PainterEnums::fill_rule_t fill_rule) const
+{
+  return winding_number_is_filled(winding_number(pt), fill_rule);
+}
@@ -0,0 +1,650 @@
+/*!
+ * \file glyph_run.cpp
+ * \brief file glyph_run.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <algorithm>
+#include <vector>
+#include <fastuidraw/util/fastuidraw_memory.hpp>
+#include <fastuidraw/painter/glyph_run.hpp>
+#include "../private/util_private.hpp"
+#include "private/glyph_attribute_packing.hpp"
+
+namespace
+{
+  enum
+    {
+      /* glyph is not valid, i.e. has no data to draw */
+      glyph_not_drawn = -1,
+
+      /* glyph failed to upload to its GlyphCache */
+      glyph_not_uploaded = -2,
+    };
+
+  /* The values of a GlyphLocation; a GlyphLocation itself
+     cannot be kept to compare against later because the
+     region it refers to is freed when the glyph is removed
+     from or moved within the GlyphAtlas.
+   */
+  class LocationValues
+  {
+  public:
+    LocationValues(void):
+      m_location(-1, -1),
+      m_layer(-1),
+      m_size(-1, -1)
+    {}
+
+    explicit
+    LocationValues(const fastuidraw::GlyphLocation &L):
+      m_location(L.location()),
+      m_layer(L.layer()),
+      m_size(L.size())
+    {}
+
+    bool
+    operator==(const LocationValues &rhs) const
+    {
+      return m_location == rhs.m_location
+        && m_layer == rhs.m_layer
+        && m_size == rhs.m_size;
+    }
+
+    fastuidraw::ivec2 m_location;
+    int m_layer;
+    fastuidraw::ivec2 m_size;
+  };
+
+  class GlyphEntry
+  {
+  public:
+    fastuidraw::Glyph m_glyph;
+    fastuidraw::vec2 m_position;
+    float m_scale;
+
+    /* glyph type, i.e. chunk, in which the glyph is
+       packed or glyph_not_drawn/glyph_not_uploaded
+     */
+    int m_type;
+
+    /* slot within the chunk of m_type */
+    unsigned int m_slot;
+
+    /* atlas locations from which the glyph was packed */
+    LocationValues m_atlas_location;
+    LocationValues m_secondary_atlas_location;
+    int m_geometry_offset;
+  };
+
+  /* A TypeRegion gives the range of slots of those
+     glyphs of one glyph type; the attributes of the
+     glyph in slot s are at
+     m_attributes[N * (m_begin + s), N * (m_begin + s + 1))
+     where N is GlyphRunPrivate::m_attributes_per_glyph.
+   */
+  class TypeRegion
+  {
+  public:
+    TypeRegion(void):
+      m_begin(0),
+      m_capacity(0)
+    {}
+
+    unsigned int m_begin, m_capacity;
+
+    /* m_owners[s] is the index into GlyphRunPrivate::m_pool
+       of the glyph in slot s.
+     */
+    std::vector<unsigned int> m_owners;
+  };
+
+  class GlyphRunPrivate
+  {
+  public:
+    explicit
+    GlyphRunPrivate(enum fastuidraw::PainterEnums::glyph_orientation orientation,
+                    bool instanced):
+      m_orientation(orientation),
+      m_instanced(instanced),
+      m_attributes_per_glyph(instanced ? 1 : 4),
+      m_number_not_uploaded(0),
+      m_data_dirty(false)
+    {}
+
+    void
+    replace(unsigned int begin, unsigned int count,
+            fastuidraw::const_c_array<fastuidraw::vec2> glyph_positions,
+            fastuidraw::const_c_array<fastuidraw::Glyph> glyphs,
+            float render_pixel_size);
+
+    void
+    refresh_atlas_locations(void);
+
+    void
+    ready_data(void);
+
+  private:
+    unsigned int
+    allocate_entry(void);
+
+    void
+    add_to_attributes(unsigned int id);
+
+    void
+    remove_from_attributes(unsigned int id);
+
+    void
+    pack_entry(unsigned int id);
+
+    void
+    ensure_capacity(unsigned int type);
+
+  public:
+    enum fastuidraw::PainterEnums::glyph_orientation m_orientation;
+
+    /* if true, each glyph is a single instance and there are no indices */
+    bool m_instanced;
+    unsigned int m_attributes_per_glyph;
+
+    /* the glyphs in order, values are indices into m_pool */
+    std::vector<unsigned int> m_sequence;
+
+    /* entries of m_pool are stable across edits so that
+       TypeRegion::m_owners does not need to change when
+       glyphs are inserted or removed from m_sequence.
+     */
+    std::vector<GlyphEntry> m_pool;
+    std::vector<unsigned int> m_free_entries;
+
+    std::vector<fastuidraw::PainterAttribute> m_attributes;
+    std::vector<TypeRegion> m_regions;
+    unsigned int m_number_not_uploaded;
+
+    /* the indices of the glyph in slot s of every
+       chunk are the same, so all index chunks are
+       a prefix of m_indices.
+     */
+    std::vector<fastuidraw::PainterIndex> m_indices;
+
+    std::vector<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > m_attribute_chunks;
+    std::vector<fastuidraw::const_c_array<fastuidraw::PainterIndex> > m_index_chunks;
+    fastuidraw::PainterAttributeData m_data;
+    bool m_data_dirty;
+  };
+}
+
+///////////////////////////////////
+// GlyphRunPrivate methods
+unsigned int
+GlyphRunPrivate::
+allocate_entry(void)
+{
+  unsigned int return_value;
+
+  if(m_free_entries.empty())
+    {
+      return_value = m_pool.size();
+      m_pool.push_back(GlyphEntry());
+    }
+  else
+    {
+      return_value = m_free_entries.back();
+      m_free_entries.pop_back();
+    }
+  return return_value;
+}
+
+void
+GlyphRunPrivate::
+ensure_capacity(unsigned int type)
+{
+  if(type >= m_regions.size())
+    {
+      m_regions.resize(type + 1);
+    }
+
+  if(m_regions[type].m_owners.size() < m_regions[type].m_capacity)
+    {
+      return;
+    }
+
+  /* relayout all regions, doubling the capacity of the
+     region that is full; this is the only operation that
+     touches glyphs outside of an edited span and it
+     happens O(log N) times as a GlyphRun grows to N
+     glyphs.
+   */
+  std::vector<fastuidraw::PainterAttribute> attributes;
+  unsigned int total(0), max_capacity(0);
+
+  m_regions[type].m_capacity = std::max(8u, 2u * m_regions[type].m_capacity);
+  for(unsigned int t = 0, endt = m_regions.size(); t < endt; ++t)
+    {
+      total += m_regions[t].m_capacity;
+      max_capacity = std::max(max_capacity, m_regions[t].m_capacity);
+    }
+
+  attributes.resize(m_attributes_per_glyph * total);
+  for(unsigned int t = 0, b = 0, endt = m_regions.size(); t < endt; ++t)
+    {
+      TypeRegion &R(m_regions[t]);
+      if(!R.m_owners.empty())
+        {
+          std::copy(m_attributes.begin() + m_attributes_per_glyph * R.m_begin,
+                    m_attributes.begin() + m_attributes_per_glyph * (R.m_begin + R.m_owners.size()),
+                    attributes.begin() + m_attributes_per_glyph * b);
+        }
+      R.m_begin = b;
+      b += R.m_capacity;
+    }
+  m_attributes.swap(attributes);
+
+  if(!m_instanced && m_indices.size() < 6 * max_capacity)
+    {
+      unsigned int s(m_indices.size() / 6);
+
+      m_indices.resize(6 * max_capacity);
+      for(; s < max_capacity; ++s)
+        {
+          fastuidraw::detail::pack_glyph_indices(fastuidraw::make_c_array(m_indices).sub_array(6 * s, 6), 4 * s);
+        }
+    }
+}
+
+void
+GlyphRunPrivate::
+pack_entry(unsigned int id)
+{
+  GlyphEntry &E(m_pool[id]);
+  const TypeRegion &R(m_regions[E.m_type]);
+
+  assert(E.m_type >= 0);
+  E.m_atlas_location = LocationValues(E.m_glyph.atlas_location());
+  E.m_secondary_atlas_location = LocationValues(E.m_glyph.secondary_atlas_location());
+  E.m_geometry_offset = E.m_glyph.geometry_offset();
+  if(m_instanced)
+    {
+      fastuidraw::detail::pack_glyph_instance(m_orientation, E.m_position, E.m_glyph, E.m_scale,
+                                              m_attributes[R.m_begin + E.m_slot]);
+    }
+  else
+    {
+      fastuidraw::detail::pack_glyph_attributes(m_orientation, E.m_position, E.m_glyph, E.m_scale,
+                                                fastuidraw::make_c_array(m_attributes).sub_array(4 * (R.m_begin + E.m_slot), 4));
+    }
+}
+
+void
+GlyphRunPrivate::
+add_to_attributes(unsigned int id)
+{
+  GlyphEntry &E(m_pool[id]);
+  unsigned int t;
+
+  if(!E.m_glyph.valid())
+    {
+      E.m_type = glyph_not_drawn;
+      return;
+    }
+
+  if(E.m_glyph.upload_to_atlas() != fastuidraw::routine_success)
+    {
+      E.m_type = glyph_not_uploaded;
+      ++m_number_not_uploaded;
+      return;
+    }
+
+  t = E.m_glyph.type();
+  ensure_capacity(t);
+  E.m_type = t;
+  E.m_slot = m_regions[t].m_owners.size();
+  m_regions[t].m_owners.push_back(id);
+  pack_entry(id);
+}
+
+void
+GlyphRunPrivate::
+remove_from_attributes(unsigned int id)
+{
+  GlyphEntry &E(m_pool[id]);
+
+  if(E.m_type == glyph_not_uploaded)
+    {
+      assert(m_number_not_uploaded > 0);
+      --m_number_not_uploaded;
+    }
+
+  if(E.m_type < 0)
+    {
+      E.m_type = glyph_not_drawn;
+      return;
+    }
+
+  /* move the glyph of the last slot into the
+     slot of the removed glyph.
+   */
+  TypeRegion &R(m_regions[E.m_type]);
+  unsigned int last(R.m_owners.size() - 1);
+
+  assert(E.m_slot <= last && R.m_owners[E.m_slot] == id);
+  if(E.m_slot != last)
+    {
+      unsigned int moved(R.m_owners[last]);
+
+      std::copy(m_attributes.begin() + m_attributes_per_glyph * (R.m_begin + last),
+                m_attributes.begin() + m_attributes_per_glyph * (R.m_begin + last + 1),
+                m_attributes.begin() + m_attributes_per_glyph * (R.m_begin + E.m_slot));
+      R.m_owners[E.m_slot] = moved;
+      m_pool[moved].m_slot = E.m_slot;
+    }
+  R.m_owners.pop_back();
+  E.m_type = glyph_not_drawn;
+}
+
+void
+GlyphRunPrivate::
+replace(unsigned int begin, unsigned int count,
+        fastuidraw::const_c_array<fastuidraw::vec2> glyph_positions,
+        fastuidraw::const_c_array<fastuidraw::Glyph> glyphs,
+        float render_pixel_size)
+{
+  std::vector<unsigned int> ids(glyphs.size());
+
+  assert(glyph_positions.size() == glyphs.size());
+  assert(begin + count <= m_sequence.size());
+
+  for(unsigned int i = begin; i < begin + count; ++i)
+    {
+      remove_from_attributes(m_sequence[i]);
+      m_pool[m_sequence[i]].m_glyph = fastuidraw::Glyph();
+      m_free_entries.push_back(m_sequence[i]);
+    }
+
+  for(unsigned int i = 0, endi = glyphs.size(); i < endi; ++i)
+    {
+      GlyphEntry *E;
+
+      ids[i] = allocate_entry();
+      E = &m_pool[ids[i]];
+      E->m_glyph = glyphs[i];
+      E->m_position = glyph_positions[i];
+      E->m_scale = (glyphs[i].valid()) ?
+        render_pixel_size / glyphs[i].layout().m_pixel_size :
+        1.0f;
+      add_to_attributes(ids[i]);
+    }
+
+  if(count == ids.size())
+    {
+      std::copy(ids.begin(), ids.end(), m_sequence.begin() + begin);
+    }
+  else
+    {
+      m_sequence.erase(m_sequence.begin() + begin, m_sequence.begin() + begin + count);
+      m_sequence.insert(m_sequence.begin() + begin, ids.begin(), ids.end());
+    }
+  m_data_dirty = true;
+}
+
+void
+GlyphRunPrivate::
+refresh_atlas_locations(void)
+{
+  for(std::vector<unsigned int>::const_iterator iter = m_sequence.begin(),
+        end = m_sequence.end(); iter != end; ++iter)
+    {
+      GlyphEntry &E(m_pool[*iter]);
+
+      if(E.m_type == glyph_not_uploaded)
+        {
+          --m_number_not_uploaded;
+          add_to_attributes(*iter);
+          m_data_dirty = true;
+        }
+      else if(E.m_type >= 0)
+        {
+          if(E.m_glyph.upload_to_atlas() != fastuidraw::routine_success)
+            {
+              remove_from_attributes(*iter);
+              E.m_type = glyph_not_uploaded;
+              ++m_number_not_uploaded;
+              m_data_dirty = true;
+            }
+          else if(!(E.m_atlas_location == LocationValues(E.m_glyph.atlas_location()))
+                  || !(E.m_secondary_atlas_location == LocationValues(E.m_glyph.secondary_atlas_location()))
+                  || E.m_geometry_offset != E.m_glyph.geometry_offset())
+            {
+              pack_entry(*iter);
+              m_data_dirty = true;
+            }
+        }
+    }
+}
+
+void
+GlyphRunPrivate::
+ready_data(void)
+{
+  if(!m_data_dirty)
+    {
+      return;
+    }
+
+  fastuidraw::const_c_array<fastuidraw::PainterAttribute> attribute_store(fastuidraw::make_c_array(m_attributes));
+  fastuidraw::const_c_array<fastuidraw::PainterIndex> index_store(fastuidraw::make_c_array(m_indices));
+
+  m_attribute_chunks.resize(m_regions.size());
+  m_index_chunks.resize(m_regions.size());
+  for(unsigned int t = 0, endt = m_regions.size(); t < endt; ++t)
+    {
+      const TypeRegion &R(m_regions[t]);
+      unsigned int cnt(R.m_owners.size());
+
+      if(cnt > 0)
+        {
+          m_attribute_chunks[t] = attribute_store.sub_array(m_attributes_per_glyph * R.m_begin,
+                                                            m_attributes_per_glyph * cnt);
+          m_index_chunks[t] = (m_instanced) ?
+            fastuidraw::const_c_array<fastuidraw::PainterIndex>() :
+            index_store.sub_array(0, 6 * cnt);
+        }
+      else
+        {
+          m_attribute_chunks[t] = fastuidraw::const_c_array<fastuidraw::PainterAttribute>();
+          m_index_chunks[t] = fastuidraw::const_c_array<fastuidraw::PainterIndex>();
+        }
+    }
+
+  fastuidraw::detail::set_painter_attribute_data_chunks(m_data, attribute_store, index_store,
+                                                        fastuidraw::make_c_array(m_attribute_chunks),
+                                                        fastuidraw::make_c_array(m_index_chunks));
+  m_data_dirty = false;
+}
+
+//////////////////////////////////////
+// fastuidraw::GlyphRun methods
+fastuidraw::GlyphRun::
+GlyphRun(enum PainterEnums::glyph_orientation orientation, bool instanced)
+{
+  m_d = FASTUIDRAWnew GlyphRunPrivate(orientation, instanced);
+}
+
+fastuidraw::GlyphRun::
+~GlyphRun()
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+enum fastuidraw::PainterEnums::glyph_orientation
+fastuidraw::GlyphRun::
+orientation(void) const
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  return d->m_orientation;
+}
+
+bool
+fastuidraw::GlyphRun::
+instanced(void) const
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  return d->m_instanced;
+}
+
+unsigned int
+fastuidraw::GlyphRun::
+number_glyphs(void) const
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  return d->m_sequence.size();
+}
+
+unsigned int
+fastuidraw::GlyphRun::
+number_glyphs_not_uploaded(void) const
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  return d->m_number_not_uploaded;
+}
+
+fastuidraw::Glyph
+fastuidraw::GlyphRun::
+glyph(unsigned int I) const
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  assert(I < d->m_sequence.size());
+  return d->m_pool[d->m_sequence[I]].m_glyph;
+}
+
+fastuidraw::vec2
+fastuidraw::GlyphRun::
+glyph_position(unsigned int I) const
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  assert(I < d->m_sequence.size());
+  return d->m_pool[d->m_sequence[I]].m_position;
+}
+
+float
+fastuidraw::GlyphRun::
+render_pixel_size(unsigned int I) const
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  assert(I < d->m_sequence.size());
+
+  const GlyphEntry &E(d->m_pool[d->m_sequence[I]]);
+  return (E.m_glyph.valid()) ?
+    E.m_scale * static_cast<float>(E.m_glyph.layout().m_pixel_size) :
+    E.m_scale;
+}
+
+void
+fastuidraw::GlyphRun::
+replace(unsigned int begin, unsigned int count,
+        const_c_array<vec2> glyph_positions,
+        const_c_array<Glyph> glyphs,
+        float render_pixel_size)
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  d->replace(begin, count, glyph_positions, glyphs, render_pixel_size);
+}
+
+void
+fastuidraw::GlyphRun::
+replace(unsigned int begin, unsigned int count,
+        GlyphCache &cache, GlyphRender render,
+        const reference_counted_ptr<const FontBase> &font,
+        const_c_array<vec2> glyph_positions,
+        const_c_array<uint32_t> glyph_codes,
+        float render_pixel_size)
+{
+  GlyphRunPrivate *d;
+  std::vector<Glyph> glyphs(glyph_codes.size());
+
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  for(unsigned int i = 0, endi = glyph_codes.size(); i < endi; ++i)
+    {
+      glyphs[i] = cache.fetch_glyph(render, font, glyph_codes[i]);
+    }
+  d->replace(begin, count, glyph_positions, make_c_array(glyphs), render_pixel_size);
+}
+
+void
+fastuidraw::GlyphRun::
+append(const_c_array<vec2> glyph_positions,
+       const_c_array<Glyph> glyphs,
+       float render_pixel_size)
+{
+  replace(number_glyphs(), 0, glyph_positions, glyphs, render_pixel_size);
+}
+
+void
+fastuidraw::GlyphRun::
+append(GlyphCache &cache, GlyphRender render,
+       const reference_counted_ptr<const FontBase> &font,
+       const_c_array<vec2> glyph_positions,
+       const_c_array<uint32_t> glyph_codes,
+       float render_pixel_size)
+{
+  replace(number_glyphs(), 0, cache, render, font,
+          glyph_positions, glyph_codes, render_pixel_size);
+}
+
+void
+fastuidraw::GlyphRun::
+erase(unsigned int begin, unsigned int count)
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  d->replace(begin, count, const_c_array<vec2>(), const_c_array<Glyph>(), 1.0f);
+}
+
+void
+fastuidraw::GlyphRun::
+clear(void)
+{
+  erase(0, number_glyphs());
+}
+
+void
+fastuidraw::GlyphRun::
+refresh_atlas_locations(void)
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  d->refresh_atlas_locations();
+}
+
+const fastuidraw::PainterAttributeData&
+fastuidraw::GlyphRun::
+data(void) const
+{
+  GlyphRunPrivate *d;
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  d->ready_data();
+  return d->m_data;
+}
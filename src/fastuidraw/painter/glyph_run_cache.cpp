@@ -0,0 +1,393 @@
+/*!
+ * \file glyph_run_cache.cpp
+ * \brief file glyph_run_cache.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <algorithm>
+#include <vector>
+#include <list>
+#include <map>
+#include <fastuidraw/painter/glyph_run_cache.hpp>
+#include "../private/util_private.hpp"
+
+namespace
+{
+  class RunEntry;
+
+  /* The key of a laid out string; the hash of the string
+     is compared first so that the string itself is only
+     compared when everything else matches.
+   */
+  class RunKey
+  {
+  public:
+    RunKey(fastuidraw::const_c_array<uint32_t> text,
+           fastuidraw::GlyphSelector::FontGroup group,
+           fastuidraw::GlyphRender render, float pixel_size,
+           enum fastuidraw::PainterEnums::glyph_orientation orientation,
+           bool instanced):
+      m_hash(compute_hash(text)),
+      m_group(group),
+      m_render(render),
+      m_pixel_size(pixel_size),
+      m_orientation(orientation),
+      m_instanced(instanced),
+      m_text(text.begin(), text.end())
+    {}
+
+    bool
+    operator<(const RunKey &rhs) const
+    {
+      if(m_hash != rhs.m_hash)
+        {
+          return m_hash < rhs.m_hash;
+        }
+
+      if(!(m_group == rhs.m_group))
+        {
+          return m_group < rhs.m_group;
+        }
+
+      if(!(m_render == rhs.m_render))
+        {
+          return m_render < rhs.m_render;
+        }
+
+      if(m_pixel_size != rhs.m_pixel_size)
+        {
+          return m_pixel_size < rhs.m_pixel_size;
+        }
+
+      if(m_orientation != rhs.m_orientation)
+        {
+          return m_orientation < rhs.m_orientation;
+        }
+
+      if(m_instanced != rhs.m_instanced)
+        {
+          return m_instanced < rhs.m_instanced;
+        }
+
+      return m_text < rhs.m_text;
+    }
+
+    /* FNV-1a of the character codes */
+    static
+    uint64_t
+    compute_hash(fastuidraw::const_c_array<uint32_t> text)
+    {
+      uint64_t v(0xCBF29CE484222325ull);
+      for(unsigned int i = 0; i < text.size(); ++i)
+        {
+          v ^= static_cast<uint64_t>(text[i]);
+          v *= 0x100000001B3ull;
+        }
+      return v;
+    }
+
+    uint64_t m_hash;
+    fastuidraw::GlyphSelector::FontGroup m_group;
+    fastuidraw::GlyphRender m_render;
+    float m_pixel_size;
+    enum fastuidraw::PainterEnums::glyph_orientation m_orientation;
+    bool m_instanced;
+    std::vector<uint32_t> m_text;
+  };
+
+  typedef std::map<RunKey, RunEntry*> RunMap;
+  typedef std::list<RunEntry*> RunList;
+
+  class RunEntry:fastuidraw::noncopyable
+  {
+  public:
+    RunEntry(enum fastuidraw::PainterEnums::glyph_orientation orientation,
+             bool instanced):
+      m_run(orientation, instanced)
+    {}
+
+    /* returns true if any glyph of m_run was removed
+       from its GlyphCache since the layout
+     */
+    bool
+    glyphs_removed(void) const;
+
+    fastuidraw::GlyphRun m_run;
+    fastuidraw::GlyphRunCache::Metrics m_metrics;
+
+    /* Glyph::generation() of each glyph of m_run
+       at the time of the layout
+     */
+    std::vector<unsigned int> m_generations;
+
+    RunMap::iterator m_map_location;
+    RunList::iterator m_list_location;
+  };
+
+  class GlyphRunCachePrivate
+  {
+  public:
+    GlyphRunCachePrivate(const fastuidraw::reference_counted_ptr<fastuidraw::GlyphSelector> &selector,
+                         unsigned int max_number_runs):
+      m_selector(selector),
+      m_max_number_runs(std::max(1u, max_number_runs)),
+      m_stats(0)
+    {}
+
+    ~GlyphRunCachePrivate()
+    {
+      clear();
+    }
+
+    void
+    clear(void);
+
+    void
+    shrink(unsigned int max_number_runs);
+
+    void
+    layout(const RunKey &key, RunEntry *entry);
+
+    fastuidraw::reference_counted_ptr<fastuidraw::GlyphSelector> m_selector;
+    unsigned int m_max_number_runs;
+
+    RunMap m_map;
+
+    /* most recently fetched first */
+    RunList m_list;
+
+    fastuidraw::vecN<unsigned int, fastuidraw::GlyphRunCache::num_stats> m_stats;
+
+    /* work rooms for layout() */
+    std::vector<fastuidraw::Glyph> m_work_room_glyphs;
+    std::vector<fastuidraw::vec2> m_work_room_positions;
+  };
+}
+
+/////////////////////////////////////
+// RunEntry methods
+bool
+RunEntry::
+glyphs_removed(void) const
+{
+  assert(m_generations.size() == m_run.number_glyphs());
+  for(unsigned int i = 0, endi = m_run.number_glyphs(); i < endi; ++i)
+    {
+      fastuidraw::Glyph G(m_run.glyph(i));
+      if(G.valid() && G.generation() != m_generations[i])
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+/////////////////////////////////////
+// GlyphRunCachePrivate methods
+void
+GlyphRunCachePrivate::
+clear(void)
+{
+  for(RunList::iterator iter = m_list.begin(); iter != m_list.end(); ++iter)
+    {
+      FASTUIDRAWdelete(*iter);
+    }
+  m_list.clear();
+  m_map.clear();
+}
+
+void
+GlyphRunCachePrivate::
+shrink(unsigned int max_number_runs)
+{
+  while(m_list.size() > max_number_runs)
+    {
+      RunEntry *E(m_list.back());
+
+      m_map.erase(E->m_map_location);
+      m_list.pop_back();
+      FASTUIDRAWdelete(E);
+    }
+}
+
+void
+GlyphRunCachePrivate::
+layout(const RunKey &key, RunEntry *entry)
+{
+  unsigned int sz(key.m_text.size());
+  fastuidraw::vec2 pen(0.0f, 0.0f);
+  fastuidraw::GlyphRunCache::Metrics &metrics(entry->m_metrics);
+
+  m_work_room_glyphs.resize(sz);
+  m_work_room_positions.resize(sz);
+  entry->m_generations.resize(sz);
+  m_selector->create_glyph_sequence(key.m_render, key.m_group,
+                                    key.m_text.begin(), key.m_text.end(),
+                                    m_work_room_glyphs.begin());
+
+  metrics = fastuidraw::GlyphRunCache::Metrics();
+  for(unsigned int i = 0; i < sz; ++i)
+    {
+      const fastuidraw::Glyph &G(m_work_room_glyphs[i]);
+
+      m_work_room_positions[i] = pen;
+      entry->m_generations[i] = 0;
+      if(G.valid())
+        {
+          const fastuidraw::GlyphLayoutData &L(G.layout());
+          float ratio;
+
+          ratio = key.m_pixel_size / static_cast<float>(L.m_pixel_size);
+          pen.x() += ratio * L.m_advance.x();
+          metrics.m_ascent = std::max(metrics.m_ascent,
+                                      ratio * (L.m_horizontal_layout_offset.y() + L.m_size.y()));
+          metrics.m_descent = std::min(metrics.m_descent,
+                                       ratio * L.m_horizontal_layout_offset.y());
+          entry->m_generations[i] = G.generation();
+        }
+    }
+  metrics.m_advance = pen.x();
+
+  entry->m_run.clear();
+  entry->m_run.append(fastuidraw::make_c_array(m_work_room_positions),
+                      fastuidraw::make_c_array(m_work_room_glyphs),
+                      key.m_pixel_size);
+}
+
+/////////////////////////////////////
+// fastuidraw::GlyphRunCache methods
+fastuidraw::GlyphRunCache::
+GlyphRunCache(const reference_counted_ptr<GlyphSelector> &selector,
+              unsigned int max_number_runs)
+{
+  m_d = FASTUIDRAWnew GlyphRunCachePrivate(selector, max_number_runs);
+}
+
+fastuidraw::GlyphRunCache::
+~GlyphRunCache()
+{
+  GlyphRunCachePrivate *d;
+  d = static_cast<GlyphRunCachePrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+unsigned int
+fastuidraw::GlyphRunCache::
+max_number_runs(void) const
+{
+  GlyphRunCachePrivate *d;
+  d = static_cast<GlyphRunCachePrivate*>(m_d);
+  return d->m_max_number_runs;
+}
+
+void
+fastuidraw::GlyphRunCache::
+max_number_runs(unsigned int v)
+{
+  GlyphRunCachePrivate *d;
+  d = static_cast<GlyphRunCachePrivate*>(m_d);
+  d->m_max_number_runs = std::max(1u, v);
+  d->shrink(d->m_max_number_runs);
+}
+
+unsigned int
+fastuidraw::GlyphRunCache::
+number_runs(void) const
+{
+  GlyphRunCachePrivate *d;
+  d = static_cast<GlyphRunCachePrivate*>(m_d);
+  return d->m_map.size();
+}
+
+const fastuidraw::GlyphRun&
+fastuidraw::GlyphRunCache::
+fetch_run(const_c_array<uint32_t> text,
+          GlyphSelector::FontGroup group,
+          GlyphRender render, float pixel_size,
+          enum PainterEnums::glyph_orientation orientation,
+          bool instanced, Metrics *out_metrics)
+{
+  GlyphRunCachePrivate *d;
+  d = static_cast<GlyphRunCachePrivate*>(m_d);
+
+  RunKey key(text, group, render, pixel_size, orientation, instanced);
+  RunMap::iterator iter;
+  RunEntry *E;
+
+  iter = d->m_map.find(key);
+  if(iter != d->m_map.end())
+    {
+      E = iter->second;
+      d->m_list.splice(d->m_list.begin(), d->m_list, E->m_list_location);
+      if(E->glyphs_removed())
+        {
+          FASTUIDRAWincrement_stat(d->m_stats[num_invalidations], 1u);
+          d->layout(key, E);
+        }
+      else
+        {
+          FASTUIDRAWincrement_stat(d->m_stats[num_hits], 1u);
+          E->m_run.refresh_atlas_locations();
+        }
+    }
+  else
+    {
+      /* make room first so that the new entry
+         is never the one discarded
+       */
+      FASTUIDRAWincrement_stat(d->m_stats[num_misses], 1u);
+      d->shrink(d->m_max_number_runs - 1u);
+
+      E = FASTUIDRAWnew RunEntry(orientation, instanced);
+      d->m_list.push_front(E);
+      E->m_list_location = d->m_list.begin();
+      E->m_map_location = d->m_map.insert(std::make_pair(key, E)).first;
+      d->layout(key, E);
+    }
+
+  if(out_metrics)
+    {
+      *out_metrics = E->m_metrics;
+    }
+  return E->m_run;
+}
+
+void
+fastuidraw::GlyphRunCache::
+clear(void)
+{
+  GlyphRunCachePrivate *d;
+  d = static_cast<GlyphRunCachePrivate*>(m_d);
+  d->clear();
+}
+
+unsigned int
+fastuidraw::GlyphRunCache::
+query_stat(enum stats_t st) const
+{
+  GlyphRunCachePrivate *d;
+  d = static_cast<GlyphRunCachePrivate*>(m_d);
+  return d->m_stats[st];
+}
+
+void
+fastuidraw::GlyphRunCache::
+reset_stats(void)
+{
+  GlyphRunCachePrivate *d;
+  d = static_cast<GlyphRunCachePrivate*>(m_d);
+  d->m_stats = vecN<unsigned int, num_stats>(0);
+}
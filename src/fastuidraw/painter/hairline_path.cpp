@@ -0,0 +1,199 @@
+/*!
+ * \file hairline_path.cpp
+ * \brief file hairline_path.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <vector>
+#include <fastuidraw/util/fastuidraw_memory.hpp>
+#include <fastuidraw/painter/hairline_path.hpp>
+#include "../private/util_private.hpp"
+
+namespace
+{
+  class HairlinePathPrivate
+  {
+  public:
+    HairlinePathPrivate(void):
+      m_have_current(false)
+    {}
+
+    void
+    add_segment(const fastuidraw::vec2 &p0, const fastuidraw::vec2 &p1);
+
+    std::vector<fastuidraw::PainterAttribute> m_segments;
+    bool m_have_current;
+    fastuidraw::vec2 m_current;
+    fastuidraw::vec2 m_min, m_max;
+  };
+}
+
+void
+HairlinePathPrivate::
+add_segment(const fastuidraw::vec2 &p0, const fastuidraw::vec2 &p1)
+{
+  fastuidraw::PainterAttribute A;
+
+  A.m_attrib0 = fastuidraw::pack_vec4(p0.x(), p0.y(), p1.x(), p1.y());
+  A.m_attrib1 = fastuidraw::uvec4(0u, 0u, 0u, 0u);
+  A.m_attrib2 = fastuidraw::uvec4(0u, 0u, 0u, 0u);
+
+  if(m_segments.empty())
+    {
+      m_min = p0;
+      m_max = p0;
+    }
+  m_min.x() = fastuidraw::t_min(m_min.x(), fastuidraw::t_min(p0.x(), p1.x()));
+  m_min.y() = fastuidraw::t_min(m_min.y(), fastuidraw::t_min(p0.y(), p1.y()));
+  m_max.x() = fastuidraw::t_max(m_max.x(), fastuidraw::t_max(p0.x(), p1.x()));
+  m_max.y() = fastuidraw::t_max(m_max.y(), fastuidraw::t_max(p0.y(), p1.y()));
+  m_segments.push_back(A);
+}
+
+///////////////////////////////////////////
+// fastuidraw::HairlinePath methods
+fastuidraw::HairlinePath::
+HairlinePath(void)
+{
+  m_d = FASTUIDRAWnew HairlinePathPrivate();
+}
+
+fastuidraw::HairlinePath::
+~HairlinePath()
+{
+  HairlinePathPrivate *d;
+  d = static_cast<HairlinePathPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+fastuidraw::HairlinePath&
+fastuidraw::HairlinePath::
+move_to(const vec2 &pt)
+{
+  HairlinePathPrivate *d;
+  d = static_cast<HairlinePathPrivate*>(m_d);
+  d->m_have_current = true;
+  d->m_current = pt;
+  return *this;
+}
+
+fastuidraw::HairlinePath&
+fastuidraw::HairlinePath::
+line_to(const vec2 &pt)
+{
+  HairlinePathPrivate *d;
+  d = static_cast<HairlinePathPrivate*>(m_d);
+  if(d->m_have_current)
+    {
+      d->add_segment(d->m_current, pt);
+    }
+  d->m_have_current = true;
+  d->m_current = pt;
+  return *this;
+}
+
+fastuidraw::HairlinePath&
+fastuidraw::HairlinePath::
+line_to(const_c_array<vec2> pts)
+{
+  HairlinePathPrivate *d;
+  d = static_cast<HairlinePathPrivate*>(m_d);
+
+  if(pts.empty())
+    {
+      return *this;
+    }
+
+  d->m_segments.reserve(d->m_segments.size() + pts.size());
+  for(unsigned int i = 0; i < pts.size(); ++i)
+    {
+      line_to(pts[i]);
+    }
+  return *this;
+}
+
+void
+fastuidraw::HairlinePath::
+clear(void)
+{
+  HairlinePathPrivate *d;
+  d = static_cast<HairlinePathPrivate*>(m_d);
+  d->m_segments.clear();
+  d->m_have_current = false;
+}
+
+fastuidraw::const_c_array<fastuidraw::PainterAttribute>
+fastuidraw::HairlinePath::
+segments(void) const
+{
+  HairlinePathPrivate *d;
+  d = static_cast<HairlinePathPrivate*>(m_d);
+  return make_c_array(d->m_segments);
+}
+
+bool
+fastuidraw::HairlinePath::
+empty(void) const
+{
+  HairlinePathPrivate *d;
+  d = static_cast<HairlinePathPrivate*>(m_d);
+  return d->m_segments.empty();
+}
+
+const fastuidraw::vec2&
+fastuidraw::HairlinePath::
+bounding_box_min(void) const
+{
+  HairlinePathPrivate *d;
+  d = static_cast<HairlinePathPrivate*>(m_d);
+  return d->m_min;
+}
+
+const fastuidraw::vec2&
+fastuidraw::HairlinePath::
+bounding_box_max(void) const
+{
+  HairlinePathPrivate *d;
+  d = static_cast<HairlinePathPrivate*>(m_d);
+  return d->m_max;
+}
+
+void
+fastuidraw::HairlinePath::
+expand_segment(const PainterAttribute &segment,
+               c_array<PainterAttribute> dst)
+{
+  assert(dst.size() == 4);
+  for(unsigned int c = 0; c < 4; ++c)
+    {
+      dst[c] = segment;
+      dst[c].m_attrib2.w() = c;
+    }
+}
+
+void
+fastuidraw::HairlinePath::
+pack_segment_indices(c_array<PainterIndex> dst,
+                     PainterIndex first)
+{
+  assert(dst.size() == 6);
+  dst[0] = first;
+  dst[1] = first + 1;
+  dst[2] = first + 2;
+  dst[3] = first;
+  dst[4] = first + 2;
+  dst[5] = first + 3;
+}
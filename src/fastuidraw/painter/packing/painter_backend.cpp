@@ -25,10 +25,18 @@ namespace
   {
   public:
     PerformanceHintsPrivate(void):
-      m_clipping_via_hw_clip_planes(true)
+      m_clipping_via_hw_clip_planes(true),
+      m_stencil_coverage(false),
+      m_stencil_clipping(false),
+      m_instanced_quads(false),
+      m_rounded_rect_clipping(false)
     {}
 
     bool m_clipping_via_hw_clip_planes;
+    bool m_stencil_coverage;
+    bool m_stencil_clipping;
+    bool m_instanced_quads;
+    bool m_rounded_rect_clipping;
   };
 
   class PainterBackendPrivate
@@ -105,6 +113,82 @@ clipping_via_hw_clip_planes(bool v)
   return *this;
 }
 
+bool
+fastuidraw::PainterBackend::PerformanceHints::
+stencil_coverage(void) const
+{
+  PerformanceHintsPrivate *d;
+  d = static_cast<PerformanceHintsPrivate*>(m_d);
+  return d->m_stencil_coverage;
+}
+
+fastuidraw::PainterBackend::PerformanceHints&
+fastuidraw::PainterBackend::PerformanceHints::
+stencil_coverage(bool v)
+{
+  PerformanceHintsPrivate *d;
+  d = static_cast<PerformanceHintsPrivate*>(m_d);
+  d->m_stencil_coverage = v;
+  return *this;
+}
+
+bool
+fastuidraw::PainterBackend::PerformanceHints::
+stencil_clipping(void) const
+{
+  PerformanceHintsPrivate *d;
+  d = static_cast<PerformanceHintsPrivate*>(m_d);
+  return d->m_stencil_clipping;
+}
+
+fastuidraw::PainterBackend::PerformanceHints&
+fastuidraw::PainterBackend::PerformanceHints::
+stencil_clipping(bool v)
+{
+  PerformanceHintsPrivate *d;
+  d = static_cast<PerformanceHintsPrivate*>(m_d);
+  d->m_stencil_clipping = v;
+  return *this;
+}
+
+bool
+fastuidraw::PainterBackend::PerformanceHints::
+instanced_quads(void) const
+{
+  PerformanceHintsPrivate *d;
+  d = static_cast<PerformanceHintsPrivate*>(m_d);
+  return d->m_instanced_quads;
+}
+
+fastuidraw::PainterBackend::PerformanceHints&
+fastuidraw::PainterBackend::PerformanceHints::
+instanced_quads(bool v)
+{
+  PerformanceHintsPrivate *d;
+  d = static_cast<PerformanceHintsPrivate*>(m_d);
+  d->m_instanced_quads = v;
+  return *this;
+}
+
+bool
+fastuidraw::PainterBackend::PerformanceHints::
+rounded_rect_clipping(void) const
+{
+  PerformanceHintsPrivate *d;
+  d = static_cast<PerformanceHintsPrivate*>(m_d);
+  return d->m_rounded_rect_clipping;
+}
+
+fastuidraw::PainterBackend::PerformanceHints&
+fastuidraw::PainterBackend::PerformanceHints::
+rounded_rect_clipping(bool v)
+{
+  PerformanceHintsPrivate *d;
+  d = static_cast<PerformanceHintsPrivate*>(m_d);
+  d->m_rounded_rect_clipping = v;
+  return *this;
+}
+
 ///////////////////////////////////////////////////
 // fastuidraw::PainterBackend::ConfigurationBase methods
 fastuidraw::PainterBackend::ConfigurationBase::
@@ -179,6 +263,13 @@ alignment(int v)
   return *this;
 }
 
+//////////////////////////////////////////////
+// fastuidraw::PainterBackend::RenderTarget methods
+fastuidraw::PainterBackend::RenderTarget::
+~RenderTarget()
+{
+}
+
 ////////////////////////////////////
 // fastuidraw::PainterBackend methods
 fastuidraw::PainterBackend::
@@ -302,8 +393,14 @@ register_shader(const PainterShaderSet &shaders)
   register_shader(shaders.dashed_stroke_shader());
   register_shader(shaders.pixel_width_dashed_stroke_shader());
   register_shader(shaders.fill_shader());
+  register_shader(shaders.hairline_shader());
+  register_shader(shaders.hairline_instance_shader());
+  register_shader(shaders.rounded_rect_shader());
+  register_shader(shaders.box_shadow_shader());
   register_shader(shaders.glyph_shader());
   register_shader(shaders.glyph_shader_anisotropic());
+  register_shader(shaders.glyph_instance_shader());
+  register_shader(shaders.glyph_instance_shader_anisotropic());
   register_shader(shaders.blend_shaders());
 }
 
@@ -336,6 +433,7 @@ fastuidraw::PainterBackend::
 register_shader(const PainterFillShader &p)
 {
   register_shader(p.item_shader());
+  register_shader(p.aa_item_shader());
 }
 
 void
@@ -385,3 +483,82 @@ configuration_base(void) const
   d = static_cast<PainterBackendPrivate*>(m_d);
   return d->m_config;
 }
+
+fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData>
+fastuidraw::PainterBackend::
+create_static_attribute_data(const PainterAttributeData &data,
+                             const_c_array<unsigned int> attrib_chunk_selector,
+                             enum PainterAttribute::layout_t layout)
+{
+  FASTUIDRAWunused(data);
+  FASTUIDRAWunused(attrib_chunk_selector);
+  FASTUIDRAWunused(layout);
+  return reference_counted_ptr<const PainterStaticAttributeData>();
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend::RenderTarget>
+fastuidraw::PainterBackend::
+create_render_target(ivec2 dims)
+{
+  FASTUIDRAWunused(dims);
+  return reference_counted_ptr<RenderTarget>();
+}
+
+void
+fastuidraw::PainterBackend::
+begin_render_target(const reference_counted_ptr<RenderTarget> &target)
+{
+  FASTUIDRAWunused(target);
+}
+
+void
+fastuidraw::PainterBackend::
+end_render_target(void)
+{
+}
+
+enum fastuidraw::return_code
+fastuidraw::PainterBackend::
+blur_render_target(const reference_counted_ptr<RenderTarget> &src,
+                   const reference_counted_ptr<RenderTarget> &dst,
+                   ivec2 size, float radius, bool alpha_only)
+{
+  FASTUIDRAWunused(src);
+  FASTUIDRAWunused(dst);
+  FASTUIDRAWunused(size);
+  FASTUIDRAWunused(radius);
+  FASTUIDRAWunused(alpha_only);
+  return routine_fail;
+}
+
+unsigned int
+fastuidraw::PainterBackend::
+query_stat(enum stats_t st) const
+{
+  FASTUIDRAWunused(st);
+  return 0;
+}
+
+void
+fastuidraw::PainterBackend::
+reset_stats(void)
+{
+}
+
+void
+fastuidraw::PainterBackend::
+no_depth_buffer(bool)
+{
+}
+
+void
+fastuidraw::PainterBackend::
+on_begin(void)
+{
+}
+
+void
+fastuidraw::PainterBackend::
+on_end(void)
+{
+}
@@ -185,3 +185,30 @@ unmapped(void) const
   d = static_cast<PainterDrawPrivate*>(m_d);
   return d->m_map_status == status_unmapped;
 }
+
+void
+fastuidraw::PainterDraw::
+draw_static(const reference_counted_ptr<const PainterStaticAttributeData> &data,
+            unsigned int chunk, unsigned int header_attribute,
+            unsigned int number_instances,
+            unsigned int indices_written) const
+{
+  FASTUIDRAWunused(data);
+  FASTUIDRAWunused(chunk);
+  FASTUIDRAWunused(header_attribute);
+  FASTUIDRAWunused(number_instances);
+  FASTUIDRAWunused(indices_written);
+  assert(!"PainterDraw::draw_static() called on a backend without static attribute data support");
+}
+
+void
+fastuidraw::PainterDraw::
+draw_instanced_quads(unsigned int first_attribute,
+                     unsigned int number_instances,
+                     unsigned int indices_written) const
+{
+  FASTUIDRAWunused(first_attribute);
+  FASTUIDRAWunused(number_instances);
+  FASTUIDRAWunused(indices_written);
+  assert(!"PainterDraw::draw_instanced_quads() called on a backend without instanced quad support");
+}
@@ -20,7 +20,11 @@
 
 #include <vector>
 #include <list>
+#include <algorithm>
 #include <cstring>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
 
 #include <fastuidraw/painter/packing/painter_packer.hpp>
 #include <fastuidraw/painter/painter_header.hpp>
@@ -74,10 +78,11 @@ namespace
     }
   };
 
-  /* QUESTION
-      - does the reference count to a pool need to be thread safe?
+  /* The reference count to a pool is thread safe because
+     entries from a thread safe PainterPackedValuePool may
+     be released from any thread.
    */
-  class PoolBase:public fastuidraw::reference_counted<PoolBase>::non_concurrent
+  class PoolBase:public fastuidraw::reference_counted<PoolBase>::default_base
   {
   public:
     enum
@@ -85,36 +90,52 @@ namespace
         pool_size = 1024
       };
 
-    PoolBase(void):
+    explicit
+    PoolBase(bool thread_safe):
+      m_thread_safe(thread_safe),
       m_free_slots_back(pool_size - 1)
     {
       for(unsigned int i = 0; i < pool_size; ++i)
         {
           m_free_slots[i] = pool_size - 1 - i;
         }
+
+      /* the free list used when thread safe is a stack of the
+         slots linked by m_next_free; m_free_head holds the
+         slot + 1 of the top of the stack in the low 32-bits and
+         a counter in the high 32-bits that is incremented on each
+         change to m_free_head so that a compare and swap cannot
+         succeed on a stale value (ABA problem).
+       */
+      for(int i = 0; i < pool_size; ++i)
+        {
+          m_next_free[i].store(i + 1, boost::memory_order_relaxed);
+        }
+      m_next_free[pool_size - 1].store(-1, boost::memory_order_relaxed);
+      m_free_head.store(1u, boost::memory_order_relaxed);
     }
 
     ~PoolBase()
     {
-      assert(m_free_slots_back == pool_size - 1);
+      assert(m_thread_safe || m_free_slots_back == pool_size - 1);
+    }
+
+    bool
+    thread_safe(void) const
+    {
+      return m_thread_safe;
     }
 
     int
     aquire_slot(void)
     {
-      /* Should we make this thread safe? We can make it
-         thread safe by using atomic operation on m_free_slots_back.
-         The following code would make it thread safe.
-
-         return_value = m_free_slots_back.fetch_sub(1, boost::memory_order_aquire)
-         if(return_value < 0)
-           {
-              m_free_slots_back.fetch_add(1, boost::memory_order_aquire);
-           }
-         return return_value;
-       */
       int return_value(-1);
 
+      if(m_thread_safe)
+        {
+          return aquire_slot_lock_free();
+        }
+
       if(m_free_slots_back >= 0)
         {
           return_value = m_free_slots[m_free_slots_back];
@@ -126,19 +147,15 @@ namespace
     void
     release_slot(int v)
     {
-      /* Should we make this thread safe? We can make it
-         thread safe by using atomic operation on m_free_slots_back.
-         The following code would make it thread safe.
-
-         int S;
-         S = m_free_slots_back.fetch_add(1, boost::memory_order_release);
-         boost::atomic_thread_fence(boost::memory_order_acquire);
-         assert(S < pool_size);
-         m_free_slots[S] = v;
-       */
       assert(v >= 0);
       assert(v < pool_size);
 
+      if(m_thread_safe)
+        {
+          release_slot_lock_free(v);
+          return;
+        }
+
       ++m_free_slots_back;
 
       assert(m_free_slots_back < pool_size);
@@ -146,8 +163,69 @@ namespace
     }
 
   private:
+    static
+    uint64_t
+    pack_head(uint64_t old_head, int slot)
+    {
+      uint64_t counter;
+      counter = (old_head >> uint64_t(32)) + uint64_t(1);
+      return (counter << uint64_t(32)) | uint64_t(uint32_t(slot + 1));
+    }
+
+    static
+    int
+    unpack_head(uint64_t head)
+    {
+      return int(uint32_t(head & uint64_t(0xFFFFFFFFu))) - 1;
+    }
+
+    int
+    aquire_slot_lock_free(void)
+    {
+      uint64_t old_head, new_head;
+      int slot;
+
+      old_head = m_free_head.load(boost::memory_order_acquire);
+      do
+        {
+          slot = unpack_head(old_head);
+          if(slot < 0)
+            {
+              return -1;
+            }
+          new_head = pack_head(old_head, m_next_free[slot].load(boost::memory_order_relaxed));
+        }
+      while(!m_free_head.compare_exchange_weak(old_head, new_head,
+                                               boost::memory_order_acquire,
+                                               boost::memory_order_acquire));
+      return slot;
+    }
+
+    void
+    release_slot_lock_free(int v)
+    {
+      uint64_t old_head, new_head;
+
+      old_head = m_free_head.load(boost::memory_order_relaxed);
+      do
+        {
+          m_next_free[v].store(unpack_head(old_head), boost::memory_order_relaxed);
+          new_head = pack_head(old_head, v);
+        }
+      while(!m_free_head.compare_exchange_weak(old_head, new_head,
+                                               boost::memory_order_release,
+                                               boost::memory_order_relaxed));
+    }
+
+    bool m_thread_safe;
+
+    /* free list when not thread safe */
     int m_free_slots_back;
     fastuidraw::vecN<int, pool_size> m_free_slots;
+
+    /* free list when thread safe */
+    boost::atomic<uint64_t> m_free_head;
+    boost::atomic<int> m_next_free[pool_size];
   };
 
   class EntryBase
@@ -156,7 +234,8 @@ namespace
 
     EntryBase(void):
       m_raw_value(NULL),
-      m_pool_slot(-1)
+      m_pool_slot(-1),
+      m_count(0)
     {}
 
     void
@@ -164,19 +243,51 @@ namespace
     {
       assert(m_pool);
       assert(m_pool_slot >= 0);
-      m_count.add_reference();
+      if(m_pool->thread_safe())
+        {
+          m_count.fetch_add(1, boost::memory_order_relaxed);
+        }
+      else
+        {
+          m_count.store(m_count.load(boost::memory_order_relaxed) + 1, boost::memory_order_relaxed);
+        }
     }
 
     void
     release(void)
     {
+      bool last_reference;
+
       assert(m_pool);
       assert(m_pool_slot >= 0);
-      if(m_count.remove_reference())
+      if(m_pool->thread_safe())
+        {
+          last_reference = (m_count.fetch_sub(1, boost::memory_order_release) == 1);
+          if(last_reference)
+            {
+              boost::atomic_thread_fence(boost::memory_order_acquire);
+            }
+        }
+      else
+        {
+          int v;
+          v = m_count.load(boost::memory_order_relaxed) - 1;
+          m_count.store(v, boost::memory_order_relaxed);
+          last_reference = (v == 0);
+        }
+
+      if(last_reference)
         {
-          m_pool->release_slot(m_pool_slot);
+          /* clear the fields before returning the slot
+             because once returned, another thread may
+             immediately aquire the slot.
+           */
+          fastuidraw::reference_counted_ptr<PoolBase> pool;
+          int slot(m_pool_slot);
+
+          pool.swap(m_pool);
           m_pool_slot = -1;
-          m_pool = NULL;
+          pool->release_slot(slot);
         }
     }
 
@@ -210,10 +321,12 @@ namespace
     int m_pool_slot;
 
   private:
-    /* Entry reference count is not thread safe because
-       the objects themselves are not.
+    /* Entry reference count is only modified with atomic
+       read-modify-write operations if the pool is thread
+       safe; otherwise only relaxed loads and stores are
+       used which are as cheap as non-atomic operations.
     */
-    fastuidraw::reference_count_non_concurrent m_count;
+    boost::atomic<int> m_count;
   };
 
   template<typename T>
@@ -251,6 +364,11 @@ namespace
   class Pool:public PoolBase
   {
   public:
+    explicit
+    Pool(bool thread_safe):
+      PoolBase(thread_safe)
+    {}
+
     /* Returning NULL indicates no free entries left in the pool
      */
     Entry<T>*
@@ -277,21 +395,36 @@ namespace
   {
   public:
 
-    PoolSet(void)
+    explicit
+    PoolSet(bool thread_safe):
+      m_thread_safe(thread_safe)
     {
-      m_pools.push_back(FASTUIDRAWnew Pool<T>());
+      m_pools.push_back(FASTUIDRAWnew Pool<T>(m_thread_safe));
+      m_current.store(m_pools.back().get(), boost::memory_order_relaxed);
     }
 
     Entry<T>*
     allocate(const T &st, int alignment)
     {
       Entry<T> *return_value;
+      Pool<T> *pool;
 
-      return_value = m_pools.back()->allocate(st, alignment);
+      pool = m_current.load(boost::memory_order_acquire);
+      return_value = pool->allocate(st, alignment);
       if(!return_value)
         {
-          m_pools.push_back(FASTUIDRAWnew Pool<T>());
-          return_value = m_pools.back()->allocate(st, alignment);
+          /* only lock when the current pool is exhausted,
+             which is once every PoolBase::pool_size allocations
+           */
+          if(m_thread_safe)
+            {
+              boost::lock_guard<boost::mutex> M(m_mutex);
+              return_value = allocate_from_new_pool(pool, st, alignment);
+            }
+          else
+            {
+              return_value = allocate_from_new_pool(pool, st, alignment);
+            }
         }
 
       assert(return_value);
@@ -299,18 +432,53 @@ namespace
     }
 
   private:
+    Entry<T>*
+    allocate_from_new_pool(Pool<T> *full_pool, const T &st, int alignment)
+    {
+      Pool<T> *pool;
+      Entry<T> *return_value;
+
+      /* another thread may have already added a pool,
+         or released entries to the current one.
+       */
+      pool = m_current.load(boost::memory_order_relaxed);
+      if(pool != full_pool)
+        {
+          return_value = pool->allocate(st, alignment);
+          if(return_value)
+            {
+              return return_value;
+            }
+        }
+
+      m_pools.push_back(FASTUIDRAWnew Pool<T>(m_thread_safe));
+      pool = m_pools.back().get();
+      return_value = pool->allocate(st, alignment);
+      m_current.store(pool, boost::memory_order_release);
+      return return_value;
+    }
+
+    bool m_thread_safe;
+    boost::mutex m_mutex;
+    boost::atomic<Pool<T>*> m_current;
     std::vector<fastuidraw::reference_counted_ptr<Pool<T> > > m_pools;
   };
 
   class PainterPackedValuePoolPrivate
   {
   public:
-    explicit
-    PainterPackedValuePoolPrivate(int d):
-      m_alignment(d)
+    PainterPackedValuePoolPrivate(int d, bool thread_safe):
+      m_alignment(d),
+      m_thread_safe(thread_safe),
+      m_brush_pool(thread_safe),
+      m_clip_equations_pool(thread_safe),
+      m_item_matrix_pool(thread_safe),
+      m_item_shader_data_pool(thread_safe),
+      m_blend_shader_data_pool(thread_safe)
     {}
 
     int m_alignment;
+    bool m_thread_safe;
 
     PoolSet<fastuidraw::PainterBrush> m_brush_pool;
     PoolSet<fastuidraw::PainterClipEquations> m_clip_equations_pool;
@@ -329,13 +497,210 @@ namespace
     uint32_t m_blend_shader_data_loc;
   };
 
+  enum stream_value_t
+    {
+      stream_clip_value,
+      stream_matrix_value,
+      stream_item_shader_data_value,
+      stream_blend_shader_data_value,
+      stream_brush_value,
+
+      stream_number_values
+    };
+
+  enum
+    {
+      /* largest number of opaque draws against which a draw of
+         a stream is tested, see PainterPacker::stream_occlusion_culling()
+       */
+      stream_max_occluders = 32
+    };
+
+  /* A state value recorded in a PainterPackerStream, either
+     a PainterPackedValue (whose reference is held by the
+     stream) or data packed into the store of the stream.
+   */
+  class StreamValue
+  {
+  public:
+    StreamValue(void):
+      m_entry(NULL),
+      m_offset(0),
+      m_size(0)
+    {}
+
+    EntryBase *m_entry;
+    unsigned int m_offset, m_size;
+  };
+
+  class StreamDraw
+  {
+  public:
+    StreamDraw(void):
+      m_blend_mode(0),
+      m_brush_shader(0),
+      m_z(0),
+      m_attrib_chunks(0, 0),
+      m_index_chunks(0, 0),
+      m_bounded(false),
+      m_min(0.0f, 0.0f),
+      m_max(0.0f, 0.0f),
+      m_opaque(false),
+      m_opaque_min(0.0f, 0.0f),
+      m_opaque_max(0.0f, 0.0f)
+    {}
+
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> m_shader;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterBlendShader> m_blend_shader;
+    fastuidraw::BlendMode::packed_value m_blend_mode;
+    uint32_t m_brush_shader;
+    unsigned int m_z;
+    fastuidraw::vecN<StreamValue, stream_number_values> m_values;
+
+    /* transformation when recorded, needed to draw
+       the stream with a different transformation.
+     */
+    fastuidraw::PainterItemMatrix m_item_matrix;
+
+    /* range into PainterPackerStreamPrivate::m_attrib_chunks */
+    fastuidraw::range_type<unsigned int> m_attrib_chunks;
+
+    /* range into PainterPackerStreamPrivate::m_index_chunks
+       and PainterPackerStreamPrivate::m_chunk_selector
+     */
+    fastuidraw::range_type<unsigned int> m_index_chunks;
+
+    /* if m_bounded is true, the box in the coordinates of
+       PainterPackerStream::bounding_box() covering the draw,
+       used by PainterPacker::stream_reorder_window().
+     */
+    bool m_bounded;
+    fastuidraw::vec2 m_min, m_max;
+
+    /* if m_opaque is true, the draw covers the box
+       [m_opaque_min, m_opaque_max] with a color independent
+       of what is behind it, used by
+       PainterPacker::stream_occlusion_culling().
+     */
+    bool m_opaque;
+    fastuidraw::vec2 m_opaque_min, m_opaque_max;
+  };
+
+  class PainterPackerStreamPrivate
+  {
+  public:
+    explicit
+    PainterPackerStreamPrivate(int alignment):
+      m_alignment(alignment),
+      m_blend_mode(0),
+      m_z_range(0),
+      m_bounding_box_state(bounding_box_empty),
+      m_next_draw_bounded(false),
+      m_next_draw_opaque(false)
+    {}
+
+    ~PainterPackerStreamPrivate()
+    {
+      clear();
+    }
+
+    void
+    clear(void);
+
+    template<typename T>
+    void
+    record_value(const fastuidraw::PainterData::value<T> &obj, StreamValue &out_value);
+
+    int m_alignment;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterBlendShader> m_blend_shader;
+    fastuidraw::BlendMode::packed_value m_blend_mode;
+    unsigned int m_z_range;
+    fastuidraw::float3x3 m_base_transformation;
+
+    /* see PainterPackerStream::bounding_box() */
+    enum
+      {
+        bounding_box_empty,
+        bounding_box_known,
+        bounding_box_unknown
+      } m_bounding_box_state;
+    fastuidraw::vec2 m_bounding_box_min, m_bounding_box_max;
+
+    /* box passed to PainterPackerStream::add_to_bounding_box()
+       since the last recorded draw, it is the box of the next
+       recorded draw.
+     */
+    bool m_next_draw_bounded;
+    fastuidraw::vec2 m_next_draw_min, m_next_draw_max;
+
+    /* box passed to PainterPackerStream::opaque_box()
+       since the last recorded draw.
+     */
+    bool m_next_draw_opaque;
+    fastuidraw::vec2 m_next_draw_opaque_min, m_next_draw_opaque_max;
+
+    std::vector<fastuidraw::PainterAttribute> m_attributes;
+    std::vector<fastuidraw::PainterIndex> m_indices;
+    std::vector<fastuidraw::generic_data> m_store;
+
+    /* ranges into m_attributes and m_indices; the values of
+       m_chunk_selector are relative to StreamDraw::m_attrib_chunks
+       and the index values have the index adjust applied.
+     */
+    std::vector<fastuidraw::range_type<unsigned int> > m_attrib_chunks;
+    std::vector<fastuidraw::range_type<unsigned int> > m_index_chunks;
+    std::vector<unsigned int> m_chunk_selector;
+    std::vector<StreamDraw> m_draws;
+  };
+
+  /* Adapter to feed StreamDraw state values to
+     PainterPackerPrivate::draw_generic_implement();
+     if m_clip or m_matrix are non-NULL, they are used
+     instead of the values recorded in the stream.
+   */
+  class StreamDrawState
+  {
+  public:
+    StreamDrawState(const PainterPackerStreamPrivate *stream,
+                    const StreamDraw *draw,
+                    const fastuidraw::PainterData::value<fastuidraw::PainterClipEquations> *clip = NULL,
+                    const fastuidraw::PainterItemMatrix *matrix = NULL):
+      m_stream(stream),
+      m_draw(draw),
+      m_clip(clip),
+      m_matrix(matrix)
+    {}
+
+    const PainterPackerStreamPrivate *m_stream;
+    const StreamDraw *m_draw;
+    const fastuidraw::PainterData::value<fastuidraw::PainterClipEquations> *m_clip;
+    const fastuidraw::PainterItemMatrix *m_matrix;
+  };
+
   class PainterPackerPrivate;
 
   class per_draw_command
   {
   public:
-    per_draw_command(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> &r,
-                     const fastuidraw::PainterBackend::ConfigurationBase &config);
+    per_draw_command(void);
+
+    /* make the per_draw_command as if just constructed for
+       the PainterDraw r; the work rooms keep their capacity
+       so that a reused per_draw_command does not allocate.
+     */
+    void
+    reset(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> &r,
+          const fastuidraw::PainterBackend::ConfigurationBase &config);
+
+    /* drop the handles held so that a per_draw_command
+       kept for reuse does not keep them alive.
+     */
+    void
+    release(void)
+    {
+      m_draw_command = NULL;
+      m_indirect_z_call_back = NULL;
+    }
 
     unsigned int
     attribute_room(void)
@@ -372,10 +737,29 @@ namespace
       m_draw_command->unmap(m_attributes_written, m_indices_written, store_written());
     }
 
+    /* add the stats of this command to dst; does not
+       include the PainterPacker::num_draws stat.
+     */
+    void
+    add_stats(fastuidraw::vecN<unsigned int, fastuidraw::PainterPacker::num_stats> &dst)
+    {
+      dst[fastuidraw::PainterPacker::num_attributes] += m_attributes_written;
+      dst[fastuidraw::PainterPacker::num_indices] += m_indices_written;
+      dst[fastuidraw::PainterPacker::num_generic_datas] += store_written();
+      dst[fastuidraw::PainterPacker::num_headers_shared] += m_headers_shared;
+      dst[fastuidraw::PainterPacker::num_bytes_saved] += m_bytes_saved;
+      dst[fastuidraw::PainterPacker::num_draw_breaks_shader_change] += m_draw_breaks_shader_change;
+      dst[fastuidraw::PainterPacker::num_draw_breaks_blend_mode_change] += m_draw_breaks_blend_mode_change;
+    }
+
     void
     pack_painter_state(const fastuidraw::PainterPackerData &state,
                        PainterPackerPrivate *p, painter_state_location &out_data);
 
+    void
+    pack_painter_state(const StreamDrawState &state,
+                       PainterPackerPrivate *p, painter_state_location &out_data);
+
     unsigned int
     pack_header(unsigned int header_size,
                 uint32_t brush_shader,
@@ -389,7 +773,76 @@ namespace
     fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> m_draw_command;
     unsigned int m_attributes_written, m_indices_written;
 
+    /* number of headers that reused the previous header
+       and number of bytes not written to the store because
+       of sharing headers and state data.
+     */
+    unsigned int m_headers_shared, m_bytes_saved;
+
+    /* number of calls to PainterDraw::draw_break() because
+       of a shader change and because of only a change in
+       blend mode.
+     */
+    unsigned int m_draw_breaks_shader_change, m_draw_breaks_blend_mode_change;
+
   private:
+    enum
+      {
+        invalid_location = ~0u,
+
+        /* number of entries of m_brush_cache */
+        brush_cache_size = 64
+      };
+
+    /* an entry of m_brush_cache: a brush packed by value
+       to the store at m_location whose packed data is at
+       m_offset of m_brush_cache_data.
+     */
+    class brush_cache_entry
+    {
+    public:
+      brush_cache_entry(void):
+        m_hash(0u),
+        m_location(invalid_location),
+        m_offset(0u),
+        m_size(0u)
+      {}
+
+      uint32_t m_hash, m_location;
+      unsigned int m_offset, m_size;
+    };
+
+    /* the slots of the state data of a draw, used to compare
+       a state value that is not a PainterPackedValue against
+       the previous such value packed to the same slot.
+     */
+    enum state_slot_t
+      {
+        clip_slot,
+        matrix_slot,
+        item_shader_data_slot,
+        blend_shader_data_slot,
+        brush_slot,
+
+        number_state_slots
+      };
+
+    static
+    bool
+    same_header(const fastuidraw::PainterHeader &a,
+                const fastuidraw::PainterHeader &b)
+    {
+      return a.m_clip_equations_location == b.m_clip_equations_location
+        && a.m_item_matrix_location == b.m_item_matrix_location
+        && a.m_brush_shader_data_location == b.m_brush_shader_data_location
+        && a.m_item_shader_data_location == b.m_item_shader_data_location
+        && a.m_blend_shader_data_location == b.m_blend_shader_data_location
+        && a.m_item_shader == b.m_item_shader
+        && a.m_brush_shader == b.m_brush_shader
+        && a.m_blend_shader == b.m_blend_shader
+        && a.m_z == b.m_z;
+    }
+
     fastuidraw::c_array<fastuidraw::generic_data>
     allocate_store(unsigned int num_elements);
 
@@ -402,23 +855,36 @@ namespace
     void
     pack_state_data(PainterPackerPrivate *p, EntryBase *st_d, uint32_t &location);
 
+    void
+    pack_state_data(PainterPackerPrivate *p, const PainterPackerStreamPrivate *stream,
+                    const StreamValue &value, enum state_slot_t slot, uint32_t &location);
+
+    void
+    pack_raw_data(fastuidraw::const_c_array<fastuidraw::generic_data> src,
+                  enum state_slot_t slot, uint32_t &location);
+
+    bool
+    fetch_cached_brush(fastuidraw::const_c_array<fastuidraw::generic_data> src,
+                       uint32_t hash, uint32_t &location);
+
+    static
+    uint32_t
+    hash_raw_data(fastuidraw::const_c_array<fastuidraw::generic_data> src);
+
     template<typename T>
     void
-    pack_state_data_from_value(const T &st, uint32_t &location)
+    pack_state_data_from_value(const T &st, enum state_slot_t slot, uint32_t &location)
     {
-      fastuidraw::c_array<fastuidraw::generic_data> dst;
-      unsigned int data_sz;
-
-      location = current_block();
-      data_sz = st.data_size(m_alignment);
-      dst = allocate_store(data_sz);
-      st.pack_data(m_alignment, dst);
+      m_scratch.resize(st.data_size(m_alignment));
+      st.pack_data(m_alignment, fastuidraw::make_c_array(m_scratch));
+      pack_raw_data(fastuidraw::make_c_array(m_scratch), slot, location);
     }
 
     template<typename T>
     void
     pack_state_data(PainterPackerPrivate *p,
                     const fastuidraw::PainterData::value<T> &obj,
+                    enum state_slot_t slot,
                     uint32_t &location)
     {
       if(obj.m_packed_value)
@@ -429,12 +895,12 @@ namespace
         }
       else if(obj.m_value != NULL)
         {
-          pack_state_data_from_value(*obj.m_value, location);
+          pack_state_data_from_value(*obj.m_value, slot, location);
         }
       else
         {
           static T v;
-          pack_state_data_from_value(v, location);
+          pack_state_data_from_value(v, slot, location);
         }
     }
 
@@ -443,12 +909,151 @@ namespace
     uint32_t m_brush_shader_mask;
     PainterShaderGroupPrivate m_prev_state;
     fastuidraw::BlendMode m_prev_blend_mode;
+
+    /* the last header packed and its location; the location
+       is invalid_location if the header cannot be shared, i.e.
+       there is no header yet or the header was passed to a
+       PainterPacker::DataCallBack which may modify it.
+     */
+    fastuidraw::PainterHeader m_prev_header;
+    unsigned int m_prev_header_location;
+
+    /* the DataCallBack with DataCallBack::indirect_z() true whose
+       z-value is at the location m_indirect_z_location of the
+       store; holding a reference keeps it alive so that a new
+       DataCallBack is never mistaken for it.
+     */
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> m_indirect_z_call_back;
+    unsigned int m_indirect_z_location;
+
+    /* the last state value that was not a PainterPackedValue
+       packed for each slot and its location.
+     */
+    fastuidraw::vecN<std::vector<fastuidraw::generic_data>, number_state_slots> m_prev_raw_data;
+    fastuidraw::vecN<uint32_t, number_state_slots> m_prev_raw_location;
+    std::vector<fastuidraw::generic_data> m_scratch;
+
+    /* brushes passed by value are often repeated but not
+       consecutively (for example draws alternating between
+       a few colors); m_brush_cache is a direct mapped hash
+       of the brushes packed by value to the store of the
+       PainterDraw so that a brush equal to one already
+       packed to it reuses its location.
+     */
+    fastuidraw::vecN<brush_cache_entry, brush_cache_size> m_brush_cache;
+    std::vector<fastuidraw::generic_data> m_brush_cache_data;
+  };
+
+  /* the per_draw_command objects accumulated between two
+     flushes; clear() keeps the objects (and their work rooms)
+     for the next flush instead of destroying them, so once
+     warm starting a new PainterDraw does not allocate.
+   */
+  class per_draw_command_list
+  {
+  public:
+    typedef per_draw_command *iterator;
+    typedef const per_draw_command *const_iterator;
+
+    per_draw_command_list(void):
+      m_size(0)
+    {}
+
+    bool
+    empty(void) const
+    {
+      return m_size == 0;
+    }
+
+    unsigned int
+    size(void) const
+    {
+      return m_size;
+    }
+
+    per_draw_command&
+    back(void)
+    {
+      assert(m_size > 0);
+      return m_entries[m_size - 1];
+    }
+
+    iterator
+    begin(void)
+    {
+      return m_size > 0 ? &m_entries[0] : NULL;
+    }
+
+    iterator
+    end(void)
+    {
+      return begin() + m_size;
+    }
+
+    const_iterator
+    begin(void) const
+    {
+      return m_size > 0 ? &m_entries[0] : NULL;
+    }
+
+    const_iterator
+    end(void) const
+    {
+      return begin() + m_size;
+    }
+
+    /* add a per_draw_command for r, incrementing
+       allocation_counter if one is made.
+     */
+    void
+    push(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> &r,
+         const fastuidraw::PainterBackend::ConfigurationBase &config,
+         unsigned int &allocation_counter)
+    {
+      if(m_size == m_entries.size())
+        {
+          FASTUIDRAWincrement_stat(allocation_counter, 1u);
+          m_entries.push_back(per_draw_command());
+        }
+      m_entries[m_size].reset(r, config);
+      ++m_size;
+    }
+
+    void
+    clear(void)
+    {
+      for(unsigned int i = 0; i < m_size; ++i)
+        {
+          m_entries[i].release();
+        }
+      m_size = 0;
+    }
+
+    void
+    reserve(unsigned int count)
+    {
+      if(count > m_entries.size())
+        {
+          m_entries.resize(count);
+        }
+    }
+
+  private:
+    std::vector<per_draw_command> m_entries;
+    unsigned int m_size;
   };
 
   class PainterPackerPrivateWorkroom
   {
   public:
     std::vector<unsigned int> m_attribs_loaded;
+
+    /* used by draw_stream() */
+    std::vector<unsigned int> m_stream_visible, m_stream_order, m_stream_pending;
+    std::vector<const StreamDraw*> m_stream_occluders;
+    std::vector<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > m_stream_attrib_chunks;
+    std::vector<fastuidraw::const_c_array<fastuidraw::PainterIndex> > m_stream_index_chunks;
+    std::vector<int> m_stream_index_adjusts;
   };
 
   class PainterPackerPrivate
@@ -461,11 +1066,186 @@ namespace
     void
     start_new_command(void);
 
+    /* send the accumulated draws to the backend
+       within a on_pre_draw()/on_post_draw() pair,
+       leaving m_accumulated_draws empty.
+     */
     void
-    upload_draw_state(const fastuidraw::PainterPackerData &draw_state);
+    flush_accumulated_draws(void);
 
-    unsigned int
-    compute_room_needed_for_packing(const fastuidraw::PainterPackerData &draw_state);
+    /* flush the accumulated draws if they have at least
+       m_early_flush_attributes attributes or at least
+       m_early_flush_indices indices, see
+       PainterPacker::early_flush_attributes(); called
+       before a draw is packed.
+     */
+    void
+    early_flush_if_needed(void);
+
+    template<typename S>
+    void
+    draw_generic_implement(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                           const S &draw,
+                           fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attrib_chunks,
+                           fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+                           fastuidraw::const_c_array<int> index_adjusts,
+                           fastuidraw::const_c_array<unsigned int> attrib_chunk_selector,
+                           unsigned int z,
+                           const fastuidraw::reference_counted_ptr<fastuidraw::PainterBlendShader> &blend_shader,
+                           fastuidraw::BlendMode::packed_value blend_mode,
+                           const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+
+    void
+    draw_generic_writer_implement(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                                  const fastuidraw::PainterPackerData &draw,
+                                  unsigned int number_attributes,
+                                  unsigned int number_indices,
+                                  const fastuidraw::PainterPacker::DataWriter &writer,
+                                  unsigned int z,
+                                  const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+
+    void
+    draw_static_implement(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                          fastuidraw::const_c_array<fastuidraw::PainterPackerData> instances,
+                          const fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData> &static_data,
+                          fastuidraw::const_c_array<unsigned int> chunks,
+                          unsigned int z,
+                          const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+
+    /* draw the chunks of static_data for the number_instances
+       headers starting at first_header_attribute of the
+       current draw command.
+     */
+    void
+    emit_static_instances(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData> &static_data,
+                          fastuidraw::const_c_array<unsigned int> chunks,
+                          unsigned int first_header_attribute,
+                          unsigned int number_instances);
+
+    void
+    draw_instanced_quads_implement(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                                   const fastuidraw::PainterPackerData &draw,
+                                   fastuidraw::const_c_array<fastuidraw::PainterAttribute> instances,
+                                   unsigned int z,
+                                   const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+
+    void
+    draw_stream_implement(const PainterPackerStreamPrivate *st, unsigned int z_offset,
+                          const fastuidraw::PainterData::value<fastuidraw::PainterClipEquations> *clip,
+                          const fastuidraw::float3x3 *transformation,
+                          const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+
+    /* fills m_work_room.m_stream_visible with the draws of a
+       stream that are not hidden by the opaque draws after them,
+       see PainterPacker::stream_occlusion_culling().
+     */
+    void
+    compute_stream_visible(const PainterPackerStreamPrivate *st);
+
+    /* fills m_work_room.m_stream_order with the order in
+       which to draw the draws of m_work_room.m_stream_visible,
+       see PainterPacker::stream_reorder_window().
+     */
+    void
+    compute_stream_order(const PainterPackerStreamPrivate *st);
+
+    /* returns true if drawing a and b one after the other
+       does not change the shader group.
+     */
+    bool
+    same_shader_group(const StreamDraw &a, const StreamDraw &b) const;
+
+    /* returns true if the draw may be skipped because it is
+       hidden by one of the draws of m_work_room.m_stream_occluders.
+     */
+    bool
+    draw_occluded(const StreamDraw &draw) const;
+
+    static
+    bool
+    draws_overlap(const StreamDraw &a, const StreamDraw &b)
+    {
+      return !a.m_bounded || !b.m_bounded
+        || !(a.m_max.x() < b.m_min.x() || b.m_max.x() < a.m_min.x()
+             || a.m_max.y() < b.m_min.y() || b.m_max.y() < a.m_min.y());
+    }
+
+    template<typename S>
+    void
+    upload_draw_state(const S &draw_state);
+
+    unsigned int
+    compute_room_needed_for_packing(const fastuidraw::PainterPackerData &draw_state);
+
+    unsigned int
+    compute_room_needed_for_packing(const StreamDrawState &draw_state);
+
+    /* room in the store for the header of a draw made with
+       call_back; for a DataCallBack with indirect_z() true
+       this includes the block of its z-value in case the
+       draw is the first made with it in the PainterDraw.
+     */
+    unsigned int
+    header_room(const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+    {
+      return (call_back && call_back->indirect_z()) ?
+        m_header_size + m_alignment :
+        m_header_size;
+    }
+
+    /* returns blend_mode with the stencil test of the
+       clipping by the stencil buffer applied, i.e. with
+       BlendMode::STENCIL_CLIP_TEST against m_stencil_clip_value
+       if m_stencil_clip_value is non-zero and blend_mode does
+       not use the stencil buffer itself. The last conversion
+       is kept since consecutive draws nearly always share the
+       blend mode.
+     */
+    fastuidraw::BlendMode::packed_value
+    clip_blend_mode(fastuidraw::BlendMode::packed_value blend_mode)
+    {
+      if(m_stencil_clip_value == 0)
+        {
+          return blend_mode;
+        }
+
+      if(!m_clip_blend_mode_ready || blend_mode != m_clip_blend_mode_src)
+        {
+          fastuidraw::BlendMode mode(blend_mode);
+
+          m_clip_blend_mode_ready = true;
+          m_clip_blend_mode_src = blend_mode;
+          if(mode.stencil_op() == fastuidraw::BlendMode::STENCIL_OFF)
+            {
+              mode
+                .stencil_op(fastuidraw::BlendMode::STENCIL_CLIP_TEST)
+                .stencil_value(m_stencil_clip_value);
+            }
+          m_clip_blend_mode_dst = mode.packed();
+        }
+      return m_clip_blend_mode_dst;
+    }
+
+    static
+    uint32_t
+    brush_shader(const fastuidraw::PainterPackerData &draw_state)
+    {
+      return fetch_value(draw_state.m_brush).shader();
+    }
+
+    static
+    uint32_t
+    brush_shader(const StreamDrawState &draw_state)
+    {
+      return draw_state.m_draw->m_brush_shader;
+    }
+
+    bool
+    packed_in_current_store(const EntryBase *d)
+    {
+      return d->m_painter == m_p && d->m_begin_id == m_number_begins
+        && d->m_draw_command_id == m_accumulated_draws.size();
+    }
 
     template<typename T>
     unsigned int
@@ -475,15 +1255,7 @@ namespace
         {
           EntryBase *d;
           d = static_cast<EntryBase*>(obj.m_packed_value.opaque_data());
-          if(d->m_painter == m_p && d->m_begin_id == m_number_begins
-             && d->m_draw_command_id == m_accumulated_draws.size())
-            {
-              return 0;
-            }
-          else
-            {
-              return d->m_data.size();
-            }
+          return packed_in_current_store(d) ? 0 : d->m_data.size();
         }
       else if(obj.m_value != NULL)
         {
@@ -506,7 +1278,23 @@ namespace
     painter_state_location m_painter_state_location;
     int m_number_begins;
 
-    std::vector<per_draw_command> m_accumulated_draws;
+    /* see PainterPacker::stream_reorder_window() */
+    unsigned int m_stream_reorder_window;
+
+    /* see PainterPacker::stream_occlusion_culling() */
+    bool m_stream_occlusion_culling;
+
+    /* see PainterPacker::early_flush_attributes() and
+       PainterPacker::early_flush_indices()
+     */
+    unsigned int m_early_flush_attributes, m_early_flush_indices;
+
+    /* see clip_blend_mode() */
+    uint32_t m_stencil_clip_value;
+    bool m_clip_blend_mode_ready;
+    fastuidraw::BlendMode::packed_value m_clip_blend_mode_src, m_clip_blend_mode_dst;
+
+    per_draw_command_list m_accumulated_draws;
     fastuidraw::PainterPacker *m_p;
 
     PainterPackerPrivateWorkroom m_work_room;
@@ -518,19 +1306,56 @@ namespace
 //////////////////////////////////////////
 // per_draw_command methods
 per_draw_command::
-per_draw_command(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> &r,
-                 const fastuidraw::PainterBackend::ConfigurationBase &config):
-  m_draw_command(r),
+per_draw_command(void):
   m_attributes_written(0),
   m_indices_written(0),
+  m_headers_shared(0),
+  m_bytes_saved(0),
+  m_draw_breaks_shader_change(0),
+  m_draw_breaks_blend_mode_change(0),
   m_store_blocks_written(0),
-  m_alignment(config.alignment()),
-  m_brush_shader_mask(config.brush_shader_mask())
+  m_alignment(1),
+  m_brush_shader_mask(0),
+  m_prev_header_location(invalid_location),
+  m_indirect_z_location(invalid_location),
+  m_prev_raw_location(uint32_t(invalid_location))
+{
+  m_prev_state.m_item_group = 0;
+  m_prev_state.m_brush = 0;
+  m_prev_state.m_blend_group = 0;
+  m_prev_state.m_blend_mode = 0;
+}
+
+void
+per_draw_command::
+reset(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> &r,
+      const fastuidraw::PainterBackend::ConfigurationBase &config)
 {
+  m_draw_command = r;
+  m_attributes_written = 0;
+  m_indices_written = 0;
+  m_headers_shared = 0;
+  m_bytes_saved = 0;
+  m_draw_breaks_shader_change = 0;
+  m_draw_breaks_blend_mode_change = 0;
+  m_store_blocks_written = 0;
+  m_alignment = config.alignment();
+  m_brush_shader_mask = config.brush_shader_mask();
   m_prev_state.m_item_group = 0;
   m_prev_state.m_brush = 0;
   m_prev_state.m_blend_group = 0;
   m_prev_state.m_blend_mode = 0;
+  m_prev_blend_mode = fastuidraw::BlendMode();
+  m_prev_header_location = invalid_location;
+  m_indirect_z_call_back = NULL;
+  m_indirect_z_location = invalid_location;
+  m_prev_raw_location = fastuidraw::vecN<uint32_t, number_state_slots>(uint32_t(invalid_location));
+  for(unsigned int i = 0; i < number_state_slots; ++i)
+    {
+      m_prev_raw_data[i].clear();
+    }
+  m_brush_cache = fastuidraw::vecN<brush_cache_entry, brush_cache_size>(brush_cache_entry());
+  m_brush_cache_data.clear();
 }
 
 
@@ -550,8 +1375,7 @@ per_draw_command::
 pack_state_data(PainterPackerPrivate *p,
                 EntryBase *d, uint32_t &location)
 {
-  if(d->m_painter == p->m_p && d->m_begin_id == p->m_number_begins
-     && d->m_draw_command_id == p->m_accumulated_draws.size())
+  if(p->packed_in_current_store(d))
     {
       location = d->m_offset;
       return;
@@ -574,16 +1398,158 @@ pack_state_data(PainterPackerPrivate *p,
   d->m_offset = location;
 }
 
+void
+per_draw_command::
+pack_raw_data(fastuidraw::const_c_array<fastuidraw::generic_data> src,
+              enum state_slot_t slot, uint32_t &location)
+{
+  std::vector<fastuidraw::generic_data> &prev(m_prev_raw_data[slot]);
+
+  /* consecutive draws often pass equal values that are not
+     PainterPackedValue objects (for example the same brush
+     by value); reuse the location of the previous value if
+     it has the same contents.
+   */
+  if(m_prev_raw_location[slot] != uint32_t(invalid_location)
+     && prev.size() == src.size()
+     && (src.empty() || std::memcmp(&prev[0], src.c_ptr(), src.size() * sizeof(fastuidraw::generic_data)) == 0))
+    {
+      location = m_prev_raw_location[slot];
+      m_bytes_saved += src.size() * sizeof(fastuidraw::generic_data);
+      return;
+    }
+
+  uint32_t hash(0u);
+  if(slot == brush_slot)
+    {
+      hash = hash_raw_data(src);
+      if(fetch_cached_brush(src, hash, location))
+        {
+          m_bytes_saved += src.size() * sizeof(fastuidraw::generic_data);
+          prev.resize(src.size());
+          std::copy(src.begin(), src.end(), prev.begin());
+          m_prev_raw_location[slot] = location;
+          return;
+        }
+    }
+
+  fastuidraw::c_array<fastuidraw::generic_data> dst;
+
+  location = current_block();
+  dst = allocate_store(src.size());
+  std::copy(src.begin(), src.end(), dst.begin());
+
+  prev.resize(src.size());
+  std::copy(src.begin(), src.end(), prev.begin());
+  m_prev_raw_location[slot] = location;
+
+  if(slot == brush_slot)
+    {
+      brush_cache_entry &e(m_brush_cache[hash % brush_cache_size]);
+
+      e.m_hash = hash;
+      e.m_location = location;
+      e.m_offset = m_brush_cache_data.size();
+      e.m_size = src.size();
+      m_brush_cache_data.insert(m_brush_cache_data.end(), src.begin(), src.end());
+    }
+}
+
+bool
+per_draw_command::
+fetch_cached_brush(fastuidraw::const_c_array<fastuidraw::generic_data> src,
+                   uint32_t hash, uint32_t &location)
+{
+  const brush_cache_entry &e(m_brush_cache[hash % brush_cache_size]);
+
+  if(e.m_location == uint32_t(invalid_location)
+     || e.m_hash != hash
+     || e.m_size != src.size())
+    {
+      return false;
+    }
+
+  if(!src.empty()
+     && std::memcmp(&m_brush_cache_data[e.m_offset], src.c_ptr(),
+                    src.size() * sizeof(fastuidraw::generic_data)) != 0)
+    {
+      return false;
+    }
+
+  location = e.m_location;
+  return true;
+}
+
+uint32_t
+per_draw_command::
+hash_raw_data(fastuidraw::const_c_array<fastuidraw::generic_data> src)
+{
+  /* FNV-1a over the bits of the packed values */
+  uint32_t h(2166136261u);
+  for(unsigned int i = 0; i < src.size(); ++i)
+    {
+      h = (h ^ src[i].u) * 16777619u;
+    }
+  return h;
+}
+
 void
 per_draw_command::
 pack_painter_state(const fastuidraw::PainterPackerData &state,
                    PainterPackerPrivate *p, painter_state_location &out_data)
 {
-  pack_state_data(p, state.m_clip, out_data.m_clipping_data_loc);
-  pack_state_data(p, state.m_matrix, out_data.m_item_matrix_data_loc);
-  pack_state_data(p, state.m_item_shader_data, out_data.m_item_shader_data_loc);
-  pack_state_data(p, state.m_blend_shader_data, out_data.m_blend_shader_data_loc);
-  pack_state_data(p, state.m_brush, out_data.m_brush_shader_data_loc);
+  pack_state_data(p, state.m_clip, clip_slot, out_data.m_clipping_data_loc);
+  pack_state_data(p, state.m_matrix, matrix_slot, out_data.m_item_matrix_data_loc);
+  pack_state_data(p, state.m_item_shader_data, item_shader_data_slot, out_data.m_item_shader_data_loc);
+  pack_state_data(p, state.m_blend_shader_data, blend_shader_data_slot, out_data.m_blend_shader_data_loc);
+  pack_state_data(p, state.m_brush, brush_slot, out_data.m_brush_shader_data_loc);
+}
+
+void
+per_draw_command::
+pack_state_data(PainterPackerPrivate *p, const PainterPackerStreamPrivate *stream,
+                const StreamValue &value, enum state_slot_t slot, uint32_t &location)
+{
+  if(value.m_entry)
+    {
+      pack_state_data(p, value.m_entry, location);
+      return;
+    }
+
+  pack_raw_data(fastuidraw::make_c_array(stream->m_store).sub_array(value.m_offset, value.m_size),
+                slot, location);
+}
+
+void
+per_draw_command::
+pack_painter_state(const StreamDrawState &state,
+                   PainterPackerPrivate *p, painter_state_location &out_data)
+{
+  const fastuidraw::vecN<StreamValue, stream_number_values> &v(state.m_draw->m_values);
+
+  if(state.m_clip)
+    {
+      pack_state_data(p, *state.m_clip, clip_slot, out_data.m_clipping_data_loc);
+    }
+  else
+    {
+      pack_state_data(p, state.m_stream, v[stream_clip_value], clip_slot, out_data.m_clipping_data_loc);
+    }
+
+  if(state.m_matrix)
+    {
+      pack_state_data_from_value(*state.m_matrix, matrix_slot, out_data.m_item_matrix_data_loc);
+    }
+  else
+    {
+      pack_state_data(p, state.m_stream, v[stream_matrix_value], matrix_slot, out_data.m_item_matrix_data_loc);
+    }
+  pack_state_data(p, state.m_stream, v[stream_item_shader_data_value],
+                  item_shader_data_slot, out_data.m_item_shader_data_loc);
+  pack_state_data(p, state.m_stream, v[stream_blend_shader_data_value],
+                  blend_shader_data_slot, out_data.m_blend_shader_data_loc);
+  pack_state_data(p, state.m_stream, v[stream_brush_value],
+                  brush_slot, out_data.m_brush_shader_data_loc);
 }
 
 unsigned int
@@ -601,9 +1567,6 @@ pack_header(unsigned int header_size,
   fastuidraw::c_array<fastuidraw::generic_data> dst;
   fastuidraw::PainterHeader header;
 
-  return_value = current_block();
-  dst = allocate_store(header_size);
-
   if(call_back)
     {
       call_back->current_draw(m_draw_command);
@@ -629,14 +1592,46 @@ pack_header(unsigned int header_size,
   header.m_item_shader = item_shader->ID();
   header.m_brush_shader = current.m_brush;
   header.m_blend_shader = blend.m_ID;
-  header.m_z = z;
-  header.pack_data(m_alignment, dst);
 
-  if(current.m_item_group != m_prev_state.m_item_group
-     || current.m_blend_group != m_prev_state.m_blend_group
-     || (m_brush_shader_mask & (current.m_brush ^ m_prev_state.m_brush)) != 0u
-     || current.m_blend_mode != m_prev_state.m_blend_mode)
+  bool indirect_z;
+
+  indirect_z = call_back && call_back->indirect_z();
+  if(indirect_z)
+    {
+      if(call_back != m_indirect_z_call_back)
+        {
+          fastuidraw::c_array<fastuidraw::generic_data> z_dst;
+
+          m_indirect_z_call_back = call_back;
+          m_indirect_z_location = current_block();
+          z_dst = allocate_store(m_alignment);
+          z_dst[0].u = z;
+          call_back->z_value_added(z_dst);
+        }
+      header.m_z = m_indirect_z_location | (1u << fastuidraw::PainterHeader::z_indirect_bit);
+    }
+  else
+    {
+      header.m_z = z;
+    }
+
+  bool shader_change, blend_mode_change;
+
+  shader_change = current.m_item_group != m_prev_state.m_item_group
+    || current.m_blend_group != m_prev_state.m_blend_group
+    || (m_brush_shader_mask & (current.m_brush ^ m_prev_state.m_brush)) != 0u;
+  blend_mode_change = current.m_blend_mode != m_prev_state.m_blend_mode;
+
+  if(shader_change || blend_mode_change)
     {
+      if(shader_change)
+        {
+          FASTUIDRAWincrement_stat(m_draw_breaks_shader_change, 1u);
+        }
+      else
+        {
+          FASTUIDRAWincrement_stat(m_draw_breaks_blend_mode_change, 1u);
+        }
       m_draw_command->draw_break(m_prev_state, current,
                                  m_attributes_written,
                                  m_indices_written);
@@ -644,11 +1639,40 @@ pack_header(unsigned int header_size,
 
   m_prev_state = current;
 
+  /* a draw whose header is the same as that of the previous
+     draw uses the same header block; a header passed to a
+     DataCallBack is never shared because the call back
+     may modify it, unless the DataCallBack only sets the
+     z-value through the location it indirects to.
+   */
+  if((!call_back || indirect_z)
+     && m_prev_header_location != invalid_location
+     && same_header(header, m_prev_header))
+    {
+      ++m_headers_shared;
+      m_bytes_saved += header_size * sizeof(fastuidraw::generic_data);
+      return m_prev_header_location;
+    }
+
+  return_value = current_block();
+  dst = allocate_store(header_size);
+  header.pack_data(m_alignment, dst);
+
   if(call_back)
     {
       call_back->header_added(header, dst);
     }
 
+  if(!call_back || indirect_z)
+    {
+      m_prev_header = header;
+      m_prev_header_location = return_value;
+    }
+  else
+    {
+      m_prev_header_location = invalid_location;
+    }
+
   return return_value;
 }
 
@@ -669,6 +1693,13 @@ PainterPackerPrivate(fastuidraw::reference_counted_ptr<fastuidraw::PainterBacken
   // the shaders as well.
   m_default_shaders = m_backend->default_shaders();
   m_number_begins = 0;
+  m_stream_reorder_window = 0;
+  m_stream_occlusion_culling = false;
+  m_early_flush_attributes = 0;
+  m_early_flush_indices = 0;
+  m_stencil_clip_value = 0;
+  m_clip_blend_mode_ready = false;
+  m_clip_blend_mode_src = m_clip_blend_mode_dst = 0;
 }
 
 void
@@ -679,17 +1710,73 @@ start_new_command(void)
     {
       per_draw_command &c(m_accumulated_draws.back());
 
-      m_stats[fastuidraw::PainterPacker::num_attributes] += c.m_attributes_written;
-      m_stats[fastuidraw::PainterPacker::num_indices] += c.m_indices_written;
-      m_stats[fastuidraw::PainterPacker::num_generic_datas] += c.store_written();
+      c.add_stats(m_stats);
       m_stats[fastuidraw::PainterPacker::num_draws] += 1u;
 
+      /* start_new_command() is only called with a command
+         already present when that command is full.
+       */
+      FASTUIDRAWincrement_stat(m_stats[fastuidraw::PainterPacker::num_draw_breaks_buffer_full], 1u);
+
       c.unmap();
     }
 
   fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> r;
   r = m_backend->map_draw();
-  m_accumulated_draws.push_back(per_draw_command(r, m_backend->configuration_base()));
+  m_accumulated_draws.push(r, m_backend->configuration_base(),
+                           m_stats[fastuidraw::PainterPacker::num_unbudgeted_allocations]);
+}
+
+void
+PainterPackerPrivate::
+flush_accumulated_draws(void)
+{
+  if(!m_accumulated_draws.empty())
+    {
+      per_draw_command &c(m_accumulated_draws.back());
+
+      c.add_stats(m_stats);
+      m_stats[fastuidraw::PainterPacker::num_draws] += 1u;
+
+      c.unmap();
+    }
+
+  m_backend->on_pre_draw();
+  for(per_draw_command_list::iterator iter = m_accumulated_draws.begin(),
+        end = m_accumulated_draws.end(); iter != end; ++iter)
+    {
+      assert(iter->m_draw_command->unmapped());
+      iter->m_draw_command->draw();
+    }
+  m_backend->on_post_draw();
+  m_accumulated_draws.clear();
+}
+
+void
+PainterPackerPrivate::
+early_flush_if_needed(void)
+{
+  unsigned int attributes(0), indices(0);
+
+  if(m_early_flush_attributes == 0 && m_early_flush_indices == 0)
+    {
+      return;
+    }
+
+  for(per_draw_command_list::const_iterator iter = m_accumulated_draws.begin(),
+        end = m_accumulated_draws.end(); iter != end; ++iter)
+    {
+      attributes += iter->m_attributes_written;
+      indices += iter->m_indices_written;
+    }
+
+  if((m_early_flush_attributes != 0 && attributes >= m_early_flush_attributes)
+     || (m_early_flush_indices != 0 && indices >= m_early_flush_indices))
+    {
+      FASTUIDRAWincrement_stat(m_stats[fastuidraw::PainterPacker::num_early_flushes], 1u);
+      flush_accumulated_draws();
+      start_new_command();
+    }
 }
 
 unsigned int
@@ -705,9 +1792,46 @@ compute_room_needed_for_packing(const fastuidraw::PainterPackerData &draw_state)
   return R;
 }
 
+unsigned int
+PainterPackerPrivate::
+compute_room_needed_for_packing(const StreamDrawState &draw_state)
+{
+  unsigned int R(0);
+
+  if(draw_state.m_clip)
+    {
+      R += compute_room_needed_for_packing(*draw_state.m_clip);
+    }
+
+  if(draw_state.m_matrix)
+    {
+      R += draw_state.m_matrix->data_size(m_alignment);
+    }
+
+  for(unsigned int i = 0; i < stream_number_values; ++i)
+    {
+      const StreamValue &v(draw_state.m_draw->m_values[i]);
+      if((i == stream_clip_value && draw_state.m_clip)
+         || (i == stream_matrix_value && draw_state.m_matrix))
+        {
+          continue;
+        }
+      else if(v.m_entry)
+        {
+          R += packed_in_current_store(v.m_entry) ? 0 : v.m_entry->m_data.size();
+        }
+      else
+        {
+          R += v.m_size;
+        }
+    }
+  return R;
+}
+
+template<typename S>
 void
 PainterPackerPrivate::
-upload_draw_state(const fastuidraw::PainterPackerData &draw_state)
+upload_draw_state(const S &draw_state)
 {
   unsigned int needed_room;
 
@@ -720,19 +1844,675 @@ upload_draw_state(const fastuidraw::PainterPackerData &draw_state)
   m_accumulated_draws.back().pack_painter_state(draw_state, this, m_painter_state_location);
 }
 
-/////////////////////////////////////////
-// fastuidraw::PainterShaderGroup methods
-uint32_t
-fastuidraw::PainterShaderGroup::
-blend_group(void) const
+template<typename S>
+void
+PainterPackerPrivate::
+draw_generic_implement(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                       const S &draw,
+                       fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attrib_chunks,
+                       fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+                       fastuidraw::const_c_array<int> index_adjusts,
+                       fastuidraw::const_c_array<unsigned int> attrib_chunk_selector,
+                       unsigned int z,
+                       const fastuidraw::reference_counted_ptr<fastuidraw::PainterBlendShader> &blend_shader,
+                       fastuidraw::BlendMode::packed_value blend_mode,
+                       const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
 {
-  const PainterShaderGroupPrivate *d;
-  d = static_cast<const PainterShaderGroupPrivate*>(this);
-  return d->m_blend_group;
-}
+  bool allocate_header;
+  unsigned int header_loc;
+  const unsigned int NOT_LOADED = ~0u;
 
-uint32_t
-fastuidraw::PainterShaderGroup::
+  assert((attrib_chunk_selector.empty() && attrib_chunks.size() == index_chunks.size())
+         || (attrib_chunk_selector.size() == index_chunks.size()) );
+  assert(index_adjusts.size() == index_chunks.size());
+
+  if(attrib_chunks.empty() || !shader)
+    {
+      /* should we emit a warning message that the PainterItemShader
+         was missing the item shader value?
+       */
+      return;
+    }
+
+  m_work_room.m_attribs_loaded.clear();
+  m_work_room.m_attribs_loaded.resize(attrib_chunks.size(), NOT_LOADED);
+
+  assert(shader);
+
+  early_flush_if_needed();
+  upload_draw_state(draw);
+  allocate_header = true;
+
+  for(unsigned chunk = 0, num_chunks = index_chunks.size(); chunk < num_chunks; ++chunk)
+    {
+      unsigned int attrib_room, index_room, data_room;
+      unsigned int attrib_src, needed_attrib_room;
+
+      attrib_room = m_accumulated_draws.back().attribute_room();
+      index_room = m_accumulated_draws.back().index_room();
+      data_room = m_accumulated_draws.back().store_room();
+
+      if(attrib_chunk_selector.empty())
+        {
+          attrib_src = chunk;
+          needed_attrib_room = attrib_chunks[attrib_src].size();
+        }
+      else
+        {
+          attrib_src = attrib_chunk_selector[chunk];
+          needed_attrib_room = (m_work_room.m_attribs_loaded[attrib_src] == NOT_LOADED) ?
+            attrib_chunks[attrib_src].size() :
+            0;
+        }
+
+      if(index_chunks[chunk].empty() || attrib_chunks[attrib_src].empty())
+        {
+          continue;
+        }
+
+      if(attrib_room < needed_attrib_room || index_room < index_chunks[chunk].size()
+         || (allocate_header && data_room < header_room(call_back)))
+        {
+          start_new_command();
+          upload_draw_state(draw);
+
+          /* reset attribs_loaded[] and recompute needed_attrib_room
+           */
+          if(!attrib_chunk_selector.empty())
+            {
+              std::fill(m_work_room.m_attribs_loaded.begin(), m_work_room.m_attribs_loaded.end(), NOT_LOADED);
+              needed_attrib_room = attrib_chunks[attrib_src].size();
+            }
+
+          attrib_room = m_accumulated_draws.back().attribute_room();
+          index_room = m_accumulated_draws.back().index_room();
+          data_room = m_accumulated_draws.back().store_room();
+          allocate_header = true;
+
+          if(attrib_room < needed_attrib_room || index_room < index_chunks[chunk].size())
+            {
+              assert(!"Unable to fit chunk into freshly allocated draw command, not good!");
+              continue;
+            }
+
+          assert(data_room >= header_room(call_back));
+        }
+
+      per_draw_command &cmd(m_accumulated_draws.back());
+      if(allocate_header)
+        {
+          ++m_stats[fastuidraw::PainterPacker::num_headers];
+          allocate_header = false;
+          header_loc = cmd.pack_header(m_header_size,
+                                       brush_shader(draw),
+                                       blend_shader,
+                                       clip_blend_mode(blend_mode),
+                                       shader,
+                                       z, m_painter_state_location,
+                                       call_back);
+        }
+
+      /* copy attribute data and get offset into attribute buffer
+         where attributes are copied
+       */
+      unsigned int attrib_offset;
+
+      if(needed_attrib_room > 0)
+        {
+          fastuidraw::c_array<fastuidraw::PainterAttribute> attrib_dst_ptr;
+          fastuidraw::const_c_array<fastuidraw::PainterAttribute> attrib_src_ptr;
+          fastuidraw::c_array<uint32_t> header_dst_ptr;
+
+          attrib_src_ptr = attrib_chunks[attrib_src];
+          attrib_dst_ptr = cmd.m_draw_command->m_attributes.sub_array(cmd.m_attributes_written, attrib_src_ptr.size());
+          header_dst_ptr = cmd.m_draw_command->m_header_attributes.sub_array(cmd.m_attributes_written, attrib_src_ptr.size());
+
+          std::memcpy(attrib_dst_ptr.c_ptr(), attrib_src_ptr.c_ptr(), sizeof(fastuidraw::PainterAttribute) * attrib_dst_ptr.size());
+          std::fill(header_dst_ptr.begin(), header_dst_ptr.end(), header_loc);
+
+          if(!attrib_chunk_selector.empty())
+            {
+              assert(m_work_room.m_attribs_loaded[attrib_src] == NOT_LOADED);
+              m_work_room.m_attribs_loaded[attrib_src] = cmd.m_attributes_written;
+            }
+          attrib_offset = cmd.m_attributes_written;
+          cmd.m_attributes_written += attrib_dst_ptr.size();
+        }
+      else
+        {
+          assert(!attrib_chunk_selector.empty());
+          assert(m_work_room.m_attribs_loaded[attrib_src] != NOT_LOADED);
+          attrib_offset = m_work_room.m_attribs_loaded[attrib_src];
+        }
+
+      /* copy and adjust the index value by incrementing them by attrib_offset
+       */
+      fastuidraw::c_array<fastuidraw::PainterIndex> index_dst_ptr;
+      fastuidraw::const_c_array<fastuidraw::PainterIndex> index_src_ptr;
+
+      index_src_ptr = index_chunks[chunk];
+      index_dst_ptr = cmd.m_draw_command->m_indices.sub_array(cmd.m_indices_written, index_src_ptr.size());
+      for(unsigned int i = 0; i < index_dst_ptr.size(); ++i)
+        {
+          assert(int(index_src_ptr[i]) + index_adjusts[chunk] >= 0);
+          assert(int(index_src_ptr[i]) + index_adjusts[chunk] + int(attrib_offset) <= int(cmd.m_attributes_written));
+          index_dst_ptr[i] = int(index_src_ptr[i] + attrib_offset) + index_adjusts[chunk];
+        }
+      cmd.m_indices_written += index_dst_ptr.size();
+    }
+}
+
+void
+PainterPackerPrivate::
+draw_generic_writer_implement(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                              const fastuidraw::PainterPackerData &draw,
+                              unsigned int number_attributes,
+                              unsigned int number_indices,
+                              const fastuidraw::PainterPacker::DataWriter &writer,
+                              unsigned int z,
+                              const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  unsigned int header_loc, attrib_offset;
+
+  if(number_attributes == 0 || number_indices == 0 || !shader)
+    {
+      return;
+    }
+
+  early_flush_if_needed();
+  upload_draw_state(draw);
+  if(m_accumulated_draws.back().attribute_room() < number_attributes
+     || m_accumulated_draws.back().index_room() < number_indices
+     || m_accumulated_draws.back().store_room() < header_room(call_back))
+    {
+      start_new_command();
+      upload_draw_state(draw);
+
+      if(m_accumulated_draws.back().attribute_room() < number_attributes
+         || m_accumulated_draws.back().index_room() < number_indices)
+        {
+          assert(!"Unable to fit written data into freshly allocated draw command, not good!");
+          return;
+        }
+      assert(m_accumulated_draws.back().store_room() >= header_room(call_back));
+    }
+
+  per_draw_command &cmd(m_accumulated_draws.back());
+  fastuidraw::c_array<fastuidraw::PainterAttribute> attrib_dst_ptr;
+  fastuidraw::c_array<uint32_t> header_dst_ptr;
+  fastuidraw::c_array<fastuidraw::PainterIndex> index_dst_ptr;
+
+  ++m_stats[fastuidraw::PainterPacker::num_headers];
+  header_loc = cmd.pack_header(m_header_size,
+                               brush_shader(draw),
+                               m_blend_shader,
+                               clip_blend_mode(m_blend_mode),
+                               shader,
+                               z, m_painter_state_location,
+                               call_back);
+
+  attrib_offset = cmd.m_attributes_written;
+  attrib_dst_ptr = cmd.m_draw_command->m_attributes.sub_array(attrib_offset, number_attributes);
+  header_dst_ptr = cmd.m_draw_command->m_header_attributes.sub_array(attrib_offset, number_attributes);
+  index_dst_ptr = cmd.m_draw_command->m_indices.sub_array(cmd.m_indices_written, number_indices);
+
+  writer.write_data(attrib_dst_ptr, index_dst_ptr);
+  std::fill(header_dst_ptr.begin(), header_dst_ptr.end(), header_loc);
+
+  /* rebase the indices, which the writer wrote relative
+     to the start of its attributes
+   */
+  for(unsigned int i = 0; i < index_dst_ptr.size(); ++i)
+    {
+      assert(index_dst_ptr[i] < number_attributes);
+      index_dst_ptr[i] += attrib_offset;
+    }
+
+  cmd.m_attributes_written += number_attributes;
+  cmd.m_indices_written += number_indices;
+}
+
+void
+PainterPackerPrivate::
+draw_static_implement(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                      fastuidraw::const_c_array<fastuidraw::PainterPackerData> instances,
+                      const fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData> &static_data,
+                      fastuidraw::const_c_array<unsigned int> chunks,
+                      unsigned int z,
+                      const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  unsigned int first_header_attribute, number_headers;
+
+  if(!shader || !static_data || chunks.empty() || instances.empty())
+    {
+      return;
+    }
+
+  /* each instance writes its state, its header and a single
+     attribute that holds the header location; the attributes
+     of the instances that land in the same draw command are
+     consecutive so that the chunks are drawn once for all of
+     them with one instanced draw.
+   */
+  early_flush_if_needed();
+  first_header_attribute = m_accumulated_draws.back().m_attributes_written;
+  number_headers = 0;
+  for(unsigned int i = 0; i < instances.size(); ++i)
+    {
+      if(m_accumulated_draws.back().attribute_room() < 1
+         || m_accumulated_draws.back().store_room() < compute_room_needed_for_packing(instances[i]) + header_room(call_back))
+        {
+          emit_static_instances(static_data, chunks, first_header_attribute, number_headers);
+          start_new_command();
+          first_header_attribute = m_accumulated_draws.back().m_attributes_written;
+          number_headers = 0;
+        }
+
+      upload_draw_state(instances[i]);
+
+      per_draw_command &cmd(m_accumulated_draws.back());
+      unsigned int header_loc;
+
+      assert(cmd.attribute_room() >= 1 && cmd.store_room() >= header_room(call_back));
+      ++m_stats[fastuidraw::PainterPacker::num_headers];
+      header_loc = cmd.pack_header(m_header_size,
+                                   brush_shader(instances[i]),
+                                   m_blend_shader,
+                                   clip_blend_mode(m_blend_mode),
+                                   shader,
+                                   z, m_painter_state_location,
+                                   call_back);
+
+      assert(cmd.m_attributes_written == first_header_attribute + number_headers);
+      cmd.m_draw_command->m_header_attributes[cmd.m_attributes_written] = header_loc;
+      ++cmd.m_attributes_written;
+      ++number_headers;
+    }
+  emit_static_instances(static_data, chunks, first_header_attribute, number_headers);
+}
+
+void
+PainterPackerPrivate::
+emit_static_instances(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData> &static_data,
+                      fastuidraw::const_c_array<unsigned int> chunks,
+                      unsigned int first_header_attribute,
+                      unsigned int number_instances)
+{
+  if(number_instances == 0)
+    {
+      return;
+    }
+
+  per_draw_command &cmd(m_accumulated_draws.back());
+  for(unsigned int i = 0; i < chunks.size(); ++i)
+    {
+      assert(chunks[i] < static_data->number_chunks());
+      if(static_data->number_indices(chunks[i]) > 0)
+        {
+          cmd.m_draw_command->draw_static(static_data, chunks[i],
+                                          first_header_attribute,
+                                          number_instances,
+                                          cmd.m_indices_written);
+        }
+    }
+}
+
+void
+PainterPackerPrivate::
+draw_instanced_quads_implement(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                               const fastuidraw::PainterPackerData &draw,
+                               fastuidraw::const_c_array<fastuidraw::PainterAttribute> instances,
+                               unsigned int z,
+                               const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  bool allocate_header;
+  unsigned int header_loc(0);
+
+  if(!shader || instances.empty())
+    {
+      return;
+    }
+
+  early_flush_if_needed();
+  upload_draw_state(draw);
+  allocate_header = true;
+
+  /* each instance takes one attribute and no indices; when the
+     instances do not fit in the room of the current draw command,
+     draw as many as fit and place the rest in a new command.
+   */
+  while(!instances.empty())
+    {
+      unsigned int count;
+
+      if(m_accumulated_draws.back().attribute_room() == 0
+         || (allocate_header && m_accumulated_draws.back().store_room() < header_room(call_back)))
+        {
+          start_new_command();
+          upload_draw_state(draw);
+          allocate_header = true;
+          assert(m_accumulated_draws.back().attribute_room() > 0);
+          assert(m_accumulated_draws.back().store_room() >= header_room(call_back));
+        }
+
+      per_draw_command &cmd(m_accumulated_draws.back());
+      if(allocate_header)
+        {
+          ++m_stats[fastuidraw::PainterPacker::num_headers];
+          allocate_header = false;
+          header_loc = cmd.pack_header(m_header_size,
+                                       brush_shader(draw),
+                                       m_blend_shader,
+                                       clip_blend_mode(m_blend_mode),
+                                       shader,
+                                       z, m_painter_state_location,
+                                       call_back);
+        }
+
+      count = std::min(cmd.attribute_room(), static_cast<unsigned int>(instances.size()));
+
+      fastuidraw::c_array<fastuidraw::PainterAttribute> attrib_dst_ptr;
+      fastuidraw::c_array<uint32_t> header_dst_ptr;
+
+      attrib_dst_ptr = cmd.m_draw_command->m_attributes.sub_array(cmd.m_attributes_written, count);
+      header_dst_ptr = cmd.m_draw_command->m_header_attributes.sub_array(cmd.m_attributes_written, count);
+      std::copy(instances.begin(), instances.begin() + count, attrib_dst_ptr.begin());
+      std::fill(header_dst_ptr.begin(), header_dst_ptr.end(), header_loc);
+
+      cmd.m_draw_command->draw_instanced_quads(cmd.m_attributes_written, count,
+                                               cmd.m_indices_written);
+      cmd.m_attributes_written += count;
+      instances = instances.sub_array(count);
+    }
+}
+
+void
+PainterPackerPrivate::
+draw_stream_implement(const PainterPackerStreamPrivate *st, unsigned int z_offset,
+                      const fastuidraw::PainterData::value<fastuidraw::PainterClipEquations> *clip,
+                      const fastuidraw::float3x3 *transformation,
+                      const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  fastuidraw::float3x3 relative;
+  fastuidraw::PainterItemMatrix matrix;
+
+  assert(st->m_alignment == int(m_alignment));
+  assert((clip == NULL) == (transformation == NULL));
+  if(transformation)
+    {
+      fastuidraw::float3x3 base_inverse;
+      st->m_base_transformation.inverse(base_inverse);
+      relative = (*transformation) * base_inverse;
+    }
+
+  compute_stream_visible(st);
+  compute_stream_order(st);
+  for(std::vector<unsigned int>::const_iterator iter = m_work_room.m_stream_order.begin(),
+        end = m_work_room.m_stream_order.end(); iter != end; ++iter)
+    {
+      const StreamDraw &draw(st->m_draws[*iter]);
+
+      m_work_room.m_stream_attrib_chunks.clear();
+      for(unsigned int i = draw.m_attrib_chunks.m_begin; i < draw.m_attrib_chunks.m_end; ++i)
+        {
+          m_work_room.m_stream_attrib_chunks.push_back(fastuidraw::make_c_array(st->m_attributes).sub_array(st->m_attrib_chunks[i]));
+        }
+
+      m_work_room.m_stream_index_chunks.clear();
+      for(unsigned int i = draw.m_index_chunks.m_begin; i < draw.m_index_chunks.m_end; ++i)
+        {
+          m_work_room.m_stream_index_chunks.push_back(fastuidraw::make_c_array(st->m_indices).sub_array(st->m_index_chunks[i]));
+        }
+      m_work_room.m_stream_index_adjusts.clear();
+      m_work_room.m_stream_index_adjusts.resize(m_work_room.m_stream_index_chunks.size(), 0);
+
+      if(transformation)
+        {
+          matrix.m_item_matrix = relative * draw.m_item_matrix.m_item_matrix;
+        }
+
+      draw_generic_implement(draw.m_shader,
+                             StreamDrawState(st, &draw, clip, transformation ? &matrix : NULL),
+                             fastuidraw::make_c_array(m_work_room.m_stream_attrib_chunks),
+                             fastuidraw::make_c_array(m_work_room.m_stream_index_chunks),
+                             fastuidraw::make_c_array(m_work_room.m_stream_index_adjusts),
+                             fastuidraw::make_c_array(st->m_chunk_selector).sub_array(draw.m_index_chunks),
+                             draw.m_z + z_offset,
+                             draw.m_blend_shader ? draw.m_blend_shader : m_blend_shader,
+                             draw.m_blend_shader ? draw.m_blend_mode : m_blend_mode,
+                             call_back);
+    }
+}
+
+void
+PainterPackerPrivate::
+compute_stream_visible(const PainterPackerStreamPrivate *st)
+{
+  std::vector<unsigned int> &visible(m_work_room.m_stream_visible);
+  std::vector<const StreamDraw*> &occluders(m_work_room.m_stream_occluders);
+  unsigned int num_draws(st->m_draws.size());
+
+  visible.clear();
+  if(!m_stream_occlusion_culling)
+    {
+      for(unsigned int i = 0; i < num_draws; ++i)
+        {
+          visible.push_back(i);
+        }
+      return;
+    }
+
+  /* walk the draws from the last to the first, keeping the
+     opaque draws after the current draw; the number of opaque
+     draws kept is bounded so that the cost stays linear in
+     the number of draws.
+   */
+  occluders.clear();
+  for(unsigned int i = num_draws; i > 0; --i)
+    {
+      const StreamDraw &draw(st->m_draws[i - 1]);
+
+      if(draw_occluded(draw))
+        {
+          ++m_stats[fastuidraw::PainterPacker::num_stream_draws_occluded];
+          continue;
+        }
+
+      visible.push_back(i - 1);
+      if(draw.m_opaque && occluders.size() < stream_max_occluders)
+        {
+          occluders.push_back(&draw);
+        }
+    }
+  std::reverse(visible.begin(), visible.end());
+}
+
+bool
+PainterPackerPrivate::
+draw_occluded(const StreamDraw &draw) const
+{
+  const std::vector<const StreamDraw*> &occluders(m_work_room.m_stream_occluders);
+  enum fastuidraw::BlendMode::stencil_op_t op;
+
+  /* a draw that changes the stencil buffer affects the
+     draws after it even where it is hidden.
+   */
+  op = fastuidraw::BlendMode(draw.m_blend_shader ? draw.m_blend_mode : m_blend_mode).stencil_op();
+  if(!draw.m_bounded
+     || (op != fastuidraw::BlendMode::STENCIL_OFF && op != fastuidraw::BlendMode::STENCIL_CLIP_TEST))
+    {
+      return false;
+    }
+
+  for(std::vector<const StreamDraw*>::const_iterator iter = occluders.begin(),
+        end = occluders.end(); iter != end; ++iter)
+    {
+      const StreamDraw *p(*iter);
+      if(p->m_opaque_min.x() <= draw.m_min.x() && draw.m_max.x() <= p->m_opaque_max.x()
+         && p->m_opaque_min.y() <= draw.m_min.y() && draw.m_max.y() <= p->m_opaque_max.y())
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+PainterPackerPrivate::
+compute_stream_order(const PainterPackerStreamPrivate *st)
+{
+  const std::vector<unsigned int> &visible(m_work_room.m_stream_visible);
+  std::vector<unsigned int> &order(m_work_room.m_stream_order);
+  std::vector<unsigned int> &pending(m_work_room.m_stream_pending);
+  unsigned int num_draws(visible.size());
+
+  order.clear();
+  if(m_stream_reorder_window < 2)
+    {
+      order = visible;
+      return;
+    }
+
+  /* within each window, the next draw is the first pending
+     draw that keeps the shader group of the last draw and
+     that does not overlap any of the pending draws before
+     it; if there is none, it is the first pending draw. A
+     draw is thus only ever moved ahead of draws it does not
+     overlap, which keeps the result exact.
+   */
+  for(unsigned int begin = 0; begin < num_draws; begin += m_stream_reorder_window)
+    {
+      unsigned int end;
+
+      end = fastuidraw::t_min(begin + m_stream_reorder_window, num_draws);
+      pending.clear();
+      for(unsigned int i = begin; i < end; ++i)
+        {
+          pending.push_back(visible[i]);
+        }
+
+      while(!pending.empty())
+        {
+          unsigned int pick(0);
+
+          if(!order.empty())
+            {
+              const StreamDraw &last(st->m_draws[order.back()]);
+
+              for(unsigned int p = 0; p < pending.size(); ++p)
+                {
+                  const StreamDraw &candidate(st->m_draws[pending[p]]);
+                  bool can_move(true);
+
+                  if(!same_shader_group(last, candidate))
+                    {
+                      continue;
+                    }
+
+                  for(unsigned int q = 0; q < p && can_move; ++q)
+                    {
+                      can_move = !draws_overlap(candidate, st->m_draws[pending[q]]);
+                    }
+
+                  if(can_move)
+                    {
+                      pick = p;
+                      break;
+                    }
+                }
+            }
+
+          if(pick != 0)
+            {
+              ++m_stats[fastuidraw::PainterPacker::num_stream_draws_reordered];
+            }
+          order.push_back(pending[pick]);
+          pending.erase(pending.begin() + pick);
+        }
+    }
+}
+
+bool
+PainterPackerPrivate::
+same_shader_group(const StreamDraw &a, const StreamDraw &b) const
+{
+  const fastuidraw::reference_counted_ptr<fastuidraw::PainterBlendShader> &blend_a(a.m_blend_shader ? a.m_blend_shader : m_blend_shader);
+  const fastuidraw::reference_counted_ptr<fastuidraw::PainterBlendShader> &blend_b(b.m_blend_shader ? b.m_blend_shader : m_blend_shader);
+  fastuidraw::BlendMode::packed_value mode_a(a.m_blend_shader ? a.m_blend_mode : m_blend_mode);
+  fastuidraw::BlendMode::packed_value mode_b(b.m_blend_shader ? b.m_blend_mode : m_blend_mode);
+  uint32_t group_a(blend_a ? blend_a->group() : 0u);
+  uint32_t group_b(blend_b ? blend_b->group() : 0u);
+
+  return a.m_shader->group() == b.m_shader->group()
+    && a.m_brush_shader == b.m_brush_shader
+    && group_a == group_b
+    && mode_a == mode_b;
+}
+
+////////////////////////////////////////////
+// PainterPackerStreamPrivate methods
+void
+PainterPackerStreamPrivate::
+clear(void)
+{
+  for(std::vector<StreamDraw>::iterator iter = m_draws.begin(),
+        end = m_draws.end(); iter != end; ++iter)
+    {
+      for(unsigned int i = 0; i < stream_number_values; ++i)
+        {
+          if(iter->m_values[i].m_entry)
+            {
+              iter->m_values[i].m_entry->release();
+            }
+        }
+    }
+  m_draws.clear();
+  m_attributes.clear();
+  m_indices.clear();
+  m_store.clear();
+  m_attrib_chunks.clear();
+  m_index_chunks.clear();
+  m_chunk_selector.clear();
+  m_z_range = 0;
+  m_bounding_box_state = bounding_box_empty;
+  m_next_draw_bounded = false;
+  m_next_draw_opaque = false;
+}
+
+template<typename T>
+void
+PainterPackerStreamPrivate::
+record_value(const fastuidraw::PainterData::value<T> &obj, StreamValue &out_value)
+{
+  if(obj.m_packed_value)
+    {
+      assert(obj.m_packed_value.alignment_packing() == static_cast<unsigned int>(m_alignment));
+      out_value.m_entry = static_cast<EntryBase*>(obj.m_packed_value.opaque_data());
+      out_value.m_entry->aquire();
+      return;
+    }
+
+  const T &v(fetch_value(obj));
+
+  out_value.m_offset = m_store.size();
+  out_value.m_size = v.data_size(m_alignment);
+  m_store.resize(out_value.m_offset + out_value.m_size);
+  v.pack_data(m_alignment, fastuidraw::make_c_array(m_store).sub_array(out_value.m_offset, out_value.m_size));
+}
+
+/////////////////////////////////////////
+// fastuidraw::PainterShaderGroup methods
+uint32_t
+fastuidraw::PainterShaderGroup::
+blend_group(void) const
+{
+  const PainterShaderGroupPrivate *d;
+  d = static_cast<const PainterShaderGroupPrivate*>(this);
+  return d->m_blend_group;
+}
+
+uint32_t
+fastuidraw::PainterShaderGroup::
 item_group(void) const
 {
   const PainterShaderGroupPrivate *d;
@@ -778,7 +2558,7 @@ fastuidraw::PainterPacker::
 
 void
 fastuidraw::PainterPacker::
-begin(void)
+begin(bool no_depth_buffer)
 {
   PainterPackerPrivate *d;
   d = static_cast<PainterPackerPrivate*>(m_d);
@@ -787,6 +2567,9 @@ begin(void)
   d->m_backend->image_atlas()->delay_tile_freeing();
   d->m_backend->colorstop_atlas()->delay_interval_freeing();
   std::fill(d->m_stats.begin(), d->m_stats.end(), 0u);
+  d->m_backend->reset_stats();
+  d->m_backend->no_depth_buffer(no_depth_buffer);
+  d->m_backend->on_begin();
   d->start_new_command();
   ++d->m_number_begins;
 }
@@ -801,12 +2584,35 @@ query_stat(enum stats_t st) const
   vecN<unsigned int, num_stats> tmp(0);
   if(!d->m_accumulated_draws.empty())
     {
-      per_draw_command &c(d->m_accumulated_draws.back());
-      tmp[num_attributes] = c.m_attributes_written;
-      tmp[num_indices] = c.m_indices_written;
-      tmp[num_generic_datas] = c.store_written();
+      d->m_accumulated_draws.back().add_stats(tmp);
+    }
+
+  switch(st)
+    {
+    case num_atlas_upload_bytes:
+      return d->m_backend->query_stat(PainterBackend::num_atlas_upload_bytes);
+
+    case num_backend_draw_calls:
+      return d->m_backend->query_stat(PainterBackend::num_draw_calls);
+
+    case backend_gpu_time_micro_seconds:
+      return d->m_backend->query_stat(PainterBackend::gpu_time_micro_seconds);
+
+    case backend_num_atlas_resizes:
+      return d->m_backend->query_stat(PainterBackend::num_atlas_resizes);
+
+    case backend_num_mid_pass_atlas_flushes:
+      return d->m_backend->query_stat(PainterBackend::num_mid_pass_atlas_flushes);
+
+    case backend_num_buffer_grows:
+      return d->m_backend->query_stat(PainterBackend::num_buffer_grows);
+
+    case backend_num_buffer_shrinks:
+      return d->m_backend->query_stat(PainterBackend::num_buffer_shrinks);
+
+    default:
+      return d->m_stats[st] + tmp[st];
     }
-  return d->m_stats[st] + tmp[st];
 }
 
 void
@@ -815,34 +2621,20 @@ flush(void)
 {
   PainterPackerPrivate *d;
   d = static_cast<PainterPackerPrivate*>(m_d);
-  if(!d->m_accumulated_draws.empty())
-    {
-      per_draw_command &c(d->m_accumulated_draws.back());
-
-      d->m_stats[fastuidraw::PainterPacker::num_attributes] += c.m_attributes_written;
-      d->m_stats[fastuidraw::PainterPacker::num_indices] += c.m_indices_written;
-      d->m_stats[fastuidraw::PainterPacker::num_generic_datas] += c.store_written();
-      d->m_stats[fastuidraw::PainterPacker::num_draws] += 1u;
 
-      c.unmap();
-    }
-
-  d->m_backend->on_pre_draw();
-  for(std::vector<per_draw_command>::iterator iter = d->m_accumulated_draws.begin(),
-        end = d->m_accumulated_draws.end(); iter != end; ++iter)
-    {
-      assert(iter->m_draw_command->unmapped());
-      iter->m_draw_command->draw();
-    }
-  d->m_backend->on_post_draw();
-  d->m_accumulated_draws.clear();
+  d->flush_accumulated_draws();
+  d->start_new_command();
 }
 
 void
 fastuidraw::PainterPacker::
 end(void)
 {
-  flush();
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+
+  d->flush_accumulated_draws();
+  d->m_backend->on_end();
   image_atlas()->undelay_tile_freeing();
   colorstop_atlas()->undelay_interval_freeing();
 }
@@ -876,147 +2668,104 @@ draw_generic(const reference_counted_ptr<PainterItemShader> &shader,
   PainterPackerPrivate *d;
   d = static_cast<PainterPackerPrivate*>(m_d);
 
-  bool allocate_header;
-  unsigned int header_loc;
-  const unsigned int NOT_LOADED = ~0u;
-
-  assert((attrib_chunk_selector.empty() && attrib_chunks.size() == index_chunks.size())
-         || (attrib_chunk_selector.size() == index_chunks.size()) );
-  assert(index_adjusts.size() == index_chunks.size());
-
-  if(attrib_chunks.empty() || !shader)
-    {
-      /* should we emit a warning message that the PainterItemShader
-         was missing the item shader value?
-       */
-      return;
-    }
-
-  d->m_work_room.m_attribs_loaded.clear();
-  d->m_work_room.m_attribs_loaded.resize(attrib_chunk_selector.size(), NOT_LOADED);
-
-  assert(shader);
-
-  d->upload_draw_state(draw);
-  allocate_header = true;
-
-  for(unsigned chunk = 0, num_chunks = index_chunks.size(); chunk < num_chunks; ++chunk)
-    {
-      unsigned int attrib_room, index_room, data_room;
-      unsigned int attrib_src, needed_attrib_room;
-
-      attrib_room = d->m_accumulated_draws.back().attribute_room();
-      index_room = d->m_accumulated_draws.back().index_room();
-      data_room = d->m_accumulated_draws.back().store_room();
-
-      if(attrib_chunk_selector.empty())
-        {
-          attrib_src = chunk;
-          needed_attrib_room = attrib_chunks[attrib_src].size();
-        }
-      else
-        {
-          attrib_src = attrib_chunk_selector[chunk];
-          needed_attrib_room = (d->m_work_room.m_attribs_loaded[attrib_src] == NOT_LOADED) ?
-            attrib_chunks[attrib_src].size() :
-            0;
-        }
-
-      if(index_chunks[chunk].empty() || attrib_chunks[attrib_src].empty())
-        {
-          continue;
-        }
-
-      if(attrib_room < needed_attrib_room || index_room < index_chunks[chunk].size()
-         || (allocate_header && data_room < d->m_header_size))
-        {
-          d->start_new_command();
-          d->upload_draw_state(draw);
-
-          /* reset attribs_loaded[] and recompute needed_attrib_room
-           */
-          if(!attrib_chunk_selector.empty())
-            {
-              std::fill(d->m_work_room.m_attribs_loaded.begin(), d->m_work_room.m_attribs_loaded.end(), NOT_LOADED);
-              needed_attrib_room = attrib_chunks[attrib_src].size();
-            }
-
-          attrib_room = d->m_accumulated_draws.back().attribute_room();
-          index_room = d->m_accumulated_draws.back().index_room();
-          data_room = d->m_accumulated_draws.back().store_room();
-          allocate_header = true;
-
-          if(attrib_room < needed_attrib_room || index_room < index_chunks[chunk].size())
-            {
-              assert(!"Unable to fit chunk into freshly allocated draw command, not good!");
-              continue;
-            }
-
-          assert(data_room >= d->m_header_size);
-        }
+  d->draw_generic_implement(shader, draw, attrib_chunks, index_chunks,
+                            index_adjusts, attrib_chunk_selector, z,
+                            d->m_blend_shader, d->m_blend_mode, call_back);
+}
 
-      per_draw_command &cmd(d->m_accumulated_draws.back());
-      if(allocate_header)
-        {
-          ++d->m_stats[num_headers];
-          allocate_header = false;
-          header_loc = cmd.pack_header(d->m_header_size,
-                                       fetch_value(draw.m_brush).shader(),
-                                       d->m_blend_shader,
-                                       d->m_blend_mode,
-                                       shader,
-                                       z, d->m_painter_state_location,
-                                       call_back);
-        }
+void
+fastuidraw::PainterPacker::
+draw_generic(const reference_counted_ptr<PainterItemShader> &shader,
+             const PainterPackerData &draw,
+             unsigned int number_attributes,
+             unsigned int number_indices,
+             const DataWriter &writer,
+             unsigned int z,
+             const reference_counted_ptr<DataCallBack> &call_back)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
 
-      /* copy attribute data and get offset into attribute buffer
-         where attributes are copied
-       */
-      unsigned int attrib_offset;
+  d->draw_generic_writer_implement(shader, draw, number_attributes, number_indices,
+                                   writer, z, call_back);
+}
 
-      if(needed_attrib_room > 0)
-        {
-          c_array<PainterAttribute> attrib_dst_ptr;
-          const_c_array<PainterAttribute> attrib_src_ptr;
-          c_array<uint32_t> header_dst_ptr;
+void
+fastuidraw::PainterPacker::
+draw_stream(const PainterPackerStream &stream, unsigned int z_offset,
+            const reference_counted_ptr<DataCallBack> &call_back)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  d->draw_stream_implement(static_cast<const PainterPackerStreamPrivate*>(stream.m_d),
+                           z_offset, NULL, NULL, call_back);
+}
 
-          attrib_src_ptr = attrib_chunks[attrib_src];
-          attrib_dst_ptr = cmd.m_draw_command->m_attributes.sub_array(cmd.m_attributes_written, attrib_src_ptr.size());
-          header_dst_ptr = cmd.m_draw_command->m_header_attributes.sub_array(cmd.m_attributes_written, attrib_src_ptr.size());
+void
+fastuidraw::PainterPacker::
+draw_stream(const PainterPackerStream &stream, unsigned int z_offset,
+            const PainterData::value<PainterClipEquations> &clip,
+            const float3x3 &transformation,
+            const reference_counted_ptr<DataCallBack> &call_back)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  d->draw_stream_implement(static_cast<const PainterPackerStreamPrivate*>(stream.m_d),
+                           z_offset, &clip, &transformation, call_back);
+}
 
-          std::memcpy(attrib_dst_ptr.c_ptr(), attrib_src_ptr.c_ptr(), sizeof(PainterAttribute) * attrib_dst_ptr.size());
-          std::fill(header_dst_ptr.begin(), header_dst_ptr.end(), header_loc);
+fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData>
+fastuidraw::PainterPacker::
+create_static_attribute_data(const PainterAttributeData &data,
+                             const_c_array<unsigned int> attrib_chunk_selector,
+                             enum PainterAttribute::layout_t layout)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  return d->m_backend->create_static_attribute_data(data, attrib_chunk_selector, layout);
+}
 
-          if(!attrib_chunk_selector.empty())
-            {
-              assert(d->m_work_room.m_attribs_loaded[attrib_src] == NOT_LOADED);
-              d->m_work_room.m_attribs_loaded[attrib_src] = cmd.m_attributes_written;
-            }
-          attrib_offset = cmd.m_attributes_written;
-          cmd.m_attributes_written += attrib_dst_ptr.size();
-        }
-      else
-        {
-          assert(!attrib_chunk_selector.empty());
-          assert(d->m_work_room.m_attribs_loaded[attrib_src] != NOT_LOADED);
-          attrib_offset = d->m_work_room.m_attribs_loaded[attrib_src];
-        }
+void
+fastuidraw::PainterPacker::
+draw_static(const reference_counted_ptr<PainterItemShader> &shader,
+            const PainterPackerData &draw,
+            const reference_counted_ptr<const PainterStaticAttributeData> &static_data,
+            const_c_array<unsigned int> chunks,
+            unsigned int z,
+            const reference_counted_ptr<DataCallBack> &call_back)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  d->draw_static_implement(shader, const_c_array<PainterPackerData>(&draw, 1),
+                           static_data, chunks, z, call_back);
+}
 
-      /* copy and adjust the index value by incrementing them by attrib_offset
-       */
-      c_array<PainterIndex> index_dst_ptr;
-      const_c_array<PainterIndex> index_src_ptr;
+void
+fastuidraw::PainterPacker::
+draw_static_instances(const reference_counted_ptr<PainterItemShader> &shader,
+                      const_c_array<PainterPackerData> instances,
+                      const reference_counted_ptr<const PainterStaticAttributeData> &static_data,
+                      const_c_array<unsigned int> chunks,
+                      unsigned int z,
+                      const reference_counted_ptr<DataCallBack> &call_back)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  d->draw_static_implement(shader, instances, static_data, chunks, z, call_back);
+}
 
-      index_src_ptr = index_chunks[chunk];
-      index_dst_ptr = cmd.m_draw_command->m_indices.sub_array(cmd.m_indices_written, index_src_ptr.size());
-      for(unsigned int i = 0; i < index_dst_ptr.size(); ++i)
-        {
-          assert(int(index_src_ptr[i]) + index_adjusts[chunk] >= 0);
-          assert(int(index_src_ptr[i]) + index_adjusts[chunk] + int(attrib_offset) <= int(cmd.m_attributes_written));
-          index_dst_ptr[i] = int(index_src_ptr[i] + attrib_offset) + index_adjusts[chunk];
-        }
-      cmd.m_indices_written += index_dst_ptr.size();
-    }
+void
+fastuidraw::PainterPacker::
+draw_instanced_quads(const reference_counted_ptr<PainterItemShader> &shader,
+                     const PainterPackerData &draw,
+                     const_c_array<PainterAttribute> instances,
+                     unsigned int z,
+                     const reference_counted_ptr<DataCallBack> &call_back)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  assert(d->m_backend->hints().instanced_quads());
+  d->draw_instanced_quads_implement(shader, draw, instances, z, call_back);
 }
 
 const fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlas>&
@@ -1076,6 +2825,106 @@ blend_shader(const fastuidraw::reference_counted_ptr<PainterBlendShader> &h,
   d->m_blend_mode = pblend_mode;
 }
 
+void
+fastuidraw::PainterPacker::
+stencil_clip_value(uint32_t v)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  d->m_stencil_clip_value = v & 0xFFu;
+  d->m_clip_blend_mode_ready = false;
+}
+
+uint32_t
+fastuidraw::PainterPacker::
+stencil_clip_value(void) const
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  return d->m_stencil_clip_value;
+}
+
+void
+fastuidraw::PainterPacker::
+stream_reorder_window(unsigned int v)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  d->m_stream_reorder_window = v;
+}
+
+unsigned int
+fastuidraw::PainterPacker::
+stream_reorder_window(void) const
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  return d->m_stream_reorder_window;
+}
+
+void
+fastuidraw::PainterPacker::
+early_flush_attributes(unsigned int v)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  d->m_early_flush_attributes = v;
+}
+
+unsigned int
+fastuidraw::PainterPacker::
+early_flush_attributes(void) const
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  return d->m_early_flush_attributes;
+}
+
+void
+fastuidraw::PainterPacker::
+early_flush_indices(unsigned int v)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  d->m_early_flush_indices = v;
+}
+
+unsigned int
+fastuidraw::PainterPacker::
+early_flush_indices(void) const
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  return d->m_early_flush_indices;
+}
+
+void
+fastuidraw::PainterPacker::
+reserve_draws(unsigned int count)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  d->m_accumulated_draws.reserve(count);
+}
+
+void
+fastuidraw::PainterPacker::
+stream_occlusion_culling(bool v)
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  d->m_stream_occlusion_culling = v;
+}
+
+bool
+fastuidraw::PainterPacker::
+stream_occlusion_culling(void) const
+{
+  PainterPackerPrivate *d;
+  d = static_cast<PainterPackerPrivate*>(m_d);
+  return d->m_stream_occlusion_culling;
+}
+
 const fastuidraw::PainterShaderSet&
 fastuidraw::PainterPacker::
 default_shaders(void) const
@@ -1258,9 +3107,9 @@ raw_value(void) const
 /////////////////////////////////////////////////////
 // PainterPackedValuePool methods
 fastuidraw::PainterPackedValuePool::
-PainterPackedValuePool(int alignment)
+PainterPackedValuePool(int alignment, bool thread_safe)
 {
-  m_d = FASTUIDRAWnew PainterPackedValuePoolPrivate(alignment);
+  m_d = FASTUIDRAWnew PainterPackedValuePoolPrivate(alignment, thread_safe);
 }
 
 fastuidraw::PainterPackedValuePool::
@@ -1272,6 +3121,15 @@ fastuidraw::PainterPackedValuePool::
   m_d = NULL;
 }
 
+bool
+fastuidraw::PainterPackedValuePool::
+thread_safe(void) const
+{
+  PainterPackedValuePoolPrivate *d;
+  d = static_cast<PainterPackedValuePoolPrivate*>(m_d);
+  return d->m_thread_safe;
+}
+
 fastuidraw::PainterPackedValue<fastuidraw::PainterBrush>
 fastuidraw::PainterPackedValuePool::
 create_packed_value(const PainterBrush &value)
@@ -1331,3 +3189,276 @@ create_packed_value(const PainterBlendShaderData &value)
   e = d->m_blend_shader_data_pool.allocate(value, d->m_alignment);
   return fastuidraw::PainterPackedValue<PainterBlendShaderData>(e);
 }
+
+//////////////////////////////////////////
+// fastuidraw::PainterPackerStream methods
+fastuidraw::PainterPackerStream::
+PainterPackerStream(int painter_alignment)
+{
+  m_d = FASTUIDRAWnew PainterPackerStreamPrivate(painter_alignment);
+}
+
+fastuidraw::PainterPackerStream::
+~PainterPackerStream()
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+int
+fastuidraw::PainterPackerStream::
+alignment(void) const
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  return d->m_alignment;
+}
+
+void
+fastuidraw::PainterPackerStream::
+clear(void)
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  d->clear();
+}
+
+unsigned int
+fastuidraw::PainterPackerStream::
+number_draws(void) const
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  return d->m_draws.size();
+}
+
+unsigned int
+fastuidraw::PainterPackerStream::
+z_range(void) const
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  return d->m_z_range;
+}
+
+const fastuidraw::float3x3&
+fastuidraw::PainterPackerStream::
+base_transformation(void) const
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  return d->m_base_transformation;
+}
+
+void
+fastuidraw::PainterPackerStream::
+base_transformation(const float3x3 &v)
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  d->m_base_transformation = v;
+}
+
+bool
+fastuidraw::PainterPackerStream::
+bounding_box(vec2 *pmin, vec2 *pmax) const
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+
+  if(d->m_bounding_box_state != PainterPackerStreamPrivate::bounding_box_known)
+    {
+      return false;
+    }
+  *pmin = d->m_bounding_box_min;
+  *pmax = d->m_bounding_box_max;
+  return true;
+}
+
+void
+fastuidraw::PainterPackerStream::
+add_to_bounding_box(const vec2 &pmin, const vec2 &pmax)
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+
+  if(d->m_next_draw_bounded)
+    {
+      d->m_next_draw_min.x() = t_min(d->m_next_draw_min.x(), pmin.x());
+      d->m_next_draw_min.y() = t_min(d->m_next_draw_min.y(), pmin.y());
+      d->m_next_draw_max.x() = t_max(d->m_next_draw_max.x(), pmax.x());
+      d->m_next_draw_max.y() = t_max(d->m_next_draw_max.y(), pmax.y());
+    }
+  else
+    {
+      d->m_next_draw_bounded = true;
+      d->m_next_draw_min = pmin;
+      d->m_next_draw_max = pmax;
+    }
+
+  switch(d->m_bounding_box_state)
+    {
+    case PainterPackerStreamPrivate::bounding_box_empty:
+      d->m_bounding_box_state = PainterPackerStreamPrivate::bounding_box_known;
+      d->m_bounding_box_min = pmin;
+      d->m_bounding_box_max = pmax;
+      break;
+
+    case PainterPackerStreamPrivate::bounding_box_known:
+      d->m_bounding_box_min.x() = t_min(d->m_bounding_box_min.x(), pmin.x());
+      d->m_bounding_box_min.y() = t_min(d->m_bounding_box_min.y(), pmin.y());
+      d->m_bounding_box_max.x() = t_max(d->m_bounding_box_max.x(), pmax.x());
+      d->m_bounding_box_max.y() = t_max(d->m_bounding_box_max.y(), pmax.y());
+      break;
+
+    default:
+      break;
+    }
+}
+
+void
+fastuidraw::PainterPackerStream::
+bounding_box_unknown(void)
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  d->m_bounding_box_state = PainterPackerStreamPrivate::bounding_box_unknown;
+  d->m_next_draw_bounded = false;
+}
+
+void
+fastuidraw::PainterPackerStream::
+opaque_box(const vec2 &pmin, const vec2 &pmax)
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  d->m_next_draw_opaque = true;
+  d->m_next_draw_opaque_min = pmin;
+  d->m_next_draw_opaque_max = pmax;
+}
+
+const fastuidraw::reference_counted_ptr<fastuidraw::PainterBlendShader>&
+fastuidraw::PainterPackerStream::
+blend_shader(void) const
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  return d->m_blend_shader;
+}
+
+fastuidraw::BlendMode::packed_value
+fastuidraw::PainterPackerStream::
+blend_mode(void) const
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  return d->m_blend_mode;
+}
+
+void
+fastuidraw::PainterPackerStream::
+blend_shader(const reference_counted_ptr<PainterBlendShader> &h,
+             BlendMode::packed_value packed_blend_mode)
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+  d->m_blend_shader = h;
+  d->m_blend_mode = packed_blend_mode;
+}
+
+void
+fastuidraw::PainterPackerStream::
+draw_generic(const reference_counted_ptr<PainterItemShader> &shader,
+             const PainterPackerData &draw,
+             const_c_array<const_c_array<PainterAttribute> > attrib_chunks,
+             const_c_array<const_c_array<PainterIndex> > index_chunks,
+             const_c_array<int> index_adjusts,
+             unsigned int z)
+{
+  draw_generic(shader, draw, attrib_chunks, index_chunks,
+               index_adjusts, const_c_array<unsigned int>(), z);
+}
+
+void
+fastuidraw::PainterPackerStream::
+draw_generic(const reference_counted_ptr<PainterItemShader> &shader,
+             const PainterPackerData &draw,
+             const_c_array<const_c_array<PainterAttribute> > attrib_chunks,
+             const_c_array<const_c_array<PainterIndex> > index_chunks,
+             const_c_array<int> index_adjusts,
+             const_c_array<unsigned int> attrib_chunk_selector,
+             unsigned int z)
+{
+  PainterPackerStreamPrivate *d;
+  d = static_cast<PainterPackerStreamPrivate*>(m_d);
+
+  assert((attrib_chunk_selector.empty() && attrib_chunks.size() == index_chunks.size())
+         || (attrib_chunk_selector.size() == index_chunks.size()) );
+  assert(index_adjusts.size() == index_chunks.size());
+
+  if(attrib_chunks.empty() || !shader)
+    {
+      d->m_next_draw_opaque = false;
+      return;
+    }
+
+  d->m_draws.push_back(StreamDraw());
+
+  StreamDraw &cmd(d->m_draws.back());
+  cmd.m_shader = shader;
+  cmd.m_blend_shader = d->m_blend_shader;
+  cmd.m_blend_mode = d->m_blend_mode;
+  cmd.m_brush_shader = fetch_value(draw.m_brush).shader();
+  cmd.m_item_matrix = fetch_value(draw.m_matrix);
+  cmd.m_z = z;
+  cmd.m_bounded = d->m_next_draw_bounded;
+  cmd.m_min = d->m_next_draw_min;
+  cmd.m_max = d->m_next_draw_max;
+  cmd.m_opaque = d->m_next_draw_opaque;
+  cmd.m_opaque_min = d->m_next_draw_opaque_min;
+  cmd.m_opaque_max = d->m_next_draw_opaque_max;
+  d->m_next_draw_bounded = false;
+  d->m_next_draw_opaque = false;
+  d->m_z_range = t_max(d->m_z_range, z + 1);
+
+  d->record_value(draw.m_clip, cmd.m_values[stream_clip_value]);
+  d->record_value(draw.m_matrix, cmd.m_values[stream_matrix_value]);
+  d->record_value(draw.m_item_shader_data, cmd.m_values[stream_item_shader_data_value]);
+  d->record_value(draw.m_blend_shader_data, cmd.m_values[stream_blend_shader_data_value]);
+  d->record_value(draw.m_brush, cmd.m_values[stream_brush_value]);
+
+  cmd.m_attrib_chunks.m_begin = d->m_attrib_chunks.size();
+  for(unsigned int i = 0; i < attrib_chunks.size(); ++i)
+    {
+      range_type<unsigned int> R;
+
+      R.m_begin = d->m_attributes.size();
+      d->m_attributes.insert(d->m_attributes.end(), attrib_chunks[i].begin(), attrib_chunks[i].end());
+      R.m_end = d->m_attributes.size();
+      d->m_attrib_chunks.push_back(R);
+    }
+  cmd.m_attrib_chunks.m_end = d->m_attrib_chunks.size();
+
+  /* the index adjusts are applied when recording so that
+     all the index values of the stream are relative to the
+     start of their attribute chunk.
+   */
+  cmd.m_index_chunks.m_begin = d->m_index_chunks.size();
+  for(unsigned int i = 0; i < index_chunks.size(); ++i)
+    {
+      range_type<unsigned int> R;
+
+      R.m_begin = d->m_indices.size();
+      for(unsigned int k = 0; k < index_chunks[i].size(); ++k)
+        {
+          assert(int(index_chunks[i][k]) + index_adjusts[i] >= 0);
+          d->m_indices.push_back(int(index_chunks[i][k]) + index_adjusts[i]);
+        }
+      R.m_end = d->m_indices.size();
+      d->m_index_chunks.push_back(R);
+      d->m_chunk_selector.push_back(attrib_chunk_selector.empty() ? i : attrib_chunk_selector[i]);
+    }
+  cmd.m_index_chunks.m_end = d->m_index_chunks.size();
+}
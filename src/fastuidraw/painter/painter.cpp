@@ -19,35 +19,41 @@
 
 #include <vector>
 #include <bitset>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
 
 #include <fastuidraw/util/math.hpp>
 #include <fastuidraw/painter/painter_header.hpp>
 #include <fastuidraw/painter/painter.hpp>
+#include <fastuidraw/painter/painter_attribute_data_filler_glyphs.hpp>
 
 #include "../private/util_private.hpp"
 #include "../private/util_private_ostream.hpp"
 #include "../private/clip.hpp"
+#include "private/glyph_attribute_packing.hpp"
 
 namespace
 {
+  /* size in pixels below which a portion of a FilledPath that is
+     only partially within the clipping region is drawn whole, see
+     FilledPath::select_subsets().
+   */
+  const float coarse_subset_pixels = 32.0f;
+
+  /* the surfaces of layers, see Painter::begin_layer(), are
+     at most max_layer_size pixels wide and high and are
+     created with sizes that are multiples of
+     render_target_granularity pixels.
+   */
+  const int max_layer_size = 4096;
+  const int render_target_granularity = 64;
+
   class ZDelayedAction;
   class ZDataCallBack;
+  class ZFramePool;
   class PainterPrivate;
 
-  class change_header_z
-  {
-  public:
-    change_header_z(const fastuidraw::PainterHeader &header,
-                    fastuidraw::c_array<fastuidraw::generic_data> mapped_location)
-    {
-      FASTUIDRAWunused(header);
-      m_mapped = &mapped_location[fastuidraw::PainterHeader::z_offset].u;
-    }
-
-    //location to which to write to overwrite value.
-    uint32_t *m_mapped;
-  };
-
   class ZDelayedAction:public fastuidraw::PainterDraw::DelayedAction
   {
   public:
@@ -66,47 +72,201 @@ namespace
     {
       for(unsigned int i = 0, endi = m_dests.size(); i < endi; ++i)
         {
-          *m_dests[i].m_mapped = m_z_to_write;
+          *m_dests[i] = m_z_to_write;
         }
     }
 
   private:
     friend class ZDataCallBack;
+    friend class ZFramePool;
+
+    void
+    recycle(void)
+    {
+      m_dests.clear();
+    }
+
     uint32_t m_z_to_write;
-    std::vector<change_header_z> m_dests;
+
+    /* locations of the z-value in the store of the PainterDraw,
+       the headers of the draws refer to them instead of holding
+       the z-value (see PainterHeader::z_indirect_bit), so the
+       headers are never written again.
+     */
+    std::vector<uint32_t*> m_dests;
   };
 
   class ZDataCallBack:public fastuidraw::PainterPacker::DataCallBack
   {
   public:
+    explicit
+    ZDataCallBack(ZFramePool *pool):
+      m_pool(pool)
+    {}
+
     virtual
     void
-    current_draw(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> &h)
-    {
-      if(h != m_cmd)
-        {
-          m_cmd = h;
-          m_current = FASTUIDRAWnew ZDelayedAction();
-          m_actions.push_back(m_current);
-          m_cmd->add_action(m_current);
-        }
-    }
+    current_draw(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> &h);
 
     virtual
     void
     header_added(const fastuidraw::PainterHeader &original_value,
                  fastuidraw::c_array<fastuidraw::generic_data> mapped_location)
     {
-      m_current->m_dests.push_back(change_header_z(original_value, mapped_location));
+      FASTUIDRAWunused(original_value);
+      FASTUIDRAWunused(mapped_location);
+    }
+
+    virtual
+    bool
+    indirect_z(void) const
+    {
+      return true;
     }
 
+    virtual
+    void
+    z_value_added(fastuidraw::c_array<fastuidraw::generic_data> mapped_location);
+
     std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PainterDraw::DelayedAction> > m_actions;
 
   private:
+    friend class ZFramePool;
+
+    void
+    recycle(void)
+    {
+      m_actions.clear();
+      m_cmd = NULL;
+      m_current = NULL;
+    }
+
+    ZFramePool *m_pool;
     fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> m_cmd;
     fastuidraw::reference_counted_ptr<ZDelayedAction> m_current;
   };
 
+  /* The ZDataCallBack and ZDelayedAction objects of the clipping
+     are only alive during a frame: every occluder is popped by
+     Painter::end() which performs all the ZDelayedAction objects.
+     Instead of allocating and freeing them on each clipping, a
+     ZFramePool hands out objects made during earlier frames and
+     its reset(), called by Painter::end(), makes all of them
+     available again for the next frame.
+   */
+  class ZFramePool:fastuidraw::noncopyable
+  {
+  public:
+    /* allocation_counter is incremented for each object made
+       during a frame, see PainterPacker::num_unbudgeted_allocations
+     */
+    explicit
+    ZFramePool(unsigned int &allocation_counter):
+      m_data_call_backs_used(0),
+      m_delayed_actions_used(0),
+      m_allocation_counter(allocation_counter)
+    {}
+
+    const fastuidraw::reference_counted_ptr<ZDataCallBack>&
+    data_call_back(void)
+    {
+      if(m_data_call_backs_used == m_data_call_backs.size())
+        {
+          FASTUIDRAWincrement_stat(m_allocation_counter, 1u);
+          m_data_call_backs.push_back(FASTUIDRAWnew ZDataCallBack(this));
+        }
+      return m_data_call_backs[m_data_call_backs_used++];
+    }
+
+    const fastuidraw::reference_counted_ptr<ZDelayedAction>&
+    delayed_action(void)
+    {
+      if(m_delayed_actions_used == m_delayed_actions.size())
+        {
+          FASTUIDRAWincrement_stat(m_allocation_counter, 1u);
+          m_delayed_actions.push_back(FASTUIDRAWnew ZDelayedAction());
+        }
+      return m_delayed_actions[m_delayed_actions_used++];
+    }
+
+    /* make the objects ahead of time, only
+       to be called outside of a frame.
+     */
+    void
+    reserve(unsigned int data_call_backs, unsigned int delayed_actions)
+    {
+      assert(m_data_call_backs_used == 0);
+      assert(m_delayed_actions_used == 0);
+      m_data_call_backs.reserve(data_call_backs);
+      while(m_data_call_backs.size() < data_call_backs)
+        {
+          m_data_call_backs.push_back(FASTUIDRAWnew ZDataCallBack(this));
+          m_data_call_backs.back()->m_actions.reserve(delayed_actions / fastuidraw::t_max(1u, data_call_backs));
+        }
+
+      m_delayed_actions.reserve(delayed_actions);
+      while(m_delayed_actions.size() < delayed_actions)
+        {
+          m_delayed_actions.push_back(FASTUIDRAWnew ZDelayedAction());
+        }
+    }
+
+    unsigned int&
+    allocation_counter(void)
+    {
+      return m_allocation_counter;
+    }
+
+    void
+    reset(void)
+    {
+      /* release the handles the objects hold so that
+         the PainterDraw objects of the frame are not
+         kept alive by the pool.
+       */
+      for(unsigned int i = 0; i < m_data_call_backs_used; ++i)
+        {
+          m_data_call_backs[i]->recycle();
+        }
+
+      for(unsigned int i = 0; i < m_delayed_actions_used; ++i)
+        {
+          m_delayed_actions[i]->recycle();
+        }
+      m_data_call_backs_used = 0;
+      m_delayed_actions_used = 0;
+    }
+
+  private:
+    std::vector<fastuidraw::reference_counted_ptr<ZDataCallBack> > m_data_call_backs;
+    std::vector<fastuidraw::reference_counted_ptr<ZDelayedAction> > m_delayed_actions;
+    unsigned int m_data_call_backs_used, m_delayed_actions_used;
+    unsigned int &m_allocation_counter;
+  };
+
+  void
+  ZDataCallBack::
+  current_draw(const fastuidraw::reference_counted_ptr<const fastuidraw::PainterDraw> &h)
+  {
+    if(h != m_cmd)
+      {
+        m_cmd = h;
+        m_current = m_pool->delayed_action();
+        fastuidraw::counted_push_back(m_actions,
+                                      fastuidraw::reference_counted_ptr<fastuidraw::PainterDraw::DelayedAction>(m_current),
+                                      m_pool->allocation_counter());
+        m_cmd->add_action(m_current);
+      }
+  }
+
+  void
+  ZDataCallBack::
+  z_value_added(fastuidraw::c_array<fastuidraw::generic_data> mapped_location)
+  {
+    fastuidraw::counted_push_back(m_current->m_dests, &mapped_location[0].u,
+                                  m_pool->allocation_counter());
+  }
+
   bool
   all_pts_culled_by_one_half_plane(const fastuidraw::vecN<fastuidraw::vec3, 4> &pts,
                                    const fastuidraw::PainterClipEquations &eq)
@@ -253,6 +413,54 @@ namespace
     fastuidraw::vec2 m_min, m_max;
   };
 
+  /* A small direct mapped cache of the packed values of the
+     item matrices most recently used. A PainterPackedValue is
+     packed at most once per PainterDraw, so drawing with a matrix
+     equal to a recent one, for example a widget tree doing
+     save(), translate(), draw and restore() with the same
+     translation many times, then reuses the same block of the
+     data store instead of packing the matrix again.
+   */
+  class item_matrix_cache
+  {
+  public:
+    explicit
+    item_matrix_cache(fastuidraw::PainterPackedValuePool &pool):
+      m_pool(pool)
+    {}
+
+    const fastuidraw::PainterPackedValue<fastuidraw::PainterItemMatrix>&
+    fetch(const fastuidraw::PainterItemMatrix &m)
+    {
+      const fastuidraw::vecN<float, 9> &raw(m.m_item_matrix.raw_data());
+      uint32_t hash(2166136261u);
+
+      for(unsigned int i = 0; i < 9; ++i)
+        {
+          uint32_t v;
+
+          std::memcpy(&v, &raw[i], sizeof(v));
+          hash = (hash ^ v) * 16777619u;
+        }
+
+      fastuidraw::PainterPackedValue<fastuidraw::PainterItemMatrix> &entry(m_entries[hash % cache_size]);
+      if(!entry || entry.value().m_item_matrix.raw_data() != raw)
+        {
+          entry = m_pool.create_packed_value(m);
+        }
+      return entry;
+    }
+
+  private:
+    enum
+      {
+        cache_size = 64
+      };
+
+    fastuidraw::PainterPackedValuePool &m_pool;
+    fastuidraw::vecN<fastuidraw::PainterPackedValue<fastuidraw::PainterItemMatrix>, cache_size> m_entries;
+  };
+
   /* Tracks the most recent clipping rect:
      - the 4 clip equations in clip-coordinates
      - the current transformation from item coordinates
@@ -331,11 +539,11 @@ namespace
     }
 
     const fastuidraw::PainterPackedValue<fastuidraw::PainterItemMatrix>&
-    current_item_marix_state(fastuidraw::PainterPackedValuePool &pool)
+    current_item_marix_state(item_matrix_cache &cache)
     {
       if(!m_item_matrix_state)
         {
-          m_item_matrix_state = pool.create_packed_value(m_item_matrix);
+          m_item_matrix_state = cache.fetch(m_item_matrix);
         }
       return m_item_matrix_state;
     }
@@ -396,34 +604,207 @@ namespace
     fastuidraw::float3x3 m_item_matrix_inverse_transpose;
   };
 
+  class PainterPrivate;
+
   class occluder_stack_entry
   {
   public:
-    /* steals the data it does.
+    occluder_stack_entry(void):
+      m_stencil_clip_depth(0)
+    {}
+
+    /* the actions of pz are performed on popping; pz is
+       of the ZFramePool and so is alive until Painter::end(),
+       which pops all entries. Keeping pz instead of its
+       actions keeps the entry free of memory to allocate
+       and lets pz reuse the room of its actions next frame.
      */
-    explicit
-    occluder_stack_entry(std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PainterDraw::DelayedAction> > &pz)
+    void
+    set_occluder_z(const fastuidraw::reference_counted_ptr<ZDataCallBack> &pz)
     {
-      m_set_occluder_z.swap(pz);
+      m_set_occluder_z = pz;
     }
 
+    /* entry of a clipping with the stencil buffer that
+       raised the stencil value of the clipping region
+       to stencil_clip_depth.
+     */
+    explicit
+    occluder_stack_entry(unsigned int stencil_clip_depth):
+      m_stencil_clip_depth(stencil_clip_depth)
+    {}
+
     void
-    on_pop(fastuidraw::Painter *p);
+    on_pop(fastuidraw::Painter *p, PainterPrivate *d);
 
   private:
-    /* action to execute on popping.
+    /* holds the actions to execute on popping.
+     */
+    fastuidraw::reference_counted_ptr<ZDataCallBack> m_set_occluder_z;
+
+    /* if non-zero, the entry is of a clipping with the
+       stencil buffer and there are no occluders.
+     */
+    unsigned int m_stencil_clip_depth;
+  };
+
+  /* The key of a PainterClipCache is everything on which
+     the packed occluder depends: the TessellatedPath (which
+     also captures the curve flatness), the fill rule and the
+     transformation, clipping and resolution of the Painter.
+   */
+  class PainterClipCachePrivate
+  {
+  public:
+    PainterClipCachePrivate(void):
+      m_fill_rule(fastuidraw::PainterEnums::nonzero_fill_rule)
+    {}
+
+    bool
+    matches(const fastuidraw::reference_counted_ptr<const fastuidraw::TessellatedPath> &path,
+            enum fastuidraw::PainterEnums::fill_rule_t fill_rule,
+            const fastuidraw::float3x3 &item_matrix,
+            const fastuidraw::PainterClipEquations &clip_equations,
+            const fastuidraw::vec2 &resolution) const
+    {
+      return m_stream
+        && m_path == path
+        && m_fill_rule == fill_rule
+        && m_item_matrix.raw_data() == item_matrix.raw_data()
+        && m_clip_equations.same_clipping(clip_equations)
+        && m_resolution == resolution;
+    }
+
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterPackerStream> m_stream;
+    fastuidraw::reference_counted_ptr<const fastuidraw::TessellatedPath> m_path;
+    enum fastuidraw::PainterEnums::fill_rule_t m_fill_rule;
+    fastuidraw::float3x3 m_item_matrix;
+    fastuidraw::PainterClipEquations m_clip_equations;
+    fastuidraw::vec2 m_resolution;
+  };
+
+  /* The key of a PainterLayerCache is the rect of the
+     layer and the size in pixels of its surface.
+   */
+  class PainterLayerCachePrivate
+  {
+  public:
+    PainterLayerCachePrivate(void):
+      m_valid(false)
+    {}
+
+    bool
+    matches(const fastuidraw::vec2 &xy, const fastuidraw::vec2 &wh,
+            const fastuidraw::ivec2 &sz) const
+    {
+      return m_valid
+        && m_xy == xy
+        && m_wh == wh
+        && m_size == sz;
+    }
+
+    /* m_target may be kept while m_valid is false,
+       to draw the layer again to the same surface.
+     */
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend::RenderTarget> m_target;
+    bool m_valid;
+    fastuidraw::vec2 m_xy, m_wh;
+    fastuidraw::ivec2 m_size;
+  };
+
+  /* an entry of PainterPrivate::m_layer_stack, one for
+     each Painter::begin_layer() not yet ended.
+   */
+  class layer_stack_entry
+  {
+  public:
+    layer_stack_entry(void):
+      m_offscreen(false),
+      m_retained(false),
+      m_xy(0.0f, 0.0f),
+      m_wh(0.0f, 0.0f),
+      m_size(0, 0),
+      m_opacity(1.0f),
+      m_blur_radius(0.0f),
+      m_drop_shadow(false),
+      m_shadow_offset(0.0f, 0.0f),
+      m_shadow_color(0.0f, 0.0f, 0.0f, 0.0f),
+      m_resolution(0.0f, 0.0f),
+      m_stencil_clip_depth(0)
+    {}
+
+    /* the surface end_layer() composites, NULL if the
+       content of the layer is drawn directly
      */
-    std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PainterDraw::DelayedAction> > m_set_occluder_z;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend::RenderTarget> m_target;
+
+    /* true if the content of the layer is drawn to m_target,
+       false if m_target is of a valid PainterLayerCache
+     */
+    bool m_offscreen;
+
+    /* true if m_target is retained by a PainterLayerCache,
+       in which case it must not be blurred in place
+     */
+    bool m_retained;
+
+    /* the layer covers the rect [m_xy, m_xy + m_wh] and
+       a region of m_size pixels at the origin of m_target
+     */
+    fastuidraw::vec2 m_xy, m_wh;
+    fastuidraw::ivec2 m_size;
+    float m_opacity;
+
+    /* filter applied when compositing, set by
+       Painter::end_layer_blurred() and
+       Painter::end_layer_drop_shadow()
+     */
+    float m_blur_radius;
+    bool m_drop_shadow;
+    fastuidraw::vec2 m_shadow_offset;
+    fastuidraw::vec4 m_shadow_color;
+
+    /* state of the enclosing surface restored at end_layer()
+       if m_offscreen is true; as the damage region does not
+       apply within the layer, it is swapped out of the Painter
+       together with the stream damage.
+     */
+    fastuidraw::vec2 m_resolution;
+    unsigned int m_stencil_clip_depth;
+    std::vector<fastuidraw::vec4> m_damage_region, m_stream_damage;
   };
 
+  /* A state_stack_entry is copy-on-write: Painter::save() only
+     records the position in the occluder stack and the other
+     fields are copied from the Painter the first time the Painter
+     modifies them after the save(), see PainterPrivate::save_state();
+     m_saved holds which of the fields were copied and only those
+     are restored by Painter::restore().
+   */
   class state_stack_entry
   {
   public:
+    enum saved_state_t
+      {
+        saved_blend = 1,
+        saved_clip_rect_state = 2,
+        saved_curve_flatness = 4,
+
+        /* the clip equations of PainterPrivate::m_clip_store
+           were pushed, i.e. ClipEquationStore::push() called
+         */
+        saved_clip_equations = 8,
+      };
+
+    state_stack_entry(unsigned int occluder_stack_position = 0):
+      m_occluder_stack_position(occluder_stack_position),
+      m_saved(0u)
+    {}
+
     unsigned int m_occluder_stack_position;
+    uint32_t m_saved;
     fastuidraw::reference_counted_ptr<fastuidraw::PainterBlendShader> m_blend;
     fastuidraw::BlendMode::packed_value m_blend_mode;
-    fastuidraw::range_type<unsigned int> m_clip_equation_series;
-
     clip_rect_state m_clip_rect_state;
     float m_curve_flatness;
   };
@@ -455,13 +836,31 @@ namespace
   class ClipEquationStore
   {
   public:
-    ClipEquationStore(void)
+    /* allocation_counter is incremented each time the store
+       grows, see PainterPacker::num_unbudgeted_allocations
+     */
+    explicit
+    ClipEquationStore(unsigned int &allocation_counter):
+      m_allocation_counter(allocation_counter)
     {}
 
+    void
+    reserve(unsigned int depth, unsigned int number_equations)
+    {
+      m_sz.reserve(depth);
+      m_store.reserve(number_equations);
+      m_current.reserve(number_equations);
+    }
+
     void
     push(void)
     {
-      m_sz.push_back(m_store.size());
+      fastuidraw::counted_push_back(m_sz, static_cast<unsigned int>(m_store.size()),
+                                    m_allocation_counter);
+      if(m_store.size() + m_current.size() > m_store.capacity())
+        {
+          FASTUIDRAWincrement_stat(m_allocation_counter, 1u);
+        }
       m_store.resize(m_store.size() + m_current.size());
       std::copy(m_current.begin(), m_current.end(), m_store.begin() + m_sz.back());
     }
@@ -480,6 +879,10 @@ namespace
     void
     set_current(fastuidraw::const_c_array<fastuidraw::vec3> new_equations)
     {
+      if(new_equations.size() > m_current.capacity())
+        {
+          FASTUIDRAWincrement_stat(m_allocation_counter, 1u);
+        }
       m_current.resize(new_equations.size());
       std::copy(new_equations.begin(), new_equations.end(), m_current.begin());
     }
@@ -487,7 +890,7 @@ namespace
     void
     add_to_current(const fastuidraw::vec3 &c)
     {
-      m_current.push_back(c);
+      fastuidraw::counted_push_back(m_current, c, m_allocation_counter);
     }
 
     void
@@ -524,6 +927,7 @@ namespace
     std::vector<fastuidraw::vec3> m_store;
     std::vector<unsigned int> m_sz;
     std::vector<fastuidraw::vec3> m_current;
+    unsigned int &m_allocation_counter;
   };
 
   class PainterWorkRoom
@@ -533,13 +937,24 @@ namespace
     std::vector<fastuidraw::const_c_array<fastuidraw::PainterIndex> > m_index_chunks;
     std::vector<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > m_attrib_chunks;
     std::vector<int> m_index_adjusts;
+    std::vector<fastuidraw::vec3> m_local_clip_eqs;
+    std::vector<fastuidraw::BlendMode> m_stencil_cover_ops;
     std::vector<fastuidraw::vec2> m_pts_draw_convex_polygon;
     fastuidraw::vecN<std::vector<fastuidraw::vec2>, 2> m_pts_update_clip_series;
     std::vector<float> m_clipper_floats;
     fastuidraw::vecN<std::vector<fastuidraw::vec2>, 2> m_clipper_vec2s;
     std::vector<fastuidraw::PainterIndex> m_indices;
     std::vector<fastuidraw::PainterAttribute> m_attribs;
+    std::vector<fastuidraw::vec2> m_batch_pts;
+    std::vector<fastuidraw::range_type<unsigned int> > m_batch_attrib_ranges, m_batch_index_ranges;
+    std::vector<unsigned int> m_glyph_chunks;
+    std::vector<const fastuidraw::GlyphRun*> m_batch_runs;
+    std::vector<fastuidraw::PainterItemMatrix> m_instance_matrices;
+    std::vector<fastuidraw::PainterBrush> m_instance_brushes;
+    std::vector<fastuidraw::PainterPackerData> m_instance_data;
     std::vector<unsigned int> m_edge_chunks;
+    std::vector<unsigned int> m_join_chunks;
+    std::vector<unsigned int> m_cap_chunks;
     std::vector<unsigned int> m_stroke_dashed_join_chunks;
     std::vector<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > m_stroke_attrib_chunks;
     std::vector<fastuidraw::const_c_array<fastuidraw::PainterIndex> > m_stroke_index_chunks;
@@ -548,6 +963,52 @@ namespace
     fastuidraw::FilledPath::ScratchSpace m_filled_path_scratch;
   };
 
+  enum rect_clip_t
+    {
+      rect_clipped_away,
+      rect_partially_clipped,
+      rect_not_clipped
+    };
+
+  /* accumulates the recorded boxes (see
+     PainterPrivate::m_recorded_draw_bounded) of the
+     parts of a draw whose parts are classified one
+     at a time.
+   */
+  class recorded_bounds
+  {
+  public:
+    recorded_bounds(void):
+      m_bounded(true),
+      m_have_bounds(false)
+    {}
+
+    void
+    add(bool bounded, const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax)
+    {
+      if(!bounded)
+        {
+          m_bounded = false;
+        }
+      else if(!m_have_bounds)
+        {
+          m_have_bounds = true;
+          m_min = pmin;
+          m_max = pmax;
+        }
+      else
+        {
+          m_min.x() = fastuidraw::t_min(m_min.x(), pmin.x());
+          m_min.y() = fastuidraw::t_min(m_min.y(), pmin.y());
+          m_max.x() = fastuidraw::t_max(m_max.x(), pmax.x());
+          m_max.y() = fastuidraw::t_max(m_max.y(), pmax.y());
+        }
+    }
+
+    bool m_bounded, m_have_bounds;
+    fastuidraw::vec2 m_min, m_max;
+  };
+
   class PainterPrivate
   {
   public:
@@ -574,10 +1035,33 @@ namespace
                  unsigned int z,
                  const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
 
+    void
+    draw_generic_check(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                       const fastuidraw::PainterData &draw,
+                       unsigned int number_attributes,
+                       unsigned int number_indices,
+                       const fastuidraw::PainterPacker::DataWriter &writer,
+                       unsigned int z,
+                       const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+
+    /* the PainterPackerData of a draw, i.e. draw with the
+       current clipping and transformation
+     */
+    fastuidraw::PainterPackerData
+    packer_data(const fastuidraw::PainterData &draw);
+
     bool
     update_clip_equation_series(const fastuidraw::vec2 &pmin,
                                 const fastuidraw::vec2 &pmax);
 
+    /* Called before the state named by the bit field of
+       state_stack_entry::saved_state_t values is modified, to
+       copy it to the top of m_state_stack if it has not yet
+       been copied since the last Painter::save().
+     */
+    void
+    save_state(uint32_t state);
+
     float
     select_path_thresh(const fastuidraw::Path &path);
 
@@ -587,38 +1071,442 @@ namespace
     float
     select_path_thresh_perspective(const fastuidraw::Path &path);
 
+    /* classify the rect [pmin, pmax] in local coordinates against
+       the current clip equations; a draw inside of a rect that is
+       rect_clipped_away need not be drawn at all and one inside a
+       rect that is rect_not_clipped does not need the clip equations.
+       The test is conservative: a rect that is clipped away can be
+       classified as rect_partially_clipped, as it always is while
+       recording. A rect that misses the damage region (see
+       Painter::damage_region()) is also rect_clipped_away. While
+       recording, the rect is the bounds of the next draw recorded,
+       see m_recorded_draw_bounded.
+     */
+    enum rect_clip_t
+    classify_rect(const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax);
+
+    /* write to out_min and out_max the bounding box of the rect
+       [pmin, pmax] transformed by m and projected, i.e. divided
+       by the z-coordinate; returns false if a corner of the rect
+       has a z-coordinate that is not positive, in which case the
+       box is not known.
+     */
+    static
+    bool
+    projected_rect(const fastuidraw::float3x3 &m,
+                   const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax,
+                   fastuidraw::vec2 *out_min, fastuidraw::vec2 *out_max);
+
+    /* while recording, mark the next draw recorded as opaque (see
+       PainterPackerStream::opaque_box()) if the convex polygon pts,
+       drawn unclipped with the default fill shader, covers exactly
+       its recorded box with a color that does not depend on what
+       is behind it.
+     */
     void
-    compute_edge_chunks(const fastuidraw::StrokedPath &stroked_path,
-                        const fastuidraw::PainterShaderData::DataBase *raw_data,
-                        const fastuidraw::StrokingDataSelectorBase &selector,
-                        bool close_countours,
-                        std::vector<unsigned int> &out_chunks);
+    mark_recorded_draw_opaque(const fastuidraw::PainterData &draw,
+                              fastuidraw::const_c_array<fastuidraw::vec2> pts);
 
-    fastuidraw::vec2 m_resolution;
-    fastuidraw::vec2 m_one_pixel_width;
-    float m_curve_flatness;
-    unsigned int m_current_z;
-    clip_rect_state m_clip_rect_state;
-    std::vector<occluder_stack_entry> m_occluder_stack;
-    std::vector<state_stack_entry> m_state_stack;
-    fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker> m_core;
-    fastuidraw::PainterPackedValuePool m_pool;
-    fastuidraw::PainterPackedValue<fastuidraw::PainterBrush> m_reset_brush, m_black_brush;
-    fastuidraw::PainterPackedValue<fastuidraw::PainterItemMatrix> m_identiy_matrix;
-    ClipEquationStore m_clip_store;
-    PainterWorkRoom m_work_room;
-    unsigned int m_max_attribs_per_block, m_max_indices_per_block;
-  };
+    /* projected_rect() with m mapping to clip coordinates
+       followed by the mapping to pixels
+     */
+    bool
+    pixel_rect(const fastuidraw::float3x3 &m,
+               const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax,
+               fastuidraw::vec2 *out_min, fastuidraw::vec2 *out_max) const;
+
+    /* returns true if the box [pmin, pmax] in pixels misses
+       all rects of m_damage_region, each enlarged by a pixel
+       for the anti-alias fuzz that extends past the boxes of
+       fills and glyphs.
+     */
+    bool
+    misses_damage(const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax) const;
 
-  inline
-  unsigned int
-  chunk_for_stroking(bool close_contours)
-  {
-    return close_contours ?
-      fastuidraw::StrokedPath::join_chunk_with_closing_edge:
-      fastuidraw::StrokedPath::join_chunk_without_closing_edge;
-  }
-}
+    /* returns a surface of at least sz pixels taken from
+       m_free_render_targets or created by m_backend, which
+       returns NULL if it does not support render targets.
+     */
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend::RenderTarget>
+    acquire_render_target(const fastuidraw::ivec2 &sz);
+
+    /* returns true if Path::tight_bounding_box() of path is
+       rect_clipped_away, i.e. filling the path draws nothing
+       and its tessellation is not needed.
+     */
+    bool
+    path_is_culled(const fastuidraw::Path &path);
+
+    /* classify_rect() of the bounding box of the points pts */
+    enum rect_clip_t
+    classify_points(fastuidraw::const_c_array<fastuidraw::vec2> pts);
+
+    /* classify_rect() of the bounding box of the glyphs of a chunk
+       of glyph attributes packed as by PainterAttributeDataFillerGlyphs
+     */
+    enum rect_clip_t
+    classify_glyphs(fastuidraw::const_c_array<fastuidraw::PainterAttribute> attribs,
+                    bool instanced);
+
+    /* set m_work_room.m_local_clip_eqs to the current clip
+       equations in local coordinates.
+     */
+    void
+    ready_local_clip_equations(void);
+
+    /* Append to dst the index data of those clusters of an index
+       chunk that are not culled by m_work_room.m_local_clip_eqs,
+       merging consecutive clusters that are not culled. Returns
+       false if no cluster is culled, in which case nothing is
+       appended and the index chunk should be used whole.
+     */
+    bool
+    select_visible_clusters(fastuidraw::const_c_array<fastuidraw::FilledPath::Subset::Cluster> clusters,
+                            fastuidraw::const_c_array<fastuidraw::PainterIndex> index_chunk,
+                            std::vector<fastuidraw::const_c_array<fastuidraw::PainterIndex> > &dst);
+
+    /* append to m_work_room the index chunks of the anti-alias
+       fuzz of the edges of a subset between a region that the
+       fill rule accepts and a region it does not, together with
+       the attribute chunk of the fuzz if any index chunk is
+       appended.
+     */
+    void
+    add_aa_fuzz_chunks(const fastuidraw::FilledPath::Subset &subset,
+                       const fastuidraw::Painter::CustomFillRuleBase &fill_rule);
+
+    /* set m_work_room.m_stencil_cover_ops to the passes that
+       draw the bounding box of a path where the stencil test
+       accepts the winding numbers of the fill rule; the passes
+       are empty if nothing is to be drawn. A single pass with
+       BlendMode::STENCIL_OFF indicates that all of the bounding
+       box is drawn.
+     */
+    void
+    ready_stencil_cover_ops(enum fastuidraw::PainterEnums::fill_rule_t fill_rule);
+
+    void
+    ready_stencil_cover_ops(const fastuidraw::TessellatedPath &path,
+                            const fastuidraw::Painter::CustomFillRuleBase &fill_rule);
+
+    /* fill a path with stencil-then-cover: the triangle fans of the
+       contours of path add the winding number of each pixel to the
+       stencil buffer, then the bounding box of path is drawn with
+       each of m_work_room.m_stencil_cover_ops and lastly the stencil
+       buffer is cleared where it is still non-zero.
+     */
+    void
+    stencil_fill_path(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                      const fastuidraw::PainterData &draw,
+                      const fastuidraw::TessellatedPath &path,
+                      const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+
+    /* draw the triangle fan of each contour of path, flushing
+       the fans to draw_generic() whenever a block is full.
+     */
+    void
+    draw_contour_fans(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                      const fastuidraw::PainterData &draw,
+                      const fastuidraw::TessellatedPath &path,
+                      const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+
+    void
+    draw_rect_single_chunk(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                           const fastuidraw::PainterData &draw,
+                           const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax,
+                           const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+
+    /* draw the quads of pts (4 points each) with a single
+       draw_generic(), see Painter::draw_quads().
+     */
+    void
+    draw_quads(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+               const fastuidraw::PainterData &draw,
+               fastuidraw::const_c_array<fastuidraw::vec2> pts,
+               const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+
+    /* draw the single quad of a rounded rect or box shadow, see
+       Painter::draw_rounded_rect() and Painter::draw_box_shadow();
+       blur_sigma is 0 for a rounded rect.
+     */
+    void
+    draw_rounded_rect(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                      const fastuidraw::PainterData &draw,
+                      const fastuidraw::vec2 &p, const fastuidraw::vec2 &wh,
+                      float corner_radius, float blur_sigma,
+                      const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back);
+
+    /* returns true if the next clipping is to be done with
+       the stencil buffer: the backend supports it, the draws
+       are not recorded to a PainterPackerStream (the stencil
+       values of the clipping would be those of when it was
+       recorded) and the stencil value of the clipping region
+       can be raised. Otherwise the clipping is done with
+       occluders in the depth buffer.
+     */
+    bool
+    use_stencil_clipping(void)
+    {
+      return m_core->hints().stencil_clipping()
+        && !m_recording && m_stencil_clip_depth < 255u;
+    }
+
+    /* returns true if the next clipping needs occluders but
+       the frame was begun with no_depth_buffer true; then the
+       clipping is rejected: a warning is printed and all
+       content is clipped out until the clipping is restored.
+       To be called once use_stencil_clipping() is false.
+     */
+    bool
+    reject_occluder_clipping(void);
+
+    /* returns the ZDataCallBack with which to draw an occluder;
+       occluders need the depth buffer, so they are not allowed
+       in a frame begun with no_depth_buffer true, see
+       reject_occluder_clipping().
+     */
+    const fastuidraw::reference_counted_ptr<ZDataCallBack>&
+    occluder_data_call_back(void)
+    {
+      assert(!m_no_depth_buffer
+             && "Clipping with occluders in a frame without a depth buffer");
+      return m_z_frame_pool.data_call_back();
+    }
+
+    /* set the blend state to that of blend_porter_duff_dst
+       with the stencil op op against the stencil value value
+     */
+    void
+    stencil_clip_blend(enum fastuidraw::BlendMode::stencil_op_t op, unsigned int value);
+
+    /* draw a rect covering all of the viewport with the
+       current blend state, without the clip equations
+     */
+    void
+    draw_stencil_clip_fullscreen(void);
+
+    /* the draws that raise the stencil value of the new
+       clipping region to m_stencil_clip_depth + 1 have
+       been made; increment m_stencil_clip_depth and push
+       the clipping onto m_occluder_stack.
+     */
+    void
+    push_stencil_clip(void);
+
+    /* clip-in by the fill of path with the stencil buffer,
+       the caller has already clipped-in by its bounding box.
+     */
+    template<typename T>
+    void
+    stencil_clip_in_path(fastuidraw::Painter *p, const fastuidraw::Path &path, const T &fill_rule);
+
+    /* lower the stencil value of the clipping region of the
+       stencil clipping of depth stencil_clip_depth, which is
+       then m_stencil_clip_depth, back to stencil_clip_depth - 1.
+     */
+    void
+    pop_stencil_clip(unsigned int stencil_clip_depth);
+
+    /* returns StrokedPath::dashed_edges() if m_split_dashed_edges
+       is true and the dash pattern can be given as intervals,
+       otherwise returns StrokedPath::edges().
+     */
+    const fastuidraw::PainterAttributeData&
+    select_dashed_edges(const fastuidraw::StrokedPath &stroked_path,
+                        const fastuidraw::DashEvaluatorBase *dash_evaluator,
+                        const fastuidraw::PainterShaderData::DataBase *raw_data,
+                        bool close_contours);
+
+    /* if the stroke is thinner in pixels than m_stroke_lod_pixel_width,
+       replace the joins by bevel or no joins, drop the caps and make
+       thresh coarser; thresh is as returned by select_path_thresh().
+     */
+    void
+    apply_stroke_lod(const fastuidraw::StrokingDataSelectorBase &selector,
+                     const fastuidraw::PainterShaderData::DataBase *raw_data,
+                     float &thresh,
+                     enum fastuidraw::PainterEnums::cap_style &cp,
+                     enum fastuidraw::PainterEnums::join_style &js);
+
+    void
+    compute_edge_chunks(const fastuidraw::StrokedPath &stroked_path,
+                        const fastuidraw::PainterAttributeData &edge_data,
+                        const fastuidraw::PainterShaderData::DataBase *raw_data,
+                        const fastuidraw::StrokingDataSelectorBase &selector,
+                        bool close_countours,
+                        std::vector<unsigned int> &out_chunks);
+
+    void
+    compute_join_chunks(const fastuidraw::StrokedPath &stroked_path,
+                        const fastuidraw::PainterAttributeData &join_data,
+                        const fastuidraw::PainterShaderData::DataBase *raw_data,
+                        const fastuidraw::StrokingDataSelectorBase &selector,
+                        bool close_countours,
+                        std::vector<unsigned int> &out_chunks);
+
+    void
+    compute_cap_chunks(const fastuidraw::StrokedPath &stroked_path,
+                       const fastuidraw::PainterAttributeData &cap_data,
+                       const fastuidraw::PainterShaderData::DataBase *raw_data,
+                       const fastuidraw::StrokingDataSelectorBase &selector,
+                       std::vector<unsigned int> &out_chunks);
+
+    fastuidraw::vec2 m_resolution;
+    fastuidraw::vec2 m_one_pixel_width;
+    float m_curve_flatness;
+    bool m_split_dashed_edges;
+    float m_stroke_lod_pixel_width;
+    unsigned int m_current_z;
+    clip_rect_state m_clip_rect_state;
+    std::vector<occluder_stack_entry> m_occluder_stack;
+    std::vector<state_stack_entry> m_state_stack;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker> m_core;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend> m_backend;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterPackerStream> m_recording;
+    unsigned int m_recording_start_z;
+    int m_alignment;
+    fastuidraw::PainterPackedValuePool m_pool;
+    fastuidraw::PainterPackedValue<fastuidraw::PainterBrush> m_reset_brush, m_black_brush;
+    fastuidraw::PainterPackedValue<fastuidraw::PainterItemMatrix> m_identiy_matrix;
+    item_matrix_cache m_item_matrix_cache;
+
+    /* clip equations that never clip (all are w >= 0), used by
+       draw_generic() in place of the current clip equations when
+       m_draw_unclipped is true, i.e. when the caller has clipped
+       the geometry on CPU or found it to be within the clipping
+       region; such draws then share the same clip equations and
+       never fail the clip test of the fragment shader.
+     */
+    fastuidraw::PainterPackedValue<fastuidraw::PainterClipEquations> m_no_clip_equations;
+    bool m_draw_unclipped;
+
+    /* the rects of Painter::damage_region() as (x, y, w, h) in
+       pixels and the damage of the streams drawn since begin(),
+       see Painter::stream_damage().
+     */
+    std::vector<fastuidraw::vec4> m_damage_region;
+    std::vector<fastuidraw::vec4> m_stream_damage;
+
+    /* The surfaces of the layers of Painter::begin_layer() are
+       pooled: those of the layers of a frame are moved from
+       m_free_render_targets to m_used_render_targets and at
+       Painter::end() return to m_free_render_targets, so that
+       the surfaces not used in a frame are released. Surfaces
+       retained by a PainterLayerCache are not in the pool.
+     */
+    std::vector<layer_stack_entry> m_layer_stack;
+    std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend::RenderTarget> > m_free_render_targets;
+    std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend::RenderTarget> > m_used_render_targets;
+
+    /* if true, the next draw recorded is within the box
+       [m_recorded_draw_min, m_recorded_draw_max] in the
+       coordinates of PainterPackerStream::base_transformation()
+       of m_recording, as set by classify_rect(); otherwise the
+       draw makes the bounding box of the stream unknown.
+     */
+    bool m_recorded_draw_bounded;
+    fastuidraw::vec2 m_recorded_draw_min, m_recorded_draw_max;
+
+    /* if true, the next draw recorded covers the box
+       [m_recorded_draw_min, m_recorded_draw_max] opaquely,
+       as set by mark_recorded_draw_opaque().
+     */
+    bool m_recorded_draw_opaque;
+
+    /* The clipping with the stencil buffer (see use_stencil_clipping())
+       keeps the stencil value of the current clipping region as the
+       number of stencil clippings in effect, m_stencil_clip_depth,
+       with each pixel outside of the region having a smaller value.
+       A clipping draws to increment the stencil value where the new
+       region is and popping the clipping draws to decrement it back.
+       The PainterPacker applies the test against the stencil value
+       to the draws, see PainterPacker::stencil_clip_value(). The
+       fills of the clippings are drawn with m_stencil_clip_fill_shader
+       which does not have anti-aliasing, since the anti-alias fuzz
+       would extend the stencil value past the fill.
+     */
+    unsigned int m_stencil_clip_depth;
+    fastuidraw::PainterFillShader m_stencil_clip_fill_shader;
+
+    /* set by begin(), if true the target is multisampled
+       and anti-aliasing of strokes and fills is skipped.
+     */
+    bool m_multisampled_target;
+
+    /* set by begin(), if true the frame does not use the depth
+       buffer and thus occluders must not be drawn; a clipping
+       needing them is rejected, see reject_occluder_clipping(),
+       with a warning printed once per frame.
+     */
+    bool m_no_depth_buffer;
+    bool m_warned_occluder_clipping;
+    ClipEquationStore m_clip_store;
+    ZFramePool m_z_frame_pool;
+    PainterWorkRoom m_work_room;
+    unsigned int m_max_attribs_per_block, m_max_indices_per_block;
+
+    /* stats that only the Painter can track, see
+       PainterPacker::num_filled_path_subsets_selected
+     */
+    fastuidraw::vecN<unsigned int, fastuidraw::PainterPacker::num_stats> m_stats;
+
+    /* the recorder of Painter::trace() and the depth of the
+       public calls in progress; only the outermost call is
+       recorded, the calls it makes to other public methods
+       are not.
+     */
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterTraceRecorder> m_trace;
+    unsigned int m_trace_depth;
+  };
+
+  /* increments PainterPrivate::m_trace_depth for its lifetime,
+     recorder() returns the recorder to which to record the call
+     or NULL if the call is not to be recorded.
+   */
+  class trace_scope:fastuidraw::noncopyable
+  {
+  public:
+    explicit
+    trace_scope(PainterPrivate *d):
+      m_d(d)
+    {
+      ++m_d->m_trace_depth;
+    }
+
+    ~trace_scope()
+    {
+      --m_d->m_trace_depth;
+    }
+
+    fastuidraw::PainterTraceRecorder*
+    recorder(void) const
+    {
+      return (m_d->m_trace_depth == 1) ? m_d->m_trace.get() : NULL;
+    }
+
+  private:
+    PainterPrivate *m_d;
+  };
+
+  /* true if the draw has item shader data, the trace of a
+     stroke requires the stroking parameters.
+   */
+  inline
+  bool
+  has_item_data(const fastuidraw::PainterData &draw)
+  {
+    return draw.m_item_shader_data.m_packed_value || draw.m_item_shader_data.m_value;
+  }
+
+  inline
+  unsigned int
+  chunk_for_stroking(bool close_contours)
+  {
+    return close_contours ?
+      fastuidraw::StrokedPath::join_chunk_with_closing_edge:
+      fastuidraw::StrokedPath::join_chunk_without_closing_edge;
+  }
+}
 
 //////////////////////////////////////////
 // clip_rect methods
@@ -676,18 +1564,30 @@ scale(float s)
 // occluder_stack_entry methods
 void
 occluder_stack_entry::
-on_pop(fastuidraw::Painter *p)
+on_pop(fastuidraw::Painter *p, PainterPrivate *d)
 {
+  if(m_stencil_clip_depth != 0)
+    {
+      d->pop_stencil_clip(m_stencil_clip_depth);
+      return;
+    }
+
   /* depth test is GL_GEQUAL, so we need to increment the Z
      before hand so that the occluders block all that
      is drawn below them.
    */
   p->increment_z();
-  for(unsigned int i = 0, endi = m_set_occluder_z.size(); i < endi; ++i)
+  if(!m_set_occluder_z)
+    {
+      return;
+    }
+
+  const std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PainterDraw::DelayedAction> > &actions(m_set_occluder_z->m_actions);
+  for(unsigned int i = 0, endi = actions.size(); i < endi; ++i)
     {
       ZDelayedAction *ptr;
-      assert(dynamic_cast<ZDelayedAction*>(m_set_occluder_z[i].get()) != NULL);
-      ptr = static_cast<ZDelayedAction*>(m_set_occluder_z[i].get());
+      assert(dynamic_cast<ZDelayedAction*>(actions[i].get()) != NULL);
+      ptr = static_cast<ZDelayedAction*>(actions[i].get());
       ptr->finalize_z(p->current_z());
     }
 }
@@ -737,9 +1637,11 @@ set_clip_equations_to_clip_rect(const fastuidraw::PainterPackedValue<fastuidraw:
         -y - w * max_y >= 0  --> ( 0, -1, max_y)
        However, the clip equations are in clip coordinates
        so we need to apply the inverse transpose of the
-       transformation matrix to the 4 vectors
+       transformation matrix to the 4 vectors. The rounded
+       corner data (if any) of the current clipping is kept
+       since the new clip rect is intersected against it.
    */
-  fastuidraw::PainterClipEquations cl;
+  fastuidraw::PainterClipEquations cl(m_clip_equations);
   cl.m_clip_equations[0] = inverse_transpose * fastuidraw::vec3( 1.0f,  0.0f, -m_clip_rect.m_min.x());
   cl.m_clip_equations[1] = inverse_transpose * fastuidraw::vec3(-1.0f,  0.0f,  m_clip_rect.m_max.x());
   cl.m_clip_equations[2] = inverse_transpose * fastuidraw::vec3( 0.0f,  1.0f, -m_clip_rect.m_min.y());
@@ -766,15 +1668,18 @@ set_clip_equations_to_clip_rect(const fastuidraw::PainterPackedValue<fastuidraw:
   const fastuidraw::PainterClipEquations &eq(pcl.value());
   const fastuidraw::float3x3 &m(m_item_matrix.m_item_matrix);
   std::bitset<4> return_value;
+  fastuidraw::vecN<fastuidraw::vec2, 4> corners;
   fastuidraw::vecN<fastuidraw::vec3, 4> q;
 
   /* return_value[i] is true exactly when each point of the rectangle is inside
                      the i'th clip equation.
    */
-  q[0] = m * fastuidraw::vec3(m_clip_rect.m_min.x(), m_clip_rect.m_min.y(), 1.0f);
-  q[1] = m * fastuidraw::vec3(m_clip_rect.m_max.x(), m_clip_rect.m_min.y(), 1.0f);
-  q[2] = m * fastuidraw::vec3(m_clip_rect.m_min.x(), m_clip_rect.m_max.y(), 1.0f);
-  q[3] = m * fastuidraw::vec3(m_clip_rect.m_max.x(), m_clip_rect.m_max.y(), 1.0f);
+  corners[0] = fastuidraw::vec2(m_clip_rect.m_min.x(), m_clip_rect.m_min.y());
+  corners[1] = fastuidraw::vec2(m_clip_rect.m_max.x(), m_clip_rect.m_min.y());
+  corners[2] = fastuidraw::vec2(m_clip_rect.m_min.x(), m_clip_rect.m_max.y());
+  corners[3] = fastuidraw::vec2(m_clip_rect.m_max.x(), m_clip_rect.m_max.y());
+  fastuidraw::transform_points(m, fastuidraw::const_c_array<fastuidraw::vec2>(corners),
+                               fastuidraw::c_array<fastuidraw::vec3>(q));
 
   for(int i = 0; i < 4; ++i)
     {
@@ -830,11 +1735,16 @@ rect_is_culled(const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &wh)
      those points are on the wrong size.
    */
   fastuidraw::vec2 pmax(wh + pmin);
+  fastuidraw::vecN<fastuidraw::vec2, 4> corners;
   fastuidraw::vecN<fastuidraw::vec3, 4> pts;
-  pts[0] = m_item_matrix.m_item_matrix * fastuidraw::vec3(pmin.x(), pmin.y(), 1.0f);
-  pts[1] = m_item_matrix.m_item_matrix * fastuidraw::vec3(pmin.x(), pmax.y(), 1.0f);
-  pts[2] = m_item_matrix.m_item_matrix * fastuidraw::vec3(pmax.x(), pmax.y(), 1.0f);
-  pts[3] = m_item_matrix.m_item_matrix * fastuidraw::vec3(pmax.x(), pmin.y(), 1.0f);
+
+  corners[0] = fastuidraw::vec2(pmin.x(), pmin.y());
+  corners[1] = fastuidraw::vec2(pmin.x(), pmax.y());
+  corners[2] = fastuidraw::vec2(pmax.x(), pmax.y());
+  corners[3] = fastuidraw::vec2(pmax.x(), pmin.y());
+  fastuidraw::transform_points(m_item_matrix.m_item_matrix,
+                               fastuidraw::const_c_array<fastuidraw::vec2>(corners),
+                               fastuidraw::c_array<fastuidraw::vec3>(pts));
 
   if(m_clip_rect.m_enabled)
     {
@@ -882,18 +1792,106 @@ PainterPrivate(fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend> bac
   m_resolution(1.0f, 1.0f),
   m_one_pixel_width(1.0f, 1.0f),
   m_curve_flatness(1.0f),
-  m_pool(backend->configuration_base().alignment())
+  m_split_dashed_edges(false),
+  m_stroke_lod_pixel_width(0.0f),
+  m_recording_start_z(0),
+  m_alignment(backend->configuration_base().alignment()),
+  m_pool(m_alignment),
+  m_item_matrix_cache(m_pool),
+  m_draw_unclipped(false),
+  m_recorded_draw_bounded(false),
+  m_recorded_draw_opaque(false),
+  m_stencil_clip_depth(0),
+  m_multisampled_target(false),
+  m_no_depth_buffer(false),
+  m_warned_occluder_clipping(false),
+  m_clip_store(m_stats[fastuidraw::PainterPacker::num_unbudgeted_allocations]),
+  m_z_frame_pool(m_stats[fastuidraw::PainterPacker::num_unbudgeted_allocations]),
+  m_stats(0),
+  m_trace_depth(0)
 {
   m_core = FASTUIDRAWnew fastuidraw::PainterPacker(backend);
+  m_backend = backend;
   m_reset_brush = m_pool.create_packed_value(fastuidraw::PainterBrush());
+  m_no_clip_equations = m_pool.create_packed_value(fastuidraw::PainterClipEquations());
   m_black_brush = m_pool.create_packed_value(fastuidraw::PainterBrush()
                                              .pen(0.0f, 0.0f, 0.0f, 0.0f));
   m_identiy_matrix = m_pool.create_packed_value(fastuidraw::PainterItemMatrix());
+  m_stencil_clip_fill_shader = m_core->default_shaders().fill_shader();
+  m_stencil_clip_fill_shader
+    .anti_alias(false)
+    .coverage(fastuidraw::PainterFillShader::triangulated_coverage);
   m_current_z = 1;
   m_max_attribs_per_block = backend->attribs_per_mapping();
   m_max_indices_per_block = backend->indices_per_mapping();
 }
 
+void
+PainterPrivate::
+save_state(uint32_t state)
+{
+  if(m_state_stack.empty())
+    {
+      return;
+    }
+
+  state_stack_entry &st(m_state_stack.back());
+
+  state &= ~st.m_saved;
+  if(state == 0u)
+    {
+      return;
+    }
+
+  if(state & state_stack_entry::saved_blend)
+    {
+      st.m_blend = m_core->blend_shader();
+      st.m_blend_mode = m_core->blend_mode();
+    }
+
+  if(state & state_stack_entry::saved_clip_rect_state)
+    {
+      st.m_clip_rect_state = m_clip_rect_state;
+    }
+
+  if(state & state_stack_entry::saved_curve_flatness)
+    {
+      st.m_curve_flatness = m_curve_flatness;
+    }
+
+  if(state & state_stack_entry::saved_clip_equations)
+    {
+      m_clip_store.push();
+    }
+
+  st.m_saved |= state;
+}
+
+bool
+PainterPrivate::
+reject_occluder_clipping(void)
+{
+  if(!m_no_depth_buffer)
+    {
+      return false;
+    }
+
+  if(!m_warned_occluder_clipping)
+    {
+      std::cerr << "[" << __FILE__ << ", " << __LINE__
+                << "] fastuidraw::Painter: clipping by a path or by a "
+                << "rect under rotation needs the depth or stencil buffer, "
+                << "but the frame was begun with no_depth_buffer true and "
+                << "stencil clipping is not available; all content is "
+                << "clipped out instead\n";
+      m_warned_occluder_clipping = true;
+    }
+
+  save_state(state_stack_entry::saved_clip_rect_state);
+  m_clip_rect_state.m_all_content_culled = true;
+  return true;
+}
+
 bool
 PainterPrivate::
 update_clip_equation_series(const fastuidraw::vec2 &pmin,
@@ -1011,7 +2009,7 @@ select_path_thresh_perspective(const fastuidraw::Path &path)
   bool r;
   unsigned int src;
 
-  r = path.approximate_bounding_box(&bb_min, &bb_max);
+  r = path.tight_bounding_box(&bb_min, &bb_max);
   if(!r)
     {
       /* it does not matter, since the path is essentially
@@ -1063,6 +2061,13 @@ select_path_thresh_perspective(const fastuidraw::Path &path)
      the bunch.
   */
   float area_local_coords(0.0f), area_pixel_coords(0.0f), ratio;
+  std::vector<fastuidraw::vec2> &pixel_poly(m_work_room.m_clipper_vec2s[1 - src]);
+
+  /* transform each point of the polygon once, instead
+     of once for each of the two edges using it.
+   */
+  pixel_poly.resize(poly.size());
+  fastuidraw::transform_points_projected(m, poly, make_c_array(pixel_poly));
   for(unsigned int i = 0, endi = poly.size(); i < endi; ++i)
     {
       unsigned int next_i;
@@ -1072,12 +2077,8 @@ select_path_thresh_perspective(const fastuidraw::Path &path)
       fastuidraw::vec2 q(poly[next_i]);
       area_local_coords += p.x() * q.y() - q.x() * p.y();
 
-      fastuidraw::vec3 c_p, c_q;
-      c_p = m * fastuidraw::vec3(p.x(), p.y(), 1.0f);
-      c_q = m * fastuidraw::vec3(q.x(), q.y(), 1.0f);
-
-      p = m_resolution * fastuidraw::vec2(c_p.x(), c_p.y()) / c_p.z();
-      q = m_resolution * fastuidraw::vec2(c_q.x(), c_q.y()) / c_q.z();
+      p = m_resolution * pixel_poly[i];
+      q = m_resolution * pixel_poly[next_i];
       area_pixel_coords += p.x() * q.y() - q.x() * p.y();
     }
 
@@ -1109,179 +2110,1880 @@ select_path_thresh(const fastuidraw::Path &path)
     }
 }
 
-void
+enum rect_clip_t
 PainterPrivate::
-compute_edge_chunks(const fastuidraw::StrokedPath &stroked_path,
-                    const fastuidraw::PainterShaderData::DataBase *raw_data,
-                    const fastuidraw::StrokingDataSelectorBase &selector,
-                    bool close_countours,
-                    std::vector<unsigned int> &out_chunks)
+classify_rect(const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax)
 {
-  float pixels_additional_room(0.0f), item_space_additional_room(0.0f);
-  unsigned int sz;
+  const fastuidraw::float3x3 &m(m_clip_rect_state.item_matrix());
+  const fastuidraw::PainterClipEquations &eqs(m_clip_rect_state.clip_equations());
+  fastuidraw::vecN<fastuidraw::vec2, 4> corners;
+  fastuidraw::vecN<fastuidraw::vec3, 4> pts;
+  bool all_inside(true);
+
+  corners[0] = fastuidraw::vec2(pmin.x(), pmin.y());
+  corners[1] = fastuidraw::vec2(pmin.x(), pmax.y());
+  corners[2] = fastuidraw::vec2(pmax.x(), pmax.y());
+  corners[3] = fastuidraw::vec2(pmax.x(), pmin.y());
+  fastuidraw::transform_points(m, fastuidraw::const_c_array<fastuidraw::vec2>(corners),
+                               fastuidraw::c_array<fastuidraw::vec3>(pts));
+  for(unsigned int i = 0; i < 4; ++i)
+    {
+      unsigned int num_outside(0);
+      for(unsigned int j = 0; j < 4; ++j)
+        {
+          if(fastuidraw::dot(pts[j], eqs.m_clip_equations[i]) < 0.0f)
+            {
+              ++num_outside;
+            }
+        }
 
-  out_chunks.resize(stroked_path.maximum_edge_chunks());
-  selector.stroking_distances(raw_data,
-                              &pixels_additional_room,
-                              &item_space_additional_room);
+      /* when recording, the recorded draws can be drawn later
+         with different clipping, see Painter::draw_stream(),
+         so a draw is never culled
+       */
+      if(num_outside == 4 && !m_recording)
+        {
+          return rect_clipped_away;
+        }
+      all_inside = all_inside && num_outside == 0;
+    }
 
-  sz = stroked_path.edge_chunks(m_work_room.m_stroked_path_scratch,
-                                m_clip_store.current(),
-                                m_clip_rect_state.item_matrix(),
-                                m_one_pixel_width,
-                                pixels_additional_room,
-                                item_space_additional_room,
-                                close_countours,
-                                m_max_attribs_per_block,
-                                m_max_indices_per_block,
-                                fastuidraw::make_c_array(out_chunks));
-  assert(sz <= out_chunks.size());
-  out_chunks.resize(sz);
-}
+  if(m_recording)
+    {
+      fastuidraw::float3x3 inverse_base;
 
-void
-PainterPrivate::
-draw_generic(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
-             const fastuidraw::PainterData &draw,
-             fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attrib_chunks,
-             fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
-             fastuidraw::const_c_array<int> index_adjusts,
-             fastuidraw::const_c_array<unsigned int> attrib_chunk_selector,
-             unsigned int z,
-             const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
-{
-  fastuidraw::PainterPackerData p(draw);
-  p.m_clip = m_clip_rect_state.clip_equations_state(m_pool);
-  p.m_matrix = m_clip_rect_state.current_item_marix_state(m_pool);
-  m_core->draw_generic(shader, p, attrib_chunks, index_chunks, index_adjusts, attrib_chunk_selector, z, call_back);
+      m_recording->base_transformation().inverse(inverse_base);
+      m_recorded_draw_bounded = projected_rect(inverse_base * m, pmin, pmax,
+                                               &m_recorded_draw_min, &m_recorded_draw_max);
+    }
+  else if(!m_damage_region.empty())
+    {
+      fastuidraw::vec2 qmin, qmax;
+      if(pixel_rect(m, pmin, pmax, &qmin, &qmax) && misses_damage(qmin, qmax))
+        {
+          return rect_clipped_away;
+        }
+    }
+  return all_inside ? rect_not_clipped : rect_partially_clipped;
 }
 
-void
+bool
 PainterPrivate::
-draw_generic_check(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
-                   const fastuidraw::PainterData &draw,
-                   fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attrib_chunks,
-                   fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
-                   fastuidraw::const_c_array<int> index_adjusts,
-                   fastuidraw::const_c_array<unsigned int> attrib_chunk_selector,
-                   unsigned int z,
-                   const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+projected_rect(const fastuidraw::float3x3 &m,
+               const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax,
+               fastuidraw::vec2 *out_min, fastuidraw::vec2 *out_max)
 {
-  if(!m_clip_rect_state.m_all_content_culled)
+  fastuidraw::vecN<fastuidraw::vec2, 4> corners;
+  fastuidraw::vecN<fastuidraw::vec3, 4> pts;
+
+  corners[0] = fastuidraw::vec2(pmin.x(), pmin.y());
+  corners[1] = fastuidraw::vec2(pmin.x(), pmax.y());
+  corners[2] = fastuidraw::vec2(pmax.x(), pmax.y());
+  corners[3] = fastuidraw::vec2(pmax.x(), pmin.y());
+  fastuidraw::transform_points(m, fastuidraw::const_c_array<fastuidraw::vec2>(corners),
+                               fastuidraw::c_array<fastuidraw::vec3>(pts));
+  for(unsigned int i = 0; i < 4; ++i)
+    {
+      fastuidraw::vec2 p;
+
+      if(pts[i].z() <= 0.0f)
+        {
+          return false;
+        }
+
+      p = fastuidraw::vec2(pts[i].x(), pts[i].y()) / pts[i].z();
+      if(i == 0)
+        {
+          *out_min = *out_max = p;
+        }
+      else
+        {
+          out_min->x() = fastuidraw::t_min(out_min->x(), p.x());
+          out_min->y() = fastuidraw::t_min(out_min->y(), p.y());
+          out_max->x() = fastuidraw::t_max(out_max->x(), p.x());
+          out_max->y() = fastuidraw::t_max(out_max->y(), p.y());
+        }
+    }
+  return true;
+}
+
+void
+PainterPrivate::
+mark_recorded_draw_opaque(const fastuidraw::PainterData &draw,
+                          fastuidraw::const_c_array<fastuidraw::vec2> pts)
+{
+  using namespace fastuidraw;
+
+  const PainterBlendShaderSet &blend_shaders(m_core->default_shaders().blend_shaders());
+  const reference_counted_ptr<PainterBlendShader> &blend(m_core->blend_shader());
+  float3x3 inverse_base, m;
+  vecN<vec3, 4> q;
+  uint32_t corners(0u);
+
+  /* the occluders of clipping are drawn in the depth buffer,
+     a draw of a clipped region does not cover its box
+   */
+  m_recorded_draw_opaque = false;
+  if(pts.size() != 4 || !m_recorded_draw_bounded || !m_occluder_stack.empty()
+     || (blend != blend_shaders.shader(PainterEnums::blend_porter_duff_src)
+         && blend != blend_shaders.shader(PainterEnums::blend_porter_duff_src_over))
+     || (!draw.m_brush.m_packed_value && draw.m_brush.m_value == NULL))
+    {
+      return;
+    }
+
+  const PainterBrush &brush(draw.m_brush.data());
+  if((brush.shader() & (PainterBrush::image_mask | PainterBrush::gradient_mask)) != 0u
+     || brush.pen().w() < 1.0f)
+    {
+      return;
+    }
+
+  /* the polygon covers its box exactly if each of its points
+     is a different corner of the box
+   */
+  m_recording->base_transformation().inverse(inverse_base);
+  m = inverse_base * m_clip_rect_state.item_matrix();
+  transform_points(m, pts, c_array<vec3>(q));
+  for(unsigned int i = 0; i < 4; ++i)
+    {
+      vec2 p;
+      uint32_t cx, cy;
+
+      if(q[i].z() <= 0.0f)
+        {
+          return;
+        }
+
+      p = vec2(q[i].x(), q[i].y()) / q[i].z();
+      if(p.x() == m_recorded_draw_min.x())
+        {
+          cx = 0u;
+        }
+      else if(p.x() == m_recorded_draw_max.x())
+        {
+          cx = 1u;
+        }
+      else
+        {
+          return;
+        }
+
+      if(p.y() == m_recorded_draw_min.y())
+        {
+          cy = 0u;
+        }
+      else if(p.y() == m_recorded_draw_max.y())
+        {
+          cy = 2u;
+        }
+      else
+        {
+          return;
+        }
+      corners |= (1u << (cx + cy));
+    }
+  m_recorded_draw_opaque = (corners == 15u);
+}
+
+bool
+PainterPrivate::
+pixel_rect(const fastuidraw::float3x3 &m,
+           const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax,
+           fastuidraw::vec2 *out_min, fastuidraw::vec2 *out_max) const
+{
+  if(!projected_rect(m, pmin, pmax, out_min, out_max))
+    {
+      return false;
+    }
+
+  /* from normalized device coordinates to pixels */
+  *out_min = 0.5f * (*out_min + fastuidraw::vec2(1.0f)) * m_resolution;
+  *out_max = 0.5f * (*out_max + fastuidraw::vec2(1.0f)) * m_resolution;
+  return true;
+}
+
+bool
+PainterPrivate::
+misses_damage(const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax) const
+{
+  for(std::vector<fastuidraw::vec4>::const_iterator iter = m_damage_region.begin(),
+        end = m_damage_region.end(); iter != end; ++iter)
+    {
+      const fastuidraw::vec4 &R(*iter);
+      if(pmin.x() <= R.x() + R.z() + 1.0f && pmax.x() >= R.x() - 1.0f
+         && pmin.y() <= R.y() + R.w() + 1.0f && pmax.y() >= R.y() - 1.0f)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend::RenderTarget>
+PainterPrivate::
+acquire_render_target(const fastuidraw::ivec2 &sz)
+{
+  fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend::RenderTarget> return_value;
+  unsigned int best(m_free_render_targets.size());
+  int best_area(0);
+
+  /* take the smallest free surface that is large enough */
+  for(unsigned int i = 0, endi = m_free_render_targets.size(); i < endi; ++i)
+    {
+      fastuidraw::ivec2 dims(m_free_render_targets[i]->dimensions());
+      if(dims.x() >= sz.x() && dims.y() >= sz.y()
+         && (best == endi || dims.x() * dims.y() < best_area))
+        {
+          best = i;
+          best_area = dims.x() * dims.y();
+        }
+    }
+
+  if(best < m_free_render_targets.size())
+    {
+      return_value = m_free_render_targets[best];
+      m_free_render_targets[best] = m_free_render_targets.back();
+      m_free_render_targets.pop_back();
+    }
+  else
+    {
+      /* round the size up so that layers of slightly
+         different sizes in different frames share a
+         surface
+       */
+      fastuidraw::ivec2 dims;
+      dims.x() = (sz.x() + render_target_granularity - 1) & ~(render_target_granularity - 1);
+      dims.y() = (sz.y() + render_target_granularity - 1) & ~(render_target_granularity - 1);
+      return_value = m_backend->create_render_target(dims);
+    }
+  return return_value;
+}
+
+bool
+PainterPrivate::
+path_is_culled(const fastuidraw::Path &path)
+{
+  fastuidraw::vec2 pmin, pmax;
+
+  if(!path.tight_bounding_box(&pmin, &pmax))
+    {
+      return false;
+    }
+  return classify_rect(pmin, pmax) == rect_clipped_away;
+}
+
+enum rect_clip_t
+PainterPrivate::
+classify_points(fastuidraw::const_c_array<fastuidraw::vec2> pts)
+{
+  fastuidraw::vec2 pmin, pmax;
+
+  assert(!pts.empty());
+  pmin = pmax = pts[0];
+  for(unsigned int i = 1; i < pts.size(); ++i)
+    {
+      pmin.x() = fastuidraw::t_min(pmin.x(), pts[i].x());
+      pmin.y() = fastuidraw::t_min(pmin.y(), pts[i].y());
+      pmax.x() = fastuidraw::t_max(pmax.x(), pts[i].x());
+      pmax.y() = fastuidraw::t_max(pmax.y(), pts[i].y());
+    }
+  return classify_rect(pmin, pmax);
+}
+
+enum rect_clip_t
+PainterPrivate::
+classify_glyphs(fastuidraw::const_c_array<fastuidraw::PainterAttribute> attribs,
+                bool instanced)
+{
+  using namespace fastuidraw;
+
+  if(attribs.empty())
+    {
+      return rect_clipped_away;
+    }
+
+  /* the position of a glyph vertex is m_attrib1.xy, a
+     glyph instance also has its top right corner in
+     m_attrib1.zw, see detail::pack_glyph_instance().
+   */
+  vec2 pmin, pmax;
+  pmin = pmax = vec2(unpack_float(attribs[0].m_attrib1.x()),
+                     unpack_float(attribs[0].m_attrib1.y()));
+  for(unsigned int i = 0; i < attribs.size(); ++i)
+    {
+      vec2 p;
+
+      p = vec2(unpack_float(attribs[i].m_attrib1.x()),
+               unpack_float(attribs[i].m_attrib1.y()));
+      pmin.x() = t_min(pmin.x(), p.x());
+      pmin.y() = t_min(pmin.y(), p.y());
+      pmax.x() = t_max(pmax.x(), p.x());
+      pmax.y() = t_max(pmax.y(), p.y());
+      if(instanced)
+        {
+          p = vec2(unpack_float(attribs[i].m_attrib1.z()),
+                   unpack_float(attribs[i].m_attrib1.w()));
+          pmin.x() = t_min(pmin.x(), p.x());
+          pmin.y() = t_min(pmin.y(), p.y());
+          pmax.x() = t_max(pmax.x(), p.x());
+          pmax.y() = t_max(pmax.y(), p.y());
+        }
+    }
+  return classify_rect(pmin, pmax);
+}
+
+void
+PainterPrivate::
+ready_local_clip_equations(void)
+{
+  fastuidraw::const_c_array<fastuidraw::vec3> clip_eqs(m_clip_store.current());
+  const fastuidraw::float3x3 &clip_matrix_local(m_clip_rect_state.item_matrix());
+
+  m_work_room.m_local_clip_eqs.resize(clip_eqs.size());
+  for(unsigned int i = 0; i < clip_eqs.size(); ++i)
+    {
+      m_work_room.m_local_clip_eqs[i] = clip_eqs[i] * clip_matrix_local;
+    }
+}
+
+bool
+PainterPrivate::
+select_visible_clusters(fastuidraw::const_c_array<fastuidraw::FilledPath::Subset::Cluster> clusters,
+                        fastuidraw::const_c_array<fastuidraw::PainterIndex> index_chunk,
+                        std::vector<fastuidraw::const_c_array<fastuidraw::PainterIndex> > &dst)
+{
+  using namespace fastuidraw;
+
+  const_c_array<vec3> clip_eqs(make_c_array(m_work_room.m_local_clip_eqs));
+  unsigned int num_culled(0), start(dst.size());
+  range_type<unsigned int> current(0, 0);
+
+  if(clusters.size() < 2)
+    {
+      return false;
+    }
+
+  for(unsigned int c = 0; c < clusters.size(); ++c)
+    {
+      const FilledPath::Subset::Cluster &C(clusters[c]);
+      bool culled(false);
+
+      /* a cluster is culled if all of its bounding box is on the
+         clipped side of a clip equation, i.e. if the corner of
+         the box that is farthest along the normal of the clip
+         equation is clipped.
+       */
+      for(unsigned int e = 0; e < clip_eqs.size() && !culled; ++e)
+        {
+          const vec3 &eq(clip_eqs[e]);
+          float x, y;
+
+          x = (eq.x() >= 0.0f) ? C.m_max_bb.x() : C.m_min_bb.x();
+          y = (eq.y() >= 0.0f) ? C.m_max_bb.y() : C.m_min_bb.y();
+          culled = (eq.x() * x + eq.y() * y + eq.z() < 0.0f);
+        }
+
+      if(culled)
+        {
+          ++num_culled;
+        }
+      else if(current.m_end == C.m_index_range.m_begin && current.m_end != current.m_begin)
+        {
+          current.m_end = C.m_index_range.m_end;
+        }
+      else
+        {
+          if(current.m_end != current.m_begin)
+            {
+              dst.push_back(index_chunk.sub_array(current));
+            }
+          current = C.m_index_range;
+        }
+    }
+
+  if(num_culled == 0)
+    {
+      dst.resize(start);
+      return false;
+    }
+
+  if(current.m_end != current.m_begin)
+    {
+      dst.push_back(index_chunk.sub_array(current));
+    }
+  FASTUIDRAWincrement_stat(m_stats[PainterPacker::num_filled_path_clusters_culled], num_culled);
+  return true;
+}
+
+void
+PainterPrivate::
+add_aa_fuzz_chunks(const fastuidraw::FilledPath::Subset &subset,
+                   const fastuidraw::Painter::CustomFillRuleBase &fill_rule)
+{
+  using namespace fastuidraw;
+
+  const PainterAttributeData &data(subset.aa_painter_data());
+  const_c_array<int> wnd(subset.winding_numbers());
+  unsigned int attrib_selector_value(m_work_room.m_attrib_chunks.size());
+  bool added_chunk(false), has_zero;
+
+  /* the boundary of the path is against winding number 0
+     even if the subset has no triangles of winding number 0.
+   */
+  has_zero = std::binary_search(wnd.begin(), wnd.end(), 0);
+  for(unsigned int a = 0; a < wnd.size(); ++a)
+    {
+      if(!fill_rule(wnd[a]))
+        {
+          continue;
+        }
+
+      for(unsigned int b = 0, endb = has_zero ? wnd.size() : wnd.size() + 1; b < endb; ++b)
+        {
+          int unfilled_winding((b < wnd.size()) ? wnd[b] : 0);
+          unsigned int chunk;
+          const_c_array<PainterIndex> index_chunk;
+
+          if(fill_rule(unfilled_winding))
+            {
+              continue;
+            }
+
+          chunk = FilledPath::Subset::aa_chunk_from_winding_numbers(wnd[a], unfilled_winding);
+          index_chunk = data.index_data_chunk(chunk);
+          if(!index_chunk.empty())
+            {
+              m_work_room.m_index_chunks.push_back(index_chunk);
+              m_work_room.m_index_adjusts.push_back(data.index_adjust_chunk(chunk));
+              m_work_room.m_selector.push_back(attrib_selector_value);
+              added_chunk = true;
+            }
+        }
+    }
+
+  if(added_chunk)
+    {
+      m_work_room.m_attrib_chunks.push_back(data.attribute_data_chunk(0));
+    }
+}
+
+void
+PainterPrivate::
+ready_stencil_cover_ops(enum fastuidraw::PainterEnums::fill_rule_t fill_rule)
+{
+  using namespace fastuidraw;
+
+  BlendMode mode(m_core->blend_mode());
+
+  m_work_room.m_stencil_cover_ops.clear();
+  switch(fill_rule)
+    {
+    case PainterEnums::odd_even_fill_rule:
+      mode.stencil_op(BlendMode::STENCIL_COVER_ODD);
+      break;
+
+    case PainterEnums::complement_odd_even_fill_rule:
+      mode.stencil_op(BlendMode::STENCIL_COVER_EVEN);
+      break;
+
+    case PainterEnums::nonzero_fill_rule:
+      mode.stencil_op(BlendMode::STENCIL_COVER_NON_ZERO);
+      break;
+
+    case PainterEnums::complement_nonzero_fill_rule:
+      mode.stencil_op(BlendMode::STENCIL_COVER_EQUAL).stencil_value(0u);
+      break;
+
+    default:
+      assert(!"Bad fill_rule value");
+      return;
+    }
+  m_work_room.m_stencil_cover_ops.push_back(mode);
+}
+
+void
+PainterPrivate::
+ready_stencil_cover_ops(const fastuidraw::TessellatedPath &path,
+                        const fastuidraw::Painter::CustomFillRuleBase &fill_rule)
+{
+  using namespace fastuidraw;
+
+  BlendMode mode(m_core->blend_mode());
+  int max_winding(0);
+  bool all(true), non_zero(true), odd(true), even(true);
+
+  /* a contour of N edges winds less than N / 2 times around
+     any point because each edge turns less than half a circle
+     about the point; the stencil values are 8-bit, so larger
+     winding numbers alias.
+   */
+  for(unsigned int c = 0, endc = path.number_contours(); c < endc; ++c)
+    {
+      unsigned int num_pts(0);
+      for(unsigned int e = 0, ende = path.number_edges(c); e < ende; ++e)
+        {
+          num_pts += path.edge_range(c, e).difference() - 1;
+        }
+      max_winding += num_pts / 2;
+    }
+  max_winding = t_min(max_winding, 127);
+
+  for(int w = -max_winding; w <= max_winding; ++w)
+    {
+      bool accepted(fill_rule(w));
+      bool is_odd((w & 1) != 0);
+
+      all = all && accepted;
+      non_zero = non_zero && (accepted == (w != 0));
+      odd = odd && (accepted == is_odd);
+      even = even && (accepted != is_odd);
+    }
+
+  m_work_room.m_stencil_cover_ops.clear();
+  if(all)
+    {
+      m_work_room.m_stencil_cover_ops.push_back(mode);
+    }
+  else if(non_zero)
+    {
+      m_work_room.m_stencil_cover_ops.push_back(mode.stencil_op(BlendMode::STENCIL_COVER_NON_ZERO));
+    }
+  else if(odd)
+    {
+      m_work_room.m_stencil_cover_ops.push_back(mode.stencil_op(BlendMode::STENCIL_COVER_ODD));
+    }
+  else if(even)
+    {
+      m_work_room.m_stencil_cover_ops.push_back(mode.stencil_op(BlendMode::STENCIL_COVER_EVEN));
+    }
+  else
+    {
+      mode.stencil_op(BlendMode::STENCIL_COVER_EQUAL);
+      for(int w = -max_winding; w <= max_winding; ++w)
+        {
+          if(fill_rule(w))
+            {
+              m_work_room.m_stencil_cover_ops.push_back(mode.stencil_value(static_cast<uint32_t>(w)));
+            }
+        }
+    }
+}
+
+void
+PainterPrivate::
+draw_rect_single_chunk(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                       const fastuidraw::PainterData &draw,
+                       const fastuidraw::vec2 &pmin, const fastuidraw::vec2 &pmax,
+                       const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  using namespace fastuidraw;
+
+  vecN<PainterAttribute, 4> attribs;
+  vecN<PainterIndex, 6> indices;
+  vecN<const_c_array<PainterAttribute>, 1> attrib_chunk;
+  vecN<const_c_array<PainterIndex>, 1> index_chunk;
+  vecN<int, 1> index_adjust(0);
+
+  attribs[0].m_attrib0 = pack_vec4(pmin.x(), pmin.y(), 0.0f, 0.0f);
+  attribs[1].m_attrib0 = pack_vec4(pmin.x(), pmax.y(), 0.0f, 0.0f);
+  attribs[2].m_attrib0 = pack_vec4(pmax.x(), pmax.y(), 0.0f, 0.0f);
+  attribs[3].m_attrib0 = pack_vec4(pmax.x(), pmin.y(), 0.0f, 0.0f);
+  for(unsigned int i = 0; i < 4; ++i)
+    {
+      attribs[i].m_attrib1 = uvec4(0u, 0u, 0u, 0u);
+      attribs[i].m_attrib2 = uvec4(0u, 0u, 0u, 0u);
+    }
+
+  indices[0] = 0;
+  indices[1] = 1;
+  indices[2] = 2;
+  indices[3] = 0;
+  indices[4] = 2;
+  indices[5] = 3;
+
+  attrib_chunk[0] = const_c_array<PainterAttribute>(attribs.c_ptr(), attribs.size());
+  index_chunk[0] = const_c_array<PainterIndex>(indices.c_ptr(), indices.size());
+  draw_generic(shader, draw, attrib_chunk, index_chunk, index_adjust,
+               const_c_array<unsigned int>(), m_current_z, call_back);
+}
+
+void
+PainterPrivate::
+draw_quads(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+           const fastuidraw::PainterData &draw,
+           fastuidraw::const_c_array<fastuidraw::vec2> pts,
+           const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  using namespace fastuidraw;
+
+  std::vector<PainterAttribute> &attribs(m_work_room.m_attribs);
+  std::vector<PainterIndex> &indices(m_work_room.m_indices);
+  std::vector<range_type<unsigned int> > &attrib_ranges(m_work_room.m_batch_attrib_ranges);
+  std::vector<range_type<unsigned int> > &index_ranges(m_work_room.m_batch_index_ranges);
+  unsigned int chunk_attrib_begin(0), chunk_index_begin(0);
+  bool draw_unclipped(true), cpu_clip;
+  recorded_bounds bounds;
+  PainterAttribute A;
+
+  m_recorded_draw_bounded = false;
+  if(m_clip_rect_state.m_all_content_culled)
+    {
+      return;
+    }
+
+  /* as in Painter::draw_convex_polygon(), a partially clipped
+     quad is clipped on CPU unless the clipping is left to the
+     hardware clip planes, in which case the draw keeps the clip
+     equations.
+   */
+  cpu_clip = !m_core->hints().clipping_via_hw_clip_planes()
+    || (m_clip_rect_state.m_clip_rect.m_enabled
+        && !m_clip_rect_state.item_matrix_transition_tricky());
+
+  A.m_attrib1 = uvec4(0u, 0u, 0u, 0u);
+  A.m_attrib2 = uvec4(0u, 0u, 0u, 0u);
+  attribs.clear();
+  indices.clear();
+  attrib_ranges.clear();
+  index_ranges.clear();
+
+  for(unsigned int q = 0; q + 4 <= pts.size(); q += 4)
+    {
+      const_c_array<vec2> poly(pts.sub_array(q, 4));
+      enum rect_clip_t clip_test;
+      unsigned int first;
+
+      clip_test = classify_points(poly);
+      if(clip_test == rect_clipped_away)
+        {
+          FASTUIDRAWincrement_stat(m_stats[PainterPacker::num_draws_culled], 1u);
+          continue;
+        }
+
+      if(clip_test == rect_partially_clipped)
+        {
+          if(cpu_clip)
+            {
+              m_clip_rect_state.clip_polygon(poly, m_work_room.m_pts_draw_convex_polygon,
+                                             m_work_room.m_clipper_vec2s[0],
+                                             m_work_room.m_clipper_floats);
+              poly = make_c_array(m_work_room.m_pts_draw_convex_polygon);
+              if(poly.size() < 3)
+                {
+                  continue;
+                }
+            }
+          else
+            {
+              draw_unclipped = false;
+            }
+        }
+
+      if(m_recording)
+        {
+          bounds.add(m_recorded_draw_bounded, m_recorded_draw_min, m_recorded_draw_max);
+        }
+
+      /* each chunk must fit in a single PainterDraw */
+      if(attribs.size() - chunk_attrib_begin + poly.size() > m_max_attribs_per_block
+         || indices.size() - chunk_index_begin + 3 * (poly.size() - 2) > m_max_indices_per_block)
+        {
+          attrib_ranges.push_back(range_type<unsigned int>(chunk_attrib_begin, attribs.size()));
+          index_ranges.push_back(range_type<unsigned int>(chunk_index_begin, indices.size()));
+          chunk_attrib_begin = attribs.size();
+          chunk_index_begin = indices.size();
+        }
+
+      first = attribs.size() - chunk_attrib_begin;
+      for(unsigned int i = 0; i < poly.size(); ++i)
+        {
+          A.m_attrib0 = pack_vec4(poly[i].x(), poly[i].y(), 0.0f, 0.0f);
+          attribs.push_back(A);
+        }
+      for(unsigned int i = 2; i < poly.size(); ++i)
+        {
+          indices.push_back(first);
+          indices.push_back(first + i - 1);
+          indices.push_back(first + i);
+        }
+    }
+
+  if(attribs.size() > chunk_attrib_begin)
+    {
+      attrib_ranges.push_back(range_type<unsigned int>(chunk_attrib_begin, attribs.size()));
+      index_ranges.push_back(range_type<unsigned int>(chunk_index_begin, indices.size()));
+    }
+
+  if(attrib_ranges.empty())
+    {
+      m_recorded_draw_bounded = false;
+      return;
+    }
+
+  /* the chunks are made only now since attribs and
+     indices may have been reallocated while filling.
+   */
+  m_work_room.m_attrib_chunks.clear();
+  m_work_room.m_index_chunks.clear();
+  for(unsigned int i = 0; i < attrib_ranges.size(); ++i)
+    {
+      m_work_room.m_attrib_chunks.push_back(make_c_array(attribs).sub_array(attrib_ranges[i]));
+      m_work_room.m_index_chunks.push_back(make_c_array(indices).sub_array(index_ranges[i]));
+    }
+  m_work_room.m_index_adjusts.clear();
+  m_work_room.m_index_adjusts.resize(attrib_ranges.size(), 0);
+
+  if(m_recording)
+    {
+      m_recorded_draw_bounded = bounds.m_bounded && bounds.m_have_bounds;
+      m_recorded_draw_min = bounds.m_min;
+      m_recorded_draw_max = bounds.m_max;
+    }
+
+  m_draw_unclipped = draw_unclipped;
+  draw_generic(shader, draw,
+               make_c_array(m_work_room.m_attrib_chunks),
+               make_c_array(m_work_room.m_index_chunks),
+               make_c_array(m_work_room.m_index_adjusts),
+               const_c_array<unsigned int>(), m_current_z, call_back);
+  m_draw_unclipped = false;
+}
+
+void
+PainterPrivate::
+draw_rounded_rect(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                  const fastuidraw::PainterData &draw,
+                  const fastuidraw::vec2 &p, const fastuidraw::vec2 &wh,
+                  float corner_radius, float blur_sigma,
+                  const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  using namespace fastuidraw;
+
+  vecN<PainterAttribute, 4> attribs;
+  vecN<PainterIndex, 6> indices;
+  vecN<const_c_array<PainterAttribute>, 1> attrib_chunk;
+  vecN<const_c_array<PainterIndex>, 1> index_chunk;
+  vecN<int, 1> index_adjust(0);
+  vec2 half_size, center, margin;
+
+  m_recorded_draw_bounded = false;
+  if(m_clip_rect_state.m_all_content_culled
+     || wh.x() <= 0.0f || wh.y() <= 0.0f)
+    {
+      return;
+    }
+
+  /* the shader extends the quad by 3 * blur_sigma and by a
+     pixel for the anti-aliasing; the pixel is not known in
+     local coordinates, so the culling (and, while recording,
+     the bounds of the draw) does not include it.
+   */
+  half_size = 0.5f * wh;
+  center = p + half_size;
+  margin = vec2(3.0f * blur_sigma);
+  if(classify_rect(p - margin, p + wh + margin) == rect_clipped_away)
+    {
+      FASTUIDRAWincrement_stat(m_stats[PainterPacker::num_draws_culled], 1u);
+      return;
+    }
+
+  corner_radius = t_max(0.0f, t_min(corner_radius, t_min(half_size.x(), half_size.y())));
+  for(unsigned int i = 0; i < 4; ++i)
+    {
+      attribs[i].m_attrib0 = pack_vec4(center.x(), center.y(), half_size.x(), half_size.y());
+      attribs[i].m_attrib1 = pack_vec4(corner_radius, blur_sigma, 0.0f, 0.0f);
+      attribs[i].m_attrib2 = uvec4(0u, 0u, 0u, i);
+    }
+
+  indices[0] = 0;
+  indices[1] = 1;
+  indices[2] = 2;
+  indices[3] = 0;
+  indices[4] = 2;
+  indices[5] = 3;
+
+  attrib_chunk[0] = const_c_array<PainterAttribute>(attribs.c_ptr(), attribs.size());
+  index_chunk[0] = const_c_array<PainterIndex>(indices.c_ptr(), indices.size());
+  draw_generic(shader, draw, attrib_chunk, index_chunk, index_adjust,
+               const_c_array<unsigned int>(), m_current_z, call_back);
+}
+
+void
+PainterPrivate::
+draw_contour_fans(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                  const fastuidraw::PainterData &draw,
+                  const fastuidraw::TessellatedPath &path,
+                  const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  using namespace fastuidraw;
+
+  std::vector<PainterAttribute> &attribs(m_work_room.m_attribs);
+  std::vector<PainterIndex> &indices(m_work_room.m_indices);
+  const_c_array<vec2> pts(path.point_positions());
+  vecN<const_c_array<PainterAttribute>, 1> attrib_chunk;
+  vecN<const_c_array<PainterIndex>, 1> index_chunk;
+  vecN<int, 1> index_adjust(0);
+  PainterAttribute A;
+
+  A.m_attrib1 = uvec4(0u, 0u, 0u, 0u);
+  A.m_attrib2 = uvec4(0u, 0u, 0u, 0u);
+  attribs.clear();
+  indices.clear();
+
+  for(unsigned int c = 0, endc = path.number_contours(); c < endc; ++c)
+    {
+      /* the points of a contour are the points of its edges,
+         with the last point of each edge dropped since it is
+         the first point of the next edge. The fan is centered
+         at the first point; the attribute of the center is
+         attribs[center] and that of the previous point of the
+         fan is attribs.back().
+       */
+      unsigned int center(attribs.size()), num_contour_pts(0);
+      for(unsigned int e = 0, ende = path.number_edges(c); e < ende; ++e)
+        {
+          range_type<unsigned int> R(path.edge_range(c, e));
+          for(unsigned int v = R.m_begin; v + 1 < R.m_end; ++v, ++num_contour_pts)
+            {
+              if(attribs.size() + 1 > m_max_attribs_per_block
+                 || indices.size() + 3 > m_max_indices_per_block)
+                {
+                  /* flush and restart the fan with its center
+                     and previous point.
+                   */
+                  PainterAttribute center_attrib, prev_attrib;
+
+                  if(num_contour_pts > 0)
+                    {
+                      center_attrib = attribs[center];
+                      prev_attrib = attribs.back();
+                    }
+
+                  if(!indices.empty())
+                    {
+                      attrib_chunk[0] = make_c_array(attribs);
+                      index_chunk[0] = make_c_array(indices);
+                      draw_generic(shader, draw, attrib_chunk, index_chunk, index_adjust,
+                                   const_c_array<unsigned int>(), m_current_z, call_back);
+                    }
+                  attribs.clear();
+                  indices.clear();
+                  center = 0;
+                  if(num_contour_pts > 0)
+                    {
+                      attribs.push_back(center_attrib);
+                    }
+                  if(num_contour_pts > 1)
+                    {
+                      attribs.push_back(prev_attrib);
+                    }
+                }
+
+              A.m_attrib0 = pack_vec4(pts[v].x(), pts[v].y(), 0.0f, 0.0f);
+              attribs.push_back(A);
+              if(num_contour_pts >= 2)
+                {
+                  indices.push_back(center);
+                  indices.push_back(attribs.size() - 2);
+                  indices.push_back(attribs.size() - 1);
+                }
+            }
+        }
+    }
+
+  if(!indices.empty())
+    {
+      attrib_chunk[0] = make_c_array(attribs);
+      index_chunk[0] = make_c_array(indices);
+      draw_generic(shader, draw, attrib_chunk, index_chunk, index_adjust,
+                   const_c_array<unsigned int>(), m_current_z, call_back);
+    }
+}
+
+void
+PainterPrivate::
+stencil_fill_path(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                  const fastuidraw::PainterData &draw,
+                  const fastuidraw::TessellatedPath &path,
+                  const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  using namespace fastuidraw;
+
+  reference_counted_ptr<PainterBlendShader> blend_shader(m_core->blend_shader());
+  BlendMode::packed_value blend_mode(m_core->blend_mode());
+  const_c_array<BlendMode> cover_ops(make_c_array(m_work_room.m_stencil_cover_ops));
+  enum BlendMode::stencil_op_t winding_op;
+  bool needs_clear;
+  float area(0.0f);
+
+  if(cover_ops.empty() || path.number_points() == 0)
+    {
+      return;
+    }
+
+  if(cover_ops.size() == 1 && cover_ops[0].stencil_op() == BlendMode::STENCIL_OFF)
+    {
+      draw_rect_single_chunk(shader, draw, path.bounding_box_min(), path.bounding_box_max(), call_back);
+      return;
+    }
+
+  /* The winding numbers computed by FilledPath are positive
+     for the orientation of the contours that makes the total
+     signed area of the path non-negative. The GL convention
+     is that triangles that are counter-clockwise on the screen
+     are front facing, and a triangle that is counter-clockwise
+     in item coordinates is counter-clockwise on the screen
+     exactly when the item matrix does not reverse orientation.
+   */
+  for(unsigned int c = 0, endc = path.number_contours(); c < endc; ++c)
+    {
+      const_c_array<vec2> pts(path.point_positions().sub_array(path.contour_range(c)));
+      for(unsigned int v = 1; v + 1 < pts.size(); ++v)
+        {
+          vec2 a(pts[v] - pts[0]), b(pts[v + 1] - pts[0]);
+          area += a.x() * b.y() - a.y() * b.x();
+        }
+    }
+  winding_op = ((area >= 0.0f) != m_clip_rect_state.item_matrix().reverses_orientation()) ?
+    BlendMode::STENCIL_ADD_WINDING :
+    BlendMode::STENCIL_SUBTRACT_WINDING;
+
+  m_core->blend_shader(blend_shader, BlendMode(blend_mode).stencil_op(winding_op).packed());
+  draw_contour_fans(shader, draw, path, call_back);
+
+  needs_clear = false;
+  for(unsigned int i = 0; i < cover_ops.size(); ++i)
+    {
+      needs_clear = needs_clear || cover_ops[i].stencil_op() != BlendMode::STENCIL_COVER_NON_ZERO;
+      m_core->blend_shader(blend_shader, cover_ops[i].packed());
+      draw_rect_single_chunk(shader, draw, path.bounding_box_min(), path.bounding_box_max(), call_back);
+    }
+
+  if(needs_clear)
+    {
+      m_core->blend_shader(blend_shader, BlendMode(blend_mode).stencil_op(BlendMode::STENCIL_CLEAR).packed());
+      draw_rect_single_chunk(shader, draw, path.bounding_box_min(), path.bounding_box_max(), call_back);
+    }
+
+  m_core->blend_shader(blend_shader, blend_mode);
+  FASTUIDRAWincrement_stat(m_stats[PainterPacker::num_stencil_filled_paths], 1u);
+}
+
+void
+PainterPrivate::
+stencil_clip_blend(enum fastuidraw::BlendMode::stencil_op_t op, unsigned int value)
+{
+  using namespace fastuidraw;
+
+  const PainterBlendShaderSet &blend_shaders(m_core->default_shaders().blend_shaders());
+  BlendMode mode(blend_shaders.blend_mode(PainterEnums::blend_porter_duff_dst));
+
+  mode
+    .stencil_op(op)
+    .stencil_value(value);
+  m_core->blend_shader(blend_shaders.shader(PainterEnums::blend_porter_duff_dst), mode.packed());
+}
+
+void
+PainterPrivate::
+draw_stencil_clip_fullscreen(void)
+{
+  using namespace fastuidraw;
+
+  /* The rect is in 3D API coordinates, so set the matrix
+     temporarily to identity; it is drawn without the clip
+     equations since when popping a clipping the current clip
+     equations need not contain the region of the clipping.
+     Note that we pass false to item_matrix_state() to prevent
+     marking the derived values from the matrix state as dirty.
+   */
+  PainterPackedValue<PainterItemMatrix> matrix_state;
+  bool draw_unclipped(m_draw_unclipped);
+
+  matrix_state = m_clip_rect_state.current_item_marix_state(m_item_matrix_cache);
+  m_clip_rect_state.item_matrix_state(m_identiy_matrix, false);
+  m_draw_unclipped = true;
+
+  draw_rect_single_chunk(m_core->default_shaders().fill_shader().item_shader(),
+                         PainterData(m_black_brush),
+                         vec2(-1.0f, -1.0f), vec2(1.0f, 1.0f),
+                         reference_counted_ptr<PainterPacker::DataCallBack>());
+
+  m_draw_unclipped = draw_unclipped;
+  m_clip_rect_state.item_matrix_state(matrix_state, false);
+}
+
+template<typename T>
+void
+PainterPrivate::
+stencil_clip_in_path(fastuidraw::Painter *p, const fastuidraw::Path &path, const T &fill_rule)
+{
+  if(m_clip_rect_state.m_all_content_culled)
+    {
+      return;
+    }
+
+  fastuidraw::reference_counted_ptr<fastuidraw::PainterBlendShader> blend_shader(m_core->blend_shader());
+  fastuidraw::BlendMode::packed_value blend_mode(m_core->blend_mode());
+
+  stencil_clip_blend(fastuidraw::BlendMode::STENCIL_CLIP_INCREMENT, m_stencil_clip_depth);
+  p->fill_path(m_stencil_clip_fill_shader, fastuidraw::PainterData(m_black_brush), path, fill_rule);
+  m_core->blend_shader(blend_shader, blend_mode);
+  push_stencil_clip();
+}
+
+void
+PainterPrivate::
+push_stencil_clip(void)
+{
+  ++m_stencil_clip_depth;
+  m_core->stencil_clip_value(m_stencil_clip_depth);
+  fastuidraw::counted_push_back(m_occluder_stack, occluder_stack_entry(m_stencil_clip_depth),
+                                m_stats[fastuidraw::PainterPacker::num_unbudgeted_allocations]);
+  FASTUIDRAWincrement_stat(m_stats[fastuidraw::PainterPacker::num_stencil_clips], 1u);
+}
+
+void
+PainterPrivate::
+pop_stencil_clip(unsigned int stencil_clip_depth)
+{
+  fastuidraw::reference_counted_ptr<fastuidraw::PainterBlendShader> blend_shader(m_core->blend_shader());
+  fastuidraw::BlendMode::packed_value blend_mode(m_core->blend_mode());
+
+  assert(stencil_clip_depth == m_stencil_clip_depth);
+  FASTUIDRAWunused(stencil_clip_depth);
+
+  stencil_clip_blend(fastuidraw::BlendMode::STENCIL_CLIP_DECREMENT, m_stencil_clip_depth);
+  draw_stencil_clip_fullscreen();
+  m_core->blend_shader(blend_shader, blend_mode);
+
+  --m_stencil_clip_depth;
+  m_core->stencil_clip_value(m_stencil_clip_depth);
+}
+
+const fastuidraw::PainterAttributeData&
+PainterPrivate::
+select_dashed_edges(const fastuidraw::StrokedPath &stroked_path,
+                    const fastuidraw::DashEvaluatorBase *dash_evaluator,
+                    const fastuidraw::PainterShaderData::DataBase *raw_data,
+                    bool close_contours)
+{
+  const fastuidraw::float3x3 &m(m_clip_rect_state.item_matrix());
+  fastuidraw::const_c_array<fastuidraw::range_type<float> > intervals;
+  float period, a, b, c, e, sum, det, sigma_min, margin;
+  int exponent;
+
+  /* the margin about each boundary of the dash pattern is in
+     local coordinates, so only split without perspective where
+     the size of a pixel in local coordinates is the same
+     across the path.
+   */
+  if(!m_split_dashed_edges || dash_evaluator == NULL
+     || m(2, 0) != 0.0f || m(2, 1) != 0.0f || m(2, 2) == 0.0f)
+    {
+      return stroked_path.edges(close_contours);
+    }
+
+  intervals = dash_evaluator->draw_intervals(raw_data, &period);
+  if(intervals.empty() || period <= 0.0f)
+    {
+      return stroked_path.edges(close_contours);
+    }
+
+  /* the smallest singular value of the 2x2 matrix from local
+     coordinates to pixel coordinates gives the length in pixels
+     of the shortest vector of unit length in local coordinates.
+     The factor 0.5 comes from that normalized device coordinates
+     are [-1, 1]x[-1, 1].
+   */
+  a = 0.5f * m_resolution.x() * m(0, 0) / m(2, 2);
+  b = 0.5f * m_resolution.x() * m(0, 1) / m(2, 2);
+  c = 0.5f * m_resolution.y() * m(1, 0) / m(2, 2);
+  e = 0.5f * m_resolution.y() * m(1, 1) / m(2, 2);
+  sum = a * a + b * b + c * c + e * e;
+  det = a * e - b * c;
+  sigma_min = 0.5f * (sum - fastuidraw::t_sqrt(fastuidraw::t_max(0.0f, sum * sum - 4.0f * det * det)));
+  sigma_min = fastuidraw::t_sqrt(fastuidraw::t_max(0.0f, sigma_min));
+  if(sigma_min <= 0.0f)
+    {
+      return stroked_path.edges(close_contours);
+    }
+
+  /* keep two pixels about each boundary for the anti-aliasing
+     of the boundary and round up to a power of 2 so that
+     small changes of the transformation reuse the data
+     StrokedPath keeps for the dash pattern.
+   */
+  margin = 2.0f / sigma_min;
+  std::frexp(margin, &exponent);
+  margin = std::ldexp(1.0f, exponent);
+
+  return stroked_path.dashed_edges(intervals, period, margin, close_contours);
+}
+
+void
+PainterPrivate::
+apply_stroke_lod(const fastuidraw::StrokingDataSelectorBase &selector,
+                 const fastuidraw::PainterShaderData::DataBase *raw_data,
+                 float &thresh,
+                 enum fastuidraw::PainterEnums::cap_style &cp,
+                 enum fastuidraw::PainterEnums::join_style &js)
+{
+  float pixel_distance(0.0f), item_space_distance(0.0f), pixel_width;
+
+  /* a negative thresh means that select_path_thresh() could
+     not find the scale of the transformation.
+   */
+  if(m_stroke_lod_pixel_width <= 0.0f || thresh <= 0.0f)
+    {
+      return;
+    }
+
+  /* select_path_thresh() gives m_curve_flatness divided by the
+     number of pixels per unit of item coordinates.
+   */
+  selector.stroking_distances(raw_data, &pixel_distance, &item_space_distance);
+  pixel_width = 2.0f * (pixel_distance + item_space_distance * m_curve_flatness / thresh);
+  if(pixel_width >= m_stroke_lod_pixel_width)
+    {
+      return;
+    }
+
+  cp = fastuidraw::PainterEnums::flat_caps;
+  if(js != fastuidraw::PainterEnums::no_joins)
+    {
+      js = (2.0f * pixel_width < m_stroke_lod_pixel_width) ?
+        fastuidraw::PainterEnums::no_joins :
+        fastuidraw::PainterEnums::bevel_joins;
+    }
+
+  /* Path::tessellation() levels of detail are a factor of
+     two apart, the stroke uses the next coarser level.
+   */
+  thresh *= 2.0f;
+}
+
+void
+PainterPrivate::
+compute_edge_chunks(const fastuidraw::StrokedPath &stroked_path,
+                    const fastuidraw::PainterAttributeData &edge_data,
+                    const fastuidraw::PainterShaderData::DataBase *raw_data,
+                    const fastuidraw::StrokingDataSelectorBase &selector,
+                    bool close_countours,
+                    std::vector<unsigned int> &out_chunks)
+{
+  float pixels_additional_room(0.0f), item_space_additional_room(0.0f);
+  unsigned int sz;
+
+  out_chunks.resize(stroked_path.maximum_edge_chunks());
+  selector.stroking_distances(raw_data,
+                              &pixels_additional_room,
+                              &item_space_additional_room);
+
+  sz = stroked_path.edge_chunks(m_work_room.m_stroked_path_scratch,
+                                edge_data,
+                                m_clip_store.current(),
+                                m_clip_rect_state.item_matrix(),
+                                m_one_pixel_width,
+                                pixels_additional_room,
+                                item_space_additional_room,
+                                close_countours,
+                                m_max_attribs_per_block,
+                                m_max_indices_per_block,
+                                fastuidraw::make_c_array(out_chunks));
+  assert(sz <= out_chunks.size());
+  out_chunks.resize(sz);
+  FASTUIDRAWincrement_stat(m_stats[fastuidraw::PainterPacker::num_stroked_path_chunks_selected], sz);
+}
+
+void
+PainterPrivate::
+compute_join_chunks(const fastuidraw::StrokedPath &stroked_path,
+                    const fastuidraw::PainterAttributeData &join_data,
+                    const fastuidraw::PainterShaderData::DataBase *raw_data,
+                    const fastuidraw::StrokingDataSelectorBase &selector,
+                    bool close_countours,
+                    std::vector<unsigned int> &out_chunks)
+{
+  float pixels_additional_room(0.0f), item_space_additional_room(0.0f);
+  unsigned int sz;
+
+  /* bevel and rounded joins are within the stroking
+     radius of the point of the join.
+   */
+  out_chunks.resize(stroked_path.maximum_join_chunks());
+  selector.stroking_distances(raw_data,
+                              &pixels_additional_room,
+                              &item_space_additional_room);
+
+  sz = stroked_path.join_chunks(m_work_room.m_stroked_path_scratch,
+                                join_data,
+                                m_clip_store.current(),
+                                m_clip_rect_state.item_matrix(),
+                                m_one_pixel_width,
+                                pixels_additional_room,
+                                item_space_additional_room,
+                                close_countours,
+                                m_max_attribs_per_block,
+                                m_max_indices_per_block,
+                                fastuidraw::make_c_array(out_chunks));
+  assert(sz <= out_chunks.size());
+  out_chunks.resize(sz);
+  FASTUIDRAWincrement_stat(m_stats[fastuidraw::PainterPacker::num_stroked_path_join_chunks_selected], sz);
+}
+
+void
+PainterPrivate::
+compute_cap_chunks(const fastuidraw::StrokedPath &stroked_path,
+                   const fastuidraw::PainterAttributeData &cap_data,
+                   const fastuidraw::PainterShaderData::DataBase *raw_data,
+                   const fastuidraw::StrokingDataSelectorBase &selector,
+                   std::vector<unsigned int> &out_chunks)
+{
+  float pixels_additional_room(0.0f), item_space_additional_room(0.0f);
+  unsigned int sz;
+
+  /* the corners of a square cap are sqrt(2) times
+     the stroking radius from the point of the cap.
+   */
+  out_chunks.resize(stroked_path.maximum_cap_chunks());
+  selector.stroking_distances(raw_data,
+                              &pixels_additional_room,
+                              &item_space_additional_room);
+
+  sz = stroked_path.cap_chunks(m_work_room.m_stroked_path_scratch,
+                               cap_data,
+                               m_clip_store.current(),
+                               m_clip_rect_state.item_matrix(),
+                               m_one_pixel_width,
+                               float(M_SQRT2) * pixels_additional_room,
+                               float(M_SQRT2) * item_space_additional_room,
+                               m_max_attribs_per_block,
+                               m_max_indices_per_block,
+                               fastuidraw::make_c_array(out_chunks));
+  assert(sz <= out_chunks.size());
+  out_chunks.resize(sz);
+  FASTUIDRAWincrement_stat(m_stats[fastuidraw::PainterPacker::num_stroked_path_cap_chunks_selected], sz);
+}
+
+void
+PainterPrivate::
+draw_generic(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+             const fastuidraw::PainterData &draw,
+             fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attrib_chunks,
+             fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+             fastuidraw::const_c_array<int> index_adjusts,
+             fastuidraw::const_c_array<unsigned int> attrib_chunk_selector,
+             unsigned int z,
+             const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  fastuidraw::PainterPackerData p(packer_data(draw));
+  if(m_recording)
+    {
+      assert(z >= m_recording_start_z);
+      if(m_recorded_draw_bounded)
+        {
+          m_recording->add_to_bounding_box(m_recorded_draw_min, m_recorded_draw_max);
+          if(m_recorded_draw_opaque)
+            {
+              m_recording->opaque_box(m_recorded_draw_min, m_recorded_draw_max);
+            }
+        }
+      else
+        {
+          m_recording->bounding_box_unknown();
+        }
+      m_recorded_draw_bounded = false;
+      m_recorded_draw_opaque = false;
+      m_recording->blend_shader(m_core->blend_shader(), m_core->blend_mode());
+      m_recording->draw_generic(shader, p, attrib_chunks, index_chunks, index_adjusts,
+                                attrib_chunk_selector, z - m_recording_start_z);
+    }
+  else
+    {
+      m_core->draw_generic(shader, p, attrib_chunks, index_chunks, index_adjusts, attrib_chunk_selector, z, call_back);
+    }
+}
+
+void
+PainterPrivate::
+draw_generic_check(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                   const fastuidraw::PainterData &draw,
+                   fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attrib_chunks,
+                   fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+                   fastuidraw::const_c_array<int> index_adjusts,
+                   fastuidraw::const_c_array<unsigned int> attrib_chunk_selector,
+                   unsigned int z,
+                   const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  if(!m_clip_rect_state.m_all_content_culled)
     {
       draw_generic(shader, draw, attrib_chunks, index_chunks, index_adjusts, attrib_chunk_selector, z, call_back);
     }
 }
 
-//////////////////////////////////
-// fastuidraw::Painter methods
+void
+PainterPrivate::
+draw_generic_check(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                   const fastuidraw::PainterData &draw,
+                   unsigned int number_attributes,
+                   unsigned int number_indices,
+                   const fastuidraw::PainterPacker::DataWriter &writer,
+                   unsigned int z,
+                   const fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker::DataCallBack> &call_back)
+{
+  if(m_clip_rect_state.m_all_content_culled)
+    {
+      return;
+    }
+
+  if(m_recording)
+    {
+      /* a stream keeps its own copy of the data of its
+         draws, so there is no mapped buffer to write to.
+       */
+      std::vector<fastuidraw::PainterAttribute> attribs(number_attributes);
+      std::vector<fastuidraw::PainterIndex> indices(number_indices);
+
+      writer.write_data(fastuidraw::make_c_array(attribs), fastuidraw::make_c_array(indices));
+
+      fastuidraw::vecN<fastuidraw::const_c_array<fastuidraw::PainterAttribute>, 1> aa(fastuidraw::make_c_array(attribs));
+      fastuidraw::vecN<fastuidraw::const_c_array<fastuidraw::PainterIndex>, 1> ii(fastuidraw::make_c_array(indices));
+      fastuidraw::vecN<int, 1> ia(0);
+      draw_generic(shader, draw, aa, ii, ia, fastuidraw::const_c_array<unsigned int>(), z, call_back);
+    }
+  else
+    {
+      m_core->draw_generic(shader, packer_data(draw), number_attributes, number_indices,
+                           writer, z, call_back);
+    }
+}
+
+fastuidraw::PainterPackerData
+PainterPrivate::
+packer_data(const fastuidraw::PainterData &draw)
+{
+  fastuidraw::PainterPackerData p(draw);
+  if(m_draw_unclipped)
+    {
+      p.m_clip = m_no_clip_equations;
+      FASTUIDRAWincrement_stat(m_stats[fastuidraw::PainterPacker::num_clip_free_draws], 1u);
+    }
+  else
+    {
+      p.m_clip = m_clip_rect_state.clip_equations_state(m_pool);
+    }
+  p.m_matrix = m_clip_rect_state.current_item_marix_state(m_item_matrix_cache);
+  return p;
+}
+
+//////////////////////////////////
+// fastuidraw::Painter methods
+fastuidraw::Painter::
+Painter(reference_counted_ptr<PainterBackend> backend)
+{
+  m_d = FASTUIDRAWnew PainterPrivate(backend);
+}
+
+fastuidraw::Painter::
+~Painter()
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+fastuidraw::PainterPackedValuePool&
+fastuidraw::Painter::
+packed_value_pool(void)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_pool;
+}
+
+void
+fastuidraw::Painter::
+target_resolution(int w, int h)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  w = t_max(w, 1);
+  h = t_max(h, 1);
+  d->m_resolution.x() = static_cast<float>(w);
+  d->m_resolution.y() = static_cast<float>(h);
+  d->m_one_pixel_width = 1.0f / d->m_resolution;
+  d->m_core->target_resolution(w, h);
+}
+
+void
+fastuidraw::Painter::
+damage_region(const_c_array<vec4> rects)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_damage_region.assign(rects.begin(), rects.end());
+}
+
+fastuidraw::const_c_array<fastuidraw::vec4>
+fastuidraw::Painter::
+damage_region(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return make_c_array(d->m_damage_region);
+}
+
+fastuidraw::const_c_array<fastuidraw::vec4>
+fastuidraw::Painter::
+stream_damage(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return make_c_array(d->m_stream_damage);
+}
+
+void
+fastuidraw::Painter::
+begin(const BeginParams &params)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->begin_frame(ivec2(d->m_resolution), params.m_reset_z,
+                                    params.m_multisampled_target,
+                                    params.m_no_depth_buffer);
+    }
+
+  d->m_multisampled_target = params.m_multisampled_target;
+  d->m_no_depth_buffer = params.m_no_depth_buffer;
+  d->m_warned_occluder_clipping = false;
+
+  d->m_core->begin(params.m_no_depth_buffer);
+  std::fill(d->m_stats.begin(), d->m_stats.end(), 0u);
+  d->m_stream_damage.clear();
+
+  /* the PainterBackend may be shared by the Painters of
+     several surfaces, each with its own resolution
+   */
+  d->m_core->target_resolution(static_cast<int>(d->m_resolution.x()),
+                               static_cast<int>(d->m_resolution.y()));
+
+  if(params.m_reset_z)
+    {
+      d->m_current_z = 1;
+    }
+  d->m_stencil_clip_depth = 0;
+  d->m_core->stencil_clip_value(0);
+  d->m_clip_rect_state.reset();
+  d->m_clip_store.set_current(d->m_clip_rect_state.clip_equations().m_clip_equations);
+  blend_shader(PainterEnums::blend_porter_duff_src_over);
+}
+
+bool
+fastuidraw::Painter::
+multisampled_target(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_multisampled_target;
+}
+
+bool
+fastuidraw::Painter::
+no_depth_buffer(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_no_depth_buffer;
+}
+
+void
+fastuidraw::Painter::
+end(void)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  assert(!d->m_recording);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->end_frame();
+    }
+
+  /* pop m_clip_stack to perform necessary writes
+   */
+  while(!d->m_occluder_stack.empty())
+    {
+      d->m_occluder_stack.back().on_pop(this, d);
+      d->m_occluder_stack.pop_back();
+    }
+  /* clear state stack as well.
+   */
+  d->m_clip_store.clear();
+  d->m_state_stack.clear();
+  d->m_core->end();
+  d->m_z_frame_pool.reset();
+
+  /* the flush of end() is the last draw that reads the
+     surfaces of the layers of the frame, the free surfaces
+     that the frame did not use are released.
+   */
+  assert(d->m_layer_stack.empty());
+  d->m_free_render_targets.swap(d->m_used_render_targets);
+  d->m_used_render_targets.clear();
+}
+
+void
+fastuidraw::Painter::
+draw_generic(const reference_counted_ptr<PainterItemShader> &shader, const PainterData &draw,
+             const_c_array<const_c_array<PainterAttribute> > attrib_chunks,
+             const_c_array<const_c_array<PainterIndex> > index_chunks,
+             const_c_array<int> index_adjusts,
+             const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->draw_generic_check(shader, draw, attrib_chunks, index_chunks,
+                        index_adjusts, const_c_array<unsigned int>(),
+                        current_z(), call_back);
+}
+
+void
 fastuidraw::Painter::
-Painter(reference_counted_ptr<PainterBackend> backend)
+draw_generic(const reference_counted_ptr<PainterItemShader> &shader, const PainterData &draw,
+             const_c_array<const_c_array<PainterAttribute> > attrib_chunks,
+             const_c_array<const_c_array<PainterIndex> > index_chunks,
+             const_c_array<int> index_adjusts,
+             const_c_array<unsigned int> attrib_chunk_selector,
+             const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
-  m_d = FASTUIDRAWnew PainterPrivate(backend);
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->draw_generic_check(shader, draw, attrib_chunks, index_chunks,
+                        index_adjusts, attrib_chunk_selector,
+                        current_z(), call_back);
 }
 
+void
 fastuidraw::Painter::
-~Painter()
+draw_generic(const reference_counted_ptr<PainterItemShader> &shader, const PainterData &draw,
+             unsigned int number_attributes, unsigned int number_indices,
+             const PainterPacker::DataWriter &writer,
+             const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
-  FASTUIDRAWdelete(d);
-  m_d = NULL;
+  d->draw_generic_check(shader, draw, number_attributes, number_indices,
+                        writer, current_z(), call_back);
 }
 
-fastuidraw::PainterPackedValuePool&
+fastuidraw::reference_counted_ptr<const fastuidraw::PainterStaticAttributeData>
 fastuidraw::Painter::
-packed_value_pool(void)
+create_static_attribute_data(const PainterAttributeData &data,
+                             const_c_array<unsigned int> attrib_chunk_selector,
+                             enum PainterAttribute::layout_t layout)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
-  return d->m_pool;
+  return d->m_core->create_static_attribute_data(data, attrib_chunk_selector, layout);
 }
 
 void
 fastuidraw::Painter::
-target_resolution(int w, int h)
+draw_static(const reference_counted_ptr<PainterItemShader> &shader,
+            const PainterData &draw,
+            const reference_counted_ptr<const PainterStaticAttributeData> &static_data,
+            const_c_array<unsigned int> chunks,
+            const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
-  w = t_max(w, 1);
-  h = t_max(h, 1);
-  d->m_resolution.x() = static_cast<float>(w);
-  d->m_resolution.y() = static_cast<float>(h);
-  d->m_one_pixel_width = 1.0f / d->m_resolution;
-  d->m_core->target_resolution(w, h);
+  assert(!d->m_recording);
+  if(!d->m_clip_rect_state.m_all_content_culled && !d->m_recording)
+    {
+      PainterPackerData p(draw);
+      p.m_clip = d->m_clip_rect_state.clip_equations_state(d->m_pool);
+      p.m_matrix = d->m_clip_rect_state.current_item_marix_state(d->m_item_matrix_cache);
+      d->m_core->draw_static(shader, p, static_data, chunks, d->m_current_z, call_back);
+    }
 }
 
 void
 fastuidraw::Painter::
-begin(bool reset_z)
+draw_static_instances(const reference_counted_ptr<PainterItemShader> &shader,
+                      const PainterData &draw,
+                      const reference_counted_ptr<const PainterStaticAttributeData> &static_data,
+                      const_c_array<unsigned int> chunks,
+                      const_c_array<float3x3> matrices,
+                      const_c_array<vec4> colors,
+                      const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
-  d->m_core->begin();
+  assert(!d->m_recording);
+  assert(colors.empty() || colors.size() == matrices.size());
+  if(d->m_clip_rect_state.m_all_content_culled || d->m_recording || matrices.empty())
+    {
+      return;
+    }
+
+  std::vector<PainterItemMatrix> &item_matrices(d->m_work_room.m_instance_matrices);
+  std::vector<PainterBrush> &brushes(d->m_work_room.m_instance_brushes);
+  std::vector<PainterPackerData> &instances(d->m_work_room.m_instance_data);
+  PainterPackedValue<PainterClipEquations> clip(d->m_clip_rect_state.clip_equations_state(d->m_pool));
 
-  if(reset_z)
+  /* the matrices and brushes are filled before the PainterPackerData
+     values take pointers to them, so that no reallocation can
+     invalidate those pointers.
+   */
+  item_matrices.resize(matrices.size(), d->m_clip_rect_state.current_painter_item_matrix());
+  for(unsigned int i = 0; i < matrices.size(); ++i)
     {
-      d->m_current_z = 1;
+      item_matrices[i].m_item_matrix = d->m_clip_rect_state.item_matrix() * matrices[i];
     }
-  d->m_clip_rect_state.reset();
-  d->m_clip_store.set_current(d->m_clip_rect_state.clip_equations().m_clip_equations);
-  blend_shader(PainterEnums::blend_porter_duff_src_over);
+
+  brushes.clear();
+  if(!colors.empty())
+    {
+      brushes.resize(colors.size(), draw.m_brush.data());
+      for(unsigned int i = 0; i < colors.size(); ++i)
+        {
+          brushes[i].pen(colors[i]);
+        }
+    }
+
+  instances.clear();
+  instances.resize(matrices.size(), PainterPackerData(draw));
+  for(unsigned int i = 0; i < matrices.size(); ++i)
+    {
+      instances[i].m_clip = clip;
+      instances[i].m_matrix = &item_matrices[i];
+      if(!brushes.empty())
+        {
+          instances[i].m_brush = &brushes[i];
+        }
+    }
+
+  d->m_core->draw_static_instances(shader, make_c_array(instances), static_data, chunks,
+                                   d->m_current_z, call_back);
 }
 
 void
 fastuidraw::Painter::
-end(void)
+draw_generic_instances(const reference_counted_ptr<PainterItemShader> &shader,
+                       const PainterData &draw,
+                       const PainterAttributeData &data,
+                       const_c_array<unsigned int> chunks,
+                       const_c_array<float3x3> matrices,
+                       const_c_array<vec4> colors,
+                       const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
-  /* pop m_clip_stack to perform necessary writes
-   */
-  while(!d->m_occluder_stack.empty())
+  assert(colors.empty() || colors.size() == matrices.size());
+  if(d->m_clip_rect_state.m_all_content_culled || matrices.empty())
     {
-      d->m_occluder_stack.back().on_pop(this);
-      d->m_occluder_stack.pop_back();
+      return;
+    }
+
+  std::vector<const_c_array<PainterAttribute> > &attrib_chunks(d->m_work_room.m_attrib_chunks);
+  std::vector<const_c_array<PainterIndex> > &index_chunks(d->m_work_room.m_index_chunks);
+  std::vector<int> &index_adjusts(d->m_work_room.m_index_adjusts);
+
+  attrib_chunks.clear();
+  index_chunks.clear();
+  index_adjusts.clear();
+  for(unsigned int i = 0; i < chunks.size(); ++i)
+    {
+      attrib_chunks.push_back(data.attribute_data_chunk(chunks[i]));
+      index_chunks.push_back(data.index_data_chunk(chunks[i]));
+      index_adjusts.push_back(data.index_adjust_chunk(chunks[i]));
+    }
+
+  PainterBrush brush;
+  PainterData instance(draw);
+  if(!colors.empty())
+    {
+      brush = draw.m_brush.data();
+      instance.m_brush = &brush;
+    }
+
+  for(unsigned int i = 0; i < matrices.size(); ++i)
+    {
+      if(!colors.empty())
+        {
+          brush.pen(colors[i]);
+        }
+      save();
+      concat(matrices[i]);
+      d->draw_generic_check(shader, instance,
+                            make_c_array(attrib_chunks),
+                            make_c_array(index_chunks),
+                            make_c_array(index_adjusts),
+                            const_c_array<unsigned int>(),
+                            d->m_current_z, call_back);
+      restore();
     }
-  /* clear state stack as well.
-   */
-  d->m_clip_store.clear();
-  d->m_state_stack.clear();
-  d->m_core->end();
 }
 
 void
 fastuidraw::Painter::
-draw_generic(const reference_counted_ptr<PainterItemShader> &shader, const PainterData &draw,
-             const_c_array<const_c_array<PainterAttribute> > attrib_chunks,
-             const_c_array<const_c_array<PainterIndex> > index_chunks,
-             const_c_array<int> index_adjusts,
-             const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+draw_stream(const PainterPackerStream &stream, bool use_current_state)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
-  d->draw_generic_check(shader, draw, attrib_chunks, index_chunks,
-                        index_adjusts, const_c_array<unsigned int>(),
-                        current_z(), call_back);
+
+  assert(!d->m_recording);
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->draw_stream(stream, use_current_state);
+    }
+
+  if(!d->m_clip_rect_state.m_all_content_culled && stream.number_draws() > 0)
+    {
+      vec2 bmin, bmax, qmin, qmax;
+      bool bounded;
+
+      /* the pixel box of the stream, enlarged by a pixel
+         for the anti-alias fuzz, is clamped to the target
+         surface; a stream whose box is not known damages
+         all of the surface.
+       */
+      bounded = stream.bounding_box(&bmin, &bmax)
+        && d->pixel_rect(use_current_state ?
+                         d->m_clip_rect_state.item_matrix() :
+                         stream.base_transformation(),
+                         bmin, bmax, &qmin, &qmax);
+      if(bounded)
+        {
+          qmin.x() = t_max(qmin.x() - 1.0f, 0.0f);
+          qmin.y() = t_max(qmin.y() - 1.0f, 0.0f);
+          qmax.x() = t_min(qmax.x() + 1.0f, d->m_resolution.x());
+          qmax.y() = t_min(qmax.y() + 1.0f, d->m_resolution.y());
+          if(qmin.x() >= qmax.x() || qmin.y() >= qmax.y()
+             || (!d->m_damage_region.empty() && d->misses_damage(qmin, qmax)))
+            {
+              FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_draws_culled], 1u);
+              d->m_current_z += stream.z_range();
+              return;
+            }
+          d->m_stream_damage.push_back(vec4(qmin.x(), qmin.y(),
+                                            qmax.x() - qmin.x(),
+                                            qmax.y() - qmin.y()));
+        }
+      else
+        {
+          d->m_stream_damage.push_back(vec4(0.0f, 0.0f,
+                                            d->m_resolution.x(),
+                                            d->m_resolution.y()));
+        }
+
+      if(use_current_state)
+        {
+          PainterData::value<PainterClipEquations> clip;
+
+          clip = d->m_clip_rect_state.clip_equations_state(d->m_pool);
+          d->m_core->draw_stream(stream, d->m_current_z, clip,
+                                 d->m_clip_rect_state.item_matrix());
+        }
+      else
+        {
+          d->m_core->draw_stream(stream, d->m_current_z);
+        }
+    }
+  d->m_current_z += stream.z_range();
 }
 
 void
 fastuidraw::Painter::
-draw_generic(const reference_counted_ptr<PainterItemShader> &shader, const PainterData &draw,
-             const_c_array<const_c_array<PainterAttribute> > attrib_chunks,
-             const_c_array<const_c_array<PainterIndex> > index_chunks,
-             const_c_array<int> index_adjusts,
-             const_c_array<unsigned int> attrib_chunk_selector,
-             const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+begin_recording(const reference_counted_ptr<PainterPackerStream> &stream)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
-  d->draw_generic_check(shader, draw, attrib_chunks, index_chunks,
-                        index_adjusts, attrib_chunk_selector,
-                        current_z(), call_back);
+
+  assert(!d->m_recording);
+  assert(stream);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->begin_recording(stream);
+    }
+
+  stream->clear();
+  stream->base_transformation(d->m_clip_rect_state.item_matrix());
+  d->m_recording = stream;
+  d->m_recorded_draw_bounded = false;
+  d->m_recording_start_z = d->m_current_z;
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::PainterPackerStream>
+fastuidraw::Painter::
+end_recording(void)
+{
+  PainterPrivate *d;
+  reference_counted_ptr<PainterPackerStream> return_value;
+
+  d = static_cast<PainterPrivate*>(m_d);
+  assert(d->m_recording);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->end_recording();
+    }
+
+  return_value.swap(d->m_recording);
+  d->m_current_z = d->m_recording_start_z;
+  return return_value;
+}
+
+bool
+fastuidraw::Painter::
+recording(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_recording;
+}
+
+int
+fastuidraw::Painter::
+alignment(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_alignment;
+}
+
+void
+fastuidraw::Painter::
+trace(const reference_counted_ptr<PainterTraceRecorder> &recorder)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_trace = recorder;
+}
+
+const fastuidraw::reference_counted_ptr<fastuidraw::PainterTraceRecorder>&
+fastuidraw::Painter::
+trace(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_trace;
 }
 
 void
@@ -1293,12 +3995,51 @@ draw_convex_polygon(const reference_counted_ptr<PainterItemShader> &shader,
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
+  trace_scope trace(d);
+  if(trace.recorder() && shader == default_shaders().fill_shader().item_shader())
+    {
+      trace.recorder()->draw_convex_polygon(draw, pts);
+    }
+
   if(pts.size() < 3)
     {
       return;
     }
 
-  if(!d->m_core->hints().clipping_via_hw_clip_planes())
+  if(d->m_clip_rect_state.m_all_content_culled)
+    {
+      return;
+    }
+
+  /* A polygon whose bounding box is clipped away is not drawn
+     and one whose bounding box is not clipped at all is drawn
+     without the clip equations (see m_draw_unclipped). Otherwise
+     the polygon is clipped on CPU against the clip equations, so
+     the draw does not need them either. With hardware clip planes,
+     the polygon is only clipped on CPU when the clipping is the
+     axis aligned clipping rect in local coordinates (the common
+     case of UI rects clipped by a rect), the other cases are left
+     to the hardware.
+   */
+  enum rect_clip_t clip_test;
+  clip_test = d->classify_points(pts);
+  if(clip_test == rect_clipped_away)
+    {
+      FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_draws_culled], 1u);
+      return;
+    }
+
+  if(clip_test == rect_not_clipped)
+    {
+      d->m_draw_unclipped = true;
+      if(d->m_recording && shader == default_shaders().fill_shader().item_shader())
+        {
+          d->mark_recorded_draw_opaque(draw, pts);
+        }
+    }
+  else if(!d->m_core->hints().clipping_via_hw_clip_planes()
+          || (d->m_clip_rect_state.m_clip_rect.m_enabled
+              && !d->m_clip_rect_state.item_matrix_transition_tricky()))
     {
       d->m_clip_rect_state.clip_polygon(pts, d->m_work_room.m_pts_draw_convex_polygon,
                                         d->m_work_room.m_clipper_vec2s[0],
@@ -1306,8 +4047,10 @@ draw_convex_polygon(const reference_counted_ptr<PainterItemShader> &shader,
       pts = make_c_array(d->m_work_room.m_pts_draw_convex_polygon);
       if(pts.size() < 3)
         {
+          d->m_recorded_draw_bounded = false;
           return;
         }
+      d->m_draw_unclipped = true;
     }
 
   /* Draw a triangle fan centered at pts[0]
@@ -1333,6 +4076,7 @@ draw_convex_polygon(const reference_counted_ptr<PainterItemShader> &shader,
                make_c_array(d->m_work_room.m_indices),
                0,
                call_back);
+  d->m_draw_unclipped = false;
 }
 
 void
@@ -1345,43 +4089,155 @@ draw_convex_polygon(const PainterData &draw, const_c_array<vec2> pts,
 
 void
 fastuidraw::Painter::
-draw_quad(const reference_counted_ptr<PainterItemShader> &shader,
-          const PainterData &draw, const vec2 &p0, const vec2 &p1, const vec2 &p2, const vec2 &p3,
-          const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+draw_quad(const reference_counted_ptr<PainterItemShader> &shader,
+          const PainterData &draw, const vec2 &p0, const vec2 &p1, const vec2 &p2, const vec2 &p3,
+          const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  vecN<vec2, 4> pts;
+  pts[0] = p0;
+  pts[1] = p1;
+  pts[2] = p2;
+  pts[3] = p3;
+  draw_convex_polygon(shader, draw, const_c_array<vec2>(&pts[0], pts.size()), call_back);
+}
+
+void
+fastuidraw::Painter::
+draw_quad(const PainterData &draw, const vec2 &p0, const vec2 &p1, const vec2 &p2, const vec2 &p3,
+          const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  draw_quad(default_shaders().fill_shader().item_shader(), draw, p0, p1, p2, p3, call_back);
+}
+
+void
+fastuidraw::Painter::
+draw_rect(const reference_counted_ptr<PainterItemShader> &shader,
+          const PainterData &draw, const vec2 &p, const vec2 &wh,
+          const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  draw_quad(shader, draw, p, p + vec2(0.0f, wh.y()),
+            p + wh, p + vec2(wh.x(), 0.0f),
+            call_back);
+}
+
+void
+fastuidraw::Painter::
+draw_rect(const PainterData &draw, const vec2 &p, const vec2 &wh,
+          const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  draw_rect(default_shaders().fill_shader().item_shader(), draw, p, wh, call_back);
+}
+
+void
+fastuidraw::Painter::
+draw_quads(const reference_counted_ptr<PainterItemShader> &shader,
+           const PainterData &draw, const_c_array<vec2> pts,
+           const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  assert(pts.size() % 4 == 0);
+  trace_scope trace(d);
+  if(trace.recorder() && shader == default_shaders().fill_shader().item_shader())
+    {
+      trace.recorder()->draw_quads(draw, pts);
+    }
+  d->draw_quads(shader, draw, pts, call_back);
+}
+
+void
+fastuidraw::Painter::
+draw_quads(const PainterData &draw, const_c_array<vec2> pts,
+           const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  draw_quads(default_shaders().fill_shader().item_shader(), draw, pts, call_back);
+}
+
+void
+fastuidraw::Painter::
+draw_rects(const reference_counted_ptr<PainterItemShader> &shader,
+           const PainterData &draw, const_c_array<vec2> p, const_c_array<vec2> wh,
+           const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  assert(p.size() == wh.size());
+
+  /* the corners are in the order of draw_rect() */
+  std::vector<vec2> &pts(d->m_work_room.m_batch_pts);
+  pts.resize(4 * p.size());
+  for(unsigned int i = 0, endi = p.size(); i < endi; ++i)
+    {
+      pts[4 * i] = p[i];
+      pts[4 * i + 1] = vec2(p[i].x(), p[i].y() + wh[i].y());
+      pts[4 * i + 2] = p[i] + wh[i];
+      pts[4 * i + 3] = vec2(p[i].x() + wh[i].x(), p[i].y());
+    }
+
+  trace_scope trace(d);
+  if(trace.recorder() && shader == default_shaders().fill_shader().item_shader())
+    {
+      trace.recorder()->draw_quads(draw, make_c_array(pts));
+    }
+  d->draw_quads(shader, draw, make_c_array(pts), call_back);
+}
+
+void
+fastuidraw::Painter::
+draw_rects(const PainterData &draw, const_c_array<vec2> p, const_c_array<vec2> wh,
+           const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  draw_rects(default_shaders().fill_shader().item_shader(), draw, p, wh, call_back);
+}
+
+void
+fastuidraw::Painter::
+draw_rounded_rect(const reference_counted_ptr<PainterItemShader> &shader,
+                  const PainterData &draw, const vec2 &p, const vec2 &wh,
+                  float corner_radius,
+                  const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
-  vecN<vec2, 4> pts;
-  pts[0] = p0;
-  pts[1] = p1;
-  pts[2] = p2;
-  pts[3] = p3;
-  draw_convex_polygon(shader, draw, const_c_array<vec2>(&pts[0], pts.size()), call_back);
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->draw_rounded_rect(shader, draw, p, wh, corner_radius, 0.0f, call_back);
 }
 
 void
 fastuidraw::Painter::
-draw_quad(const PainterData &draw, const vec2 &p0, const vec2 &p1, const vec2 &p2, const vec2 &p3,
-          const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+draw_rounded_rect(const PainterData &draw, const vec2 &p, const vec2 &wh,
+                  float corner_radius,
+                  const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
-  draw_quad(default_shaders().fill_shader().item_shader(), draw, p0, p1, p2, p3, call_back);
+  draw_rounded_rect(default_shaders().rounded_rect_shader(), draw, p, wh, corner_radius, call_back);
 }
 
 void
 fastuidraw::Painter::
-draw_rect(const reference_counted_ptr<PainterItemShader> &shader,
-          const PainterData &draw, const vec2 &p, const vec2 &wh,
-          const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+draw_box_shadow(const reference_counted_ptr<PainterItemShader> &shader,
+                const PainterData &draw, const vec2 &p, const vec2 &wh,
+                float corner_radius, float blur_sigma,
+                const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
-  draw_quad(shader, draw, p, p + vec2(0.0f, wh.y()),
-            p + wh, p + vec2(wh.x(), 0.0f),
-            call_back);
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  if(blur_sigma <= 0.0f)
+    {
+      draw_rounded_rect(draw, p, wh, corner_radius, call_back);
+      return;
+    }
+  d->draw_rounded_rect(shader, draw, p, wh, corner_radius, blur_sigma, call_back);
 }
 
 void
 fastuidraw::Painter::
-draw_rect(const PainterData &draw, const vec2 &p, const vec2 &wh,
-          const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+draw_box_shadow(const PainterData &draw, const vec2 &p, const vec2 &wh,
+                float corner_radius, float blur_sigma,
+                const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
-  draw_rect(default_shaders().fill_shader().item_shader(), draw, p, wh, call_back);
+  draw_box_shadow(default_shaders().box_shadow_shader(), draw, p, wh,
+                  corner_radius, blur_sigma, call_back);
 }
 
 void
@@ -1389,7 +4245,8 @@ fastuidraw::Painter::
 stroke_path(const PainterStrokeShader &shader, const PainterData &draw,
             const PainterAttributeData *edge_data, const_c_array<unsigned int> edge_chunks,
             unsigned int inc_edge,
-            const PainterAttributeData *cap_data, unsigned int cap_chunk,
+            const PainterAttributeData *cap_data, const_c_array<unsigned int> cap_chunks,
+            unsigned int inc_cap,
             const PainterAttributeData* join_data, const_c_array<unsigned int> join_chunks,
             unsigned int inc_join, bool with_anti_aliasing,
             const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
@@ -1401,7 +4258,7 @@ stroke_path(const PainterStrokeShader &shader, const PainterData &draw,
       return;
     }
 
-  unsigned int startz, zinc_sum(0), inc_cap(0), num_joins(0), num_edges(0);
+  unsigned int startz, zinc_sum(0), num_joins(0), num_edges(0), num_caps(0);
   bool modify_z;
   const reference_counted_ptr<PainterItemShader> *sh;
   c_array<const_c_array<PainterAttribute> > attrib_chunks;
@@ -1420,15 +4277,21 @@ stroke_path(const PainterStrokeShader &shader, const PainterData &draw,
       inc_edge = 0;
     }
 
+  if(cap_data == NULL)
+    {
+      cap_chunks = const_c_array<unsigned int>();
+      inc_cap = 0;
+    }
+
   /* clear first to blank the values, std::vector::clear
      does not call deallocation on its backing store,
      thus there is no malloc/free noise
    */
   d->m_work_room.m_stroke_attrib_chunks.clear();
   d->m_work_room.m_stroke_index_chunks.clear();
-  d->m_work_room.m_stroke_index_adjusts.resize(1 + edge_chunks.size() + join_chunks.size());
-  d->m_work_room.m_stroke_attrib_chunks.resize(1 + edge_chunks.size() + join_chunks.size());
-  d->m_work_room.m_stroke_index_chunks.resize(1 + edge_chunks.size() + join_chunks.size());
+  d->m_work_room.m_stroke_index_adjusts.resize(cap_chunks.size() + edge_chunks.size() + join_chunks.size());
+  d->m_work_room.m_stroke_attrib_chunks.resize(cap_chunks.size() + edge_chunks.size() + join_chunks.size());
+  d->m_work_room.m_stroke_index_chunks.resize(cap_chunks.size() + edge_chunks.size() + join_chunks.size());
 
   attrib_chunks = make_c_array(d->m_work_room.m_stroke_attrib_chunks);
   index_chunks = make_c_array(d->m_work_room.m_stroke_index_chunks);
@@ -1450,20 +4313,19 @@ stroke_path(const PainterStrokeShader &shader, const PainterData &draw,
       index_adjusts[num_joins + E] = edge_data->index_adjust_chunk(edge_chunks[E]);
     }
 
-  if(cap_data != NULL)
+  num_caps = cap_chunks.size();
+  for(unsigned int C = 0; C < num_caps; ++C)
     {
-      attrib_chunks[num_joins + num_edges] = cap_data->attribute_data_chunk(cap_chunk);
-      index_chunks[num_joins + num_edges] = cap_data->index_data_chunk(cap_chunk);
-      index_adjusts[num_joins + num_edges] = cap_data->index_adjust_chunk(cap_chunk);
-      inc_cap = cap_data->increment_z_value(cap_chunk);
-    }
-  else
-    {
-      attrib_chunks = attrib_chunks.sub_array(0, num_joins + num_edges);
-      index_chunks = index_chunks.sub_array(0, num_joins + num_edges);
-      index_adjusts = index_adjusts.sub_array(0, num_joins + num_edges);
+      attrib_chunks[num_joins + num_edges + C] = cap_data->attribute_data_chunk(cap_chunks[C]);
+      index_chunks[num_joins + num_edges + C] = cap_data->index_data_chunk(cap_chunks[C]);
+      index_adjusts[num_joins + num_edges + C] = cap_data->index_adjust_chunk(cap_chunks[C]);
     }
 
+  /* the hardware anti-aliases the stroke when the
+     target is multisampled
+   */
+  with_anti_aliasing = with_anti_aliasing && !d->m_multisampled_target;
+
   startz = d->m_current_z;
   modify_z = !with_anti_aliasing || shader.aa_type() == PainterStrokeShader::draws_solid_then_fuzz;
   sh = (with_anti_aliasing) ? &shader.aa_shader_pass1(): &shader.non_aa_shader();
@@ -1505,9 +4367,9 @@ stroke_path(const PainterStrokeShader &shader, const PainterData &draw,
         {
           incr_z -= inc_cap;
           d->draw_generic(*sh, draw,
-                          attrib_chunks.sub_array(num_joins + num_edges, 1),
-                          index_chunks.sub_array(num_joins + num_edges, 1),
-                          index_adjusts.sub_array(num_joins + num_edges, 1),
+                          attrib_chunks.sub_array(num_joins + num_edges, num_caps),
+                          index_chunks.sub_array(num_joins + num_edges, num_caps),
+                          index_adjusts.sub_array(num_joins + num_edges, num_caps),
                           fastuidraw::const_c_array<unsigned int>(),
                           startz + incr_z + 1, call_back);
         }
@@ -1555,8 +4417,9 @@ stroke_path(const PainterStrokeShader &shader, const PainterData &draw,
     }
 
   const PainterAttributeData *edge_data(NULL), *cap_data(NULL), *join_data(NULL);
-  unsigned int inc_edge, cap_chunk(0);
+  unsigned int inc_edge, inc_cap(0);
   unsigned int join_chunk(chunk_for_stroking(close_contours));
+  const_c_array<unsigned int> join_chunks(&join_chunk, 1), cap_chunks;
   unsigned int inc_join(0);
   float rounded_thresh;
 
@@ -1571,7 +4434,7 @@ stroke_path(const PainterStrokeShader &shader, const PainterData &draw,
 
   edge_data = &path.edges(close_contours);
   inc_edge = path.z_increment_edge(close_contours);
-  d->compute_edge_chunks(path,
+  d->compute_edge_chunks(path, *edge_data,
                          draw.m_item_shader_data.data().data_base(),
                          *shader.stroking_data_selector(),
                          close_contours, d->m_work_room.m_edge_chunks);
@@ -1611,15 +4474,37 @@ stroke_path(const PainterStrokeShader &shader, const PainterData &draw,
       join_data = NULL;
     }
 
+  if(cap_data != NULL)
+    {
+      inc_cap = cap_data->increment_z_value(0);
+      d->compute_cap_chunks(path, *cap_data,
+                            draw.m_item_shader_data.data().data_base(),
+                            *shader.stroking_data_selector(),
+                            d->m_work_room.m_cap_chunks);
+      cap_chunks = make_c_array(d->m_work_room.m_cap_chunks);
+    }
+
   if(join_data != NULL)
     {
       inc_join = join_data->increment_z_value(join_chunk);
+
+      /* the miter of a miter join can extend far beyond
+         the stroking radius, so miter joins are not culled.
+       */
+      if(js != PainterEnums::miter_joins)
+        {
+          d->compute_join_chunks(path, *join_data,
+                                 draw.m_item_shader_data.data().data_base(),
+                                 *shader.stroking_data_selector(),
+                                 close_contours, d->m_work_room.m_join_chunks);
+          join_chunks = make_c_array(d->m_work_room.m_join_chunks);
+        }
     }
 
   stroke_path(shader, draw,
               edge_data, make_c_array(d->m_work_room.m_edge_chunks), inc_edge,
-              cap_data, cap_chunk,
-              join_data, const_c_array<unsigned int>(&join_chunk, 1),
+              cap_data, cap_chunks, inc_cap,
+              join_data, join_chunks,
               inc_join, with_anti_aliasing, call_back);
 }
 
@@ -1634,7 +4519,21 @@ stroke_path(const PainterStrokeShader &shader, const PainterData &draw, const Pa
   float thresh;
 
   d = static_cast<PainterPrivate*>(m_d);
+
+  trace_scope trace(d);
+  if(trace.recorder() && has_item_data(draw)
+     && (&shader == &default_shaders().stroke_shader()
+         || &shader == &default_shaders().pixel_width_stroke_shader()))
+    {
+      trace.recorder()->stroke_path(draw, path, false,
+                                    &shader == &default_shaders().pixel_width_stroke_shader(),
+                                    close_contours, cp, js, with_anti_aliasing);
+    }
+
   thresh = d->select_path_thresh(path);
+  d->apply_stroke_lod(*shader.stroking_data_selector(),
+                      draw.m_item_shader_data.data().data_base(),
+                      thresh, cp, js);
   stroke_path(shader, draw, *path.tessellation(thresh)->stroked(), thresh,
               close_contours, cp, js, with_anti_aliasing, call_back);
 }
@@ -1666,7 +4565,8 @@ fastuidraw::Painter::
 stroke_dashed_path(const PainterStrokeShader &shader, const PainterData &draw,
                    const PainterAttributeData *edge_data, const_c_array<unsigned int> edge_chunks,
                    unsigned int inc_edge,
-                   const PainterAttributeData *cap_data, unsigned int cap_chunk,
+                   const PainterAttributeData *cap_data, const_c_array<unsigned int> cap_chunks,
+                   unsigned int inc_cap,
                    bool include_joins_from_closing_edge,
                    const DashEvaluatorBase *dash_evaluator, const PainterAttributeData *join_data,
                    bool with_anti_aliasing,
@@ -1715,7 +4615,7 @@ stroke_dashed_path(const PainterStrokeShader &shader, const PainterData &draw,
     }
 
   stroke_path(shader, draw, edge_data, edge_chunks, inc_edge,
-              cap_data, cap_chunk,
+              cap_data, cap_chunks, inc_cap,
               join_data, make_c_array(d->m_work_room.m_stroke_dashed_join_chunks),
               inc_join, with_anti_aliasing, call_back);
 }
@@ -1737,17 +4637,26 @@ stroke_dashed_path(const PainterDashedStrokeShaderSet &shader, const PainterData
     }
 
   const PainterAttributeData *edge_data(NULL), *cap_data(NULL), *join_data(NULL);
-  unsigned int inc_edge, cap_chunk(0);
+  unsigned int inc_edge, inc_cap(0);
+  const_c_array<unsigned int> cap_chunks;
 
-  edge_data = &path.edges(close_contours);
+  edge_data = &d->select_dashed_edges(path, shader.dash_evaluator().get(),
+                                      draw.m_item_shader_data.data().data_base(),
+                                      close_contours);
   inc_edge = path.z_increment_edge(close_contours);
-  d->compute_edge_chunks(path,
+  d->compute_edge_chunks(path, *edge_data,
                          draw.m_item_shader_data.data().data_base(),
                          *shader.shader(cp).stroking_data_selector(),
                          close_contours, d->m_work_room.m_edge_chunks);
   if(!close_contours)
     {
       cap_data = &path.adjustable_caps();
+      inc_cap = cap_data->increment_z_value(0);
+      d->compute_cap_chunks(path, *cap_data,
+                            draw.m_item_shader_data.data().data_base(),
+                            *shader.shader(cp).stroking_data_selector(),
+                            d->m_work_room.m_cap_chunks);
+      cap_chunks = make_c_array(d->m_work_room.m_cap_chunks);
     }
 
   switch(js)
@@ -1777,7 +4686,7 @@ stroke_dashed_path(const PainterDashedStrokeShaderSet &shader, const PainterData
 
   stroke_dashed_path(shader.shader(cp), draw,
                      edge_data, make_c_array(d->m_work_room.m_edge_chunks), inc_edge,
-                     cap_data, cap_chunk,
+                     cap_data, cap_chunks, inc_cap,
                      close_contours,
                      shader.dash_evaluator().get(), join_data,
                      with_anti_aliasing, call_back);
@@ -1794,7 +4703,21 @@ stroke_dashed_path(const PainterDashedStrokeShaderSet &shader, const PainterData
   float thresh;
 
   d = static_cast<PainterPrivate*>(m_d);
+
+  trace_scope trace(d);
+  if(trace.recorder() && has_item_data(draw)
+     && (&shader == &default_shaders().dashed_stroke_shader()
+         || &shader == &default_shaders().pixel_width_dashed_stroke_shader()))
+    {
+      trace.recorder()->stroke_path(draw, path, true,
+                                    &shader == &default_shaders().pixel_width_dashed_stroke_shader(),
+                                    close_contours, cp, js, with_anti_aliasing);
+    }
+
   thresh = d->select_path_thresh(path);
+  d->apply_stroke_lod(*shader.shader(cp).stroking_data_selector(),
+                      draw.m_item_shader_data.data().data_base(),
+                      thresh, cp, js);
   stroke_dashed_path(shader, draw, *path.tessellation(thresh)->stroked(), thresh,
                      close_contours, cp, js, with_anti_aliasing, call_back);
 }
@@ -1828,16 +4751,30 @@ fill_path(const PainterFillShader &shader, const PainterData &draw,
           const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
   PainterPrivate *d;
-  unsigned int idx_chunk, atr_chunk, num_subsets;
+  unsigned int idx_chunk, atr_chunk, aa_chunk, num_subsets;
+  vec2 draw_min, draw_max;
+  bool aa, draw_bounded, have_bounds(false);
 
   d = static_cast<PainterPrivate*>(m_d);
+
+  /* the bounds of the draw are the union of the bounds of
+     the subsets drawn, given by classify_rect() below, not
+     by the caller.
+   */
+  d->m_recorded_draw_bounded = false;
   if(d->m_clip_rect_state.m_all_content_culled)
     {
       return;
     }
 
   idx_chunk = FilledPath::Subset::chunk_from_fill_rule(fill_rule);
+  aa_chunk = FilledPath::Subset::aa_chunk_from_fill_rule(fill_rule);
   atr_chunk = 0;
+  aa = shader.anti_alias() && shader.aa_item_shader() && !d->m_multisampled_target;
+
+  const reference_counted_ptr<PainterItemShader> &item_shader(aa ?
+                                                              shader.aa_item_shader() :
+                                                              shader.item_shader());
 
   d->m_work_room.m_subset_selector.resize(filled_path.number_subsets());
   num_subsets = filled_path.select_subsets(d->m_work_room.m_filled_path_scratch,
@@ -1845,19 +4782,126 @@ fill_path(const PainterFillShader &shader, const PainterData &draw,
                                            d->m_clip_rect_state.item_matrix(),
                                            d->m_max_attribs_per_block,
                                            d->m_max_indices_per_block,
-                                           make_c_array(d->m_work_room.m_subset_selector));
+                                           make_c_array(d->m_work_room.m_subset_selector),
+                                           2.0f * coarse_subset_pixels / d->m_resolution);
+  FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_filled_path_subsets_selected], num_subsets);
+  FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_filled_path_subsets_culled],
+                           filled_path.number_subsets() - num_subsets);
+
+  /* all the subsets are drawn with a single draw_generic(),
+     i.e. a single header and a single packing of the chunks
+     of all subsets.
+   */
+  d->ready_local_clip_equations();
+  d->m_work_room.m_attrib_chunks.clear();
+  d->m_work_room.m_index_chunks.clear();
+  d->m_work_room.m_index_adjusts.clear();
+  d->m_work_room.m_selector.clear();
+  draw_bounded = true;
+
   for(unsigned int i = 0; i < num_subsets; ++i)
     {
       unsigned int s(d->m_work_room.m_subset_selector[i]);
       FilledPath::Subset subset(filled_path.subset(s));
       const PainterAttributeData &data(subset.painter_data());
+      const_c_array<PainterIndex> index_chunk(data.index_data_chunk(idx_chunk));
+      const_c_array<FilledPath::Subset::Cluster> clusters(subset.clusters(idx_chunk));
+      unsigned int attrib_selector_value;
 
-      draw_generic(shader.item_shader(), draw,
-                   data.attribute_data_chunk(atr_chunk),
-                   data.index_data_chunk(idx_chunk),
-                   data.index_adjust_chunk(idx_chunk),
-                   call_back);
+      /* the box of the clusters of the subset culls the subset
+         against the damage region and bounds the draw when
+         recording.
+       */
+      if(clusters.empty())
+        {
+          draw_bounded = false;
+        }
+      else
+        {
+          vec2 bmin(clusters[0].m_min_bb), bmax(clusters[0].m_max_bb);
+
+          for(unsigned int c = 1; c < clusters.size(); ++c)
+            {
+              bmin.x() = t_min(bmin.x(), clusters[c].m_min_bb.x());
+              bmin.y() = t_min(bmin.y(), clusters[c].m_min_bb.y());
+              bmax.x() = t_max(bmax.x(), clusters[c].m_max_bb.x());
+              bmax.y() = t_max(bmax.y(), clusters[c].m_max_bb.y());
+            }
+
+          if(d->classify_rect(bmin, bmax) == rect_clipped_away)
+            {
+              FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_filled_path_subsets_culled], 1u);
+              continue;
+            }
+
+          if(!have_bounds)
+            {
+              draw_min = bmin;
+              draw_max = bmax;
+              have_bounds = true;
+            }
+          else
+            {
+              draw_min.x() = t_min(draw_min.x(), bmin.x());
+              draw_min.y() = t_min(draw_min.y(), bmin.y());
+              draw_max.x() = t_max(draw_max.x(), bmax.x());
+              draw_max.y() = t_max(draw_max.y(), bmax.y());
+            }
+        }
+
+      attrib_selector_value = d->m_work_room.m_attrib_chunks.size();
+      if(!d->select_visible_clusters(subset.clusters(idx_chunk), index_chunk,
+                                     d->m_work_room.m_index_chunks))
+        {
+          d->m_work_room.m_index_chunks.push_back(index_chunk);
+        }
+      d->m_work_room.m_index_adjusts.resize(d->m_work_room.m_index_chunks.size(),
+                                            data.index_adjust_chunk(idx_chunk));
+      d->m_work_room.m_selector.resize(d->m_work_room.m_index_chunks.size(),
+                                       attrib_selector_value);
+      d->m_work_room.m_attrib_chunks.push_back(data.attribute_data_chunk(atr_chunk));
+
+      /* the anti-alias fuzz is drawn in the same call from
+         its own attribute chunk; it is not culled by clusters
+         since it extends past the triangles of the fill.
+       */
+      if(aa)
+        {
+          const PainterAttributeData &aa_data(subset.aa_painter_data());
+
+          d->m_work_room.m_index_chunks.push_back(aa_data.index_data_chunk(aa_chunk));
+          d->m_work_room.m_index_adjusts.push_back(aa_data.index_adjust_chunk(aa_chunk));
+          d->m_work_room.m_selector.push_back(d->m_work_room.m_attrib_chunks.size());
+          d->m_work_room.m_attrib_chunks.push_back(aa_data.attribute_data_chunk(0));
+        }
+    }
+
+  if(d->m_work_room.m_attrib_chunks.empty())
+    {
+      return;
+    }
+
+  /* classify_rect() of each subset set the recorded bounds
+     to those of the subset, set them to the bounds of all.
+   */
+  if(d->m_recording)
+    {
+      if(draw_bounded && have_bounds)
+        {
+          d->classify_rect(draw_min, draw_max);
+        }
+      else
+        {
+          d->m_recorded_draw_bounded = false;
+        }
     }
+
+  draw_generic(item_shader, draw,
+               make_c_array(d->m_work_room.m_attrib_chunks),
+               make_c_array(d->m_work_room.m_index_chunks),
+               make_c_array(d->m_work_room.m_index_adjusts),
+               make_c_array(d->m_work_room.m_selector),
+               call_back);
 }
 
 void
@@ -1870,8 +4914,34 @@ fill_path(const PainterFillShader &shader, const PainterData &draw,
   float thresh;
 
   d = static_cast<PainterPrivate*>(m_d);
+
+  trace_scope trace(d);
+  if(trace.recorder() && &shader == &default_shaders().fill_shader())
+    {
+      trace.recorder()->fill_path(draw, path, fill_rule);
+    }
+
+  if(d->path_is_culled(path))
+    {
+      FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_draws_culled], 1u);
+      return;
+    }
   thresh = d->select_path_thresh(path);
-  fill_path(shader, draw, *path.tessellation(thresh)->filled(), fill_rule, call_back);
+  if(shader.coverage() == PainterFillShader::stencil_coverage
+     && d->m_core->hints().stencil_coverage())
+    {
+      if(!d->m_clip_rect_state.m_all_content_culled)
+        {
+          d->ready_stencil_cover_ops(fill_rule);
+          d->stencil_fill_path(shader.item_shader(), draw, *path.tessellation(thresh), call_back);
+        }
+      return;
+    }
+  /* the simplification of the fill by thresh keeps the number
+     of triangles proportional to the pixels covered when the
+     path is zoomed out.
+   */
+  fill_path(shader, draw, *path.tessellation(thresh)->filled(thresh), fill_rule, call_back);
 }
 
 void
@@ -1890,12 +4960,14 @@ fill_path(const PainterFillShader &shader, const PainterData &draw,
 {
   unsigned int num_subsets;
   PainterPrivate *d;
+  bool aa;
 
   d = static_cast<PainterPrivate*>(m_d);
   if(d->m_clip_rect_state.m_all_content_culled)
     {
       return;
     }
+  aa = shader.anti_alias() && shader.aa_item_shader() && !d->m_multisampled_target;
 
   d->m_work_room.m_subset_selector.resize(filled_path.number_subsets());
   num_subsets = filled_path.select_subsets(d->m_work_room.m_filled_path_scratch,
@@ -1903,8 +4975,13 @@ fill_path(const PainterFillShader &shader, const PainterData &draw,
                                            d->m_clip_rect_state.item_matrix(),
                                            d->m_max_attribs_per_block,
                                            d->m_max_indices_per_block,
-                                           make_c_array(d->m_work_room.m_subset_selector));
+                                           make_c_array(d->m_work_room.m_subset_selector),
+                                           2.0f * coarse_subset_pixels / d->m_resolution);
+  FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_filled_path_subsets_selected], num_subsets);
+  FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_filled_path_subsets_culled],
+                           filled_path.number_subsets() - num_subsets);
 
+  d->ready_local_clip_equations();
   d->m_work_room.m_attrib_chunks.clear();
   d->m_work_room.m_index_chunks.clear();
   d->m_work_room.m_index_adjusts.clear();
@@ -1933,10 +5010,18 @@ fill_path(const PainterFillShader &shader, const PainterData &draw,
           index_chunk = data.index_data_chunk(chunk);
           if(!index_chunk.empty() && fill_rule(winding_number))
             {
-              d->m_work_room.m_selector.push_back(attrib_selector_value);
-              d->m_work_room.m_index_chunks.push_back(index_chunk);
-              d->m_work_room.m_index_adjusts.push_back(data.index_adjust_chunk(chunk));
-              added_chunk = true;
+              unsigned int num_chunks(d->m_work_room.m_index_chunks.size());
+
+              if(!d->select_visible_clusters(subset.clusters(chunk), index_chunk,
+                                             d->m_work_room.m_index_chunks))
+                {
+                  d->m_work_room.m_index_chunks.push_back(index_chunk);
+                }
+              d->m_work_room.m_selector.resize(d->m_work_room.m_index_chunks.size(),
+                                               attrib_selector_value);
+              d->m_work_room.m_index_adjusts.resize(d->m_work_room.m_index_chunks.size(),
+                                                    data.index_adjust_chunk(chunk));
+              added_chunk = added_chunk || num_chunks < d->m_work_room.m_index_chunks.size();
             }
         }
 
@@ -1945,11 +5030,16 @@ fill_path(const PainterFillShader &shader, const PainterData &draw,
           attrib_chunk = data.attribute_data_chunk(0);
           d->m_work_room.m_attrib_chunks.push_back(attrib_chunk);
         }
+
+      if(aa)
+        {
+          d->add_aa_fuzz_chunks(subset, fill_rule);
+        }
     }
 
   if(!d->m_work_room.m_index_chunks.empty())
     {
-      draw_generic(shader.item_shader(), draw,
+      draw_generic(aa ? shader.aa_item_shader() : shader.item_shader(), draw,
                    make_c_array(d->m_work_room.m_attrib_chunks),
                    make_c_array(d->m_work_room.m_index_chunks),
                    make_c_array(d->m_work_room.m_index_adjusts),
@@ -1967,61 +5057,409 @@ fill_path(const PainterFillShader &shader,
   PainterPrivate *d;
   float thresh;
 
-  d = static_cast<PainterPrivate*>(m_d);
-  thresh = d->select_path_thresh(path);
-  fill_path(shader, draw, *path.tessellation(thresh)->filled(), fill_rule, call_back);
+  d = static_cast<PainterPrivate*>(m_d);
+  if(d->path_is_culled(path))
+    {
+      FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_draws_culled], 1u);
+      return;
+    }
+  thresh = d->select_path_thresh(path);
+  if(shader.coverage() == PainterFillShader::stencil_coverage
+     && d->m_core->hints().stencil_coverage())
+    {
+      if(!d->m_clip_rect_state.m_all_content_culled)
+        {
+          const TessellatedPath &tess(*path.tessellation(thresh));
+          d->ready_stencil_cover_ops(tess, fill_rule);
+          d->stencil_fill_path(shader.item_shader(), draw, tess, call_back);
+        }
+      return;
+    }
+  /* the simplification of the fill by thresh keeps the number
+     of triangles proportional to the pixels covered when the
+     path is zoomed out.
+   */
+  fill_path(shader, draw, *path.tessellation(thresh)->filled(thresh), fill_rule, call_back);
+}
+
+void
+fastuidraw::Painter::
+fill_path(const PainterData &draw, const Path &path, const CustomFillRuleBase &fill_rule,
+          const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  fill_path(default_shaders().fill_shader(), draw, path, fill_rule, call_back);
+}
+
+void
+fastuidraw::Painter::
+draw_glyphs(const PainterGlyphShader &shader, const PainterData &draw,
+            const PainterAttributeData &data,
+            const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  if(d->m_clip_rect_state.m_all_content_culled)
+    {
+      return;
+    }
+
+  /* only the data of the default glyph shaders is known to be
+     packed as by PainterAttributeDataFillerGlyphs, which is
+     needed to see if the glyphs are within the clipping.
+   */
+  bool known_packing;
+  known_packing = (&shader == &default_shaders().glyph_shader()
+                   || &shader == &default_shaders().glyph_shader_anisotropic());
+
+  const_c_array<unsigned int> chks(data.non_empty_index_data_chunks());
+  for(unsigned int i = 0; i < chks.size(); ++i)
+    {
+      unsigned int k;
+
+      k = chks[i];
+      if(known_packing)
+        {
+          enum rect_clip_t clip_test;
+
+          clip_test = d->classify_glyphs(data.attribute_data_chunk(k), false);
+          if(clip_test == rect_clipped_away)
+            {
+              FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_draws_culled], 1u);
+              increment_z(data.increment_z_value(k));
+              continue;
+            }
+          d->m_draw_unclipped = (clip_test == rect_not_clipped);
+        }
+      draw_generic(shader.shader(PainterAttributeDataFillerGlyphs::chunk_glyph_type(k)), draw,
+                   data.attribute_data_chunk(k),
+                   data.index_data_chunk(k),
+                   data.index_adjust_chunk(k),
+                   call_back);
+      d->m_draw_unclipped = false;
+      increment_z(data.increment_z_value(k));
+    }
+}
+
+void
+fastuidraw::Painter::
+draw_glyphs(const PainterData &draw,
+            const PainterAttributeData &data, bool use_anistopic_antialias,
+            const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  if(use_anistopic_antialias)
+    {
+      draw_glyphs(default_shaders().glyph_shader_anisotropic(), draw, data, call_back);
+    }
+  else
+    {
+      draw_glyphs(default_shaders().glyph_shader(), draw, data, call_back);
+    }
+}
+
+void
+fastuidraw::Painter::
+draw_glyph_runs(const PainterGlyphShader &shader, const PainterData &draw,
+                const_c_array<const GlyphRun*> runs,
+                const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  trace_scope trace(d);
+  if(trace.recorder()
+     && (&shader == &default_shaders().glyph_shader()
+         || &shader == &default_shaders().glyph_shader_anisotropic()))
+    {
+      trace.recorder()->draw_glyph_runs(draw, runs,
+                                        &shader == &default_shaders().glyph_shader_anisotropic());
+    }
+
+  d->m_recorded_draw_bounded = false;
+  if(d->m_clip_rect_state.m_all_content_culled)
+    {
+      return;
+    }
+
+  bool known_packing;
+  known_packing = (&shader == &default_shaders().glyph_shader()
+                   || &shader == &default_shaders().glyph_shader_anisotropic());
+
+  /* the glyph types drawn by any of the runs */
+  std::vector<unsigned int> &types(d->m_work_room.m_glyph_chunks);
+  types.clear();
+  for(unsigned int r = 0; r < runs.size(); ++r)
+    {
+      if(runs[r])
+        {
+          const_c_array<unsigned int> chks(runs[r]->data().non_empty_index_data_chunks());
+
+          assert(!runs[r]->instanced());
+          types.insert(types.end(), chks.begin(), chks.end());
+        }
+    }
+  std::sort(types.begin(), types.end());
+  types.erase(std::unique(types.begin(), types.end()), types.end());
+
+  for(unsigned int t = 0; t < types.size(); ++t)
+    {
+      unsigned int k(types[t]);
+      int z_inc(0);
+      bool draw_unclipped(true);
+      recorded_bounds bounds;
+
+      d->m_work_room.m_attrib_chunks.clear();
+      d->m_work_room.m_index_chunks.clear();
+      d->m_work_room.m_index_adjusts.clear();
+      for(unsigned int r = 0; r < runs.size(); ++r)
+        {
+          if(!runs[r] || runs[r]->data().index_data_chunk(k).empty())
+            {
+              continue;
+            }
+
+          const PainterAttributeData &data(runs[r]->data());
+          z_inc += data.increment_z_value(k);
+          if(known_packing)
+            {
+              enum rect_clip_t clip_test;
+
+              clip_test = d->classify_glyphs(data.attribute_data_chunk(k), false);
+              if(clip_test == rect_clipped_away)
+                {
+                  FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_draws_culled], 1u);
+                  continue;
+                }
+              draw_unclipped = draw_unclipped && (clip_test == rect_not_clipped);
+              if(d->m_recording)
+                {
+                  bounds.add(d->m_recorded_draw_bounded, d->m_recorded_draw_min, d->m_recorded_draw_max);
+                }
+            }
+          else
+            {
+              draw_unclipped = false;
+              bounds.m_bounded = false;
+            }
+
+          d->m_work_room.m_attrib_chunks.push_back(data.attribute_data_chunk(k));
+          d->m_work_room.m_index_chunks.push_back(data.index_data_chunk(k));
+          d->m_work_room.m_index_adjusts.push_back(data.index_adjust_chunk(k));
+        }
+
+      if(!d->m_work_room.m_attrib_chunks.empty())
+        {
+          if(d->m_recording)
+            {
+              d->m_recorded_draw_bounded = bounds.m_bounded && bounds.m_have_bounds;
+              d->m_recorded_draw_min = bounds.m_min;
+              d->m_recorded_draw_max = bounds.m_max;
+            }
+          d->m_draw_unclipped = draw_unclipped;
+          draw_generic(shader.shader(PainterAttributeDataFillerGlyphs::chunk_glyph_type(k)), draw,
+                       make_c_array(d->m_work_room.m_attrib_chunks),
+                       make_c_array(d->m_work_room.m_index_chunks),
+                       make_c_array(d->m_work_room.m_index_adjusts),
+                       call_back);
+          d->m_draw_unclipped = false;
+        }
+      increment_z(z_inc);
+    }
+}
+
+void
+fastuidraw::Painter::
+draw_glyph_runs(const PainterData &draw,
+                const_c_array<const GlyphRun*> runs, bool use_anistopic_antialias,
+                const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->draw_glyph_runs(draw, runs, use_anistopic_antialias);
+    }
+
+  /* the instanced runs are drawn one by one, the
+     others together with a single draw per glyph type.
+   */
+  std::vector<const GlyphRun*> &batch(d->m_work_room.m_batch_runs);
+  batch.clear();
+  for(unsigned int r = 0; r < runs.size(); ++r)
+    {
+      if(runs[r] && runs[r]->instanced())
+        {
+          draw_glyph_instances(draw, runs[r]->data(), use_anistopic_antialias, call_back);
+        }
+      else if(runs[r])
+        {
+          batch.push_back(runs[r]);
+        }
+    }
+
+  draw_glyph_runs(use_anistopic_antialias ?
+                  default_shaders().glyph_shader_anisotropic() :
+                  default_shaders().glyph_shader(),
+                  draw, make_c_array(batch), call_back);
 }
 
 void
 fastuidraw::Painter::
-fill_path(const PainterData &draw, const Path &path, const CustomFillRuleBase &fill_rule,
-          const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+draw_glyph_instances(const PainterGlyphShader &instance_shader,
+                     const PainterGlyphShader &quad_shader,
+                     const PainterData &draw,
+                     const PainterAttributeData &data,
+                     const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
-  fill_path(default_shaders().fill_shader(), draw, path, fill_rule, call_back);
+  PainterPrivate *d;
+  bool instanced;
+
+  d = static_cast<PainterPrivate*>(m_d);
+  if(d->m_clip_rect_state.m_all_content_culled)
+    {
+      return;
+    }
+
+  instanced = d->m_core->hints().instanced_quads() && !d->m_recording;
+  for(unsigned int k = 0, endk = data.attribute_data_chunks().size(); k < endk; ++k)
+    {
+      const_c_array<PainterAttribute> instances(data.attribute_data_chunk(k));
+      enum glyph_type tp(PainterAttributeDataFillerGlyphs::chunk_glyph_type(k));
+
+      if(instances.empty())
+        {
+          continue;
+        }
+
+      enum rect_clip_t clip_test;
+
+      clip_test = d->classify_glyphs(instances, true);
+      if(clip_test == rect_clipped_away)
+        {
+          FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_draws_culled], 1u);
+          increment_z(data.increment_z_value(k));
+          continue;
+        }
+
+      d->m_draw_unclipped = (clip_test == rect_not_clipped);
+      if(instanced)
+        {
+          PainterPackerData p(draw);
+          if(d->m_draw_unclipped)
+            {
+              p.m_clip = d->m_no_clip_equations;
+              FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_clip_free_draws], 1u);
+            }
+          else
+            {
+              p.m_clip = d->m_clip_rect_state.clip_equations_state(d->m_pool);
+            }
+          p.m_matrix = d->m_clip_rect_state.current_item_marix_state(d->m_item_matrix_cache);
+          d->m_core->draw_instanced_quads(instance_shader.shader(tp), p,
+                                          instances, d->m_current_z, call_back);
+        }
+      else
+        {
+          std::vector<PainterAttribute> &attribs(d->m_work_room.m_attribs);
+          std::vector<PainterIndex> &indices(d->m_work_room.m_indices);
+
+          attribs.resize(4 * instances.size());
+          indices.resize(6 * instances.size());
+          for(unsigned int i = 0; i < instances.size(); ++i)
+            {
+              detail::expand_glyph_instance(instances[i], make_c_array(attribs).sub_array(4 * i, 4));
+              detail::pack_glyph_indices(make_c_array(indices).sub_array(6 * i, 6), 4 * i);
+            }
+          draw_generic(quad_shader.shader(tp), draw,
+                       make_c_array(attribs), make_c_array(indices),
+                       0, call_back);
+        }
+      d->m_draw_unclipped = false;
+      increment_z(data.increment_z_value(k));
+    }
 }
 
 void
 fastuidraw::Painter::
-draw_glyphs(const PainterGlyphShader &shader, const PainterData &draw,
-            const PainterAttributeData &data,
-            const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+draw_hairline(const reference_counted_ptr<PainterItemShader> &instance_shader,
+              const reference_counted_ptr<PainterItemShader> &quad_shader,
+              const PainterData &draw, const HairlinePath &path,
+              const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
   PainterPrivate *d;
+  const_c_array<PainterAttribute> segments(path.segments());
+
   d = static_cast<PainterPrivate*>(m_d);
+  if(d->m_clip_rect_state.m_all_content_culled || segments.empty())
+    {
+      return;
+    }
 
-  if(d->m_clip_rect_state.m_all_content_culled)
+  if(d->m_core->hints().instanced_quads() && !d->m_recording)
     {
+      PainterPackerData p(draw);
+      p.m_clip = d->m_clip_rect_state.clip_equations_state(d->m_pool);
+      p.m_matrix = d->m_clip_rect_state.current_item_marix_state(d->m_item_matrix_cache);
+      d->m_core->draw_instanced_quads(instance_shader, p, segments,
+                                      d->m_current_z, call_back);
       return;
     }
 
-  const_c_array<unsigned int> chks(data.non_empty_index_data_chunks());
-  for(unsigned int i = 0; i < chks.size(); ++i)
+  /* expand the segments in blocks that fit in a
+     single PainterDraw each.
+   */
+  std::vector<PainterAttribute> &attribs(d->m_work_room.m_attribs);
+  std::vector<PainterIndex> &indices(d->m_work_room.m_indices);
+  unsigned int block_size;
+
+  block_size = t_min(d->m_max_attribs_per_block / 4, d->m_max_indices_per_block / 6);
+  assert(block_size > 0);
+  while(!segments.empty())
     {
-      unsigned int k;
+      unsigned int count;
 
-      k = chks[i];
-      draw_generic(shader.shader(static_cast<enum glyph_type>(k)), draw,
-                   data.attribute_data_chunk(k),
-                   data.index_data_chunk(k),
-                   data.index_adjust_chunk(k),
-                   call_back);
-      increment_z(data.increment_z_value(k));
+      count = t_min(block_size, static_cast<unsigned int>(segments.size()));
+      attribs.resize(4 * count);
+      indices.resize(6 * count);
+      for(unsigned int i = 0; i < count; ++i)
+        {
+          HairlinePath::expand_segment(segments[i], make_c_array(attribs).sub_array(4 * i, 4));
+          HairlinePath::pack_segment_indices(make_c_array(indices).sub_array(6 * i, 6), 4 * i);
+        }
+      draw_generic(quad_shader, draw, make_c_array(attribs), make_c_array(indices), 0, call_back);
+      segments = segments.sub_array(count);
     }
 }
 
 void
 fastuidraw::Painter::
-draw_glyphs(const PainterData &draw,
-            const PainterAttributeData &data, bool use_anistopic_antialias,
-            const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+draw_hairline(const PainterData &draw, const HairlinePath &path,
+              const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
+{
+  draw_hairline(default_shaders().hairline_instance_shader(),
+                default_shaders().hairline_shader(),
+                draw, path, call_back);
+}
+
+void
+fastuidraw::Painter::
+draw_glyph_instances(const PainterData &draw,
+                     const PainterAttributeData &data, bool use_anistopic_antialias,
+                     const reference_counted_ptr<PainterPacker::DataCallBack> &call_back)
 {
   if(use_anistopic_antialias)
     {
-      draw_glyphs(default_shaders().glyph_shader_anisotropic(), draw, data, call_back);
+      draw_glyph_instances(default_shaders().glyph_instance_shader_anisotropic(),
+                           default_shaders().glyph_shader_anisotropic(),
+                           draw, data, call_back);
     }
   else
     {
-      draw_glyphs(default_shaders().glyph_shader(), draw, data, call_back);
+      draw_glyph_instances(default_shaders().glyph_instance_shader(),
+                           default_shaders().glyph_shader(),
+                           draw, data, call_back);
     }
 }
 
@@ -2040,7 +5478,14 @@ transformation(const float3x3 &m)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_state(state_stack_entry::saved_clip_rect_state);
   d->m_clip_rect_state.item_matrix(m, true);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->transformation(d->m_clip_rect_state.item_matrix());
+    }
 }
 
 const fastuidraw::PainterPackedValue<fastuidraw::PainterItemMatrix>&
@@ -2049,7 +5494,7 @@ transformation_state(void)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
-  return d->m_clip_rect_state.current_item_marix_state(d->m_pool);
+  return d->m_clip_rect_state.current_item_marix_state(d->m_item_matrix_cache);
 }
 
 void
@@ -2058,7 +5503,14 @@ transformation_state(const PainterPackedValue<PainterItemMatrix> &h)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_state(state_stack_entry::saved_clip_rect_state);
   d->m_clip_rect_state.item_matrix_state(h, true);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->transformation(d->m_clip_rect_state.item_matrix());
+    }
 }
 
 void
@@ -2067,6 +5519,7 @@ concat(const float3x3 &tr)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_state(state_stack_entry::saved_clip_rect_state);
 
   float3x3 m;
   bool tricky;
@@ -2083,6 +5536,12 @@ concat(const float3x3 &tr)
       d->m_clip_rect_state.m_clip_rect.translate(vec2(-tr(0, 2), -tr(1, 2)));
       d->m_clip_rect_state.m_clip_rect.shear(1.0f / tr(0,0), 1.0f / tr(1,1));
     }
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->transformation(d->m_clip_rect_state.item_matrix());
+    }
 }
 
 void
@@ -2091,11 +5550,18 @@ translate(const vec2 &p)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_state(state_stack_entry::saved_clip_rect_state);
 
   float3x3 m(d->m_clip_rect_state.item_matrix());
   m.translate(p.x(), p.y());
   d->m_clip_rect_state.item_matrix(m, false);
   d->m_clip_rect_state.m_clip_rect.translate(-p);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->transformation(d->m_clip_rect_state.item_matrix());
+    }
 }
 
 void
@@ -2104,11 +5570,18 @@ scale(float s)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_state(state_stack_entry::saved_clip_rect_state);
 
   float3x3 m(d->m_clip_rect_state.item_matrix());
   m.scale(s);
   d->m_clip_rect_state.item_matrix(m, false);
   d->m_clip_rect_state.m_clip_rect.scale(1.0f / s);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->transformation(d->m_clip_rect_state.item_matrix());
+    }
 }
 
 void
@@ -2117,11 +5590,18 @@ shear(float sx, float sy)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_state(state_stack_entry::saved_clip_rect_state);
 
   float3x3 m(d->m_clip_rect_state.item_matrix());
   m.shear(sx, sy);
   d->m_clip_rect_state.item_matrix(m, false);
   d->m_clip_rect_state.m_clip_rect.shear(1.0f / sx, 1.0f / sy);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->transformation(d->m_clip_rect_state.item_matrix());
+    }
 }
 
 void
@@ -2130,6 +5610,7 @@ rotate(float angle)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_state(state_stack_entry::saved_clip_rect_state);
 
   float3x3 tr;
   float s, c;
@@ -2143,67 +5624,395 @@ rotate(float angle)
   tr(0, 1) = -s;
   tr(1, 1) = c;
 
-  float3x3 m(d->m_clip_rect_state.item_matrix());
-  m = m * tr;
-  d->m_clip_rect_state.item_matrix(m, true);
-}
+  float3x3 m(d->m_clip_rect_state.item_matrix());
+  m = m * tr;
+  d->m_clip_rect_state.item_matrix(m, true);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->transformation(d->m_clip_rect_state.item_matrix());
+    }
+}
+
+void
+fastuidraw::Painter::
+curveFlatness(float thresh)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->save_state(state_stack_entry::saved_curve_flatness);
+  d->m_curve_flatness = thresh;
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->curve_flatness(thresh);
+    }
+}
+
+float
+fastuidraw::Painter::
+curveFlatness(void)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_curve_flatness;
+}
+
+void
+fastuidraw::Painter::
+splitDashedEdges(bool v)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_split_dashed_edges = v;
+}
+
+bool
+fastuidraw::Painter::
+splitDashedEdges(void)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_split_dashed_edges;
+}
+
+void
+fastuidraw::Painter::
+strokeLODPixelWidth(float v)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_stroke_lod_pixel_width = v;
+}
+
+float
+fastuidraw::Painter::
+strokeLODPixelWidth(void)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_stroke_lod_pixel_width;
+}
+
+void
+fastuidraw::Painter::
+save(void)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->save();
+    }
+  counted_push_back(d->m_state_stack, state_stack_entry(d->m_occluder_stack.size()),
+                    d->m_stats[PainterPacker::num_unbudgeted_allocations]);
+}
+
+void
+fastuidraw::Painter::
+restore(void)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  assert(!d->m_state_stack.empty());
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->restore();
+    }
+
+  const state_stack_entry &st(d->m_state_stack.back());
+
+  if(st.m_saved & state_stack_entry::saved_clip_rect_state)
+    {
+      d->m_clip_rect_state = st.m_clip_rect_state;
+    }
+
+  if(st.m_saved & state_stack_entry::saved_blend)
+    {
+      d->m_core->blend_shader(st.m_blend, st.m_blend_mode);
+    }
+
+  if(st.m_saved & state_stack_entry::saved_curve_flatness)
+    {
+      d->m_curve_flatness = st.m_curve_flatness;
+    }
+
+  while(d->m_occluder_stack.size() > st.m_occluder_stack_position)
+    {
+      d->m_occluder_stack.back().on_pop(this, d);
+      d->m_occluder_stack.pop_back();
+    }
+
+  if(st.m_saved & state_stack_entry::saved_clip_equations)
+    {
+      d->m_clip_store.pop();
+    }
+  d->m_state_stack.pop_back();
+}
+
+bool
+fastuidraw::Painter::
+begin_layer(const vec2 &xy, const vec2 &wh, float opacity,
+            const reference_counted_ptr<PainterLayerCache> &cache)
+{
+  PainterPrivate *d;
+  PainterLayerCachePrivate *c;
+  vec2 qmin, qmax;
+
+  d = static_cast<PainterPrivate*>(m_d);
+  c = (cache) ? static_cast<PainterLayerCachePrivate*>(cache->m_d) : NULL;
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->begin_layer(xy, wh, opacity);
+    }
+
+  /* the entry starts as a layer whose content is drawn directly */
+  counted_push_back(d->m_layer_stack, layer_stack_entry(),
+                    d->m_stats[PainterPacker::num_unbudgeted_allocations]);
+  if(d->m_recording
+     || d->m_clip_rect_state.m_all_content_culled
+     || !d->pixel_rect(d->m_clip_rect_state.item_matrix(), xy, xy + wh, &qmin, &qmax))
+    {
+      return true;
+    }
+
+  layer_stack_entry &L(d->m_layer_stack.back());
+  L.m_xy = xy;
+  L.m_wh = wh;
+  L.m_opacity = opacity;
+  L.m_size.x() = t_min(t_max(1, static_cast<int>(std::ceil(qmax.x() - qmin.x()))), max_layer_size);
+  L.m_size.y() = t_min(t_max(1, static_cast<int>(std::ceil(qmax.y() - qmin.y()))), max_layer_size);
+
+  if(c != NULL)
+    {
+      L.m_retained = true;
+      if(c->matches(xy, wh, L.m_size))
+        {
+          L.m_target = c->m_target;
+          return false;
+        }
+
+      c->m_valid = false;
+      if(!c->m_target
+         || c->m_target->dimensions().x() < L.m_size.x()
+         || c->m_target->dimensions().y() < L.m_size.y())
+        {
+          c->m_target = d->acquire_render_target(L.m_size);
+        }
+      L.m_target = c->m_target;
+    }
+  else
+    {
+      L.m_target = d->acquire_render_target(L.m_size);
+      if(L.m_target)
+        {
+          d->m_used_render_targets.push_back(L.m_target);
+        }
+    }
+
+  if(!L.m_target)
+    {
+      return true;
+    }
+
+  if(c != NULL)
+    {
+      c->m_valid = true;
+      c->m_xy = xy;
+      c->m_wh = wh;
+      c->m_size = L.m_size;
+    }
+
+  L.m_offscreen = true;
+  L.m_resolution = d->m_resolution;
+  L.m_stencil_clip_depth = d->m_stencil_clip_depth;
+  L.m_damage_region.swap(d->m_damage_region);
+  L.m_stream_damage.swap(d->m_stream_damage);
+
+  save();
+  d->save_state(state_stack_entry::saved_clip_rect_state
+                | state_stack_entry::saved_clip_equations);
+
+  /* the draws so far go to the enclosing surface */
+  d->m_core->flush();
+  d->m_backend->begin_render_target(L.m_target);
+
+  ivec2 dims(L.m_target->dimensions());
+  float3x3 proj;
+  vec2 r;
+
+  target_resolution(dims.x(), dims.y());
+  d->m_stencil_clip_depth = 0;
+  d->m_core->stencil_clip_value(0);
+
+  /* the rect maps to the region of L.m_size pixels at the
+     origin of the surface, its min-corner to the texel at
+     the origin.
+   */
+  r = xy + wh * vec2(dims) / vec2(L.m_size);
+  proj = float3x3(float_orthogonal_projection_params(xy.x(), r.x(), xy.y(), r.y()));
+  d->m_clip_rect_state.reset();
+  d->m_clip_rect_state.item_matrix(proj, false);
+  d->m_clip_store.set_current(d->m_clip_rect_state.clip_equations().m_clip_equations);
+  clipInRect(xy, wh);
+
+  return true;
+}
+
+void
+fastuidraw::Painter::
+end_layer(void)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  assert(!d->m_layer_stack.empty());
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->end_layer();
+    }
+
+  layer_stack_entry &L(d->m_layer_stack.back());
+
+  if(L.m_offscreen)
+    {
+      /* the occluders of the clipping within the layer are
+         popped by restore() and drawn to the layer
+       */
+      restore();
+      d->m_core->flush();
+      d->m_backend->end_render_target();
+
+      target_resolution(static_cast<int>(L.m_resolution.x()),
+                        static_cast<int>(L.m_resolution.y()));
+      d->m_stencil_clip_depth = L.m_stencil_clip_depth;
+      d->m_core->stencil_clip_value(L.m_stencil_clip_depth);
+      d->m_damage_region.swap(L.m_damage_region);
+      d->m_stream_damage.swap(L.m_stream_damage);
+    }
+
+  if(L.m_target)
+    {
+      PainterBrush brush;
+      float2x2 m;
+      vec2 factor;
+      reference_counted_ptr<PainterBackend::RenderTarget> blurred;
+
+      if(L.m_blur_radius > 0.0f)
+        {
+          /* a drop shadow needs the layer unblurred, and
+             the surface of a PainterLayerCache is kept
+             unblurred for the frames that follow.
+           */
+          if(L.m_drop_shadow || L.m_retained)
+            {
+              blurred = d->acquire_render_target(L.m_size);
+              if(blurred)
+                {
+                  d->m_used_render_targets.push_back(blurred);
+                }
+            }
+          else
+            {
+              blurred = L.m_target;
+            }
+
+          /* the draws of the enclosing surface stay with
+             the PainterPacker, the blur is only of the
+             surfaces of the layer, whose draws are sent.
+           */
+          if(blurred
+             && routine_fail == d->m_backend->blur_render_target(L.m_target, blurred, L.m_size,
+                                                                 L.m_blur_radius, L.m_drop_shadow))
+            {
+              blurred.clear();
+            }
+        }
+
+      /* the brush maps the rect of the layer to the
+         region of L.m_size texels of the surface
+       */
+      factor = vec2(L.m_size) / L.m_wh;
+      m(0, 0) = factor.x();
+      m(1, 1) = factor.y();
 
-void
-fastuidraw::Painter::
-curveFlatness(float thresh)
-{
-  PainterPrivate *d;
-  d = static_cast<PainterPrivate*>(m_d);
-  d->m_curve_flatness = thresh;
-}
+      if(L.m_drop_shadow && blurred)
+        {
+          /* the shadow is white with the blurred coverage
+             of the layer as alpha, the pen colors it.
+           */
+          vec2 xy(L.m_xy + L.m_shadow_offset);
+
+          brush
+            .pen(L.m_shadow_color.x(), L.m_shadow_color.y(), L.m_shadow_color.z(),
+                 L.m_shadow_color.w() * L.m_opacity)
+            .sub_image(blurred->image(), uvec2(0, 0), uvec2(L.m_size),
+                       PainterBrush::image_filter_linear)
+            .transformation(-factor * xy, m);
+          draw_rect(PainterData(&brush), xy, L.m_wh);
+          blurred.clear();
+        }
 
-float
-fastuidraw::Painter::
-curveFlatness(void)
-{
-  PainterPrivate *d;
-  d = static_cast<PainterPrivate*>(m_d);
-  return d->m_curve_flatness;
+      brush
+        .pen(1.0f, 1.0f, 1.0f, L.m_opacity)
+        .sub_image(blurred ? blurred->image() : L.m_target->image(),
+                   uvec2(0, 0), uvec2(L.m_size),
+                   PainterBrush::image_filter_linear)
+        .transformation(-factor * L.m_xy, m);
+      draw_rect(PainterData(&brush), L.m_xy, L.m_wh);
+    }
+  d->m_layer_stack.pop_back();
 }
 
 void
 fastuidraw::Painter::
-save(void)
+end_layer_blurred(float radius)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
-  state_stack_entry st;
-  st.m_occluder_stack_position = d->m_occluder_stack.size();
-  st.m_blend = d->m_core->blend_shader();
-  st.m_blend_mode = d->m_core->blend_mode();
-  st.m_clip_rect_state = d->m_clip_rect_state;
-  st.m_curve_flatness = d->m_curve_flatness;
+  assert(!d->m_layer_stack.empty());
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->end_layer_blurred(radius);
+    }
 
-  d->m_state_stack.push_back(st);
-  d->m_clip_store.push();
+  layer_stack_entry &L(d->m_layer_stack.back());
+  L.m_blur_radius = radius;
+  L.m_drop_shadow = false;
+  end_layer();
 }
 
 void
 fastuidraw::Painter::
-restore(void)
+end_layer_drop_shadow(float radius, const vec2 &offset, const vec4 &color)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
-  assert(!d->m_state_stack.empty());
-  const state_stack_entry &st(d->m_state_stack.back());
-
-  d->m_clip_rect_state = st.m_clip_rect_state;
-  d->m_core->blend_shader(st.m_blend, st.m_blend_mode);
-  d->m_curve_flatness = st.m_curve_flatness;
-  while(d->m_occluder_stack.size() > st.m_occluder_stack_position)
+  assert(!d->m_layer_stack.empty());
+  trace_scope trace(d);
+  if(trace.recorder())
     {
-      d->m_occluder_stack.back().on_pop(this);
-      d->m_occluder_stack.pop_back();
+      trace.recorder()->end_layer_drop_shadow(radius, offset, color);
     }
-  d->m_state_stack.pop_back();
-  d->m_clip_store.pop();
+
+  layer_stack_entry &L(d->m_layer_stack.back());
+  L.m_blur_radius = t_max(radius, 1.0f);
+  L.m_drop_shadow = true;
+  L.m_shadow_offset = offset;
+  L.m_shadow_color = color;
+  end_layer();
 }
 
 /* How we handle clipping.
@@ -2229,6 +6038,26 @@ restore(void)
         - clipIn by path P
             1. clipIn by R, R = bounding box of P
             2. clipOut by R\P.
+
+     If the backend supports clipping with the stencil buffer,
+     see PainterPrivate::use_stencil_clipping(), the occluders
+     are replaced by changing the stencil buffer where the
+     stencil value is d = m_stencil_clip_depth, i.e. in the
+     current clipping region:
+        - clipOut by path P
+           1. draw the viewport incrementing the stencil value.
+           2. draw the fill of P decrementing where the stencil
+              is d + 1.
+        - clipIn by path P
+           1. clipIn by R, R = bounding box of P
+           2. draw the fill of P incrementing the stencil value.
+        - clipIn by rect R, hard case
+           1. set the clip equations
+           2. draw R with the OLD clip equations incrementing
+              the stencil value.
+     after which d is incremented and all draws are made where
+     the stencil value is d. Popping the clipping draws the
+     viewport decrementing where the stencil value is d.
 */
 
 void
@@ -2238,6 +6067,12 @@ clipOutPath(const Path &path, enum PainterEnums::fill_rule_t fill_rule)
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->clip_path(false, path, fill_rule);
+    }
+
   if(d->m_clip_rect_state.m_all_content_culled)
     {
       /* everything is clipped anyways, adding more clipping does not matter
@@ -2249,12 +6084,30 @@ clipOutPath(const Path &path, enum PainterEnums::fill_rule_t fill_rule)
   BlendMode::packed_value old_blend_mode;
   reference_counted_ptr<ZDataCallBack> zdatacallback;
 
+  if(d->use_stencil_clipping())
+    {
+      old_blend = blend_shader();
+      old_blend_mode = blend_mode();
+      d->stencil_clip_blend(BlendMode::STENCIL_CLIP_INCREMENT, d->m_stencil_clip_depth);
+      d->draw_stencil_clip_fullscreen();
+      d->stencil_clip_blend(BlendMode::STENCIL_CLIP_DECREMENT, d->m_stencil_clip_depth + 1);
+      fill_path(d->m_stencil_clip_fill_shader, PainterData(d->m_black_brush), path, fill_rule);
+      blend_shader(old_blend, old_blend_mode);
+      d->push_stencil_clip();
+      return;
+    }
+
+  if(d->reject_occluder_clipping())
+    {
+      return;
+    }
+
   /* zdatacallback generates a list of PainterDraw::DelayedAction
      objects (held in m_actions) who's action is to write the correct
      z-value to occlude elements drawn after clipOut but not after
      the next time m_occluder_stack is popped.
    */
-  zdatacallback = FASTUIDRAWnew ZDataCallBack();
+  zdatacallback = d->occluder_data_call_back();
   old_blend = blend_shader();
   old_blend_mode = blend_mode();
 
@@ -2262,7 +6115,9 @@ clipOutPath(const Path &path, enum PainterEnums::fill_rule_t fill_rule)
   fill_path(PainterData(d->m_black_brush), path, fill_rule, zdatacallback);
   blend_shader(old_blend, old_blend_mode);
 
-  d->m_occluder_stack.push_back(occluder_stack_entry(zdatacallback->m_actions));
+  counted_push_back(d->m_occluder_stack, occluder_stack_entry(),
+                    d->m_stats[PainterPacker::num_unbudgeted_allocations]);
+  d->m_occluder_stack.back().set_occluder_z(zdatacallback);
 }
 
 void
@@ -2283,12 +6138,30 @@ clipOutPath(const Path &path, const CustomFillRuleBase &fill_rule)
   BlendMode::packed_value old_blend_mode;
   reference_counted_ptr<ZDataCallBack> zdatacallback;
 
+  if(d->use_stencil_clipping())
+    {
+      old_blend = blend_shader();
+      old_blend_mode = blend_mode();
+      d->stencil_clip_blend(BlendMode::STENCIL_CLIP_INCREMENT, d->m_stencil_clip_depth);
+      d->draw_stencil_clip_fullscreen();
+      d->stencil_clip_blend(BlendMode::STENCIL_CLIP_DECREMENT, d->m_stencil_clip_depth + 1);
+      fill_path(d->m_stencil_clip_fill_shader, PainterData(d->m_black_brush), path, fill_rule);
+      blend_shader(old_blend, old_blend_mode);
+      d->push_stencil_clip();
+      return;
+    }
+
+  if(d->reject_occluder_clipping())
+    {
+      return;
+    }
+
   /* zdatacallback generates a list of PainterDraw::DelayedAction
      objects (held in m_actions) who's action is to write the correct
      z-value to occlude elements drawn after clipOut but not after
      the next time m_occluder_stack is popped.
    */
-  zdatacallback = FASTUIDRAWnew ZDataCallBack();
+  zdatacallback = d->occluder_data_call_back();
   old_blend = blend_shader();
   old_blend_mode = blend_mode();
 
@@ -2296,7 +6169,9 @@ clipOutPath(const Path &path, const CustomFillRuleBase &fill_rule)
   fill_path(PainterData(d->m_black_brush), path, fill_rule, zdatacallback);
   blend_shader(old_blend, old_blend_mode);
 
-  d->m_occluder_stack.push_back(occluder_stack_entry(zdatacallback->m_actions));
+  counted_push_back(d->m_occluder_stack, occluder_stack_entry(),
+                    d->m_stats[PainterPacker::num_unbudgeted_allocations]);
+  d->m_occluder_stack.back().set_occluder_z(zdatacallback);
 }
 
 void
@@ -2306,6 +6181,12 @@ clipInPath(const Path &path, enum PainterEnums::fill_rule_t fill_rule)
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->clip_path(true, path, fill_rule);
+    }
+
   if(d->m_clip_rect_state.m_all_content_culled)
     {
       /* everything is clipped anyways, adding more clipping does not matter
@@ -2317,6 +6198,11 @@ clipInPath(const Path &path, enum PainterEnums::fill_rule_t fill_rule)
   pmin = path.tessellation()->bounding_box_min();
   pmax = path.tessellation()->bounding_box_max();
   clipInRect(pmin, pmax - pmin);
+  if(d->use_stencil_clipping())
+    {
+      d->stencil_clip_in_path(this, path, fill_rule);
+      return;
+    }
   clipOutPath(path, PainterEnums::complement_fill_rule(fill_rule));
 }
 
@@ -2338,9 +6224,115 @@ clipInPath(const Path &path, const CustomFillRuleBase &fill_rule)
   pmin = path.tessellation()->bounding_box_min();
   pmax = path.tessellation()->bounding_box_max();
   clipInRect(pmin, pmax - pmin);
+  if(d->use_stencil_clipping())
+    {
+      d->stencil_clip_in_path(this, path, fill_rule);
+      return;
+    }
   clipOutPath(path, ComplementFillRule(&fill_rule));
 }
 
+void
+fastuidraw::Painter::
+clipOutPath(const Path &path, enum PainterEnums::fill_rule_t fill_rule,
+            const reference_counted_ptr<PainterClipCache> &cache)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  if(!cache || d->m_recording || d->use_stencil_clipping())
+    {
+      clipOutPath(path, fill_rule);
+      return;
+    }
+
+  if(d->m_clip_rect_state.m_all_content_culled || d->reject_occluder_clipping())
+    {
+      /* everything is clipped anyways, adding more clipping does not matter
+       */
+      return;
+    }
+
+  PainterClipCachePrivate *c;
+  reference_counted_ptr<const TessellatedPath> tess;
+  reference_counted_ptr<ZDataCallBack> zdatacallback;
+
+  c = static_cast<PainterClipCachePrivate*>(cache->m_d);
+  tess = path.tessellation(d->select_path_thresh(path));
+  if(c->matches(tess, fill_rule,
+                d->m_clip_rect_state.item_matrix(),
+                d->m_clip_rect_state.clip_equations(),
+                d->m_resolution))
+    {
+      FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_clip_cache_hits], 1u);
+    }
+  else
+    {
+      reference_counted_ptr<PainterBlendShader> old_blend;
+      BlendMode::packed_value old_blend_mode;
+
+      FASTUIDRAWincrement_stat(d->m_stats[PainterPacker::num_clip_cache_misses], 1u);
+      if(!c->m_stream)
+        {
+          c->m_stream = FASTUIDRAWnew PainterPackerStream(d->m_alignment);
+        }
+
+      /* record the occluder, the PainterPackerStream keeps
+         the blend shader and blend mode of each draw, so
+         the blend state only needs to be set for recording.
+       */
+      old_blend = blend_shader();
+      old_blend_mode = blend_mode();
+      begin_recording(c->m_stream);
+      blend_shader(PainterEnums::blend_porter_duff_dst);
+      fill_path(PainterData(d->m_black_brush), path, fill_rule);
+      blend_shader(old_blend, old_blend_mode);
+      end_recording();
+
+      c->m_path = tess;
+      c->m_fill_rule = fill_rule;
+      c->m_item_matrix = d->m_clip_rect_state.item_matrix();
+      c->m_clip_equations = d->m_clip_rect_state.clip_equations();
+      c->m_resolution = d->m_resolution;
+    }
+
+  /* the z-values of the occluder are written when m_occluder_stack
+     is popped exactly as for the uncached clipOutPath().
+   */
+  zdatacallback = d->occluder_data_call_back();
+  d->m_core->draw_stream(*c->m_stream, d->m_current_z, zdatacallback);
+  counted_push_back(d->m_occluder_stack, occluder_stack_entry(),
+                    d->m_stats[PainterPacker::num_unbudgeted_allocations]);
+  d->m_occluder_stack.back().set_occluder_z(zdatacallback);
+}
+
+void
+fastuidraw::Painter::
+clipInPath(const Path &path, enum PainterEnums::fill_rule_t fill_rule,
+           const reference_counted_ptr<PainterClipCache> &cache)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  if(d->m_clip_rect_state.m_all_content_culled)
+    {
+      /* everything is clipped anyways, adding more clipping does not matter
+       */
+      return;
+    }
+
+  vec2 pmin, pmax;
+  pmin = path.tessellation()->bounding_box_min();
+  pmax = path.tessellation()->bounding_box_max();
+  clipInRect(pmin, pmax - pmin);
+  if(d->use_stencil_clipping())
+    {
+      d->stencil_clip_in_path(this, path, fill_rule);
+      return;
+    }
+  clipOutPath(path, PainterEnums::complement_fill_rule(fill_rule), cache);
+}
+
 void
 fastuidraw::Painter::
 clipInRect(const vec2 &pmin, const vec2 &wh)
@@ -2348,6 +6340,14 @@ clipInRect(const vec2 &pmin, const vec2 &wh)
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->clip_in_rect(pmin, wh);
+    }
+  d->save_state(state_stack_entry::saved_clip_rect_state
+                | state_stack_entry::saved_clip_equations);
+
   vec2 pmax(pmin + wh);
 
   d->m_clip_rect_state.m_all_content_culled =
@@ -2425,6 +6425,33 @@ clipInRect(const vec2 &pmin, const vec2 &wh)
       return;
     }
 
+  if(d->use_stencil_clipping())
+    {
+      /* draw the new clipping rectangle with the old clip
+         equations, incrementing the stencil value where it
+         is within the old clipping region.
+       */
+      fastuidraw::reference_counted_ptr<PainterBlendShader> old_blend;
+      BlendMode::packed_value old_blend_mode;
+
+      old_blend = blend_shader();
+      old_blend_mode = blend_mode();
+      d->m_clip_rect_state.clip_equations_state(prev_clip);
+      d->stencil_clip_blend(BlendMode::STENCIL_CLIP_INCREMENT, d->m_stencil_clip_depth);
+      d->draw_rect_single_chunk(default_shaders().fill_shader().item_shader(),
+                                PainterData(d->m_black_brush), pmin, pmax,
+                                reference_counted_ptr<PainterPacker::DataCallBack>());
+      d->m_clip_rect_state.clip_equations_state(current_clip);
+      blend_shader(old_blend, old_blend_mode);
+      d->push_stencil_clip();
+      return;
+    }
+
+  if(d->reject_occluder_clipping())
+    {
+      return;
+    }
+
   /* draw the complement of the half planes. The half planes
      are in 3D api coordinates, so set the matrix temporarily
      to identity. Note that we pass false to item_matrix_state()
@@ -2432,12 +6459,12 @@ clipInRect(const vec2 &pmin, const vec2 &wh)
      state from being marked as dirty.
    */
   PainterPackedValue<PainterItemMatrix> matrix_state;
-  matrix_state = d->m_clip_rect_state.current_item_marix_state(d->m_pool);
+  matrix_state = d->m_clip_rect_state.current_item_marix_state(d->m_item_matrix_cache);
   assert(matrix_state);
   d->m_clip_rect_state.item_matrix_state(d->m_identiy_matrix, false);
 
   reference_counted_ptr<ZDataCallBack> zdatacallback;
-  zdatacallback = FASTUIDRAWnew ZDataCallBack();
+  zdatacallback = d->occluder_data_call_back();
 
   fastuidraw::reference_counted_ptr<PainterBlendShader> old_blend;
   BlendMode::packed_value old_blend_mode;
@@ -2476,12 +6503,80 @@ clipInRect(const vec2 &pmin, const vec2 &wh)
 
   /* add to occluder stack.
    */
-  d->m_occluder_stack.push_back(occluder_stack_entry(zdatacallback->m_actions));
+  counted_push_back(d->m_occluder_stack, occluder_stack_entry(),
+                    d->m_stats[PainterPacker::num_unbudgeted_allocations]);
+  d->m_occluder_stack.back().set_occluder_z(zdatacallback);
 
   d->m_clip_rect_state.item_matrix_state(matrix_state, false);
   blend_shader(old_blend, old_blend_mode);
 }
 
+void
+fastuidraw::Painter::
+clipInRoundedRect(const vec2 &pmin, const vec2 &wh, float corner_radius)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->clip_in_rounded_rect(pmin, wh, corner_radius);
+    }
+
+  corner_radius = t_min(corner_radius, 0.5f * t_min(wh.x(), wh.y()));
+
+  /* the straight sides are handled by clipInRect(), which
+     also takes care of saving the clip state.
+   */
+  clipInRect(pmin, wh);
+  if(d->m_clip_rect_state.m_all_content_culled || corner_radius <= 0.0f)
+    {
+      return;
+    }
+
+  if(!d->m_core->hints().rounded_rect_clipping()
+     || d->m_clip_rect_state.clip_equations().m_rounded_rect_radius > 0.0f)
+    {
+      /* either the backend cannot clip corners or a rounded
+         rect is already in the clip state; fall back to
+         clipping against a path of the rounded rect.
+       */
+      const float quarter_turn(0.5f * static_cast<float>(M_PI));
+      vec2 pmax(pmin + wh);
+      Path path;
+
+      path << vec2(pmin.x() + corner_radius, pmin.y())
+           << vec2(pmax.x() - corner_radius, pmin.y())
+           << Path::arc(quarter_turn, vec2(pmax.x(), pmin.y() + corner_radius))
+           << vec2(pmax.x(), pmax.y() - corner_radius)
+           << Path::arc(quarter_turn, vec2(pmax.x() - corner_radius, pmax.y()))
+           << vec2(pmin.x() + corner_radius, pmax.y())
+           << Path::arc(quarter_turn, vec2(pmin.x(), pmax.y() - corner_radius))
+           << vec2(pmin.x(), pmin.y() + corner_radius)
+           << Path::contour_end_arc(quarter_turn);
+      clipInPath(path, PainterEnums::nonzero_fill_rule);
+      return;
+    }
+
+  /* the corners are tested per fragment in coordinates
+     relative to the center of the rect; the map from clip
+     coordinates to those coordinates is given by the
+     inverse transpose of the item matrix applied to the
+     rows of the translation by -center.
+   */
+  const float3x3 &inverse_transpose(d->m_clip_rect_state.item_matrix_inverse_transpose());
+  PainterClipEquations cl(d->m_clip_rect_state.clip_equations());
+  vec2 center(pmin + 0.5f * wh);
+
+  cl.m_rounded_rect_transformation[0] = inverse_transpose * vec3(1.0f, 0.0f, -center.x());
+  cl.m_rounded_rect_transformation[1] = inverse_transpose * vec3(0.0f, 1.0f, -center.y());
+  cl.m_rounded_rect_transformation[2] = inverse_transpose * vec3(0.0f, 0.0f, 1.0f);
+  cl.m_rounded_rect_half_size = 0.5f * wh;
+  cl.m_rounded_rect_radius = corner_radius;
+  d->m_clip_rect_state.clip_equations(cl);
+}
+
 const fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlas>&
 fastuidraw::Painter::
 glyph_atlas(void) const
@@ -2534,7 +6629,101 @@ blend_shader(const fastuidraw::reference_counted_ptr<PainterBlendShader> &h,
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  d->save_state(state_stack_entry::saved_blend);
   d->m_core->blend_shader(h, mode);
+
+  trace_scope trace(d);
+  if(trace.recorder())
+    {
+      trace.recorder()->blend_shader(default_shaders(), h, mode);
+    }
+}
+
+void
+fastuidraw::Painter::
+stream_reorder_window(unsigned int v)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_core->stream_reorder_window(v);
+}
+
+unsigned int
+fastuidraw::Painter::
+stream_reorder_window(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_core->stream_reorder_window();
+}
+
+void
+fastuidraw::Painter::
+early_flush_attributes(unsigned int v)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_core->early_flush_attributes(v);
+}
+
+unsigned int
+fastuidraw::Painter::
+early_flush_attributes(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_core->early_flush_attributes();
+}
+
+void
+fastuidraw::Painter::
+early_flush_indices(unsigned int v)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_core->early_flush_indices(v);
+}
+
+unsigned int
+fastuidraw::Painter::
+early_flush_indices(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_core->early_flush_indices();
+}
+
+void
+fastuidraw::Painter::
+reserve(const Budget &budget)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+
+  d->m_core->reserve_draws(budget.m_draws);
+  d->m_occluder_stack.reserve(budget.m_clip_depth);
+  d->m_state_stack.reserve(budget.m_save_depth);
+  d->m_layer_stack.reserve(budget.m_layer_depth);
+  d->m_clip_store.reserve(budget.m_save_depth, budget.m_clip_equations);
+  d->m_z_frame_pool.reserve(budget.m_clippings, budget.m_occluder_draws);
+}
+
+void
+fastuidraw::Painter::
+stream_occlusion_culling(bool v)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_core->stream_occlusion_culling(v);
+}
+
+bool
+fastuidraw::Painter::
+stream_occlusion_culling(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_core->stream_occlusion_culling();
 }
 
 const fastuidraw::PainterShaderSet&
@@ -2552,7 +6741,7 @@ query_stat(enum PainterPacker::stats_t st) const
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
-  return d->m_core->query_stat(st);
+  return d->m_core->query_stat(st) + d->m_stats[st];
 }
 
 unsigned int
@@ -2635,3 +6824,74 @@ register_shader(const PainterShaderSet &p)
   d = static_cast<PainterPrivate*>(m_d);
   d->m_core->register_shader(p);
 }
+
+////////////////////////////////////
+// fastuidraw::PainterClipCache methods
+fastuidraw::PainterClipCache::
+PainterClipCache(void)
+{
+  m_d = FASTUIDRAWnew PainterClipCachePrivate();
+}
+
+fastuidraw::PainterClipCache::
+~PainterClipCache()
+{
+  PainterClipCachePrivate *d;
+  d = static_cast<PainterClipCachePrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+void
+fastuidraw::PainterClipCache::
+clear(void)
+{
+  PainterClipCachePrivate *d;
+  d = static_cast<PainterClipCachePrivate*>(m_d);
+  d->m_stream.clear();
+  d->m_path.clear();
+}
+
+bool
+fastuidraw::PainterClipCache::
+valid(void) const
+{
+  PainterClipCachePrivate *d;
+  d = static_cast<PainterClipCachePrivate*>(m_d);
+  return d->m_stream;
+}
+
+////////////////////////////////////
+// fastuidraw::PainterLayerCache methods
+fastuidraw::PainterLayerCache::
+PainterLayerCache(void)
+{
+  m_d = FASTUIDRAWnew PainterLayerCachePrivate();
+}
+
+fastuidraw::PainterLayerCache::
+~PainterLayerCache()
+{
+  PainterLayerCachePrivate *d;
+  d = static_cast<PainterLayerCachePrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+void
+fastuidraw::PainterLayerCache::
+clear(void)
+{
+  PainterLayerCachePrivate *d;
+  d = static_cast<PainterLayerCachePrivate*>(m_d);
+  d->m_valid = false;
+}
+
+bool
+fastuidraw::PainterLayerCache::
+valid(void) const
+{
+  PainterLayerCachePrivate *d;
+  d = static_cast<PainterLayerCachePrivate*>(m_d);
+  return d->m_valid;
+}
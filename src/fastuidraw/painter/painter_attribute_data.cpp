@@ -21,26 +21,107 @@
 #include <fastuidraw/util/fastuidraw_memory.hpp>
 #include <fastuidraw/painter/painter_attribute_data.hpp>
 #include "../private/util_private.hpp"
+#include "../private/blob_private.hpp"
+#include "../private/memory_report_private.hpp"
 
 namespace
 {
   class PainterAttributeDataPrivate
   {
   public:
+    PainterAttributeDataPrivate(void):
+      m_reported_bytes(0)
+    {}
+
+    ~PainterAttributeDataPrivate()
+    {
+      fastuidraw::detail::memory_report_shrink(fastuidraw::memory::subsystem_attribute_data,
+                                               m_reported_bytes, 0);
+    }
+
     void
     ready_non_empty_index_data_chunks(void);
 
+    /* update the bytes of m_attribute_data and m_index_data
+       reported to memory::subsystem_usage()
+     */
+    void
+    update_memory_report(void);
+
     std::vector<fastuidraw::PainterAttribute> m_attribute_data;
     std::vector<fastuidraw::PainterIndex> m_index_data;
 
+    /* the arrays into which the chunks point, either
+       m_attribute_data and m_index_data or, when the
+       data is read from a blob, the words of the blob
+     */
+    fastuidraw::const_c_array<fastuidraw::PainterAttribute> m_attribute_store;
+    fastuidraw::const_c_array<fastuidraw::PainterIndex> m_index_store;
+
     std::vector<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > m_attribute_chunks;
     std::vector<fastuidraw::const_c_array<fastuidraw::PainterIndex> > m_index_chunks;
     std::vector<unsigned int> m_increment_z;
     std::vector<unsigned int> m_non_empty_index_data_chunks;
     std::vector<int> m_index_adjust_chunks;
+
+    uint64_t m_reported_bytes;
+  };
+
+  /* job for run_in_parallel() to run the fill jobs
+     of a PainterAttributeDataFiller
+   */
+  class FillJob
+  {
+  public:
+    FillJob(const fastuidraw::PainterAttributeDataFiller &filler,
+            PainterAttributeDataPrivate *d):
+      m_filler(filler),
+      m_d(d)
+    {}
+
+    void
+    operator()(unsigned int begin, unsigned int end)
+    {
+      for(unsigned int j = begin; j < end; ++j)
+        {
+          m_filler.fill_job(j,
+                            fastuidraw::make_c_array(m_d->m_attribute_data),
+                            fastuidraw::make_c_array(m_d->m_index_data),
+                            fastuidraw::make_c_array(m_d->m_attribute_chunks),
+                            fastuidraw::make_c_array(m_d->m_index_chunks),
+                            fastuidraw::make_c_array(m_d->m_increment_z),
+                            fastuidraw::make_c_array(m_d->m_index_adjust_chunks));
+        }
+    }
+
+  private:
+    const fastuidraw::PainterAttributeDataFiller &m_filler;
+    PainterAttributeDataPrivate *m_d;
   };
 }
 
+void
+PainterAttributeDataPrivate::
+update_memory_report(void)
+{
+  uint64_t bytes;
+
+  bytes = m_attribute_data.capacity() * sizeof(fastuidraw::PainterAttribute)
+    + m_index_data.capacity() * sizeof(fastuidraw::PainterIndex);
+
+  if(bytes > m_reported_bytes)
+    {
+      fastuidraw::detail::memory_report_grow(fastuidraw::memory::subsystem_attribute_data,
+                                             bytes - m_reported_bytes, 0);
+    }
+  else
+    {
+      fastuidraw::detail::memory_report_shrink(fastuidraw::memory::subsystem_attribute_data,
+                                               m_reported_bytes - bytes, 0);
+    }
+  m_reported_bytes = bytes;
+}
+
 void
 PainterAttributeDataPrivate::
 ready_non_empty_index_data_chunks(void)
@@ -55,6 +136,153 @@ ready_non_empty_index_data_chunks(void)
     }
 }
 
+namespace
+{
+  template<typename T>
+  void
+  write_chunks(fastuidraw::detail::BlobWriter &dst,
+               fastuidraw::const_c_array<T> store,
+               const std::vector<fastuidraw::const_c_array<T> > &chunks)
+  {
+    dst.write_u32(store.size());
+    dst.write_pod_array(store);
+    dst.write_u32(chunks.size());
+    for(unsigned int i = 0, endi = chunks.size(); i < endi; ++i)
+      {
+        unsigned int offset;
+
+        offset = chunks[i].empty() ? 0u : chunks[i].c_ptr() - store.c_ptr();
+        assert(chunks[i].empty() || (offset + chunks[i].size() <= store.size()));
+        dst.write_u32(offset);
+        dst.write_u32(chunks[i].size());
+      }
+  }
+
+  template<typename T>
+  fastuidraw::const_c_array<T>
+  read_chunks(fastuidraw::detail::BlobReader &src,
+              std::vector<fastuidraw::const_c_array<T> > &chunks)
+  {
+    fastuidraw::const_c_array<T> store;
+    unsigned int num_chunks;
+
+    store = src.read_pod_array<T>(src.read_u32());
+    num_chunks = src.read_u32();
+    chunks.clear();
+    for(unsigned int i = 0; i < num_chunks && !src.failed(); ++i)
+      {
+        unsigned int offset, size;
+
+        offset = src.read_u32();
+        size = src.read_u32();
+        if(size == 0)
+          {
+            chunks.push_back(fastuidraw::const_c_array<T>());
+          }
+        else if(offset <= store.size() && size <= store.size() - offset)
+          {
+            chunks.push_back(store.sub_array(offset, size));
+          }
+        else
+          {
+            src.fail();
+          }
+      }
+    return store;
+  }
+}
+
+void
+fastuidraw::detail::
+write_painter_attribute_data(BlobWriter &dst, const PainterAttributeData &data)
+{
+  const PainterAttributeDataPrivate *d;
+  d = static_cast<const PainterAttributeDataPrivate*>(data.m_d);
+
+  write_chunks(dst, d->m_attribute_store, d->m_attribute_chunks);
+  write_chunks(dst, d->m_index_store, d->m_index_chunks);
+
+  dst.write_u32(d->m_index_adjust_chunks.size());
+  for(unsigned int i = 0, endi = d->m_index_adjust_chunks.size(); i < endi; ++i)
+    {
+      dst.write_i32(d->m_index_adjust_chunks[i]);
+    }
+
+  dst.write_u32(d->m_increment_z.size());
+  for(unsigned int i = 0, endi = d->m_increment_z.size(); i < endi; ++i)
+    {
+      dst.write_u32(d->m_increment_z[i]);
+    }
+}
+
+bool
+fastuidraw::detail::
+read_painter_attribute_data(BlobReader &src, PainterAttributeData &data)
+{
+  PainterAttributeDataPrivate *d;
+  unsigned int num_adjusts, num_z;
+
+  d = static_cast<PainterAttributeDataPrivate*>(data.m_d);
+  d->m_attribute_data.clear();
+  d->m_index_data.clear();
+  d->m_attribute_store = read_chunks(src, d->m_attribute_chunks);
+  d->m_index_store = read_chunks(src, d->m_index_chunks);
+
+  num_adjusts = src.read_u32();
+  d->m_index_adjust_chunks.clear();
+  for(unsigned int i = 0; i < num_adjusts && !src.failed(); ++i)
+    {
+      d->m_index_adjust_chunks.push_back(src.read_i32());
+    }
+
+  num_z = src.read_u32();
+  d->m_increment_z.clear();
+  for(unsigned int i = 0; i < num_z && !src.failed(); ++i)
+    {
+      d->m_increment_z.push_back(src.read_u32());
+    }
+
+  if(src.failed() || d->m_index_adjust_chunks.size() != d->m_index_chunks.size())
+    {
+      src.fail();
+      d->m_attribute_store = const_c_array<PainterAttribute>();
+      d->m_index_store = const_c_array<PainterIndex>();
+      d->m_attribute_chunks.clear();
+      d->m_index_chunks.clear();
+      d->m_index_adjust_chunks.clear();
+      d->m_increment_z.clear();
+    }
+  d->ready_non_empty_index_data_chunks();
+  return !src.failed();
+}
+
+void
+fastuidraw::detail::
+set_painter_attribute_data_chunks(PainterAttributeData &data,
+                                  const_c_array<PainterAttribute> attribute_store,
+                                  const_c_array<PainterIndex> index_store,
+                                  const_c_array<const_c_array<PainterAttribute> > attribute_chunks,
+                                  const_c_array<const_c_array<PainterIndex> > index_chunks)
+{
+  PainterAttributeDataPrivate *d;
+
+  /* the chunks point into memory owned by the caller, as when
+     the data is read from a blob; the caller must keep that
+     memory alive and call again whenever it moves.
+   */
+  d = static_cast<PainterAttributeDataPrivate*>(data.m_d);
+  d->m_attribute_data.clear();
+  d->m_index_data.clear();
+  d->m_attribute_store = attribute_store;
+  d->m_index_store = index_store;
+  d->m_attribute_chunks.assign(attribute_chunks.begin(), attribute_chunks.end());
+  d->m_index_chunks.assign(index_chunks.begin(), index_chunks.end());
+  d->m_index_adjust_chunks.clear();
+  d->m_index_adjust_chunks.resize(index_chunks.size(), 0);
+  d->m_increment_z.clear();
+  d->ready_non_empty_index_data_chunks();
+}
+
 //////////////////////////////////////////////
 // fastuidraw::PainterAttributeData methods
 fastuidraw::PainterAttributeData::
@@ -63,6 +291,23 @@ PainterAttributeData(void)
   m_d = FASTUIDRAWnew PainterAttributeDataPrivate();
 }
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+fastuidraw::PainterAttributeData::
+PainterAttributeData(PainterAttributeData &&obj) noexcept:
+  m_d(obj.m_d)
+{
+  obj.m_d = FASTUIDRAWnew PainterAttributeDataPrivate();
+}
+
+fastuidraw::PainterAttributeData&
+fastuidraw::PainterAttributeData::
+operator=(PainterAttributeData &&obj) noexcept
+{
+  swap(obj);
+  return *this;
+}
+#endif
+
 fastuidraw::PainterAttributeData::
 ~PainterAttributeData()
 {
@@ -72,10 +317,29 @@ fastuidraw::PainterAttributeData::
   m_d = NULL;
 }
 
+void
+fastuidraw::PainterAttributeData::
+swap(PainterAttributeData &obj)
+{
+  std::swap(m_d, obj.m_d);
+}
+
 void
 fastuidraw::PainterAttributeData::
 set_data(const PainterAttributeDataFiller &filler)
 {
+  set_data(filler, 1);
+}
+
+void
+fastuidraw::PainterAttributeData::
+set_data(const PainterAttributeDataFiller &filler,
+         unsigned int max_threads)
+{
+  /* the number of jobs below which a thread is not
+     worth the cost of starting it
+   */
+  const unsigned int min_jobs_per_thread(16);
   PainterAttributeDataPrivate *d;
   d = static_cast<PainterAttributeDataPrivate*>(m_d);
 
@@ -100,6 +364,13 @@ set_data(const PainterAttributeDataFiller &filler)
   d->m_increment_z.clear();
   d->m_increment_z.resize(number_z_increments, 0u);
 
+  if(filler.number_fill_jobs() > 0)
+    {
+      FillJob job(filler, d);
+      run_in_parallel(filler.number_fill_jobs(), max_threads,
+                      min_jobs_per_thread, job);
+    }
+
   filler.fill_data(make_c_array(d->m_attribute_data),
                    make_c_array(d->m_index_data),
                    make_c_array(d->m_attribute_chunks),
@@ -107,7 +378,10 @@ set_data(const PainterAttributeDataFiller &filler)
                    make_c_array(d->m_increment_z),
                    make_c_array(d->m_index_adjust_chunks));
 
+  d->m_attribute_store = make_c_array(d->m_attribute_data);
+  d->m_index_store = make_c_array(d->m_index_data);
   d->ready_non_empty_index_data_chunks();
+  d->update_memory_report();
 }
 
 fastuidraw::const_c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> >
@@ -198,3 +472,12 @@ non_empty_index_data_chunks(void) const
   d = static_cast<PainterAttributeDataPrivate*>(m_d);
   return make_c_array(d->m_non_empty_index_data_chunks);
 }
+
+unsigned int
+fastuidraw::PainterAttributeData::
+number_bytes(void) const
+{
+  PainterAttributeDataPrivate *d;
+  d = static_cast<PainterAttributeDataPrivate*>(m_d);
+  return d->m_reported_bytes;
+}
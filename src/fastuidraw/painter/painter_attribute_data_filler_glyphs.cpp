@@ -21,97 +21,10 @@
 #include <fastuidraw/util/fastuidraw_memory.hpp>
 #include <fastuidraw/painter/painter_attribute_data_filler_glyphs.hpp>
 #include "../private/util_private.hpp"
+#include "private/glyph_attribute_packing.hpp"
 
 namespace
 {
-  inline
-  uint32_t
-  filter_atlas_layer(int layer)
-  {
-    assert(layer >= -1);
-    return (layer != -1) ? static_cast<uint32_t>(layer) : ~0u;
-  }
-
-  inline
-  void
-  pack_glyph_indices(fastuidraw::c_array<fastuidraw::PainterIndex> dst, unsigned int aa)
-  {
-    assert(dst.size() == 6);
-    dst[0] = aa;
-    dst[1] = aa + 1;
-    dst[2] = aa + 2;
-    dst[3] = aa;
-    dst[4] = aa + 2;
-    dst[5] = aa + 3;
-  }
-
-  inline
-  void
-  pack_glyph_attributes(enum fastuidraw::PainterEnums::glyph_orientation orientation,
-                        fastuidraw::vec2 p, fastuidraw::Glyph glyph, float SCALE,
-                        fastuidraw::c_array<fastuidraw::PainterAttribute> dst)
-  {
-    assert(glyph.valid());
-
-    fastuidraw::GlyphLocation atlas(glyph.atlas_location());
-    fastuidraw::GlyphLocation secondary_atlas(glyph.secondary_atlas_location());
-    fastuidraw::uvec4 uint_values;
-    fastuidraw::vec2 tex_size(atlas.size());
-    fastuidraw::vec2 tex_xy(atlas.location());
-    fastuidraw::vec2 secondary_tex_xy(secondary_atlas.location());
-    fastuidraw::vec2 t_bl(tex_xy), t_tr(t_bl + tex_size);
-    fastuidraw::vec2 t2_bl(secondary_tex_xy), t2_tr(t2_bl + tex_size);
-    fastuidraw::vec2 glyph_size(SCALE * glyph.layout().m_size);
-    fastuidraw::vec2 p_bl, p_tr;
-
-    /* ISSUE: we are assuming horizontal layout; we should probably
-       change the inteface so that caller chooses how to adjust
-       positions with the choices:
-         adjust_using_horizontal,
-         adjust_using_vertical,
-         no_adjust
-     */
-    if(orientation == fastuidraw::PainterEnums::y_increases_downwards)
-      {
-        p_bl.x() = p.x() + SCALE * glyph.layout().m_horizontal_layout_offset.x();
-        p_tr.x() = p_bl.x() + glyph_size.x();
-
-        p_bl.y() = p.y() - SCALE * glyph.layout().m_horizontal_layout_offset.y();
-        p_tr.y() = p_bl.y() - glyph_size.y();
-      }
-    else
-      {
-        p_bl = p + SCALE * glyph.layout().m_horizontal_layout_offset;
-        p_tr = p_bl + glyph_size;
-      }
-
-    /* secondary_atlas.layer() can be -1 to indicate that
-       the glyph does not have secondary atlas, when changed
-       to an unsigned value it is ungood, to compensate we
-       will "do something".
-     */
-    uint_values.x() = 0u;
-    uint_values.y() = glyph.geometry_offset();
-    uint_values.z() = filter_atlas_layer(atlas.layer());
-    uint_values.w() = filter_atlas_layer(secondary_atlas.layer());
-
-    dst[0].m_attrib0 = fastuidraw::pack_vec4(t_bl.x(), t_bl.y(), t2_bl.x(), t2_bl.y());
-    dst[0].m_attrib1 = fastuidraw::pack_vec4(p_bl.x(), p_bl.y(), 0.0f, 0.0f);
-    dst[0].m_attrib2 = uint_values;
-
-    dst[1].m_attrib0 = fastuidraw::pack_vec4(t_tr.x(), t_bl.y(), t2_tr.x(), t2_bl.y());
-    dst[1].m_attrib1 = fastuidraw::pack_vec4(p_tr.x(), p_bl.y(), 0.0f, 0.0f);
-    dst[1].m_attrib2 = uint_values;
-
-    dst[2].m_attrib0 = fastuidraw::pack_vec4(t_tr.x(), t_tr.y(), t2_tr.x(), t2_tr.y());
-    dst[2].m_attrib1 = fastuidraw::pack_vec4(p_tr.x(), p_tr.y(), 0.0f, 0.0f);
-    dst[2].m_attrib2 = uint_values;
-
-    dst[3].m_attrib0 = fastuidraw::pack_vec4(t_bl.x(), t_tr.y(), t2_bl.x(), t2_tr.y());
-    dst[3].m_attrib1 = fastuidraw::pack_vec4(p_bl.x(), p_tr.y(), 0.0f, 0.0f);
-    dst[3].m_attrib2 = uint_values;
-  }
-
   class FillGlyphsPrivate
   {
   public:
@@ -132,13 +45,26 @@ namespace
     void
     compute_number_glyphs(void);
 
+    unsigned int
+    chunk(unsigned int glyph, enum fastuidraw::glyph_type tp) const
+    {
+      return fastuidraw::PainterAttributeDataFillerGlyphs::chunk_index(tp,
+                                                                        (m_glyphs_per_chunk != 0) ?
+                                                                        glyph / m_glyphs_per_chunk :
+                                                                        0u);
+    }
+
     fastuidraw::const_c_array<fastuidraw::vec2> m_glyph_positions;
     fastuidraw::const_c_array<fastuidraw::Glyph> m_glyphs;
     fastuidraw::const_c_array<float> m_scale_factors;
     enum fastuidraw::PainterEnums::glyph_orientation m_orientation;
     std::pair<bool, float> m_render_pixel_size;
     unsigned int m_number_glyphs;
-    std::vector<unsigned int> m_cnt_by_type;
+    bool m_instanced;
+    unsigned int m_glyphs_per_chunk;
+
+    /* number of glyphs of each chunk, see chunk() */
+    std::vector<unsigned int> m_cnt_by_chunk;
   };
 }
 
@@ -154,7 +80,9 @@ FillGlyphsPrivate(fastuidraw::const_c_array<fastuidraw::vec2> glyph_positions,
   m_scale_factors(scale_factors),
   m_orientation(orientation),
   m_render_pixel_size(false, 1.0f),
-  m_number_glyphs(0)
+  m_number_glyphs(0),
+  m_instanced(false),
+  m_glyphs_per_chunk(0)
 {
   assert(glyph_positions.size() == glyphs.size());
   assert(scale_factors.empty() || scale_factors.size() == glyphs.size());
@@ -169,7 +97,9 @@ FillGlyphsPrivate(fastuidraw::const_c_array<fastuidraw::vec2> glyph_positions,
   m_glyphs(glyphs),
   m_orientation(orientation),
   m_render_pixel_size(true, render_pixel_size),
-  m_number_glyphs(0)
+  m_number_glyphs(0),
+  m_instanced(false),
+  m_glyphs_per_chunk(0)
 {
   assert(glyph_positions.size() == glyphs.size());
 }
@@ -182,7 +112,9 @@ FillGlyphsPrivate(fastuidraw::const_c_array<fastuidraw::vec2> glyph_positions,
   m_glyphs(glyphs),
   m_orientation(orientation),
   m_render_pixel_size(false, 1.0f),
-  m_number_glyphs(0)
+  m_number_glyphs(0),
+  m_instanced(false),
+  m_glyphs_per_chunk(0)
 {
   assert(glyph_positions.size() == glyphs.size());
 }
@@ -191,6 +123,8 @@ void
 FillGlyphsPrivate::
 compute_number_glyphs(void)
 {
+  m_number_glyphs = 0;
+  m_cnt_by_chunk.clear();
   for(unsigned int i = 0, endi = m_glyphs.size(); i < endi; ++i)
     {
       enum fastuidraw::return_code R;
@@ -204,11 +138,13 @@ compute_number_glyphs(void)
             }
           ++m_number_glyphs;
 
-          if(m_cnt_by_type.size() <= m_glyphs[i].type())
+          unsigned int k;
+          k = chunk(i, m_glyphs[i].type());
+          if(m_cnt_by_chunk.size() <= k)
             {
-              m_cnt_by_type.resize(1 + m_glyphs[i].type(), 0);
+              m_cnt_by_chunk.resize(1 + k, 0);
             }
-          ++m_cnt_by_type[m_glyphs[i].type()];
+          ++m_cnt_by_chunk[k];
         }
     }
 }
@@ -251,6 +187,53 @@ fastuidraw::PainterAttributeDataFillerGlyphs::
   m_d = NULL;
 }
 
+unsigned int
+fastuidraw::PainterAttributeDataFillerGlyphs::
+number_glyphs(void) const
+{
+  FillGlyphsPrivate *d;
+  d = static_cast<FillGlyphsPrivate*>(m_d);
+  return d->m_number_glyphs;
+}
+
+bool
+fastuidraw::PainterAttributeDataFillerGlyphs::
+instanced(void) const
+{
+  FillGlyphsPrivate *d;
+  d = static_cast<FillGlyphsPrivate*>(m_d);
+  return d->m_instanced;
+}
+
+fastuidraw::PainterAttributeDataFillerGlyphs&
+fastuidraw::PainterAttributeDataFillerGlyphs::
+instanced(bool v)
+{
+  FillGlyphsPrivate *d;
+  d = static_cast<FillGlyphsPrivate*>(m_d);
+  d->m_instanced = v;
+  return *this;
+}
+
+unsigned int
+fastuidraw::PainterAttributeDataFillerGlyphs::
+glyphs_per_chunk(void) const
+{
+  FillGlyphsPrivate *d;
+  d = static_cast<FillGlyphsPrivate*>(m_d);
+  return d->m_glyphs_per_chunk;
+}
+
+fastuidraw::PainterAttributeDataFillerGlyphs&
+fastuidraw::PainterAttributeDataFillerGlyphs::
+glyphs_per_chunk(unsigned int v)
+{
+  FillGlyphsPrivate *d;
+  d = static_cast<FillGlyphsPrivate*>(m_d);
+  d->m_glyphs_per_chunk = v;
+  return *this;
+}
+
 void
 fastuidraw::PainterAttributeDataFillerGlyphs::
 compute_sizes(unsigned int &number_attributes,
@@ -263,10 +246,10 @@ compute_sizes(unsigned int &number_attributes,
   d = static_cast<FillGlyphsPrivate*>(m_d);
 
   d->compute_number_glyphs();
-  number_attributes = 4 * d->m_number_glyphs;
-  number_indices = 6 * d->m_number_glyphs;
-  number_attribute_chunks = d->m_cnt_by_type.size();
-  number_index_chunks = d->m_cnt_by_type.size();
+  number_attributes = (d->m_instanced) ? d->m_number_glyphs : 4 * d->m_number_glyphs;
+  number_indices = (d->m_instanced) ? 0 : 6 * d->m_number_glyphs;
+  number_attribute_chunks = d->m_cnt_by_chunk.size();
+  number_index_chunks = d->m_cnt_by_chunk.size();
   number_z_increments = 0;
 }
 
@@ -281,12 +264,20 @@ fill_data(c_array<PainterAttribute> attribute_data,
 {
   FillGlyphsPrivate *d;
   d = static_cast<FillGlyphsPrivate*>(m_d);
-  for(unsigned int i = 0, c = 0, endi = d->m_cnt_by_type.size(); i < endi; ++i)
+  for(unsigned int i = 0, c = 0, endi = d->m_cnt_by_chunk.size(); i < endi; ++i)
     {
-      attrib_chunks[i] = attribute_data.sub_array(4 * c, 4 * d->m_cnt_by_type[i]);
-      index_chunks[i] = index_data.sub_array(6 * c, 6 * d->m_cnt_by_type[i]);
+      if(d->m_instanced)
+        {
+          attrib_chunks[i] = attribute_data.sub_array(c, d->m_cnt_by_chunk[i]);
+          index_chunks[i] = const_c_array<PainterIndex>();
+        }
+      else
+        {
+          attrib_chunks[i] = attribute_data.sub_array(4 * c, 4 * d->m_cnt_by_chunk[i]);
+          index_chunks[i] = index_data.sub_array(6 * c, 6 * d->m_cnt_by_chunk[i]);
+        }
       index_adjusts[i] = 0;
-      c += d->m_cnt_by_type[i];
+      c += d->m_cnt_by_chunk[i];
     }
 
   assert(zincrements.empty());
@@ -304,11 +295,21 @@ fill_data(c_array<PainterAttribute> attribute_data,
             d->m_render_pixel_size.second / d->m_glyphs[g].layout().m_pixel_size :
             (d->m_scale_factors.empty()) ? 1.0f : d->m_scale_factors[g];
 
-          t = d->m_glyphs[g].type();
-          pack_glyph_attributes(d->m_orientation, d->m_glyph_positions[g],
-                                d->m_glyphs[g], scale,
-                                const_cast_c_array(attrib_chunks[t].sub_array(4 * current[t], 4)));
-          pack_glyph_indices(const_cast_c_array(index_chunks[t].sub_array(6 * current[t], 6)), 4 * current[t]);
+          t = d->chunk(g, d->m_glyphs[g].type());
+          if(d->m_instanced)
+            {
+              detail::pack_glyph_instance(d->m_orientation, d->m_glyph_positions[g],
+                                          d->m_glyphs[g], scale,
+                                          const_cast_c_array(attrib_chunks[t])[current[t]]);
+            }
+          else
+            {
+              detail::pack_glyph_attributes(d->m_orientation, d->m_glyph_positions[g],
+                                            d->m_glyphs[g], scale,
+                                            const_cast_c_array(attrib_chunks[t].sub_array(4 * current[t], 4)));
+              detail::pack_glyph_indices(const_cast_c_array(index_chunks[t].sub_array(6 * current[t], 6)),
+                                         4 * current[t]);
+            }
           ++current[t];
         }
     }
@@ -19,6 +19,18 @@
 #include <algorithm>
 #include <fastuidraw/painter/painter_brush.hpp>
 
+namespace
+{
+  uint32_t
+  pack_inline_color(fastuidraw::u8vec4 c)
+  {
+    return fastuidraw::pack_bits(0, 8, c.x())
+      | fastuidraw::pack_bits(8, 8, c.y())
+      | fastuidraw::pack_bits(16, 8, c.z())
+      | fastuidraw::pack_bits(24, 8, c.w());
+  }
+}
+
 ////////////////////////////////////
 // fastuidraw::PainterBrush methods
 unsigned int
@@ -35,6 +47,18 @@ data_size(unsigned int alignment) const
       return_value += round_up_to_multiple(image_data_size, alignment);
     }
 
+  if(pshader & image_mipmap_mask)
+    {
+      assert(pshader & image_mask);
+      return_value += round_up_to_multiple(image_mipmap_data_size, alignment);
+    }
+
+  if(pshader & image_bindless_mask)
+    {
+      assert(pshader & image_mask);
+      return_value += round_up_to_multiple(image_bindless_data_size, alignment);
+    }
+
   if(pshader & radial_gradient_mask)
     {
       assert(pshader & gradient_mask);
@@ -45,6 +69,12 @@ data_size(unsigned int alignment) const
       return_value += round_up_to_multiple(linear_gradient_data_size, alignment);
     }
 
+  if(pshader & gradient_inline_color_stops_mask)
+    {
+      assert(pshader & gradient_mask);
+      return_value += round_up_to_multiple(gradient_inline_color_stops_data_size, alignment);
+    }
+
   if(pshader & repeat_window_mask)
     {
       return_value += round_up_to_multiple(repeat_window_data_size, alignment);
@@ -112,6 +142,39 @@ pack_data(unsigned int alignment, c_array<generic_data> dst) const
         | pack_bits(image_slack_bit0, image_slack_num_bits, slack);
     }
 
+  if(pshader & image_mipmap_mask)
+    {
+      sz = round_up_to_multiple(image_mipmap_data_size, alignment);
+      sub_dest = dst.sub_array(current, sz);
+      current += sz;
+
+      assert(m_data.m_image);
+      uvec2 dims(m_data.m_image->dimensions());
+
+      sub_dest[image_mipmap_dimensions_xy_offset].u =
+        pack_bits(image_size_x_bit0, image_size_x_num_bits, dims.x())
+        | pack_bits(image_size_y_bit0, image_size_y_num_bits, dims.y());
+      sub_dest[image_mipmap_number_levels_offset].u = m_data.m_image->number_mipmap_levels();
+    }
+
+  if(pshader & image_bindless_mask)
+    {
+      sz = round_up_to_multiple(image_bindless_data_size, alignment);
+      sub_dest = dst.sub_array(current, sz);
+      current += sz;
+
+      assert(m_data.m_image);
+      uint64_t handle(m_data.m_image->bindless_handle());
+
+      sub_dest[image_bindless_handle_low_offset].u = static_cast<uint32_t>(handle & 0xFFFFFFFFu);
+      sub_dest[image_bindless_handle_high_offset].u = static_cast<uint32_t>(handle >> 32u);
+
+      uvec2 dims(m_data.m_image->dimensions());
+      sub_dest[image_bindless_texture_size_xy_offset].u =
+        pack_bits(image_size_x_bit0, image_size_x_num_bits, dims.x())
+        | pack_bits(image_size_y_bit0, image_size_y_num_bits, dims.y());
+    }
+
   if(pshader & gradient_mask)
     {
       if(pshader & radial_gradient_mask)
@@ -126,19 +189,30 @@ pack_data(unsigned int alignment, c_array<generic_data> dst) const
       sub_dest = dst.sub_array(current, sz);
       current += sz;
 
-      assert(m_data.m_cs);
-      assert(m_data.m_cs->texel_location().x() >= 0);
-      assert(m_data.m_cs->texel_location().y() >= 0);
+      if(pshader & gradient_inline_color_stops_mask)
+        {
+          /* color stops are packed after the gradient,
+             no location in the ColorStopAtlas to give.
+           */
+          sub_dest[gradient_color_stop_xy_offset].u = 0u;
+          sub_dest[gradient_color_stop_length_offset].u = 0u;
+        }
+      else
+        {
+          assert(m_data.m_cs);
+          assert(m_data.m_cs->texel_location().x() >= 0);
+          assert(m_data.m_cs->texel_location().y() >= 0);
 
-      uint32_t x, y;
-      x = static_cast<uint32_t>(m_data.m_cs->texel_location().x());
-      y = static_cast<uint32_t>(m_data.m_cs->texel_location().y());
+          uint32_t x, y;
+          x = static_cast<uint32_t>(m_data.m_cs->texel_location().x());
+          y = static_cast<uint32_t>(m_data.m_cs->texel_location().y());
 
-      sub_dest[gradient_color_stop_xy_offset].u =
-        pack_bits(gradient_color_stop_x_bit0, gradient_color_stop_x_num_bits, x)
-        | pack_bits(gradient_color_stop_y_bit0, gradient_color_stop_y_num_bits, y);
+          sub_dest[gradient_color_stop_xy_offset].u =
+            pack_bits(gradient_color_stop_x_bit0, gradient_color_stop_x_num_bits, x)
+            | pack_bits(gradient_color_stop_y_bit0, gradient_color_stop_y_num_bits, y);
 
-      sub_dest[gradient_color_stop_length_offset].u = m_data.m_cs->width();
+          sub_dest[gradient_color_stop_length_offset].u = m_data.m_cs->width();
+        }
 
       sub_dest[gradient_p0_x_offset].f = m_data.m_grad_start.x();
       sub_dest[gradient_p0_y_offset].f = m_data.m_grad_start.y();
@@ -152,6 +226,26 @@ pack_data(unsigned int alignment, c_array<generic_data> dst) const
         }
     }
 
+  if(pshader & gradient_inline_color_stops_mask)
+    {
+      sz = round_up_to_multiple(gradient_inline_color_stops_data_size, alignment);
+      sub_dest = dst.sub_array(current, sz);
+      current += sz;
+
+      assert(m_data.m_number_inline_stops > 0);
+      assert(m_data.m_number_inline_stops <= max_inline_color_stops);
+      sub_dest[gradient_inline_color_stops_count_offset].u = m_data.m_number_inline_stops;
+      for(unsigned int i = 0; i < max_inline_color_stops; ++i)
+        {
+          /* unused slots repeat the last color stop */
+          unsigned int s;
+
+          s = std::min(i, m_data.m_number_inline_stops - 1);
+          sub_dest[gradient_inline_color_stops_place_offset + i].f = m_data.m_inline_stops[s].m_place;
+          sub_dest[gradient_inline_color_stops_color_offset + i].u = pack_inline_color(m_data.m_inline_stops[s].m_color);
+        }
+    }
+
   if(pshader & repeat_window_mask)
     {
       sz = round_up_to_multiple(repeat_window_data_size, alignment);
@@ -205,6 +299,83 @@ sub_image(const reference_counted_ptr<const Image> &im,
   m_data.m_shader_raw &= ~(filter_bits << image_filter_bit0);
   m_data.m_shader_raw |= (filter_bits << image_filter_bit0);
 
+  m_data.m_shader_raw &= ~(image_mipmap_mask | image_bindless_mask
+                           | image_external_texture_mask | image_premultiplied_alpha_mask);
+  if(im && im->number_mipmap_levels() > 1)
+    {
+      m_data.m_shader_raw |= image_mipmap_mask;
+    }
+
+  if(im && im->bindless_handle() != 0)
+    {
+      m_data.m_shader_raw |= image_bindless_mask;
+      if(im->bindless_external_texture())
+        {
+          m_data.m_shader_raw |= image_external_texture_mask;
+        }
+    }
+
+  if(im && im->premultiplied_alpha())
+    {
+      m_data.m_shader_raw |= image_premultiplied_alpha_mask;
+    }
+
+  return *this;
+}
+
+void
+fastuidraw::PainterBrush::
+set_inline_color_stops(const ColorStopSequence &cs)
+{
+  const_c_array<ColorStop> stops(cs.values());
+
+  m_data.m_cs = reference_counted_ptr<const ColorStopSequenceOnAtlas>();
+  m_data.m_number_inline_stops = std::min(static_cast<unsigned int>(stops.size()),
+                                          static_cast<unsigned int>(max_inline_color_stops));
+  for(unsigned int i = 0; i < m_data.m_number_inline_stops; ++i)
+    {
+      m_data.m_inline_stops[i] = stops[i];
+    }
+}
+
+fastuidraw::PainterBrush&
+fastuidraw::PainterBrush::
+linear_gradient(const ColorStopSequence &cs,
+                const vec2 &start_p, const vec2 &end_p, bool repeat)
+{
+  bool has_stops;
+
+  set_inline_color_stops(cs);
+  has_stops = (m_data.m_number_inline_stops > 0);
+
+  m_data.m_grad_start = start_p;
+  m_data.m_grad_end = end_p;
+  m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, has_stops, gradient_mask);
+  m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, has_stops && repeat, gradient_repeat_mask);
+  m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, has_stops, gradient_inline_color_stops_mask);
+  m_data.m_shader_raw &= ~radial_gradient_mask;
+  return *this;
+}
+
+fastuidraw::PainterBrush&
+fastuidraw::PainterBrush::
+radial_gradient(const ColorStopSequence &cs,
+                const vec2 &start_p, float start_r,
+                const vec2 &end_p, float end_r, bool repeat)
+{
+  bool has_stops;
+
+  set_inline_color_stops(cs);
+  has_stops = (m_data.m_number_inline_stops > 0);
+
+  m_data.m_grad_start = start_p;
+  m_data.m_grad_start_r = start_r;
+  m_data.m_grad_end = end_p;
+  m_data.m_grad_end_r = end_r;
+  m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, has_stops, gradient_mask);
+  m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, has_stops && repeat, gradient_repeat_mask);
+  m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, has_stops, radial_gradient_mask);
+  m_data.m_shader_raw = apply_bit_flag(m_data.m_shader_raw, has_stops, gradient_inline_color_stops_mask);
   return *this;
 }
 
@@ -230,7 +401,7 @@ shader(void) const
   /* lacking an image or gradient means the brush does
      nothing and so all bits should be down.
    */
-  if(!m_data.m_image && !m_data.m_cs)
+  if(!m_data.m_image && !m_data.m_cs && m_data.m_number_inline_stops == 0)
     {
       return_value = 0;
     }
@@ -245,6 +416,7 @@ reset(void)
   m_data.m_shader_raw = 0u;
   m_data.m_image = NULL;
   m_data.m_cs = NULL;
+  m_data.m_number_inline_stops = 0;
 }
 
 fastuidraw::PainterBrush&
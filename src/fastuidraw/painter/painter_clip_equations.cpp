@@ -22,8 +22,10 @@
 // fastuidraw::PainterClipEquations methods
 void
 fastuidraw::PainterClipEquations::
-pack_data(unsigned int, c_array<generic_data> dst) const
+pack_data(unsigned int alignment, c_array<generic_data> dst) const
 {
+  c_array<generic_data> rounded_rect;
+
   dst[clip0_coeff_x].f = m_clip_equations[0].x();
   dst[clip0_coeff_y].f = m_clip_equations[0].y();
   dst[clip0_coeff_w].f = m_clip_equations[0].z();
@@ -39,4 +41,21 @@ pack_data(unsigned int, c_array<generic_data> dst) const
   dst[clip3_coeff_x].f = m_clip_equations[3].x();
   dst[clip3_coeff_y].f = m_clip_equations[3].y();
   dst[clip3_coeff_w].f = m_clip_equations[3].z();
+
+  rounded_rect = dst.sub_array(round_up_to_multiple(clip_data_size, alignment));
+  rounded_rect[rounded_rect_x_coeff_x].f = m_rounded_rect_transformation[0].x();
+  rounded_rect[rounded_rect_x_coeff_y].f = m_rounded_rect_transformation[0].y();
+  rounded_rect[rounded_rect_x_coeff_w].f = m_rounded_rect_transformation[0].z();
+
+  rounded_rect[rounded_rect_y_coeff_x].f = m_rounded_rect_transformation[1].x();
+  rounded_rect[rounded_rect_y_coeff_y].f = m_rounded_rect_transformation[1].y();
+  rounded_rect[rounded_rect_y_coeff_w].f = m_rounded_rect_transformation[1].z();
+
+  rounded_rect[rounded_rect_q_coeff_x].f = m_rounded_rect_transformation[2].x();
+  rounded_rect[rounded_rect_q_coeff_y].f = m_rounded_rect_transformation[2].y();
+  rounded_rect[rounded_rect_q_coeff_w].f = m_rounded_rect_transformation[2].z();
+
+  rounded_rect[rounded_rect_half_width_offset].f = m_rounded_rect_half_size.x();
+  rounded_rect[rounded_rect_half_height_offset].f = m_rounded_rect_half_size.y();
+  rounded_rect[rounded_rect_radius_offset].f = m_rounded_rect_radius;
 }
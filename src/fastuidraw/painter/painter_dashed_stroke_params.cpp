@@ -24,6 +24,69 @@
 
 namespace
 {
+  /* The ends of the intervals of a dash pattern are packed
+     into the data store as a static search tree so that a
+     shader finds the interval of a distance with one fetch
+     per level instead of a linear search. For an alignment
+     of N, a node of the tree is one block of N values and
+     has N + 1 children:
+       - the leaves are the ends of the intervals in order,
+         N per block, with the last leaf padded by values
+         larger than the total length of the pattern
+       - the internal nodes come before the leaves, level by
+         level starting from the root; level k has (N + 1)^k
+         nodes in order and the i'th value of a node is the
+         largest value under its i'th child.
+     A search reads a node, counts how many of its values
+     the distance is not less than and descends into that
+     child. Values for the subtree that holds the last leaf
+     are replaced by the padding value so that a search
+     never descends past the last leaf.
+   */
+  class IntervalTree
+  {
+  public:
+    IntervalTree(unsigned int number_intervals, unsigned int alignment):
+      m_alignment(alignment),
+      m_num_leaves((number_intervals + alignment - 1) / alignment),
+      m_num_levels(0),
+      m_width(1)
+    {
+      while(m_width < m_num_leaves)
+        {
+          m_width *= (m_alignment + 1);
+          ++m_num_levels;
+        }
+      m_num_internal_nodes = (m_width - 1) / m_alignment;
+    }
+
+    unsigned int
+    data_size(void) const
+    {
+      return m_alignment * (m_num_internal_nodes + m_num_leaves);
+    }
+
+    void
+    pack(fastuidraw::const_c_array<fastuidraw::generic_data> interval_ends,
+         float pad_value,
+         fastuidraw::c_array<fastuidraw::generic_data> dst) const;
+
+  private:
+    float
+    last_value_of_leaf(fastuidraw::const_c_array<fastuidraw::generic_data> interval_ends,
+                       unsigned int leaf, float pad_value) const
+    {
+      return (leaf + 1 >= m_num_leaves) ?
+        pad_value :
+        interval_ends[m_alignment * leaf + m_alignment - 1].f;
+    }
+
+    unsigned int m_alignment;
+    unsigned int m_num_leaves;
+    unsigned int m_num_levels;
+    unsigned int m_width;
+    unsigned int m_num_internal_nodes;
+  };
 
   class PainterDashedStrokeParamsData:public fastuidraw::PainterShaderData::DataBase
   {
@@ -42,6 +105,12 @@ namespace
     void
     pack_data(unsigned int alignment, fastuidraw::c_array<fastuidraw::generic_data> dst) const;
 
+    /* recompute m_draw_intervals, called whenever
+       m_dash_pattern or m_dash_offset changes.
+     */
+    void
+    ready_draw_intervals(void);
+
     float m_miter_limit;
     float m_radius;
     float m_dash_offset;
@@ -49,6 +118,12 @@ namespace
     float m_first_interval_start;
     std::vector<fastuidraw::PainterDashedStrokeParams::DashPatternElement> m_dash_pattern;
     std::vector<fastuidraw::generic_data> m_dash_pattern_packed;
+
+    /* intervals drawn by the dash pattern in units of the
+       distance from the contour start, see
+       DashEvaluatorBase::draw_intervals().
+     */
+    std::vector<fastuidraw::range_type<float> > m_draw_intervals;
   };
 
   class DashEvaluator:public fastuidraw::DashEvaluatorBase
@@ -64,6 +139,10 @@ namespace
     covered_by_dash_pattern(const fastuidraw::PainterShaderData::DataBase *data,
                             const fastuidraw::PainterAttribute &attrib) const;
 
+    virtual
+    fastuidraw::const_c_array<fastuidraw::range_type<float> >
+    draw_intervals(const fastuidraw::PainterShaderData::DataBase *data,
+                   float *out_period) const;
 
     virtual
     unsigned int
@@ -108,6 +187,44 @@ namespace
   };
 }
 
+////////////////////////////////
+// IntervalTree methods
+void
+IntervalTree::
+pack(fastuidraw::const_c_array<fastuidraw::generic_data> interval_ends,
+     float pad_value,
+     fastuidraw::c_array<fastuidraw::generic_data> dst) const
+{
+  unsigned int level_start(0), level_width(1), leaves_per_child(m_width);
+
+  for(unsigned int level = 0; level < m_num_levels; ++level)
+    {
+      leaves_per_child /= (m_alignment + 1);
+      for(unsigned int node = 0; node < level_width; ++node)
+        {
+          for(unsigned int i = 0; i < m_alignment; ++i)
+            {
+              unsigned int child, last_leaf;
+
+              child = node * (m_alignment + 1) + i;
+              last_leaf = (child + 1) * leaves_per_child - 1;
+              dst[m_alignment * (level_start + node) + i].f =
+                last_value_of_leaf(interval_ends, last_leaf, pad_value);
+            }
+        }
+      level_start += level_width;
+      level_width *= (m_alignment + 1);
+    }
+
+  assert(level_start == m_num_internal_nodes);
+  for(unsigned int i = 0, endi = m_alignment * m_num_leaves; i < endi; ++i)
+    {
+      dst[m_alignment * m_num_internal_nodes + i].f = (i < interval_ends.size()) ?
+        interval_ends[i].f :
+        pad_value;
+    }
+}
+
 ////////////////////////////////
 // StrokingDataSelector methods
 StrokingDataSelector::
@@ -193,7 +310,7 @@ data_size(unsigned int alignment) const
 {
   using namespace fastuidraw;
   return round_up_to_multiple(PainterDashedStrokeParams::stroke_static_data_size, alignment)
-    + round_up_to_multiple(2 * m_dash_pattern.size(), alignment);
+    + IntervalTree(m_dash_pattern_packed.size(), alignment).data_size();
 }
 
 void
@@ -213,18 +330,71 @@ pack_data(unsigned int alignment, fastuidraw::c_array<fastuidraw::generic_data>
     {
       c_array<generic_data> dst_pattern;
       dst_pattern = dst.sub_array(round_up_to_multiple(PainterDashedStrokeParams::stroke_static_data_size, alignment));
-      std::copy(m_dash_pattern_packed.begin(), m_dash_pattern_packed.end(), dst_pattern.begin());
-      for(unsigned int i = m_dash_pattern_packed.size(), endi = dst_pattern.size(); i < endi; ++i)
-        {
-          //make the last entry larger than the total length so a
-          //shader can use that to know when it has reached the end.
-          dst_pattern[i].f = m_total_length * 2.0f + 1.0f;
-        }
+
+      //pad with a value larger than the total length so a
+      //shader never finds an interval past the last one.
+      IntervalTree(m_dash_pattern_packed.size(), alignment).pack(make_c_array(m_dash_pattern_packed),
+                                                                 m_total_length * 2.0f + 1.0f,
+                                                                 dst_pattern);
+    }
+}
+
+void
+PainterDashedStrokeParamsData::
+ready_draw_intervals(void)
+{
+  m_draw_intervals.clear();
+  if(m_total_length <= 0.0f || m_dash_pattern.empty())
+    {
+      return;
+    }
+
+  float start(0.0f), shift;
+  for(unsigned int i = 0, endi = m_dash_pattern.size(); i < endi; ++i)
+    {
+      fastuidraw::range_type<float> R(start, start + m_dash_pattern[i].m_draw_length);
+      m_draw_intervals.push_back(R);
+      start = R.m_end + m_dash_pattern[i].m_space_length;
+    }
+
+  /* the last interval runs into the first interval
+     of the next period, just as m_first_interval_start
+     indicates to the shader.
+   */
+  if(m_draw_intervals.size() > 1 && m_first_interval_start < 0.0f)
+    {
+      m_draw_intervals.back().m_end += m_draw_intervals.front().m_end;
+      m_draw_intervals.erase(m_draw_intervals.begin());
+    }
+
+  /* a distance d from the contour start is at d + m_dash_offset
+     in the dash pattern; shift by a multiple of the period
+     so that the first interval begins in [0, m_total_length).
+   */
+  shift = -m_dash_offset;
+  shift -= m_total_length * std::floor((m_draw_intervals.front().m_begin + shift) / m_total_length);
+  for(unsigned int i = 0, endi = m_draw_intervals.size(); i < endi; ++i)
+    {
+      m_draw_intervals[i].m_begin += shift;
+      m_draw_intervals[i].m_end += shift;
     }
 }
 
 ///////////////////////////////
 // DashEvaluator methods
+fastuidraw::const_c_array<fastuidraw::range_type<float> >
+DashEvaluator::
+draw_intervals(const fastuidraw::PainterShaderData::DataBase *data,
+               float *out_period) const
+{
+  const PainterDashedStrokeParamsData *d;
+  assert(dynamic_cast<const PainterDashedStrokeParamsData*>(data) != NULL);
+  d = static_cast<const PainterDashedStrokeParamsData*>(data);
+
+  *out_period = d->m_total_length;
+  return fastuidraw::make_c_array(d->m_draw_intervals);
+}
+
 bool
 DashEvaluator::
 covered_by_dash_pattern(const fastuidraw::PainterShaderData::DataBase *data,
@@ -372,6 +542,7 @@ dash_offset(float f)
   assert(dynamic_cast<PainterDashedStrokeParamsData*>(m_data) != NULL);
   d = static_cast<PainterDashedStrokeParamsData*>(m_data);
   d->m_dash_offset = f;
+  d->ready_draw_intervals();
   return *this;
 }
 
@@ -403,6 +574,7 @@ dash_pattern(const_c_array<DashPatternElement> f)
   d->m_dash_pattern.resize(f.size());
   if(d->m_dash_pattern.empty())
     {
+      d->ready_draw_intervals();
       return *this;
     }
 
@@ -465,6 +637,7 @@ dash_pattern(const_c_array<DashPatternElement> f)
         }
     }
 
+  d->ready_draw_intervals();
   return *this;
 }
 
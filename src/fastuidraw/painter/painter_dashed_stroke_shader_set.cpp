@@ -111,3 +111,15 @@ dash_evaluator(void) const
   d = static_cast<PainterDashedStrokeShaderSetPrivate*>(m_d);
   return d->m_dash_evaluator;
 }
+
+/////////////////////////////////////
+// fastuidraw::DashEvaluatorBase methods
+fastuidraw::const_c_array<fastuidraw::range_type<float> >
+fastuidraw::DashEvaluatorBase::
+draw_intervals(const PainterShaderData::DataBase *data,
+               float *out_period) const
+{
+  FASTUIDRAWunused(data);
+  *out_period = 0.0f;
+  return const_c_array<range_type<float> >();
+}
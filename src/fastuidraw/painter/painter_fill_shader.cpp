@@ -23,7 +23,15 @@ namespace
   class PainterFillShaderPrivate
   {
   public:
+    PainterFillShaderPrivate(void):
+      m_coverage(fastuidraw::PainterFillShader::triangulated_coverage),
+      m_anti_alias(false)
+    {}
+
     fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> m_item_shader;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> m_aa_item_shader;
+    enum fastuidraw::PainterFillShader::coverage_t m_coverage;
+    bool m_anti_alias;
   };
 }
 
@@ -87,4 +95,7 @@ operator=(const PainterFillShader &rhs)
   }
 
 setget_implement(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader>&, item_shader)
+setget_implement(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader>&, aa_item_shader)
+setget_implement(enum fastuidraw::PainterFillShader::coverage_t, coverage)
+setget_implement(bool, anti_alias)
 #undef setget_implement
@@ -22,18 +22,23 @@ void
 fastuidraw::PainterHeader::
 pack_data(unsigned int alignment, c_array<generic_data> dst) const
 {
-  FASTUIDRAWunused(alignment);
+  c_array<generic_data> cold;
+
   assert(dst.size() == data_size(alignment));
 
-  dst[clip_equations_location_offset].u    = m_clip_equations_location;
-  dst[item_matrix_location_offset].u       = m_item_matrix_location;
-  dst[brush_shader_data_location_offset].u = m_brush_shader_data_location;
-  dst[item_shader_data_location_offset].u  = m_item_shader_data_location;
-  dst[blend_shader_data_location_offset].u = m_blend_shader_data_location;
-  dst[brush_shader_offset].u               = m_brush_shader;
-  dst[z_offset].u                          = m_z;
+  dst[clip_equations_location_offset].u = m_clip_equations_location;
+  dst[item_matrix_location_offset].u    = m_item_matrix_location;
+  dst[z_offset].u                       = m_z;
 
   dst[item_blend_shader_offset].u
     = pack_bits(item_shader_bit0, item_shader_num_bits, m_item_shader)
     | pack_bits(blend_shader_bit0, blend_shader_num_bits, m_blend_shader);
+
+  /* the offsets of the cold part are relative to hot_header_size
+   */
+  cold = dst.sub_array(cold_header_location(alignment));
+  cold[item_shader_data_location_offset - hot_header_size].u  = m_item_shader_data_location;
+  cold[blend_shader_data_location_offset - hot_header_size].u = m_blend_shader_data_location;
+  cold[brush_shader_offset - hot_header_size].u               = m_brush_shader;
+  cold[brush_shader_data_location_offset - hot_header_size].u = m_brush_shader_data_location;
 }
@@ -25,11 +25,16 @@ namespace
   {
   public:
     fastuidraw::PainterGlyphShader m_glyph_shader, m_glyph_shader_anisotropic;
+    fastuidraw::PainterGlyphShader m_glyph_instance_shader, m_glyph_instance_shader_anisotropic;
     fastuidraw::PainterStrokeShader m_stroke_shader;
     fastuidraw::PainterStrokeShader m_pixel_width_stroke_shader;
     fastuidraw::PainterDashedStrokeShaderSet m_dashed_stroke_shader;
     fastuidraw::PainterDashedStrokeShaderSet m_pixel_width_dashed_stroke_shader;
     fastuidraw::PainterFillShader m_fill_shader;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> m_hairline_shader;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> m_hairline_instance_shader;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> m_rounded_rect_shader;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> m_box_shadow_shader;
     fastuidraw::PainterBlendShaderSet m_blend_shaders;
   };
 }
@@ -95,11 +100,17 @@ operator=(const PainterShaderSet &rhs)
 
 setget_implement(fastuidraw::PainterGlyphShader, glyph_shader)
 setget_implement(fastuidraw::PainterGlyphShader, glyph_shader_anisotropic)
+setget_implement(fastuidraw::PainterGlyphShader, glyph_instance_shader)
+setget_implement(fastuidraw::PainterGlyphShader, glyph_instance_shader_anisotropic)
 setget_implement(fastuidraw::PainterStrokeShader, stroke_shader)
 setget_implement(fastuidraw::PainterStrokeShader, pixel_width_stroke_shader)
 setget_implement(fastuidraw::PainterDashedStrokeShaderSet, dashed_stroke_shader)
 setget_implement(fastuidraw::PainterDashedStrokeShaderSet, pixel_width_dashed_stroke_shader)
 setget_implement(fastuidraw::PainterFillShader, fill_shader)
+setget_implement(fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader>, hairline_shader)
+setget_implement(fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader>, hairline_instance_shader)
+setget_implement(fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader>, rounded_rect_shader)
+setget_implement(fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader>, box_shadow_shader)
 setget_implement(fastuidraw::PainterBlendShaderSet, blend_shaders)
 
 #undef setget_implement
@@ -0,0 +1,2194 @@
+/*!
+ * \file painter_trace.cpp
+ * \brief file painter_trace.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#include <map>
+#include <vector>
+#include <cstring>
+#include <fastuidraw/painter/painter_trace.hpp>
+#include <fastuidraw/painter/painter.hpp>
+#include <fastuidraw/colorstop_atlas.hpp>
+#include "../private/util_private.hpp"
+#include "../private/blob_private.hpp"
+
+namespace
+{
+  /* A trace is a header followed by records; a record is
+     its opcode, the number of words of its payload and then
+     the payload. The payload of a definition begins with the
+     id of the definition; the ids of each kind of definition
+     are 0, 1, 2, ... in the order of the definitions.
+   */
+  enum
+    {
+      trace_magic = 0x54445546u, /* "FUDT" */
+      trace_version = 2u,
+      trace_header_size = 3u,
+      no_id = ~0u
+    };
+
+  enum opcode_t
+    {
+      op_define_path,
+      op_define_image,
+      op_define_font,
+      op_define_glyph_run,
+      op_define_brush,
+      op_define_stroke,
+
+      op_begin_frame,
+      op_end_frame,
+      op_save,
+      op_restore,
+      op_transformation,
+      op_blend_mode,
+      op_curve_flatness,
+      op_clip_in_rect,
+      op_clip_path,
+      op_fill_path,
+      op_stroke_path,
+      op_draw_convex_polygon,
+      op_draw_quads,
+      op_draw_glyph_runs,
+      op_begin_layer,
+      op_end_layer,
+      op_begin_recording,
+      op_end_recording,
+      op_draw_stream,
+      op_clip_in_rounded_rect,
+      op_end_layer_blurred,
+      op_end_layer_drop_shadow,
+
+      number_opcodes
+    };
+
+  enum definition_kind_t
+    {
+      path_definition,
+      image_definition,
+      font_definition,
+      glyph_run_definition,
+      brush_definition,
+      stroke_definition,
+
+      number_definition_kinds
+    };
+
+  enum edge_t
+    {
+      flat_edge,
+      bezier_edge,
+      arc_edge
+    };
+
+  enum stroke_flags_t
+    {
+      stroke_dashed = 1u,
+      stroke_pixel_width = 2u,
+      stroke_close_contours = 4u,
+      stroke_anti_alias = 8u
+    };
+
+  enum gradient_t
+    {
+      no_gradient,
+      atlas_gradient,
+      inline_gradient
+    };
+
+  uint32_t
+  pack_color(const fastuidraw::u8vec4 &c)
+  {
+    return static_cast<uint32_t>(c.x())
+      | (static_cast<uint32_t>(c.y()) << 8u)
+      | (static_cast<uint32_t>(c.z()) << 16u)
+      | (static_cast<uint32_t>(c.w()) << 24u);
+  }
+
+  fastuidraw::u8vec4
+  unpack_color(uint32_t v)
+  {
+    return fastuidraw::u8vec4(v & 0xFFu, (v >> 8u) & 0xFFu,
+                              (v >> 16u) & 0xFFu, (v >> 24u) & 0xFFu);
+  }
+
+  void
+  write_string(fastuidraw::detail::BlobWriter &dst, const char *s)
+  {
+    unsigned int len(s ? std::strlen(s) : 0u);
+
+    dst.write_u32(len);
+    dst.write_packed_array(fastuidraw::const_c_array<uint8_t>(reinterpret_cast<const uint8_t*>(s), len));
+  }
+
+  std::string
+  read_string(fastuidraw::detail::BlobReader &src)
+  {
+    unsigned int len(src.read_u32());
+    std::vector<uint8_t> bytes;
+
+    if(len > 4096u)
+      {
+        src.fail();
+        return std::string();
+      }
+    bytes.resize(len);
+    src.read_packed_array(fastuidraw::make_c_array(bytes));
+    return std::string(bytes.begin(), bytes.end());
+  }
+
+  void
+  write_path(fastuidraw::detail::BlobWriter &dst, const fastuidraw::Path &path)
+  {
+    std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::PathContour> > contours;
+
+    for(unsigned int c = 0, endc = path.number_contours(); c < endc; ++c)
+      {
+        fastuidraw::reference_counted_ptr<const fastuidraw::PathContour> C(path.contour(c));
+        if(C->ended() && C->number_points() > 0)
+          {
+            contours.push_back(C);
+          }
+      }
+
+    dst.write_u32(contours.size());
+    for(unsigned int c = 0, endc = contours.size(); c < endc; ++c)
+      {
+        const fastuidraw::PathContour &C(*contours[c]);
+
+        dst.write_u32(C.number_points());
+        for(unsigned int i = 0, endi = C.number_points(); i < endi; ++i)
+          {
+            const fastuidraw::PathContour::interpolator_base *h(C.curve_interpolator(i));
+            const fastuidraw::PathContour::bezier *b;
+            const fastuidraw::PathContour::arc *a;
+
+            b = dynamic_cast<const fastuidraw::PathContour::bezier*>(h);
+            a = dynamic_cast<const fastuidraw::PathContour::arc*>(h);
+            dst.write_vec2(C.point(i));
+            if(b)
+              {
+                fastuidraw::const_c_array<fastuidraw::vec2> pts(b->pts());
+
+                assert(pts.size() >= 2);
+                dst.write_u32(bezier_edge);
+                dst.write_u32(pts.size() - 2);
+                for(unsigned int k = 1; k + 1 < pts.size(); ++k)
+                  {
+                    dst.write_vec2(pts[k]);
+                  }
+              }
+            else if(a)
+              {
+                dst.write_u32(arc_edge);
+                dst.write_float(a->angle());
+              }
+            else
+              {
+                /* lines and the edges of custom interpolators,
+                   which are approximated by a line
+                 */
+                dst.write_u32(flat_edge);
+              }
+          }
+      }
+  }
+
+  void
+  read_path(fastuidraw::detail::BlobReader &src, fastuidraw::Path &path)
+  {
+    unsigned int num_contours;
+    std::vector<fastuidraw::vec2> pts, control_pts;
+    std::vector<uint32_t> edges, num_control_pts;
+    std::vector<float> angles;
+
+    num_contours = src.read_u32();
+    for(unsigned int c = 0; c < num_contours && !src.failed(); ++c)
+      {
+        unsigned int num_points, ctl;
+
+        num_points = src.read_u32();
+        if(num_points == 0)
+          {
+            src.fail();
+            return;
+          }
+
+        pts.clear();
+        edges.clear();
+        angles.clear();
+        control_pts.clear();
+        num_control_pts.clear();
+        for(unsigned int i = 0; i < num_points && !src.failed(); ++i)
+          {
+            uint32_t e;
+
+            pts.push_back(src.read_vec2());
+            e = src.read_u32();
+            edges.push_back(e);
+            angles.push_back(0.0f);
+            num_control_pts.push_back(0);
+            if(e == bezier_edge)
+              {
+                num_control_pts.back() = src.read_u32();
+                for(unsigned int k = 0; k < num_control_pts.back() && !src.failed(); ++k)
+                  {
+                    control_pts.push_back(src.read_vec2());
+                  }
+              }
+            else if(e == arc_edge)
+              {
+                angles.back() = src.read_float();
+              }
+            else if(e != flat_edge)
+              {
+                src.fail();
+              }
+          }
+
+        if(src.failed())
+          {
+            return;
+          }
+
+        /* the edge i goes from pts[i] to pts[i + 1],
+           the last edge closes the contour.
+         */
+        path << pts[0];
+        ctl = 0;
+        for(unsigned int i = 0; i < num_points; ++i)
+          {
+            for(unsigned int k = 0; k < num_control_pts[i]; ++k, ++ctl)
+              {
+                path << fastuidraw::Path::control_point(control_pts[ctl]);
+              }
+
+            if(i + 1 < num_points)
+              {
+                if(edges[i] == arc_edge)
+                  {
+                    path << fastuidraw::Path::arc(angles[i], pts[i + 1]);
+                  }
+                else
+                  {
+                    path << pts[i + 1];
+                  }
+              }
+            else if(edges[i] == arc_edge)
+              {
+                path << fastuidraw::Path::contour_end_arc(angles[i]);
+              }
+            else
+              {
+                path << fastuidraw::Path::contour_end();
+              }
+          }
+      }
+  }
+
+  const fastuidraw::PainterBrush*
+  brush_of(const fastuidraw::PainterData &draw)
+  {
+    return (draw.m_brush.m_packed_value || draw.m_brush.m_value) ?
+      &draw.m_brush.data() :
+      NULL;
+  }
+
+  const fastuidraw::PainterItemShaderData*
+  item_data_of(const fastuidraw::PainterData &draw)
+  {
+    return (draw.m_item_shader_data.m_packed_value || draw.m_item_shader_data.m_value) ?
+      &draw.m_item_shader_data.data() :
+      NULL;
+  }
+
+  class PainterTraceRecorderPrivate
+  {
+  public:
+    typedef std::map<std::vector<uint32_t>, uint32_t> definition_map;
+
+    explicit
+    PainterTraceRecorderPrivate(unsigned int max_frames):
+      m_max_frames(max_frames),
+      m_number_frames(0),
+      m_in_frame(false)
+    {}
+
+    bool
+    done(void) const
+    {
+      return m_max_frames != 0 && m_number_frames >= m_max_frames;
+    }
+
+    void
+    clear(void);
+
+    void
+    write_record(uint32_t op, const fastuidraw::detail::BlobWriter &payload);
+
+    void
+    write_record(uint32_t op);
+
+    /* returns the id of the definition of the given kind with the
+       given payload, writing the definition if it is new.
+     */
+    uint32_t
+    define(enum definition_kind_t kind, const fastuidraw::detail::BlobWriter &payload);
+
+    uint32_t
+    path_id(const fastuidraw::Path &path);
+
+    uint32_t
+    image_id(const fastuidraw::reference_counted_ptr<const fastuidraw::Image> &image);
+
+    uint32_t
+    font_id(const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> &font);
+
+    uint32_t
+    glyph_run_id(const fastuidraw::GlyphRun &run);
+
+    uint32_t
+    brush_id(const fastuidraw::PainterData &draw);
+
+    uint32_t
+    stroke_id(const fastuidraw::PainterData &draw, bool dashed);
+
+    uint32_t
+    stream_id(const fastuidraw::PainterPackerStream *stream);
+
+    unsigned int m_max_frames, m_number_frames;
+    bool m_in_frame;
+    fastuidraw::detail::BlobWriter m_out;
+
+    fastuidraw::vecN<definition_map, number_definition_kinds> m_definitions;
+
+    /* images, fonts and streams are identified by their address,
+       the references keep the addresses from being reused.
+     */
+    std::map<const fastuidraw::Image*, uint32_t> m_images;
+    std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::Image> > m_image_refs;
+    std::map<const fastuidraw::FontBase*, uint32_t> m_fonts;
+    std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> > m_font_refs;
+    std::map<const fastuidraw::PainterPackerStream*, uint32_t> m_streams;
+    std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::PainterPackerStream> > m_stream_refs;
+  };
+
+  class record
+  {
+  public:
+    record(uint32_t op, fastuidraw::const_c_array<uint32_t> payload):
+      m_op(op),
+      m_payload(payload)
+    {}
+
+    uint32_t m_op;
+    fastuidraw::const_c_array<uint32_t> m_payload;
+  };
+
+  class frame
+  {
+  public:
+    unsigned int m_begin, m_end;
+    fastuidraw::ivec2 m_resolution;
+  };
+
+  /* the variant of stroking parameters of a stroke definition */
+  class stroke_params
+  {
+  public:
+    stroke_params(void):
+      m_created(false),
+      m_dashed(false)
+    {}
+
+    bool m_created, m_dashed;
+    fastuidraw::PainterStrokeParams m_stroke;
+    fastuidraw::PainterDashedStrokeParams m_dashed_stroke;
+  };
+
+  class PainterTracePlayerPrivate
+  {
+  public:
+    PainterTracePlayerPrivate(fastuidraw::const_c_array<uint8_t> blob,
+                              const fastuidraw::reference_counted_ptr<fastuidraw::PainterTracePlayer::ResourceProvider> &provider);
+
+    ~PainterTracePlayerPrivate();
+
+    void
+    parse(void);
+
+    /* Returns the payload of a definition without its id,
+       or an empty array if there is no such definition.
+     */
+    fastuidraw::const_c_array<uint32_t>
+    definition(enum definition_kind_t kind, uint32_t id) const;
+
+    const fastuidraw::Path*
+    path(uint32_t id);
+
+    fastuidraw::reference_counted_ptr<const fastuidraw::Image>
+    image(uint32_t id, fastuidraw::Painter &painter);
+
+    fastuidraw::reference_counted_ptr<const fastuidraw::FontBase>
+    font(uint32_t id);
+
+    const fastuidraw::GlyphRun*
+    glyph_run(uint32_t id);
+
+    const fastuidraw::PainterBrush*
+    brush(uint32_t id, fastuidraw::Painter &painter);
+
+    const fastuidraw::PainterItemShaderData*
+    stroke(uint32_t id);
+
+    fastuidraw::PainterData
+    painter_data(uint32_t brush_id, uint32_t stroke_id, fastuidraw::Painter &painter);
+
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterPackerStream>
+    stream(uint32_t id, fastuidraw::Painter &painter, bool create);
+
+    void
+    replay_record(const record &R, fastuidraw::Painter &painter);
+
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterTracePlayer::ResourceProvider> m_provider;
+    std::vector<uint32_t> m_words;
+    std::vector<record> m_records;
+    std::vector<frame> m_frames;
+    fastuidraw::vecN<std::vector<int>, number_definition_kinds> m_definitions;
+    bool m_valid;
+
+    std::vector<fastuidraw::Path*> m_paths;
+    std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::Image> > m_images;
+    std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> > m_fonts;
+    std::vector<fastuidraw::GlyphRun*> m_glyph_runs;
+    std::vector<fastuidraw::PainterBrush*> m_brushes;
+    std::vector<stroke_params*> m_strokes;
+    std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PainterPackerStream> > m_streams;
+
+    /* the definitions whose creation failed, so
+       that the creation is not tried again
+     */
+    fastuidraw::vecN<std::vector<bool>, number_definition_kinds> m_failed;
+  };
+}
+
+//////////////////////////////////////////////
+// PainterTraceRecorderPrivate methods
+void
+PainterTraceRecorderPrivate::
+clear(void)
+{
+  m_number_frames = 0;
+  m_in_frame = false;
+  m_out.clear();
+  for(unsigned int i = 0; i < m_definitions.size(); ++i)
+    {
+      m_definitions[i].clear();
+    }
+  m_images.clear();
+  m_image_refs.clear();
+  m_fonts.clear();
+  m_font_refs.clear();
+  m_streams.clear();
+  m_stream_refs.clear();
+}
+
+void
+PainterTraceRecorderPrivate::
+write_record(uint32_t op, const fastuidraw::detail::BlobWriter &payload)
+{
+  m_out.write_u32(op);
+  m_out.write_u32(payload.words().size());
+  m_out.append(payload);
+}
+
+void
+PainterTraceRecorderPrivate::
+write_record(uint32_t op)
+{
+  m_out.write_u32(op);
+  m_out.write_u32(0u);
+}
+
+uint32_t
+PainterTraceRecorderPrivate::
+define(enum definition_kind_t kind, const fastuidraw::detail::BlobWriter &payload)
+{
+  definition_map &defs(m_definitions[kind]);
+  definition_map::iterator iter;
+  uint32_t id;
+
+  iter = defs.find(payload.words());
+  if(iter != defs.end())
+    {
+      return iter->second;
+    }
+
+  id = defs.size();
+  defs[payload.words()] = id;
+
+  m_out.write_u32(op_define_path + kind);
+  m_out.write_u32(payload.words().size() + 1u);
+  m_out.write_u32(id);
+  m_out.append(payload);
+  return id;
+}
+
+uint32_t
+PainterTraceRecorderPrivate::
+path_id(const fastuidraw::Path &path)
+{
+  fastuidraw::detail::BlobWriter W;
+
+  write_path(W, path);
+  return define(path_definition, W);
+}
+
+uint32_t
+PainterTraceRecorderPrivate::
+image_id(const fastuidraw::reference_counted_ptr<const fastuidraw::Image> &image)
+{
+  std::map<const fastuidraw::Image*, uint32_t>::iterator iter;
+  fastuidraw::detail::BlobWriter W;
+  uint32_t id;
+
+  iter = m_images.find(image.get());
+  if(iter != m_images.end())
+    {
+      return iter->second;
+    }
+
+  /* two images of the same size are distinct images, so the
+     definition is written directly instead of by define().
+   */
+  id = m_image_refs.size();
+  m_images[image.get()] = id;
+  m_image_refs.push_back(image);
+
+  W.write_u32(id);
+  W.write_i32(image->dimensions().x());
+  W.write_i32(image->dimensions().y());
+  W.write_u32(image->slack());
+  W.write_u32(image->number_mipmap_levels());
+  write_record(op_define_image, W);
+  return id;
+}
+
+uint32_t
+PainterTraceRecorderPrivate::
+font_id(const fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> &font)
+{
+  std::map<const fastuidraw::FontBase*, uint32_t>::iterator iter;
+  fastuidraw::detail::BlobWriter W;
+  uint32_t id;
+
+  iter = m_fonts.find(font.get());
+  if(iter != m_fonts.end())
+    {
+      return iter->second;
+    }
+
+  id = m_font_refs.size();
+  m_fonts[font.get()] = id;
+  m_font_refs.push_back(font);
+
+  const fastuidraw::FontProperties &props(font->properties());
+  W.write_u32(id);
+  W.write_bool(props.bold());
+  W.write_bool(props.italic());
+  write_string(W, props.style());
+  write_string(W, props.family());
+  write_string(W, props.foundry());
+  write_string(W, props.source_label());
+  write_record(op_define_font, W);
+  return id;
+}
+
+uint32_t
+PainterTraceRecorderPrivate::
+glyph_run_id(const fastuidraw::GlyphRun &run)
+{
+  fastuidraw::detail::BlobWriter W;
+  std::vector<uint32_t> fonts;
+  unsigned int num_valid(0);
+
+  /* the fonts are defined before the glyph run */
+  fonts.resize(run.number_glyphs(), no_id);
+  for(unsigned int i = 0, endi = run.number_glyphs(); i < endi; ++i)
+    {
+      fastuidraw::Glyph G(run.glyph(i));
+      if(G.valid() && G.layout().m_font)
+        {
+          fonts[i] = font_id(G.layout().m_font);
+          ++num_valid;
+        }
+    }
+
+  W.write_u32(run.orientation());
+  W.write_bool(run.instanced());
+  W.write_u32(num_valid);
+  for(unsigned int i = 0, endi = run.number_glyphs(); i < endi; ++i)
+    {
+      if(fonts[i] != no_id)
+        {
+          fastuidraw::Glyph G(run.glyph(i));
+
+          W.write_u32(fonts[i]);
+          W.write_u32(G.type());
+          W.write_i32(G.layout().m_pixel_size);
+          W.write_i32(G.renderer().m_subpixel_offset);
+          W.write_u32(G.layout().m_glyph_code);
+          W.write_vec2(run.glyph_position(i));
+          W.write_float(run.render_pixel_size(i));
+        }
+    }
+  return define(glyph_run_definition, W);
+}
+
+uint32_t
+PainterTraceRecorderPrivate::
+brush_id(const fastuidraw::PainterData &draw)
+{
+  using namespace fastuidraw;
+
+  const PainterBrush *brush(brush_of(draw));
+  detail::BlobWriter W;
+  uint32_t shader, image;
+
+  if(!brush)
+    {
+      return no_id;
+    }
+
+  shader = brush->shader();
+  image = (shader & PainterBrush::image_mask) ? image_id(brush->image()) : no_id;
+
+  W.write_u32(shader);
+  W.write_float(brush->pen().x());
+  W.write_float(brush->pen().y());
+  W.write_float(brush->pen().z());
+  W.write_float(brush->pen().w());
+
+  if(image != no_id)
+    {
+      W.write_u32(image);
+      W.write_u32(brush->sub_image_start().x());
+      W.write_u32(brush->sub_image_start().y());
+      W.write_u32(brush->sub_image_size().x());
+      W.write_u32(brush->sub_image_size().y());
+    }
+
+  if(shader & PainterBrush::gradient_mask)
+    {
+      const_c_array<ColorStop> stops;
+      int width(0);
+
+      if(shader & PainterBrush::gradient_inline_color_stops_mask)
+        {
+          W.write_u32(inline_gradient);
+          stops = brush->inline_color_stops();
+        }
+      else
+        {
+          W.write_u32(atlas_gradient);
+          stops = brush->color_stops()->color_stops();
+          width = brush->color_stops()->width();
+        }
+
+      W.write_i32(width);
+      W.write_u32(stops.size());
+      for(unsigned int i = 0; i < stops.size(); ++i)
+        {
+          W.write_u32(pack_color(stops[i].m_color));
+          W.write_float(stops[i].m_place);
+        }
+      W.write_vec2(brush->gradient_start());
+      W.write_vec2(brush->gradient_end());
+      W.write_float(brush->gradient_start_radius());
+      W.write_float(brush->gradient_end_radius());
+    }
+
+  if(shader & PainterBrush::repeat_window_mask)
+    {
+      W.write_vec2(brush->repeat_window_position());
+      W.write_vec2(brush->repeat_window_size());
+    }
+
+  if(shader & PainterBrush::transformation_translation_mask)
+    {
+      W.write_vec2(brush->transformation_translate());
+    }
+
+  if(shader & PainterBrush::transformation_matrix_mask)
+    {
+      const float2x2 &m(brush->transformation_matrix());
+      W.write_float(m(0, 0));
+      W.write_float(m(0, 1));
+      W.write_float(m(1, 0));
+      W.write_float(m(1, 1));
+    }
+  return define(brush_definition, W);
+}
+
+uint32_t
+PainterTraceRecorderPrivate::
+stroke_id(const fastuidraw::PainterData &draw, bool dashed)
+{
+  using namespace fastuidraw;
+
+  const PainterItemShaderData *data(item_data_of(draw));
+  detail::BlobWriter W;
+
+  if(!data)
+    {
+      return no_id;
+    }
+
+  /* the default stroke shaders require their item
+     shader data to be of these types.
+   */
+  W.write_bool(dashed);
+  if(dashed)
+    {
+      const PainterDashedStrokeParams &st(static_cast<const PainterDashedStrokeParams&>(*data));
+      const_c_array<PainterDashedStrokeParams::DashPatternElement> pattern(st.dash_pattern());
+
+      W.write_float(st.width());
+      W.write_float(st.miter_limit());
+      W.write_float(st.dash_offset());
+      W.write_u32(pattern.size());
+      for(unsigned int i = 0; i < pattern.size(); ++i)
+        {
+          W.write_float(pattern[i].m_draw_length);
+          W.write_float(pattern[i].m_space_length);
+        }
+    }
+  else
+    {
+      const PainterStrokeParams &st(static_cast<const PainterStrokeParams&>(*data));
+
+      W.write_float(st.width());
+      W.write_float(st.miter_limit());
+    }
+  return define(stroke_definition, W);
+}
+
+uint32_t
+PainterTraceRecorderPrivate::
+stream_id(const fastuidraw::PainterPackerStream *stream)
+{
+  std::map<const fastuidraw::PainterPackerStream*, uint32_t>::iterator iter;
+  uint32_t id;
+
+  iter = m_streams.find(stream);
+  if(iter != m_streams.end())
+    {
+      return iter->second;
+    }
+
+  id = m_stream_refs.size();
+  m_streams[stream] = id;
+  m_stream_refs.push_back(stream);
+  return id;
+}
+
+///////////////////////////////////////////
+// PainterTracePlayerPrivate methods
+PainterTracePlayerPrivate::
+PainterTracePlayerPrivate(fastuidraw::const_c_array<uint8_t> blob,
+                          const fastuidraw::reference_counted_ptr<fastuidraw::PainterTracePlayer::ResourceProvider> &provider):
+  m_provider(provider),
+  m_valid(false)
+{
+  std::vector<uint32_t> backing;
+  fastuidraw::detail::BlobReader src(blob, backing);
+
+  m_words.resize(blob.size() / sizeof(uint32_t));
+  for(unsigned int i = 0, endi = m_words.size(); i < endi; ++i)
+    {
+      m_words[i] = src.read_u32();
+    }
+  parse();
+}
+
+PainterTracePlayerPrivate::
+~PainterTracePlayerPrivate()
+{
+  for(unsigned int i = 0; i < m_paths.size(); ++i)
+    {
+      if(m_paths[i])
+        {
+          FASTUIDRAWdelete(m_paths[i]);
+        }
+    }
+
+  for(unsigned int i = 0; i < m_glyph_runs.size(); ++i)
+    {
+      if(m_glyph_runs[i])
+        {
+          FASTUIDRAWdelete(m_glyph_runs[i]);
+        }
+    }
+
+  for(unsigned int i = 0; i < m_brushes.size(); ++i)
+    {
+      if(m_brushes[i])
+        {
+          FASTUIDRAWdelete(m_brushes[i]);
+        }
+    }
+
+  for(unsigned int i = 0; i < m_strokes.size(); ++i)
+    {
+      if(m_strokes[i])
+        {
+          FASTUIDRAWdelete(m_strokes[i]);
+        }
+    }
+}
+
+void
+PainterTracePlayerPrivate::
+parse(void)
+{
+  unsigned int loc, open_frame, endloc;
+
+  endloc = m_words.size();
+  if(endloc < trace_header_size
+     || m_words[0] != trace_magic
+     || m_words[1] != trace_version)
+    {
+      return;
+    }
+
+  open_frame = no_id;
+  for(loc = trace_header_size; loc + 2 <= endloc;)
+    {
+      uint32_t op, len;
+
+      op = m_words[loc];
+      len = m_words[loc + 1];
+      if(op >= number_opcodes || len > endloc - loc - 2)
+        {
+          return;
+        }
+
+      fastuidraw::const_c_array<uint32_t> payload;
+      if(len > 0)
+        {
+          payload = fastuidraw::const_c_array<uint32_t>(&m_words[loc + 2], len);
+        }
+      loc += len + 2;
+
+      if(op < op_begin_frame)
+        {
+          unsigned int kind(op - op_define_path);
+          uint32_t id;
+
+          if(payload.empty())
+            {
+              return;
+            }
+          id = payload[0];
+          if(id != m_definitions[kind].size())
+            {
+              return;
+            }
+          m_definitions[kind].push_back(m_records.size());
+        }
+      else if(op == op_begin_frame)
+        {
+          fastuidraw::detail::BlobReader R(payload);
+          frame F;
+
+          if(open_frame != no_id)
+            {
+              return;
+            }
+          F.m_begin = m_records.size();
+          F.m_end = F.m_begin;
+          F.m_resolution.x() = R.read_i32();
+          F.m_resolution.y() = R.read_i32();
+          if(R.failed())
+            {
+              return;
+            }
+          open_frame = m_frames.size();
+          m_frames.push_back(F);
+        }
+      else if(op == op_end_frame)
+        {
+          if(open_frame == no_id)
+            {
+              return;
+            }
+          m_frames[open_frame].m_end = m_records.size();
+          open_frame = no_id;
+        }
+
+      m_records.push_back(record(op, payload));
+    }
+
+  if(open_frame != no_id)
+    {
+      /* the trace was written in the middle of
+         a frame, drop the incomplete frame.
+       */
+      m_frames.pop_back();
+    }
+
+  m_paths.resize(m_definitions[path_definition].size(), NULL);
+  m_images.resize(m_definitions[image_definition].size());
+  m_fonts.resize(m_definitions[font_definition].size());
+  m_glyph_runs.resize(m_definitions[glyph_run_definition].size(), NULL);
+  m_brushes.resize(m_definitions[brush_definition].size(), NULL);
+  m_strokes.resize(m_definitions[stroke_definition].size(), NULL);
+  for(unsigned int i = 0; i < m_failed.size(); ++i)
+    {
+      m_failed[i].resize(m_definitions[i].size(), false);
+    }
+  m_valid = true;
+}
+
+fastuidraw::const_c_array<uint32_t>
+PainterTracePlayerPrivate::
+definition(enum definition_kind_t kind, uint32_t id) const
+{
+  if(id >= m_definitions[kind].size() || m_failed[kind][id])
+    {
+      return fastuidraw::const_c_array<uint32_t>();
+    }
+  return m_records[m_definitions[kind][id]].m_payload.sub_array(1);
+}
+
+const fastuidraw::Path*
+PainterTracePlayerPrivate::
+path(uint32_t id)
+{
+  if(id < m_paths.size() && !m_paths[id] && !m_failed[path_definition][id])
+    {
+      fastuidraw::detail::BlobReader R(definition(path_definition, id));
+      fastuidraw::Path *P;
+
+      P = FASTUIDRAWnew fastuidraw::Path();
+      read_path(R, *P);
+      if(R.failed())
+        {
+          FASTUIDRAWdelete(P);
+          m_failed[path_definition][id] = true;
+        }
+      else
+        {
+          m_paths[id] = P;
+        }
+    }
+  return (id < m_paths.size()) ? m_paths[id] : NULL;
+}
+
+fastuidraw::reference_counted_ptr<const fastuidraw::Image>
+PainterTracePlayerPrivate::
+image(uint32_t id, fastuidraw::Painter &painter)
+{
+  if(id < m_images.size() && !m_images[id] && !m_failed[image_definition][id])
+    {
+      fastuidraw::detail::BlobReader R(definition(image_definition, id));
+      fastuidraw::ivec2 dims;
+      unsigned int slack, levels;
+
+      dims.x() = R.read_i32();
+      dims.y() = R.read_i32();
+      slack = R.read_u32();
+      levels = R.read_u32();
+      if(!R.failed() && dims.x() > 0 && dims.y() > 0)
+        {
+          m_images[id] = m_provider->image(painter.image_atlas(), dims, slack, levels);
+        }
+      m_failed[image_definition][id] = !m_images[id];
+    }
+  return (id < m_images.size()) ?
+    m_images[id] :
+    fastuidraw::reference_counted_ptr<const fastuidraw::Image>();
+}
+
+fastuidraw::reference_counted_ptr<const fastuidraw::FontBase>
+PainterTracePlayerPrivate::
+font(uint32_t id)
+{
+  if(id < m_fonts.size() && !m_fonts[id] && !m_failed[font_definition][id])
+    {
+      fastuidraw::detail::BlobReader R(definition(font_definition, id));
+      fastuidraw::FontProperties props;
+      std::string style, family, foundry, source_label;
+
+      props.bold(R.read_bool());
+      props.italic(R.read_bool());
+      style = read_string(R);
+      family = read_string(R);
+      foundry = read_string(R);
+      source_label = read_string(R);
+      props
+        .style(style.c_str())
+        .family(family.c_str())
+        .foundry(foundry.c_str())
+        .source_label(source_label.c_str());
+
+      if(!R.failed())
+        {
+          m_fonts[id] = m_provider->font(props);
+        }
+      m_failed[font_definition][id] = !m_fonts[id];
+    }
+  return (id < m_fonts.size()) ?
+    m_fonts[id] :
+    fastuidraw::reference_counted_ptr<const fastuidraw::FontBase>();
+}
+
+const fastuidraw::GlyphRun*
+PainterTracePlayerPrivate::
+glyph_run(uint32_t id)
+{
+  using namespace fastuidraw;
+
+  if(id < m_glyph_runs.size() && !m_glyph_runs[id] && !m_failed[glyph_run_definition][id])
+    {
+      detail::BlobReader R(definition(glyph_run_definition, id));
+      reference_counted_ptr<GlyphCache> cache(m_provider->glyph_cache());
+      enum PainterEnums::glyph_orientation orientation;
+      unsigned int num_glyphs;
+      bool instanced;
+      GlyphRun *run;
+
+      orientation = (R.read_u32() == PainterEnums::y_increases_upwards) ?
+        PainterEnums::y_increases_upwards :
+        PainterEnums::y_increases_downwards;
+      instanced = R.read_bool();
+      num_glyphs = R.read_u32();
+
+      m_failed[glyph_run_definition][id] = true;
+      if(R.failed() || !cache)
+        {
+          return NULL;
+        }
+
+      run = FASTUIDRAWnew GlyphRun(orientation, instanced);
+      for(unsigned int i = 0; i < num_glyphs && !R.failed(); ++i)
+        {
+          reference_counted_ptr<const FontBase> F;
+          GlyphRender render;
+          uint32_t glyph_code;
+          vec2 position;
+          float render_pixel_size;
+
+          F = font(R.read_u32());
+          render.m_type = static_cast<enum glyph_type>(R.read_u32());
+          render.m_pixel_size = R.read_i32();
+          render.m_subpixel_offset = R.read_i32();
+          glyph_code = R.read_u32();
+          position = R.read_vec2();
+          render_pixel_size = R.read_float();
+
+          if(F && !R.failed() && render.valid()
+             && F->can_create_rendering_data(render.m_type))
+            {
+              run->append(*cache, render, F,
+                          const_c_array<vec2>(&position, 1),
+                          const_c_array<uint32_t>(&glyph_code, 1),
+                          render_pixel_size);
+            }
+        }
+
+      if(R.failed())
+        {
+          FASTUIDRAWdelete(run);
+          return NULL;
+        }
+      m_failed[glyph_run_definition][id] = false;
+      m_glyph_runs[id] = run;
+    }
+  return (id < m_glyph_runs.size()) ? m_glyph_runs[id] : NULL;
+}
+
+const fastuidraw::PainterBrush*
+PainterTracePlayerPrivate::
+brush(uint32_t id, fastuidraw::Painter &painter)
+{
+  using namespace fastuidraw;
+
+  if(id < m_brushes.size() && !m_brushes[id] && !m_failed[brush_definition][id])
+    {
+      detail::BlobReader R(definition(brush_definition, id));
+      PainterBrush *brush;
+      uint32_t shader;
+      vec4 pen;
+
+      brush = FASTUIDRAWnew PainterBrush();
+      shader = R.read_u32();
+      pen.x() = R.read_float();
+      pen.y() = R.read_float();
+      pen.z() = R.read_float();
+      pen.w() = R.read_float();
+      brush->pen(pen);
+
+      if(shader & PainterBrush::image_mask)
+        {
+          reference_counted_ptr<const Image> im;
+          uint32_t filter;
+          uvec2 xy, wh;
+
+          im = image(R.read_u32(), painter);
+          xy.x() = R.read_u32();
+          xy.y() = R.read_u32();
+          wh.x() = R.read_u32();
+          wh.y() = R.read_u32();
+          filter = unpack_bits(PainterBrush::image_filter_bit0,
+                               PainterBrush::image_filter_num_bits,
+                               shader);
+          if(im && filter >= PainterBrush::image_filter_nearest
+             && filter <= PainterBrush::image_filter_cubic)
+            {
+              brush->sub_image(im, xy, wh, static_cast<enum PainterBrush::image_filter>(filter));
+            }
+        }
+
+      if(shader & PainterBrush::gradient_mask)
+        {
+          ColorStopSequence stops;
+          uint32_t kind, num_stops;
+          int width;
+          vec2 p0, p1;
+          float r0, r1;
+          bool repeat, radial;
+
+          kind = R.read_u32();
+          width = R.read_i32();
+          num_stops = R.read_u32();
+          for(unsigned int i = 0; i < num_stops && !R.failed(); ++i)
+            {
+              u8vec4 c(unpack_color(R.read_u32()));
+              float place(R.read_float());
+              stops.add(ColorStop(c, place));
+            }
+          p0 = R.read_vec2();
+          p1 = R.read_vec2();
+          r0 = R.read_float();
+          r1 = R.read_float();
+          repeat = (shader & PainterBrush::gradient_repeat_mask) != 0u;
+          radial = (shader & PainterBrush::radial_gradient_mask) != 0u;
+
+          if(!R.failed() && num_stops > 0 && kind == inline_gradient)
+            {
+              if(radial)
+                {
+                  brush->radial_gradient(stops, p0, r0, p1, r1, repeat);
+                }
+              else
+                {
+                  brush->linear_gradient(stops, p0, p1, repeat);
+                }
+            }
+          else if(!R.failed() && num_stops > 0 && kind == atlas_gradient && width > 0)
+            {
+              reference_counted_ptr<const ColorStopSequenceOnAtlas> cs;
+
+              cs = FASTUIDRAWnew ColorStopSequenceOnAtlas(stops, painter.colorstop_atlas(), width);
+              if(radial)
+                {
+                  brush->radial_gradient(cs, p0, r0, p1, r1, repeat);
+                }
+              else
+                {
+                  brush->linear_gradient(cs, p0, p1, repeat);
+                }
+            }
+        }
+
+      if(shader & PainterBrush::repeat_window_mask)
+        {
+          vec2 pos, size;
+
+          pos = R.read_vec2();
+          size = R.read_vec2();
+          brush->repeat_window(pos, size);
+        }
+
+      if(shader & PainterBrush::transformation_translation_mask)
+        {
+          brush->transformation_translate(R.read_vec2());
+        }
+
+      if(shader & PainterBrush::transformation_matrix_mask)
+        {
+          float2x2 m;
+
+          m(0, 0) = R.read_float();
+          m(0, 1) = R.read_float();
+          m(1, 0) = R.read_float();
+          m(1, 1) = R.read_float();
+          brush->transformation_matrix(m);
+        }
+
+      if(R.failed())
+        {
+          FASTUIDRAWdelete(brush);
+          m_failed[brush_definition][id] = true;
+        }
+      else
+        {
+          m_brushes[id] = brush;
+        }
+    }
+  return (id < m_brushes.size()) ? m_brushes[id] : NULL;
+}
+
+const fastuidraw::PainterItemShaderData*
+PainterTracePlayerPrivate::
+stroke(uint32_t id)
+{
+  using namespace fastuidraw;
+
+  if(id < m_strokes.size() && !m_strokes[id] && !m_failed[stroke_definition][id])
+    {
+      detail::BlobReader R(definition(stroke_definition, id));
+      stroke_params *st;
+
+      st = FASTUIDRAWnew stroke_params();
+      st->m_dashed = R.read_bool();
+      if(st->m_dashed)
+        {
+          std::vector<PainterDashedStrokeParams::DashPatternElement> pattern;
+          unsigned int num_elements;
+
+          st->m_dashed_stroke.width(R.read_float());
+          st->m_dashed_stroke.miter_limit(R.read_float());
+          st->m_dashed_stroke.dash_offset(R.read_float());
+          num_elements = R.read_u32();
+          for(unsigned int i = 0; i < num_elements && !R.failed(); ++i)
+            {
+              PainterDashedStrokeParams::DashPatternElement E;
+              E.m_draw_length = R.read_float();
+              E.m_space_length = R.read_float();
+              pattern.push_back(E);
+            }
+          st->m_dashed_stroke.dash_pattern(make_c_array(pattern));
+        }
+      else
+        {
+          st->m_stroke.width(R.read_float());
+          st->m_stroke.miter_limit(R.read_float());
+        }
+
+      if(R.failed())
+        {
+          FASTUIDRAWdelete(st);
+          m_failed[stroke_definition][id] = true;
+        }
+      else
+        {
+          m_strokes[id] = st;
+        }
+    }
+
+  if(id < m_strokes.size() && m_strokes[id])
+    {
+      const stroke_params *st(m_strokes[id]);
+      return (st->m_dashed) ?
+        static_cast<const PainterItemShaderData*>(&st->m_dashed_stroke) :
+        static_cast<const PainterItemShaderData*>(&st->m_stroke);
+    }
+  return NULL;
+}
+
+fastuidraw::PainterData
+PainterTracePlayerPrivate::
+painter_data(uint32_t brush_id, uint32_t stroke_id, fastuidraw::Painter &painter)
+{
+  fastuidraw::PainterData return_value;
+
+  return_value.m_brush.m_value = brush(brush_id, painter);
+  return_value.m_item_shader_data.m_value = stroke(stroke_id);
+  return return_value;
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::PainterPackerStream>
+PainterTracePlayerPrivate::
+stream(uint32_t id, fastuidraw::Painter &painter, bool create)
+{
+  /* streams have no definition, a stream is created
+     by the first begin_recording() that uses its id.
+   */
+  if(create && id < 0x10000u && id >= m_streams.size())
+    {
+      m_streams.resize(id + 1);
+    }
+
+  if(id >= m_streams.size())
+    {
+      return fastuidraw::reference_counted_ptr<fastuidraw::PainterPackerStream>();
+    }
+
+  if(create && !m_streams[id])
+    {
+      m_streams[id] = FASTUIDRAWnew fastuidraw::PainterPackerStream(painter.alignment());
+    }
+  return m_streams[id];
+}
+
+void
+PainterTracePlayerPrivate::
+replay_record(const record &rec, fastuidraw::Painter &painter)
+{
+  using namespace fastuidraw;
+
+  detail::BlobReader R(rec.m_payload);
+
+  switch(rec.m_op)
+    {
+    case op_begin_frame:
+      {
+        fastuidraw::Painter::BeginParams params;
+
+        R.read_i32();
+        R.read_i32();
+        params.m_reset_z = R.read_bool();
+        params.m_multisampled_target = R.read_bool();
+        /* traces from before no_depth_buffer was recorded
+           end here; the read then gives false.
+         */
+        params.m_no_depth_buffer = R.read_bool();
+        painter.begin(params);
+      }
+      break;
+
+    case op_end_frame:
+      painter.end();
+      break;
+
+    case op_save:
+      painter.save();
+      break;
+
+    case op_restore:
+      painter.restore();
+      break;
+
+    case op_transformation:
+      {
+        float3x3 m;
+        for(unsigned int r = 0; r < 3; ++r)
+          {
+            for(unsigned int c = 0; c < 3; ++c)
+              {
+                m(r, c) = R.read_float();
+              }
+          }
+        if(!R.failed())
+          {
+            painter.transformation(m);
+          }
+      }
+      break;
+
+    case op_blend_mode:
+      {
+        uint32_t m(R.read_u32());
+        const PainterBlendShaderSet &blend(painter.default_shaders().blend_shaders());
+
+        if(m < blend.shader_count()
+           && blend.shader(static_cast<enum PainterEnums::blend_mode_t>(m)))
+          {
+            painter.blend_shader(static_cast<enum PainterEnums::blend_mode_t>(m));
+          }
+        else
+          {
+            painter.blend_shader(PainterEnums::blend_porter_duff_src_over);
+          }
+      }
+      break;
+
+    case op_curve_flatness:
+      painter.curveFlatness(R.read_float());
+      break;
+
+    case op_clip_in_rect:
+      {
+        vec2 xy, wh;
+
+        xy = R.read_vec2();
+        wh = R.read_vec2();
+        painter.clipInRect(xy, wh);
+      }
+      break;
+
+    case op_clip_in_rounded_rect:
+      {
+        vec2 xy, wh;
+        float r;
+
+        xy = R.read_vec2();
+        wh = R.read_vec2();
+        r = R.read_float();
+        painter.clipInRoundedRect(xy, wh, r);
+      }
+      break;
+
+    case op_clip_path:
+      {
+        const Path *P;
+        bool clip_in;
+        uint32_t rule;
+
+        clip_in = R.read_bool();
+        P = path(R.read_u32());
+        rule = R.read_u32();
+        if(P && rule < PainterEnums::fill_rule_data_count)
+          {
+            if(clip_in)
+              {
+                painter.clipInPath(*P, static_cast<enum PainterEnums::fill_rule_t>(rule));
+              }
+            else
+              {
+                painter.clipOutPath(*P, static_cast<enum PainterEnums::fill_rule_t>(rule));
+              }
+          }
+      }
+      break;
+
+    case op_fill_path:
+      {
+        const Path *P;
+        uint32_t brush, rule;
+
+        brush = R.read_u32();
+        P = path(R.read_u32());
+        rule = R.read_u32();
+        if(P && rule < PainterEnums::fill_rule_data_count)
+          {
+            painter.fill_path(painter_data(brush, no_id, painter), *P,
+                              static_cast<enum PainterEnums::fill_rule_t>(rule));
+          }
+      }
+      break;
+
+    case op_stroke_path:
+      {
+        const Path *P;
+        uint32_t brush, stroke_id, flags, cap, join;
+        bool close_contours, aa;
+
+        brush = R.read_u32();
+        stroke_id = R.read_u32();
+        P = path(R.read_u32());
+        flags = R.read_u32();
+        cap = R.read_u32();
+        join = R.read_u32();
+
+        /* the stroke definition must match the kind of stroke */
+        if(!P || !stroke(stroke_id)
+           || m_strokes[stroke_id]->m_dashed != ((flags & stroke_dashed) != 0u)
+           || cap >= PainterEnums::number_cap_styles
+           || join >= PainterEnums::number_join_styles)
+          {
+            break;
+          }
+
+        PainterData draw(painter_data(brush, stroke_id, painter));
+        enum PainterEnums::cap_style cp(static_cast<enum PainterEnums::cap_style>(cap));
+        enum PainterEnums::join_style js(static_cast<enum PainterEnums::join_style>(join));
+
+        close_contours = (flags & stroke_close_contours) != 0u;
+        aa = (flags & stroke_anti_alias) != 0u;
+        if(flags & stroke_dashed)
+          {
+            painter.stroke_dashed_path((flags & stroke_pixel_width) ?
+                                       painter.default_shaders().pixel_width_dashed_stroke_shader() :
+                                       painter.default_shaders().dashed_stroke_shader(),
+                                       draw, *P, close_contours, cp, js, aa);
+          }
+        else
+          {
+            painter.stroke_path((flags & stroke_pixel_width) ?
+                                painter.default_shaders().pixel_width_stroke_shader() :
+                                painter.default_shaders().stroke_shader(),
+                                draw, *P, close_contours, cp, js, aa);
+          }
+      }
+      break;
+
+    case op_draw_convex_polygon:
+    case op_draw_quads:
+      {
+        uint32_t brush, num_pts;
+        const_c_array<vec2> pts;
+
+        brush = R.read_u32();
+        num_pts = R.read_u32();
+        pts = R.read_pod_array<vec2>(num_pts);
+        if(R.failed())
+          {
+            break;
+          }
+
+        if(rec.m_op == op_draw_convex_polygon)
+          {
+            painter.draw_convex_polygon(painter_data(brush, no_id, painter), pts);
+          }
+        else if(pts.size() % 4 == 0)
+          {
+            painter.draw_quads(painter_data(brush, no_id, painter), pts);
+          }
+      }
+      break;
+
+    case op_draw_glyph_runs:
+      {
+        std::vector<const GlyphRun*> runs;
+        uint32_t brush, num_runs;
+        bool aniso;
+
+        brush = R.read_u32();
+        aniso = R.read_bool();
+        num_runs = R.read_u32();
+        for(unsigned int i = 0; i < num_runs && !R.failed(); ++i)
+          {
+            const GlyphRun *run(glyph_run(R.read_u32()));
+            if(run)
+              {
+                runs.push_back(run);
+              }
+          }
+        painter.draw_glyph_runs(painter_data(brush, no_id, painter),
+                                make_c_array(runs), aniso);
+      }
+      break;
+
+    case op_begin_layer:
+      {
+        vec2 xy, wh;
+        float opacity;
+
+        xy = R.read_vec2();
+        wh = R.read_vec2();
+        opacity = R.read_float();
+        painter.begin_layer(xy, wh, opacity);
+      }
+      break;
+
+    case op_end_layer:
+      painter.end_layer();
+      break;
+
+    case op_end_layer_blurred:
+      painter.end_layer_blurred(R.read_float());
+      break;
+
+    case op_end_layer_drop_shadow:
+      {
+        float r;
+        vec2 offset;
+        vec4 color;
+
+        r = R.read_float();
+        offset = R.read_vec2();
+        for(unsigned int i = 0; i < 4; ++i)
+          {
+            color[i] = R.read_float();
+          }
+        painter.end_layer_drop_shadow(r, offset, color);
+      }
+      break;
+
+    case op_begin_recording:
+      {
+        reference_counted_ptr<PainterPackerStream> S;
+
+        S = stream(R.read_u32(), painter, true);
+        if(S)
+          {
+            painter.begin_recording(S);
+          }
+      }
+      break;
+
+    case op_end_recording:
+      if(painter.recording())
+        {
+          painter.end_recording();
+        }
+      break;
+
+    case op_draw_stream:
+      {
+        reference_counted_ptr<PainterPackerStream> S;
+        bool use_current_state;
+
+        S = stream(R.read_u32(), painter, false);
+        use_current_state = R.read_bool();
+        if(S && !painter.recording())
+          {
+            painter.draw_stream(*S, use_current_state);
+          }
+      }
+      break;
+
+    default:
+      /* definitions are created on their first use */
+      break;
+    }
+}
+
+/////////////////////////////////////////////
+// fastuidraw::PainterTraceRecorder methods
+fastuidraw::PainterTraceRecorder::
+PainterTraceRecorder(unsigned int max_frames)
+{
+  m_d = FASTUIDRAWnew PainterTraceRecorderPrivate(max_frames);
+}
+
+fastuidraw::PainterTraceRecorder::
+~PainterTraceRecorder()
+{
+  PainterTraceRecorderPrivate *d;
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+unsigned int
+fastuidraw::PainterTraceRecorder::
+number_frames(void) const
+{
+  PainterTraceRecorderPrivate *d;
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  return d->m_number_frames;
+}
+
+bool
+fastuidraw::PainterTraceRecorder::
+done(void) const
+{
+  PainterTraceRecorderPrivate *d;
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  return d->done();
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+write(std::vector<uint8_t> &dst) const
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  W.write_u32(trace_magic);
+  W.write_u32(trace_version);
+  W.write_u32(d->m_number_frames);
+  W.append(d->m_out);
+  W.finish(dst);
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+clear(void)
+{
+  PainterTraceRecorderPrivate *d;
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  d->clear();
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+begin_frame(const ivec2 &resolution, bool reset_z, bool multisampled_target,
+            bool no_depth_buffer)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  d->m_in_frame = !d->done();
+  if(!d->m_in_frame)
+    {
+      return;
+    }
+
+  W.write_i32(resolution.x());
+  W.write_i32(resolution.y());
+  W.write_bool(reset_z);
+  W.write_bool(multisampled_target);
+  W.write_bool(no_depth_buffer);
+  d->write_record(op_begin_frame, W);
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+end_frame(void)
+{
+  PainterTraceRecorderPrivate *d;
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      d->write_record(op_end_frame);
+      d->m_in_frame = false;
+      ++d->m_number_frames;
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+save(void)
+{
+  PainterTraceRecorderPrivate *d;
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      d->write_record(op_save);
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+restore(void)
+{
+  PainterTraceRecorderPrivate *d;
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      d->write_record(op_restore);
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+transformation(const float3x3 &m)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(!d->m_in_frame)
+    {
+      return;
+    }
+
+  for(unsigned int r = 0; r < 3; ++r)
+    {
+      for(unsigned int c = 0; c < 3; ++c)
+        {
+          W.write_float(m(r, c));
+        }
+    }
+  d->write_record(op_transformation, W);
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+blend_shader(const PainterShaderSet &default_shaders,
+             const reference_counted_ptr<PainterBlendShader> &h,
+             BlendMode::packed_value mode)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+  uint32_t m(no_id);
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(!d->m_in_frame)
+    {
+      return;
+    }
+
+  const PainterBlendShaderSet &blend(default_shaders.blend_shaders());
+  for(unsigned int i = 0, endi = blend.shader_count(); i < endi && m == no_id; ++i)
+    {
+      enum PainterEnums::blend_mode_t e(static_cast<enum PainterEnums::blend_mode_t>(i));
+      if(blend.shader(e) == h && blend.blend_mode(e) == mode)
+        {
+          m = i;
+        }
+    }
+  W.write_u32(m);
+  d->write_record(op_blend_mode, W);
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+curve_flatness(float v)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      W.write_float(v);
+      d->write_record(op_curve_flatness, W);
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+clip_in_rect(const vec2 &xy, const vec2 &wh)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      W.write_vec2(xy);
+      W.write_vec2(wh);
+      d->write_record(op_clip_in_rect, W);
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+clip_in_rounded_rect(const vec2 &xy, const vec2 &wh, float corner_radius)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      W.write_vec2(xy);
+      W.write_vec2(wh);
+      W.write_float(corner_radius);
+      d->write_record(op_clip_in_rounded_rect, W);
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+clip_path(bool clip_in, const Path &path, enum PainterEnums::fill_rule_t fill_rule)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+  uint32_t path_id;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(!d->m_in_frame)
+    {
+      return;
+    }
+
+  path_id = d->path_id(path);
+  W.write_bool(clip_in);
+  W.write_u32(path_id);
+  W.write_u32(fill_rule);
+  d->write_record(op_clip_path, W);
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+fill_path(const PainterData &draw, const Path &path,
+          enum PainterEnums::fill_rule_t fill_rule)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+  uint32_t brush_id, path_id;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(!d->m_in_frame)
+    {
+      return;
+    }
+
+  brush_id = d->brush_id(draw);
+  path_id = d->path_id(path);
+  W.write_u32(brush_id);
+  W.write_u32(path_id);
+  W.write_u32(fill_rule);
+  d->write_record(op_fill_path, W);
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+stroke_path(const PainterData &draw, const Path &path, bool dashed, bool pixel_width,
+            bool close_contours, enum PainterEnums::cap_style cp,
+            enum PainterEnums::join_style js, bool with_anti_aliasing)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+  uint32_t brush_id, stroke_id, path_id, flags(0u);
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(!d->m_in_frame)
+    {
+      return;
+    }
+
+  brush_id = d->brush_id(draw);
+  stroke_id = d->stroke_id(draw, dashed);
+  path_id = d->path_id(path);
+
+  flags |= (dashed) ? uint32_t(stroke_dashed) : 0u;
+  flags |= (pixel_width) ? uint32_t(stroke_pixel_width) : 0u;
+  flags |= (close_contours) ? uint32_t(stroke_close_contours) : 0u;
+  flags |= (with_anti_aliasing) ? uint32_t(stroke_anti_alias) : 0u;
+
+  W.write_u32(brush_id);
+  W.write_u32(stroke_id);
+  W.write_u32(path_id);
+  W.write_u32(flags);
+  W.write_u32(cp);
+  W.write_u32(js);
+  d->write_record(op_stroke_path, W);
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+draw_convex_polygon(const PainterData &draw, const_c_array<vec2> pts)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+  uint32_t brush_id;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(!d->m_in_frame)
+    {
+      return;
+    }
+
+  brush_id = d->brush_id(draw);
+  W.write_u32(brush_id);
+  W.write_u32(pts.size());
+  W.write_pod_array(pts);
+  d->write_record(op_draw_convex_polygon, W);
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+draw_quads(const PainterData &draw, const_c_array<vec2> pts)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+  uint32_t brush_id;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(!d->m_in_frame)
+    {
+      return;
+    }
+
+  brush_id = d->brush_id(draw);
+  W.write_u32(brush_id);
+  W.write_u32(pts.size());
+  W.write_pod_array(pts);
+  d->write_record(op_draw_quads, W);
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+draw_glyph_runs(const PainterData &draw, const_c_array<const GlyphRun*> runs,
+                bool use_anistopic_antialias)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+  std::vector<uint32_t> run_ids;
+  uint32_t brush_id;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(!d->m_in_frame)
+    {
+      return;
+    }
+
+  brush_id = d->brush_id(draw);
+  for(unsigned int i = 0; i < runs.size(); ++i)
+    {
+      if(runs[i])
+        {
+          run_ids.push_back(d->glyph_run_id(*runs[i]));
+        }
+    }
+
+  W.write_u32(brush_id);
+  W.write_bool(use_anistopic_antialias);
+  W.write_u32(run_ids.size());
+  W.write_pod_array<uint32_t>(make_c_array(run_ids));
+  d->write_record(op_draw_glyph_runs, W);
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+begin_layer(const vec2 &xy, const vec2 &wh, float opacity)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      W.write_vec2(xy);
+      W.write_vec2(wh);
+      W.write_float(opacity);
+      d->write_record(op_begin_layer, W);
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+end_layer(void)
+{
+  PainterTraceRecorderPrivate *d;
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      d->write_record(op_end_layer);
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+end_layer_blurred(float radius)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      W.write_float(radius);
+      d->write_record(op_end_layer_blurred, W);
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+end_layer_drop_shadow(float radius, const vec2 &offset, const vec4 &color)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      W.write_float(radius);
+      W.write_vec2(offset);
+      for(unsigned int i = 0; i < 4; ++i)
+        {
+          W.write_float(color[i]);
+        }
+      d->write_record(op_end_layer_drop_shadow, W);
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+begin_recording(const reference_counted_ptr<PainterPackerStream> &stream)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      W.write_u32(d->stream_id(stream.get()));
+      d->write_record(op_begin_recording, W);
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+end_recording(void)
+{
+  PainterTraceRecorderPrivate *d;
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      d->write_record(op_end_recording);
+    }
+}
+
+void
+fastuidraw::PainterTraceRecorder::
+draw_stream(const PainterPackerStream &stream, bool use_current_state)
+{
+  PainterTraceRecorderPrivate *d;
+  detail::BlobWriter W;
+
+  d = static_cast<PainterTraceRecorderPrivate*>(m_d);
+  if(d->m_in_frame)
+    {
+      W.write_u32(d->stream_id(&stream));
+      W.write_bool(use_current_state);
+      d->write_record(op_draw_stream, W);
+    }
+}
+
+///////////////////////////////////////////
+// fastuidraw::PainterTracePlayer methods
+fastuidraw::PainterTracePlayer::
+PainterTracePlayer(const_c_array<uint8_t> blob,
+                   const reference_counted_ptr<ResourceProvider> &provider)
+{
+  assert(provider);
+  m_d = FASTUIDRAWnew PainterTracePlayerPrivate(blob, provider);
+}
+
+fastuidraw::PainterTracePlayer::
+~PainterTracePlayer()
+{
+  PainterTracePlayerPrivate *d;
+  d = static_cast<PainterTracePlayerPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+bool
+fastuidraw::PainterTracePlayer::
+valid(void) const
+{
+  PainterTracePlayerPrivate *d;
+  d = static_cast<PainterTracePlayerPrivate*>(m_d);
+  return d->m_valid;
+}
+
+unsigned int
+fastuidraw::PainterTracePlayer::
+number_frames(void) const
+{
+  PainterTracePlayerPrivate *d;
+  d = static_cast<PainterTracePlayerPrivate*>(m_d);
+  return d->m_frames.size();
+}
+
+fastuidraw::ivec2
+fastuidraw::PainterTracePlayer::
+frame_resolution(unsigned int frame) const
+{
+  PainterTracePlayerPrivate *d;
+  d = static_cast<PainterTracePlayerPrivate*>(m_d);
+  assert(frame < d->m_frames.size());
+  return d->m_frames[frame].m_resolution;
+}
+
+void
+fastuidraw::PainterTracePlayer::
+replay_frame(unsigned int frame, Painter &painter)
+{
+  PainterTracePlayerPrivate *d;
+  d = static_cast<PainterTracePlayerPrivate*>(m_d);
+  assert(frame < d->m_frames.size());
+
+  const ::frame &F(d->m_frames[frame]);
+  for(unsigned int r = F.m_begin; r <= F.m_end; ++r)
+    {
+      d->replay_record(d->m_records[r], painter);
+    }
+}
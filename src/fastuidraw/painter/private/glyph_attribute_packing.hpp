@@ -0,0 +1,174 @@
+/*!
+ * \file glyph_attribute_packing.hpp
+ * \brief file glyph_attribute_packing.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/painter/painter_attribute.hpp>
+#include <fastuidraw/painter/painter_enums.hpp>
+#include <fastuidraw/text/glyph.hpp>
+
+/* Packing of the attributes and indices of a single glyph,
+   shared by PainterAttributeDataFillerGlyphs and GlyphRun.
+ */
+namespace fastuidraw { namespace detail {
+
+  inline
+  uint32_t
+  filter_atlas_layer(int layer)
+  {
+    assert(layer >= -1);
+    return (layer != -1) ? static_cast<uint32_t>(layer) : ~0u;
+  }
+
+  inline
+  void
+  pack_glyph_indices(c_array<PainterIndex> dst, unsigned int aa)
+  {
+    assert(dst.size() == 6);
+    dst[0] = aa;
+    dst[1] = aa + 1;
+    dst[2] = aa + 2;
+    dst[3] = aa;
+    dst[4] = aa + 2;
+    dst[5] = aa + 3;
+  }
+
+  /* Pack a glyph as a single instance, the format read by
+     fastuidraw_painter_glyph_instance.vert.glsl:
+       - m_attrib0.xy -> bottom left texel in primary atlas
+       - m_attrib0.zw -> bottom left texel in secondary atlas
+       - m_attrib1.xy -> bottom left position
+       - m_attrib1.zw -> top right position
+       - m_attrib2.x  -> texel size, x in low 16 bits, y in high 16 bits
+       - m_attrib2.y  -> geometry offset
+       - m_attrib2.z  -> layer in primary atlas
+       - m_attrib2.w  -> layer in secondary atlas
+   */
+  inline
+  void
+  pack_glyph_instance(enum PainterEnums::glyph_orientation orientation,
+                      vec2 p, Glyph glyph, float SCALE,
+                      PainterAttribute &dst)
+  {
+    assert(glyph.valid());
+
+    GlyphLocation atlas(glyph.atlas_location());
+    GlyphLocation secondary_atlas(glyph.secondary_atlas_location());
+    ivec2 tex_size(atlas.size());
+    vec2 t_bl(atlas.location());
+    vec2 t2_bl(secondary_atlas.location());
+    vec2 glyph_size(SCALE * glyph.layout().m_size);
+    vec2 p_bl, p_tr;
+
+    /* ISSUE: we are assuming horizontal layout; we should probably
+       change the inteface so that caller chooses how to adjust
+       positions with the choices:
+         adjust_using_horizontal,
+         adjust_using_vertical,
+         no_adjust
+     */
+    if(orientation == PainterEnums::y_increases_downwards)
+      {
+        p_bl.x() = p.x() + SCALE * glyph.layout().m_horizontal_layout_offset.x();
+        p_tr.x() = p_bl.x() + glyph_size.x();
+
+        p_bl.y() = p.y() - SCALE * glyph.layout().m_horizontal_layout_offset.y();
+        p_tr.y() = p_bl.y() - glyph_size.y();
+      }
+    else
+      {
+        p_bl = p + SCALE * glyph.layout().m_horizontal_layout_offset;
+        p_tr = p_bl + glyph_size;
+      }
+
+    assert(tex_size.x() >= 0 && tex_size.x() <= 0xFFFF);
+    assert(tex_size.y() >= 0 && tex_size.y() <= 0xFFFF);
+
+    /* secondary_atlas.layer() can be -1 to indicate that
+       the glyph does not have secondary atlas, when changed
+       to an unsigned value it is ungood, to compensate we
+       will "do something".
+     */
+    dst.m_attrib0 = pack_vec4(t_bl.x(), t_bl.y(), t2_bl.x(), t2_bl.y());
+    dst.m_attrib1 = pack_vec4(p_bl.x(), p_bl.y(), p_tr.x(), p_tr.y());
+    dst.m_attrib2.x() = uint32_t(tex_size.x()) | (uint32_t(tex_size.y()) << 16u);
+    dst.m_attrib2.y() = glyph.geometry_offset();
+    dst.m_attrib2.z() = filter_atlas_layer(atlas.layer());
+    dst.m_attrib2.w() = filter_atlas_layer(secondary_atlas.layer());
+  }
+
+  /* Expand an instance packed by pack_glyph_instance() to the four
+     vertices of its quad, in the order used by pack_glyph_indices();
+     the vertex with index k is the corner that the instance vertex
+     shader computes for gl_VertexID == k.
+   */
+  inline
+  void
+  expand_glyph_instance(const PainterAttribute &instance,
+                        c_array<PainterAttribute> dst)
+  {
+    assert(dst.size() == 4);
+
+    float t_blx, t_bly, t2_blx, t2_bly, p_blx, p_bly, p_trx, p_try;
+    float szx, szy;
+    uvec4 uint_values(instance.m_attrib2);
+
+    t_blx = unpack_float(instance.m_attrib0.x());
+    t_bly = unpack_float(instance.m_attrib0.y());
+    t2_blx = unpack_float(instance.m_attrib0.z());
+    t2_bly = unpack_float(instance.m_attrib0.w());
+    p_blx = unpack_float(instance.m_attrib1.x());
+    p_bly = unpack_float(instance.m_attrib1.y());
+    p_trx = unpack_float(instance.m_attrib1.z());
+    p_try = unpack_float(instance.m_attrib1.w());
+    szx = static_cast<float>(uint_values.x() & 0xFFFFu);
+    szy = static_cast<float>(uint_values.x() >> 16u);
+    uint_values.x() = 0u;
+
+    dst[0].m_attrib0 = pack_vec4(t_blx, t_bly, t2_blx, t2_bly);
+    dst[0].m_attrib1 = pack_vec4(p_blx, p_bly, 0.0f, 0.0f);
+    dst[0].m_attrib2 = uint_values;
+
+    dst[1].m_attrib0 = pack_vec4(t_blx + szx, t_bly, t2_blx + szx, t2_bly);
+    dst[1].m_attrib1 = pack_vec4(p_trx, p_bly, 0.0f, 0.0f);
+    dst[1].m_attrib2 = uint_values;
+
+    dst[2].m_attrib0 = pack_vec4(t_blx + szx, t_bly + szy, t2_blx + szx, t2_bly + szy);
+    dst[2].m_attrib1 = pack_vec4(p_trx, p_try, 0.0f, 0.0f);
+    dst[2].m_attrib2 = uint_values;
+
+    dst[3].m_attrib0 = pack_vec4(t_blx, t_bly + szy, t2_blx, t2_bly + szy);
+    dst[3].m_attrib1 = pack_vec4(p_blx, p_try, 0.0f, 0.0f);
+    dst[3].m_attrib2 = uint_values;
+  }
+
+  inline
+  void
+  pack_glyph_attributes(enum PainterEnums::glyph_orientation orientation,
+                        vec2 p, Glyph glyph, float SCALE,
+                        c_array<PainterAttribute> dst)
+  {
+    PainterAttribute instance;
+
+    pack_glyph_instance(orientation, p, glyph, SCALE, instance);
+    expand_glyph_instance(instance, dst);
+  }
+
+} //namespace detail
+} //namespace fastuidraw
@@ -19,6 +19,8 @@
 
 #include <vector>
 #include <complex>
+#include <algorithm>
+#include <limits>
 
 #include <fastuidraw/tessellated_path.hpp>
 #include <fastuidraw/path.hpp>
@@ -27,8 +29,10 @@
 #include <fastuidraw/painter/painter_attribute_data_filler.hpp>
 #include "../private/util_private.hpp"
 #include "../private/bounding_box.hpp"
+#include "../private/blob_private.hpp"
 #include "../private/path_util_private.hpp"
 #include "../private/clip.hpp"
+#include "../private/culling_boxes.hpp"
 
 namespace
 {
@@ -66,6 +70,305 @@ namespace
       }
   }
 
+  bool
+  box_contains(const fastuidraw::BoundingBox &b, const fastuidraw::vec2 &pt, float room)
+  {
+    return !b.empty()
+      && pt.x() >= b.min_point().x() - room && pt.x() <= b.max_point().x() + room
+      && pt.y() >= b.min_point().y() - room && pt.y() <= b.max_point().y() + room;
+  }
+
+  bool
+  triangle_contains(const fastuidraw::vec2 &a, const fastuidraw::vec2 &b,
+                    const fastuidraw::vec2 &c, const fastuidraw::vec2 &p)
+  {
+    float d0, d1, d2;
+    bool has_neg, has_pos;
+
+    d0 = (b.x() - a.x()) * (p.y() - a.y()) - (b.y() - a.y()) * (p.x() - a.x());
+    d1 = (c.x() - b.x()) * (p.y() - b.y()) - (c.y() - b.y()) * (p.x() - b.x());
+    d2 = (a.x() - c.x()) * (p.y() - c.y()) - (a.y() - c.y()) * (p.x() - c.x());
+    has_neg = (d0 < 0.0f) || (d1 < 0.0f) || (d2 < 0.0f);
+    has_pos = (d0 > 0.0f) || (d1 > 0.0f) || (d2 > 0.0f);
+    return !(has_neg && has_pos);
+  }
+
+  /* the offset of a point as computed by
+     fastuidraw_stroke_compute_offset() of the
+     stroke vertex shader.
+   */
+  fastuidraw::vec2
+  stroke_offset(const fastuidraw::StrokedPath::point &pt, float miter_limit)
+  {
+    if(pt.offset_type() == fastuidraw::StrokedPath::offset_miter_join)
+      {
+        fastuidraw::vec2 n(pt.m_pre_offset), v(-n.y(), n.x());
+        float r, numer, denom, lambda;
+
+        lambda = (fastuidraw::dot(v, pt.m_auxilary_offset) > 0.0f) ? -1.0f : 1.0f;
+        numer = fastuidraw::dot(pt.m_pre_offset, pt.m_auxilary_offset) - 1.0f;
+        denom = fastuidraw::dot(v, pt.m_auxilary_offset);
+        r = (denom != 0.0f) ? numer / denom : 0.0f;
+        if(miter_limit >= 0.0f)
+          {
+            r = fastuidraw::t_max(-miter_limit, fastuidraw::t_min(miter_limit, r));
+          }
+        return lambda * (n - r * v);
+      }
+
+    fastuidraw::StrokedPath::point q(pt);
+    return q.offset_vector();
+  }
+
+  /* returns true if pt is in a triangle of the named chunk
+     of data with the points of the chunk offset by the
+     stroking radius.
+   */
+  bool
+  stroked_chunk_contains(const fastuidraw::PainterAttributeData &data,
+                         unsigned int chunk, const fastuidraw::vec2 &pt,
+                         float radius, float miter_limit,
+                         std::vector<fastuidraw::vec2> &positions)
+  {
+    fastuidraw::const_c_array<fastuidraw::PainterAttribute> attribs;
+    fastuidraw::const_c_array<fastuidraw::PainterIndex> indices;
+    int adjust;
+
+    attribs = data.attribute_data_chunk(chunk);
+    indices = data.index_data_chunk(chunk);
+    adjust = data.index_adjust_chunk(chunk);
+
+    positions.resize(attribs.size());
+    for(unsigned int i = 0; i < attribs.size(); ++i)
+      {
+        fastuidraw::StrokedPath::point P;
+
+        fastuidraw::StrokedPath::point::unpack_point(&P, attribs[i]);
+        positions[i] = P.m_position + radius * stroke_offset(P, miter_limit);
+      }
+
+    for(unsigned int i = 0; i + 2 < indices.size(); i += 3)
+      {
+        if(triangle_contains(positions[int(indices[i]) + adjust],
+                             positions[int(indices[i + 1]) + adjust],
+                             positions[int(indices[i + 2]) + adjust],
+                             pt))
+          {
+            return true;
+          }
+      }
+    return false;
+  }
+
+  /* returns true if pt is within radius of the position of
+     a point of the named chunk of data; used for rounded
+     joins and caps with the data of the bevel joins and of
+     the square caps whose points are all at the position of
+     their join or cap.
+   */
+  bool
+  chunk_point_within(const fastuidraw::PainterAttributeData &data,
+                     unsigned int chunk, const fastuidraw::vec2 &pt,
+                     float radius)
+  {
+    fastuidraw::const_c_array<fastuidraw::PainterAttribute> attribs;
+
+    attribs = data.attribute_data_chunk(chunk);
+    for(unsigned int i = 0; i < attribs.size(); ++i)
+      {
+        fastuidraw::StrokedPath::point P;
+
+        fastuidraw::StrokedPath::point::unpack_point(&P, attribs[i]);
+        if(fastuidraw::magnitudeSq(P.m_position - pt) <= radius * radius)
+          {
+            return true;
+          }
+      }
+    return false;
+  }
+
+  class ScratchSpacePrivate
+  {
+  public:
+    std::vector<fastuidraw::vec3> m_adjusted_clip_eqs;
+    std::vector<fastuidraw::vec2> m_clipped_rect;
+
+    fastuidraw::vecN<std::vector<fastuidraw::vec2>, 2> m_clip_scratch_vec2s;
+    std::vector<float> m_clip_scratch_floats;
+
+    /* chunks and stroked positions of the points of a
+       chunk for StrokedPath::hit_test().
+     */
+    std::vector<unsigned int> m_hit_chunks;
+    std::vector<fastuidraw::vec2> m_hit_positions;
+  };
+
+  /* ChunkCullingHierarchy holds a hierarchy of chunks of a
+     PainterAttributeData in arrays ordered depth-first: the
+     first child of element i is element i + 1 and the
+     elements below i are those in [i + 1, m_skip[i]). Each
+     element has two chunks: the chunk of the data of the
+     element alone and the chunk of the data of the element
+     together with all elements below it. Selecting chunks is
+     then a forward scan over the arrays that jumps ahead to
+     m_skip[i] to skip the elements below i.
+
+     The bounding boxes are stored as separate arrays of the
+     coordinates and are classified against the clip equations
+     block_size elements at a time, looking only at the box
+     corners nearest and farthest along the normal of each
+     equation; only a box that crosses a clip equation is
+     clipped exactly with detail::clip_against_planes().
+   */
+  class ChunkCullingHierarchy
+  {
+  public:
+    enum
+      {
+        block_size = fastuidraw::detail::CullingBoxes::block_size
+      };
+
+    class Element
+    {
+    public:
+      /* an element whose m_bb is empty has no data of its own
+         and m_chunk is not taken.
+       */
+      fastuidraw::BoundingBox m_bb, m_bb_with_children;
+      unsigned int m_chunk, m_chunk_with_children;
+    };
+
+    /* add an element as the next element in depth-first
+       order, returns the index of the element. The elements
+       below it are those added before end_element() is called
+       with the returned index.
+     */
+    unsigned int
+    begin_element(const Element &element);
+
+    void
+    end_element(unsigned int i);
+
+    /* call once all elements are added.
+     */
+    void
+    finalize(void);
+
+    unsigned int
+    number_elements(void) const
+    {
+      return m_elements.size();
+    }
+
+    /* the sizes of the chunks are checked against max_attribute_cnt
+       and max_index_cnt from data.
+     */
+    unsigned int
+    select_chunks(ScratchSpacePrivate &scratch,
+                  const fastuidraw::PainterAttributeData &data,
+                  fastuidraw::const_c_array<fastuidraw::vec3> clip_equations,
+                  const fastuidraw::float3x3 &clip_matrix_local,
+                  const fastuidraw::vec2 &recip_dimensions,
+                  float pixels_additional_room,
+                  float item_space_additional_room,
+                  unsigned int max_attribute_cnt,
+                  unsigned int max_index_cnt,
+                  fastuidraw::c_array<unsigned int> dst) const;
+
+    /* adds to dst the chunk of each element whose own
+       data has a bounding box that, inflated by room,
+       contains pt.
+     */
+    void
+    chunks_containing(const fastuidraw::vec2 &pt, float room,
+                      std::vector<unsigned int> &dst) const;
+
+  private:
+    typedef fastuidraw::detail::CullingBoxes Boxes;
+
+    void
+    take_all(unsigned int i,
+             const fastuidraw::PainterAttributeData &data,
+             unsigned int max_attribute_cnt,
+             unsigned int max_index_cnt,
+             fastuidraw::c_array<unsigned int> dst,
+             unsigned int &current) const;
+
+    std::vector<Element> m_elements;
+    std::vector<unsigned int> m_skip;
+    Boxes m_boxes, m_boxes_with_children;
+  };
+
+  /* ItemCullingHierarchy splits the sequence of joins or caps
+     of a StrokedPath into a hierarchy of ranges of consecutive
+     items, each range having its own chunk in the PainterAttributeData
+     of the items. Consecutive items are typically along the same
+     contour and so near each other.
+   */
+  class ItemCullingHierarchy
+  {
+  public:
+    enum
+      {
+        items_per_leaf = 16
+      };
+
+    ItemCullingHierarchy(void):
+      m_first_chunk(0)
+    {}
+
+    /* set the hierarchy from the bounding box of each
+       item, the chunks of the ranges are numbered
+       starting at first_chunk.
+     */
+    void
+    set(fastuidraw::const_c_array<fastuidraw::BoundingBox> item_boxes,
+        unsigned int first_chunk);
+
+    unsigned int
+    number_chunks(void) const
+    {
+      return m_ranges.size();
+    }
+
+    /* one past the last chunk of the ranges
+     */
+    unsigned int
+    end_chunk(void) const
+    {
+      return m_first_chunk + m_ranges.size();
+    }
+
+    /* set the chunks of the ranges from where the data of each
+       item starts: the attributes of item i are those in
+       [vertex_starts[i], vertex_starts[i + 1]) and the
+       indices are those in [index_starts[i], index_starts[i + 1]).
+     */
+    void
+    fill_chunks(fastuidraw::const_c_array<unsigned int> vertex_starts,
+                fastuidraw::const_c_array<unsigned int> index_starts,
+                fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+                fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
+                fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
+                fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+                fastuidraw::c_array<int> index_adjusts) const;
+
+    const ChunkCullingHierarchy&
+    culler(void) const
+    {
+      return m_culler;
+    }
+
+  private:
+    void
+    create(fastuidraw::const_c_array<fastuidraw::BoundingBox> item_boxes,
+           fastuidraw::range_type<unsigned int> R);
+
+    unsigned int m_first_chunk;
+    std::vector<fastuidraw::range_type<unsigned int> > m_ranges;
+    ChunkCullingHierarchy m_culler;
+  };
+
   class PerEdgeData
   {
   public:
@@ -112,13 +415,28 @@ namespace
       return m_per_contour_data[C].m_edge_data_store.size();
     }
 
+    /* set m_join_hierarchy and m_cap_hierarchy from
+       m_per_contour_data.
+     */
+    void
+    ready_culling_hierarchies(void);
+
     std::vector<PerContourData> m_per_contour_data;
+
+    /* m_join_hierarchy[0] is of the joins without those of the
+       closing edges and m_join_hierarchy[1] is of all joins; the
+       chunks of both follow the chunks of the individual joins.
+       The chunks of m_cap_hierarchy follow chunk 0 of all caps.
+     */
+    fastuidraw::vecN<ItemCullingHierarchy, 2> m_join_hierarchy;
+    ItemCullingHierarchy m_cap_hierarchy;
   };
 
   class SingleSubEdge
   {
   public:
-    unsigned int m_pt0, m_pt1; //index into TessellatedPath::points
+    unsigned int m_contour, m_edge; //edge of the TessellatedPath of the sub-edge
+    unsigned int m_pt0, m_pt1; //index into TessellatedPath::point_positions()
     fastuidraw::vec2 m_normal, m_delta;
 
     bool m_has_bevel;
@@ -175,7 +493,7 @@ namespace
     explicit
     SubEdgeCullingHierarchy(const fastuidraw::BoundingBox &start_box,
                             fastuidraw::const_c_array<SingleSubEdge> data,
-                            fastuidraw::const_c_array<fastuidraw::TessellatedPath::point> src_pts);
+                            fastuidraw::const_c_array<fastuidraw::vec2> src_pts);
 
     ~SubEdgeCullingHierarchy();
 
@@ -187,22 +505,12 @@ namespace
     int
     choose_splitting_coordinate(const fastuidraw::BoundingBox &start_box,
                                 fastuidraw::const_c_array<SingleSubEdge> data,
-                                fastuidraw::const_c_array<fastuidraw::TessellatedPath::point> src_pts);
+                                fastuidraw::const_c_array<fastuidraw::vec2> src_pts);
 
     SubEdgeCullingHierarchy*
     create(const fastuidraw::BoundingBox &start_box,
            const std::vector<SingleSubEdge> &data,
-           fastuidraw::const_c_array<fastuidraw::TessellatedPath::point> src_pts);
-  };
-
-  class ScratchSpacePrivate
-  {
-  public:
-    std::vector<fastuidraw::vec3> m_adjusted_clip_eqs;
-    std::vector<fastuidraw::vec2> m_clipped_rect;
-
-    fastuidraw::vecN<std::vector<fastuidraw::vec2>, 2> m_clip_scratch_vec2s;
-    std::vector<float> m_clip_scratch_floats;
+           fastuidraw::const_c_array<fastuidraw::vec2> src_pts);
   };
 
   class EdgesElement
@@ -213,28 +521,50 @@ namespace
         points_per_segment = 6,
         triangles_per_segment = points_per_segment - 2,
         indices_per_segment_without_bevel = 3 * triangles_per_segment,
+
+        compact_points_per_segment = 4,
+        compact_triangles_per_segment = compact_points_per_segment - 2,
+        compact_indices_per_segment_without_bevel = 3 * compact_triangles_per_segment,
       };
 
     static
     EdgesElement*
-    create(SubEdgeCullingHierarchy *src)
+    create(SubEdgeCullingHierarchy *src, bool compact)
     {
       unsigned int total_chunks(0);
-      return FASTUIDRAWnew EdgesElement(0, 0, src, total_chunks, 0);
+      return FASTUIDRAWnew EdgesElement(0, 0, src, compact, total_chunks, 0);
     }
 
+    /* read an EdgesElement and its descendants written
+       by write_to_blob(), returns NULL if the blob
+       is malformed.
+     */
+    static
+    EdgesElement*
+    create_from_blob(fastuidraw::detail::BlobReader &src);
+
+    /* returns true if the chunks of this EdgesElement and its
+       descendants are chunks of data whose sizes match the
+       ranges and if the ranges of each element are within
+       those of its parent; used to reject a malformed blob.
+     */
+    bool
+    consistent_with(const fastuidraw::PainterAttributeData &data) const;
+
+    /* write this EdgesElement and its descendants, the
+       fields m_data_src are not written since they are
+       only used to fill the PainterAttributeData.
+     */
+    void
+    write_to_blob(fastuidraw::detail::BlobWriter &dst) const;
+
     ~EdgesElement();
 
-    unsigned int
-    edge_chunks(ScratchSpacePrivate &work_room,
-                fastuidraw::const_c_array<fastuidraw::vec3> clip_equations,
-                const fastuidraw::float3x3 &clip_matrix_local,
-                const fastuidraw::vec2 &recip_dimensions,
-                float pixels_additional_room,
-                float item_space_additional_room,
-                unsigned int max_attribute_cnt,
-                unsigned int max_index_cnt,
-                fastuidraw::c_array<unsigned int> dst);
+    /* add this EdgesElement and its descendants to a
+       ChunkCullingHierarchy in depth-first order.
+     */
+    void
+    flatten(ChunkCullingHierarchy &dst) const;
 
     unsigned int
     maximum_edge_chunks(void)
@@ -244,7 +574,7 @@ namespace
 
     static
     void
-    count_vertices_indices(SubEdgeCullingHierarchy *src,
+    count_vertices_indices(SubEdgeCullingHierarchy *src, bool compact,
                            unsigned int &vertex_cnt,
                            unsigned int &index_cnt,
                            unsigned int &depth_cnt);
@@ -266,22 +596,12 @@ namespace
 
   private:
     EdgesElement(unsigned int vertex_st, unsigned int index_st,
-                 SubEdgeCullingHierarchy *src, unsigned int &total_chunks,
-                 unsigned int depth);
+                 SubEdgeCullingHierarchy *src, bool compact,
+                 unsigned int &total_chunks, unsigned int depth);
 
-    void
-    edge_chunks_implement(ScratchSpacePrivate &work_room,
-                          float item_space_additional_room,
-                          unsigned int max_attribute_cnt,
-                          unsigned int max_index_cnt,
-                          fastuidraw::c_array<unsigned int> dst,
-                          unsigned int &current);
-
-    void
-    edge_chunks_take_all(unsigned int max_attribute_cnt,
-                         unsigned int max_index_cnt,
-                         fastuidraw::c_array<unsigned int> dst,
-                         unsigned int &current);
+    EdgesElement(void):
+      m_children(NULL, NULL)
+    {}
   };
 
   class EdgesElementFiller:public fastuidraw::PainterAttributeDataFiller
@@ -289,7 +609,8 @@ namespace
   public:
     explicit
     EdgesElementFiller(EdgesElement *src,
-                       const fastuidraw::TessellatedPath &P);
+                       const fastuidraw::TessellatedPath &P,
+                       bool compact);
 
     virtual
     void
@@ -307,22 +628,132 @@ namespace
               fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
               fastuidraw::c_array<unsigned int> zincrements,
               fastuidraw::c_array<int> index_adjusts) const;
+
+    virtual
+    unsigned int
+    number_fill_jobs(void) const
+    {
+      return m_elements.size();
+    }
+
+    /* each EdgesElement is a job, its vertices, indices
+       and chunks are disjoint from those of any other
+       EdgesElement.
+     */
+    virtual
+    void
+    fill_job(unsigned int job,
+             fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+             fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
+             fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
+             fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+             fastuidraw::c_array<unsigned int> zincrements,
+             fastuidraw::c_array<int> index_adjusts) const;
   private:
     void
-    fill_data_worker(EdgesElement *e,
-                     fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
-                     fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
-                     fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
-                     fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
-                     fastuidraw::c_array<int> index_adjusts) const;
+    add_elements(EdgesElement *e);
+
     void
     process_sub_edge(const SingleSubEdge &sub_edge, unsigned int depth,
                      fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
                      fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
                      unsigned int &vertex_offset, unsigned int &index_offset) const;
 
+    void
+    process_compact_sub_edge(const SingleSubEdge &sub_edge, unsigned int depth,
+                             fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+                             fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
+                             unsigned int &vertex_offset, unsigned int &index_offset) const;
+
     EdgesElement *m_src;
     const fastuidraw::TessellatedPath &m_P;
+    bool m_compact;
+    std::vector<EdgesElement*> m_elements;
+  };
+
+  /* Makes the data of StrokedPath::dashed_edges() from the
+     data made by EdgesElementFiller: each sub-edge quad is
+     split at the points within a margin of the boundaries
+     of the dash pattern and those pieces that are in a gap
+     of the dash pattern are dropped. The chunks are the
+     same as those of the source data so that the same
+     ChunkCullingHierarchy is used to select them. Since
+     the number of pieces is only known after splitting,
+     the data is made in the ctor.
+   */
+  class DashedEdgesFiller:public fastuidraw::PainterAttributeDataFiller
+  {
+  public:
+    DashedEdgesFiller(const EdgesElement *src,
+                      const fastuidraw::PainterAttributeData &src_data,
+                      bool compact,
+                      fastuidraw::const_c_array<fastuidraw::range_type<float> > draw_intervals,
+                      float period, float margin);
+
+    virtual
+    void
+    compute_sizes(unsigned int &num_attributes,
+                  unsigned int &num_indices,
+                  unsigned int &num_attribute_chunks,
+                  unsigned int &num_index_chunks,
+                  unsigned int &number_z_increments) const;
+
+    virtual
+    void
+    fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+              fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
+              fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
+              fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+              fastuidraw::c_array<unsigned int> zincrements,
+              fastuidraw::c_array<int> index_adjusts) const;
+
+  private:
+    enum
+      {
+        /* a sub-edge that would need more cuts than this
+           is not split.
+         */
+        max_cuts_per_sub_edge = 1024,
+
+        /* a sub-edge is only split if its pieces are on
+           average at least this many times the margin long,
+           otherwise the added vertices cost more than the
+           fragments saved.
+         */
+        min_piece_length_in_margins = 8
+      };
+
+    enum piece_t
+      {
+        gap_piece,
+        boundary_piece,
+        interior_piece,
+      };
+
+    void
+    process_element(const EdgesElement *e);
+
+    void
+    process_sub_edge(fastuidraw::const_c_array<fastuidraw::PainterAttribute> quad);
+
+    void
+    add_piece(fastuidraw::const_c_array<fastuidraw::PainterAttribute> quad,
+              float t0, float t1);
+
+    enum piece_t
+    classify(float distance) const;
+
+    const fastuidraw::PainterAttributeData &m_src_data;
+    unsigned int m_points_per_segment;
+    fastuidraw::const_c_array<unsigned int> m_quad_indices;
+    fastuidraw::const_c_array<fastuidraw::range_type<float> > m_intervals;
+    float m_period, m_margin;
+
+    std::vector<float> m_cuts;
+    std::vector<fastuidraw::PainterAttribute> m_attribs;
+    std::vector<fastuidraw::PainterIndex> m_indices;
+    std::vector<fastuidraw::range_type<unsigned int> > m_attrib_ranges;
+    std::vector<fastuidraw::range_type<unsigned int> > m_index_ranges;
   };
 
   class JoinCount
@@ -362,6 +793,13 @@ namespace
     compute_lambda(const fastuidraw::vec2 &n0, const fastuidraw::vec2 &n1);
   };
 
+  /* The per-join work, add_join() and fill_join_implement(),
+     is implemented by the class T deriving from JoinCreatorBase<T>
+     and called statically, so the loops over the joins of a path
+     do not make a virtual call per join and the join generation
+     can be inlined into them.
+   */
+  template<typename T>
   class JoinCreatorBase:public fastuidraw::PainterAttributeDataFiller
   {
   public:
@@ -388,22 +826,32 @@ namespace
               fastuidraw::c_array<unsigned int> zincrements,
               fastuidraw::c_array<int> index_adjusts) const;
 
-  protected:
+    virtual
+    unsigned int
+    number_fill_jobs(void) const
+    {
+      return m_num_joins;
+    }
 
+    /* each join is a job, the location of its data is
+       given by m_vertex_starts and m_index_starts
+     */
+    virtual
     void
-    post_ctor_initalize(void);
+    fill_job(unsigned int job,
+             fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+             fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
+             fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
+             fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+             fastuidraw::c_array<unsigned int> zincrements,
+             fastuidraw::c_array<int> index_adjusts) const;
 
-  private:
+  protected:
 
-    virtual
     void
-    add_join(unsigned int join_id,
-             const PathData &path,
-             const fastuidraw::vec2 &n0_from_stroking,
-             const fastuidraw::vec2 &n1_from_stroking,
-             unsigned int contour, unsigned int edge,
-             unsigned int &vert_count, unsigned int &index_count) const = 0;
+    post_ctor_initalize(void);
 
+  private:
 
     void
     fill_join(unsigned int join_id,
@@ -415,30 +863,35 @@ namespace
               fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
               fastuidraw::c_array<int> index_adjusts) const;
 
-    virtual
     void
-    fill_join_implement(unsigned int join_id,
-                        const PathData &path,
-                        unsigned int contour, unsigned int edge,
-                        fastuidraw::c_array<fastuidraw::PainterAttribute> pts,
-                        unsigned int depth,
-                        fastuidraw::c_array<unsigned int> indices,
-                        unsigned int &vertex_offset, unsigned int &index_offset) const = 0;
+    add_join_start(unsigned int contour, unsigned int edge);
 
     const PathData &m_P;
     unsigned int m_num_non_closed_verts, m_num_non_closed_indices;
     unsigned int m_num_closed_verts, m_num_closed_indices;
     unsigned int m_num_joins;
     bool m_post_ctor_initalized_called;
+
+    /* the join J has its vertices in the range
+       [m_vertex_starts[J], m_vertex_starts[J + 1])
+       and its indices in the range
+       [m_index_starts[J], m_index_starts[J + 1]);
+       the contour and edge of the join J are
+       m_join_contour_edge[J].
+     */
+    std::vector<unsigned int> m_vertex_starts, m_index_starts;
+    std::vector<fastuidraw::uvec2> m_join_contour_edge;
   };
 
 
-  class RoundedJoinCreator:public JoinCreatorBase
+  class RoundedJoinCreator:public JoinCreatorBase<RoundedJoinCreator>
   {
   public:
     RoundedJoinCreator(const PathData &P, float thresh);
 
   private:
+    friend class JoinCreatorBase<RoundedJoinCreator>;
+
 
     class PerJoinData:public CommonJoinData
     {
@@ -461,7 +914,6 @@ namespace
       unsigned int m_num_arc_points;
     };
 
-    virtual
     void
     add_join(unsigned int join_id,
              const PathData &path,
@@ -470,7 +922,6 @@ namespace
              unsigned int contour, unsigned int edge,
              unsigned int &vert_count, unsigned int &index_count) const;
 
-    virtual
     void
     fill_join_implement(unsigned int join_id,
                         const PathData &path,
@@ -484,15 +935,16 @@ namespace
     mutable std::vector<PerJoinData> m_per_join_data;
   };
 
-  class BevelJoinCreator:public JoinCreatorBase
+  class BevelJoinCreator:public JoinCreatorBase<BevelJoinCreator>
   {
   public:
     explicit
     BevelJoinCreator(const PathData &P);
 
   private:
+    friend class JoinCreatorBase<BevelJoinCreator>;
+
 
-    virtual
     void
     add_join(unsigned int join_id,
              const PathData &path,
@@ -501,7 +953,6 @@ namespace
              unsigned int contour, unsigned int edge,
              unsigned int &vert_count, unsigned int &index_count) const;
 
-    virtual
     void
     fill_join_implement(unsigned int join_id,
                         const PathData &path,
@@ -514,14 +965,15 @@ namespace
     mutable std::vector<fastuidraw::vec2> m_n0, m_n1;
   };
 
-  class MiterJoinCreator:public JoinCreatorBase
+  class MiterJoinCreator:public JoinCreatorBase<MiterJoinCreator>
   {
   public:
     explicit
     MiterJoinCreator(const PathData &P);
 
   private:
-    virtual
+    friend class JoinCreatorBase<MiterJoinCreator>;
+
     void
     add_join(unsigned int join_id,
              const PathData &path,
@@ -530,7 +982,6 @@ namespace
              unsigned int contour, unsigned int edge,
              unsigned int &vert_count, unsigned int &index_count) const;
 
-    virtual
     void
     fill_join_implement(unsigned int join_id,
                         const PathData &path,
@@ -576,6 +1027,10 @@ namespace
     fastuidraw::vec2 m_p, m_n, m_v;
   };
 
+  /* As JoinCreatorBase, the class T deriving from CapCreatorBase<T>
+     implements add_cap() which is called statically.
+   */
+  template<typename T>
   class CapCreatorBase:public fastuidraw::PainterAttributeDataFiller
   {
   public:
@@ -603,31 +1058,22 @@ namespace
               fastuidraw::c_array<int> index_adjusts) const;
 
   private:
-    virtual
-    void
-    add_cap(const fastuidraw::vec2 &normal_from_stroking,
-            bool is_starting_cap, unsigned int depth,
-            const fastuidraw::TessellatedPath::point &p0,
-            fastuidraw::c_array<fastuidraw::PainterAttribute> pts,
-            fastuidraw::c_array<unsigned int> indices,
-            unsigned int &vertex_offset,
-            unsigned int &index_offset) const = 0;
-
     const PathData &m_P;
     PointIndexCapSize m_size;
   };
 
-  class RoundedCapCreator:public CapCreatorBase
+  class RoundedCapCreator:public CapCreatorBase<RoundedCapCreator>
   {
   public:
     RoundedCapCreator(const PathData &P, float thresh);
 
   private:
+    friend class CapCreatorBase<RoundedCapCreator>;
+
     static
     PointIndexCapSize
     compute_size(const PathData &P, float thresh);
 
-    virtual
     void
     add_cap(const fastuidraw::vec2 &normal_from_stroking,
             bool is_starting_cap, unsigned int depth,
@@ -641,7 +1087,7 @@ namespace
     unsigned int m_num_arc_points_per_cap;
   };
 
-  class SquareCapCreator:public CapCreatorBase
+  class SquareCapCreator:public CapCreatorBase<SquareCapCreator>
   {
   public:
     explicit
@@ -650,6 +1096,8 @@ namespace
     {}
 
   private:
+    friend class CapCreatorBase<SquareCapCreator>;
+
     static
     PointIndexCapSize
     compute_size(const PathData &P);
@@ -664,7 +1112,7 @@ namespace
             unsigned int &index_offset) const;
   };
 
-  class AdjustableCapCreator:public CapCreatorBase
+  class AdjustableCapCreator:public CapCreatorBase<AdjustableCapCreator>
   {
   public:
     AdjustableCapCreator(const PathData &P):
@@ -672,6 +1120,8 @@ namespace
     {}
 
   private:
+    friend class CapCreatorBase<AdjustableCapCreator>;
+
     enum
       {
         number_points_per_fan = 6,
@@ -712,11 +1162,12 @@ namespace
   public:
     ThreshWithData(void):
       m_data(NULL),
-      m_thresh(-1)
+      m_thresh(-1),
+      m_last_use(0)
     {}
 
     ThreshWithData(fastuidraw::PainterAttributeData *d, float t):
-      m_data(d), m_thresh(t)
+      m_data(d), m_thresh(t), m_last_use(0)
     {}
 
     static
@@ -728,24 +1179,203 @@ namespace
 
     fastuidraw::PainterAttributeData *m_data;
     float m_thresh;
+
+    /* value of StrokedPathPrivate::m_use_counter
+       when the data was last returned
+     */
+    unsigned int m_last_use;
   };
 
-  class StrokedPathPrivate
+  class DashedEdgesEntry
   {
   public:
-    explicit
-    StrokedPathPrivate(const fastuidraw::TessellatedPath &P);
-    ~StrokedPathPrivate();
+    DashedEdgesEntry(void):
+      m_period(0.0f),
+      m_margin(0.0f),
+      m_include_closing_edges(false),
+      m_data(NULL)
+    {}
 
-    void
-    create_edges(const fastuidraw::TessellatedPath &P);
+    bool
+    matches(fastuidraw::const_c_array<fastuidraw::range_type<float> > draw_intervals,
+            float period, float margin, bool include_closing_edges) const
+    {
+      if(m_period != period || m_margin != margin
+         || m_include_closing_edges != include_closing_edges
+         || m_intervals.size() != draw_intervals.size())
+        {
+          return false;
+        }
 
-    template<typename T>
-    const fastuidraw::PainterAttributeData&
-    fetch_create(float thresh, std::vector<ThreshWithData> &values);
+      for(unsigned int i = 0, endi = m_intervals.size(); i < endi; ++i)
+        {
+          if(m_intervals[i].m_begin != draw_intervals[i].m_begin
+             || m_intervals[i].m_end != draw_intervals[i].m_end)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
 
-    fastuidraw::vecN<EdgesElement*, 2> m_edge_culler;
-    fastuidraw::vecN<fastuidraw::PainterAttributeData, 2> m_edges;
+    std::vector<fastuidraw::range_type<float> > m_intervals;
+    float m_period, m_margin;
+    bool m_include_closing_edges;
+    fastuidraw::PainterAttributeData *m_data;
+  };
+
+  /* The join and cap data that do not depend on a threshhold
+     are made in parallel in the ctor of StrokedPathPrivate and the
+     rounded joins and caps of several threshholds are made in
+     parallel by StrokedPath::warm_rounded(); a JoinCapTask is one
+     PainterAttributeData to make for that.
+   */
+  class JoinCapTask
+  {
+  public:
+    enum kind_t
+      {
+        bevel_joins,
+        miter_joins,
+        square_caps,
+        adjustable_caps,
+        rounded_joins,
+        rounded_caps,
+      };
+
+    JoinCapTask(enum kind_t k, fastuidraw::PainterAttributeData *dst, float thresh = 1.0f):
+      m_kind(k),
+      m_dst(dst),
+      m_thresh(thresh)
+    {}
+
+    enum kind_t m_kind;
+    fastuidraw::PainterAttributeData *m_dst;
+    float m_thresh;
+  };
+
+  /* job for run_in_parallel() to perform JoinCapTask's, each
+     task writes only to its own PainterAttributeData and the
+     creators only read the PathData.
+   */
+  class JoinCapJob
+  {
+  public:
+    JoinCapJob(const PathData &P, const std::vector<JoinCapTask> &tasks):
+      m_path_data(P),
+      m_tasks(tasks)
+    {}
+
+    void
+    operator()(unsigned int begin, unsigned int end);
+
+  private:
+    const PathData &m_path_data;
+    const std::vector<JoinCapTask> &m_tasks;
+  };
+
+  enum fastuidraw::StrokedPath::edge_format_t default_edge_format_value = fastuidraw::StrokedPath::full_edge_format;
+  unsigned int default_rounded_cache_max_bytes_value = 0;
+
+  /* Value that starts a blob of a StrokedPath and
+     the version of its format, see
+     StrokedPathPrivate::write_to_blob().
+   */
+  namespace StrokedPathBlobConstants
+  {
+    const uint32_t blob_magic = 0x50534446u;
+    const uint32_t blob_version = 4u;
+  }
+
+  class StrokedPathPrivate
+  {
+  public:
+    StrokedPathPrivate(const fastuidraw::TessellatedPath &P,
+                       enum fastuidraw::StrokedPath::edge_format_t edge_format);
+    ~StrokedPathPrivate();
+
+    /* Blob format, all values are 32-bit words:
+        - StrokedPathBlobConstants::blob_magic
+        - StrokedPathBlobConstants::blob_version
+        - m_effective_curve_distance_threshhold
+        - m_edge_format
+        - m_max_threads
+        - for each of m_edge_culler[0], m_edge_culler[1]:
+          the EdgesElement hierarchy followed by m_edges[]
+        - m_bevel_joins, m_miter_joins, m_square_caps
+          and m_adjustable_caps
+        - m_path_data
+       The rounded joins and caps are not written since
+       they depend on the threshhold; they are made on
+       demand from m_path_data as usual.
+     */
+    void
+    write_to_blob(fastuidraw::detail::BlobWriter &dst) const;
+
+    /* returns NULL if the blob is malformed
+     */
+    static
+    StrokedPathPrivate*
+    create_from_blob(fastuidraw::const_c_array<uint8_t> blob);
+
+    void
+    create_edges(const fastuidraw::TessellatedPath &P);
+
+    template<typename T>
+    const fastuidraw::PainterAttributeData&
+    fetch_create(float thresh, std::vector<ThreshWithData> &values,
+                 enum JoinCapTask::kind_t kind);
+
+    /* The rounded joins and caps are made for threshholds
+       that are powers of 2, the data returned for thresh is
+       that of the largest power of 2 that is no more than
+       thresh (and 1e-6); returns that power of 2.
+     */
+    static
+    float
+    level_threshhold(float thresh);
+
+    /* returns the element of values, which is sorted by
+       decreasing m_thresh, with m_thresh equal to t or where
+       to insert it if there is none.
+     */
+    static
+    std::vector<ThreshWithData>::iterator
+    find_level(float t, std::vector<ThreshWithData> &values);
+
+    /* returns the data of values for level t, adding a
+       PainterAttributeData for it if there is none; in that
+       case if tasks is non-NULL the task to fill it is added
+       to tasks and if tasks is NULL it is filled with T.
+       Marks the data as used by the current value of
+       m_use_counter.
+     */
+    template<typename T>
+    fastuidraw::PainterAttributeData*
+    fetch_level(float t, std::vector<ThreshWithData> &values,
+                enum JoinCapTask::kind_t kind,
+                std::vector<JoinCapTask> *tasks);
+
+    unsigned int
+    rounded_cache_bytes(void) const;
+
+    /* release the least recently used rounded joins and caps
+       until rounded_cache_bytes() is no more than
+       m_rounded_cache_max_bytes; the data used by the
+       current value of m_use_counter and the joins and
+       caps of the level protected_level are never released,
+       the latter because Painter fetches the caps and joins
+       of a stroke before drawing either.
+     */
+    void
+    evict_rounded(float protected_level);
+
+    void
+    run_join_cap_tasks(const std::vector<JoinCapTask> &tasks);
+
+    fastuidraw::vecN<EdgesElement*, 2> m_edge_culler;
+    fastuidraw::vecN<ChunkCullingHierarchy, 2> m_edge_hierarchy;
+    fastuidraw::vecN<fastuidraw::PainterAttributeData, 2> m_edges;
 
     fastuidraw::PainterAttributeData m_bevel_joins, m_miter_joins;
     fastuidraw::PainterAttributeData m_square_caps, m_adjustable_caps;
@@ -754,7 +1384,38 @@ namespace
     std::vector<ThreshWithData> m_rounded_joins;
     std::vector<ThreshWithData> m_rounded_caps;
 
+    /* the data of the last few calls to dashed_edges(),
+       oldest first.
+     */
+    std::vector<DashedEdgesEntry> m_dashed_edges;
+
     float m_effective_curve_distance_threshhold;
+    enum fastuidraw::StrokedPath::edge_format_t m_edge_format;
+
+    /* maximum number of threads with which to make
+       the join and cap data, from the TessellationParams
+       of the TessellatedPath
+     */
+    unsigned int m_max_threads;
+
+    unsigned int m_rounded_cache_max_bytes;
+    unsigned int m_use_counter;
+
+    /* if a StrokedPath is read from a blob that cannot
+       be used in place, the words of the blob are
+       copied here.
+     */
+    std::vector<uint32_t> m_blob_words;
+
+  private:
+    StrokedPathPrivate(void):
+      m_edge_culler(NULL, NULL),
+      m_effective_curve_distance_threshhold(0.0f),
+      m_edge_format(fastuidraw::StrokedPath::full_edge_format),
+      m_max_threads(1),
+      m_rounded_cache_max_bytes(default_rounded_cache_max_bytes_value),
+      m_use_counter(0)
+    {}
   };
 
 }
@@ -915,8 +1576,12 @@ EdgeStore(const fastuidraw::TessellatedPath &P, PathData &path_data)
   for(unsigned int o = 0; o < P.number_contours(); ++o)
     {
       path_data.m_per_contour_data[o].m_edge_data_store.resize(P.number_edges(o));
-      path_data.m_per_contour_data[o].m_start_contour_pt = P.unclosed_contour_point_data(o).front();
-      path_data.m_per_contour_data[o].m_end_contour_pt = P.unclosed_contour_point_data(o).back();
+      unsigned int last_unclosed_edge;
+
+      last_unclosed_edge = (P.number_edges(o) > 1) ? P.number_edges(o) - 2 : 0;
+      path_data.m_per_contour_data[o].m_start_contour_pt = P.edge_point(o, 0, P.edge_range(o, 0).m_begin);
+      path_data.m_per_contour_data[o].m_end_contour_pt = P.edge_point(o, last_unclosed_edge,
+                                                                      P.edge_range(o, last_unclosed_edge).m_end - 1);
       for(unsigned int e = 0; e < P.number_edges(o); ++e)
         {
           if(e + 1 == P.number_edges(o))
@@ -955,7 +1620,8 @@ process_edge(const fastuidraw::TessellatedPath &P, PathData &path_data,
              std::vector<SingleSubEdge> &dst, fastuidraw::BoundingBox &bx)
 {
   fastuidraw::range_type<unsigned int> R;
-  fastuidraw::const_c_array<fastuidraw::TessellatedPath::point> src_pts(P.point_data());
+  fastuidraw::const_c_array<fastuidraw::vec2> src_pts(P.point_positions());
+  fastuidraw::const_c_array<fastuidraw::vec2> src_pts_t(P.point_derivatives());
   fastuidraw::vec2 normal(1.0f, 0.0f), last_normal(1.0f, 0.0f);
 
   R = P.edge_range(contour, edge);
@@ -969,7 +1635,7 @@ process_edge(const fastuidraw::TessellatedPath &P, PathData &path_data,
       float delta_magnitude;
       SingleSubEdge sub_edge;
 
-      delta = src_pts[i + 1].m_p - src_pts[i].m_p;
+      delta = src_pts[i + 1] - src_pts[i];
       delta_magnitude = delta.magnitude();
 
       if(delta.magnitude() >= sm_mag_tol)
@@ -979,9 +1645,9 @@ process_edge(const fastuidraw::TessellatedPath &P, PathData &path_data,
       else
         {
           delta_magnitude = 0.0;
-          if(src_pts[i].m_p_t.magnitudeSq() >= sm_mag_tol * sm_mag_tol)
+          if(src_pts_t[i].magnitudeSq() >= sm_mag_tol * sm_mag_tol)
             {
-              normal = fastuidraw::vec2(-src_pts[i].m_p_t.y(), src_pts[i].m_p_t.x());
+              normal = fastuidraw::vec2(-src_pts_t[i].y(), src_pts_t[i].x());
               normal.normalize();
             }
         }
@@ -991,7 +1657,7 @@ process_edge(const fastuidraw::TessellatedPath &P, PathData &path_data,
           sub_edge.m_bevel_lambda = 0.0f;
           sub_edge.m_has_bevel = false;
           path_data.m_per_contour_data[contour].write_edge_data(edge).m_begin_normal = normal;
-          path_data.m_per_contour_data[contour].write_edge_data(edge).m_start_pt = src_pts[i];
+          path_data.m_per_contour_data[contour].write_edge_data(edge).m_start_pt = P.edge_point(contour, edge, i);
           if(edge == 0)
             {
               path_data.m_per_contour_data[contour].m_begin_cap_normal = normal;
@@ -1004,24 +1670,26 @@ process_edge(const fastuidraw::TessellatedPath &P, PathData &path_data,
           sub_edge.m_bevel_normal = last_normal;
         }
 
+      sub_edge.m_contour = contour;
+      sub_edge.m_edge = edge;
       sub_edge.m_pt0 = i;
       sub_edge.m_pt1 = i + 1;
       sub_edge.m_normal = normal;
       sub_edge.m_delta = delta;
 
       dst.push_back(sub_edge);
-      bx.union_point(src_pts[i].m_p);
-      bx.union_point(src_pts[i + 1].m_p);
+      bx.union_point(src_pts[i]);
+      bx.union_point(src_pts[i + 1]);
 
       last_normal = normal;
     }
 
   if(R.m_begin + 1 >= R.m_end)
     {
-      normal = fastuidraw::vec2(-src_pts[R.m_begin].m_p_t.y(), src_pts[R.m_begin].m_p_t.x());
+      normal = fastuidraw::vec2(-src_pts_t[R.m_begin].y(), src_pts_t[R.m_begin].x());
       normal.normalize();
       path_data.m_per_contour_data[contour].write_edge_data(edge).m_begin_normal = normal;
-      path_data.m_per_contour_data[contour].write_edge_data(edge).m_start_pt = src_pts[R.m_begin];
+      path_data.m_per_contour_data[contour].write_edge_data(edge).m_start_pt = P.edge_point(contour, edge, R.m_begin);
       if(edge == 0)
         {
           path_data.m_per_contour_data[contour].m_begin_cap_normal = normal;
@@ -1029,7 +1697,7 @@ process_edge(const fastuidraw::TessellatedPath &P, PathData &path_data,
     }
 
   path_data.m_per_contour_data[contour].write_edge_data(edge).m_end_normal = normal;
-  path_data.m_per_contour_data[contour].write_edge_data(edge).m_end_pt = src_pts[R.m_end - 1];
+  path_data.m_per_contour_data[contour].write_edge_data(edge).m_end_pt = P.edge_point(contour, edge, R.m_end - 1);
   if(edge + 2 == P.number_edges(contour))
     {
       path_data.m_per_contour_data[contour].m_end_cap_normal = normal;
@@ -1041,7 +1709,7 @@ process_edge(const fastuidraw::TessellatedPath &P, PathData &path_data,
 SubEdgeCullingHierarchy::
 SubEdgeCullingHierarchy(const fastuidraw::BoundingBox &start_box,
                         fastuidraw::const_c_array<SingleSubEdge> data,
-                        fastuidraw::const_c_array<fastuidraw::TessellatedPath::point> src_pts)
+                        fastuidraw::const_c_array<fastuidraw::vec2> src_pts)
 {
   int c;
 
@@ -1060,18 +1728,18 @@ SubEdgeCullingHierarchy(const fastuidraw::BoundingBox &start_box,
           const SingleSubEdge &sub_edge(data[i]);
           bool sA, sB;
 
-          sA = (src_pts[sub_edge.m_pt0].m_p[c] < mid_point);
-          sB = (src_pts[sub_edge.m_pt1].m_p[c] < mid_point);
+          sA = (src_pts[sub_edge.m_pt0][c] < mid_point);
+          sB = (src_pts[sub_edge.m_pt1][c] < mid_point);
           if(sA == sB)
             {
-              child_boxes[sA].union_point(src_pts[sub_edge.m_pt0].m_p);
-              child_boxes[sA].union_point(src_pts[sub_edge.m_pt1].m_p);
+              child_boxes[sA].union_point(src_pts[sub_edge.m_pt0]);
+              child_boxes[sA].union_point(src_pts[sub_edge.m_pt1]);
               child_sub_edges[sA].push_back(sub_edge);
             }
           else
             {
-              m_sub_edges_bb.union_point(src_pts[sub_edge.m_pt0].m_p);
-              m_sub_edges_bb.union_point(src_pts[sub_edge.m_pt1].m_p);
+              m_sub_edges_bb.union_point(src_pts[sub_edge.m_pt0]);
+              m_sub_edges_bb.union_point(src_pts[sub_edge.m_pt1]);
               m_sub_edges.push_back(sub_edge);
             }
         }
@@ -1084,8 +1752,8 @@ SubEdgeCullingHierarchy(const fastuidraw::BoundingBox &start_box,
       for(unsigned int i = 0; i < data.size(); ++i)
         {
           const SingleSubEdge &sub_edge(data[i]);
-          m_sub_edges_bb.union_point(src_pts[sub_edge.m_pt0].m_p);
-          m_sub_edges_bb.union_point(src_pts[sub_edge.m_pt1].m_p);
+          m_sub_edges_bb.union_point(src_pts[sub_edge.m_pt0]);
+          m_sub_edges_bb.union_point(src_pts[sub_edge.m_pt1]);
           m_sub_edges.push_back(sub_edge);
         }
     }
@@ -1121,7 +1789,7 @@ int
 SubEdgeCullingHierarchy::
 choose_splitting_coordinate(const fastuidraw::BoundingBox &start_box,
                             fastuidraw::const_c_array<SingleSubEdge> data,
-                            fastuidraw::const_c_array<fastuidraw::TessellatedPath::point> src_pts)
+                            fastuidraw::const_c_array<fastuidraw::vec2> src_pts)
 {
   fastuidraw::vec2 mid_pt;
   fastuidraw::ivec2 counter(0, 0);
@@ -1133,8 +1801,8 @@ choose_splitting_coordinate(const fastuidraw::BoundingBox &start_box,
       const SingleSubEdge &sub_edge(data[i]);
       for(unsigned int c = 0; c < 2; ++c)
         {
-          sA[c] = (src_pts[sub_edge.m_pt0].m_p[c] < mid_pt[c]);
-          sB[c] = (src_pts[sub_edge.m_pt1].m_p[c] < mid_pt[c]);
+          sA[c] = (src_pts[sub_edge.m_pt0][c] < mid_pt[c]);
+          sB[c] = (src_pts[sub_edge.m_pt1][c] < mid_pt[c]);
           if(sA[c] != sB[c])
             {
               ++counter[c];
@@ -1148,7 +1816,7 @@ SubEdgeCullingHierarchy*
 SubEdgeCullingHierarchy::
 create(const fastuidraw::BoundingBox &start_box,
        const std::vector<SingleSubEdge> &data,
-       fastuidraw::const_c_array<fastuidraw::TessellatedPath::point> src_pts)
+       fastuidraw::const_c_array<fastuidraw::vec2> src_pts)
 {
   if(!data.empty())
     {
@@ -1162,92 +1830,187 @@ create(const fastuidraw::BoundingBox &start_box,
     }
 }
 
-////////////////////////////////////////////
-// EdgesElement methods
-EdgesElement::
-EdgesElement(unsigned int vertex_st, unsigned int index_st,
-             SubEdgeCullingHierarchy *src, unsigned int &total_chunks,
-             unsigned int depth):
-  m_children(NULL, NULL)
+namespace
 {
-  m_vertex_data_range_with_children.m_begin = vertex_st;
-  m_index_data_range_with_children.m_begin = index_st;
-  m_depth_with_children.m_begin = depth;
+  void
+  write_range(fastuidraw::detail::BlobWriter &dst,
+              const fastuidraw::range_type<unsigned int> &R)
+  {
+    dst.write_u32(R.m_begin);
+    dst.write_u32(R.m_end);
+  }
 
-  if(src->m_children[0] != NULL)
-    {
-      m_children[0] = FASTUIDRAWnew EdgesElement(vertex_st, index_st, src->m_children[0], total_chunks, depth);
-      vertex_st = m_children[0]->m_vertex_data_range_with_children.m_end;
-      index_st = m_children[0]->m_index_data_range_with_children.m_end;
-      depth = m_children[0]->m_depth_with_children.m_end;
-    }
+  fastuidraw::range_type<unsigned int>
+  read_range(fastuidraw::detail::BlobReader &src)
+  {
+    fastuidraw::range_type<unsigned int> R;
 
-  if(src->m_children[1] != NULL)
-    {
-      m_children[1] = FASTUIDRAWnew EdgesElement(vertex_st, index_st, src->m_children[1], total_chunks, depth);
-      vertex_st = m_children[1]->m_vertex_data_range_with_children.m_end;
-      index_st = m_children[1]->m_index_data_range_with_children.m_end;
-      depth = m_children[1]->m_depth_with_children.m_end;
-    }
+    R.m_begin = src.read_u32();
+    R.m_end = src.read_u32();
+    if(R.m_begin > R.m_end)
+      {
+        src.fail();
+      }
+    return R;
+  }
 
-  unsigned int index_cnt, vertex_cnt, depth_cnt;
-  count_vertices_indices(src, vertex_cnt, index_cnt, depth_cnt);
-  m_data_chunk = total_chunks;
-  m_data_bb = src->m_sub_edges_bb;
-  m_data_src = fastuidraw::make_c_array(src->m_sub_edges);
-  m_vertex_data_range.m_begin = vertex_st;
-  m_vertex_data_range.m_end = vertex_st + vertex_cnt;
-  m_index_data_range.m_begin = index_st;
-  m_index_data_range.m_end = index_st + index_cnt;
-  m_depth.m_begin = depth;
-  m_depth.m_end = depth + depth_cnt;
+  bool
+  range_within(const fastuidraw::range_type<unsigned int> &R,
+               const fastuidraw::range_type<unsigned int> &outer)
+  {
+    return outer.m_begin <= R.m_begin && R.m_end <= outer.m_end;
+  }
 
-  m_data_chunk_with_children = total_chunks + 1;
-  m_data_with_children_bb = src->m_entire_bb;
-  m_vertex_data_range_with_children.m_end = m_vertex_data_range.m_end;
-  m_index_data_range_with_children.m_end = m_index_data_range.m_end;
-  m_depth_with_children.m_end = m_depth.m_end;
+  void
+  write_point(fastuidraw::detail::BlobWriter &dst,
+              const fastuidraw::TessellatedPath::point &pt)
+  {
+    dst.write_vec2(pt.m_p);
+    dst.write_vec2(pt.m_p_t);
+    dst.write_float(pt.m_distance_from_edge_start);
+    dst.write_float(pt.m_distance_from_contour_start);
+    dst.write_float(pt.m_edge_length);
+    dst.write_float(pt.m_open_contour_length);
+    dst.write_float(pt.m_closed_contour_length);
+  }
 
-  total_chunks += 2u;
+  fastuidraw::TessellatedPath::point
+  read_point(fastuidraw::detail::BlobReader &src)
+  {
+    fastuidraw::TessellatedPath::point pt;
+
+    pt.m_p = src.read_vec2();
+    pt.m_p_t = src.read_vec2();
+    pt.m_distance_from_edge_start = src.read_float();
+    pt.m_distance_from_contour_start = src.read_float();
+    pt.m_edge_length = src.read_float();
+    pt.m_open_contour_length = src.read_float();
+    pt.m_closed_contour_length = src.read_float();
+    return pt;
+  }
 }
 
-EdgesElement::
-~EdgesElement()
+////////////////////////////////////////////
+// ChunkCullingHierarchy methods
+unsigned int
+ChunkCullingHierarchy::
+begin_element(const Element &element)
 {
-  if(m_children[0] != NULL)
+  m_elements.push_back(element);
+  m_skip.push_back(m_elements.size());
+  return m_elements.size() - 1;
+}
+
+void
+ChunkCullingHierarchy::
+end_element(unsigned int i)
+{
+  assert(i < m_skip.size());
+  m_skip[i] = m_elements.size();
+}
+
+void
+ChunkCullingHierarchy::
+finalize(void)
+{
+  m_boxes.pad(m_elements.size());
+  m_boxes_with_children.pad(m_elements.size());
+  for(unsigned int i = 0, endi = m_elements.size(); i < endi; ++i)
     {
-      FASTUIDRAWdelete(m_children[0]);
+      m_boxes.set(i, m_elements[i].m_bb);
+      m_boxes_with_children.set(i, m_elements[i].m_bb_with_children);
     }
-  if(m_children[1] != NULL)
+}
+
+void
+ChunkCullingHierarchy::
+chunks_containing(const fastuidraw::vec2 &pt, float room,
+                  std::vector<unsigned int> &dst) const
+{
+  for(unsigned int i = 0, endi = m_elements.size(); i < endi;)
     {
-      FASTUIDRAWdelete(m_children[1]);
+      const Element &element(m_elements[i]);
+
+      if(!box_contains(element.m_bb_with_children, pt, room))
+        {
+          i = m_skip[i];
+        }
+      else
+        {
+          if(box_contains(element.m_bb, pt, room))
+            {
+              dst.push_back(element.m_chunk);
+            }
+          ++i;
+        }
+    }
+}
+
+void
+ChunkCullingHierarchy::
+take_all(unsigned int i,
+         const fastuidraw::PainterAttributeData &data,
+         unsigned int max_attribute_cnt,
+         unsigned int max_index_cnt,
+         fastuidraw::c_array<unsigned int> dst,
+         unsigned int &current) const
+{
+  for(unsigned int end = m_skip[i]; i < end;)
+    {
+      const Element &element(m_elements[i]);
+
+      if(data.attribute_data_chunk(element.m_chunk_with_children).size() <= max_attribute_cnt
+         && data.index_data_chunk(element.m_chunk_with_children).size() <= max_index_cnt)
+        {
+          dst[current] = element.m_chunk_with_children;
+          ++current;
+          i = m_skip[i];
+        }
+      else
+        {
+          if(!element.m_bb.empty())
+            {
+              if(data.attribute_data_chunk(element.m_chunk).size() <= max_attribute_cnt
+                 && data.index_data_chunk(element.m_chunk).size() <= max_index_cnt)
+                {
+                  dst[current] = element.m_chunk;
+                  ++current;
+                }
+              else
+                {
+                  assert(!"StrokedPath: chunk has too many attribute and indices");
+                }
+            }
+          ++i;
+        }
     }
 }
 
 unsigned int
-EdgesElement::
-edge_chunks(ScratchSpacePrivate &scratch,
-            fastuidraw::const_c_array<fastuidraw::vec3> clip_equations,
-            const fastuidraw::float3x3 &clip_matrix_local,
-            const fastuidraw::vec2 &recip_dimensions,
-            float pixels_additional_room,
-            float item_space_additional_room,
-            unsigned int max_attribute_cnt,
-            unsigned int max_index_cnt,
-            fastuidraw::c_array<unsigned int> dst)
+ChunkCullingHierarchy::
+select_chunks(ScratchSpacePrivate &scratch,
+              const fastuidraw::PainterAttributeData &data,
+              fastuidraw::const_c_array<fastuidraw::vec3> clip_equations,
+              const fastuidraw::float3x3 &clip_matrix_local,
+              const fastuidraw::vec2 &recip_dimensions,
+              float pixels_additional_room,
+              float item_space_additional_room,
+              unsigned int max_attribute_cnt,
+              unsigned int max_index_cnt,
+              fastuidraw::c_array<unsigned int> dst) const
 {
-  unsigned int return_value(0u);
+  using namespace fastuidraw;
 
   scratch.m_adjusted_clip_eqs.resize(clip_equations.size());
   for(unsigned int i = 0; i < clip_equations.size(); ++i)
     {
-      fastuidraw::vec3 c(clip_equations[i]);
+      vec3 c(clip_equations[i]);
       float f;
 
       /* make "w" larger by the named number of pixels.
        */
-      f = fastuidraw::t_abs(c.x()) * recip_dimensions.x()
-        + fastuidraw::t_abs(c.y()) * recip_dimensions.y();
+      f = t_abs(c.x()) * recip_dimensions.x()
+        + t_abs(c.y()) * recip_dimensions.y();
 
       c.z() += pixels_additional_room * f;
 
@@ -1257,171 +2020,457 @@ edge_chunks(ScratchSpacePrivate &scratch,
       scratch.m_adjusted_clip_eqs[i] = c * clip_matrix_local;
     }
 
-  edge_chunks_implement(scratch, item_space_additional_room,
-                        max_attribute_cnt, max_index_cnt,
-                        dst, return_value);
-  return return_value;
-}
+  const_c_array<vec3> clip_eqs(make_c_array(scratch.m_adjusted_clip_eqs));
+  vecN<enum Boxes::classification_t, block_size> block, block_with_children;
+  unsigned int block_start(m_boxes.m_min_x.size());
+  unsigned int i(0), sz(m_elements.size()), current(0);
 
-void
-EdgesElement::
-edge_chunks_take_all(unsigned int max_attribute_cnt,
-                     unsigned int max_index_cnt,
-                     fastuidraw::c_array<unsigned int> dst,
-                     unsigned int &current)
-{
-  if(m_vertex_data_range_with_children.difference() <= max_attribute_cnt
-     && m_index_data_range_with_children.difference() <= max_index_cnt)
-    {
-      dst[current] = m_data_chunk_with_children;
-      ++current;
-    }
-  else
+  while(i < sz)
     {
-      if(m_vertex_data_range.difference() <= max_attribute_cnt
-         && m_index_data_range.difference() <= max_index_cnt)
+      enum Boxes::classification_t c;
+
+      if(i < block_start || i >= block_start + block_size)
         {
-          dst[current] = m_data_chunk;
-          ++current;
+          block_start = i - (i % block_size);
+          m_boxes_with_children.classify_block(clip_eqs, item_space_additional_room,
+                                               block_start, block_with_children);
+          m_boxes.classify_block(clip_eqs, item_space_additional_room,
+                                 block_start, block);
         }
-      else
+
+      c = block_with_children[i - block_start];
+      if(c == Boxes::is_partially_clipped)
         {
-          assert(!"StrokedPath: Edge chunk has too many attribute and indices");
+          c = m_boxes_with_children.clip(clip_eqs, item_space_additional_room, i,
+                                         scratch.m_clipped_rect,
+                                         scratch.m_clip_scratch_floats,
+                                         scratch.m_clip_scratch_vec2s);
         }
 
-      if(m_children[0] != NULL)
+      if(c == Boxes::is_culled)
         {
-          m_children[0]->edge_chunks_take_all(max_attribute_cnt, max_index_cnt,
-                                              dst, current);
+          i = m_skip[i];
         }
-
-      if(m_children[1] != NULL)
+      else if(c == Boxes::is_unclipped)
+        {
+          take_all(i, data, max_attribute_cnt, max_index_cnt, dst, current);
+          i = m_skip[i];
+        }
+      else
         {
-          m_children[1]->edge_chunks_take_all(max_attribute_cnt, max_index_cnt,
-                                              dst, current);
+          /* take the chunk of the element alone if its
+             own data is not culled and visit the elements
+             below it.
+           */
+          c = block[i - block_start];
+          if(c == Boxes::is_partially_clipped)
+            {
+              c = m_boxes.clip(clip_eqs, item_space_additional_room, i,
+                               scratch.m_clipped_rect,
+                               scratch.m_clip_scratch_floats,
+                               scratch.m_clip_scratch_vec2s);
+            }
+
+          if(c != Boxes::is_culled)
+            {
+              dst[current] = m_elements[i].m_chunk;
+              ++current;
+            }
+          ++i;
         }
     }
+  return current;
 }
 
+////////////////////////////////////////////
+// ItemCullingHierarchy methods
 void
-EdgesElement::
-edge_chunks_implement(ScratchSpacePrivate &scratch,
-                      float item_space_additional_room,
-                      unsigned int max_attribute_cnt,
-                      unsigned int max_index_cnt,
-                      fastuidraw::c_array<unsigned int> dst,
-                      unsigned int &current)
+ItemCullingHierarchy::
+set(fastuidraw::const_c_array<fastuidraw::BoundingBox> item_boxes,
+    unsigned int first_chunk)
 {
-  using namespace fastuidraw;
-  using namespace fastuidraw::detail;
-
-  if(m_data_with_children_bb.empty())
+  m_first_chunk = first_chunk;
+  if(!item_boxes.empty())
     {
-      return;
+      create(item_boxes, fastuidraw::range_type<unsigned int>(0, item_boxes.size()));
     }
+  m_culler.finalize();
+}
 
-  /* clip the bounding box of this EdgesElement
-   */
-  vecN<vec2, 4> bb;
-  bool unclipped;
-
-  m_data_with_children_bb.inflated_polygon(bb, item_space_additional_room);
-  unclipped = clip_against_planes(make_c_array(scratch.m_adjusted_clip_eqs),
-                                  bb, scratch.m_clipped_rect,
-                                  scratch.m_clip_scratch_floats,
-                                  scratch.m_clip_scratch_vec2s);
-  //completely unclipped.
-  if(unclipped)
-    {
-      edge_chunks_take_all(max_attribute_cnt, max_index_cnt, dst, current);
-      return;
-    }
+void
+ItemCullingHierarchy::
+create(fastuidraw::const_c_array<fastuidraw::BoundingBox> item_boxes,
+       fastuidraw::range_type<unsigned int> R)
+{
+  ChunkCullingHierarchy::Element element;
+  unsigned int i;
 
-  //completely clipped
-  if(scratch.m_clipped_rect.empty())
+  for(unsigned int k = R.m_begin; k < R.m_end; ++k)
     {
-      return;
+      element.m_bb_with_children.union_box(item_boxes[k]);
     }
+  element.m_chunk_with_children = m_first_chunk + m_ranges.size();
+  m_ranges.push_back(R);
 
-  if(m_children[0] != NULL)
+  /* only the leaves have data of their own, the chunk
+     of a leaf alone and with its children are the same.
+   */
+  if(R.difference() <= items_per_leaf)
     {
-      m_children[0]->edge_chunks_implement(scratch, item_space_additional_room,
-                                           max_attribute_cnt, max_index_cnt,
-                                           dst, current);
+      element.m_bb = element.m_bb_with_children;
+      element.m_chunk = element.m_chunk_with_children;
+      i = m_culler.begin_element(element);
     }
-
-  if(m_children[1] != NULL)
+  else
     {
-      m_children[1]->edge_chunks_implement(scratch, item_space_additional_room,
-                                           max_attribute_cnt, max_index_cnt,
-                                           dst, current);
+      unsigned int mid;
+
+      element.m_chunk = element.m_chunk_with_children;
+      i = m_culler.begin_element(element);
+
+      mid = R.m_begin + R.difference() / 2;
+      create(item_boxes, fastuidraw::range_type<unsigned int>(R.m_begin, mid));
+      create(item_boxes, fastuidraw::range_type<unsigned int>(mid, R.m_end));
     }
+  m_culler.end_element(i);
+}
 
-  if(!m_data_bb.empty())
+void
+ItemCullingHierarchy::
+fill_chunks(fastuidraw::const_c_array<unsigned int> vertex_starts,
+            fastuidraw::const_c_array<unsigned int> index_starts,
+            fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+            fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
+            fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
+            fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+            fastuidraw::c_array<int> index_adjusts) const
+{
+  assert(vertex_starts.size() == index_starts.size());
+  assert(m_first_chunk + m_ranges.size() <= attribute_chunks.size());
+  for(unsigned int k = 0, endk = m_ranges.size(); k < endk; ++k)
     {
-      m_data_bb.inflated_polygon(bb, item_space_additional_room);
-      clip_against_planes(make_c_array(scratch.m_adjusted_clip_eqs),
-                          bb, scratch.m_clipped_rect,
-                          scratch.m_clip_scratch_floats,
-                          scratch.m_clip_scratch_vec2s);
-
-      if(!scratch.m_clipped_rect.empty())
-        {
-          dst[current] = m_data_chunk;
-          ++current;
-        }
+      fastuidraw::range_type<unsigned int> R(m_ranges[k]);
+      unsigned int K(m_first_chunk + k);
+
+      assert(R.m_end < vertex_starts.size());
+      attribute_chunks[K] = attribute_data.sub_array(vertex_starts[R.m_begin],
+                                                     vertex_starts[R.m_end] - vertex_starts[R.m_begin]);
+      index_chunks[K] = index_data.sub_array(index_starts[R.m_begin],
+                                             index_starts[R.m_end] - index_starts[R.m_begin]);
+      index_adjusts[K] = -int(vertex_starts[R.m_begin]);
     }
 }
 
+////////////////////////////////////////////
+// PathData methods
 void
-EdgesElement::
-count_vertices_indices(SubEdgeCullingHierarchy *src,
-                       unsigned int &vertex_cnt,
-                       unsigned int &index_cnt,
-                       unsigned int &depth_cnt)
+PathData::
+ready_culling_hierarchies(void)
 {
-  vertex_cnt = 0u;
-  index_cnt = 0u;
-  depth_cnt = src->m_sub_edges.size();
-  for(unsigned int i = 0, endi = depth_cnt; i < endi; ++i)
+  std::vector<fastuidraw::BoundingBox> boxes;
+  unsigned int num_non_closed_joins, first_chunk;
+
+  /* the joins are in the same order as made by
+     JoinCreatorBase::post_ctor_initalize()
+   */
+  for(unsigned int o = 0; o < number_contours(); ++o)
     {
-      const SingleSubEdge &v(src->m_sub_edges[i]);
-      if(v.m_has_bevel)
+      for(unsigned int e = 1; e + 1 < number_edges(o); ++e)
         {
-          vertex_cnt += 3;
-          index_cnt += 3;
+          boxes.push_back(fastuidraw::BoundingBox());
+          boxes.back().union_point(m_per_contour_data[o].edge_data(e - 1).m_end_pt.m_p);
+          boxes.back().union_point(m_per_contour_data[o].edge_data(e).m_start_pt.m_p);
         }
-      vertex_cnt += points_per_segment;
-      index_cnt += indices_per_segment_without_bevel;
     }
-}
+  num_non_closed_joins = boxes.size();
 
-////////////////////////////////////////
-// EdgesElementFiller methods
-EdgesElementFiller::
-EdgesElementFiller(EdgesElement *src,
-                   const fastuidraw::TessellatedPath &P):
-  m_src(src),
-  m_P(P)
-{
-}
+  for(unsigned int o = 0; o < number_contours(); ++o)
+    {
+      if(number_edges(o) >= 2)
+        {
+          for(unsigned int e = number_edges(o) - 1; e <= number_edges(o); ++e)
+            {
+              boxes.push_back(fastuidraw::BoundingBox());
+              boxes.back().union_point(m_per_contour_data[o].edge_data(e - 1).m_end_pt.m_p);
+              boxes.back().union_point(m_per_contour_data[o].edge_data(e).m_start_pt.m_p);
+            }
+        }
+    }
 
-void
-EdgesElementFiller::
-compute_sizes(unsigned int &num_attributes,
-              unsigned int &num_indices,
-              unsigned int &num_attribute_chunks,
-              unsigned int &num_index_chunks,
-              unsigned int &number_z_increments) const
-{
-  num_attribute_chunks = num_index_chunks = m_src->m_data_chunk_with_children + 1;
-  num_attributes = m_src->m_vertex_data_range_with_children.m_end;
-  num_indices = m_src->m_index_data_range_with_children.m_end;
-  number_z_increments = 1;
+  first_chunk = fastuidraw::StrokedPath::join_chunk_start_individual_joins + boxes.size();
+  m_join_hierarchy[0].set(fastuidraw::make_c_array(boxes).sub_array(0, num_non_closed_joins),
+                          first_chunk);
+  m_join_hierarchy[1].set(fastuidraw::make_c_array(boxes),
+                          first_chunk + m_join_hierarchy[0].number_chunks());
+
+  /* the caps are in the same order as made by
+     CapCreatorBase::fill_data()
+   */
+  boxes.clear();
+  for(unsigned int o = 0; o < number_contours(); ++o)
+    {
+      boxes.push_back(fastuidraw::BoundingBox(m_per_contour_data[o].m_start_contour_pt.m_p,
+                                              m_per_contour_data[o].m_start_contour_pt.m_p));
+      boxes.push_back(fastuidraw::BoundingBox(m_per_contour_data[o].m_end_contour_pt.m_p,
+                                              m_per_contour_data[o].m_end_contour_pt.m_p));
+    }
+  m_cap_hierarchy.set(fastuidraw::make_c_array(boxes), 1);
 }
 
-void
-EdgesElementFiller::
+////////////////////////////////////////////
+// EdgesElement methods
+EdgesElement::
+EdgesElement(unsigned int vertex_st, unsigned int index_st,
+             SubEdgeCullingHierarchy *src, bool compact,
+             unsigned int &total_chunks, unsigned int depth):
+  m_children(NULL, NULL)
+{
+  m_vertex_data_range_with_children.m_begin = vertex_st;
+  m_index_data_range_with_children.m_begin = index_st;
+  m_depth_with_children.m_begin = depth;
+
+  if(src->m_children[0] != NULL)
+    {
+      m_children[0] = FASTUIDRAWnew EdgesElement(vertex_st, index_st, src->m_children[0], compact, total_chunks, depth);
+      vertex_st = m_children[0]->m_vertex_data_range_with_children.m_end;
+      index_st = m_children[0]->m_index_data_range_with_children.m_end;
+      depth = m_children[0]->m_depth_with_children.m_end;
+    }
+
+  if(src->m_children[1] != NULL)
+    {
+      m_children[1] = FASTUIDRAWnew EdgesElement(vertex_st, index_st, src->m_children[1], compact, total_chunks, depth);
+      vertex_st = m_children[1]->m_vertex_data_range_with_children.m_end;
+      index_st = m_children[1]->m_index_data_range_with_children.m_end;
+      depth = m_children[1]->m_depth_with_children.m_end;
+    }
+
+  unsigned int index_cnt, vertex_cnt, depth_cnt;
+  count_vertices_indices(src, compact, vertex_cnt, index_cnt, depth_cnt);
+  m_data_chunk = total_chunks;
+  m_data_bb = src->m_sub_edges_bb;
+  m_data_src = fastuidraw::make_c_array(src->m_sub_edges);
+  m_vertex_data_range.m_begin = vertex_st;
+  m_vertex_data_range.m_end = vertex_st + vertex_cnt;
+  m_index_data_range.m_begin = index_st;
+  m_index_data_range.m_end = index_st + index_cnt;
+  m_depth.m_begin = depth;
+  m_depth.m_end = depth + depth_cnt;
+
+  m_data_chunk_with_children = total_chunks + 1;
+  m_data_with_children_bb = src->m_entire_bb;
+  m_vertex_data_range_with_children.m_end = m_vertex_data_range.m_end;
+  m_index_data_range_with_children.m_end = m_index_data_range.m_end;
+  m_depth_with_children.m_end = m_depth.m_end;
+
+  total_chunks += 2u;
+}
+
+EdgesElement::
+~EdgesElement()
+{
+  if(m_children[0] != NULL)
+    {
+      FASTUIDRAWdelete(m_children[0]);
+    }
+  if(m_children[1] != NULL)
+    {
+      FASTUIDRAWdelete(m_children[1]);
+    }
+}
+
+EdgesElement*
+EdgesElement::
+create_from_blob(fastuidraw::detail::BlobReader &src)
+{
+  EdgesElement *return_value;
+  fastuidraw::vecN<bool, 2> has_child;
+
+  return_value = FASTUIDRAWnew EdgesElement();
+  has_child[0] = src.read_bool();
+  has_child[1] = src.read_bool();
+
+  return_value->m_vertex_data_range = read_range(src);
+  return_value->m_index_data_range = read_range(src);
+  return_value->m_depth = read_range(src);
+  return_value->m_data_chunk = src.read_u32();
+  return_value->m_data_bb = src.read_bounding_box();
+
+  return_value->m_vertex_data_range_with_children = read_range(src);
+  return_value->m_index_data_range_with_children = read_range(src);
+  return_value->m_depth_with_children = read_range(src);
+  return_value->m_data_chunk_with_children = src.read_u32();
+  return_value->m_data_with_children_bb = src.read_bounding_box();
+
+  for(unsigned int i = 0; i < 2 && !src.failed(); ++i)
+    {
+      if(has_child[i])
+        {
+          return_value->m_children[i] = create_from_blob(src);
+        }
+    }
+
+  if(src.failed())
+    {
+      FASTUIDRAWdelete(return_value);
+      return NULL;
+    }
+  return return_value;
+}
+
+bool
+EdgesElement::
+consistent_with(const fastuidraw::PainterAttributeData &data) const
+{
+  unsigned int num_attribute_chunks(data.attribute_data_chunks().size());
+  unsigned int num_index_chunks(data.index_data_chunks().size());
+
+  if(m_data_chunk >= num_attribute_chunks
+     || m_data_chunk >= num_index_chunks
+     || m_data_chunk_with_children >= num_attribute_chunks
+     || m_data_chunk_with_children >= num_index_chunks
+     || data.attribute_data_chunk(m_data_chunk).size() != m_vertex_data_range.difference()
+     || data.index_data_chunk(m_data_chunk).size() != m_index_data_range.difference()
+     || data.attribute_data_chunk(m_data_chunk_with_children).size() != m_vertex_data_range_with_children.difference()
+     || data.index_data_chunk(m_data_chunk_with_children).size() != m_index_data_range_with_children.difference()
+     || !range_within(m_vertex_data_range, m_vertex_data_range_with_children)
+     || !range_within(m_index_data_range, m_index_data_range_with_children)
+     || !range_within(m_depth, m_depth_with_children))
+    {
+      return false;
+    }
+
+  for(unsigned int i = 0; i < 2; ++i)
+    {
+      const EdgesElement *c(m_children[i]);
+      if(c != NULL
+         && (!range_within(c->m_vertex_data_range_with_children, m_vertex_data_range_with_children)
+             || !range_within(c->m_index_data_range_with_children, m_index_data_range_with_children)
+             || !range_within(c->m_depth_with_children, m_depth_with_children)
+             || !c->consistent_with(data)))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+EdgesElement::
+write_to_blob(fastuidraw::detail::BlobWriter &dst) const
+{
+  dst.write_bool(m_children[0] != NULL);
+  dst.write_bool(m_children[1] != NULL);
+
+  write_range(dst, m_vertex_data_range);
+  write_range(dst, m_index_data_range);
+  write_range(dst, m_depth);
+  dst.write_u32(m_data_chunk);
+  dst.write_bounding_box(m_data_bb);
+
+  write_range(dst, m_vertex_data_range_with_children);
+  write_range(dst, m_index_data_range_with_children);
+  write_range(dst, m_depth_with_children);
+  dst.write_u32(m_data_chunk_with_children);
+  dst.write_bounding_box(m_data_with_children_bb);
+
+  for(unsigned int i = 0; i < 2; ++i)
+    {
+      if(m_children[i] != NULL)
+        {
+          m_children[i]->write_to_blob(dst);
+        }
+    }
+}
+
+void
+EdgesElement::
+flatten(ChunkCullingHierarchy &dst) const
+{
+  ChunkCullingHierarchy::Element element;
+  unsigned int i;
+
+  element.m_bb = m_data_bb;
+  element.m_chunk = m_data_chunk;
+  element.m_bb_with_children = m_data_with_children_bb;
+  element.m_chunk_with_children = m_data_chunk_with_children;
+
+  i = dst.begin_element(element);
+  for(unsigned int c = 0; c < 2; ++c)
+    {
+      if(m_children[c] != NULL)
+        {
+          m_children[c]->flatten(dst);
+        }
+    }
+  dst.end_element(i);
+}
+void
+EdgesElement::
+count_vertices_indices(SubEdgeCullingHierarchy *src, bool compact,
+                       unsigned int &vertex_cnt,
+                       unsigned int &index_cnt,
+                       unsigned int &depth_cnt)
+{
+  vertex_cnt = 0u;
+  index_cnt = 0u;
+  depth_cnt = src->m_sub_edges.size();
+  for(unsigned int i = 0, endi = depth_cnt; i < endi; ++i)
+    {
+      const SingleSubEdge &v(src->m_sub_edges[i]);
+      if(v.m_has_bevel)
+        {
+          vertex_cnt += 3;
+          index_cnt += 3;
+        }
+      vertex_cnt += (compact) ? compact_points_per_segment : points_per_segment;
+      index_cnt += (compact) ? compact_indices_per_segment_without_bevel : indices_per_segment_without_bevel;
+    }
+}
+
+////////////////////////////////////////
+// EdgesElementFiller methods
+EdgesElementFiller::
+EdgesElementFiller(EdgesElement *src,
+                   const fastuidraw::TessellatedPath &P,
+                   bool compact):
+  m_src(src),
+  m_P(P),
+  m_compact(compact)
+{
+  add_elements(m_src);
+}
+
+void
+EdgesElementFiller::
+add_elements(EdgesElement *e)
+{
+  m_elements.push_back(e);
+  for(unsigned int c = 0; c < 2; ++c)
+    {
+      if(e->m_children[c] != NULL)
+        {
+          add_elements(e->m_children[c]);
+        }
+    }
+}
+
+void
+EdgesElementFiller::
+compute_sizes(unsigned int &num_attributes,
+              unsigned int &num_indices,
+              unsigned int &num_attribute_chunks,
+              unsigned int &num_index_chunks,
+              unsigned int &number_z_increments) const
+{
+  num_attribute_chunks = num_index_chunks = m_src->m_data_chunk_with_children + 1;
+  num_attributes = m_src->m_vertex_data_range_with_children.m_end;
+  num_indices = m_src->m_index_data_range_with_children.m_end;
+  number_z_increments = 1;
+}
+
+void
+EdgesElementFiller::
 fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
           fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
           fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
@@ -1429,35 +2478,32 @@ fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
           fastuidraw::c_array<unsigned int> zincrements,
           fastuidraw::c_array<int> index_adjusts) const
 {
+  FASTUIDRAWunused(attribute_data);
+  FASTUIDRAWunused(index_data);
+  FASTUIDRAWunused(attribute_chunks);
+  FASTUIDRAWunused(index_chunks);
+  FASTUIDRAWunused(index_adjusts);
+
+  /* the chunks are filled by fill_job() */
   zincrements[0] = m_src->m_depth_with_children.m_end;
-  fill_data_worker(m_src, attribute_data, index_data,
-                   attribute_chunks, index_chunks, index_adjusts);
 }
 
 void
 EdgesElementFiller::
-fill_data_worker(EdgesElement *e,
-                 fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
-                 fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
-                 fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
-                 fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
-                 fastuidraw::c_array<int> index_adjusts) const
+fill_job(unsigned int job,
+         fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+         fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
+         fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
+         fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+         fastuidraw::c_array<unsigned int> zincrements,
+         fastuidraw::c_array<int> index_adjusts) const
 {
-  if(e->m_children[0] != NULL)
-    {
-      fill_data_worker(e->m_children[0], attribute_data, index_data,
-                       attribute_chunks, index_chunks, index_adjusts);
-    }
-
-  if(e->m_children[1] != NULL)
-    {
-      fill_data_worker(e->m_children[1], attribute_data, index_data,
-                       attribute_chunks, index_chunks, index_adjusts);
-    }
-
+  EdgesElement *e(m_elements[job]);
   fastuidraw::c_array<fastuidraw::PainterAttribute> ad;
   fastuidraw::c_array<fastuidraw::PainterIndex> id;
 
+  FASTUIDRAWunused(zincrements);
+
   ad = attribute_data.sub_array(e->m_vertex_data_range);
   id = index_data.sub_array(e->m_index_data_range);
   attribute_chunks[e->m_data_chunk] = ad;
@@ -1489,7 +2535,8 @@ process_sub_edge(const SingleSubEdge &sub_edge, unsigned int raw_depth,
                  fastuidraw::c_array<fastuidraw::PainterIndex> indices,
                  unsigned int &vert_offset, unsigned int &index_offset) const
 {
-  fastuidraw::const_c_array<fastuidraw::TessellatedPath::point> src_pts(m_P.point_data());
+  fastuidraw::TessellatedPath::point pt0(m_P.edge_point(sub_edge.m_contour, sub_edge.m_edge, sub_edge.m_pt0));
+  fastuidraw::TessellatedPath::point pt1(m_P.edge_point(sub_edge.m_contour, sub_edge.m_edge, sub_edge.m_pt1));
   const int boundary_values[3] = { 1, 1, 0 };
   const float normal_sign[3] = { 1.0f, -1.0f, 0.0f };
   fastuidraw::vecN<fastuidraw::StrokedPath::point, 6> pts;
@@ -1511,12 +2558,12 @@ process_sub_edge(const SingleSubEdge &sub_edge, unsigned int raw_depth,
 
       for(unsigned int k = 0; k < 3; ++k)
         {
-          pts[k].m_position = src_pts[sub_edge.m_pt0].m_p;
-          pts[k].m_distance_from_edge_start = src_pts[sub_edge.m_pt0].m_distance_from_edge_start;
-          pts[k].m_distance_from_contour_start = src_pts[sub_edge.m_pt0].m_distance_from_contour_start;
-          pts[k].m_edge_length = src_pts[sub_edge.m_pt0].m_edge_length;
-          pts[k].m_open_contour_length = src_pts[sub_edge.m_pt0].m_open_contour_length;
-          pts[k].m_closed_contour_length = src_pts[sub_edge.m_pt0].m_closed_contour_length;
+          pts[k].m_position = pt0.m_p;
+          pts[k].m_distance_from_edge_start = pt0.m_distance_from_edge_start;
+          pts[k].m_distance_from_contour_start = pt0.m_distance_from_contour_start;
+          pts[k].m_edge_length = pt0.m_edge_length;
+          pts[k].m_open_contour_length = pt0.m_open_contour_length;
+          pts[k].m_closed_contour_length = pt0.m_closed_contour_length;
           pts[k].m_auxilary_offset = fastuidraw::vec2(0.0f, 0.0f);
         }
 
@@ -1524,87 +2571,470 @@ process_sub_edge(const SingleSubEdge &sub_edge, unsigned int raw_depth,
       pts[0].m_packed_data = pack_data(0, fastuidraw::StrokedPath::offset_start_sub_edge, depth)
         | fastuidraw::StrokedPath::bevel_edge_mask;
 
-      pts[1].m_pre_offset = sub_edge.m_bevel_lambda * sub_edge.m_bevel_normal;
-      pts[1].m_packed_data = pack_data(1, fastuidraw::StrokedPath::offset_start_sub_edge, depth)
-        | fastuidraw::StrokedPath::bevel_edge_mask;
+      pts[1].m_pre_offset = sub_edge.m_bevel_lambda * sub_edge.m_bevel_normal;
+      pts[1].m_packed_data = pack_data(1, fastuidraw::StrokedPath::offset_start_sub_edge, depth)
+        | fastuidraw::StrokedPath::bevel_edge_mask;
+
+      pts[2].m_pre_offset = sub_edge.m_bevel_lambda * sub_edge.m_normal;
+      pts[2].m_packed_data = pack_data(1, fastuidraw::StrokedPath::offset_start_sub_edge, depth)
+        | fastuidraw::StrokedPath::bevel_edge_mask;
+
+      for(unsigned int i = 0; i < 3; ++i)
+        {
+          pts[i].fastuidraw::StrokedPath::point::pack_point(&attribute_data[vert_offset + i]);
+        }
+
+      vert_offset += 3;
+    }
+
+  if(m_compact)
+    {
+      process_compact_sub_edge(sub_edge, depth, attribute_data, indices,
+                               vert_offset, index_offset);
+      return;
+    }
+
+  /* The quad is:
+     (p, n, delta,  1),
+     (p,-n, delta,  1),
+     (p, 0,     0,  0),
+     (p_next,  n, -delta, 1),
+     (p_next, -n, -delta, 1),
+     (p_next,  0, 0)
+
+     Notice that we are encoding if it is
+     start or end of edge from the sign of
+     m_on_boundary.
+  */
+  for(unsigned int k = 0; k < 3; ++k)
+    {
+      pts[k].m_position = pt0.m_p;
+      pts[k].m_distance_from_edge_start = pt0.m_distance_from_edge_start;
+      pts[k].m_distance_from_contour_start = pt0.m_distance_from_contour_start;
+      pts[k].m_edge_length = pt0.m_edge_length;
+      pts[k].m_open_contour_length = pt0.m_open_contour_length;
+      pts[k].m_closed_contour_length = pt0.m_closed_contour_length;
+      pts[k].m_pre_offset = normal_sign[k] * sub_edge.m_normal;
+      pts[k].m_auxilary_offset = sub_edge.m_delta;
+      pts[k].m_packed_data = pack_data(boundary_values[k],
+                                       fastuidraw::StrokedPath::offset_start_sub_edge,
+                                       depth);
+
+      pts[k + 3].m_position = pt1.m_p;
+      pts[k + 3].m_distance_from_edge_start = pt1.m_distance_from_edge_start;
+      pts[k + 3].m_distance_from_contour_start = pt1.m_distance_from_contour_start;
+      pts[k + 3].m_edge_length = pt1.m_edge_length;
+      pts[k + 3].m_open_contour_length = pt1.m_open_contour_length;
+      pts[k + 3].m_closed_contour_length = pt1.m_closed_contour_length;
+      pts[k + 3].m_pre_offset = normal_sign[k] * sub_edge.m_normal;
+      pts[k + 3].m_auxilary_offset = -sub_edge.m_delta;
+      pts[k + 3].m_packed_data = pack_data(boundary_values[k],
+                                           fastuidraw::StrokedPath::offset_end_sub_edge,
+                                           depth);
+    }
+
+  for(unsigned int i = 0; i < 6; ++i)
+    {
+      pts[i].fastuidraw::StrokedPath::point::pack_point(&attribute_data[vert_offset + i]);
+    }
+
+  indices[index_offset + 0] = vert_offset + 0;
+  indices[index_offset + 1] = vert_offset + 2;
+  indices[index_offset + 2] = vert_offset + 5;
+  indices[index_offset + 3] = vert_offset + 0;
+  indices[index_offset + 4] = vert_offset + 5;
+  indices[index_offset + 5] = vert_offset + 3;
+
+  indices[index_offset + 6] = vert_offset + 2;
+  indices[index_offset + 7] = vert_offset + 1;
+  indices[index_offset + 8] = vert_offset + 4;
+  indices[index_offset + 9] = vert_offset + 2;
+  indices[index_offset + 10] = vert_offset + 4;
+  indices[index_offset + 11] = vert_offset + 5;
+
+  index_offset += EdgesElement::indices_per_segment_without_bevel;
+  vert_offset += EdgesElement::points_per_segment;
+}
+
+void
+EdgesElementFiller::
+process_compact_sub_edge(const SingleSubEdge &sub_edge, unsigned int depth,
+                         fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+                         fastuidraw::c_array<fastuidraw::PainterIndex> indices,
+                         unsigned int &vert_offset, unsigned int &index_offset) const
+{
+  fastuidraw::TessellatedPath::point pt0(m_P.edge_point(sub_edge.m_contour, sub_edge.m_edge, sub_edge.m_pt0));
+  fastuidraw::TessellatedPath::point pt1(m_P.edge_point(sub_edge.m_contour, sub_edge.m_edge, sub_edge.m_pt1));
+  const float normal_sign[2] = { 1.0f, -1.0f };
+  const uint32_t side_bits[2] = { 0u, fastuidraw::StrokedPath::negative_boundary_mask };
+  fastuidraw::vecN<fastuidraw::StrokedPath::point, 4> pts;
+
+  /* The quad is:
+     (p, n, delta, 1),
+     (p,-n, delta, -1),
+     (p_next,  n, -delta, 1),
+     (p_next, -n, -delta, -1)
+
+     The points on the path are not present; instead
+     the points on the side opposite to the normal
+     have negative_boundary_bit up so that the on
+     boundary value interpolated across the quad is
+     zero along the path.
+  */
+  for(unsigned int k = 0; k < 2; ++k)
+    {
+      pts[k].m_position = pt0.m_p;
+      pts[k].m_distance_from_edge_start = pt0.m_distance_from_edge_start;
+      pts[k].m_distance_from_contour_start = pt0.m_distance_from_contour_start;
+      pts[k].m_edge_length = pt0.m_edge_length;
+      pts[k].m_open_contour_length = pt0.m_open_contour_length;
+      pts[k].m_closed_contour_length = pt0.m_closed_contour_length;
+      pts[k].m_pre_offset = normal_sign[k] * sub_edge.m_normal;
+      pts[k].m_auxilary_offset = sub_edge.m_delta;
+      pts[k].m_packed_data = pack_data(1, fastuidraw::StrokedPath::offset_start_sub_edge, depth)
+        | side_bits[k];
+
+      pts[k + 2].m_position = pt1.m_p;
+      pts[k + 2].m_distance_from_edge_start = pt1.m_distance_from_edge_start;
+      pts[k + 2].m_distance_from_contour_start = pt1.m_distance_from_contour_start;
+      pts[k + 2].m_edge_length = pt1.m_edge_length;
+      pts[k + 2].m_open_contour_length = pt1.m_open_contour_length;
+      pts[k + 2].m_closed_contour_length = pt1.m_closed_contour_length;
+      pts[k + 2].m_pre_offset = normal_sign[k] * sub_edge.m_normal;
+      pts[k + 2].m_auxilary_offset = -sub_edge.m_delta;
+      pts[k + 2].m_packed_data = pack_data(1, fastuidraw::StrokedPath::offset_end_sub_edge, depth)
+        | side_bits[k];
+    }
+
+  for(unsigned int i = 0; i < 4; ++i)
+    {
+      pts[i].fastuidraw::StrokedPath::point::pack_point(&attribute_data[vert_offset + i]);
+    }
+
+  indices[index_offset + 0] = vert_offset + 0;
+  indices[index_offset + 1] = vert_offset + 1;
+  indices[index_offset + 2] = vert_offset + 3;
+  indices[index_offset + 3] = vert_offset + 0;
+  indices[index_offset + 4] = vert_offset + 3;
+  indices[index_offset + 5] = vert_offset + 2;
+
+  index_offset += EdgesElement::compact_indices_per_segment_without_bevel;
+  vert_offset += EdgesElement::compact_points_per_segment;
+}
+
+//////////////////////////////////////////
+// DashedEdgesFiller methods
+DashedEdgesFiller::
+DashedEdgesFiller(const EdgesElement *src,
+                  const fastuidraw::PainterAttributeData &src_data,
+                  bool compact,
+                  fastuidraw::const_c_array<fastuidraw::range_type<float> > draw_intervals,
+                  float period, float margin):
+  m_src_data(src_data),
+  m_intervals(draw_intervals),
+  m_period(period),
+  m_margin(margin)
+{
+  /* same triangles as made by EdgesElementFiller::process_sub_edge()
+     and EdgesElementFiller::process_compact_sub_edge().
+   */
+  static const unsigned int full_quad_indices[EdgesElement::indices_per_segment_without_bevel] =
+    {
+      0, 2, 5, 0, 5, 3,
+      2, 1, 4, 2, 4, 5
+    };
+  static const unsigned int compact_quad_indices[EdgesElement::compact_indices_per_segment_without_bevel] =
+    {
+      0, 1, 3, 0, 3, 2
+    };
+
+  if(compact)
+    {
+      m_points_per_segment = EdgesElement::compact_points_per_segment;
+      m_quad_indices = fastuidraw::const_c_array<unsigned int>(compact_quad_indices,
+                                                               EdgesElement::compact_indices_per_segment_without_bevel);
+    }
+  else
+    {
+      m_points_per_segment = EdgesElement::points_per_segment;
+      m_quad_indices = fastuidraw::const_c_array<unsigned int>(full_quad_indices,
+                                                               EdgesElement::indices_per_segment_without_bevel);
+    }
+
+  m_attrib_ranges.resize(src_data.attribute_data_chunks().size());
+  m_index_ranges.resize(src_data.index_data_chunks().size());
+  process_element(src);
+}
+
+void
+DashedEdgesFiller::
+compute_sizes(unsigned int &num_attributes,
+              unsigned int &num_indices,
+              unsigned int &num_attribute_chunks,
+              unsigned int &num_index_chunks,
+              unsigned int &number_z_increments) const
+{
+  num_attributes = m_attribs.size();
+  num_indices = m_indices.size();
+  num_attribute_chunks = m_attrib_ranges.size();
+  num_index_chunks = m_index_ranges.size();
+  number_z_increments = 1;
+}
+
+void
+DashedEdgesFiller::
+fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+          fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
+          fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
+          fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+          fastuidraw::c_array<unsigned int> zincrements,
+          fastuidraw::c_array<int> index_adjusts) const
+{
+  std::copy(m_attribs.begin(), m_attribs.end(), attribute_data.begin());
+  std::copy(m_indices.begin(), m_indices.end(), index_data.begin());
+  for(unsigned int c = 0, endc = m_attrib_ranges.size(); c < endc; ++c)
+    {
+      attribute_chunks[c] = attribute_data.sub_array(m_attrib_ranges[c]);
+      index_chunks[c] = index_data.sub_array(m_index_ranges[c]);
+      index_adjusts[c] = -int(m_attrib_ranges[c].m_begin);
+    }
+  zincrements[0] = m_src_data.increment_z_value(0);
+}
+
+void
+DashedEdgesFiller::
+process_element(const EdgesElement *e)
+{
+  fastuidraw::range_type<unsigned int> attribs_with_children, indices_with_children;
+  fastuidraw::const_c_array<fastuidraw::PainterAttribute> src;
+
+  /* the data of the children is made first so that the data
+     of an element and its descendants is contiguous, just as
+     in EdgesElementFiller::fill_data_worker().
+   */
+  attribs_with_children.m_begin = m_attribs.size();
+  indices_with_children.m_begin = m_indices.size();
+  for(unsigned int i = 0; i < 2; ++i)
+    {
+      if(e->m_children[i] != NULL)
+        {
+          process_element(e->m_children[i]);
+        }
+    }
+
+  m_attrib_ranges[e->m_data_chunk].m_begin = m_attribs.size();
+  m_index_ranges[e->m_data_chunk].m_begin = m_indices.size();
+
+  /* the attributes of a sub-edge are the 3 points of its bevel,
+     if it has one, followed by the points of its quad.
+   */
+  src = m_src_data.attribute_data_chunk(e->m_data_chunk);
+  while(!src.empty())
+    {
+      if(src[0].m_attrib2.x() & fastuidraw::StrokedPath::bevel_edge_mask)
+        {
+          float d;
+
+          d = fastuidraw::unpack_float(src[0].m_attrib1.y());
+          if(classify(d) != gap_piece)
+            {
+              unsigned int v(m_attribs.size());
+              for(unsigned int k = 0; k < 3; ++k)
+                {
+                  m_attribs.push_back(src[k]);
+                  m_indices.push_back(v + k);
+                }
+            }
+          src = src.sub_array(3);
+        }
+      else
+        {
+          assert(src.size() >= m_points_per_segment);
+          process_sub_edge(src.sub_array(0, m_points_per_segment));
+          src = src.sub_array(m_points_per_segment);
+        }
+    }
+
+  m_attrib_ranges[e->m_data_chunk].m_end = m_attribs.size();
+  m_index_ranges[e->m_data_chunk].m_end = m_indices.size();
+
+  attribs_with_children.m_end = m_attribs.size();
+  indices_with_children.m_end = m_indices.size();
+  m_attrib_ranges[e->m_data_chunk_with_children] = attribs_with_children;
+  m_index_ranges[e->m_data_chunk_with_children] = indices_with_children;
+}
+
+enum DashedEdgesFiller::piece_t
+DashedEdgesFiller::
+classify(float distance) const
+{
+  enum piece_t return_value(gap_piece);
+  float k;
+
+  /* the intervals begin within one period from the begin of
+     the first interval and are no longer than a period, thus
+     only the repeats of the pattern in the range [k - 2, k + 1]
+     can be within the margin of distance.
+   */
+  k = std::floor((distance - m_intervals[0].m_begin) / m_period);
+  for(int j = -2; j <= 1; ++j)
+    {
+      float shift;
+
+      shift = (k + float(j)) * m_period;
+      for(unsigned int i = 0, endi = m_intervals.size(); i < endi; ++i)
+        {
+          float a, b;
+
+          a = m_intervals[i].m_begin + shift;
+          b = m_intervals[i].m_end + shift;
+          if(distance >= a + m_margin && distance <= b - m_margin)
+            {
+              return interior_piece;
+            }
+          else if(distance >= a - m_margin && distance <= b + m_margin)
+            {
+              return_value = boundary_piece;
+            }
+        }
+    }
+  return return_value;
+}
+
+void
+DashedEdgesFiller::
+process_sub_edge(fastuidraw::const_c_array<fastuidraw::PainterAttribute> quad)
+{
+  float d0, d1, k0, k1;
+  unsigned int half(m_points_per_segment / 2);
+
+  d0 = fastuidraw::unpack_float(quad[0].m_attrib1.y());
+  d1 = fastuidraw::unpack_float(quad[half].m_attrib1.y());
+
+  k0 = std::floor((d0 - m_intervals[0].m_begin) / m_period) - 2.0f;
+  k1 = std::floor((d1 - m_intervals[0].m_begin) / m_period) + 1.0f;
+  if(d1 <= d0 || 4.0f * (k1 - k0 + 1.0f) * float(m_intervals.size()) > float(max_cuts_per_sub_edge))
+    {
+      /* a degenerate sub-edge or a sub-edge across many
+         repeats of the dash pattern, not worth splitting.
+       */
+      add_piece(quad, 0.0f, 1.0f);
+      return;
+    }
+
+  /* cut at each point within the margin of a boundary of the
+     dash pattern; each piece between consecutive cuts is then
+     in a gap, within the margin of a boundary or in the interior
+     of an interval.
+   */
+  m_cuts.clear();
+  for(float k = k0; k <= k1; k += 1.0f)
+    {
+      for(unsigned int i = 0, endi = m_intervals.size(); i < endi; ++i)
+        {
+          float v[4];
+
+          v[0] = m_intervals[i].m_begin + k * m_period - m_margin;
+          v[1] = m_intervals[i].m_begin + k * m_period + m_margin;
+          v[2] = m_intervals[i].m_end + k * m_period - m_margin;
+          v[3] = m_intervals[i].m_end + k * m_period + m_margin;
+          for(unsigned int c = 0; c < 4; ++c)
+            {
+              if(v[c] > d0 && v[c] < d1)
+                {
+                  m_cuts.push_back(v[c]);
+                }
+            }
+        }
+    }
+  std::sort(m_cuts.begin(), m_cuts.end());
+  m_cuts.erase(std::unique(m_cuts.begin(), m_cuts.end()), m_cuts.end());
+  if(d1 - d0 < float(min_piece_length_in_margins) * m_margin * float(m_cuts.size() + 1))
+    {
+      add_piece(quad, 0.0f, 1.0f);
+      return;
+    }
+  m_cuts.push_back(d1);
+
+  /* merge consecutive pieces of the same kind and drop the
+     pieces in the gaps.
+   */
+  float start(d0), prev(d0), recip(1.0f / (d1 - d0));
+  enum piece_t current(classify(0.5f * (d0 + m_cuts[0])));
 
-      pts[2].m_pre_offset = sub_edge.m_bevel_lambda * sub_edge.m_normal;
-      pts[2].m_packed_data = pack_data(1, fastuidraw::StrokedPath::offset_start_sub_edge, depth)
-        | fastuidraw::StrokedPath::bevel_edge_mask;
+  for(unsigned int c = 0, endc = m_cuts.size(); c < endc; ++c)
+    {
+      enum piece_t tp;
 
-      for(unsigned int i = 0; i < 3; ++i)
+      if(m_cuts[c] <= prev)
         {
-          pts[i].fastuidraw::StrokedPath::point::pack_point(&attribute_data[vert_offset + i]);
+          continue;
         }
 
-      vert_offset += 3;
+      tp = classify(0.5f * (prev + m_cuts[c]));
+      if(tp != current)
+        {
+          if(current != gap_piece)
+            {
+              add_piece(quad, (start - d0) * recip, (prev - d0) * recip);
+            }
+          current = tp;
+          start = prev;
+        }
+      prev = m_cuts[c];
     }
 
-  /* The quad is:
-     (p, n, delta,  1),
-     (p,-n, delta,  1),
-     (p, 0,     0,  0),
-     (p_next,  n, -delta, 1),
-     (p_next, -n, -delta, 1),
-     (p_next,  0, 0)
-
-     Notice that we are encoding if it is
-     start or end of edge from the sign of
-     m_on_boundary.
-  */
-  for(unsigned int k = 0; k < 3; ++k)
+  if(current != gap_piece)
     {
-      pts[k].m_position = src_pts[sub_edge.m_pt0].m_p;
-      pts[k].m_distance_from_edge_start = src_pts[sub_edge.m_pt0].m_distance_from_edge_start;
-      pts[k].m_distance_from_contour_start = src_pts[sub_edge.m_pt0].m_distance_from_contour_start;
-      pts[k].m_edge_length = src_pts[sub_edge.m_pt0].m_edge_length;
-      pts[k].m_open_contour_length = src_pts[sub_edge.m_pt0].m_open_contour_length;
-      pts[k].m_closed_contour_length = src_pts[sub_edge.m_pt0].m_closed_contour_length;
-      pts[k].m_pre_offset = normal_sign[k] * sub_edge.m_normal;
-      pts[k].m_auxilary_offset = sub_edge.m_delta;
-      pts[k].m_packed_data = pack_data(boundary_values[k],
-                                       fastuidraw::StrokedPath::offset_start_sub_edge,
-                                       depth);
-
-      pts[k + 3].m_position = src_pts[sub_edge.m_pt1].m_p;
-      pts[k + 3].m_distance_from_edge_start = src_pts[sub_edge.m_pt1].m_distance_from_edge_start;
-      pts[k + 3].m_distance_from_contour_start = src_pts[sub_edge.m_pt1].m_distance_from_contour_start;
-      pts[k + 3].m_edge_length = src_pts[sub_edge.m_pt1].m_edge_length;
-      pts[k + 3].m_open_contour_length = src_pts[sub_edge.m_pt1].m_open_contour_length;
-      pts[k + 3].m_closed_contour_length = src_pts[sub_edge.m_pt1].m_closed_contour_length;
-      pts[k + 3].m_pre_offset = normal_sign[k] * sub_edge.m_normal;
-      pts[k + 3].m_auxilary_offset = -sub_edge.m_delta;
-      pts[k + 3].m_packed_data = pack_data(boundary_values[k],
-                                           fastuidraw::StrokedPath::offset_end_sub_edge,
-                                           depth);
+      add_piece(quad, (start - d0) * recip, 1.0f);
     }
+}
 
-  for(unsigned int i = 0; i < 6; ++i)
+void
+DashedEdgesFiller::
+add_piece(fastuidraw::const_c_array<fastuidraw::PainterAttribute> quad,
+          float t0, float t1)
+{
+  unsigned int half(m_points_per_segment / 2), v(m_attribs.size());
+
+  /* the first half of the points of a quad are at the start of
+     the sub-edge and the second half are at the end. The
+     auxilary offset of a sub-edge point is the vector to the
+     other end of the sub-edge, which the shader uses to get
+     the length of the sub-edge, so it is scaled to the piece.
+   */
+  for(unsigned int i = 0; i < m_points_per_segment; ++i)
     {
-      pts[i].fastuidraw::StrokedPath::point::pack_point(&attribute_data[vert_offset + i]);
-    }
+      fastuidraw::StrokedPath::point p0, p1, pt;
+      unsigned int k(i % half);
+      float t;
 
-  indices[index_offset + 0] = vert_offset + 0;
-  indices[index_offset + 1] = vert_offset + 2;
-  indices[index_offset + 2] = vert_offset + 5;
-  indices[index_offset + 3] = vert_offset + 0;
-  indices[index_offset + 4] = vert_offset + 5;
-  indices[index_offset + 5] = vert_offset + 3;
+      t = (i < half) ? t0 : t1;
+      fastuidraw::StrokedPath::point::unpack_point(&p0, quad[k]);
+      fastuidraw::StrokedPath::point::unpack_point(&p1, quad[k + half]);
+      pt = (i < half) ? p0 : p1;
 
-  indices[index_offset + 6] = vert_offset + 2;
-  indices[index_offset + 7] = vert_offset + 1;
-  indices[index_offset + 8] = vert_offset + 4;
-  indices[index_offset + 9] = vert_offset + 2;
-  indices[index_offset + 10] = vert_offset + 4;
-  indices[index_offset + 11] = vert_offset + 5;
+      pt.m_position = p0.m_position + t * (p1.m_position - p0.m_position);
+      pt.m_distance_from_edge_start = p0.m_distance_from_edge_start
+        + t * (p1.m_distance_from_edge_start - p0.m_distance_from_edge_start);
+      pt.m_distance_from_contour_start = p0.m_distance_from_contour_start
+        + t * (p1.m_distance_from_contour_start - p0.m_distance_from_contour_start);
+      pt.m_auxilary_offset *= (t1 - t0);
 
-  index_offset += EdgesElement::indices_per_segment_without_bevel;
-  vert_offset += EdgesElement::points_per_segment;
+      m_attribs.push_back(fastuidraw::PainterAttribute());
+      pt.pack_point(&m_attribs.back());
+    }
+
+  for(unsigned int i = 0, endi = m_quad_indices.size(); i < endi; ++i)
+    {
+      m_indices.push_back(v + m_quad_indices[i]);
+    }
 }
 
 /////////////////////////////////////////////////
 // JoinCreatorBase methods
-JoinCreatorBase::
+template<typename T>
+JoinCreatorBase<T>::
 JoinCreatorBase(const PathData &P):
   m_P(P),
   m_num_non_closed_verts(0u),
@@ -1615,8 +3045,9 @@ JoinCreatorBase(const PathData &P):
   m_post_ctor_initalized_called(false)
 {}
 
+template<typename T>
 void
-JoinCreatorBase::
+JoinCreatorBase<T>::
 post_ctor_initalize(void)
 {
   assert(!m_post_ctor_initalized_called);
@@ -1625,10 +3056,11 @@ post_ctor_initalize(void)
     {
       for(unsigned int e = 1; e + 1 < m_P.number_edges(o); ++e, ++m_num_joins)
         {
-          add_join(m_num_joins, m_P,
-                   m_P.m_per_contour_data[o].edge_data(e - 1).m_end_normal,
-                   m_P.m_per_contour_data[o].edge_data(e).m_begin_normal,
-                   o, e, m_num_non_closed_verts, m_num_non_closed_indices);
+          add_join_start(o, e);
+          static_cast<const T*>(this)->add_join(m_num_joins, m_P,
+                                                m_P.m_per_contour_data[o].edge_data(e - 1).m_end_normal,
+                                                m_P.m_per_contour_data[o].edge_data(e).m_begin_normal,
+                                                o, e, m_num_non_closed_verts, m_num_non_closed_indices);
         }
     }
 
@@ -1636,25 +3068,44 @@ post_ctor_initalize(void)
     {
       if(m_P.number_edges(o) >= 2)
         {
-          add_join(m_num_joins, m_P,
-                   m_P.m_per_contour_data[o].edge_data(m_P.number_edges(o) - 2).m_end_normal,
-                   m_P.m_per_contour_data[o].edge_data(m_P.number_edges(o) - 1).m_begin_normal,
-                   o, m_P.number_edges(o) - 1,
-                   m_num_closed_verts, m_num_closed_indices);
-
-          add_join(m_num_joins + 1, m_P,
-                   m_P.m_per_contour_data[o].m_edge_data_store.back().m_end_normal,
-                   m_P.m_per_contour_data[o].m_edge_data_store.front().m_begin_normal,
-                   o, m_P.number_edges(o),
-                   m_num_closed_verts, m_num_closed_indices);
+          add_join_start(o, m_P.number_edges(o) - 1);
+          static_cast<const T*>(this)->add_join(m_num_joins, m_P,
+                                                m_P.m_per_contour_data[o].edge_data(m_P.number_edges(o) - 2).m_end_normal,
+                                                m_P.m_per_contour_data[o].edge_data(m_P.number_edges(o) - 1).m_begin_normal,
+                                                o, m_P.number_edges(o) - 1,
+                                                m_num_closed_verts, m_num_closed_indices);
+
+          add_join_start(o, m_P.number_edges(o));
+          static_cast<const T*>(this)->add_join(m_num_joins + 1, m_P,
+                                                m_P.m_per_contour_data[o].m_edge_data_store.back().m_end_normal,
+                                                m_P.m_per_contour_data[o].m_edge_data_store.front().m_begin_normal,
+                                                o, m_P.number_edges(o),
+                                                m_num_closed_verts, m_num_closed_indices);
 
           m_num_joins += 2;
         }
     }
+  m_vertex_starts.push_back(m_num_non_closed_verts + m_num_closed_verts);
+  m_index_starts.push_back(m_num_non_closed_indices + m_num_closed_indices);
+}
+
+template<typename T>
+void
+JoinCreatorBase<T>::
+add_join_start(unsigned int contour, unsigned int edge)
+{
+  /* the joins are numbered in the order their data
+     is placed, with all joins not of the closing edges
+     before those of the closing edges.
+   */
+  m_vertex_starts.push_back(m_num_non_closed_verts + m_num_closed_verts);
+  m_index_starts.push_back(m_num_non_closed_indices + m_num_closed_indices);
+  m_join_contour_edge.push_back(fastuidraw::uvec2(contour, edge));
 }
 
+template<typename T>
 void
-JoinCreatorBase::
+JoinCreatorBase<T>::
 compute_sizes(unsigned int &num_attributes,
               unsigned int &num_indices,
               unsigned int &num_attribute_chunks,
@@ -1664,12 +3115,15 @@ compute_sizes(unsigned int &num_attributes,
   assert(m_post_ctor_initalized_called);
   num_attributes = m_num_non_closed_verts + m_num_closed_verts;
   num_indices = m_num_non_closed_indices + m_num_closed_indices;
-  num_attribute_chunks = num_index_chunks = m_num_joins + 2;
+  num_attribute_chunks = num_index_chunks = m_num_joins + 2
+    + m_P.m_join_hierarchy[0].number_chunks()
+    + m_P.m_join_hierarchy[1].number_chunks();
   number_z_increments = 2;
 }
 
+template<typename T>
 void
-JoinCreatorBase::
+JoinCreatorBase<T>::
 fill_join(unsigned int join_id,
           unsigned int contour, unsigned int edge,
           fastuidraw::c_array<fastuidraw::PainterAttribute> pts,
@@ -1684,7 +3138,7 @@ fill_join(unsigned int join_id,
 
   assert(join_id < m_num_joins);
   depth = m_num_joins - 1 - join_id;
-  fill_join_implement(join_id, m_P, contour, edge, pts, depth, indices, vertex_offset, index_offset);
+  static_cast<const T*>(this)->fill_join_implement(join_id, m_P, contour, edge, pts, depth, indices, vertex_offset, index_offset);
 
   K = join_id + fastuidraw::StrokedPath::join_chunk_start_individual_joins;
   attribute_chunks[K] = pts.sub_array(v, vertex_offset - v);
@@ -1692,8 +3146,32 @@ fill_join(unsigned int join_id,
   index_adjusts[K] = -int(v);
 }
 
+template<typename T>
+void
+JoinCreatorBase<T>::
+fill_job(unsigned int job,
+         fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+         fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
+         fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
+         fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterIndex> > index_chunks,
+         fastuidraw::c_array<unsigned int> zincrements,
+         fastuidraw::c_array<int> index_adjusts) const
+{
+  unsigned int vertex_offset(m_vertex_starts[job]), index_offset(m_index_starts[job]);
+
+  FASTUIDRAWunused(zincrements);
+  fill_join(job, m_join_contour_edge[job].x(), m_join_contour_edge[job].y(),
+            attribute_data, index_data,
+            vertex_offset, index_offset,
+            attribute_chunks, index_chunks,
+            index_adjusts);
+  assert(vertex_offset == m_vertex_starts[job + 1]);
+  assert(index_offset == m_index_starts[job + 1]);
+}
+
+template<typename T>
 void
-JoinCreatorBase::
+JoinCreatorBase<T>::
 fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
           fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
           fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
@@ -1701,11 +3179,10 @@ fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
           fastuidraw::c_array<unsigned int> zincrements,
           fastuidraw::c_array<int> index_adjusts) const
 {
-  unsigned int vertex_offset(0), index_offset(0), join_id(0);
-
   assert(attribute_data.size() == m_num_non_closed_verts + m_num_closed_verts);
   assert(index_data.size() == m_num_non_closed_indices + m_num_closed_indices);
 
+  /* the individual joins are filled by fill_job() */
   index_adjusts[fastuidraw::StrokedPath::join_chunk_without_closing_edge] = 0;
   zincrements[fastuidraw::StrokedPath::join_chunk_without_closing_edge] = m_num_joins;
   attribute_chunks[fastuidraw::StrokedPath::join_chunk_without_closing_edge] = attribute_data.sub_array(0, m_num_non_closed_verts);
@@ -1716,41 +3193,14 @@ fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
   attribute_chunks[fastuidraw::StrokedPath::join_chunk_with_closing_edge] = attribute_data.sub_array(0, m_num_non_closed_verts + m_num_closed_verts);
   index_chunks[fastuidraw::StrokedPath::join_chunk_with_closing_edge] = index_data.sub_array(0, m_num_non_closed_indices + m_num_closed_indices);
 
-  for(unsigned int o = 0; o < m_P.number_contours(); ++o)
-    {
-      for(unsigned int e = 1; e + 1 < m_P.number_edges(o); ++e, ++join_id)
-        {
-          fill_join(join_id, o, e,
-                    attribute_data, index_data,
-                    vertex_offset, index_offset,
-                    attribute_chunks, index_chunks,
-                    index_adjusts);
-        }
-    }
-  assert(vertex_offset == m_num_non_closed_verts);
-  assert(index_offset == m_num_non_closed_indices);
-
-  for(unsigned int o = 0; o < m_P.number_contours(); ++o)
+  for(unsigned int i = 0; i < 2; ++i)
     {
-      if(m_P.number_edges(o) >= 2)
-        {
-          fill_join(join_id, o, m_P.number_edges(o) - 1,
-                    attribute_data, index_data,
-                    vertex_offset, index_offset,
-                    attribute_chunks, index_chunks,
-                    index_adjusts);
-
-          fill_join(join_id + 1, o, m_P.number_edges(o),
-                    attribute_data, index_data,
-                    vertex_offset, index_offset,
-                    attribute_chunks, index_chunks,
-                    index_adjusts);
-
-          join_id += 2;
-        }
+      m_P.m_join_hierarchy[i].fill_chunks(fastuidraw::make_c_array(m_vertex_starts),
+                                          fastuidraw::make_c_array(m_index_starts),
+                                          attribute_data, index_data,
+                                          attribute_chunks, index_chunks,
+                                          index_adjusts);
     }
-  assert(vertex_offset == m_num_non_closed_verts + m_num_closed_verts);
-  assert(index_offset == m_num_non_closed_indices + m_num_closed_indices);
 }
 
 
@@ -2180,14 +3630,16 @@ fill_join_implement(unsigned int join_id,
 
 ///////////////////////////////////////////////
 // CapCreatorBase methods
-CapCreatorBase::
+template<typename T>
+CapCreatorBase<T>::
 CapCreatorBase(const PathData &P, PointIndexCapSize sz):
   m_P(P),
   m_size(sz)
 {}
 
+template<typename T>
 void
-CapCreatorBase::
+CapCreatorBase<T>::
 compute_sizes(unsigned int &num_attributes,
               unsigned int &num_indices,
               unsigned int &num_attribute_chunks,
@@ -2196,11 +3648,13 @@ compute_sizes(unsigned int &num_attributes,
 {
   num_attributes = m_size.m_verts;
   num_indices = m_size.m_indices;
-  number_z_increments = num_attribute_chunks = num_index_chunks = 1;
+  num_attribute_chunks = num_index_chunks = 1 + m_P.m_cap_hierarchy.number_chunks();
+  number_z_increments = 1;
 }
 
+template<typename T>
 void
-CapCreatorBase::
+CapCreatorBase<T>::
 fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
           fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
           fastuidraw::c_array<fastuidraw::const_c_array<fastuidraw::PainterAttribute> > attribute_chunks,
@@ -2209,21 +3663,28 @@ fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
           fastuidraw::c_array<int> index_adjusts) const
 {
   unsigned int vertex_offset(0u), index_offset(0u), depth;
+  std::vector<unsigned int> vertex_starts, index_starts;
 
   depth = 2 * m_P.number_contours();
   for(unsigned int o = 0; o < m_P.number_contours(); ++o, depth -= 2u)
     {
       assert(depth >= 2);
-      add_cap(m_P.m_per_contour_data[o].m_begin_cap_normal,
-              true, depth - 1, m_P.m_per_contour_data[o].m_start_contour_pt,
-              attribute_data, index_data,
-              vertex_offset, index_offset);
-
-      add_cap(m_P.m_per_contour_data[o].m_end_cap_normal,
-              false, depth - 2, m_P.m_per_contour_data[o].m_end_contour_pt,
-              attribute_data, index_data,
-              vertex_offset, index_offset);
+      vertex_starts.push_back(vertex_offset);
+      index_starts.push_back(index_offset);
+      static_cast<const T*>(this)->add_cap(m_P.m_per_contour_data[o].m_begin_cap_normal,
+                                           true, depth - 1, m_P.m_per_contour_data[o].m_start_contour_pt,
+                                           attribute_data, index_data,
+                                           vertex_offset, index_offset);
+
+      vertex_starts.push_back(vertex_offset);
+      index_starts.push_back(index_offset);
+      static_cast<const T*>(this)->add_cap(m_P.m_per_contour_data[o].m_end_cap_normal,
+                                           false, depth - 2, m_P.m_per_contour_data[o].m_end_contour_pt,
+                                           attribute_data, index_data,
+                                           vertex_offset, index_offset);
     }
+  vertex_starts.push_back(vertex_offset);
+  index_starts.push_back(index_offset);
 
   assert(vertex_offset == m_size.m_verts);
   assert(index_offset == m_size.m_indices);
@@ -2231,6 +3692,12 @@ fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
   index_chunks[0] = index_data;
   zincrements[0] = 2 * m_P.number_contours();
   index_adjusts[0] = 0;
+
+  m_P.m_cap_hierarchy.fill_chunks(fastuidraw::make_c_array(vertex_starts),
+                                  fastuidraw::make_c_array(index_starts),
+                                  attribute_data, index_data,
+                                  attribute_chunks, index_chunks,
+                                  index_adjusts);
 }
 
 ///////////////////////////////////////////////////
@@ -2561,96 +4028,401 @@ add_cap(const fastuidraw::vec2 &normal_from_stroking,
            pts, vertex_offset, indices, index_offset);
 }
 
-/////////////////////////////////////////////
-// StrokedPathPrivate methods
-StrokedPathPrivate::
-StrokedPathPrivate(const fastuidraw::TessellatedPath &P)
-{
-  create_edges(P);
-  m_bevel_joins.set_data(BevelJoinCreator(m_path_data));
-  m_miter_joins.set_data(MiterJoinCreator(m_path_data));
-  m_square_caps.set_data(SquareCapCreator(m_path_data));
-  m_adjustable_caps.set_data(AdjustableCapCreator(m_path_data));
-  m_effective_curve_distance_threshhold = P.effective_curve_distance_threshhold();
+/////////////////////////////////////////////
+// JoinCapJob methods
+void
+JoinCapJob::
+operator()(unsigned int begin, unsigned int end)
+{
+  for(unsigned int i = begin; i < end; ++i)
+    {
+      const JoinCapTask &task(m_tasks[i]);
+
+      switch(task.m_kind)
+        {
+        case JoinCapTask::bevel_joins:
+          task.m_dst->set_data(BevelJoinCreator(m_path_data));
+          break;
+        case JoinCapTask::miter_joins:
+          task.m_dst->set_data(MiterJoinCreator(m_path_data));
+          break;
+        case JoinCapTask::square_caps:
+          task.m_dst->set_data(SquareCapCreator(m_path_data));
+          break;
+        case JoinCapTask::adjustable_caps:
+          task.m_dst->set_data(AdjustableCapCreator(m_path_data));
+          break;
+        case JoinCapTask::rounded_joins:
+          task.m_dst->set_data(RoundedJoinCreator(m_path_data, task.m_thresh));
+          break;
+        case JoinCapTask::rounded_caps:
+          task.m_dst->set_data(RoundedCapCreator(m_path_data, task.m_thresh));
+          break;
+        }
+    }
+}
+
+/////////////////////////////////////////////
+// StrokedPathPrivate methods
+StrokedPathPrivate::
+StrokedPathPrivate(const fastuidraw::TessellatedPath &P,
+                   enum fastuidraw::StrokedPath::edge_format_t edge_format):
+  m_edge_format(edge_format),
+  m_max_threads(P.tessellation_parameters().m_max_threads),
+  m_rounded_cache_max_bytes(default_rounded_cache_max_bytes_value),
+  m_use_counter(0)
+{
+  std::vector<JoinCapTask> tasks;
+
+  create_edges(P);
+  m_path_data.ready_culling_hierarchies();
+
+  tasks.push_back(JoinCapTask(JoinCapTask::bevel_joins, &m_bevel_joins));
+  tasks.push_back(JoinCapTask(JoinCapTask::miter_joins, &m_miter_joins));
+  tasks.push_back(JoinCapTask(JoinCapTask::square_caps, &m_square_caps));
+  tasks.push_back(JoinCapTask(JoinCapTask::adjustable_caps, &m_adjustable_caps));
+  run_join_cap_tasks(tasks);
+
+  m_effective_curve_distance_threshhold = P.effective_curve_distance_threshhold();
+}
+
+StrokedPathPrivate::
+~StrokedPathPrivate()
+{
+  for(unsigned int i = 0, endi = m_rounded_joins.size(); i < endi; ++i)
+    {
+      FASTUIDRAWdelete(m_rounded_joins[i].m_data);
+    }
+
+  for(unsigned int i = 0, endi = m_rounded_caps.size(); i < endi; ++i)
+    {
+      FASTUIDRAWdelete(m_rounded_caps[i].m_data);
+    }
+
+  for(unsigned int i = 0, endi = m_dashed_edges.size(); i < endi; ++i)
+    {
+      FASTUIDRAWdelete(m_dashed_edges[i].m_data);
+    }
+
+  for(unsigned int i = 0; i < 2; ++i)
+    {
+      if(m_edge_culler[i] != NULL)
+        {
+          FASTUIDRAWdelete(m_edge_culler[i]);
+        }
+    }
+}
+
+void
+StrokedPathPrivate::
+write_to_blob(fastuidraw::detail::BlobWriter &dst) const
+{
+  dst.write_u32(StrokedPathBlobConstants::blob_magic);
+  dst.write_u32(StrokedPathBlobConstants::blob_version);
+  dst.write_float(m_effective_curve_distance_threshhold);
+  dst.write_u32(m_edge_format);
+  dst.write_u32(m_max_threads);
+
+  for(unsigned int i = 0; i < 2; ++i)
+    {
+      m_edge_culler[i]->write_to_blob(dst);
+      fastuidraw::detail::write_painter_attribute_data(dst, m_edges[i]);
+    }
+
+  fastuidraw::detail::write_painter_attribute_data(dst, m_bevel_joins);
+  fastuidraw::detail::write_painter_attribute_data(dst, m_miter_joins);
+  fastuidraw::detail::write_painter_attribute_data(dst, m_square_caps);
+  fastuidraw::detail::write_painter_attribute_data(dst, m_adjustable_caps);
+
+  dst.write_u32(m_path_data.number_contours());
+  for(unsigned int c = 0, endc = m_path_data.number_contours(); c < endc; ++c)
+    {
+      const PerContourData &C(m_path_data.m_per_contour_data[c]);
+
+      dst.write_vec2(C.m_begin_cap_normal);
+      dst.write_vec2(C.m_end_cap_normal);
+      write_point(dst, C.m_start_contour_pt);
+      write_point(dst, C.m_end_contour_pt);
+      dst.write_u32(C.m_edge_data_store.size());
+      for(unsigned int e = 0, ende = C.m_edge_data_store.size(); e < ende; ++e)
+        {
+          const PerEdgeData &E(C.m_edge_data_store[e]);
+
+          dst.write_vec2(E.m_begin_normal);
+          dst.write_vec2(E.m_end_normal);
+          write_point(dst, E.m_start_pt);
+          write_point(dst, E.m_end_pt);
+        }
+    }
+}
+
+StrokedPathPrivate*
+StrokedPathPrivate::
+create_from_blob(fastuidraw::const_c_array<uint8_t> blob)
+{
+  StrokedPathPrivate *d;
+  unsigned int num_contours;
+
+  d = FASTUIDRAWnew StrokedPathPrivate();
+  fastuidraw::detail::BlobReader src(blob, d->m_blob_words);
+
+  if(src.read_u32() != StrokedPathBlobConstants::blob_magic
+     || src.read_u32() != StrokedPathBlobConstants::blob_version)
+    {
+      src.fail();
+    }
+  d->m_effective_curve_distance_threshhold = src.read_float();
+  switch(src.read_u32())
+    {
+    case fastuidraw::StrokedPath::full_edge_format:
+      d->m_edge_format = fastuidraw::StrokedPath::full_edge_format;
+      break;
+    case fastuidraw::StrokedPath::compact_edge_format:
+      d->m_edge_format = fastuidraw::StrokedPath::compact_edge_format;
+      break;
+    default:
+      src.fail();
+    }
+  d->m_max_threads = src.read_u32();
+
+  for(unsigned int i = 0; i < 2 && !src.failed(); ++i)
+    {
+      d->m_edge_culler[i] = EdgesElement::create_from_blob(src);
+      fastuidraw::detail::read_painter_attribute_data(src, d->m_edges[i]);
+
+      /* the chunks named by the EdgesElement hierarchy
+         are used to index the chunks of m_edges[i], reject
+         the blob the same way a malformed PainterAttributeData
+         is rejected.
+       */
+      if(d->m_edge_culler[i] != NULL && !src.failed())
+        {
+          if(d->m_edge_culler[i]->consistent_with(d->m_edges[i]))
+            {
+              d->m_edge_culler[i]->flatten(d->m_edge_hierarchy[i]);
+              d->m_edge_hierarchy[i].finalize();
+            }
+          else
+            {
+              src.fail();
+            }
+        }
+    }
+
+  fastuidraw::detail::read_painter_attribute_data(src, d->m_bevel_joins);
+  fastuidraw::detail::read_painter_attribute_data(src, d->m_miter_joins);
+  fastuidraw::detail::read_painter_attribute_data(src, d->m_square_caps);
+  fastuidraw::detail::read_painter_attribute_data(src, d->m_adjustable_caps);
+
+  num_contours = src.read_u32();
+  for(unsigned int c = 0; c < num_contours && !src.failed(); ++c)
+    {
+      unsigned int num_edges;
+
+      d->m_path_data.m_per_contour_data.push_back(PerContourData());
+      PerContourData &C(d->m_path_data.m_per_contour_data.back());
+
+      C.m_begin_cap_normal = src.read_vec2();
+      C.m_end_cap_normal = src.read_vec2();
+      C.m_start_contour_pt = read_point(src);
+      C.m_end_contour_pt = read_point(src);
+
+      /* PerContourData::edge_data() requires at least one edge
+       */
+      num_edges = src.read_u32();
+      if(num_edges == 0)
+        {
+          src.fail();
+        }
+
+      for(unsigned int e = 0; e < num_edges && !src.failed(); ++e)
+        {
+          C.m_edge_data_store.push_back(PerEdgeData());
+          PerEdgeData &E(C.m_edge_data_store.back());
+
+          E.m_begin_normal = src.read_vec2();
+          E.m_end_normal = src.read_vec2();
+          E.m_start_pt = read_point(src);
+          E.m_end_pt = read_point(src);
+        }
+    }
+
+  /* the chunks selected by join_chunks() and cap_chunks()
+     must be present in the join and cap data.
+   */
+  if(!src.failed())
+    {
+      d->m_path_data.ready_culling_hierarchies();
+      if(d->m_bevel_joins.index_data_chunks().size() != d->m_path_data.m_join_hierarchy[1].end_chunk()
+         || d->m_miter_joins.index_data_chunks().size() != d->m_path_data.m_join_hierarchy[1].end_chunk()
+         || d->m_square_caps.index_data_chunks().size() != d->m_path_data.m_cap_hierarchy.end_chunk()
+         || d->m_adjustable_caps.index_data_chunks().size() != d->m_path_data.m_cap_hierarchy.end_chunk())
+        {
+          src.fail();
+        }
+    }
+
+  if(src.failed())
+    {
+      FASTUIDRAWdelete(d);
+      return NULL;
+    }
+  return d;
+}
+
+void
+StrokedPathPrivate::
+create_edges(const fastuidraw::TessellatedPath &P)
+{
+  EdgeStore edge_store(P, m_path_data);
+  bool compact(m_edge_format == fastuidraw::StrokedPath::compact_edge_format);
+
+  for(unsigned int i = 0; i < 2; ++i)
+    {
+      SubEdgeCullingHierarchy *s;
+      s = FASTUIDRAWnew SubEdgeCullingHierarchy(edge_store.bounding_box(i != 0),
+                                                edge_store.sub_edges(i != 0),
+                                                P.point_positions());
+      m_edge_culler[i] = EdgesElement::create(s, compact);
+      m_edge_culler[i]->flatten(m_edge_hierarchy[i]);
+      m_edge_hierarchy[i].finalize();
+      m_edges[i].set_data(EdgesElementFiller(m_edge_culler[i], P, compact), m_max_threads);
+      FASTUIDRAWdelete(s);
+    }
+}
+
+void
+StrokedPathPrivate::
+run_join_cap_tasks(const std::vector<JoinCapTask> &tasks)
+{
+  JoinCapJob job(m_path_data, tasks);
+  fastuidraw::run_in_parallel(tasks.size(), m_max_threads, 1, job);
+}
+
+float
+StrokedPathPrivate::
+level_threshhold(float thresh)
+{
+  float t(1.0f);
+
+  /* we set a hard tolerance of 1e-6. Should we
+     set it as a ratio of the bounding box of
+     the underlying tessellated path?
+   */
+  thresh = fastuidraw::t_max(thresh, float(1e-6));
+  while(t > thresh)
+    {
+      t *= 0.5f;
+    }
+  return t;
+}
+
+std::vector<ThreshWithData>::iterator
+StrokedPathPrivate::
+find_level(float t, std::vector<ThreshWithData> &values)
+{
+  return std::lower_bound(values.begin(), values.end(), t,
+                          ThreshWithData::reverse_compare_against_thresh);
+}
+
+template<typename T>
+fastuidraw::PainterAttributeData*
+StrokedPathPrivate::
+fetch_level(float t, std::vector<ThreshWithData> &values,
+            enum JoinCapTask::kind_t kind,
+            std::vector<JoinCapTask> *tasks)
+{
+  std::vector<ThreshWithData>::iterator iter;
+
+  iter = find_level(t, values);
+  if(iter == values.end() || iter->m_thresh != t)
+    {
+      fastuidraw::PainterAttributeData *newD;
+
+      newD = FASTUIDRAWnew fastuidraw::PainterAttributeData();
+      if(tasks)
+        {
+          tasks->push_back(JoinCapTask(kind, newD, t));
+        }
+      else
+        {
+          newD->set_data(T(m_path_data, t));
+        }
+      iter = values.insert(iter, ThreshWithData(newD, t));
+    }
+
+  assert(iter->m_data != NULL);
+  iter->m_last_use = m_use_counter;
+  return iter->m_data;
 }
 
+unsigned int
 StrokedPathPrivate::
-~StrokedPathPrivate()
+rounded_cache_bytes(void) const
 {
+  unsigned int return_value(0);
   for(unsigned int i = 0, endi = m_rounded_joins.size(); i < endi; ++i)
     {
-      FASTUIDRAWdelete(m_rounded_joins[i].m_data);
+      return_value += m_rounded_joins[i].m_data->number_bytes();
     }
-
   for(unsigned int i = 0, endi = m_rounded_caps.size(); i < endi; ++i)
     {
-      FASTUIDRAWdelete(m_rounded_caps[i].m_data);
+      return_value += m_rounded_caps[i].m_data->number_bytes();
     }
-  FASTUIDRAWdelete(m_edge_culler[0]);
-  FASTUIDRAWdelete(m_edge_culler[1]);
+  return return_value;
 }
 
 void
 StrokedPathPrivate::
-create_edges(const fastuidraw::TessellatedPath &P)
+evict_rounded(float protected_level)
 {
-  EdgeStore edge_store(P, m_path_data);
-
-  for(unsigned int i = 0; i < 2; ++i)
+  while(m_rounded_cache_max_bytes > 0 && rounded_cache_bytes() > m_rounded_cache_max_bytes)
     {
-      SubEdgeCullingHierarchy *s;
-      s = FASTUIDRAWnew SubEdgeCullingHierarchy(edge_store.bounding_box(i != 0),
-                                                edge_store.sub_edges(i != 0),
-                                                P.point_data());
-      m_edge_culler[i] = EdgesElement::create(s);
-      m_edges[i].set_data(EdgesElementFiller(m_edge_culler[i], P));
-      FASTUIDRAWdelete(s);
+      std::vector<ThreshWithData> *victim_values(NULL);
+      unsigned int victim(0);
+      fastuidraw::vecN<std::vector<ThreshWithData>*, 2> lists(&m_rounded_joins, &m_rounded_caps);
+
+      for(unsigned int L = 0; L < 2; ++L)
+        {
+          std::vector<ThreshWithData> &values(*lists[L]);
+          for(unsigned int i = 0, endi = values.size(); i < endi; ++i)
+            {
+              if(values[i].m_last_use != m_use_counter
+                 && values[i].m_thresh != protected_level
+                 && (victim_values == NULL || values[i].m_last_use < (*victim_values)[victim].m_last_use))
+                {
+                  victim_values = &values;
+                  victim = i;
+                }
+            }
+        }
+
+      if(victim_values == NULL)
+        {
+          break;
+        }
+
+      FASTUIDRAWdelete((*victim_values)[victim].m_data);
+      victim_values->erase(victim_values->begin() + victim);
     }
 }
 
 template<typename T>
 const fastuidraw::PainterAttributeData&
 StrokedPathPrivate::
-fetch_create(float thresh, std::vector<ThreshWithData> &values)
+fetch_create(float thresh, std::vector<ThreshWithData> &values,
+             enum JoinCapTask::kind_t kind)
 {
-  if(values.empty())
-    {
-      fastuidraw::PainterAttributeData *newD;
-      newD = FASTUIDRAWnew fastuidraw::PainterAttributeData();
-      newD->set_data(T(m_path_data, 1.0f));
-      values.push_back(ThreshWithData(newD, 1.0f));
-    }
+  fastuidraw::PainterAttributeData *return_value;
+  float level(level_threshhold(thresh));
 
-  /* we set a hard tolerance of 1e-6. Should we
-     set it as a ratio of the bounding box of
-     the underlying tessellated path?
+  /* only the level of thresh is made; the coarser
+     levels are made only if they are asked for.
    */
-  thresh = fastuidraw::t_max(thresh, float(1e-6));
-  if(values.back().m_thresh <= thresh)
-    {
-      std::vector<ThreshWithData>::const_iterator iter;
-      iter = std::lower_bound(values.begin(), values.end(), thresh,
-                              ThreshWithData::reverse_compare_against_thresh);
-      assert(iter != values.end());
-      assert(iter->m_thresh <= thresh);
-      assert(iter->m_data != NULL);
-      return *iter->m_data;
-    }
-  else
-    {
-      float t;
-      t = values.back().m_thresh;
-      while(t > thresh)
-        {
-          fastuidraw::PainterAttributeData *newD;
-
-          t *= 0.5f;
-          newD = FASTUIDRAWnew fastuidraw::PainterAttributeData();
-          newD->set_data(T(m_path_data, t));
-          values.push_back(ThreshWithData(newD, t));
-        }
-      return *values.back().m_data;
-    }
+  ++m_use_counter;
+  return_value = fetch_level<T>(level, values, kind, NULL);
+  evict_rounded(level);
+  return *return_value;
 }
 
 //////////////////////////////////////
@@ -2810,10 +4582,17 @@ chunk_for_named_join(unsigned int J)
 }
 
 fastuidraw::StrokedPath::
-StrokedPath(const fastuidraw::TessellatedPath &P)
+StrokedPath(const fastuidraw::TessellatedPath &P,
+            enum edge_format_t edge_format)
 {
   assert(number_offset_types < FASTUIDRAW_MAX_VALUE_FROM_NUM_BITS(offset_type_num_bits));
-  m_d = FASTUIDRAWnew StrokedPathPrivate(P);
+  m_d = FASTUIDRAWnew StrokedPathPrivate(P, edge_format);
+}
+
+fastuidraw::StrokedPath::
+StrokedPath(void *d):
+  m_d(d)
+{
 }
 
 fastuidraw::StrokedPath::
@@ -2825,6 +4604,62 @@ fastuidraw::StrokedPath::
   m_d = NULL;
 }
 
+uint32_t
+fastuidraw::StrokedPath::
+blob_version(void)
+{
+  return StrokedPathBlobConstants::blob_version;
+}
+
+void
+fastuidraw::StrokedPath::
+serialize(std::vector<uint8_t> &dst) const
+{
+  StrokedPathPrivate *d;
+  detail::BlobWriter writer;
+
+  d = static_cast<StrokedPathPrivate*>(m_d);
+  d->write_to_blob(writer);
+  writer.finish(dst);
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::StrokedPath>
+fastuidraw::StrokedPath::
+create_from_blob(const_c_array<uint8_t> blob)
+{
+  StrokedPathPrivate *d;
+
+  d = StrokedPathPrivate::create_from_blob(blob);
+  if(d == NULL)
+    {
+      return reference_counted_ptr<StrokedPath>();
+    }
+  return FASTUIDRAWnew StrokedPath(d);
+}
+
+enum fastuidraw::StrokedPath::edge_format_t
+fastuidraw::StrokedPath::
+edge_format(void) const
+{
+  StrokedPathPrivate *d;
+  d = static_cast<StrokedPathPrivate*>(m_d);
+  return d->m_edge_format;
+}
+
+enum fastuidraw::StrokedPath::edge_format_t
+fastuidraw::StrokedPath::
+default_edge_format(void)
+{
+  return default_edge_format_value;
+}
+
+void
+fastuidraw::StrokedPath::
+default_edge_format(enum edge_format_t v)
+{
+  default_edge_format_value = v;
+}
+
 float
 fastuidraw::StrokedPath::
 effective_curve_distance_threshhold(void) const
@@ -2843,9 +4678,93 @@ edges(bool include_closing_edges) const
   return d->m_edges[include_closing_edges];
 }
 
+const fastuidraw::PainterAttributeData&
+fastuidraw::StrokedPath::
+dashed_edges(const_c_array<range_type<float> > draw_intervals,
+             float period, float margin,
+             bool include_closing_edges) const
+{
+  StrokedPathPrivate *d;
+  d = static_cast<StrokedPathPrivate*>(m_d);
+
+  /* the number of dash patterns for which the data is kept
+   */
+  const unsigned int max_cached_patterns = 8;
+  float max_gap(0.0f);
+
+  margin = t_max(margin, 0.0f);
+  if(period > 0.0f && !draw_intervals.empty())
+    {
+      for(unsigned int i = 0, endi = draw_intervals.size(); i < endi; ++i)
+        {
+          float next_begin;
+
+          next_begin = (i + 1 < endi) ?
+            draw_intervals[i + 1].m_begin :
+            draw_intervals[0].m_begin + period;
+          max_gap = t_max(max_gap, next_begin - draw_intervals[i].m_end);
+        }
+    }
+
+  if(max_gap <= 2.0f * margin)
+    {
+      return d->m_edges[include_closing_edges];
+    }
+
+  for(unsigned int i = 0, endi = d->m_dashed_edges.size(); i < endi; ++i)
+    {
+      if(d->m_dashed_edges[i].matches(draw_intervals, period, margin, include_closing_edges))
+        {
+          return *d->m_dashed_edges[i].m_data;
+        }
+    }
+
+  if(d->m_dashed_edges.size() >= max_cached_patterns)
+    {
+      FASTUIDRAWdelete(d->m_dashed_edges.front().m_data);
+      d->m_dashed_edges.erase(d->m_dashed_edges.begin());
+    }
+
+  DashedEdgesEntry entry;
+  entry.m_intervals.resize(draw_intervals.size());
+  std::copy(draw_intervals.begin(), draw_intervals.end(), entry.m_intervals.begin());
+  entry.m_period = period;
+  entry.m_margin = margin;
+  entry.m_include_closing_edges = include_closing_edges;
+  entry.m_data = FASTUIDRAWnew PainterAttributeData();
+  entry.m_data->set_data(DashedEdgesFiller(d->m_edge_culler[include_closing_edges],
+                                           d->m_edges[include_closing_edges],
+                                           d->m_edge_format == compact_edge_format,
+                                           draw_intervals, period, margin));
+  d->m_dashed_edges.push_back(entry);
+
+  return *entry.m_data;
+}
+
+unsigned int
+fastuidraw::StrokedPath::
+edge_chunks(ScratchSpace &work_room,
+            const_c_array<vec3> clip_equations,
+            const float3x3 &clip_matrix_local,
+            const vec2 &recip_dimensions,
+            float pixels_additional_room,
+            float item_space_additional_room,
+            bool include_closing_edges,
+            unsigned int max_attribute_cnt,
+            unsigned int max_index_cnt,
+            c_array<unsigned int> dst) const
+{
+  return edge_chunks(work_room, edges(include_closing_edges),
+                     clip_equations, clip_matrix_local,
+                     recip_dimensions, pixels_additional_room,
+                     item_space_additional_room, include_closing_edges,
+                     max_attribute_cnt, max_index_cnt, dst);
+}
+
 unsigned int
 fastuidraw::StrokedPath::
 edge_chunks(ScratchSpace &work_room,
+            const PainterAttributeData &edge_data,
             const_c_array<vec3> clip_equations,
             const float3x3 &clip_matrix_local,
             const vec2 &recip_dimensions,
@@ -2857,15 +4776,14 @@ edge_chunks(ScratchSpace &work_room,
             c_array<unsigned int> dst) const
 {
   StrokedPathPrivate *d;
-  EdgesElement *e;
   d = static_cast<StrokedPathPrivate*>(m_d);
-  e = d->m_edge_culler[include_closing_edges];
-  return e->edge_chunks(*static_cast<ScratchSpacePrivate*>(work_room.m_d),
-                        clip_equations, clip_matrix_local,
-                        recip_dimensions, pixels_additional_room,
-                        item_space_additional_room,
-                        max_attribute_cnt, max_index_cnt,
-                        dst);
+  return d->m_edge_hierarchy[include_closing_edges].select_chunks(*static_cast<ScratchSpacePrivate*>(work_room.m_d),
+                                                                  edge_data,
+                                                                  clip_equations, clip_matrix_local,
+                                                                  recip_dimensions, pixels_additional_room,
+                                                                  item_space_additional_room,
+                                                                  max_attribute_cnt, max_index_cnt,
+                                                                  dst);
 }
 
 unsigned int
@@ -2878,6 +4796,74 @@ maximum_edge_chunks(void) const
                d->m_edge_culler[1]->maximum_edge_chunks());
 }
 
+unsigned int
+fastuidraw::StrokedPath::
+join_chunks(ScratchSpace &work_room,
+            const PainterAttributeData &join_data,
+            const_c_array<vec3> clip_equations,
+            const float3x3 &clip_matrix_local,
+            const vec2 &recip_dimensions,
+            float pixels_additional_room,
+            float item_space_additional_room,
+            bool include_joins_from_closing_edge,
+            unsigned int max_attribute_cnt,
+            unsigned int max_index_cnt,
+            c_array<unsigned int> dst) const
+{
+  StrokedPathPrivate *d;
+  d = static_cast<StrokedPathPrivate*>(m_d);
+  return d->m_path_data.m_join_hierarchy[include_joins_from_closing_edge].culler().select_chunks(*static_cast<ScratchSpacePrivate*>(work_room.m_d),
+                                                                                                 join_data,
+                                                                                                 clip_equations, clip_matrix_local,
+                                                                                                 recip_dimensions, pixels_additional_room,
+                                                                                                 item_space_additional_room,
+                                                                                                 max_attribute_cnt, max_index_cnt,
+                                                                                                 dst);
+}
+
+unsigned int
+fastuidraw::StrokedPath::
+maximum_join_chunks(void) const
+{
+  StrokedPathPrivate *d;
+  d = static_cast<StrokedPathPrivate*>(m_d);
+  return t_max(d->m_path_data.m_join_hierarchy[0].culler().number_elements(),
+               d->m_path_data.m_join_hierarchy[1].culler().number_elements());
+}
+
+unsigned int
+fastuidraw::StrokedPath::
+cap_chunks(ScratchSpace &work_room,
+           const PainterAttributeData &cap_data,
+           const_c_array<vec3> clip_equations,
+           const float3x3 &clip_matrix_local,
+           const vec2 &recip_dimensions,
+           float pixels_additional_room,
+           float item_space_additional_room,
+           unsigned int max_attribute_cnt,
+           unsigned int max_index_cnt,
+           c_array<unsigned int> dst) const
+{
+  StrokedPathPrivate *d;
+  d = static_cast<StrokedPathPrivate*>(m_d);
+  return d->m_path_data.m_cap_hierarchy.culler().select_chunks(*static_cast<ScratchSpacePrivate*>(work_room.m_d),
+                                                              cap_data,
+                                                              clip_equations, clip_matrix_local,
+                                                              recip_dimensions, pixels_additional_room,
+                                                              item_space_additional_room,
+                                                              max_attribute_cnt, max_index_cnt,
+                                                              dst);
+}
+
+unsigned int
+fastuidraw::StrokedPath::
+maximum_cap_chunks(void) const
+{
+  StrokedPathPrivate *d;
+  d = static_cast<StrokedPathPrivate*>(m_d);
+  return d->m_path_data.m_cap_hierarchy.culler().number_elements();
+}
+
 unsigned int
 fastuidraw::StrokedPath::
 z_increment_edge(bool include_closing_edges) const
@@ -2928,7 +4914,63 @@ rounded_joins(float thresh) const
   StrokedPathPrivate *d;
   d = static_cast<StrokedPathPrivate*>(m_d);
 
-  return d->fetch_create<RoundedJoinCreator>(thresh, d->m_rounded_joins);
+  return d->fetch_create<RoundedJoinCreator>(thresh, d->m_rounded_joins,
+                                                  JoinCapTask::rounded_joins);
+}
+
+void
+fastuidraw::StrokedPath::
+warm_rounded(float thresh) const
+{
+  StrokedPathPrivate *d;
+  std::vector<JoinCapTask> tasks;
+  float level;
+
+  d = static_cast<StrokedPathPrivate*>(m_d);
+  level = StrokedPathPrivate::level_threshhold(thresh);
+
+  ++d->m_use_counter;
+  for(float t = 1.0f; t >= level; t *= 0.5f)
+    {
+      d->fetch_level<RoundedJoinCreator>(t, d->m_rounded_joins,
+                                         JoinCapTask::rounded_joins, &tasks);
+      d->fetch_level<RoundedCapCreator>(t, d->m_rounded_caps,
+                                        JoinCapTask::rounded_caps, &tasks);
+    }
+  d->run_join_cap_tasks(tasks);
+  d->evict_rounded(level);
+}
+
+unsigned int
+fastuidraw::StrokedPath::
+rounded_cache_bytes(void) const
+{
+  StrokedPathPrivate *d;
+  d = static_cast<StrokedPathPrivate*>(m_d);
+  return d->rounded_cache_bytes();
+}
+
+unsigned int
+fastuidraw::StrokedPath::
+rounded_cache_max_bytes(void) const
+{
+  StrokedPathPrivate *d;
+  d = static_cast<StrokedPathPrivate*>(m_d);
+  return d->m_rounded_cache_max_bytes;
+}
+
+unsigned int
+fastuidraw::StrokedPath::
+default_rounded_cache_max_bytes(void)
+{
+  return default_rounded_cache_max_bytes_value;
+}
+
+void
+fastuidraw::StrokedPath::
+default_rounded_cache_max_bytes(unsigned int v)
+{
+  default_rounded_cache_max_bytes_value = v;
 }
 
 const fastuidraw::PainterAttributeData&
@@ -2937,5 +4979,105 @@ rounded_caps(float thresh) const
 {
   StrokedPathPrivate *d;
   d = static_cast<StrokedPathPrivate*>(m_d);
-  return d->fetch_create<RoundedCapCreator>(thresh, d->m_rounded_caps);
+  return d->fetch_create<RoundedCapCreator>(thresh, d->m_rounded_caps,
+                                                 JoinCapTask::rounded_caps);
+}
+
+bool
+fastuidraw::StrokedPath::
+hit_test(ScratchSpace &scratch_space, const vec2 &pt, float stroke_width,
+         enum PainterEnums::join_style js, enum PainterEnums::cap_style cp,
+         bool close_contours, float miter_limit) const
+{
+  StrokedPathPrivate *d;
+  ScratchSpacePrivate &scratch(*static_cast<ScratchSpacePrivate*>(scratch_space.m_d));
+  float radius(0.5f * t_abs(stroke_width));
+  std::vector<unsigned int> &chunks(scratch.m_hit_chunks);
+
+  d = static_cast<StrokedPathPrivate*>(m_d);
+
+  /* edges */
+  chunks.clear();
+  d->m_edge_hierarchy[close_contours].chunks_containing(pt, radius, chunks);
+  for(unsigned int i = 0; i < chunks.size(); ++i)
+    {
+      if(stroked_chunk_contains(d->m_edges[close_contours], chunks[i], pt,
+                                radius, miter_limit, scratch.m_hit_positions))
+        {
+          return true;
+        }
+    }
+
+  /* joins, the bounding boxes of the joins are of the
+     join points only.
+   */
+  if(js != PainterEnums::no_joins)
+    {
+      const PainterAttributeData *join_data;
+      float room(radius);
+
+      if(js == PainterEnums::miter_joins)
+        {
+          join_data = &d->m_miter_joins;
+          room = (miter_limit >= 0.0f) ?
+            radius * t_sqrt(1.0f + miter_limit * miter_limit) :
+            std::numeric_limits<float>::max();
+        }
+      else
+        {
+          join_data = &d->m_bevel_joins;
+        }
+
+      chunks.clear();
+      d->m_path_data.m_join_hierarchy[close_contours].culler().chunks_containing(pt, room, chunks);
+      for(unsigned int i = 0; i < chunks.size(); ++i)
+        {
+          bool hit;
+
+          if(js == PainterEnums::rounded_joins)
+            {
+              hit = chunk_point_within(*join_data, chunks[i], pt, radius);
+            }
+          else
+            {
+              hit = stroked_chunk_contains(*join_data, chunks[i], pt, radius,
+                                           miter_limit, scratch.m_hit_positions);
+            }
+
+          if(hit)
+            {
+              return true;
+            }
+        }
+    }
+
+  /* caps, a square cap extends by the radius along
+     both the edge and its normal.
+   */
+  if(!close_contours && cp != PainterEnums::flat_caps)
+    {
+      chunks.clear();
+      d->m_path_data.m_cap_hierarchy.culler().chunks_containing(pt, 2.0f * radius, chunks);
+      for(unsigned int i = 0; i < chunks.size(); ++i)
+        {
+          bool hit;
+
+          if(cp == PainterEnums::rounded_caps)
+            {
+              hit = chunk_point_within(d->m_square_caps, chunks[i], pt, radius);
+            }
+          else
+            {
+              hit = stroked_chunk_contains(d->m_square_caps, chunks[i], pt, radius,
+                                           miter_limit, scratch.m_hit_positions);
+            }
+
+          if(hit)
+            {
+              return true;
+            }
+        }
+    }
+
+  return false;
 }
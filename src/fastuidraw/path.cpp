@@ -19,11 +19,16 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <typeinfo>
 #include <vector>
 #include <fastuidraw/path.hpp>
 #include <fastuidraw/tessellated_path.hpp>
 #include "private/util_private.hpp"
 #include "private/path_util_private.hpp"
+#include "private/small_vector.hpp"
 
 namespace
 {
@@ -117,6 +122,78 @@ namespace
     return fastuidraw::t_sqrt(fastuidraw::t_max(0.0f, a_p_mag_sq - d_sq / b_a_mag_sq));
   }
 
+  /* The tessellators write the points directly to the span
+     passed to dump() (which holds TessellationParams::m_max_segments
+     + 1 points) in order of time, so that no sorting and no heap
+     allocation is needed to tessellate an edge. The recursion depth
+     is bounded by log2(m_max_segments), doing so guarantees that
+     the number of points never exceeds the size of the span.
+   */
+  inline
+  void
+  union_point(const fastuidraw::vec2 &p,
+              fastuidraw::vec2 &min_bb, fastuidraw::vec2 &max_bb)
+  {
+    min_bb.x() = fastuidraw::t_min(min_bb.x(), p.x());
+    min_bb.y() = fastuidraw::t_min(min_bb.y(), p.y());
+
+    max_bb.x() = fastuidraw::t_max(max_bb.x(), p.x());
+    max_bb.y() = fastuidraw::t_max(max_bb.y(), p.y());
+  }
+
+  inline
+  void
+  union_box(const fastuidraw::vec2 &p0, const fastuidraw::vec2 &p1,
+            fastuidraw::vec2 &min_bb, fastuidraw::vec2 &max_bb)
+  {
+    union_point(p0, min_bb, max_bb);
+    union_point(p1, min_bb, max_bb);
+  }
+
+  /* Writes to out the roots of a * t * t + b * t + c
+     that are strictly between 0 and 1, returning how
+     many were written.
+   */
+  unsigned int
+  roots_in_unit_interval(float a, float b, float c,
+                         fastuidraw::vecN<float, 2> &out)
+  {
+    unsigned int return_value(0);
+    const float epsilon(1e-6f);
+
+    if(fastuidraw::t_abs(a) < epsilon)
+      {
+        if(fastuidraw::t_abs(b) >= epsilon)
+          {
+            out[return_value++] = -c / b;
+          }
+      }
+    else
+      {
+        float desc;
+
+        desc = b * b - 4.0f * a * c;
+        if(desc >= 0.0f)
+          {
+            float r;
+
+            r = fastuidraw::t_sqrt(desc);
+            out[return_value++] = (-b + r) / (2.0f * a);
+            out[return_value++] = (-b - r) / (2.0f * a);
+          }
+      }
+
+    unsigned int kept(0);
+    for(unsigned int i = 0; i < return_value; ++i)
+      {
+        if(out[i] > 0.0f && out[i] < 1.0f)
+          {
+            out[kept++] = out[i];
+          }
+      }
+    return kept;
+  }
+
   class TessellatorBase:fastuidraw::noncopyable
   {
   public:
@@ -125,7 +202,8 @@ namespace
       m_h(h),
       m_thresh(tess_params.m_threshhold),
       m_max_recursion(fastuidraw::uint32_log2(tess_params.m_max_segments)),
-      m_max_size(tess_params.m_max_segments + 1)
+      m_max_size(tess_params.m_max_segments + 1),
+      m_num_points(0)
     {
     }
 
@@ -143,10 +221,20 @@ namespace
     float m_thresh;
     unsigned int m_max_recursion, m_max_size;
 
+    void
+    add_point(const analytic_point_data &pt)
+    {
+      assert(m_num_points < m_out_data.size());
+      m_out_data[m_num_points++] = pt;
+    }
+
     virtual
-    unsigned int
-    fill_data(fastuidraw::c_array<fastuidraw::TessellatedPath::point> out_data,
-              float *out_effective_curve_distance, float *out_effective_curvature) = 0;
+    void
+    fill_data(float *out_effective_curve_distance, float *out_effective_curvature) = 0;
+
+  private:
+    fastuidraw::c_array<fastuidraw::TessellatedPath::point> m_out_data;
+    unsigned int m_num_points;
   };
 
   class TessellatorCurvature:public TessellatorBase
@@ -160,17 +248,14 @@ namespace
     }
 
   private:
-    std::vector<analytic_point_data> m_data;
-
     void
-    tessellation_worker(unsigned int idx_p, unsigned int idx_q,
+    tessellation_worker(const analytic_point_data &start, const analytic_point_data &end,
                         unsigned int recursion_level,
                         float *out_effective_curve_distance, float *out_effective_curvature);
 
     virtual
-    unsigned int
-    fill_data(fastuidraw::c_array<fastuidraw::TessellatedPath::point> out_data,
-              float *out_effective_curve_distance, float *out_effective_curvature);
+    void
+    fill_data(float *out_effective_curve_distance, float *out_effective_curvature);
   };
 
   class TessellatorDistance:public TessellatorBase
@@ -184,18 +269,15 @@ namespace
     }
 
   private:
-    std::vector<analytic_point_data> m_data;
-
     void
-    tessellation_worker(unsigned int idx_p, unsigned int idx_q,
+    tessellation_worker(const analytic_point_data &start, const analytic_point_data &end,
                         unsigned int recursion_level,
                         fastuidraw::PathContour::interpolator_generic::tessellated_region *in_src,
                         float *out_effective_curve_distance, float *out_effective_curvature);
 
     virtual
-    unsigned int
-    fill_data(fastuidraw::c_array<fastuidraw::TessellatedPath::point> out_data,
-              float *out_effective_curve_distance, float *out_effective_curvature);
+    void
+    fill_data(float *out_effective_curve_distance, float *out_effective_curvature);
   };
 
   class InterpolatorBasePrivate
@@ -206,6 +288,69 @@ namespace
     fastuidraw::vec2 m_end;
   };
 
+  /* Compute the maximum distance between the points
+     of a Bezier curve and the line segment between
+     its start and end point. The curve is contained
+     within the convex hull of the points, so this
+     computation is fast, conservative value for getting
+     the curve_distance.
+   */
+  float
+  compute_curve_distance(fastuidraw::const_c_array<fastuidraw::vec2> pts)
+  {
+    float return_value(0.0f);
+    for(unsigned int i = 1, endi = pts.size(); i + 1 < endi; ++i)
+      {
+        float v;
+        v = compute_distance(pts.front(), pts[i], pts.back());
+        return_value = fastuidraw::t_max(return_value, v);
+      }
+    return return_value;
+  }
+
+  /* Split the Bezier curve given by pts at t = 0.5 writing
+     the first half to outA and the second half to outB,
+     all three arrays have the same size.
+
+     For a Bezier curve, given by points p(0), .., p(n),
+     and a time 0 <= t <= 1, De Casteljau's algorithm is
+     the following.
+
+     Let
+       q(0, j) = p(j) for 0 <= j <= n,
+       q(i + 1, j) = (1 - t) * q(i, j) + t * q(i, j + 1) for 0 <= i <= n, 0 <= j <= n - i
+     then
+       The curve split at time t is given by
+         A = { q(0, 0), q(1, 0), q(2, 0), ... , q(n, 0) }
+         B = { q(n, 0), q(n - 1, 1), q(n - 2, 2), ... , q(0, n) }
+       and
+         the curve evaluated at t is given by q(n, 0).
+
+     The iteration is done in place within outB: the pass
+     computing q(i, .) only modifies the values at indices
+     below n - i + 1, so the value left at index n - i is
+     q(i, n - i), which is exactly the value of B there.
+   */
+  void
+  split_bezier(fastuidraw::const_c_array<fastuidraw::vec2> pts,
+               fastuidraw::c_array<fastuidraw::vec2> outA,
+               fastuidraw::c_array<fastuidraw::vec2> outB)
+  {
+    unsigned int sz(pts.size());
+
+    assert(sz > 0 && outA.size() == sz && outB.size() == sz);
+    std::copy(pts.begin(), pts.end(), outB.begin());
+    outA[0] = outB[0];
+    for(unsigned int i = 1; i < sz; ++i)
+      {
+        for(unsigned int j = 0, endj = sz - i; j < endj; ++j)
+          {
+            outB[j] = 0.5f * outB[j] + 0.5f * outB[j + 1];
+          }
+        outA[i] = outB[0];
+      }
+  }
+
   class BezierTessRegion:
     public fastuidraw::PathContour::interpolator_generic::tessellated_region
   {
@@ -215,7 +360,7 @@ namespace
     {
       float mid;
 
-      m_pts.reserve(parent->m_pts.size());
+      m_pts.resize(parent->m_pts.size());
       mid = 0.5f * (parent->m_start + parent->m_end);
       if(is_region_start)
         {
@@ -235,27 +380,10 @@ namespace
       m_end(1.0f)
     {}
 
-    float
-    compute_curve_distance(void)
-    {
-      /* Compute the maximum distance between the points
-         of a BezierTessRegion and the line segment between
-         the start and  end point of the BezierTessRegion.
-         The curve is contained within the convex hull of the
-         points, so this computation is fast, conservative
-         value for getting the curve_distance.
-       */
-      float return_value(0.0f);
-      for(unsigned int i = 1, endi = m_pts.size(); i + 1 < endi; ++i)
-        {
-          float v;
-          v = compute_distance(m_pts.front(), m_pts[i], m_pts.back());
-          return_value = fastuidraw::t_max(return_value, v);
-        }
-      return return_value;
-    }
-
-    std::vector<fastuidraw::vec2> m_pts;
+    /* quadratic and cubic curves are the common case;
+       their points are stored inline.
+     */
+    fastuidraw::small_vector<fastuidraw::vec2, 4> m_pts;
     float m_start, m_end;
   };
 
@@ -265,12 +393,208 @@ namespace
     void
     init(void);
 
+    void
+    compute_tight_bounding_box(void);
+
     fastuidraw::vec2 m_min_bb, m_max_bb;
+    fastuidraw::vec2 m_tight_min_bb, m_tight_max_bb;
     BezierTessRegion m_start_region;
     std::vector<fastuidraw::vec2> m_poly;
     std::vector<fastuidraw::vec2> m_poly_prime;
     std::vector<fastuidraw::vec2> m_poly_prime_prime;
-    fastuidraw::vecN<std::vector<fastuidraw::vec2>, 2> m_work_room;
+  };
+
+  /* Distance tessellation of a Bezier curve with N points
+     where the control points of the regions are held on
+     the stack instead of in heap allocated tessellated_region
+     objects.
+   */
+  template<unsigned int N>
+  class BezierTessellatorDistance:public TessellatorBase
+  {
+  public:
+    BezierTessellatorDistance(const fastuidraw::TessellatedPath::TessellationParams &tess_params,
+                              const fastuidraw::PathContour::bezier *h,
+                              const BezierPrivate *d):
+      TessellatorBase(tess_params, h),
+      m_d(d)
+    {
+      assert(!tess_params.m_curvature_tessellation);
+      assert(d->m_start_region.m_pts.size() == N);
+    }
+
+  private:
+    typedef fastuidraw::vecN<fastuidraw::vec2, N> region;
+
+    void
+    tessellation_worker(const region &pts, float t0, float t1,
+                        const analytic_point_data &start, const analytic_point_data &end,
+                        unsigned int recurse_level,
+                        float *out_effective_curve_distance, float *out_effective_curvature)
+    {
+      region A, B;
+      float t, out_tess;
+
+      split_bezier(pts, A, B);
+      t = 0.5f * (t0 + t1);
+      out_tess = fastuidraw::t_max(compute_curve_distance(A), compute_curve_distance(B));
+
+      analytic_point_data mid(t, A[N - 1],
+                              poly::compute_poly(t, make_c_array(m_d->m_poly_prime)),
+                              poly::compute_poly(t, make_c_array(m_d->m_poly_prime_prime)));
+
+      if(recurse_level + 1u < m_max_recursion && out_tess > m_thresh)
+        {
+          tessellation_worker(A, t0, t, start, mid, recurse_level + 1,
+                              out_effective_curve_distance, out_effective_curvature);
+          add_point(mid);
+          tessellation_worker(B, t, t1, mid, end, recurse_level + 1,
+                              out_effective_curve_distance, out_effective_curvature);
+        }
+      else
+        {
+          float v;
+
+          add_point(mid);
+          v = analytic_point_data::compute_approximate_curvature(t1 - t0, start, mid, end);
+          *out_effective_curve_distance = fastuidraw::t_max(*out_effective_curve_distance, out_tess);
+          *out_effective_curvature = fastuidraw::t_max(*out_effective_curvature, v);
+        }
+    }
+
+    virtual
+    void
+    fill_data(float *out_effective_curve_distance, float *out_effective_curvature)
+    {
+      analytic_point_data start(0.0f, m_h), end(1.0f, m_h);
+      region pts;
+
+      std::copy(m_d->m_start_region.m_pts.begin(),
+                m_d->m_start_region.m_pts.end(),
+                pts.begin());
+      add_point(start);
+      tessellation_worker(pts, 0.0f, 1.0f, start, end, 0,
+                          out_effective_curve_distance, out_effective_curvature);
+      add_point(end);
+    }
+
+    const BezierPrivate *m_d;
+  };
+
+  /* Evaluates a polynomial (given in the pre-multiplied
+     Bernstein basis of BezierPrivate) with N coefficients
+     at uniformly spaced times by forward differencing.
+   */
+  template<unsigned int N>
+  class forward_differencer
+  {
+  public:
+    forward_differencer(fastuidraw::const_c_array<fastuidraw::vec2> poly, float h)
+    {
+      assert(poly.size() == N);
+      for(unsigned int k = 0; k < N; ++k)
+        {
+          m_d[k] = poly::compute_poly(static_cast<float>(k) * h, poly);
+        }
+
+      /* m_d[k] becomes the k'th forward difference at t = 0 */
+      for(unsigned int k = 1; k < N; ++k)
+        {
+          for(unsigned int j = N - 1; j >= k; --j)
+            {
+              m_d[j] -= m_d[j - 1];
+            }
+        }
+    }
+
+    const fastuidraw::vec2&
+    value(void) const
+    {
+      return m_d[0];
+    }
+
+    void
+    step(void)
+    {
+      for(unsigned int k = 0; k + 1 < N; ++k)
+        {
+          m_d[k] += m_d[k + 1];
+        }
+    }
+
+  private:
+    fastuidraw::vecN<fastuidraw::vec2, N> m_d;
+  };
+
+  /* Tessellation of a Bezier curve with N points for
+     TessellationParams::m_uniform_tessellation.
+   */
+  template<unsigned int N>
+  class BezierTessellatorUniform:public TessellatorBase
+  {
+  public:
+    BezierTessellatorUniform(const fastuidraw::TessellatedPath::TessellationParams &tess_params,
+                             const fastuidraw::PathContour::bezier *h,
+                             const BezierPrivate *d):
+      TessellatorBase(tess_params, h),
+      m_d(d),
+      m_max_segments(tess_params.m_max_segments)
+    {
+      assert(!tess_params.m_curvature_tessellation);
+      assert(tess_params.m_uniform_tessellation);
+      assert(d->m_start_region.m_pts.size() == N);
+    }
+
+  private:
+    virtual
+    void
+    fill_data(float *out_effective_curve_distance, float *out_effective_curvature)
+    {
+      const unsigned int degree(N - 1);
+      fastuidraw::const_c_array<fastuidraw::vec2> pts(make_c_array(m_d->m_start_region.m_pts));
+      float M(0.0f), C, h;
+      unsigned int num_segments;
+
+      /* Wang's formula */
+      for(unsigned int i = 0; i + 2 < N; ++i)
+        {
+          fastuidraw::vec2 v;
+          v = pts[i] - 2.0f * pts[i + 1] + pts[i + 2];
+          M = fastuidraw::t_max(M, v.magnitude());
+        }
+      C = static_cast<float>(degree * (degree - 1)) * M / 8.0f;
+      num_segments = static_cast<unsigned int>(std::ceil(fastuidraw::t_sqrt(C / fastuidraw::t_max(m_thresh, 1e-6f))));
+      num_segments = fastuidraw::t_max(1u, fastuidraw::t_min(num_segments, m_max_segments));
+      h = 1.0f / static_cast<float>(num_segments);
+
+      forward_differencer<N> p(make_c_array(m_d->m_poly), h);
+      forward_differencer<N - 1> p_t(make_c_array(m_d->m_poly_prime), h);
+      forward_differencer<N - 2> p_tt(make_c_array(m_d->m_poly_prime_prime), h);
+
+      analytic_point_data prev(0.0f, p.value(), p_t.value(), p_tt.value());
+      add_point(prev);
+      for(unsigned int i = 1; i <= num_segments; ++i)
+        {
+          float v;
+
+          p.step();
+          p_t.step();
+          p_tt.step();
+
+          analytic_point_data current(static_cast<float>(i) * h,
+                                      p.value(), p_t.value(), p_tt.value());
+          add_point(current);
+
+          /* no mid-point for Simpson's rule, use the trapezoid rule */
+          v = 0.5f * h * (prev.m_K_times_speed + current.m_K_times_speed);
+          *out_effective_curvature = fastuidraw::t_max(*out_effective_curvature, v);
+          prev = current;
+        }
+      *out_effective_curve_distance = C * h * h;
+    }
+
+    const BezierPrivate *m_d;
+    unsigned int m_max_segments;
   };
 
   class ArcPrivate
@@ -285,12 +609,115 @@ namespace
   class PathContourPrivate
   {
   public:
+    typedef fastuidraw::reference_counted_ptr<const fastuidraw::PathContour::interpolator_base> interpolator_ref;
+
+    PathContourPrivate(void):
+      m_materialized(false),
+      m_ended(false),
+      m_is_flat(false)
+    {}
+
+    /* add a line segment to pt; the flat object of a line
+       segment is only created (by create_interpolator()) when
+       it is needed.
+     */
+    void
+    add_flat(const fastuidraw::vec2 &pt)
+    {
+      m_pts.push_back(pt);
+      m_interpolators.push_back(interpolator_ref());
+      if(m_materialized)
+        {
+          create_interpolator(m_interpolators.size() - 1);
+        }
+    }
+
+    void
+    add_interpolator(const interpolator_ref &p)
+    {
+      m_pts.push_back(p->end_pt());
+      m_interpolators.push_back(p);
+    }
+
+    /* returns m_interpolators[I], creating the flat of the
+       line segment if it was not yet created. The previous
+       interpolator of the created flat may not be created
+       yet, in which case it is set by
+       PathContour::create_interpolators(); until then only
+       its end point is correct, which is all that is used of
+       the previous interpolator by the interpolators created
+       after it.
+     */
+    const interpolator_ref&
+    create_interpolator(unsigned int I)
+    {
+      if(!m_interpolators[I])
+        {
+          interpolator_ref prev;
+          if(I > 0)
+            {
+              prev = m_interpolators[I - 1];
+            }
+          m_interpolators[I] = FASTUIDRAWnew fastuidraw::PathContour::flat(prev, m_pts[I]);
+        }
+      return m_interpolators[I];
+    }
+
     fastuidraw::vec2 m_start_pt;
     std::vector<fastuidraw::vec2> m_current_control_points;
-    fastuidraw::reference_counted_ptr<const fastuidraw::PathContour::interpolator_base> m_end_to_start;
-    std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::PathContour::interpolator_base> > m_interpolators;
+    interpolator_ref m_end_to_start;
+
+    /* m_pts[I] is the I'th point of the contour and for I > 0,
+       m_interpolators[I] is the interpolator from m_pts[I - 1]
+       to m_pts[I]; once the contour is ended, m_interpolators[0]
+       is the interpolator from m_pts.back() to m_pts[0]. An
+       element of m_interpolators is NULL if it is a line segment
+       whose flat object was not created, i.e. a line segment
+       costs only its point until PathContour::interpolator() or
+       PathContour::prev_interpolator() is called, which create
+       all of them (and then m_materialized is true).
+     */
+    std::vector<fastuidraw::vec2> m_pts;
+    std::vector<interpolator_ref> m_interpolators;
+    bool m_materialized;
+    bool m_ended;
 
     fastuidraw::vec2 m_min_bb, m_max_bb;
+    fastuidraw::vec2 m_tight_min_bb, m_tight_max_bb;
+
+    /* set when the contour is ended */
+    bool m_is_flat;
+  };
+
+  class AsyncTessellation;
+
+  /* The key of the geometry of a Path in a PathGeometryCache:
+     a hash of the words followed by the words, which are the
+     bits of the points, control points and angles of the
+     interpolators of the contours of the Path.
+   */
+  typedef std::pair<uint64_t, std::vector<uint32_t> > geometry_key;
+
+  class GeometryCacheEntry
+  {
+  public:
+    GeometryCacheEntry(void):
+      m_tessellation_done(false)
+    {}
+
+    std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::TessellatedPath> > m_tessellation;
+    bool m_tessellation_done;
+  };
+
+  class PathGeometryCachePrivate
+  {
+  public:
+    PathGeometryCachePrivate(void):
+      m_number_hits(0)
+    {}
+
+    std::map<geometry_key, GeometryCacheEntry> m_entries;
+    unsigned int m_number_hits;
   };
 
   class PathPrivate
@@ -299,30 +726,150 @@ namespace
     typedef fastuidraw::TessellatedPath TessellatedPath;
     typedef fastuidraw::reference_counted_ptr<const TessellatedPath> tessellated_path_ref;
 
+    enum geometry_key_state_t
+      {
+        geometry_key_dirty,
+        geometry_key_valid,
+        geometry_key_none,
+      };
+
     PathPrivate(void):
       m_tessellation_done(false),
-      m_start_check_bb(0)
+      m_cache_max_bytes(0),
+      m_use_counter(0),
+      m_async_tessellation(false),
+      m_async_job(NULL),
+      m_start_check_bb(0),
+      m_geometry_key_state(geometry_key_dirty)
     {}
 
     PathPrivate(const PathPrivate &obj);
 
+    ~PathPrivate();
+
     const fastuidraw::reference_counted_ptr<fastuidraw::PathContour>&
     current_contour(void)
     {
       assert(!m_contours.empty());
-      m_tessellation.clear();
-      m_tessellation_done = false;
+      invalidate_tessellation();
       return m_contours.back();
     }
 
     void
     move_common(const fastuidraw::vec2 &pt)
     {
-      m_tessellation.clear();
-      m_tessellation_done = false;
+      invalidate_tessellation();
       m_contours.push_back(FASTUIDRAWnew fastuidraw::PathContour());
       m_contours.back()->start(pt);
     }
+
+    /* Called when the geometry changes; the tessellations are
+       kept in m_prev_tessellation so that the next tessellation
+       can reuse the data of the contours that did not change.
+     */
+    void
+    invalidate_tessellation(void)
+    {
+      if(!m_tessellation.empty())
+        {
+          m_prev_tessellation.swap(m_tessellation);
+          m_tessellation.clear();
+          m_last_use.clear();
+        }
+      m_tessellation_done = false;
+      m_geometry_key_state = geometry_key_dirty;
+      retire_async_job();
+    }
+
+    void
+    add_tessellation(const tessellated_path_ref &ref)
+    {
+      m_tessellation.push_back(ref);
+      m_last_use.push_back(0u);
+    }
+
+    /* mark m_tessellation[idx] as used, evict least recently
+       used levels if over m_cache_max_bytes and return the
+       (possibly moved) element.
+     */
+    const tessellated_path_ref&
+    use_tessellation(unsigned int idx);
+
+    unsigned int
+    cache_bytes(void) const;
+
+    /* creates a tessellation of path reusing from the element
+       of m_prev_tessellation with the same parameters if there
+       is one and otherwise from prev if prev is non-NULL.
+     */
+    tessellated_path_ref
+    create_tessellation(const fastuidraw::Path &path,
+                        const TessellatedPath::TessellationParams &params,
+                        const TessellatedPath *prev = NULL);
+
+    /* Create successively finer tessellations of path, starting
+       from a tessellation with the given max_segments() and
+       effective_curve_distance_threshhold(), until one has
+       effective_curve_distance_threshhold() no more than thresh
+       or until finer tessellations no longer improve; the created
+       tessellations are appended to out and returns true if
+       refining stopped improving. If reuse is non-NULL, the
+       tessellations are created with its create_tessellation().
+       Each tessellation is made from the one before it (the first
+       from start if start is non-NULL) so that the polygon contours
+       are copied instead of tessellated again.
+     */
+    static
+    tessellated_path_ref
+    create_level(const fastuidraw::Path &path, PathPrivate *reuse,
+                 const TessellatedPath::TessellationParams &params,
+                 const TessellatedPath *prev);
+
+    static
+    bool
+    refine_tessellation(const fastuidraw::Path &path, PathPrivate *reuse,
+                        const TessellatedPath *start,
+                        unsigned int start_max_segments, float start_thresh,
+                        float thresh, std::vector<tessellated_path_ref> &out);
+
+    /* add the results of m_async_job if it is finished
+     */
+    void
+    poll_async_jobs(void);
+
+    /* start a job to refine to thresh if no job is in
+       flight; returns false if the geometry cannot be
+       tessellated in the background.
+     */
+    bool
+    start_async_job(float thresh);
+
+    /* abandon m_async_job, its results will be
+       discarded.
+     */
+    void
+    retire_async_job(void);
+
+    /* computes m_geometry_key if it is dirty, returns
+       false if the geometry cannot be keyed.
+     */
+    bool
+    ready_geometry_key(void);
+
+    /* if the entry of the geometry in cache has a finer
+       tessellation than m_tessellation, take the
+       tessellations of the entry.
+     */
+    void
+    take_from_geometry_cache(PathGeometryCachePrivate *cache);
+
+    /* if m_tessellation is finer than the tessellations
+       of the entry of the geometry in cache, give the
+       entry the tessellations of m_tessellation.
+     */
+    void
+    give_to_geometry_cache(PathGeometryCachePrivate *cache);
+
     std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PathContour> > m_contours;
 
     /* m_tessellation are gauranteed to be sorted from lowest to highest LOD.
@@ -330,26 +877,185 @@ namespace
     std::vector<tessellated_path_ref> m_tessellation;
     bool m_tessellation_done;
 
+    /* m_last_use[i] is the value of m_use_counter when
+       m_tessellation[i] was last returned by tessellation().
+     */
+    std::vector<uint64_t> m_last_use;
+    unsigned int m_cache_max_bytes;
+    uint64_t m_use_counter;
+
+    /* tessellations from before the last change of geometry,
+       used to construct new tessellations incrementally.
+     */
+    std::vector<tessellated_path_ref> m_prev_tessellation;
+
+    /* m_async_job is the job creating the next finer levels
+       of m_tessellation.
+     */
+    bool m_async_tessellation;
+    AsyncTessellation *m_async_job;
+
+    /* absorb the bounding boxes of the ended contours starting
+       at m_start_check_bb into m_max_bb, m_min_bb and into
+       m_tight_max_bb, m_tight_min_bb; returns true if atleast
+       one contour has been absorbed.
+     */
+    bool
+    update_bounding_boxes(void);
+
     /* m_start_check_bb gives the index into m_contours that
        have not had their bounding box absorbed into
        m_max_bb and m_min_bb.
      */
     unsigned int m_start_check_bb;
     fastuidraw::vec2 m_max_bb, m_min_bb;
+    fastuidraw::vec2 m_tight_max_bb, m_tight_min_bb;
+
+    /* the PathGeometryCache through which to share the
+       tessellations and the key of the geometry in it.
+     */
+    fastuidraw::reference_counted_ptr<fastuidraw::PathGeometryCache> m_geometry_cache;
+    enum geometry_key_state_t m_geometry_key_state;
+    geometry_key m_geometry_key;
   };
 
-  inline
+  /* append the bits of the values to dst */
+  void
+  add_geometry_words(fastuidraw::const_c_array<float> values, std::vector<uint32_t> &dst)
+  {
+    for(unsigned int i = 0; i < values.size(); ++i)
+      {
+        uint32_t v;
+        std::memcpy(&v, &values[i], sizeof(v));
+        dst.push_back(v);
+      }
+  }
+
+  void
+  add_geometry_words(const fastuidraw::vec2 &p, std::vector<uint32_t> &dst)
+  {
+    add_geometry_words(fastuidraw::const_c_array<float>(p.c_ptr(), 2), dst);
+  }
+
+  /* returns false if the interpolator is of a type
+     whose geometry cannot be written as words.
+   */
   bool
-  reverse_compare_curve_distance_thresh(const PathPrivate::tessellated_path_ref &lhs,
-                                        float rhs)
+  add_geometry_words(const fastuidraw::PathContour::interpolator_base *p,
+                     const fastuidraw::vec2 &end_pt, std::vector<uint32_t> &dst)
   {
-    return lhs->effective_curve_distance_threshhold() > rhs;
+    const fastuidraw::PathContour::bezier *b;
+    const fastuidraw::PathContour::arc *a;
+
+    /* a NULL p is a line segment */
+    if(!p)
+      {
+        dst.push_back(0u);
+        add_geometry_words(end_pt, dst);
+        return true;
+      }
+
+    /* the interpolators whose derived type is not exactly
+       one of ours may tessellate differently.
+     */
+    b = dynamic_cast<const fastuidraw::PathContour::bezier*>(p);
+    a = dynamic_cast<const fastuidraw::PathContour::arc*>(p);
+    if(b && typeid(*p) == typeid(fastuidraw::PathContour::bezier))
+      {
+        fastuidraw::const_c_array<fastuidraw::vec2> pts(b->pts());
+
+        dst.push_back(1u);
+        dst.push_back(pts.size());
+        for(unsigned int i = 0; i < pts.size(); ++i)
+          {
+            add_geometry_words(pts[i], dst);
+          }
+      }
+    else if(a && typeid(*p) == typeid(fastuidraw::PathContour::arc))
+      {
+        float angle(a->angle());
+
+        dst.push_back(2u);
+        add_geometry_words(fastuidraw::const_c_array<float>(&angle, 1), dst);
+        add_geometry_words(p->end_pt(), dst);
+      }
+    else if(typeid(*p) == typeid(fastuidraw::PathContour::flat))
+      {
+        dst.push_back(0u);
+        add_geometry_words(p->end_pt(), dst);
+      }
+    else
+      {
+        return false;
+      }
+    return true;
   }
-}
 
-////////////////////////////////////
-// poly methods
-void
+  /* An AsyncTessellation creates tessellations as a task of
+     default_task_executor(). The reference counts of the objects
+     of path, tessellation and interpolators are not thread safe,
+     so the job works on a deep copy of the contours made on the
+     thread that starts the job; the created TessellatedPath
+     objects (and their StrokedPath and FilledPath) are only
+     referenced by the job until the job is done. The job is
+     deleted by its owner once done() returns true, or given
+     up with abandon(), in which case it deletes itself when
+     it is done so that the owner never waits for it.
+   */
+  class AsyncTessellation:
+    public fastuidraw::TaskExecutor::Task,
+    fastuidraw::noncopyable
+  {
+  public:
+    typedef PathPrivate::tessellated_path_ref tessellated_path_ref;
+
+    /* create the job and hand it to default_task_executor() */
+    static
+    AsyncTessellation*
+    start(const std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PathContour> > &contours,
+          const fastuidraw::TessellatedPath &start, float thresh);
+
+    bool
+    done(void);
+
+    /* the caller no longer owns the job, the job
+       is deleted now if done or else when done.
+     */
+    void
+    abandon(void);
+
+    virtual
+    void
+    run(void);
+
+    /* values read and written by the job until done()
+     */
+    fastuidraw::Path m_path;
+    unsigned int m_start_max_segments;
+    float m_start_thresh, m_thresh;
+    std::vector<tessellated_path_ref> m_results;
+    bool m_tessellation_done;
+
+  private:
+    AsyncTessellation(const std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PathContour> > &contours,
+                      const fastuidraw::TessellatedPath &start, float thresh);
+
+    fastuidraw::mutex m_mutex;
+    bool m_done, m_abandoned;
+  };
+
+  inline
+  bool
+  reverse_compare_curve_distance_thresh(const PathPrivate::tessellated_path_ref &lhs,
+                                        float rhs)
+  {
+    return lhs->effective_curve_distance_threshhold() > rhs;
+  }
+}
+
+////////////////////////////////////
+// poly methods
+void
 poly::
 compute_bernstein_derivative(const std::vector<fastuidraw::vec2> &input,
                              std::vector<fastuidraw::vec2> &output)
@@ -541,7 +1247,10 @@ dump(fastuidraw::c_array<fastuidraw::TessellatedPath::point> out_data,
 
   *out_effective_curve_distance = 0.0f;
   *out_effective_curvature = 0.0f;
-  return_value = fill_data(out_data, out_effective_curve_distance, out_effective_curvature);
+  m_out_data = out_data;
+  m_num_points = 0;
+  fill_data(out_effective_curve_distance, out_effective_curvature);
+  return_value = m_num_points;
   out_data = out_data.sub_array(0, return_value);
 
   /* enforce start and end point values
@@ -566,39 +1275,26 @@ dump(fastuidraw::c_array<fastuidraw::TessellatedPath::point> out_data,
 
 /////////////////////////////////////
 // TessellatorDistance methods
-unsigned int
+void
 TessellatorDistance::
-fill_data(fastuidraw::c_array<fastuidraw::TessellatedPath::point> out_data,
-          float *out_effective_curve_distance, float *out_effective_curvature)
+fill_data(float *out_effective_curve_distance, float *out_effective_curvature)
 {
-  /* initialize m_data with start and end point data.
-   */
-  m_data.push_back(analytic_point_data(0.0f, m_h));
-  m_data.push_back(analytic_point_data(1.0f, m_h));
+  analytic_point_data start(0.0f, m_h), end(1.0f, m_h);
 
-  /* tessellate
-   */
-  tessellation_worker(0, 1, 0, NULL,
+  add_point(start);
+  tessellation_worker(start, end, 0, NULL,
                       out_effective_curve_distance,
                       out_effective_curvature);
-
-  /* sort the values by time
-   */
-  std::sort(m_data.begin(), m_data.end());
-
-  assert(m_data.size() <= out_data.size());
-  std::copy(m_data.begin(), m_data.end(), out_data.begin());
-  return m_data.size();
+  add_point(end);
 }
 
 void
 TessellatorDistance::
-tessellation_worker(unsigned int idx_start, unsigned int idx_end,
+tessellation_worker(const analytic_point_data &start, const analytic_point_data &end,
                     unsigned int recurse_level,
                     fastuidraw::PathContour::interpolator_generic::tessellated_region *in_src,
                     float *out_effective_curve_distance, float *out_effective_curvature)
 {
-  unsigned int idx_mid(m_data.size());
   float out_tess;
   fastuidraw::PathContour::interpolator_generic::tessellated_region *rgnA, *rgnB;
   fastuidraw::vec2 p, p_t, p_tt;
@@ -608,21 +1304,23 @@ tessellation_worker(unsigned int idx_start, unsigned int idx_end,
                   &t, &p, &p_t, &p_tt,
                   &out_tess);
 
-  m_data.push_back(analytic_point_data(t, p, p_t, p_tt));
+  analytic_point_data mid(t, p, p_t, p_tt);
 
   if(recurse_level + 1u < m_max_recursion && out_tess > m_thresh)
     {
-      tessellation_worker(idx_start, idx_mid, recurse_level + 1, rgnA,
+      tessellation_worker(start, mid, recurse_level + 1, rgnA,
                           out_effective_curve_distance, out_effective_curvature);
-      tessellation_worker(idx_mid, idx_end, recurse_level + 1, rgnB,
+      add_point(mid);
+      tessellation_worker(mid, end, recurse_level + 1, rgnB,
                           out_effective_curve_distance, out_effective_curvature);
     }
   else
     {
       float v, delta_t;
 
-      delta_t = m_data[idx_end].m_time - m_data[idx_start].m_time;
-      v = analytic_point_data::compute_approximate_curvature(delta_t, m_data[idx_start], m_data[idx_mid], m_data[idx_end]);
+      add_point(mid);
+      delta_t = end.m_time - start.m_time;
+      v = analytic_point_data::compute_approximate_curvature(delta_t, start, mid, end);
 
       *out_effective_curve_distance = fastuidraw::t_max(*out_effective_curve_distance, out_tess);
       *out_effective_curvature = fastuidraw::t_max(*out_effective_curvature, v);
@@ -633,66 +1331,48 @@ tessellation_worker(unsigned int idx_start, unsigned int idx_end,
 
 /////////////////////////////////////
 // TessellatorCurvature methods
-unsigned int
+void
 TessellatorCurvature::
-fill_data(fastuidraw::c_array<fastuidraw::TessellatedPath::point> out_data,
-          float *out_effective_curve_distance, float *out_effective_curvature)
+fill_data(float *out_effective_curve_distance, float *out_effective_curvature)
 {
-  /* initialize m_data with start and end point data.
-   */
-  m_data.push_back(analytic_point_data(0.0f, m_h));
-  m_data.push_back(analytic_point_data(1.0f, m_h));
-
-  /* tessellate
-   */
-  tessellation_worker(0, 1, 0, out_effective_curve_distance, out_effective_curvature);
-
-  /* sort the values by time
-   */
-  std::sort(m_data.begin(), m_data.end());
+  analytic_point_data start(0.0f, m_h), end(1.0f, m_h);
 
-  assert(m_data.size() <= out_data.size());
-  std::copy(m_data.begin(), m_data.end(), out_data.begin());
-  return m_data.size();
+  add_point(start);
+  tessellation_worker(start, end, 0, out_effective_curve_distance, out_effective_curvature);
+  add_point(end);
 }
 
 void
 TessellatorCurvature::
-tessellation_worker(unsigned int idx_start, unsigned int idx_end,
+tessellation_worker(const analytic_point_data &start, const analytic_point_data &end,
                     unsigned int recurse_level,
                     float *out_effective_curve_distance,
                     float *out_effective_curvature)
 {
-  float delta_t, start_t, end_t, mid_t, curvature;
-  unsigned int idx_mid(m_data.size());
+  float delta_t, mid_t, curvature;
   bool recurse;
 
-  start_t = m_data[idx_start].m_time;
-  end_t = m_data[idx_end].m_time;
-  mid_t = 0.5f * (end_t + start_t);
-  delta_t = (end_t - start_t);
+  mid_t = 0.5f * (end.m_time + start.m_time);
+  delta_t = (end.m_time - start.m_time);
 
-  m_data.push_back(analytic_point_data(mid_t, m_h));
-  curvature = analytic_point_data::compute_approximate_curvature(delta_t,
-                                                                 m_data[idx_start],
-                                                                 m_data[idx_mid],
-                                                                 m_data[idx_end]);
+  analytic_point_data mid(mid_t, m_h);
+  curvature = analytic_point_data::compute_approximate_curvature(delta_t, start, mid, end);
 
   recurse = (curvature > m_thresh) || (recurse_level == 0u);
 
   if(recurse_level + 1u < m_max_recursion && recurse)
     {
-      tessellation_worker(idx_start, idx_mid, recurse_level + 1,
+      tessellation_worker(start, mid, recurse_level + 1,
                           out_effective_curve_distance, out_effective_curvature);
-      tessellation_worker(idx_mid, idx_end, recurse_level + 1,
+      add_point(mid);
+      tessellation_worker(mid, end, recurse_level + 1,
                           out_effective_curve_distance, out_effective_curvature);
     }
   else
     {
+      add_point(mid);
       *out_effective_curvature = curvature;
-      *out_effective_curve_distance = compute_distance(m_data[idx_start].m_p,
-                                                       m_data[idx_mid].m_p,
-                                                       m_data[idx_end].m_p);
+      *out_effective_curve_distance = compute_distance(start.m_p, mid.m_p, end.m_p);
     }
 }
 
@@ -720,7 +1400,9 @@ init(void)
       m_max_bb.x() = fastuidraw::t_max(m_max_bb.x(), m_poly[i].x());
       m_max_bb.y() = fastuidraw::t_max(m_max_bb.y(), m_poly[i].y());
     }
-  m_start_region.m_pts = m_poly; //original region uses original points.
+  //original region uses original points.
+  m_start_region.m_pts.resize(m_poly.size());
+  std::copy(m_poly.begin(), m_poly.end(), m_start_region.m_pts.begin());
 
   //compute derivatives in Bernstein basis
   poly::compute_bernstein_derivative(m_poly, m_poly_prime);
@@ -731,8 +1413,63 @@ init(void)
   BC.prepare_bernstein(m_poly_prime);
   BC.prepare_bernstein(m_poly_prime_prime);
 
-  m_work_room[0].resize(m_poly.size());
-  m_work_room[1].resize(m_poly.size());
+  compute_tight_bounding_box();
+
+}
+
+void
+BezierPrivate::
+compute_tight_bounding_box(void)
+{
+  fastuidraw::const_c_array<fastuidraw::vec2> pts(make_c_array(m_start_region.m_pts));
+  fastuidraw::vec2 a, b, c, qa, qb, qc;
+
+  if(pts.size() != 3 && pts.size() != 4)
+    {
+      /* lines are exact from the end points and for higher
+         degree we do not solve for the roots of the derivative.
+       */
+      m_tight_min_bb = m_min_bb;
+      m_tight_max_bb = m_max_bb;
+      return;
+    }
+
+  m_tight_min_bb = m_tight_max_bb = pts.front();
+  union_point(pts.back(), m_tight_min_bb, m_tight_max_bb);
+
+  /* the derivative (up to a positive constant) in power
+     basis is qa * t^2 + qb * t + qc; for a quadratic it
+     is (P1 - P0) * (1 - t) + (P2 - P1) * t and for a cubic
+     (P1 - P0) * (1 - t)^2 + 2 * (P2 - P1) * (1 - t) * t + (P3 - P2) * t^2
+   */
+  a = pts[1] - pts[0];
+  b = pts[2] - pts[1];
+  if(pts.size() == 3)
+    {
+      qa = fastuidraw::vec2(0.0f, 0.0f);
+      qb = b - a;
+      qc = a;
+    }
+  else
+    {
+      c = pts[3] - pts[2];
+      qa = a - 2.0f * b + c;
+      qb = 2.0f * (b - a);
+      qc = a;
+    }
+
+  for(unsigned int coord = 0; coord < 2; ++coord)
+    {
+      fastuidraw::vecN<float, 2> roots;
+      unsigned int num_roots;
+
+      num_roots = roots_in_unit_interval(qa[coord], qb[coord], qc[coord], roots);
+      for(unsigned int i = 0; i < num_roots; ++i)
+        {
+          union_point(poly::compute_poly(roots[i], make_c_array(m_poly)),
+                      m_tight_min_bb, m_tight_max_bb);
+        }
+    }
 }
 
 ////////////////////////////////////////////
@@ -873,6 +1610,19 @@ fastuidraw::PathContour::bezier::
   m_d = NULL;
 }
 
+fastuidraw::const_c_array<fastuidraw::vec2>
+fastuidraw::PathContour::bezier::
+pts(void) const
+{
+  BezierPrivate *d;
+  d = static_cast<BezierPrivate*>(m_d);
+  /* m_poly is pre-multiplied by the binomial
+     coefficients, the original points are those
+     of the starting region.
+   */
+  return make_c_array(d->m_start_region.m_pts);
+}
+
 void
 fastuidraw::PathContour::bezier::
 approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const
@@ -883,6 +1633,64 @@ approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const
   *out_max_bb = d->m_max_bb;
 }
 
+void
+fastuidraw::PathContour::bezier::
+tight_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const
+{
+  BezierPrivate *d;
+  d = static_cast<BezierPrivate*>(m_d);
+  *out_min_bb = d->m_tight_min_bb;
+  *out_max_bb = d->m_tight_max_bb;
+}
+
+unsigned int
+fastuidraw::PathContour::bezier::
+produce_tessellation(const TessellatedPath::TessellationParams &tess_params,
+                     c_array<TessellatedPath::point> out_data,
+                     float *out_effective_curve_distance,
+                     float *out_effective_curvature) const
+{
+  BezierPrivate *d;
+  d = static_cast<BezierPrivate*>(m_d);
+
+  if(!tess_params.m_curvature_tessellation && tess_params.m_uniform_tessellation)
+    {
+      switch(d->m_start_region.m_pts.size())
+        {
+        case 3:
+          {
+            BezierTessellatorUniform<3> tesser(tess_params, this, d);
+            return tesser.dump(out_data, out_effective_curve_distance, out_effective_curvature);
+          }
+        case 4:
+          {
+            BezierTessellatorUniform<4> tesser(tess_params, this, d);
+            return tesser.dump(out_data, out_effective_curve_distance, out_effective_curvature);
+          }
+        }
+    }
+
+  if(!tess_params.m_curvature_tessellation)
+    {
+      switch(d->m_start_region.m_pts.size())
+        {
+        case 3:
+          {
+            BezierTessellatorDistance<3> tesser(tess_params, this, d);
+            return tesser.dump(out_data, out_effective_curve_distance, out_effective_curvature);
+          }
+        case 4:
+          {
+            BezierTessellatorDistance<4> tesser(tess_params, this, d);
+            return tesser.dump(out_data, out_effective_curve_distance, out_effective_curvature);
+          }
+        }
+    }
+  return interpolator_generic::produce_tessellation(tess_params, out_data,
+                                                    out_effective_curve_distance,
+                                                    out_effective_curvature);
+}
+
 void
 fastuidraw::PathContour::bezier::
 compute(float t, vec2 *outp, vec2 *outp_t, vec2 *outp_tt) const
@@ -918,39 +1726,14 @@ tessellate(tessellated_region *in_region,
   newA = FASTUIDRAWnew BezierTessRegion(in_region_casted, true);
   newB = FASTUIDRAWnew BezierTessRegion(in_region_casted, false);
 
-  c_array<vec2> dst, src;
-  src = make_c_array(in_region_casted->m_pts);
-
-  newA->m_pts.push_back(src.front());
-  newB->m_pts.push_back(src.back());
-
-  /* For a Bezier curve, given by points p(0), .., p(n),
-     and a time 0 <= t <= 1, De Casteljau's algorithm is
-     the following.
-
-     Let
-       q(0, j) = p(j) for 0 <= j <= n,
-       q(i + 1, j) = (1 - t) * q(i, j) + t * q(i, j + 1) for 0 <= i <= n, 0 <= j <= n - i
-     then
-       The curve split at time t is given by
-         A = { q(0, 0), q(1, 0), q(2, 0), ... , q(n, 0) }
-         B = { q(n, 0), q(n - 1, 1), q(n - 2, 2), ... , q(0, n) }
-       and
-         the curve evaluated at t is given by q(n, 0).
-     We use t = 0.5 because we are always doing mid-point cutting.
+  /* the split writes only to the new regions so that different
+     edges using the same bezier (i.e. a PathContour used by
+     different Path objects) can be tessellated from different
+     threads.
    */
-  for(unsigned int i = 0, endi = src.size(), sz = endi - 1; sz > 0 && i < endi; ++i, --sz)
-    {
-      dst = make_c_array(d->m_work_room[i & 1]).sub_array(0, sz);
-      for(unsigned int j = 0; j < dst.size(); ++j)
-        {
-          dst[j] = 0.5f * src[j] + 0.5f * src[j + 1];
-        }
-      newA->m_pts.push_back(dst.front());
-      newB->m_pts.push_back(dst.back());
-      src = dst;
-    }
-  std::reverse(newB->m_pts.begin(), newB->m_pts.end());
+  split_bezier(make_c_array(in_region_casted->m_pts),
+               make_c_array(newA->m_pts),
+               make_c_array(newB->m_pts));
 
   *out_regionA = newA;
   *out_regionB = newB;
@@ -959,7 +1742,8 @@ tessellate(tessellated_region *in_region,
   *out_p_t = poly::compute_poly(*out_t, make_c_array(d->m_poly_prime));
   *out_p_tt = poly::compute_poly(*out_t, make_c_array(d->m_poly_prime_prime));
 
-  *out_effective_curve_distance = fastuidraw::t_max(newA->compute_curve_distance(), newB->compute_curve_distance());
+  *out_effective_curve_distance = fastuidraw::t_max(compute_curve_distance(make_c_array(newA->m_pts)),
+                                                    compute_curve_distance(make_c_array(newB->m_pts)));
 }
 
 fastuidraw::PathContour::interpolator_base*
@@ -1062,6 +1846,7 @@ arc(const reference_counted_ptr<const interpolator_base> &start, float angle, co
   d->m_angle_speed = angle_coeff_dir * angle;
 
   vec2 p0, p1;
+  float angle0, angle1, quarter_turn(0.5f * static_cast<float>(M_PI));
   p0 = vec2(std::cos(d->m_start_angle), std::sin(d->m_start_angle));
   p1 = vec2(std::cos(d->m_start_angle + d->m_angle_speed), std::sin(d->m_start_angle + d->m_angle_speed));
 
@@ -1071,6 +1856,25 @@ arc(const reference_counted_ptr<const interpolator_base> &start, float angle, co
   d->m_max_bb.x() = fastuidraw::t_max(p0.x(), p1.x());
   d->m_max_bb.y() = fastuidraw::t_max(p0.y(), p1.y());
 
+  /* the arc also reaches the extremes of the circle at
+     the multiples of a quarter turn within its range of
+     angles, giving the exact bounding box of the arc.
+   */
+  angle0 = fastuidraw::t_min(d->m_start_angle, d->m_start_angle + d->m_angle_speed);
+  angle1 = fastuidraw::t_max(d->m_start_angle, d->m_start_angle + d->m_angle_speed);
+  for(int k = static_cast<int>(std::ceil(angle0 / quarter_turn)),
+        endk = static_cast<int>(std::floor(angle1 / quarter_turn)); k <= endk; ++k)
+    {
+      const vec2 extremes[4] =
+        {
+          vec2(1.0f, 0.0f),
+          vec2(0.0f, 1.0f),
+          vec2(-1.0f, 0.0f),
+          vec2(0.0f, -1.0f),
+        };
+      union_point(extremes[((k % 4) + 4) % 4], d->m_min_bb, d->m_max_bb);
+    }
+
   d->m_min_bb = d->m_center + d->m_radius * d->m_min_bb;
   d->m_max_bb = d->m_center + d->m_radius * d->m_max_bb;
 }
@@ -1093,6 +1897,15 @@ fastuidraw::PathContour::arc::
   m_d = NULL;
 }
 
+float
+fastuidraw::PathContour::arc::
+angle(void) const
+{
+  ArcPrivate *d;
+  d = static_cast<ArcPrivate*>(m_d);
+  return d->m_angle_speed;
+}
+
 unsigned int
 fastuidraw::PathContour::arc::
 produce_tessellation(const TessellatedPath::TessellationParams &tess_params,
@@ -1173,16 +1986,15 @@ start(const vec2 &start_pt)
   d = static_cast<PathContourPrivate*>(m_d);
 
   assert(d->m_interpolators.empty());
-  assert(!d->m_end_to_start);
+  assert(!d->m_ended);
 
   d->m_start_pt = start_pt;
 
   /* m_interpolators[0] is an "empty" interpolator whose only purpose
-     it to provide a "previous" for the first interpolator added.
+     it to provide a "previous" for the first interpolator added; it
+     is a line segment, so it is only created when needed.
    */
-  reference_counted_ptr<const interpolator_base> h;
-  h = FASTUIDRAWnew flat(reference_counted_ptr<const interpolator_base>(), d->m_start_pt);
-  d->m_interpolators.push_back(h);
+  d->add_flat(d->m_start_pt);
 }
 
 void
@@ -1192,7 +2004,7 @@ add_control_point(const fastuidraw::vec2 &pt)
   PathContourPrivate *d;
   d = static_cast<PathContourPrivate*>(m_d);
 
-  assert(!d->m_end_to_start);
+  assert(!d->m_ended);
   d->m_current_control_points.push_back(pt);
 }
 
@@ -1203,29 +2015,38 @@ to_point(const fastuidraw::vec2 &pt)
   PathContourPrivate *d;
   d = static_cast<PathContourPrivate*>(m_d);
 
-  reference_counted_ptr<const interpolator_base> h;
+  assert(!d->m_interpolators.empty());
+  assert(!d->m_ended);
 
   if(d->m_current_control_points.empty())
     {
-      h = FASTUIDRAWnew flat(prev_interpolator(), pt);
+      d->add_flat(pt);
     }
   else
     {
-      h = FASTUIDRAWnew bezier(prev_interpolator(),
-                              make_c_array(d->m_current_control_points),
-                              pt);
+      reference_counted_ptr<const interpolator_base> h;
+      h = FASTUIDRAWnew bezier(d->create_interpolator(d->m_interpolators.size() - 1),
+                               make_c_array(d->m_current_control_points),
+                               pt);
+      d->m_current_control_points.clear();
+      d->add_interpolator(h);
     }
-  d->m_current_control_points.clear();
-  to_generic(h);
 }
 
 void
 fastuidraw::PathContour::
 to_arc(float angle, const vec2 &pt)
 {
+  PathContourPrivate *d;
+  d = static_cast<PathContourPrivate*>(m_d);
+
+  assert(!d->m_interpolators.empty());
+  assert(d->m_current_control_points.empty());
+  assert(!d->m_ended);
+
   reference_counted_ptr<const interpolator_base> h;
-  h = FASTUIDRAWnew arc(prev_interpolator(), angle, pt);
-  to_generic(h);
+  h = FASTUIDRAWnew arc(d->create_interpolator(d->m_interpolators.size() - 1), angle, pt);
+  d->add_interpolator(h);
 }
 
 void
@@ -1237,23 +2058,72 @@ to_generic(const reference_counted_ptr<const PathContour::interpolator_base> &p)
 
   assert(!d->m_interpolators.empty());
   assert(d->m_current_control_points.empty());
-  assert(!d->m_end_to_start);
+  assert(!d->m_ended);
   assert(p->prev_interpolator() == prev_interpolator());
 
-  d->m_interpolators.push_back(p);
+  d->add_interpolator(p);
 }
 
 void
 fastuidraw::PathContour::
 end_generic(reference_counted_ptr<const interpolator_base> p)
+{
+  assert(p);
+  assert(p->prev_interpolator() == prev_interpolator());
+  end_contour(p);
+}
+
+void
+fastuidraw::PathContour::
+end(void)
+{
+  PathContourPrivate *d;
+  d = static_cast<PathContourPrivate*>(m_d);
+
+  reference_counted_ptr<const interpolator_base> h;
+
+  assert(!d->m_interpolators.empty());
+  if(!d->m_current_control_points.empty())
+    {
+      h = FASTUIDRAWnew bezier(d->create_interpolator(d->m_interpolators.size() - 1),
+                               make_c_array(d->m_current_control_points),
+                               d->m_start_pt);
+      d->m_current_control_points.clear();
+    }
+  end_contour(h);
+}
+
+void
+fastuidraw::PathContour::
+end_arc(float angle)
+{
+  PathContourPrivate *d;
+  d = static_cast<PathContourPrivate*>(m_d);
+
+  assert(!d->m_interpolators.empty());
+
+  reference_counted_ptr<const interpolator_base> h;
+  h = FASTUIDRAWnew arc(d->create_interpolator(d->m_interpolators.size() - 1),
+                        angle, d->m_start_pt);
+  end_contour(h);
+}
+
+void
+fastuidraw::PathContour::
+end_contour(reference_counted_ptr<const interpolator_base> p)
 {
   PathContourPrivate *d;
   d = static_cast<PathContourPrivate*>(m_d);
 
-  assert(!d->m_end_to_start);
+  assert(!d->m_ended);
   assert(d->m_current_control_points.empty());
   assert(!d->m_interpolators.empty());
-  assert(p->prev_interpolator() == prev_interpolator());
+
+  /* a NULL p indicates that the closing edge is a line segment */
+  if(!p && d->m_materialized)
+    {
+      p = FASTUIDRAWnew flat(d->m_interpolators.back(), d->m_start_pt);
+    }
 
   if(d->m_interpolators.size() == 1)
     {
@@ -1263,76 +2133,113 @@ end_generic(reference_counted_ptr<const interpolator_base> p)
          interpolator -after- p which starts and ends on the
          end point of p.
        */
-      reference_counted_ptr<const interpolator_base> h;
+      if(p)
+        {
+          reference_counted_ptr<const interpolator_base> h;
 
-      to_generic(p);
-      h = FASTUIDRAWnew flat(p, p->end_pt());
-      p = h;
+          d->add_interpolator(p);
+          h = FASTUIDRAWnew flat(p, p->end_pt());
+          p = h;
+        }
+      else
+        {
+          d->add_flat(d->m_start_pt);
+        }
     }
 
-  /* hack-evil: we are going to replace m_interpolator[0]
-     with p, we also need to change m_interpolator[1]->m_prev
-     as well to p.
-   */
   assert(d->m_interpolators.size() > 1);
+  if(p)
+    {
+      /* hack-evil: we are going to replace m_interpolator[0]
+         with p, we also need to change m_interpolator[1]->m_prev
+         as well to p if it was created.
+       */
+      if(d->m_interpolators[1])
+        {
+          InterpolatorBasePrivate *q;
+          q = static_cast<InterpolatorBasePrivate*>(d->m_interpolators[1]->m_d);
+          q->m_prev = p.get();
+        }
+      d->m_interpolators[0] = p;
+    }
 
-  InterpolatorBasePrivate *q;
-  q = static_cast<InterpolatorBasePrivate*>(d->m_interpolators[1]->m_d);
-  q->m_prev = p.get();
-
-  d->m_interpolators[0] = p;
-  d->m_end_to_start = p;
+  /* when the closing edge is a line segment, m_interpolators[0]
+     stays as the fake interpolator if it was created; it ends at
+     the start point, as does the closing edge.
+   */
+  d->m_ended = true;
+  if(d->m_materialized)
+    {
+      d->m_end_to_start = d->m_interpolators[0];
+    }
 
-  /* compute bounding box after ending the PathContour.
+  /* compute bounding box after ending the PathContour; the
+     bounding box of a line segment is given by its end points,
+     which are all points of the contour.
    */
-  d->m_interpolators[0]->approximate_bounding_box(&d->m_min_bb, &d->m_max_bb);
-  for(unsigned int i = 1, endi = d->m_interpolators.size(); i < endi; ++i)
+  d->m_min_bb = d->m_max_bb = d->m_start_pt;
+  for(unsigned int i = 1, endi = d->m_pts.size(); i < endi; ++i)
+    {
+      union_point(d->m_pts[i], d->m_min_bb, d->m_max_bb);
+    }
+  d->m_tight_min_bb = d->m_min_bb;
+  d->m_tight_max_bb = d->m_max_bb;
+
+  d->m_is_flat = true;
+  for(unsigned int i = 0, endi = d->m_interpolators.size(); i < endi; ++i)
     {
-      vec2 p0, p1;
-      d->m_interpolators[i]->approximate_bounding_box(&p0, &p1);
+      const interpolator_base *h(d->m_interpolators[i].get());
+
+      if(h && !dynamic_cast<const flat*>(h))
+        {
+          vec2 p0, p1;
 
-      d->m_min_bb.x() = fastuidraw::t_min(d->m_min_bb.x(), p0.x());
-      d->m_min_bb.y() = fastuidraw::t_min(d->m_min_bb.y(), p0.y());
+          d->m_is_flat = false;
+          h->approximate_bounding_box(&p0, &p1);
+          union_box(p0, p1, d->m_min_bb, d->m_max_bb);
 
-      d->m_max_bb.x() = fastuidraw::t_max(d->m_max_bb.x(), p1.x());
-      d->m_max_bb.y() = fastuidraw::t_max(d->m_max_bb.y(), p1.y());
+          h->tight_bounding_box(&p0, &p1);
+          union_box(p0, p1, d->m_tight_min_bb, d->m_tight_max_bb);
+        }
     }
 }
 
 void
 fastuidraw::PathContour::
-end(void)
+create_interpolators(void) const
 {
   PathContourPrivate *d;
   d = static_cast<PathContourPrivate*>(m_d);
 
-  reference_counted_ptr<const interpolator_base> h;
-
-  if(d->m_current_control_points.empty())
+  if(d->m_materialized)
     {
-      h = FASTUIDRAWnew flat(prev_interpolator(), d->m_start_pt);
+      return;
     }
-  else
+
+  d->m_materialized = true;
+  for(unsigned int i = 0, endi = d->m_interpolators.size(); i < endi; ++i)
     {
-      h = FASTUIDRAWnew bezier(prev_interpolator(),
-                               make_c_array(d->m_current_control_points),
-                               d->m_start_pt);
+      d->create_interpolator(i);
     }
 
-  d->m_current_control_points.clear();
-  end_generic(h);
-}
-
-void
-fastuidraw::PathContour::
-end_arc(float angle)
-{
-  PathContourPrivate *d;
-  d = static_cast<PathContourPrivate*>(m_d);
+  /* set the previous of each interpolator, since a flat
+     created for a line segment before its previous was
+     created has NULL as its previous.
+   */
+  for(unsigned int i = 1, endi = d->m_interpolators.size(); i < endi; ++i)
+    {
+      InterpolatorBasePrivate *q;
+      q = static_cast<InterpolatorBasePrivate*>(d->m_interpolators[i]->m_d);
+      q->m_prev = d->m_interpolators[i - 1].get();
+    }
 
-  reference_counted_ptr<const interpolator_base> h;
-  h = FASTUIDRAWnew arc(prev_interpolator(), angle, d->m_start_pt);
-  end_generic(h);
+  if(d->m_ended)
+    {
+      InterpolatorBasePrivate *q;
+      q = static_cast<InterpolatorBasePrivate*>(d->m_interpolators[0]->m_d);
+      q->m_prev = d->m_interpolators.back().get();
+      d->m_end_to_start = d->m_interpolators[0];
+    }
 }
 
 unsigned int
@@ -1341,7 +2248,7 @@ number_points(void) const
 {
   PathContourPrivate *d;
   d = static_cast<PathContourPrivate*>(m_d);
-  return d->m_interpolators.size();
+  return d->m_pts.size();
 }
 
 const fastuidraw::vec2&
@@ -1350,7 +2257,7 @@ point(unsigned int I) const
 {
   PathContourPrivate *d;
   d = static_cast<PathContourPrivate*>(m_d);
-  return d->m_interpolators[I]->end_pt();
+  return d->m_pts[I];
 }
 
 const fastuidraw::reference_counted_ptr<const fastuidraw::PathContour::interpolator_base>&
@@ -1360,6 +2267,8 @@ interpolator(unsigned int I) const
   PathContourPrivate *d;
   d = static_cast<PathContourPrivate*>(m_d);
 
+  create_interpolators();
+
   /* m_interpolator[I+1] connects point(I) to point(I+1).
    */
   unsigned int J(I+1);
@@ -1374,102 +2283,611 @@ interpolator(unsigned int I) const
     d->m_interpolators[J];
 }
 
+const fastuidraw::PathContour::interpolator_base*
+fastuidraw::PathContour::
+curve_interpolator(unsigned int I) const
+{
+  PathContourPrivate *d;
+  d = static_cast<PathContourPrivate*>(m_d);
+
+  unsigned int J(I+1);
+  const interpolator_base *h;
+
+  assert(J <= d->m_interpolators.size());
+  if(J == d->m_interpolators.size())
+    {
+      h = (d->m_ended) ? d->m_interpolators[0].get() : NULL;
+    }
+  else
+    {
+      h = d->m_interpolators[J].get();
+    }
+
+  return (h && !dynamic_cast<const flat*>(h)) ? h : NULL;
+}
 
 const fastuidraw::reference_counted_ptr<const fastuidraw::PathContour::interpolator_base>&
 fastuidraw::PathContour::
 prev_interpolator(void)
 {
-  PathContourPrivate *d;
-  d = static_cast<PathContourPrivate*>(m_d);
+  PathContourPrivate *d;
+  d = static_cast<PathContourPrivate*>(m_d);
+
+  assert(!d->m_interpolators.empty());
+  create_interpolators();
+  return d->m_interpolators.back();
+}
+
+bool
+fastuidraw::PathContour::
+ended(void) const
+{
+  PathContourPrivate *d;
+  d = static_cast<PathContourPrivate*>(m_d);
+
+  return d->m_ended;
+}
+
+bool
+fastuidraw::PathContour::
+is_flat(void) const
+{
+  PathContourPrivate *d;
+  d = static_cast<PathContourPrivate*>(m_d);
+
+  return d->m_ended && d->m_is_flat;
+}
+
+fastuidraw::PathContour*
+fastuidraw::PathContour::
+deep_copy(void)
+{
+  PathContour *return_value;
+  return_value = FASTUIDRAWnew PathContour();
+
+  PathContourPrivate *d, *r;
+  d = static_cast<PathContourPrivate*>(m_d);
+  r = static_cast<PathContourPrivate*>(return_value->m_d);
+
+  r->m_start_pt = d->m_start_pt;
+  r->m_current_control_points = d->m_current_control_points;
+  r->m_pts = d->m_pts;
+  r->m_min_bb = d->m_min_bb;
+  r->m_max_bb = d->m_max_bb;
+  r->m_tight_min_bb = d->m_tight_min_bb;
+  r->m_tight_max_bb = d->m_tight_max_bb;
+  r->m_ended = d->m_ended;
+  r->m_is_flat = d->m_is_flat;
+
+  /* now we need to do the deep copies of the interpolators
+     that are not line segments; the line segments of the
+     copy are only created when needed.
+   */
+  r->m_interpolators.resize(d->m_interpolators.size());
+  for(unsigned int i = 1, endi = d->m_interpolators.size(); i < endi; ++i)
+    {
+      const interpolator_base *h(d->m_interpolators[i].get());
+      if(h && !dynamic_cast<const flat*>(h))
+        {
+          r->m_interpolators[i] = h->deep_copy(r->create_interpolator(i - 1));
+        }
+    }
+
+  const interpolator_base *h(d->m_interpolators.empty() ? NULL : d->m_interpolators[0].get());
+  if(d->m_ended && h && !dynamic_cast<const flat*>(h))
+    {
+      r->m_interpolators[0] = h->deep_copy(r->create_interpolator(r->m_interpolators.size() - 1));
+
+      //we also need to replace r->m_interpolators[1]->m_prev with
+      //the new value for r->m_interpolators[0]
+      assert(r->m_interpolators.size() > 1);
+      if(r->m_interpolators[1])
+        {
+          InterpolatorBasePrivate *q;
+          q = static_cast<InterpolatorBasePrivate*>(r->m_interpolators[1]->m_d);
+          q->m_prev = r->m_interpolators[0].get();
+        }
+    }
+  return return_value;
+}
+
+bool
+fastuidraw::PathContour::
+approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const
+{
+  if(!ended())
+    {
+      return false;
+    }
+
+  PathContourPrivate *d;
+  d = static_cast<PathContourPrivate*>(m_d);
+
+  *out_min_bb = d->m_min_bb;
+  *out_max_bb = d->m_max_bb;
+
+  return true;
+}
+
+bool
+fastuidraw::PathContour::
+tight_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const
+{
+  if(!ended())
+    {
+      return false;
+    }
+
+  PathContourPrivate *d;
+  d = static_cast<PathContourPrivate*>(m_d);
+
+  *out_min_bb = d->m_tight_min_bb;
+  *out_max_bb = d->m_tight_max_bb;
+
+  return true;
+}
+
+/////////////////////////////////
+// PathPrivate methods
+PathPrivate::
+PathPrivate(const PathPrivate &obj):
+  m_contours(obj.m_contours),
+  m_tessellation(obj.m_tessellation),
+  m_tessellation_done(obj.m_tessellation_done),
+  m_last_use(obj.m_last_use),
+  m_cache_max_bytes(obj.m_cache_max_bytes),
+  m_use_counter(obj.m_use_counter),
+  m_prev_tessellation(obj.m_prev_tessellation),
+  m_async_tessellation(obj.m_async_tessellation),
+  m_async_job(NULL),
+  m_start_check_bb(obj.m_start_check_bb),
+  m_max_bb(obj.m_max_bb),
+  m_min_bb(obj.m_min_bb),
+  m_tight_max_bb(obj.m_tight_max_bb),
+  m_tight_min_bb(obj.m_tight_min_bb),
+  m_geometry_cache(obj.m_geometry_cache),
+  m_geometry_key_state(obj.m_geometry_key_state),
+  m_geometry_key(obj.m_geometry_key)
+{
+  /* if the last contour is not ended, we need to do a
+     deep copy on it.
+   */
+  if(!m_contours.back()->ended())
+    {
+      m_contours.back() = m_contours.back()->deep_copy();
+    }
+}
+
+PathPrivate::
+~PathPrivate()
+{
+  retire_async_job();
+}
+
+bool
+PathPrivate::
+update_bounding_boxes(void)
+{
+  bool assigned_value(m_start_check_bb != 0u);
+  for(unsigned endi = m_contours.size();
+      m_start_check_bb < endi && m_contours[m_start_check_bb]->ended();
+      ++m_start_check_bb)
+    {
+      fastuidraw::vec2 p0, p1, q0, q1;
+      bool value_valid;
+
+      value_valid = m_contours[m_start_check_bb]->approximate_bounding_box(&p0, &p1)
+        && m_contours[m_start_check_bb]->tight_bounding_box(&q0, &q1);
+      assert(value_valid);
+      FASTUIDRAWunused(value_valid);
+
+      if(assigned_value)
+        {
+          union_box(p0, p1, m_min_bb, m_max_bb);
+          union_box(q0, q1, m_tight_min_bb, m_tight_max_bb);
+        }
+      else
+        {
+          m_min_bb = p0;
+          m_max_bb = p1;
+          m_tight_min_bb = q0;
+          m_tight_max_bb = q1;
+          assigned_value = true;
+        }
+    }
+  return assigned_value;
+}
+
+PathPrivate::tessellated_path_ref
+PathPrivate::
+create_tessellation(const fastuidraw::Path &path,
+                    const TessellatedPath::TessellationParams &params,
+                    const TessellatedPath *prev)
+{
+  for(std::vector<tessellated_path_ref>::const_iterator iter = m_prev_tessellation.begin(),
+        end = m_prev_tessellation.end(); iter != end; ++iter)
+    {
+      if(!((*iter)->tessellation_parameters() != params))
+        {
+          return FASTUIDRAWnew TessellatedPath(path, params, **iter);
+        }
+    }
+  return (prev) ?
+    FASTUIDRAWnew TessellatedPath(path, params, *prev) :
+    FASTUIDRAWnew TessellatedPath(path, params);
+}
+
+PathPrivate::tessellated_path_ref
+PathPrivate::
+create_level(const fastuidraw::Path &path, PathPrivate *reuse,
+             const TessellatedPath::TessellationParams &params,
+             const TessellatedPath *prev)
+{
+  if(reuse)
+    {
+      return reuse->create_tessellation(path, params, prev);
+    }
+  return (prev) ?
+    FASTUIDRAWnew TessellatedPath(path, params, *prev) :
+    FASTUIDRAWnew TessellatedPath(path, params);
+}
+
+bool
+PathPrivate::
+refine_tessellation(const fastuidraw::Path &path, PathPrivate *reuse,
+                    const TessellatedPath *start,
+                    unsigned int start_max_segments, float start_thresh,
+                    float thresh, std::vector<tessellated_path_ref> &out)
+{
+  TessellatedPath::TessellationParams params;
+  tessellated_path_ref ref;
+  const TessellatedPath *prev(start);
+  float current_tess(start_thresh);
+  bool tessellation_done(false);
+
+  params
+    .max_segments(2 * start_max_segments)
+    .curve_distance_tessellate(start_thresh);
+
+  while(!tessellation_done && current_tess > thresh)
+    {
+      float last_tess;
+
+      params.m_threshhold *= 0.5f;
+      last_tess = current_tess;
+      ref = create_level(path, reuse, params, prev);
+      prev = ref.get();
+      current_tess = ref->effective_curve_distance_threshhold();
+      tessellation_done = (last_tess <= current_tess);
+
+      while(!tessellation_done && current_tess > params.m_threshhold)
+        {
+          params.m_max_segments *= 2;
+          last_tess = current_tess;
+          ref = create_level(path, reuse, params, prev);
+          prev = ref.get();
+          current_tess = ref->effective_curve_distance_threshhold();
+          tessellation_done = (last_tess <= current_tess);
+        }
+
+      if(tessellation_done)
+        {
+          std::cout << "Tapped out at (max_segs = "
+                    << ref->max_segments() << ", tess_factor = "
+                    << ref->effective_curve_distance_threshhold()
+                    << ", num_points = " << ref->number_points()
+                    << ")\n";
+        }
+      out.push_back(ref);
+    }
+  return tessellation_done;
+}
+
+void
+PathPrivate::
+poll_async_jobs(void)
+{
+  if(m_async_job == NULL || !m_async_job->done())
+    {
+      return;
+    }
+
+  /* levels may have been evicted while the job ran, only
+     take the results that keep m_tessellation sorted.
+   */
+  const std::vector<tessellated_path_ref> &results(m_async_job->m_results);
+  for(unsigned int i = 0, endi = results.size(); i < endi; ++i)
+    {
+      if(results[i]->effective_curve_distance_threshhold()
+         < m_tessellation.back()->effective_curve_distance_threshhold())
+        {
+          add_tessellation(results[i]);
+          m_tessellation_done = (i + 1 == endi) && m_async_job->m_tessellation_done;
+        }
+    }
+  FASTUIDRAWdelete(m_async_job);
+  m_async_job = NULL;
+}
+
+bool
+PathPrivate::
+ready_geometry_key(void)
+{
+  if(m_geometry_key_state == geometry_key_dirty)
+    {
+      std::vector<uint32_t> &words(m_geometry_key.second);
+      uint64_t hash(14695981039346656037ull);
+
+      m_geometry_key_state = geometry_key_valid;
+      words.clear();
+      words.push_back(m_contours.size());
+      for(unsigned int c = 0, endc = m_contours.size();
+          c < endc && m_geometry_key_state == geometry_key_valid; ++c)
+        {
+          const fastuidraw::PathContour *contour(m_contours[c].get());
+
+          if(!contour->ended())
+            {
+              m_geometry_key_state = geometry_key_none;
+              break;
+            }
+
+          words.push_back(contour->number_points());
+          add_geometry_words(contour->point(0), words);
+          for(unsigned int i = 0, endi = contour->number_points(); i < endi; ++i)
+            {
+              const fastuidraw::vec2 &end_pt(contour->point(i + 1 < endi ? i + 1 : 0));
+              if(!add_geometry_words(contour->curve_interpolator(i), end_pt, words))
+                {
+                  m_geometry_key_state = geometry_key_none;
+                  break;
+                }
+            }
+        }
+
+      if(m_geometry_key_state == geometry_key_valid)
+        {
+          for(unsigned int i = 0, endi = words.size(); i < endi; ++i)
+            {
+              hash ^= words[i];
+              hash *= 1099511628211ull;
+            }
+          m_geometry_key.first = hash;
+        }
+      else
+        {
+          words.clear();
+        }
+    }
+  return m_geometry_key_state == geometry_key_valid;
+}
+
+void
+PathPrivate::
+take_from_geometry_cache(PathGeometryCachePrivate *cache)
+{
+  std::map<geometry_key, GeometryCacheEntry>::const_iterator iter;
+
+  if(!ready_geometry_key())
+    {
+      return;
+    }
+
+  iter = cache->m_entries.find(m_geometry_key);
+  if(iter == cache->m_entries.end() || iter->second.m_tessellation.empty())
+    {
+      return;
+    }
+
+  const GeometryCacheEntry &E(iter->second);
+  if(m_tessellation.empty()
+     || E.m_tessellation.back()->effective_curve_distance_threshhold()
+     < m_tessellation.back()->effective_curve_distance_threshhold())
+    {
+      m_tessellation = E.m_tessellation;
+      m_last_use.assign(m_tessellation.size(), 0u);
+      m_tessellation_done = E.m_tessellation_done;
+      ++cache->m_number_hits;
+    }
+}
+
+void
+PathPrivate::
+give_to_geometry_cache(PathGeometryCachePrivate *cache)
+{
+  if(m_tessellation.empty() || !ready_geometry_key())
+    {
+      return;
+    }
+
+  GeometryCacheEntry &E(cache->m_entries[m_geometry_key]);
+  if(E.m_tessellation.empty()
+     || m_tessellation.back()->effective_curve_distance_threshhold()
+     < E.m_tessellation.back()->effective_curve_distance_threshhold()
+     || (m_tessellation_done && !E.m_tessellation_done))
+    {
+      E.m_tessellation = m_tessellation;
+      E.m_tessellation_done = m_tessellation_done;
+    }
+}
+
+bool
+PathPrivate::
+start_async_job(float thresh)
+{
+  if(!m_contours.empty() && !m_contours.back()->ended())
+    {
+      return false;
+    }
+
+  if(m_async_job == NULL)
+    {
+      m_async_job = AsyncTessellation::start(m_contours, *m_tessellation.back(), thresh);
+    }
+  return true;
+}
+
+void
+PathPrivate::
+retire_async_job(void)
+{
+  if(m_async_job)
+    {
+      m_async_job->abandon();
+      m_async_job = NULL;
+    }
+}
+
+unsigned int
+PathPrivate::
+cache_bytes(void) const
+{
+  unsigned int return_value(0);
+  for(unsigned int i = 0, endi = m_tessellation.size(); i < endi; ++i)
+    {
+      return_value += m_tessellation[i]->number_bytes();
+    }
+  for(unsigned int i = 0, endi = m_prev_tessellation.size(); i < endi; ++i)
+    {
+      return_value += m_prev_tessellation[i]->number_bytes();
+    }
+  return return_value;
+}
+
+const PathPrivate::tessellated_path_ref&
+PathPrivate::
+use_tessellation(unsigned int idx)
+{
+  assert(idx < m_tessellation.size());
+  m_last_use[idx] = ++m_use_counter;
+
+  while(m_cache_max_bytes > 0 && cache_bytes() > m_cache_max_bytes)
+    {
+      unsigned int victim(m_tessellation.size());
+
+      /* the previous tessellations are only an aid
+         to incremental tessellation, drop them first.
+       */
+      if(!m_prev_tessellation.empty())
+        {
+          m_prev_tessellation.clear();
+          continue;
+        }
+
+      /* never evict the coarsest level since finer levels
+         are created from it, nor the level being returned.
+       */
+      for(unsigned int i = 1, endi = m_tessellation.size(); i < endi; ++i)
+        {
+          if(i != idx && (victim == endi || m_last_use[i] < m_last_use[victim]))
+            {
+              victim = i;
+            }
+        }
+
+      if(victim == m_tessellation.size())
+        {
+          break;
+        }
+
+      if(victim + 1 == m_tessellation.size())
+        {
+          m_tessellation_done = false;
+        }
+      m_tessellation.erase(m_tessellation.begin() + victim);
+      m_last_use.erase(m_last_use.begin() + victim);
+      if(victim < idx)
+        {
+          --idx;
+        }
+    }
+  return m_tessellation[idx];
+}
+
+///////////////////////////////////////
+// AsyncTessellation methods
+AsyncTessellation::
+AsyncTessellation(const std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PathContour> > &contours,
+                  const fastuidraw::TessellatedPath &start, float thresh):
+  m_start_max_segments(start.max_segments()),
+  m_start_thresh(start.effective_curve_distance_threshhold()),
+  m_thresh(thresh),
+  m_tessellation_done(false),
+  m_done(false),
+  m_abandoned(false)
+{
+  for(unsigned int i = 0, endi = contours.size(); i < endi; ++i)
+    {
+      m_path.add_contour(contours[i]->deep_copy());
+    }
+}
+
+AsyncTessellation*
+AsyncTessellation::
+start(const std::vector<fastuidraw::reference_counted_ptr<fastuidraw::PathContour> > &contours,
+      const fastuidraw::TessellatedPath &start, float thresh)
+{
+  AsyncTessellation *p;
 
-  assert(!d->m_interpolators.empty());
-  return d->m_interpolators[d->m_interpolators.size() - 1];
+  p = FASTUIDRAWnew AsyncTessellation(contours, start, thresh);
+  fastuidraw::default_task_executor()->run_task_async(p);
+  return p;
 }
 
 bool
-fastuidraw::PathContour::
-ended(void) const
+AsyncTessellation::
+done(void)
 {
-  PathContourPrivate *d;
-  d = static_cast<PathContourPrivate*>(m_d);
-
-  return d->m_end_to_start;
+  fastuidraw::autolock_mutex M(m_mutex);
+  return m_done;
 }
 
-fastuidraw::PathContour*
-fastuidraw::PathContour::
-deep_copy(void)
+void
+AsyncTessellation::
+abandon(void)
 {
-  PathContour *return_value;
-  return_value = FASTUIDRAWnew PathContour();
-
-  PathContourPrivate *d, *r;
-  d = static_cast<PathContourPrivate*>(m_d);
-  r = static_cast<PathContourPrivate*>(return_value->m_d);
-
-  r->m_start_pt = d->m_start_pt;
-  r->m_current_control_points = d->m_current_control_points;
-
-  /* now we need to do the deep copies of the interpolator. eww.
-   */
-  r->m_interpolators.resize(d->m_interpolators.size());
+  bool delete_now;
 
-  r->m_interpolators[0] = FASTUIDRAWnew flat(reference_counted_ptr<const interpolator_base>(), r->m_start_pt);
-  for(unsigned int i = 1, endi = d->m_interpolators.size(); i < endi; ++i)
-    {
-      r->m_interpolators[i] = d->m_interpolators[i]->deep_copy(r->m_interpolators[i-1]);
-    }
+  m_mutex.lock();
+  assert(!m_abandoned);
+  m_abandoned = true;
+  delete_now = m_done;
+  m_mutex.unlock();
 
-  if(d->m_end_to_start)
+  if(delete_now)
     {
-      r->m_interpolators[0] = d->m_end_to_start->deep_copy(r->m_interpolators.back());
-      r->m_end_to_start = r->m_interpolators[0];
-
-      //we also need to replace r->m_interpolators[1]->m_prev with
-      //the new value for r->m_interpolators[0]
-      assert(r->m_interpolators.size() > 1);
-      InterpolatorBasePrivate *q;
-      q = static_cast<InterpolatorBasePrivate*>(r->m_interpolators[1]->m_d);
-      q->m_prev = r->m_end_to_start.get();
+      FASTUIDRAWdelete(this);
     }
-  return return_value;
 }
 
-bool
-fastuidraw::PathContour::
-approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const
+void
+AsyncTessellation::
+run(void)
 {
-  if(!ended())
+  bool delete_now;
+
+  m_tessellation_done = PathPrivate::refine_tessellation(m_path, NULL, NULL, m_start_max_segments,
+                                                         m_start_thresh, m_thresh, m_results);
+  if(!m_results.empty())
     {
-      return false;
+      /* create the data for drawing here too so that the
+         thread drawing the path does not need to.
+       */
+      m_results.back()->stroked();
+      m_results.back()->filled();
     }
 
-  PathContourPrivate *d;
-  d = static_cast<PathContourPrivate*>(m_d);
-
-  *out_min_bb = d->m_min_bb;
-  *out_max_bb = d->m_max_bb;
-
-  return true;
-}
+  m_mutex.lock();
+  m_done = true;
+  delete_now = m_abandoned;
+  m_mutex.unlock();
 
-/////////////////////////////////
-// PathPrivate methods
-PathPrivate::
-PathPrivate(const PathPrivate &obj):
-  m_contours(obj.m_contours),
-  m_tessellation(obj.m_tessellation),
-  m_tessellation_done(obj.m_tessellation_done),
-  m_start_check_bb(obj.m_start_check_bb),
-  m_max_bb(obj.m_max_bb),
-  m_min_bb(obj.m_min_bb)
-{
-  /* if the last contour is not ended, we need to do a
-     deep copy on it.
+  /* nothing else references the results of an
+     abandoned job, so they are freed on this thread.
    */
-  if(!m_contours.back()->ended())
+  if(delete_now)
     {
-      m_contours.back() = m_contours.back()->deep_copy();
+      FASTUIDRAWdelete(this);
     }
 }
 
@@ -1489,6 +2907,15 @@ Path(const Path &obj)
   m_d = FASTUIDRAWnew PathPrivate(*obj_d);
 }
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+fastuidraw::Path::
+Path(Path &&obj) noexcept:
+  m_d(obj.m_d)
+{
+  obj.m_d = FASTUIDRAWnew PathPrivate();
+}
+#endif
+
 void
 fastuidraw::Path::
 swap(Path &obj)
@@ -1505,6 +2932,16 @@ operator=(const Path &rhs)
   return *this;
 }
 
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+const fastuidraw::Path&
+fastuidraw::Path::
+operator=(Path &&rhs) noexcept
+{
+  swap(rhs);
+  return *this;
+}
+#endif
+
 fastuidraw::Path::
 ~Path()
 {
@@ -1521,8 +2958,12 @@ clear(void)
   PathPrivate *d;
   d = static_cast<PathPrivate*>(m_d);
   d->m_tessellation.clear();
+  d->m_last_use.clear();
+  d->m_prev_tessellation.clear();
+  d->retire_async_job();
   d->m_contours.clear();
   d->m_tessellation_done = false;
+  d->m_geometry_key_state = PathPrivate::geometry_key_dirty;
   d->m_start_check_bb = 0u;
 }
 
@@ -1541,17 +2982,17 @@ add_contour(const reference_counted_ptr<const PathContour> &pcontour)
   reference_counted_ptr<PathContour> contour;
   contour = pcontour.const_cast_ptr<PathContour>();
 
-  d->m_tessellation.clear();
+  d->invalidate_tessellation();
   if(d->m_contours.empty() || d->m_contours.back()->ended())
     {
-      d->m_contours.push_back(contour);
+      d->m_contours.push_back(FASTUIDRAWmove(contour));
     }
   else
     {
       reference_counted_ptr<PathContour> r;
-      r = d->m_contours.back();
-      d->m_contours.back() = contour;
-      d->m_contours.push_back(r);
+      r.swap(d->m_contours.back());
+      d->m_contours.back().swap(contour);
+      d->m_contours.push_back(FASTUIDRAWmove(r));
     }
 
   return *this;
@@ -1567,13 +3008,13 @@ add_contours(const Path &path)
 
   if(d != pd && !pd->m_contours.empty())
     {
-      d->m_tessellation.clear();
+      d->invalidate_tessellation();
       d->m_contours.reserve(d->m_contours.size() + pd->m_contours.size());
 
       reference_counted_ptr<PathContour> r;
       if(!d->m_contours.empty() && !d->m_contours.back()->ended())
         {
-          r = d->m_contours.back();
+          r.swap(d->m_contours.back());
           d->m_contours.pop_back();
         }
 
@@ -1592,12 +3033,190 @@ add_contours(const Path &path)
 
       if(r)
         {
-          d->m_contours.push_back(r);
+          d->m_contours.push_back(FASTUIDRAWmove(r));
         }
     }
   return *this;
 }
 
+unsigned int
+fastuidraw::Path::
+add_contours(const_c_array<enum verb_t> verbs,
+             const_c_array<vec2> pts,
+             const_c_array<float> arc_angles)
+{
+  PathPrivate *d;
+  d = static_cast<PathPrivate*>(m_d);
+
+  if(verbs.empty() || verbs[0] != verb_move || pts.empty())
+    {
+      return 0;
+    }
+
+  d->invalidate_tessellation();
+
+  reference_counted_ptr<PathContour> r;
+  if(!d->m_contours.empty() && !d->m_contours.back()->ended())
+    {
+      r = d->m_contours.back();
+      d->m_contours.pop_back();
+    }
+
+  unsigned int v(0), p(0), a(0);
+  bool truncated(false);
+
+  while(v < verbs.size() && !truncated)
+    {
+      unsigned int endv, num_interpolators;
+      reference_counted_ptr<PathContour> contour;
+      PathContourPrivate *cd;
+
+      assert(verbs[v] == verb_move);
+      if(p >= pts.size())
+        {
+          break;
+        }
+
+      /* count the edges of the contour so that its
+         points and interpolators are allocated just once; one
+         more for the "empty" interpolator added by
+         PathContour::start() and one more in case
+         PathContour::end_generic() needs to add an
+         edge to a contour of one edge.
+       */
+      num_interpolators = 2;
+      for(endv = v + 1; endv < verbs.size() && verbs[endv] != verb_move; ++endv)
+        {
+          if(verbs[endv] != verb_control_point)
+            {
+              ++num_interpolators;
+            }
+        }
+
+      contour = FASTUIDRAWnew PathContour();
+      cd = static_cast<PathContourPrivate*>(contour->m_d);
+      cd->m_interpolators.reserve(num_interpolators);
+      cd->m_pts.reserve(num_interpolators);
+      contour->start(pts[p++]);
+
+      for(++v; v < endv && !contour->ended(); ++v)
+        {
+          enum verb_t verb(verbs[v]);
+          unsigned int num_pts(0), num_angles(0);
+          bool closes;
+
+          switch(verb)
+            {
+            case verb_control_point:
+            case verb_line:
+            case verb_arc:
+              num_pts = 1;
+              break;
+            case verb_quadratic:
+              num_pts = 2;
+              break;
+            case verb_cubic:
+              num_pts = 3;
+              break;
+            default:
+              break;
+            }
+          num_angles = (verb == verb_arc || verb == verb_close_arc) ? 1 : 0;
+
+          if(p + num_pts > pts.size() || a + num_angles > arc_angles.size())
+            {
+              truncated = true;
+              break;
+            }
+
+          /* an edge that ends at the first point and is followed
+             by verb_close is the closing edge of the contour.
+           */
+          closes = verb != verb_control_point
+            && num_pts > 0
+            && v + 1 < endv
+            && verbs[v + 1] == verb_close
+            && pts[p + num_pts - 1] == cd->m_start_pt;
+
+          switch(verb)
+            {
+            case verb_control_point:
+              contour->add_control_point(pts[p]);
+              break;
+
+            case verb_line:
+            case verb_quadratic:
+            case verb_cubic:
+              for(unsigned int i = 0; i + 1 < num_pts; ++i)
+                {
+                  contour->add_control_point(pts[p + i]);
+                }
+              if(closes)
+                {
+                  contour->end();
+                }
+              else
+                {
+                  contour->to_point(pts[p + num_pts - 1]);
+                }
+              break;
+
+            case verb_arc:
+              if(closes)
+                {
+                  contour->end_arc(arc_angles[a]);
+                }
+              else
+                {
+                  contour->to_arc(arc_angles[a], pts[p]);
+                }
+              break;
+
+            case verb_close:
+              contour->end();
+              break;
+
+            case verb_close_arc:
+              contour->end_arc(arc_angles[a]);
+              break;
+
+            default:
+              assert(!"Bad verb_t value passed to Path::add_contours()");
+              break;
+            }
+
+          p += num_pts;
+          a += num_angles;
+          if(closes)
+            {
+              /* skip the verb_close */
+              ++v;
+            }
+        }
+
+      if(!contour->ended())
+        {
+          contour->end();
+        }
+      d->m_contours.push_back(FASTUIDRAWmove(contour));
+
+      /* verbs after the contour is closed and before
+         the next verb_move are ignored.
+       */
+      if(!truncated)
+        {
+          v = endv;
+        }
+    }
+
+  if(r)
+    {
+      d->m_contours.push_back(FASTUIDRAWmove(r));
+    }
+
+  return v;
+}
+
 fastuidraw::Path&
 fastuidraw::Path::
 move(const fastuidraw::vec2 &pt)
@@ -1647,19 +3266,36 @@ fastuidraw::Path::
 tessellation(float thresh) const
 {
   PathPrivate *d;
+  PathGeometryCachePrivate *cache(NULL);
+
   d = static_cast<PathPrivate*>(m_d);
+  if(d->m_geometry_cache)
+    {
+      cache = static_cast<PathGeometryCachePrivate*>(d->m_geometry_cache->m_d);
+      d->take_from_geometry_cache(cache);
+    }
 
   if(d->m_tessellation.empty())
     {
       PathPrivate::tessellated_path_ref ref;
       TessellatedPath::TessellationParams params;
-      ref = FASTUIDRAWnew TessellatedPath(*this, params);
-      d->m_tessellation.push_back(ref);
+      ref = d->create_tessellation(*this, params);
+      d->add_tessellation(ref);
+    }
+
+  if(d->m_async_job)
+    {
+      d->poll_async_jobs();
+    }
+
+  if(cache)
+    {
+      d->give_to_geometry_cache(cache);
     }
 
   if(thresh <= 0.0f)
     {
-      return d->m_tessellation.front();
+      return d->use_tessellation(0);
     }
 
   if(d->m_tessellation.back()->effective_curve_distance_threshhold() <= thresh)
@@ -1673,91 +3309,172 @@ tessellation(float thresh) const
       assert(iter != d->m_tessellation.end());
       assert(*iter);
       assert((*iter)->effective_curve_distance_threshhold() <= thresh);
-      return *iter;
+      return d->use_tessellation(iter - d->m_tessellation.begin());
     }
   else
     {
       if(d->m_tessellation_done)
         {
-          return d->m_tessellation.back();
+          return d->use_tessellation(d->m_tessellation.size() - 1);
         }
 
-      PathPrivate::tessellated_path_ref prev_ref, ref;
-      TessellatedPath::TessellationParams params;
-
-      ref = d->m_tessellation.back();
-      params
-        .max_segments(2 * ref->max_segments())
-        .curve_distance_tessellate(ref->effective_curve_distance_threshhold());
+      if(d->m_async_tessellation && d->start_async_job(thresh))
+        {
+          return d->use_tessellation(d->m_tessellation.size() - 1);
+        }
 
-      while(!d->m_tessellation_done
-            && ref->effective_curve_distance_threshhold() > thresh)
+      const PathPrivate::tessellated_path_ref &ref(d->m_tessellation.back());
+      std::vector<PathPrivate::tessellated_path_ref> refs;
+      d->m_tessellation_done =
+        PathPrivate::refine_tessellation(*this, d, ref.get(), ref->max_segments(),
+                                         ref->effective_curve_distance_threshhold(),
+                                         thresh, refs);
+      for(unsigned int i = 0, endi = refs.size(); i < endi; ++i)
         {
-          float last_tess;
+          d->add_tessellation(refs[i]);
+        }
+      if(cache)
+        {
+          d->give_to_geometry_cache(cache);
+        }
+      return d->use_tessellation(d->m_tessellation.size() - 1);
+    }
+}
 
-          params.m_threshhold *= 0.5f;
-          last_tess = ref->effective_curve_distance_threshhold();
-          ref = FASTUIDRAWnew TessellatedPath(*this, params);
-          d->m_tessellation_done = (last_tess <= ref->effective_curve_distance_threshhold());
+fastuidraw::Path&
+fastuidraw::Path::
+tessellation_cache_max_bytes(unsigned int v)
+{
+  PathPrivate *d;
+  d = static_cast<PathPrivate*>(m_d);
+  d->m_cache_max_bytes = v;
+  return *this;
+}
 
-          while(!d->m_tessellation_done && ref->effective_curve_distance_threshhold() > params.m_threshhold)
-            {
-              params.m_max_segments *= 2;
-              last_tess = ref->effective_curve_distance_threshhold();
-              ref = FASTUIDRAWnew TessellatedPath(*this, params);
-              d->m_tessellation_done = (last_tess <= ref->effective_curve_distance_threshhold());
-            }
+unsigned int
+fastuidraw::Path::
+tessellation_cache_max_bytes(void) const
+{
+  PathPrivate *d;
+  d = static_cast<PathPrivate*>(m_d);
+  return d->m_cache_max_bytes;
+}
 
-          if(d->m_tessellation_done)
-            {
-              std::cout << "Tapped out at (max_segs = "
-                        << ref->max_segments() << ", tess_factor = "
-                        << ref->effective_curve_distance_threshhold()
-                        << ", num_points = " << ref->point_data().size()
-                        << ")\n";
-            }
-          d->m_tessellation.push_back(ref);
-        }
-      return d->m_tessellation.back();
+unsigned int
+fastuidraw::Path::
+tessellation_cache_bytes(void) const
+{
+  PathPrivate *d;
+  d = static_cast<PathPrivate*>(m_d);
+  return d->cache_bytes();
+}
+
+fastuidraw::Path&
+fastuidraw::Path::
+async_tessellation(bool v)
+{
+  PathPrivate *d;
+  d = static_cast<PathPrivate*>(m_d);
+  d->m_async_tessellation = v;
+  if(!v && d->m_async_job)
+    {
+      /* the levels of the job in flight are still taken
+         by the next call to tessellation().
+       */
+      d->poll_async_jobs();
     }
+  return *this;
 }
 
 bool
 fastuidraw::Path::
-approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const
+async_tessellation(void) const
 {
   PathPrivate *d;
   d = static_cast<PathPrivate*>(m_d);
+  return d->m_async_tessellation;
+}
 
-  bool assigned_value(d->m_start_check_bb != 0u);
-  for(unsigned endi = d->m_contours.size();
-      d->m_start_check_bb < endi && d->m_contours[d->m_start_check_bb]->ended();
-      ++d->m_start_check_bb)
-    {
-      vec2 p0, p1;
-      bool value_valid;
+bool
+fastuidraw::Path::
+tessellation_pending(void) const
+{
+  PathPrivate *d;
+  d = static_cast<PathPrivate*>(m_d);
+  return d->m_async_job != NULL && !d->m_async_job->done();
+}
 
-      value_valid = d->m_contours[d->m_start_check_bb]->approximate_bounding_box(&p0, &p1);
-      assert(value_valid);
-      FASTUIDRAWunused(value_valid);
+fastuidraw::Path&
+fastuidraw::Path::
+geometry_cache(const reference_counted_ptr<PathGeometryCache> &v)
+{
+  PathPrivate *d;
+  d = static_cast<PathPrivate*>(m_d);
+  d->m_geometry_cache = v;
+  return *this;
+}
 
-      if(assigned_value)
-        {
-          d->m_min_bb.x() = fastuidraw::t_min(d->m_min_bb.x(), p0.x());
-          d->m_min_bb.y() = fastuidraw::t_min(d->m_min_bb.y(), p0.y());
+const fastuidraw::reference_counted_ptr<fastuidraw::PathGeometryCache>&
+fastuidraw::Path::
+geometry_cache(void) const
+{
+  PathPrivate *d;
+  d = static_cast<PathPrivate*>(m_d);
+  return d->m_geometry_cache;
+}
 
-          d->m_max_bb.x() = fastuidraw::t_max(d->m_max_bb.x(), p1.x());
-          d->m_max_bb.y() = fastuidraw::t_max(d->m_max_bb.y(), p1.y());
-        }
-      else
-        {
-          d->m_min_bb = p0;
-          d->m_max_bb = p1;
-          assigned_value = true;
-        }
-    }
+//////////////////////////////////////////
+// fastuidraw::PathGeometryCache methods
+fastuidraw::PathGeometryCache::
+PathGeometryCache(void)
+{
+  m_d = FASTUIDRAWnew PathGeometryCachePrivate();
+}
+
+fastuidraw::PathGeometryCache::
+~PathGeometryCache()
+{
+  PathGeometryCachePrivate *d;
+  d = static_cast<PathGeometryCachePrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+void
+fastuidraw::PathGeometryCache::
+clear(void)
+{
+  PathGeometryCachePrivate *d;
+  d = static_cast<PathGeometryCachePrivate*>(m_d);
+  d->m_entries.clear();
+}
+
+unsigned int
+fastuidraw::PathGeometryCache::
+number_entries(void) const
+{
+  PathGeometryCachePrivate *d;
+  d = static_cast<PathGeometryCachePrivate*>(m_d);
+  return d->m_entries.size();
+}
+
+unsigned int
+fastuidraw::PathGeometryCache::
+number_hits(void) const
+{
+  PathGeometryCachePrivate *d;
+  d = static_cast<PathGeometryCachePrivate*>(m_d);
+  return d->m_number_hits;
+}
+
+bool
+fastuidraw::Path::
+approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const
+{
+  PathPrivate *d;
+  d = static_cast<PathPrivate*>(m_d);
 
-  if(assigned_value)
+  if(d->update_bounding_boxes())
     {
       *out_min_bb = d->m_min_bb;
       *out_max_bb = d->m_max_bb;
@@ -1769,6 +3486,25 @@ approximate_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const
     }
 }
 
+bool
+fastuidraw::Path::
+tight_bounding_box(vec2 *out_min_bb, vec2 *out_max_bb) const
+{
+  PathPrivate *d;
+  d = static_cast<PathPrivate*>(m_d);
+
+  if(d->update_bounding_boxes())
+    {
+      *out_min_bb = d->m_tight_min_bb;
+      *out_max_bb = d->m_tight_max_bb;
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
 fastuidraw::Path&
 fastuidraw::Path::
 operator<<(const control_point &pt)
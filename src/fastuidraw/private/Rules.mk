@@ -4,7 +4,8 @@ dirstack_$(sp)	:= $(d)
 d		:= $(dir)
 # End standard header
 
-LIBRARY_PRIVATE_SOURCES += $(call filelist, interval_allocator.cpp path_util_private.cpp clip.cpp)
+LIBRARY_PRIVATE_SOURCES += $(call filelist, interval_allocator.cpp path_util_private.cpp clip.cpp \
+	sweep_triangulator.cpp culling_boxes.cpp)
 
 # Begin standard footer
 d		:= $(dirstack_$(sp))
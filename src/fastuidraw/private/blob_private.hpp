@@ -0,0 +1,400 @@
+/*!
+ * \file blob_private.hpp
+ * \brief file blob_private.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <vector>
+#include <cstring>
+#include <assert.h>
+#include <stdint.h>
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include "bounding_box.hpp"
+
+namespace fastuidraw
+{
+  class PainterAttributeData;
+
+  namespace detail
+  {
+    /* A blob is a sequence of 32-bit words stored
+       little-endian; floats are stored as the bits
+       of their IEEE-754 representation.
+     */
+    inline
+    bool
+    host_is_little_endian(void)
+    {
+      uint32_t one(1u);
+      uint8_t first;
+
+      std::memcpy(&first, &one, 1);
+      return first == 1u;
+    }
+
+    inline
+    uint32_t
+    swap_bytes(uint32_t v)
+    {
+      return (v >> 24u) | ((v >> 8u) & 0xFF00u)
+        | ((v << 8u) & 0xFF0000u) | (v << 24u);
+    }
+
+    /* Accumulates the words of a blob.
+     */
+    class BlobWriter:noncopyable
+    {
+    public:
+      void
+      write_u32(uint32_t v)
+      {
+        m_words.push_back(v);
+      }
+
+      void
+      write_i32(int32_t v)
+      {
+        uint32_t u;
+        std::memcpy(&u, &v, sizeof(u));
+        write_u32(u);
+      }
+
+      void
+      write_float(float v)
+      {
+        uint32_t u;
+        std::memcpy(&u, &v, sizeof(u));
+        write_u32(u);
+      }
+
+      void
+      write_vec2(const vec2 &v)
+      {
+        write_float(v.x());
+        write_float(v.y());
+      }
+
+      void
+      write_bool(bool v)
+      {
+        write_u32(v ? 1u : 0u);
+      }
+
+      /* write the contents of an array of POD
+         values whose size is a multiple of 4 bytes;
+         the number of elements is NOT written.
+       */
+      template<typename T>
+      void
+      write_pod_array(const_c_array<T> v)
+      {
+        unsigned int num_words, start;
+
+        assert(sizeof(T) % sizeof(uint32_t) == 0);
+        num_words = v.size() * sizeof(T) / sizeof(uint32_t);
+        start = m_words.size();
+        m_words.resize(start + num_words);
+        if(num_words > 0)
+          {
+            std::memcpy(&m_words[start], v.c_ptr(), num_words * sizeof(uint32_t));
+          }
+      }
+
+      /* write an array of values of at most 16 bits packed
+         into words, lowest bits first; the number of elements
+         is NOT written.
+       */
+      template<typename T>
+      void
+      write_packed_array(const_c_array<T> v)
+      {
+        const unsigned int per_word(sizeof(uint32_t) / sizeof(T));
+
+        assert(sizeof(T) == 1 || sizeof(T) == 2);
+        for(unsigned int i = 0, endi = v.size(); i < endi; i += per_word)
+          {
+            uint32_t w(0u);
+            for(unsigned int k = 0; k < per_word && i + k < endi; ++k)
+              {
+                w |= static_cast<uint32_t>(v[i + k]) << (8u * sizeof(T) * k);
+              }
+            write_u32(w);
+          }
+      }
+
+      void
+      write_bounding_box(const BoundingBox &box)
+      {
+        write_bool(box.empty());
+        write_vec2(box.empty() ? vec2(0.0f, 0.0f) : box.min_point());
+        write_vec2(box.empty() ? vec2(0.0f, 0.0f) : box.max_point());
+      }
+
+      /* append the words written to another BlobWriter
+       */
+      void
+      append(const BlobWriter &src)
+      {
+        m_words.insert(m_words.end(), src.m_words.begin(), src.m_words.end());
+      }
+
+      /* the words written so far, in host order
+       */
+      const std::vector<uint32_t>&
+      words(void) const
+      {
+        return m_words;
+      }
+
+      void
+      clear(void)
+      {
+        m_words.clear();
+      }
+
+      /* write the words to bytes, converting to
+         little-endian if necessary.
+       */
+      void
+      finish(std::vector<uint8_t> &dst) const
+      {
+        bool swap(!host_is_little_endian());
+
+        dst.resize(m_words.size() * sizeof(uint32_t));
+        for(unsigned int i = 0, endi = m_words.size(); i < endi; ++i)
+          {
+            uint32_t v(m_words[i]);
+            if(swap)
+              {
+                v = swap_bytes(v);
+              }
+            std::memcpy(&dst[i * sizeof(uint32_t)], &v, sizeof(uint32_t));
+          }
+      }
+
+    private:
+      std::vector<uint32_t> m_words;
+    };
+
+    /* Reads the words of a blob; once a read goes past
+       the end of the blob or a caller has flagged the
+       blob as malformed with fail(), all reads return
+       zero and failed() returns true.
+     */
+    class BlobReader:noncopyable
+    {
+    public:
+      /* view the bytes of a blob as words; when the host is
+         little-endian and the bytes are 4-byte aligned,
+         the words are the bytes themselves, otherwise they
+         are copied to backing.
+       */
+      BlobReader(const_c_array<uint8_t> blob, std::vector<uint32_t> &backing):
+        m_location(0),
+        m_failed(false)
+      {
+        unsigned int num_words(blob.size() / sizeof(uint32_t));
+        if(host_is_little_endian()
+           && (reinterpret_cast<uintptr_t>(blob.c_ptr()) % sizeof(uint32_t)) == 0)
+          {
+            m_words = const_c_array<uint32_t>(reinterpret_cast<const uint32_t*>(blob.c_ptr()),
+                                              num_words);
+          }
+        else
+          {
+            bool swap(!host_is_little_endian());
+
+            backing.resize(num_words);
+            for(unsigned int i = 0; i < num_words; ++i)
+              {
+                std::memcpy(&backing[i], &blob[i * sizeof(uint32_t)], sizeof(uint32_t));
+                if(swap)
+                  {
+                    backing[i] = swap_bytes(backing[i]);
+                  }
+              }
+            if(num_words > 0)
+              {
+                m_words = const_c_array<uint32_t>(&backing[0], num_words);
+              }
+          }
+      }
+
+      /* view words that are already in host order
+       */
+      explicit
+      BlobReader(const_c_array<uint32_t> words):
+        m_words(words),
+        m_location(0),
+        m_failed(false)
+      {}
+
+      bool
+      failed(void) const
+      {
+        return m_failed;
+      }
+
+      void
+      fail(void)
+      {
+        m_failed = true;
+      }
+
+      uint32_t
+      read_u32(void)
+      {
+        if(m_failed || m_location >= m_words.size())
+          {
+            m_failed = true;
+            return 0u;
+          }
+        return m_words[m_location++];
+      }
+
+      int32_t
+      read_i32(void)
+      {
+        uint32_t u(read_u32());
+        int32_t v;
+        std::memcpy(&v, &u, sizeof(v));
+        return v;
+      }
+
+      float
+      read_float(void)
+      {
+        uint32_t u(read_u32());
+        float v;
+        std::memcpy(&v, &u, sizeof(v));
+        return v;
+      }
+
+      vec2
+      read_vec2(void)
+      {
+        vec2 v;
+        v.x() = read_float();
+        v.y() = read_float();
+        return v;
+      }
+
+      bool
+      read_bool(void)
+      {
+        return read_u32() != 0u;
+      }
+
+      /* returns a view into the blob of count elements
+         written with BlobWriter::write_pod_array().
+       */
+      template<typename T>
+      const_c_array<T>
+      read_pod_array(unsigned int count)
+      {
+        unsigned int num_words;
+
+        assert(sizeof(T) % sizeof(uint32_t) == 0);
+        num_words = sizeof(T) / sizeof(uint32_t);
+        if(m_failed || count > (m_words.size() - m_location) / num_words)
+          {
+            m_failed = true;
+            return const_c_array<T>();
+          }
+
+        num_words *= count;
+        if(num_words == 0)
+          {
+            return const_c_array<T>();
+          }
+
+        const_c_array<T> return_value(reinterpret_cast<const T*>(&m_words[m_location]), count);
+        m_location += num_words;
+        return return_value;
+      }
+
+      /* read count elements written with
+         BlobWriter::write_packed_array() to dst.
+       */
+      template<typename T>
+      void
+      read_packed_array(c_array<T> dst)
+      {
+        const unsigned int per_word(sizeof(uint32_t) / sizeof(T));
+        const uint32_t mask((sizeof(T) == 1) ? 0xFFu : 0xFFFFu);
+
+        assert(sizeof(T) == 1 || sizeof(T) == 2);
+        if(m_failed || (dst.size() + per_word - 1) / per_word > m_words.size() - m_location)
+          {
+            m_failed = true;
+            return;
+          }
+
+        for(unsigned int i = 0, endi = dst.size(); i < endi; i += per_word)
+          {
+            uint32_t w(read_u32());
+            for(unsigned int k = 0; k < per_word && i + k < endi; ++k)
+              {
+                dst[i + k] = static_cast<T>((w >> (8u * sizeof(T) * k)) & mask);
+              }
+          }
+      }
+
+      BoundingBox
+      read_bounding_box(void)
+      {
+        bool empty;
+        vec2 pmin, pmax;
+
+        empty = read_bool();
+        pmin = read_vec2();
+        pmax = read_vec2();
+        if(empty)
+          {
+            return BoundingBox();
+          }
+        if(!(pmin.x() <= pmax.x() && pmin.y() <= pmax.y()))
+          {
+            m_failed = true;
+            return BoundingBox();
+          }
+        return BoundingBox(pmin, pmax);
+      }
+
+    private:
+      const_c_array<uint32_t> m_words;
+      unsigned int m_location;
+      bool m_failed;
+    };
+
+    /* write the contents of a PainterAttributeData to a blob.
+     */
+    void
+    write_painter_attribute_data(BlobWriter &dst, const PainterAttributeData &data);
+
+    /* set the contents of a PainterAttributeData from a blob;
+       the chunks of dst point into the words of src, so those
+       words must stay alive as long as dst uses them.
+       Returns false if the blob is malformed.
+     */
+    bool
+    read_painter_attribute_data(BlobReader &src, PainterAttributeData &dst);
+  }
+}
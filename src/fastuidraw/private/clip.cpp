@@ -19,6 +19,26 @@
 #include "clip.hpp"
 #include "util_private.hpp"
 
+namespace
+{
+  /* the loop has no branches so that a compiler can
+     vectorize it across the points.
+   */
+  unsigned int
+  number_points_inside(const fastuidraw::vec3 &clip_eq,
+                       fastuidraw::const_c_array<fastuidraw::vec2> pts)
+  {
+    unsigned int return_value(0);
+    for(unsigned int i = 0, endi = pts.size(); i < endi; ++i)
+      {
+        float d;
+        d = clip_eq.x() * pts[i].x() + clip_eq.y() * pts[i].y() + clip_eq.z();
+        return_value += (d >= 0.0f) ? 1u : 0u;
+      }
+    return return_value;
+  }
+}
+
 bool
 fastuidraw::detail::
 clip_against_plane(const vec3 &clip_eq, const_c_array<vec2> pts,
@@ -167,19 +187,63 @@ clip_against_planes(const_c_array<vec3> clip_eq, const_c_array<vec2> in_pts,
                     vecN<std::vector<vec2>, 2> &scratch_space_vec2s)
 {
   unsigned int src(0), dst(1), i;
-  bool return_value(true);
+  bool any_plane_cuts(false);
+  const_c_array<vec2> current(in_pts);
 
-  scratch_space_vec2s[src].resize(in_pts.size());
-  std::copy(in_pts.begin(), in_pts.end(), scratch_space_vec2s[src].begin());
+  if(in_pts.empty())
+    {
+      out_pts.resize(0);
+      return clip_eq.empty();
+    }
 
-  for(i = 0; i < clip_eq.size(); ++i, std::swap(src, dst))
+  /* classify the input points against all planes first; the
+     common cases of completely unclipped and of completely
+     culled are then handled without clipping at all.
+   */
+  for(i = 0; i < clip_eq.size(); ++i)
     {
-      bool r;
-      r = clip_against_plane(clip_eq[i], make_c_array(scratch_space_vec2s[src]),
-                             scratch_space_vec2s[dst],
-                             scratch_space_floats);
-      return_value = return_value && r;
+      unsigned int num_inside;
+
+      num_inside = number_points_inside(clip_eq[i], in_pts);
+      if(num_inside == 0)
+        {
+          out_pts.resize(0);
+          return false;
+        }
+      any_plane_cuts = any_plane_cuts || num_inside != in_pts.size();
+    }
+
+  if(!any_plane_cuts)
+    {
+      out_pts.resize(in_pts.size());
+      std::copy(in_pts.begin(), in_pts.end(), out_pts.begin());
+      return true;
+    }
+
+  /* A plane against which all points of the input polygon are
+     inside is also a plane against which all of the points of
+     the polygon clipped against the other planes are inside,
+     because those points are on the edges of the input polygon;
+     thus clipping is only performed against the planes that
+     cut the input polygon, reading the input directly instead
+     of copying it first.
+   */
+  for(i = 0; i < clip_eq.size(); ++i)
+    {
+      if(number_points_inside(clip_eq[i], in_pts) == in_pts.size())
+        {
+          continue;
+        }
+
+      clip_against_plane(clip_eq[i], current, scratch_space_vec2s[dst],
+                         scratch_space_floats);
+      current = make_c_array(scratch_space_vec2s[dst]);
+      std::swap(src, dst);
+      if(current.empty())
+        {
+          break;
+        }
     }
   std::swap(out_pts, scratch_space_vec2s[src]);
-  return return_value;
+  return false;
 }
@@ -39,7 +39,10 @@ namespace fastuidraw
     /* Clip a polygon against several planes. The clip equations
        clip_eq and the polygon pts are both in the same coordinate
        system (likely local). Returns true if the polygon is
-       completely unclipped.
+       completely unclipped. The points are first classified
+       against all planes so that unclipped and culled polygons
+       are handled without clipping and only the planes that
+       cut the polygon are clipped against.
      */
     bool
     clip_against_planes(const_c_array<vec3> clip_eq, const_c_array<vec2> in_pts,
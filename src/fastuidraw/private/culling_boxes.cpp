@@ -0,0 +1,123 @@
+/*!
+ * \file culling_boxes.cpp
+ * \brief file culling_boxes.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include "culling_boxes.hpp"
+#include "clip.hpp"
+#include "util_private.hpp"
+
+void
+fastuidraw::detail::CullingBoxes::
+pad(unsigned int sz)
+{
+  unsigned int padded_sz;
+
+  /* an empty box has min > max so that classify_block()
+     finds it culled by any clip equation.
+   */
+  padded_sz = block_size * ((sz + block_size - 1) / block_size);
+  m_min_x.clear();
+  m_min_y.clear();
+  m_max_x.clear();
+  m_max_y.clear();
+  m_min_x.resize(padded_sz, 1.0f);
+  m_min_y.resize(padded_sz, 1.0f);
+  m_max_x.resize(padded_sz, -1.0f);
+  m_max_y.resize(padded_sz, -1.0f);
+}
+
+void
+fastuidraw::detail::CullingBoxes::
+set(unsigned int i, const BoundingBox &bb)
+{
+  if(!bb.empty())
+    {
+      m_min_x[i] = bb.min_point().x();
+      m_min_y[i] = bb.min_point().y();
+      m_max_x[i] = bb.max_point().x();
+      m_max_y[i] = bb.max_point().y();
+    }
+}
+
+void
+fastuidraw::detail::CullingBoxes::
+classify_block(const_c_array<vec3> clip_eqs, float room,
+               unsigned int start,
+               vecN<enum classification_t, block_size> &out) const
+{
+  vecN<bool, block_size> culled(false), unclipped(true);
+
+  assert(start % block_size == 0);
+  assert(start + block_size <= m_min_x.size());
+  for(unsigned int e = 0; e < clip_eqs.size(); ++e)
+    {
+      const vec3 &eq(clip_eqs[e]);
+      const float *near_x, *near_y, *far_x, *far_y;
+      float eq_room;
+
+      /* the corner farthest along the normal of the clip
+         equation has the largest value and the nearest
+         has the smallest; inflating the box by R moves
+         those values by R * (|eq.x| + |eq.y|).
+       */
+      near_x = (eq.x() >= 0.0f) ? &m_min_x[start] : &m_max_x[start];
+      far_x = (eq.x() >= 0.0f) ? &m_max_x[start] : &m_min_x[start];
+      near_y = (eq.y() >= 0.0f) ? &m_min_y[start] : &m_max_y[start];
+      far_y = (eq.y() >= 0.0f) ? &m_max_y[start] : &m_min_y[start];
+      eq_room = room * (t_abs(eq.x()) + t_abs(eq.y()));
+
+      for(unsigned int k = 0; k < block_size; ++k)
+        {
+          float far_value, near_value;
+
+          far_value = eq.x() * far_x[k] + eq.y() * far_y[k] + eq.z() + eq_room;
+          near_value = eq.x() * near_x[k] + eq.y() * near_y[k] + eq.z() - eq_room;
+          culled[k] = culled[k] || far_value < 0.0f;
+          unclipped[k] = unclipped[k] && near_value >= 0.0f;
+        }
+    }
+
+  for(unsigned int k = 0; k < block_size; ++k)
+    {
+      bool empty;
+
+      empty = m_min_x[start + k] > m_max_x[start + k];
+      out[k] = (culled[k] || empty) ? is_culled :
+        (unclipped[k] ? is_unclipped : is_partially_clipped);
+    }
+}
+
+enum fastuidraw::detail::CullingBoxes::classification_t
+fastuidraw::detail::CullingBoxes::
+clip(const_c_array<vec3> clip_eqs, float room, unsigned int i,
+     std::vector<vec2> &clipped_rect,
+     std::vector<float> &scratch_space_floats,
+     vecN<std::vector<vec2>, 2> &scratch_space_vec2s) const
+{
+  vecN<vec2, 4> bb;
+  bool unclipped;
+
+  bb[0] = vec2(m_min_x[i] - room, m_min_y[i] - room);
+  bb[1] = vec2(m_max_x[i] + room, m_min_y[i] - room);
+  bb[2] = vec2(m_max_x[i] + room, m_max_y[i] + room);
+  bb[3] = vec2(m_min_x[i] - room, m_max_y[i] + room);
+  unclipped = clip_against_planes(clip_eqs, bb, clipped_rect,
+                                  scratch_space_floats,
+                                  scratch_space_vec2s);
+  return clipped_rect.empty() ? is_culled :
+    (unclipped ? is_unclipped : is_partially_clipped);
+}
@@ -0,0 +1,86 @@
+/*!
+ * \file culling_boxes.hpp
+ * \brief file culling_boxes.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <vector>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include "bounding_box.hpp"
+
+namespace fastuidraw
+{
+  namespace detail
+  {
+    /* CullingBoxes holds a list of bounding boxes as separate
+       arrays of the coordinates so that they can be classified
+       against clip equations block_size boxes at a time. The
+       test of a box against a clip equation only looks at the
+       box corners nearest and farthest along the equation's
+       normal; only a box that crosses a clip equation needs to
+       be clipped exactly with clip().
+     */
+    class CullingBoxes
+    {
+    public:
+      enum
+        {
+          block_size = 4
+        };
+
+      enum classification_t
+        {
+          is_culled,
+          is_unclipped,
+          is_partially_clipped,
+        };
+
+      /* resize to hold sz boxes, the arrays are padded to
+         a multiple of block_size; all boxes are set to empty
+         boxes (m_min > m_max) which are always culled.
+       */
+      void
+      pad(unsigned int sz);
+
+      /* set the box i, an empty bb leaves the box empty.
+       */
+      void
+      set(unsigned int i, const BoundingBox &bb);
+
+      /* classify the block_size boxes starting at start,
+         which must be a multiple of block_size, against
+         clip_eqs with each box inflated by room.
+       */
+      void
+      classify_block(const_c_array<vec3> clip_eqs, float room,
+                     unsigned int start,
+                     vecN<enum classification_t, block_size> &out) const;
+
+      /* exactly clip the box i inflated by room against clip_eqs.
+       */
+      enum classification_t
+      clip(const_c_array<vec3> clip_eqs, float room, unsigned int i,
+           std::vector<vec2> &clipped_rect,
+           std::vector<float> &scratch_space_floats,
+           vecN<std::vector<vec2>, 2> &scratch_space_vec2s) const;
+
+      std::vector<float> m_min_x, m_min_y, m_max_x, m_max_y;
+    };
+  }
+}
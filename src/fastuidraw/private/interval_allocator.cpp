@@ -19,14 +19,70 @@
 
 #include <assert.h>
 #include "interval_allocator.hpp"
+#include "memory_report_private.hpp"
 
+namespace
+{
+  inline
+  int
+  lowest_set_bit(uint32_t v)
+  {
+    assert(v != 0);
+    #if defined(__GNUC__)
+      {
+        return __builtin_ctz(v);
+      }
+    #else
+      {
+        int return_value(0);
+        for(; (v & 1u) == 0; v >>= 1u, ++return_value)
+          {}
+        return return_value;
+      }
+    #endif
+  }
+
+  inline
+  int
+  highest_set_bit(uint32_t v)
+  {
+    assert(v != 0);
+    #if defined(__GNUC__)
+      {
+        return 31 - __builtin_clz(v);
+      }
+    #else
+      {
+        int return_value(-1);
+        for(; v != 0; v >>= 1u, ++return_value)
+          {}
+        return return_value;
+      }
+    #endif
+  }
+}
 
 fastuidraw::interval_allocator::
-interval_allocator(int size)
+interval_allocator(int size):
+  m_report_subsystem(memory::number_subsystems),
+  m_report_bytes_per_unit(0),
+  m_reported_free_bytes(0),
+  m_reported_largest_free_bytes(0)
 {
   reset(size);
 }
 
+fastuidraw::interval_allocator::
+~interval_allocator()
+{
+  if(m_report_bytes_per_unit != 0)
+    {
+      detail::memory_report_free_space(m_report_subsystem,
+                                       m_reported_free_bytes, m_reported_largest_free_bytes,
+                                       0, 0);
+    }
+}
+
 void
 fastuidraw::interval_allocator::
 reset(int size)
@@ -34,12 +90,23 @@ reset(int size)
   assert(size >= 0);
 
   m_size = std::max(0, size);
-  m_sorted.clear();
-  m_free_intervals.clear();
+  m_total_free = 0;
+  m_nodes.clear();
+  m_unused_nodes.clear();
+  m_boundary.assign(m_size + 1, -1);
+  m_bin_heads = vecN<int, number_bins>(-1);
+  m_non_empty_second_level = vecN<uint32_t, number_first_level_bins>(0u);
+  m_non_empty_first_level = 0u;
+  m_largest_free_interval = 0;
+  m_largest_free_interval_dirty = false;
   if(m_size > 0)
     {
       free_interval(0, m_size);
     }
+  else
+    {
+      update_report();
+    }
 }
 
 void
@@ -51,236 +118,412 @@ resize(int size)
     {
       int old_size(m_size);
       m_size = size;
+      m_boundary.resize(m_size + 1, -1);
       free_interval(old_size, size - old_size);
     }
 }
 
-
-fastuidraw::interval_allocator::interval_status_t
+void
 fastuidraw::interval_allocator::
-interval_status(int begin, int size) const
+report_free_space(enum memory::subsystem_t subsystem,
+                  unsigned int bytes_per_unit)
 {
-  assert(begin >= 0);
-  assert(size > 0);
-
-  int end(begin + size);
-  assert(end <= m_size);
-
-  std::map<int, interval>::const_iterator begin_iter;
-
-  /* begin_iter points to the first free interval I
-     for which I.m_end >= begin
-   */
-  begin_iter = m_free_intervals.upper_bound(begin);
+  assert(m_report_bytes_per_unit == 0);
+  m_report_subsystem = subsystem;
+  m_report_bytes_per_unit = bytes_per_unit;
+  update_report();
+}
 
-  if(begin_iter == m_free_intervals.end())
+void
+fastuidraw::interval_allocator::
+update_report(void)
+{
+  if(m_report_bytes_per_unit == 0)
     {
-      /* All free intervals end at or before begin,
-         thus the interval is completely allocated
-       */
-      return completely_allocated;
+      return;
     }
 
-  interval I(begin_iter->second);
-  assert(I.m_end > begin);
+  uint64_t free_bytes, largest_free_bytes;
 
-  if(I.m_end >= end && I.m_begin <= begin)
+  free_bytes = uint64_t(m_total_free) * uint64_t(m_report_bytes_per_unit);
+  largest_free_bytes = uint64_t(largest_free_interval()) * uint64_t(m_report_bytes_per_unit);
+  if(free_bytes != m_reported_free_bytes
+     || largest_free_bytes != m_reported_largest_free_bytes)
     {
-      /* the free Interval I completely contains
-         the interval [begin, end)
-       */
-      return completely_free;
+      detail::memory_report_free_space(m_report_subsystem,
+                                       m_reported_free_bytes, m_reported_largest_free_bytes,
+                                       free_bytes, largest_free_bytes);
+      m_reported_free_bytes = free_bytes;
+      m_reported_largest_free_bytes = largest_free_bytes;
     }
+}
 
-  if(I.m_begin > begin)
+float
+fastuidraw::interval_allocator::
+fragmentation(void) const
+{
+  if(m_total_free == 0)
     {
-      /* the queried interval begins before I.
-         Note that the free interval previous
-         to I (call it J) has that J.m_end < begin,
-         i.e. J ends before begin, and the range
-         [J.m_end, I.m_begin) is completely
-         allocated.
-       */
-      if(end <= I.m_begin)
-        {
-          /* end is before I even starts, thus
-             [begin, end) is completely allocated
-           */
-          return completely_allocated;
-        }
-      else
-        {
-          return partially_allocated;
-        }
+      return 0.0f;
     }
+  return 1.0f - static_cast<float>(largest_free_interval()) / static_cast<float>(m_total_free);
+}
 
-  assert(I.m_end < end);
-  return partially_allocated;
+void
+fastuidraw::interval_allocator::
+bins_of_size(uint32_t size, int *first_level, int *second_level)
+{
+  int F;
 
+  assert(size > 0);
+  F = highest_set_bit(size);
+  *first_level = F;
+
+  /* the second level is given by the log2_number_second_level_bins
+     bits following the highest bit; sizes below number_second_level_bins
+     are shifted up, so those bins hold exactly one size.
+   */
+  if(F >= log2_number_second_level_bins)
+    {
+      *second_level = (size >> (F - log2_number_second_level_bins)) & (number_second_level_bins - 1);
+    }
+  else
+    {
+      *second_level = (size << (log2_number_second_level_bins - F)) & (number_second_level_bins - 1);
+    }
 }
 
 int
 fastuidraw::interval_allocator::
-allocate_interval(int size)
+create_node(int begin, int end)
 {
-  if(size <= 0)
+  int node;
+
+  if(m_unused_nodes.empty())
     {
-      return -1;
+      node = m_nodes.size();
+      m_nodes.push_back(free_node());
+    }
+  else
+    {
+      node = m_unused_nodes.back();
+      m_unused_nodes.pop_back();
     }
 
-  std::map<int, interval_ref_set>::iterator iter;
+  m_nodes[node].m_interval = interval(begin, end);
+  assert(m_boundary[begin] == -1);
+  assert(m_boundary[end] == -1);
+  m_boundary[begin] = node;
+  m_boundary[end] = node;
+  link_to_bin(node);
+  note_size_increase(end - begin);
+  return node;
+}
 
-  iter = m_sorted.lower_bound(size);
-  if(iter == m_sorted.end())
+void
+fastuidraw::interval_allocator::
+destroy_node(int node)
+{
+  const interval &I(m_nodes[node].m_interval);
+
+  assert(m_boundary[I.m_begin] == node);
+  assert(m_boundary[I.m_end] == node);
+  m_boundary[I.m_begin] = -1;
+  m_boundary[I.m_end] = -1;
+  unlink_from_bin(node);
+  note_size_decrease(I.m_end - I.m_begin);
+  m_unused_nodes.push_back(node);
+}
+
+void
+fastuidraw::interval_allocator::
+set_interval(int node, int begin, int end)
+{
+  interval &I(m_nodes[node].m_interval);
+
+  if(m_boundary[I.m_begin] == node)
     {
-      return -1;
+      m_boundary[I.m_begin] = -1;
+    }
+  if(m_boundary[I.m_end] == node)
+    {
+      m_boundary[I.m_end] = -1;
     }
 
-  interval_ref interval_reference(*iter->second.begin());
-  interval I(interval_reference->second);
-  interval return_value(I.m_begin, I.m_begin + size);
-
-  assert(interval_reference->second.m_end == interval_reference->first);
-  assert(I.m_end - I.m_begin == iter->first);
+  unlink_from_bin(node);
+  I = interval(begin, end);
+  m_boundary[begin] = node;
+  m_boundary[end] = node;
+  link_to_bin(node);
+}
 
-  iter->second.erase(iter->second.begin());
-  if(iter->second.empty())
+void
+fastuidraw::interval_allocator::
+link_to_bin(int node)
+{
+  free_node &N(m_nodes[node]);
+  int F, S;
+
+  bins_of_size(N.m_interval.m_end - N.m_interval.m_begin, &F, &S);
+  N.m_bin = F * number_second_level_bins + S;
+  N.m_prev = -1;
+  N.m_next = m_bin_heads[N.m_bin];
+  if(N.m_next != -1)
     {
-      m_sorted.erase(iter);
+      m_nodes[N.m_next].m_prev = node;
     }
+  m_bin_heads[N.m_bin] = node;
+  m_non_empty_second_level[F] |= (1u << S);
+  m_non_empty_first_level |= (1u << F);
+}
 
-  /* Now take away the room from the interval
-     pointed to by interval_reference that
-     we used in the allocation. We can do
-     this because the map is keyed by
-     m_end of interval.
-   */
-  interval_reference->second.m_begin += size;
+void
+fastuidraw::interval_allocator::
+unlink_from_bin(int node)
+{
+  free_node &N(m_nodes[node]);
 
-  assert(interval_reference->second.m_begin <= interval_reference->second.m_end);
-  if(interval_reference->second.m_begin == interval_reference->second.m_end)
+  if(N.m_prev != -1)
     {
-      /* if the new interval is empty, then we delete it
-      */
-      m_free_intervals.erase(interval_reference);
+      m_nodes[N.m_prev].m_next = N.m_next;
     }
   else
     {
-      /* is not empty, we need to add it to m_sorted
-       */
-      int sz(interval_reference->second.m_end - interval_reference->second.m_begin);
-      m_sorted[sz].insert(interval_reference);
+      assert(m_bin_heads[N.m_bin] == node);
+      m_bin_heads[N.m_bin] = N.m_next;
+      if(N.m_next == -1)
+        {
+          int F(N.m_bin / number_second_level_bins);
+          int S(N.m_bin % number_second_level_bins);
+
+          m_non_empty_second_level[F] &= ~(1u << S);
+          if(m_non_empty_second_level[F] == 0u)
+            {
+              m_non_empty_first_level &= ~(1u << F);
+            }
+        }
     }
 
-  return return_value.m_begin;
+  if(N.m_next != -1)
+    {
+      m_nodes[N.m_next].m_prev = N.m_prev;
+    }
+  N.m_prev = N.m_next = -1;
 }
 
+void
+fastuidraw::interval_allocator::
+note_size_decrease(int old_size)
+{
+  if(!m_largest_free_interval_dirty && old_size == m_largest_free_interval)
+    {
+      m_largest_free_interval_dirty = true;
+    }
+}
 
 void
 fastuidraw::interval_allocator::
-free_interval(int location, int size)
+note_size_increase(int new_size)
 {
-  assert(size > 0);
-  assert(interval_status(location, size) == completely_allocated);
+  if(!m_largest_free_interval_dirty)
+    {
+      m_largest_free_interval = std::max(m_largest_free_interval, new_size);
+    }
+}
 
-  int end(location + size);
+void
+fastuidraw::interval_allocator::
+compute_largest_free_interval(void) const
+{
+  int F, S;
 
-  /* see if location corresponds to m_end
-     of an existing free block.
-   */
-  interval_ref iter;
-  iter = m_free_intervals.find(location);
-  if(iter != m_free_intervals.end())
-    {
-      /* in this case we need to enlarge
-         the block pointed to by iter,
-         however that means we need to
-         remove it since we are changing
-         m_end to end;
-       */
-      location = iter->second.m_begin;
-      size = end - location;
-      remove_free_interval(iter);
-    }
-
-  iter = m_free_intervals.lower_bound(end);
-  if(iter != m_free_intervals.end() && iter->second.m_begin == end)
-    {
-      /* end is the start of an existing block,
-         so just make that existing block bigger.
-         First, remove it from m_sorted.
-      */
-      remove_free_interval_from_sorted_only(iter);
-
-      /* Second, make it bigger and add it to m_sorted
-       */
-      iter->second.m_begin = location;
-      m_sorted[iter->second.m_end - iter->second.m_begin].insert(iter);
+  m_largest_free_interval = 0;
+  m_largest_free_interval_dirty = false;
+  if(m_non_empty_first_level == 0u)
+    {
       return;
     }
 
-  /* the element to add has that its end is not
-     the start of an existing free interval and
-     that its beginning is not the end of an
-     existing one either, so just add it:
-   */
-  interval I(location, end);
-  std::pair<interval_ref, bool> R;
-
-  R = m_free_intervals.insert( std::pair<int, interval>(end, I));
-  assert(R.second);
-  m_sorted[size].insert(R.first);
+  F = highest_set_bit(m_non_empty_first_level);
+  S = highest_set_bit(m_non_empty_second_level[F]);
+  for(int node = m_bin_heads[F * number_second_level_bins + S];
+      node != -1; node = m_nodes[node].m_next)
+    {
+      const interval &I(m_nodes[node].m_interval);
+      m_largest_free_interval = std::max(m_largest_free_interval,
+                                         I.m_end - I.m_begin);
+    }
 }
 
-void
+fastuidraw::interval_allocator::interval_status_t
 fastuidraw::interval_allocator::
-remove_free_interval(interval_ref iter)
+interval_status(int begin, int size) const
 {
-  int sz(iter->second.m_end - iter->second.m_begin);
-  std::map<int, interval_ref_set>::iterator sorted_iter;
+  assert(begin >= 0);
+  assert(size > 0);
 
-  sorted_iter = m_sorted.find(sz);
-  assert(sorted_iter != m_sorted.end());
+  int end(begin + size);
+  assert(end <= m_size);
+
+  for(int bin = 0; bin < number_bins; ++bin)
+    {
+      for(int node = m_bin_heads[bin]; node != -1; node = m_nodes[node].m_next)
+        {
+          const interval &I(m_nodes[node].m_interval);
 
-  remove_free_interval(sorted_iter, iter);
+          if(I.m_begin <= begin && I.m_end >= end)
+            {
+              return completely_free;
+            }
+
+          if(I.m_begin < end && I.m_end > begin)
+            {
+              return partially_allocated;
+            }
+        }
+    }
+  return completely_allocated;
 }
 
-void
+int
 fastuidraw::interval_allocator::
-remove_free_interval(std::map<int, interval_ref_set>::iterator sorted_iter,
-                     interval_ref iter)
+find_fitting_node(int size) const
 {
-  /* we need to remove iter from m_sorted
-     and m_free_intervals
+  uint32_t rounded_size(size);
+  int F, S;
+
+  /* round the size up to the start of the next second level
+     bin (unless it already is the start of one), every interval
+     in that bin or a bin after it is then large enough.
    */
-  remove_free_interval_from_sorted_only(sorted_iter, iter);
-  m_free_intervals.erase(iter);
+  F = highest_set_bit(rounded_size);
+  if(F >= log2_number_second_level_bins)
+    {
+      rounded_size += (1u << (F - log2_number_second_level_bins)) - 1u;
+    }
+
+  bins_of_size(rounded_size, &F, &S);
+  if(F < number_first_level_bins)
+    {
+      uint32_t fitting;
+
+      fitting = m_non_empty_second_level[F] & (~0u << S);
+      if(fitting == 0u && F + 1 < number_first_level_bins)
+        {
+          fitting = m_non_empty_first_level & (~0u << (F + 1));
+          if(fitting != 0u)
+            {
+              F = lowest_set_bit(fitting);
+              fitting = m_non_empty_second_level[F];
+            }
+        }
+
+      if(fitting != 0u)
+        {
+          return m_bin_heads[F * number_second_level_bins + lowest_set_bit(fitting)];
+        }
+    }
+
+  /* only intervals of the bin of size itself can fit now */
+  bins_of_size(size, &F, &S);
+  for(int node = m_bin_heads[F * number_second_level_bins + S]; node != -1; node = m_nodes[node].m_next)
+    {
+      const interval &I(m_nodes[node].m_interval);
+      if(I.m_end - I.m_begin >= size)
+        {
+          return node;
+        }
+    }
+
+  return -1;
 }
 
-void
+int
 fastuidraw::interval_allocator::
-remove_free_interval_from_sorted_only(std::map<int, interval_ref_set>::iterator sorted_iter,
-                                      interval_ref iter)
+allocate_interval(int size)
 {
-  assert(iter->second.m_end == iter->first);
-  assert(iter->second.m_end - iter->second.m_begin == sorted_iter->first);
-  assert(sorted_iter != m_sorted.end());
-  assert(sorted_iter->second.find(iter) != sorted_iter->second.end());
+  if(size <= 0)
+    {
+      return -1;
+    }
+
+  int node;
+
+  node = find_fitting_node(size);
+  if(node == -1)
+    {
+      return -1;
+    }
+
+  interval I(m_nodes[node].m_interval);
+  int return_value(I.m_begin), old_size(I.m_end - I.m_begin);
 
-  sorted_iter->second.erase(iter);
-  if(sorted_iter->second.empty())
+  /* take away the room from the interval used
+     by the allocation and keep the remainder
+   */
+  if(old_size == size)
     {
-      m_sorted.erase(sorted_iter);
+      destroy_node(node);
     }
+  else
+    {
+      set_interval(node, I.m_begin + size, I.m_end);
+      note_size_decrease(old_size);
+    }
+
+  m_total_free -= size;
+  update_report();
+  return return_value;
 }
 
+
 void
 fastuidraw::interval_allocator::
-remove_free_interval_from_sorted_only(interval_ref iter)
+free_interval(int location, int size)
 {
-  int sz(iter->second.m_end - iter->second.m_begin);
-  std::map<int, interval_ref_set>::iterator sorted_iter;
+  assert(size > 0);
+  assert(interval_status(location, size) == completely_allocated);
+
+  int end(location + size);
+  int before(m_boundary[location]), after(m_boundary[end]);
+
+  m_total_free += size;
+
+  /* before is a free interval ending at location
+     and after is a free interval starting at end
+   */
+  if(before != -1 && m_nodes[before].m_interval.m_end != location)
+    {
+      before = -1;
+    }
+
+  if(after != -1 && m_nodes[after].m_interval.m_begin != end)
+    {
+      after = -1;
+    }
+
+  if(before != -1 && after != -1)
+    {
+      int new_end(m_nodes[after].m_interval.m_end);
+
+      destroy_node(after);
+      set_interval(before, m_nodes[before].m_interval.m_begin, new_end);
+      note_size_increase(new_end - m_nodes[before].m_interval.m_begin);
+    }
+  else if(before != -1)
+    {
+      set_interval(before, m_nodes[before].m_interval.m_begin, end);
+      note_size_increase(end - m_nodes[before].m_interval.m_begin);
+    }
+  else if(after != -1)
+    {
+      set_interval(after, location, m_nodes[after].m_interval.m_end);
+      note_size_increase(m_nodes[after].m_interval.m_end - location);
+    }
+  else
+    {
+      create_node(location, end);
+    }
 
-  sorted_iter = m_sorted.find(sz);
-  remove_free_interval_from_sorted_only(sorted_iter, iter);
+  update_report();
 }
@@ -19,21 +19,30 @@
 
 #pragma once
 
-#include <map>
-#include <set>
+#include <vector>
+#include <stdint.h>
 #include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/memory_report.hpp>
 
 namespace fastuidraw
 {
   /*!\class interval_allocator
     An interval_allocator gives a means to allocate and deallocate
-    ranges from a linear range. The implementation is simply
-    to make a list of free intervals sorted by size. Allocation
-    means taking from the list the smallest interval that can
-    accomodate the request. From that interval take the portion
-    needed and return the remainder as a new entry on the free
-    list. All operations are O(log N) where N is the number of
-    free intervals.
+    ranges from a linear range. The free intervals are kept on the
+    segregated free lists of a two-level segregated fit: the first
+    level bin of a size S is floor(log2(S)) and the second level
+    splits each first level bin into 4 sub-bins of equal width;
+    bit masks record which bins are non-empty. Allocation rounds
+    the request up to the start of the next sub-bin so that every
+    interval of the lowest non-empty bin at or above it fits, takes
+    the first interval of that bin and keeps the remainder free;
+    only if no such bin exists is the bin of the request walked for
+    an interval that fits. Hence allocation is O(1) except for that
+    walk. Freeing merges the interval with its free neighbours at
+    once and is O(1): since free intervals are never adjacent, each
+    position is the boundary of at most one free interval, which is
+    recorded in an array of one int per position.
    */
   class interval_allocator:fastuidraw::noncopyable
   {
@@ -68,6 +77,8 @@ namespace fastuidraw
     explicit
     interval_allocator(int size);
 
+    ~interval_allocator();
+
     /*!\fn
       Reconstruct the \ref interval_allocator, i.e. clear all free intervals
       \param size new size for the \ref interval_allocator
@@ -111,18 +122,55 @@ namespace fastuidraw
 
     /*!\fn
       Returns the largest value that can be passed to allocate_interval()
-      and not fail.
+      and not fail. The value is cached and only recomputed (by walking
+      the highest non-empty bin) after the largest free interval was
+      allocated from.
      */
     int
     largest_free_interval(void) const
     {
-      return m_sorted.empty() ?
-        0 :
-        m_sorted.rbegin()->first;
+      if(m_largest_free_interval_dirty)
+        {
+          compute_largest_free_interval();
+        }
+      return m_largest_free_interval;
     }
 
     /*!\fn
-      Returns the allocation status of an interval
+      Returns the sum of the sizes of the free intervals.
+     */
+    int
+    total_free(void) const
+    {
+      return m_total_free;
+    }
+
+    /*!\fn
+      Returns the fragmentation of the free space, i.e.
+      1 - largest_free_interval() / total_free(); 0 when
+      all free space is one interval (or there is no free
+      space) and close to 1 when the free space is split
+      into many small intervals.
+     */
+    float
+    fragmentation(void) const;
+
+    /*!\fn
+      Have the \ref interval_allocator report its free space
+      to the memory report (see memory::usage::m_free_bytes)
+      from now on.
+      \param subsystem subsystem to which to report
+      \param bytes_per_unit number of bytes of each unit of
+                            the range of the \ref interval_allocator
+     */
+    void
+    report_free_space(enum memory::subsystem_t subsystem,
+                      unsigned int bytes_per_unit);
+
+    /*!\fn
+      Returns the allocation status of an interval. Only meant
+      for checking correctness, it is O(N) where N is the number
+      of free intervals.
       \param begin start of interval
       \param size length of interval
      */
@@ -131,48 +179,103 @@ namespace fastuidraw
 
   private:
     typedef range_type<int> interval;
-    typedef std::map<int, interval>::iterator interval_ref;
 
-    class compare_interval_ref
+    enum
+      {
+        /* a first level bin for each possible
+           value of floor(log2(size))
+         */
+        number_first_level_bins = 31,
+
+        /* log2 of the number of second level
+           bins of each first level bin
+         */
+        log2_number_second_level_bins = 2,
+        number_second_level_bins = 1 << log2_number_second_level_bins,
+
+        number_bins = number_first_level_bins * number_second_level_bins
+      };
+
+    class free_node
     {
     public:
-      bool
-      operator()(interval_ref lhs, interval_ref rhs)
-      {
-        assert(lhs->first == lhs->second.m_end);
-        assert(rhs->first == rhs->second.m_end);
-        return lhs->second.m_end < rhs->second.m_end;
-      }
+      interval m_interval;
+
+      /* bin of the node and the previous and next
+         nodes in the list of the bin, -1 for none
+       */
+      int m_bin;
+      int m_prev, m_next;
     };
-    typedef std::set<interval_ref, compare_interval_ref> interval_ref_set;
+
+    static
+    void
+    bins_of_size(uint32_t size, int *first_level, int *second_level);
+
+    int
+    create_node(int begin, int end);
 
     void
-    remove_free_interval(interval_ref iter);
+    destroy_node(int node);
 
     void
-    remove_free_interval(std::map<int, interval_ref_set>::iterator,
-                         interval_ref iter);
+    set_interval(int node, int begin, int end);
 
     void
-    remove_free_interval_from_sorted_only(std::map<int, interval_ref_set>::iterator sorted_iter,
-                                          interval_ref iter);
+    link_to_bin(int node);
 
     void
-    remove_free_interval_from_sorted_only(interval_ref iter);
+    unlink_from_bin(int node);
+
+    int
+    find_fitting_node(int size) const;
+
+    void
+    note_size_decrease(int old_size);
+
+    void
+    note_size_increase(int new_size);
+
+    void
+    compute_largest_free_interval(void) const;
+
+    void
+    update_report(void);
 
     int m_size;
+    int m_total_free;
 
-    /* List of free intervals, stored in a map
-       keyed by interval::m_end
+    /* storage of the free intervals, nodes no longer
+       in use are listed in m_unused_nodes for reuse
      */
-    std::map<int, interval> m_free_intervals;
+    std::vector<free_node> m_nodes;
+    std::vector<int> m_unused_nodes;
+
+    /* m_boundary[p] for 0 <= p <= m_size gives the node
+       of the free interval that begins or ends at p, or
+       -1 if no free interval begins or ends at p.
+     */
+    std::vector<int> m_boundary;
+
+    /* first node of the list of each bin, -1 for empty;
+       bit S of m_non_empty_second_level[F] is up exactly
+       when the list of bin (F, S) is not empty and bit F
+       of m_non_empty_first_level is up exactly when
+       m_non_empty_second_level[F] is not zero
+     */
+    vecN<int, number_bins> m_bin_heads;
+    vecN<uint32_t, number_first_level_bins> m_non_empty_second_level;
+    uint32_t m_non_empty_first_level;
+
+    mutable int m_largest_free_interval;
+    mutable bool m_largest_free_interval_dirty;
 
-    /* Each element of m_sorted[size] refers
-       to an element in m_free_intervals. Map
-       is keyed by the size of the interval
-       pointed to by *second
+    /* values last given to the memory report, m_report_bytes_per_unit
+       is 0 if the free space is not reported
      */
-    std::map<int, interval_ref_set> m_sorted;
+    enum memory::subsystem_t m_report_subsystem;
+    unsigned int m_report_bytes_per_unit;
+    uint64_t m_reported_free_bytes, m_reported_largest_free_bytes;
   };
 
 }
@@ -0,0 +1,52 @@
+/*!
+ * \file memory_report_private.hpp
+ * \brief file memory_report_private.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/memory_report.hpp>
+
+namespace fastuidraw
+{
+  namespace detail
+  {
+    /* Add to the memory of a subsystem, calls the
+       budget_callback of the subsystem if one is set.
+     */
+    void
+    memory_report_grow(enum memory::subsystem_t subsystem,
+                       uint64_t cpu_bytes, uint64_t gpu_bytes);
+
+    /* Remove from the memory of a subsystem, the values
+       must have been previously added by memory_report_grow().
+     */
+    void
+    memory_report_shrink(enum memory::subsystem_t subsystem,
+                         uint64_t cpu_bytes, uint64_t gpu_bytes);
+
+    /* Change the free space of a backing store of a subsystem
+       from (old_free_bytes, old_largest_free_bytes) to
+       (new_free_bytes, new_largest_free_bytes), see
+       memory::usage::m_free_bytes.
+     */
+    void
+    memory_report_free_space(enum memory::subsystem_t subsystem,
+                             uint64_t old_free_bytes, uint64_t old_largest_free_bytes,
+                             uint64_t new_free_bytes, uint64_t new_largest_free_bytes);
+  }
+}
@@ -0,0 +1,210 @@
+/*!
+ * \file small_vector.hpp
+ * \brief file small_vector.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <vector>
+#include <assert.h>
+#include <fastuidraw/util/c_array.hpp>
+
+namespace fastuidraw
+{
+  /*!
+    A small_vector is an array whose first N elements are
+    stored inline and which only allocates from the heap
+    when it grows beyond N elements. Once on the heap, the
+    elements stay on the heap until the small_vector is
+    cleared. T must be default constructible and copyable;
+    the inline storage is always N default constructed
+    values.
+   */
+  template<typename T, size_t N>
+  class small_vector
+  {
+  public:
+    small_vector(void):
+      m_size(0)
+    {}
+
+    size_t
+    size(void) const
+    {
+      return m_size;
+    }
+
+    bool
+    empty(void) const
+    {
+      return m_size == 0;
+    }
+
+    T*
+    data(void)
+    {
+      return m_heap.empty() ? m_inline : &m_heap[0];
+    }
+
+    const T*
+    data(void) const
+    {
+      return m_heap.empty() ? m_inline : &m_heap[0];
+    }
+
+    T&
+    operator[](size_t i)
+    {
+      assert(i < m_size);
+      return data()[i];
+    }
+
+    const T&
+    operator[](size_t i) const
+    {
+      assert(i < m_size);
+      return data()[i];
+    }
+
+    T&
+    back(void)
+    {
+      assert(m_size > 0);
+      return data()[m_size - 1];
+    }
+
+    const T&
+    back(void) const
+    {
+      assert(m_size > 0);
+      return data()[m_size - 1];
+    }
+
+    T*
+    begin(void)
+    {
+      return data();
+    }
+
+    const T*
+    begin(void) const
+    {
+      return data();
+    }
+
+    T*
+    end(void)
+    {
+      return data() + m_size;
+    }
+
+    const T*
+    end(void) const
+    {
+      return data() + m_size;
+    }
+
+    void
+    push_back(const T &v)
+    {
+      if(m_heap.empty())
+        {
+          if(m_size < N)
+            {
+              m_inline[m_size] = v;
+              ++m_size;
+              return;
+            }
+          move_to_heap();
+        }
+      m_heap.push_back(v);
+      ++m_size;
+    }
+
+    void
+    pop_back(void)
+    {
+      assert(m_size > 0);
+      if(!m_heap.empty())
+        {
+          m_heap.pop_back();
+        }
+      --m_size;
+    }
+
+    void
+    resize(size_t sz, const T &v = T())
+    {
+      if(m_heap.empty() && sz <= N)
+        {
+          for(size_t i = m_size; i < sz; ++i)
+            {
+              m_inline[i] = v;
+            }
+        }
+      else
+        {
+          if(m_heap.empty())
+            {
+              move_to_heap();
+            }
+          m_heap.resize(sz, v);
+        }
+      m_size = sz;
+    }
+
+    void
+    clear(void)
+    {
+      m_heap.clear();
+      m_size = 0;
+    }
+
+  private:
+    void
+    move_to_heap(void)
+    {
+      assert(m_heap.empty());
+      m_heap.reserve(2 * N);
+      m_heap.insert(m_heap.end(), m_inline, m_inline + m_size);
+    }
+
+    T m_inline[N];
+    size_t m_size;
+
+    /* non-empty exactly when the elements are on the heap */
+    std::vector<T> m_heap;
+  };
+
+  template<typename T, size_t N>
+  c_array<T>
+  make_c_array(small_vector<T, N> &p)
+  {
+    return p.empty() ?
+      c_array<T>() :
+      c_array<T>(p.data(), p.size());
+  }
+
+  template<typename T, size_t N>
+  const_c_array<T>
+  make_c_array(const small_vector<T, N> &p)
+  {
+    return p.empty() ?
+      const_c_array<T>() :
+      const_c_array<T>(p.data(), p.size());
+  }
+}
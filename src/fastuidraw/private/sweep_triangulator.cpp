@@ -0,0 +1,429 @@
+/*!
+ * \file sweep_triangulator.cpp
+ * \brief file sweep_triangulator.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#include <algorithm>
+#include "sweep_triangulator.hpp"
+
+namespace
+{
+  class compare_vertex_yx
+  {
+  public:
+    bool
+    operator()(const fastuidraw::vec2 &a, const fastuidraw::vec2 &b) const
+    {
+      return a.y() < b.y() || (a.y() == b.y() && a.x() < b.x());
+    }
+  };
+
+  class compare_x
+  {
+  public:
+    bool
+    operator()(const fastuidraw::vec2 &a, float b) const
+    {
+      return a.x() < b;
+    }
+
+    bool
+    operator()(float a, const fastuidraw::vec2 &b) const
+    {
+      return a < b.x();
+    }
+  };
+
+  template<typename T>
+  class compare_edge_start_y
+  {
+  public:
+    explicit
+    compare_edge_start_y(const std::vector<T> &edges):
+      m_edges(edges)
+    {}
+
+    bool
+    operator()(unsigned int a, unsigned int b) const
+    {
+      return m_edges[a].m_start.y() < m_edges[b].m_start.y();
+    }
+
+  private:
+    const std::vector<T> &m_edges;
+  };
+
+  float
+  clamp_value(float v, float min_v, float max_v)
+  {
+    return std::min(max_v, std::max(min_v, v));
+  }
+}
+
+//////////////////////////////////////////
+// fastuidraw::detail::SweepTriangulator methods
+void
+fastuidraw::detail::SweepTriangulator::
+clear(void)
+{
+  m_vertices.clear();
+  m_edges.clear();
+  m_contour_start = 0;
+  m_points.clear();
+  m_indices.clear();
+  m_winding_numbers.clear();
+}
+
+void
+fastuidraw::detail::SweepTriangulator::
+add_point(const vec2 &pt)
+{
+  m_vertices.push_back(pt);
+}
+
+void
+fastuidraw::detail::SweepTriangulator::
+end_contour(void)
+{
+  for(unsigned int i = m_contour_start, endi = m_vertices.size(); i < endi; ++i)
+    {
+      unsigned int next;
+
+      next = (i + 1 == endi) ? m_contour_start : i + 1;
+      add_edge(m_vertices[i], m_vertices[next]);
+    }
+  m_contour_start = m_vertices.size();
+}
+
+void
+fastuidraw::detail::SweepTriangulator::
+add_edge(const vec2 &a, const vec2 &b)
+{
+  /* horizontal edges do not change the winding number
+     along a scanline and their end points are already
+     vertices, so they do not need to be an edge.
+   */
+  if(a.y() == b.y())
+    {
+      return;
+    }
+
+  edge e;
+  if(a.y() < b.y())
+    {
+      e.m_start = a;
+      e.m_end = b;
+      e.m_winding_delta = -1;
+    }
+  else
+    {
+      e.m_start = b;
+      e.m_end = a;
+      e.m_winding_delta = 1;
+    }
+  m_edges.push_back(e);
+}
+
+float
+fastuidraw::detail::SweepTriangulator::
+edge_x(const edge &e, float y)
+{
+  /* the same computation must be done for the scanline
+     points and for the trapezoids of the slabs so that
+     the values are bit-for-bit equal.
+   */
+  if(y <= e.m_start.y())
+    {
+      return e.m_start.x();
+    }
+
+  if(y >= e.m_end.y())
+    {
+      return e.m_end.x();
+    }
+
+  double t;
+  t = (static_cast<double>(y) - static_cast<double>(e.m_start.y()))
+    / (static_cast<double>(e.m_end.y()) - static_cast<double>(e.m_start.y()));
+
+  return static_cast<float>(static_cast<double>(e.m_start.x())
+                            + t * (static_cast<double>(e.m_end.x()) - static_cast<double>(e.m_start.x())));
+}
+
+void
+fastuidraw::detail::SweepTriangulator::
+compute_scanlines(const vec2 &min_pt, const vec2 &max_pt)
+{
+  m_scanlines.clear();
+  m_scanlines.push_back(min_pt.y());
+  m_scanlines.push_back(max_pt.y());
+  for(unsigned int i = 0, endi = m_vertices.size(); i < endi; ++i)
+    {
+      m_scanlines.push_back(m_vertices[i].y());
+    }
+
+  /* add the y-coordinate of each intersection of edges, the
+     edges are walked sorted by their minimum y so that only
+     those pairs that overlap in y are tested.
+   */
+  for(unsigned int ii = 0, endii = m_sorted_edges.size(); ii < endii; ++ii)
+    {
+      const edge &e(m_edges[m_sorted_edges[ii]]);
+      float e_min_x, e_max_x;
+
+      e_min_x = std::min(e.m_start.x(), e.m_end.x());
+      e_max_x = std::max(e.m_start.x(), e.m_end.x());
+      for(unsigned int jj = ii + 1; jj < endii; ++jj)
+        {
+          const edge &f(m_edges[m_sorted_edges[jj]]);
+          if(f.m_start.y() >= e.m_end.y())
+            {
+              break;
+            }
+
+          if(std::max(f.m_start.x(), f.m_end.x()) < e_min_x
+             || std::min(f.m_start.x(), f.m_end.x()) > e_max_x)
+            {
+              continue;
+            }
+
+          vecN<double, 2> p(e.m_start), r(vecN<double, 2>(e.m_end) - p);
+          vecN<double, 2> q(f.m_start), s(vecN<double, 2>(f.m_end) - q);
+          vecN<double, 2> qp(q - p);
+          double denom, t, u;
+
+          denom = r.x() * s.y() - r.y() * s.x();
+          if(denom == 0.0)
+            {
+              continue;
+            }
+
+          t = (qp.x() * s.y() - qp.y() * s.x()) / denom;
+          u = (qp.x() * r.y() - qp.y() * r.x()) / denom;
+          if(t > 0.0 && t < 1.0 && u > 0.0 && u < 1.0)
+            {
+              float y;
+              y = static_cast<float>(p.y() + t * r.y());
+              m_scanlines.push_back(clamp_value(y, min_pt.y(), max_pt.y()));
+            }
+        }
+    }
+
+  std::sort(m_scanlines.begin(), m_scanlines.end());
+  m_scanlines.erase(std::unique(m_scanlines.begin(), m_scanlines.end()), m_scanlines.end());
+}
+
+void
+fastuidraw::detail::SweepTriangulator::
+triangulate(const vec2 &min_pt, const vec2 &max_pt)
+{
+  assert(m_contour_start == m_vertices.size());
+
+  m_points.clear();
+  m_indices.clear();
+  m_winding_numbers.clear();
+
+  m_sorted_edges.resize(m_edges.size());
+  for(unsigned int i = 0, endi = m_edges.size(); i < endi; ++i)
+    {
+      m_sorted_edges[i] = i;
+    }
+  std::sort(m_sorted_edges.begin(), m_sorted_edges.end(), compare_edge_start_y<edge>(m_edges));
+
+  compute_scanlines(min_pt, max_pt);
+  std::sort(m_vertices.begin(), m_vertices.end(), compare_vertex_yx());
+
+  /* walk the scanlines from bottom to top; the points of a
+     scanline are the vertices on it, the points where the
+     edges cross it and the sides of the rectangle. The slab
+     below a scanline is triangulated once the points of the
+     scanline are known.
+   */
+  unsigned int next_vertex(0), next_edge(0);
+
+  m_active_edges.clear();
+  m_slab_edges.clear();
+  m_scanline_start.resize(m_scanlines.size() + 1);
+  for(unsigned int k = 0, endk = m_scanlines.size(); k < endk; ++k)
+    {
+      float y(m_scanlines[k]);
+
+      m_scanline_xs.clear();
+      m_scanline_xs.push_back(min_pt.x());
+      m_scanline_xs.push_back(max_pt.x());
+
+      for(; next_vertex < m_vertices.size() && m_vertices[next_vertex].y() <= y; ++next_vertex)
+        {
+          m_scanline_xs.push_back(clamp_value(m_vertices[next_vertex].x(), min_pt.x(), max_pt.x()));
+        }
+
+      for(; next_edge < m_sorted_edges.size() && m_edges[m_sorted_edges[next_edge]].m_start.y() <= y; ++next_edge)
+        {
+          m_active_edges.push_back(m_sorted_edges[next_edge]);
+        }
+
+      unsigned int num_active(0);
+      for(unsigned int i = 0, endi = m_active_edges.size(); i < endi; ++i)
+        {
+          const edge &e(m_edges[m_active_edges[i]]);
+          if(e.m_end.y() >= y)
+            {
+              m_active_edges[num_active++] = m_active_edges[i];
+              m_scanline_xs.push_back(clamp_value(edge_x(e, y), min_pt.x(), max_pt.x()));
+            }
+        }
+      m_active_edges.resize(num_active);
+
+      std::sort(m_scanline_xs.begin(), m_scanline_xs.end());
+      m_scanline_xs.erase(std::unique(m_scanline_xs.begin(), m_scanline_xs.end()), m_scanline_xs.end());
+
+      m_scanline_start[k] = m_points.size();
+      for(unsigned int i = 0, endi = m_scanline_xs.size(); i < endi; ++i)
+        {
+          m_points.push_back(vec2(m_scanline_xs[i], y));
+        }
+      m_scanline_start[k + 1] = m_points.size();
+
+      if(k > 0)
+        {
+          triangulate_slab(k - 1, min_pt, max_pt);
+        }
+
+      /* the edges of the slab above scanline k are the
+         active edges that do not end on it.
+       */
+      if(k + 1 < endk)
+        {
+          double mid_y;
+
+          mid_y = 0.5 * (static_cast<double>(y) + static_cast<double>(m_scanlines[k + 1]));
+          m_slab_edges.clear();
+          for(unsigned int i = 0, endi = m_active_edges.size(); i < endi; ++i)
+            {
+              const edge &e(m_edges[m_active_edges[i]]);
+              if(e.m_end.y() > y)
+                {
+                  double t, x;
+
+                  t = (mid_y - static_cast<double>(e.m_start.y()))
+                    / (static_cast<double>(e.m_end.y()) - static_cast<double>(e.m_start.y()));
+                  x = static_cast<double>(e.m_start.x())
+                    + t * (static_cast<double>(e.m_end.x()) - static_cast<double>(e.m_start.x()));
+                  m_slab_edges.push_back(std::make_pair(x, m_active_edges[i]));
+                }
+            }
+          std::sort(m_slab_edges.begin(), m_slab_edges.end());
+        }
+    }
+}
+
+void
+fastuidraw::detail::SweepTriangulator::
+triangulate_slab(unsigned int slab, const vec2 &min_pt, const vec2 &max_pt)
+{
+  float y0(m_scanlines[slab]), y1(m_scanlines[slab + 1]);
+  float left_bottom(min_pt.x()), left_top(min_pt.x());
+  int winding(0);
+
+  for(unsigned int i = 0, endi = m_slab_edges.size(); i < endi; ++i)
+    {
+      const edge &e(m_edges[m_slab_edges[i].second]);
+      float bottom, top;
+
+      bottom = clamp_value(edge_x(e, y0), min_pt.x(), max_pt.x());
+      top = clamp_value(edge_x(e, y1), min_pt.x(), max_pt.x());
+      add_trapezoid(slab, left_bottom, bottom, left_top, top, winding);
+
+      left_bottom = bottom;
+      left_top = top;
+      winding += e.m_winding_delta;
+    }
+  add_trapezoid(slab, left_bottom, max_pt.x(), left_top, max_pt.x(), winding);
+}
+
+void
+fastuidraw::detail::SweepTriangulator::
+add_trapezoid(unsigned int slab, float bottom_min, float bottom_max,
+              float top_min, float top_max, int winding)
+{
+  /* crossing edges may be out of order at the slab
+     boundaries by round-off.
+   */
+  if(bottom_min > bottom_max)
+    {
+      std::swap(bottom_min, bottom_max);
+    }
+
+  if(top_min > top_max)
+    {
+      std::swap(top_min, top_max);
+    }
+
+  std::vector<vec2>::const_iterator base(m_points.begin());
+  unsigned int b, end_b, t, end_t;
+
+  b = std::lower_bound(base + m_scanline_start[slab], base + m_scanline_start[slab + 1],
+                       bottom_min, compare_x()) - base;
+  end_b = std::upper_bound(base + b, base + m_scanline_start[slab + 1],
+                           bottom_max, compare_x()) - base;
+  t = std::lower_bound(base + m_scanline_start[slab + 1], base + m_scanline_start[slab + 2],
+                       top_min, compare_x()) - base;
+  end_t = std::upper_bound(base + t, base + m_scanline_start[slab + 2],
+                           top_max, compare_x()) - base;
+
+  if(b == end_b || t == end_t || (end_b - b) + (end_t - t) < 3)
+    {
+      return;
+    }
+
+  /* zip the bottom and top point chains together, always
+     advancing along the chain whose next point is leftmost.
+   */
+  while(b + 1 < end_b || t + 1 < end_t)
+    {
+      if(t + 1 == end_t || (b + 1 < end_b && m_points[b + 1].x() <= m_points[t + 1].x()))
+        {
+          add_triangle(b, b + 1, t, winding);
+          ++b;
+        }
+      else
+        {
+          add_triangle(b, t + 1, t, winding);
+          ++t;
+        }
+    }
+}
+
+void
+fastuidraw::detail::SweepTriangulator::
+add_triangle(unsigned int a, unsigned int b, unsigned int c, int winding)
+{
+  vec2 v(m_points[b] - m_points[a]), w(m_points[c] - m_points[a]);
+
+  /* we only reject a triangle if its area to floating
+     point arithematic is zero.
+   */
+  if(v.x() * w.y() - v.y() * w.x() == 0.0f)
+    {
+      return;
+    }
+
+  m_indices.push_back(a);
+  m_indices.push_back(b);
+  m_indices.push_back(c);
+  m_winding_numbers.push_back(winding);
+}
@@ -0,0 +1,150 @@
+/*!
+ * \file sweep_triangulator.hpp
+ * \brief file sweep_triangulator.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <vector>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/util.hpp>
+
+namespace fastuidraw
+{
+  namespace detail
+  {
+    /* A SweepTriangulator triangulates a set of closed polygons,
+       which may self-intersect and have overlapping edges, within
+       a rectangle, giving each triangle the winding number of the
+       region it covers, including those regions of winding number
+       zero. The plane is cut along each y-coordinate of a vertex or
+       of an intersection of two edges into horizontal slabs; the
+       edges that cross a slab do not intersect within it, so each
+       slab is a sequence of trapezoids, one per span between
+       consecutive edges, with constant winding number. The points
+       of a trapezoid are all the points where the edges or vertices
+       meet the top and bottom of the slab within the span so
+       that the triangulation has no T-junctions.
+
+       All work is done in arrays that are reused across calls to
+       triangulate(), so a SweepTriangulator used for many polygons
+       does not allocate once its arrays have grown.
+     */
+    class SweepTriangulator:noncopyable
+    {
+    public:
+      SweepTriangulator(void):
+        m_contour_start(0)
+      {}
+
+      /* remove all contours and the results of triangulate().
+       */
+      void
+      clear(void);
+
+      /* add a point to the current contour.
+       */
+      void
+      add_point(const vec2 &pt);
+
+      /* close the current contour, the next add_point()
+         starts a new contour.
+       */
+      void
+      end_contour(void);
+
+      /* triangulate the region [min_pt, max_pt] which must
+         contain all points of all contours.
+       */
+      void
+      triangulate(const vec2 &min_pt, const vec2 &max_pt);
+
+      /* points made by triangulate(), they are NOT
+         the points passed to add_point().
+       */
+      const std::vector<vec2>&
+      points(void) const
+      {
+        return m_points;
+      }
+
+      /* indices into points(), 3 for each triangle.
+       */
+      const std::vector<unsigned int>&
+      indices(void) const
+      {
+        return m_indices;
+      }
+
+      /* winding number of each triangle, the winding number
+         of the region outside of all contours is 0.
+       */
+      const std::vector<int>&
+      winding_numbers(void) const
+      {
+        return m_winding_numbers;
+      }
+
+    private:
+      class edge
+      {
+      public:
+        /* m_start.y() < m_end.y() */
+        vec2 m_start, m_end;
+        int m_winding_delta;
+      };
+
+      static
+      float
+      edge_x(const edge &e, float y);
+
+      void
+      add_edge(const vec2 &a, const vec2 &b);
+
+      void
+      compute_scanlines(const vec2 &min_pt, const vec2 &max_pt);
+
+      void
+      triangulate_slab(unsigned int slab, const vec2 &min_pt, const vec2 &max_pt);
+
+      void
+      add_trapezoid(unsigned int slab, float bottom_min, float bottom_max,
+                    float top_min, float top_max, int winding);
+
+      void
+      add_triangle(unsigned int a, unsigned int b, unsigned int c, int winding);
+
+      /* input */
+      std::vector<vec2> m_vertices;
+      std::vector<edge> m_edges;
+      unsigned int m_contour_start;
+
+      /* scratch */
+      std::vector<float> m_scanlines;
+      std::vector<unsigned int> m_scanline_start;
+      std::vector<unsigned int> m_sorted_edges, m_active_edges;
+      std::vector<std::pair<double, unsigned int> > m_slab_edges;
+      std::vector<float> m_scanline_xs;
+
+      /* output */
+      std::vector<vec2> m_points;
+      std::vector<unsigned int> m_indices;
+      std::vector<int> m_winding_numbers;
+    };
+  }
+}
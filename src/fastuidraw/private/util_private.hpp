@@ -22,7 +22,35 @@
 #include <boost/thread.hpp>
 
 #include <vector>
+#include <algorithm>
+#include <utility>
+#include <stdint.h>
 #include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/task_executor.hpp>
+
+/* Increment the statistic X by V; the counters reported by
+   PainterPacker::query_stat() and PainterBackend::query_stat()
+   that are not needed for the operation of the painter are
+   updated with this macro so that a build can compile them
+   out by defining FASTUIDRAW_NO_STATS.
+ */
+#ifdef FASTUIDRAW_NO_STATS
+#define FASTUIDRAWincrement_stat(X, V) do {} while(0)
+#else
+#define FASTUIDRAWincrement_stat(X, V) do { (X) += (V); } while(0)
+#endif
+
+/* Cast X to an rvalue so that it is moved from when the
+   compiler supports move semantics and copied otherwise;
+   X must not be used afterwards other than to assign to
+   it or to destroy it.
+ */
+#ifdef FASTUIDRAW_HAS_MOVE_SEMANTICS
+#define FASTUIDRAWmove(X) std::move(X)
+#else
+#define FASTUIDRAWmove(X) (X)
+#endif
 
 namespace fastuidraw
 {
@@ -39,6 +67,12 @@ namespace fastuidraw
       m_mutex.lock();
     }
 
+    bool
+    try_lock(void)
+    {
+      return m_mutex.try_lock();
+    }
+
     void
     unlock(void)
     {
@@ -70,6 +104,23 @@ namespace fastuidraw
     mutex &m_mutex;
   };
 
+  /*!
+    push_back() value onto v and increment the stat counter
+    if doing so makes v allocate, i.e. if v is at capacity;
+    used to count the allocations of the containers that are
+    reserved ahead of time, see PainterPacker::num_unbudgeted_allocations.
+   */
+  template<typename T>
+  void
+  counted_push_back(std::vector<T> &v, const T &value, unsigned int &counter)
+  {
+    if(v.size() == v.capacity())
+      {
+        FASTUIDRAWincrement_stat(counter, 1u);
+      }
+    v.push_back(value);
+  }
+
   template<typename T>
   c_array<T>
   make_c_array(std::vector<T> &p)
@@ -106,4 +157,128 @@ namespace fastuidraw
     q = const_cast<T*>(p.c_ptr());
     return c_array<T>(q, p.size());
   }
+
+  /*!
+    Two independent 64-bit hashes of an array of texels
+    (FNV-1a and a multiply-xorshift hash) used as the key to
+    find identical texels in an atlas; a match is only a
+    candidate and the texels are compared before sharing.
+   */
+  typedef std::pair<uint64_t, uint64_t> texel_hash;
+
+  inline
+  texel_hash
+  compute_texel_hash(const_c_array<u8vec4> data)
+  {
+    uint64_t h0(14695981039346656037ull), h1(0x9E3779B97F4A7C15ull);
+
+    for(unsigned int i = 0; i < data.size(); ++i)
+      {
+        uint64_t v;
+
+        v = static_cast<uint64_t>(data[i].x())
+          | (static_cast<uint64_t>(data[i].y()) << 8u)
+          | (static_cast<uint64_t>(data[i].z()) << 16u)
+          | (static_cast<uint64_t>(data[i].w()) << 24u);
+
+        for(unsigned int b = 0; b < 4; ++b)
+          {
+            h0 ^= (v >> (8u * b)) & 0xFFu;
+            h0 *= 1099511628211ull;
+          }
+
+        h1 ^= v + (static_cast<uint64_t>(i) << 32u);
+        h1 *= 0xBF58476D1CE4E5B9ull;
+        h1 ^= h1 >> 31u;
+      }
+    return texel_hash(h0, h1);
+  }
+
+  /*!
+    Job of run_in_parallel(), calls f(begin, end).
+   */
+  template<typename F>
+  class run_in_parallel_job:public TaskExecutor::Task
+  {
+  public:
+    run_in_parallel_job(F *f, unsigned int b, unsigned int e):
+      m_f(f), m_b(b), m_e(e)
+    {}
+
+    virtual
+    void
+    run(void)
+    {
+      (*m_f)(m_b, m_e);
+    }
+
+  private:
+    F *m_f;
+    unsigned int m_b, m_e;
+  };
+
+  /*!
+    Calls f(begin, end) over contiguous ranges that
+    partition [0, count) with each range a task of
+    default_task_executor(); the calling thread runs
+    tasks as well and the function returns when all
+    ranges are done. The ranges are in increasing order and have
+    at least min_per_thread elements (except when count
+    is smaller) so that f can write results that depend
+    only on the element index without synchronization.
+    \param count number of elements
+    \param max_threads maximum number of ranges, a value
+                       of 0 indicates to use the number of
+                       threads of default_task_executor()
+    \param min_per_thread minimum number of elements
+                          each thread processes
+    \param f functor called as f(begin, end); it is called
+             from multiple threads at the same time
+   */
+  template<typename F>
+  void
+  run_in_parallel(unsigned int count, unsigned int max_threads,
+                  unsigned int min_per_thread, F &f)
+  {
+    unsigned int num_threads, per_thread;
+    reference_counted_ptr<TaskExecutor> executor;
+
+    if(max_threads == 1 || count <= std::max(1u, min_per_thread))
+      {
+        f(0, count);
+        return;
+      }
+
+    executor = default_task_executor();
+    if(max_threads == 0)
+      {
+        max_threads = std::max(1u, executor->number_threads());
+      }
+    min_per_thread = std::max(1u, min_per_thread);
+    num_threads = std::min(max_threads, std::max(1u, count / min_per_thread));
+
+    if(num_threads <= 1)
+      {
+        f(0, count);
+        return;
+      }
+
+    std::vector<run_in_parallel_job<F> > jobs;
+    std::vector<TaskExecutor::Task*> tasks(num_threads, NULL);
+
+    per_thread = count / num_threads;
+    jobs.reserve(num_threads);
+    for(unsigned int t = 0; t < num_threads; ++t)
+      {
+        unsigned int e;
+
+        e = (t + 1 < num_threads) ? (t + 1) * per_thread : count;
+        jobs.push_back(run_in_parallel_job<F>(&f, t * per_thread, e));
+      }
+    for(unsigned int t = 0; t < num_threads; ++t)
+      {
+        tasks[t] = &jobs[t];
+      }
+    executor->run_tasks(make_c_array(tasks));
+  }
 }
@@ -17,24 +17,180 @@
  */
 
 
-#include <list>
 #include <vector>
+#include <algorithm>
 #include <fastuidraw/tessellated_path.hpp>
 #include <fastuidraw/path.hpp>
 #include <fastuidraw/painter/stroked_path.hpp>
 #include <fastuidraw/painter/filled_path.hpp>
 #include "private/util_private.hpp"
+#include "private/memory_report_private.hpp"
 
 namespace
 {
+  class edge_tessellation
+  {
+  public:
+    edge_tessellation(void):
+      m_thresh_dist(0.0f),
+      m_thresh_curvature(0.0f)
+    {}
+
+    std::vector<fastuidraw::TessellatedPath::point> m_pts;
+    float m_thresh_dist, m_thresh_curvature;
+  };
+
+  /* An edge to tessellate: either a curve given by its interpolator
+     or, when m_interpolator is NULL, the line segment from m_start
+     to m_end, see PathContour::curve_interpolator().
+   */
+  class edge
+  {
+  public:
+    edge(const fastuidraw::PathContour::interpolator_base *h,
+         const fastuidraw::vec2 &start, const fastuidraw::vec2 &end):
+      m_interpolator(h),
+      m_start(start),
+      m_end(end)
+    {}
+
+    const fastuidraw::PathContour::interpolator_base *m_interpolator;
+    fastuidraw::vec2 m_start, m_end;
+  };
+
+  /* Tessellates a range of edges; each edge only writes to its
+     own slot of m_out so that ranges can be run on different
+     threads. The interpolators are accessed by raw pointer so
+     that the (non-atomic) reference counts are not touched from
+     the worker threads.
+   */
+  class tessellate_edges
+  {
+  public:
+    tessellate_edges(const fastuidraw::TessellatedPath::TessellationParams &params,
+                     const std::vector<edge> &edges,
+                     std::vector<edge_tessellation> &out):
+      m_params(params),
+      m_edges(edges),
+      m_out(out)
+    {}
+
+    void
+    operator()(unsigned int begin, unsigned int end)
+    {
+      std::vector<fastuidraw::TessellatedPath::point> work_room(m_params.m_max_segments + 1);
+      for(unsigned int i = begin; i < end; ++i)
+        {
+          const edge &E(m_edges[i]);
+
+          if(!E.m_interpolator)
+            {
+              fastuidraw::vec2 delta(E.m_end - E.m_start);
+
+              m_out[i].m_pts.resize(2);
+              m_out[i].m_pts[0].m_p = E.m_start;
+              m_out[i].m_pts[0].m_p_t = delta;
+              m_out[i].m_pts[0].m_distance_from_edge_start = 0.0f;
+              m_out[i].m_pts[1].m_p = E.m_end;
+              m_out[i].m_pts[1].m_p_t = delta;
+              m_out[i].m_pts[1].m_distance_from_edge_start = delta.magnitude();
+              continue;
+            }
+
+          unsigned int needed;
+
+          needed = E.m_interpolator->produce_tessellation(m_params,
+                                                          fastuidraw::make_c_array(work_room),
+                                                          &m_out[i].m_thresh_dist,
+                                                          &m_out[i].m_thresh_curvature);
+          assert(needed > 0u);
+          m_out[i].m_pts.assign(work_room.begin(), work_room.begin() + needed);
+        }
+    }
+
+  private:
+    const fastuidraw::TessellatedPath::TessellationParams &m_params;
+    const std::vector<edge> &m_edges;
+    std::vector<edge_tessellation> &m_out;
+  };
+
+  /* the values of TessellatedPath::point that are the
+     same for all points of an edge are stored once.
+   */
+  class edge_data
+  {
+  public:
+    edge_data(void):
+      m_length(0.0f),
+      m_distance_from_contour_start(0.0f)
+    {}
+
+    fastuidraw::range_type<unsigned int> m_range;
+    float m_length;
+    float m_distance_from_contour_start;
+  };
+
+  /* per-contour values so that a contour can be reused
+     by a TessellatedPath constructed incrementally.
+   */
+  class contour_data
+  {
+  public:
+    contour_data(void):
+      m_max_segments(0u),
+      m_effective_curve_distance_threshhold(0.0f),
+      m_effective_curvature_threshhold(0.0f),
+      m_open_contour_length(0.0f),
+      m_closed_contour_length(0.0f),
+      m_box_min(0.0f, 0.0f),
+      m_box_max(0.0f, 0.0f)
+    {}
+
+    fastuidraw::reference_counted_ptr<const fastuidraw::PathContour> m_contour;
+    unsigned int m_max_segments;
+    float m_effective_curve_distance_threshhold;
+    float m_effective_curvature_threshhold;
+    float m_open_contour_length, m_closed_contour_length;
+    fastuidraw::vec2 m_box_min, m_box_max;
+  };
+
   class TessellatedPathPrivate
   {
   public:
     TessellatedPathPrivate(const fastuidraw::Path &input,
-                           fastuidraw::TessellatedPath::TessellationParams TP);
+                           fastuidraw::TessellatedPath::TessellationParams TP,
+                           const TessellatedPathPrivate *prev);
+
+    /* copy the points [begin, end) of src to the end of
+       the point arrays.
+     */
+    void
+    append_points(const TessellatedPathPrivate &src,
+                  unsigned int begin, unsigned int end);
+
+    void
+    append_point(const fastuidraw::TessellatedPath::point &pt)
+    {
+      m_positions.push_back(pt.m_p);
+      m_derivatives.push_back(pt.m_p_t);
+      m_distances_from_edge_start.push_back(pt.m_distance_from_edge_start);
+    }
 
-    std::vector<std::vector<fastuidraw::range_type<unsigned int> > > m_edge_ranges;
-    std::vector<fastuidraw::TessellatedPath::point> m_point_data;
+    unsigned int
+    number_points(void) const
+    {
+      return m_positions.size();
+    }
+
+    std::vector<std::vector<edge_data> > m_edge_data;
+    std::vector<contour_data> m_contour_data;
+
+    /* the points are stored as arrays of each of their
+       values that varies along an edge.
+     */
+    std::vector<fastuidraw::vec2> m_positions;
+    std::vector<fastuidraw::vec2> m_derivatives;
+    std::vector<float> m_distances_from_edge_start;
     fastuidraw::vec2 m_box_min, m_box_max;
     fastuidraw::TessellatedPath::TessellationParams m_params;
     float m_effective_curve_distance_threshhold;
@@ -42,6 +198,30 @@ namespace
     unsigned int m_max_segments;
     fastuidraw::reference_counted_ptr<const fastuidraw::StrokedPath> m_stroked;
     fastuidraw::reference_counted_ptr<const fastuidraw::FilledPath> m_filled;
+
+    /* m_filled_lods[k] is the fill simplified with the tolerance
+       filled_lod_tolerance(k), each made when first needed.
+     */
+    std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::FilledPath> > m_filled_lods;
+
+    float
+    filled_lod_tolerance(unsigned int k) const
+    {
+      float sz;
+      sz = fastuidraw::t_max(m_box_max.x() - m_box_min.x(), m_box_max.y() - m_box_min.y());
+      return sz * static_cast<float>(1u << k) / static_cast<float>(filled_lod_divisor);
+    }
+
+    enum
+      {
+        /* the tolerance of the finest simplified fill is the
+           size of the tessellation divided by filled_lod_divisor
+           and each coarser level doubles it, the coarsest
+           tolerance being an eighth of the size.
+         */
+        filled_lod_divisor = 2048,
+        number_filled_lods = 9
+      };
   };
 }
 
@@ -49,8 +229,10 @@ namespace
 // TessellatedPathPrivate methods
 TessellatedPathPrivate::
 TessellatedPathPrivate(const fastuidraw::Path &input,
-                       fastuidraw::TessellatedPath::TessellationParams TP):
-  m_edge_ranges(input.number_contours()),
+                       fastuidraw::TessellatedPath::TessellationParams TP,
+                       const TessellatedPathPrivate *prev):
+  m_edge_data(input.number_contours()),
+  m_contour_data(input.number_contours()),
   m_box_min(0.0f, 0.0f),
   m_box_max(0.0f, 0.0f),
   m_params(TP),
@@ -58,102 +240,180 @@ TessellatedPathPrivate(const fastuidraw::Path &input,
   m_effective_curvature_threshhold(0.0f),
   m_max_segments(0u)
 {
+  /* the number of edges below which a thread is not worth
+     spawning to tessellate a range of edges.
+   */
+  const unsigned int min_edges_per_thread(256);
+
   if(input.number_contours() > 0)
     {
-      std::list<std::vector<fastuidraw::TessellatedPath::point> > temp;
-      std::vector<fastuidraw::TessellatedPath::point> work_room(m_params.m_max_segments + 1);
-      std::list<std::vector<fastuidraw::TessellatedPath::point> >::const_iterator iter, end_iter;
+      std::vector<edge> edges;
+      std::vector<edge_tessellation> tessellations;
+      unsigned int total_needed(0), num_reused(0);
+
+      for(unsigned int o = 0, endo = input.number_contours(); o < endo; ++o)
+        {
+          m_contour_data[o].m_contour = input.contour(o);
+        }
 
-      for(unsigned int loc = 0, o = 0, endo = input.number_contours(); o < endo; ++o)
+      /* an ended PathContour does not change, so the leading
+         contours that are the same objects as those of prev
+         have the same tessellation.
+       */
+      if(prev != NULL && !(prev->m_params != m_params))
         {
-          fastuidraw::reference_counted_ptr<const fastuidraw::PathContour> contour(input.contour(o));
-          float contour_length(0.0f), open_contour_length(0.0f), closed_contour_length(0.0f);
-          std::list<std::vector<fastuidraw::TessellatedPath::point> >::iterator start_contour;
+          while(num_reused < m_contour_data.size()
+                && num_reused < prev->m_contour_data.size()
+                && m_contour_data[num_reused].m_contour == prev->m_contour_data[num_reused].m_contour
+                && m_contour_data[num_reused].m_contour->ended())
+            {
+              ++num_reused;
+            }
+        }
+
+      /* a contour made only of lines has the same tessellation
+         for all TessellationParams, so a remaining contour that
+         is the same object as the contour of prev at the same
+         index is copied from prev even if prev is a different
+         level of detail of the Path.
+       */
+      std::vector<bool> copy_contour(m_contour_data.size(), false);
+      if(prev != NULL)
+        {
+          for(unsigned int o = num_reused, endo = m_contour_data.size(); o < endo; ++o)
+            {
+              copy_contour[o] = o < prev->m_contour_data.size()
+                && m_contour_data[o].m_contour == prev->m_contour_data[o].m_contour
+                && m_contour_data[o].m_contour->is_flat();
+            }
+        }
+
+      /* gather the edges that are not reused, then tessellate
+         them (possibly in parallel) and finally concatenate the
+         results in contour and edge order.
+       */
+      for(unsigned int o = num_reused, endo = m_contour_data.size(); o < endo; ++o)
+        {
+          const fastuidraw::PathContour *contour(m_contour_data[o].m_contour.get());
+
+          m_edge_data[o].resize(contour->number_points());
+          if(copy_contour[o])
+            {
+              const std::vector<edge_data> &R(prev->m_edge_data[o]);
+              total_needed += R.back().m_range.m_end - R.front().m_range.m_begin;
+              continue;
+            }
 
-          m_edge_ranges[o].resize(contour->number_points());
           for(unsigned int e = 0, ende = contour->number_points(); e < ende; ++e)
             {
-              unsigned int needed;
-              float thresh_dist(0.0f), thresh_curvature(0.0f);
-
-              temp.push_back(std::vector<fastuidraw::TessellatedPath::point>());
-              needed = contour->interpolator(e)->produce_tessellation(m_params,
-                                                                      fastuidraw::make_c_array(work_room),
-                                                                      &thresh_dist,
-                                                                      &thresh_curvature);
-              m_edge_ranges[o][e] = fastuidraw::range_type<unsigned int>(loc, loc + needed);
-              loc += needed;
-
-              assert(needed > 0u);
-              m_max_segments = fastuidraw::t_max(m_max_segments, needed - 1);
-              m_effective_curve_distance_threshhold = fastuidraw::t_max(m_effective_curve_distance_threshhold, thresh_dist);
-              m_effective_curvature_threshhold = fastuidraw::t_max(m_effective_curvature_threshhold, thresh_curvature);
+              edges.push_back(edge(contour->curve_interpolator(e),
+                                   contour->point(e),
+                                   contour->point(e + 1 < ende ? e + 1 : 0)));
+            }
+        }
 
-              for(unsigned int n = 0; n < needed; ++n)
-                {
-                  const fastuidraw::vec2 &pt(work_room[n].m_p);
-
-                  work_room[n].m_distance_from_contour_start = contour_length + work_room[n].m_distance_from_edge_start;
-
-                  if(o == 0 and e == 0 and n == 0)
-                    {
-                      m_box_min = pt;
-                      m_box_max = pt;
-                    }
-                  else
-                    {
-                      m_box_min.x() = std::min(m_box_min.x(), pt.x());
-                      m_box_min.y() = std::min(m_box_min.y(), pt.y());
-                      m_box_max.x() = std::max(m_box_max.x(), pt.x());
-                      m_box_max.y() = std::max(m_box_max.y(), pt.y());
-                    }
-                }
-              std::list<std::vector<fastuidraw::TessellatedPath::point> >::iterator t;
-              t = temp.insert(temp.end(),
-                              std::vector<fastuidraw::TessellatedPath::point>(work_room.begin(), work_room.begin() + needed));
-              if(e == 0)
-                {
-                  start_contour = t;
-                }
+      tessellations.resize(edges.size());
+      tessellate_edges worker(m_params, edges, tessellations);
+      fastuidraw::run_in_parallel(edges.size(), m_params.m_max_threads,
+                                  min_edges_per_thread, worker);
 
-              contour_length = temp.back().back().m_distance_from_contour_start;
+      if(num_reused > 0)
+        {
+          total_needed += prev->m_edge_data[num_reused - 1].back().m_range.m_end;
+        }
+      for(unsigned int i = 0, endi = tessellations.size(); i < endi; ++i)
+        {
+          total_needed += tessellations[i].m_pts.size();
+        }
+      m_positions.reserve(total_needed);
+      m_derivatives.reserve(total_needed);
+      m_distances_from_edge_start.reserve(total_needed);
 
-              if(e + 2 == ende)
-                {
-                  open_contour_length = contour_length;
-                }
-              else if(e + 1 == ende)
+      if(num_reused > 0)
+        {
+          std::copy(prev->m_edge_data.begin(), prev->m_edge_data.begin() + num_reused,
+                    m_edge_data.begin());
+          std::copy(prev->m_contour_data.begin(), prev->m_contour_data.begin() + num_reused,
+                    m_contour_data.begin());
+          append_points(*prev, 0, m_edge_data[num_reused - 1].back().m_range.m_end);
+        }
+
+      for(unsigned int k = 0, o = num_reused, endo = m_edge_data.size(); o < endo; ++o)
+        {
+          float contour_length(0.0f);
+          unsigned int contour_start(number_points());
+          contour_data &C(m_contour_data[o]);
+
+          if(copy_contour[o])
+            {
+              const std::vector<edge_data> &R(prev->m_edge_data[o]);
+              unsigned int prev_start(R.front().m_range.m_begin);
+
+              for(unsigned int e = 0, ende = R.size(); e < ende; ++e)
                 {
-                  closed_contour_length = contour_length;
+                  m_edge_data[o][e] = R[e];
+                  m_edge_data[o][e].m_range.m_begin += contour_start - prev_start;
+                  m_edge_data[o][e].m_range.m_end += contour_start - prev_start;
                 }
+              append_points(*prev, prev_start, R.back().m_range.m_end);
+              C = prev->m_contour_data[o];
+              continue;
+            }
+
+          C.m_box_min = C.m_box_max = tessellations[k].m_pts.front().m_p;
+          for(unsigned int e = 0, ende = m_edge_data[o].size(); e < ende; ++e, ++k)
+            {
+              const edge_tessellation &T(tessellations[k]);
+              unsigned int needed(T.m_pts.size()), loc(number_points());
+              edge_data &E(m_edge_data[o][e]);
+
+              E.m_range = fastuidraw::range_type<unsigned int>(loc, loc + needed);
+              E.m_length = T.m_pts.back().m_distance_from_edge_start;
+              E.m_distance_from_contour_start = contour_length;
+              C.m_max_segments = fastuidraw::t_max(C.m_max_segments, needed - 1);
+              C.m_effective_curve_distance_threshhold = fastuidraw::t_max(C.m_effective_curve_distance_threshhold, T.m_thresh_dist);
+              C.m_effective_curvature_threshhold = fastuidraw::t_max(C.m_effective_curvature_threshhold, T.m_thresh_curvature);
 
               for(unsigned int n = 0; n < needed; ++n)
                 {
-                  (*t)[n].m_edge_length = (*t)[needed - 1].m_distance_from_edge_start;
+                  const fastuidraw::TessellatedPath::point &pt(T.m_pts[n]);
+
+                  C.m_box_min.x() = std::min(C.m_box_min.x(), pt.m_p.x());
+                  C.m_box_min.y() = std::min(C.m_box_min.y(), pt.m_p.y());
+                  C.m_box_max.x() = std::max(C.m_box_max.x(), pt.m_p.x());
+                  C.m_box_max.y() = std::max(C.m_box_max.y(), pt.m_p.y());
+                  append_point(pt);
                 }
-            }
 
-          for(std::list<std::vector<fastuidraw::TessellatedPath::point> >::iterator
-                t = start_contour, endt = temp.end(); t != endt; ++t)
-            {
-              for(unsigned int e = 0, ende = t->size(); e < ende; ++e)
+              contour_length += m_distances_from_edge_start.back();
+              if(e + 2 == ende)
+                {
+                  C.m_open_contour_length = contour_length;
+                }
+              else if(e + 1 == ende)
                 {
-                  (*t)[e].m_open_contour_length = open_contour_length;
-                  (*t)[e].m_closed_contour_length = closed_contour_length;
+                  C.m_closed_contour_length = contour_length;
                 }
             }
         }
+      assert(total_needed == number_points());
 
-      unsigned int total_needed;
-
-      total_needed = m_edge_ranges.back().back().m_end;
-      m_point_data.reserve(total_needed);
-      for(iter = temp.begin(), end_iter = temp.end(); iter != end_iter; ++iter)
+      m_box_min = m_contour_data[0].m_box_min;
+      m_box_max = m_contour_data[0].m_box_max;
+      for(unsigned int o = 0, endo = m_contour_data.size(); o < endo; ++o)
         {
-          std::copy(iter->begin(), iter->end(),
-                    std::back_insert_iterator<std::vector<fastuidraw::TessellatedPath::point> >(m_point_data));
+          const contour_data &C(m_contour_data[o]);
+
+          m_max_segments = fastuidraw::t_max(m_max_segments, C.m_max_segments);
+          m_effective_curve_distance_threshhold = fastuidraw::t_max(m_effective_curve_distance_threshhold,
+                                                                    C.m_effective_curve_distance_threshhold);
+          m_effective_curvature_threshhold = fastuidraw::t_max(m_effective_curvature_threshhold,
+                                                               C.m_effective_curvature_threshhold);
+          m_box_min.x() = std::min(m_box_min.x(), C.m_box_min.x());
+          m_box_min.y() = std::min(m_box_min.y(), C.m_box_min.y());
+          m_box_max.x() = std::max(m_box_max.x(), C.m_box_max.x());
+          m_box_max.y() = std::max(m_box_max.y(), C.m_box_max.y());
         }
-      assert(total_needed == m_point_data.size());
     }
   else
     {
@@ -161,31 +421,74 @@ TessellatedPathPrivate(const fastuidraw::Path &input,
     }
 }
 
+void
+TessellatedPathPrivate::
+append_points(const TessellatedPathPrivate &src,
+              unsigned int begin, unsigned int end)
+{
+  m_positions.insert(m_positions.end(),
+                     src.m_positions.begin() + begin,
+                     src.m_positions.begin() + end);
+  m_derivatives.insert(m_derivatives.end(),
+                       src.m_derivatives.begin() + begin,
+                       src.m_derivatives.begin() + end);
+  m_distances_from_edge_start.insert(m_distances_from_edge_start.end(),
+                                     src.m_distances_from_edge_start.begin() + begin,
+                                     src.m_distances_from_edge_start.begin() + end);
+}
+
 //////////////////////////////////////
 // fastuidraw::TessellatedPath methods
 fastuidraw::TessellatedPath::
 TessellatedPath(const Path &input,
                 fastuidraw::TessellatedPath::TessellationParams TP)
 {
-  m_d = FASTUIDRAWnew TessellatedPathPrivate(input, TP);
-  std::cout << "Created(max_segs = "
-            << max_segments()
-            << ", curve_distance = "
-            << effective_curve_distance_threshhold()
-            << ", curvature = "
-            << effective_curvature_threshhold()
-            << ", num_points = " << point_data().size() << ")\n";
+  m_d = FASTUIDRAWnew TessellatedPathPrivate(input, TP, NULL);
+  detail::memory_report_grow(memory::subsystem_tessellated_paths, number_bytes(), 0);
+}
+
+fastuidraw::TessellatedPath::
+TessellatedPath(const Path &input,
+                fastuidraw::TessellatedPath::TessellationParams TP,
+                const TessellatedPath &prev)
+{
+  TessellatedPathPrivate *prev_d;
+  prev_d = static_cast<TessellatedPathPrivate*>(prev.m_d);
+  m_d = FASTUIDRAWnew TessellatedPathPrivate(input, TP, prev_d);
+  detail::memory_report_grow(memory::subsystem_tessellated_paths, number_bytes(), 0);
 }
 
 fastuidraw::TessellatedPath::
 ~TessellatedPath()
 {
   TessellatedPathPrivate *d;
+
+  detail::memory_report_shrink(memory::subsystem_tessellated_paths, number_bytes(), 0);
   d = static_cast<TessellatedPathPrivate*>(m_d);
   FASTUIDRAWdelete(d);
   m_d = NULL;
 }
 
+unsigned int
+fastuidraw::TessellatedPath::
+number_bytes(void) const
+{
+  TessellatedPathPrivate *d;
+  unsigned int return_value;
+
+  d = static_cast<TessellatedPathPrivate*>(m_d);
+  return_value = sizeof(TessellatedPathPrivate)
+    + d->m_positions.capacity() * sizeof(vec2)
+    + d->m_derivatives.capacity() * sizeof(vec2)
+    + d->m_distances_from_edge_start.capacity() * sizeof(float)
+    + d->m_contour_data.capacity() * sizeof(contour_data);
+  for(unsigned int i = 0, endi = d->m_edge_data.size(); i < endi; ++i)
+    {
+      return_value += d->m_edge_data[i].capacity() * sizeof(edge_data);
+    }
+  return return_value;
+}
+
 const fastuidraw::reference_counted_ptr<const fastuidraw::StrokedPath>&
 fastuidraw::TessellatedPath::
 stroked(void) const
@@ -212,6 +515,38 @@ filled(void) const
   return d->m_filled;
 }
 
+const fastuidraw::reference_counted_ptr<const fastuidraw::FilledPath>&
+fastuidraw::TessellatedPath::
+filled(float tolerance) const
+{
+  TessellatedPathPrivate *d;
+  d = static_cast<TessellatedPathPrivate*>(m_d);
+
+  if(!(tolerance >= d->filled_lod_tolerance(0)) || d->filled_lod_tolerance(0) <= 0.0f)
+    {
+      return filled();
+    }
+
+  unsigned int k(0);
+  while(k + 1 < TessellatedPathPrivate::number_filled_lods
+        && d->filled_lod_tolerance(k + 1) <= tolerance)
+    {
+      ++k;
+    }
+
+  if(d->m_filled_lods.empty())
+    {
+      d->m_filled_lods.resize(TessellatedPathPrivate::number_filled_lods);
+    }
+
+  if(!d->m_filled_lods[k])
+    {
+      d->m_filled_lods[k] = FASTUIDRAWnew FilledPath(*this, FilledPath::default_triangulator(),
+                                                     d->filled_lod_tolerance(k));
+    }
+  return d->m_filled_lods[k];
+}
+
 const fastuidraw::TessellatedPath::TessellationParams&
 fastuidraw::TessellatedPath::
 tessellation_parameters(void) const
@@ -249,103 +584,167 @@ max_segments(void) const
   return d->m_max_segments;
 }
 
-fastuidraw::const_c_array<fastuidraw::TessellatedPath::point>
+unsigned int
 fastuidraw::TessellatedPath::
-point_data(void) const
+number_points(void) const
 {
   TessellatedPathPrivate *d;
   d = static_cast<TessellatedPathPrivate*>(m_d);
 
-  return make_c_array(d->m_point_data);
+  return d->number_points();
 }
 
-unsigned int
+fastuidraw::const_c_array<fastuidraw::vec2>
 fastuidraw::TessellatedPath::
-number_contours(void) const
+point_positions(void) const
 {
   TessellatedPathPrivate *d;
   d = static_cast<TessellatedPathPrivate*>(m_d);
 
-  return d->m_edge_ranges.size();
+  return make_c_array(d->m_positions);
 }
 
-fastuidraw::range_type<unsigned int>
+fastuidraw::const_c_array<fastuidraw::vec2>
 fastuidraw::TessellatedPath::
-contour_range(unsigned int contour) const
+point_derivatives(void) const
 {
   TessellatedPathPrivate *d;
   d = static_cast<TessellatedPathPrivate*>(m_d);
 
-  return range_type<unsigned int>(d->m_edge_ranges[contour].front().m_begin,
-                                  d->m_edge_ranges[contour].back().m_end);
+  return make_c_array(d->m_derivatives);
 }
 
-fastuidraw::range_type<unsigned int>
+fastuidraw::const_c_array<float>
 fastuidraw::TessellatedPath::
-unclosed_contour_range(unsigned int contour) const
+point_distances_from_edge_start(void) const
 {
   TessellatedPathPrivate *d;
   d = static_cast<TessellatedPathPrivate*>(m_d);
 
-  range_type<unsigned int> return_value;
-  unsigned int num_edges(number_edges(contour));
+  return make_c_array(d->m_distances_from_edge_start);
+}
 
-  return_value.m_begin = d->m_edge_ranges[contour].front().m_begin;
-  return_value.m_end = (num_edges > 1) ?
-    d->m_edge_ranges[contour][num_edges - 2].m_end:
-    d->m_edge_ranges[contour][num_edges - 1].m_end;
+fastuidraw::TessellatedPath::point
+fastuidraw::TessellatedPath::
+edge_point(unsigned int contour, unsigned int edge, unsigned int I) const
+{
+  TessellatedPathPrivate *d;
+  d = static_cast<TessellatedPathPrivate*>(m_d);
+
+  const edge_data &E(d->m_edge_data[contour][edge]);
+  const contour_data &C(d->m_contour_data[contour]);
+  point return_value;
+
+  assert(E.m_range.m_begin <= I && I < E.m_range.m_end);
+  return_value.m_p = d->m_positions[I];
+  return_value.m_p_t = d->m_derivatives[I];
+  return_value.m_distance_from_edge_start = d->m_distances_from_edge_start[I];
+  return_value.m_distance_from_contour_start = E.m_distance_from_contour_start
+    + return_value.m_distance_from_edge_start;
+  return_value.m_edge_length = E.m_length;
+  return_value.m_open_contour_length = C.m_open_contour_length;
+  return_value.m_closed_contour_length = C.m_closed_contour_length;
 
   return return_value;
 }
 
-fastuidraw::const_c_array<fastuidraw::TessellatedPath::point>
+float
+fastuidraw::TessellatedPath::
+edge_length(unsigned int contour, unsigned int edge) const
+{
+  TessellatedPathPrivate *d;
+  d = static_cast<TessellatedPathPrivate*>(m_d);
+
+  return d->m_edge_data[contour][edge].m_length;
+}
+
+float
+fastuidraw::TessellatedPath::
+edge_distance_from_contour_start(unsigned int contour, unsigned int edge) const
+{
+  TessellatedPathPrivate *d;
+  d = static_cast<TessellatedPathPrivate*>(m_d);
+
+  return d->m_edge_data[contour][edge].m_distance_from_contour_start;
+}
+
+float
 fastuidraw::TessellatedPath::
-contour_point_data(unsigned int contour) const
+open_contour_length(unsigned int contour) const
 {
   TessellatedPathPrivate *d;
   d = static_cast<TessellatedPathPrivate*>(m_d);
 
-  return make_c_array(d->m_point_data).sub_array(contour_range(contour));
+  return d->m_contour_data[contour].m_open_contour_length;
 }
 
-fastuidraw::const_c_array<fastuidraw::TessellatedPath::point>
+float
 fastuidraw::TessellatedPath::
-unclosed_contour_point_data(unsigned int contour) const
+closed_contour_length(unsigned int contour) const
 {
   TessellatedPathPrivate *d;
   d = static_cast<TessellatedPathPrivate*>(m_d);
 
-  return make_c_array(d->m_point_data).sub_array(unclosed_contour_range(contour));
+  return d->m_contour_data[contour].m_closed_contour_length;
 }
 
 unsigned int
 fastuidraw::TessellatedPath::
-number_edges(unsigned int contour) const
+number_contours(void) const
 {
   TessellatedPathPrivate *d;
   d = static_cast<TessellatedPathPrivate*>(m_d);
 
-  return d->m_edge_ranges[contour].size();
+  return d->m_edge_data.size();
 }
 
 fastuidraw::range_type<unsigned int>
 fastuidraw::TessellatedPath::
-edge_range(unsigned int contour, unsigned int edge) const
+contour_range(unsigned int contour) const
 {
   TessellatedPathPrivate *d;
   d = static_cast<TessellatedPathPrivate*>(m_d);
 
-  return d->m_edge_ranges[contour][edge];
+  return range_type<unsigned int>(d->m_edge_data[contour].front().m_range.m_begin,
+                                  d->m_edge_data[contour].back().m_range.m_end);
 }
 
-fastuidraw::const_c_array<fastuidraw::TessellatedPath::point>
+fastuidraw::range_type<unsigned int>
 fastuidraw::TessellatedPath::
-edge_point_data(unsigned int contour, unsigned int edge) const
+unclosed_contour_range(unsigned int contour) const
+{
+  TessellatedPathPrivate *d;
+  d = static_cast<TessellatedPathPrivate*>(m_d);
+
+  range_type<unsigned int> return_value;
+  unsigned int num_edges(number_edges(contour));
+
+  return_value.m_begin = d->m_edge_data[contour].front().m_range.m_begin;
+  return_value.m_end = (num_edges > 1) ?
+    d->m_edge_data[contour][num_edges - 2].m_range.m_end:
+    d->m_edge_data[contour][num_edges - 1].m_range.m_end;
+
+  return return_value;
+}
+
+unsigned int
+fastuidraw::TessellatedPath::
+number_edges(unsigned int contour) const
+{
+  TessellatedPathPrivate *d;
+  d = static_cast<TessellatedPathPrivate*>(m_d);
+
+  return d->m_edge_data[contour].size();
+}
+
+fastuidraw::range_type<unsigned int>
+fastuidraw::TessellatedPath::
+edge_range(unsigned int contour, unsigned int edge) const
 {
   TessellatedPathPrivate *d;
   d = static_cast<TessellatedPathPrivate*>(m_d);
 
-  return make_c_array(d->m_point_data).sub_array(edge_range(contour, edge));
+  return d->m_edge_data[contour][edge].m_range;
 }
 
 fastuidraw::vec2
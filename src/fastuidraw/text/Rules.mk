@@ -10,10 +10,13 @@ include $(dir)/Rules.mk
 LIBRARY_SOURCES += $(call filelist, glyph_atlas.cpp \
 	glyph_render_data.cpp \
 	glyph_render_data_curve_pair.cpp \
+	glyph_render_data_banded_curves.cpp \
 	glyph_render_data_distance_field.cpp \
+	glyph_render_data_msdf.cpp \
 	glyph_render_data_coverage.cpp \
 	glyph_cache.cpp glyph_selector.cpp \
 	freetype_font.cpp freetype_lib.cpp \
+	font_file_data.cpp font.cpp \
 	font_properties.cpp)
 
 # Begin standard footer
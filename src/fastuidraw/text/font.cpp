@@ -0,0 +1,37 @@
+/*!
+ * \file font.cpp
+ * \brief file font.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#include <fastuidraw/text/font.hpp>
+#include <fastuidraw/text/glyph_layout_data.hpp>
+#include "../private/util_private.hpp"
+
+void
+fastuidraw::FontBase::
+compute_layout_data(GlyphRender render, uint32_t glyph_code,
+                    GlyphLayoutData &layout) const
+{
+  GlyphRenderData *data;
+  Path path;
+
+  data = compute_rendering_data(render, glyph_code, layout, path);
+  if(data)
+    {
+      FASTUIDRAWdelete(data);
+    }
+}
@@ -0,0 +1,214 @@
+/*!
+ * \file font_file_data.cpp
+ * \brief file font_file_data.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <fastuidraw/text/font_file_data.hpp>
+#include "../private/util_private.hpp"
+
+namespace
+{
+  class FontFileDataPrivate
+  {
+  public:
+    explicit
+    FontFileDataPrivate(const char *filename);
+
+    ~FontFileDataPrivate();
+
+    std::string m_filename;
+
+    /* if m_mapped is non-NULL, the contents of the file
+       are the m_mapped_size bytes at m_mapped, otherwise
+       they are a copy in m_copy.
+     */
+    void *m_mapped;
+    size_t m_mapped_size;
+    std::vector<uint8_t> m_copy;
+    bool m_valid;
+
+  private:
+    bool
+    map_file(void);
+
+    bool
+    read_file(void);
+  };
+}
+
+///////////////////////////////////////
+// FontFileDataPrivate methods
+FontFileDataPrivate::
+FontFileDataPrivate(const char *filename):
+  m_filename(filename),
+  m_mapped(NULL),
+  m_mapped_size(0),
+  m_valid(false)
+{
+  m_valid = map_file() || read_file();
+}
+
+FontFileDataPrivate::
+~FontFileDataPrivate()
+{
+  #if !defined(_WIN32)
+    {
+      if(m_mapped != NULL)
+        {
+          munmap(m_mapped, m_mapped_size);
+        }
+    }
+  #endif
+}
+
+bool
+FontFileDataPrivate::
+map_file(void)
+{
+  #if !defined(_WIN32)
+    {
+      int fd;
+      struct stat st;
+      void *p;
+
+      fd = open(m_filename.c_str(), O_RDONLY);
+      if(fd < 0)
+        {
+          return false;
+        }
+
+      if(fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+          close(fd);
+          return false;
+        }
+
+      p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+      /* the mapping keeps the file referenced */
+      close(fd);
+      if(p == MAP_FAILED)
+        {
+          return false;
+        }
+
+      m_mapped = p;
+      m_mapped_size = st.st_size;
+      return true;
+    }
+  #else
+    {
+      return false;
+    }
+  #endif
+}
+
+bool
+FontFileDataPrivate::
+read_file(void)
+{
+  std::ifstream file(m_filename.c_str(), std::ios::binary);
+  if(!file)
+    {
+      return false;
+    }
+
+  file.seekg(0, std::ios::end);
+  std::streamoff sz(file.tellg());
+  if(sz <= 0)
+    {
+      return false;
+    }
+
+  file.seekg(0, std::ios::beg);
+  m_copy.resize(sz);
+  file.read(reinterpret_cast<char*>(&m_copy[0]), sz);
+  if(!file)
+    {
+      m_copy.clear();
+      return false;
+    }
+  return true;
+}
+
+///////////////////////////////////////
+// fastuidraw::FontFileData methods
+fastuidraw::FontFileData::
+FontFileData(const char *filename)
+{
+  m_d = FASTUIDRAWnew FontFileDataPrivate(filename);
+}
+
+fastuidraw::FontFileData::
+~FontFileData()
+{
+  FontFileDataPrivate *d;
+  d = static_cast<FontFileDataPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+bool
+fastuidraw::FontFileData::
+valid(void) const
+{
+  FontFileDataPrivate *d;
+  d = static_cast<FontFileDataPrivate*>(m_d);
+  return d->m_valid;
+}
+
+fastuidraw::const_c_array<uint8_t>
+fastuidraw::FontFileData::
+data(void) const
+{
+  FontFileDataPrivate *d;
+  d = static_cast<FontFileDataPrivate*>(m_d);
+  if(d->m_mapped != NULL)
+    {
+      return const_c_array<uint8_t>(static_cast<const uint8_t*>(d->m_mapped), d->m_mapped_size);
+    }
+  return make_c_array(d->m_copy);
+}
+
+const char*
+fastuidraw::FontFileData::
+filename(void) const
+{
+  FontFileDataPrivate *d;
+  d = static_cast<FontFileDataPrivate*>(m_d);
+  return d->m_filename.c_str();
+}
+
+bool
+fastuidraw::FontFileData::
+memory_mapped(void) const
+{
+  FontFileDataPrivate *d;
+  d = static_cast<FontFileDataPrivate*>(m_d);
+  return d->m_mapped != NULL;
+}
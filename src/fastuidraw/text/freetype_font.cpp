@@ -16,15 +16,23 @@
  *
  */
 
+#include <string>
+#include <vector>
+#include <cstring>
 #include <fastuidraw/text/freetype_font.hpp>
 #include <fastuidraw/text/glyph_layout_data.hpp>
 #include <fastuidraw/text/glyph_render_data.hpp>
 #include <fastuidraw/text/glyph_render_data_curve_pair.hpp>
+#include <fastuidraw/text/glyph_render_data_banded_curves.hpp>
 #include <fastuidraw/text/glyph_render_data_distance_field.hpp>
+#include <fastuidraw/text/glyph_render_data_msdf.hpp>
 #include <fastuidraw/text/glyph_render_data_coverage.hpp>
+#include <fastuidraw/util/task_executor.hpp>
 
 #include "private/freetype_util.hpp"
 #include "private/freetype_curvepair_util.hpp"
+#include "private/distance_transform.hpp"
+#include "private/msdf_generator.hpp"
 #include "../private/util_private.hpp"
 
 #include <ft2build.h>
@@ -54,18 +62,84 @@ namespace
     return v;
   }
 
+  /* Render the outline of the glyph loaded in face to image
+     at supersample times the resolution of the bitmap of the
+     glyph with padding pixels of padding on each side. The
+     values written are 1 for pixels covered at least half and
+     0 otherwise. The pixel (x, y) is at image[x + y * image_size.x()]
+     with y = 0 at the bottom. Modifies the outline of the glyph
+     slot of face.
+   */
+  void
+  render_supersampled_coverage(FT_Face face,
+                               const fastuidraw::ivec2 &bitmap_sz,
+                               const fastuidraw::ivec2 &bitmap_offset,
+                               int supersample, int padding,
+                               fastuidraw::ivec2 &image_size,
+                               std::vector<uint8_t> &image)
+  {
+    FT_Outline *outline(&face->glyph->outline);
+    FT_Matrix scale;
+    FT_Bitmap bitmap;
+    std::vector<uint8_t> buffer;
+
+    image_size = bitmap_sz * supersample + fastuidraw::ivec2(2 * padding, 2 * padding);
+    buffer.resize(image_size.x() * image_size.y(), 0);
+    image.resize(image_size.x() * image_size.y());
+
+    scale.xx = scale.yy = supersample << 16;
+    scale.xy = scale.yx = 0;
+    FT_Outline_Translate(outline, -64 * bitmap_offset.x(), -64 * bitmap_offset.y());
+    FT_Outline_Transform(outline, &scale);
+    FT_Outline_Translate(outline, 64 * padding, 64 * padding);
+
+    std::memset(&bitmap, 0, sizeof(bitmap));
+    bitmap.rows = image_size.y();
+    bitmap.width = image_size.x();
+    bitmap.pitch = image_size.x();
+    bitmap.buffer = &buffer[0];
+    bitmap.num_grays = 256;
+    bitmap.pixel_mode = FT_PIXEL_MODE_GRAY;
+    FT_Outline_Get_Bitmap(face->glyph->library, outline, &bitmap);
+
+    for(int y = 0; y < image_size.y(); ++y)
+      {
+        for(int x = 0; x < image_size.x(); ++x)
+          {
+            int read_location;
+
+            read_location = x + (image_size.y() - 1 - y) * image_size.x();
+            image[x + y * image_size.x()] = (buffer[read_location] >= 128) ? 1 : 0;
+          }
+      }
+  }
+
   class RenderParamsPrivate
   {
   public:
     RenderParamsPrivate(void):
       m_distance_field_pixel_size(48),
       m_distance_field_max_distance(96.0f),
-      m_curve_pair_pixel_size(32)
+      m_distance_field_generator(fastuidraw::FontFreeType::RenderParams::outline_distance_field_generator),
+      m_distance_field_supersample(5),
+      m_curve_pair_pixel_size(32),
+      m_banded_curves_pixel_size(64),
+      m_banded_curves_max_number_bands(8),
+      m_msdf_pixel_size(24),
+      m_msdf_max_distance(128.0f),
+      m_max_number_faces(0)
     {}
 
     unsigned int m_distance_field_pixel_size;
     float m_distance_field_max_distance;
+    enum fastuidraw::FontFreeType::RenderParams::distance_field_generator_t m_distance_field_generator;
+    unsigned int m_distance_field_supersample;
     unsigned int m_curve_pair_pixel_size;
+    unsigned int m_banded_curves_pixel_size;
+    unsigned int m_banded_curves_max_number_bands;
+    unsigned int m_msdf_pixel_size;
+    float m_msdf_max_distance;
+    unsigned int m_max_number_faces;
   };
 
   class PathCreator
@@ -107,6 +181,84 @@ namespace
     bool m_started;
   };
 
+  /* Collects the curves of an FT_Outline as quadratic
+     curves in pixel coordinates; cubic curves are
+     approximated by two quadratic curves. If contour_starts
+     is non-NULL, the index into curves of the first curve
+     of each contour is appended to it.
+   */
+  class BandedCurvesCreator
+  {
+  public:
+    static
+    void
+    decompose(FT_Outline *outline,
+              std::vector<fastuidraw::GlyphRenderDataBandedCurves::curve> &curves,
+              std::vector<unsigned int> *contour_starts = NULL);
+
+  private:
+    BandedCurvesCreator(std::vector<fastuidraw::GlyphRenderDataBandedCurves::curve> &curves,
+                        std::vector<unsigned int> *contour_starts):
+      m_curves(curves),
+      m_contour_starts(contour_starts)
+    {}
+
+    static
+    int
+    ft_outline_move_to(const FT_Vector *pt, void *user);
+
+    static
+    int
+    ft_outline_line_to(const FT_Vector *pt, void *user);
+
+    static
+    int
+    ft_outline_conic_to(const FT_Vector *control_pt,
+                        const FT_Vector *pt, void *user);
+
+    static
+    int
+    ft_outline_cubic_to(const FT_Vector *control_pt1,
+                        const FT_Vector *control_pt2,
+                        const FT_Vector *pt, void *user);
+
+    static
+    fastuidraw::vec2
+    make_vec2(const FT_Vector &pt)
+    {
+      return fastuidraw::vec2(to_pixel_sizes(pt.x), to_pixel_sizes(pt.y));
+    }
+
+    std::vector<fastuidraw::GlyphRenderDataBandedCurves::curve> &m_curves;
+    std::vector<unsigned int> *m_contour_starts;
+    fastuidraw::vec2 m_pt;
+  };
+
+  /* Feeds the contours of an FT_Outline to a MSDFGenerator
+     as quadratic curves in pixel coordinates; the curves are
+     those of BandedCurvesCreator, taken one contour at a time.
+   */
+  void
+  decompose_to_msdf_generator(FT_Outline *outline,
+                              fastuidraw::detail::MSDFGenerator &generator)
+  {
+    std::vector<fastuidraw::GlyphRenderDataBandedCurves::curve> curves;
+    std::vector<unsigned int> contour_starts;
+
+    BandedCurvesCreator::decompose(outline, curves, &contour_starts);
+    for(unsigned int c = 0; c < contour_starts.size(); ++c)
+      {
+        unsigned int end;
+
+        end = (c + 1 < contour_starts.size()) ? contour_starts[c + 1] : curves.size();
+        generator.begin_contour();
+        for(unsigned int i = contour_starts[c]; i < end; ++i)
+          {
+            generator.add_curve(curves[i].m_p0, curves[i].m_p1, curves[i].m_p2);
+          }
+      }
+  }
+
   bool
   operator==(const FT_Vector &lhs, const FT_Vector &rhs)
   {
@@ -128,17 +280,57 @@ namespace
     void
     common_init(void);
 
+    /* Returns an FT_Face that no other thread uses until
+       it is passed to release_face(): m_face if it is free,
+       otherwise a free face of m_free_faces, otherwise a
+       newly opened face if there are fewer than
+       max_number_faces() faces, otherwise m_face once it
+       is freed.
+     */
+    FT_Face
+    acquire_face(void);
+
+    void
+    release_face(FT_Face face);
+
+    /* open another FT_Face from the file data of the
+       font, returns NULL on failure.
+     */
+    FT_Face
+    open_face(void);
+
     void
-    common_compute_rendering_data(int pixel_size, FT_Int32 load_flags,
+    common_compute_rendering_data(FT_Face face,
+                                  int pixel_size, FT_Int32 load_flags,
                                   fastuidraw::GlyphLayoutData &layout,
                                   uint32_t glyph_code);
 
+    /* translates the outline of the glyph loaded into face
+       by subpixel_offset / GlyphRender::number_subpixel_offsets
+       pixels along x and changes the horizontal layout of
+       layout to the pixels covered by the translated outline.
+     */
+    void
+    apply_subpixel_offset(FT_Face face, int subpixel_offset,
+                          fastuidraw::GlyphLayoutData &layout);
+
     void
-    compute_rendering_data(int pixel_size, uint32_t glyph_code,
+    compute_rendering_data(int pixel_size, int subpixel_offset,
+                           uint32_t glyph_code,
                            fastuidraw::GlyphLayoutData &layout,
                            fastuidraw::GlyphRenderDataCoverage &output,
                            fastuidraw::Path &path);
 
+    /* computes the same GlyphLayoutData as compute_rendering_data()
+       with the same pixel size, load flags and subpixel offset,
+       without rendering
+     */
+    void
+    compute_layout_data(int pixel_size, FT_Int32 load_flags,
+                        uint32_t glyph_code,
+                        fastuidraw::GlyphLayoutData &layout,
+                        int subpixel_offset = 0);
+
     void
     compute_rendering_data(uint32_t glyph_code,
                            fastuidraw::GlyphLayoutData &layout,
@@ -151,11 +343,42 @@ namespace
                            fastuidraw::GlyphRenderDataCurvePair &output,
                            fastuidraw::Path &path);
 
+    void
+    compute_rendering_data(uint32_t glyph_code,
+                           fastuidraw::GlyphLayoutData &layout,
+                           fastuidraw::GlyphRenderDataBandedCurves &output,
+                           fastuidraw::Path &path);
+
+    void
+    compute_rendering_data(uint32_t glyph_code,
+                           fastuidraw::GlyphLayoutData &layout,
+                           fastuidraw::GlyphRenderDataMSDF &output,
+                           fastuidraw::Path &path);
+
+    /* m_mutex is locked while m_face is used
+     */
     fastuidraw::mutex m_mutex;
     FT_Face m_face;
     fastuidraw::FontFreeType::RenderParams m_render_params;
     fastuidraw::reference_counted_ptr<fastuidraw::FreetypeLib> m_lib;
     fastuidraw::FontFreeType *m_p;
+
+    /* file data and face index from which m_face was
+       loaded; m_file_data is NULL if more faces cannot
+       be opened. Every face opened from m_file_data
+       references its memory, so m_file_data is to
+       outlive the faces.
+     */
+    fastuidraw::reference_counted_ptr<const fastuidraw::FontFileData> m_file_data;
+    int m_face_index;
+
+    /* additional faces that are not in use, the number
+       of faces open (including m_face) and the mutex
+       that protects both.
+     */
+    fastuidraw::mutex m_faces_mutex;
+    std::vector<FT_Face> m_free_faces;
+    unsigned int m_number_faces;
   };
 }
 
@@ -278,6 +501,100 @@ ft_outline_cubic_to(const FT_Vector *ct1,
 }
 
 
+//////////////////////////////////////////
+// BandedCurvesCreator methods
+void
+BandedCurvesCreator::
+decompose(FT_Outline *outline,
+          std::vector<fastuidraw::GlyphRenderDataBandedCurves::curve> &curves,
+          std::vector<unsigned int> *contour_starts)
+{
+  BandedCurvesCreator datum(curves, contour_starts);
+  FT_Outline_Funcs funcs;
+
+  funcs.move_to = &ft_outline_move_to;
+  funcs.line_to = &ft_outline_line_to;
+  funcs.conic_to = &ft_outline_conic_to;
+  funcs.cubic_to = &ft_outline_cubic_to;
+  funcs.shift = 0;
+  funcs.delta = 0;
+  FT_Outline_Decompose(outline, &funcs, &datum);
+}
+
+int
+BandedCurvesCreator::
+ft_outline_move_to(const FT_Vector *pt, void *user)
+{
+  BandedCurvesCreator *p;
+  p = static_cast<BandedCurvesCreator*>(user);
+  p->m_pt = make_vec2(*pt);
+  if(p->m_contour_starts)
+    {
+      p->m_contour_starts->push_back(p->m_curves.size());
+    }
+  return 0;
+}
+
+int
+BandedCurvesCreator::
+ft_outline_line_to(const FT_Vector *pt, void *user)
+{
+  BandedCurvesCreator *p;
+  fastuidraw::vec2 p2(make_vec2(*pt));
+
+  p = static_cast<BandedCurvesCreator*>(user);
+  if(p2 != p->m_pt)
+    {
+      p->m_curves.push_back(fastuidraw::GlyphRenderDataBandedCurves::curve(p->m_pt, p2));
+      p->m_pt = p2;
+    }
+  return 0;
+}
+
+int
+BandedCurvesCreator::
+ft_outline_conic_to(const FT_Vector *ct,
+                    const FT_Vector *pt, void *user)
+{
+  BandedCurvesCreator *p;
+  fastuidraw::vec2 p2(make_vec2(*pt));
+
+  p = static_cast<BandedCurvesCreator*>(user);
+  p->m_curves.push_back(fastuidraw::GlyphRenderDataBandedCurves::curve(p->m_pt, make_vec2(*ct), p2));
+  p->m_pt = p2;
+  return 0;
+}
+
+int
+BandedCurvesCreator::
+ft_outline_cubic_to(const FT_Vector *ct1,
+                    const FT_Vector *ct2,
+                    const FT_Vector *pt, void *user)
+{
+  BandedCurvesCreator *p;
+  fastuidraw::vec2 p0, c1(make_vec2(*ct1)), c2(make_vec2(*ct2)), p3(make_vec2(*pt));
+  fastuidraw::vec2 c01, c12, c23, c012, c123, mid;
+
+  p = static_cast<BandedCurvesCreator*>(user);
+  p0 = p->m_pt;
+
+  /* split the cubic at t = 0.5 and approximate each half
+     by the quadratic whose control point is the average of
+     the extrapolated control points of the half.
+   */
+  c01 = 0.5f * (p0 + c1);
+  c12 = 0.5f * (c1 + c2);
+  c23 = 0.5f * (c2 + p3);
+  c012 = 0.5f * (c01 + c12);
+  c123 = 0.5f * (c12 + c23);
+  mid = 0.5f * (c012 + c123);
+
+  p->m_curves.push_back(fastuidraw::GlyphRenderDataBandedCurves::curve(p0, 0.25f * (3.0f * (c01 + c012) - p0 - mid), mid));
+  p->m_curves.push_back(fastuidraw::GlyphRenderDataBandedCurves::curve(mid, 0.25f * (3.0f * (c123 + c23) - mid - p3), p3));
+  p->m_pt = p3;
+  return 0;
+}
+
 //////////////////////////////////////////////////
 // FontFreeTypePrivate methods
 FontFreeTypePrivate::
@@ -285,7 +602,9 @@ FontFreeTypePrivate(fastuidraw::FontFreeType *p, FT_Face pface,
                     const fastuidraw::FontFreeType::RenderParams &render_params):
   m_face(pface),
   m_render_params(render_params),
-  m_p(p)
+  m_p(p),
+  m_face_index(0),
+  m_number_faces(1)
 {
   common_init();
 }
@@ -297,7 +616,9 @@ FontFreeTypePrivate(fastuidraw::FontFreeType *p, FT_Face pface,
   m_face(pface),
   m_render_params(render_params),
   m_lib(lib),
-  m_p(p)
+  m_p(p),
+  m_face_index(0),
+  m_number_faces(1)
 {
   common_init();
 }
@@ -307,8 +628,15 @@ FontFreeTypePrivate::
 {
   if(m_lib)
     {
+      m_lib->lock();
       FT_Done_Face(m_face);
+      for(unsigned int i = 0, endi = m_free_faces.size(); i < endi; ++i)
+        {
+          FT_Done_Face(m_free_faces[i]);
+        }
+      m_lib->unlock();
     }
+  assert(m_free_faces.size() + 1 == m_number_faces || !m_lib);
 }
 
 void
@@ -320,25 +648,123 @@ common_init(void)
   FT_Set_Transform(m_face, NULL, NULL);
 }
 
+FT_Face
+FontFreeTypePrivate::
+open_face(void)
+{
+  FT_Face face(NULL);
+  int error_code;
+
+  m_lib->lock();
+  error_code = FT_New_Memory_Face(m_lib->lib(),
+                                  m_file_data->data().c_ptr(),
+                                  m_file_data->data().size(),
+                                  m_face_index, &face);
+  if(error_code != 0 && face != NULL)
+    {
+      FT_Done_Face(face);
+      face = NULL;
+    }
+  m_lib->unlock();
+
+  if(face != NULL)
+    {
+      FT_Set_Transform(face, NULL, NULL);
+    }
+  return face;
+}
+
+FT_Face
+FontFreeTypePrivate::
+acquire_face(void)
+{
+  if(m_mutex.try_lock())
+    {
+      return m_face;
+    }
+
+  bool open_new_face(false);
+  FT_Face face(NULL);
+
+  m_faces_mutex.lock();
+  if(!m_free_faces.empty())
+    {
+      face = m_free_faces.back();
+      m_free_faces.pop_back();
+    }
+  else if(m_file_data && m_lib)
+    {
+      unsigned int max_faces(m_render_params.max_number_faces());
+      if(max_faces == 0)
+        {
+          max_faces = std::max(1u, fastuidraw::default_task_executor()->number_threads());
+        }
+
+      if(m_number_faces < max_faces)
+        {
+          open_new_face = true;
+          ++m_number_faces;
+        }
+    }
+  m_faces_mutex.unlock();
+
+  if(open_new_face)
+    {
+      face = open_face();
+      if(face == NULL)
+        {
+          /* do not attempt again to open faces
+             if opening the file failed.
+           */
+          fastuidraw::autolock_mutex m(m_faces_mutex);
+          --m_number_faces;
+          m_file_data = fastuidraw::reference_counted_ptr<const fastuidraw::FontFileData>();
+        }
+    }
+
+  if(face == NULL)
+    {
+      m_mutex.lock();
+      face = m_face;
+    }
+  return face;
+}
+
+void
+FontFreeTypePrivate::
+release_face(FT_Face face)
+{
+  if(face == m_face)
+    {
+      m_mutex.unlock();
+    }
+  else
+    {
+      fastuidraw::autolock_mutex m(m_faces_mutex);
+      m_free_faces.push_back(face);
+    }
+}
+
 void
 FontFreeTypePrivate::
-common_compute_rendering_data(int pixel_size, FT_Int32 load_flags,
+common_compute_rendering_data(FT_Face face,
+                              int pixel_size, FT_Int32 load_flags,
                               fastuidraw::GlyphLayoutData &output,
                               uint32_t glyph_code)
 {
   fastuidraw::ivec2 bitmap_sz, bitmap_offset, iadvance;
 
-  FT_Set_Pixel_Sizes(m_face, pixel_size, pixel_size);
-  FT_Load_Glyph(m_face, glyph_code, load_flags);
-
-  output.m_size.x() = to_pixel_sizes(m_face->glyph->metrics.width);
-  output.m_size.y() = to_pixel_sizes(m_face->glyph->metrics.height);
-  output.m_horizontal_layout_offset.x() = to_pixel_sizes(m_face->glyph->metrics.horiBearingX);
-  output.m_horizontal_layout_offset.y() = to_pixel_sizes(m_face->glyph->metrics.horiBearingY) - output.m_size.y();
-  output.m_vertical_layout_offset.x() = to_pixel_sizes(m_face->glyph->metrics.vertBearingX);
-  output.m_vertical_layout_offset.y() = to_pixel_sizes(m_face->glyph->metrics.vertBearingY) - output.m_size.y();
-  output.m_advance.x() = to_pixel_sizes(m_face->glyph->metrics.horiAdvance);
-  output.m_advance.y() = to_pixel_sizes(m_face->glyph->metrics.vertAdvance);
+  FT_Set_Pixel_Sizes(face, pixel_size, pixel_size);
+  FT_Load_Glyph(face, glyph_code, load_flags);
+
+  output.m_size.x() = to_pixel_sizes(face->glyph->metrics.width);
+  output.m_size.y() = to_pixel_sizes(face->glyph->metrics.height);
+  output.m_horizontal_layout_offset.x() = to_pixel_sizes(face->glyph->metrics.horiBearingX);
+  output.m_horizontal_layout_offset.y() = to_pixel_sizes(face->glyph->metrics.horiBearingY) - output.m_size.y();
+  output.m_vertical_layout_offset.x() = to_pixel_sizes(face->glyph->metrics.vertBearingX);
+  output.m_vertical_layout_offset.y() = to_pixel_sizes(face->glyph->metrics.vertBearingY) - output.m_size.y();
+  output.m_advance.x() = to_pixel_sizes(face->glyph->metrics.horiAdvance);
+  output.m_advance.y() = to_pixel_sizes(face->glyph->metrics.vertAdvance);
   output.m_glyph_code = glyph_code;
   output.m_pixel_size = pixel_size;
   output.m_font = m_p;
@@ -346,20 +772,70 @@ common_compute_rendering_data(int pixel_size, FT_Int32 load_flags,
 
 void
 FontFreeTypePrivate::
-compute_rendering_data(int pixel_size, uint32_t glyph_code,
+apply_subpixel_offset(FT_Face face, int subpixel_offset,
+                      fastuidraw::GlyphLayoutData &layout)
+{
+  FT_BBox cbox;
+  FT_Pos x_min, x_max;
+
+  /* bitmap glyphs cannot be moved by a fraction of a pixel */
+  if(subpixel_offset == 0 || face->glyph->format != FT_GLYPH_FORMAT_OUTLINE)
+    {
+      return;
+    }
+
+  /* FT_Render_Glyph places the bitmap at the pixels covered
+     by the control box of the outline, with the origin of the
+     glyph at a pixel boundary.
+   */
+  FT_Outline_Translate(&face->glyph->outline,
+                       (64 * subpixel_offset) / fastuidraw::GlyphRender::number_subpixel_offsets,
+                       0);
+  FT_Outline_Get_CBox(&face->glyph->outline, &cbox);
+  x_min = cbox.xMin & ~63;
+  x_max = (cbox.xMax + 63) & ~63;
+  layout.m_horizontal_layout_offset.x() = to_pixel_sizes(x_min);
+  layout.m_size.x() = to_pixel_sizes(x_max - x_min);
+}
+
+void
+FontFreeTypePrivate::
+compute_layout_data(int pixel_size, FT_Int32 load_flags,
+                    uint32_t glyph_code,
+                    fastuidraw::GlyphLayoutData &layout,
+                    int subpixel_offset)
+{
+  FT_Face face;
+
+  face = acquire_face();
+  common_compute_rendering_data(face, pixel_size, load_flags, layout, glyph_code);
+  apply_subpixel_offset(face, subpixel_offset, layout);
+  release_face(face);
+}
+
+void
+FontFreeTypePrivate::
+compute_rendering_data(int pixel_size, int subpixel_offset,
+                       uint32_t glyph_code,
                        fastuidraw::GlyphLayoutData &layout,
                        fastuidraw::GlyphRenderDataCoverage &output,
                        fastuidraw::Path &path)
 {
   fastuidraw::ivec2 bitmap_sz;
-  fastuidraw::autolock_mutex m(m_mutex);
+  FT_Face face;
 
-  common_compute_rendering_data(pixel_size, FT_LOAD_DEFAULT, layout, glyph_code);
-  PathCreator::decompose_to_path(&m_face->glyph->outline, path);
-  FT_Render_Glyph(m_face->glyph, FT_RENDER_MODE_NORMAL);
+  face = acquire_face();
+  common_compute_rendering_data(face, pixel_size, FT_LOAD_DEFAULT, layout, glyph_code);
 
-  bitmap_sz.x() = m_face->glyph->bitmap.width;
-  bitmap_sz.y() = m_face->glyph->bitmap.rows;
+  /* the path is of the glyph at the pixel boundary,
+     i.e. without the subpixel offset
+   */
+  PathCreator::decompose_to_path(&face->glyph->outline, path);
+  apply_subpixel_offset(face, subpixel_offset, layout);
+  FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL);
+
+  bitmap_sz.x() = face->glyph->bitmap.width;
+  bitmap_sz.y() = face->glyph->bitmap.rows;
 
   /* add one pixel slack on glyph
    */
@@ -367,7 +843,7 @@ compute_rendering_data(int pixel_size, uint32_t glyph_code,
     {
       int pitch;
 
-      pitch = m_face->glyph->bitmap.pitch;
+      pitch = face->glyph->bitmap.pitch;
       output.resize(bitmap_sz + fastuidraw::ivec2(1, 1));
       std::fill(output.coverage_values().begin(), output.coverage_values().end(), 0);
       for(int y = 0; y < bitmap_sz.y(); ++y)
@@ -378,7 +854,7 @@ compute_rendering_data(int pixel_size, uint32_t glyph_code,
 
               write_location = x + y * output.resolution().x();
               read_location = x + (bitmap_sz.y() - 1 - y) * pitch;
-              output.coverage_values()[write_location] = m_face->glyph->bitmap.buffer[read_location];
+              output.coverage_values()[write_location] = face->glyph->bitmap.buffer[read_location];
             }
         }
     }
@@ -386,6 +862,7 @@ compute_rendering_data(int pixel_size, uint32_t glyph_code,
     {
       output.resize(fastuidraw::ivec2(0, 0));
     }
+  release_face(face);
 }
 
 void
@@ -397,25 +874,41 @@ compute_rendering_data(uint32_t glyph_code,
 {
   int pixel_size(m_render_params.distance_field_pixel_size());
   float max_distance(m_render_params.distance_field_max_distance());
-  fastuidraw::ivec2 bitmap_sz, bitmap_offset;
+  bool use_distance_transform(m_render_params.distance_field_generator()
+                              == fastuidraw::FontFreeType::RenderParams::distance_transform_distance_field_generator);
+  int supersample(std::max(1u, m_render_params.distance_field_supersample()));
+  fastuidraw::ivec2 bitmap_sz, bitmap_offset, image_size;
+  std::vector<uint8_t> image;
+  FT_Face face;
 
   std::vector<fastuidraw::detail::point_type> pts;
   std::ostream *stream_ptr(NULL);
   fastuidraw::detail::geometry_data dbg(stream_ptr, pts);
 
-  m_mutex.lock();
+  face = acquire_face();
+
+    common_compute_rendering_data(face, pixel_size, FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING, layout, glyph_code);
+    FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL);
 
-    common_compute_rendering_data(pixel_size, FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING, layout, glyph_code);
-    FT_Render_Glyph(m_face->glyph, FT_RENDER_MODE_NORMAL);
+    bitmap_sz.x() = face->glyph->bitmap.width;
+    bitmap_sz.y() = face->glyph->bitmap.rows;
+    bitmap_offset.x() = face->glyph->bitmap_left;
+    bitmap_offset.y() = face->glyph->bitmap_top - face->glyph->bitmap.rows;
 
-    bitmap_sz.x() = m_face->glyph->bitmap.width;
-    bitmap_sz.y() = m_face->glyph->bitmap.rows;
-    bitmap_offset.x() = m_face->glyph->bitmap_left;
-    bitmap_offset.y() = m_face->glyph->bitmap_top - m_face->glyph->bitmap.rows;
+    fastuidraw::detail::OutlineData outline_data(face->glyph->outline, bitmap_sz, bitmap_offset, dbg);
 
-    fastuidraw::detail::OutlineData outline_data(m_face->glyph->outline, bitmap_sz, bitmap_offset, dbg);
+    if(use_distance_transform && bitmap_sz.x() != 0 && bitmap_sz.y() != 0)
+      {
+        /* pad the supersampled bitmap by a texel on each side so that the
+           distance from the texels on the boundary of the glyph to
+           outside of the glyph is not clipped.
+         */
+        render_supersampled_coverage(face, bitmap_sz, bitmap_offset,
+                                     supersample, supersample,
+                                     image_size, image);
+      }
 
-  m_mutex.unlock();
+  release_face(face);
 
   outline_data.extract_path(path);
   if(bitmap_sz.x() != 0 && bitmap_sz.y() != 0)
@@ -424,24 +917,68 @@ compute_rendering_data(uint32_t glyph_code,
        */
       output.resize(bitmap_sz + fastuidraw::ivec2(1, 1));
       std::fill(output.distance_values().begin(), output.distance_values().end(), 0);
-      boost::multi_array<fastuidraw::detail::distance_return_type, 2> distance_values(boost::extents[bitmap_sz.x()][bitmap_sz.y()]);
 
-      outline_data.compute_distance_values(distance_values, max_distance, true);
-      for(int y = 0; y < bitmap_sz.y(); ++y)
+      if(use_distance_transform)
         {
-          for(int x = 0; x < bitmap_sz.x(); ++x)
+          fastuidraw::detail::DistanceTransform transform;
+          std::vector<float> distances(bitmap_sz.x() * bitmap_sz.y());
+          fastuidraw::ivec2 sample_start(supersample + (supersample - 1) / 2);
+          float to_distance_units(64.0f / static_cast<float>(supersample));
+          int search_radius;
+
+          /* only the distances up to max_distance matter, the +1 is for
+             the half pixel taken below.
+           */
+          search_radius = 1 + static_cast<int>(std::ceil(max_distance / to_distance_units));
+          transform.compute(image_size, fastuidraw::const_c_array<uint8_t>(&image[0], image.size()),
+                            sample_start, supersample, bitmap_sz, search_radius,
+                            fastuidraw::c_array<float>(&distances[0], distances.size()));
+
+          for(int y = 0; y < bitmap_sz.y(); ++y)
             {
-              int location;
-              bool outside;
-              float v0;
+              for(int x = 0; x < bitmap_sz.x(); ++x)
+                {
+                  int location, sample_location;
+                  bool outside;
+                  float v0;
+
+                  location = x + y * output.resolution().x();
+                  sample_location = sample_start.x() + x * supersample
+                    + (sample_start.y() + y * supersample) * image_size.x();
+                  outside = (image[sample_location] == 0);
+
+                  /* the transform gives the distance to the center of the
+                     nearest pixel of the other side, the boundary is
+                     (about) half a pixel closer.
+                   */
+                  v0 = std::max(0.0f, distances[x + y * bitmap_sz.x()] - 0.5f) * to_distance_units;
+                  v0 = std::min(v0 / max_distance, 1.0f);
+
+                  output.distance_values()[location] = pixel_value_from_distance(v0, outside);
+                }
+            }
+        }
+      else
+        {
+          boost::multi_array<fastuidraw::detail::distance_return_type, 2> distance_values(boost::extents[bitmap_sz.x()][bitmap_sz.y()]);
 
-              location = x + y * output.resolution().x();
-              outside = (distance_values[x][y].m_solution_count.winding_number() == 0);
+          outline_data.compute_distance_values(distance_values, max_distance, true);
+          for(int y = 0; y < bitmap_sz.y(); ++y)
+            {
+              for(int x = 0; x < bitmap_sz.x(); ++x)
+                {
+                  int location;
+                  bool outside;
+                  float v0;
+
+                  location = x + y * output.resolution().x();
+                  outside = (distance_values[x][y].m_solution_count.winding_number() == 0);
 
-              v0 = distance_values[x][y].m_distance.value();
-              v0 = std::min(v0 / max_distance, 1.0f);
+                  v0 = distance_values[x][y].m_distance.value();
+                  v0 = std::min(v0 / max_distance, 1.0f);
 
-              output.distance_values()[location] = pixel_value_from_distance(v0, outside);
+                  output.distance_values()[location] = pixel_value_from_distance(v0, outside);
+                }
             }
         }
     }
@@ -460,21 +997,117 @@ compute_rendering_data(uint32_t glyph_code,
 {
   int pixel_size(m_render_params.curve_pair_pixel_size());
   fastuidraw::ivec2 bitmap_offset, bitmap_sz;
-
-  m_mutex.lock();
-    common_compute_rendering_data(pixel_size, FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING, layout, glyph_code);
-    FT_Render_Glyph(m_face->glyph, FT_RENDER_MODE_NORMAL);
-    bitmap_sz.x() = m_face->glyph->bitmap.width;
-    bitmap_sz.y() = m_face->glyph->bitmap.rows;
-    bitmap_offset.x() = m_face->glyph->bitmap_left;
-    bitmap_offset.y() = m_face->glyph->bitmap_top - m_face->glyph->bitmap.rows;
-    fastuidraw::detail::CurvePairGenerator gen(m_face->glyph->outline, bitmap_sz, bitmap_offset, output);
-  m_mutex.unlock();
+  FT_Face face;
+
+  face = acquire_face();
+    common_compute_rendering_data(face, pixel_size, FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING, layout, glyph_code);
+    FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL);
+    bitmap_sz.x() = face->glyph->bitmap.width;
+    bitmap_sz.y() = face->glyph->bitmap.rows;
+    bitmap_offset.x() = face->glyph->bitmap_left;
+    bitmap_offset.y() = face->glyph->bitmap_top - face->glyph->bitmap.rows;
+    fastuidraw::detail::CurvePairGenerator gen(face->glyph->outline, bitmap_sz, bitmap_offset, output);
+  release_face(face);
 
   gen.extract_data(output);
   gen.extract_path(path);
 }
 
+void
+FontFreeTypePrivate::
+compute_rendering_data(uint32_t glyph_code,
+                       fastuidraw::GlyphLayoutData &layout,
+                       fastuidraw::GlyphRenderDataBandedCurves &output,
+                       fastuidraw::Path &path)
+{
+  int pixel_size(m_render_params.banded_curves_pixel_size());
+  int max_bands(std::max(1u, m_render_params.banded_curves_max_number_bands()));
+  std::vector<fastuidraw::GlyphRenderDataBandedCurves::curve> curves;
+  fastuidraw::ivec2 number_bands(0, 0);
+  FT_Face face;
+
+  face = acquire_face();
+    common_compute_rendering_data(face, pixel_size, FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING, layout, glyph_code);
+    PathCreator::decompose_to_path(&face->glyph->outline, path);
+    BandedCurvesCreator::decompose(&face->glyph->outline, curves);
+  release_face(face);
+
+  if(!curves.empty() && layout.m_size.x() > 0.0f && layout.m_size.y() > 0.0f)
+    {
+      fastuidraw::vec2 scale;
+      int n;
+
+      /* map the box of the glyph, which is the box of
+         the quad drawn for the glyph, to the bands.
+       */
+      n = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(curves.size()))));
+      n = std::min(max_bands, n);
+      number_bands = fastuidraw::ivec2(n, n);
+      scale = fastuidraw::vec2(number_bands) / layout.m_size;
+      for(unsigned int i = 0; i < curves.size(); ++i)
+        {
+          curves[i].m_p0 = (curves[i].m_p0 - layout.m_horizontal_layout_offset) * scale;
+          curves[i].m_p1 = (curves[i].m_p1 - layout.m_horizontal_layout_offset) * scale;
+          curves[i].m_p2 = (curves[i].m_p2 - layout.m_horizontal_layout_offset) * scale;
+        }
+    }
+  else
+    {
+      curves.clear();
+    }
+
+  output.set_curves(number_bands,
+                    curves.empty() ?
+                    fastuidraw::const_c_array<fastuidraw::GlyphRenderDataBandedCurves::curve>() :
+                    fastuidraw::const_c_array<fastuidraw::GlyphRenderDataBandedCurves::curve>(&curves[0], curves.size()));
+}
+
+void
+FontFreeTypePrivate::
+compute_rendering_data(uint32_t glyph_code,
+                       fastuidraw::GlyphLayoutData &layout,
+                       fastuidraw::GlyphRenderDataMSDF &output,
+                       fastuidraw::Path &path)
+{
+  int pixel_size(m_render_params.msdf_pixel_size());
+  float max_distance(std::max(1.0f, m_render_params.msdf_max_distance()) / 64.0f);
+  fastuidraw::ivec2 bitmap_sz, bitmap_offset;
+  fastuidraw::detail::MSDFGenerator generator;
+  FT_Face face;
+
+  face = acquire_face();
+    common_compute_rendering_data(face, pixel_size, FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING, layout, glyph_code);
+    PathCreator::decompose_to_path(&face->glyph->outline, path);
+    decompose_to_msdf_generator(&face->glyph->outline, generator);
+
+    /* the texels cover the same region as the texels
+       of distance field glyphs, that of the bitmap of
+       the glyph with one pixel slack.
+     */
+    FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL);
+    bitmap_sz.x() = face->glyph->bitmap.width;
+    bitmap_sz.y() = face->glyph->bitmap.rows;
+    bitmap_offset.x() = face->glyph->bitmap_left;
+    bitmap_offset.y() = face->glyph->bitmap_top - face->glyph->bitmap.rows;
+  release_face(face);
+
+  if(bitmap_sz.x() != 0 && bitmap_sz.y() != 0)
+    {
+      fastuidraw::vecN<fastuidraw::c_array<uint8_t>, 3> channels;
+
+      output.resize(bitmap_sz + fastuidraw::ivec2(1, 1));
+      channels[0] = output.distance_values(fastuidraw::GlyphRenderDataMSDF::red_channel);
+      channels[1] = output.distance_values(fastuidraw::GlyphRenderDataMSDF::green_channel);
+      channels[2] = output.distance_values(fastuidraw::GlyphRenderDataMSDF::blue_channel);
+      generator.compute(output.resolution(), fastuidraw::vec2(bitmap_offset),
+                        max_distance, channels);
+    }
+  else
+    {
+      output.resize(fastuidraw::ivec2(0, 0));
+    }
+}
+
 /////////////////////////////////////////////
 // fastuidraw::FontFreeType::RenderParams methods
 fastuidraw::FontFreeType::RenderParams::
@@ -549,6 +1182,44 @@ distance_field_max_distance(void) const
   return d->m_distance_field_max_distance;
 }
 
+fastuidraw::FontFreeType::RenderParams&
+fastuidraw::FontFreeType::RenderParams::
+distance_field_generator(enum distance_field_generator_t v)
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  d->m_distance_field_generator = v;
+  return *this;
+}
+
+enum fastuidraw::FontFreeType::RenderParams::distance_field_generator_t
+fastuidraw::FontFreeType::RenderParams::
+distance_field_generator(void) const
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  return d->m_distance_field_generator;
+}
+
+fastuidraw::FontFreeType::RenderParams&
+fastuidraw::FontFreeType::RenderParams::
+distance_field_supersample(unsigned int v)
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  d->m_distance_field_supersample = v;
+  return *this;
+}
+
+unsigned int
+fastuidraw::FontFreeType::RenderParams::
+distance_field_supersample(void) const
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  return d->m_distance_field_supersample;
+}
+
 fastuidraw::FontFreeType::RenderParams&
 fastuidraw::FontFreeType::RenderParams::
 curve_pair_pixel_size(unsigned int v)
@@ -568,6 +1239,101 @@ curve_pair_pixel_size(void) const
   return d->m_curve_pair_pixel_size;
 }
 
+fastuidraw::FontFreeType::RenderParams&
+fastuidraw::FontFreeType::RenderParams::
+banded_curves_pixel_size(unsigned int v)
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  d->m_banded_curves_pixel_size = v;
+  return *this;
+}
+
+unsigned int
+fastuidraw::FontFreeType::RenderParams::
+banded_curves_pixel_size(void) const
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  return d->m_banded_curves_pixel_size;
+}
+
+fastuidraw::FontFreeType::RenderParams&
+fastuidraw::FontFreeType::RenderParams::
+banded_curves_max_number_bands(unsigned int v)
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  d->m_banded_curves_max_number_bands = v;
+  return *this;
+}
+
+unsigned int
+fastuidraw::FontFreeType::RenderParams::
+banded_curves_max_number_bands(void) const
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  return d->m_banded_curves_max_number_bands;
+}
+
+fastuidraw::FontFreeType::RenderParams&
+fastuidraw::FontFreeType::RenderParams::
+msdf_pixel_size(unsigned int v)
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  d->m_msdf_pixel_size = v;
+  return *this;
+}
+
+unsigned int
+fastuidraw::FontFreeType::RenderParams::
+msdf_pixel_size(void) const
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  return d->m_msdf_pixel_size;
+}
+
+fastuidraw::FontFreeType::RenderParams&
+fastuidraw::FontFreeType::RenderParams::
+msdf_max_distance(float v)
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  d->m_msdf_max_distance = v;
+  return *this;
+}
+
+float
+fastuidraw::FontFreeType::RenderParams::
+msdf_max_distance(void) const
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  return d->m_msdf_max_distance;
+}
+
+fastuidraw::FontFreeType::RenderParams&
+fastuidraw::FontFreeType::RenderParams::
+max_number_faces(unsigned int v)
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  d->m_max_number_faces = v;
+  return *this;
+}
+
+unsigned int
+fastuidraw::FontFreeType::RenderParams::
+max_number_faces(void) const
+{
+  RenderParamsPrivate *d;
+  d = static_cast<RenderParamsPrivate*>(m_d);
+  return d->m_max_number_faces;
+}
+
 ///////////////////////////////////////////////////
 // fastuidraw::FontFreeType methods
 fastuidraw::FontFreeType::
@@ -629,7 +1395,9 @@ can_create_rendering_data(enum glyph_type tp) const
 {
   return tp == coverage_glyph
     || tp == distance_field_glyph
-    || tp == curve_pair_glyph;
+    || tp == curve_pair_glyph
+    || tp == banded_curves_glyph
+    || tp == msdf_glyph;
 }
 
 fastuidraw::GlyphRenderData*
@@ -646,7 +1414,8 @@ compute_rendering_data(GlyphRender render, uint32_t glyph_code,
       {
         GlyphRenderDataCoverage *data;
         data = FASTUIDRAWnew GlyphRenderDataCoverage();
-        d->compute_rendering_data(render.m_pixel_size, glyph_code, layout, *data, path);
+        d->compute_rendering_data(render.m_pixel_size, render.m_subpixel_offset,
+                                  glyph_code, layout, *data, path);
         return data;
       }
       break;
@@ -669,12 +1438,74 @@ compute_rendering_data(GlyphRender render, uint32_t glyph_code,
       }
       break;
 
+    case banded_curves_glyph:
+      {
+        GlyphRenderDataBandedCurves *data;
+        data = FASTUIDRAWnew GlyphRenderDataBandedCurves();
+        d->compute_rendering_data(glyph_code, layout, *data, path);
+        return data;
+      }
+      break;
+
+    case msdf_glyph:
+      {
+        GlyphRenderDataMSDF *data;
+        data = FASTUIDRAWnew GlyphRenderDataMSDF();
+        d->compute_rendering_data(glyph_code, layout, *data, path);
+        return data;
+      }
+      break;
+
     default:
       assert(!"Invalid glyph type");
       return NULL;
     }
 }
 
+void
+fastuidraw::FontFreeType::
+compute_layout_data(GlyphRender render, uint32_t glyph_code,
+                    GlyphLayoutData &layout) const
+{
+  FontFreeTypePrivate *d;
+  d = static_cast<FontFreeTypePrivate*>(m_d);
+
+  switch(render.m_type)
+    {
+    case coverage_glyph:
+      d->compute_layout_data(render.m_pixel_size, FT_LOAD_DEFAULT, glyph_code,
+                             layout, render.m_subpixel_offset);
+      break;
+
+    case distance_field_glyph:
+      d->compute_layout_data(d->m_render_params.distance_field_pixel_size(),
+                             FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING,
+                             glyph_code, layout);
+      break;
+
+    case curve_pair_glyph:
+      d->compute_layout_data(d->m_render_params.curve_pair_pixel_size(),
+                             FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING,
+                             glyph_code, layout);
+      break;
+
+    case banded_curves_glyph:
+      d->compute_layout_data(d->m_render_params.banded_curves_pixel_size(),
+                             FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING,
+                             glyph_code, layout);
+      break;
+
+    case msdf_glyph:
+      d->compute_layout_data(d->m_render_params.msdf_pixel_size(),
+                             FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING,
+                             glyph_code, layout);
+      break;
+
+    default:
+      assert(!"Invalid glyph type");
+    }
+}
+
 
 const fastuidraw::FontFreeType::RenderParams&
 fastuidraw::FontFreeType::
@@ -696,11 +1527,12 @@ face(void) const
 
 int
 fastuidraw::FontFreeType::
-create(c_array<reference_counted_ptr<FontFreeType> > fonts, const char *filename,
+create(c_array<reference_counted_ptr<FontFreeType> > fonts,
+       reference_counted_ptr<const FontFileData> data,
        reference_counted_ptr<FreetypeLib> lib,
        const RenderParams &render_params)
 {
-  if(!lib || !lib->valid())
+  if(!lib || !lib->valid() || !data || !data->valid())
     {
       return 0;
     }
@@ -709,56 +1541,109 @@ create(c_array<reference_counted_ptr<FontFreeType> > fonts, const char *filename
   int error_code;
   unsigned int num(0);
 
-  error_code = FT_New_Face(lib->lib(), filename, -1, &face);
-  if(error_code == 0 && face != NULL && (face->face_flags & FT_FACE_FLAG_SCALABLE) == 0)
+  /* a negative face index only queries the number of faces */
+  lib->lock();
+  error_code = FT_New_Memory_Face(lib->lib(), data->data().c_ptr(), data->data().size(), -1, &face);
+  lib->unlock();
+  if(error_code == 0 && face != NULL)
     {
-      reference_counted_ptr<fastuidraw::FontFreeType> f;
-
       num = face->num_faces;
       for(unsigned int i = 0, c = 0; i < num && c < fonts.size(); ++i, ++c)
         {
-          fonts[c] = create(filename, lib, render_params, i);
+          fonts[c] = create(data, lib, render_params, i);
         }
     }
 
   if(face != NULL)
     {
+      lib->lock();
       FT_Done_Face(face);
+      lib->unlock();
     }
 
   return num;
 }
 
+int
+fastuidraw::FontFreeType::
+create(c_array<reference_counted_ptr<FontFreeType> > fonts, const char *filename,
+       reference_counted_ptr<FreetypeLib> lib,
+       const RenderParams &render_params)
+{
+  reference_counted_ptr<const FontFileData> data;
+  data = FASTUIDRAWnew FontFileData(filename);
+  return create(fonts, data, lib, render_params);
+}
+
 fastuidraw::reference_counted_ptr<fastuidraw::FontFreeType>
 fastuidraw::FontFreeType::
-create(const char *filename, reference_counted_ptr<FreetypeLib> lib,
+create(reference_counted_ptr<const FontFileData> data,
+       reference_counted_ptr<FreetypeLib> lib,
        const RenderParams &render_params, int face_index)
 {
-  if(!lib || !lib->valid())
+  if(!lib || !lib->valid() || !data || !data->valid())
     {
       return reference_counted_ptr<FontFreeType>();
     }
 
   int error_code;
   FT_Face face(NULL);
-  error_code = FT_New_Face(lib->lib(), filename, face_index, &face);
+
+  lib->lock();
+  error_code = FT_New_Memory_Face(lib->lib(), data->data().c_ptr(), data->data().size(),
+                                  face_index, &face);
   if(error_code != 0 || face == NULL || (face->face_flags & FT_FACE_FLAG_SCALABLE) == 0)
     {
       if(face != NULL)
         {
           FT_Done_Face(face);
         }
+      lib->unlock();
       return reference_counted_ptr<FontFreeType>();
     }
+  lib->unlock();
 
   FontProperties p;
   std::ostringstream str;
 
-  str << filename << ":" << face_index;
+  str << data->filename() << ":" << face_index;
   compute_font_propertes_from_face(face, p);
   p.source_label(str.str().c_str());
 
-  return FASTUIDRAWnew FontFreeType(face, lib, p, render_params);
+  reference_counted_ptr<FontFreeType> return_value;
+  FontFreeTypePrivate *d;
+
+  return_value = FASTUIDRAWnew FontFreeType(face, lib, p, render_params);
+
+  /* the face references the memory of data, and knowing
+     data allows the font to open more faces to generate
+     glyph data from several threads
+   */
+  d = static_cast<FontFreeTypePrivate*>(return_value->m_d);
+  d->m_file_data = data;
+  d->m_face_index = face_index;
+
+  return return_value;
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::FontFreeType>
+fastuidraw::FontFreeType::
+create(reference_counted_ptr<const FontFileData> data,
+       const RenderParams &render_params, int face_index)
+{
+  reference_counted_ptr<FreetypeLib> lib;
+  lib = FASTUIDRAWnew FreetypeLib();
+  return create(data, lib, render_params, face_index);
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::FontFreeType>
+fastuidraw::FontFreeType::
+create(const char *filename, reference_counted_ptr<FreetypeLib> lib,
+       const RenderParams &render_params, int face_index)
+{
+  reference_counted_ptr<const FontFileData> data;
+  data = FASTUIDRAWnew FontFileData(filename);
+  return create(data, lib, render_params, face_index);
 }
 
 fastuidraw::reference_counted_ptr<fastuidraw::FontFreeType>
@@ -18,6 +18,7 @@
 
 
 #include <fastuidraw/text/freetype_lib.hpp>
+#include "../private/util_private.hpp"
 
 fastuidraw::FreetypeLib::
 FreetypeLib(void)
@@ -29,6 +30,7 @@ FreetypeLib(void)
     {
       m_lib = NULL;
     }
+  m_mutex = FASTUIDRAWnew mutex();
 }
 
 fastuidraw::FreetypeLib::
@@ -38,4 +40,27 @@ fastuidraw::FreetypeLib::
     {
       FT_Done_FreeType(m_lib);
     }
+
+  mutex *m;
+  m = static_cast<mutex*>(m_mutex);
+  FASTUIDRAWdelete(m);
+  m_mutex = NULL;
+}
+
+void
+fastuidraw::FreetypeLib::
+lock(void)
+{
+  mutex *m;
+  m = static_cast<mutex*>(m_mutex);
+  m->lock();
+}
+
+void
+fastuidraw::FreetypeLib::
+unlock(void)
+{
+  mutex *m;
+  m = static_cast<mutex*>(m_mutex);
+  m->unlock();
 }
@@ -21,12 +21,16 @@
 
 #include "../private/interval_allocator.hpp"
 #include "../private/util_private.hpp"
+#include "../private/memory_report_private.hpp"
 #include "private/rect_atlas.hpp"
 
 namespace
 {
+  /* the reference count is atomic because GlyphAtlas::allocate()
+     takes references to the layers from several threads
+   */
   class rect_atlas_layer:
-    public fastuidraw::reference_counted<rect_atlas_layer>::non_concurrent,
+    public fastuidraw::reference_counted<rect_atlas_layer>::default_base,
     public fastuidraw::detail::RectAtlas
   {
   public:
@@ -50,18 +54,31 @@ namespace
   class GlyphAtlasTexelBackingStoreBasePrivate
   {
   public:
-    GlyphAtlasTexelBackingStoreBasePrivate(fastuidraw::ivec3 whl, bool presizable):
+    GlyphAtlasTexelBackingStoreBasePrivate(fastuidraw::ivec3 whl, bool presizable,
+                                           bool psixteen_bit):
       m_dimensions(whl),
-      m_resizeable(presizable)
+      m_resizeable(presizable),
+      m_sixteen_bit(psixteen_bit)
     {}
 
-    GlyphAtlasTexelBackingStoreBasePrivate(int w, int h, int l, bool presizable):
+    GlyphAtlasTexelBackingStoreBasePrivate(int w, int h, int l, bool presizable,
+                                           bool psixteen_bit):
       m_dimensions(w, h, l),
-      m_resizeable(presizable)
+      m_resizeable(presizable),
+      m_sixteen_bit(psixteen_bit)
     {}
 
+    /* the texels of a glyph atlas are 8-bit or 16-bit */
+    uint64_t
+    bytes(void) const
+    {
+      return uint64_t(m_dimensions.x()) * uint64_t(m_dimensions.y()) * uint64_t(m_dimensions.z())
+        * uint64_t(m_sixteen_bit ? 2 : 1);
+    }
+
     fastuidraw::ivec3 m_dimensions;
     bool m_resizeable;
+    bool m_sixteen_bit;
   };
 
   class GlyphAtlasGeometryBackingStoreBasePrivate
@@ -75,6 +92,12 @@ namespace
     {
     }
 
+    uint64_t
+    bytes(void) const
+    {
+      return uint64_t(m_size) * uint64_t(m_alignment) * sizeof(fastuidraw::generic_data);
+    }
+
     bool m_resizeable;
     unsigned int m_alignment;
     unsigned int m_size;
@@ -87,11 +110,14 @@ namespace
                       fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasGeometryBackingStoreBase> pgeometry_store):
       m_texel_store(ptexel_store),
       m_geometry_store(pgeometry_store),
-      m_geometry_data_allocator(pgeometry_store->size())
+      m_geometry_data_allocator(pgeometry_store->size()),
+      m_shelf_max_height(0)
     {
       assert(m_texel_store);
       assert(m_geometry_store);
       allocate_atlas_bookkeeping(m_texel_store->dimensions().z());
+      m_geometry_data_allocator.report_free_space(fastuidraw::memory::subsystem_glyph_atlas,
+                                                  m_geometry_store->alignment() * sizeof(fastuidraw::generic_data));
     };
 
     void
@@ -105,29 +131,152 @@ namespace
       for(int i = old_size; i < new_size; ++i)
         {
           m_private_data[i] = FASTUIDRAWnew rect_atlas_layer(dims, i);
+          m_private_data[i]->shelf_max_height(m_shelf_max_height);
         }
     }
 
-    fastuidraw::mutex m_mutex;
+    /* allocate a region from the first layer with room,
+       adding a layer to the texel store if none has room
+       and the texel store is resizeable; the returned
+       layer is the layer of the region.
+     */
+    const fastuidraw::detail::RectAtlas::rectangle*
+    allocate_rectangle(fastuidraw::ivec2 size,
+                       const fastuidraw::GlyphAtlas::Padding &padding,
+                       int &out_layer);
+
+    /* returns the layer i, or NULL if there are
+       not more than i layers
+     */
+    fastuidraw::reference_counted_ptr<rect_atlas_layer>
+    layer(unsigned int i)
+    {
+      fastuidraw::autolock_mutex m(m_layers_mutex);
+      return (i < m_private_data.size()) ?
+        m_private_data[i] :
+        fastuidraw::reference_counted_ptr<rect_atlas_layer>();
+    }
+
+    /* The atlas is locked in parts so that threads can
+       allocate from it at the same time:
+        - each layer (a RectAtlas) locks itself when a
+          rectangle is added to or removed from it
+        - m_layers_mutex guards m_private_data, i.e. the
+          number of layers, and m_shelf_max_height
+        - m_texel_mutex guards the calls to m_texel_store
+        - m_geometry_mutex guards m_geometry_data_allocator
+          and the calls to m_geometry_store
+       When more than one is locked, they are locked in
+       the order m_layers_mutex, m_texel_mutex.
+     */
+    fastuidraw::mutex m_layers_mutex;
+    fastuidraw::mutex m_texel_mutex;
+    fastuidraw::mutex m_geometry_mutex;
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasTexelBackingStoreBase> m_texel_store;
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasGeometryBackingStoreBase> m_geometry_store;
     std::vector<fastuidraw::reference_counted_ptr<rect_atlas_layer> > m_private_data;
     fastuidraw::interval_allocator m_geometry_data_allocator;
+    int m_shelf_max_height;
   };
 }
 
+//////////////////////////////////////////
+// GlyphAtlasPrivate methods
+const fastuidraw::detail::RectAtlas::rectangle*
+GlyphAtlasPrivate::
+allocate_rectangle(fastuidraw::ivec2 size,
+                   const fastuidraw::GlyphAtlas::Padding &padding,
+                   int &out_layer)
+{
+  const fastuidraw::detail::RectAtlas::rectangle *r(NULL);
+  fastuidraw::reference_counted_ptr<rect_atlas_layer> L;
+  unsigned int i(0);
+
+  out_layer = -1;
+  if(size.x() > m_texel_store->dimensions().x()
+     || size.y() > m_texel_store->dimensions().y())
+    {
+      return NULL;
+    }
+
+  /* each layer locks itself while a rectangle is added
+     to it, so threads allocating at the same time only
+     wait on each other when they try the same layer.
+   */
+  for(L = layer(i); L; L = layer(++i))
+    {
+      r = L->add_rectangle(size,
+                           padding.m_left, padding.m_right,
+                           padding.m_top, padding.m_bottom);
+      if(r != NULL)
+        {
+          break;
+        }
+    }
+
+  if(r == NULL && m_texel_store->resizeable())
+    {
+      fastuidraw::autolock_mutex m(m_layers_mutex);
+
+      /* another thread may have added layers since
+         the loop above, try those first.
+       */
+      for(; i < m_private_data.size() && r == NULL; ++i)
+        {
+          r = m_private_data[i]->add_rectangle(size,
+                                               padding.m_left, padding.m_right,
+                                               padding.m_top, padding.m_bottom);
+        }
+
+      if(r == NULL)
+        {
+          int old_size;
+
+          /* TODO:
+              Should we reallocate on powers of 2, or one layer
+              at a time? [Right now we are doing one layer at
+              a time].
+           */
+          old_size = m_private_data.size();
+          {
+            fastuidraw::autolock_mutex t(m_texel_mutex);
+            m_texel_store->resize(old_size + 1);
+          }
+          allocate_atlas_bookkeeping(old_size + 1);
+
+          r = m_private_data[old_size]->add_rectangle(size,
+                                                      padding.m_left, padding.m_right,
+                                                      padding.m_top, padding.m_bottom);
+          assert(r != NULL);
+        }
+    }
+
+  if(r != NULL)
+    {
+      assert(dynamic_cast<const rect_atlas_layer*>(r->atlas()));
+      out_layer = static_cast<const rect_atlas_layer*>(r->atlas())->layer();
+    }
+  return r;
+}
+
 /////////////////////////////////////////////////////
 // fastuidraw::GlyphAtlasTexelBackingStoreBase methods
 fastuidraw::GlyphAtlasTexelBackingStoreBase::
-GlyphAtlasTexelBackingStoreBase(ivec3 whl, bool presizable)
+GlyphAtlasTexelBackingStoreBase(ivec3 whl, bool presizable, bool psixteen_bit)
 {
-  m_d = FASTUIDRAWnew GlyphAtlasTexelBackingStoreBasePrivate(whl, presizable);
+  GlyphAtlasTexelBackingStoreBasePrivate *d;
+  d = FASTUIDRAWnew GlyphAtlasTexelBackingStoreBasePrivate(whl, presizable, psixteen_bit);
+  m_d = d;
+  detail::memory_report_grow(memory::subsystem_glyph_atlas, 0, d->bytes());
 }
 
 fastuidraw::GlyphAtlasTexelBackingStoreBase::
-GlyphAtlasTexelBackingStoreBase(int w, int h, int l, bool presizable)
+GlyphAtlasTexelBackingStoreBase(int w, int h, int l, bool presizable, bool psixteen_bit)
 {
-  m_d = FASTUIDRAWnew GlyphAtlasTexelBackingStoreBasePrivate(w, h, l, presizable);
+  GlyphAtlasTexelBackingStoreBasePrivate *d;
+  d = FASTUIDRAWnew GlyphAtlasTexelBackingStoreBasePrivate(w, h, l, presizable, psixteen_bit);
+  m_d = d;
+  detail::memory_report_grow(memory::subsystem_glyph_atlas, 0, d->bytes());
 }
 
 fastuidraw::GlyphAtlasTexelBackingStoreBase::
@@ -135,6 +284,7 @@ fastuidraw::GlyphAtlasTexelBackingStoreBase::
 {
   GlyphAtlasTexelBackingStoreBasePrivate *d;
   d = static_cast<GlyphAtlasTexelBackingStoreBasePrivate*>(m_d);
+  detail::memory_report_shrink(memory::subsystem_glyph_atlas, 0, d->bytes());
   FASTUIDRAWdelete(d);
   m_d = NULL;
 }
@@ -157,6 +307,29 @@ resizeable(void) const
   return d->m_resizeable;
 }
 
+bool
+fastuidraw::GlyphAtlasTexelBackingStoreBase::
+sixteen_bit(void) const
+{
+  GlyphAtlasTexelBackingStoreBasePrivate *d;
+  d = static_cast<GlyphAtlasTexelBackingStoreBasePrivate*>(m_d);
+  return d->m_sixteen_bit;
+}
+
+void
+fastuidraw::GlyphAtlasTexelBackingStoreBase::
+set_data16(int x, int y, int l, int w, int h,
+           const_c_array<uint16_t> data)
+{
+  FASTUIDRAWunused(x);
+  FASTUIDRAWunused(y);
+  FASTUIDRAWunused(l);
+  FASTUIDRAWunused(w);
+  FASTUIDRAWunused(h);
+  FASTUIDRAWunused(data);
+  assert(!"set_data16() called on a texel store without 16-bit texels");
+}
+
 void
 fastuidraw::GlyphAtlasTexelBackingStoreBase::
 resize(int new_num_layers)
@@ -165,9 +338,20 @@ resize(int new_num_layers)
   d = static_cast<GlyphAtlasTexelBackingStoreBasePrivate*>(m_d);
 
   assert(d->m_resizeable);
-  assert(new_num_layers > d->m_dimensions.z());
+  assert(new_num_layers > 0);
+  assert(new_num_layers != d->m_dimensions.z());
   resize_implement(new_num_layers);
+
+  uint64_t old_bytes(d->bytes());
   d->m_dimensions.z() = new_num_layers;
+  if(d->bytes() > old_bytes)
+    {
+      detail::memory_report_grow(memory::subsystem_glyph_atlas, 0, d->bytes() - old_bytes);
+    }
+  else
+    {
+      detail::memory_report_shrink(memory::subsystem_glyph_atlas, 0, old_bytes - d->bytes());
+    }
 }
 
 
@@ -177,7 +361,10 @@ fastuidraw::GlyphAtlasGeometryBackingStoreBase::
 GlyphAtlasGeometryBackingStoreBase(unsigned int palignment, unsigned int psize,
                                    bool presizable)
 {
-  m_d = FASTUIDRAWnew GlyphAtlasGeometryBackingStoreBasePrivate(palignment, psize, presizable);
+  GlyphAtlasGeometryBackingStoreBasePrivate *d;
+  d = FASTUIDRAWnew GlyphAtlasGeometryBackingStoreBasePrivate(palignment, psize, presizable);
+  m_d = d;
+  detail::memory_report_grow(memory::subsystem_glyph_atlas, 0, d->bytes());
 }
 
 fastuidraw::GlyphAtlasGeometryBackingStoreBase::
@@ -185,6 +372,7 @@ fastuidraw::GlyphAtlasGeometryBackingStoreBase::
 {
   GlyphAtlasGeometryBackingStoreBasePrivate *d;
   d = static_cast<GlyphAtlasGeometryBackingStoreBasePrivate*>(m_d);
+  detail::memory_report_shrink(memory::subsystem_glyph_atlas, 0, d->bytes());
   FASTUIDRAWdelete(d);
   m_d = NULL;
 }
@@ -225,7 +413,10 @@ resize(unsigned int new_size)
   assert(d->m_resizeable);
   assert(new_size > d->m_size);
   resize_implement(new_size);
+
+  uint64_t old_bytes(d->bytes());
   d->m_size = new_size;
+  detail::memory_report_grow(memory::subsystem_glyph_atlas, 0, d->bytes() - old_bytes);
 }
 
 ///////////////////////////////////////////
@@ -300,50 +491,41 @@ allocate(fastuidraw::ivec2 size, const_c_array<uint8_t> pdata,
   d = static_cast<GlyphAtlasPrivate*>(m_d);
 
   GlyphLocation return_value;
-  const detail::RectAtlas::rectangle *r(NULL);
-  unsigned int layer;
+  const detail::RectAtlas::rectangle *r;
+  int layer;
 
-  if(size.x() > d->m_texel_store->dimensions().x()
-     || size.y() > d->m_texel_store->dimensions().y())
+  r = d->allocate_rectangle(size, padding, layer);
+  if(r != NULL)
     {
-      return return_value;
+      autolock_mutex t(d->m_texel_mutex);
+      return_value.m_opaque = r;
+      d->m_texel_store->set_data(r->minX_minY().x(), r->minX_minY().y(), layer,
+                                 size.x(), size.y(), pdata);
     }
 
-  autolock_mutex m(d->m_mutex);
-
-  for(unsigned int i = 0, endi = d->m_private_data.size(); i < endi && r == NULL; ++i)
-    {
-      r = d->m_private_data[i]->add_rectangle(size,
-                                              padding.m_left, padding.m_right,
-                                              padding.m_top, padding.m_bottom);
-      layer = i;
-    }
+  return return_value;
+}
 
-  if(r == NULL && d->m_texel_store->resizeable())
-    {
-      int old_size;
+fastuidraw::GlyphLocation
+fastuidraw::GlyphAtlas::
+allocate(fastuidraw::ivec2 size, const_c_array<uint16_t> pdata,
+         const GlyphAtlas::Padding &padding)
+{
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
 
-      /* TODO:
-          Should we reallocate on powers of 2, or one layer
-          at a time? [Right now we are doing one layer at
-          a time].
-       */
-      old_size = d->m_texel_store->dimensions().z();
-      d->m_texel_store->resize(old_size + 1);
-      d->allocate_atlas_bookkeeping(d->m_texel_store->dimensions().z());
-
-      r = d->m_private_data[old_size]->add_rectangle(size,
-                                                     padding.m_left, padding.m_right,
-                                                     padding.m_top, padding.m_bottom);
-      layer = old_size;
-      assert(r != NULL);
-    }
+  GlyphLocation return_value;
+  const detail::RectAtlas::rectangle *r;
+  int layer;
 
+  assert(d->m_texel_store->sixteen_bit());
+  r = d->allocate_rectangle(size, padding, layer);
   if(r != NULL)
     {
+      autolock_mutex t(d->m_texel_mutex);
       return_value.m_opaque = r;
-      d->m_texel_store->set_data(r->minX_minY().x(), r->minX_minY().y(), layer,
-                                 size.x(), size.y(), pdata);
+      d->m_texel_store->set_data16(r->minX_minY().x(), r->minX_minY().y(), layer,
+                                   size.x(), size.y(), pdata);
     }
 
   return return_value;
@@ -363,6 +545,113 @@ deallocate(fastuidraw::GlyphLocation G)
     }
 }
 
+fastuidraw::GlyphLocation
+fastuidraw::GlyphAtlas::
+relocate(GlyphLocation G, int excluded_layer, int number_layers)
+{
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
+
+  GlyphLocation return_value;
+  const detail::RectAtlas::rectangle *src, *r(NULL);
+  reference_counted_ptr<rect_atlas_layer> L;
+  int src_layer, layer(-1), left, right, top, bottom;
+  ivec2 size;
+
+  assert(G.valid());
+  src = static_cast<const detail::RectAtlas::rectangle*>(G.m_opaque);
+  assert(dynamic_cast<const rect_atlas_layer*>(src->atlas()));
+  src_layer = static_cast<const rect_atlas_layer*>(src->atlas())->layer();
+
+  /* recover the padding from the padded and
+     unpadded rectangles of the region
+   */
+  size = src->size();
+  left = src->minX_minY().x() - src->unpadded_minX_minY().x();
+  top = src->minX_minY().y() - src->unpadded_minX_minY().y();
+  right = size.x() - src->unpadded_size().x() - left;
+  bottom = size.y() - src->unpadded_size().y() - top;
+
+  for(int i = 0; (number_layers < 0 || i < number_layers) && r == NULL; ++i)
+    {
+      L = d->layer(i);
+      if(!L)
+        {
+          break;
+        }
+
+      if(i != excluded_layer)
+        {
+          r = L->add_rectangle(size, left, right, top, bottom);
+          layer = i;
+        }
+    }
+
+  if(r != NULL)
+    {
+      if(size.x() > 0 && size.y() > 0)
+        {
+          autolock_mutex t(d->m_texel_mutex);
+          d->m_texel_store->copy_data(src->minX_minY().x(), src->minX_minY().y(), src_layer,
+                                      size.x(), size.y(),
+                                      r->minX_minY().x(), r->minX_minY().y(), layer);
+        }
+      detail::RectAtlas::delete_rectangle(src);
+      return_value.m_opaque = r;
+    }
+
+  return return_value;
+}
+
+enum fastuidraw::return_code
+fastuidraw::GlyphAtlas::
+shrink_texel_store(int number_layers)
+{
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
+
+  assert(number_layers >= 1);
+
+  autolock_mutex m(d->m_layers_mutex);
+  int old_size(d->m_private_data.size());
+
+  if(number_layers >= old_size)
+    {
+      return routine_success;
+    }
+
+  if(!d->m_texel_store->resizeable())
+    {
+      return routine_fail;
+    }
+
+  for(int i = number_layers; i < old_size; ++i)
+    {
+      if(d->m_private_data[i]->area_allocated() != 0)
+        {
+          return routine_fail;
+        }
+    }
+
+  d->m_private_data.resize(number_layers);
+
+  autolock_mutex t(d->m_texel_mutex);
+  d->m_texel_store->resize(number_layers);
+  return routine_success;
+}
+
+int
+fastuidraw::GlyphAtlas::
+number_texels_allocated(int layer) const
+{
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
+
+  reference_counted_ptr<rect_atlas_layer> L(d->layer(layer));
+  assert(L);
+  return L->area_allocated();
+}
+
 int
 fastuidraw::GlyphAtlas::
 allocate_geometry_data(const_c_array<generic_data> pdata)
@@ -370,7 +659,7 @@ allocate_geometry_data(const_c_array<generic_data> pdata)
   GlyphAtlasPrivate *d;
   d = static_cast<GlyphAtlasPrivate*>(m_d);
 
-  autolock_mutex m(d->m_mutex);
+  autolock_mutex m(d->m_geometry_mutex);
   unsigned int count, alignment;
   int block_count, return_value;
 
@@ -415,7 +704,7 @@ deallocate_geometry_data(int location, int count)
       return;
     }
 
-  autolock_mutex m(d->m_mutex);
+  autolock_mutex m(d->m_geometry_mutex);
 
   assert(count > 0);
   d->m_geometry_data_allocator.free_interval(location, count);
@@ -429,15 +718,44 @@ clear(void)
   GlyphAtlasPrivate *d;
   d = static_cast<GlyphAtlasPrivate*>(m_d);
 
-  autolock_mutex m(d->m_mutex);
+  {
+    autolock_mutex m(d->m_geometry_mutex);
+    d->m_geometry_data_allocator.reset(d->m_geometry_data_allocator.size());
+  }
 
-  d->m_geometry_data_allocator.reset(d->m_geometry_data_allocator.size());
+  autolock_mutex m(d->m_layers_mutex);
   for(unsigned int i = 0, endi = d->m_private_data.size(); i < endi; ++i)
     {
       d->m_private_data[i]->clear();
     }
 }
 
+void
+fastuidraw::GlyphAtlas::
+shelf_max_height(int v)
+{
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
+
+  autolock_mutex m(d->m_layers_mutex);
+  d->m_shelf_max_height = v;
+  for(unsigned int i = 0, endi = d->m_private_data.size(); i < endi; ++i)
+    {
+      d->m_private_data[i]->shelf_max_height(v);
+    }
+}
+
+int
+fastuidraw::GlyphAtlas::
+shelf_max_height(void) const
+{
+  GlyphAtlasPrivate *d;
+  d = static_cast<GlyphAtlasPrivate*>(m_d);
+
+  autolock_mutex m(d->m_layers_mutex);
+  return d->m_shelf_max_height;
+}
+
 void
 fastuidraw::GlyphAtlas::
 flush(void) const
@@ -445,8 +763,12 @@ flush(void) const
   GlyphAtlasPrivate *d;
   d = static_cast<GlyphAtlasPrivate*>(m_d);
 
-  autolock_mutex m(d->m_mutex);
-  d->m_texel_store->flush();
+  {
+    autolock_mutex t(d->m_texel_mutex);
+    d->m_texel_store->flush();
+  }
+
+  autolock_mutex m(d->m_geometry_mutex);
   d->m_geometry_store->flush();
 }
 
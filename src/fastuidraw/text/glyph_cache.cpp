@@ -17,17 +17,27 @@
  */
 
 
-#include <map>
 #include <vector>
+#include <list>
+#include <map>
+#include <algorithm>
 #include <fastuidraw/text/glyph_cache.hpp>
 #include <fastuidraw/text/glyph_render_data.hpp>
+#include <fastuidraw/text/glyph_render_data_coverage.hpp>
+#include <fastuidraw/text/glyph_render_data_distance_field.hpp>
+#include <fastuidraw/text/glyph_render_data_curve_pair.hpp>
+#include <fastuidraw/text/glyph_render_data_banded_curves.hpp>
+#include <fastuidraw/text/glyph_render_data_msdf.hpp>
 #include "../private/util_private.hpp"
+#include "../private/blob_private.hpp"
+#include "../private/memory_report_private.hpp"
 
 
 namespace
 {
 
   class GlyphCachePrivate;
+  class PrefetchJob;
 
   class GlyphDataPrivate
   {
@@ -38,12 +48,29 @@ namespace
       m_geometry_offset(-1),
       m_geometry_length(0),
       m_uploaded_to_atlas(false),
-      m_glyph_data(NULL)
+      m_glyph_data(NULL),
+      m_last_used_frame(0),
+      m_prefetch(NULL),
+      m_font(NULL),
+      m_glyph_code(0),
+      m_generation(0)
     {}
 
     void
     clear(void);
 
+    /* remove the data of the glyph from the atlas
+       but keep m_glyph_data so that the glyph can
+       be uploaded again.
+     */
+    void
+    remove_from_atlas(void);
+
+    /* mark the glyph as used in the current frame
+     */
+    void
+    mark_used(void);
+
     enum fastuidraw::return_code
     upload_to_atlas(void);
 
@@ -73,6 +100,38 @@ namespace
     /* data to generate glyph data
      */
     fastuidraw::GlyphRenderData *m_glyph_data;
+
+    /* value of m_cache->m_current_frame when the
+       glyph was last used
+     */
+    uint64_t m_last_used_frame;
+
+    /* non-NULL while the rendering data is
+       generated by the prefetch thread
+     */
+    PrefetchJob *m_prefetch;
+
+    /* font and glyph code of the glyph, for
+       fastuidraw::GlyphCache::write_usage_profile();
+       the font is held by the key of m_cache->m_glyph_map
+     */
+    const fastuidraw::FontBase *m_font;
+    uint32_t m_glyph_code;
+
+    /* incremented each time the glyph is cleared,
+       see fastuidraw::Glyph::generation()
+     */
+    unsigned int m_generation;
+  };
+
+  class GlyphLastUsedCompare
+  {
+  public:
+    bool
+    operator()(const GlyphDataPrivate *lhs, const GlyphDataPrivate *rhs) const
+    {
+      return lhs->m_last_used_frame < rhs->m_last_used_frame;
+    }
   };
 
   class GlyphSource
@@ -90,11 +149,37 @@ namespace
     {}
 
     bool
-    operator<(const GlyphSource &rhs) const
+    operator==(const GlyphSource &rhs) const
+    {
+      return m_font == rhs.m_font
+        && m_glyph_code == rhs.m_glyph_code
+        && m_render == rhs.m_render;
+    }
+
+    /* packs the glyph code and GlyphRender into 64-bits
+       and mixes it with the address of the font; the pixel
+       size and subpixel offset are ignored for scalable glyph
+       types, just as GlyphRender::operator==() ignores them.
+     */
+    uint64_t
+    hash(void) const
     {
-      return (m_font != rhs.m_font) ? m_font < rhs.m_font :
-        (m_glyph_code != rhs.m_glyph_code) ? m_glyph_code < rhs.m_glyph_code :
-        m_render < rhs.m_render;
+      uint64_t pixel_size, subpixel_offset, v;
+
+      pixel_size = fastuidraw::GlyphRender::scalable(m_render.m_type) ?
+        0u : static_cast<uint32_t>(m_render.m_pixel_size);
+      subpixel_offset = fastuidraw::GlyphRender::scalable(m_render.m_type) ?
+        0u : static_cast<uint32_t>(m_render.m_subpixel_offset);
+      v = (static_cast<uint64_t>(m_glyph_code) << 32u)
+        ^ (static_cast<uint64_t>(m_render.m_type) << 24u)
+        ^ (subpixel_offset << 20u)
+        ^ pixel_size;
+      v ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(m_font.get())) * 0x9E3779B97F4A7C15ull;
+
+      /* finalizer of splitmix64 */
+      v = (v ^ (v >> 30u)) * 0xBF58476D1CE4E5B9ull;
+      v = (v ^ (v >> 27u)) * 0x94D049BB133111EBull;
+      return v ^ (v >> 31u);
     }
 
     fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> m_font;
@@ -102,6 +187,329 @@ namespace
     fastuidraw::GlyphRender m_render;
   };
 
+  /* ordering of GlyphSource for std::map */
+  class GlyphSourceLess
+  {
+  public:
+    bool
+    operator()(const GlyphSource &lhs, const GlyphSource &rhs) const
+    {
+      if(lhs.m_font != rhs.m_font)
+        {
+          return lhs.m_font < rhs.m_font;
+        }
+      if(lhs.m_glyph_code != rhs.m_glyph_code)
+        {
+          return lhs.m_glyph_code < rhs.m_glyph_code;
+        }
+      return lhs.m_render < rhs.m_render;
+    }
+  };
+
+  /* layout data fetched by fastuidraw::GlyphCache::fetch_glyph_layout()
+     of glyphs that have no generated rendering data
+   */
+  typedef std::map<GlyphSource, fastuidraw::GlyphLayoutData, GlyphSourceLess> LayoutMap;
+
+  /* Open addressing hash table with linear probing
+     from GlyphSource to GlyphDataPrivate; the number
+     of slots is always a power of 2.
+   */
+  class GlyphMap
+  {
+  public:
+    GlyphMap(void):
+      m_number_elements(0),
+      m_number_removed(0)
+    {}
+
+    GlyphDataPrivate*
+    find(const GlyphSource &src) const
+    {
+      if(m_slots.empty())
+        {
+          return NULL;
+        }
+
+      for(unsigned int mask = m_slots.size() - 1u, I = src.hash() & mask; ; I = (I + 1u) & mask)
+        {
+          const Slot &S(m_slots[I]);
+          if(S.m_state == slot_empty)
+            {
+              return NULL;
+            }
+          else if(S.m_state == slot_used && S.m_src == src)
+            {
+              return S.m_glyph;
+            }
+        }
+    }
+
+    /* src must not already be in the map */
+    void
+    insert(const GlyphSource &src, GlyphDataPrivate *G)
+    {
+      assert(find(src) == NULL);
+      if(4u * (m_number_elements + m_number_removed + 1u) > 3u * m_slots.size())
+        {
+          /* only double the number of slots if the slots are
+             mostly taken by elements, otherwise just rehashing
+             removes the slots of removed elements.
+           */
+          rehash(2u * (m_number_elements + 1u) > m_slots.size() ?
+                 std::max(2u * static_cast<unsigned int>(m_slots.size()), 64u) :
+                 m_slots.size());
+        }
+      insert_no_grow(src, G);
+    }
+
+    void
+    erase(const GlyphSource &src)
+    {
+      if(m_slots.empty())
+        {
+          return;
+        }
+
+      for(unsigned int mask = m_slots.size() - 1u, I = src.hash() & mask; ; I = (I + 1u) & mask)
+        {
+          Slot &S(m_slots[I]);
+          if(S.m_state == slot_empty)
+            {
+              return;
+            }
+          else if(S.m_state == slot_used && S.m_src == src)
+            {
+              S.m_state = slot_removed;
+              S.m_src = GlyphSource();
+              S.m_glyph = NULL;
+              --m_number_elements;
+              ++m_number_removed;
+              return;
+            }
+        }
+    }
+
+    void
+    clear(void)
+    {
+      m_slots.clear();
+      m_number_elements = 0;
+      m_number_removed = 0;
+    }
+
+  private:
+    enum slot_state_t
+      {
+        slot_empty,
+        slot_used,
+        slot_removed,
+      };
+
+    class Slot
+    {
+    public:
+      Slot(void):
+        m_state(slot_empty),
+        m_glyph(NULL)
+      {}
+
+      enum slot_state_t m_state;
+      GlyphSource m_src;
+      GlyphDataPrivate *m_glyph;
+    };
+
+    void
+    insert_no_grow(const GlyphSource &src, GlyphDataPrivate *G)
+    {
+      for(unsigned int mask = m_slots.size() - 1u, I = src.hash() & mask; ; I = (I + 1u) & mask)
+        {
+          Slot &S(m_slots[I]);
+          if(S.m_state != slot_used)
+            {
+              if(S.m_state == slot_removed)
+                {
+                  --m_number_removed;
+                }
+              S.m_state = slot_used;
+              S.m_src = src;
+              S.m_glyph = G;
+              ++m_number_elements;
+              return;
+            }
+        }
+    }
+
+    void
+    rehash(unsigned int number_slots)
+    {
+      std::vector<Slot> old_slots(number_slots);
+
+      assert((number_slots & (number_slots - 1u)) == 0u);
+      std::swap(old_slots, m_slots);
+      m_number_elements = 0;
+      m_number_removed = 0;
+      for(unsigned int i = 0, endi = old_slots.size(); i < endi; ++i)
+        {
+          if(old_slots[i].m_state == slot_used)
+            {
+              insert_no_grow(old_slots[i].m_src, old_slots[i].m_glyph);
+            }
+        }
+    }
+
+    std::vector<Slot> m_slots;
+    unsigned int m_number_elements, m_number_removed;
+  };
+
+  /* a glyph whose rendering data generation is
+     deferred to GlyphCache::end_deferred_generation()
+   */
+  class DeferredGlyph
+  {
+  public:
+    DeferredGlyph(GlyphDataPrivate *G, const GlyphSource &src):
+      m_glyph(G),
+      m_src(src)
+    {}
+
+    GlyphDataPrivate *m_glyph;
+    GlyphSource m_src;
+  };
+
+  /* job for run_in_parallel() to generate the
+     rendering data of deferred glyphs
+   */
+  class GenerateDeferredGlyphs
+  {
+  public:
+    explicit
+    GenerateDeferredGlyphs(const std::vector<DeferredGlyph> &glyphs):
+      m_glyphs(glyphs)
+    {}
+
+    void
+    operator()(unsigned int begin, unsigned int end) const
+    {
+      for(unsigned int i = begin; i < end; ++i)
+        {
+          GlyphDataPrivate *q(m_glyphs[i].m_glyph);
+          q->m_glyph_data = m_glyphs[i].m_src.m_font->compute_rendering_data(q->m_render,
+                                                                             m_glyphs[i].m_src.m_glyph_code,
+                                                                             q->m_layout, q->m_path);
+        }
+    }
+
+  private:
+    const std::vector<DeferredGlyph> &m_glyphs;
+  };
+
+  /* rendering data of a glyph generated by
+     the task of a GlyphPrefetcher
+   */
+  class PrefetchJob
+  {
+  public:
+    PrefetchJob(GlyphDataPrivate *G, const GlyphSource &src):
+      m_glyph(G),
+      m_src(src),
+      m_glyph_data(NULL),
+      m_done(false)
+    {}
+
+    GlyphDataPrivate *m_glyph;
+    GlyphSource m_src;
+    fastuidraw::GlyphLayoutData m_layout;
+    fastuidraw::Path m_path;
+    fastuidraw::GlyphRenderData *m_glyph_data;
+    bool m_done;
+  };
+
+  /* job for run_in_parallel() to generate the
+     rendering data of a batch of prefetch jobs
+   */
+  class GeneratePrefetchJobs
+  {
+  public:
+    explicit
+    GeneratePrefetchJobs(const std::vector<PrefetchJob*> &jobs):
+      m_jobs(jobs)
+    {}
+
+    void
+    operator()(unsigned int begin, unsigned int end) const
+    {
+      for(unsigned int i = begin; i < end; ++i)
+        {
+          PrefetchJob *job(m_jobs[i]);
+          job->m_glyph_data = job->m_src.m_font->compute_rendering_data(job->m_glyph->m_render,
+                                                                        job->m_src.m_glyph_code,
+                                                                        job->m_layout, job->m_path);
+        }
+    }
+
+  private:
+    const std::vector<PrefetchJob*> &m_jobs;
+  };
+
+  /* A GlyphPrefetcher generates the rendering data of the
+     jobs in the order they are added with a task given to
+     TaskExecutor::run_task_async() of default_task_executor()
+     when a job is added and the task is not already in flight;
+     the task takes the jobs in batches, generates each batch
+     with run_in_parallel() and ends once no job is left. Only
+     the task touches the fields of a job other than m_done
+     until m_done is true.
+   */
+  class GlyphPrefetcher:
+    public fastuidraw::TaskExecutor::Task,
+    fastuidraw::noncopyable
+  {
+  public:
+    GlyphPrefetcher(void);
+
+    /* waits for the task to end, the
+       jobs must have been taken first
+     */
+    ~GlyphPrefetcher();
+
+    void
+    add_job(PrefetchJob *job);
+
+    /* wait until job is done */
+    void
+    wait(PrefetchJob *job);
+
+    /* take the jobs that are done; the caller
+       then owns them
+     */
+    void
+    take_done_jobs(std::vector<PrefetchJob*> &dst);
+
+    /* remove the jobs that are not yet started and the
+       jobs that are done, waiting for the job in progress
+       if there is one; the caller then owns them
+     */
+    void
+    take_all_jobs(std::vector<PrefetchJob*> &dst);
+
+    virtual
+    void
+    run(void);
+
+  private:
+    boost::mutex m_mutex;
+    boost::condition_variable m_job_done;
+    std::list<PrefetchJob*> m_queue;
+    std::vector<PrefetchJob*> m_done;
+    std::vector<PrefetchJob*> m_in_progress;
+
+    /* true from when the task is handed to the
+       executor until it ends
+     */
+    bool m_scheduled;
+  };
+
   class GlyphCachePrivate
   {
   public:
@@ -120,12 +528,492 @@ namespace
     GlyphDataPrivate*
     fetch_or_allocate_glyph(GlyphSource src);
 
+    /* Called when uploading G to the atlas failed; removes
+       from the atlas the glyphs not used in the current frame,
+       least recently used first, until G can be uploaded.
+     */
+    enum fastuidraw::return_code
+    evict_and_upload(GlyphDataPrivate *G);
+
+    /* Returns the layer of the atlas that compact_atlas()
+       should empty, or -1 if no layer should be emptied.
+     */
+    int
+    choose_compact_layer(void) const;
+
+    /* empty the layers of the atlas at or after number_layers,
+       see fastuidraw::GlyphCache::trim_atlas(); returns the
+       number of layers that still hold glyphs, i.e. one more
+       than the last layer of a glyph that could not be moved,
+       or number_layers if all were moved.
+     */
+    int
+    vacate_layers(int number_layers);
+
+    /* move the rendering data of the prefetched glyphs
+       that are done to their glyphs
+     */
+    void
+    absorb_prefetched_glyphs(void);
+
+    /* wait for the prefetch of G to finish and absorb it */
+    void
+    finish_prefetch(GlyphDataPrivate *G);
+
+    /* stop all prefetches, discarding those not done */
+    void
+    cancel_prefetches(void);
+
+    void
+    absorb_job(PrefetchJob *job);
+
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlas> m_atlas;
-    std::map<GlyphSource, GlyphDataPrivate*> m_glyph_map;
+    GlyphMap m_glyph_map;
+    LayoutMap m_layout_map;
     std::vector<GlyphDataPrivate*> m_glyphs;
     std::vector<unsigned int> m_free_slots;
+    fastuidraw::vecN<unsigned int, fastuidraw::GlyphCache::num_stats> m_stats;
     fastuidraw::GlyphCache *m_p;
+    uint64_t m_current_frame;
+    std::vector<GlyphDataPrivate*> m_evict_candidates;
+
+    /* layer of the atlas emptied by compact_atlas(),
+       -1 if no compaction is in progress
+     */
+    int m_compact_layer;
+
+    /* layer on which a compaction failed to move a glyph
+       and the number of texels allocated on it then; the
+       layer is not chosen again until that number changes.
+     */
+    int m_compact_failed_layer, m_compact_failed_texels;
+    bool m_deferring_generation;
+    std::vector<DeferredGlyph> m_deferred_glyphs;
+
+    /* created on the first prefetch */
+    GlyphPrefetcher *m_prefetcher;
+    std::vector<PrefetchJob*> m_work_room_jobs;
+  };
+
+  /* Value that starts a blob of baked glyphs and the
+     version of the layout of the blob written by
+     fastuidraw::GlyphCache::bake_glyphs().
+   */
+  namespace BakedGlyphsConstants
+  {
+    const uint32_t blob_magic = 0x42594C47u;
+    const uint32_t blob_version = 5u;
+  }
+
+  /* Value that starts a blob written by
+     fastuidraw::GlyphCache::write_usage_profile()
+     and the version of the layout of the blob.
+   */
+  namespace UsageProfileConstants
+  {
+    const uint32_t blob_magic = 0x50555947u;
+    const uint32_t blob_version = 2u;
+  }
+
+  enum baked_interpolator_t
+    {
+      baked_flat_interpolator,
+      baked_bezier_interpolator,
+    };
+
+  /* A glyph read from a blob of baked glyphs
+   */
+  class BakedGlyph
+  {
+  public:
+    BakedGlyph(void):
+      m_glyph_data(NULL)
+    {}
+
+    fastuidraw::GlyphLayoutData m_layout;
+    fastuidraw::Path m_path;
+    fastuidraw::GlyphRenderData *m_glyph_data;
   };
+
+  /* Returns false if the path has interpolators other than
+     flat and bezier, in which case nothing is written.
+   */
+  bool
+  write_path(fastuidraw::detail::BlobWriter &dst, const fastuidraw::Path &path)
+  {
+    std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::PathContour> > contours;
+
+    for(unsigned int c = 0, endc = path.number_contours(); c < endc; ++c)
+      {
+        fastuidraw::reference_counted_ptr<const fastuidraw::PathContour> C(path.contour(c));
+
+        if(!C->ended() || C->number_points() == 0)
+          {
+            continue;
+          }
+
+        for(unsigned int i = 0, endi = C->number_points(); i < endi; ++i)
+          {
+            const fastuidraw::PathContour::interpolator_base *h(C->curve_interpolator(i));
+            if(h && !dynamic_cast<const fastuidraw::PathContour::bezier*>(h))
+              {
+                return false;
+              }
+          }
+        contours.push_back(C);
+      }
+
+    dst.write_u32(contours.size());
+    for(unsigned int c = 0, endc = contours.size(); c < endc; ++c)
+      {
+        const fastuidraw::PathContour &C(*contours[c]);
+
+        dst.write_u32(C.number_points());
+        for(unsigned int i = 0, endi = C.number_points(); i < endi; ++i)
+          {
+            const fastuidraw::PathContour::bezier *b;
+
+            dst.write_vec2(C.point(i));
+            b = dynamic_cast<const fastuidraw::PathContour::bezier*>(C.curve_interpolator(i));
+            if(b)
+              {
+                fastuidraw::const_c_array<fastuidraw::vec2> pts(b->pts());
+
+                assert(pts.size() >= 2);
+                dst.write_u32(baked_bezier_interpolator);
+                dst.write_u32(pts.size() - 2);
+                for(unsigned int k = 1; k + 1 < pts.size(); ++k)
+                  {
+                    dst.write_vec2(pts[k]);
+                  }
+              }
+            else
+              {
+                dst.write_u32(baked_flat_interpolator);
+              }
+          }
+      }
+    return true;
+  }
+
+  void
+  read_path(fastuidraw::detail::BlobReader &src, fastuidraw::Path &path)
+  {
+    unsigned int num_contours;
+
+    num_contours = src.read_u32();
+    for(unsigned int c = 0; c < num_contours && !src.failed(); ++c)
+      {
+        unsigned int num_points;
+
+        num_points = src.read_u32();
+        if(num_points == 0)
+          {
+            src.fail();
+          }
+
+        for(unsigned int i = 0; i < num_points && !src.failed(); ++i)
+          {
+            path << src.read_vec2();
+            if(src.read_u32() == baked_bezier_interpolator)
+              {
+                unsigned int num_control_pts;
+
+                num_control_pts = src.read_u32();
+                for(unsigned int k = 0; k < num_control_pts && !src.failed(); ++k)
+                  {
+                    path << fastuidraw::Path::control_point(src.read_vec2());
+                  }
+              }
+          }
+
+        if(!src.failed())
+          {
+            path << fastuidraw::Path::contour_end();
+          }
+      }
+  }
+
+  void
+  write_ivec2(fastuidraw::detail::BlobWriter &dst, const fastuidraw::ivec2 &v)
+  {
+    dst.write_i32(v.x());
+    dst.write_i32(v.y());
+  }
+
+  /* reads a resolution, failing if it is negative or so
+     large that the blob cannot possibly hold the texels
+   */
+  fastuidraw::ivec2
+  read_resolution(fastuidraw::detail::BlobReader &src)
+  {
+    fastuidraw::ivec2 v;
+
+    v.x() = src.read_i32();
+    v.y() = src.read_i32();
+    if(v.x() < 0 || v.y() < 0 || v.x() > 0xFFFF || v.y() > 0xFFFF)
+      {
+        src.fail();
+        return fastuidraw::ivec2(0, 0);
+      }
+    return v;
+  }
+
+  void
+  write_per_curve(fastuidraw::detail::BlobWriter &dst,
+                  const fastuidraw::GlyphRenderDataCurvePair::per_curve &v)
+  {
+    dst.write_float(v.m_m0);
+    dst.write_float(v.m_m1);
+    dst.write_vec2(v.m_q);
+    dst.write_float(v.m_quad_coeff);
+  }
+
+  void
+  read_per_curve(fastuidraw::detail::BlobReader &src,
+                 fastuidraw::GlyphRenderDataCurvePair::per_curve &v)
+  {
+    v.m_m0 = src.read_float();
+    v.m_m1 = src.read_float();
+    v.m_q = src.read_vec2();
+    v.m_quad_coeff = src.read_float();
+  }
+
+  /* Returns false if data is not of the class that
+     FontFreeType generates for the glyph type.
+   */
+  bool
+  write_glyph_data(fastuidraw::detail::BlobWriter &dst, enum fastuidraw::glyph_type tp,
+                   const fastuidraw::GlyphRenderData *data)
+  {
+    switch(tp)
+      {
+      case fastuidraw::coverage_glyph:
+        {
+          const fastuidraw::GlyphRenderDataCoverage *p;
+          p = dynamic_cast<const fastuidraw::GlyphRenderDataCoverage*>(data);
+          if(!p)
+            {
+              return false;
+            }
+          write_ivec2(dst, p->resolution());
+          dst.write_packed_array(p->coverage_values());
+        }
+        return true;
+
+      case fastuidraw::distance_field_glyph:
+        {
+          const fastuidraw::GlyphRenderDataDistanceField *p;
+          p = dynamic_cast<const fastuidraw::GlyphRenderDataDistanceField*>(data);
+          if(!p)
+            {
+              return false;
+            }
+          write_ivec2(dst, p->resolution());
+          dst.write_packed_array(p->distance_values());
+        }
+        return true;
+
+      case fastuidraw::msdf_glyph:
+        {
+          const fastuidraw::GlyphRenderDataMSDF *p;
+          p = dynamic_cast<const fastuidraw::GlyphRenderDataMSDF*>(data);
+          if(!p)
+            {
+              return false;
+            }
+          write_ivec2(dst, p->resolution());
+          dst.write_packed_array(p->distance_values(fastuidraw::GlyphRenderDataMSDF::red_channel));
+          dst.write_packed_array(p->distance_values(fastuidraw::GlyphRenderDataMSDF::green_channel));
+          dst.write_packed_array(p->distance_values(fastuidraw::GlyphRenderDataMSDF::blue_channel));
+        }
+        return true;
+
+      case fastuidraw::curve_pair_glyph:
+        {
+          const fastuidraw::GlyphRenderDataCurvePair *p;
+          p = dynamic_cast<const fastuidraw::GlyphRenderDataCurvePair*>(data);
+          if(!p)
+            {
+              return false;
+            }
+          write_ivec2(dst, p->resolution());
+          dst.write_packed_array(p->active_curve_pair());
+          dst.write_u32(p->geometry_data().size());
+          for(unsigned int i = 0, endi = p->geometry_data().size(); i < endi; ++i)
+            {
+              const fastuidraw::GlyphRenderDataCurvePair::entry &E(p->geometry_data()[i]);
+              dst.write_vec2(E.m_p);
+              write_per_curve(dst, E.m_curve0);
+              write_per_curve(dst, E.m_curve1);
+              dst.write_bool(E.m_use_min);
+              dst.write_float(E.m_zeta);
+              dst.write_u32(E.m_type);
+            }
+          dst.write_u32(p->number_approximated_texels());
+        }
+        return true;
+
+      case fastuidraw::banded_curves_glyph:
+        {
+          const fastuidraw::GlyphRenderDataBandedCurves *p;
+          p = dynamic_cast<const fastuidraw::GlyphRenderDataBandedCurves*>(data);
+          if(!p)
+            {
+              return false;
+            }
+          /* the bands and cell values are recomputed
+             from the curves when read back.
+           */
+          write_ivec2(dst, p->number_bands());
+          dst.write_u32(p->curves().size());
+          for(unsigned int i = 0, endi = p->curves().size(); i < endi; ++i)
+            {
+              dst.write_vec2(p->curves()[i].m_p0);
+              dst.write_vec2(p->curves()[i].m_p1);
+              dst.write_vec2(p->curves()[i].m_p2);
+            }
+        }
+        return true;
+
+      default:
+        return false;
+      }
+  }
+
+  /* returns NULL if the blob is malformed
+   */
+  fastuidraw::GlyphRenderData*
+  read_glyph_data(fastuidraw::detail::BlobReader &src, enum fastuidraw::glyph_type tp)
+  {
+    fastuidraw::GlyphRenderData *return_value(NULL);
+    fastuidraw::ivec2 res;
+
+    res = read_resolution(src);
+    if(src.failed())
+      {
+        return NULL;
+      }
+
+    switch(tp)
+      {
+      case fastuidraw::coverage_glyph:
+        {
+          fastuidraw::GlyphRenderDataCoverage *p;
+          p = FASTUIDRAWnew fastuidraw::GlyphRenderDataCoverage();
+          p->resize(res);
+          src.read_packed_array(p->coverage_values());
+          return_value = p;
+        }
+        break;
+
+      case fastuidraw::distance_field_glyph:
+        {
+          fastuidraw::GlyphRenderDataDistanceField *p;
+          p = FASTUIDRAWnew fastuidraw::GlyphRenderDataDistanceField();
+          p->resize(res);
+          src.read_packed_array(p->distance_values());
+          return_value = p;
+        }
+        break;
+
+      case fastuidraw::msdf_glyph:
+        {
+          fastuidraw::GlyphRenderDataMSDF *p;
+          p = FASTUIDRAWnew fastuidraw::GlyphRenderDataMSDF();
+          p->resize(res);
+          src.read_packed_array(p->distance_values(fastuidraw::GlyphRenderDataMSDF::red_channel));
+          src.read_packed_array(p->distance_values(fastuidraw::GlyphRenderDataMSDF::green_channel));
+          src.read_packed_array(p->distance_values(fastuidraw::GlyphRenderDataMSDF::blue_channel));
+          return_value = p;
+        }
+        break;
+
+      case fastuidraw::curve_pair_glyph:
+        {
+          fastuidraw::GlyphRenderDataCurvePair *p;
+          unsigned int num_entries;
+
+          p = FASTUIDRAWnew fastuidraw::GlyphRenderDataCurvePair();
+          p->resize_active_curve_pair(res);
+          src.read_packed_array(p->active_curve_pair());
+          num_entries = src.read_u32();
+          if(num_entries > 0xFFFF)
+            {
+              src.fail();
+            }
+
+          if(!src.failed())
+            {
+              p->resize_geometry_data(num_entries);
+            }
+
+          for(unsigned int i = 0; i < num_entries && !src.failed(); ++i)
+            {
+              fastuidraw::GlyphRenderDataCurvePair::entry &E(p->geometry_data()[i]);
+              uint32_t entry_type;
+
+              E.m_p = src.read_vec2();
+              read_per_curve(src, E.m_curve0);
+              read_per_curve(src, E.m_curve1);
+              E.m_use_min = src.read_bool();
+              E.m_zeta = src.read_float();
+              entry_type = src.read_u32();
+              if(entry_type > fastuidraw::GlyphRenderDataCurvePair::entry_completely_uncovered)
+                {
+                  src.fail();
+                }
+              E.m_type = static_cast<enum fastuidraw::GlyphRenderDataCurvePair::entry_type>(entry_type);
+            }
+          p->number_approximated_texels(src.read_u32());
+          return_value = p;
+        }
+        break;
+
+      case fastuidraw::banded_curves_glyph:
+        {
+          fastuidraw::GlyphRenderDataBandedCurves *p;
+          std::vector<fastuidraw::GlyphRenderDataBandedCurves::curve> curves;
+          unsigned int num_curves;
+
+          num_curves = src.read_u32();
+          if(num_curves > 0xFFFF || (num_curves > 0 && (res.x() == 0 || res.y() == 0)))
+            {
+              src.fail();
+            }
+
+          for(unsigned int i = 0; i < num_curves && !src.failed(); ++i)
+            {
+              fastuidraw::vec2 p0, p1, p2;
+
+              p0 = src.read_vec2();
+              p1 = src.read_vec2();
+              p2 = src.read_vec2();
+              curves.push_back(fastuidraw::GlyphRenderDataBandedCurves::curve(p0, p1, p2));
+            }
+
+          if(!src.failed())
+            {
+              p = FASTUIDRAWnew fastuidraw::GlyphRenderDataBandedCurves();
+              p->set_curves(res, curves.empty() ?
+                            fastuidraw::const_c_array<fastuidraw::GlyphRenderDataBandedCurves::curve>() :
+                            make_c_array(curves));
+              return_value = p;
+            }
+        }
+        break;
+
+      default:
+        src.fail();
+      }
+
+    if(src.failed() && return_value)
+      {
+        FASTUIDRAWdelete(return_value);
+        return_value = NULL;
+      }
+    return return_value;
+  }
 }
 
 /////////////////////////////////////////////////////////
@@ -135,8 +1023,23 @@ GlyphDataPrivate::
 clear(void)
 {
   m_render = fastuidraw::GlyphRender();
+  m_font = NULL;
+  ++m_generation;
   assert(!m_render.valid());
 
+  remove_from_atlas();
+  if(m_glyph_data)
+    {
+      FASTUIDRAWdelete(m_glyph_data);
+      m_glyph_data = NULL;
+    }
+  m_path.clear();
+}
+
+void
+GlyphDataPrivate::
+remove_from_atlas(void)
+{
   if(m_atlas_location[0].valid())
     {
       m_cache->m_atlas->deallocate(m_atlas_location[0]);
@@ -155,14 +1058,14 @@ clear(void)
       m_geometry_offset = -1;
       m_geometry_length = 0;
     }
-
   m_uploaded_to_atlas = false;
-  if(m_glyph_data)
-    {
-      FASTUIDRAWdelete(m_glyph_data);
-      m_glyph_data = NULL;
-    }
-  m_path.clear();
+}
+
+void
+GlyphDataPrivate::
+mark_used(void)
+{
+  m_last_used_frame = m_cache->m_current_frame;
 }
 
 enum fastuidraw::return_code
@@ -182,6 +1085,7 @@ upload_to_atlas(void)
    */
   enum fastuidraw::return_code return_value;
 
+  mark_used();
   if(m_uploaded_to_atlas)
     {
       return fastuidraw::routine_success;
@@ -193,9 +1097,15 @@ upload_to_atlas(void)
                                                m_atlas_location[1],
                                                m_geometry_offset,
                                                m_geometry_length);
+  if(return_value != fastuidraw::routine_success)
+    {
+      return_value = m_cache->evict_and_upload(this);
+    }
+
   if(return_value == fastuidraw::routine_success)
     {
       m_uploaded_to_atlas = true;
+      FASTUIDRAWincrement_stat(m_cache->m_stats[fastuidraw::GlyphCache::num_uploads], 1u);
     }
 
   return return_value;
@@ -203,23 +1113,152 @@ upload_to_atlas(void)
 
 
 
+/////////////////////////////////////////////////
+// GlyphPrefetcher methods
+GlyphPrefetcher::
+GlyphPrefetcher(void):
+  m_scheduled(false)
+{}
+
+GlyphPrefetcher::
+~GlyphPrefetcher()
+{
+  boost::unique_lock<boost::mutex> m(m_mutex);
+
+  assert(m_queue.empty());
+  assert(m_done.empty());
+  while(m_scheduled)
+    {
+      m_job_done.wait(m);
+    }
+}
+
+void
+GlyphPrefetcher::
+add_job(PrefetchJob *job)
+{
+  bool schedule;
+
+  {
+    boost::lock_guard<boost::mutex> m(m_mutex);
+    m_queue.push_back(job);
+    schedule = !m_scheduled;
+    m_scheduled = true;
+  }
+
+  if(schedule)
+    {
+      fastuidraw::default_task_executor()->run_task_async(this);
+    }
+}
+
+void
+GlyphPrefetcher::
+wait(PrefetchJob *job)
+{
+  boost::unique_lock<boost::mutex> m(m_mutex);
+  while(!job->m_done)
+    {
+      m_job_done.wait(m);
+    }
+}
+
+void
+GlyphPrefetcher::
+take_done_jobs(std::vector<PrefetchJob*> &dst)
+{
+  boost::lock_guard<boost::mutex> m(m_mutex);
+  dst.insert(dst.end(), m_done.begin(), m_done.end());
+  m_done.clear();
+}
+
+void
+GlyphPrefetcher::
+take_all_jobs(std::vector<PrefetchJob*> &dst)
+{
+  boost::unique_lock<boost::mutex> m(m_mutex);
+
+  dst.insert(dst.end(), m_queue.begin(), m_queue.end());
+  m_queue.clear();
+  while(!m_in_progress.empty())
+    {
+      m_job_done.wait(m);
+    }
+  dst.insert(dst.end(), m_done.begin(), m_done.end());
+  m_done.clear();
+}
+
+void
+GlyphPrefetcher::
+run(void)
+{
+  boost::unique_lock<boost::mutex> m(m_mutex);
+  while(!m_queue.empty())
+    {
+      unsigned int max_batch;
+
+      /* a few jobs per thread of the executor, so that a
+         wait() on a job of the batch is not much longer
+         than generating one glyph per thread.
+       */
+      max_batch = 4u * std::max(1u, fastuidraw::default_task_executor()->number_threads());
+      assert(m_in_progress.empty());
+      while(!m_queue.empty() && m_in_progress.size() < max_batch)
+        {
+          m_in_progress.push_back(m_queue.front());
+          m_queue.pop_front();
+        }
+
+      m.unlock();
+      GeneratePrefetchJobs generate(m_in_progress);
+      fastuidraw::run_in_parallel(m_in_progress.size(), 0, 1, generate);
+      m.lock();
+
+      for(unsigned int i = 0, endi = m_in_progress.size(); i < endi; ++i)
+        {
+          m_in_progress[i]->m_done = true;
+        }
+      m_done.insert(m_done.end(), m_in_progress.begin(), m_in_progress.end());
+      m_in_progress.clear();
+      m_job_done.notify_all();
+    }
+
+  m_scheduled = false;
+  m_job_done.notify_all();
+}
+
 /////////////////////////////////////////////////
 // GlyphCachePrivate methods
 GlyphCachePrivate::
 GlyphCachePrivate(fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlas> patlas,
                   fastuidraw::GlyphCache *p):
   m_atlas(patlas),
-  m_p(p)
+  m_stats(0),
+  m_p(p),
+  m_current_frame(0),
+  m_compact_layer(-1),
+  m_compact_failed_layer(-1),
+  m_compact_failed_texels(0),
+  m_deferring_generation(false),
+  m_prefetcher(NULL)
 {}
 
 GlyphCachePrivate::
 ~GlyphCachePrivate()
 {
+  cancel_prefetches();
+  if(m_prefetcher)
+    {
+      FASTUIDRAWdelete(m_prefetcher);
+    }
+
   for(unsigned int i = 0, endi = m_glyphs.size(); i < endi; ++i)
     {
       m_glyphs[i]->clear();
       FASTUIDRAWdelete(m_glyphs[i]);
     }
+  fastuidraw::detail::memory_report_shrink(fastuidraw::memory::subsystem_glyph_cache,
+                                           m_glyphs.size() * sizeof(GlyphDataPrivate), 0);
 }
 
 
@@ -227,13 +1266,12 @@ GlyphDataPrivate*
 GlyphCachePrivate::
 fetch_or_allocate_glyph(GlyphSource src)
 {
-  std::map<GlyphSource, GlyphDataPrivate*>::iterator iter;
   GlyphDataPrivate *G;
 
-  iter = m_glyph_map.find(src);
-  if(iter != m_glyph_map.end())
+  G = m_glyph_map.find(src);
+  if(G != NULL)
     {
-      return iter->second;
+      return G;
     }
 
 
@@ -241,6 +1279,8 @@ fetch_or_allocate_glyph(GlyphSource src)
     {
       G = FASTUIDRAWnew GlyphDataPrivate(this, m_glyphs.size());
       m_glyphs.push_back(G);
+      fastuidraw::detail::memory_report_grow(fastuidraw::memory::subsystem_glyph_cache,
+                                             sizeof(GlyphDataPrivate), 0);
       assert(!G->m_render.valid());
     }
   else
@@ -250,10 +1290,293 @@ fetch_or_allocate_glyph(GlyphSource src)
       G = m_glyphs[v];
       assert(!G->m_render.valid());
     }
-  m_glyph_map[src] = G;
+  G->m_font = src.m_font.get();
+  G->m_glyph_code = src.m_glyph_code;
+  m_glyph_map.insert(src, G);
   return G;
 }
 
+void
+GlyphCachePrivate::
+absorb_job(PrefetchJob *job)
+{
+  GlyphDataPrivate *G(job->m_glyph);
+
+  assert(G->m_prefetch == job);
+  assert(!G->m_glyph_data);
+  G->m_glyph_data = job->m_glyph_data;
+  G->m_layout = job->m_layout;
+  G->m_path.swap(job->m_path);
+  G->m_prefetch = NULL;
+  FASTUIDRAWdelete(job);
+}
+
+void
+GlyphCachePrivate::
+absorb_prefetched_glyphs(void)
+{
+  if(!m_prefetcher)
+    {
+      return;
+    }
+
+  m_work_room_jobs.clear();
+  m_prefetcher->take_done_jobs(m_work_room_jobs);
+  for(unsigned int i = 0, endi = m_work_room_jobs.size(); i < endi; ++i)
+    {
+      absorb_job(m_work_room_jobs[i]);
+    }
+  m_work_room_jobs.clear();
+}
+
+void
+GlyphCachePrivate::
+finish_prefetch(GlyphDataPrivate *G)
+{
+  assert(G->m_prefetch);
+  m_prefetcher->wait(G->m_prefetch);
+  absorb_prefetched_glyphs();
+  assert(!G->m_prefetch);
+}
+
+void
+GlyphCachePrivate::
+cancel_prefetches(void)
+{
+  if(!m_prefetcher)
+    {
+      return;
+    }
+
+  m_work_room_jobs.clear();
+  m_prefetcher->take_all_jobs(m_work_room_jobs);
+  for(unsigned int i = 0, endi = m_work_room_jobs.size(); i < endi; ++i)
+    {
+      PrefetchJob *job(m_work_room_jobs[i]);
+      if(job->m_done)
+        {
+          absorb_job(job);
+        }
+      else
+        {
+          /* the glyph is removed from the
+             cache as it has no data
+           */
+          GlyphDataPrivate *G(job->m_glyph);
+
+          G->m_prefetch = NULL;
+          m_glyph_map.erase(job->m_src);
+          G->clear();
+          m_free_slots.push_back(G->m_cache_location);
+          FASTUIDRAWdelete(job);
+        }
+    }
+  m_work_room_jobs.clear();
+}
+
+enum fastuidraw::return_code
+GlyphCachePrivate::
+evict_and_upload(GlyphDataPrivate *G)
+{
+  enum fastuidraw::return_code return_value(fastuidraw::routine_fail);
+
+  m_evict_candidates.clear();
+  for(unsigned int i = 0, endi = m_glyphs.size(); i < endi; ++i)
+    {
+      GlyphDataPrivate *p(m_glyphs[i]);
+      if(p->m_uploaded_to_atlas && p->m_last_used_frame != m_current_frame)
+        {
+          m_evict_candidates.push_back(p);
+        }
+    }
+
+  if(m_evict_candidates.empty())
+    {
+      return fastuidraw::routine_fail;
+    }
+
+  std::sort(m_evict_candidates.begin(), m_evict_candidates.end(), GlyphLastUsedCompare());
+
+  /* evict the cold glyphs in batches of doubling size
+     so that the number of upload attempts is logarithmic
+     in the number of glyphs that need to be evicted;
+     a glyph only fits once the freed regions are large
+     enough, so evicting just one glyph at a time would
+     attempt an upload per evicted glyph.
+   */
+  for(unsigned int begin = 0, batch = 1, endi = m_evict_candidates.size();
+      begin < endi && return_value != fastuidraw::routine_success; batch *= 2)
+    {
+      unsigned int end;
+
+      end = std::min(endi, begin + batch);
+      FASTUIDRAWincrement_stat(m_stats[fastuidraw::GlyphCache::num_evictions], end - begin);
+      for(; begin < end; ++begin)
+        {
+          m_evict_candidates[begin]->remove_from_atlas();
+        }
+
+      return_value = G->m_glyph_data->upload_to_atlas(m_atlas,
+                                                      G->m_atlas_location[0],
+                                                      G->m_atlas_location[1],
+                                                      G->m_geometry_offset,
+                                                      G->m_geometry_length);
+    }
+  m_evict_candidates.clear();
+
+  return return_value;
+}
+
+int
+GlyphCachePrivate::
+vacate_layers(int number_layers)
+{
+  std::vector<GlyphDataPrivate*> hot;
+  unsigned int next_candidate(0), batch(1);
+  int return_value(number_layers);
+
+  m_evict_candidates.clear();
+  for(unsigned int i = 0, endi = m_glyphs.size(); i < endi; ++i)
+    {
+      GlyphDataPrivate *p(m_glyphs[i]);
+      bool cold, on_removed_layer(false);
+
+      if(!p->m_uploaded_to_atlas)
+        {
+          continue;
+        }
+
+      for(unsigned int k = 0; k < 2; ++k)
+        {
+          on_removed_layer = on_removed_layer
+            || (p->m_atlas_location[k].valid() && p->m_atlas_location[k].layer() >= number_layers);
+        }
+
+      cold = (p->m_last_used_frame != m_current_frame);
+      if(on_removed_layer && cold)
+        {
+          FASTUIDRAWincrement_stat(m_stats[fastuidraw::GlyphCache::num_evictions], 1);
+          p->remove_from_atlas();
+        }
+      else if(on_removed_layer)
+        {
+          hot.push_back(p);
+        }
+      else if(cold)
+        {
+          m_evict_candidates.push_back(p);
+        }
+    }
+
+  std::sort(m_evict_candidates.begin(), m_evict_candidates.end(), GlyphLastUsedCompare());
+
+  for(unsigned int i = 0, endi = hot.size(); i < endi; ++i)
+    {
+      GlyphDataPrivate *p(hot[i]);
+
+      for(unsigned int k = 0; k < 2; ++k)
+        {
+          fastuidraw::GlyphLocation &L(p->m_atlas_location[k]);
+          fastuidraw::GlyphLocation moved;
+
+          if(!L.valid() || L.layer() < number_layers)
+            {
+              continue;
+            }
+
+          moved = m_atlas->relocate(L, -1, number_layers);
+
+          /* evict the cold glyphs of the kept layers in batches
+             of doubling size, as in evict_and_upload(), until
+             the glyph fits.
+           */
+          while(!moved.valid() && next_candidate < m_evict_candidates.size())
+            {
+              unsigned int end;
+
+              end = std::min(static_cast<unsigned int>(m_evict_candidates.size()), next_candidate + batch);
+              FASTUIDRAWincrement_stat(m_stats[fastuidraw::GlyphCache::num_evictions], end - next_candidate);
+              for(; next_candidate < end; ++next_candidate)
+                {
+                  m_evict_candidates[next_candidate]->remove_from_atlas();
+                }
+              batch *= 2;
+              moved = m_atlas->relocate(L, -1, number_layers);
+            }
+
+          if(moved.valid())
+            {
+              FASTUIDRAWincrement_stat(m_stats[fastuidraw::GlyphCache::num_relocations], 1);
+              L = moved;
+            }
+          else
+            {
+              return_value = std::max(return_value, L.layer() + 1);
+            }
+        }
+    }
+  m_evict_candidates.clear();
+
+  return return_value;
+}
+
+int
+GlyphCachePrivate::
+choose_compact_layer(void) const
+{
+  fastuidraw::ivec3 dims(m_atlas->texel_store()->dimensions());
+  int layer_texels, free_texels, return_value, return_value_texels;
+
+  /* emptying a layer only helps if there is another layer
+     to which to move its glyphs and no layer is empty
+     already.
+   */
+  if(dims.z() < 2)
+    {
+      return -1;
+    }
+
+  layer_texels = dims.x() * dims.y();
+  free_texels = 0;
+  return_value = -1;
+  return_value_texels = layer_texels;
+  for(int layer = 0; layer < dims.z(); ++layer)
+    {
+      int texels;
+
+      texels = m_atlas->number_texels_allocated(layer);
+      if(texels == 0)
+        {
+          return -1;
+        }
+
+      free_texels += layer_texels - texels;
+      if(texels < return_value_texels
+         && (layer != m_compact_failed_layer || texels != m_compact_failed_texels))
+        {
+          return_value = layer;
+          return_value_texels = texels;
+        }
+    }
+
+  /* only empty a layer that is at most half used and whose
+     glyphs take at most half of the free room of the other
+     layers, the free room of a fragmented layer is far from
+     perfectly usable.
+   */
+  if(return_value != -1)
+    {
+      free_texels -= layer_texels - return_value_texels;
+      if(2 * return_value_texels > layer_texels
+         || 2 * return_value_texels > free_texels)
+        {
+          return_value = -1;
+        }
+    }
+
+  return return_value;
+}
+
 ///////////////////////////////////////////////////////
 // fastuidraw::Glyph methods
 enum fastuidraw::glyph_type
@@ -266,6 +1589,16 @@ type(void) const
   return p->m_render.m_type;
 }
 
+fastuidraw::GlyphRender
+fastuidraw::Glyph::
+renderer(void) const
+{
+  GlyphDataPrivate *p;
+  p = static_cast<GlyphDataPrivate*>(m_opaque);
+  assert(p != NULL);
+  return p->m_render;
+}
+
 const fastuidraw::GlyphLayoutData&
 fastuidraw::Glyph::
 layout(void) const
@@ -296,6 +1629,16 @@ cache_location(void) const
   return p->m_cache_location;
 }
 
+unsigned int
+fastuidraw::Glyph::
+generation(void) const
+{
+  GlyphDataPrivate *p;
+  p = static_cast<GlyphDataPrivate*>(m_opaque);
+  assert(p != NULL);
+  return p->m_generation;
+}
+
 fastuidraw::GlyphLocation
 fastuidraw::Glyph::
 atlas_location(void) const
@@ -346,6 +1689,19 @@ path(void) const
   return p->m_path;
 }
 
+unsigned int
+fastuidraw::Glyph::
+number_approximated_texels(void) const
+{
+  GlyphDataPrivate *p;
+  const GlyphRenderDataCurvePair *q;
+
+  p = static_cast<GlyphDataPrivate*>(m_opaque);
+  assert(p != NULL && p->m_render.valid());
+  q = dynamic_cast<const GlyphRenderDataCurvePair*>(p->m_glyph_data);
+  return (q != NULL) ? q->number_approximated_texels() : 0u;
+}
+
 
 //////////////////////////////////////////////////////////
 // fastuidraw::GlyphCache methods
@@ -383,14 +1739,135 @@ fetch_glyph(GlyphRender render,
   GlyphSource src(font, glyph_code, render);
 
   q = d->fetch_or_allocate_glyph(src);
+  q->mark_used();
 
   if(!q->m_render.valid())
     {
+      FASTUIDRAWincrement_stat(d->m_stats[num_misses], 1u);
       q->m_render = render;
       assert(!q->m_glyph_data);
-      q->m_glyph_data = font->compute_rendering_data(q->m_render, glyph_code, q->m_layout, q->m_path);
+      if(d->m_deferring_generation)
+        {
+          d->m_deferred_glyphs.push_back(DeferredGlyph(q, src));
+        }
+      else
+        {
+          q->m_glyph_data = font->compute_rendering_data(q->m_render, glyph_code, q->m_layout, q->m_path);
+        }
+    }
+  else
+    {
+      FASTUIDRAWincrement_stat(d->m_stats[num_hits], 1u);
+      if(q->m_prefetch)
+        {
+          d->finish_prefetch(q);
+        }
+    }
+
+  return Glyph(q);
+}
+
+fastuidraw::GlyphLayoutData
+fastuidraw::GlyphCache::
+fetch_glyph_layout(GlyphRender render,
+                   const reference_counted_ptr<const FontBase> &font,
+                   uint32_t glyph_code)
+{
+  if(!font || !font->can_create_rendering_data(render.m_type))
+    {
+      return GlyphLayoutData();
+    }
+
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  GlyphDataPrivate *q;
+  GlyphSource src(font, glyph_code, render);
+
+  /* the layout of a glyph is set when its rendering data is
+     generated, so a glyph that is deferred or whose prefetch
+     is not done is not yet usable.
+   */
+  q = d->m_glyph_map.find(src);
+  if(q != NULL && q->m_render.valid() && q->m_glyph_data != NULL)
+    {
+      return q->m_layout;
+    }
+
+  LayoutMap::iterator iter;
+  iter = d->m_layout_map.find(src);
+  if(iter != d->m_layout_map.end())
+    {
+      return iter->second;
     }
 
+  GlyphLayoutData L;
+
+  FASTUIDRAWincrement_stat(d->m_stats[num_layout_misses], 1u);
+  font->compute_layout_data(render, glyph_code, L);
+  d->m_layout_map[src] = L;
+  return L;
+}
+
+void
+fastuidraw::GlyphCache::
+prefetch_glyph(GlyphRender render,
+               const reference_counted_ptr<const FontBase> &font,
+               uint32_t glyph_code)
+{
+  if(!font || !font->can_create_rendering_data(render.m_type))
+    {
+      return;
+    }
+
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  GlyphDataPrivate *q;
+  GlyphSource src(font, glyph_code, render);
+
+  q = d->fetch_or_allocate_glyph(src);
+  if(q->m_render.valid())
+    {
+      return;
+    }
+
+  FASTUIDRAWincrement_stat(d->m_stats[num_misses], 1u);
+  q->m_render = render;
+  if(!d->m_prefetcher)
+    {
+      d->m_prefetcher = FASTUIDRAWnew GlyphPrefetcher();
+    }
+  q->m_prefetch = FASTUIDRAWnew PrefetchJob(q, src);
+  d->m_prefetcher->add_job(q->m_prefetch);
+}
+
+fastuidraw::Glyph
+fastuidraw::GlyphCache::
+fetch_glyph_if_ready(GlyphRender render,
+                     const reference_counted_ptr<const FontBase> &font,
+                     uint32_t glyph_code)
+{
+  if(!font || !font->can_create_rendering_data(render.m_type))
+    {
+      return Glyph();
+    }
+
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  GlyphDataPrivate *q;
+  GlyphSource src(font, glyph_code, render);
+
+  d->absorb_prefetched_glyphs();
+  q = d->m_glyph_map.find(src);
+  if(q == NULL || q->m_prefetch != NULL || q->m_glyph_data == NULL)
+    {
+      return Glyph();
+    }
+
+  FASTUIDRAWincrement_stat(d->m_stats[num_hits], 1u);
+  q->mark_used();
   return Glyph(q);
 }
 
@@ -406,7 +1883,9 @@ delete_glyph(Glyph G)
   p = static_cast<GlyphDataPrivate*>(G.m_opaque);
   assert(p != NULL);
   assert(p->m_cache == d);
+  assert(!d->m_deferring_generation);
   assert(p->m_render.valid());
+  assert(!p->m_prefetch);
 
   GlyphSource src(p->m_layout.m_font, p->m_layout.m_glyph_code, p->m_render);
   d->m_glyph_map.erase(src);
@@ -414,6 +1893,435 @@ delete_glyph(Glyph G)
   d->m_free_slots.push_back(p->m_cache_location);
 }
 
+uint32_t
+fastuidraw::GlyphCache::
+baked_glyphs_blob_version(void)
+{
+  return BakedGlyphsConstants::blob_version;
+}
+
+unsigned int
+fastuidraw::GlyphCache::
+bake_glyphs(std::vector<uint8_t> &dst, GlyphRender render,
+            const reference_counted_ptr<const FontBase> &font,
+            const_c_array<uint32_t> glyph_codes)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  assert(!d->m_deferring_generation);
+  FASTUIDRAWunused(d);
+
+  detail::BlobWriter glyphs;
+  unsigned int num_glyphs(0);
+
+  for(unsigned int i = 0, endi = glyph_codes.size(); i < endi; ++i)
+    {
+      Glyph G;
+      GlyphDataPrivate *q;
+      detail::BlobWriter glyph;
+
+      G = fetch_glyph(render, font, glyph_codes[i]);
+      if(!G.valid())
+        {
+          continue;
+        }
+
+      q = static_cast<GlyphDataPrivate*>(G.m_opaque);
+      glyph.write_u32(q->m_layout.m_glyph_code);
+      glyph.write_vec2(q->m_layout.m_horizontal_layout_offset);
+      glyph.write_vec2(q->m_layout.m_vertical_layout_offset);
+      glyph.write_vec2(q->m_layout.m_size);
+      glyph.write_vec2(q->m_layout.m_advance);
+      glyph.write_i32(q->m_layout.m_pixel_size);
+      if(q->m_glyph_data
+         && write_path(glyph, q->m_path)
+         && write_glyph_data(glyph, q->m_render.m_type, q->m_glyph_data))
+        {
+          glyphs.append(glyph);
+          ++num_glyphs;
+        }
+    }
+
+  detail::BlobWriter blob;
+  blob.write_u32(BakedGlyphsConstants::blob_magic);
+  blob.write_u32(BakedGlyphsConstants::blob_version);
+  blob.write_u32(render.m_type);
+  blob.write_i32(render.m_pixel_size);
+  blob.write_i32(render.m_subpixel_offset);
+  blob.write_u32(num_glyphs);
+  blob.append(glyphs);
+  blob.finish(dst);
+
+  return num_glyphs;
+}
+
+int
+fastuidraw::GlyphCache::
+load_baked_glyphs(const_c_array<uint8_t> blob,
+                  const reference_counted_ptr<const FontBase> &font)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  assert(!d->m_deferring_generation);
+
+  std::vector<uint32_t> backing;
+  detail::BlobReader src(blob, backing);
+  std::vector<BakedGlyph> glyphs;
+  GlyphRender render;
+  uint32_t render_type, num_glyphs;
+  int return_value(0);
+
+  if(!font
+     || src.read_u32() != BakedGlyphsConstants::blob_magic
+     || src.read_u32() != BakedGlyphsConstants::blob_version)
+    {
+      src.fail();
+    }
+
+  render_type = src.read_u32();
+  render.m_pixel_size = src.read_i32();
+  render.m_subpixel_offset = src.read_i32();
+  num_glyphs = src.read_u32();
+  if(render_type > msdf_glyph || num_glyphs > blob.size())
+    {
+      src.fail();
+    }
+  render.m_type = static_cast<enum glyph_type>(render_type);
+  if(!render.valid())
+    {
+      src.fail();
+    }
+
+  /* read all glyphs before adding any so that a
+     malformed blob does not add any glyphs.
+   */
+  if(!src.failed())
+    {
+      glyphs.resize(num_glyphs);
+    }
+
+  for(unsigned int i = 0; i < glyphs.size() && !src.failed(); ++i)
+    {
+      BakedGlyph &G(glyphs[i]);
+
+      G.m_layout.m_glyph_code = src.read_u32();
+      G.m_layout.m_horizontal_layout_offset = src.read_vec2();
+      G.m_layout.m_vertical_layout_offset = src.read_vec2();
+      G.m_layout.m_size = src.read_vec2();
+      G.m_layout.m_advance = src.read_vec2();
+      G.m_layout.m_pixel_size = src.read_i32();
+      G.m_layout.m_font = font;
+      read_path(src, G.m_path);
+      if(!src.failed())
+        {
+          G.m_glyph_data = read_glyph_data(src, render.m_type);
+        }
+    }
+
+  for(unsigned int i = 0, endi = glyphs.size(); i < endi; ++i)
+    {
+      BakedGlyph &G(glyphs[i]);
+      GlyphDataPrivate *q;
+
+      if(src.failed())
+        {
+          if(G.m_glyph_data)
+            {
+              FASTUIDRAWdelete(G.m_glyph_data);
+            }
+          continue;
+        }
+
+      /* the prefetch of a glyph already in the cache is not
+         to be disturbed, just as fetch_glyph() would not.
+       */
+      GlyphSource glyph_src(font, G.m_layout.m_glyph_code, render);
+      q = d->fetch_or_allocate_glyph(glyph_src);
+      if(q->m_render.valid())
+        {
+          FASTUIDRAWdelete(G.m_glyph_data);
+          continue;
+        }
+
+      q->m_render = render;
+      q->m_layout = G.m_layout;
+      q->m_path.swap(G.m_path);
+      q->m_glyph_data = G.m_glyph_data;
+      q->mark_used();
+      if(d->m_atlas)
+        {
+          q->upload_to_atlas();
+        }
+      ++return_value;
+    }
+
+  return src.failed() ? -1 : return_value;
+}
+
+void
+fastuidraw::GlyphCache::
+begin_deferred_generation(void)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  assert(!d->m_deferring_generation);
+  d->m_deferring_generation = true;
+}
+
+void
+fastuidraw::GlyphCache::
+end_deferred_generation(unsigned int max_threads)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  assert(d->m_deferring_generation);
+
+  GenerateDeferredGlyphs job(d->m_deferred_glyphs);
+  fastuidraw::run_in_parallel(d->m_deferred_glyphs.size(), max_threads, 1, job);
+
+  d->m_deferred_glyphs.clear();
+  d->m_deferring_generation = false;
+}
+
+uint32_t
+fastuidraw::GlyphCache::
+usage_profile_version(void)
+{
+  return UsageProfileConstants::blob_version;
+}
+
+unsigned int
+fastuidraw::GlyphCache::
+write_usage_profile(std::vector<uint8_t> &dst,
+                    const_c_array<reference_counted_ptr<const FontBase> > fonts) const
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  std::map<const FontBase*, uint32_t> font_index;
+  detail::BlobWriter keys, blob;
+  unsigned int return_value(0);
+
+  for(unsigned int i = 0; i < fonts.size(); ++i)
+    {
+      if(fonts[i] && font_index.find(fonts[i].get()) == font_index.end())
+        {
+          font_index[fonts[i].get()] = i;
+        }
+    }
+
+  /* m_glyphs is in the order the glyphs were added,
+     except for slots reused after delete_glyph()
+   */
+  for(unsigned int i = 0, endi = d->m_glyphs.size(); i < endi; ++i)
+    {
+      const GlyphDataPrivate *p(d->m_glyphs[i]);
+      std::map<const FontBase*, uint32_t>::const_iterator iter;
+
+      if(!p->m_render.valid())
+        {
+          continue;
+        }
+
+      iter = font_index.find(p->m_font);
+      if(iter == font_index.end())
+        {
+          continue;
+        }
+
+      keys.write_u32(iter->second);
+      keys.write_u32(p->m_glyph_code);
+      keys.write_u32(p->m_render.m_type);
+      keys.write_i32(p->m_render.m_pixel_size);
+      keys.write_i32(p->m_render.m_subpixel_offset);
+      ++return_value;
+    }
+
+  blob.write_u32(UsageProfileConstants::blob_magic);
+  blob.write_u32(UsageProfileConstants::blob_version);
+  blob.write_u32(return_value);
+  blob.append(keys);
+  blob.finish(dst);
+
+  return return_value;
+}
+
+int
+fastuidraw::GlyphCache::
+prefetch_usage_profile(const_c_array<uint8_t> blob,
+                       const_c_array<reference_counted_ptr<const FontBase> > fonts)
+{
+  std::vector<uint32_t> backing;
+  detail::BlobReader src(blob, backing);
+  uint32_t num_keys;
+
+  if(src.read_u32() != UsageProfileConstants::blob_magic
+     || src.read_u32() != UsageProfileConstants::blob_version)
+    {
+      src.fail();
+    }
+
+  num_keys = src.read_u32();
+  if(num_keys > blob.size())
+    {
+      src.fail();
+    }
+
+  /* read all the keys before prefetching any so
+     that a malformed blob prefetches nothing
+   */
+  std::vector<GlyphSource> keys;
+  for(uint32_t i = 0; i < num_keys && !src.failed(); ++i)
+    {
+      uint32_t font, glyph_code, render_type;
+      GlyphRender render;
+
+      font = src.read_u32();
+      glyph_code = src.read_u32();
+      render_type = src.read_u32();
+      render.m_pixel_size = src.read_i32();
+      render.m_subpixel_offset = src.read_i32();
+      if(render_type > msdf_glyph)
+        {
+          src.fail();
+        }
+      render.m_type = static_cast<enum glyph_type>(render_type);
+      if(!render.valid())
+        {
+          src.fail();
+        }
+      if(font < fonts.size() && fonts[font])
+        {
+          keys.push_back(GlyphSource(fonts[font], glyph_code, render));
+        }
+    }
+
+  if(src.failed())
+    {
+      return -1;
+    }
+
+  for(unsigned int i = 0, endi = keys.size(); i < endi; ++i)
+    {
+      prefetch_glyph(keys[i].m_render, keys[i].m_font, keys[i].m_glyph_code);
+    }
+
+  return keys.size();
+}
+
+void
+fastuidraw::GlyphCache::
+begin_frame(void)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  ++d->m_current_frame;
+}
+
+unsigned int
+fastuidraw::GlyphCache::
+compact_atlas(unsigned int max_texels)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  unsigned int return_value(0), texels_moved(0);
+
+  if(d->m_compact_layer == -1)
+    {
+      d->m_compact_layer = d->choose_compact_layer();
+    }
+
+  for(unsigned int i = 0, endi = d->m_glyphs.size();
+      i < endi && d->m_compact_layer != -1 && texels_moved < max_texels; ++i)
+    {
+      GlyphDataPrivate *p(d->m_glyphs[i]);
+
+      for(unsigned int k = 0; k < 2 && d->m_compact_layer != -1; ++k)
+        {
+          GlyphLocation &L(p->m_atlas_location[k]);
+          GlyphLocation moved;
+          ivec2 sz;
+
+          if(!L.valid() || L.layer() != d->m_compact_layer)
+            {
+              continue;
+            }
+
+          moved = d->m_atlas->relocate(L, d->m_compact_layer);
+          if(moved.valid())
+            {
+              /* GlyphLocation::size() does not include the
+                 padding, so the budget is only approximate.
+               */
+              sz = moved.size();
+              texels_moved += std::max(0, sz.x() * sz.y());
+              L = moved;
+              ++return_value;
+            }
+          else
+            {
+              /* the free room of the other layers is too
+                 fragmented, give up on the layer.
+               */
+              d->m_compact_failed_layer = d->m_compact_layer;
+              d->m_compact_failed_texels = d->m_atlas->number_texels_allocated(d->m_compact_layer);
+              d->m_compact_layer = -1;
+            }
+        }
+    }
+
+  if(d->m_compact_layer != -1
+     && d->m_atlas->number_texels_allocated(d->m_compact_layer) == 0)
+    {
+      d->m_compact_layer = -1;
+    }
+
+  FASTUIDRAWincrement_stat(d->m_stats[num_relocations], return_value);
+  return return_value;
+}
+
+uint64_t
+fastuidraw::GlyphCache::
+trim_atlas(uint64_t target_bytes)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  /* the texels of the texel store are 8-bit */
+  ivec3 dims(d->m_atlas->texel_store()->dimensions());
+  uint64_t layer_bytes(uint64_t(dims.x()) * uint64_t(dims.y()));
+  int number_layers(dims.z());
+
+  if(layer_bytes * uint64_t(dims.z()) > target_bytes
+     && d->m_atlas->texel_store()->resizeable())
+    {
+      number_layers = static_cast<int>(target_bytes / layer_bytes);
+      number_layers = std::max(1, number_layers);
+
+      /* if not every glyph could be moved, keep the
+         layers up to the last one that has glyphs.
+       */
+      int keep(d->vacate_layers(number_layers));
+      if(keep < dims.z())
+        {
+          d->m_atlas->shrink_texel_store(keep);
+        }
+      number_layers = d->m_atlas->texel_store()->dimensions().z();
+
+      if(d->m_compact_layer >= number_layers)
+        {
+          d->m_compact_layer = -1;
+        }
+      if(d->m_compact_failed_layer >= number_layers)
+        {
+          d->m_compact_failed_layer = -1;
+        }
+    }
+
+  return layer_bytes * uint64_t(number_layers);
+}
+
 void
 fastuidraw::GlyphCache::
 clear_atlas(void)
@@ -439,9 +2347,12 @@ clear_cache(void)
 {
   GlyphCachePrivate *d;
   d = static_cast<GlyphCachePrivate*>(m_d);
+  assert(!d->m_deferring_generation);
 
+  d->cancel_prefetches();
   d->m_atlas->clear();
   d->m_glyph_map.clear();
+  d->m_layout_map.clear();
 
   for(unsigned int i = 0, endi = d->m_glyphs.size(); i < endi; ++i)
     {
@@ -454,3 +2365,21 @@ clear_cache(void)
         }
     }
 }
+
+unsigned int
+fastuidraw::GlyphCache::
+query_stat(enum stats_t st) const
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  return d->m_stats[st];
+}
+
+void
+fastuidraw::GlyphCache::
+reset_stats(void)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+  std::fill(d->m_stats.begin(), d->m_stats.end(), 0u);
+}
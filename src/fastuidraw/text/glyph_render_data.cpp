@@ -17,20 +17,25 @@
  */
 
 
+#include <cmath>
 #include <fastuidraw/text/glyph_render_data.hpp>
 
 //////////////////////////////////////
 // GlyphRender methods
 fastuidraw::GlyphRender::
-GlyphRender(int pixel_size):
+GlyphRender(int pixel_size, int subpixel_offset):
   m_type(coverage_glyph),
-  m_pixel_size(pixel_size)
-{}
+  m_pixel_size(pixel_size),
+  m_subpixel_offset(subpixel_offset)
+{
+  assert(subpixel_offset >= 0 && subpixel_offset < number_subpixel_offsets);
+}
 
 fastuidraw::GlyphRender::
 GlyphRender(enum glyph_type t):
   m_type(t),
-  m_pixel_size(0)
+  m_pixel_size(0),
+  m_subpixel_offset(0)
 {
   assert(scalable(t) && t != invalid_glyph);
 }
@@ -38,7 +43,8 @@ GlyphRender(enum glyph_type t):
 fastuidraw::GlyphRender::
 GlyphRender(void):
   m_type(invalid_glyph),
-  m_pixel_size(0)
+  m_pixel_size(0),
+  m_subpixel_offset(0)
 {}
 
 bool
@@ -52,7 +58,11 @@ operator<(const GlyphRender &rhs) const
 
   if(!scalable(m_type))
     {
-      return m_pixel_size < rhs.m_pixel_size;
+      if(m_pixel_size != rhs.m_pixel_size)
+        {
+          return m_pixel_size < rhs.m_pixel_size;
+        }
+      return m_subpixel_offset < rhs.m_subpixel_offset;
     }
 
   return false;
@@ -63,7 +73,9 @@ fastuidraw::GlyphRender::
 operator==(const GlyphRender &rhs) const
 {
   return m_type == rhs.m_type
-    && (scalable(m_type) || m_pixel_size == rhs.m_pixel_size);
+    && (scalable(m_type)
+        || (m_pixel_size == rhs.m_pixel_size
+            && m_subpixel_offset == rhs.m_subpixel_offset));
 }
 
 bool
@@ -71,7 +83,10 @@ fastuidraw::GlyphRender::
 valid(void) const
 {
   return (m_type != invalid_glyph) &&
-    (scalable(m_type) || m_pixel_size > 0);
+    (scalable(m_type)
+     || (m_pixel_size > 0
+         && m_subpixel_offset >= 0
+         && m_subpixel_offset < number_subpixel_offsets));
 }
 
 bool
@@ -81,6 +96,18 @@ scalable(enum glyph_type tp)
   return tp != coverage_glyph;
 }
 
+int
+fastuidraw::GlyphRender::
+quantize_subpixel_offset(float x, float &snapped_x)
+{
+  float q, s;
+
+  q = std::floor(x * static_cast<float>(number_subpixel_offsets) + 0.5f);
+  s = std::floor(q / static_cast<float>(number_subpixel_offsets));
+  snapped_x = s;
+  return static_cast<int>(q - s * static_cast<float>(number_subpixel_offsets));
+}
+
 ////////////////////////////////////
 // fastuidraw::GlyphRenderData methods
 fastuidraw::GlyphRenderData::
@@ -0,0 +1,410 @@
+/*!
+ * \file glyph_render_data_banded_curves.cpp
+ * \brief file glyph_render_data_banded_curves.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <fastuidraw/text/glyph_render_data_banded_curves.hpp>
+
+#include "../private/util_private.hpp"
+
+namespace
+{
+  typedef fastuidraw::GlyphRenderDataBandedCurves::curve curve;
+
+  /* A curve whose coordinate of index coord is constant
+     never crosses a ray along the other coordinate, thus
+     it is not part of any band along that coordinate.
+   */
+  bool
+  constant_along(const curve &c, int coord)
+  {
+    return c.m_p0[coord] == c.m_p1[coord]
+      && c.m_p1[coord] == c.m_p2[coord];
+  }
+
+  float
+  min_coordinate(const curve &c, int coord)
+  {
+    return std::min(c.m_p0[coord], std::min(c.m_p1[coord], c.m_p2[coord]));
+  }
+
+  float
+  max_coordinate(const curve &c, int coord)
+  {
+    return std::max(c.m_p0[coord], std::max(c.m_p1[coord], c.m_p2[coord]));
+  }
+
+  /* Sorts the curves of a band so that the curves whose
+     maximum along the band is the largest come first; the
+     shader stops walking a band once the curves are behind
+     the fragment.
+   */
+  class sort_along_band
+  {
+  public:
+    sort_along_band(fastuidraw::const_c_array<curve> curves, int coord):
+      m_curves(curves),
+      m_coord(coord)
+    {}
+
+    bool
+    operator()(unsigned int lhs, unsigned int rhs) const
+    {
+      return max_coordinate(m_curves[lhs], m_coord) > max_coordinate(m_curves[rhs], m_coord);
+    }
+
+  private:
+    fastuidraw::const_c_array<curve> m_curves;
+    int m_coord;
+  };
+
+  /* Returns the winding number of p computed by casting
+     a ray from p in the direction of increasing x. Uses
+     the same root eligibility rule as the shader so that
+     the cell values agree with the computed coverage.
+   */
+  int
+  compute_winding_number(fastuidraw::const_c_array<curve> curves, fastuidraw::vec2 p)
+  {
+    int return_value(0);
+
+    for(unsigned int i = 0; i < curves.size(); ++i)
+      {
+        fastuidraw::vec2 p0(curves[i].m_p0 - p);
+        fastuidraw::vec2 p1(curves[i].m_p1 - p);
+        fastuidraw::vec2 p2(curves[i].m_p2 - p);
+        unsigned int shift, code;
+
+        /* the classification of the signs of the y-coordinates
+           of the control points gives which of the (at most two)
+           roots of y(t) = 0 count as crossings of the ray; the
+           table 0x2E74 is indexed by those signs.
+         */
+        shift = ((p0.y() > 0.0f) ? 2u : 0u)
+          | ((p1.y() > 0.0f) ? 4u : 0u)
+          | ((p2.y() > 0.0f) ? 8u : 0u);
+        code = (0x2E74u >> shift) & 3u;
+
+        if(code != 0u)
+          {
+            fastuidraw::vec2 a, b;
+            float t1, t2, ra;
+
+            a = p0 - 2.0f * p1 + p2;
+            b = p0 - p1;
+            if(std::abs(a.y()) < 1e-5f)
+              {
+                t1 = t2 = 0.5f * p0.y() / b.y();
+              }
+            else
+              {
+                ra = std::sqrt(std::max(b.y() * b.y() - a.y() * p0.y(), 0.0f));
+                t1 = (b.y() - ra) / a.y();
+                t2 = (b.y() + ra) / a.y();
+              }
+
+            if((code & 1u) != 0u && (a.x() * t1 - 2.0f * b.x()) * t1 + p0.x() > 0.0f)
+              {
+                ++return_value;
+              }
+
+            if(code > 1u && (a.x() * t2 - 2.0f * b.x()) * t2 + p0.x() > 0.0f)
+              {
+                --return_value;
+              }
+          }
+      }
+    return return_value;
+  }
+
+  void
+  pack_entry(fastuidraw::c_array<fastuidraw::generic_data> dst,
+             unsigned int entry, unsigned int entry_floats,
+             float x, float y, float z, float w)
+  {
+    fastuidraw::c_array<fastuidraw::generic_data> sub;
+
+    sub = dst.sub_array(entry * entry_floats, entry_floats);
+    sub[0].f = x;
+    sub[1].f = y;
+    sub[2].f = z;
+    sub[3].f = w;
+  }
+
+  class GlyphRenderDataBandedCurvesPrivate
+  {
+  public:
+    GlyphRenderDataBandedCurvesPrivate(void):
+      m_number_bands(0, 0),
+      m_number_band_curves(0)
+    {}
+
+    void
+    compute_bands(int coord, std::vector<std::vector<unsigned int> > &bands);
+
+    fastuidraw::ivec2 m_number_bands;
+    std::vector<curve> m_curves;
+
+    /* m_horizontal_bands are along the x-coordinate,
+       one per unit of y; m_vertical_bands are along
+       the y-coordinate, one per unit of x.
+     */
+    std::vector<std::vector<unsigned int> > m_horizontal_bands;
+    std::vector<std::vector<unsigned int> > m_vertical_bands;
+    std::vector<uint8_t> m_cell_values;
+    unsigned int m_number_band_curves;
+  };
+}
+
+////////////////////////////////////////////
+// GlyphRenderDataBandedCurvesPrivate methods
+void
+GlyphRenderDataBandedCurvesPrivate::
+compute_bands(int coord, std::vector<std::vector<unsigned int> > &bands)
+{
+  /* a band along coordinate coord stacks along the
+     other coordinate.
+   */
+  const float epsilon(1.0f / 64.0f);
+  int other(1 - coord);
+  fastuidraw::const_c_array<curve> curves(make_c_array(m_curves));
+
+  bands.clear();
+  bands.resize(m_number_bands[other]);
+  for(unsigned int c = 0; c < m_curves.size(); ++c)
+    {
+      int band_begin, band_end;
+
+      if(constant_along(m_curves[c], other))
+        {
+          continue;
+        }
+
+      band_begin = static_cast<int>(std::floor(min_coordinate(m_curves[c], other) - epsilon));
+      band_end = static_cast<int>(std::floor(max_coordinate(m_curves[c], other) + epsilon));
+      band_begin = std::max(0, band_begin);
+      band_end = std::min(m_number_bands[other] - 1, band_end);
+      for(int b = band_begin; b <= band_end; ++b)
+        {
+          bands[b].push_back(c);
+        }
+    }
+
+  for(unsigned int b = 0; b < bands.size(); ++b)
+    {
+      std::sort(bands[b].begin(), bands[b].end(), sort_along_band(curves, coord));
+      m_number_band_curves += bands[b].size();
+    }
+}
+
+/////////////////////////////////////
+// fastuidraw::GlyphRenderDataBandedCurves methods
+fastuidraw::GlyphRenderDataBandedCurves::
+GlyphRenderDataBandedCurves(void)
+{
+  m_d = FASTUIDRAWnew GlyphRenderDataBandedCurvesPrivate();
+}
+
+fastuidraw::GlyphRenderDataBandedCurves::
+~GlyphRenderDataBandedCurves()
+{
+  GlyphRenderDataBandedCurvesPrivate *d;
+  d = static_cast<GlyphRenderDataBandedCurvesPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+void
+fastuidraw::GlyphRenderDataBandedCurves::
+set_curves(ivec2 number_bands, const_c_array<curve> curves)
+{
+  GlyphRenderDataBandedCurvesPrivate *d;
+  d = static_cast<GlyphRenderDataBandedCurvesPrivate*>(m_d);
+
+  assert(number_bands.x() >= 0 && number_bands.y() >= 0);
+  assert(curves.empty() || (number_bands.x() > 0 && number_bands.y() > 0));
+
+  d->m_number_bands = number_bands;
+  d->m_curves.resize(curves.size());
+  std::copy(curves.begin(), curves.end(), d->m_curves.begin());
+  d->m_number_band_curves = 0;
+  d->compute_bands(0, d->m_horizontal_bands);
+  d->compute_bands(1, d->m_vertical_bands);
+
+  /* a cell has curves if a curve comes within half a band
+     of it, so that the coverage ramp of the anti-aliasing
+     of a curve is not cut off at the boundary of a cell.
+   */
+  d->m_cell_values.resize(number_bands.x() * number_bands.y());
+  for(int y = 0, J = 0; y < number_bands.y(); ++y)
+    {
+      for(int x = 0; x < number_bands.x(); ++x, ++J)
+        {
+          vec2 min_pt(float(x) - 0.5f, float(y) - 0.5f);
+          vec2 max_pt(float(x) + 1.5f, float(y) + 1.5f);
+          bool has_curves(false);
+
+          for(unsigned int c = 0; c < curves.size() && !has_curves; ++c)
+            {
+              has_curves = min_coordinate(curves[c], 0) <= max_pt.x()
+                && max_coordinate(curves[c], 0) >= min_pt.x()
+                && min_coordinate(curves[c], 1) <= max_pt.y()
+                && max_coordinate(curves[c], 1) >= min_pt.y();
+            }
+
+          if(has_curves)
+            {
+              d->m_cell_values[J] = cell_has_curves;
+            }
+          else
+            {
+              int w;
+              w = compute_winding_number(curves, vec2(float(x) + 0.5f, float(y) + 0.5f));
+              d->m_cell_values[J] = (w != 0) ? cell_full : cell_empty;
+            }
+        }
+    }
+}
+
+fastuidraw::ivec2
+fastuidraw::GlyphRenderDataBandedCurves::
+number_bands(void) const
+{
+  GlyphRenderDataBandedCurvesPrivate *d;
+  d = static_cast<GlyphRenderDataBandedCurvesPrivate*>(m_d);
+  return d->m_number_bands;
+}
+
+fastuidraw::const_c_array<fastuidraw::GlyphRenderDataBandedCurves::curve>
+fastuidraw::GlyphRenderDataBandedCurves::
+curves(void) const
+{
+  GlyphRenderDataBandedCurvesPrivate *d;
+  d = static_cast<GlyphRenderDataBandedCurvesPrivate*>(m_d);
+  return make_c_array(d->m_curves);
+}
+
+fastuidraw::const_c_array<unsigned int>
+fastuidraw::GlyphRenderDataBandedCurves::
+horizontal_band(int band) const
+{
+  GlyphRenderDataBandedCurvesPrivate *d;
+  d = static_cast<GlyphRenderDataBandedCurvesPrivate*>(m_d);
+  assert(band >= 0 && band < d->m_number_bands.y());
+  return make_c_array(d->m_horizontal_bands[band]);
+}
+
+fastuidraw::const_c_array<unsigned int>
+fastuidraw::GlyphRenderDataBandedCurves::
+vertical_band(int band) const
+{
+  GlyphRenderDataBandedCurvesPrivate *d;
+  d = static_cast<GlyphRenderDataBandedCurvesPrivate*>(m_d);
+  assert(band >= 0 && band < d->m_number_bands.x());
+  return make_c_array(d->m_vertical_bands[band]);
+}
+
+fastuidraw::const_c_array<uint8_t>
+fastuidraw::GlyphRenderDataBandedCurves::
+cell_values(void) const
+{
+  GlyphRenderDataBandedCurvesPrivate *d;
+  d = static_cast<GlyphRenderDataBandedCurvesPrivate*>(m_d);
+  return make_c_array(d->m_cell_values);
+}
+
+unsigned int
+fastuidraw::GlyphRenderDataBandedCurves::
+number_band_curves(void) const
+{
+  GlyphRenderDataBandedCurvesPrivate *d;
+  d = static_cast<GlyphRenderDataBandedCurvesPrivate*>(m_d);
+  return d->m_number_band_curves;
+}
+
+enum fastuidraw::return_code
+fastuidraw::GlyphRenderDataBandedCurves::
+upload_to_atlas(const reference_counted_ptr<GlyphAtlas> &atlas,
+                GlyphLocation &atlas_location,
+                GlyphLocation &secondary_atlas_location,
+                int &geometry_offset,
+                int &geometry_length) const
+{
+  GlyphRenderDataBandedCurvesPrivate *d;
+  d = static_cast<GlyphRenderDataBandedCurvesPrivate*>(m_d);
+
+  secondary_atlas_location = GlyphLocation();
+  geometry_offset = -1;
+  geometry_length = 0;
+
+  atlas_location = atlas->allocate(d->m_number_bands, make_c_array(d->m_cell_values),
+                                   GlyphAtlas::Padding());
+  if(atlas_location.valid() && !d->m_curves.empty())
+    {
+      unsigned int alignment, entry_floats, num_entries, curve_entry;
+      std::vector<generic_data> geometry_data;
+      c_array<generic_data> dst;
+      generic_data zero;
+      vec2 delta(atlas_location.location());
+
+      alignment = atlas->geometry_store()->alignment();
+      entry_floats = round_up_to_multiple(static_cast<unsigned int>(entry_size), alignment);
+      num_entries = 1 + d->m_number_bands.x() + d->m_number_bands.y()
+        + entries_per_curve * d->m_number_band_curves;
+
+      zero.f = 0.0f;
+      geometry_data.resize(num_entries * entry_floats, zero);
+      dst = make_c_array(geometry_data);
+
+      pack_entry(dst, 0, entry_floats, delta.x(), delta.y(),
+                 float(d->m_number_bands.x()), float(d->m_number_bands.y()));
+
+      curve_entry = 1 + d->m_number_bands.x() + d->m_number_bands.y();
+      for(unsigned int b = 0, endb = d->m_horizontal_bands.size() + d->m_vertical_bands.size();
+          b < endb; ++b)
+        {
+          const std::vector<unsigned int> &band((b < d->m_horizontal_bands.size()) ?
+                                                d->m_horizontal_bands[b] :
+                                                d->m_vertical_bands[b - d->m_horizontal_bands.size()]);
+
+          pack_entry(dst, 1 + b, entry_floats, float(curve_entry), float(band.size()), 0.0f, 0.0f);
+          for(unsigned int i = 0; i < band.size(); ++i, curve_entry += entries_per_curve)
+            {
+              const curve &c(d->m_curves[band[i]]);
+              vec2 p0(c.m_p0 + delta), p1(c.m_p1 + delta), p2(c.m_p2 + delta);
+
+              pack_entry(dst, curve_entry, entry_floats, p0.x(), p0.y(), p1.x(), p1.y());
+              pack_entry(dst, curve_entry + 1, entry_floats, p2.x(), p2.y(), 0.0f, 0.0f);
+            }
+        }
+
+      geometry_offset = atlas->allocate_geometry_data(make_c_array(geometry_data));
+      geometry_length = geometry_data.size() / alignment;
+      if(geometry_offset == -1)
+        {
+          atlas->deallocate(atlas_location);
+          atlas_location = GlyphLocation();
+          geometry_length = 0;
+        }
+    }
+
+  return atlas_location.valid() ?
+    routine_success :
+    routine_fail;
+}
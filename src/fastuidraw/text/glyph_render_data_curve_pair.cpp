@@ -97,7 +97,8 @@ namespace
   {
   public:
     GlyphRenderDataCurvePairPrivate(void):
-      m_resolution(0, 0)
+      m_resolution(0, 0),
+      m_number_approximated_texels(0)
     {}
 
     void
@@ -112,6 +113,7 @@ namespace
     fastuidraw::ivec2 m_resolution;
     std::vector<uint16_t> m_texels;
     std::vector<fastuidraw::GlyphRenderDataCurvePair::entry> m_geometry_data;
+    unsigned int m_number_approximated_texels;
   };
 }
 
@@ -400,6 +402,24 @@ resize_geometry_data(int sz)
   d->m_geometry_data.resize(sz, fastuidraw::GlyphRenderDataCurvePair::entry(false));
 }
 
+unsigned int
+fastuidraw::GlyphRenderDataCurvePair::
+number_approximated_texels(void) const
+{
+  GlyphRenderDataCurvePairPrivate *d;
+  d = static_cast<GlyphRenderDataCurvePairPrivate*>(m_d);
+  return d->m_number_approximated_texels;
+}
+
+void
+fastuidraw::GlyphRenderDataCurvePair::
+number_approximated_texels(unsigned int v)
+{
+  GlyphRenderDataCurvePairPrivate *d;
+  d = static_cast<GlyphRenderDataCurvePairPrivate*>(m_d);
+  d->m_number_approximated_texels = v;
+}
+
 enum fastuidraw::return_code
 fastuidraw::GlyphRenderDataCurvePair::
 upload_to_atlas(const reference_counted_ptr<GlyphAtlas> &atlas,
@@ -416,13 +436,24 @@ upload_to_atlas(const reference_counted_ptr<GlyphAtlas> &atlas,
   padding.m_bottom = 1;
 
   std::vector<uint8_t> primary, secondary;
+  std::vector<uint16_t> wide;
   std::vector<float> geometry;
-  bool has_secondary(false);
+  bool has_secondary(false), sixteen_bit(atlas->texel_store()->sixteen_bit());
   int num_texels(d->m_resolution.x() * d->m_resolution.y());
 
-  /* fill primary
+  /* fill primary, or if the texel store is 16-bit,
+     fill wide so that the texel values are in a
+     single region instead of split between primary
+     (low byte) and secondary (high byte).
    */
-  primary.resize(num_texels, 0);
+  if(sixteen_bit)
+    {
+      wide.resize(num_texels, 0);
+    }
+  else
+    {
+      primary.resize(num_texels, 0);
+    }
   for(int y = 0, J = 0; y < d->m_resolution.y(); ++y)
     {
       for(int x = 0; x < d->m_resolution.x(); ++x, ++J)
@@ -441,15 +472,23 @@ upload_to_atlas(const reference_counted_ptr<GlyphAtlas> &atlas,
             {
               v += 2;
             }
-          primary[J] = v & 0xFF;
-          if(v > 0xFF)
+
+          if(sixteen_bit)
+            {
+              wide[J] = v;
+            }
+          else
             {
-              if(!has_secondary)
+              primary[J] = v & 0xFF;
+              if(v > 0xFF)
                 {
-                  has_secondary = true;
-                  secondary.resize(num_texels, 0);
+                  if(!has_secondary)
+                    {
+                      has_secondary = true;
+                      secondary.resize(num_texels, 0);
+                    }
+                  secondary[J] = (v >> 8);
                 }
-              secondary[J] = (v >> 8);
             }
         }
     }
@@ -458,7 +497,9 @@ upload_to_atlas(const reference_counted_ptr<GlyphAtlas> &atlas,
   geometry_offset = -1;
   geometry_length = 0;
 
-  atlas_location = atlas->allocate(d->m_resolution, make_c_array(primary), padding);
+  atlas_location = (sixteen_bit) ?
+    atlas->allocate(d->m_resolution, make_c_array(wide), padding) :
+    atlas->allocate(d->m_resolution, make_c_array(primary), padding);
   if(atlas_location.valid())
     {
       bool success(true);
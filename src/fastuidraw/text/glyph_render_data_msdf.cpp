@@ -0,0 +1,184 @@
+/*!
+ * \file glyph_render_data_msdf.cpp
+ * \brief file glyph_render_data_msdf.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#include <vector>
+#include <algorithm>
+#include <fastuidraw/text/glyph_render_data_msdf.hpp>
+#include "../private/util_private.hpp"
+
+namespace
+{
+  class GlyphDataPrivate
+  {
+  public:
+    GlyphDataPrivate(void):
+      m_resolution(0, 0)
+    {}
+
+    void
+    resize(fastuidraw::ivec2 sz)
+    {
+      assert(sz.x() >= 0);
+      assert(sz.y() >= 0);
+      m_texels.resize(fastuidraw::GlyphRenderDataMSDF::number_channels * sz.x() * sz.y());
+      m_resolution = sz;
+    }
+
+    fastuidraw::c_array<uint8_t>
+    channel(enum fastuidraw::GlyphRenderDataMSDF::channel_t c)
+    {
+      unsigned int sz(m_resolution.x() * m_resolution.y());
+
+      assert(c < fastuidraw::GlyphRenderDataMSDF::number_channels);
+      return fastuidraw::make_c_array(m_texels).sub_array(c * sz, sz);
+    }
+
+    fastuidraw::ivec2 m_resolution;
+
+    /* the channels one after the other */
+    std::vector<uint8_t> m_texels;
+  };
+}
+
+/////////////////////////////////////////////
+// fastuidraw::GlyphRenderDataMSDF methods
+fastuidraw::GlyphRenderDataMSDF::
+GlyphRenderDataMSDF(void)
+{
+  m_d = FASTUIDRAWnew GlyphDataPrivate();
+}
+
+fastuidraw::GlyphRenderDataMSDF::
+~GlyphRenderDataMSDF(void)
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+fastuidraw::ivec2
+fastuidraw::GlyphRenderDataMSDF::
+resolution(void) const
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+  return d->m_resolution;
+}
+
+fastuidraw::const_c_array<uint8_t>
+fastuidraw::GlyphRenderDataMSDF::
+distance_values(enum channel_t c) const
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+  return d->channel(c);
+}
+
+fastuidraw::c_array<uint8_t>
+fastuidraw::GlyphRenderDataMSDF::
+distance_values(enum channel_t c)
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+  return d->channel(c);
+}
+
+void
+fastuidraw::GlyphRenderDataMSDF::
+resize(fastuidraw::ivec2 sz)
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+  d->resize(sz);
+}
+
+enum fastuidraw::return_code
+fastuidraw::GlyphRenderDataMSDF::
+upload_to_atlas(const reference_counted_ptr<GlyphAtlas> &atlas,
+                GlyphLocation &atlas_location,
+                GlyphLocation &secondary_atlas_location,
+                int &geometry_offset,
+                int &geometry_length) const
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+
+  GlyphAtlas::Padding padding;
+  ivec2 res(d->m_resolution);
+  std::vector<uint8_t> secondary(2 * res.x() * res.y());
+  std::vector<generic_data> geometry_data;
+  generic_data zero;
+
+  /* the second and third channels are placed side by
+     side, row by row; the last column of each channel is
+     its padding so no texel of one channel is filtered
+     into the other.
+   */
+  for(int y = 0; y < res.y(); ++y)
+    {
+      for(int c = green_channel; c <= blue_channel; ++c)
+        {
+          const_c_array<uint8_t> src(d->channel(static_cast<enum channel_t>(c)));
+
+          std::copy(src.c_ptr() + y * res.x(),
+                    src.c_ptr() + (y + 1) * res.x(),
+                    secondary.begin() + (2 * y + c - green_channel) * res.x());
+        }
+    }
+
+  zero.f = 0.0f;
+  geometry_data.resize(atlas->geometry_store()->alignment(), zero);
+  geometry_data[0].f = static_cast<float>(res.x());
+
+  padding.m_right = 1;
+  padding.m_bottom = 1;
+  atlas_location = atlas->allocate(res, d->channel(red_channel), padding);
+  secondary_atlas_location = GlyphLocation();
+  geometry_offset = -1;
+  geometry_length = 0;
+
+  if(!atlas_location.valid())
+    {
+      return routine_fail;
+    }
+
+  secondary_atlas_location = atlas->allocate(ivec2(2 * res.x(), res.y()),
+                                             make_c_array(secondary), padding);
+  if(secondary_atlas_location.valid())
+    {
+      geometry_offset = atlas->allocate_geometry_data(make_c_array(geometry_data));
+      geometry_length = 1;
+    }
+
+  if(geometry_offset == -1)
+    {
+      if(secondary_atlas_location.valid())
+        {
+          atlas->deallocate(secondary_atlas_location);
+          secondary_atlas_location = GlyphLocation();
+        }
+      atlas->deallocate(atlas_location);
+      atlas_location = GlyphLocation();
+      geometry_length = 0;
+      return routine_fail;
+    }
+
+  return routine_success;
+}
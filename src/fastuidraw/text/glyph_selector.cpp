@@ -19,6 +19,8 @@
 
 #include <set>
 #include <map>
+#include <cmath>
+#include <algorithm>
 
 #include <fastuidraw/text/glyph_selector.hpp>
 #include "../private/util_private.hpp"
@@ -135,6 +137,32 @@ namespace
     {}
   };
 
+  class RenderPolicyPrivate
+  {
+  public:
+    RenderPolicyPrivate(void):
+      m_coverage_max_pixel_size(16.0f),
+      m_distance_field_max_pixel_size(48.0f),
+      m_curve_pair_max_approximated_texels(0)
+    {}
+
+    /* returns true if a Glyph selected as a curve-pair glyph is
+       to be replaced by a glyph of the fallback rendering type
+     */
+    bool
+    too_approximated(const fastuidraw::Glyph &G) const
+    {
+      return G.valid()
+        && G.type() == fastuidraw::curve_pair_glyph
+        && m_curve_pair_max_approximated_texels >= 0
+        && G.number_approximated_texels() > static_cast<unsigned int>(m_curve_pair_max_approximated_texels);
+    }
+
+    float m_coverage_max_pixel_size;
+    float m_distance_field_max_pixel_size;
+    int m_curve_pair_max_approximated_texels;
+  };
+
   class GlyphSelectorPrivate
   {
   public:
@@ -162,6 +190,34 @@ namespace
                                    fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> h,
                                    uint32_t character_code);
 
+    /* select the font and glyph code of a character code rendered
+       as tp, from a font with font merging or from a font group
+     */
+    glyph_source
+    select_glyph(fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> h,
+                 uint32_t character_code, enum fastuidraw::glyph_type tp);
+
+    glyph_source
+    select_glyph(fastuidraw::reference_counted_ptr<font_group> group,
+                 uint32_t character_code, enum fastuidraw::glyph_type tp);
+
+    template<typename T>
+    void
+    prefetch_glyph_no_lock(fastuidraw::GlyphRender tp, T h, uint32_t character_code);
+
+    template<typename T>
+    fastuidraw::GlyphLayoutData
+    fetch_glyph_layout_no_lock(fastuidraw::GlyphRender tp, T h, uint32_t character_code);
+
+    template<typename T>
+    fastuidraw::Glyph
+    fetch_glyph_if_ready_no_lock(fastuidraw::GlyphRender tp, fastuidraw::GlyphRender fallback,
+                                 T h, uint32_t character_code);
+
+    /* group is the opaque pointer of a GlyphSelector::FontGroup */
+    fastuidraw::reference_counted_ptr<font_group>
+    group_from_handle(void *group);
+
     fastuidraw::mutex m_mutex;
     fastuidraw::reference_counted_ptr<font_group> m_master_group;
     font_group_map<bold_italic_key> m_bold_italic_groups;
@@ -170,6 +226,7 @@ namespace
     font_group_map<foundry_style_family_bold_italic_key> m_foundry_style_family_bold_italic_groups;
 
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphCache> m_cache;
+    unsigned int m_glyph_generation_threads;
   };
 }
 
@@ -231,7 +288,8 @@ fetch_glyph(uint32_t character_code, enum fastuidraw::glyph_type tp) const
 // GlyphSelectorPrivate methods
 GlyphSelectorPrivate::
 GlyphSelectorPrivate(fastuidraw::reference_counted_ptr<fastuidraw::GlyphCache> h):
-  m_cache(h)
+  m_cache(h),
+  m_glyph_generation_threads(1)
 {
   m_master_group = FASTUIDRAWnew font_group(fastuidraw::reference_counted_ptr<font_group>());
 }
@@ -371,6 +429,245 @@ fetch_glyph_no_lock(fastuidraw::GlyphRender tp,
     }
 }
 
+glyph_source
+GlyphSelectorPrivate::
+select_glyph(fastuidraw::reference_counted_ptr<const fastuidraw::FontBase> h,
+             uint32_t character_code, enum fastuidraw::glyph_type tp)
+{
+  if(!h || !h->can_create_rendering_data(tp))
+    {
+      return glyph_source();
+    }
+  return fetch_glyph_helper(h, character_code, tp);
+}
+
+glyph_source
+GlyphSelectorPrivate::
+select_glyph(fastuidraw::reference_counted_ptr<font_group> group,
+             uint32_t character_code, enum fastuidraw::glyph_type tp)
+{
+  assert(group);
+  return group->fetch_glyph(character_code, tp);
+}
+
+template<typename T>
+void
+GlyphSelectorPrivate::
+prefetch_glyph_no_lock(fastuidraw::GlyphRender tp, T h, uint32_t character_code)
+{
+  glyph_source src;
+
+  if(!tp.valid())
+    {
+      return;
+    }
+
+  src = select_glyph(h, character_code, tp.m_type);
+  if(src.first)
+    {
+      m_cache->prefetch_glyph(tp, src.first, src.second);
+    }
+}
+
+template<typename T>
+fastuidraw::GlyphLayoutData
+GlyphSelectorPrivate::
+fetch_glyph_layout_no_lock(fastuidraw::GlyphRender tp, T h, uint32_t character_code)
+{
+  glyph_source src;
+
+  if(!tp.valid())
+    {
+      return fastuidraw::GlyphLayoutData();
+    }
+
+  src = select_glyph(h, character_code, tp.m_type);
+  if(src.first)
+    {
+      return m_cache->fetch_glyph_layout(tp, src.first, src.second);
+    }
+  return fastuidraw::GlyphLayoutData();
+}
+
+template<typename T>
+fastuidraw::Glyph
+GlyphSelectorPrivate::
+fetch_glyph_if_ready_no_lock(fastuidraw::GlyphRender tp, fastuidraw::GlyphRender fallback,
+                             T h, uint32_t character_code)
+{
+  glyph_source src;
+  fastuidraw::Glyph G;
+
+  if(tp.valid())
+    {
+      src = select_glyph(h, character_code, tp.m_type);
+      if(src.first)
+        {
+          G = m_cache->fetch_glyph_if_ready(tp, src.first, src.second);
+          if(!G.valid())
+            {
+              m_cache->prefetch_glyph(tp, src.first, src.second);
+            }
+        }
+    }
+
+  if(!G.valid() && fallback.valid())
+    {
+      src = select_glyph(h, character_code, fallback.m_type);
+      if(src.first)
+        {
+          G = m_cache->fetch_glyph_if_ready(fallback, src.first, src.second);
+        }
+    }
+
+  return G;
+}
+
+fastuidraw::reference_counted_ptr<font_group>
+GlyphSelectorPrivate::
+group_from_handle(void *group)
+{
+  fastuidraw::reference_counted_ptr<font_group> p;
+  p = fastuidraw::reference_counted_ptr<font_group>(static_cast<font_group*>(group));
+  if(!p)
+    {
+      p = m_master_group;
+    }
+  return p;
+}
+
+////////////////////////////////////////////////
+// fastuidraw::GlyphSelector::RenderPolicy methods
+fastuidraw::GlyphSelector::RenderPolicy::
+RenderPolicy(void)
+{
+  m_d = FASTUIDRAWnew RenderPolicyPrivate();
+}
+
+fastuidraw::GlyphSelector::RenderPolicy::
+RenderPolicy(const RenderPolicy &obj)
+{
+  RenderPolicyPrivate *d;
+  d = static_cast<RenderPolicyPrivate*>(obj.m_d);
+  m_d = FASTUIDRAWnew RenderPolicyPrivate(*d);
+}
+
+fastuidraw::GlyphSelector::RenderPolicy::
+~RenderPolicy()
+{
+  RenderPolicyPrivate *d;
+  d = static_cast<RenderPolicyPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+fastuidraw::GlyphSelector::RenderPolicy&
+fastuidraw::GlyphSelector::RenderPolicy::
+operator=(const RenderPolicy &rhs)
+{
+  if(this != &rhs)
+    {
+      RenderPolicyPrivate *d, *rhs_d;
+      d = static_cast<RenderPolicyPrivate*>(m_d);
+      rhs_d = static_cast<RenderPolicyPrivate*>(rhs.m_d);
+      *d = *rhs_d;
+    }
+  return *this;
+}
+
+float
+fastuidraw::GlyphSelector::RenderPolicy::
+coverage_max_pixel_size(void) const
+{
+  RenderPolicyPrivate *d;
+  d = static_cast<RenderPolicyPrivate*>(m_d);
+  return d->m_coverage_max_pixel_size;
+}
+
+fastuidraw::GlyphSelector::RenderPolicy&
+fastuidraw::GlyphSelector::RenderPolicy::
+coverage_max_pixel_size(float v)
+{
+  RenderPolicyPrivate *d;
+  d = static_cast<RenderPolicyPrivate*>(m_d);
+  d->m_coverage_max_pixel_size = v;
+  return *this;
+}
+
+float
+fastuidraw::GlyphSelector::RenderPolicy::
+distance_field_max_pixel_size(void) const
+{
+  RenderPolicyPrivate *d;
+  d = static_cast<RenderPolicyPrivate*>(m_d);
+  return d->m_distance_field_max_pixel_size;
+}
+
+fastuidraw::GlyphSelector::RenderPolicy&
+fastuidraw::GlyphSelector::RenderPolicy::
+distance_field_max_pixel_size(float v)
+{
+  RenderPolicyPrivate *d;
+  d = static_cast<RenderPolicyPrivate*>(m_d);
+  d->m_distance_field_max_pixel_size = v;
+  return *this;
+}
+
+int
+fastuidraw::GlyphSelector::RenderPolicy::
+curve_pair_max_approximated_texels(void) const
+{
+  RenderPolicyPrivate *d;
+  d = static_cast<RenderPolicyPrivate*>(m_d);
+  return d->m_curve_pair_max_approximated_texels;
+}
+
+fastuidraw::GlyphSelector::RenderPolicy&
+fastuidraw::GlyphSelector::RenderPolicy::
+curve_pair_max_approximated_texels(int v)
+{
+  RenderPolicyPrivate *d;
+  d = static_cast<RenderPolicyPrivate*>(m_d);
+  d->m_curve_pair_max_approximated_texels = v;
+  return *this;
+}
+
+fastuidraw::GlyphRender
+fastuidraw::GlyphSelector::RenderPolicy::
+select(float pixel_size) const
+{
+  RenderPolicyPrivate *d;
+  d = static_cast<RenderPolicyPrivate*>(m_d);
+
+  if(pixel_size < d->m_coverage_max_pixel_size)
+    {
+      /* coverage glyphs are realized at an integer
+         pixel size; round up so that the glyph is
+         minified rather than magnified.
+       */
+      int sz;
+      sz = std::max(1, static_cast<int>(std::ceil(pixel_size)));
+      return GlyphRender(sz);
+    }
+  else if(pixel_size < d->m_distance_field_max_pixel_size)
+    {
+      return GlyphRender(distance_field_glyph);
+    }
+  else
+    {
+      return GlyphRender(curve_pair_glyph);
+    }
+}
+
+bool
+fastuidraw::GlyphSelector::RenderPolicy::
+too_approximated(const Glyph &G) const
+{
+  RenderPolicyPrivate *d;
+  d = static_cast<RenderPolicyPrivate*>(m_d);
+  return d->too_approximated(G);
+}
+
 ////////////////////////////////////////////////
 // fastuidraw::GlyphSelector methods
 fastuidraw::GlyphSelector::
@@ -474,20 +771,92 @@ unlock_mutex(void)
   d->m_mutex.unlock();
 }
 
+void
+fastuidraw::GlyphSelector::
+begin_glyph_sequence(void)
+{
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  d->m_mutex.lock();
+  d->m_cache->begin_deferred_generation();
+}
+
+void
+fastuidraw::GlyphSelector::
+end_glyph_sequence(void)
+{
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  d->m_cache->end_deferred_generation(d->m_glyph_generation_threads);
+  d->m_mutex.unlock();
+}
+
+unsigned int
+fastuidraw::GlyphSelector::
+glyph_generation_threads(void) const
+{
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  return d->m_glyph_generation_threads;
+}
+
+void
+fastuidraw::GlyphSelector::
+glyph_generation_threads(unsigned int v)
+{
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  d->m_glyph_generation_threads = v;
+}
+
 fastuidraw::Glyph
 fastuidraw::GlyphSelector::
 fetch_glyph_no_lock(GlyphRender tp, FontGroup group, uint32_t character_code)
 {
   GlyphSelectorPrivate *d;
   d = static_cast<GlyphSelectorPrivate*>(m_d);
+  return d->fetch_glyph_no_lock(tp, d->group_from_handle(group.m_d), character_code);
+}
 
-  reference_counted_ptr<font_group> p;
-  p = reference_counted_ptr<font_group>(static_cast<font_group*>(group.m_d));
-  if(!p)
-    {
-      p = d->m_master_group;
-    }
-  return d->fetch_glyph_no_lock(tp, p, character_code);
+void
+fastuidraw::GlyphSelector::
+prefetch_glyph_no_lock(GlyphRender tp, FontGroup group, uint32_t character_code)
+{
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  d->prefetch_glyph_no_lock(tp, d->group_from_handle(group.m_d), character_code);
+}
+
+void
+fastuidraw::GlyphSelector::
+prefetch_glyph_no_lock(GlyphRender tp,
+                       reference_counted_ptr<const FontBase> h,
+                       uint32_t character_code)
+{
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  d->prefetch_glyph_no_lock(tp, h, character_code);
+}
+
+fastuidraw::Glyph
+fastuidraw::GlyphSelector::
+fetch_glyph_if_ready_no_lock(GlyphRender tp, GlyphRender fallback,
+                             FontGroup group, uint32_t character_code)
+{
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  return d->fetch_glyph_if_ready_no_lock(tp, fallback, d->group_from_handle(group.m_d), character_code);
+}
+
+fastuidraw::Glyph
+fastuidraw::GlyphSelector::
+fetch_glyph_if_ready_no_lock(GlyphRender tp, GlyphRender fallback,
+                             reference_counted_ptr<const FontBase> h,
+                             uint32_t character_code)
+{
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  return d->fetch_glyph_if_ready_no_lock(tp, fallback, h, character_code);
 }
 
 fastuidraw::GlyphSelector::FontGroup
@@ -540,6 +909,120 @@ fetch_glyph(GlyphRender tp, reference_counted_ptr<const FontBase> h, uint32_t ch
   return G;
 }
 
+fastuidraw::Glyph
+fastuidraw::GlyphSelector::
+fetch_glyph(const RenderPolicy &policy, float pixel_size,
+            FontGroup group, uint32_t character_code)
+{
+  Glyph G;
+
+  lock_mutex();
+  G = fetch_glyph_no_lock(policy.select(pixel_size), group, character_code);
+  if(policy.too_approximated(G))
+    {
+      G = fetch_glyph_no_lock(GlyphRender(distance_field_glyph), group, character_code);
+    }
+  unlock_mutex();
+  return G;
+}
+
+fastuidraw::Glyph
+fastuidraw::GlyphSelector::
+fetch_glyph(const RenderPolicy &policy, float pixel_size,
+            reference_counted_ptr<const FontBase> h,
+            uint32_t character_code)
+{
+  Glyph G;
+
+  lock_mutex();
+  G = fetch_glyph_no_lock(policy.select(pixel_size), h, character_code);
+  if(policy.too_approximated(G))
+    {
+      G = fetch_glyph_no_lock(GlyphRender(distance_field_glyph), h, character_code);
+    }
+  unlock_mutex();
+  return G;
+}
+
+void
+fastuidraw::GlyphSelector::
+apply_render_policy_fallback(const RenderPolicy &policy, FontGroup group,
+                             const_c_array<uint32_t> character_codes,
+                             c_array<Glyph> glyphs)
+{
+  assert(character_codes.size() == glyphs.size());
+  begin_glyph_sequence();
+  for(unsigned int i = 0, endi = glyphs.size(); i < endi; ++i)
+    {
+      if(policy.too_approximated(glyphs[i]))
+        {
+          glyphs[i] = fetch_glyph_no_lock(GlyphRender(distance_field_glyph), group, character_codes[i]);
+        }
+    }
+  end_glyph_sequence();
+}
+
+void
+fastuidraw::GlyphSelector::
+apply_render_policy_fallback(const RenderPolicy &policy,
+                             reference_counted_ptr<const FontBase> h,
+                             const_c_array<uint32_t> character_codes,
+                             c_array<Glyph> glyphs)
+{
+  assert(character_codes.size() == glyphs.size());
+  begin_glyph_sequence();
+  for(unsigned int i = 0, endi = glyphs.size(); i < endi; ++i)
+    {
+      if(policy.too_approximated(glyphs[i]))
+        {
+          glyphs[i] = fetch_glyph_no_lock(GlyphRender(distance_field_glyph), h, character_codes[i]);
+        }
+    }
+  end_glyph_sequence();
+}
+
+fastuidraw::GlyphLayoutData
+fastuidraw::GlyphSelector::
+fetch_glyph_layout(GlyphRender tp, FontGroup group, uint32_t character_code)
+{
+  GlyphLayoutData L;
+  lock_mutex();
+  L = fetch_glyph_layout_no_lock(tp, group, character_code);
+  unlock_mutex();
+  return L;
+}
+
+fastuidraw::GlyphLayoutData
+fastuidraw::GlyphSelector::
+fetch_glyph_layout(GlyphRender tp, reference_counted_ptr<const FontBase> h,
+                   uint32_t character_code)
+{
+  GlyphLayoutData L;
+  lock_mutex();
+  L = fetch_glyph_layout_no_lock(tp, h, character_code);
+  unlock_mutex();
+  return L;
+}
+
+fastuidraw::GlyphLayoutData
+fastuidraw::GlyphSelector::
+fetch_glyph_layout_no_lock(GlyphRender tp, FontGroup group, uint32_t character_code)
+{
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  return d->fetch_glyph_layout_no_lock(tp, d->group_from_handle(group.m_d), character_code);
+}
+
+fastuidraw::GlyphLayoutData
+fastuidraw::GlyphSelector::
+fetch_glyph_layout_no_lock(GlyphRender tp, reference_counted_ptr<const FontBase> h,
+                           uint32_t character_code)
+{
+  GlyphSelectorPrivate *d;
+  d = static_cast<GlyphSelectorPrivate*>(m_d);
+  return d->fetch_glyph_layout_no_lock(tp, h, character_code);
+}
+
 fastuidraw::Glyph
 fastuidraw::GlyphSelector::
 fetch_glyph_no_merging(GlyphRender tp, reference_counted_ptr<const FontBase> h, uint32_t character_code)
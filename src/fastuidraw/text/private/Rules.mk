@@ -4,7 +4,8 @@ dirstack_$(sp)	:= $(d)
 d		:= $(dir)
 # End standard header
 
-LIBRARY_PRIVATE_SOURCES += $(call filelist, rect_atlas.cpp freetype_util.cpp freetype_curvepair_util.cpp)
+LIBRARY_PRIVATE_SOURCES += $(call filelist, rect_atlas.cpp freetype_util.cpp freetype_curvepair_util.cpp \
+	distance_transform.cpp msdf_generator.cpp)
 
 # Begin standard footer
 d		:= $(dirstack_$(sp))
@@ -0,0 +1,123 @@
+/*!
+ * \file distance_transform.cpp
+ * \brief file distance_transform.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <assert.h>
+#include <cmath>
+#include <algorithm>
+#include "distance_transform.hpp"
+
+void
+fastuidraw::detail::DistanceTransform::
+sweep_row(const uint8_t *row, int w, int far_value)
+{
+  for(int x = 0; x < w; ++x)
+    {
+      int set_value, unset_value;
+
+      set_value = (row[x] != 0) ? 0 : std::min(m_to_set[x] + 1, far_value);
+      unset_value = (row[x] != 0) ? std::min(m_to_unset[x] + 1, far_value) : 0;
+      m_to_set[x] = set_value;
+      m_to_unset[x] = unset_value;
+    }
+}
+
+void
+fastuidraw::detail::DistanceTransform::
+compute(const ivec2 &image_size, const_c_array<uint8_t> image,
+        const ivec2 &sample_start, int sample_stride,
+        const ivec2 &sample_count, int max_distance,
+        c_array<float> out_distances)
+{
+  int w(image_size.x()), h(image_size.y());
+  int far_value(max_distance + 1);
+  int far_value_sq(far_value * far_value);
+
+  assert(image.size() >= static_cast<unsigned int>(w * h));
+  assert(out_distances.size() >= static_cast<unsigned int>(sample_count.x() * sample_count.y()));
+  assert(sample_start.y() + (sample_count.y() - 1) * sample_stride < h);
+
+  m_to_set.resize(w);
+  m_to_unset.resize(w);
+  m_vertical[0].resize(w * sample_count.y());
+  m_vertical[1].resize(w * sample_count.y());
+
+  /* sweep down */
+  std::fill(m_to_set.begin(), m_to_set.end(), far_value);
+  std::fill(m_to_unset.begin(), m_to_unset.end(), far_value);
+  for(int y = 0, j = 0; y < h && j < sample_count.y(); ++y)
+    {
+      sweep_row(image.c_ptr() + y * w, w, far_value);
+      if(y == sample_start.y() + j * sample_stride)
+        {
+          std::copy(m_to_unset.begin(), m_to_unset.end(), m_vertical[0].begin() + j * w);
+          std::copy(m_to_set.begin(), m_to_set.end(), m_vertical[1].begin() + j * w);
+          ++j;
+        }
+    }
+
+  /* sweep up */
+  std::fill(m_to_set.begin(), m_to_set.end(), far_value);
+  std::fill(m_to_unset.begin(), m_to_unset.end(), far_value);
+  for(int y = h - 1, j = sample_count.y() - 1; y >= 0 && j >= 0; --y)
+    {
+      sweep_row(image.c_ptr() + y * w, w, far_value);
+      if(y == sample_start.y() + j * sample_stride)
+        {
+          int *to_unset(&m_vertical[0][j * w]), *to_set(&m_vertical[1][j * w]);
+          for(int x = 0; x < w; ++x)
+            {
+              to_unset[x] = std::min(to_unset[x], m_to_unset[x]);
+              to_set[x] = std::min(to_set[x], m_to_set[x]);
+            }
+          --j;
+        }
+    }
+
+  /* horizontal pass, only the pixels within max_distance
+     of a sample can be closer than max_distance.
+   */
+  for(int j = 0; j < sample_count.y(); ++j)
+    {
+      int y(sample_start.y() + j * sample_stride);
+
+      for(int i = 0; i < sample_count.x(); ++i)
+        {
+          int x(sample_start.x() + i * sample_stride);
+          int kind, best;
+          const int *vertical;
+
+          assert(x >= 0 && x < w);
+          /* a non-zero sample needs the distance to a zero pixel
+             and a zero sample needs the distance to a non-zero pixel
+           */
+          kind = (image[x + y * w] != 0) ? 0 : 1;
+          vertical = &m_vertical[kind][j * w];
+
+          best = far_value_sq;
+          for(int xx = std::max(0, x - max_distance),
+                end_xx = std::min(w, x + max_distance + 1); xx < end_xx; ++xx)
+            {
+              int dx(xx - x), v(vertical[xx]);
+              best = std::min(best, dx * dx + v * v);
+            }
+          out_distances[i + j * sample_count.x()] = (best < far_value_sq) ?
+            std::sqrt(static_cast<float>(best)) :
+            static_cast<float>(far_value);
+        }
+    }
+}
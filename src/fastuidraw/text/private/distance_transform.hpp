@@ -0,0 +1,80 @@
+/*!
+ * \file distance_transform.hpp
+ * \brief file distance_transform.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
+
+namespace fastuidraw
+{
+  namespace detail
+  {
+    /* A DistanceTransform computes the Euclidean distance
+       transform of a binary image at a set of sample pixels
+       up to a maximum distance. It proceeds in two passes as
+       the separable transforms do: the first computes for
+       each pixel of the rows of the samples the vertical
+       distance to the nearest pixel of each kind and the
+       second takes for each sample the minimum over the
+       pixels of its row within the maximum distance. Because
+       the distance is bounded, the first pass is just a
+       sweep down and a sweep up over the rows of the image.
+       The work room is kept between calls so that computing
+       many transforms does not allocate for each one.
+     */
+    class DistanceTransform
+    {
+    public:
+      /* For each sample pixel of image, compute the distance in
+         pixels from the center of the sample pixel to the center
+         of the nearest pixel whose value is of the other kind,
+         i.e. zero if the sample is non-zero and non-zero if the
+         sample is zero. If that distance is more than
+         max_distance, the value written is max_distance + 1.
+         The pixel (x, y) of image is at image[x + y * image_size.x()].
+         The sample (i, j) is the pixel sample_start + sample_stride * (i, j)
+         and is written to out_distances[i + j * sample_count.x()].
+       */
+      void
+      compute(const ivec2 &image_size, const_c_array<uint8_t> image,
+              const ivec2 &sample_start, int sample_stride,
+              const ivec2 &sample_count, int max_distance,
+              c_array<float> out_distances);
+
+    private:
+      void
+      sweep_row(const uint8_t *row, int w, int far_value);
+
+      /* vertical distance of each pixel of the current row
+         to the nearest zero pixel and the nearest non-zero
+         pixel above it (or below it on the sweep up)
+       */
+      std::vector<int> m_to_unset, m_to_set;
+
+      /* minimum vertical distances of the pixels of the rows
+         of the samples, m_vertical[0] to zero pixels and
+         m_vertical[1] to non-zero pixels
+       */
+      vecN<std::vector<int>, 2> m_vertical;
+    };
+  }
+}
@@ -156,6 +156,16 @@ namespace
     void
     fill_index_data(void);
 
+    /* number of texels filled by fill_index_data() for
+       which sub_select_index_hard_case() had to choose
+       two of more than two curves
+     */
+    unsigned int
+    number_approximated_texels(void) const
+    {
+      return m_number_approximated_texels;
+    }
+
   private:
     typedef const fastuidraw::detail::simple_line* curve_cache_value_entry;
     typedef std::map<int, std::vector<curve_cache_value_entry> > curve_cache_value;
@@ -206,6 +216,7 @@ namespace
     std::vector<bool> m_reverse_components;
     boost::multi_array<fastuidraw::detail::analytic_return_type, 2> m_intersection_data;
     boost::multi_array<int, 2> m_winding_values;
+    unsigned int m_number_approximated_texels;
   };
 
 
@@ -643,7 +654,8 @@ IndexTextureData(TaggedOutlineData &outline_data,
   m_outline_data(outline_data),
   m_index_pixels(pixel_data_out),
   m_intersection_data(boost::extents[m_bitmap_sz.x()][m_bitmap_sz.y()]),
-  m_winding_values(boost::extents[m_bitmap_sz.x()][m_bitmap_sz.y()])
+  m_winding_values(boost::extents[m_bitmap_sz.x()][m_bitmap_sz.y()]),
+  m_number_approximated_texels(0)
 {
   std::fill(m_index_pixels.begin(), m_index_pixels.end(), fastuidraw::GlyphRenderDataCurvePair::completely_empty_texel);
   assert(m_index_pixels.size() == static_cast<unsigned int>(m_bitmap_sz.x() * m_bitmap_sz.y()));
@@ -1195,6 +1207,7 @@ select_index(int x, int y)
                                                winding_value))
             {
               pixel=sub_select_index_hard_case(curves, x, y, texel_bl, texel_tr);
+              ++m_number_approximated_texels;
             }
         }
     }
@@ -1285,9 +1298,11 @@ extract_data(GlyphRenderDataCurvePair &output)
       output.resize_geometry_data(outline_data->number_curves());
       outline_data->fill_geometry_data(output.geometry_data());
       index_generator.fill_index_data();
+      output.number_approximated_texels(index_generator.number_approximated_texels());
     }
   else
     {
       output.resize_geometry_data(0);
+      output.number_approximated_texels(0);
     }
 }
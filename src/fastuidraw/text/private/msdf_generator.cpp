@@ -0,0 +1,304 @@
+/*!
+ * \file msdf_generator.cpp
+ * \brief file msdf_generator.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <assert.h>
+#include <cmath>
+#include <algorithm>
+#include "msdf_generator.hpp"
+
+namespace
+{
+  float
+  cross(const fastuidraw::vec2 &a, const fastuidraw::vec2 &b)
+  {
+    return a.x() * b.y() - a.y() * b.x();
+  }
+
+  fastuidraw::vec2
+  unit_or_fallback(const fastuidraw::vec2 &v, const fastuidraw::vec2 &fallback)
+  {
+    float m(v.magnitude());
+    if(m > 1e-6f)
+      {
+        return v / m;
+      }
+
+    m = fallback.magnitude();
+    return (m > 1e-6f) ? fallback / m : fastuidraw::vec2(1.0f, 0.0f);
+  }
+
+  /* same criteria as is commonly used for MSDF: two edges
+     meet at a corner if the direction turns by more than
+     about 3 radians away from being smooth, i.e. the sine
+     of the angle between the tangents is more than sin(3)
+     or the tangents point away from each other.
+   */
+  bool
+  is_corner(const fastuidraw::vec2 &a, const fastuidraw::vec2 &b)
+  {
+    const float cross_threshold(0.14112f);
+    return dot(a, b) <= 0.0f || std::abs(cross(a, b)) > cross_threshold;
+  }
+}
+
+void
+fastuidraw::detail::MSDFGenerator::
+begin_contour(void)
+{
+  m_contours.push_back(contour(m_edges.size()));
+}
+
+void
+fastuidraw::detail::MSDFGenerator::
+add_curve(const vec2 &p0, const vec2 &p1, const vec2 &p2)
+{
+  edge E;
+
+  assert(!m_contours.empty());
+  if(p0 == p2 && p0 == p1)
+    {
+      return;
+    }
+
+  E.m_p0 = p0;
+  E.m_p1 = p1;
+  E.m_p2 = p2;
+  E.m_start_tangent = unit_or_fallback(p1 - p0, p2 - p0);
+  E.m_end_tangent = unit_or_fallback(p2 - p1, p2 - p0);
+  E.m_points = m_points.size();
+  E.m_color = white;
+
+  for(unsigned int i = 0; i <= segments_per_edge; ++i)
+    {
+      float t, s;
+
+      t = static_cast<float>(i) / static_cast<float>(segments_per_edge);
+      s = 1.0f - t;
+      m_points.push_back(s * s * p0 + 2.0f * s * t * p1 + t * t * p2);
+    }
+
+  m_edges.push_back(E);
+  m_contours.back().m_end = m_edges.size();
+}
+
+void
+fastuidraw::detail::MSDFGenerator::
+color_edges(void)
+{
+  const uint32_t cycle[3] = { cyan, magenta, yellow };
+  const uint32_t teardrop[3] = { magenta, white, yellow };
+
+  for(unsigned int c = 0; c < m_contours.size(); ++c)
+    {
+      unsigned int begin(m_contours[c].m_begin), n(m_contours[c].m_end - begin);
+      std::vector<bool> corner(n, false);
+      unsigned int num_corners(0), first_corner(0);
+
+      for(unsigned int i = 0; i < n; ++i)
+        {
+          const edge &prev(m_edges[begin + (i + n - 1) % n]);
+          if(is_corner(prev.m_end_tangent, m_edges[begin + i].m_start_tangent))
+            {
+              if(num_corners == 0)
+                {
+                  first_corner = i;
+                }
+              corner[i] = true;
+              ++num_corners;
+            }
+        }
+
+      if(num_corners == 0 || (num_corners == 1 && n < 3))
+        {
+          /* smooth contour, or a corner with too few edges
+             around it to separate; the contour gives all
+             channels and the corner is not kept sharp.
+           */
+          for(unsigned int i = 0; i < n; ++i)
+            {
+              m_edges[begin + i].m_color = white;
+            }
+        }
+      else if(num_corners == 1)
+        {
+          /* tear drop, split the edges after the corner
+             into three runs so that the edges on either
+             side of the corner share only one channel.
+           */
+          for(unsigned int k = 0; k < n; ++k)
+            {
+              m_edges[begin + (first_corner + k) % n].m_color = teardrop[(3 * k) / n];
+            }
+        }
+      else
+        {
+          unsigned int run(0);
+          for(unsigned int k = 0; k < n; ++k)
+            {
+              unsigned int i((first_corner + k) % n);
+              uint32_t color;
+
+              if(k > 0 && corner[i])
+                {
+                  ++run;
+                }
+
+              color = cycle[run % 3];
+
+              /* the last run meets the first one at first_corner,
+                 they must not have the same color.
+               */
+              if(run == num_corners - 1 && run % 3 == 0)
+                {
+                  color = magenta;
+                }
+              m_edges[begin + i].m_color = color;
+            }
+        }
+    }
+}
+
+float
+fastuidraw::detail::MSDFGenerator::
+signed_pseudo_distance(const edge &E, const vec2 &p, float &true_distance) const
+{
+  float best_dist_sq(-1.0f), best_t(0.0f);
+  unsigned int best_segment(0);
+  vec2 best_q(E.m_p0), best_dir(E.m_start_tangent);
+
+  for(unsigned int i = 0; i < segments_per_edge; ++i)
+    {
+      vec2 a(m_points[E.m_points + i]), b(m_points[E.m_points + i + 1]);
+      vec2 ab(b - a), q;
+      float denom(dot(ab, ab)), t, d_sq;
+
+      t = (denom > 0.0f) ? dot(p - a, ab) / denom : 0.0f;
+      t = std::max(0.0f, std::min(1.0f, t));
+      q = a + t * ab;
+      d_sq = dot(p - q, p - q);
+      if(best_dist_sq < 0.0f || d_sq < best_dist_sq)
+        {
+          best_dist_sq = d_sq;
+          best_t = t;
+          best_segment = i;
+          best_q = q;
+          best_dir = unit_or_fallback(ab, E.m_start_tangent);
+        }
+    }
+
+  true_distance = std::sqrt(best_dist_sq);
+
+  /* beyond an end of the edge the distance is to the
+     tangent line at that end, this is what makes the
+     channels that do not see both edges of a corner
+     extend the edge past the corner.
+   */
+  if(best_segment == 0 && best_t <= 0.0f
+     && dot(p - E.m_p0, E.m_start_tangent) < 0.0f)
+    {
+      return m_orientation * cross(E.m_start_tangent, p - E.m_p0);
+    }
+
+  if(best_segment + 1 == segments_per_edge && best_t >= 1.0f
+     && dot(p - E.m_p2, E.m_end_tangent) > 0.0f)
+    {
+      return m_orientation * cross(E.m_end_tangent, p - E.m_p2);
+    }
+
+  return (m_orientation * cross(best_dir, p - best_q) >= 0.0f) ?
+    true_distance :
+    -true_distance;
+}
+
+void
+fastuidraw::detail::MSDFGenerator::
+compute(const ivec2 &count, const vec2 &origin, float max_distance,
+        vecN<c_array<uint8_t>, 3> out_channels)
+{
+  float area(0.0f);
+
+  for(unsigned int c = 0; c < 3; ++c)
+    {
+      assert(out_channels[c].size() >= static_cast<unsigned int>(count.x() * count.y()));
+      std::fill(out_channels[c].begin(), out_channels[c].end(), 0);
+    }
+
+  if(m_edges.empty())
+    {
+      return;
+    }
+
+  /* the inside is to the left of the edges if the outer
+     contours go counter-clockwise, i.e. if the signed area
+     of the outline is positive.
+   */
+  for(unsigned int e = 0; e < m_edges.size(); ++e)
+    {
+      for(unsigned int i = 0; i < segments_per_edge; ++i)
+        {
+          area += cross(m_points[m_edges[e].m_points + i],
+                        m_points[m_edges[e].m_points + i + 1]);
+        }
+    }
+  m_orientation = (area >= 0.0f) ? 1.0f : -1.0f;
+
+  color_edges();
+
+  for(int y = 0; y < count.y(); ++y)
+    {
+      for(int x = 0; x < count.x(); ++x)
+        {
+          vec2 p(origin + vec2(static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f));
+          vecN<float, 3> best_true(-1.0f), best_signed(0.0f);
+
+          for(unsigned int e = 0; e < m_edges.size(); ++e)
+            {
+              float true_distance, signed_distance;
+
+              signed_distance = signed_pseudo_distance(m_edges[e], p, true_distance);
+              for(unsigned int c = 0; c < 3; ++c)
+                {
+                  /* on a tie, i.e. at the point shared by two
+                     edges, prefer the edge whose pseudo-distance
+                     is larger; the other edge sees p beyond its
+                     end at an angle.
+                   */
+                  if((m_edges[e].m_color & (1u << c)) != 0
+                     && (best_true[c] < 0.0f
+                         || true_distance < best_true[c] - 1e-5f
+                         || (true_distance <= best_true[c] + 1e-5f
+                             && std::abs(signed_distance) > std::abs(best_signed[c]))))
+                    {
+                      best_true[c] = true_distance;
+                      best_signed[c] = signed_distance;
+                    }
+                }
+            }
+
+          for(unsigned int c = 0; c < 3; ++c)
+            {
+              float v;
+
+              v = best_signed[c] / max_distance;
+              v = std::max(-1.0f, std::min(1.0f, v));
+              v = 0.5f * (v + 1.0f);
+              out_channels[c][x + y * count.x()] = static_cast<uint8_t>(255.0f * v);
+            }
+        }
+    }
+}
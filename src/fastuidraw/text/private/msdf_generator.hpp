@@ -0,0 +1,134 @@
+/*!
+ * \file msdf_generator.hpp
+ * \brief file msdf_generator.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
+
+namespace fastuidraw
+{
+  namespace detail
+  {
+    /* A MSDFGenerator computes a multi-channel signed distance
+       field from the contours of an outline made of quadratic
+       curves. The edges of each contour are colored so that the
+       two edges meeting at a corner do not share all channels:
+       a contour without corners is white (all channels), the
+       edges between the corners of a contour otherwise cycle
+       through cyan, magenta and yellow. Each channel is then
+       the signed pseudo-distance to the nearest edge having
+       that channel, i.e. the distance to the tangent line of
+       an end of the edge when the nearest point is that end.
+       The median of the channels is the signed distance to the
+       outline away from the corners and keeps the corners
+       sharp, see GlyphRenderDataMSDF. The generator does not
+       detect or correct the texels where the channels clash.
+     */
+    class MSDFGenerator
+    {
+    public:
+      /* Start a new contour, the curves of a contour
+         are to be added in order and the contour is to
+         end where it starts.
+       */
+      void
+      begin_contour(void);
+
+      /* Add a quadratic curve to the current contour; a
+         line segment is given with p1 being the mid-point
+         of p0 and p2.
+       */
+      void
+      add_curve(const vec2 &p0, const vec2 &p1, const vec2 &p2);
+
+      /* Compute the distance values; the texel (x, y) of a
+         channel is at out_channels[c][x + y * count.x()] and
+         its center is at origin + (x + 0.5, y + 0.5), in the
+         coordinates of the curves. The distances are positive
+         inside of the outline (non-zero fill rule with the
+         orientation of the outer contours) and the value written
+         is 255 * (1 + d / max_distance) / 2 clamped to [0, 255].
+       */
+      void
+      compute(const ivec2 &count, const vec2 &origin, float max_distance,
+              vecN<c_array<uint8_t>, 3> out_channels);
+
+    private:
+      enum
+        {
+          red_bit = 1,
+          green_bit = 2,
+          blue_bit = 4,
+
+          white = red_bit | green_bit | blue_bit,
+          cyan = green_bit | blue_bit,
+          magenta = red_bit | blue_bit,
+          yellow = red_bit | green_bit,
+        };
+
+      /* number of line segments an edge is flattened into */
+      enum
+        {
+          segments_per_edge = 8
+        };
+
+      class edge
+      {
+      public:
+        vec2 m_p0, m_p1, m_p2;
+
+        /* unit tangents at the start and the end */
+        vec2 m_start_tangent, m_end_tangent;
+
+        /* index into m_points of the first point of
+           the flattening, the flattening has
+           segments_per_edge + 1 points
+         */
+        unsigned int m_points;
+
+        uint32_t m_color;
+      };
+
+      class contour
+      {
+      public:
+        contour(unsigned int first):
+          m_begin(first),
+          m_end(first)
+        {}
+
+        unsigned int m_begin, m_end;
+      };
+
+      void
+      color_edges(void);
+
+      float
+      signed_pseudo_distance(const edge &E, const vec2 &p, float &true_distance) const;
+
+      std::vector<edge> m_edges;
+      std::vector<contour> m_contours;
+      std::vector<vec2> m_points;
+      float m_orientation;
+    };
+  }
+}
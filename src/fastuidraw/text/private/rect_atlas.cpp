@@ -435,12 +435,81 @@ fast_check(ivec2 psize)
    */
 }
 
+/////////////////////////////////////////
+// fastuidraw::detail::RectAtlas::shelf methods
+int
+fastuidraw::detail::RectAtlas::shelf::
+allocate(int w)
+{
+  int x;
+
+  /* first fit in the freed spans */
+  for(unsigned int i = 0, endi = m_free_spans.size(); i < endi; ++i)
+    {
+      ivec2 &span(m_free_spans[i]);
+      if(span.y() >= w)
+        {
+          x = span.x();
+          span.x() += w;
+          span.y() -= w;
+          if(span.y() == 0)
+            {
+              span = m_free_spans.back();
+              m_free_spans.pop_back();
+            }
+          return x;
+        }
+    }
+
+  if(m_x + w <= m_backing->size().x())
+    {
+      x = m_x;
+      m_x += w;
+      return x;
+    }
+
+  return -1;
+}
+
+void
+fastuidraw::detail::RectAtlas::shelf::
+deallocate(int x, int w)
+{
+  /* merge with the freed spans that touch [x, x + w) */
+  for(unsigned int i = 0; i < m_free_spans.size();)
+    {
+      ivec2 span(m_free_spans[i]);
+      if(span.x() + span.y() == x || x + w == span.x())
+        {
+          x = std::min(x, span.x());
+          w += span.y();
+          m_free_spans[i] = m_free_spans.back();
+          m_free_spans.pop_back();
+        }
+      else
+        {
+          ++i;
+        }
+    }
+
+  if(x + w == m_x)
+    {
+      m_x = x;
+    }
+  else
+    {
+      m_free_spans.push_back(ivec2(x, w));
+    }
+}
+
 ////////////////////////////////////
 // fastuidraw::detail::RectAtlas methods
 fastuidraw::detail::RectAtlas::
 RectAtlas(const ivec2 &dimensions):
   m_root(NULL),
-  m_empty_rect(this, ivec2(0, 0))
+  m_empty_rect(this, ivec2(0, 0)),
+  m_area_allocated(0),
+  m_shelf_max_height(0)
 {
   m_root = FASTUIDRAWnew tree_node_without_children(NULL, &m_tracker, ivec2(0,0), dimensions, NULL);
 }
@@ -449,9 +518,26 @@ fastuidraw::detail::RectAtlas::
 ~RectAtlas()
 {
   assert(m_root != NULL);
+  clear_shelves();
   FASTUIDRAWdelete(m_root);
 }
 
+void
+fastuidraw::detail::RectAtlas::
+shelf_max_height(int v)
+{
+  m_mutex.lock();
+  m_shelf_max_height = v;
+  m_mutex.unlock();
+}
+
+int
+fastuidraw::detail::RectAtlas::
+shelf_max_height(void) const
+{
+  return m_shelf_max_height;
+}
+
 fastuidraw::ivec2
 fastuidraw::detail::RectAtlas::
 size(void) const
@@ -460,6 +546,13 @@ size(void) const
   return m_root->size();
 }
 
+int
+fastuidraw::detail::RectAtlas::
+area_allocated(void) const
+{
+  return m_area_allocated;
+}
+
 void
 fastuidraw::detail::RectAtlas::
 clear(void)
@@ -467,11 +560,155 @@ clear(void)
   ivec2 dimensions(m_root->size());
 
   m_mutex.lock();
+  clear_shelves();
   FASTUIDRAWdelete(m_root);
   m_root = FASTUIDRAWnew tree_node_without_children(NULL, &m_tracker, ivec2(0,0), dimensions, NULL);
+  m_area_allocated = 0;
   m_mutex.unlock();
 }
 
+void
+fastuidraw::detail::RectAtlas::
+clear_shelves(void)
+{
+  /* the backing rectangles of the shelves are
+     deleted with the tree
+   */
+  for(shelf_map::iterator iter = m_shelves.begin(), end = m_shelves.end();
+      iter != end; ++iter)
+    {
+      for(unsigned int i = 0, endi = iter->second.size(); i < endi; ++i)
+        {
+          shelf *S(iter->second[i]);
+          for(unsigned int r = 0, endr = S->m_rects.size(); r < endr; ++r)
+            {
+              FASTUIDRAWdelete(S->m_rects[r]);
+            }
+          FASTUIDRAWdelete(S);
+        }
+    }
+  m_shelves.clear();
+}
+
+fastuidraw::detail::RectAtlas::rectangle*
+fastuidraw::detail::RectAtlas::
+add_to_tree(const ivec2 &dimensions)
+{
+  rectangle *return_value;
+  add_remove_return_value R;
+
+  if(!m_tracker.fast_check(dimensions))
+    {
+      return NULL;
+    }
+
+  return_value = FASTUIDRAWnew rectangle(this, dimensions);
+  R = m_root->add(return_value);
+  if(R.second != routine_success)
+    {
+      FASTUIDRAWdelete(return_value);
+      return NULL;
+    }
+
+  if(R.first != m_root)
+    {
+      FASTUIDRAWdelete(m_root);
+      m_root = R.first;
+    }
+  return return_value;
+}
+
+enum fastuidraw::return_code
+fastuidraw::detail::RectAtlas::
+remove_from_tree(const rectangle *im)
+{
+  add_remove_return_value R;
+
+  R = m_root->api_remove(im);
+  if(R.second == routine_success and R.first != m_root)
+    {
+      FASTUIDRAWdelete(m_root);
+      m_root = R.first;
+    }
+  return R.second;
+}
+
+fastuidraw::detail::RectAtlas::rectangle*
+fastuidraw::detail::RectAtlas::
+add_to_shelf(const ivec2 &dimensions)
+{
+  int height, x(-1);
+  shelf *S(NULL);
+
+  height = round_up_to_multiple(dimensions.y(), shelf_height_granularity);
+  height = std::min(height, m_root->size().y());
+
+  std::vector<shelf*> &shelves(m_shelves[height]);
+
+  /* the shelves made last are the most likely to have room */
+  for(unsigned int i = shelves.size(); i > 0 && x < 0; --i)
+    {
+      S = shelves[i - 1];
+      x = S->allocate(dimensions.x());
+    }
+
+  if(x < 0)
+    {
+      rectangle *backing;
+
+      backing = add_to_tree(ivec2(m_root->size().x(), height));
+      if(backing == NULL)
+        {
+          return NULL;
+        }
+
+      S = FASTUIDRAWnew shelf(backing);
+      shelves.push_back(S);
+      x = S->allocate(dimensions.x());
+      assert(x == 0);
+    }
+
+  rectangle *return_value;
+
+  return_value = FASTUIDRAWnew rectangle(this, dimensions);
+  return_value->m_minX_minY = S->m_backing->minX_minY() + ivec2(x, 0);
+  return_value->m_shelf = S;
+  return_value->m_shelf_slot = S->m_rects.size();
+  S->m_rects.push_back(return_value);
+
+  return return_value;
+}
+
+void
+fastuidraw::detail::RectAtlas::
+remove_from_shelf(const rectangle *im)
+{
+  shelf *S(im->m_shelf);
+  unsigned int slot(im->m_shelf_slot);
+
+  assert(slot < S->m_rects.size());
+  assert(S->m_rects[slot] == im);
+
+  S->deallocate(im->minX_minY().x() - S->m_backing->minX_minY().x(), im->size().x());
+  FASTUIDRAWdelete(S->m_rects[slot]);
+  S->m_rects[slot] = S->m_rects.back();
+  S->m_rects[slot]->m_shelf_slot = slot;
+  S->m_rects.pop_back();
+
+  if(S->m_rects.empty())
+    {
+      std::vector<shelf*> &shelves(m_shelves[S->m_backing->size().y()]);
+      std::vector<shelf*>::iterator iter;
+
+      iter = std::find(shelves.begin(), shelves.end(), S);
+      assert(iter != shelves.end());
+      shelves.erase(iter);
+
+      remove_from_tree(S->m_backing);
+      FASTUIDRAWdelete(S);
+    }
+}
+
 const fastuidraw::detail::RectAtlas::rectangle*
 fastuidraw::detail::RectAtlas::
 add_rectangle(const ivec2 &dimensions,
@@ -481,40 +718,38 @@ add_rectangle(const ivec2 &dimensions,
   rectangle *return_value(NULL);
 
   m_mutex.lock();
-  if(m_tracker.fast_check(dimensions))
+  if(dimensions.x() > 0 and dimensions.y() > 0)
     {
-      add_remove_return_value R;
-
-
-      if(dimensions.x() > 0 and dimensions.y() > 0)
+      if(dimensions.y() <= m_shelf_max_height
+         && dimensions.x() <= m_root->size().x())
         {
-          //attempt to add the rect:
-          return_value = FASTUIDRAWnew rectangle(this, dimensions);
-          R = m_root->add(return_value);
+          return_value = add_to_shelf(dimensions);
+        }
 
-          if(R.second == routine_success)
-            {
-              if(R.first != m_root)
-                {
-                  FASTUIDRAWdelete(m_root);
-                  m_root = R.first;
-                }
-            }
-          else
-            {
-              FASTUIDRAWdelete(return_value);
-              return_value = NULL;
-            }
+      /* a rectangle for which there is no room for
+         a new shelf may still fit in the tree
+       */
+      if(return_value == NULL)
+        {
+          return_value = add_to_tree(dimensions);
         }
-      else
+
+      if(return_value != NULL)
         {
-          return_value = &m_empty_rect;
+          m_area_allocated += dimensions.x() * dimensions.y();
         }
     }
+  else if(m_tracker.fast_check(dimensions))
+    {
+      return_value = &m_empty_rect;
+    }
   m_mutex.unlock();
 
-  return_value->finalize(left_padding, right_padding,
-                         top_padding, bottom_padding);
+  if(return_value != NULL)
+    {
+      return_value->finalize(left_padding, right_padding,
+                             top_padding, bottom_padding);
+    }
   return return_value;
 }
 
@@ -523,8 +758,6 @@ enum fastuidraw::return_code
 fastuidraw::detail::RectAtlas::
 remove_rectangle_implement(const rectangle *im)
 {
-  add_remove_return_value R;
-
   assert(im->atlas() == this);
 
   if(im->size().x() <= 0 or im->size().y() <= 0)
@@ -534,15 +767,26 @@ remove_rectangle_implement(const rectangle *im)
     }
   else
     {
+      int area(im->size().x() * im->size().y());
+      enum return_code return_value;
+
       m_mutex.lock();
-      R = m_root->api_remove(im);
-      if(R.second == routine_success and R.first != m_root)
+      if(im->m_shelf != NULL)
+        {
+          remove_from_shelf(im);
+          return_value = routine_success;
+        }
+      else
+        {
+          return_value = remove_from_tree(im);
+        }
+
+      if(return_value == routine_success)
         {
-          FASTUIDRAWdelete(m_root);
-          m_root = R.first;
+          m_area_allocated -= area;
         }
       m_mutex.unlock();
-      return R.second;
+      return return_value;
     }
 }
 
@@ -20,6 +20,8 @@
 #pragma once
 
 #include <assert.h>
+#include <map>
+#include <vector>
 
 #include <fastuidraw/util/reference_counted.hpp>
 #include <fastuidraw/util/util.hpp>
@@ -34,12 +36,18 @@ namespace detail {
 
 /*!\class RectAtlas
   Provides an interface to allocate and free rectangle
-  regions from a large rectangle.
+  regions from a large rectangle. Rectangles are placed
+  by a tree that splits the free room (a guillotine
+  packer) or, for short rectangles (see shelf_max_height()),
+  in shelves: rows of the width of the atlas, allocated
+  from the tree, in which rectangles of similar height
+  are placed side by side.
  */
 class RectAtlas:public fastuidraw::noncopyable
 {
 private:
   class tree_base;
+  class shelf;
 
 public:
   /*!\class rectangle
@@ -104,7 +112,9 @@ public:
       m_atlas(p),
       m_minX_minY(0, 0),
       m_size(psize),
-      m_tree(NULL)
+      m_tree(NULL),
+      m_shelf(NULL),
+      m_shelf_slot(0)
     {}
 
     void
@@ -120,6 +130,12 @@ public:
     ivec2 m_unpadded_minX_minY, m_unpadded_size;
     tree_base *m_tree;
 
+    /* if non-NULL, the rectangle is in a shelf (and m_tree
+       is NULL) at the index m_shelf_slot of shelf::m_rects
+     */
+    shelf *m_shelf;
+    unsigned int m_shelf_slot;
+
     void
     build_parent_list(std::list<const tree_base*> &output) const;
   };
@@ -166,6 +182,43 @@ public:
   ivec2
   size(void) const;
 
+  /*!\fn int area_allocated
+    Returns the sum of the areas (including padding)
+    of the rectangles of this RectAtlas that are not
+    yet deleted.
+   */
+  int
+  area_allocated(void) const;
+
+  /*!\fn void shelf_max_height
+    Set the largest height of the rectangles that are placed
+    in shelves. A shelf holds rectangles whose height rounded
+    up to a multiple of \ref shelf_height_granularity is its
+    height; finding room in a shelf is a scan of its few freed
+    spans instead of a search of the tree, and the shelves of
+    a height pack rectangles of that height tightly. A shelf is
+    given back to the tree when its last rectangle is deleted.
+    A value of 0 or less indicates to place all rectangles
+    with the tree. Changing the value does not move the
+    rectangles already added. Default value is 0.
+   */
+  void
+  shelf_max_height(int v);
+
+  /*!\fn int shelf_max_height
+    Returns the value set by shelf_max_height(int).
+   */
+  int
+  shelf_max_height(void) const;
+
+  /*!\var shelf_height_granularity
+    The height of a shelf is a multiple of this value.
+   */
+  enum
+    {
+      shelf_height_granularity = 4
+    };
+
   /*!\fn enum return_code delete_rectangle
     Delete a rectangle, and in doing so remove it
     from the owning RectAtlas, and thus allowing
@@ -367,9 +420,60 @@ private:
     freesize_map m_sorted_by_y_size;
   };
 
+  /* A shelf is a rectangle of the tree (m_backing) of the
+     width of the atlas; the rectangles of a shelf are placed
+     from left to right, [0, m_x) is the used part of the
+     shelf and m_free_spans are the spans (x, width) within
+     it of the rectangles deleted since.
+   */
+  class shelf
+  {
+  public:
+    explicit
+    shelf(rectangle *backing):
+      m_backing(backing),
+      m_x(0)
+    {}
+
+    /* returns the x-offset within the shelf of a span
+       of width w, or -1 if the shelf has no room.
+     */
+    int
+    allocate(int w);
+
+    void
+    deallocate(int x, int w);
+
+    rectangle *m_backing;
+    int m_x;
+    std::vector<ivec2> m_free_spans;
+    std::vector<rectangle*> m_rects;
+  };
+
+  typedef std::map<int, std::vector<shelf*> > shelf_map;
+
   enum return_code
   remove_rectangle_implement(const rectangle *im);
 
+  /* add and remove rectangles of the tree and of the
+     shelves; the caller locks m_mutex and tracks the
+     area allocated.
+   */
+  rectangle*
+  add_to_tree(const ivec2 &dimensions);
+
+  enum return_code
+  remove_from_tree(const rectangle *im);
+
+  rectangle*
+  add_to_shelf(const ivec2 &dimensions);
+
+  void
+  remove_from_shelf(const rectangle *im);
+
+  void
+  clear_shelves(void);
+
   static
   void
   move_rectangle(rectangle *rect, const ivec2 &moveby)
@@ -390,6 +494,9 @@ private:
   fastuidraw::mutex m_mutex;
   tree_base *m_root;
   rectangle m_empty_rect;
+  int m_area_allocated;
+  shelf_map m_shelves;
+  int m_shelf_max_height;
 };
 
 } //namespace detail_private
@@ -7,7 +7,7 @@ d		:= $(dir)
 LIBRARY_SOURCES += $(call filelist, static_resource.cpp \
 	fastuidraw_memory.cpp util.cpp blend_mode.cpp \
 	reference_count_mutex.cpp reference_count_atomic.cpp \
-	pixel_distance_math.cpp)
+	pixel_distance_math.cpp memory_report.cpp task_executor.cpp)
 
 # Begin standard footer
 d		:= $(dirstack_$(sp))
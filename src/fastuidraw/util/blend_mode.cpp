@@ -25,7 +25,7 @@ namespace
 {
   enum
     {
-      op_num_bits = 3,
+      op_num_bits = 5,
       func_num_bits = 5,
     };
 
@@ -52,7 +52,13 @@ namespace
       func_dst_alpha_bit0 = func_dst_rgb_bit0 + func_dst_rgb_num_bits,
       func_dst_alpha_num_bits = func_num_bits,
 
-      total_blending_bits = func_dst_alpha_bit0 + func_dst_alpha_num_bits
+      stencil_op_bit0 = func_dst_alpha_bit0 + func_dst_alpha_num_bits,
+      stencil_op_num_bits = 4,
+
+      stencil_value_bit0 = stencil_op_bit0 + stencil_op_num_bits,
+      stencil_value_num_bits = 8,
+
+      total_blending_bits = stencil_value_bit0 + stencil_value_num_bits
     };
 
   template<typename T>
@@ -62,7 +68,7 @@ namespace
             fastuidraw::BlendMode::packed_value value,
             T &dest)
   {
-    dest = static_cast<T>(fastuidraw::unpack_bits(bit0, num_bits, value));
+    dest = static_cast<T>(fastuidraw::uint64_unpack_bits(bit0, num_bits, value));
   }
 
   template<typename T>
@@ -71,7 +77,7 @@ namespace
              fastuidraw::BlendMode::packed_value num_bits,
              T value)
   {
-    return fastuidraw::pack_bits(bit0, num_bits, fastuidraw::BlendMode::packed_value(value));
+    return fastuidraw::uint64_pack_bits(bit0, num_bits, fastuidraw::BlendMode::packed_value(value));
   }
 }
 
@@ -88,6 +94,8 @@ BlendMode(packed_value v)
   set_value(fun_src_alpha_bit0, fun_src_alpha_num_bits, v, m_blend_func[Kfunc_src_alpha]);
   set_value(func_dst_rgb_bit0, func_dst_rgb_num_bits, v, m_blend_func[Kfunc_dst_rgb]);
   set_value(func_dst_alpha_bit0, func_dst_alpha_num_bits, v, m_blend_func[Kfunc_dst_alpha]);
+  set_value(stencil_op_bit0, stencil_op_num_bits, v, m_stencil_op);
+  set_value(stencil_value_bit0, stencil_value_num_bits, v, m_stencil_value);
 }
 
 fastuidraw::BlendMode::packed_value
@@ -100,5 +108,7 @@ packed(void) const
     | pack_value(func_src_rgb_bit0, func_src_rgb_num_bits, m_blend_func[Kfunc_src_rgb])
     | pack_value(fun_src_alpha_bit0, fun_src_alpha_num_bits, m_blend_func[Kfunc_src_alpha])
     | pack_value(func_dst_rgb_bit0, func_dst_rgb_num_bits, m_blend_func[Kfunc_dst_rgb])
-    | pack_value(func_dst_alpha_bit0, func_dst_alpha_num_bits, m_blend_func[Kfunc_dst_alpha]);
+    | pack_value(func_dst_alpha_bit0, func_dst_alpha_num_bits, m_blend_func[Kfunc_dst_alpha])
+    | pack_value(stencil_op_bit0, stencil_op_num_bits, m_stencil_op)
+    | pack_value(stencil_value_bit0, stencil_value_num_bits, m_stencil_value);
 }
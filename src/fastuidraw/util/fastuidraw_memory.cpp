@@ -23,7 +23,10 @@
 #include <iomanip>
 #include <iosfwd>
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
+#include <stdint.h>
+#include <new>
 
 #include <fastuidraw/util/fastuidraw_memory.hpp>
 #include "../private/util_private.hpp"
@@ -38,20 +41,36 @@ namespace
               << size << " bytes failed\n";
   }
 
-  class address_set_type:
-    private std::map<const void*, std::pair<const char*,int> >
+  /* set once at program start by set_allocator(), read
+     without locking by each allocation.
+   */
+  fastuidraw::memory::allocator *s_allocator = NULL;
+
+  /* The tracked addresses are split across shards, each with
+     its own lock, so that allocations from different threads
+     rarely contend on the same lock.
+   */
+  class address_shard:
+    public std::map<const void*, std::pair<const char*,int> >
   {
   public:
+    fastuidraw::mutex m_mutex;
+  };
+
+  class address_set_type
+  {
+  public:
+    enum
+      {
+        number_shards = 64
+      };
+
     address_set_type(void)
     {}
 
-    virtual
     ~address_set_type()
     {
-      if(!empty())
-        {
-          print(std::cerr);
-        }
+      print(std::cerr);
     }
 
     bool
@@ -67,7 +86,20 @@ namespace
     print(std::ostream &ostr);
 
   private:
-    fastuidraw::mutex m_mutex;
+    address_shard&
+    shard(const void *ptr)
+    {
+      uintptr_t v;
+
+      /* the low bits are the same for all allocations
+         because of alignment, so mix in higher bits.
+       */
+      v = reinterpret_cast<uintptr_t>(ptr);
+      v = (v >> 4u) ^ (v >> 10u);
+      return m_shards[v % number_shards];
+    }
+
+    address_shard m_shards[number_shards];
   };
 
   address_set_type&
@@ -77,6 +109,52 @@ namespace
     return retval;
   }
 
+  void*
+  allocate(size_t size, enum fastuidraw::memory::tag_t tag)
+  {
+    return (s_allocator) ?
+      s_allocator->allocate(size, tag) :
+      std::malloc(size);
+  }
+
+  void*
+  callocate(size_t nmemb, size_t size, enum fastuidraw::memory::tag_t tag)
+  {
+    void *return_value;
+
+    if(!s_allocator)
+      {
+        return std::calloc(nmemb, size);
+      }
+
+    return_value = s_allocator->allocate(nmemb * size, tag);
+    if(return_value)
+      {
+        std::memset(return_value, 0, nmemb * size);
+      }
+    return return_value;
+  }
+
+  void*
+  reallocate(void *ptr, size_t size, enum fastuidraw::memory::tag_t tag)
+  {
+    return (s_allocator) ?
+      s_allocator->reallocate(ptr, size, tag) :
+      std::realloc(ptr, size);
+  }
+
+  void
+  deallocate(void *ptr, enum fastuidraw::memory::tag_t tag)
+  {
+    if(s_allocator)
+      {
+        s_allocator->deallocate(ptr, tag);
+      }
+    else
+      {
+        std::free(ptr);
+      }
+  }
 }
 
 ///////////////////////////////////////////////
@@ -86,10 +164,11 @@ address_set_type::
 present(const void *ptr)
 {
   bool return_value;
+  address_shard &S(shard(ptr));
 
-  m_mutex.lock();
-  return_value = (find(ptr) != end());
-  m_mutex.unlock();
+  S.m_mutex.lock();
+  return_value = (S.find(ptr) != S.end());
+  S.m_mutex.unlock();
   return return_value;
 }
 
@@ -97,9 +176,11 @@ void
 address_set_type::
 track(const void *ptr, const char* file, int line)
 {
-  m_mutex.lock();
-  insert(value_type(ptr, mapped_type(file, line)));
-  m_mutex.unlock();
+  address_shard &S(shard(ptr));
+
+  S.m_mutex.lock();
+  S.insert(address_shard::value_type(ptr, address_shard::mapped_type(file, line)));
+  S.m_mutex.unlock();
 }
 
 void
@@ -107,22 +188,23 @@ address_set_type::
 untrack(const void *ptr, const char *file, int line)
 {
   bool found;
-  iterator iter;
+  address_shard::iterator iter;
+  address_shard &S(shard(ptr));
 
-  m_mutex.lock();
+  S.m_mutex.lock();
 
-  iter = find(ptr);
-  if(iter != end())
+  iter = S.find(ptr);
+  if(iter != S.end())
     {
       found = true;
-      erase(iter);
+      S.erase(iter);
     }
   else
     {
       found = false;
     }
 
-  m_mutex.unlock();
+  S.m_mutex.unlock();
 
   if(!found)
     {
@@ -136,20 +218,37 @@ void
 address_set_type::
 print(std::ostream &ostr)
 {
-  m_mutex.lock();
-
-  for(const_iterator iter = begin(); iter != end(); ++iter)
+  for(unsigned int i = 0; i < number_shards; ++i)
     {
-      ostr << const_cast<void*>(iter->first) << "[" << iter->second.first
-           << "," << iter->second.second << "]\n";
-    }
+      address_shard &S(m_shards[i]);
 
-  m_mutex.unlock();
+      S.m_mutex.lock();
+      for(address_shard::const_iterator iter = S.begin(); iter != S.end(); ++iter)
+        {
+          ostr << const_cast<void*>(iter->first) << "[" << iter->second.first
+               << "," << iter->second.second << "]\n";
+        }
+      S.m_mutex.unlock();
+    }
 }
 
 
 //////////////////////////////////////////////////////
 // fastuidraw::memory methods
+void
+fastuidraw::memory::
+set_allocator(allocator *p)
+{
+  s_allocator = p;
+}
+
+fastuidraw::memory::allocator*
+fastuidraw::memory::
+get_allocator(void)
+{
+  return s_allocator;
+}
+
 void
 fastuidraw::memory::
 object_deletion_message(const void *ptr, const char *file, int line)
@@ -163,7 +262,7 @@ object_deletion_message(const void *ptr, const char *file, int line)
 
 void*
 fastuidraw::memory::
-malloc_implement(size_t size, const char *file, int line)
+malloc_implement(size_t size, enum tag_t tag, const char *file, int line)
 {
   void *return_value;
 
@@ -172,7 +271,7 @@ malloc_implement(size_t size, const char *file, int line)
       return NULL;
     }
 
-  return_value = std::malloc(size);
+  return_value = allocate(size, tag);
   if(!return_value)
     {
       bad_malloc_message(size, file, line);
@@ -186,7 +285,7 @@ malloc_implement(size_t size, const char *file, int line)
 
 void*
 fastuidraw::memory::
-calloc_implement(size_t nmemb, size_t size, const char *file, int line)
+calloc_implement(size_t nmemb, size_t size, enum tag_t tag, const char *file, int line)
 {
   void *return_value;
 
@@ -195,7 +294,7 @@ calloc_implement(size_t nmemb, size_t size, const char *file, int line)
       return NULL;
     }
 
-  return_value = std::calloc(nmemb, size);
+  return_value = callocate(nmemb, size, tag);
   if(!return_value)
     {
       bad_malloc_message(size * nmemb, file, line);
@@ -209,18 +308,18 @@ calloc_implement(size_t nmemb, size_t size, const char *file, int line)
 
 void*
 fastuidraw::memory::
-realloc_implement(void *ptr, size_t size, const char *file, int line)
+realloc_implement(void *ptr, size_t size, enum tag_t tag, const char *file, int line)
 {
   void *return_value;
 
   if(!ptr)
     {
-      return malloc_implement(size, file, line);
+      return malloc_implement(size, tag, file, line);
     }
 
   if(size == 0)
     {
-      free_implement(ptr, file, line);
+      free_implement(ptr, tag, file, line);
       return NULL;
     }
 
@@ -231,7 +330,7 @@ realloc_implement(void *ptr, size_t size, const char *file, int line)
                 << std::flush;
     }
 
-  return_value = std::realloc(ptr, size);
+  return_value = reallocate(ptr, size, tag);
 
   if(return_value != ptr)
     {
@@ -244,35 +343,147 @@ realloc_implement(void *ptr, size_t size, const char *file, int line)
 
 void
 fastuidraw::memory::
-free_implement(void *ptr, const char *file, int line)
+free_implement(void *ptr, enum tag_t tag, const char *file, int line)
 {
   if(ptr)
     {
       address_set().untrack(ptr, file, line);
+      deallocate(ptr, tag);
     }
-  std::free(ptr);
 }
 
 void*
-operator new(std::size_t n, const char *file, int line) throw ()
+fastuidraw::memory::
+malloc_dispatch(size_t size, enum tag_t tag)
+{
+  return (size != 0) ?
+    allocate(size, tag) :
+    NULL;
+}
+
+void*
+fastuidraw::memory::
+calloc_dispatch(size_t nmemb, size_t size, enum tag_t tag)
 {
-  return fastuidraw::memory::malloc_implement(n, file, line);
+  return (nmemb != 0 && size != 0) ?
+    callocate(nmemb, size, tag) :
+    NULL;
 }
 
 void*
-operator new[](std::size_t n, const char *file, int line) throw ()
+fastuidraw::memory::
+realloc_dispatch(void *ptr, size_t size, enum tag_t tag)
 {
-  return fastuidraw::memory::malloc_implement(n, file, line);
+  if(!ptr)
+    {
+      return malloc_dispatch(size, tag);
+    }
+
+  if(size == 0)
+    {
+      free_dispatch(ptr, tag);
+      return NULL;
+    }
+
+  return reallocate(ptr, size, tag);
 }
 
 void
-operator delete(void *ptr, const char *file, int line) throw()
+fastuidraw::memory::
+free_dispatch(void *ptr, enum tag_t tag)
 {
-  fastuidraw::memory::free_implement(ptr, file, line);
+  if(ptr)
+    {
+      deallocate(ptr, tag);
+    }
+}
+
+/* FASTUIDRAWnew takes the storage of an object from the allocator,
+   FASTUIDRAWdelete destroys the object and gives the storage back
+   to it. The storage of arrays comes from the global operator new[]
+   since FASTUIDRAWdelete_array releases with the global delete[].
+ */
+void*
+operator new(std::size_t n, enum fastuidraw::memory::tag_t tag) throw ()
+{
+  return allocate(n == 0 ? 1 : n, tag);
+}
+
+void*
+operator new(std::size_t n, enum fastuidraw::memory::tag_t tag,
+             const char *file, int line) throw ()
+{
+  void *return_value;
+
+  return_value = allocate(n == 0 ? 1 : n, tag);
+  if(!return_value)
+    {
+      bad_malloc_message(n, file, line);
+    }
+  else
+    {
+      address_set().track(return_value, file, line);
+    }
+  return return_value;
+}
+
+void*
+operator new[](std::size_t n, enum fastuidraw::memory::tag_t) throw ()
+{
+  return ::operator new[](n, std::nothrow);
+}
+
+void*
+operator new[](std::size_t n, enum fastuidraw::memory::tag_t,
+               const char *file, int line) throw ()
+{
+  void *return_value;
+
+  return_value = ::operator new[](n, std::nothrow);
+  if(!return_value)
+    {
+      bad_malloc_message(n, file, line);
+    }
+  else
+    {
+      address_set().track(return_value, file, line);
+    }
+  return return_value;
 }
 
 void
-operator delete[](void *ptr, const char *file, int line) throw()
+operator delete(void *ptr, enum fastuidraw::memory::tag_t tag) throw()
 {
-  fastuidraw::memory::free_implement(ptr, file, line);
+  if(ptr)
+    {
+      deallocate(ptr, tag);
+    }
+}
+
+void
+operator delete(void *ptr, enum fastuidraw::memory::tag_t tag,
+                const char *file, int line) throw()
+{
+  if(ptr)
+    {
+      address_set().untrack(ptr, file, line);
+      deallocate(ptr, tag);
+    }
+}
+
+void
+operator delete[](void *ptr, enum fastuidraw::memory::tag_t) throw()
+{
+  ::operator delete[](ptr);
+}
+
+void
+operator delete[](void *ptr, enum fastuidraw::memory::tag_t,
+                  const char *file, int line) throw()
+{
+  if(ptr)
+    {
+      address_set().untrack(ptr, file, line);
+    }
+  ::operator delete[](ptr);
 }
@@ -0,0 +1,157 @@
+/*!
+ * \file memory_report.cpp
+ * \brief file memory_report.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <assert.h>
+#include <fastuidraw/util/memory_report.hpp>
+#include "../private/util_private.hpp"
+#include "../private/memory_report_private.hpp"
+
+namespace
+{
+  class subsystem_entry
+  {
+  public:
+    subsystem_entry(void):
+      m_callback(NULL)
+    {}
+
+    fastuidraw::mutex m_mutex;
+    fastuidraw::memory::usage m_current;
+    fastuidraw::memory::usage m_limit;
+    fastuidraw::memory::budget_callback *m_callback;
+  };
+
+  class subsystem_table
+  {
+  public:
+    subsystem_entry m_entries[fastuidraw::memory::number_subsystems];
+  };
+
+  subsystem_entry&
+  entry(enum fastuidraw::memory::subsystem_t subsystem)
+  {
+    static subsystem_table R;
+
+    assert(subsystem < fastuidraw::memory::number_subsystems);
+    return R.m_entries[subsystem];
+  }
+
+  bool
+  over_limit(uint64_t current, uint64_t limit)
+  {
+    return limit != 0 && current > limit;
+  }
+}
+
+//////////////////////////////////////////////////
+// fastuidraw::detail methods
+void
+fastuidraw::detail::
+memory_report_grow(enum memory::subsystem_t subsystem,
+                   uint64_t cpu_bytes, uint64_t gpu_bytes)
+{
+  subsystem_entry &E(entry(subsystem));
+  memory::usage current, limit;
+  memory::budget_callback *callback;
+
+  if(cpu_bytes == 0 && gpu_bytes == 0)
+    {
+      return;
+    }
+
+  E.m_mutex.lock();
+  E.m_current.m_cpu_bytes += cpu_bytes;
+  E.m_current.m_gpu_bytes += gpu_bytes;
+  current = E.m_current;
+  limit = E.m_limit;
+  callback = E.m_callback;
+  E.m_mutex.unlock();
+
+  if(callback)
+    {
+      if(gpu_bytes != 0)
+        {
+          callback->grew(subsystem, current);
+        }
+
+      if(over_limit(current.m_cpu_bytes, limit.m_cpu_bytes)
+         || over_limit(current.m_gpu_bytes, limit.m_gpu_bytes))
+        {
+          callback->over_budget(subsystem, current, limit);
+        }
+    }
+}
+
+void
+fastuidraw::detail::
+memory_report_shrink(enum memory::subsystem_t subsystem,
+                     uint64_t cpu_bytes, uint64_t gpu_bytes)
+{
+  subsystem_entry &E(entry(subsystem));
+
+  E.m_mutex.lock();
+  assert(E.m_current.m_cpu_bytes >= cpu_bytes);
+  assert(E.m_current.m_gpu_bytes >= gpu_bytes);
+  E.m_current.m_cpu_bytes -= cpu_bytes;
+  E.m_current.m_gpu_bytes -= gpu_bytes;
+  E.m_mutex.unlock();
+}
+
+void
+fastuidraw::detail::
+memory_report_free_space(enum memory::subsystem_t subsystem,
+                         uint64_t old_free_bytes, uint64_t old_largest_free_bytes,
+                         uint64_t new_free_bytes, uint64_t new_largest_free_bytes)
+{
+  subsystem_entry &E(entry(subsystem));
+
+  E.m_mutex.lock();
+  assert(E.m_current.m_free_bytes >= old_free_bytes);
+  assert(E.m_current.m_largest_free_bytes >= old_largest_free_bytes);
+  E.m_current.m_free_bytes += new_free_bytes - old_free_bytes;
+  E.m_current.m_largest_free_bytes += new_largest_free_bytes - old_largest_free_bytes;
+  E.m_mutex.unlock();
+}
+
+//////////////////////////////////////////////////
+// fastuidraw::memory methods
+fastuidraw::memory::usage
+fastuidraw::memory::
+subsystem_usage(enum subsystem_t subsystem)
+{
+  subsystem_entry &E(entry(subsystem));
+  usage return_value;
+
+  E.m_mutex.lock();
+  return_value = E.m_current;
+  E.m_mutex.unlock();
+  return return_value;
+}
+
+void
+fastuidraw::memory::
+set_budget(enum subsystem_t subsystem, const usage &limit,
+           budget_callback *callback)
+{
+  subsystem_entry &E(entry(subsystem));
+
+  E.m_mutex.lock();
+  E.m_limit = limit;
+  E.m_callback = callback;
+  E.m_mutex.unlock();
+}
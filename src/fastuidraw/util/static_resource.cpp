@@ -18,8 +18,20 @@
 
 
 #include <assert.h>
-#include <map>
+#include <string.h>
+#include <list>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <boost/version.hpp>
+
+#if (BOOST_VERSION < 105300)
+  #define FASTUIDRAW_USE_DETAIL_ATOMIC
+#endif
+
+#ifndef FASTUIDRAW_USE_DETAIL_ATOMIC
+  #include <boost/atomic.hpp>
+#endif
 
 #include <fastuidraw/util/util.hpp>
 #include <fastuidraw/util/reference_counted.hpp>
@@ -29,11 +41,92 @@
 
 namespace
 {
+  /* A resource is never modified or removed once added,
+     so the address of its label and data stay valid for
+     the lifetime of the hoard.
+   */
+  class resource
+  {
+  public:
+    std::string m_label;
+    std::vector<uint8_t> m_data;
+  };
+
+  /* an immutable array of resources sorted by label */
+  typedef std::vector<const resource*> resource_table;
+
+  bool
+  compare_resources(const resource *lhs, const resource *rhs)
+  {
+    return strcmp(lhs->m_label.c_str(), rhs->m_label.c_str()) < 0;
+  }
+
+  const resource*
+  find_resource(const resource_table *table, const char *label)
+  {
+    unsigned int lo(0), hi(table->size());
+
+    while(lo < hi)
+      {
+        unsigned int mid((lo + hi) / 2);
+        int c;
+
+        c = strcmp(label, (*table)[mid]->m_label.c_str());
+        if(c == 0)
+          {
+            return (*table)[mid];
+          }
+        else if(c < 0)
+          {
+            hi = mid;
+          }
+        else
+          {
+            lo = mid + 1;
+          }
+      }
+    return NULL;
+  }
+
+  /* The resources are nearly all added by static_resource
+     objects at static initialization, whereas fetches come
+     from many threads during startup. Adding a resource only
+     appends it to m_pending under the lock; the first fetch
+     after that builds a new sorted table from the published
+     table and the pending resources and publishes it. The
+     common case of a fetch with nothing pending is a lookup
+     in the published table without taking the lock. Readers
+     may still be looking at a replaced table, so replaced
+     tables are kept until the hoard is destroyed.
+   */
   class resource_hoard:fastuidraw::noncopyable
   {
   public:
-    std::map<std::string, std::vector<uint8_t> > m_data;
+    resource_hoard(void);
+    ~resource_hoard();
+
+    void
+    add(const char *label, fastuidraw::const_c_array<uint8_t> value);
+
+    const resource*
+    fetch(const char *label);
+
+  private:
+    const resource_table*
+    publish_pending(void);
+
+    std::list<resource> m_resources;
+    std::vector<const resource*> m_pending;
+    std::vector<resource_table*> m_tables;
     fastuidraw::mutex m_mutex;
+
+    #ifndef FASTUIDRAW_USE_DETAIL_ATOMIC
+    boost::atomic<const resource_table*> m_published;
+    boost::atomic<bool> m_dirty;
+    #else
+    const resource_table *m_published;
+    bool m_dirty;
+    #endif
   };
 
   static
@@ -45,36 +138,109 @@ namespace
   }
 }
 
+//////////////////////////////////
+// resource_hoard methods
+resource_hoard::
+resource_hoard(void):
+  m_published(NULL),
+  m_dirty(false)
+{
+  m_tables.push_back(FASTUIDRAWnew resource_table());
+  m_published = m_tables.back();
+}
+
+resource_hoard::
+~resource_hoard()
+{
+  for(unsigned int i = 0, endi = m_tables.size(); i < endi; ++i)
+    {
+      FASTUIDRAWdelete(m_tables[i]);
+    }
+}
+
+void
+resource_hoard::
+add(const char *label, fastuidraw::const_c_array<uint8_t> value)
+{
+  fastuidraw::autolock_mutex m(m_mutex);
+
+  m_resources.push_back(resource());
+  m_resources.back().m_label = label;
+  m_resources.back().m_data.assign(value.begin(), value.end());
+  m_pending.push_back(&m_resources.back());
+
+  #ifndef FASTUIDRAW_USE_DETAIL_ATOMIC
+  m_dirty.store(true, boost::memory_order_release);
+  #else
+  m_dirty = true;
+  #endif
+}
+
+const resource_table*
+resource_hoard::
+publish_pending(void)
+{
+  const resource_table *current(m_tables.back());
+  resource_table *table;
+
+  if(m_pending.empty())
+    {
+      return current;
+    }
+
+  table = FASTUIDRAWnew resource_table();
+  table->reserve(current->size() + m_pending.size());
+  table->insert(table->end(), current->begin(), current->end());
+  table->insert(table->end(), m_pending.begin(), m_pending.end());
+  std::sort(table->begin(), table->end(), compare_resources);
+  m_pending.clear();
+  m_tables.push_back(table);
+
+  #ifndef FASTUIDRAW_USE_DETAIL_ATOMIC
+  m_published.store(table, boost::memory_order_release);
+  m_dirty.store(false, boost::memory_order_release);
+  #else
+  m_published = table;
+  m_dirty = false;
+  #endif
+
+  return table;
+}
+
+const resource*
+resource_hoard::
+fetch(const char *label)
+{
+  #ifndef FASTUIDRAW_USE_DETAIL_ATOMIC
+  if(!m_dirty.load(boost::memory_order_acquire))
+    {
+      return find_resource(m_published.load(boost::memory_order_acquire), label);
+    }
+  #endif
+
+  fastuidraw::autolock_mutex m(m_mutex);
+  return find_resource(publish_pending(), label);
+}
+
 void
 fastuidraw::
 generate_static_resource(const char *presource_label, const_c_array<uint8_t> pvalue)
 {
-  std::string sresource_label(presource_label);
-  std::vector<uint8_t> svalue(pvalue.begin(), pvalue.end());
-  hoard().m_mutex.lock();
-  assert(hoard().m_data.find(sresource_label) == hoard().m_data.end());
-  hoard().m_data[sresource_label] = svalue;
-  hoard().m_mutex.unlock();
+  assert(hoard().fetch(presource_label) == NULL);
+  hoard().add(presource_label, pvalue);
 }
 
 fastuidraw::const_c_array<uint8_t>
 fastuidraw::
 fetch_static_resource(const char *presource_label)
 {
-  const_c_array<uint8_t> return_value;
-  std::string sresource_label(presource_label);
-  std::map<std::string, std::vector<uint8_t> >::const_iterator iter;
+  const resource *R;
 
-  hoard().m_mutex.lock();
-  iter = hoard().m_data.find(sresource_label);
-  if(iter != hoard().m_data.end())
-    {
-      return_value = make_c_array(iter->second);
-    }
-  hoard().m_mutex.unlock();
-  return return_value;
+  R = hoard().fetch(presource_label);
+  return (R != NULL) ?
+    make_c_array(R->m_data) :
+    const_c_array<uint8_t>();
 }
-
 ///////////////////////////////////////
 // fastuidraw::static_resource methods
 fastuidraw::static_resource::
@@ -0,0 +1,493 @@
+/*!
+ * \file task_executor.cpp
+ * \brief file task_executor.cpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#include <assert.h>
+#include <deque>
+#include <vector>
+#include <boost/thread.hpp>
+
+#include <fastuidraw/util/task_executor.hpp>
+#include "../private/util_private.hpp"
+
+namespace
+{
+  /* the tasks passed to one call of run_tasks(),
+     the caller waits until m_remaining is zero.
+   */
+  class task_batch:fastuidraw::noncopyable
+  {
+  public:
+    explicit
+    task_batch(unsigned int count):
+      m_remaining(count)
+    {}
+
+    void
+    task_done(void)
+    {
+      boost::lock_guard<boost::mutex> L(m_mutex);
+
+      assert(m_remaining > 0);
+      --m_remaining;
+      if(m_remaining == 0)
+        {
+          m_cond.notify_all();
+        }
+    }
+
+    bool
+    done(void)
+    {
+      boost::lock_guard<boost::mutex> L(m_mutex);
+      return m_remaining == 0;
+    }
+
+    void
+    wait(void)
+    {
+      boost::unique_lock<boost::mutex> L(m_mutex);
+      while(m_remaining != 0)
+        {
+          m_cond.wait(L);
+        }
+    }
+
+  private:
+    boost::mutex m_mutex;
+    boost::condition_variable m_cond;
+    unsigned int m_remaining;
+  };
+
+  /* a task of run_tasks() has the batch of its call,
+     a task of run_task_async() has no batch.
+   */
+  class queued_task
+  {
+  public:
+    queued_task(void):
+      m_task(NULL),
+      m_batch(NULL)
+    {}
+
+    queued_task(fastuidraw::TaskExecutor::Task *t, task_batch *b):
+      m_task(t),
+      m_batch(b)
+    {}
+
+    fastuidraw::TaskExecutor::Task *m_task;
+    task_batch *m_batch;
+  };
+
+  class task_queue:fastuidraw::noncopyable
+  {
+  public:
+    boost::mutex m_mutex;
+    std::deque<queued_task> m_tasks;
+  };
+
+  void
+  no_cleanup(unsigned int*)
+  {}
+
+  class WorkStealingTaskExecutorPrivate;
+
+  /* boost::thread copies the functor it runs */
+  class worker
+  {
+  public:
+    worker(WorkStealingTaskExecutorPrivate *p, unsigned int q):
+      m_p(p),
+      m_queue(q)
+    {}
+
+    void
+    operator()(void);
+
+  private:
+    WorkStealingTaskExecutorPrivate *m_p;
+    unsigned int m_queue;
+  };
+
+  class WorkStealingTaskExecutorPrivate:fastuidraw::noncopyable
+  {
+  public:
+    explicit
+    WorkStealingTaskExecutorPrivate(unsigned int number_threads);
+
+    ~WorkStealingTaskExecutorPrivate();
+
+    unsigned int
+    queue_of_caller(void);
+
+    void
+    push(unsigned int q,
+         fastuidraw::const_c_array<fastuidraw::TaskExecutor::Task*> tasks,
+         task_batch *batch);
+
+    void
+    push_async(fastuidraw::TaskExecutor::Task *task);
+
+    /* run a task of run_tasks() taken from the queues, or if
+       there is none and take_async is true, a task of
+       run_task_async(); returns false if no task was run.
+     */
+    bool
+    run_one(unsigned int q, bool take_async);
+
+    void
+    worker_loop(unsigned int q);
+
+    unsigned int m_number_threads;
+
+    /* entry q is the queue of the worker thread q for
+       q < m_number_threads - 1, the last entry is shared
+       by the threads that are not worker threads.
+     */
+    std::vector<task_queue*> m_queues;
+
+    /* the tasks of run_task_async(), taken only by
+       the worker threads.
+     */
+    task_queue m_async_queue;
+
+    /* m_worker_ids[q] = q, the worker thread q points
+       m_worker_queue to m_worker_ids[q].
+     */
+    std::vector<unsigned int> m_worker_ids;
+    boost::thread_specific_ptr<unsigned int> m_worker_queue;
+
+    /* number of tasks pushed and not yet taken from a
+       queue; incremented before the tasks are placed on
+       their queue so that it is never less than the
+       number of tasks on the queues.
+     */
+    boost::mutex m_sleep_mutex;
+    boost::condition_variable m_sleep_cond;
+    unsigned int m_number_queued;
+    bool m_shutdown;
+
+    boost::thread_group m_threads;
+  };
+
+  class default_executor_holder
+  {
+  public:
+    fastuidraw::mutex m_mutex;
+    fastuidraw::reference_counted_ptr<fastuidraw::TaskExecutor> m_executor;
+  };
+
+  default_executor_holder&
+  default_executor(void)
+  {
+    static default_executor_holder R;
+    return R;
+  }
+}
+
+/////////////////////////////////////
+// worker methods
+void
+worker::
+operator()(void)
+{
+  m_p->worker_loop(m_queue);
+}
+
+///////////////////////////////////////////////////
+// WorkStealingTaskExecutorPrivate methods
+WorkStealingTaskExecutorPrivate::
+WorkStealingTaskExecutorPrivate(unsigned int number_threads):
+  m_number_threads(number_threads),
+  m_worker_queue(no_cleanup),
+  m_number_queued(0),
+  m_shutdown(false)
+{
+  if(m_number_threads == 0)
+    {
+      m_number_threads = std::max(1u, boost::thread::hardware_concurrency());
+    }
+
+  m_queues.resize(m_number_threads);
+  m_worker_ids.resize(m_number_threads - 1);
+  for(unsigned int q = 0; q < m_number_threads; ++q)
+    {
+      m_queues[q] = FASTUIDRAWnew task_queue();
+    }
+
+  for(unsigned int q = 0; q + 1 < m_number_threads; ++q)
+    {
+      m_worker_ids[q] = q;
+      m_threads.create_thread(worker(this, q));
+    }
+}
+
+WorkStealingTaskExecutorPrivate::
+~WorkStealingTaskExecutorPrivate()
+{
+  {
+    boost::lock_guard<boost::mutex> L(m_sleep_mutex);
+    m_shutdown = true;
+  }
+  m_sleep_cond.notify_all();
+  m_threads.join_all();
+
+  for(unsigned int q = 0; q < m_queues.size(); ++q)
+    {
+      assert(m_queues[q]->m_tasks.empty());
+      FASTUIDRAWdelete(m_queues[q]);
+    }
+  assert(m_async_queue.m_tasks.empty());
+}
+
+unsigned int
+WorkStealingTaskExecutorPrivate::
+queue_of_caller(void)
+{
+  unsigned int *p;
+
+  p = m_worker_queue.get();
+  return (p != NULL) ? *p : m_queues.size() - 1;
+}
+
+void
+WorkStealingTaskExecutorPrivate::
+push(unsigned int q,
+     fastuidraw::const_c_array<fastuidraw::TaskExecutor::Task*> tasks,
+     task_batch *batch)
+{
+  {
+    boost::lock_guard<boost::mutex> L(m_sleep_mutex);
+    m_number_queued += tasks.size();
+  }
+
+  {
+    boost::lock_guard<boost::mutex> L(m_queues[q]->m_mutex);
+    for(unsigned int i = 0; i < tasks.size(); ++i)
+      {
+        m_queues[q]->m_tasks.push_back(queued_task(tasks[i], batch));
+      }
+  }
+  m_sleep_cond.notify_all();
+}
+
+void
+WorkStealingTaskExecutorPrivate::
+push_async(fastuidraw::TaskExecutor::Task *task)
+{
+  {
+    boost::lock_guard<boost::mutex> L(m_sleep_mutex);
+    ++m_number_queued;
+  }
+
+  {
+    boost::lock_guard<boost::mutex> L(m_async_queue.m_mutex);
+    m_async_queue.m_tasks.push_back(queued_task(task, NULL));
+  }
+  m_sleep_cond.notify_one();
+}
+
+bool
+WorkStealingTaskExecutorPrivate::
+run_one(unsigned int q, bool take_async)
+{
+  queued_task T;
+  bool found(false);
+
+  /* take the newest task of our own queue, its data is
+     the most likely to still be in cache; otherwise steal
+     the oldest task of another queue, which is typically
+     the largest piece of work left on it.
+   */
+  {
+    task_queue *Q(m_queues[q]);
+    boost::lock_guard<boost::mutex> L(Q->m_mutex);
+    if(!Q->m_tasks.empty())
+      {
+        T = Q->m_tasks.back();
+        Q->m_tasks.pop_back();
+        found = true;
+      }
+  }
+
+  for(unsigned int i = 1, endi = m_queues.size(); !found && i < endi; ++i)
+    {
+      task_queue *Q(m_queues[(q + i) % endi]);
+      boost::lock_guard<boost::mutex> L(Q->m_mutex);
+      if(!Q->m_tasks.empty())
+        {
+          T = Q->m_tasks.front();
+          Q->m_tasks.pop_front();
+          found = true;
+        }
+    }
+
+  if(!found && take_async)
+    {
+      boost::lock_guard<boost::mutex> L(m_async_queue.m_mutex);
+      if(!m_async_queue.m_tasks.empty())
+        {
+          T = m_async_queue.m_tasks.front();
+          m_async_queue.m_tasks.pop_front();
+          found = true;
+        }
+    }
+
+  if(!found)
+    {
+      return false;
+    }
+
+  {
+    boost::lock_guard<boost::mutex> L(m_sleep_mutex);
+    assert(m_number_queued > 0);
+    --m_number_queued;
+  }
+
+  T.m_task->run();
+  if(T.m_batch)
+    {
+      T.m_batch->task_done();
+    }
+  return true;
+}
+
+void
+WorkStealingTaskExecutorPrivate::
+worker_loop(unsigned int q)
+{
+  m_worker_queue.reset(&m_worker_ids[q]);
+  for(;;)
+    {
+      if(run_one(q, true))
+        {
+          continue;
+        }
+
+      boost::unique_lock<boost::mutex> L(m_sleep_mutex);
+      while(m_number_queued == 0 && !m_shutdown)
+        {
+          m_sleep_cond.wait(L);
+        }
+
+      if(m_number_queued == 0 && m_shutdown)
+        {
+          return;
+        }
+    }
+}
+
+///////////////////////////////////////////////
+// fastuidraw::WorkStealingTaskExecutor methods
+fastuidraw::WorkStealingTaskExecutor::
+WorkStealingTaskExecutor(unsigned int number_threads)
+{
+  m_d = FASTUIDRAWnew WorkStealingTaskExecutorPrivate(number_threads);
+}
+
+fastuidraw::WorkStealingTaskExecutor::
+~WorkStealingTaskExecutor()
+{
+  WorkStealingTaskExecutorPrivate *d;
+  d = static_cast<WorkStealingTaskExecutorPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = NULL;
+}
+
+unsigned int
+fastuidraw::WorkStealingTaskExecutor::
+number_threads(void) const
+{
+  WorkStealingTaskExecutorPrivate *d;
+  d = static_cast<WorkStealingTaskExecutorPrivate*>(m_d);
+  return d->m_number_threads;
+}
+
+void
+fastuidraw::WorkStealingTaskExecutor::
+run_tasks(const_c_array<Task*> tasks)
+{
+  WorkStealingTaskExecutorPrivate *d;
+  d = static_cast<WorkStealingTaskExecutorPrivate*>(m_d);
+
+  if(tasks.size() <= 1 || d->m_number_threads <= 1)
+    {
+      for(unsigned int i = 0; i < tasks.size(); ++i)
+        {
+          tasks[i]->run();
+        }
+      return;
+    }
+
+  unsigned int q(d->queue_of_caller());
+  task_batch batch(tasks.size());
+
+  /* run tasks until none are left on any queue, then the
+     remaining tasks of the batch are running on other
+     threads and we only need to wait for them.
+   */
+  d->push(q, tasks, &batch);
+  while(!batch.done())
+    {
+      if(!d->run_one(q, false))
+        {
+          batch.wait();
+        }
+    }
+}
+
+void
+fastuidraw::WorkStealingTaskExecutor::
+run_task_async(Task *task)
+{
+  WorkStealingTaskExecutorPrivate *d;
+  d = static_cast<WorkStealingTaskExecutorPrivate*>(m_d);
+
+  if(d->m_number_threads <= 1)
+    {
+      task->run();
+      return;
+    }
+  d->push_async(task);
+}
+
+//////////////////////////////////
+// global methods
+fastuidraw::reference_counted_ptr<fastuidraw::TaskExecutor>
+fastuidraw::
+default_task_executor(void)
+{
+  default_executor_holder &R(default_executor());
+  autolock_mutex M(R.m_mutex);
+
+  if(!R.m_executor)
+    {
+      R.m_executor = FASTUIDRAWnew WorkStealingTaskExecutor();
+    }
+  return R.m_executor;
+}
+
+void
+fastuidraw::
+default_task_executor(const reference_counted_ptr<TaskExecutor> &executor)
+{
+  default_executor_holder &R(default_executor());
+  autolock_mutex M(R.m_mutex);
+
+  R.m_executor = executor;
+}